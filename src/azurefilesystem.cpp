@@ -15,7 +15,9 @@
 //*****************************************************************************
 #include "azurefilesystem.hpp"
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -82,8 +84,27 @@ as::cloud_storage_account createDefaultOrAnonymousAccount() {
     }
 }
 
+namespace {
+// Account is parsed and proxy is configured once per credentials instead of for every model on every watcher tick
+as::cloud_storage_account getPooledAccount() {
+    static std::mutex accountsMtx;
+    static std::map<std::string, as::cloud_storage_account> accounts;
+    std::string key;
+    for (const char* name : {"AZURE_STORAGE_CONNECTION_STRING", "AZURE_STORAGE_USE_HTTP_PROXY", "https_proxy", "http_proxy"}) {
+        const char* value = std::getenv(name);
+        key += std::string(value != nullptr ? value : "") + "|";
+    }
+    std::lock_guard<std::mutex> lock(accountsMtx);
+    auto it = accounts.find(key);
+    if (it == accounts.end()) {
+        it = accounts.emplace(key, createDefaultOrAnonymousAccount()).first;
+    }
+    return it->second;
+}
+}  // namespace
+
 AzureFileSystem::AzureFileSystem() :
-    account_{createDefaultOrAnonymousAccount()} {
+    account_{getPooledAccount()} {
     SPDLOG_LOGGER_TRACE(azurestorage_logger, "AzureFileSystem default ctor");
 }
 
@@ -220,6 +241,7 @@ StatusCode AzureFileSystem::downloadModelVersions(const std::string& path,
         return sc;
     }
 
+    AzureStorageAdapter::files_to_download_t files_to_download;
     for (auto& ver : versions) {
         std::string versionpath = path;
         if (!endsWith(versionpath, "/")) {
@@ -242,13 +264,20 @@ StatusCode AzureFileSystem::downloadModelVersions(const std::string& path,
             return status;
         }
 
-        status = azureStorageObj->downloadFileFolderTo(lpath);
+        status = azureStorageObj->collectFilesToDownload(lpath, &files_to_download);
         if (status != StatusCode::OK) {
             SPDLOG_LOGGER_ERROR(azurestorage_logger, "Failed to download model version {}", versionpath);
             return status;
         }
     }
 
+    // Files of all versions are downloaded together so that parallelism is not limited to a single version
+    auto status = AzureStorageAdapter::downloadFiles(files_to_download, account_, downloadCache);
+    if (status != StatusCode::OK) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, "Failed to download model versions from {}", path);
+        return status;
+    }
+
     return StatusCode::OK;
 }
 
@@ -15,10 +15,18 @@
 //*****************************************************************************
 #include "azurestorage.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include <cpprest/filestream.h>
+#pragma GCC diagnostic pop
+
 #include "azurefilesystem.hpp"
 #include "logging.hpp"
+#include "paralleltasks.hpp"
 
 namespace ovms {
 
@@ -26,6 +34,24 @@ using namespace utility;
 
 const std::string UNAVAILABLE_PATH_ERROR = "Unable to access path: {}";
 
+const uint32_t DEFAULT_AZURE_STORAGE_DOWNLOAD_THREADS = 8;
+const uint32_t DEFAULT_AZURE_STORAGE_DOWNLOAD_PART_SIZE_MB = 32;
+
+namespace {
+template <typename Download>
+void downloadToLocalFileAt(const std::string& local_path, uint64_t offset, Download download) {
+    auto stream = concurrency::streams::file_stream<uint8_t>::open_ostream(local_path, std::ios_base::in | std::ios_base::out | std::ios_base::binary).get();
+    try {
+        stream.seek(offset);
+        download(stream);
+    } catch (...) {
+        stream.close().wait();
+        throw;
+    }
+    stream.close().wait();
+}
+}  // namespace
+
 const std::string AzureStorageAdapter::extractAzureStorageExceptionMessage(const as::storage_exception& e) {
     as::request_result result = e.result();
     as::storage_extended_error extended_error = result.extended_error();
@@ -74,6 +100,109 @@ bool AzureStorageAdapter::isAbsolutePath(const std::string& path) {
     return !path.empty() && (path[0] == '/');
 }
 
+StatusCode AzureStorageAdapter::downloadFiles(const files_to_download_t& files_to_download, const as::cloud_storage_account& account,
+    const std::shared_ptr<DownloadCache>& downloadCache) {
+    const size_t download_threads = FileSystem::getPositiveEnvValue("AZURE_STORAGE_DOWNLOAD_THREADS", DEFAULT_AZURE_STORAGE_DOWNLOAD_THREADS);
+    const uint64_t download_part_size = uint64_t(FileSystem::getPositiveEnvValue("AZURE_STORAGE_DOWNLOAD_PART_SIZE_MB", DEFAULT_AZURE_STORAGE_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024;
+
+    // Each file requires several requests before its content can be downloaded, so they are prepared concurrently as well
+    std::vector<std::shared_ptr<AzureStorageAdapter>> storages(files_to_download.size());
+    std::vector<uint64_t> sizes(files_to_download.size(), 0);
+    std::vector<std::string> cache_keys(files_to_download.size());
+    std::vector<StatusCode> statuses(files_to_download.size(), StatusCode::OK);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < files_to_download.size(); i++) {
+        tasks.emplace_back([i, &files_to_download, &account, &downloadCache, &storage = storages[i], &size = sizes[i], &cache_key = cache_keys[i], &status = statuses[i]]() {
+            const auto& [remote_file_path, local_file_path] = files_to_download[i];
+            auto factory = std::make_shared<ovms::AzureStorageFactory>();
+            storage = factory.get()->getNewAzureStorageObject(remote_file_path, account);
+            status = storage->checkPath(remote_file_path);
+            if (status != StatusCode::OK) {
+                SPDLOG_LOGGER_WARN(azurestorage_logger, "Check path failed: {} -> {}", remote_file_path,
+                    ovms::Status(status).string());
+                return;
+            }
+            std::vector<std::string> content_identity;
+            status = storage->getFileMetadata(&size, &content_identity);
+            if (status != StatusCode::OK) {
+                return;
+            }
+            cache_key = DownloadCache::createKey(content_identity);
+            if (downloadCache && downloadCache->restore(cache_key, local_file_path)) {
+                // nothing left to download
+                cache_key.clear();
+                size = 0;
+                return;
+            }
+        });
+    }
+    executeInParallel(tasks, download_threads);
+    for (const auto& status : statuses) {
+        if (status != StatusCode::OK) {
+            return status;
+        }
+    }
+    DownloadDeduplicator deduplicator;
+    for (size_t i = 0; i < files_to_download.size(); i++) {
+        if (cache_keys[i].empty()) {
+            continue;
+        }
+        if (deduplicator.isDuplicate(cache_keys[i], files_to_download[i].second)) {
+            cache_keys[i].clear();
+            sizes[i] = 0;
+            continue;
+        }
+        auto status = FileSystem::createLocalFile(files_to_download[i].second, sizes[i]);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+        if (!downloadCache) {
+            cache_keys[i].clear();
+        }
+    }
+
+    struct FilePart {
+        size_t file;
+        uint64_t offset;
+        uint64_t length;
+    };
+    std::vector<FilePart> parts;
+    for (size_t i = 0; i < files_to_download.size(); i++) {
+        for (uint64_t offset = 0; offset < sizes[i]; offset += download_part_size) {
+            parts.push_back({i, offset, std::min(download_part_size, sizes[i] - offset)});
+        }
+    }
+
+    SPDLOG_LOGGER_DEBUG(azurestorage_logger, "Downloading {} files in {} parts using up to {} threads", files_to_download.size(), parts.size(), download_threads);
+    statuses.assign(parts.size(), StatusCode::OK);
+    tasks.clear();
+    for (size_t i = 0; i < parts.size(); i++) {
+        tasks.emplace_back([&files_to_download, &storages, &part = parts[i], &status = statuses[i]]() {
+            const auto& [remote_file_path, local_file_path] = files_to_download[part.file];
+            status = storages[part.file]->downloadFileRange(local_file_path, part.offset, part.length);
+            if (status != StatusCode::OK) {
+                SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to save file from {} to {}", remote_file_path,
+                    local_file_path);
+            }
+        });
+    }
+    executeInParallel(tasks, download_threads);
+    for (const auto& status : statuses) {
+        if (status != StatusCode::OK) {
+            return status;
+        }
+    }
+    if (!deduplicator.linkDuplicates()) {
+        return StatusCode::FILESYSTEM_ERROR;
+    }
+    for (size_t i = 0; i < files_to_download.size(); i++) {
+        if (!cache_keys[i].empty()) {
+            downloadCache->store(cache_keys[i], files_to_download[i].second);
+        }
+    }
+    return StatusCode::OK;
+}
+
 AzureStorageBlob::AzureStorageBlob(const std::string& path, as::cloud_storage_account account) {
     account_ = account;
     as_blob_client_ = account_.create_cloud_blob_client();
@@ -435,7 +564,64 @@ StatusCode AzureStorageBlob::downloadFile(const std::string& local_path) {
     return StatusCode::AS_FILE_NOT_FOUND;
 }
 
+StatusCode AzureStorageBlob::getFileMetadata(uint64_t* size, std::vector<std::string>* content_identity) {
+    try {
+        if (!isPathValidationOk_) {
+            auto status = checkPath(fullUri_);
+            if (status != StatusCode::OK)
+                return status;
+        }
+
+        as_blob_ = as_container_.get_blob_reference(blockpath_);
+        if (!as_blob_.exists()) {
+            SPDLOG_LOGGER_WARN(azurestorage_logger, "Block blob does not exist: {} -> {}", fullPath_, blockpath_);
+            return StatusCode::AS_FILE_NOT_FOUND;
+        }
+
+        *size = as_blob_.properties().size();
+        // MD5 is optional, ETag identifies content of single blob then
+        if (as_blob_.properties().content_md5().empty()) {
+            *content_identity = {"azure_blob", as_blob_.uri().primary_uri().to_string(), as_blob_.properties().etag(), std::to_string(*size)};
+        } else {
+            *content_identity = {"azure_md5", as_blob_.properties().content_md5(), std::to_string(*size)};
+        }
+        return StatusCode::OK;
+    } catch (const as::storage_exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
+    } catch (const std::exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, UNAVAILABLE_PATH_ERROR, e.what());
+    }
+
+    return StatusCode::AS_FILE_NOT_FOUND;
+}
+
+StatusCode AzureStorageBlob::downloadFileRange(const std::string& local_path, uint64_t offset, uint64_t length) {
+    try {
+        // Separate reference for each range, since download updates blob properties
+        as::cloud_blob blob = as_container_.get_blob_reference(blockpath_);
+        downloadToLocalFileAt(local_path, offset, [&blob, offset, length](concurrency::streams::ostream& stream) {
+            blob.download_range_to_stream(stream, offset, length);
+        });
+        return StatusCode::OK;
+    } catch (const as::storage_exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
+    } catch (const std::exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, UNAVAILABLE_PATH_ERROR, e.what());
+    }
+
+    return StatusCode::AS_FILE_NOT_FOUND;
+}
+
 StatusCode AzureStorageBlob::downloadFileFolderTo(const std::string& local_path) {
+    files_to_download_t files_to_download;
+    auto status = collectFilesToDownload(local_path, &files_to_download);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    return downloadFiles(files_to_download, account_, nullptr);
+}
+
+StatusCode AzureStorageBlob::collectFilesToDownload(const std::string& local_path, files_to_download_t* files_to_download) {
     try {
         if (!isPathValidationOk_) {
             auto status = checkPath(fullUri_);
@@ -485,14 +671,14 @@ StatusCode AzureStorageBlob::downloadFileFolderTo(const std::string& local_path)
 
             auto mkdir_status = CreateLocalDir(local_dir_path);
             if (mkdir_status != StatusCode::OK) {
-                return status;
+                return mkdir_status;
             }
-            auto download_dir_status =
-                azureSubdirStorageObj->downloadFileFolderTo(local_dir_path);
-            if (download_dir_status != StatusCode::OK) {
+            auto collect_dir_status =
+                azureSubdirStorageObj->collectFilesToDownload(local_dir_path, files_to_download);
+            if (collect_dir_status != StatusCode::OK) {
                 SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to download directory from {} to {}",
                     remote_dir_path, local_dir_path);
-                return download_dir_status;
+                return collect_dir_status;
             }
         }
 
@@ -501,23 +687,7 @@ StatusCode AzureStorageBlob::downloadFileFolderTo(const std::string& local_path)
             std::string local_file_path = joinPath({local_path, f});
             SPDLOG_LOGGER_TRACE(azurestorage_logger, "Processing file {} from {} -> {}", f, remote_file_path,
                 local_file_path);
-
-            auto factory = std::make_shared<ovms::AzureStorageFactory>();
-            auto azureFiledirStorageObj = factory.get()->getNewAzureStorageObject(remote_file_path, account_);
-            status = azureFiledirStorageObj->checkPath(remote_file_path);
-            if (status != StatusCode::OK) {
-                SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to download directory from {} to {}",
-                    remote_file_path, local_file_path);
-                return status;
-            }
-
-            auto download_status =
-                azureFiledirStorageObj->downloadFile(local_file_path);
-            if (download_status != StatusCode::OK) {
-                SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to save file from {} to {}", remote_file_path,
-                    local_file_path);
-                return download_status;
-            }
+            files_to_download->emplace_back(remote_file_path, local_file_path);
         }
         return StatusCode::OK;
     } catch (const as::storage_exception& e) {
@@ -1029,7 +1199,80 @@ StatusCode AzureStorageFile::downloadFile(const std::string& local_path) {
     return StatusCode::AS_FILE_NOT_FOUND;
 }
 
+StatusCode AzureStorageFile::getFileMetadata(uint64_t* size, std::vector<std::string>* content_identity) {
+    try {
+        if (!isPathValidationOk_) {
+            auto status = checkPath(fullUri_);
+            if (status != StatusCode::OK)
+                return status;
+        }
+
+        as::cloud_file_directory as_last_working_subdir;
+        std::string tmp_dir = "";
+
+        try {
+            for (std::vector<std::string>::size_type i = 0; i != subdirs_.size(); i++) {
+                tmp_dir = tmp_dir + (i == 0 ? "" : "/") + subdirs_[i];
+                as::cloud_file_directory as_tmp_subdir = as_share_.get_directory_reference(tmp_dir);
+                if (!as_tmp_subdir.exists()) {
+                    break;
+                }
+
+                as_last_working_subdir = as_tmp_subdir;
+            }
+        } catch (const as::storage_exception& e) {
+        }
+
+        as_directory_ = as_last_working_subdir;
+        as_file1_ = as_directory_.get_file_reference(_XPLATSTR(file_));
+        if (!as_file1_.exists()) {
+            SPDLOG_LOGGER_WARN(azurestorage_logger, "File does not exist: {} -> {}", fullPath_, file_);
+            return StatusCode::AS_FILE_NOT_FOUND;
+        }
+
+        *size = as_file1_.properties().length();
+        if (as_file1_.properties().content_md5().empty()) {
+            *content_identity = {"azure_file", as_file1_.uri().primary_uri().to_string(), as_file1_.properties().etag(), std::to_string(*size)};
+        } else {
+            *content_identity = {"azure_md5", as_file1_.properties().content_md5(), std::to_string(*size)};
+        }
+        return StatusCode::OK;
+    } catch (const as::storage_exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
+    } catch (const std::exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, UNAVAILABLE_PATH_ERROR, e.what());
+    }
+
+    return StatusCode::AS_FILE_NOT_FOUND;
+}
+
+StatusCode AzureStorageFile::downloadFileRange(const std::string& local_path, uint64_t offset, uint64_t length) {
+    try {
+        // Separate reference for each range, since download updates file properties
+        as::cloud_file file = as_directory_.get_file_reference(_XPLATSTR(file_));
+        downloadToLocalFileAt(local_path, offset, [&file, offset, length](concurrency::streams::ostream& stream) {
+            file.download_range_to_stream(stream, offset, offset + length - 1);
+        });
+        return StatusCode::OK;
+    } catch (const as::storage_exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, "Unable to access path: {}", extractAzureStorageExceptionMessage(e));
+    } catch (const std::exception& e) {
+        SPDLOG_LOGGER_ERROR(azurestorage_logger, UNAVAILABLE_PATH_ERROR, e.what());
+    }
+
+    return StatusCode::AS_FILE_NOT_FOUND;
+}
+
 StatusCode AzureStorageFile::downloadFileFolderTo(const std::string& local_path) {
+    files_to_download_t files_to_download;
+    auto status = collectFilesToDownload(local_path, &files_to_download);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    return downloadFiles(files_to_download, account_, nullptr);
+}
+
+StatusCode AzureStorageFile::collectFilesToDownload(const std::string& local_path, files_to_download_t* files_to_download) {
     try {
         if (!isPathValidationOk_) {
             auto status = checkPath(fullUri_);
@@ -1079,14 +1322,14 @@ StatusCode AzureStorageFile::downloadFileFolderTo(const std::string& local_path)
 
             auto mkdir_status = CreateLocalDir(local_dir_path);
             if (mkdir_status != StatusCode::OK) {
-                return status;
+                return mkdir_status;
             }
-            auto download_dir_status =
-                azureSubdirStorageObj->downloadFileFolderTo(local_dir_path);
-            if (download_dir_status != StatusCode::OK) {
+            auto collect_dir_status =
+                azureSubdirStorageObj->collectFilesToDownload(local_dir_path, files_to_download);
+            if (collect_dir_status != StatusCode::OK) {
                 SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to download directory from {} to {}",
                     remote_dir_path, local_dir_path);
-                return download_dir_status;
+                return collect_dir_status;
             }
         }
 
@@ -1095,23 +1338,7 @@ StatusCode AzureStorageFile::downloadFileFolderTo(const std::string& local_path)
             std::string local_file_path = joinPath({local_path, f});
             SPDLOG_LOGGER_TRACE(azurestorage_logger, "Processing file {} from {} -> {}", f, remote_file_path,
                 local_file_path);
-
-            auto factory = std::make_shared<ovms::AzureStorageFactory>();
-            auto azureFileStorageObj = factory.get()->getNewAzureStorageObject(remote_file_path, account_);
-            auto status = azureFileStorageObj->checkPath(remote_file_path);
-            if (status != StatusCode::OK) {
-                SPDLOG_LOGGER_WARN(azurestorage_logger, "Check path failed: {} -> {}", remote_file_path,
-                    ovms::Status(status).string());
-                return status;
-            }
-
-            auto download_status =
-                azureFileStorageObj->downloadFile(local_file_path);
-            if (download_status != StatusCode::OK) {
-                SPDLOG_LOGGER_WARN(azurestorage_logger, "Unable to save file from {} to {}", remote_file_path,
-                    local_file_path);
-                return download_status;
-            }
+            files_to_download->emplace_back(remote_file_path, local_file_path);
         }
         return StatusCode::OK;
     } catch (const as::storage_exception& e) {
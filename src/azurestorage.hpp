@@ -19,10 +19,12 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <spdlog/spdlog.h>
 
+#include "downloadcache.hpp"
 #include "status.hpp"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -43,6 +45,11 @@ using files_list_t = std::set<std::string>;
 
 class AzureStorageAdapter {
 public:
+    /**
+     * @brief Pairs of remote file path and local file path
+     */
+    using files_to_download_t = std::vector<std::pair<std::string, std::string>>;
+
     AzureStorageAdapter() {}
 
     virtual StatusCode fileExists(bool* exists) = 0;
@@ -58,6 +65,29 @@ public:
     virtual StatusCode downloadFileFolderTo(const std::string& local_path) = 0;
     virtual StatusCode checkPath(const std::string& path) = 0;
 
+    /**
+     * @brief Lists files of the directory and its subdirectories and creates local mirror of the subdirectories
+     */
+    virtual StatusCode collectFilesToDownload(const std::string& local_path, files_to_download_t* files_to_download) = 0;
+
+    /**
+     * @brief Gets size of the file and fields identifying its content, keeps file reference for downloading its ranges
+     */
+    virtual StatusCode getFileMetadata(uint64_t* size, std::vector<std::string>* content_identity) = 0;
+
+    /**
+     * @brief Downloads range of the file into local file at the same offset, getFileSize needs to be called first
+     */
+    virtual StatusCode downloadFileRange(const std::string& local_path, uint64_t offset, uint64_t length) = 0;
+
+    /**
+     * @brief Downloads files concurrently, files larger than download part size are split into ranges downloaded in parallel
+     *
+     * Files found in download cache are not downloaded, downloaded ones are added to it. Cache is not used if nullptr.
+     */
+    static StatusCode downloadFiles(const files_to_download_t& files_to_download, const as::cloud_storage_account& account,
+        const std::shared_ptr<DownloadCache>& downloadCache);
+
     std::string joinPath(std::initializer_list<std::string> segments);
     StatusCode CreateLocalDir(const std::string& path);
     bool isAbsolutePath(const std::string& path);
@@ -98,6 +128,12 @@ public:
 
     StatusCode downloadFileFolderTo(const std::string& local_path) override;
 
+    StatusCode collectFilesToDownload(const std::string& local_path, files_to_download_t* files_to_download) override;
+
+    StatusCode getFileMetadata(uint64_t* size, std::vector<std::string>* content_identity) override;
+
+    StatusCode downloadFileRange(const std::string& local_path, uint64_t offset, uint64_t length) override;
+
 private:
     std::string getLastPathPart(const std::string& path);
 
@@ -156,6 +192,12 @@ public:
 
     StatusCode downloadFileFolderTo(const std::string& local_path) override;
 
+    StatusCode collectFilesToDownload(const std::string& local_path, files_to_download_t* files_to_download) override;
+
+    StatusCode getFileMetadata(uint64_t* size, std::vector<std::string>* content_identity) override;
+
+    StatusCode downloadFileRange(const std::string& local_path, uint64_t offset, uint64_t length) override;
+
 private:
     StatusCode parseFilePath(const std::string& path) override;
 
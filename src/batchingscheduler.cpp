@@ -0,0 +1,333 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "batchingscheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "executinstreamidguard.hpp"
+#include "imagedecoder.hpp"
+#include "modelinstance.hpp"
+#include "phasemarkers.hpp"
+#include "precisionconversion.hpp"
+#include "prediction_service_utils.hpp"
+#include "serialization.hpp"
+#include "sharedmemory.hpp"
+#include "tensorcache.hpp"
+
+#define DEBUG
+#include "timer.hpp"
+
+namespace ovms {
+
+BatchingScheduler::BatchingScheduler(ModelInstance& modelInstance, size_t maxBatchSize, uint64_t batchTimeoutMicroseconds, uint64_t batchLatencySloMicroseconds) :
+    modelInstance(modelInstance),
+    maxBatchSize(maxBatchSize),
+    batchTimeoutMicroseconds(batchTimeoutMicroseconds) {
+    if (batchLatencySloMicroseconds > 0) {
+        timeoutTuner = std::make_unique<BatchTimeoutTuner>(maxBatchSize, batchTimeoutMicroseconds, batchLatencySloMicroseconds);
+    }
+    // Requests contents are copied into blobs owned by scheduler so that infer requests never point to memory of finished requests
+    auto& inferRequestsQueue = modelInstance.getInferRequestsQueue();
+    inputBlobs.resize(inferRequestsQueue.size());
+    for (auto& blobs : inputBlobs) {
+        for (const auto& [name, tensorInfo] : modelInstance.getInputsInfo()) {
+            auto blob = InferenceEngine::Blob::CreateFromData(std::make_shared<InferenceEngine::Data>(tensorInfo->getName(), tensorInfo->getTensorDesc()));
+            blob->allocate();
+            blobs.emplace(name, std::move(blob));
+        }
+    }
+}
+
+void BatchingScheduler::closeBatch(const std::shared_ptr<Batch>& batch) {
+    batch->closed = true;
+    if (formingBatch == batch) {
+        formingBatch.reset();
+    }
+    batch->closedNotify.notify_one();
+}
+
+Status BatchingScheduler::execute(const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response) {
+    BatchedRequest batchedRequest;
+    batchedRequest.request = request;
+    batchedRequest.response = response;
+    batchedRequest.batchSize = getRequestBatchSize(request);
+    // Rows of each input are copied at the same offset of batch, so all inputs have to agree on batch size
+    for (const auto& [name, requestInput] : request->inputs()) {
+        if (requestInput.tensor_shape().dim_size() == 0 ||
+            requestInput.tensor_shape().dim(0).size() < 0 ||
+            static_cast<size_t>(requestInput.tensor_shape().dim(0).size()) != batchedRequest.batchSize ||
+            (requestInput.dtype() == tensorflow::DataType::DT_STRING && static_cast<size_t>(requestInput.string_val_size()) != batchedRequest.batchSize)) {
+            std::stringstream ss;
+            ss << "Input: " << name << " batch size differs from other inputs; Expected: " << batchedRequest.batchSize;
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("Failed to schedule request - {}", details);
+            return Status(StatusCode::INVALID_BATCH_SIZE, details);
+        }
+    }
+    return schedule(batchedRequest);
+}
+
+Status BatchingScheduler::execute(const BlobMap& inputs, size_t batchSize, BlobMap& outputs) {
+    BatchedRequest batchedRequest;
+    batchedRequest.inputs = &inputs;
+    batchedRequest.outputs = &outputs;
+    batchedRequest.batchSize = batchSize;
+    return schedule(batchedRequest);
+}
+
+Status BatchingScheduler::schedule(BatchedRequest& batchedRequest) {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (timeoutTuner) {
+        timeoutTuner->recordArrival(std::chrono::steady_clock::now(), batchedRequest.batchSize);
+    }
+    if (formingBatch && formingBatch->batchSize + batchedRequest.batchSize > maxBatchSize) {
+        // Request does not fit, dispatch forming batch right away and start a new one
+        closeBatch(formingBatch);
+    }
+    bool isLeader = false;
+    if (!formingBatch) {
+        formingBatch = std::make_shared<Batch>();
+        isLeader = true;
+    }
+    auto batch = formingBatch;
+    batch->requests.push_back(&batchedRequest);
+    batch->batchSize += batchedRequest.batchSize;
+    if (batch->batchSize == maxBatchSize) {
+        closeBatch(batch);
+    }
+
+    if (!isLeader) {
+        batch->finishedNotify.wait(lock, [&batch]() { return batch->finished; });
+        return batch->status;
+    }
+
+    const uint64_t timeoutMicroseconds = timeoutTuner ? timeoutTuner->getTimeoutMicroseconds() : batchTimeoutMicroseconds;
+    batch->closedNotify.wait_for(lock, std::chrono::microseconds(timeoutMicroseconds), [&batch]() { return batch->closed; });
+    if (!batch->closed) {
+        closeBatch(batch);
+    }
+    lock.unlock();
+
+    // Closed batch is not modified by other threads anymore
+    const auto executionStart = std::chrono::steady_clock::now();
+    auto status = executeBatch(*batch);
+
+    lock.lock();
+    if (timeoutTuner && status.ok()) {
+        timeoutTuner->recordInference(batch->batchSize, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - executionStart).count());
+        timeoutTuner->update();
+    }
+    batch->status = status;
+    batch->finished = true;
+    lock.unlock();
+    batch->finishedNotify.notify_all();
+    return status;
+}
+
+Status BatchingScheduler::fillInputBlobs(const Batch& batch, std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& blobs) const {
+    for (auto& [name, blob] : blobs) {
+        char* buffer = blob->buffer().as<char*>();
+        const size_t rowByteSize = blob->byteSize() / maxBatchSize;
+        const auto& conversion = getPrecisionConversion(blob->getTensorDesc().getPrecision());
+        size_t offset = 0;
+        for (const auto* batchedRequest : batch.requests) {
+            char* destination = buffer + offset * rowByteSize;
+            // Copies never exceed rows of the request, so that rows of other requests and memory past the blob stay intact
+            const size_t requestByteSize = batchedRequest->batchSize * rowByteSize;
+            if (offset + batchedRequest->batchSize > maxBatchSize) {
+                SPDLOG_DEBUG("Failed to prepare batched inputs. Batch exceeds max batch size");
+                return StatusCode::INVALID_BATCH_SIZE;
+            }
+            if (batchedRequest->inputs) {
+                auto nodeInputItr = batchedRequest->inputs->find(name);
+                if (nodeInputItr == batchedRequest->inputs->end()) {
+                    SPDLOG_DEBUG("Failed to prepare batched inputs. Missing node input: {}", name);
+                    return StatusCode::INVALID_MISSING_INPUT;
+                }
+                const auto& nodeInput = nodeInputItr->second;
+                std::memcpy(destination, nodeInput->cbuffer().as<const char*>(), std::min(nodeInput->byteSize(), requestByteSize));
+                offset += batchedRequest->batchSize;
+                continue;
+            }
+            auto requestInputItr = batchedRequest->request->inputs().find(name);
+            if (requestInputItr == batchedRequest->request->inputs().end()) {
+                SPDLOG_DEBUG("Failed to prepare batched inputs. Validation of request failed");
+                return Status(StatusCode::INTERNAL_ERROR, "Failed to deserialize request");
+            }
+            const auto& requestInput = requestInputItr->second;
+            if (isSharedMemoryTensor(requestInput)) {
+                std::shared_ptr<const SharedMemoryRegion> region;
+                const char* data = nullptr;
+                auto status = getSharedMemoryTensorData(requestInput, requestByteSize, region, data);
+                if (!status.ok()) {
+                    return status;
+                }
+                std::memcpy(destination, data, requestByteSize);
+                offset += batchedRequest->batchSize;
+                continue;
+            }
+            if (isCachedTensorReference(requestInput)) {
+                std::shared_ptr<const CachedTensor> tensor;
+                const char* data = nullptr;
+                auto status = getCachedTensorData(requestInput, requestByteSize, tensor, data);
+                if (!status.ok()) {
+                    return status;
+                }
+                std::memcpy(destination, data, requestByteSize);
+                offset += batchedRequest->batchSize;
+                continue;
+            }
+            if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+                const auto& desc = blob->getTensorDesc();
+                auto dims = desc.getDims();
+                dims[0] = batchedRequest->batchSize;
+                auto status = decodeImages(requestInput, InferenceEngine::TensorDesc(desc.getPrecision(), dims, desc.getLayout()), destination);
+                if (!status.ok()) {
+                    return status;
+                }
+                offset += batchedRequest->batchSize;
+                continue;
+            }
+            if (conversion.requestField == TensorProtoField::HALF_VAL || conversion.requestField == TensorProtoField::INT_VAL) {
+                // Values are zero padded in half_val or int_val container
+                if (conversion.countValues(requestInput) * blob->getTensorDesc().getPrecision().size() > requestByteSize) {
+                    SPDLOG_DEBUG("Failed to prepare batched inputs. Input: {} has more values than rows of request", name);
+                    return StatusCode::INVALID_VALUE_COUNT;
+                }
+                conversion.copyValues(requestInput, destination);
+            } else {
+                std::memcpy(destination, requestInput.tensor_content().data(), std::min(requestInput.tensor_content().size(), requestByteSize));
+            }
+            offset += batchedRequest->batchSize;
+        }
+        // fill rows not used in this batch so that stale data from previous inference does not affect performance
+        if (offset < maxBatchSize) {
+            std::memset(buffer + offset * rowByteSize, 0, (maxBatchSize - offset) * rowByteSize);
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status BatchingScheduler::splitOutputs(const Batch& batch, InferenceEngine::InferRequest& inferRequest) const {
+    for (const auto& [name, networkOutput] : modelInstance.getOutputsInfo()) {
+        InferenceEngine::Blob::Ptr blob;
+        try {
+            blob = inferRequest.GetBlob(networkOutput->getName());
+        } catch (const InferenceEngine::details::InferenceEngineException& e) {
+            Status status = StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
+            SPDLOG_ERROR("{}: {}", status.string(), e.what());
+            return status;
+        }
+        size_t offset = 0;
+        const size_t rowByteSize = blob->byteSize() / maxBatchSize;
+        for (auto* batchedRequest : batch.requests) {
+            if (batchedRequest->outputs) {
+                const auto& desc = blob->getTensorDesc();
+                auto dims = desc.getDims();
+                dims[0] = batchedRequest->batchSize;
+                auto slice = InferenceEngine::Blob::CreateFromData(std::make_shared<InferenceEngine::Data>("",
+                    InferenceEngine::TensorDesc(desc.getPrecision(), dims, desc.getLayout())));
+                slice->allocate();
+                std::memcpy(slice->buffer().as<char*>(), blob->cbuffer().as<const char*>() + offset * rowByteSize, batchedRequest->batchSize * rowByteSize);
+                batchedRequest->outputs->emplace(name, std::move(slice));
+                offset += batchedRequest->batchSize;
+                continue;
+            }
+            if (!isOutputRequested(*batchedRequest->request, networkOutput->getMappedName())) {
+                offset += batchedRequest->batchSize;
+                continue;
+            }
+            auto& tensorProto = (*batchedRequest->response->mutable_outputs())[networkOutput->getMappedName()];
+            auto status = serializeBlobBatchSliceToTensorProto(tensorProto, networkOutput, blob, offset, batchedRequest->batchSize, modelInstance.getModelConfig().isFp16Outputs());
+            if (!status.ok()) {
+                return status;
+            }
+            offset += batchedRequest->batchSize;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status BatchingScheduler::executeBatch(const Batch& batch) {
+    Timer timer;
+    using std::chrono::microseconds;
+    auto& metrics = modelInstance.getMetrics();
+
+    timer.start("get infer request");
+    PhaseScope streamWaitPhase(STREAM_WAIT_PHASE, &batch);
+    auto& inferRequestsQueue = modelInstance.getInferRequestsQueue();
+    ExecutingStreamIdGuard executingStreamIdGuard(inferRequestsQueue);
+    int executingInferId = executingStreamIdGuard.getId();
+    InferenceEngine::InferRequest& inferRequest = inferRequestsQueue.getInferRequest(executingInferId);
+    timer.stop("get infer request");
+    streamWaitPhase.end();
+    metrics.streamWait.observe(timer.elapsed<microseconds>("get infer request"));
+    SPDLOG_DEBUG("Getting infer req duration in model {}, version {}, nireq {}: {:.3f} ms",
+        modelInstance.getName(), modelInstance.getVersion(), executingInferId, timer.elapsed<microseconds>("get infer request") / 1000);
+
+    timer.start("deserialize");
+    PhaseScope deserializePhase(DESERIALIZE_PHASE, &batch);
+    auto& blobs = inputBlobs[executingInferId];
+    auto status = fillInputBlobs(batch, blobs);
+    if (!status.ok())
+        return status;
+    try {
+        for (const auto& [name, blob] : blobs) {
+            inferRequest.SetBlob(modelInstance.getInputsInfo().at(name)->getName(), blob);
+        }
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    }
+    timer.stop("deserialize");
+    deserializePhase.end();
+    metrics.deserialization.observe(timer.elapsed<microseconds>("deserialize"));
+    SPDLOG_DEBUG("Batch of {} requests with total batch size {} assembled in model {}, version {}, nireq {}: {:.3f} ms",
+        batch.requests.size(), batch.batchSize, modelInstance.getName(), modelInstance.getVersion(), executingInferId, timer.elapsed<microseconds>("deserialize") / 1000);
+
+    timer.start("prediction");
+    PhaseScope inferencePhase(INFERENCE_PHASE, &batch);
+    status = performInference(inferRequestsQueue, executingInferId, inferRequest, false,
+        std::chrono::microseconds(modelInstance.getModelConfig().getCompletionSpinMicroseconds()));
+    timer.stop("prediction");
+    inferencePhase.end();
+    metrics.inference.observe(timer.elapsed<microseconds>("prediction"));
+    if (!status.ok())
+        return status;
+    SPDLOG_DEBUG("Prediction duration in model {}, version {}, nireq {}: {:.3f} ms",
+        modelInstance.getName(), modelInstance.getVersion(), executingInferId, timer.elapsed<microseconds>("prediction") / 1000);
+
+    timer.start("serialize");
+    PhaseScope serializePhase(SERIALIZE_PHASE, &batch);
+    status = splitOutputs(batch, inferRequest);
+    timer.stop("serialize");
+    serializePhase.end();
+    metrics.serialization.observe(timer.elapsed<microseconds>("serialize"));
+    if (!status.ok())
+        return status;
+    SPDLOG_DEBUG("Serialization duration in model {}, version {}, nireq {}: {:.3f} ms",
+        modelInstance.getName(), modelInstance.getVersion(), executingInferId, timer.elapsed<microseconds>("serialize") / 1000);
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,127 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "batchtimeouttuner.hpp"
+#include "node.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+class ModelInstance;
+
+/**
+ * @brief Merges concurrent predict requests of a single model version into one inference.
+ *
+ * Network is loaded with batch size equal to max_batch_size. First request of a batch becomes its leader:
+ * it waits up to batch_timeout_microseconds for other requests to join, then executes the inference
+ * on behalf of all of them and splits outputs back to requests responses. Batch is dispatched earlier
+ * when it gets full. Unused rows of the network input are zero filled and their results are dropped.
+ * Requests may come either as predict requests or as blobs of pipeline nodes, both are merged into the same batches.
+ * With latency SLO set, timeout is chosen by BatchTimeoutTuner from observed traffic, up to batch_timeout_microseconds.
+ */
+class BatchingScheduler {
+    struct BatchedRequest {
+        const tensorflow::serving::PredictRequest* request = nullptr;
+        tensorflow::serving::PredictResponse* response = nullptr;
+        const BlobMap* inputs = nullptr;
+        BlobMap* outputs = nullptr;
+        size_t batchSize;
+    };
+
+    struct Batch {
+        std::vector<BatchedRequest*> requests;
+        size_t batchSize = 0;
+        bool closed = false;
+        bool finished = false;
+        Status status = StatusCode::OK;
+        std::condition_variable closedNotify;
+        std::condition_variable finishedNotify;
+    };
+
+    ModelInstance& modelInstance;
+    const size_t maxBatchSize;
+    const uint64_t batchTimeoutMicroseconds;
+
+    std::mutex mtx;
+    std::shared_ptr<Batch> formingBatch;
+
+    /**
+     * @brief Tunes timeout when latency SLO is set, nullptr for fixed timeout. Guarded by mtx
+     */
+    std::unique_ptr<BatchTimeoutTuner> timeoutTuner;
+
+    /**
+     * @brief Input blobs owned by scheduler for each infer request, sized for max batch
+     */
+    std::vector<std::unordered_map<std::string, InferenceEngine::Blob::Ptr>> inputBlobs;
+
+    void closeBatch(const std::shared_ptr<Batch>& batch);
+
+    Status schedule(BatchedRequest& batchedRequest);
+
+    Status fillInputBlobs(const Batch& batch, std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& blobs) const;
+    Status splitOutputs(const Batch& batch, InferenceEngine::InferRequest& inferRequest) const;
+    Status executeBatch(const Batch& batch);
+
+public:
+    BatchingScheduler(ModelInstance& modelInstance, size_t maxBatchSize, uint64_t batchTimeoutMicroseconds, uint64_t batchLatencySloMicroseconds = 0);
+
+    size_t getMaxBatchSize() const { return maxBatchSize; }
+    uint64_t getBatchTimeoutMicroseconds() const { return batchTimeoutMicroseconds; }
+
+    /**
+     * @brief Tuner of timeout, nullptr if timeout is fixed. Intended for monitoring only
+     */
+    const BatchTimeoutTuner* getTimeoutTuner() const { return timeoutTuner.get(); }
+
+    /**
+     * @brief Schedules already validated request for batched execution and blocks until its response is ready
+     *
+     * @param request
+     * @param response
+     *
+     * @return Status
+     */
+    Status execute(const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response);
+
+    /**
+     * @brief Schedules already validated inputs of pipeline node for batched execution and blocks until outputs are ready
+     *
+     * @param inputs blobs keyed by model input names, with the same batch size
+     * @param batchSize
+     * @param outputs filled with blobs owned by the caller, keyed by model output names
+     *
+     * @return Status
+     */
+    Status execute(const BlobMap& inputs, size_t batchSize, BlobMap& outputs);
+};
+
+}  // namespace ovms
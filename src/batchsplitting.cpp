@@ -0,0 +1,243 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "batchsplitting.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/types.h"
+#pragma GCC diagnostic pop
+
+#include "modelinstance.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Number of bytes of tensor data per first dimension row, 0 if tensor data is not in tensor_content
+ */
+size_t getRowByteSize(const tensorflow::TensorProto& tensor) {
+    const auto& shape = tensor.tensor_shape();
+    if (shape.dim_size() == 0 || shape.dim(0).size() <= 0 || tensor.dtype() == tensorflow::DataType::DT_STRING) {
+        return 0;
+    }
+    // dimensions come from request, product is checked so that it cannot wrap around to match content size
+    size_t rowSize = tensorflow::DataTypeSize(tensor.dtype());
+    for (int i = 1; i < shape.dim_size(); i++) {
+        if (shape.dim(i).size() <= 0 || __builtin_mul_overflow(rowSize, static_cast<size_t>(shape.dim(i).size()), &rowSize)) {
+            return 0;
+        }
+    }
+    size_t byteSize = 0;
+    if (rowSize == 0 || __builtin_mul_overflow(rowSize, static_cast<size_t>(shape.dim(0).size()), &byteSize) ||
+        tensor.tensor_content().size() != byteSize) {
+        return 0;
+    }
+    return rowSize;
+}
+}  // namespace
+
+bool isBatchSplitRequired(const ModelInstance& modelInstance, const tensorflow::serving::PredictRequest& request) {
+    const auto& config = modelInstance.getModelConfig();
+    if (!config.isSplitBatch() || config.getMaxBatchSize() > 0) {
+        return false;
+    }
+    const size_t batchSize = modelInstance.getBatchSize();
+    if (batchSize == 0) {
+        return false;
+    }
+    for (const auto& [name, input] : request.inputs()) {
+        if (input.tensor_shape().dim_size() > 0 && input.tensor_shape().dim(0).size() > 0 &&
+            static_cast<size_t>(input.tensor_shape().dim(0).size()) > batchSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t getSubBatchesCount(const tensorflow::serving::PredictRequest& request, size_t batchSize) {
+    if (request.inputs().empty() || batchSize == 0) {
+        return 0;
+    }
+    const auto& firstInputShape = request.inputs().begin()->second.tensor_shape();
+    if (firstInputShape.dim_size() == 0 || firstInputShape.dim(0).size() <= 0) {
+        return 0;
+    }
+    const size_t requestBatchSize = firstInputShape.dim(0).size();
+    if (requestBatchSize <= batchSize) {
+        return 0;
+    }
+    for (const auto& [name, input] : request.inputs()) {
+        // rows of each input are bounded by its data, so that batch size cannot exceed the request
+        if (getRowByteSize(input) == 0 || static_cast<size_t>(input.tensor_shape().dim(0).size()) != requestBatchSize) {
+            // left for validation of original request
+            SPDLOG_DEBUG("Request input: {} cannot be split into sub-batches", name);
+            return 0;
+        }
+    }
+    return (requestBatchSize + batchSize - 1) / batchSize;
+}
+
+void prepareSubBatchRequest(const tensorflow::serving::PredictRequest& request, size_t batchSize, size_t index,
+    tensorflow::serving::PredictRequest& subRequest) {
+    const size_t requestBatchSize = request.inputs().begin()->second.tensor_shape().dim(0).size();
+    *subRequest.mutable_model_spec() = request.model_spec();
+    *subRequest.mutable_output_filter() = request.output_filter();
+    const size_t firstRow = index * batchSize;
+    const size_t rows = std::min(batchSize, requestBatchSize - firstRow);
+    for (const auto& [name, input] : request.inputs()) {
+        const size_t rowSize = getRowByteSize(input);
+        auto& subInput = (*subRequest.mutable_inputs())[name];
+        subInput.set_dtype(input.dtype());
+        *subInput.mutable_tensor_shape() = input.tensor_shape();
+        subInput.mutable_tensor_shape()->mutable_dim(0)->set_size(batchSize);
+        auto content = subInput.mutable_tensor_content();
+        content->reserve(batchSize * rowSize);
+        content->assign(input.tensor_content(), firstRow * rowSize, rows * rowSize);
+        content->resize(batchSize * rowSize, '\0');
+    }
+}
+
+Status mergeSubBatchResponses(const std::vector<tensorflow::serving::PredictResponse>& subResponses, size_t batchSize,
+    size_t requestBatchSize, tensorflow::serving::PredictResponse& response) {
+    if (subResponses.empty()) {
+        return StatusCode::OK;
+    }
+    for (const auto& [name, firstOutput] : subResponses.front().outputs()) {
+        const size_t rowSize = getRowByteSize(firstOutput);
+        if (rowSize == 0 || static_cast<size_t>(firstOutput.tensor_shape().dim(0).size()) != batchSize) {
+            const std::string details = "Output: " + name + " does not have batch in first dimension";
+            SPDLOG_DEBUG("Cannot merge sub-batches outputs - {}", details);
+            return Status(StatusCode::OV_INTERNAL_SERIALIZATION_ERROR, details);
+        }
+        auto& output = (*response.mutable_outputs())[name];
+        output.set_dtype(firstOutput.dtype());
+        *output.mutable_tensor_shape() = firstOutput.tensor_shape();
+        output.mutable_tensor_shape()->mutable_dim(0)->set_size(requestBatchSize);
+        auto content = output.mutable_tensor_content();
+        content->clear();
+        content->reserve(requestBatchSize * rowSize);
+        for (const auto& subResponse : subResponses) {
+            auto subOutput = subResponse.outputs().find(name);
+            if (subOutput == subResponse.outputs().end() || subOutput->second.tensor_content().size() != batchSize * rowSize) {
+                const std::string details = "Output: " + name + " differs between sub-batches";
+                SPDLOG_DEBUG("Cannot merge sub-batches outputs - {}", details);
+                return Status(StatusCode::OV_INTERNAL_SERIALIZATION_ERROR, details);
+            }
+            const size_t rows = std::min(batchSize, requestBatchSize - content->size() / rowSize);
+            content->append(subOutput->second.tensor_content(), 0, rows * rowSize);
+        }
+    }
+    return StatusCode::OK;
+}
+
+size_t getMergeableBatchSize(const tensorflow::serving::PredictRequest& request) {
+    if (request.inputs().empty()) {
+        return 0;
+    }
+    const auto& firstInputShape = request.inputs().begin()->second.tensor_shape();
+    if (firstInputShape.dim_size() == 0) {
+        return 0;
+    }
+    const size_t batchSize = firstInputShape.dim(0).size();
+    for (const auto& [name, input] : request.inputs()) {
+        if (getRowByteSize(input) == 0 || static_cast<size_t>(input.tensor_shape().dim(0).size()) != batchSize) {
+            return 0;
+        }
+    }
+    return batchSize;
+}
+
+bool haveSameSampleShapes(const tensorflow::serving::PredictRequest& first, const tensorflow::serving::PredictRequest& second) {
+    if (first.inputs().size() != second.inputs().size()) {
+        return false;
+    }
+    for (const auto& [name, input] : first.inputs()) {
+        auto it = second.inputs().find(name);
+        if (it == second.inputs().end() || it->second.dtype() != input.dtype()) {
+            return false;
+        }
+        const auto& shape = input.tensor_shape();
+        const auto& otherShape = it->second.tensor_shape();
+        if (shape.dim_size() != otherShape.dim_size()) {
+            return false;
+        }
+        for (int i = 1; i < shape.dim_size(); i++) {
+            if (shape.dim(i).size() != otherShape.dim(i).size()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void mergeRequestBatches(const std::vector<const tensorflow::serving::PredictRequest*>& requests, tensorflow::serving::PredictRequest& merged) {
+    if (requests.empty()) {
+        return;
+    }
+    const auto& first = *requests.front();
+    *merged.mutable_model_spec() = first.model_spec();
+    *merged.mutable_output_filter() = first.output_filter();
+    size_t batchSize = 0;
+    for (const auto* request : requests) {
+        batchSize += getMergeableBatchSize(*request);
+    }
+    for (const auto& [name, firstInput] : first.inputs()) {
+        auto& input = (*merged.mutable_inputs())[name];
+        input.set_dtype(firstInput.dtype());
+        *input.mutable_tensor_shape() = firstInput.tensor_shape();
+        input.mutable_tensor_shape()->mutable_dim(0)->set_size(batchSize);
+        auto content = input.mutable_tensor_content();
+        content->clear();
+        content->reserve(batchSize * getRowByteSize(firstInput));
+        for (const auto* request : requests) {
+            content->append(request->inputs().at(name).tensor_content());
+        }
+    }
+}
+
+Status splitResponseBatches(const tensorflow::serving::PredictResponse& merged, const std::vector<size_t>& batchSizes,
+    const std::vector<tensorflow::serving::PredictResponse*>& responses) {
+    const size_t batchSize = std::accumulate(batchSizes.begin(), batchSizes.end(), size_t(0));
+    for (const auto& [name, mergedOutput] : merged.outputs()) {
+        const size_t rowSize = getRowByteSize(mergedOutput);
+        if (rowSize == 0 || static_cast<size_t>(mergedOutput.tensor_shape().dim(0).size()) != batchSize) {
+            const std::string details = "Output: " + name + " does not have batch in first dimension";
+            SPDLOG_DEBUG("Cannot split merged requests outputs - {}", details);
+            return Status(StatusCode::OV_INTERNAL_SERIALIZATION_ERROR, details);
+        }
+    }
+    for (const auto& [name, mergedOutput] : merged.outputs()) {
+        const size_t rowSize = getRowByteSize(mergedOutput);
+        size_t offset = 0;
+        for (size_t i = 0; i < responses.size(); i++) {
+            auto& output = (*responses[i]->mutable_outputs())[name];
+            output.set_dtype(mergedOutput.dtype());
+            *output.mutable_tensor_shape() = mergedOutput.tensor_shape();
+            output.mutable_tensor_shape()->mutable_dim(0)->set_size(batchSizes[i]);
+            output.mutable_tensor_content()->assign(mergedOutput.tensor_content(), offset * rowSize, batchSizes[i] * rowSize);
+            offset += batchSizes[i];
+        }
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,114 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+class ModelInstance;
+
+/**
+ * @brief Checks if request is split into sub-batches, which is when split_batch is enabled without dynamic batching
+ * and batch of request inputs exceeds network batch size
+ *
+ * @param modelInstance
+ * @param request
+ *
+ * @return bool
+ */
+bool isBatchSplitRequired(const ModelInstance& modelInstance, const tensorflow::serving::PredictRequest& request);
+
+/**
+ * @brief Gets number of sub-requests with network batch size request inputs are split into along first dimension
+ *
+ * Only requests with data of all inputs in tensor_content matching their shapes and the same positive first
+ * dimension are split.
+ *
+ * @param request
+ * @param batchSize network batch size
+ *
+ * @return number of sub-requests, 0 if request is not split
+ */
+size_t getSubBatchesCount(const tensorflow::serving::PredictRequest& request, size_t batchSize);
+
+/**
+ * @brief Prepares sub-request with given index of request split by getSubBatchesCount
+ *
+ * Sub-requests are prepared one at a time, so that only those in progress are kept in memory. Last sub-request
+ * is filled with zeros after request data.
+ *
+ * @param request
+ * @param batchSize network batch size
+ * @param index index of sub-request, lower than number of sub-requests
+ * @param subRequest
+ */
+void prepareSubBatchRequest(const tensorflow::serving::PredictRequest& request, size_t batchSize, size_t index,
+    tensorflow::serving::PredictRequest& subRequest);
+
+/**
+ * @brief Concatenates outputs of sub-requests responses along first dimension, dropping results of zero filled rows
+ *
+ * @param subResponses responses in order of sub-requests
+ * @param batchSize network batch size
+ * @param requestBatchSize batch size of request before splitting
+ * @param response
+ *
+ * @return Status
+ */
+Status mergeSubBatchResponses(const std::vector<tensorflow::serving::PredictResponse>& subResponses, size_t batchSize,
+    size_t requestBatchSize, tensorflow::serving::PredictResponse& response);
+
+/**
+ * @brief Gets batch size of request, which is first dimension shared by all inputs with data in tensor_content
+ *
+ * @return batch size or 0 if inputs data cannot be merged with other requests along first dimension
+ */
+size_t getMergeableBatchSize(const tensorflow::serving::PredictRequest& request);
+
+/**
+ * @brief Checks if requests have the same inputs, with the same precisions and dimensions apart from the first one
+ */
+bool haveSameSampleShapes(const tensorflow::serving::PredictRequest& first, const tensorflow::serving::PredictRequest& second);
+
+/**
+ * @brief Concatenates inputs of requests with the same sample shapes along first dimension
+ *
+ * @param requests requests with mergeable batch size, model spec is taken from the first one
+ * @param merged
+ */
+void mergeRequestBatches(const std::vector<const tensorflow::serving::PredictRequest*>& requests, tensorflow::serving::PredictRequest& merged);
+
+/**
+ * @brief Splits outputs of merged request response along first dimension into responses of merged requests
+ *
+ * @param merged response of request merged from requests with given batch sizes
+ * @param batchSizes
+ * @param responses in order of batch sizes
+ *
+ * @return Status
+ */
+Status splitResponseBatches(const tensorflow::serving::PredictResponse& merged, const std::vector<size_t>& batchSizes,
+    const std::vector<tensorflow::serving::PredictResponse*>& responses);
+
+}  // namespace ovms
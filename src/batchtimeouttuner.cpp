@@ -0,0 +1,126 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "batchtimeouttuner.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ovms {
+
+namespace {
+// weight of the newest inference in moving estimates
+constexpr double ESTIMATE_WEIGHT = 0.1;
+constexpr double TAIL_DEVIATIONS = 3;
+}  // namespace
+
+BatchTimeoutTuner::BatchTimeoutTuner(size_t maxBatchSize, uint64_t maxTimeoutMicroseconds, uint64_t latencySloMicroseconds) :
+    maxBatchSize(maxBatchSize),
+    maxTimeoutMicroseconds(maxTimeoutMicroseconds),
+    latencySloMicroseconds(latencySloMicroseconds),
+    inferenceEstimates(maxBatchSize + 1),
+    timeoutMicroseconds(maxTimeoutMicroseconds),
+    targetBatchSize(maxBatchSize) {}
+
+void BatchTimeoutTuner::recordArrival(std::chrono::steady_clock::time_point time, size_t rows) {
+    arrivals[nextArrival] = {time, rows};
+    nextArrival = (nextArrival + 1) % ARRIVALS_WINDOW;
+    if (arrivalsCount < ARRIVALS_WINDOW) {
+        ++arrivalsCount;
+    }
+}
+
+void BatchTimeoutTuner::recordInference(size_t batchSize, double microseconds) {
+    if (batchSize == 0 || batchSize > maxBatchSize) {
+        return;
+    }
+    auto& estimate = inferenceEstimates[batchSize];
+    if (!estimate.observed) {
+        estimate = {microseconds, 0, true};
+        return;
+    }
+    estimate.deviation += ESTIMATE_WEIGHT * (std::abs(microseconds - estimate.mean) - estimate.deviation);
+    estimate.mean += ESTIMATE_WEIGHT * (microseconds - estimate.mean);
+}
+
+double BatchTimeoutTuner::getArrivalRate() const {
+    return arrivalRate.load(std::memory_order_relaxed);
+}
+
+const BatchTimeoutTuner::InferenceEstimate* BatchTimeoutTuner::findEstimate(size_t batchSize) const {
+    // network runs with max batch size, so time of the nearest larger batch is closer than that of smaller one
+    for (size_t size = batchSize; size <= maxBatchSize; ++size) {
+        if (inferenceEstimates[size].observed) {
+            return &inferenceEstimates[size];
+        }
+    }
+    for (size_t size = batchSize; size > 0; --size) {
+        if (inferenceEstimates[size].observed) {
+            return &inferenceEstimates[size];
+        }
+    }
+    return nullptr;
+}
+
+void BatchTimeoutTuner::update() {
+    if (arrivalsCount < 2) {
+        return;
+    }
+    const auto& oldest = arrivals[arrivalsCount < ARRIVALS_WINDOW ? 0 : nextArrival];
+    const auto& newest = arrivals[(nextArrival + ARRIVALS_WINDOW - 1) % ARRIVALS_WINDOW];
+    const double span = std::chrono::duration<double, std::micro>(newest.time - oldest.time).count();
+    if (span <= 0) {
+        return;
+    }
+    size_t rows = 0;
+    for (size_t i = 0; i < arrivalsCount; ++i) {
+        rows += arrivals[i].rows;
+    }
+    // rows of the oldest arrival came before the measured span
+    const double rowsPerMicrosecond = (rows - oldest.rows) / span;
+    arrivalRate.store(rowsPerMicrosecond * 1e6, std::memory_order_relaxed);
+
+    double bestThroughput = 0;
+    double bestWait = 0;
+    size_t bestBatchSize = 0;
+    for (size_t batchSize = 1; batchSize <= maxBatchSize; ++batchSize) {
+        const double wait = (batchSize - 1) / rowsPerMicrosecond;
+        if (wait > maxTimeoutMicroseconds) {
+            break;
+        }
+        const auto* estimate = findEstimate(batchSize);
+        if (estimate == nullptr) {
+            return;
+        }
+        if (wait + estimate->mean + TAIL_DEVIATIONS * estimate->deviation > latencySloMicroseconds) {
+            break;
+        }
+        const double throughput = batchSize / std::max(estimate->mean, 1.0);
+        if (throughput > bestThroughput) {
+            bestThroughput = throughput;
+            bestWait = wait;
+            bestBatchSize = batchSize;
+        }
+    }
+    if (bestBatchSize == 0) {
+        // even single request misses SLO, waiting would only make it worse
+        bestBatchSize = 1;
+        bestWait = 0;
+    }
+    timeoutMicroseconds.store(static_cast<uint64_t>(std::ceil(bestWait)), std::memory_order_relaxed);
+    targetBatchSize.store(bestBatchSize, std::memory_order_relaxed);
+}
+
+}  // namespace ovms
@@ -0,0 +1,100 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Chooses dynamic batching timeout from observed request arrival rate and inference time of batches
+ *
+ * Arrival rate is estimated from the sliding window of recent arrivals. Inference time is tracked per batch size
+ * as moving mean and mean deviation, their sum with three deviations is used as tail estimate. Timeout is the time
+ * needed for arrival of rows filling the batch size with the highest throughput among those whose waiting and tail
+ * inference time fit within latency SLO. At low traffic this falls back to no waiting. Until arrivals
+ * and inferences are observed the maximum timeout is used.
+ *
+ * Not thread safe apart from getters used for monitoring, callers serialize record and update calls.
+ */
+class BatchTimeoutTuner {
+public:
+    static constexpr size_t ARRIVALS_WINDOW = 128;
+
+    BatchTimeoutTuner(size_t maxBatchSize, uint64_t maxTimeoutMicroseconds, uint64_t latencySloMicroseconds);
+
+    void recordArrival(std::chrono::steady_clock::time_point time, size_t rows);
+
+    void recordInference(size_t batchSize, double microseconds);
+
+    /**
+     * @brief Recomputes timeout from current estimates
+     */
+    void update();
+
+    uint64_t getTimeoutMicroseconds() const {
+        return timeoutMicroseconds.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Batch size expected to be dispatched with current timeout
+     */
+    size_t getTargetBatchSize() const {
+        return targetBatchSize.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Estimated arrival rate in rows per second, 0 if not known yet
+     */
+    double getArrivalRate() const;
+
+private:
+    struct Arrival {
+        std::chrono::steady_clock::time_point time;
+        size_t rows;
+    };
+
+    struct InferenceEstimate {
+        double mean = 0;
+        double deviation = 0;
+        bool observed = false;
+    };
+
+    const size_t maxBatchSize;
+    const uint64_t maxTimeoutMicroseconds;
+    const uint64_t latencySloMicroseconds;
+
+    std::array<Arrival, ARRIVALS_WINDOW> arrivals;
+    size_t arrivalsCount = 0;
+    size_t nextArrival = 0;
+
+    /**
+     * @brief Indexed by batch size
+     */
+    std::vector<InferenceEstimate> inferenceEstimates;
+
+    std::atomic<uint64_t> timeoutMicroseconds;
+    std::atomic<size_t> targetBatchSize;
+    std::atomic<double> arrivalRate{0};
+
+    const InferenceEstimate* findEstimate(size_t batchSize) const;
+};
+
+}  // namespace ovms
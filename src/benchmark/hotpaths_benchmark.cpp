@@ -0,0 +1,340 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "../deserialization.hpp"
+#include "../entry_node.hpp"
+#include "../exit_node.hpp"
+#include "../ovinferrequestsqueue.hpp"
+#include "../prediction_service_utils.hpp"
+#include "../rest_parser.hpp"
+#include "../rest_utils.hpp"
+#include "../serialization.hpp"
+#include "../tensorinfo.hpp"
+#include "../test/ovtestutils.hpp"
+
+// Benchmarks of request processing steps executed for every predict request, apart from inference itself.
+// Each benchmark takes precision and batch size of tensor shaped as typical image model input or classification output.
+
+namespace {
+
+const InferenceEngine::SizeVector IMAGE_SHAPE{3, 224, 224};
+const InferenceEngine::SizeVector CLASSIFICATION_SHAPE{1000};
+
+InferenceEngine::Precision getPrecision(const benchmark::State& state) {
+    return static_cast<InferenceEngine::Precision::ePrecision>(state.range(0));
+}
+
+InferenceEngine::SizeVector getShape(const benchmark::State& state, const InferenceEngine::SizeVector& sampleShape) {
+    InferenceEngine::SizeVector shape{static_cast<size_t>(state.range(1))};
+    shape.insert(shape.end(), sampleShape.begin(), sampleShape.end());
+    return shape;
+}
+
+size_t getElementsCount(const InferenceEngine::SizeVector& shape) {
+    return std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+}
+
+std::shared_ptr<ovms::TensorInfo> createTensorInfo(InferenceEngine::Precision precision, const InferenceEngine::SizeVector& shape) {
+    return std::make_shared<ovms::TensorInfo>("input", precision, shape, shape.size() == 4 ? InferenceEngine::Layout::NCHW : InferenceEngine::Layout::NC);
+}
+
+InferenceEngine::Blob::Ptr createBlob(InferenceEngine::Precision precision, const InferenceEngine::SizeVector& shape) {
+    auto blob = InferenceEngine::Blob::CreateFromData(std::make_shared<InferenceEngine::Data>("output",
+        InferenceEngine::TensorDesc(precision, shape, InferenceEngine::TensorDesc::getLayoutByDims(shape))));
+    blob->allocate();
+    std::memset(blob->buffer().as<char*>(), 1, blob->byteSize());
+    return blob;
+}
+
+tensorflow::TensorProto createTensorProto(InferenceEngine::Precision precision, const InferenceEngine::SizeVector& shape) {
+    tensorflow::TensorProto proto;
+    proto.set_dtype(ovms::TensorInfo::getPrecisionAsDataType(precision));
+    for (auto dim : shape) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    const size_t count = getElementsCount(shape);
+    if (precision == InferenceEngine::Precision::FP16) {
+        for (size_t i = 0; i < count; i++) {
+            proto.add_half_val(1);
+        }
+    } else if (precision == InferenceEngine::Precision::U16) {
+        for (size_t i = 0; i < count; i++) {
+            proto.add_int_val(1);
+        }
+    } else {
+        proto.mutable_tensor_content()->assign(count * precision.size(), 1);
+    }
+    return proto;
+}
+
+void writeNestedArray(std::stringstream& json, const InferenceEngine::SizeVector& shape, size_t dim) {
+    json << "[";
+    for (size_t i = 0; i < shape[dim]; i++) {
+        json << (i > 0 ? "," : "");
+        if (dim + 1 < shape.size()) {
+            writeNestedArray(json, shape, dim + 1);
+        } else {
+            json << "0.5";
+        }
+    }
+    json << "]";
+}
+
+void setBytesProcessed(benchmark::State& state, InferenceEngine::Precision precision, const InferenceEngine::SizeVector& shape) {
+    state.SetBytesProcessed(state.iterations() * getElementsCount(shape) * precision.size());
+    state.SetLabel(precision.name());
+}
+
+void precisionsAndBatchSizes(benchmark::internal::Benchmark* benchmark) {
+    for (auto precision : {InferenceEngine::Precision::FP32, InferenceEngine::Precision::FP16, InferenceEngine::Precision::U8, InferenceEngine::Precision::I32}) {
+        for (int batchSize : {1, 8}) {
+            benchmark->Args({static_cast<int64_t>(precision), batchSize});
+        }
+    }
+}
+
+void batchSizes(benchmark::internal::Benchmark* benchmark) {
+    for (int batchSize : {1, 8}) {
+        benchmark->Args({static_cast<int64_t>(InferenceEngine::Precision::FP32), batchSize});
+    }
+}
+
+void BM_RestParserRow(benchmark::State& state) {
+    const auto shape = getShape(state, CLASSIFICATION_SHAPE);
+    std::stringstream json;
+    json << "{\"signature_name\":\"serving_default\",\"instances\":[";
+    for (size_t i = 0; i < shape[0]; i++) {
+        json << (i > 0 ? "," : "");
+        writeNestedArray(json, shape, 1);
+    }
+    json << "]}";
+    const std::string body = json.str();
+    ovms::tensor_map_t inputs{{"input", createTensorInfo(getPrecision(state), shape)}};
+    for (auto _ : state) {
+        ovms::RestParser parser(inputs);
+        benchmark::DoNotOptimize(parser.parse(body.c_str()));
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_RestParserRow)->Apply(batchSizes);
+
+void BM_RestParserRowInsitu(benchmark::State& state) {
+    const auto shape = getShape(state, CLASSIFICATION_SHAPE);
+    std::stringstream json;
+    json << "{\"signature_name\":\"serving_default\",\"instances\":[";
+    for (size_t i = 0; i < shape[0]; i++) {
+        json << (i > 0 ? "," : "");
+        writeNestedArray(json, shape, 1);
+    }
+    json << "]}";
+    const std::string body = json.str();
+    ovms::tensor_map_t inputs{{"input", createTensorInfo(getPrecision(state), shape)}};
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string request = body;
+        state.ResumeTiming();
+        ovms::RestParser parser(inputs);
+        benchmark::DoNotOptimize(parser.parseInsitu(request.data()));
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_RestParserRowInsitu)->Args({static_cast<int64_t>(InferenceEngine::Precision::FP32), 1})->Args({static_cast<int64_t>(InferenceEngine::Precision::FP32), 64});
+
+void BM_RestParserColumn(benchmark::State& state) {
+    const auto shape = getShape(state, CLASSIFICATION_SHAPE);
+    std::stringstream json;
+    json << "{\"signature_name\":\"serving_default\",\"inputs\":{\"input\":";
+    writeNestedArray(json, shape, 0);
+    json << "}}";
+    const std::string body = json.str();
+    ovms::tensor_map_t inputs{{"input", createTensorInfo(getPrecision(state), shape)}};
+    for (auto _ : state) {
+        ovms::RestParser parser(inputs);
+        benchmark::DoNotOptimize(parser.parse(body.c_str()));
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_RestParserColumn)->Apply(batchSizes);
+
+void BM_MakeJsonFromPredictResponse(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, CLASSIFICATION_SHAPE);
+    tensorflow::serving::PredictResponse response;
+    (*response.mutable_outputs())["output"] = createTensorProto(precision, shape);
+    for (auto _ : state) {
+        std::string json;
+        benchmark::DoNotOptimize(ovms::makeJsonFromPredictResponse(response, &json, ovms::Order::COLUMN));
+    }
+    setBytesProcessed(state, precision, shape);
+}
+BENCHMARK(BM_MakeJsonFromPredictResponse)->Apply(precisionsAndBatchSizes);
+
+void BM_SerializeBlobToTensorProto(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, IMAGE_SHAPE);
+    auto tensorInfo = createTensorInfo(precision, shape);
+    auto blob = createBlob(precision, shape);
+    for (auto _ : state) {
+        tensorflow::TensorProto proto;
+        benchmark::DoNotOptimize(ovms::serializeBlobToTensorProto(proto, tensorInfo, blob));
+    }
+    setBytesProcessed(state, precision, shape);
+}
+BENCHMARK(BM_SerializeBlobToTensorProto)->Apply(precisionsAndBatchSizes);
+
+// response proto reused between iterations, as output protos cleared and filled in place, keeps allocated dims
+void BM_SerializeBlobToReusedTensorProto(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, IMAGE_SHAPE);
+    auto tensorInfo = createTensorInfo(precision, shape);
+    auto blob = createBlob(precision, shape);
+    tensorflow::TensorProto proto;
+    for (auto _ : state) {
+        proto.Clear();
+        benchmark::DoNotOptimize(ovms::serializeBlobToTensorProto(proto, tensorInfo, blob));
+    }
+    setBytesProcessed(state, precision, shape);
+}
+BENCHMARK(BM_SerializeBlobToReusedTensorProto)->Apply(precisionsAndBatchSizes);
+
+void BM_DeserializePredictRequest(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, IMAGE_SHAPE);
+    ovms::tensor_map_t inputs{{"input", createTensorInfo(precision, shape)}};
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())["input"] = createTensorProto(precision, shape);
+    // SetBlob of mocked infer request does nothing, so that only request deserialization is measured
+    auto mockInferRequest = std::make_shared<NiceMock<MockIInferRequest>>();
+    InferenceEngine::InferRequest inferRequest(mockInferRequest);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ovms::deserializePredictRequest<ovms::ConcreteTensorProtoDeserializator>(request, inputs, inferRequest));
+    }
+    setBytesProcessed(state, precision, shape);
+}
+BENCHMARK(BM_DeserializePredictRequest)->Apply(precisionsAndBatchSizes);
+
+void BM_DeserializeManyInputsRequest(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, IMAGE_SHAPE);
+    const int inputsCount = 8;
+    ovms::tensor_map_t inputs;
+    tensorflow::serving::PredictRequest request;
+    for (int i = 0; i < inputsCount; i++) {
+        const std::string name = "input" + std::to_string(i);
+        inputs[name] = std::make_shared<ovms::TensorInfo>(name, precision, shape, InferenceEngine::Layout::NCHW);
+        (*request.mutable_inputs())[name] = createTensorProto(precision, shape);
+    }
+    auto mockInferRequest = std::make_shared<NiceMock<MockIInferRequest>>();
+    InferenceEngine::InferRequest inferRequest(mockInferRequest);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ovms::deserializePredictRequest<ovms::ConcreteTensorProtoDeserializator>(request, inputs, inferRequest));
+    }
+    state.SetBytesProcessed(state.iterations() * inputsCount * getElementsCount(shape) * precision.size());
+    state.SetLabel(precision.name());
+}
+BENCHMARK(BM_DeserializeManyInputsRequest)->Args({static_cast<int64_t>(InferenceEngine::Precision::FP16), 1})->Args({static_cast<int64_t>(InferenceEngine::Precision::FP16), 8})->UseRealTime();
+
+void BM_EntryNodeDeserialize(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, IMAGE_SHAPE);
+    auto proto = createTensorProto(precision, shape);
+    tensorflow::serving::PredictRequest request;
+    ovms::EntryNode entryNode(&request);
+    for (auto _ : state) {
+        InferenceEngine::Blob::Ptr blob;
+        benchmark::DoNotOptimize(entryNode.deserialize(proto, blob));
+    }
+    setBytesProcessed(state, precision, shape);
+}
+BENCHMARK(BM_EntryNodeDeserialize)->Args({static_cast<int64_t>(InferenceEngine::Precision::FP32), 1})->Args({static_cast<int64_t>(InferenceEngine::Precision::FP32), 8})->Args({static_cast<int64_t>(InferenceEngine::Precision::U8), 1})->Args({static_cast<int64_t>(InferenceEngine::Precision::I32), 1});
+
+void BM_ExitNodeSerialize(benchmark::State& state) {
+    const auto precision = getPrecision(state);
+    const auto shape = getShape(state, IMAGE_SHAPE);
+    auto blob = createBlob(precision, shape);
+    tensorflow::serving::PredictResponse response;
+    ovms::ExitNode exitNode(&response);
+    for (auto _ : state) {
+        tensorflow::TensorProto proto;
+        benchmark::DoNotOptimize(exitNode.serialize(blob, proto));
+    }
+    setBytesProcessed(state, precision, shape);
+}
+BENCHMARK(BM_ExitNodeSerialize)->Apply(precisionsAndBatchSizes);
+
+const int STREAMS_COUNT = 4;
+std::unique_ptr<ovms::OVInferRequestsQueue> inferRequestsQueue;
+
+void BM_InferRequestsQueueGetAndReturn(benchmark::State& state) {
+    static InferenceEngine::Core engine;
+    static InferenceEngine::ExecutableNetwork network = engine.LoadNetwork(
+        engine.ReadNetwork(std::filesystem::current_path().u8string() + "/src/test/dummy/1/dummy.xml"), "CPU");
+    if (state.thread_index == 0) {
+        inferRequestsQueue = std::make_unique<ovms::OVInferRequestsQueue>(network, STREAMS_COUNT);
+    }
+    for (auto _ : state) {
+        int streamId = inferRequestsQueue->waitForIdleStream();
+        benchmark::DoNotOptimize(streamId);
+        inferRequestsQueue->returnStream(streamId);
+    }
+    if (state.thread_index == 0) {
+        inferRequestsQueue.reset();
+    }
+}
+// More threads than streams make callers wait for streams returned by others
+BENCHMARK(BM_InferRequestsQueueGetAndReturn)->ThreadRange(1, 4 * STREAMS_COUNT)->UseRealTime();
+
+// Runs dummy model, much faster than handoff to stream thread, with StartAsync and Wait or synchronously on calling thread.
+// p50 of inline_inference is the median aggregate of repetitions, e.g. --benchmark_repetitions=20
+void BM_PerformInference(benchmark::State& state) {
+    static InferenceEngine::Core engine;
+    static InferenceEngine::ExecutableNetwork network = engine.LoadNetwork(
+        engine.ReadNetwork(std::filesystem::current_path().u8string() + "/src/test/dummy/1/dummy.xml"), "CPU");
+    const bool inlineExecution = state.range(0);
+    ovms::OVInferRequestsQueue queue(network, 1);
+    int streamId = queue.waitForIdleStream();
+    auto& inferRequest = queue.getInferRequest(streamId);
+    for (auto _ : state) {
+        auto status = ovms::performInference(queue, streamId, inferRequest, inlineExecution);
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+    }
+    queue.returnStream(streamId);
+    state.SetLabel(inlineExecution ? "inline" : "async");
+}
+BENCHMARK(BM_PerformInference)->Arg(0)->Arg(1)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,400 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "../localfilesystem.hpp"
+#include "../logging.hpp"
+#include "../modelinstanceunloadguard.hpp"
+#include "../modelmanager.hpp"
+#include "../prediction_service_utils.hpp"
+
+// Measures model lifecycle: cold start, full reload of config and single version bump, on local filesystem and on
+// synthetic remote one standing for S3/GCS. Models are copies of the dummy test model, so times are dominated by
+// model manager and filesystem overhead rather than by network compilation.
+
+namespace {
+
+namespace fs = std::filesystem;
+
+const std::string DUMMY_MODEL_DIRECTORY = fs::current_path().u8string() + "/src/test/dummy/1";
+const std::string INPUT_NAME = "b";
+const int INPUT_SIZE = 10;
+
+enum Backend {
+    LOCAL,
+    REMOTE
+};
+
+/**
+ * @brief Local directory served with latency of object storage requests and limited download bandwidth
+ *
+ * Versions are downloaded to temporary directory like for S3 and GCS, so that model manager removes it after loading.
+ */
+class SyntheticRemoteFileSystem : public ovms::LocalFileSystem {
+    static constexpr std::chrono::milliseconds REQUEST_LATENCY{20};
+    static constexpr double BANDWIDTH_BYTES_PER_SECOND = 100.0 * 1024 * 1024;
+
+    static void request() {
+        std::this_thread::sleep_for(REQUEST_LATENCY);
+    }
+
+public:
+    ovms::StatusCode fileExists(const std::string& path, bool* exists) override {
+        request();
+        return LocalFileSystem::fileExists(path, exists);
+    }
+
+    ovms::StatusCode isDirectory(const std::string& path, bool* is_dir) override {
+        request();
+        return LocalFileSystem::isDirectory(path, is_dir);
+    }
+
+    ovms::StatusCode getDirectoryContents(const std::string& path, ovms::files_list_t* contents) override {
+        request();
+        return LocalFileSystem::getDirectoryContents(path, contents);
+    }
+
+    ovms::StatusCode getDirectorySubdirs(const std::string& path, ovms::files_list_t* subdirs) override {
+        request();
+        return LocalFileSystem::getDirectorySubdirs(path, subdirs);
+    }
+
+    ovms::StatusCode getDirectoryFiles(const std::string& path, ovms::files_list_t* files) override {
+        request();
+        return LocalFileSystem::getDirectoryFiles(path, files);
+    }
+
+    ovms::StatusCode downloadModelVersions(const std::string& path, std::string* local_path, const std::vector<ovms::model_version_t>& versions) override {
+        auto sc = createTempPath(local_path);
+        if (sc != ovms::StatusCode::OK) {
+            return sc;
+        }
+        uintmax_t bytes = 0;
+        for (auto version : versions) {
+            const auto source = fs::path(path) / std::to_string(version);
+            const auto destination = fs::path(*local_path) / std::to_string(version);
+            fs::copy(source, destination, fs::copy_options::recursive);
+            for (const auto& entry : fs::recursive_directory_iterator(destination)) {
+                if (entry.is_regular_file()) {
+                    request();
+                    bytes += entry.file_size();
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(bytes / BANDWIDTH_BYTES_PER_SECOND));
+        return ovms::StatusCode::OK;
+    }
+};
+
+class BenchmarkModelManager : public ovms::ModelManager {
+    const Backend backend;
+
+public:
+    explicit BenchmarkModelManager(Backend backend) :
+        backend(backend) {}
+
+    std::shared_ptr<ovms::FileSystem> filesystemFactory(const std::string& basePath) override {
+        if (backend == REMOTE) {
+            return std::make_shared<SyntheticRemoteFileSystem>();
+        }
+        return ModelManager::filesystemFactory(basePath);
+    }
+};
+
+/**
+ * @brief Directory with models model_0 ... model_N-1, each with version 1, and config file serving all of them
+ */
+class ModelsDirectory {
+    const fs::path root;
+
+public:
+    const int modelsCount;
+
+    explicit ModelsDirectory(int modelsCount) :
+        root(fs::temp_directory_path() / ("ovms_lifecycle_benchmark_" + std::to_string(modelsCount))),
+        modelsCount(modelsCount) {
+        fs::remove_all(root);
+        for (int i = 0; i < modelsCount; i++) {
+            const auto versionDirectory = fs::path(getBasePath(i)) / "1";
+            fs::create_directories(versionDirectory);
+            fs::copy(DUMMY_MODEL_DIRECTORY, versionDirectory, fs::copy_options::recursive);
+        }
+        writeConfig(1);
+    }
+
+    ~ModelsDirectory() {
+        fs::remove_all(root);
+    }
+
+    std::string getModelName(int i) const {
+        return "model_" + std::to_string(i);
+    }
+
+    std::string getBasePath(int i) const {
+        return (root / getModelName(i)).u8string();
+    }
+
+    std::string getConfigPath() const {
+        return (root / "config.json").u8string();
+    }
+
+    /**
+     * @brief Writes config of all models, changing nireq makes all of them reload
+     */
+    void writeConfig(int nireq) const {
+        std::ofstream config(getConfigPath());
+        config << "{\"model_config_list\": [";
+        for (int i = 0; i < modelsCount; i++) {
+            config << (i > 0 ? "," : "") << "{\"config\": {\"name\": \"" << getModelName(i) << "\", \"base_path\": \""
+                   << getBasePath(i) << "\", \"nireq\": " << nireq << "}}";
+        }
+        config << "]}";
+    }
+
+    /**
+     * @brief Copies version 1 of model as new version, which replaces served one with default version policy
+     */
+    void addVersion(int i, ovms::model_version_t version) const {
+        fs::copy(fs::path(getBasePath(i)) / "1", fs::path(getBasePath(i)) / std::to_string(version), fs::copy_options::recursive);
+    }
+};
+
+Backend getBackend(const benchmark::State& state) {
+    return static_cast<Backend>(state.range(1));
+}
+
+void setLabel(benchmark::State& state) {
+    state.SetLabel(getBackend(state) == REMOTE ? "remote" : "local");
+}
+
+/**
+ * @brief Arguments are number of models and backend, time of startFromFile on new model manager
+ */
+void BM_ColdStart(benchmark::State& state) {
+    ModelsDirectory directory(state.range(0));
+    for (auto _ : state) {
+        auto manager = std::make_unique<BenchmarkModelManager>(getBackend(state));
+        const auto start = std::chrono::steady_clock::now();
+        auto status = manager->startFromFile(directory.getConfigPath());
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+    }
+    setLabel(state);
+}
+
+/**
+ * @brief Arguments are number of models and backend, time of reloading config which changes all models
+ */
+void BM_FullReload(benchmark::State& state) {
+    ModelsDirectory directory(state.range(0));
+    BenchmarkModelManager manager(getBackend(state));
+    auto status = manager.startFromFile(directory.getConfigPath());
+    int nireq = 1;
+    for (auto _ : state) {
+        nireq = nireq == 1 ? 2 : 1;
+        directory.writeConfig(nireq);
+        const auto start = std::chrono::steady_clock::now();
+        status = manager.startFromFile(directory.getConfigPath());
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+    }
+    setLabel(state);
+}
+
+/**
+ * @brief Arguments are number of models and backend, time of loading new version of one model and retiring previous one
+ */
+void BM_VersionBump(benchmark::State& state) {
+    ModelsDirectory directory(state.range(0));
+    BenchmarkModelManager manager(getBackend(state));
+    auto status = manager.startFromFile(directory.getConfigPath());
+    ovms::ModelConfig config(directory.getModelName(0), directory.getBasePath(0));
+    config.setNireq(1);
+    ovms::model_version_t version = 1;
+    for (auto _ : state) {
+        directory.addVersion(0, ++version);
+        const auto start = std::chrono::steady_clock::now();
+        status = manager.reloadModelWithVersions(config);
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+    }
+    setLabel(state);
+}
+
+tensorflow::serving::PredictRequest createRequest(const std::string& modelName) {
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name(modelName);
+    auto& proto = (*request.mutable_inputs())[INPUT_NAME];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(INPUT_SIZE);
+    std::vector<float> data(INPUT_SIZE, 1.0);
+    proto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    return request;
+}
+
+/**
+ * @brief Runs predict requests on given model from client threads and collects their latencies in microseconds
+ */
+class Clients {
+    std::mutex mtx;
+    bool collecting = false;
+    std::vector<double> latencies;
+    std::atomic<bool> stopped{false};
+    std::vector<std::thread> threads;
+
+public:
+    Clients(ovms::ModelManager& manager, const std::string& modelName, int threadsCount) {
+        for (int i = 0; i < threadsCount; i++) {
+            threads.emplace_back([this, &manager, modelName]() {
+                const auto request = createRequest(modelName);
+                while (!stopped) {
+                    const auto start = std::chrono::steady_clock::now();
+                    tensorflow::serving::PredictResponse response;
+                    std::shared_ptr<ovms::ModelInstance> instance;
+                    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+                    auto status = ovms::getModelInstance(manager, modelName, 0, instance, unloadGuard);
+                    if (status.ok()) {
+                        ovms::inference(*instance, &request, &response, unloadGuard);
+                    }
+                    const double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (collecting) {
+                        latencies.push_back(latency);
+                    }
+                }
+            });
+        }
+    }
+
+    ~Clients() {
+        stopped = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void startCollecting() {
+        std::lock_guard<std::mutex> lock(mtx);
+        collecting = true;
+    }
+
+    /**
+     * @brief Stops collecting and returns 99th percentile of latencies collected since start, clients keep running
+     */
+    double takePercentile99() {
+        std::vector<double> all;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            collecting = false;
+            all.swap(latencies);
+        }
+        if (all.empty()) {
+            return 0;
+        }
+        auto percentile = all.begin() + static_cast<size_t>(0.99 * (all.size() - 1));
+        std::nth_element(all.begin(), percentile, all.end());
+        return *percentile;
+    }
+};
+
+/**
+ * @brief Arguments are number of models and backend, p99 latency of requests to served model while all models are reloaded
+ *
+ * Requests go to the last model, so their latency includes waiting for its own reload as well as interference of the others.
+ * Baseline is p99 latency over the same time without reload.
+ */
+void BM_LatencyDuringReload(benchmark::State& state) {
+    ModelsDirectory directory(state.range(0));
+    BenchmarkModelManager manager(getBackend(state));
+    auto status = manager.startFromFile(directory.getConfigPath());
+    if (!status.ok()) {
+        state.SkipWithError(status.string().c_str());
+        return;
+    }
+    Clients clients(manager, directory.getModelName(directory.modelsCount - 1), 4);
+    double baselineP99 = 0, reloadP99 = 0;
+    int nireq = 1;
+    for (auto _ : state) {
+        nireq = nireq == 1 ? 2 : 1;
+        directory.writeConfig(nireq);
+        clients.startCollecting();
+        const auto start = std::chrono::steady_clock::now();
+        status = manager.startFromFile(directory.getConfigPath());
+        const auto reloadTime = std::chrono::steady_clock::now() - start;
+        reloadP99 = std::max(reloadP99, clients.takePercentile99());
+        state.SetIterationTime(std::chrono::duration<double>(reloadTime).count());
+        clients.startCollecting();
+        std::this_thread::sleep_for(reloadTime);
+        baselineP99 = std::max(baselineP99, clients.takePercentile99());
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+    }
+    state.counters["baseline_p99_us"] = baselineP99;
+    state.counters["reload_p99_us"] = reloadP99;
+    setLabel(state);
+}
+
+void modelsAndBackends(benchmark::internal::Benchmark* benchmark) {
+    for (int backend : {LOCAL, REMOTE}) {
+        for (int models : {1, 10, 50}) {
+            benchmark->Args({models, backend});
+        }
+    }
+}
+BENCHMARK(BM_ColdStart)->Apply(modelsAndBackends)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FullReload)->Apply(modelsAndBackends)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_VersionBump)->Apply(modelsAndBackends)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LatencyDuringReload)->Apply(modelsAndBackends)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ovms::configure_logger("ERROR", "");
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
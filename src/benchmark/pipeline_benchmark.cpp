@@ -0,0 +1,226 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "../entry_node.hpp"
+#include "../exit_node.hpp"
+#include "../logging.hpp"
+#include "../node.hpp"
+#include "../pipeline.hpp"
+
+// Measures overhead of pipeline scheduling apart from OpenVINO. Models are replaced with nodes
+// finishing after fixed synthetic latency, notified from separate thread like infer request completion callbacks.
+
+namespace {
+
+/**
+ * @brief Pushes nodes to their notification queues once their deadline passes
+ */
+class CompletionTimer {
+    struct Completion {
+        ovms::NodeNotificationQueue* queue;
+        ovms::Node* node;
+    };
+
+    std::mutex mtx;
+    std::condition_variable notify;
+    std::multimap<std::chrono::steady_clock::time_point, Completion> completions;
+    bool stopped = false;
+    std::thread thread;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!stopped) {
+            if (completions.empty()) {
+                notify.wait(lock);
+                continue;
+            }
+            auto first = completions.begin();
+            if (first->first > std::chrono::steady_clock::now()) {
+                notify.wait_until(lock, first->first);
+                continue;
+            }
+            auto completion = first->second;
+            completions.erase(first);
+            lock.unlock();
+            completion.queue->push(*completion.node);
+            lock.lock();
+        }
+    }
+
+public:
+    CompletionTimer() :
+        thread([this]() { run(); }) {}
+
+    ~CompletionTimer() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopped = true;
+        }
+        notify.notify_one();
+        thread.join();
+    }
+
+    static CompletionTimer& getInstance() {
+        static CompletionTimer instance;
+        return instance;
+    }
+
+    void schedule(std::chrono::microseconds latency, ovms::NodeNotificationQueue& queue, ovms::Node& node) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            completions.emplace(std::chrono::steady_clock::now() + latency, Completion{&queue, &node});
+        }
+        notify.notify_one();
+    }
+};
+
+/**
+ * @brief Stands for model node, passes its input through as output after synthetic latency
+ */
+class SyntheticLatencyNode : public ovms::Node {
+    const std::chrono::microseconds latency;
+
+public:
+    SyntheticLatencyNode(const std::string& nodeName, std::chrono::microseconds latency) :
+        Node(nodeName),
+        latency(latency) {}
+
+    ovms::Status execute(ovms::NodeNotificationQueue& notifyEndQueue) override {
+        if (latency.count() == 0) {
+            notifyEndQueue.push(*this);
+        } else {
+            CompletionTimer::getInstance().schedule(latency, notifyEndQueue, *this);
+        }
+        return ovms::StatusCode::OK;
+    }
+
+    ovms::Status fetchResults(ovms::BlobMap& outputs) override {
+        outputs["output"] = inputBlobs.at("input");
+        return ovms::StatusCode::OK;
+    }
+};
+
+const std::string INPUT_NAME = "input";
+const int INPUT_SIZE = 10;
+
+/**
+ * @brief Creates pipeline of width parallel branches, each a chain of depth nodes
+ *
+ * Pipeline is created for each request, as pipeline factory does.
+ */
+std::unique_ptr<ovms::Pipeline> createPipeline(int depth, int width, std::chrono::microseconds latency,
+    const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response) {
+    auto entry = std::make_unique<ovms::EntryNode>(request);
+    auto exit = std::make_unique<ovms::ExitNode>(response);
+    auto pipeline = std::make_unique<ovms::Pipeline>(*entry, *exit, "benchmark");
+    for (int branch = 0; branch < width; branch++) {
+        ovms::Node* previous = entry.get();
+        std::string previousOutput = INPUT_NAME;
+        for (int level = 0; level < depth; level++) {
+            auto node = std::make_unique<SyntheticLatencyNode>("node_" + std::to_string(branch) + "_" + std::to_string(level), latency);
+            ovms::Pipeline::connect(*previous, *node, {{previousOutput, "input"}});
+            previous = node.get();
+            previousOutput = "output";
+            pipeline->push(std::move(node));
+        }
+        ovms::Pipeline::connect(*previous, *exit, {{previousOutput, "output_" + std::to_string(branch)}});
+    }
+    pipeline->push(std::move(entry));
+    pipeline->push(std::move(exit));
+    return pipeline;
+}
+
+tensorflow::serving::PredictRequest createRequest() {
+    tensorflow::serving::PredictRequest request;
+    auto& proto = (*request.mutable_inputs())[INPUT_NAME];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(INPUT_SIZE);
+    std::vector<float> data(INPUT_SIZE, 1.0);
+    proto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    return request;
+}
+
+/**
+ * @brief Arguments are pipeline depth, width and synthetic latency of each node in microseconds
+ *
+ * Reported overhead is request time exceeding latency of nodes on the critical path, divided by nodes count
+ * to get it per node. With concurrent threads it includes waiting for shared pipeline executor.
+ */
+void BM_PipelineExecute(benchmark::State& state) {
+    const int depth = state.range(0);
+    const int width = state.range(1);
+    const std::chrono::microseconds latency(state.range(2));
+    const auto request = createRequest();
+    double totalSeconds = 0;
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        tensorflow::serving::PredictResponse response;
+        auto pipeline = createPipeline(depth, width, latency, &request, &response);
+        auto status = pipeline->execute();
+        totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!status.ok()) {
+            state.SkipWithError(status.string().c_str());
+            break;
+        }
+    }
+    if (state.iterations() == 0) {
+        return;
+    }
+    const double requestMicroseconds = totalSeconds * 1e6 / state.iterations();
+    const double overheadMicroseconds = requestMicroseconds - depth * static_cast<double>(latency.count());
+    state.counters["request_overhead_us"] = overheadMicroseconds;
+    state.counters["node_overhead_us"] = overheadMicroseconds / (depth * width + 2);
+    state.counters["nodes_per_second"] = benchmark::Counter(static_cast<double>(state.iterations()) * (depth * width + 2), benchmark::Counter::kIsRate);
+}
+
+void topologies(benchmark::internal::Benchmark* benchmark) {
+    for (int latency : {0, 1000}) {
+        for (auto [depth, width] : std::vector<std::pair<int, int>>{{1, 1}, {4, 1}, {16, 1}, {1, 4}, {1, 16}, {4, 4}, {8, 8}}) {
+            benchmark->Args({depth, width, latency});
+        }
+    }
+}
+BENCHMARK(BM_PipelineExecute)->Apply(topologies)->UseRealTime();
+BENCHMARK(BM_PipelineExecute)->Args({4, 4, 1000})->ThreadRange(2, 64)->UseRealTime();
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ovms::configure_logger("ERROR", "");
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
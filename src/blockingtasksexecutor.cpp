@@ -0,0 +1,92 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "blockingtasksexecutor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace ovms {
+
+namespace {
+// workers spend most of the time waiting for inference, so there are more of them than hardware threads
+size_t getDefaultWorkersCount() {
+    return std::max<size_t>(64, 4 * static_cast<size_t>(std::thread::hardware_concurrency()));
+}
+}  // namespace
+
+BlockingTasksExecutor::BlockingTasksExecutor(size_t workersCount) {
+    for (size_t i = 0; i < workersCount; ++i) {
+        workers.emplace_back(&BlockingTasksExecutor::work, this);
+    }
+}
+
+BlockingTasksExecutor::~BlockingTasksExecutor() {
+    shutdown();
+}
+
+BlockingTasksExecutor& BlockingTasksExecutor::getInferencesInstance() {
+    static BlockingTasksExecutor instance(getDefaultWorkersCount());
+    return instance;
+}
+
+BlockingTasksExecutor& BlockingTasksExecutor::getPipelineBatchesInstance() {
+    static BlockingTasksExecutor instance(getDefaultWorkersCount());
+    return instance;
+}
+
+bool BlockingTasksExecutor::schedule(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (stopped) {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+    return true;
+}
+
+void BlockingTasksExecutor::shutdown() {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void BlockingTasksExecutor::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            available.wait(lock, [this] { return stopped || !tasks.empty(); });
+            // queued tasks are still run after shutdown, so that their requests are completed
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,77 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Fixed pool of threads running tasks which block until inference is finished, in first in first out order
+ *
+ * Used instead of detached threads for requests waiting on batching scheduler, sequence or split batch,
+ * so that number of threads is bounded and tasks still running keep the server from unloading models on shutdown.
+ * Tasks waiting on tasks of the same pool may deadlock, those have to be scheduled on separate instances.
+ */
+class BlockingTasksExecutor {
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable available;
+    bool stopped = false;
+
+    void work();
+
+public:
+    BlockingTasksExecutor(size_t workersCount);
+    ~BlockingTasksExecutor();
+
+    BlockingTasksExecutor(const BlockingTasksExecutor&) = delete;
+    BlockingTasksExecutor& operator=(const BlockingTasksExecutor&) = delete;
+
+    /**
+     * @brief Gets executor of synchronous model inferences, with enough workers to keep inference streams busy
+     */
+    static BlockingTasksExecutor& getInferencesInstance();
+
+    /**
+     * @brief Gets executor of requests batched by pipeline batcher, which wait for inferences of executor above
+     */
+    static BlockingTasksExecutor& getPipelineBatchesInstance();
+
+    /**
+     * @brief Queues task to be run by first idle worker
+     *
+     * @return false if executor is shut down and task is not going to run
+     */
+    bool schedule(std::function<void()> task);
+
+    /**
+     * @brief Stops accepting tasks and returns once queued and running ones are finished
+     */
+    void shutdown();
+
+    size_t getWorkersCount() const {
+        return workers.size();
+    }
+};
+
+}  // namespace ovms
@@ -0,0 +1,54 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "built_in_node.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+Status BuiltInNode::execute(NodeNotificationQueue& notifyEndQueue) {
+    // Built in nodes are cheap compared to inference, they are executed right away in pipeline thread
+    auto status = process();
+    // Blobs can be owned by inference requests of previous nodes, release them once processed
+    this->inputBlobs.clear();
+    notifyEndQueue.push(*this);
+    return status;
+}
+
+Status BuiltInNode::fetchResults(BlobMap& outputs) {
+    for (const auto& node : this->next) {
+        for (const auto& pair : node.get().getMappingByDependency(*this)) {
+            const auto& outputName = pair.first;
+            if (outputs.count(outputName) == 1) {
+                continue;
+            }
+            if (!node.get().isInputRequired(pair.second)) {
+                continue;
+            }
+            const auto& dataItem = nodeOutputNameAlias.count(outputName) == 1 ? nodeOutputNameAlias.at(outputName) : outputName;
+            auto blobItr = this->outputBlobs.find(dataItem);
+            if (blobItr == this->outputBlobs.end()) {
+                SPDLOG_WARN("[Node: {}] Cannot find output for alias {}", getName(), outputName);
+                return StatusCode::INVALID_MISSING_OUTPUT;
+            }
+            outputs.emplace(outputName, blobItr->second);
+        }
+    }
+    this->release();
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "node.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Base of nodes processing blobs in server code instead of a model
+ *
+ * Node computes its outputs synchronously in ::execute and keeps them keyed by data item names,
+ * subsequent nodes refer to them by aliases defined in node outputs configuration.
+ */
+class BuiltInNode : public Node {
+protected:
+    const std::unordered_map<std::string, std::string> nodeOutputNameAlias;
+    BlobMap outputBlobs;
+
+public:
+    BuiltInNode(const std::string& nodeName, std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        Node(nodeName),
+        nodeOutputNameAlias(nodeOutputNameAlias) {}
+
+    Status execute(NodeNotificationQueue& notifyEndQueue) override;
+
+    Status fetchResults(BlobMap& outputs) override;
+
+    void release() override {
+        this->outputBlobs.clear();
+    }
+
+    void reset() override {
+        release();
+        Node::reset();
+    }
+
+protected:
+    /**
+     * @brief Fills outputBlobs out of inputBlobs
+     */
+    virtual Status process() = 0;
+};
+
+}  // namespace ovms
@@ -0,0 +1,142 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "chunkedinputs.hpp"
+
+#include <cstring>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+#include "tensorbufferpool.hpp"
+
+namespace ovms {
+
+Status ChunkedInputs::prepare(const tensor_map_t& inputsInfo, const tensorflow::serving::PredictRequest& header) {
+    auto status = validate(inputsInfo, header);
+    if (!status.ok()) {
+        return status;
+    }
+    return allocate(inputsInfo, header);
+}
+
+Status ChunkedInputs::validate(const tensor_map_t& inputsInfo, const tensorflow::serving::PredictRequest& header) {
+    bytes = 0;
+    if (static_cast<size_t>(header.inputs_size()) != inputsInfo.size()) {
+        std::stringstream ss;
+        ss << "Expected: " << inputsInfo.size() << "; Actual: " << header.inputs_size();
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Invalid number of chunked inputs - {}", details);
+        return Status(StatusCode::INVALID_NO_OF_INPUTS, details);
+    }
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        auto it = header.inputs().find(name);
+        if (it == header.inputs().end()) {
+            SPDLOG_DEBUG("Missing chunked input with specific name - {}", name);
+            return Status(StatusCode::INVALID_MISSING_INPUT, "Required input: " + name);
+        }
+        const auto& requestInput = it->second;
+        const auto& conversion = tensorInfo->getPrecisionConversion();
+        if (!conversion.nativeContent || requestInput.dtype() != conversion.dtype) {
+            std::stringstream ss;
+            ss << "Expected: " << tensorInfo->getPrecisionAsString()
+               << "; Actual: " << TensorInfo::getDataTypeAsString(requestInput.dtype())
+               << ", chunked inputs are supported only for precisions with native tensor content";
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("Invalid precision of chunked input {} - {}", name, details);
+            return Status(StatusCode::INVALID_PRECISION, details);
+        }
+        const auto& shape = tensorInfo->getShape();
+        bool shapeMatches = requestInput.tensor_shape().dim_size() == static_cast<int>(shape.size());
+        for (int i = 0; shapeMatches && i < requestInput.tensor_shape().dim_size(); i++) {
+            shapeMatches = requestInput.tensor_shape().dim(i).size() >= 0 &&
+                           static_cast<size_t>(requestInput.tensor_shape().dim(i).size()) == shape[i];
+        }
+        if (!shapeMatches) {
+            std::stringstream ss;
+            ss << "Expected: " << TensorInfo::shapeToString(shape)
+               << "; Actual: " << TensorInfo::tensorShapeToString(requestInput.tensor_shape());
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("Invalid shape of chunked input {} - {}", name, details);
+            return Status(StatusCode::INVALID_SHAPE, details);
+        }
+        size_t inputBytes = tensorInfo->getPrecision().size();
+        for (const auto dim : shape) {
+            inputBytes *= dim;
+        }
+        bytes += inputBytes;
+    }
+    return StatusCode::OK;
+}
+
+Status ChunkedInputs::allocate(const tensor_map_t& inputsInfo, const tensorflow::serving::PredictRequest& header) {
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        const auto& requestInput = header.inputs().at(name);
+        auto blob = createPooledBlob(tensorInfo->getTensorDesc());
+        Input input;
+        input.data = blob->buffer().as<char*>();
+        input.size = blob->byteSize();
+        blobs[tensorInfo->getName()] = std::move(blob);
+        inputs[name] = input;
+        if (!requestInput.tensor_content().empty()) {
+            auto status = write(name, 0, requestInput.tensor_content());
+            if (!status.ok()) {
+                return status;
+            }
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status ChunkedInputs::write(const std::string& inputName, uint64_t offset, const std::string& content) {
+    auto it = inputs.find(inputName);
+    if (it == inputs.end()) {
+        SPDLOG_DEBUG("Chunk of unexpected input - {}", inputName);
+        return Status(StatusCode::INVALID_MISSING_INPUT, "Unexpected input: " + inputName);
+    }
+    auto& input = it->second;
+    if (offset != input.received) {
+        std::stringstream ss;
+        ss << "Expected offset: " << input.received << "; Actual: " << offset;
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Chunk of input {} out of order - {}", inputName, details);
+        return Status(StatusCode::CHUNKED_INPUT_OUT_OF_ORDER, details);
+    }
+    if (content.size() > input.size - input.received) {
+        std::stringstream ss;
+        ss << "Expected: " << input.size << " bytes; Actual: " << input.received + content.size() << " bytes";
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Invalid content size of chunked input {} - {}", inputName, details);
+        return Status(StatusCode::INVALID_CONTENT_SIZE, details);
+    }
+    std::memcpy(input.data + input.received, content.data(), content.size());
+    input.received += content.size();
+    return StatusCode::OK;
+}
+
+Status ChunkedInputs::checkComplete() const {
+    for (const auto& [name, input] : inputs) {
+        if (input.received != input.size) {
+            std::stringstream ss;
+            ss << "Expected: " << input.size << " bytes; Actual: " << input.received << " bytes";
+            const std::string details = ss.str();
+            SPDLOG_DEBUG("Incomplete content of chunked input {} - {}", name, details);
+            return Status(StatusCode::INVALID_CONTENT_SIZE, details);
+        }
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
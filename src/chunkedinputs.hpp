@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Inputs of request uploaded in chunks, written directly into blobs passed to inference,
+ * so that very large tensors are not buffered as a whole in request proto and then copied.
+ *
+ * Content of each input is raw tensor content in native layout of model input and arrives in order.
+ */
+class ChunkedInputs {
+public:
+    /**
+     * @brief Validates inputs declared in request header against model inputs and allocates blob for each of them.
+     * Content of inputs already sent in header becomes their first bytes.
+     *
+     * Shapes have to match model inputs exactly, chunked inputs do not trigger reshape or batch size change.
+     */
+    Status prepare(const tensor_map_t& inputsInfo, const tensorflow::serving::PredictRequest& header);
+
+    /**
+     * @brief Validates inputs declared in request header against model inputs and computes their total size, without allocating blobs
+     */
+    Status validate(const tensor_map_t& inputsInfo, const tensorflow::serving::PredictRequest& header);
+
+    /**
+     * @brief Allocates blob for each input of header already validated, content of inputs sent in header becomes their first bytes
+     */
+    Status allocate(const tensor_map_t& inputsInfo, const tensorflow::serving::PredictRequest& header);
+
+    /**
+     * @brief Appends chunk to content of input
+     *
+     * @param offset position of chunk in input content, equal to the number of bytes already received
+     */
+    Status write(const std::string& inputName, uint64_t offset, const std::string& content);
+
+    /**
+     * @brief Checks that content of all inputs was received
+     */
+    Status checkComplete() const;
+
+    /**
+     * @brief Total size of inputs content
+     */
+    size_t getBytes() const {
+        return bytes;
+    }
+
+    /**
+     * @brief Blobs of inputs keyed by network input name
+     */
+    const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& getBlobs() const {
+        return blobs;
+    }
+
+private:
+    struct Input {
+        char* data = nullptr;
+        size_t size = 0;
+        size_t received = 0;
+    };
+
+    std::unordered_map<std::string, Input> inputs;
+    std::unordered_map<std::string, InferenceEngine::Blob::Ptr> blobs;
+    size_t bytes = 0;
+};
+
+}  // namespace ovms
@@ -0,0 +1,151 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "compilednetworkregistry.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <system_error>
+
+namespace ovms {
+
+namespace {
+bool sameFileContents(const std::string& lhsPath, const std::string& rhsPath) {
+    std::ifstream lhs(lhsPath, std::ios::binary);
+    std::ifstream rhs(rhsPath, std::ios::binary);
+    if (!lhs || !rhs) {
+        return false;
+    }
+    constexpr size_t CHUNK_SIZE = 1024 * 1024;
+    std::vector<char> lhsChunk(CHUNK_SIZE);
+    std::vector<char> rhsChunk(CHUNK_SIZE);
+    while (lhs && rhs) {
+        lhs.read(lhsChunk.data(), CHUNK_SIZE);
+        rhs.read(rhsChunk.data(), CHUNK_SIZE);
+        if (lhs.gcount() != rhs.gcount() || !std::equal(lhsChunk.begin(), lhsChunk.begin() + lhs.gcount(), rhsChunk.begin())) {
+            return false;
+        }
+    }
+    return lhs.eof() && rhs.eof();
+}
+}  // namespace
+
+bool CompiledNetworkKey::addModelFile(const std::string& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    modelFiles.push_back({path, size, modified});
+    return true;
+}
+
+bool CompiledNetworkKey::matches(const CompiledNetworkKey& other) const {
+    if (hash != other.hash || description != other.description ||
+        modelFiles.size() != other.modelFiles.size() || inMemoryModelFiles.size() != other.inMemoryModelFiles.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < inMemoryModelFiles.size(); i++) {
+        if (*inMemoryModelFiles[i] != *other.inMemoryModelFiles[i]) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < modelFiles.size(); i++) {
+        const auto& file = modelFiles[i];
+        const auto& otherFile = other.modelFiles[i];
+        if (file.size != otherFile.size) {
+            return false;
+        }
+        if (file.path == otherFile.path && file.modified == otherFile.modified) {
+            continue;
+        }
+        if (!sameFileContents(file.path, otherFile.path)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<InferenceEngine::ExecutableNetwork> CompiledNetworkRegistry::getOrLoad(const CompiledNetworkKey& key,
+    const std::function<std::shared_ptr<InferenceEngine::ExecutableNetwork>()>& load,
+    bool& shared) {
+    std::shared_ptr<Entry> entry;
+    // model files are compared without registry lock, entries added meanwhile are compared in next pass
+    std::set<const Entry*> compared;
+    while (!entry) {
+        std::vector<std::shared_ptr<Entry>> candidates;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            // entries of released networks are removed unless other version is loading or comparing them
+            for (auto it = entries.begin(); it != entries.end();) {
+                if (it->first != key.hash && it->second->network.expired() && it->second.use_count() == 1) {
+                    it = entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            auto range = entries.equal_range(key.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (compared.count(it->second.get()) == 0) {
+                    candidates.push_back(it->second);
+                }
+            }
+            if (candidates.empty()) {
+                entry = std::make_shared<Entry>(key);
+                entries.emplace(key.hash, entry);
+                break;
+            }
+        }
+        for (const auto& candidate : candidates) {
+            compared.insert(candidate.get());
+            if (candidate->key.matches(key)) {
+                entry = candidate;
+                break;
+            }
+        }
+    }
+    // network of entry is read and written under registry lock, loading lock only serializes compilation
+    std::unique_lock<std::mutex> loadingLock(entry->loadingMtx);
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> network;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        network = entry->network.lock();
+    }
+    shared = network != nullptr;
+    if (!network) {
+        network = load();
+        std::unique_lock<std::mutex> lock(mtx);
+        entry->network = network;
+    }
+    return network;
+}
+
+size_t CompiledNetworkRegistry::size() {
+    std::unique_lock<std::mutex> lock(mtx);
+    size_t count = 0;
+    for (const auto& [key, entry] : entries) {
+        if (!entry->network.expired()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+}  // namespace ovms
@@ -0,0 +1,109 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Identity of compiled network, hash selects entries and the rest is compared in full on hash match
+ */
+struct CompiledNetworkKey {
+    struct ModelFile {
+        std::string path;
+        uintmax_t size;
+        std::filesystem::file_time_type modified;
+    };
+
+    uint64_t hash = 0;
+    // device, plugin config, inputs and CPUs of the network
+    std::string description;
+    // files on disk are compared by content unless they are the same unmodified file
+    std::vector<ModelFile> modelFiles;
+    std::vector<std::shared_ptr<const std::string>> inMemoryModelFiles;
+
+    /**
+     * @brief Adds model file with its current size and modification time
+     *
+     * @return false if file cannot be accessed
+     */
+    bool addModelFile(const std::string& path);
+
+    /**
+     * @brief Compares description and content of model files, hashes are expected to be equal
+     */
+    bool matches(const CompiledNetworkKey& other) const;
+};
+
+/**
+ * @brief Networks compiled by loaded model versions, keyed by hash of model files, device, plugin config and input shapes
+ *
+ * Model versions exposing identical model files under several names or versions get the same compiled network,
+ * and so the same weights memory and device streams, instead of compiling their own. Full key is compared on hash
+ * match, so colliding hashes never share a network. Infer requests are still created by each model version, since
+ * versions configure their own number of infer requests. Networks are held by model versions only and are released
+ * once the last of them is unloaded.
+ */
+class CompiledNetworkRegistry {
+    struct Entry {
+        explicit Entry(const CompiledNetworkKey& key) :
+            key(key) {}
+        const CompiledNetworkKey key;
+        std::mutex loadingMtx;
+        std::weak_ptr<InferenceEngine::ExecutableNetwork> network;
+    };
+
+    std::mutex mtx;
+    std::multimap<uint64_t, std::shared_ptr<Entry>> entries;
+
+public:
+    static CompiledNetworkRegistry& getInstance() {
+        static CompiledNetworkRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief Gets network compiled for key by other model version, or compiles it with load
+     *
+     * Concurrent loads of the same key wait for the first one, so that the network is compiled once.
+     *
+     * @param key
+     * @param load compiles network, exceptions are passed to caller
+     * @param shared set to true if network was compiled by other model version
+     *
+     * @return network
+     */
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> getOrLoad(const CompiledNetworkKey& key,
+        const std::function<std::shared_ptr<InferenceEngine::ExecutableNetwork>()>& load,
+        bool& shared);
+
+    /**
+     * @brief Number of networks held by model versions
+     */
+    size_t size();
+};
+
+}  // namespace ovms
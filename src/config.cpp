@@ -17,18 +17,24 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <regex>
 #include <thread>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
+#include <sys/un.h>
 #include <sysexits.h>
 
+#include "cpuaffinity.hpp"
+#include "deviceconcurrencylimiter.hpp"
 #include "version.hpp"
 
 namespace ovms {
 
 const uint AVAILABLE_CORES = std::thread::hardware_concurrency();
 const uint MAX_PORT_NUMBER = std::numeric_limits<ushort>::max();
+const size_t MAX_UNIX_SOCKET_PATH_LENGTH = sizeof(sockaddr_un::sun_path);
 
 const uint64_t DEFAULT_REST_WORKERS = AVAILABLE_CORES * 4.0;
 const std::string DEFAULT_REST_WORKERS_STRING{std::to_string(DEFAULT_REST_WORKERS)};
@@ -60,14 +66,70 @@ Config& Config::parse(int argc, char** argv) {
                 "Network interface address to bind to for the REST API",
                 cxxopts::value<std::string>()->default_value("0.0.0.0"),
                 "REST_BIND_ADDRESS")
+            ("grpc_unix_socket_path",
+                "Path of unix domain socket to accept gRPC API connections on, in addition to the port",
+                cxxopts::value<std::string>(),
+                "GRPC_UNIX_SOCKET_PATH")
+            ("rest_unix_socket_path",
+                "Path of unix domain socket to accept REST API connections on, in addition to rest_port",
+                cxxopts::value<std::string>(),
+                "REST_UNIX_SOCKET_PATH")
             ("grpc_workers",
                 "number of gRPC servers. Default 1. Increase for multi client, high throughput scenarios",
                 cxxopts::value<uint>()->default_value("1"),
                 "GRPC_WORKERS")
+            ("grpc_completion_queues",
+                "Number of completion queues of each gRPC server, each polled by its own thread. Default 1. Increase when gRPC request handling does not scale with CPU cores",
+                cxxopts::value<uint>()->default_value("1"),
+                "GRPC_COMPLETION_QUEUES")
+            ("grpc_cpu_set",
+                "List of CPUs gRPC completion queue threads are pinned to one per CPU in round robin order, e.g. 0-3. Default threads are not pinned, or pinned to CPUs of their server shard.",
+                cxxopts::value<std::string>(),
+                "GRPC_CPU_SET")
             ("rest_workers",
                 "number of worker threads in REST server - has no effect if rest_port is not set. Default value depends on number of CPUs. ",
                 cxxopts::value<uint>()->default_value(DEFAULT_REST_WORKERS_STRING.c_str()),
                 "REST_WORKERS")
+            ("rest_connection_timeout",
+                "Seconds after which idle kept alive REST connections are closed. Set above idle timeout of gateways pooling connections, so that connections they reuse are not closed by the server. Default 0 - 50 seconds.",
+                cxxopts::value<uint>()->default_value("0"),
+                "REST_CONNECTION_TIMEOUT")
+            ("rest_socket_buffer_size",
+                "Size in bytes of kernel send and receive buffers of REST connections. Default 0 - system default.",
+                cxxopts::value<uint>()->default_value("0"),
+                "REST_SOCKET_BUFFER_SIZE")
+            ("server_shards",
+                "Number of gRPC and REST servers sharing ports with SO_REUSEPORT, each with its threads pinned to its part of server_shards_cpu_set. Overrides grpc_workers. Default 0 - disabled.",
+                cxxopts::value<uint>()->default_value("0"),
+                "SERVER_SHARDS")
+            ("server_shards_cpu_set",
+                "List of CPUs split between server_shards, e.g. 0-7,16-23. Default all CPUs available for the process.",
+                cxxopts::value<std::string>(),
+                "SERVER_SHARDS_CPU_SET")
+            ("worker_processes",
+                "Number of server processes forked at startup, each loading models and accepting connections on the same ports with SO_REUSEPORT. Master process restarts workers which exit and stops them on shutdown. Default 0 - single process.",
+                cxxopts::value<uint>()->default_value("0"),
+                "WORKER_PROCESSES")
+            ("executor_workers",
+                "Number of worker threads shared by pipeline nodes and REST responses serialization, pinned each to one CPU of executor_cpu_set if set. Default 0 - one for each CPU of executor_cpu_set or hardware thread.",
+                cxxopts::value<uint>()->default_value("0"),
+                "EXECUTOR_WORKERS")
+            ("executor_cpu_set",
+                "List of CPUs shared executor workers are pinned to, e.g. CPUs not used by inference streams. Default workers are not pinned.",
+                cxxopts::value<std::string>(),
+                "EXECUTOR_CPU_SET")
+            ("profiling_endpoints",
+                "Serve /debug/pprof/profile and /debug/pprof/heap endpoints of REST API for profiling the running server",
+                cxxopts::value<bool>()->default_value("false"),
+                "PROFILING_ENDPOINTS")
+            ("capture_path",
+                "Path of binary file where sampled gRPC and REST predict requests are recorded with their arrival times, to be replayed by ovms_load_generator. Disabled by default.",
+                cxxopts::value<std::string>(),
+                "CAPTURE_PATH")
+            ("capture_sample_ratio",
+                "Fraction of predict requests recorded to capture_path, greater than 0 and not greater than 1. Default 1 - all requests.",
+                cxxopts::value<double>()->default_value("1"),
+                "CAPTURE_SAMPLE_RATIO")
             ("log_level",
                 "serving log level - one of DEBUG, INFO, ERROR",
                 cxxopts::value<std::string>()->default_value("INFO"), "LOG_LEVEL")
@@ -80,12 +142,76 @@ Config& Config::parse(int argc, char** argv) {
             ("file_system_poll_wait_seconds",
                 "Time interval between config and model versions changes detection. Default is 1. Zero or negative value disables changes monitoring.",
                 cxxopts::value<uint>()->default_value("1"),
-                "SECONDS");
+                "SECONDS")
+            ("model_loading_threads",
+                "Maximum number of models and model versions loaded concurrently at startup and on configuration reload. Default 4.",
+                cxxopts::value<uint>()->default_value("4"),
+                "MODEL_LOADING_THREADS")
+            ("model_usage_file",
+                "File with request counts of models saved periodically and on shutdown, read at startup to load the busiest models first. Default empty - models are loaded in configuration order.",
+                cxxopts::value<std::string>(),
+                "MODEL_USAGE_FILE")
+            ("serve_while_loading",
+                "Start gRPC and REST servers before models are loaded, models become available one by one. Server is not ready until models critical for readiness are loaded.",
+                cxxopts::value<bool>()->default_value("false"),
+                "SERVE_WHILE_LOADING")
+            ("compiled_model_cache_dir",
+                "Directory where networks compiled for target devices are exported and imported from on next model loads. Disabled by default.",
+                cxxopts::value<std::string>(), "COMPILED_MODEL_CACHE_DIR")
+            ("share_compiled_networks",
+                "Share one compiled network and its streams between model versions with identical model files, target device, plugin config and inputs, e.g. the same model served under several names.",
+                cxxopts::value<bool>()->default_value("false"),
+                "SHARE_COMPILED_NETWORKS")
+            ("cloud_model_cache_dir",
+                "Directory where model files downloaded from cloud storage are kept, so that they are not downloaded again on next loads. Disabled by default.",
+                cxxopts::value<std::string>(), "CLOUD_MODEL_CACHE_DIR")
+            ("model_memory_budget_mb",
+                "Estimated memory of loaded model versions in megabytes above which least recently used idle versions are unloaded until next request. Default 0 - unlimited.",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "MODEL_MEMORY_BUDGET_MB")
+            ("in_flight_memory_budget_mb",
+                "Estimated memory in megabytes of requests, responses and pipeline node outputs being processed above which new requests are rejected. Default 0 - unlimited.",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "IN_FLIGHT_MEMORY_BUDGET_MB")
+            ("tensor_pool_size_mb",
+                "Maximum size in megabytes of released tensor buffers kept for reuse by node outputs and converted inputs. Default 0 - buffers are not reused.",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "TENSOR_POOL_SIZE_MB")
+            ("tensor_pool_hugepages",
+                "Map tensor buffers of at least 2MB from hugepages, if available",
+                cxxopts::value<bool>()->default_value("false"),
+                "TENSOR_POOL_HUGEPAGES")
+            ("tensor_cache_size_mb",
+                "Maximum size in megabytes of tensors uploaded with TensorCacheService UploadTensor and referred to by handle in requests. Least recently used tensors are evicted. Default 0 - uploads are disabled.",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "TENSOR_CACHE_SIZE_MB")
+            ("response_compression_min_bytes",
+                "Minimum size in bytes of REST and gRPC Predict responses compressed with gzip, when client accepts it. Default 0 - responses are not compressed.",
+                cxxopts::value<uint64_t>()->default_value("0"),
+                "RESPONSE_COMPRESSION_MIN_BYTES")
+            ("device_concurrency_limits",
+                "Comma separated list of DEVICE=COUNT limits of infer requests executing at once on device, shared by all models loaded on it, e.g. GPU=4,MYRIAD=8. Models on limited device get its slots in proportion to their device_scheduling_weight. Devices are not limited by default.",
+                cxxopts::value<std::string>(),
+                "DEVICE_CONCURRENCY_LIMITS");
         options->add_options("multi model")
             ("config_path",
                 "absolute path to json configuration file",
                 cxxopts::value<std::string>(), "CONFIG_PATH");
 
+        options->add_options("offline batch")
+            ("batch_input_dir",
+                "Directory with one subdirectory per sample holding <input name>.npy files. When set, samples are inferred with batch_model_name and written to batch_output_dir, then the server exits without starting gRPC and REST servers",
+                cxxopts::value<std::string>(), "BATCH_INPUT_DIR")
+            ("batch_output_dir",
+                "Directory where outputs of samples are written as <sample>/<output name>.npy files",
+                cxxopts::value<std::string>(), "BATCH_OUTPUT_DIR")
+            ("batch_model_name",
+                "Name of model or pipeline samples are inferred with. Default model_name",
+                cxxopts::value<std::string>(), "BATCH_MODEL_NAME")
+            ("batch_concurrency",
+                "Maximum number of samples inferred at once. Default 0 - nireq of the model or number of hardware threads for pipelines",
+                cxxopts::value<uint32_t>()->default_value("0"), "BATCH_CONCURRENCY");
+
         options->add_options("single model")
             ("model_name",
                 "name of the model",
@@ -131,7 +257,7 @@ Config& Config::parse(int argc, char** argv) {
         }
 
         if (result->count("help") || result->arguments().size() == 0) {
-            std::cout << options->help({"", "multi model", "single model"}) << std::endl;
+            std::cout << options->help({"", "multi model", "single model", "offline batch"}) << std::endl;
             exit(EX_OK);
         }
 
@@ -185,6 +311,26 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
+    if (result->count("batch_input_dir") && !result->count("batch_output_dir")) {
+        std::cerr << "batch_output_dir is required with batch_input_dir" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (result->count("batch_input_dir") && this->batchModelName().empty()) {
+        std::cerr << "batch_model_name is required with batch_input_dir and config_path" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("grpc_completion_queues") && ((this->grpcCompletionQueues() > AVAILABLE_CORES) || (this->grpcCompletionQueues() < 1))) {
+        std::cerr << "grpc_completion_queues count should be from 1 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    std::vector<int> grpcCpus;
+    if (result->count("grpc_cpu_set") && !parseCpuList(this->grpcCpuSet(), grpcCpus).ok()) {
+        std::cerr << "grpc_cpu_set should be list of CPUs like 0-3,8,10-11" << std::endl;
+        exit(EX_USAGE);
+    }
+
     // check grpc_workers value
     if (result->count("grpc_workers") && ((this->grpcWorkers() > AVAILABLE_CORES) || (this->grpcWorkers() < 1))) {
         std::cerr << "grpc_workers count should be from 1 to CPU core count : " << AVAILABLE_CORES << std::endl;
@@ -202,6 +348,54 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
+    if (result->count("rest_connection_timeout") && this->restConnectionTimeout() > static_cast<uint>(std::numeric_limits<int>::max())) {
+        std::cerr << "rest_connection_timeout should be from 0 to " << std::numeric_limits<int>::max() << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("rest_socket_buffer_size") && this->restSocketBufferSize() > static_cast<uint>(std::numeric_limits<int>::max())) {
+        std::cerr << "rest_socket_buffer_size should be from 0 to " << std::numeric_limits<int>::max() << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("server_shards") && this->serverShards() > AVAILABLE_CORES) {
+        std::cerr << "server_shards count should be from 0 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("worker_processes") && this->workerProcesses() > AVAILABLE_CORES) {
+        std::cerr << "worker_processes count should be from 0 to CPU core count : " << AVAILABLE_CORES << std::endl;
+        exit(EX_USAGE);
+    }
+
+    std::vector<int> serverShardsCpus;
+    if (result->count("server_shards_cpu_set") && !parseCpuList(this->serverShardsCpuSet(), serverShardsCpus).ok()) {
+        std::cerr << "server_shards_cpu_set should be list of CPUs like 0-3,8,10-11" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    std::vector<int> executorCpus;
+    if (result->count("executor_cpu_set") && !parseCpuList(this->executorCpuSet(), executorCpus).ok()) {
+        std::cerr << "executor_cpu_set should be list of CPUs like 0-3,8,10-11" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("capture_sample_ratio") && (this->captureSampleRatio() <= 0 || this->captureSampleRatio() > 1)) {
+        std::cerr << "capture_sample_ratio should be greater than 0 and not greater than 1" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    if (result->count("model_loading_threads") && this->modelLoadingThreads() < 1) {
+        std::cerr << "model_loading_threads should be at least 1" << std::endl;
+        exit(EX_USAGE);
+    }
+
+    std::map<std::string, size_t> deviceConcurrencyLimits;
+    if (result->count("device_concurrency_limits") && !DeviceConcurrencyLimiter::parseLimits(this->deviceConcurrencyLimits(), deviceConcurrencyLimits).ok()) {
+        std::cerr << "device_concurrency_limits should be comma separated list of DEVICE=COUNT with COUNT at least 1" << std::endl;
+        exit(EX_USAGE);
+    }
+
     // check docker ports
     if (result->count("port") && ((this->port() > MAX_PORT_NUMBER) || (this->port() < 0))) {
         std::cerr << "port number out of range from 0 to " << MAX_PORT_NUMBER << std::endl;
@@ -226,6 +420,24 @@ void Config::validate() {
         exit(EX_USAGE);
     }
 
+    // check unix domain socket paths
+    if (this->grpcUnixSocketPath().size() >= MAX_UNIX_SOCKET_PATH_LENGTH) {
+        std::cerr << "grpc_unix_socket_path should be shorter than " << MAX_UNIX_SOCKET_PATH_LENGTH << " characters" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (this->restUnixSocketPath().size() >= MAX_UNIX_SOCKET_PATH_LENGTH) {
+        std::cerr << "rest_unix_socket_path should be shorter than " << MAX_UNIX_SOCKET_PATH_LENGTH << " characters" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (!this->restUnixSocketPath().empty() && this->restPort() == 0) {
+        std::cerr << "rest_unix_socket_path is set but rest_port is not set. rest_port is required to start rest servers" << std::endl;
+        exit(EX_USAGE);
+    }
+    if (!this->restUnixSocketPath().empty() && this->restUnixSocketPath() == this->grpcUnixSocketPath()) {
+        std::cerr << "grpc_unix_socket_path and rest_unix_socket_path cannot have the same values" << std::endl;
+        exit(EX_USAGE);
+    }
+
     // port and rest_port cannot be the same
     if (this->port() == this->restPort()) {
         std::cerr << "port and rest_port cannot have the same values" << std::endl;
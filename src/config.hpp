@@ -135,6 +135,28 @@ public:
         return "0.0.0.0";
     }
 
+    /**
+         * @brief Get the unix domain socket path for the gRPC API, empty if disabled
+         * 
+         * @return const std::string
+         */
+    const std::string grpcUnixSocketPath() {
+        if (result->count("grpc_unix_socket_path"))
+            return result->operator[]("grpc_unix_socket_path").as<std::string>();
+        return "";
+    }
+
+    /**
+         * @brief Get the unix domain socket path for the REST API, empty if disabled
+         * 
+         * @return const std::string
+         */
+    const std::string restUnixSocketPath() {
+        if (result->count("rest_unix_socket_path"))
+            return result->operator[]("rest_unix_socket_path").as<std::string>();
+        return "";
+    }
+
     /**
          * @brief Gets the gRPC workers count
          * 
@@ -144,6 +166,26 @@ public:
         return result->operator[]("grpc_workers").as<uint>();
     }
 
+    /**
+         * @brief Gets the number of completion queues of each gRPC server
+         * 
+         * @return uint
+         */
+    uint grpcCompletionQueues() {
+        return result->operator[]("grpc_completion_queues").as<uint>();
+    }
+
+    /**
+         * @brief Gets the list of CPUs gRPC completion queue threads are pinned to, empty if not set
+         * 
+         * @return const std::string&
+         */
+    const std::string& grpcCpuSet() {
+        if (result->count("grpc_cpu_set"))
+            return result->operator[]("grpc_cpu_set").as<std::string>();
+        return empty;
+    }
+
     /**
          * @brief Gets the rest workers count
          * 
@@ -153,6 +195,102 @@ public:
         return result->operator[]("rest_workers").as<uint>();
     }
 
+    /**
+     * @brief Gets the timeout in seconds of idle REST connections, 0 for default
+     *
+     * @return uint
+     */
+    uint restConnectionTimeout() {
+        return result->operator[]("rest_connection_timeout").as<uint>();
+    }
+
+    /**
+     * @brief Gets the size of kernel buffers of REST connections, 0 for system default
+     *
+     * @return uint
+     */
+    uint restSocketBufferSize() {
+        return result->operator[]("rest_socket_buffer_size").as<uint>();
+    }
+
+    /**
+         * @brief Gets the number of gRPC and REST servers sharing ports, 0 if disabled
+         * 
+         * @return uint
+         */
+    uint serverShards() {
+        return result->operator[]("server_shards").as<uint>();
+    }
+
+    /**
+         * @brief Gets the number of forked server processes, 0 if server runs in single process
+         * 
+         * @return uint
+         */
+    uint workerProcesses() {
+        return result->operator[]("worker_processes").as<uint>();
+    }
+
+    /**
+         * @brief Gets the list of CPUs split between server shards, empty if all CPUs available for the process are used
+         * 
+         * @return const std::string&
+         */
+    const std::string& serverShardsCpuSet() {
+        if (result->count("server_shards_cpu_set"))
+            return result->operator[]("server_shards_cpu_set").as<std::string>();
+        return empty;
+    }
+
+    /**
+         * @brief Gets the number of shared executor workers, 0 if it depends on CPUs
+         * 
+         * @return uint
+         */
+    uint executorWorkers() {
+        return result->operator[]("executor_workers").as<uint>();
+    }
+
+    /**
+         * @brief Gets the list of CPUs shared executor workers are pinned to, empty if workers are not pinned
+         * 
+         * @return const std::string&
+         */
+    const std::string& executorCpuSet() {
+        if (result->count("executor_cpu_set"))
+            return result->operator[]("executor_cpu_set").as<std::string>();
+        return empty;
+    }
+
+    /**
+         * @brief Checks if profiling endpoints of REST API are served
+         * 
+         * @return bool
+         */
+    bool profilingEndpoints() {
+        return result->operator[]("profiling_endpoints").as<bool>();
+    }
+
+    /**
+         * @brief Gets the path of file predict requests are captured to, empty if capture is disabled
+         * 
+         * @return const std::string&
+         */
+    const std::string& capturePath() {
+        if (result->count("capture_path"))
+            return result->operator[]("capture_path").as<std::string>();
+        return empty;
+    }
+
+    /**
+         * @brief Gets the fraction of predict requests captured
+         * 
+         * @return double
+         */
+    double captureSampleRatio() {
+        return result->operator[]("capture_sample_ratio").as<double>();
+    }
+
     /**
          * @brief Get the model name
          * 
@@ -283,5 +421,172 @@ public:
     uint filesystemPollWaitSeconds() {
         return result->operator[]("file_system_poll_wait_seconds").as<uint>();
     }
+
+    /**
+     * @brief Get the maximum number of models and versions loaded concurrently
+     * 
+     * @return uint 
+     */
+    uint modelLoadingThreads() {
+        return result->operator[]("model_loading_threads").as<uint>();
+    }
+
+    /**
+     * @brief Get the path of file with request counts of models, empty if disabled
+     *
+     * @return std::string
+     */
+    std::string modelUsageFile() {
+        if (result->count("model_usage_file"))
+            return result->operator[]("model_usage_file").as<std::string>();
+        return "";
+    }
+
+    /**
+     * @brief Tells whether servers are started before models are loaded
+     *
+     * @return bool
+     */
+    bool serveWhileLoading() {
+        return result->operator[]("serve_while_loading").as<bool>();
+    }
+
+    /**
+     * @brief Get the directory of exported compiled networks
+     * 
+     * @return const std::string&
+     */
+    const std::string& compiledModelCacheDir() {
+        if (result->count("compiled_model_cache_dir"))
+            return result->operator[]("compiled_model_cache_dir").as<std::string>();
+        return empty;
+    }
+
+    /**
+         * @brief Checks if compiled networks are shared between identical model versions
+         * 
+         * @return bool
+         */
+    bool shareCompiledNetworks() {
+        return result->operator[]("share_compiled_networks").as<bool>();
+    }
+
+    /**
+     * @brief Get the directory of cached files downloaded from cloud storage
+     * 
+     * @return const std::string&
+     */
+    const std::string& cloudModelCacheDir() {
+        if (result->count("cloud_model_cache_dir"))
+            return result->operator[]("cloud_model_cache_dir").as<std::string>();
+        return empty;
+    }
+
+    /**
+     * @brief Get the memory budget of loaded model versions in megabytes, 0 if unlimited
+     * 
+     * @return uint64_t
+     */
+    uint64_t modelMemoryBudgetMb() {
+        return result->operator[]("model_memory_budget_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get the memory budget of requests in progress in megabytes, 0 if unlimited
+     * 
+     * @return uint64_t
+     */
+    uint64_t inFlightMemoryBudgetMb() {
+        return result->operator[]("in_flight_memory_budget_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Get the maximum size of released tensor buffers kept for reuse in megabytes
+     * 
+     * @return uint64_t
+     */
+    uint64_t tensorPoolSizeMb() {
+        return result->operator[]("tensor_pool_size_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Whether tensor buffers are mapped from hugepages
+     * 
+     * @return bool
+     */
+    bool tensorPoolHugePages() {
+        return result->operator[]("tensor_pool_hugepages").as<bool>();
+    }
+
+    /**
+     * @brief Get the maximum size of uploaded tensors referred to by handle in megabytes, 0 if uploads are disabled
+     * 
+     * @return uint64_t
+     */
+    uint64_t tensorCacheSizeMb() {
+        return result->operator[]("tensor_cache_size_mb").as<uint64_t>();
+    }
+
+    /**
+     * @brief Gets the minimum size of response compressed with gzip, 0 if disabled
+     * 
+     * @return uint64_t
+     */
+    uint64_t responseCompressionMinBytes() {
+        return result->operator[]("response_compression_min_bytes").as<uint64_t>();
+    }
+
+    /**
+     * @brief Gets the limits of infer requests executing at once on devices, empty if devices are not limited
+     * 
+     * @return const std::string&
+     */
+    const std::string& deviceConcurrencyLimits() {
+        if (result->count("device_concurrency_limits"))
+            return result->operator[]("device_concurrency_limits").as<std::string>();
+        return empty;
+    }
+
+    /**
+     * @brief Gets the directory of samples inferred in offline batch mode, empty if servers are started instead
+     * 
+     * @return const std::string&
+     */
+    const std::string& batchInputDir() {
+        if (result->count("batch_input_dir"))
+            return result->operator[]("batch_input_dir").as<std::string>();
+        return empty;
+    }
+
+    /**
+     * @brief Gets the directory where outputs of samples are written in offline batch mode
+     * 
+     * @return const std::string&
+     */
+    const std::string& batchOutputDir() {
+        if (result->count("batch_output_dir"))
+            return result->operator[]("batch_output_dir").as<std::string>();
+        return empty;
+    }
+
+    /**
+     * @brief Gets the model or pipeline samples are inferred with in offline batch mode, model_name by default
+     * 
+     * @return const std::string&
+     */
+    const std::string& batchModelName() {
+        if (result->count("batch_model_name"))
+            return result->operator[]("batch_model_name").as<std::string>();
+        return modelName();
+    }
+
+    /**
+     * @brief Gets the maximum number of samples inferred at once in offline batch mode, 0 for default
+     * 
+     * @return uint32_t
+     */
+    uint32_t batchConcurrency() {
+        return result->operator[]("batch_concurrency").as<uint32_t>();
+    }
 };
 }  // namespace ovms
@@ -0,0 +1,257 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "cpuaffinity.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <pthread.h>
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+Status parseCpuList(const std::string& list, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) {
+            continue;
+        }
+        try {
+            size_t position = 0;
+            const int first = std::stoi(range, &position);
+            int last = first;
+            if (position < range.size()) {
+                if (range[position] != '-') {
+                    return StatusCode::CPU_AFFINITY_INVALID;
+                }
+                size_t lastPosition = 0;
+                last = std::stoi(range.substr(position + 1), &lastPosition);
+                if (position + 1 + lastPosition != range.size()) {
+                    return StatusCode::CPU_AFFINITY_INVALID;
+                }
+            }
+            if (first < 0 || last < first || last >= CPU_SETSIZE) {
+                return StatusCode::CPU_AFFINITY_INVALID;
+            }
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return StatusCode::CPU_AFFINITY_INVALID;
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return StatusCode::OK;
+}
+
+namespace {
+Status getAllowedCpus(std::vector<int>& cpus) {
+    cpu_set_t allowedCpus;
+    CPU_ZERO(&allowedCpus);
+    if (sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) != 0) {
+        SPDLOG_ERROR("Cannot get CPU affinity of the process");
+        return StatusCode::CPU_AFFINITY_INVALID;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowedCpus)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return StatusCode::OK;
+}
+}  // namespace
+
+Status getRequestedCpus(int numaNode, const std::string& cpuSet, std::vector<int>& cpus) {
+    cpus.clear();
+    std::string list = cpuSet;
+    if (list.empty()) {
+        if (numaNode < 0) {
+            return StatusCode::OK;
+        }
+        const std::string path = "/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist";
+        std::ifstream file(path);
+        if (!file.good() || !std::getline(file, list)) {
+            SPDLOG_ERROR("NUMA node: {} does not exist, cannot read {}", numaNode, path);
+            return StatusCode::CPU_AFFINITY_INVALID;
+        }
+    }
+    std::vector<int> requestedCpus;
+    auto status = parseCpuList(list, requestedCpus);
+    if (!status.ok()) {
+        SPDLOG_ERROR("Invalid CPU list: {}", list);
+        return status;
+    }
+    cpu_set_t allowedCpus;
+    CPU_ZERO(&allowedCpus);
+    if (sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) != 0) {
+        SPDLOG_ERROR("Cannot get CPU affinity of the process");
+        return StatusCode::CPU_AFFINITY_INVALID;
+    }
+    std::copy_if(requestedCpus.begin(), requestedCpus.end(), std::back_inserter(cpus),
+        [&allowedCpus](int cpu) { return CPU_ISSET(cpu, &allowedCpus); });
+    if (cpus.empty()) {
+        SPDLOG_ERROR("None of requested CPUs: {} is available for the process", list);
+        return StatusCode::CPU_AFFINITY_INVALID;
+    }
+    return StatusCode::OK;
+}
+
+Status getNumaNodesCpus(const std::vector<int>& cpuSet, std::vector<std::vector<int>>& nodesCpus) {
+    nodesCpus.clear();
+    std::vector<int> allowedCpus = cpuSet;
+    if (allowedCpus.empty()) {
+        auto status = getAllowedCpus(allowedCpus);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    const std::string onlinePath = "/sys/devices/system/node/online";
+    std::string list;
+    std::ifstream online(onlinePath);
+    std::vector<int> nodes;
+    if (!online.good() || !std::getline(online, list) || !parseCpuList(list, nodes).ok()) {
+        SPDLOG_ERROR("Cannot read NUMA nodes from {}", onlinePath);
+        return StatusCode::CPU_AFFINITY_INVALID;
+    }
+    for (auto node : nodes) {
+        const std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+        std::ifstream file(path);
+        std::vector<int> cpus;
+        // memory only nodes have empty CPU list
+        if (!file.good() || !std::getline(file, list) || list.empty() || !parseCpuList(list, cpus).ok()) {
+            continue;
+        }
+        std::vector<int> nodeCpus;
+        std::set_intersection(cpus.begin(), cpus.end(), allowedCpus.begin(), allowedCpus.end(), std::back_inserter(nodeCpus));
+        if (!nodeCpus.empty()) {
+            nodesCpus.push_back(std::move(nodeCpus));
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status splitCpus(const std::string& cpuSet, size_t count, std::vector<std::vector<int>>& cpuSets) {
+    cpuSets.clear();
+    std::vector<int> cpus;
+    auto status = cpuSet.empty() ? getAllowedCpus(cpus) : getRequestedCpus(-1, cpuSet, cpus);
+    if (!status.ok()) {
+        return status;
+    }
+    if (count == 0 || cpus.empty()) {
+        return StatusCode::OK;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (count > cpus.size()) {
+            cpuSets.push_back({cpus[i % cpus.size()]});
+            continue;
+        }
+        cpuSets.emplace_back(cpus.begin() + i * cpus.size() / count, cpus.begin() + (i + 1) * cpus.size() / count);
+    }
+    return StatusCode::OK;
+}
+
+CpuReservations& CpuReservations::getInstance() {
+    static CpuReservations instance;
+    return instance;
+}
+
+Status CpuReservations::reserve(const std::string& modelName, const std::vector<int>& cpus) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& [name, reservedCpus] : reservations) {
+        if (name == modelName) {
+            continue;
+        }
+        auto overlapping = std::find_first_of(cpus.begin(), cpus.end(), reservedCpus.begin(), reservedCpus.end());
+        if (overlapping != cpus.end()) {
+            SPDLOG_ERROR("CPU: {} requested by model: {} is reserved by model: {}", *overlapping, modelName, name);
+            return StatusCode::CPU_SET_RESERVED;
+        }
+    }
+    reservations[modelName] = cpus;
+    return StatusCode::OK;
+}
+
+void CpuReservations::release(const std::string& modelName) {
+    std::lock_guard<std::mutex> lock(mtx);
+    reservations.erase(modelName);
+}
+
+Status CpuReservations::excludeReserved(const std::string& modelName, std::vector<int>& cpus) const {
+    std::vector<int> reservedCpus;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto& [name, modelCpus] : reservations) {
+            if (name != modelName) {
+                reservedCpus.insert(reservedCpus.end(), modelCpus.begin(), modelCpus.end());
+            }
+        }
+    }
+    if (reservedCpus.empty()) {
+        return StatusCode::OK;
+    }
+    std::sort(reservedCpus.begin(), reservedCpus.end());
+    const bool requested = !cpus.empty();
+    if (!requested) {
+        auto status = getAllowedCpus(cpus);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    std::vector<int> unreservedCpus;
+    std::set_difference(cpus.begin(), cpus.end(), reservedCpus.begin(), reservedCpus.end(), std::back_inserter(unreservedCpus));
+    if (unreservedCpus.empty()) {
+        SPDLOG_ERROR("All CPUs {}available for model: {} are reserved by other models", requested ? "requested " : "", modelName);
+        return StatusCode::CPU_SET_RESERVED;
+    }
+    cpus = std::move(unreservedCpus);
+    return StatusCode::OK;
+}
+
+CpuAffinityGuard::CpuAffinityGuard(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+    CPU_ZERO(&previousCpus);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(previousCpus), &previousCpus) != 0) {
+        SPDLOG_WARN("Cannot get CPU affinity of the thread");
+        return;
+    }
+    cpu_set_t requestedCpus;
+    CPU_ZERO(&requestedCpus);
+    for (const int cpu : cpus) {
+        CPU_SET(cpu, &requestedCpus);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(requestedCpus), &requestedCpus) != 0) {
+        SPDLOG_WARN("Cannot set CPU affinity of the thread");
+        return;
+    }
+    changed = true;
+}
+
+CpuAffinityGuard::~CpuAffinityGuard() {
+    if (changed) {
+        pthread_setaffinity_np(pthread_self(), sizeof(previousCpus), &previousCpus);
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,123 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Parses list of CPUs in the format used by cpuset and sysfs, e.g. "0-3,8,10-11"
+ *
+ * @param list
+ * @param cpus sorted list of CPUs
+ *
+ * @return status
+ */
+Status parseCpuList(const std::string& list, std::vector<int>& cpus);
+
+/**
+ * @brief Gets CPUs the model should run on, from explicit CPU list or from CPUs of NUMA node
+ *
+ * CPUs not allowed for the process are skipped. Empty result with OK status means no affinity was requested.
+ *
+ * @param numaNode NUMA node or negative value if not set
+ * @param cpuSet CPU list, takes precedence over NUMA node
+ * @param cpus
+ *
+ * @return status
+ */
+Status getRequestedCpus(int numaNode, const std::string& cpuSet, std::vector<int>& cpus);
+
+/**
+ * @brief Gets CPUs of each NUMA node which are allowed for the process, nodes without such CPUs are skipped
+ *
+ * @param cpuSet CPU list nodes CPUs are limited to, all CPUs allowed for the process if empty
+ * @param nodesCpus sorted lists of CPUs, one for each node
+ *
+ * @return status
+ */
+Status getNumaNodesCpus(const std::vector<int>& cpuSet, std::vector<std::vector<int>>& nodesCpus);
+
+/**
+ * @brief Splits CPUs into consecutive sets of nearly equal size, e.g. for shards of servers
+ *
+ * When there are less CPUs than sets, CPUs are shared by sets in round robin order.
+ *
+ * @param cpuSet CPU list, all CPUs allowed for the process if empty
+ * @param count number of sets
+ * @param cpuSets
+ *
+ * @return status
+ */
+Status splitCpus(const std::string& cpuSet, size_t count, std::vector<std::vector<int>>& cpuSets);
+
+/**
+ * @brief CPUs reserved exclusively by models, so that inference streams of other models are kept off them
+ */
+class CpuReservations {
+    mutable std::mutex mtx;
+    std::map<std::string, std::vector<int>> reservations;
+
+public:
+    static CpuReservations& getInstance();
+
+    /**
+     * @brief Reserves CPUs for model, replacing its previous reservation
+     *
+     * @return CPU_SET_RESERVED if any of CPUs is reserved by other model
+     */
+    Status reserve(const std::string& modelName, const std::vector<int>& cpus);
+
+    void release(const std::string& modelName);
+
+    /**
+     * @brief Removes CPUs reserved by other models from CPUs of model. When no CPUs were requested and other
+     * models hold reservations, model gets all CPUs allowed for the process except reserved ones.
+     *
+     * @param cpus sorted list of requested CPUs, empty if no affinity was requested
+     *
+     * @return CPU_SET_RESERVED if all requested CPUs are reserved by other models
+     */
+    Status excludeReserved(const std::string& modelName, std::vector<int>& cpus) const;
+};
+
+/**
+ * @brief Restricts calling thread to given CPUs for its lifetime, restores previous affinity when destroyed
+ *
+ * Threads created meanwhile, e.g. plugin streams created during network load, inherit the affinity.
+ * Memory first touched by the thread is allocated on the NUMA node of the CPUs.
+ */
+class CpuAffinityGuard {
+    cpu_set_t previousCpus;
+    bool changed = false;
+
+public:
+    explicit CpuAffinityGuard(const std::vector<int>& cpus);
+    ~CpuAffinityGuard();
+
+    CpuAffinityGuard(const CpuAffinityGuard&) = delete;
+    CpuAffinityGuard& operator=(const CpuAffinityGuard&) = delete;
+};
+
+}  // namespace ovms
@@ -0,0 +1,219 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "custom_node.hpp"
+
+#include <utility>
+#include <vector>
+
+#include <dlfcn.h>
+#include <spdlog/spdlog.h>
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Output blob pointing into memory allocated by library, releases the memory once the blob is released
+ */
+struct LibraryBackedBlob {
+    std::shared_ptr<CustomNodeLibrary> library;
+    void* data;
+    InferenceEngine::Blob::Ptr blob;
+
+    LibraryBackedBlob(std::shared_ptr<CustomNodeLibrary> library, void* data, InferenceEngine::Blob::Ptr blob) :
+        library(std::move(library)),
+        data(data),
+        blob(std::move(blob)) {}
+    LibraryBackedBlob(const LibraryBackedBlob&) = delete;
+    LibraryBackedBlob& operator=(const LibraryBackedBlob&) = delete;
+
+    ~LibraryBackedBlob() {
+        blob.reset();
+        library->release(data);
+    }
+};
+
+CustomNodeTensorPrecision toCustomNodePrecision(InferenceEngine::Precision precision) {
+    switch (precision) {
+    case InferenceEngine::Precision::FP32:
+        return CUSTOM_NODE_FP32;
+    case InferenceEngine::Precision::FP16:
+        return CUSTOM_NODE_FP16;
+    case InferenceEngine::Precision::U8:
+        return CUSTOM_NODE_U8;
+    case InferenceEngine::Precision::I8:
+        return CUSTOM_NODE_I8;
+    case InferenceEngine::Precision::U16:
+        return CUSTOM_NODE_U16;
+    case InferenceEngine::Precision::I16:
+        return CUSTOM_NODE_I16;
+    case InferenceEngine::Precision::I32:
+        return CUSTOM_NODE_I32;
+    case InferenceEngine::Precision::I64:
+        return CUSTOM_NODE_I64;
+    default:
+        return CUSTOM_NODE_UNSPECIFIED;
+    }
+}
+
+template <typename T>
+InferenceEngine::Blob::Ptr wrapData(const InferenceEngine::TensorDesc& desc, uint8_t* data) {
+    return InferenceEngine::make_shared_blob<T>(desc, reinterpret_cast<T*>(data));
+}
+
+/**
+ * @brief Creates blob pointing to output data, nullptr for unsupported precision
+ */
+InferenceEngine::Blob::Ptr wrapOutput(const CustomNodeTensor& output, const InferenceEngine::SizeVector& dims) {
+    using InferenceEngine::Precision;
+    auto desc = [&dims](Precision precision) {
+        return InferenceEngine::TensorDesc(precision, dims, InferenceEngine::TensorDesc::getLayoutByDims(dims));
+    };
+    switch (output.precision) {
+    case CUSTOM_NODE_FP32:
+        return wrapData<float>(desc(Precision::FP32), output.data);
+    case CUSTOM_NODE_FP16:
+        return wrapData<int16_t>(desc(Precision::FP16), output.data);
+    case CUSTOM_NODE_U8:
+        return wrapData<uint8_t>(desc(Precision::U8), output.data);
+    case CUSTOM_NODE_I8:
+        return wrapData<int8_t>(desc(Precision::I8), output.data);
+    case CUSTOM_NODE_U16:
+        return wrapData<uint16_t>(desc(Precision::U16), output.data);
+    case CUSTOM_NODE_I16:
+        return wrapData<int16_t>(desc(Precision::I16), output.data);
+    case CUSTOM_NODE_I32:
+        return wrapData<int32_t>(desc(Precision::I32), output.data);
+    case CUSTOM_NODE_I64:
+        return wrapData<int64_t>(desc(Precision::I64), output.data);
+    case CUSTOM_NODE_UNSPECIFIED:
+    default:
+        return nullptr;
+    }
+}
+}  // namespace
+
+CustomNodeLibrary::~CustomNodeLibrary() {
+    dlclose(handle);
+}
+
+Status CustomNodeLibrary::load(const std::string& libraryPath, std::shared_ptr<CustomNodeLibrary>& library) {
+    static std::mutex librariesMtx;
+    static std::map<std::string, std::weak_ptr<CustomNodeLibrary>> libraries;
+    std::lock_guard<std::mutex> lock(librariesMtx);
+    library = libraries[libraryPath].lock();
+    if (library) {
+        return StatusCode::OK;
+    }
+    void* handle = dlopen(libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        SPDLOG_ERROR("Cannot open custom node library: {} {}", libraryPath, dlerror());
+        return StatusCode::CUSTOM_NODE_LIBRARY_INVALID;
+    }
+    auto executeFn = reinterpret_cast<execute_fn>(dlsym(handle, "execute"));
+    auto releaseFn = reinterpret_cast<release_fn>(dlsym(handle, "release"));
+    if (!executeFn || !releaseFn) {
+        SPDLOG_ERROR("Custom node library: {} does not export execute and release functions", libraryPath);
+        dlclose(handle);
+        return StatusCode::CUSTOM_NODE_LIBRARY_MISSING_FUNCTIONS;
+    }
+    library = std::shared_ptr<CustomNodeLibrary>(new CustomNodeLibrary(handle, executeFn, releaseFn));
+    libraries[libraryPath] = library;
+    SPDLOG_INFO("Loaded custom node library: {}", libraryPath);
+    return StatusCode::OK;
+}
+
+Status CustomNode::process() {
+    const auto& library = this->parameters.library;
+    if (!library) {
+        return StatusCode::CUSTOM_NODE_LIBRARY_INVALID;
+    }
+    // Inputs point to memory of blobs, kept by node until library returns
+    std::vector<std::vector<uint64_t>> inputsDims;
+    std::vector<CustomNodeTensor> inputs;
+    inputsDims.reserve(this->inputBlobs.size());
+    inputs.reserve(this->inputBlobs.size());
+    for (const auto& [name, blob] : this->inputBlobs) {
+        const auto& desc = blob->getTensorDesc();
+        const auto precision = toCustomNodePrecision(desc.getPrecision());
+        if (precision == CUSTOM_NODE_UNSPECIFIED) {
+            const std::string details = "Input: " + name + "; Actual: " + TensorInfo::getPrecisionAsString(desc.getPrecision());
+            SPDLOG_DEBUG("[Node: {}] Unsupported custom node input precision - {}", getName(), details);
+            return Status(StatusCode::INVALID_PRECISION, details);
+        }
+        const auto& dims = inputsDims.emplace_back(desc.getDims().begin(), desc.getDims().end());
+        inputs.push_back({name.c_str(), blob->buffer().as<uint8_t*>(), blob->byteSize(),
+            const_cast<uint64_t*>(dims.data()), dims.size(), precision});
+    }
+    std::vector<CustomNodeParam> params;
+    params.reserve(this->parameters.params.size());
+    for (const auto& [key, value] : this->parameters.params) {
+        params.push_back({key.c_str(), value.c_str()});
+    }
+
+    CustomNodeTensor* outputs = nullptr;
+    int outputsCount = 0;
+    int result = library->execute(inputs.data(), static_cast<int>(inputs.size()), &outputs, &outputsCount,
+        params.data(), static_cast<int>(params.size()));
+    if (result != 0) {
+        SPDLOG_DEBUG("[Node: {}] Custom node library {} returned error: {}", getName(), this->parameters.libraryPath, result);
+        return StatusCode::CUSTOM_NODE_EXECUTION_FAILED;
+    }
+
+    Status status = StatusCode::OK;
+    for (int i = 0; i < outputsCount; i++) {
+        auto& output = outputs[i];
+        InferenceEngine::SizeVector dims;
+        if (output.dims != nullptr) {
+            dims.assign(output.dims, output.dims + output.dimsCount);
+        }
+        InferenceEngine::Blob::Ptr blob;
+        if (status.ok() && output.name != nullptr && output.data != nullptr) {
+            blob = wrapOutput(output, dims);
+        }
+        if (blob && blob->byteSize() != output.dataBytes) {
+            blob.reset();
+        }
+        if (!blob) {
+            SPDLOG_DEBUG("[Node: {}] Custom node library {} returned output {} of unsupported precision or inconsistent size",
+                getName(), this->parameters.libraryPath, output.name != nullptr ? output.name : "");
+            status = StatusCode::CUSTOM_NODE_INVALID_OUTPUT;
+            if (output.data != nullptr) {
+                library->release(output.data);
+            }
+        } else {
+            // aliasing pointer - blob memory stays valid until following nodes release the blob
+            auto owner = std::make_shared<LibraryBackedBlob>(library, output.data, std::move(blob));
+            this->outputBlobs.emplace(output.name, InferenceEngine::Blob::Ptr(owner, owner->blob.get()));
+        }
+        if (output.name != nullptr) {
+            library->release(const_cast<char*>(output.name));
+        }
+        if (output.dims != nullptr) {
+            library->release(output.dims);
+        }
+    }
+    if (outputs != nullptr) {
+        library->release(outputs);
+    }
+    if (!status.ok()) {
+        this->outputBlobs.clear();
+    }
+    return status;
+}
+
+}  // namespace ovms
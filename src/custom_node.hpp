@@ -0,0 +1,91 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "built_in_node.hpp"
+#include "custom_node_interface.h"
+
+namespace ovms {
+
+/**
+ * @brief Shared library implementing custom node interface, unloaded once no pipeline definition uses it
+ */
+class CustomNodeLibrary {
+    using execute_fn = decltype(&::execute);
+    using release_fn = decltype(&::release);
+
+    void* handle;
+    execute_fn executeFn;
+    release_fn releaseFn;
+
+    CustomNodeLibrary(void* handle, execute_fn executeFn, release_fn releaseFn) :
+        handle(handle),
+        executeFn(executeFn),
+        releaseFn(releaseFn) {}
+
+public:
+    ~CustomNodeLibrary();
+
+    /**
+     * @brief Loads library or returns the one already loaded from the same path, so that reloaded pipelines share it
+     */
+    static Status load(const std::string& libraryPath, std::shared_ptr<CustomNodeLibrary>& library);
+
+    int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount,
+        const struct CustomNodeParam* params, int paramsCount) const {
+        return executeFn(inputs, inputsCount, outputs, outputsCount, params, paramsCount);
+    }
+
+    void release(void* ptr) const {
+        releaseFn(ptr);
+    }
+};
+
+struct CustomNodeParameters {
+    // Path of shared library implementing custom node interface
+    std::string libraryPath;
+    // Passed to library on each execution
+    std::map<std::string, std::string> params;
+    // Loaded while parsing configuration, nullptr if loading failed
+    std::shared_ptr<CustomNodeLibrary> library;
+};
+
+/**
+ * @brief Runs computation of custom node library inside pipeline, e.g. tokenizer or feature transform
+ *
+ * Inputs are passed to library as pointers to blob memory. Outputs allocated by library are passed to following nodes
+ * as blobs pointing to that memory, which is released by library once the last of them is released.
+ */
+class CustomNode : public BuiltInNode {
+    const CustomNodeParameters parameters;
+
+public:
+    CustomNode(const std::string& nodeName, const CustomNodeParameters& parameters,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        BuiltInNode(nodeName, nodeOutputNameAlias),
+        parameters(parameters) {}
+
+protected:
+    Status process() override;
+};
+
+}  // namespace ovms
@@ -0,0 +1,83 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Stable C interface of custom node libraries, executed as nodes of pipeline inside the server process.
+ * Library is loaded with dlopen and has to export execute and release functions declared below.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    CUSTOM_NODE_UNSPECIFIED,
+    CUSTOM_NODE_FP32,
+    CUSTOM_NODE_FP16,
+    CUSTOM_NODE_U8,
+    CUSTOM_NODE_I8,
+    CUSTOM_NODE_U16,
+    CUSTOM_NODE_I16,
+    CUSTOM_NODE_I32,
+    CUSTOM_NODE_I64
+} CustomNodeTensorPrecision;
+
+/**
+ * Tensor passed to and returned by library. Memory of input tensors belongs to the server and is valid until execute returns,
+ * it must not be written. Memory of output tensors is allocated by library and handed over to the server.
+ */
+struct CustomNodeTensor {
+    const char* name;
+    uint8_t* data;
+    uint64_t dataBytes;
+    uint64_t* dims;
+    uint64_t dimsCount;
+    CustomNodeTensorPrecision precision;
+};
+
+/**
+ * Key and value of parameter set in node configuration.
+ */
+struct CustomNodeParam {
+    const char* key;
+    const char* value;
+};
+
+/**
+ * Computes node outputs. Called concurrently by pipelines running at the same time.
+ *
+ * On success library allocates array of outputs and sets outputsCount. The array, name, data and dims of each output
+ * are released by the server with release. Output data is passed to following nodes without copying and released
+ * once the last of them finished using it.
+ *
+ * @return 0 on success, other value fails the pipeline
+ */
+int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount,
+    const struct CustomNodeParam* params, int paramsCount);
+
+/**
+ * Releases memory allocated by library in execute.
+ *
+ * @return 0 on success
+ */
+int release(void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
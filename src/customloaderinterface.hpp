@@ -15,7 +15,11 @@
 //*****************************************************************************
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace ovms {
@@ -30,6 +34,58 @@ enum class CustomLoaderStatus {
     INTERNAL_ERROR     /*!< generic error */
 };
 
+/**
+     * @brief Destination of the model read by custom loader.
+     * Weights are written directly to memory used by the network, without intermediate buffers.
+     */
+class CustomLoaderModelWriter {
+public:
+    virtual ~CustomLoaderModelWriter() {
+    }
+
+    /**
+         * @brief Sets the model topology (IR xml or ONNX)
+         *
+         * @param model
+         */
+    virtual void setModel(std::string&& model) = 0;
+
+    /**
+         * @brief Allocates the weights buffer to be filled by the loader.
+         * Distinct chunks of the buffer can be written concurrently, e.g. by threads decrypting parts of the weights file.
+         *
+         * @param size of weights in bytes
+         * @return buffer valid until the loader returns from loadModelStreamed
+         */
+    virtual uint8_t* allocateWeights(size_t size) = 0;
+
+    /**
+         * @brief Hands over weights read into a vector, ownership moves to the network
+         *
+         * @param weights
+         */
+    virtual void setWeights(std::vector<uint8_t>&& weights) = 0;
+
+    /**
+         * @brief Hands over weights in memory owned by the loader, e.g. decrypted into its own buffer.
+         * Memory is referenced by the network without copying and released by destroying the owner once model is unloaded.
+         *
+         * @param owner keeping the memory valid, the network shares its ownership
+         * @param data pointer to weights
+         * @param size of weights in bytes
+         */
+    virtual void setWeights(std::shared_ptr<const void> owner, const uint8_t* data, size_t size) = 0;
+
+    /**
+         * @brief Hands over weights stored in a file, e.g. decrypted to tmpfs.
+         * The file is mapped to memory instead of being read, it can be removed by the loader once loadModelStreamed returns.
+         *
+         * @param path of weights file
+         * @return false if file cannot be mapped
+         */
+    virtual bool setWeightsFile(const std::string& path) = 0;
+};
+
 /**
      * @brief This class is the custom loader interface base class.
      * Custom Loader implementation shall derive from this base calss
@@ -109,6 +165,42 @@ public:
          *
          */
     virtual CustomLoaderStatus loaderDeInit() = 0;
+
+    /**
+         * @brief Load the model by the custom loader directly into the memory used by the network.
+         * OVMS always loads models using this function, default implementation forwards to loadModel reading into vectors.
+         *
+         * @param model name required to be loaded - defined under model config in the config file
+         * @param base path where the required model files are present
+         * @param version of the model
+         * @param loader config parameters json as string
+         * @param writer receiving the model and weights
+         * @return status (On success, the return value will specify the type of model (IR,ONNX,BLOB) passed to writer)
+         */
+    virtual CustomLoaderStatus loadModelStreamed(const std::string& modelName,
+        const std::string& basePath,
+        const int version,
+        const std::string& loaderOptions,
+        CustomLoaderModelWriter& writer) {
+        std::vector<uint8_t> modelBuffer;
+        std::vector<uint8_t> weights;
+        CustomLoaderStatus status = loadModel(modelName, basePath, version, loaderOptions, modelBuffer, weights);
+        if ((status == CustomLoaderStatus::MODEL_TYPE_IR) || (status == CustomLoaderStatus::MODEL_TYPE_ONNX) || (status == CustomLoaderStatus::MODEL_TYPE_BLOB)) {
+            writer.setModel(std::string(modelBuffer.begin(), modelBuffer.end()));
+            writer.setWeights(std::move(weights));
+        }
+        return status;
+    }
+
+    /**
+         * @brief Tells whether loadModelStreamed can be called concurrently for different models and versions.
+         * Models of loaders which are not thread safe are loaded one by one.
+         *
+         * @return true if loader is thread safe
+         */
+    virtual bool supportsConcurrentLoading() const {
+        return false;
+    }
 };
 
 // the types of the class factories
@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "deadlinetimer.hpp"
+
+namespace ovms {
+
+DeadlineTimer::DeadlineTimer() :
+    thread([this]() { run(); }) {}
+
+DeadlineTimer::~DeadlineTimer() {
+    {
+        std::unique_lock lock(mtx);
+        stopped = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+DeadlineTimer& DeadlineTimer::getInstance() {
+    static DeadlineTimer instance;
+    return instance;
+}
+
+DeadlineTimer::TaskId DeadlineTimer::schedule(std::chrono::steady_clock::time_point time, std::function<void()> task) {
+    std::unique_lock lock(mtx);
+    const TaskId id = nextId++;
+    const bool earliest = tasks.empty() || time < tasks.begin()->first.first;
+    tasks.emplace(Key{time, id}, std::move(task));
+    scheduledTimes.emplace(id, time);
+    lock.unlock();
+    if (earliest) {
+        changed.notify_all();
+    }
+    return id;
+}
+
+bool DeadlineTimer::cancel(TaskId id) {
+    std::unique_lock lock(mtx);
+    auto it = scheduledTimes.find(id);
+    if (it != scheduledTimes.end()) {
+        tasks.erase(Key{it->second, id});
+        scheduledTimes.erase(it);
+        return true;
+    }
+    changed.wait(lock, [this, id]() { return runningId != id; });
+    return false;
+}
+
+void DeadlineTimer::run() {
+    std::unique_lock lock(mtx);
+    while (!stopped) {
+        if (tasks.empty()) {
+            changed.wait(lock);
+            continue;
+        }
+        const auto time = tasks.begin()->first.first;
+        if (std::chrono::steady_clock::now() < time) {
+            changed.wait_until(lock, time);
+            continue;
+        }
+        auto node = tasks.extract(tasks.begin());
+        runningId = node.key().second;
+        scheduledTimes.erase(runningId);
+        lock.unlock();
+        node.mapped()();
+        lock.lock();
+        runningId = 0;
+        changed.notify_all();
+    }
+}
+
+}  // namespace ovms
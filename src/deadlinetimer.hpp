@@ -0,0 +1,79 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace ovms {
+
+/**
+ * @brief Single thread running tasks once their time passes, used to enforce timeouts of asynchronous executions
+ *
+ * Tasks run one at a time on the timer thread, so they should only record expiration and hand over the work.
+ */
+class DeadlineTimer {
+public:
+    using TaskId = uint64_t;
+
+private:
+    using Key = std::pair<std::chrono::steady_clock::time_point, TaskId>;
+
+    std::mutex mtx;
+    std::condition_variable changed;
+    std::map<Key, std::function<void()>> tasks;
+    std::unordered_map<TaskId, std::chrono::steady_clock::time_point> scheduledTimes;
+    TaskId nextId = 1;
+    TaskId runningId = 0;
+    bool stopped = false;
+    std::thread thread;
+
+    void run();
+
+public:
+    DeadlineTimer();
+    ~DeadlineTimer();
+
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+
+    static DeadlineTimer& getInstance();
+
+    /**
+     * @brief Schedules task to run on timer thread once given time passes
+     *
+     * @return id of scheduled task, never 0
+     */
+    TaskId schedule(std::chrono::steady_clock::time_point time, std::function<void()> task);
+
+    /**
+     * @brief Cancels scheduled task, waits until it finishes if it is already running so that its state can be freed right after
+     *
+     * Must not be called from the task itself.
+     *
+     * @return true if task was cancelled before it started, false if it already ran
+     */
+    bool cancel(TaskId id);
+};
+
+}  // namespace ovms
@@ -0,0 +1,135 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "demultiplexer_node.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "ov_utils.hpp"
+
+namespace ovms {
+
+namespace {
+constexpr size_t DETECTION_SIZE = 7;
+
+struct Box {
+    float xMin, yMin, xMax, yMax;
+};
+
+float clamp01(float value) {
+    return std::min(std::max(value, 0.0f), 1.0f);
+}
+
+// image points to single CHW image
+void cropAndResize(const float* image, size_t channels, size_t height, size_t width,
+    const Box& box, float* crop, size_t cropHeight, size_t cropWidth) {
+    const float x0 = box.xMin * width;
+    const float y0 = box.yMin * height;
+    const float scaleX = (box.xMax - box.xMin) * width / cropWidth;
+    const float scaleY = (box.yMax - box.yMin) * height / cropHeight;
+    for (size_t oy = 0; oy < cropHeight; oy++) {
+        float sy = std::min(std::max(y0 + (oy + 0.5f) * scaleY - 0.5f, 0.0f), static_cast<float>(height - 1));
+        size_t y1 = static_cast<size_t>(sy);
+        size_t y2 = std::min(y1 + 1, height - 1);
+        float dy = sy - y1;
+        for (size_t ox = 0; ox < cropWidth; ox++) {
+            float sx = std::min(std::max(x0 + (ox + 0.5f) * scaleX - 0.5f, 0.0f), static_cast<float>(width - 1));
+            size_t x1 = static_cast<size_t>(sx);
+            size_t x2 = std::min(x1 + 1, width - 1);
+            float dx = sx - x1;
+            for (size_t c = 0; c < channels; c++) {
+                const float* plane = image + c * height * width;
+                float top = plane[y1 * width + x1] * (1 - dx) + plane[y1 * width + x2] * dx;
+                float bottom = plane[y2 * width + x1] * (1 - dx) + plane[y2 * width + x2] * dx;
+                crop[(c * cropHeight + oy) * cropWidth + ox] = top * (1 - dy) + bottom * dy;
+            }
+        }
+    }
+}
+}  // namespace
+
+Status DemultiplexerNode::process() {
+    auto imageItr = this->inputBlobs.find(DEMULTIPLEXER_IMAGE_INPUT_NAME);
+    auto detectionItr = this->inputBlobs.find(DEMULTIPLEXER_DETECTION_INPUT_NAME);
+    if (imageItr == this->inputBlobs.end() || detectionItr == this->inputBlobs.end()) {
+        SPDLOG_DEBUG("[Node: {}] Missing {} or {} input", getName(), DEMULTIPLEXER_IMAGE_INPUT_NAME, DEMULTIPLEXER_DETECTION_INPUT_NAME);
+        return StatusCode::INVALID_MISSING_INPUT;
+    }
+    const auto& image = imageItr->second;
+    const auto& detection = detectionItr->second;
+    if (image->getTensorDesc().getPrecision() != InferenceEngine::Precision::FP32 ||
+        detection->getTensorDesc().getPrecision() != InferenceEngine::Precision::FP32) {
+        SPDLOG_DEBUG("[Node: {}] Only FP32 image and detection inputs are supported", getName());
+        return StatusCode::INVALID_PRECISION;
+    }
+    const auto& imageDims = image->getTensorDesc().getDims();
+    const auto& detectionDims = detection->getTensorDesc().getDims();
+    if (imageDims.size() != 4 || imageDims[0] != 1 ||
+        detectionDims.size() != 4 || detectionDims[3] != DETECTION_SIZE) {
+        SPDLOG_DEBUG("[Node: {}] Expected image with shape [1,C,H,W] and detection with shape [1,1,N,{}]", getName(), DETECTION_SIZE);
+        return StatusCode::INVALID_SHAPE;
+    }
+    const size_t channels = imageDims[1];
+    const size_t height = imageDims[2];
+    const size_t width = imageDims[3];
+
+    auto crops = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32,
+        {parameters.maxCrops, channels, parameters.cropHeight, parameters.cropWidth}, InferenceEngine::Layout::NCHW));
+    auto coordinates = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32,
+        {parameters.maxCrops, 4}, InferenceEngine::Layout::NC));
+    auto cropsCount = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::I32,
+        {1}, InferenceEngine::Layout::C));
+
+    const float* imageData = image->cbuffer().as<const float*>();
+    const float* detections = detection->cbuffer().as<const float*>();
+    const size_t detectionsCount = detection->size() / DETECTION_SIZE;
+    const size_t cropSize = channels * parameters.cropHeight * parameters.cropWidth;
+    float* cropsData = crops->buffer().as<float*>();
+    float* coordinatesData = coordinates->buffer().as<float*>();
+    size_t count = 0;
+    for (size_t i = 0; i < detectionsCount && count < parameters.maxCrops; i++) {
+        const float* d = detections + i * DETECTION_SIZE;
+        if (d[0] < 0) {
+            // image_id -1 marks end of valid detections
+            break;
+        }
+        if (d[2] < parameters.confidenceThreshold) {
+            continue;
+        }
+        Box box{clamp01(d[3]), clamp01(d[4]), clamp01(d[5]), clamp01(d[6])};
+        if (box.xMax <= box.xMin || box.yMax <= box.yMin) {
+            continue;
+        }
+        cropAndResize(imageData, channels, height, width, box, cropsData + count * cropSize, parameters.cropHeight, parameters.cropWidth);
+        coordinatesData[count * 4 + 0] = box.xMin;
+        coordinatesData[count * 4 + 1] = box.yMin;
+        coordinatesData[count * 4 + 2] = box.xMax;
+        coordinatesData[count * 4 + 3] = box.yMax;
+        count++;
+    }
+    cropsCount->buffer().as<int32_t*>()[0] = static_cast<int32_t>(count);
+    SPDLOG_DEBUG("[Node: {}] Prepared {} crops out of {} detections", getName(), count, detectionsCount);
+
+    this->outputBlobs.emplace(DEMULTIPLEXER_CROPS_OUTPUT_NAME, std::move(crops));
+    this->outputBlobs.emplace(DEMULTIPLEXER_COORDINATES_OUTPUT_NAME, std::move(coordinates));
+    this->outputBlobs.emplace(DEMULTIPLEXER_CROPS_COUNT_OUTPUT_NAME, std::move(cropsCount));
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "built_in_node.hpp"
+
+namespace ovms {
+
+const std::string DEMULTIPLEXER_IMAGE_INPUT_NAME = "image";
+const std::string DEMULTIPLEXER_DETECTION_INPUT_NAME = "detection";
+const std::string DEMULTIPLEXER_CROPS_OUTPUT_NAME = "crops";
+const std::string DEMULTIPLEXER_CROPS_COUNT_OUTPUT_NAME = "crops_count";
+const std::string DEMULTIPLEXER_COORDINATES_OUTPUT_NAME = "coordinates";
+
+struct DemultiplexerParameters {
+    size_t cropWidth = 0;
+    size_t cropHeight = 0;
+    size_t maxCrops = 0;
+    float confidenceThreshold = 0.5;
+};
+
+/**
+ * @brief Splits image into crops of boxes found by detection model, so that they are processed by next node in one inference
+ *
+ * Takes NCHW FP32 image with batch 1 and detection output in [1, 1, N, 7] format of DetectionOutput layer
+ * (image_id, label, confidence, x_min, y_min, x_max, y_max with normalized coordinates, list ends at image_id -1).
+ * Boxes with confidence not lower than threshold are resized to crop size with bilinear interpolation and stacked
+ * into batch of max_crops, with unused rows zero filled. Number of crops and their normalized coordinates are
+ * passed as separate outputs, so that gather node can drop results of padding rows.
+ */
+class DemultiplexerNode : public BuiltInNode {
+    const DemultiplexerParameters parameters;
+
+public:
+    DemultiplexerNode(const std::string& nodeName, const DemultiplexerParameters& parameters,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        BuiltInNode(nodeName, nodeOutputNameAlias),
+        parameters(parameters) {}
+
+protected:
+    Status process() override;
+};
+
+}  // namespace ovms
@@ -15,8 +15,14 @@
 //*****************************************************************************
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
@@ -27,73 +33,83 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "imagedecoder.hpp"
+#include "sharedmemory.hpp"
 #include "status.hpp"
+#include "tensorbufferpool.hpp"
+#include "tensorcache.hpp"
 #include "tensorinfo.hpp"
+#include "workstealingexecutor.hpp"
 
 namespace ovms {
 
-template <typename T>
-InferenceEngine::Blob::Ptr makeBlob(const tensorflow::TensorProto& requestInput,
-    const std::shared_ptr<TensorInfo>& tensorInfo) {
-    return InferenceEngine::make_shared_blob<T>(
-        tensorInfo->getTensorDesc(),
-        const_cast<T*>(reinterpret_cast<const T*>(requestInput.tensor_content().data())));
-}
-
 class ConcreteTensorProtoDeserializator {
 public:
     static InferenceEngine::Blob::Ptr deserializeTensorProto(
         const tensorflow::TensorProto& requestInput,
         const std::shared_ptr<TensorInfo>& tensorInfo) {
-        switch (tensorInfo->getPrecision()) {
-        case InferenceEngine::Precision::FP32:
-            return makeBlob<float>(requestInput, tensorInfo);
-        case InferenceEngine::Precision::FP16: {
-            // Needs conversion due to zero padding for each value:
-            // https://github.com/tensorflow/tensorflow/blob/v2.2.0/tensorflow/core/framework/tensor.proto#L45
-            auto blob = InferenceEngine::make_shared_blob<uint16_t>(tensorInfo->getTensorDesc());
-            blob->allocate();
-            uint16_t* ptr = blob->buffer().as<uint16_t*>();
-            auto size = static_cast<size_t>(requestInput.half_val_size());
-            for (size_t i = 0; i < size; i++) {
-                ptr[i] = requestInput.half_val(i);
-            }
-            return blob;
-        }
-        case InferenceEngine::Precision::U8:
-            return makeBlob<uint8_t>(requestInput, tensorInfo);
-        case InferenceEngine::Precision::I8:
-            return makeBlob<int8_t>(requestInput, tensorInfo);
-        case InferenceEngine::Precision::U16: {
-            // Needs conversion due to zero padding for each value:
-            // https://github.com/tensorflow/tensorflow/blob/v2.2.0/tensorflow/core/framework/tensor.proto#L55
-            auto blob = InferenceEngine::make_shared_blob<uint16_t>(tensorInfo->getTensorDesc());
-            blob->allocate();
-            uint16_t* ptr = blob->buffer().as<uint16_t*>();
-            auto size = static_cast<size_t>(requestInput.int_val_size());
-            for (size_t i = 0; i < size; i++) {
-                ptr[i] = requestInput.int_val(i);
-            }
+        const auto& conversion = tensorInfo->getPrecisionConversion();
+        switch (conversion.requestField) {
+        case TensorProtoField::TENSOR_CONTENT:
+            return conversion.wrapContent(requestInput, tensorInfo->getTensorDesc());
+        case TensorProtoField::HALF_VAL:
+        case TensorProtoField::INT_VAL: {
+            // Needs conversion due to zero padding for each value
+            auto blob = createPooledBlob(tensorInfo->getTensorDesc());
+            conversion.copyValues(requestInput, blob->buffer().as<void*>());
             return blob;
         }
-        case InferenceEngine::Precision::I16:
-            return makeBlob<int16_t>(requestInput, tensorInfo);
-        case InferenceEngine::Precision::I32:
-            return makeBlob<int32_t>(requestInput, tensorInfo);
-
-        case InferenceEngine::Precision::I64:
-
-        case InferenceEngine::Precision::MIXED:
-        case InferenceEngine::Precision::Q78:
-        case InferenceEngine::Precision::BIN:
-        case InferenceEngine::Precision::BOOL:
-        case InferenceEngine::Precision::CUSTOM:
+        case TensorProtoField::NONE:
         default:
             return nullptr;
         }
     }
+
+    /**
+     * @brief Writes tensor proto content into already allocated blob memory
+     *
+     * @return false if precision is not supported or content size does not match blob
+     */
+    static bool deserializeTensorProtoToBlob(
+        const tensorflow::TensorProto& requestInput,
+        const std::shared_ptr<TensorInfo>& tensorInfo,
+        InferenceEngine::Blob::Ptr& blob) {
+        const auto& conversion = tensorInfo->getPrecisionConversion();
+        switch (conversion.requestField) {
+        case TensorProtoField::TENSOR_CONTENT:
+            if (requestInput.tensor_content().size() != blob->byteSize()) {
+                return false;
+            }
+            std::memcpy(blob->buffer().as<char*>(), requestInput.tensor_content().data(), requestInput.tensor_content().size());
+            return true;
+        case TensorProtoField::HALF_VAL:
+        case TensorProtoField::INT_VAL:
+            if (conversion.countValues(requestInput) != blob->size()) {
+                return false;
+            }
+            conversion.copyValues(requestInput, blob->buffer().as<void*>());
+            return true;
+        case TensorProtoField::NONE:
+        default:
+            return false;
+        }
+    }
 };
 
+/**
+ * @brief Decodes images sent as string_val into blob of model input layout and precision
+ */
+inline Status deserializeEncodedImages(
+    const tensorflow::TensorProto& requestInput,
+    const std::shared_ptr<TensorInfo>& tensorInfo,
+    InferenceEngine::Blob::Ptr& blob) {
+    if (blob == nullptr) {
+        blob = InferenceEngine::Blob::CreateFromData(std::make_shared<InferenceEngine::Data>("", tensorInfo->getTensorDesc()));
+        blob->allocate();
+    }
+    return decodeImages(requestInput, tensorInfo->getTensorDesc(), blob->buffer().as<void*>());
+}
+
 template <class TensorProtoDeserializator>
 InferenceEngine::Blob::Ptr deserializeTensorProto(
     const tensorflow::TensorProto& requestInput,
@@ -101,12 +117,69 @@ InferenceEngine::Blob::Ptr deserializeTensorProto(
     return TensorProtoDeserializator::deserializeTensorProto(requestInput, tensorInfo);
 }
 
+/**
+ * @brief Inputs copying at least that many bytes are deserialized concurrently, when there is more than one of them
+ */
+constexpr size_t PARALLEL_DESERIALIZATION_MIN_BYTES = 1 << 20;
+
+/**
+ * @brief Number of bytes deserialization copies or converts into blob memory, 0 when blob wraps request memory
+ */
+inline size_t getDeserializationCopySize(const tensorflow::TensorProto& requestInput, const TensorInfo& tensorInfo, bool preallocated) {
+    const auto& conversion = tensorInfo.getPrecisionConversion();
+    if (conversion.requestField == TensorProtoField::HALF_VAL || conversion.requestField == TensorProtoField::INT_VAL) {
+        return conversion.countValues(requestInput) * sizeof(uint16_t);
+    }
+    return preallocated ? requestInput.tensor_content().size() : 0;
+}
+
+/**
+ * @brief Executes deserialization of inputs, concurrently when more than one of them copies at least PARALLEL_DESERIALIZATION_MIN_BYTES
+ *
+ * @param tasks deserialization of each input, they can throw OV exceptions
+ * @param copySizes number of bytes copied by each task
+ *
+ * @return status of first failed task in order of tasks, OK if all succeeded
+ */
+inline Status executeDeserialization(const std::vector<std::function<Status()>>& tasks, const std::vector<size_t>& copySizes) {
+    std::vector<Status> statuses(tasks.size(), StatusCode::OK);
+    const size_t largeInputsCount = std::count_if(copySizes.begin(), copySizes.end(),
+        [](size_t copySize) { return copySize >= PARALLEL_DESERIALIZATION_MIN_BYTES; });
+    // helping workers pays off only when copies of at least two inputs can overlap
+    auto& executor = WorkStealingExecutor::getInstance();
+    const size_t helpers = largeInputsCount > 1 ? std::min<size_t>(largeInputsCount - 1, executor.getWorkersCount()) : 0;
+    executor.parallelFor(tasks.size(), helpers, [&tasks, &statuses](size_t i) {
+        // OV implementation the InferenceEngineException is not
+        // a base class for all other exceptions thrown from OV.
+        // OV can throw exceptions derived from std::logic_error.
+        try {
+            statuses[i] = tasks[i]();
+        } catch (const InferenceEngine::details::InferenceEngineException& e) {
+            statuses[i] = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            SPDLOG_DEBUG("{}: {}", statuses[i].string(), e.what());
+        } catch (std::logic_error& e) {
+            statuses[i] = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+            SPDLOG_DEBUG("{}: {}", statuses[i].string(), e.what());
+        }
+    });
+    for (const auto& status : statuses) {
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
 template <class TensorProtoDeserializator>
 Status deserializePredictRequest(
     const tensorflow::serving::PredictRequest& request,
     const tensor_map_t& inputMap,
     InferenceEngine::InferRequest& inferRequest) {
     try {
+        // inputs with data copied into new blob are deserialized after the others, concurrently if they are large
+        std::vector<std::pair<std::shared_ptr<TensorInfo>, InferenceEngine::Blob::Ptr>> copiedBlobs;
+        std::vector<std::function<Status()>> copyTasks;
+        std::vector<size_t> copySizes;
         for (const auto& pair : inputMap) {
             const auto& name = pair.first;
             auto tensorInfo = pair.second;
@@ -117,6 +190,54 @@ Status deserializePredictRequest(
             }
             auto& requestInput = requestInputItr->second;
 
+            if (isSharedMemoryTensor(requestInput)) {
+                // Data stays in shared memory region of the client, blob only points to it
+                InferenceEngine::Blob::Ptr blob;
+                auto status = createSharedMemoryBlob(requestInput, tensorInfo->getTensorDesc(), blob);
+                if (!status.ok()) {
+                    return status;
+                }
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+                continue;
+            }
+            if (isCachedTensorReference(requestInput)) {
+                // Data was uploaded to tensor cache once, blob only points to it
+                InferenceEngine::Blob::Ptr blob;
+                auto status = createCachedTensorBlob(requestInput, tensorInfo->getTensorDesc(), blob);
+                if (!status.ok()) {
+                    return status;
+                }
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+                continue;
+            }
+            if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+                InferenceEngine::Blob::Ptr blob;
+                auto status = deserializeEncodedImages(requestInput, tensorInfo, blob);
+                if (!status.ok()) {
+                    return status;
+                }
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+                continue;
+            }
+
+            const size_t copySize = getDeserializationCopySize(requestInput, *tensorInfo, false);
+            if (copySize > 0) {
+                const size_t index = copiedBlobs.size();
+                copiedBlobs.emplace_back(tensorInfo, nullptr);
+                copyTasks.emplace_back([&copiedBlobs, &requestInput, tensorInfo, index]() -> Status {
+                    auto& blob = copiedBlobs[index].second;
+                    blob = deserializeTensorProto<TensorProtoDeserializator>(requestInput, tensorInfo);
+                    if (blob == nullptr) {
+                        Status status = StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+                        SPDLOG_DEBUG(status.string());
+                        return status;
+                    }
+                    return StatusCode::OK;
+                });
+                copySizes.push_back(copySize);
+                continue;
+            }
+
             InferenceEngine::Blob::Ptr blob =
                 deserializeTensorProto<TensorProtoDeserializator>(
                     requestInput, tensorInfo);
@@ -128,6 +249,13 @@ Status deserializePredictRequest(
             }
             inferRequest.SetBlob(tensorInfo->getName(), blob);
         }
+        auto status = executeDeserialization(copyTasks, copySizes);
+        if (!status.ok()) {
+            return status;
+        }
+        for (const auto& [tensorInfo, blob] : copiedBlobs) {
+            inferRequest.SetBlob(tensorInfo->getName(), blob);
+        }
         // OV implementation the InferenceEngineException is not
         // a base class for all other exceptions thrown from OV.
         // OV can throw exceptions derived from std::logic_error.
@@ -143,4 +271,124 @@ Status deserializePredictRequest(
 
     return StatusCode::OK;
 }
+
+/**
+ * @brief Deserializes request into input blobs allocated once per infer request instead of wrapping request memory.
+ * Avoids blob allocation and plugin side reallocation on every request. Inputs which cannot be written
+ * into preallocated blob are deserialized regular way.
+ */
+template <class TensorProtoDeserializator>
+Status deserializePredictRequestToPreallocatedBlobs(
+    const tensorflow::serving::PredictRequest& request,
+    const tensor_map_t& inputMap,
+    InferenceEngine::InferRequest& inferRequest,
+    const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& preallocatedBlobs) {
+    try {
+        // copies into preallocated blobs are done after the loop, concurrently if they are large
+        std::vector<std::pair<std::shared_ptr<TensorInfo>, InferenceEngine::Blob::Ptr>> copiedBlobs;
+        std::vector<std::function<Status()>> copyTasks;
+        std::vector<size_t> copySizes;
+        for (const auto& pair : inputMap) {
+            const auto& name = pair.first;
+            auto tensorInfo = pair.second;
+            auto requestInputItr = request.inputs().find(name);
+            if (requestInputItr == request.inputs().end()) {
+                SPDLOG_DEBUG("Failed to deserialize request. Validation of request failed");
+                return Status(StatusCode::INTERNAL_ERROR, "Failed to deserialize request");
+            }
+            auto& requestInput = requestInputItr->second;
+
+            if (isSharedMemoryTensor(requestInput)) {
+                // Data stays in shared memory region of the client, blob only points to it
+                InferenceEngine::Blob::Ptr blob;
+                auto status = createSharedMemoryBlob(requestInput, tensorInfo->getTensorDesc(), blob);
+                if (!status.ok()) {
+                    return status;
+                }
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+                continue;
+            }
+            if (isCachedTensorReference(requestInput)) {
+                // Data was uploaded to tensor cache once, blob only points to it
+                InferenceEngine::Blob::Ptr blob;
+                auto status = createCachedTensorBlob(requestInput, tensorInfo->getTensorDesc(), blob);
+                if (!status.ok()) {
+                    return status;
+                }
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+                continue;
+            }
+            auto preallocatedBlobItr = preallocatedBlobs.find(name);
+            if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+                // Images are decoded straight into preallocated blob memory
+                InferenceEngine::Blob::Ptr blob;
+                if (preallocatedBlobItr != preallocatedBlobs.end() && preallocatedBlobItr->second->getTensorDesc() == tensorInfo->getTensorDesc()) {
+                    blob = preallocatedBlobItr->second;
+                }
+                auto status = deserializeEncodedImages(requestInput, tensorInfo, blob);
+                if (!status.ok()) {
+                    return status;
+                }
+                if (inferRequest.GetBlob(tensorInfo->getName()) != blob) {
+                    inferRequest.SetBlob(tensorInfo->getName(), blob);
+                }
+                continue;
+            }
+            InferenceEngine::Blob::Ptr preallocatedBlob;
+            if (preallocatedBlobItr != preallocatedBlobs.end() && preallocatedBlobItr->second->getTensorDesc() == tensorInfo->getTensorDesc()) {
+                preallocatedBlob = preallocatedBlobItr->second;
+            }
+            const size_t copySize = getDeserializationCopySize(requestInput, *tensorInfo, preallocatedBlob != nullptr);
+            if (copySize == 0) {
+                InferenceEngine::Blob::Ptr blob =
+                    deserializeTensorProto<TensorProtoDeserializator>(
+                        requestInput, tensorInfo);
+
+                if (blob == nullptr) {
+                    Status status = StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+                    SPDLOG_DEBUG(status.string());
+                    return status;
+                }
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+                continue;
+            }
+            const size_t index = copiedBlobs.size();
+            copiedBlobs.emplace_back(tensorInfo, preallocatedBlob);
+            copyTasks.emplace_back([&copiedBlobs, &requestInput, tensorInfo, index]() -> Status {
+                auto& blob = copiedBlobs[index].second;
+                if (blob != nullptr && TensorProtoDeserializator::deserializeTensorProtoToBlob(requestInput, tensorInfo, blob)) {
+                    return StatusCode::OK;
+                }
+                blob = deserializeTensorProto<TensorProtoDeserializator>(requestInput, tensorInfo);
+                if (blob == nullptr) {
+                    Status status = StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+                    SPDLOG_DEBUG(status.string());
+                    return status;
+                }
+                return StatusCode::OK;
+            });
+            copySizes.push_back(copySize);
+        }
+        auto status = executeDeserialization(copyTasks, copySizes);
+        if (!status.ok()) {
+            return status;
+        }
+        for (const auto& [tensorInfo, blob] : copiedBlobs) {
+            // Setting the same blob again is skipped so plugin does not reallocate its memory
+            if (inferRequest.GetBlob(tensorInfo->getName()) != blob) {
+                inferRequest.SetBlob(tensorInfo->getName(), blob);
+            }
+        }
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    } catch (std::logic_error& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    }
+
+    return StatusCode::OK;
+}
 }  // namespace ovms
@@ -0,0 +1,160 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "deviceconcurrencylimiter.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "stringutils.hpp"
+
+namespace ovms {
+namespace {
+// virtual time advanced by each slot granted to client with default weight
+const uint64_t VIRTUAL_TIME_STRIDE = 1 << 20;
+
+std::mutex limitersMtx;
+std::map<std::string, size_t> deviceLimits;
+std::map<std::string, std::shared_ptr<DeviceConcurrencyLimiter>> deviceLimiters;
+}  // namespace
+
+DeviceConcurrencyLimiter::DeviceConcurrencyLimiter(const std::string& device, size_t maxInFlight) :
+    device(device),
+    maxInFlight(maxInFlight) {}
+
+void DeviceConcurrencyLimiter::configure(const std::map<std::string, size_t>& limits) {
+    std::lock_guard<std::mutex> lock(limitersMtx);
+    deviceLimits = limits;
+    deviceLimiters.clear();
+}
+
+Status DeviceConcurrencyLimiter::parseLimits(const std::string& value, std::map<std::string, size_t>& limits) {
+    for (const std::string& deviceLimit : tokenize(value, ',')) {
+        std::vector<std::string> keyValue = tokenize(deviceLimit, '=');
+        if (keyValue.size() != 2) {
+            return StatusCode::DEVICE_CONCURRENCY_LIMITS_WRONG_FORMAT;
+        }
+        erase_spaces(keyValue[0]);
+        erase_spaces(keyValue[1]);
+        auto maxInFlight = stou32(keyValue[1]);
+        if (keyValue[0].empty() || !maxInFlight || maxInFlight.value() == 0) {
+            return StatusCode::DEVICE_CONCURRENCY_LIMITS_WRONG_FORMAT;
+        }
+        limits[keyValue[0]] = maxInFlight.value();
+    }
+    return StatusCode::OK;
+}
+
+std::shared_ptr<DeviceConcurrencyLimiter> DeviceConcurrencyLimiter::forDevice(const std::string& device) {
+    std::lock_guard<std::mutex> lock(limitersMtx);
+    auto limit = deviceLimits.find(device);
+    if (limit == deviceLimits.end()) {
+        return nullptr;
+    }
+    auto& limiter = deviceLimiters[device];
+    if (!limiter) {
+        limiter = std::make_shared<DeviceConcurrencyLimiter>(device, limit->second);
+    }
+    return limiter;
+}
+
+DeviceConcurrencyLimiter::client_id_t DeviceConcurrencyLimiter::registerClient(uint32_t weight, std::function<void()> onSlotAvailable) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const client_id_t id = nextClientId++;
+    Client& client = clients[id];
+    client.stride = VIRTUAL_TIME_STRIDE / std::max<uint32_t>(weight, 1);
+    client.onSlotAvailable = std::move(onSlotAvailable);
+    client.virtualTime = virtualTime;
+    return id;
+}
+
+void DeviceConcurrencyLimiter::unregisterClient(client_id_t id) {
+    std::unique_lock<std::mutex> lock(mtx);
+    auto it = clients.find(id);
+    if (it == clients.end()) {
+        return;
+    }
+    it->second.removed = true;
+    notified.wait(lock, [&it]() { return it->second.notifying == 0; });
+    clients.erase(it);
+}
+
+bool DeviceConcurrencyLimiter::tryAcquire(client_id_t id) {
+    std::lock_guard<std::mutex> lock(mtx);
+    Client& client = clients.at(id);
+    const uint64_t startTime = std::max(client.virtualTime, virtualTime);
+    const bool waitingBefore = std::any_of(clients.begin(), clients.end(), [id, startTime](const auto& other) {
+        return other.first != id && other.second.waiting && !other.second.removed && other.second.virtualTime < startTime;
+    });
+    if (inFlight < maxInFlight && !waitingBefore) {
+        inFlight++;
+        virtualTime = startTime;
+        client.virtualTime = startTime + client.stride;
+        client.waiting = false;
+        return true;
+    }
+    if (!client.waiting) {
+        // client idle so far does not get credit for the time it did not use the device
+        client.waiting = true;
+        client.virtualTime = startTime;
+    }
+    return false;
+}
+
+void DeviceConcurrencyLimiter::release() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (inFlight == 0) {
+            SPDLOG_ERROR("Released slot of device {} which was not acquired", device);
+            return;
+        }
+        inFlight--;
+    }
+    notifyWaitingClients();
+}
+
+size_t DeviceConcurrencyLimiter::getInFlight() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return inFlight;
+}
+
+void DeviceConcurrencyLimiter::notifyWaitingClients() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (inFlight < maxInFlight) {
+        Client* next = nullptr;
+        for (auto& [id, client] : clients) {
+            if (client.waiting && !client.removed && (next == nullptr || client.virtualTime < next->virtualTime)) {
+                next = &client;
+            }
+        }
+        if (next == nullptr) {
+            return;
+        }
+        // client either takes the slot from callback or waits again, then next one is tried while slots are free
+        next->waiting = false;
+        next->notifying++;
+        lock.unlock();
+        next->onSlotAvailable();
+        lock.lock();
+        if (--next->notifying == 0) {
+            notified.notify_all();
+        }
+    }
+}
+
+}  // namespace ovms
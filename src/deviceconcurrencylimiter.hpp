@@ -0,0 +1,134 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Caps number of infer requests executing at once on single device, shared by pools of all models loaded on it
+ *
+ * Pools waiting for free slot are served with weighted fair queueing: each granted slot advances virtual time of the
+ * pool by inverse of its weight and free slot goes to waiting pool with the lowest virtual time. Pool which was idle
+ * starts from current virtual time of the device, so that it does not get burst of slots for time it did not use.
+ */
+class DeviceConcurrencyLimiter {
+public:
+    using client_id_t = uint64_t;
+
+    /**
+     * @brief Weight of clients not configured otherwise
+     */
+    static const uint32_t DEFAULT_WEIGHT = 1;
+
+    DeviceConcurrencyLimiter(const std::string& device, size_t maxInFlight);
+
+    /**
+     * @brief Sets limits of devices which limiters get for, replaces previous ones. Limiters already taken keep their limit
+     *
+     * @param limits maximum number of infer requests executing at once, keyed by device name
+     */
+    static void configure(const std::map<std::string, size_t>& limits);
+
+    /**
+     * @brief Parses limits in format DEVICE=COUNT[,DEVICE=COUNT...], e.g. GPU=4,MYRIAD=8
+     */
+    static Status parseLimits(const std::string& value, std::map<std::string, size_t>& limits);
+
+    /**
+     * @brief Gets limiter shared by all models loaded on device
+     *
+     * @return limiter or nullptr if device is not limited
+     */
+    static std::shared_ptr<DeviceConcurrencyLimiter> forDevice(const std::string& device);
+
+    /**
+     * @brief Registers pool competing for slots of device
+     *
+     * @param weight share of slots given to the client when device is saturated, relative to weights of other clients
+     * @param onSlotAvailable called without locks held once slot was freed while client was waiting for it, client should try to acquire it then
+     */
+    client_id_t registerClient(uint32_t weight, std::function<void()> onSlotAvailable);
+
+    /**
+     * @brief Removes client, waits until notification about free slot in progress for it finishes
+     */
+    void unregisterClient(client_id_t id);
+
+    /**
+     * @brief Takes slot if device has free one and no client with lower virtual time is waiting for it.
+     * Otherwise client is marked as waiting and notified once slot is available
+     */
+    bool tryAcquire(client_id_t id);
+
+    /**
+     * @brief Returns slot taken with tryAcquire and hands it to waiting clients
+     */
+    void release();
+
+    const std::string& getDevice() const {
+        return device;
+    }
+
+    size_t getMaxInFlight() const {
+        return maxInFlight;
+    }
+
+    /**
+     * @brief Number of taken slots, intended for monitoring only
+     */
+    size_t getInFlight() const;
+
+private:
+    struct Client {
+        uint64_t stride;
+        std::function<void()> onSlotAvailable;
+        uint64_t virtualTime = 0;
+        bool waiting = false;
+        bool removed = false;
+        size_t notifying = 0;
+    };
+
+    /**
+     * @brief Notifies waiting clients with the lowest virtual time while there are free slots
+     */
+    void notifyWaitingClients();
+
+    const std::string device;
+    const size_t maxInFlight;
+
+    mutable std::mutex mtx;
+    std::condition_variable notified;
+    std::map<client_id_t, Client> clients;
+    client_id_t nextClientId = 0;
+    size_t inFlight = 0;
+
+    /**
+     * @brief Virtual time at which the latest slot was granted
+     */
+    uint64_t virtualTime = 0;
+};
+
+}  // namespace ovms
@@ -15,51 +15,49 @@
 //*****************************************************************************
 #include "dl_node.hpp"
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
 
+#include "blockingtasksexecutor.hpp"
 #include "modelmanager.hpp"
-#include "ov_utils.hpp"
 #include "ovinferrequestsqueue.hpp"
 #include "prediction_service_utils.hpp"
+#include "xxhash.hpp"
 
 namespace ovms {
 
-const uint WAIT_FOR_STREAM_ID_TIMEOUT_MICROSECONDS = 1;
+namespace {
+/**
+ * @brief Model instance of node kept loaded until last output blob passed without copy is released
+ */
+struct ModelInferenceResources {
+    std::shared_ptr<ModelInstance> model;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuard;
+};
+}  // namespace
 
-Status DLNode::execute(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue) {
+Status DLNode::execute(NodeNotificationQueue& notifyEndQueue) {
     Status status;
     if (this->nodeStreamIdGuard == nullptr) {
-        status = requestExecuteRequiredResources();
+        status = requestExecuteRequiredResources(notifyEndQueue);
         if (!status.ok()) {
             notifyEndQueue.push(*this);
             return status;
         }
     }
-    auto streamId = this->nodeStreamIdGuard->tryGetId(WAIT_FOR_STREAM_ID_TIMEOUT_MICROSECONDS);
-    if (!streamId) {
-        SPDLOG_DEBUG("[Node: {}] Could not acquire stream Id right away", getName());
-        return StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET;
+    if (this->batched) {
+        return executeBatchedInference(notifyEndQueue);
     }
-    auto& inferRequestsQueue = this->model->getInferRequestsQueue();
-    auto& inferRequest = inferRequestsQueue.getInferRequest(streamId.value());
-    status = setInputsForInference(inferRequest);
-    if (!status.ok()) {
-        notifyEndQueue.push(*this);
-        return status;
-    }
-    status = executeInference(notifyEndQueue, inferRequest);
-    if (!status.ok()) {
-        notifyEndQueue.push(*this);
-        return status;
-    }
-    return status;
+    return executeOnStream(notifyEndQueue);
 }
 
-Status DLNode::requestExecuteRequiredResources() {
+Status DLNode::requestExecuteRequiredResources(NodeNotificationQueue& notifyEndQueue) {
     Status status = StatusCode::OK;
     status = getModelInstance(
         this->modelManager,
@@ -77,92 +75,99 @@ Status DLNode::requestExecuteRequiredResources() {
     if (!status.ok()) {
         return status;
     }
+    if (this->model->getBatchingScheduler() != nullptr) {
+        // concurrent pipelines reaching this model are merged into one inference, scheduler takes infer request itself
+        this->batched = true;
+        return status;
+    }
     auto& inferRequestsQueue = this->model->getInferRequestsQueue();
-    this->nodeStreamIdGuard = std::make_unique<NodeStreamIdGuard>(inferRequestsQueue);
+    this->nodeStreamIdGuard = std::make_unique<NodeStreamIdGuard>(inferRequestsQueue, [this, &notifyEndQueue]() {
+        SPDLOG_DEBUG("[Node: {}] Stream Id assigned to deferred node", getName());
+        notifyEndQueue.push(*this);
+    });
     return status;
 }
 
-Status DLNode::setInputsForInference(InferenceEngine::InferRequest& infer_request) {
-    Status status = StatusCode::OK;
-    try {
-        // Prepare inference request, fill with input blobs
-        for (const auto& kv : this->inputBlobs) {
-            std::string realModelInputName;
-            if (!getRealInputName(kv.first, &realModelInputName).ok()) {
-                SPDLOG_WARN("DLNode::fetchResults (Node name {}); cannot find real model input name for ali{}", getName(), kv.first);
-                return StatusCode::INTERNAL_ERROR;
-            }
-            infer_request.SetBlob(realModelInputName, kv.second);
-        }
-        // OV implementation the InferenceEngineException is not
-        // a base class for all other exceptions thrown from OV.
-        // OV can throw exceptions derived from std::logic_error.
-    } catch (const InferenceEngine::details::InferenceEngineException& e) {
-        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
-        SPDLOG_DEBUG("[Node: {}] {}; exception message: {}", getName(), status.string(), e.what());
-    } catch (std::logic_error& e) {
-        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
-        SPDLOG_DEBUG("[Node: {}] {}; exception message: {}", getName(), status.string(), e.what());
-    } catch (...) {
-        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
-        SPDLOG_DEBUG("[Node: {}] {}; with unknown exception", getName(), status.string());
+Status DLNode::executeBatchedInference(NodeNotificationQueue& notifyEndQueue) {
+    if (this->inputBlobs.empty()) {
+        notifyEndQueue.push(*this);
+        return StatusCode::INVALID_MISSING_INPUT;
     }
-    return status;
+    const size_t batchSize = this->inputBlobs.begin()->second->getTensorDesc().getDims()[0];
+    SPDLOG_DEBUG("[Node: {}] Scheduling batched inference of model: {} with batch size: {}", getName(), modelName, batchSize);
+    // pipeline is not finished, so neither node nor notification queue are destroyed, until node notifies it has finished
+    bool scheduled = BlockingTasksExecutor::getInferencesInstance().schedule([this, &notifyEndQueue, batchSize]() {
+        this->batchedInferenceStatus = this->model->getBatchingScheduler()->execute(this->inputBlobs, batchSize, this->batchedOutputs);
+        this->inputBlobs.clear();
+        // node may be released by pipeline right after notification
+        notifyEndQueue.push(*this);
+    });
+    if (!scheduled) {
+        this->inputBlobs.clear();
+        notifyEndQueue.push(*this);
+        return StatusCode::SERVER_SHUTTING_DOWN;
+    }
+    return StatusCode::OK;
 }
 
-Status DLNode::executeInference(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue, InferenceEngine::InferRequest& infer_request) {
-    try {
-        SPDLOG_DEBUG("Setting completion callback for node name: {}", this->getName());
-        infer_request.SetCompletionCallback([this, &notifyEndQueue, &infer_request]() {
-            SPDLOG_DEBUG("Completion callback received for node name: {}", this->getName());
-            // After inference is completed, input blobs are not needed anymore
-            this->inputBlobs.clear();
-            notifyEndQueue.push(*this);
-            infer_request.SetCompletionCallback([]() {});  // reset callback on infer request
-        });
-        SPDLOG_DEBUG("Starting infer async for node name: {}", getName());
-        infer_request.StartAsync();
-    } catch (const InferenceEngine::details::InferenceEngineException& e) {
-        SPDLOG_DEBUG("[Node: {}] Exception occured when starting async inference or setting completion callback on model: {}, error: {}",
-            getName(), modelName, e.what());
-        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
-    } catch (const std::exception& e) {
-        SPDLOG_DEBUG("[Node: {}] Exception occured when starting async inference or setting completion callback on  model: {}, error: {}",
-            getName(), modelName, e.what());
-        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
-    } catch (...) {
-        SPDLOG_DEBUG("[Node: {}] Unknown exception occured when starting async inference or setting completion callback on model: {}",
-            getName(), modelName);
-        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+Status DLNode::fetchBatchedResults(BlobMap& outputs) {
+    if (!this->memoized && !this->batchedInferenceStatus.ok()) {
+        SPDLOG_DEBUG("[Node: {}] Batched inference failed: {}", getName(), this->batchedInferenceStatus.string());
+        return this->batchedInferenceStatus;
+    }
+    for (const auto& node : this->next) {
+        for (const auto& pair : node.get().getMappingByDependency(*this)) {
+            const auto& output_name = pair.first;
+            if (outputs.count(output_name) == 1) {
+                continue;
+            }
+            const auto& modelOutputName = getModelOutputName(output_name);
+            auto blobItr = this->batchedOutputs.find(modelOutputName);
+            if (blobItr == this->batchedOutputs.end()) {
+                SPDLOG_WARN("[Node: {}] Cannot find model output for alias {}", getName(), output_name);
+                return StatusCode::INVALID_MISSING_OUTPUT;
+            }
+            // blobs are sliced from batch into memory owned by this node, no copy needed
+            outputs.emplace(output_name, blobItr->second);
+        }
+    }
+    if (this->exportingOutputs) {
+        const auto requiredOutputs = getRequiredModelOutputs();
+        for (const auto& [name, blob] : this->batchedOutputs) {
+            if (requiredOutputs.count(name) == 1 || this->additionalExportedOutputs.count(name) == 1) {
+                this->exportedOutputs.emplace(name, blob);
+            }
+        }
     }
+    this->release();
     return StatusCode::OK;
 }
 
 Status DLNode::fetchResults(BlobMap& outputs) {
+    if (this->memoized) {
+        return fetchBatchedResults(outputs);
+    }
     // ::execute needs to be executed before ::fetchResults
     if (this->model == nullptr) {
         SPDLOG_DEBUG("[Node: {}] Fetching results failed due to earlier execution failure", getName());
         return StatusCode::UNKNOWN_ERROR;
     }
-
-    // Get infer request corresponding to this node model
-    auto streamId = this->nodeStreamIdGuard->tryGetId();
-    if (!streamId) {
-        SPDLOG_DEBUG("[Node: {}] Fetching results failed - node had stream Id never assigned", getName());
-        return StatusCode::UNKNOWN_ERROR;
+    if (this->batched) {
+        return fetchBatchedResults(outputs);
     }
-    auto& infer_request = this->model->getInferRequestsQueue().getInferRequest(streamId.value());
-    // Wait for blob results
-    SPDLOG_DEBUG("[Node: {}] Waiting for infer request with streamId:{} to finish", getName(), streamId.value());
-    auto ov_status = infer_request.Wait(InferenceEngine::IInferRequest::RESULT_READY);
-    SPDLOG_DEBUG("[Node: {}] Infer request with streamId:{} finished", getName(), streamId.value());
-    this->inputBlobs.clear();
-    if (ov_status != InferenceEngine::StatusCode::OK) {
-        Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
-        SPDLOG_DEBUG("[Node: {}] Async infer failed: {}; OV StatusCode: {}", getName(), status.string(), ov_status);
+
+    // Wait for infer request corresponding to this node model
+    InferenceEngine::InferRequest* inferRequest = nullptr;
+    auto status = waitForInference(inferRequest);
+    if (!status.ok()) {
         return status;
     }
 
+    std::shared_ptr<InferRequestOutputsOwner> outputsOwner;
+    if (this->zeroCopyOutputs) {
+        outputsOwner = std::make_shared<InferRequestOutputsOwner>();
+    }
+
     // Fill outputs map with result blobs. Fetch only those that are required in following nodes.
     for (const auto& node : this->next) {
         for (const auto& pair : node.get().getMappingByDependency(*this)) {
@@ -170,37 +175,125 @@ Status DLNode::fetchResults(BlobMap& outputs) {
             if (outputs.count(output_name) == 1) {
                 continue;
             }
-
-            try {
-                std::string realModelOutputName;
-                if (!getRealOutputName(output_name, &realModelOutputName).ok()) {
-                    SPDLOG_WARN("[Node: {}] Cannot find real model output name for alias{}", getName(), output_name);
-                    return StatusCode::INTERNAL_ERROR;
-                }
-                SPDLOG_DEBUG("[Node: {}] Getting blob from model:{}, inferRequestStreamId:{}, blobName:{}",
-                    getName(), modelName, streamId.value(), realModelOutputName);
-                const auto blob = infer_request.GetBlob(realModelOutputName);
-                SPDLOG_DEBUG("[Node: {}] Creating copy of blob from model:{}, inferRequestStreamId:{}, blobName:{}",
-                    getName(), modelName, streamId.value(), realModelOutputName);
-                const auto copiedBlob = blobClone(blob);
-                if (copiedBlob == nullptr) {
-                    SPDLOG_ERROR("[Node: {}] Cannot copy blob - buffer sizes mismatch", getName());
-                    return StatusCode::INTERNAL_ERROR;
-                }
-                outputs.emplace(std::make_pair(output_name, std::move(copiedBlob)));
-            } catch (const InferenceEngine::details::InferenceEngineException& e) {
-                Status status = StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
-                SPDLOG_DEBUG("[Node: {}] Error during getting blob {}; exception message: {}", getName(), status.string(), e.what());
+            // outputs filtered out by request are not fetched, unless memoized for other requests
+            if (!this->exportingOutputs && !node.get().isInputRequired(pair.second)) {
+                continue;
+            }
+            std::string realModelOutputName;
+            if (!getRealOutputName(output_name, &realModelOutputName).ok()) {
+                SPDLOG_WARN("[Node: {}] Cannot find real model output name for alias{}", getName(), output_name);
+                return StatusCode::INTERNAL_ERROR;
+            }
+            InferenceEngine::Blob::Ptr blob;
+            status = fetchOutput(*inferRequest, realModelOutputName, outputsOwner, blob);
+            if (!status.ok()) {
                 return status;
             }
+            outputs.emplace(std::make_pair(output_name, std::move(blob)));
+            exportOutput(output_name, outputs.at(output_name));
             SPDLOG_DEBUG("[Node: {}]: Blob with name {} has been prepared", getName(), output_name);
         }
     }
+    // Outputs required only by nodes memoizing results of this node
+    for (const auto& modelOutputName : this->additionalExportedOutputs) {
+        if (this->exportedOutputs.count(modelOutputName) == 1) {
+            continue;
+        }
+        auto outputInfoItr = this->model->getOutputsInfo().find(modelOutputName);
+        if (outputInfoItr == this->model->getOutputsInfo().end()) {
+            SPDLOG_WARN("[Node: {}] Cannot find model output {} required by memoizing node", getName(), modelOutputName);
+            return StatusCode::INVALID_MISSING_OUTPUT;
+        }
+        InferenceEngine::Blob::Ptr blob;
+        status = fetchOutput(*inferRequest, outputInfoItr->second->getName(), outputsOwner, blob);
+        if (!status.ok()) {
+            return status;
+        }
+        this->exportedOutputs.emplace(modelOutputName, std::move(blob));
+    }
+    if (outputsOwner) {
+        // Inference request is released once following nodes do not need its outputs anymore
+        outputsOwner->inferenceResources = std::make_shared<ModelInferenceResources>(
+            ModelInferenceResources{std::move(this->model), std::move(this->modelUnloadGuard)});
+        outputsOwner->nodeStreamIdGuard = std::move(this->nodeStreamIdGuard);
+    }
     // After results are fetched, model and inference request are not needed anymore
     this->release();
     return StatusCode::OK;
 }
 
+void DLNode::exportOutput(const std::string& alias, const InferenceEngine::Blob::Ptr& blob) {
+    if (!this->exportingOutputs) {
+        return;
+    }
+    this->exportedOutputs.emplace(getModelOutputName(alias), blob);
+}
+
+std::string DLNode::getMemoizationGroup() const {
+    return this->modelName + ":" + std::to_string(this->modelVersion.value_or(0));
+}
+
+uint64_t DLNode::computeMemoizationKey() const {
+    XXHash64 hash;
+    hash.updateString(getMemoizationGroup());
+    // blob map iteration order is not defined
+    std::vector<std::string> names;
+    names.reserve(this->inputBlobs.size());
+    for (const auto& [name, blob] : this->inputBlobs) {
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    for (const auto& name : names) {
+        const auto& blob = this->inputBlobs.at(name);
+        const auto& desc = blob->getTensorDesc();
+        hash.updateString(name);
+        const int precision = desc.getPrecision();
+        hash.update(&precision, sizeof(precision));
+        const auto& dims = desc.getDims();
+        const size_t dimsCount = dims.size();
+        hash.update(&dimsCount, sizeof(dimsCount));
+        hash.update(dims.data(), dims.size() * sizeof(size_t));
+        hash.update(blob->cbuffer().as<const void*>(), blob->byteSize());
+    }
+    return hash.digest();
+}
+
+std::set<std::string> DLNode::getRequiredModelOutputs() const {
+    std::set<std::string> names;
+    for (const auto& node : this->next) {
+        for (const auto& pair : node.get().getMappingByDependency(*this)) {
+            const auto& alias = pair.first;
+            names.insert(getModelOutputName(alias));
+        }
+    }
+    return names;
+}
+
+void DLNode::exportOutputs(const std::set<std::string>& additionalOutputs) {
+    this->exportingOutputs = true;
+    this->additionalExportedOutputs.insert(additionalOutputs.begin(), additionalOutputs.end());
+}
+
+BlobMap DLNode::takeExportedOutputs() {
+    BlobMap outputs = std::move(this->exportedOutputs);
+    this->exportedOutputs.clear();
+    this->additionalExportedOutputs.clear();
+    this->exportingOutputs = false;
+    return outputs;
+}
+
+bool DLNode::setMemoizedOutputs(const BlobMap& outputs) {
+    for (const auto& name : getRequiredModelOutputs()) {
+        if (outputs.count(name) == 0) {
+            return false;
+        }
+    }
+    this->batchedOutputs = outputs;
+    this->memoized = true;
+    this->inputBlobs.clear();
+    return true;
+}
+
 Status DLNode::validate(const InferenceEngine::Blob::Ptr& blob, const TensorInfo& info) {
     if (info.getPrecision() != blob->getTensorDesc().getPrecision()) {
         std::stringstream ss;
@@ -244,6 +337,7 @@ Status DLNode::validate(const InferenceEngine::Blob::Ptr& blob, const TensorInfo
 
 Status DLNode::prepareInputsAndModelForInference() {
     size_t requestedBatchSize = 0;
+    size_t batchingSchedulerBatchSize = 0;
     std::map<std::string, shape_t> requestedReshapes;
 
     // Validate each blob against its OV tensor info
@@ -270,6 +364,20 @@ Status DLNode::prepareInputsAndModelForInference() {
             return status;
         }
 
+        // Dynamically batched model accepts inputs up to max batch size, they are merged with other requests
+        if (status == StatusCode::INVALID_BATCH_SIZE && this->model->getBatchingScheduler() != nullptr) {
+            const size_t blobBatchSize = blob->getTensorDesc().getDims()[0];
+            if (blobBatchSize == 0 || blobBatchSize > this->model->getBatchSize()) {
+                return status;
+            }
+            if (batchingSchedulerBatchSize != 0 && blobBatchSize != batchingSchedulerBatchSize) {
+                SPDLOG_DEBUG("[Node: {}] Inputs of dynamically batched model have different batch sizes", getName());
+                return status;
+            }
+            batchingSchedulerBatchSize = blobBatchSize;
+            continue;
+        }
+
         // If batch size is incorrect, perform network batch size change if allowed (shape mode=auto or batch size=auto)
         if (status == StatusCode::INVALID_BATCH_SIZE) {
             if (this->model->getModelConfig().getBatchingMode() == Mode::AUTO) {
@@ -17,42 +17,54 @@
 
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "executinstreamidguard.hpp"
+#include "infer_request_node.hpp"
 #include "model_version_policy.hpp"  // for model_version_t typename
 #include "modelinstance.hpp"
 #include "modelinstanceunloadguard.hpp"
-#include "node.hpp"
-#include "nodestreamidguard.hpp"
 
 namespace ovms {
 
 class ModelManager;
 
-class DLNode : public Node {
+class DLNode : public InferRequestNode {
     std::string modelName;
     std::optional<model_version_t> modelVersion;
     ModelManager& modelManager;
-    const std::unordered_map<std::string, std::string> nodeOutputNameAlias;
 
     std::shared_ptr<ModelInstance> model;
-    std::unique_ptr<NodeStreamIdGuard> nodeStreamIdGuard;
     std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuard;
 
+    // Outputs and status of inference batched with other pipelines by scheduler of dynamically batched model
+    BlobMap batchedOutputs;
+    Status batchedInferenceStatus;
+    bool batched = false;
+
+    // Outputs taken from node with the same model and inputs instead of running inference, served like batched outputs
+    bool memoized = false;
+
+    // Outputs keyed by model output names exported for nodes memoizing results of this node
+    bool exportingOutputs = false;
+    std::set<std::string> additionalExportedOutputs;
+    BlobMap exportedOutputs;
+
 public:
     DLNode(const std::string& nodeName, const std::string& modelName, std::optional<model_version_t> modelVersion,
         ModelManager& modelManager,
-        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
-        Node(nodeName),
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {},
+        bool zeroCopyOutputs = false) :
+        InferRequestNode(nodeName, std::move(nodeOutputNameAlias), zeroCopyOutputs),
         modelName(modelName),
         modelVersion(modelVersion),
-        modelManager(modelManager),
-        nodeOutputNameAlias(nodeOutputNameAlias) {
+        modelManager(modelManager) {
     }
 
-    Status execute(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue) override;
+    Status execute(NodeNotificationQueue& notifyEndQueue) override;
 
     Status fetchResults(BlobMap& outputs) override;
 
@@ -66,23 +78,65 @@ public:
      */
     Status prepareInputsAndModelForInference();
 
-    bool tryDisarmStreamIdGuard(const uint microseconds = 1) override {
-        SPDLOG_DEBUG("Trying to disarm stream id guard of node: {}", getName());
-        if (this->nodeStreamIdGuard == nullptr) {
-            return true;
-        }
-        return this->nodeStreamIdGuard->tryDisarm(microseconds);
-    }
-
     void release() override {
         SPDLOG_DEBUG("Releasing resources for node {}", getName());
-        this->nodeStreamIdGuard.reset();
+        InferRequestNode::release();
+        this->batchedOutputs.clear();
+        this->batched = false;
+        this->memoized = false;
         this->model.reset();
         this->modelUnloadGuard.reset();
     }
 
-private:
-    Status getRealInputName(const std::string& alias, std::string* result) const {
+    void reset() override {
+        this->exportingOutputs = false;
+        this->additionalExportedOutputs.clear();
+        this->exportedOutputs.clear();
+        InferRequestNode::reset();
+    }
+
+    /**
+     * @brief Identifies nodes producing the same outputs for the same inputs
+     */
+    std::string getMemoizationGroup() const;
+
+    /**
+     * @brief Computes hash of model and content of input blobs, valid once node is ready
+     */
+    uint64_t computeMemoizationKey() const;
+
+    /**
+     * @brief Names of model outputs required by following nodes
+     */
+    std::set<std::string> getRequiredModelOutputs() const;
+
+    /**
+     * @brief Makes node keep fetched outputs by model output names, including outputs not required by following nodes
+     *
+     * @param additionalOutputs model output names required by nodes memoizing results of this node
+     */
+    void exportOutputs(const std::set<std::string>& additionalOutputs);
+
+    /**
+     * @brief Takes outputs kept since exportOutputs, valid after results are fetched
+     */
+    BlobMap takeExportedOutputs();
+
+    /**
+     * @brief Uses outputs of other node instead of running inference, node is ready for fetching results right away
+     *
+     * @param outputs keyed by model output names
+     *
+     * @return false if some of outputs required by following nodes is missing
+     */
+    bool setMemoizedOutputs(const BlobMap& outputs);
+
+protected:
+    OVInferRequestsQueue* getInferRequestsQueue() override {
+        return this->model ? &this->model->getInferRequestsQueue() : nullptr;
+    }
+
+    Status getRealInputName(const std::string& alias, std::string* result) const override {
         if (this->model->getInputsInfo().count(alias) == 0) {
             return StatusCode::INVALID_MISSING_INPUT;
         }
@@ -90,8 +144,19 @@ private:
         return StatusCode::OK;
     }
 
+    const std::string& getInferredModelName() const override { return modelName; }
+
+    size_t getInFlightMemoryBudgetBytes() const override {
+        return this->model->getModelConfig().getInFlightMemoryBudgetMb() * 1024 * 1024;
+    }
+
+    uint32_t getCompletionSpinMicroseconds() const override {
+        return this->model->getModelConfig().getCompletionSpinMicroseconds();
+    }
+
+private:
     Status getRealOutputName(const std::string& alias, std::string* result) const {
-        const auto& modelOutputName = nodeOutputNameAlias.count(alias) == 1 ? nodeOutputNameAlias.at(alias) : alias;
+        const auto& modelOutputName = getModelOutputName(alias);
         if (this->model->getOutputsInfo().count(modelOutputName) == 0) {
             return StatusCode::INVALID_MISSING_OUTPUT;
         }
@@ -99,9 +164,18 @@ private:
         return StatusCode::OK;
     }
 
-    Status requestExecuteRequiredResources();
-    Status setInputsForInference(InferenceEngine::InferRequest& infer_request);
-    Status executeInference(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue, InferenceEngine::InferRequest& infer_request);
+    Status requestExecuteRequiredResources(NodeNotificationQueue& notifyEndQueue);
+
+    /**
+     * @brief Passes inputs to batching scheduler of the model on separate thread, since batched execution blocks
+     */
+    Status executeBatchedInference(NodeNotificationQueue& notifyEndQueue);
+    Status fetchBatchedResults(BlobMap& outputs);
+
+    /**
+     * @brief Keeps fetched output for nodes memoizing results of this node
+     */
+    void exportOutput(const std::string& alias, const InferenceEngine::Blob::Ptr& blob);
 };
 
 }  // namespace ovms
@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "downloadcache.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+#include "fnvhash.hpp"
+
+namespace ovms {
+
+DownloadCache::DownloadCache(const std::string& directory) :
+    directory(directory) {}
+
+std::string DownloadCache::createKey(const std::vector<std::string>& identity) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const auto& field : identity) {
+        hashString(hash, field);
+    }
+    std::stringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+std::string DownloadCache::getCachedFilePath(const std::string& key) const {
+    return (std::filesystem::path(directory) / key).string();
+}
+
+namespace {
+// hard link shares the file without copying, copy is needed when paths are on different filesystems
+bool linkOrCopy(const std::string& from, const std::string& to) {
+    if (::link(from.c_str(), to.c_str()) == 0) {
+        return true;
+    }
+    std::error_code ec;
+    std::filesystem::copy_file(from, to, ec);
+    return !ec;
+}
+}  // namespace
+
+bool DownloadCache::restore(const std::string& key, const std::string& localPath) const {
+    const auto cachedFilePath = getCachedFilePath(key);
+    std::error_code ec;
+    if (!std::filesystem::exists(cachedFilePath, ec)) {
+        return false;
+    }
+    std::filesystem::remove(localPath, ec);
+    if (!linkOrCopy(cachedFilePath, localPath)) {
+        SPDLOG_WARN("Failed to restore file:{} from download cache:{}", localPath, cachedFilePath);
+        return false;
+    }
+    SPDLOG_DEBUG("Restored file:{} from download cache:{}", localPath, cachedFilePath);
+    return true;
+}
+
+void DownloadCache::store(const std::string& key, const std::string& localPath) const {
+    static std::atomic<uint64_t> tmpFileCounter = 0;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    const auto cachedFilePath = getCachedFilePath(key);
+    // file is published with rename so that other loads and server instances never see it partially written
+    const auto tmpFilePath = cachedFilePath + ".tmp" + std::to_string(::getpid()) + "_" + std::to_string(tmpFileCounter++);
+    if (!linkOrCopy(localPath, tmpFilePath)) {
+        SPDLOG_WARN("Failed to store file:{} in download cache:{}", localPath, directory);
+        std::filesystem::remove(tmpFilePath, ec);
+        return;
+    }
+    std::filesystem::rename(tmpFilePath, cachedFilePath, ec);
+    if (ec) {
+        SPDLOG_WARN("Failed to store file:{} in download cache:{}; error: {}", localPath, directory, ec.message());
+        std::filesystem::remove(tmpFilePath, ec);
+        return;
+    }
+    SPDLOG_DEBUG("Stored file:{} in download cache:{}", localPath, cachedFilePath);
+}
+
+bool DownloadDeduplicator::isDuplicate(const std::string& key, const std::string& localPath) {
+    auto [it, inserted] = downloadedPaths.emplace(key, localPath);
+    if (inserted) {
+        return false;
+    }
+    duplicates.emplace_back(it->second, localPath);
+    return true;
+}
+
+bool DownloadDeduplicator::linkDuplicates() const {
+    for (const auto& [downloadedPath, localPath] : duplicates) {
+        std::error_code ec;
+        std::filesystem::remove(localPath, ec);
+        if (!linkOrCopy(downloadedPath, localPath)) {
+            SPDLOG_ERROR("Failed to put file:{} with the same content as downloaded:{}", localPath, downloadedPath);
+            return false;
+        }
+        SPDLOG_DEBUG("File:{} has the same content as downloaded:{}, linked instead of downloading", localPath, downloadedPath);
+    }
+    return true;
+}
+
+}  // namespace ovms
@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Persistent local store of files downloaded from cloud storage
+ *
+ * Files are identified by a key built from object metadata describing its content, like ETag, generation or content hash,
+ * and kept in the cache directory under that key. Downloaded model directories contain hard links to the cached files,
+ * so removing them after the model is loaded keeps the cache intact. Cached files are never modified in place.
+ */
+class DownloadCache {
+    const std::string directory;
+
+    std::string getCachedFilePath(const std::string& key) const;
+
+public:
+    explicit DownloadCache(const std::string& directory);
+
+    const std::string& getDirectory() const { return directory; }
+
+    /**
+     * @brief Creates cache key from fields identifying content of remote object
+     *
+     * @param identity
+     * @return key
+     */
+    static std::string createKey(const std::vector<std::string>& identity);
+
+    /**
+     * @brief Puts cached file at local path
+     *
+     * @param key
+     * @param localPath
+     *
+     * @return true if file was found in cache
+     */
+    bool restore(const std::string& key, const std::string& localPath) const;
+
+    /**
+     * @brief Adds downloaded file to cache, existing entry with the same key is replaced
+     *
+     * @param key
+     * @param localPath
+     */
+    void store(const std::string& key, const std::string& localPath) const;
+};
+
+/**
+ * @brief Tracks files with the same content within one download, e.g. weights shared by model versions,
+ * so that each content is transferred once and linked at other paths, also without download cache
+ */
+class DownloadDeduplicator {
+    std::unordered_map<std::string, std::string> downloadedPaths;
+    std::vector<std::pair<std::string, std::string>> duplicates;
+
+public:
+    /**
+     * @brief Registers file to download
+     *
+     * @param key identifying file content, as for DownloadCache
+     * @param localPath
+     *
+     * @return true if file with the same content is already downloaded to other path, file should be skipped then
+     */
+    bool isDuplicate(const std::string& key, const std::string& localPath);
+
+    /**
+     * @brief Puts downloaded files at paths of their duplicates, to be called once all files are downloaded
+     *
+     * @return true if all duplicates were linked or copied
+     */
+    bool linkDuplicates() const;
+};
+
+}  // namespace ovms
@@ -26,6 +26,11 @@
 #include "tensorflow/core/framework/tensor.h"
 #pragma GCC diagnostic pop
 
+#include "imagedecoder.hpp"
+#include "precisionconversion.hpp"
+#include "sharedmemory.hpp"
+#include "tensorcache.hpp"
+
 namespace ovms {
 
 Status EntryNode::fetchResults(BlobMap& outputs) {
@@ -36,6 +41,9 @@ Status EntryNode::fetchResults(BlobMap& outputs) {
             if (outputs.count(output_name) == 1) {
                 continue;
             }
+            if (!node.get().isInputRequired(pair.second)) {
+                continue;
+            }
 
             if (request->inputs().count(output_name) == 0) {
                 std::stringstream ss;
@@ -62,6 +70,40 @@ Status EntryNode::fetchResults(BlobMap& outputs) {
 }
 
 Status EntryNode::deserialize(const tensorflow::TensorProto& proto, InferenceEngine::Blob::Ptr& blob) {
+    if (proto.dtype() == tensorflow::DataType::DT_STRING) {
+        // Encoded images are decoded into U8 NHWC blob, resizing is left for subsequent nodes
+        auto status = decodeImages(proto, blob);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("[Node: {}] {}", getName(), status.string());
+        }
+        return status;
+    }
+
+    const bool sharedMemoryTensor = isSharedMemoryTensor(proto);
+    if (sharedMemoryTensor || isCachedTensorReference(proto)) {
+        // Data stays in shared memory region of the client or in tensor cache, blob only points to it
+        const auto& conversion = getDataTypeConversion(proto.dtype());
+        if (!conversion.nativeContent) {
+            const std::string details = "Actual: " + TensorInfo::getDataTypeAsString(proto.dtype());
+            SPDLOG_DEBUG("[Node: {}] Unsupported deserialization precision - {}", getName(), details);
+            return Status(StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION, details);
+        }
+        InferenceEngine::SizeVector shape;
+        for (int i = 0; i < proto.tensor_shape().dim_size(); i++) {
+            if (proto.tensor_shape().dim(i).size() < 0) {
+                SPDLOG_DEBUG("[Node: {}] Negative dimension of referred tensor", getName());
+                return StatusCode::INVALID_SHAPE;
+            }
+            shape.emplace_back(proto.tensor_shape().dim(i).size());
+        }
+        const InferenceEngine::TensorDesc desc(conversion.precision, shape, InferenceEngine::TensorDesc::getLayoutByDims(shape));
+        auto status = sharedMemoryTensor ? createSharedMemoryBlob(proto, desc, blob) : createCachedTensorBlob(proto, desc, blob);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("[Node: {}] {}", getName(), status.string());
+        }
+        return status;
+    }
+
     InferenceEngine::TensorDesc description;
     if (proto.tensor_content().size() == 0) {
         const std::string details = "Tensor content size can't be 0";
@@ -91,38 +133,17 @@ Status EntryNode::deserialize(const tensorflow::TensorProto& proto, InferenceEng
     // description.setLayout();  // Layout info is stored in model instance. If we find out it is required, then need to be set right before inference.
 
     try {
-        switch (proto.dtype()) {
-        case tensorflow::DataType::DT_FLOAT:
-            description.setPrecision(InferenceEngine::Precision::FP32);
-            blob = InferenceEngine::make_shared_blob<float>(description, (float*)proto.tensor_content().data());
-            break;
-        case tensorflow::DataType::DT_UINT8:
-            description.setPrecision(InferenceEngine::Precision::U8);
-            blob = InferenceEngine::make_shared_blob<uint8_t>(description, (uint8_t*)proto.tensor_content().data());
-            break;
-        case tensorflow::DataType::DT_INT8:
-            description.setPrecision(InferenceEngine::Precision::I8);
-            blob = InferenceEngine::make_shared_blob<int8_t>(description, (int8_t*)proto.tensor_content().data());
-            break;
-        case tensorflow::DataType::DT_INT16:
-            description.setPrecision(InferenceEngine::Precision::I16);
-            blob = InferenceEngine::make_shared_blob<int16_t>(description, (int16_t*)proto.tensor_content().data());
-            break;
-        case tensorflow::DataType::DT_INT32:
-            description.setPrecision(InferenceEngine::Precision::I32);
-            blob = InferenceEngine::make_shared_blob<int32_t>(description, (int32_t*)proto.tensor_content().data());
-            break;
-        case tensorflow::DataType::DT_HALF:
-        case tensorflow::DataType::DT_UINT16:
-        case tensorflow::DataType::DT_INT64:
-        default: {
+        // FP16 and U16 values are zero padded in typed fields of regular requests, only content of other precisions is wrapped
+        const auto& conversion = getDataTypeConversion(proto.dtype());
+        if (conversion.requestField != TensorProtoField::TENSOR_CONTENT) {
             std::stringstream ss;
             ss << "Actual: " << TensorInfo::getDataTypeAsString(proto.dtype());
             const std::string details = ss.str();
             SPDLOG_DEBUG("[Node: {}] Unsupported deserialization precision - {}", getName(), details);
             return Status(StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION, details);
         }
-        }
+        description.setPrecision(conversion.precision);
+        blob = conversion.wrapContent(proto, description);
     } catch (const InferenceEngine::details::InferenceEngineException& e) {
         Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
         SPDLOG_DEBUG("[Node: {}] Exception thrown during deserialization from make_shared_blob; {}; exception message: {}",
@@ -36,13 +36,17 @@ public:
         Node(ENTRY_NODE_NAME),
         request(request) {}
 
-    Status execute(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue) override {
+    Status execute(NodeNotificationQueue& notifyEndQueue) override {
         notifyEndQueue.push(*this);
         return StatusCode::OK;
     }
 
     Status fetchResults(BlobMap& outputs) override;
 
+    void setRequest(const tensorflow::serving::PredictRequest* request) {
+        this->request = request;
+    }
+
     // Entry nodes have no dependency
     void addDependency(Node&, const InputPairs&) override {
         throw std::logic_error("This node cannot have dependency");
@@ -0,0 +1,70 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../../custom_node_interface.h"
+
+// Adds value of "add_value" parameter to each element of FP32 inputs, outputs have the same names as inputs
+
+static float getAddValue(const struct CustomNodeParam* params, int paramsCount) {
+    for (int i = 0; i < paramsCount; i++) {
+        if (std::strcmp(params[i].key, "add_value") == 0) {
+            return std::stof(params[i].value);
+        }
+    }
+    return 0;
+}
+
+int execute(const struct CustomNodeTensor* inputs, int inputsCount, struct CustomNodeTensor** outputs, int* outputsCount,
+    const struct CustomNodeParam* params, int paramsCount) {
+    float addValue = 0;
+    try {
+        addValue = getAddValue(params, paramsCount);
+    } catch (...) {
+        return 1;
+    }
+    for (int i = 0; i < inputsCount; i++) {
+        if (inputs[i].precision != CUSTOM_NODE_FP32) {
+            return 2;
+        }
+    }
+    *outputsCount = inputsCount;
+    *outputs = static_cast<struct CustomNodeTensor*>(std::malloc(inputsCount * sizeof(struct CustomNodeTensor)));
+    for (int i = 0; i < inputsCount; i++) {
+        const auto& input = inputs[i];
+        auto& output = (*outputs)[i];
+        output.name = strdup(input.name);
+        output.dataBytes = input.dataBytes;
+        output.data = static_cast<uint8_t*>(std::malloc(input.dataBytes));
+        output.dimsCount = input.dimsCount;
+        output.dims = static_cast<uint64_t*>(std::malloc(input.dimsCount * sizeof(uint64_t)));
+        std::memcpy(output.dims, input.dims, input.dimsCount * sizeof(uint64_t));
+        output.precision = input.precision;
+        const float* values = reinterpret_cast<const float*>(input.data);
+        float* results = reinterpret_cast<float*>(output.data);
+        for (uint64_t j = 0; j < input.dataBytes / sizeof(float); j++) {
+            results[j] = values[j] + addValue;
+        }
+    }
+    return 0;
+}
+
+int release(void* ptr) {
+    std::free(ptr);
+    return 0;
+}
@@ -15,20 +15,53 @@
 //*****************************************************************************
 #pragma once
 
+#include <optional>
+
 #include "ovinferrequestsqueue.hpp"
+#include "status.hpp"
 
 namespace ovms {
 struct ExecutingStreamIdGuard {
     ExecutingStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue) :
         inferRequestsQueue_(inferRequestsQueue),
-        id_(inferRequestsQueue_.getIdleStream().get()) {}
+        id_(inferRequestsQueue_.waitForIdleStream()) {}
+
+    /**
+     * @brief Waits for stream according to admission policy, getStatus() tells if request was rejected instead
+     */
+    ExecutingStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue, const StreamWaitingOptions& options) :
+        inferRequestsQueue_(inferRequestsQueue),
+        id_(inferRequestsQueue_.tryGetIdleStream(options.priority)) {
+        if (id_) {
+            return;
+        }
+        BlockingIdleStreamWaiter waiter;
+        waiter.setOptions(options);
+        if (!inferRequestsQueue_.waitForIdleStream(waiter)) {
+            status_ = StatusCode::INFER_REQUESTS_QUEUE_FULL;
+            return;
+        }
+        id_ = waiter.waitUntil(options.deadline);
+        if (!id_ && !inferRequestsQueue_.cancelWaiting(waiter)) {
+            // stream was assigned or deadline reported just before cancelling
+            id_ = waiter.waitUntil(std::chrono::steady_clock::time_point::max());
+        }
+        if (!id_) {
+            status_ = options.isCancelled() ? StatusCode::REQUEST_CANCELLED : StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT;
+        }
+    }
+
     ~ExecutingStreamIdGuard() {
-        inferRequestsQueue_.returnStream(id_);
+        if (id_) {
+            inferRequestsQueue_.returnStream(id_.value());
+        }
     }
-    int getId() { return id_; }
+    int getId() { return id_.value(); }
+    const Status& getStatus() const { return status_; }
 
 private:
     ovms::OVInferRequestsQueue& inferRequestsQueue_;
-    const int id_;
+    std::optional<int> id_;
+    Status status_ = StatusCode::OK;
 };
 }  //  namespace ovms
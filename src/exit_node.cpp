@@ -17,6 +17,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
@@ -25,59 +26,64 @@
 #include "tensorflow/core/framework/tensor.h"
 #pragma GCC diagnostic pop
 
+#include "precisionconversion.hpp"
+#include "serialization.hpp"
+
 namespace ovms {
 
 Status ExitNode::fetchResults(BlobMap&) {
-    // Serialize results to proto
+    if (this->request != nullptr) {
+        for (const auto& name : this->request->output_filter()) {
+            // outputs of nodes skipped by closed gate are left out of response
+            if (this->inputBlobs.count(name) == 0 && this->skippedInputs.count(name) == 0) {
+                const std::string details = "Requested output: " + name;
+                SPDLOG_DEBUG("[Node: {}] Output filter refers to missing pipeline output - {}", getName(), details);
+                return Status(StatusCode::INVALID_MISSING_OUTPUT, details);
+            }
+        }
+    }
+    // Serialize results to proto, response map entries are inserted before outputs are serialized concurrently
+    std::vector<std::pair<const std::string*, const InferenceEngine::Blob::Ptr*>> outputs;
+    std::vector<tensorflow::TensorProto*> protos;
+    std::vector<size_t> byteSizes;
+    outputs.reserve(this->inputBlobs.size());
+    protos.reserve(this->inputBlobs.size());
+    byteSizes.reserve(this->inputBlobs.size());
     for (const auto& kv : this->inputBlobs) {
-        const auto& output_name = kv.first;
-        auto& blob = kv.second;
+        outputs.emplace_back(&kv.first, &kv.second);
+        protos.push_back(&(*this->response->mutable_outputs())[kv.first]);
+        byteSizes.push_back(kv.second->byteSize());
+    }
+    auto status = serializeOutputsInParallel(byteSizes, [this, &outputs, &protos](size_t index) {
+        const auto& output_name = *outputs[index].first;
         SPDLOG_DEBUG("[Node: {}] Serializing response from pipeline. Output name:{}", getName(), output_name);
-        auto& proto = (*this->response->mutable_outputs())[output_name];
-        auto status = serialize(blob, proto);
-        if (!status.ok()) {
-            return status;
+        auto status = serialize(*outputs[index].second, *protos[index]);
+        if (status.ok()) {
+            SPDLOG_DEBUG("[Node: {}] Serialized blob to proto: blob name {}", getName(), output_name);
         }
-
-        SPDLOG_DEBUG("[Node: {}] Serialized blob to proto: blob name {}", getName(), output_name);
+        return status;
+    });
+    if (!status.ok()) {
+        return status;
     }
-
+    // Blobs can be owned by inference requests of previous nodes, release them once serialized
+    this->inputBlobs.clear();
     return StatusCode::OK;
 }
 
+bool ExitNode::isInputRequired(const std::string& inputName) const {
+    return this->request == nullptr || isOutputRequested(*this->request, inputName);
+}
+
 Status ExitNode::serialize(const InferenceEngine::Blob::Ptr& blob, tensorflow::TensorProto& proto) {
     // Set size
     for (size_t dim : blob->getTensorDesc().getDims()) {
         proto.mutable_tensor_shape()->add_dim()->set_size(dim);
     }
 
-    // Set precision
-    switch (blob->getTensorDesc().getPrecision()) {
-    case InferenceEngine::Precision::FP32:
-        proto.set_dtype(tensorflow::DataTypeToEnum<float>::value);
-        break;
-    case InferenceEngine::Precision::I32:
-        proto.set_dtype(tensorflow::DataTypeToEnum<int32_t>::value);
-        break;
-    case InferenceEngine::Precision::I16:
-        proto.set_dtype(tensorflow::DataTypeToEnum<int16_t>::value);
-        break;
-    case InferenceEngine::Precision::U8:
-        proto.set_dtype(tensorflow::DataTypeToEnum<uint8_t>::value);
-        break;
-    case InferenceEngine::Precision::I8:
-        proto.set_dtype(tensorflow::DataTypeToEnum<int8_t>::value);
-        break;
-    case InferenceEngine::Precision::U16:
-        proto.set_dtype(tensorflow::DataTypeToEnum<uint32_t>::value);  // 2 byte padding [v1, v0, 0, 0, u1, u0, 0, 0, ...]
-        break;
-    case InferenceEngine::Precision::FP16:
-        proto.set_dtype(tensorflow::DataTypeToEnum<float>::value);  // 2 byte padding [v1, v0, 0, 0, u1, u0, 0, 0, ...]
-        break;
-    case InferenceEngine::Precision::I64:
-        proto.set_dtype(tensorflow::DataTypeToEnum<int32_t>::value);  // Manually tested that OV I64 = TF int32_t
-        break;
-    default:
+    // Set precision, tensor_content holds values in their native width, no padding or conversion is needed
+    const auto& conversion = getPrecisionConversion(blob->getTensorDesc().getPrecision());
+    if (!conversion.nativeContent) {
         std::stringstream ss;
         ss << "Actual: " << TensorInfo::getPrecisionAsString(blob->getTensorDesc().getPrecision());
         const std::string details = ss.str();
@@ -85,8 +91,17 @@ Status ExitNode::serialize(const InferenceEngine::Blob::Ptr& blob, tensorflow::T
         Status status = Status(StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION, details);
         return status;
     }
+    proto.set_dtype(conversion.dtype);
 
     // Set content
+    if (this->fp16Outputs && blob->getTensorDesc().getPrecision() == InferenceEngine::Precision::FP32) {
+        const size_t count = blob->byteSize() / sizeof(float);
+        std::string content(count * sizeof(uint16_t), '\0');
+        convertFloatToHalf(blob->cbuffer().as<const float*>(), count, reinterpret_cast<uint16_t*>(&content[0]));
+        proto.set_dtype(tensorflow::DataType::DT_HALF);
+        proto.mutable_tensor_content()->swap(content);
+        return StatusCode::OK;
+    }
     proto.mutable_tensor_content()->assign((char*)blob->buffer(), blob->byteSize());
 
     return StatusCode::OK;
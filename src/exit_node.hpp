@@ -31,6 +31,8 @@ const std::string EXIT_NODE_NAME = "response";
 
 class ExitNode : public Node {
     tensorflow::serving::PredictResponse* response;
+    const tensorflow::serving::PredictRequest* request = nullptr;
+    bool fp16Outputs = false;
 
 public:
     ExitNode(tensorflow::serving::PredictResponse* response) :
@@ -40,13 +42,40 @@ public:
 
     // Exit node does not have execute logic.
     // It serializes its received input blobs to proto in ::fetchResults
-    Status execute(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue) override {
+    Status execute(NodeNotificationQueue& notifyEndQueue) override {
         notifyEndQueue.push(*this);
         return StatusCode::OK;
     }
 
     Status fetchResults(BlobMap& outputs) override;
 
+    void setResponse(tensorflow::serving::PredictResponse* response) {
+        this->response = response;
+    }
+
+    /**
+     * @brief Sets request whose output_filter selects pipeline outputs to serialize
+     */
+    void setRequest(const tensorflow::serving::PredictRequest* request) {
+        this->request = request;
+    }
+
+    /**
+     * @brief Sets if FP32 pipeline outputs are serialized as FP16
+     */
+    void setFp16Outputs(bool fp16Outputs) {
+        this->fp16Outputs = fp16Outputs;
+    }
+
+    bool isInputRequired(const std::string& inputName) const override;
+
+    /**
+     * @brief Tells whether request selects some of pipeline outputs only
+     */
+    bool hasOutputFilter() const {
+        return this->request != nullptr && this->request->output_filter_size() > 0;
+    }
+
     // Exit nodes have no dependants
     void addDependant(Node& node) override {
         throw std::logic_error("This node cannot have dependant");
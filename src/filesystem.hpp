@@ -16,14 +16,21 @@
 #pragma once
 
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <set>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 #include <spdlog/spdlog.h>
 
+#include "downloadcache.hpp"
+#include "fnvhash.hpp"
 #include "model_version_policy.hpp"
 #include "status.hpp"
+#include "stringutils.hpp"
 
 namespace ovms {
 
@@ -119,6 +126,40 @@ public:
      */
 
     virtual StatusCode deleteFileFolder(const std::string& path) = 0;
+
+    /**
+     * @brief Get a token which changes whenever content of given directory changes
+     *
+     * Used to skip listing of model versions when nothing changed since last check. Default implementation covers names of
+     * directory entries, filesystems override it with cheaper or more precise checks.
+     *
+     * @param path
+     * @param token
+     * @return StatusCode
+     */
+    virtual StatusCode getDirectoryChangeToken(const std::string& path, std::string* token) {
+        files_list_t contents;
+        auto status = getDirectoryContents(path, &contents);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+        uint64_t hash = FNV_OFFSET_BASIS;
+        for (const auto& entry : contents) {
+            hashString(hash, entry);
+        }
+        *token = std::to_string(hash);
+        return StatusCode::OK;
+    }
+
+    /**
+     * @brief Sets persistent cache used by remote filesystems to skip downloads of files fetched before
+     *
+     * @param downloadCache
+     */
+    void setDownloadCache(std::shared_ptr<DownloadCache> downloadCache) {
+        this->downloadCache = std::move(downloadCache);
+    }
+
     /**
      * @brief Create a Temp Path
      * 
@@ -141,6 +182,46 @@ public:
         return StatusCode::OK;
     }
 
+    /**
+     * @brief Creates local file of given size, so that its parts can be downloaded concurrently and written at their offsets
+     * 
+     * @param path 
+     * @param size 
+     * @return StatusCode 
+     */
+    static StatusCode createLocalFile(const std::string& path, uint64_t size) {
+        std::ofstream file(path, std::ios::binary);
+        file.close();
+        std::error_code ec;
+        if (file) {
+            fs::resize_file(path, size, ec);
+        }
+        if (!file || ec) {
+            SPDLOG_ERROR("Failed to create local file: {} {}", path, ec ? ec.message() : strerror(errno));
+            return StatusCode::PATH_INVALID;
+        }
+        return StatusCode::OK;
+    }
+
+    /**
+     * @brief Reads download setting from environment variable, returns default value if it is not set or is not a positive number
+     * 
+     * @param name 
+     * @param defaultValue 
+     * @return uint32_t 
+     */
+    static uint32_t getPositiveEnvValue(const char* name, uint32_t defaultValue) {
+        const char* environmentVariableBuffer = std::getenv(name);
+        if (environmentVariableBuffer) {
+            auto result = stou32(environmentVariableBuffer);
+            if (result && result.value() > 0) {
+                return result.value();
+            }
+            SPDLOG_WARN("Invalid value of {}: {}, using default: {}", name, environmentVariableBuffer, defaultValue);
+        }
+        return defaultValue;
+    }
+
     static bool isPathEscaped(const std::string& path) {
         return std::string::npos != path.find("../") || std::string::npos != path.find("/..");
     }
@@ -191,6 +272,12 @@ public:
     }
 
     static const std::vector<std::string> acceptedFiles;
+
+protected:
+    /**
+     * @brief Cache of downloaded files, nullptr if disabled
+     */
+    std::shared_ptr<DownloadCache> downloadCache;
 };
 
 }  // namespace ovms
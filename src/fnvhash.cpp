@@ -0,0 +1,47 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "fnvhash.hpp"
+
+#include <fstream>
+#include <vector>
+
+namespace ovms {
+
+void hashBytes(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+}
+
+void hashString(uint64_t& hash, const std::string& str) {
+    hashBytes(hash, str.c_str(), str.size() + 1);
+}
+
+bool hashFile(uint64_t& hash, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.good()) {
+        return false;
+    }
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        hashBytes(hash, buffer.data(), file.gcount());
+    }
+    return true;
+}
+
+}  // namespace ovms
@@ -0,0 +1,43 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief 64-bit FNV-1a hash, stable across builds and platforms so it can identify files persisted on disk
+ */
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void hashBytes(uint64_t& hash, const char* data, size_t size);
+
+/**
+ * @brief Hashes string including its terminating zero, so that consecutive fields stay separated
+ */
+void hashString(uint64_t& hash, const std::string& str);
+
+/**
+ * @brief Hashes content of the file
+ *
+ * @return false if file could not be read
+ */
+bool hashFile(uint64_t& hash, const std::string& path);
+
+}  // namespace ovms
@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "fused_dl_node.hpp"
+
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include <inference_engine.hpp>
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+Status FusedDLNode::validate(const std::string& name, const InferenceEngine::Blob::Ptr& blob) const {
+    auto it = this->network->getInputsInfo().find(name);
+    if (it == this->network->getInputsInfo().end()) {
+        SPDLOG_DEBUG("[Node: {}] Missing input with specific name - Required input: {}", getName(), name);
+        return Status(StatusCode::INVALID_MISSING_INPUT, "Required input: " + name);
+    }
+    const auto& info = *it->second;
+    const auto& desc = blob->getTensorDesc();
+    if (info.getPrecision() != desc.getPrecision()) {
+        std::stringstream ss;
+        ss << "Expected: " << info.getPrecisionAsString()
+           << "; Actual: " << TensorInfo::getPrecisionAsString(desc.getPrecision());
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Node: {}] Invalid precision - {}", getName(), details);
+        return Status(StatusCode::INVALID_PRECISION, details);
+    }
+    if (info.getShape() != desc.getDims()) {
+        std::stringstream ss;
+        ss << "Expected: " << TensorInfo::shapeToString(info.getShape())
+           << "; Actual: " << TensorInfo::shapeToString(desc.getDims());
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Node: {}] Invalid shape - {}", getName(), details);
+        return Status(info.getShape()[0] != desc.getDims()[0] ? StatusCode::INVALID_BATCH_SIZE : StatusCode::INVALID_SHAPE, details);
+    }
+    return StatusCode::OK;
+}
+
+Status FusedDLNode::execute(NodeNotificationQueue& notifyEndQueue) {
+    Status status;
+    if (this->nodeStreamIdGuard == nullptr) {
+        for (const auto& [name, blob] : this->inputBlobs) {
+            status = validate(name, blob);
+            if (!status.ok()) {
+                notifyEndQueue.push(*this);
+                return status;
+            }
+        }
+        this->nodeStreamIdGuard = std::make_unique<NodeStreamIdGuard>(this->network->getInferRequestsQueue(), [this, &notifyEndQueue]() {
+            SPDLOG_DEBUG("[Node: {}] Stream Id assigned to deferred node", getName());
+            notifyEndQueue.push(*this);
+        });
+    }
+    return executeOnStream(notifyEndQueue);
+}
+
+Status FusedDLNode::fetchResults(BlobMap& outputs) {
+    if (this->nodeStreamIdGuard == nullptr) {
+        SPDLOG_DEBUG("[Node: {}] Fetching results failed due to earlier execution failure", getName());
+        return StatusCode::UNKNOWN_ERROR;
+    }
+    InferenceEngine::InferRequest* inferRequest = nullptr;
+    auto status = waitForInference(inferRequest);
+    if (!status.ok()) {
+        return status;
+    }
+
+    std::shared_ptr<InferRequestOutputsOwner> outputsOwner;
+    if (this->zeroCopyOutputs) {
+        outputsOwner = std::make_shared<InferRequestOutputsOwner>();
+    }
+    for (const auto& node : this->next) {
+        for (const auto& pair : node.get().getMappingByDependency(*this)) {
+            const auto& outputName = pair.first;
+            if (outputs.count(outputName) == 1 || !node.get().isInputRequired(pair.second)) {
+                continue;
+            }
+            std::string fusedOutputName;
+            if (!this->network->getOutputName(getModelOutputName(outputName), fusedOutputName)) {
+                SPDLOG_WARN("[Node: {}] Cannot find fused network output name for alias {}", getName(), outputName);
+                return StatusCode::INTERNAL_ERROR;
+            }
+            InferenceEngine::Blob::Ptr blob;
+            status = fetchOutput(*inferRequest, fusedOutputName, outputsOwner, blob);
+            if (!status.ok()) {
+                return status;
+            }
+            outputs.emplace(outputName, std::move(blob));
+        }
+    }
+    if (outputsOwner) {
+        // Inference request is released once following nodes do not need its outputs anymore
+        outputsOwner->inferenceResources = this->network;
+        outputsOwner->nodeStreamIdGuard = std::move(this->nodeStreamIdGuard);
+    }
+    this->release();
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
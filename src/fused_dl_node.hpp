@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "fusednetwork.hpp"
+#include "infer_request_node.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Runs linear chain of DL nodes as single inference of fused network. Node has name of the last node of the chain,
+ * inputs of the first node and outputs of the last one, so that pipeline is connected the same way as without fusion.
+ */
+class FusedDLNode : public InferRequestNode {
+    std::shared_ptr<FusedNetwork> network;
+
+public:
+    FusedDLNode(const std::string& nodeName, std::shared_ptr<FusedNetwork> network,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {},
+        bool zeroCopyOutputs = false) :
+        InferRequestNode(nodeName, std::move(nodeOutputNameAlias), zeroCopyOutputs),
+        network(std::move(network)) {
+    }
+
+    Status execute(NodeNotificationQueue& notifyEndQueue) override;
+
+    Status fetchResults(BlobMap& outputs) override;
+
+protected:
+    OVInferRequestsQueue* getInferRequestsQueue() override { return &this->network->getInferRequestsQueue(); }
+
+    Status getRealInputName(const std::string& alias, std::string* result) const override {
+        if (!this->network->getInputName(alias, *result)) {
+            return StatusCode::INVALID_MISSING_INPUT;
+        }
+        return StatusCode::OK;
+    }
+
+    /**
+     * @brief Outputs of fused network are outputs of the last model, so they are counted in its in flight memory budget
+     */
+    const std::string& getInferredModelName() const override { return this->network->getOutputModelName(); }
+
+    size_t getInFlightMemoryBudgetBytes() const override { return this->network->getInFlightMemoryBudgetBytes(); }
+
+    uint32_t getCompletionSpinMicroseconds() const override { return this->network->getCompletionSpinMicroseconds(); }
+
+private:
+    /**
+     * @brief Validates input blob against input of the first model, fused network is not reshaped for requests
+     */
+    Status validate(const std::string& name, const InferenceEngine::Blob::Ptr& blob) const;
+};
+
+}  // namespace ovms
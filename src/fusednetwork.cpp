@@ -0,0 +1,201 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "fusednetwork.hpp"
+
+#include <utility>
+
+#include <ngraph/function.hpp>
+#include <ngraph/graph_util.hpp>
+#include <ngraph/opsets/opset1.hpp>
+#include <spdlog/spdlog.h>
+
+#include "modelinstance.hpp"
+#include "ovengine.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Name of CNNNetwork output created for result of given node output
+ */
+std::string getResultName(const ngraph::Output<ngraph::Node>& output) {
+    const auto& node = output.get_node_shared_ptr();
+    if (node->get_output_size() == 1) {
+        return node->get_friendly_name();
+    }
+    return node->get_friendly_name() + "." + std::to_string(output.get_index());
+}
+
+Status notFused(const std::string& name, const std::string& details) {
+    SPDLOG_DEBUG("Models of fused network: {} cannot be fused - {}", name, details);
+    return Status(StatusCode::PIPELINE_NODES_NOT_FUSED, details);
+}
+
+bool isMatching(const TensorInfo& output, const TensorInfo& input) {
+    return output.getPrecision() == input.getPrecision() &&
+           output.getShape() == input.getShape() &&
+           output.getLayout() == input.getLayout();
+}
+}  // namespace
+
+Status FusedNetwork::create(const std::string& name, const std::vector<FusedNetworkStage>& stages, std::shared_ptr<FusedNetwork>& fused) {
+    if (stages.size() < 2) {
+        return notFused(name, "at least two models are required");
+    }
+    std::shared_ptr<FusedNetwork> network(new FusedNetwork(name));
+    auto& firstModel = *stages.front().model;
+    auto& lastModel = *stages.back().model;
+    try {
+        ngraph::ParameterVector parameters;
+        ngraph::ResultVector results;
+        // Outputs of previous model keyed by its network output names
+        std::unordered_map<std::string, ngraph::Output<ngraph::Node>> previousOutputs;
+        for (size_t i = 0; i < stages.size(); i++) {
+            const auto& stage = stages[i];
+            auto function = stage.model->getNetworkFunction();
+            if (function == nullptr) {
+                return notFused(name, "network of model " + stage.model->getName() + " is not kept in memory");
+            }
+            // each model is cloned, so that the same model may be used by several stages and original network stays intact
+            auto clone = ngraph::clone_function(*function);
+            std::unordered_map<std::string, std::shared_ptr<ngraph::opset1::Parameter>> stageParameters;
+            for (const auto& parameter : clone->get_parameters()) {
+                stageParameters.emplace(parameter->get_friendly_name(), parameter);
+            }
+            std::unordered_map<std::string, ngraph::Output<ngraph::Node>> stageOutputs;
+            for (const auto& result : clone->get_results()) {
+                const auto source = result->input_value(0);
+                stageOutputs.emplace(getResultName(source), source);
+            }
+            // operations of different models may have the same names
+            for (const auto& op : clone->get_ops()) {
+                op->set_friendly_name(stage.nodeName + "/" + op->get_friendly_name());
+            }
+            if (i == 0) {
+                parameters = clone->get_parameters();
+                for (const auto& [mappedName, info] : firstModel.getInputsInfo()) {
+                    auto it = stageParameters.find(info->getName());
+                    if (it == stageParameters.end()) {
+                        return notFused(name, "missing input " + info->getName() + " in network of model " + firstModel.getName());
+                    }
+                    network->inputNames.emplace(mappedName, it->second->get_friendly_name());
+                }
+            } else {
+                const auto& previous = stages[i - 1];
+                size_t connectedInputs = 0;
+                for (const auto& [outputAlias, inputName] : stage.inputs) {
+                    const auto aliasIt = previous.outputNameAliases.find(outputAlias);
+                    const auto& outputName = aliasIt != previous.outputNameAliases.end() ? aliasIt->second : outputAlias;
+                    auto outputInfo = previous.model->getOutputsInfo().find(outputName);
+                    auto inputInfo = stage.model->getInputsInfo().find(inputName);
+                    if (outputInfo == previous.model->getOutputsInfo().end() || inputInfo == stage.model->getInputsInfo().end()) {
+                        return notFused(name, "missing output " + outputName + " of node " + previous.nodeName + " or input " + inputName + " of node " + stage.nodeName);
+                    }
+                    if (!isMatching(*outputInfo->second, *inputInfo->second)) {
+                        return notFused(name, "output " + outputName + " of node " + previous.nodeName + " differs from input " + inputName + " of node " + stage.nodeName);
+                    }
+                    auto source = previousOutputs.find(outputInfo->second->getName());
+                    auto parameter = stageParameters.find(inputInfo->second->getName());
+                    if (source == previousOutputs.end() || parameter == stageParameters.end()) {
+                        return notFused(name, "missing tensors of connection " + outputName + " - " + inputName + " in networks");
+                    }
+                    if (source->second.get_element_type() != parameter->second->get_element_type() ||
+                        !source->second.get_partial_shape().same_scheme(parameter->second->get_partial_shape())) {
+                        return notFused(name, "network output " + outputName + " of node " + previous.nodeName + " differs from network input " + inputName + " of node " + stage.nodeName);
+                    }
+                    for (auto& target : parameter->second->output(0).get_target_inputs()) {
+                        target.replace_source_output(source->second);
+                    }
+                    connectedInputs++;
+                }
+                if (connectedInputs != stageParameters.size()) {
+                    return notFused(name, "not all inputs of node " + stage.nodeName + " are connected to outputs of node " + previous.nodeName);
+                }
+            }
+            previousOutputs = std::move(stageOutputs);
+            if (i == stages.size() - 1) {
+                results = clone->get_results();
+                for (const auto& [mappedName, info] : lastModel.getOutputsInfo()) {
+                    auto it = previousOutputs.find(info->getName());
+                    if (it == previousOutputs.end()) {
+                        return notFused(name, "missing output " + info->getName() + " in network of model " + lastModel.getName());
+                    }
+                    network->outputNames.emplace(mappedName, getResultName(it->second));
+                }
+            }
+        }
+
+        InferenceEngine::CNNNetwork cnnNetwork(std::make_shared<ngraph::Function>(results, parameters, name));
+        const auto cnnInputs = cnnNetwork.getInputsInfo();
+        for (const auto& [mappedName, fusedName] : network->inputNames) {
+            auto it = cnnInputs.find(fusedName);
+            if (it == cnnInputs.end()) {
+                return notFused(name, "missing input " + fusedName + " in fused network");
+            }
+            const auto& info = firstModel.getInputsInfo().at(mappedName);
+            it->second->setPrecision(info->getPrecision());
+            it->second->setLayout(info->getLayout());
+        }
+        const auto cnnOutputs = cnnNetwork.getOutputsInfo();
+        for (const auto& [mappedName, fusedName] : network->outputNames) {
+            auto it = cnnOutputs.find(fusedName);
+            if (it == cnnOutputs.end()) {
+                return notFused(name, "missing output " + fusedName + " in fused network");
+            }
+            const auto& info = lastModel.getOutputsInfo().at(mappedName);
+            it->second->setPrecision(info->getPrecision());
+            it->second->setLayout(info->getLayout());
+        }
+
+        const auto& config = firstModel.getModelConfig();
+        network->execNetwork = std::make_unique<InferenceEngine::ExecutableNetwork>(
+            getSharedOVEngine()->LoadNetwork(cnnNetwork, firstModel.getTargetDevice(), ModelInstance::prepareDefaultPluginConfig(config)));
+        network->inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*network->execNetwork,
+            firstModel.getInferRequestsQueue().getMaxSize());
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        return notFused(name, e.what());
+    } catch (const std::exception& e) {
+        return notFused(name, e.what());
+    }
+    network->inputsInfo = firstModel.getInputsInfo();
+    network->outputsInfo = lastModel.getOutputsInfo();
+    network->outputModelName = lastModel.getName();
+    network->inFlightMemoryBudgetBytes = lastModel.getModelConfig().getInFlightMemoryBudgetMb() * 1024 * 1024;
+    network->completionSpinMicroseconds = lastModel.getModelConfig().getCompletionSpinMicroseconds();
+    SPDLOG_INFO("Compiled fused network: {} of {} models on device: {}", name, stages.size(), firstModel.getTargetDevice());
+    fused = std::move(network);
+    return StatusCode::OK;
+}
+
+bool FusedNetwork::getInputName(const std::string& mappedName, std::string& result) const {
+    auto it = inputNames.find(mappedName);
+    if (it == inputNames.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+bool FusedNetwork::getOutputName(const std::string& mappedName, std::string& result) const {
+    auto it = outputNames.find(mappedName);
+    if (it == outputNames.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+}  // namespace ovms
@@ -0,0 +1,112 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#include "node.hpp"
+#include "ovinferrequestsqueue.hpp"
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+class ModelInstance;
+
+/**
+ * @brief DL node of pipeline compiled into fused network
+ */
+struct FusedNetworkStage {
+    std::string nodeName;
+    std::shared_ptr<ModelInstance> model;
+    std::unordered_map<std::string, std::string> outputNameAliases;
+    // Outputs of previous stage connected to inputs of the model, empty for the first stage
+    InputPairs inputs;
+};
+
+/**
+ * @brief Network compiled from models of linear chain of DL nodes, with outputs of each model connected straight
+ * to inputs of the next one, so that the chain runs as single inference with intermediate tensors kept on device
+ */
+class FusedNetwork {
+    const std::string name;
+
+    std::unique_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
+    std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
+
+    // Inputs of the first model and outputs of the last model keyed by their mapped names
+    tensor_map_t inputsInfo;
+    tensor_map_t outputsInfo;
+
+    // Names of fused network inputs and outputs keyed by mapped names of tensors of original models
+    std::unordered_map<std::string, std::string> inputNames;
+    std::unordered_map<std::string, std::string> outputNames;
+
+    // Settings of the last model, which produces outputs of the network
+    std::string outputModelName;
+    size_t inFlightMemoryBudgetBytes = 0;
+    uint32_t completionSpinMicroseconds = 0;
+
+    FusedNetwork(const std::string& name) :
+        name(name) {}
+
+public:
+    /**
+     * @brief Fuses functions of models and compiles them on device of the first model with its plugin config,
+     * using the same number of infer requests as the first model
+     *
+     * @param name
+     * @param stages in execution order
+     * @param fused
+     *
+     * @return PIPELINE_NODES_NOT_FUSED if models cannot be connected directly, e.g. connected tensors differ
+     * in precision, shape or layout, or network of some model was released from memory after compilation
+     */
+    static Status create(const std::string& name, const std::vector<FusedNetworkStage>& stages, std::shared_ptr<FusedNetwork>& fused);
+
+    const std::string& getName() const { return name; }
+
+    OVInferRequestsQueue& getInferRequestsQueue() { return *inferRequestsQueue; }
+
+    const tensor_map_t& getInputsInfo() const { return inputsInfo; }
+    const tensor_map_t& getOutputsInfo() const { return outputsInfo; }
+
+    /**
+     * @brief Gets name of network input connected to input of the first model
+     *
+     * @return false if model has no such input
+     */
+    bool getInputName(const std::string& mappedName, std::string& result) const;
+
+    /**
+     * @brief Gets name of network output connected to output of the last model
+     *
+     * @return false if model has no such output
+     */
+    bool getOutputName(const std::string& mappedName, std::string& result) const;
+
+    const std::string& getOutputModelName() const { return outputModelName; }
+    size_t getInFlightMemoryBudgetBytes() const { return inFlightMemoryBudgetBytes; }
+    uint32_t getCompletionSpinMicroseconds() const { return completionSpinMicroseconds; }
+};
+
+}  // namespace ovms
@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "gate_node.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+namespace {
+template <typename T>
+bool anyPasses(const InferenceEngine::Blob::Ptr& blob, const GateParameters& parameters) {
+    const T* values = blob->cbuffer().as<const T*>();
+    const T* end = values + blob->size();
+    if (parameters.comparison == GATE_LESS) {
+        return std::any_of(values, end, [&parameters](T value) { return value < parameters.threshold; });
+    }
+    return std::any_of(values, end, [&parameters](T value) { return value > parameters.threshold; });
+}
+}  // namespace
+
+Status GateNode::process() {
+    auto conditionItr = this->inputBlobs.find(GATE_CONDITION_INPUT_NAME);
+    if (conditionItr == this->inputBlobs.end()) {
+        SPDLOG_DEBUG("[Node: {}] Missing {} input", getName(), GATE_CONDITION_INPUT_NAME);
+        return StatusCode::INVALID_MISSING_INPUT;
+    }
+    const auto& condition = conditionItr->second;
+    const auto precision = condition->getTensorDesc().getPrecision();
+    if (precision == InferenceEngine::Precision::FP32) {
+        open = anyPasses<float>(condition, parameters);
+    } else if (precision == InferenceEngine::Precision::I32) {
+        open = anyPasses<int32_t>(condition, parameters);
+    } else {
+        SPDLOG_DEBUG("[Node: {}] Input {} has to be FP32 or I32 blob", getName(), GATE_CONDITION_INPUT_NAME);
+        return StatusCode::INVALID_PRECISION;
+    }
+    SPDLOG_DEBUG("[Node: {}] Gate is {}", getName(), open ? "open" : "closed");
+    if (open) {
+        this->outputBlobs = this->inputBlobs;
+    }
+    return StatusCode::OK;
+}
+
+Status GateNode::fetchResults(BlobMap& outputs) {
+    if (!open) {
+        // dependants are skipped, they do not expect any outputs
+        this->release();
+        return StatusCode::OK;
+    }
+    return BuiltInNode::fetchResults(outputs);
+}
+
+}  // namespace ovms
@@ -0,0 +1,66 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "built_in_node.hpp"
+
+namespace ovms {
+
+const std::string GATE_CONDITION_INPUT_NAME = "condition";
+
+const std::string GATE_GREATER = "greater";
+const std::string GATE_LESS = "less";
+
+struct GateParameters {
+    // One of greater and less, comparison of condition values with threshold
+    std::string comparison = GATE_GREATER;
+    float threshold = 0;
+};
+
+/**
+ * @brief Decides whether following nodes are executed, so that expensive models of a cascade run only when needed
+ *
+ * Gate is open if any value of FP32 or I32 condition input compares with threshold as configured,
+ * every input is then passed as output with the same name. All nodes depending on closed gate are skipped,
+ * never reserving inference streams, and pipeline response lacks outputs of skipped nodes.
+ */
+class GateNode : public BuiltInNode {
+    const GateParameters parameters;
+    bool open = true;
+
+public:
+    GateNode(const std::string& nodeName, const GateParameters& parameters,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        BuiltInNode(nodeName, nodeOutputNameAlias),
+        parameters(parameters) {}
+
+    Status fetchResults(BlobMap& outputs) override;
+
+    bool skipsDependants() const override { return !open; }
+
+    void reset() override {
+        open = true;
+        BuiltInNode::reset();
+    }
+
+protected:
+    Status process() override;
+};
+
+}  // namespace ovms
@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "gather_node.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "ov_utils.hpp"
+
+namespace ovms {
+
+Status GatherNode::process() {
+    auto countItr = this->inputBlobs.find(GATHER_COUNT_INPUT_NAME);
+    if (countItr == this->inputBlobs.end()) {
+        SPDLOG_DEBUG("[Node: {}] Missing {} input", getName(), GATHER_COUNT_INPUT_NAME);
+        return StatusCode::INVALID_MISSING_INPUT;
+    }
+    const auto& countBlob = countItr->second;
+    if (countBlob->getTensorDesc().getPrecision() != InferenceEngine::Precision::I32 || countBlob->size() == 0) {
+        SPDLOG_DEBUG("[Node: {}] Input {} has to be non empty I32 blob", getName(), GATHER_COUNT_INPUT_NAME);
+        return StatusCode::INVALID_PRECISION;
+    }
+    const size_t count = static_cast<size_t>(std::max(countBlob->cbuffer().as<const int32_t*>()[0], 0));
+    for (const auto& [name, blob] : this->inputBlobs) {
+        if (name == GATHER_COUNT_INPUT_NAME) {
+            continue;
+        }
+        const auto& desc = blob->getTensorDesc();
+        auto dims = desc.getDims();
+        if (dims.size() == 0) {
+            SPDLOG_DEBUG("[Node: {}] Input {} has no batch dimension", getName(), name);
+            return StatusCode::INVALID_SHAPE;
+        }
+        const size_t rowByteSize = dims[0] > 0 ? blob->byteSize() / dims[0] : 0;
+        dims[0] = std::min(count, dims[0]);
+        auto gathered = createZeroBlob(InferenceEngine::TensorDesc(desc.getPrecision(), dims, desc.getLayout()));
+        std::memcpy(gathered->buffer().as<char*>(), blob->cbuffer().as<const char*>(), dims[0] * rowByteSize);
+        this->outputBlobs.emplace(name, std::move(gathered));
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,42 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "built_in_node.hpp"
+
+namespace ovms {
+
+const std::string GATHER_COUNT_INPUT_NAME = "count";
+
+/**
+ * @brief Drops results of padding rows added by demultiplexer node
+ *
+ * Every input other than count is passed as output with the same name, trimmed to first count rows
+ * of its first dimension. Count is expected as I32 blob, usually crops_count output of demultiplexer.
+ */
+class GatherNode : public BuiltInNode {
+public:
+    GatherNode(const std::string& nodeName, std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        BuiltInNode(nodeName, nodeOutputNameAlias) {}
+
+protected:
+    Status process() override;
+};
+
+}  // namespace ovms
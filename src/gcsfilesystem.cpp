@@ -25,13 +25,20 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "gcsfilesystem.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "logging.hpp"
+#include "paralleltasks.hpp"
 #include "stringutils.hpp"
 
 namespace ovms {
@@ -60,6 +67,9 @@ StatusCode GCSFileSystem::parsePath(const std::string& path,
 
 namespace {
 
+const uint32_t DEFAULT_GCS_DOWNLOAD_THREADS = 8;
+const uint32_t DEFAULT_GCS_DOWNLOAD_PART_SIZE_MB = 64;
+
 google::cloud::storage::ClientOptions createDefaultOrAnonymousClientOptions() {
     if (std::getenv("GOOGLE_APPLICATION_CREDENTIALS") == nullptr) {
         auto credentials =
@@ -82,15 +92,35 @@ google::cloud::storage::ClientOptions createDefaultOrAnonymousClientOptions() {
     }
 }
 
+// Client copies share connection pool, so one client per credentials is reused by file systems created
+// for every model on every watcher tick instead of opening new TLS connections
+google::cloud::storage::Client getPooledClient() {
+    static std::mutex clientsMtx;
+    static std::map<std::string, google::cloud::storage::Client> clients;
+    const char* credentialsFile = std::getenv("GOOGLE_APPLICATION_CREDENTIALS");
+    const std::string key = credentialsFile != nullptr ? credentialsFile : "";
+    std::lock_guard<std::mutex> lock(clientsMtx);
+    auto it = clients.find(key);
+    if (it == clients.end()) {
+        SPDLOG_LOGGER_DEBUG(gcs_logger, "Creating GCS client");
+        it = clients.emplace(key, google::cloud::storage::Client{createDefaultOrAnonymousClientOptions()}).first;
+    }
+    return it->second;
+}
+
 }  // namespace
 
 GCSFileSystem::GCSFileSystem() :
-    client_{createDefaultOrAnonymousClientOptions()} {
+    client_{getPooledClient()},
+    download_threads_(getPositiveEnvValue("GCS_DOWNLOAD_THREADS", DEFAULT_GCS_DOWNLOAD_THREADS)),
+    download_part_size_(uint64_t(getPositiveEnvValue("GCS_DOWNLOAD_PART_SIZE_MB", DEFAULT_GCS_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "GCSFileSystem default ctor");
 }
 
 GCSFileSystem::GCSFileSystem(const gcs::v1::ClientOptions& options) :
-    client_{options, gcs::StrictIdempotencyPolicy()} {
+    client_{options, gcs::StrictIdempotencyPolicy()},
+    download_threads_(getPositiveEnvValue("GCS_DOWNLOAD_THREADS", DEFAULT_GCS_DOWNLOAD_THREADS)),
+    download_part_size_(uint64_t(getPositiveEnvValue("GCS_DOWNLOAD_PART_SIZE_MB", DEFAULT_GCS_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "GCSFileSystem ctor with custom options");
 }
 
@@ -184,6 +214,29 @@ GCSFileSystem::getDirectoryContents(const std::string& path,
     return StatusCode::OK;
 }
 
+StatusCode GCSFileSystem::getDirectoryChangeToken(const std::string& path, std::string* token) {
+    std::string bucket, directory_path;
+    auto status = this->parsePath(path, &bucket, &directory_path);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    // single flat listing, object generation changes on every overwrite
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (auto&& meta : client_.ListObjects(bucket, gcs::Prefix(appendSlash(directory_path)))) {
+        if (!meta) {
+            SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to get directory change token -> object metadata "
+                                            "is empty. Error: {}",
+                meta.status().message());
+            return StatusCode::GCS_INVALID_ACCESS;
+        }
+        hashString(hash, meta->name());
+        hashString(hash, std::to_string(meta->generation()));
+        hashString(hash, std::to_string(meta->size()));
+    }
+    *token = std::to_string(hash);
+    return StatusCode::OK;
+}
+
 StatusCode GCSFileSystem::getDirectorySubdirs(const std::string& path,
     std::set<std::string>* subdirs) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "Listing directory subdirs: {}", path);
@@ -260,29 +313,101 @@ StatusCode GCSFileSystem::readTextFile(const std::string& path,
         SPDLOG_LOGGER_ERROR(gcs_logger, "Downloading file has failed: ", path);
         return StatusCode::GCS_FILE_INVALID;
     }
-    std::string data = "";
-    char c = 0;
-    while (stream.get(c)) {
-        data += c;
-    }
-    *contents = data;
+    // read in bulk through stream buffer, model weights read into memory take hundreds of megabytes
+    std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    *contents = std::move(data);
     SPDLOG_LOGGER_TRACE(gcs_logger, "File {} has been downloaded (bytes={})", path,
-        data.size());
+        contents->size());
     return StatusCode::OK;
 }
 
-StatusCode GCSFileSystem::downloadFile(const std::string& remote_path,
-    const std::string& local_path) {
-    SPDLOG_LOGGER_TRACE(gcs_logger, "Saving file {} to {}", remote_path, local_path);
-    std::string contents;
-    auto read_status = this->readTextFile(remote_path, &contents);
-    if (read_status != StatusCode::OK) {
-        SPDLOG_LOGGER_ERROR(gcs_logger, "Failed to get object at {}", remote_path);
-        return read_status;
-    }
-    std::ofstream output_file(local_path.c_str(), std::ios::binary);
-    output_file << contents;
-    output_file.close();
+StatusCode GCSFileSystem::downloadFiles(const files_to_download_t& files_to_download) {
+    struct ObjectPart {
+        std::string bucket;
+        std::string object;
+        std::string local_file_path;
+        uint64_t offset;
+        uint64_t size;
+        bool ranged;
+    };
+    std::vector<ObjectPart> parts;
+    std::vector<std::pair<std::string, std::string>> files_to_cache;
+    DownloadDeduplicator deduplicator;
+
+    for (const auto& [remote_file_path, local_file_path] : files_to_download) {
+        SPDLOG_LOGGER_TRACE(gcs_logger, "Saving file {} to {}", remote_file_path, local_file_path);
+        std::string bucket, object;
+        auto status = parsePath(remote_file_path, &bucket, &object);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+        auto metadata = client_.GetObjectMetadata(bucket, object);
+        if (!metadata) {
+            SPDLOG_LOGGER_ERROR(gcs_logger, "Failed to get object metadata at {}: {}", remote_file_path, metadata.status().message());
+            return StatusCode::GCS_FAILED_GET_OBJECT;
+        }
+        const uint64_t object_size = metadata->size();
+        // MD5 is missing for composite objects, generation identifies content of single object then
+        auto key = metadata->md5_hash().empty() ?
+            DownloadCache::createKey({"gcs", bucket, object, std::to_string(metadata->generation()), std::to_string(object_size)}) :
+            DownloadCache::createKey({"gcs_md5", metadata->md5_hash(), std::to_string(object_size)});
+        if (downloadCache && downloadCache->restore(key, local_file_path)) {
+            continue;
+        }
+        if (deduplicator.isDuplicate(key, local_file_path)) {
+            continue;
+        }
+        if (downloadCache) {
+            files_to_cache.emplace_back(key, local_file_path);
+        }
+        status = createLocalFile(local_file_path, object_size);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+
+        const bool ranged = object_size > download_part_size_;
+        for (uint64_t offset = 0; offset < object_size; offset += download_part_size_) {
+            parts.push_back({bucket, object, local_file_path, offset, std::min(download_part_size_, object_size - offset), ranged});
+        }
+    }
+
+    SPDLOG_LOGGER_DEBUG(gcs_logger, "Downloading {} files in {} parts using up to {} threads", files_to_download.size(), parts.size(), download_threads_);
+    std::vector<StatusCode> statuses(parts.size(), StatusCode::OK);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < parts.size(); i++) {
+        tasks.emplace_back([this, &part = parts[i], &status = statuses[i]]() {
+            gcs::ObjectReadStream stream = part.ranged ? client_.ReadObject(part.bucket, part.object, gcs::ReadRange(part.offset, part.offset + part.size)) : client_.ReadObject(part.bucket, part.object);
+            if (!stream) {
+                SPDLOG_LOGGER_ERROR(gcs_logger, "Failed to get object at {}/{}: {}", part.bucket, part.object, stream.status().message());
+                status = StatusCode::GCS_FAILED_GET_OBJECT;
+                return;
+            }
+            // Content is streamed straight to its place in the target file
+            std::fstream output_file(part.local_file_path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+            output_file.seekp(part.offset);
+            output_file << stream.rdbuf();
+            const auto written = static_cast<uint64_t>(output_file.tellp()) - part.offset;
+            output_file.close();
+            if (!stream.status().ok() || !output_file || written != part.size) {
+                SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to save file from {}/{} bytes {}-{} to {}", part.bucket, part.object,
+                    part.offset, part.offset + part.size, part.local_file_path);
+                status = StatusCode::GCS_FAILED_GET_OBJECT;
+            }
+        });
+    }
+    executeInParallel(tasks, download_threads_);
+
+    for (const auto& status : statuses) {
+        if (status != StatusCode::OK) {
+            return status;
+        }
+    }
+    if (!deduplicator.linkDuplicates()) {
+        return StatusCode::FILESYSTEM_ERROR;
+    }
+    for (const auto& [key, local_file_path] : files_to_cache) {
+        downloadCache->store(key, local_file_path);
+    }
     return StatusCode::OK;
 }
 
@@ -295,7 +420,9 @@ StatusCode GCSFileSystem::downloadModelVersions(const std::string& path,
         return sc;
     }
 
+    // Files of all versions are downloaded together so that parallelism is not limited to a single version
     StatusCode result = StatusCode::OK;
+    files_to_download_t files_to_download;
     for (auto& ver : versions) {
         std::string versionpath = path;
         if (!endsWith(versionpath, "/")) {
@@ -308,17 +435,33 @@ StatusCode GCSFileSystem::downloadModelVersions(const std::string& path,
         }
         lpath.append(std::to_string(ver));
         fs::create_directory(lpath);
-        auto status = downloadFileFolder(versionpath, lpath);
+        auto status = collectFilesToDownload(versionpath, lpath, &files_to_download);
         if (status != StatusCode::OK) {
             result = status;
             SPDLOG_LOGGER_ERROR(gcs_logger, "Failed to download model version {}", versionpath);
         }
     }
 
+    auto status = downloadFiles(files_to_download);
+    if (status != StatusCode::OK) {
+        result = status;
+        SPDLOG_LOGGER_ERROR(gcs_logger, "Failed to download model versions from {}", path);
+    }
+
     return result;
 }
 
 StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std::string& local_path) {
+    files_to_download_t files_to_download;
+    auto status = collectFilesToDownload(path, local_path, &files_to_download);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    return downloadFiles(files_to_download);
+}
+
+StatusCode GCSFileSystem::collectFilesToDownload(const std::string& path, const std::string& local_path,
+    files_to_download_t* files_to_download) {
     SPDLOG_LOGGER_TRACE(gcs_logger, "Downloading dir {} and saving to {}", path, local_path);
     bool is_dir;
     auto status = this->isDirectory(path, &is_dir);
@@ -350,14 +493,14 @@ StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std:
             local_dir_path);
         auto mkdir_status = CreateLocalDir(local_dir_path);
         if (mkdir_status != StatusCode::OK) {
-            return status;
+            return mkdir_status;
         }
-        auto download_dir_status =
-            this->downloadFileFolder(remote_dir_path, local_dir_path);
-        if (download_dir_status != StatusCode::OK) {
+        auto collect_dir_status =
+            this->collectFilesToDownload(remote_dir_path, local_dir_path, files_to_download);
+        if (collect_dir_status != StatusCode::OK) {
             SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to download directory from {} to {}",
                 remote_dir_path, local_dir_path);
-            return download_dir_status;
+            return collect_dir_status;
         }
     }
 
@@ -369,13 +512,7 @@ StatusCode GCSFileSystem::downloadFileFolder(const std::string& path, const std:
             std::string local_file_path = joinPath({local_path, f});
             SPDLOG_LOGGER_TRACE(gcs_logger, "Processing file {} from {} -> {}", f, remote_file_path,
                 local_file_path);
-            auto download_status =
-                this->downloadFile(remote_file_path, local_file_path);
-            if (download_status != StatusCode::OK) {
-                SPDLOG_LOGGER_ERROR(gcs_logger, "Unable to save file from {} to {}", remote_file_path,
-                    local_file_path);
-                return download_status;
-            }
+            files_to_download->emplace_back(remote_file_path, local_file_path);
         }
     }
     return StatusCode::OK;
@@ -17,6 +17,7 @@
 
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google/cloud/storage/client.h"
@@ -74,6 +75,15 @@ public:
     StatusCode getDirectoryContents(const std::string& path,
         files_list_t* contents) override;
 
+    /**
+   * @brief Get a token changing whenever any object under given directory changes
+   * 
+   * @param path 
+   * @param token 
+   * @return StatusCode 
+   */
+    StatusCode getDirectoryChangeToken(const std::string& path, std::string* token) override;
+
     /**
    * @brief Get only directories in given directory
    *
@@ -146,20 +156,44 @@ private:
         std::string* object);
 
     /**
+    * @brief Pairs of remote file path and local file path
+    */
+    using files_to_download_t = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+    * @brief Lists accepted files of remote directory and its subdirectories and creates local mirror of the subdirectories
     *
-    * @brief
-    *
-    * @param remote_path
+    * @param path
     * @param local_path
+    * @param files_to_download
+    * @return StatusCode
     */
-    StatusCode downloadFile(const std::string& remote_path,
-        const std::string& local_path);
+    StatusCode collectFilesToDownload(const std::string& path, const std::string& local_path,
+        files_to_download_t* files_to_download);
+
+    /**
+    * @brief Downloads files concurrently, objects larger than download part size are read with ranged reads in parallel
+    *
+    * @param files_to_download
+    * @return StatusCode
+    */
+    StatusCode downloadFiles(const files_to_download_t& files_to_download);
 
     /**
     * @brief
     *
     */
     google::cloud::storage::Client client_;
+
+    /**
+    * @brief Maximum number of concurrent reads, set with GCS_DOWNLOAD_THREADS
+    */
+    size_t download_threads_;
+
+    /**
+    * @brief Size in bytes of object ranges read in parallel, set with GCS_DOWNLOAD_PART_SIZE_MB
+    */
+    uint64_t download_part_size_;
 };
 
 }  // namespace ovms
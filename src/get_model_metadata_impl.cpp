@@ -25,6 +25,30 @@ namespace ovms {
 Status GetModelMetadataImpl::getModelStatus(
     const tensorflow::serving::GetModelMetadataRequest* request,
     tensorflow::serving::GetModelMetadataResponse* response) {
+    std::shared_ptr<const ModelMetadataCacheEntry> entry;
+    auto status = getCachedResponse(request, entry);
+    if (!status.ok()) {
+        return status;
+    }
+    response->CopyFrom(entry->response);
+    return StatusCode::OK;
+}
+
+Status GetModelMetadataImpl::getModelStatus(
+    const tensorflow::serving::GetModelMetadataRequest* request,
+    std::string* json) {
+    std::shared_ptr<const ModelMetadataCacheEntry> entry;
+    auto status = getCachedResponse(request, entry);
+    if (!status.ok()) {
+        return status;
+    }
+    *json = entry->json;
+    return StatusCode::OK;
+}
+
+Status GetModelMetadataImpl::getCachedResponse(
+    const tensorflow::serving::GetModelMetadataRequest* request,
+    std::shared_ptr<const ModelMetadataCacheEntry>& entry) {
     auto status = validate(request);
     if (!status.ok()) {
         return status;
@@ -41,7 +65,29 @@ Status GetModelMetadataImpl::getModelStatus(
         if (!pipelineDefinition) {
             return StatusCode::MODEL_NAME_MISSING;
         }
-        return buildResponse(*pipelineDefinition, response, manager);
+        std::unique_ptr<PipelineDefinitionUnloadGuard> unloadGuard;
+        status = pipelineDefinition->waitForLoaded(unloadGuard, 0);
+        if (!status.ok()) {
+            return status;
+        }
+        entry = pipelineDefinition->getMetadataCache();
+        if (entry) {
+            return StatusCode::OK;
+        }
+        // response built after reload or used model change started is dropped by generation check
+        const auto generation = pipelineDefinition->getPipelinePool().getGeneration();
+        auto newEntry = std::make_shared<ModelMetadataCacheEntry>();
+        status = buildResponse(*pipelineDefinition, &newEntry->response, manager);
+        if (!status.ok()) {
+            return status;
+        }
+        status = serializeResponse2Json(&newEntry->response, &newEntry->json);
+        if (!status.ok()) {
+            return status;
+        }
+        pipelineDefinition->setMetadataCache(newEntry, generation);
+        entry = std::move(newEntry);
+        return StatusCode::OK;
     }
 
     std::shared_ptr<ModelInstance> instance = nullptr;
@@ -61,7 +107,27 @@ Status GetModelMetadataImpl::getModelStatus(
         }
     }
 
-    return buildResponse(instance, response);
+    std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+    status = instance->waitForLoaded(0, unloadGuard);
+    if (!status.ok()) {
+        return status;
+    }
+    entry = instance->getMetadataCache();
+    if (entry) {
+        return StatusCode::OK;
+    }
+    auto newEntry = std::make_shared<ModelMetadataCacheEntry>();
+    status = buildResponse(instance, &newEntry->response);
+    if (!status.ok()) {
+        return status;
+    }
+    status = serializeResponse2Json(&newEntry->response, &newEntry->json);
+    if (!status.ok()) {
+        return status;
+    }
+    instance->setMetadataCache(newEntry);
+    entry = std::move(newEntry);
+    return StatusCode::OK;
 }
 
 Status GetModelMetadataImpl::validate(
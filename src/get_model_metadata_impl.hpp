@@ -31,6 +31,15 @@ namespace ovms {
 
 using proto_signature_map_t = google::protobuf::Map<std::string, tensorflow::TensorInfo>;
 
+/**
+ * @brief Metadata response of model version or pipeline built once, together with its JSON form for REST API
+ */
+struct ModelMetadataCacheEntry {
+    tensorflow::serving::GetModelMetadataResponse response;
+    std::string json;
+    uint64_t generation = 0;
+};
+
 class GetModelMetadataImpl {
 public:
     static Status validate(
@@ -48,9 +57,23 @@ public:
         tensorflow::serving::GetModelMetadataResponse* response,
         const ModelManager& manager);
 
+    /**
+     * @brief Gets metadata response cached in model version or pipeline definition, builds and caches it if missing
+     */
+    static Status getCachedResponse(
+        const tensorflow::serving::GetModelMetadataRequest* request,
+        std::shared_ptr<const ModelMetadataCacheEntry>& entry);
+
     static Status getModelStatus(
         const tensorflow::serving::GetModelMetadataRequest* request,
         tensorflow::serving::GetModelMetadataResponse* response);
+
+    /**
+     * @brief Gets metadata response serialized to JSON
+     */
+    static Status getModelStatus(
+        const tensorflow::serving::GetModelMetadataRequest* request,
+        std::string* json);
     static Status createGrpcRequest(std::string model_name, std::optional<int64_t> model_version, tensorflow::serving::GetModelMetadataRequest* request);
     static Status serializeResponse2Json(const tensorflow::serving::GetModelMetadataResponse* response, std::string* output);
 };
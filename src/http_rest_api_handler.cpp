@@ -15,40 +15,59 @@
 //*****************************************************************************
 #include "http_rest_api_handler.hpp"
 
+#include <charconv>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <spdlog/spdlog.h>
 
 #include "filesystem.hpp"
 #include "get_model_metadata_impl.hpp"
+#include "inflightmemorybudget.hpp"
+#include "metrics.hpp"
 #include "model_service.hpp"
 #include "modelinstanceunloadguard.hpp"
+#include "pipeline.hpp"
+#include "pipelinebatcher.hpp"
 #include "prediction_service_utils.hpp"
+#include "profiler.hpp"
+#include "requesttrace.hpp"
 #include "rest_parser.hpp"
 #include "rest_utils.hpp"
+#include "sharedmemory.hpp"
+#include "statussnapshot.hpp"
 
 #define DEBUG
 #include "timer.hpp"
+#include "trafficcapture.hpp"
 
 using tensorflow::serving::PredictRequest;
 using tensorflow::serving::PredictResponse;
 
 namespace ovms {
 
-const std::string HttpRestApiHandler::kPathRegexExp = R"((.?)\/v1\/models\/.*)";
-const std::string HttpRestApiHandler::predictionRegexExp =
-    R"((.?)\/v1\/models\/([^\/:]+)(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?:(classify|regress|predict))";
-const std::string HttpRestApiHandler::modelstatusRegexExp =
-    R"((.?)\/v1\/models(?:\/([^\/:]+))?(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?(?:\/(metadata))?)";
+const std::string HttpRestApiHandler::kInferenceHeaderContentLengthHeader = "Inference-Header-Content-Length";
+
+namespace {
+Status parseRequestBody(RestParser& requestParser, std::string& request, const std::optional<size_t>& binaryHeaderSize) {
+    if (binaryHeaderSize.has_value()) {
+        return requestParser.parseBinary(request.data(), request.size(), binaryHeaderSize.value());
+    }
+    return requestParser.parseInsitu(request.data());
+}
+}  // namespace
 
 Status HttpRestApiHandler::validateUrlAndMethod(
     const std::string_view http_method,
     const std::string& request_path,
-    std::smatch* sm) {
+    RestPathComponents* components) {
 
     if (http_method != "POST" && http_method != "GET") {
         return StatusCode::REST_UNSUPPORTED_METHOD;
@@ -59,43 +78,45 @@ Status HttpRestApiHandler::validateUrlAndMethod(
         return StatusCode::PATH_INVALID;
     }
 
-    if (!std::regex_match(request_path, *sm, sanityRegex)) {
+    if (!matchModelsPath(request_path)) {
         return StatusCode::REST_INVALID_URL;
     }
 
     if (http_method == "POST") {
-        if (std::regex_match(request_path, *sm, predictionRegex)) {
+        if (matchPredictionPath(request_path, *components)) {
             return StatusCode::OK;
-        } else if (std::regex_match(request_path, *sm, modelstatusRegex)) {
+        } else if (matchModelStatusPath(request_path, *components)) {
             return StatusCode::REST_UNSUPPORTED_METHOD;
         }
     } else if (http_method == "GET") {
-        if (std::regex_match(request_path, *sm, modelstatusRegex)) {
+        if (matchModelStatusPath(request_path, *components)) {
             return StatusCode::OK;
-        } else if (std::regex_match(request_path, *sm, predictionRegex)) {
+        } else if (matchPredictionPath(request_path, *components)) {
             return StatusCode::REST_UNSUPPORTED_METHOD;
         }
     }
     return StatusCode::REST_INVALID_URL;
 }
 
-Status HttpRestApiHandler::parseModelVersion(std::string& model_version_str, std::optional<int64_t>& model_version) {
+Status HttpRestApiHandler::parseModelVersion(const std::string_view model_version_str, std::optional<int64_t>& model_version) {
     if (!model_version_str.empty()) {
-        try {
-            model_version = std::stoll(model_version_str.c_str());
-        } catch (std::exception& e) {
+        int64_t version;
+        const auto [end, error] = std::from_chars(model_version_str.data(), model_version_str.data() + model_version_str.size(), version);
+        if (error != std::errc() || end != model_version_str.data() + model_version_str.size()) {
             SPDLOG_ERROR("Couldn't parse model version {}", model_version_str);
             return StatusCode::REST_COULD_NOT_PARSE_VERSION;
         }
+        model_version = version;
     }
     return StatusCode::OK;
 }
 
 Status HttpRestApiHandler::dispatchToProcessor(
     const std::string_view request_path,
-    const std::string& request_body,
+    std::string& request_body,
     std::string* response,
-    const HttpRequestComponents& request_components) {
+    const HttpRequestComponents& request_components,
+    const ResponseChunkWriter& writeResponseChunk) {
 
     if (FileSystem::isPathEscaped({request_path.begin(), request_path.end()})) {
         SPDLOG_ERROR("Path {} escape with .. is forbidden.", request_path);
@@ -105,7 +126,7 @@ Status HttpRestApiHandler::dispatchToProcessor(
     if (request_components.http_method == "POST") {
         if (request_components.processing_method == "predict") {
             return processPredictRequest(request_components.model_name, request_components.model_version,
-                request_components.model_version_label, request_body, response);
+                request_components.model_version_label, request_body, request_components.binary_header_size, response, writeResponseChunk);
         } else {
             SPDLOG_WARN("Requested REST resource {} not found", std::string(request_path));
             return StatusCode::REST_NOT_FOUND;
@@ -122,21 +143,15 @@ Status HttpRestApiHandler::dispatchToProcessor(
     return StatusCode::UNKNOWN_ERROR;
 }
 
-Status HttpRestApiHandler::processRequest(
+Status HttpRestApiHandler::parseRequestComponents(
+    HttpRequestComponents& requestComponents,
     const std::string_view http_method,
-    const std::string_view request_path,
-    const std::string& request_body,
+    const std::string& request_path,
+    const std::string& inferenceHeaderContentLength,
     std::vector<std::pair<std::string, std::string>>* headers,
     std::string* response) {
-
-    std::smatch sm;
-    std::string request_path_str(request_path);
-    if (FileSystem::isPathEscaped(request_path_str)) {
-        SPDLOG_ERROR("Path {} escape with .. is forbidden.", request_path);
-        return StatusCode::PATH_INVALID;
-    }
-
-    auto status = validateUrlAndMethod(http_method, request_path_str, &sm);
+    RestPathComponents components;
+    auto status = validateUrlAndMethod(http_method, request_path, &components);
     if (!status.ok()) {
         return status;
     }
@@ -145,33 +160,184 @@ Status HttpRestApiHandler::processRequest(
     response->clear();
     headers->push_back({"Content-Type", "application/json"});
 
-    HttpRequestComponents requestComponents;
     requestComponents.http_method = http_method;
 
-    requestComponents.model_name = sm[2];
-    std::string model_version_str = sm[3];
-    std::string model_version_label_str = sm[4];
+    requestComponents.model_name = components.modelName;
     if (requestComponents.http_method == "POST")
-        requestComponents.processing_method = sm[5];
+        requestComponents.processing_method = components.method;
     else
-        requestComponents.model_subresource = sm[5];
+        requestComponents.model_subresource = components.method;
 
-    status = parseModelVersion(model_version_str, requestComponents.model_version);
+    status = parseModelVersion(components.modelVersion, requestComponents.model_version);
     if (!status.ok())
         return status;
 
-    if (!model_version_label_str.empty()) {
-        requestComponents.model_version_label = model_version_label_str;
+    if (!components.modelVersionLabel.empty()) {
+        requestComponents.model_version_label = std::string(components.modelVersionLabel);
+    }
+
+    if (!inferenceHeaderContentLength.empty()) {
+        try {
+            requestComponents.binary_header_size = std::stoull(inferenceHeaderContentLength);
+        } catch (std::exception& e) {
+            SPDLOG_ERROR("Couldn't parse {} header: {}", kInferenceHeaderContentLengthHeader, inferenceHeaderContentLength);
+            return StatusCode::REST_BINARY_HEADER_INVALID;
+        }
+    }
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processRequest(
+    const std::string_view http_method,
+    const std::string_view request_path,
+    std::string& request_body,
+    std::vector<std::pair<std::string, std::string>>* headers,
+    std::string* response,
+    const ResponseChunkWriter& writeResponseChunk,
+    const std::string& inferenceHeaderContentLength) {
+
+    std::string request_path_str(request_path);
+    if (FileSystem::isPathEscaped(request_path_str)) {
+        SPDLOG_ERROR("Path {} escape with .. is forbidden.", request_path);
+        return StatusCode::PATH_INVALID;
+    }
+
+    if (matchMetricsPath(request_path)) {
+        if (http_method != "GET") {
+            return StatusCode::REST_UNSUPPORTED_METHOD;
+        }
+        headers->clear();
+        response->clear();
+        headers->push_back({"Content-Type", "text/plain; version=0.0.4"});
+        return processMetricsRequest(response);
+    }
+
+    if (matchReadinessPath(request_path)) {
+        if (http_method != "GET") {
+            return StatusCode::REST_UNSUPPORTED_METHOD;
+        }
+        headers->clear();
+        response->clear();
+        headers->push_back({"Content-Type", "application/json"});
+        return processReadinessRequest(response);
+    }
+
+    if (matchStatusSnapshotPath(request_path)) {
+        if (http_method != "GET") {
+            return StatusCode::REST_UNSUPPORTED_METHOD;
+        }
+        headers->clear();
+        response->clear();
+        headers->push_back({"Content-Type", "application/json"});
+        return processStatusSnapshotRequest(response);
+    }
+
+    std::string_view profile, profileSeconds;
+    if (CpuProfiler::isEnabled() && matchProfilingPath(request_path, profile, profileSeconds)) {
+        if (http_method != "GET") {
+            return StatusCode::REST_UNSUPPORTED_METHOD;
+        }
+        headers->clear();
+        response->clear();
+        return processProfilingRequest(profile, profileSeconds, headers, response);
+    }
+
+    std::string_view regionName, sharedMemoryMethod;
+    if (matchSharedMemoryPath(request_path, regionName, sharedMemoryMethod)) {
+        headers->clear();
+        response->clear();
+        headers->push_back({"Content-Type", "application/json"});
+        return processSharedMemoryRequest(http_method, regionName, sharedMemoryMethod, request_body, response);
+    }
+
+    HttpRequestComponents requestComponents;
+    auto status = parseRequestComponents(requestComponents, http_method, request_path_str, inferenceHeaderContentLength, headers, response);
+    if (!status.ok()) {
+        return status;
+    }
+    return dispatchToProcessor(request_path, request_body, response, requestComponents, writeResponseChunk);
+}
+
+void HttpRestApiHandler::processRequestAsync(
+    const std::string_view http_method,
+    const std::string_view request_path,
+    std::string& request_body,
+    std::vector<std::pair<std::string, std::string>>* headers,
+    std::string* response,
+    const ResponseChunkWriter& writeResponseChunk,
+    const std::string& inferenceHeaderContentLength,
+    const std::string& inferencePriority,
+    const std::string& traceparent,
+    const std::string& serverTiming,
+    InferenceContinuationScheduler scheduleContinuation,
+    RequestCompletionCallback onComplete) {
+    std::string request_path_str(request_path);
+    std::string_view regionName, sharedMemoryMethod, profile, profileSeconds;
+    if (FileSystem::isPathEscaped(request_path_str) || matchMetricsPath(request_path) || matchReadinessPath(request_path) ||
+        matchStatusSnapshotPath(request_path) || matchSharedMemoryPath(request_path, regionName, sharedMemoryMethod) ||
+        (CpuProfiler::isEnabled() && matchProfilingPath(request_path, profile, profileSeconds))) {
+        onComplete(processRequest(http_method, request_path, request_body, headers, response, writeResponseChunk, inferenceHeaderContentLength));
+        return;
     }
-    return dispatchToProcessor(request_path, request_body, response, requestComponents);
+
+    HttpRequestComponents requestComponents;
+    auto status = parseRequestComponents(requestComponents, http_method, request_path_str, inferenceHeaderContentLength, headers, response);
+    if (!status.ok()) {
+        onComplete(status);
+        return;
+    }
+    if (!inferencePriority.empty()) {
+        auto priority = parseRequestPriority(inferencePriority);
+        if (priority) {
+            requestComponents.priority = priority.value();
+        } else {
+            SPDLOG_DEBUG("Ignored unknown {} header value: {}", REQUEST_PRIORITY_HEADER, inferencePriority);
+        }
+    }
+    auto& modelManager = ModelManager::getInstance();
+    const bool isPredict = requestComponents.http_method == "POST" && requestComponents.processing_method == "predict";
+    if (isPredict) {
+        TrafficCapture::getInstance().captureRest(request_path_str, inferenceHeaderContentLength, request_body);
+    }
+    const bool isModelPredict = isPredict && modelManager.modelExists(requestComponents.model_name);
+    // batch leader of pipeline with batching blocks until merged requests are executed, so such requests are processed synchronously
+    const bool isPipelinePredict = isPredict && !isModelPredict &&
+                                   modelManager.pipelineDefinitionExists(requestComponents.model_name) &&
+                                   !getPipelineBatcher(modelManager, requestComponents.model_name);
+    if (isModelPredict || isPipelinePredict) {
+        requestComponents.trace = RequestTrace::create(traceparent, !serverTiming.empty());
+        if (requestComponents.trace) {
+            // server timing is sent with response headers, spans are exported once response is sent
+            onComplete = [trace = requestComponents.trace, headers, onComplete = std::move(onComplete)](const Status& status) {
+                if (trace->isServerTimingRequested()) {
+                    headers->emplace_back(SERVER_TIMING_HEADER, trace->serializeServerTiming());
+                }
+                onComplete(status);
+                if (trace->isSampled()) {
+                    trace->exportSpans();
+                }
+            };
+        }
+        if (isModelPredict) {
+            processSingleModelRequestAsync(requestComponents, request_body, response, writeResponseChunk,
+                std::move(scheduleContinuation), std::move(onComplete));
+        } else {
+            processPipelineRequestAsync(requestComponents, request_body, response, writeResponseChunk, std::move(onComplete));
+        }
+        return;
+    }
+    // other requests are processed synchronously
+    onComplete(dispatchToProcessor(request_path, request_body, response, requestComponents, writeResponseChunk));
 }
 
 Status HttpRestApiHandler::processPredictRequest(
     const std::string& modelName,
     const std::optional<int64_t>& modelVersion,
     const std::optional<std::string_view>& modelVersionLabel,
-    const std::string& request,
-    std::string* response) {
+    std::string& request,
+    const std::optional<size_t>& binaryHeaderSize,
+    std::string* response,
+    const ResponseChunkWriter& writeResponseChunk) {
     // model_version_label currently is not in use
 
     Timer timer;
@@ -188,10 +354,10 @@ Status HttpRestApiHandler::processPredictRequest(
 
     if (modelManager.modelExists(modelName)) {
         SPDLOG_DEBUG("Found model with name: {}. Searching for requested version...", modelName);
-        status = processSingleModelRequest(modelName, modelVersion, request, requestOrder, responseProto);
+        status = processSingleModelRequest(modelName, modelVersion, request, binaryHeaderSize, requestOrder, responseProto);
     } else if (modelManager.pipelineDefinitionExists(modelName)) {
         SPDLOG_DEBUG("Found pipeline with name: {}", modelName);
-        status = processPipelineRequest(modelName, request, requestOrder, responseProto);
+        status = processPipelineRequest(modelName, request, binaryHeaderSize, requestOrder, responseProto);
     } else {
         SPDLOG_WARN("Model or pipeline matching request parameters not found - name: {}, version: {}", modelName, modelVersion.value_or(0));
         status = StatusCode::MODEL_NAME_MISSING;
@@ -199,7 +365,11 @@ Status HttpRestApiHandler::processPredictRequest(
     if (!status.ok())
         return status;
 
-    status = makeJsonFromPredictResponse(responseProto, response, requestOrder);
+    if (writeResponseChunk) {
+        status = makeJsonFromPredictResponse(responseProto, writeResponseChunk, requestOrder);
+    } else {
+        status = makeJsonFromPredictResponse(responseProto, response, requestOrder);
+    }
     if (!status.ok())
         return status;
 
@@ -210,7 +380,8 @@ Status HttpRestApiHandler::processPredictRequest(
 
 Status HttpRestApiHandler::processSingleModelRequest(const std::string& modelName,
     const std::optional<int64_t>& modelVersion,
-    const std::string& request,
+    std::string& request,
+    const std::optional<size_t>& binaryHeaderSize,
     Order& requestOrder,
     tensorflow::serving::PredictResponse& responseProto) {
 
@@ -230,7 +401,7 @@ Status HttpRestApiHandler::processSingleModelRequest(const std::string& modelNam
     Timer timer;
     timer.start("parse");
     RestParser requestParser(modelInstance->getInputsInfo());
-    status = requestParser.parse(request.c_str());
+    status = parseRequestBody(requestParser, request, binaryHeaderSize);
     if (!status.ok()) {
         return status;
     }
@@ -243,12 +414,174 @@ Status HttpRestApiHandler::processSingleModelRequest(const std::string& modelNam
     if (modelVersion.has_value()) {
         requestProto.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
     }
+    // request body and parsed request are held until response is serialized
+    InFlightMemoryBudget::Reservation inFlightMemory;
+    status = reserveModelInFlightMemory(*modelInstance, requestProto, request.size(), inFlightMemory);
+    if (!status.ok()) {
+        return status;
+    }
     status = inference(*modelInstance, &requestProto, &responseProto, modelInstanceUnloadGuard);
     return status;
 }
 
+void HttpRestApiHandler::processSingleModelRequestAsync(
+    const HttpRequestComponents& requestComponents,
+    std::string& request,
+    std::string* response,
+    const ResponseChunkWriter& writeResponseChunk,
+    InferenceContinuationScheduler scheduleContinuation,
+    RequestCompletionCallback onComplete) {
+    const auto& modelName = requestComponents.model_name;
+    const auto& modelVersion = requestComponents.model_version;
+    Timer timer;
+    timer.start("total");
+    SPDLOG_DEBUG("Processing REST request for model: {}; version: {}",
+        modelName, modelVersion.value_or(0));
+
+    std::shared_ptr<ModelInstance> modelInstance;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    auto status = getModelInstance(
+        ModelManager::getInstance(),
+        modelName,
+        modelVersion.value_or(0),
+        modelInstance,
+        modelInstanceUnloadGuard);
+    if (!status.ok()) {
+        SPDLOG_WARN("Requested model instance - name: {}, version: {} - does not exist.", modelName, modelVersion.value_or(0));
+        onComplete(status);
+        return;
+    }
+
+    timer.start("parse");
+    const auto parseStart = std::chrono::steady_clock::now();
+    // parser holds request proto, both are kept until response is serialized
+    auto requestParser = std::make_shared<RestParser>(modelInstance->getInputsInfo());
+    status = parseRequestBody(*requestParser, request, requestComponents.binary_header_size);
+    if (!status.ok()) {
+        onComplete(status);
+        return;
+    }
+    timer.stop("parse");
+    SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>("parse") / 1000);
+    RequestTrace* trace = requestComponents.trace.get();
+    if (trace) {
+        trace->addSpan("parse JSON", parseStart, std::chrono::steady_clock::now());
+    }
+
+    tensorflow::serving::PredictRequest& requestProto = requestParser->getProto();
+    requestProto.mutable_model_spec()->set_name(modelName);
+    if (modelVersion.has_value()) {
+        requestProto.mutable_model_spec()->mutable_version()->set_value(modelVersion.value());
+    }
+    auto responseProto = std::make_shared<PredictResponse>();
+    auto onInferenceComplete = [requestParser, responseProto, response, writeResponseChunk, scheduleContinuation, onComplete, timer, trace](const Status& status) mutable {
+        if (!status.ok()) {
+            onComplete(status);
+            return;
+        }
+        // do not serialize JSON in OpenVINO callback thread
+        scheduleContinuation([requestParser, responseProto, response, writeResponseChunk, onComplete, timer, trace]() mutable {
+            const auto serializeStart = std::chrono::steady_clock::now();
+            Status status;
+            if (writeResponseChunk) {
+                status = makeJsonFromPredictResponse(*responseProto, writeResponseChunk, requestParser->getOrder());
+            } else {
+                status = makeJsonFromPredictResponse(*responseProto, response, requestParser->getOrder());
+            }
+            if (trace) {
+                trace->addSpan("serialize JSON", serializeStart, std::chrono::steady_clock::now());
+            }
+            if (status.ok()) {
+                timer.stop("total");
+                SPDLOG_DEBUG("Total REST request processing time: {} ms", timer.elapsed<std::chrono::microseconds>("total") / 1000);
+            }
+            onComplete(status);
+        });
+    };
+    StreamWaitingOptions waitingOptions;
+    waitingOptions.priority = requestComponents.priority;
+    waitingOptions.trace = trace;
+    waitingOptions.bufferedRequestBytes = request.size();
+    inferenceAsync(std::move(modelInstance), &requestProto, responseProto.get(), std::move(modelInstanceUnloadGuard),
+        std::move(scheduleContinuation), std::move(onInferenceComplete), waitingOptions);
+}
+
+void HttpRestApiHandler::processPipelineRequestAsync(
+    const HttpRequestComponents& requestComponents,
+    std::string& request,
+    std::string* response,
+    const ResponseChunkWriter& writeResponseChunk,
+    RequestCompletionCallback onComplete) {
+    const auto& modelName = requestComponents.model_name;
+    Timer timer;
+    timer.start("total");
+    SPDLOG_DEBUG("Processing REST request for pipeline: {}", modelName);
+
+    timer.start("parse");
+    const auto parseStart = std::chrono::steady_clock::now();
+    // parser holds request proto, both are kept until response is serialized
+    auto requestParser = std::make_shared<RestParser>();
+    auto status = parseRequestBody(*requestParser, request, requestComponents.binary_header_size);
+    if (!status.ok()) {
+        onComplete(status);
+        return;
+    }
+    timer.stop("parse");
+    SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>("parse") / 1000);
+    RequestTrace* trace = requestComponents.trace.get();
+    if (trace) {
+        trace->addSpan("parse JSON", parseStart, std::chrono::steady_clock::now());
+    }
+
+    tensorflow::serving::PredictRequest& requestProto = requestParser->getProto();
+    requestProto.mutable_model_spec()->set_name(modelName);
+    auto inFlightMemory = std::make_shared<InFlightMemoryBudget::Reservation>();
+    status = reservePipelineInFlightMemory(modelName, requestProto, request.size(), *inFlightMemory);
+    if (!status.ok()) {
+        onComplete(status);
+        return;
+    }
+    auto responseProto = std::make_shared<PredictResponse>();
+    std::unique_ptr<Pipeline> pipelinePtr;
+    status = getPipeline(ModelManager::getInstance(), pipelinePtr, &requestProto, responseProto.get());
+    if (!status.ok()) {
+        onComplete(status);
+        return;
+    }
+    // pipeline is owned by its own finish callback and destroyed by it once all nodes are finished,
+    // request and response protos are kept until then since nodes running after timeout still reference them
+    std::shared_ptr<Pipeline> pipeline = std::move(pipelinePtr);
+    pipeline->setTrace(trace);
+    // result is reported on WorkStealingExecutor worker, JSON is serialized there without blocking any thread during execution
+    pipeline->executeAsync([requestParser, responseProto, response, writeResponseChunk, onComplete = std::move(onComplete), timer, trace](const Status& pipelineStatus) mutable {
+        if (!pipelineStatus.ok()) {
+            onComplete(pipelineStatus);
+            return;
+        }
+        const auto serializeStart = std::chrono::steady_clock::now();
+        Status status;
+        if (writeResponseChunk) {
+            status = makeJsonFromPredictResponse(*responseProto, writeResponseChunk, requestParser->getOrder());
+        } else {
+            status = makeJsonFromPredictResponse(*responseProto, response, requestParser->getOrder());
+        }
+        if (trace) {
+            trace->addSpan("serialize JSON", serializeStart, std::chrono::steady_clock::now());
+        }
+        if (status.ok()) {
+            timer.stop("total");
+            SPDLOG_DEBUG("Total REST request processing time: {} ms", timer.elapsed<std::chrono::microseconds>("total") / 1000);
+        }
+        onComplete(status);
+    },
+        [pipeline, requestParser, responseProto, inFlightMemory]() mutable {
+            pipeline.reset();
+        });
+}
+
 Status HttpRestApiHandler::processPipelineRequest(const std::string& modelName,
-    const std::string& request,
+    std::string& request,
+    const std::optional<size_t>& binaryHeaderSize,
     Order& requestOrder,
     tensorflow::serving::PredictResponse& responseProto) {
 
@@ -256,23 +589,34 @@ Status HttpRestApiHandler::processPipelineRequest(const std::string& modelName,
 
     Timer timer;
     timer.start("parse");
-    RestParser requestParser;
-    auto status = requestParser.parse(request.c_str());
+    // parser holds request proto, it is kept with in flight memory reservation until nodes running after pipeline timeout finish
+    auto requestParser = std::make_shared<RestParser>();
+    auto status = parseRequestBody(*requestParser, request, binaryHeaderSize);
     if (!status.ok()) {
         return status;
     }
-    requestOrder = requestParser.getOrder();
+    requestOrder = requestParser->getOrder();
     timer.stop("parse");
     SPDLOG_DEBUG("JSON request parsing time: {} ms", timer.elapsed<std::chrono::microseconds>("parse") / 1000);
 
-    tensorflow::serving::PredictRequest& requestProto = requestParser.getProto();
+    tensorflow::serving::PredictRequest& requestProto = requestParser->getProto();
     requestProto.mutable_model_spec()->set_name(modelName);
+    auto inFlightMemory = std::make_shared<InFlightMemoryBudget::Reservation>();
+    status = reservePipelineInFlightMemory(modelName, requestProto, request.size(), *inFlightMemory);
+    if (!status.ok()) {
+        return status;
+    }
+    // response is not written after timeout, exit node is not started once pipeline failed
+    auto keepAlive = std::make_shared<std::pair<std::shared_ptr<RestParser>, std::shared_ptr<InFlightMemoryBudget::Reservation>>>(requestParser, inFlightMemory);
+    auto batcher = getPipelineBatcher(ModelManager::getInstance(), modelName);
+    if (batcher) {
+        return batcher->execute(&requestProto, &responseProto, std::move(keepAlive));
+    }
     status = getPipeline(ModelManager::getInstance(), pipelinePtr, &requestProto, &responseProto);
     if (!status.ok()) {
         return status;
     }
-    status = pipelinePtr->execute();
-    return status;
+    return Pipeline::executeAndRelease(std::move(pipelinePtr), std::move(keepAlive));
 }
 
 Status HttpRestApiHandler::processModelMetadataRequest(
@@ -282,18 +626,13 @@ Status HttpRestApiHandler::processModelMetadataRequest(
     std::string* response) {
     // model_version_label currently is not in use
     tensorflow::serving::GetModelMetadataRequest grpc_request;
-    tensorflow::serving::GetModelMetadataResponse grpc_response;
     Status status;
     std::string modelName(model_name);
     status = GetModelMetadataImpl::createGrpcRequest(modelName, model_version, &grpc_request);
     if (!status.ok()) {
         return status;
     }
-    status = GetModelMetadataImpl::getModelStatus(&grpc_request, &grpc_response);
-    if (!status.ok()) {
-        return status;
-    }
-    status = GetModelMetadataImpl::serializeResponse2Json(&grpc_response, response);
+    status = GetModelMetadataImpl::getModelStatus(&grpc_request, response);
     if (!status.ok()) {
         return status;
     }
@@ -326,4 +665,101 @@ Status HttpRestApiHandler::processModelStatusRequest(
     return StatusCode::OK;
 }
 
+Status HttpRestApiHandler::processMetricsRequest(std::string* response) {
+    *response = serializeMetricsToPrometheusText(ModelManager::getInstance());
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processReadinessRequest(std::string* response) {
+    auto status = ModelManager::getInstance().getReadinessProbe().check(ModelManager::getInstance());
+    if (status.ok()) {
+        *response = "{\"ready\": true}";
+    }
+    return status;
+}
+
+Status HttpRestApiHandler::processStatusSnapshotRequest(std::string* response) {
+    *response = *StatusSnapshot::getInstance().getJson();
+    return StatusCode::OK;
+}
+
+Status HttpRestApiHandler::processProfilingRequest(
+    const std::string_view profile,
+    const std::string_view seconds,
+    std::vector<std::pair<std::string, std::string>>* headers,
+    std::string* response) {
+    if (profile == "heap") {
+        headers->push_back({"Content-Type", getHeapStatisticsContentType()});
+        return getHeapStatistics(*response);
+    }
+    // profile blocks REST worker, so it is kept well below request timeout
+    std::chrono::milliseconds duration;
+    auto status = CpuProfiler::parseDuration(seconds, std::chrono::milliseconds(timeout_in_ms / 2), duration);
+    if (!status.ok()) {
+        return status;
+    }
+    headers->push_back({"Content-Type", "application/octet-stream"});
+    return CpuProfiler::profile(duration, *response);
+}
+
+Status HttpRestApiHandler::processSharedMemoryRequest(
+    const std::string_view http_method,
+    const std::string_view regionName,
+    const std::string_view method,
+    const std::string& request_body,
+    std::string* response) {
+    auto& registry = SharedMemoryRegistry::getInstance();
+    if (method.empty()) {
+        if (http_method != "GET") {
+            return StatusCode::REST_UNSUPPORTED_METHOD;
+        }
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        writer.StartObject();
+        writer.Key("regions");
+        writer.StartArray();
+        for (const auto& region : registry.getRegions()) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(region->getName().c_str());
+            writer.Key("key");
+            writer.String(region->getKey().c_str());
+            writer.Key("offset");
+            writer.Uint64(region->getOffset());
+            writer.Key("byte_size");
+            writer.Uint64(region->getByteSize());
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        *response = buffer.GetString();
+        return StatusCode::OK;
+    }
+    if (http_method != "POST") {
+        return StatusCode::REST_UNSUPPORTED_METHOD;
+    }
+    const std::string name(regionName);
+    if (method == "unregister") {
+        auto status = registry.unregisterRegion(name);
+        if (status.ok()) {
+            *response = "{}";
+        }
+        return status;
+    }
+    rapidjson::Document doc;
+    if (doc.Parse(request_body.c_str()).HasParseError() || !doc.IsObject() ||
+        !doc.HasMember("key") || !doc["key"].IsString() ||
+        !doc.HasMember("byte_size") || !doc["byte_size"].IsUint64() ||
+        (doc.HasMember("offset") && !doc["offset"].IsUint64())) {
+        SPDLOG_DEBUG("Invalid shared memory region:{} registration request, expected key, byte_size and optional offset", name);
+        return StatusCode::REST_MALFORMED_REQUEST;
+    }
+    const uint64_t offset = doc.HasMember("offset") ? doc["offset"].GetUint64() : 0;
+    auto status = registry.registerRegion(name, doc["key"].GetString(), offset, doc["byte_size"].GetUint64());
+    if (status.ok()) {
+        *response = "{}";
+    }
+    return status;
+}
+
 }  // namespace ovms
@@ -15,8 +15,10 @@
 //*****************************************************************************
 #pragma once
 
-#include <regex>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -25,7 +27,11 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "prediction_service_utils.hpp"
+#include "requesttrace.hpp"
 #include "rest_parser.hpp"
+#include "rest_router.hpp"
+#include "rest_utils.hpp"
 #include "status.hpp"
 
 namespace ovms {
@@ -34,16 +40,22 @@ struct HttpRequestComponents {
     std::string_view http_method;
     std::string model_name;
     std::optional<int64_t> model_version;
-    std::optional<std::string_view> model_version_label;
+    std::optional<std::string> model_version_label;
     std::string processing_method;
     std::string model_subresource;
+    std::optional<size_t> binary_header_size;
+    RequestPriority priority = RequestPriority::NORMAL;
+    std::shared_ptr<RequestTrace> trace;
 };
 
+using RequestCompletionCallback = std::function<void(const Status&)>;
+
 class HttpRestApiHandler {
 public:
-    static const std::string kPathRegexExp;
-    static const std::string predictionRegexExp;
-    static const std::string modelstatusRegexExp;
+    /**
+     * @brief Request header with size of JSON header preceding binary tensors data in predict request body
+     */
+    static const std::string kInferenceHeaderContentLengthHeader;
 
     /**
      * @brief Construct a new HttpRest Api Handler
@@ -51,41 +63,69 @@ public:
      * @param timeout_in_ms 
      */
     HttpRestApiHandler(int timeout_in_ms) :
-        sanityRegex(kPathRegexExp),
-        predictionRegex(predictionRegexExp),
-        modelstatusRegex(modelstatusRegexExp),
         timeout_in_ms(timeout_in_ms) {}
 
     Status validateUrlAndMethod(
         const std::string_view http_method,
         const std::string& request_path,
-        std::smatch* sm);
+        RestPathComponents* components);
 
-    Status parseModelVersion(std::string& model_version_str, std::optional<int64_t>& model_version);
+    Status parseModelVersion(const std::string_view model_version_str, std::optional<int64_t>& model_version);
 
     Status dispatchToProcessor(
         const std::string_view request_path,
-        const std::string& request_body,
+        std::string& request_body,
         std::string* response,
-        const HttpRequestComponents& request_components);
+        const HttpRequestComponents& request_components,
+        const ResponseChunkWriter& writeResponseChunk = {});
 
     /**
      * @brief Process Request
      * 
      * @param http_method 
      * @param request_path 
-     * @param request_body 
+     * @param request_body parsed in place, its content is not preserved
      * @param headers 
      * @param resposnse 
+     * @param writeResponseChunk if set, successful predict response is passed to it in chunks instead of response
+     * @param inferenceHeaderContentLength value of Inference-Header-Content-Length header, if set body contains binary tensors
      *
      * @return StatusCode 
      */
     Status processRequest(
         const std::string_view http_method,
         const std::string_view request_path,
-        const std::string& request_body,
+        std::string& request_body,
         std::vector<std::pair<std::string, std::string>>* headers,
-        std::string* response);
+        std::string* response,
+        const ResponseChunkWriter& writeResponseChunk = {},
+        const std::string& inferenceHeaderContentLength = "");
+
+    /**
+     * @brief Process Request without blocking calling thread while inference is running
+     *
+     * Predict requests for single models are executed with inferenceAsync and predict requests for pipelines without
+     * batching with Pipeline::executeAsync, other requests are processed synchronously by calling thread. Parameters are the same as in processRequest and must stay valid until onComplete is called.
+     *
+     * @param inferencePriority value of inference-priority header, priority of predict request waiting for infer request
+     * @param traceparent value of traceparent header, steps of sampled predict requests for single models and pipelines are traced
+     * @param serverTiming value of server timing request header, when not empty timing of steps of predict requests for single models and pipelines is sent in response header
+     * @param scheduleContinuation hands over continuation of processing to other thread, it must not block
+     * @param onComplete called exactly once with request processing status, once response has been written
+     */
+    void processRequestAsync(
+        const std::string_view http_method,
+        const std::string_view request_path,
+        std::string& request_body,
+        std::vector<std::pair<std::string, std::string>>* headers,
+        std::string* response,
+        const ResponseChunkWriter& writeResponseChunk,
+        const std::string& inferenceHeaderContentLength,
+        const std::string& inferencePriority,
+        const std::string& traceparent,
+        const std::string& serverTiming,
+        InferenceContinuationScheduler scheduleContinuation,
+        RequestCompletionCallback onComplete);
 
     /**
      * @brief Process predict request
@@ -94,7 +134,9 @@ public:
      * @param modelVersion 
      * @param modelVersionLabel 
      * @param request 
+     * @param binaryHeaderSize size of JSON header when request contains binary tensors
      * @param response 
+     * @param writeResponseChunk if set, successful response is passed to it in chunks instead of response
      *
      * @return StatusCode 
      */
@@ -102,19 +144,44 @@ public:
         const std::string& modelName,
         const std::optional<int64_t>& modelVersion,
         const std::optional<std::string_view>& modelVersionLabel,
-        const std::string& request,
-        std::string* response);
+        std::string& request,
+        const std::optional<size_t>& binaryHeaderSize,
+        std::string* response,
+        const ResponseChunkWriter& writeResponseChunk = {});
 
     Status processSingleModelRequest(
         const std::string& modelName,
         const std::optional<int64_t>& modelVersion,
-        const std::string& request,
+        std::string& request,
+        const std::optional<size_t>& binaryHeaderSize,
         Order& requestOrder,
         tensorflow::serving::PredictResponse& responseProto);
 
+    /**
+     * @brief Process predict request for single model, response is serialized on thread passed with scheduleContinuation
+     */
+    void processSingleModelRequestAsync(
+        const HttpRequestComponents& requestComponents,
+        std::string& request,
+        std::string* response,
+        const ResponseChunkWriter& writeResponseChunk,
+        InferenceContinuationScheduler scheduleContinuation,
+        RequestCompletionCallback onComplete);
+
+    /**
+     * @brief Process predict request for pipeline, no thread is blocked while pipeline is executed and response is serialized on WorkStealingExecutor worker
+     */
+    void processPipelineRequestAsync(
+        const HttpRequestComponents& requestComponents,
+        std::string& request,
+        std::string* response,
+        const ResponseChunkWriter& writeResponseChunk,
+        RequestCompletionCallback onComplete);
+
     Status processPipelineRequest(
         const std::string& modelName,
-        const std::string& request,
+        std::string& request,
+        const std::optional<size_t>& binaryHeaderSize,
         Order& requestOrder,
         tensorflow::serving::PredictResponse& responseProto);
 
@@ -149,10 +216,81 @@ public:
         const std::optional<std::string_view>& model_version_label,
         std::string* response);
 
+    /**
+     * @brief Process metrics request
+     *
+     * @param response metrics of served model versions in Prometheus text format
+     *
+     * @return StatusCode
+     */
+    Status processMetricsRequest(std::string* response);
+
+    /**
+     * @brief Process readiness request
+     *
+     * @param response readiness of server in JSON format
+     *
+     * @return StatusCode, SERVER_NOT_READY when infer requests queue pressure of critical models exceeds thresholds
+     */
+    Status processReadinessRequest(std::string* response);
+
+    /**
+     * @brief Process status of all models and pipelines request
+     *
+     * @param response states of all model versions and pipelines in JSON format, served from snapshot updated on state transitions
+     *
+     * @return StatusCode
+     */
+    Status processStatusSnapshotRequest(std::string* response);
+
+    /**
+     * @brief Process profiling request, served only when profiling endpoints are enabled
+     *
+     * @param profile profile collects CPU profile in pprof format for given seconds, heap gets heap allocator statistics
+     * @param seconds duration of CPU profile, up to half of request timeout which is also the default
+     * @param headers
+     * @param response
+     *
+     * @return StatusCode
+     */
+    Status processProfilingRequest(
+        const std::string_view profile,
+        const std::string_view seconds,
+        std::vector<std::pair<std::string, std::string>>* headers,
+        std::string* response);
+
+    /**
+     * @brief Process shared memory regions request
+     *
+     * Region is registered with POST of {"key": <shm_open name>, "offset": <bytes>, "byte_size": <bytes>} body
+     * and unregistered with POST of empty body. GET lists registered regions.
+     *
+     * @param http_method
+     * @param regionName empty for list of regions
+     * @param method register, unregister or empty for list of regions
+     * @param request_body
+     * @param response
+     *
+     * @return StatusCode
+     */
+    Status processSharedMemoryRequest(
+        const std::string_view http_method,
+        const std::string_view regionName,
+        const std::string_view method,
+        const std::string& request_body,
+        std::string* response);
+
 private:
-    const std::regex sanityRegex;
-    const std::regex predictionRegex;
-    const std::regex modelstatusRegex;
+    /**
+     * @brief Validates url and method and extracts request components, sets response content type on success
+     */
+    Status parseRequestComponents(
+        HttpRequestComponents& requestComponents,
+        const std::string_view http_method,
+        const std::string& request_path,
+        const std::string& inferenceHeaderContentLength,
+        std::vector<std::pair<std::string, std::string>>* headers,
+        std::string* response);
 
     int timeout_in_ms;
 };
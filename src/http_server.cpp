@@ -15,13 +15,22 @@
 //*****************************************************************************
 #include "http_server.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <functional>
 #include <memory>
-#include <regex>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
@@ -32,12 +41,16 @@
 #pragma GCC diagnostic pop
 
 #include "http_rest_api_handler.hpp"
+#include "responsecompression.hpp"
 #include "status.hpp"
+#include "workstealingexecutor.hpp"
 
 namespace ovms {
 
 namespace net_http = tensorflow::serving::net_http;
 
+static constexpr size_t MAX_RESERVED_BODY_BYTES = 64 * 1024 * 1024;
+
 class RequestExecutor final : public net_http::EventExecutor {
 public:
     explicit RequestExecutor(int num_threads) :
@@ -51,8 +64,9 @@ private:
 
 class RestApiRequestDispatcher {
 public:
-    RestApiRequestDispatcher(int timeout_in_ms) :
-        regex_(HttpRestApiHandler::kPathRegexExp) {
+    RestApiRequestDispatcher(int timeout_in_ms, net_http::EventExecutor& executor, size_t compression_min_bytes) :
+        executor_(executor),
+        compression_min_bytes_(compression_min_bytes) {
         handler_ = std::make_unique<HttpRestApiHandler>(timeout_in_ms);
     }
 
@@ -63,9 +77,33 @@ public:
     }
 
 private:
+    /**
+     * @brief Buffers of request which has to stay valid until reply is sent
+     */
+    struct PendingRequest {
+        std::string body;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string output;
+        // whole response is kept in output to be compressed before sending
+        bool compress = false;
+    };
+
     void processRequest(net_http::ServerRequestInterface* req) {
         SPDLOG_DEBUG("REST request {}", req->uri_path());
-        std::string body;
+        auto pending = std::make_shared<PendingRequest>();
+        auto& body = pending->body;
+        // Reserve body upfront so that appending chunks does not reallocate, body is later parsed in place.
+        // Header is sent by client, reservation is capped so that it alone cannot force large allocation.
+        const auto contentLength = req->GetRequestHeader("Content-Length");
+        if (!contentLength.empty()) {
+            size_t length = 0;
+            const auto result = std::from_chars(contentLength.data(), contentLength.data() + contentLength.size(), length);
+            if (result.ec == std::errc() && result.ptr == contentLength.data() + contentLength.size()) {
+                body.reserve(std::min(length, MAX_RESERVED_BODY_BYTES));
+            } else {
+                SPDLOG_DEBUG("Could not parse Content-Length header: {}", contentLength);
+            }
+        }
         int64_t num_bytes = 0;
         auto request_chunk = req->ReadRequestBytes(&num_bytes);
         while (request_chunk != nullptr) {
@@ -73,21 +111,52 @@ private:
             request_chunk = req->ReadRequestBytes(&num_bytes);
         }
 
-        std::vector<std::pair<std::string, std::string>> headers;
-        std::string output;
         SPDLOG_DEBUG("Processing HTTP request: {} {} body: {} bytes",
             req->http_method(),
             req->uri_path(),
             body.size());
-        const auto status = handler_->processRequest(req->http_method(), req->uri_path(), body, &headers, &output);
+        pending->compress = compression_min_bytes_ > 0 && acceptsGzipEncoding(req->GetRequestHeader("Accept-Encoding"));
+        // Predict response is written to evhttp output buffer while being serialized, without building whole JSON string
+        const auto writeResponseChunk = [req, output = &pending->output, compress = pending->compress](const char* data, size_t size) {
+            if (compress) {
+                output->append(data, size);
+            } else {
+                req->WriteResponseBytes(data, static_cast<int64_t>(size));
+            }
+        };
+        // Executor thread is released while inference is running, response is serialized and sent by shared executor worker
+        handler_->processRequestAsync(req->http_method(), req->uri_path(), body, &pending->headers, &pending->output, writeResponseChunk,
+            req->GetRequestHeader(HttpRestApiHandler::kInferenceHeaderContentLengthHeader),
+            req->GetRequestHeader(REQUEST_PRIORITY_HEADER),
+            req->GetRequestHeader(TRACEPARENT_HEADER),
+            req->GetRequestHeader(SERVER_TIMING_REQUEST_HEADER),
+            [](std::function<void()> continuation) { WorkStealingExecutor::getInstance().schedule(std::move(continuation)); },
+            [this, req, pending](const Status& status) { reply(req, *pending, status); });
+    }
+
+    void reply(net_http::ServerRequestInterface* req, PendingRequest& pending, const Status& status) {
+        auto& output = pending.output;
         if (!status.ok() && output.empty()) {
             output.append("{\"error\": \"" + status.string() + "\"}");
         }
         const auto http_status = status.http();
-        for (const auto& kv : headers) {
+        for (const auto& kv : pending.headers) {
             req->OverwriteResponseHeader(kv.first, kv.second);
         }
-        req->WriteResponseString(output);
+        if (pending.compress && output.size() >= compression_min_bytes_) {
+            std::string compressed;
+            if (compressGzip(output, compressed)) {
+                SPDLOG_DEBUG("Compressed REST response from {} to {} bytes", output.size(), compressed.size());
+                output = std::move(compressed);
+                req->OverwriteResponseHeader("Content-Encoding", "gzip");
+            }
+        }
+        if (compression_min_bytes_ > 0) {
+            req->OverwriteResponseHeader("Vary", "Accept-Encoding");
+        }
+        if (!output.empty()) {
+            req->WriteResponseString(output);
+        }
         if (http_status != net_http::HTTPStatusCode::OK) {
             SPDLOG_DEBUG("Processing HTTP/REST request failed: {} {}. Reason: {}",
                 req->http_method(),
@@ -97,15 +166,117 @@ private:
         req->ReplyWithStatus(http_status);
     }
 
-    const std::regex regex_;
+    net_http::EventExecutor& executor_;
     std::unique_ptr<HttpRestApiHandler> handler_;
+    const size_t compression_min_bytes_;
 };
 
-std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, int timeout_in_ms) {
+void removeStaleUnixSocket(const std::string& path) {
+    struct stat pathStat;
+    if (stat(path.c_str(), &pathStat) == 0 && S_ISSOCK(pathStat.st_mode)) {
+        unlink(path.c_str());
+    }
+}
+
+/**
+ * @brief Creates listening unix domain socket
+ *
+ * @return socket descriptor or -1 on failure
+ */
+static int listenOnUnixSocket(const std::string& path) {
+    removeStaleUnixSocket(path);
+    sockaddr_un socketAddress{};
+    socketAddress.sun_family = AF_UNIX;
+    path.copy(socketAddress.sun_path, sizeof(socketAddress.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Sets options of listening TCP socket, inherited by accepted connections
+ *
+ * Nagle's algorithm is disabled, so that the last segment of response written on kept alive connection is not
+ * delayed until client acknowledges the previous ones.
+ */
+static bool setConnectionOptions(int fd, int socket_buffer_bytes) {
+    const int enable = 1;
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)) != 0) {
+        return false;
+    }
+    if (socket_buffer_bytes > 0 &&
+        (setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &socket_buffer_bytes, sizeof(socket_buffer_bytes)) != 0 ||
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &socket_buffer_bytes, sizeof(socket_buffer_bytes)) != 0)) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Creates listening TCP socket, optionally bound with SO_REUSEPORT so that kernel balances connections between servers sharing the port
+ *
+ * @return socket descriptor or -1 on failure
+ */
+static int listenOnPort(const std::string& address, int port, bool reuse_port, int socket_buffer_bytes) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(address.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* info = addresses; info != nullptr && fd < 0; info = info->ai_next) {
+        fd = socket(info->ai_family, info->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, info->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        const int enable = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) != 0 ||
+            (reuse_port && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) ||
+            !setConnectionOptions(fd, socket_buffer_bytes) ||
+            bind(fd, info->ai_addr, info->ai_addrlen) != 0 || listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, int timeout_in_ms, const std::string& unix_socket_path, size_t compression_min_bytes, bool reuse_port,
+    int connection_timeout_sec, int socket_buffer_bytes) {
     auto options = std::make_unique<net_http::ServerOptions>();
     options->AddPort(static_cast<uint32_t>(port));
     options->SetAddress(address);
-    options->SetExecutor(std::make_unique<RequestExecutor>(num_threads));
+    options->SetConnectionTimeout(connection_timeout_sec);
+    // port is bound here instead of by the server to tune sockets of connections accepted on it
+    int fd = listenOnPort(address, port, reuse_port, socket_buffer_bytes);
+    if (fd < 0) {
+        SPDLOG_ERROR("Failed to listen on port {}{}", port, reuse_port ? " shared with other servers" : "");
+        return nullptr;
+    }
+    // server takes ownership of the descriptor
+    options->SetPortSocket(fd);
+    if (!unix_socket_path.empty()) {
+        int fd = listenOnUnixSocket(unix_socket_path);
+        if (fd < 0) {
+            SPDLOG_ERROR("Failed to listen on unix domain socket {}", unix_socket_path);
+            return nullptr;
+        }
+        // server takes ownership of the descriptor
+        options->AddListeningSocket(fd);
+    }
+    auto executor = std::make_unique<RequestExecutor>(num_threads);
+    auto& requestExecutor = *executor;
+    options->SetExecutor(std::move(executor));
 
     auto server = net_http::CreateEvHTTPServer(std::move(options));
     if (server == nullptr) {
@@ -114,7 +285,7 @@ std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address
     }
 
     std::shared_ptr<RestApiRequestDispatcher> dispatcher =
-        std::make_shared<RestApiRequestDispatcher>(timeout_in_ms);
+        std::make_shared<RestApiRequestDispatcher>(timeout_in_ms, requestExecutor, compression_min_bytes);
 
     net_http::RequestHandlerOptions handler_options;
     server->RegisterRequestDispatcher(
@@ -125,6 +296,9 @@ std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address
 
     if (server->StartAcceptingRequests()) {
         SPDLOG_INFO("REST server listening on port {} with {} threads", port, num_threads);
+        if (!unix_socket_path.empty()) {
+            SPDLOG_INFO("REST server listening on unix domain socket {}", unix_socket_path);
+        }
         return server;
     }
 
@@ -33,9 +33,22 @@ using http_server = tensorflow::serving::net_http::HTTPServerInterface;
  * @param port 
  * @param num_threads 
  * @param timeout_in_m
+ * @param unix_socket_path path of unix domain socket accepting connections in addition to port, empty if disabled
+ * @param compression_min_bytes minimum size of response compressed with gzip when client accepts it, 0 if disabled
+ * @param reuse_port port is bound with SO_REUSEPORT, so that it is shared with other servers
+ * @param connection_timeout_sec seconds after which idle kept alive connections are closed, 0 for libevent default of 50 seconds
+ * @param socket_buffer_bytes size of kernel send and receive buffers of connections, 0 for system default
  *  
  * @return std::unique_ptr<http_server> 
  */
-std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, int timeout_in_ms);
+std::unique_ptr<http_server> createAndStartHttpServer(const std::string& address, int port, int num_threads, int timeout_in_ms, const std::string& unix_socket_path = "", size_t compression_min_bytes = 0, bool reuse_port = false,
+    int connection_timeout_sec = 0, int socket_buffer_bytes = 0);
+
+/**
+ * @brief Removes socket file left by previous server instance so that unix domain socket can be bound again
+ *
+ * @param path
+ */
+void removeStaleUnixSocket(const std::string& path);
 
 }  // namespace ovms
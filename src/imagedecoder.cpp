@@ -0,0 +1,261 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "imagedecoder.hpp"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+
+#include <jpeglib.h>
+#include <png.h>
+#include <spdlog/spdlog.h>
+
+#include "workstealingexecutor.hpp"
+
+namespace ovms {
+
+namespace {
+struct JpegErrorManager {
+    jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+void onJpegError(j_common_ptr info) {
+    longjmp(reinterpret_cast<JpegErrorManager*>(info->err)->jump, 1);
+}
+
+void onJpegMessage(j_common_ptr info) {
+    char message[JMSG_LENGTH_MAX];
+    (*info->err->format_message)(info, message);
+    SPDLOG_DEBUG("JPEG decoder: {}", message);
+}
+
+bool isJpeg(const std::string& encoded) {
+    return encoded.size() > 2 &&
+           static_cast<uint8_t>(encoded[0]) == 0xFF &&
+           static_cast<uint8_t>(encoded[1]) == 0xD8;
+}
+
+Status checkImageSize(size_t imageHeight, size_t imageWidth, size_t height, size_t width) {
+    if ((height != 0 && imageHeight != height) || (width != 0 && imageWidth != width)) {
+        const std::string details = "Image size: " + std::to_string(imageWidth) + "x" + std::to_string(imageHeight) +
+                                    "; Expected: " + std::to_string(width) + "x" + std::to_string(height);
+        SPDLOG_DEBUG("Invalid image size - {}", details);
+        return Status(StatusCode::INVALID_SHAPE, details);
+    }
+    // header dimensions are at most 2^32 - 1 each, product does not overflow
+    if (imageHeight == 0 || imageWidth == 0 || imageHeight * imageWidth > MAX_DECODED_IMAGE_PIXELS) {
+        const std::string details = "Image size: " + std::to_string(imageWidth) + "x" + std::to_string(imageHeight) +
+                                    "; Allowed pixels: " + std::to_string(MAX_DECODED_IMAGE_PIXELS);
+        SPDLOG_DEBUG("Invalid image size - {}", details);
+        return Status(StatusCode::INVALID_SHAPE, details);
+    }
+    return StatusCode::OK;
+}
+
+bool isPng(const std::string& encoded) {
+    return encoded.size() > 8 && png_sig_cmp(reinterpret_cast<png_const_bytep>(encoded.data()), 0, 8) == 0;
+}
+
+// libjpeg-turbo uses SIMD implementation of IDCT and color conversion for the host instruction set
+Status decodeJpeg(const std::string& encoded, size_t channels, DecodedImage& image, size_t height, size_t width) {
+    jpeg_decompress_struct info;
+    JpegErrorManager error;
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = onJpegError;
+    error.manager.output_message = onJpegMessage;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&info);
+        SPDLOG_DEBUG("Failed to decode JPEG image");
+        return StatusCode::IMAGE_PARSING_FAILED;
+    }
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, reinterpret_cast<const unsigned char*>(encoded.data()), encoded.size());
+    jpeg_read_header(&info, TRUE);
+    auto status = checkImageSize(info.image_height, info.image_width, height, width);
+    if (!status.ok()) {
+        jpeg_destroy_decompress(&info);
+        return status;
+    }
+    if (channels == 0) {
+        channels = info.num_components == 1 ? 1 : 3;
+    }
+    info.out_color_space = channels == 1 ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&info);
+    image.height = info.output_height;
+    image.width = info.output_width;
+    image.channels = channels;
+    image.pixels.resize(image.height * image.width * image.channels);
+    const size_t rowSize = image.width * image.channels;
+    while (info.output_scanline < info.output_height) {
+        JSAMPROW row = image.pixels.data() + info.output_scanline * rowSize;
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    if (error.manager.num_warnings > 0) {
+        // corrupted or truncated data is filled by decoder instead of failing
+        SPDLOG_DEBUG("JPEG image is corrupted");
+        return StatusCode::IMAGE_PARSING_FAILED;
+    }
+    return StatusCode::OK;
+}
+
+Status decodePng(const std::string& encoded, size_t channels, DecodedImage& image, size_t height, size_t width) {
+    png_image png;
+    std::memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&png, encoded.data(), encoded.size())) {
+        SPDLOG_DEBUG("Failed to read PNG image header: {}", png.message);
+        return StatusCode::IMAGE_PARSING_FAILED;
+    }
+    auto status = checkImageSize(png.height, png.width, height, width);
+    if (!status.ok()) {
+        png_image_free(&png);
+        return status;
+    }
+    if (channels == 0) {
+        channels = (png.format & PNG_FORMAT_FLAG_COLOR) ? 3 : 1;
+    }
+    png.format = channels == 1 ? PNG_FORMAT_GRAY : PNG_FORMAT_RGB;
+    image.height = png.height;
+    image.width = png.width;
+    image.channels = channels;
+    image.pixels.resize(PNG_IMAGE_SIZE(png));
+    if (!png_image_finish_read(&png, nullptr, image.pixels.data(), 0, nullptr)) {
+        SPDLOG_DEBUG("Failed to decode PNG image: {}", png.message);
+        png_image_free(&png);
+        return StatusCode::IMAGE_PARSING_FAILED;
+    }
+    return StatusCode::OK;
+}
+
+template <typename T>
+void convertImage(const DecodedImage& image, bool interleaved, T* destination) {
+    const size_t pixels = image.height * image.width;
+    if (interleaved) {
+        std::transform(image.pixels.begin(), image.pixels.end(), destination, [](uint8_t value) { return static_cast<T>(value); });
+        return;
+    }
+    for (size_t c = 0; c < image.channels; c++) {
+        T* plane = destination + c * pixels;
+        for (size_t p = 0; p < pixels; p++) {
+            plane[p] = static_cast<T>(image.pixels[p * image.channels + c]);
+        }
+    }
+}
+
+Status decodeInParallel(const tensorflow::TensorProto& proto, const std::function<Status(int)>& decode) {
+    std::vector<Status> statuses(proto.string_val_size(), StatusCode::OK);
+    auto& executor = WorkStealingExecutor::getInstance();
+    const size_t count = proto.string_val_size();
+    executor.parallelFor(count, std::min(count > 0 ? count - 1 : 0, executor.getWorkersCount()), [&statuses, &decode](size_t i) {
+        try {
+            statuses[i] = decode(i);
+        } catch (const std::bad_alloc&) {
+            SPDLOG_DEBUG("Not enough memory to decode image {}", i);
+            statuses[i] = StatusCode::IMAGE_PARSING_FAILED;
+        }
+    });
+    for (const auto& status : statuses) {
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+}  // namespace
+
+Status decodeImage(const std::string& encoded, size_t channels, DecodedImage& image, size_t height, size_t width) {
+    if (isJpeg(encoded)) {
+        return decodeJpeg(encoded, channels, image, height, width);
+    }
+    if (isPng(encoded)) {
+        return decodePng(encoded, channels, image, height, width);
+    }
+    SPDLOG_DEBUG("Unsupported image format, only JPEG and PNG are supported");
+    return StatusCode::IMAGE_PARSING_FAILED;
+}
+
+Status decodeImages(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc, void* destination) {
+    const auto& dims = desc.getDims();
+    const auto precision = desc.getPrecision();
+    if (precision != InferenceEngine::Precision::U8 && precision != InferenceEngine::Precision::FP32) {
+        SPDLOG_DEBUG("Images can be decoded only to U8 or FP32 precision");
+        return StatusCode::INVALID_PRECISION;
+    }
+    if (dims.size() != 4 || dims[0] != static_cast<size_t>(proto.string_val_size())) {
+        SPDLOG_DEBUG("Images can be decoded only to 4 dimensional input with batch size equal to images count");
+        return StatusCode::INVALID_BATCH_SIZE;
+    }
+    const bool interleaved = desc.getLayout() == InferenceEngine::Layout::NHWC;
+    const size_t channels = interleaved ? dims[3] : dims[1];
+    const size_t height = interleaved ? dims[1] : dims[2];
+    const size_t width = interleaved ? dims[2] : dims[3];
+    if (channels != 1 && channels != 3) {
+        SPDLOG_DEBUG("Images can be decoded only to inputs with 1 or 3 channels");
+        return StatusCode::INVALID_SHAPE;
+    }
+    const size_t imageSize = channels * height * width;
+    return decodeInParallel(proto, [&](int i) -> Status {
+        DecodedImage image;
+        // image of other size is rejected from its header, before pixels are decoded
+        auto status = decodeImage(proto.string_val(i), channels, image, height, width);
+        if (!status.ok()) {
+            return status;
+        }
+        if (precision == InferenceEngine::Precision::U8) {
+            convertImage(image, interleaved, static_cast<uint8_t*>(destination) + i * imageSize);
+        } else {
+            convertImage(image, interleaved, static_cast<float*>(destination) + i * imageSize);
+        }
+        return StatusCode::OK;
+    });
+}
+
+Status decodeImages(const tensorflow::TensorProto& proto, InferenceEngine::Blob::Ptr& blob) {
+    if (proto.string_val_size() == 0) {
+        SPDLOG_DEBUG("Missing encoded images in string_val");
+        return StatusCode::IMAGE_PARSING_FAILED;
+    }
+    std::vector<DecodedImage> images(proto.string_val_size());
+    auto status = decodeInParallel(proto, [&proto, &images](int i) { return decodeImage(proto.string_val(i), 0, images[i]); });
+    if (!status.ok()) {
+        return status;
+    }
+    const auto& first = images[0];
+    for (const auto& image : images) {
+        if (image.height != first.height || image.width != first.width || image.channels != first.channels) {
+            SPDLOG_DEBUG("Images in batch have different size or color type");
+            return StatusCode::INVALID_SHAPE;
+        }
+    }
+    InferenceEngine::TensorDesc desc(InferenceEngine::Precision::U8,
+        {images.size(), first.height, first.width, first.channels}, InferenceEngine::Layout::NHWC);
+    blob = InferenceEngine::make_shared_blob<uint8_t>(desc);
+    blob->allocate();
+    uint8_t* destination = blob->buffer().as<uint8_t*>();
+    for (const auto& image : images) {
+        destination = std::copy(image.pixels.begin(), image.pixels.end(), destination);
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
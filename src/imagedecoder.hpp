@@ -0,0 +1,84 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+struct DecodedImage {
+    size_t height = 0;
+    size_t width = 0;
+    size_t channels = 0;
+    // interleaved HWC pixels in RGB order
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * @brief Maximum number of pixels of decoded image, so that small file cannot make decoder allocate gigabytes
+ */
+constexpr size_t MAX_DECODED_IMAGE_PIXELS = 8192 * 8192;
+
+/**
+ * @brief Decodes JPEG or PNG image
+ *
+ * Size from image header is checked before pixels are allocated.
+ *
+ * @param encoded image file content
+ * @param channels 1 for grayscale, 3 for RGB, 0 to keep image color type
+ * @param image
+ * @param height expected height of image, any height if 0
+ * @param width expected width of image, any width if 0
+ *
+ * @return Status, INVALID_SHAPE if image size is not the expected one or exceeds MAX_DECODED_IMAGE_PIXELS
+ */
+Status decodeImage(const std::string& encoded, size_t channels, DecodedImage& image, size_t height = 0, size_t width = 0);
+
+/**
+ * @brief Decodes batch of images from string_val of tensor proto into memory described by tensor desc
+ *
+ * Images are decoded in parallel by shared executor and converted to layout (NCHW or NHWC) and precision (U8 or FP32) of desc.
+ * Batch size of desc has to match number of images and all images need spatial size of desc.
+ *
+ * @param proto
+ * @param desc
+ * @param destination memory of desc byte size
+ *
+ * @return Status
+ */
+Status decodeImages(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc, void* destination);
+
+/**
+ * @brief Decodes batch of images from string_val of tensor proto into U8 NHWC blob keeping images size and color type
+ *
+ * @param proto
+ * @param blob
+ *
+ * @return Status
+ */
+Status decodeImages(const tensorflow::TensorProto& proto, InferenceEngine::Blob::Ptr& blob);
+
+}  // namespace ovms
@@ -0,0 +1,204 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "infer_request_node.hpp"
+
+#include <chrono>
+#include <optional>
+#include <utility>
+
+#include "inflightmemorybudget.hpp"
+#include "ov_utils.hpp"
+#include "ovinferrequestsqueue.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Copy of infer request output keeping its size reserved in in flight memory budget until last output blob is released
+ */
+struct ReservedOutputCopy {
+    InferenceEngine::Blob::Ptr blob;
+    InFlightMemoryBudget::Reservation reservation;
+};
+}  // namespace
+
+Status InferRequestNode::executeOnStream(NodeNotificationQueue& notifyEndQueue) {
+    auto streamId = this->nodeStreamIdGuard->tryGetId(0);
+    if (!streamId) {
+        if (this->nodeStreamIdGuard->notifyWhenAssigned()) {
+            // Node will be pushed to notifyEndQueue again once stream is returned by other inference
+            SPDLOG_DEBUG("[Node: {}] Could not acquire stream Id right away", getName());
+            return StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET;
+        }
+        streamId = this->nodeStreamIdGuard->tryGetId(0);
+    }
+    auto& inferRequest = getInferRequestsQueue()->getInferRequest(streamId.value());
+    auto status = setInputsForInference(inferRequest);
+    if (!status.ok()) {
+        notifyEndQueue.push(*this);
+        return status;
+    }
+    status = executeInference(notifyEndQueue, inferRequest);
+    if (!status.ok()) {
+        notifyEndQueue.push(*this);
+    }
+    return status;
+}
+
+Status InferRequestNode::setInputsForInference(InferenceEngine::InferRequest& inferRequest) {
+    Status status = StatusCode::OK;
+    try {
+        // Prepare inference request, fill with input blobs
+        for (const auto& [name, blob] : this->inputBlobs) {
+            std::string realInputName;
+            if (!getRealInputName(name, &realInputName).ok()) {
+                SPDLOG_WARN("[Node: {}] Cannot find real input name of model: {} for alias {}", getName(), getInferredModelName(), name);
+                return StatusCode::INTERNAL_ERROR;
+            }
+            if (this->originalInputBlobs.count(realInputName) == 0) {
+                this->originalInputBlobs.emplace(realInputName, inferRequest.GetBlob(realInputName));
+            }
+            inferRequest.SetBlob(realInputName, blob);
+        }
+        // OV implementation the InferenceEngineException is not
+        // a base class for all other exceptions thrown from OV.
+        // OV can throw exceptions derived from std::logic_error.
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("[Node: {}] {}; exception message: {}", getName(), status.string(), e.what());
+    } catch (std::logic_error& e) {
+        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("[Node: {}] {}; exception message: {}", getName(), status.string(), e.what());
+    } catch (...) {
+        status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("[Node: {}] {}; with unknown exception", getName(), status.string());
+    }
+    return status;
+}
+
+Status InferRequestNode::executeInference(NodeNotificationQueue& notifyEndQueue, InferenceEngine::InferRequest& inferRequest) {
+    try {
+        SPDLOG_DEBUG("Setting completion callback for node name: {}", this->getName());
+        inferRequest.SetCompletionCallback([this, &notifyEndQueue, &inferRequest]() {
+            SPDLOG_DEBUG("Completion callback received for node name: {}", this->getName());
+            // After inference is completed, input blobs are not needed anymore
+            this->inputBlobs.clear();
+            notifyEndQueue.push(*this);
+            inferRequest.SetCompletionCallback([]() {});  // reset callback on infer request
+        });
+        SPDLOG_DEBUG("Starting infer async for node name: {}", getName());
+        inferRequest.StartAsync();
+    } catch (const std::exception& e) {
+        SPDLOG_DEBUG("[Node: {}] Exception occured when starting async inference or setting completion callback on model: {}, error: {}",
+            getName(), getInferredModelName(), e.what());
+        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+    } catch (...) {
+        SPDLOG_DEBUG("[Node: {}] Unknown exception occured when starting async inference or setting completion callback on model: {}",
+            getName(), getInferredModelName());
+        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+    }
+    return StatusCode::OK;
+}
+
+Status InferRequestNode::waitForInference(InferenceEngine::InferRequest*& inferRequest) {
+    auto streamId = this->nodeStreamIdGuard ? this->nodeStreamIdGuard->tryGetId() : std::nullopt;
+    if (!streamId) {
+        SPDLOG_DEBUG("[Node: {}] Fetching results failed - node had stream Id never assigned", getName());
+        return StatusCode::UNKNOWN_ERROR;
+    }
+    inferRequest = &getInferRequestsQueue()->getInferRequest(streamId.value());
+    SPDLOG_DEBUG("[Node: {}] Waiting for infer request with streamId:{} to finish", getName(), streamId.value());
+    auto ovStatus = waitForInferRequest(*inferRequest, std::chrono::microseconds(getCompletionSpinMicroseconds()));
+    SPDLOG_DEBUG("[Node: {}] Infer request with streamId:{} finished", getName(), streamId.value());
+    this->inputBlobs.clear();
+    restoreOriginalInputBlobs();
+    if (ovStatus != InferenceEngine::StatusCode::OK) {
+        Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_DEBUG("[Node: {}] Async infer failed: {}; OV StatusCode: {}", getName(), status.string(), ovStatus);
+        return status;
+    }
+    return StatusCode::OK;
+}
+
+Status InferRequestNode::fetchOutput(InferenceEngine::InferRequest& inferRequest, const std::string& realOutputName,
+    const std::shared_ptr<InferRequestOutputsOwner>& outputsOwner, InferenceEngine::Blob::Ptr& output) {
+    try {
+        const auto blob = inferRequest.GetBlob(realOutputName);
+        if (outputsOwner) {
+            SPDLOG_DEBUG("[Node: {}] Passing blob from model:{}, blobName:{} without copy", getName(), getInferredModelName(), realOutputName);
+            outputsOwner->blobs.emplace(realOutputName, blob);
+            // aliasing pointer - blob memory stays valid as long as stream of this node is reserved
+            output = InferenceEngine::Blob::Ptr(outputsOwner, blob.get());
+            return StatusCode::OK;
+        }
+        SPDLOG_DEBUG("[Node: {}] Creating copy of blob from model:{}, blobName:{}", getName(), getInferredModelName(), realOutputName);
+        return copyOutput(blob, output);
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        Status status = StatusCode::OV_INTERNAL_SERIALIZATION_ERROR;
+        SPDLOG_DEBUG("[Node: {}] Error during getting blob {}; exception message: {}", getName(), status.string(), e.what());
+        return status;
+    }
+}
+
+Status InferRequestNode::copyOutput(const InferenceEngine::Blob::Ptr& blob, InferenceEngine::Blob::Ptr& copy) {
+    auto& budget = InFlightMemoryBudget::getInstance();
+    const size_t modelBudgetBytes = getInFlightMemoryBudgetBytes();
+    std::optional<InFlightMemoryBudget::Reservation> reservation;
+    if (!budget.isUnlimited(modelBudgetBytes)) {
+        reservation = budget.tryReserve(getInferredModelName(), blob->byteSize(), modelBudgetBytes);
+        if (!reservation) {
+            SPDLOG_DEBUG("[Node: {}] Cannot copy blob - in flight memory budget exceeded", getName());
+            return StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED;
+        }
+    }
+    copy = blobClone(blob);
+    if (copy == nullptr) {
+        SPDLOG_ERROR("[Node: {}] Cannot copy blob - buffer sizes mismatch", getName());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    if (this->metrics) {
+        this->metrics->copiedBytes.fetch_add(blob->byteSize(), std::memory_order_relaxed);
+    }
+    if (reservation) {
+        auto owner = std::make_shared<ReservedOutputCopy>(ReservedOutputCopy{copy, std::move(reservation.value())});
+        // aliasing pointer - reservation is released together with copied blob
+        copy = InferenceEngine::Blob::Ptr(owner, owner->blob.get());
+    }
+    return StatusCode::OK;
+}
+
+void InferRequestNode::restoreOriginalInputBlobs() {
+    if (this->originalInputBlobs.empty()) {
+        return;
+    }
+    auto streamId = this->nodeStreamIdGuard ? this->nodeStreamIdGuard->tryGetId(0) : std::nullopt;
+    auto* inferRequestsQueue = getInferRequestsQueue();
+    if (inferRequestsQueue == nullptr || !streamId) {
+        this->originalInputBlobs.clear();
+        return;
+    }
+    auto& inferRequest = inferRequestsQueue->getInferRequest(streamId.value());
+    try {
+        for (const auto& [name, blob] : this->originalInputBlobs) {
+            inferRequest.SetBlob(name, blob);
+        }
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        SPDLOG_DEBUG("[Node: {}] Restoring infer request input blobs failed; exception message: {}", getName(), e.what());
+    }
+    this->originalInputBlobs.clear();
+}
+
+}  // namespace ovms
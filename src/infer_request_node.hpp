@@ -0,0 +1,139 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <inference_engine.hpp>
+#include <spdlog/spdlog.h>
+
+#include "node.hpp"
+#include "nodestreamidguard.hpp"
+
+namespace ovms {
+
+class OVInferRequestsQueue;
+
+/**
+ * @brief Owner of infer request outputs passed to following nodes without copy.
+ * Keeps the stream reserved and inference resources alive until last output blob is released.
+ * Members are destroyed in reverse order - stream is returned before inference resources are released.
+ */
+struct InferRequestOutputsOwner {
+    std::shared_ptr<void> inferenceResources;
+    std::unique_ptr<NodeStreamIdGuard> nodeStreamIdGuard;
+    BlobMap blobs;
+};
+
+/**
+ * @brief Base of nodes running inference on infer request taken from stream of model or fused network
+ */
+class InferRequestNode : public Node {
+protected:
+    const std::unordered_map<std::string, std::string> nodeOutputNameAlias;
+    const bool zeroCopyOutputs;
+
+    std::unique_ptr<NodeStreamIdGuard> nodeStreamIdGuard;
+
+    // Input blobs allocated by infer request, replaced with blobs received from previous nodes for the inference
+    BlobMap originalInputBlobs;
+
+    InferRequestNode(const std::string& nodeName,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias,
+        bool zeroCopyOutputs) :
+        Node(nodeName),
+        nodeOutputNameAlias(nodeOutputNameAlias),
+        zeroCopyOutputs(zeroCopyOutputs) {
+    }
+
+public:
+    bool tryDisarmStreamIdGuard(const uint microseconds = 1) override {
+        SPDLOG_DEBUG("Trying to disarm stream id guard of node: {}", getName());
+        if (this->nodeStreamIdGuard == nullptr) {
+            return true;
+        }
+        return this->nodeStreamIdGuard->tryDisarm(microseconds);
+    }
+
+    void release() override {
+        restoreOriginalInputBlobs();
+        this->nodeStreamIdGuard.reset();
+    }
+
+    void reset() override {
+        release();
+        this->originalInputBlobs.clear();
+        Node::reset();
+    }
+
+    bool hasZeroCopyOutputs() const { return zeroCopyOutputs; }
+
+protected:
+    /**
+     * @brief Infer requests queue of model or network used by the node, nullptr if node has not acquired it
+     */
+    virtual OVInferRequestsQueue* getInferRequestsQueue() = 0;
+
+    virtual Status getRealInputName(const std::string& alias, std::string* result) const = 0;
+
+    /**
+     * @brief Name of the model used for logging and in flight memory budget of output copies
+     */
+    virtual const std::string& getInferredModelName() const = 0;
+
+    virtual size_t getInFlightMemoryBudgetBytes() const = 0;
+
+    virtual uint32_t getCompletionSpinMicroseconds() const = 0;
+
+    const std::string& getModelOutputName(const std::string& alias) const {
+        return nodeOutputNameAlias.count(alias) == 1 ? nodeOutputNameAlias.at(alias) : alias;
+    }
+
+    /**
+     * @brief Acquires stream for the node, sets input blobs and starts async inference.
+     * Requires stream id guard to be created. Node is pushed to notifyEndQueue once inference is finished or failed.
+     */
+    Status executeOnStream(NodeNotificationQueue& notifyEndQueue);
+
+    /**
+     * @brief Waits for inference started by executeOnStream and restores original input blobs of infer request
+     */
+    Status waitForInference(InferenceEngine::InferRequest*& inferRequest);
+
+    /**
+     * @brief Gets output of finished infer request, passed without copy if outputsOwner is set
+     */
+    Status fetchOutput(InferenceEngine::InferRequest& inferRequest, const std::string& realOutputName,
+        const std::shared_ptr<InferRequestOutputsOwner>& outputsOwner, InferenceEngine::Blob::Ptr& output);
+
+    /**
+     * @brief Copies infer request output passed to following nodes, copy is counted in in flight memory budget until released
+     */
+    Status copyOutput(const InferenceEngine::Blob::Ptr& blob, InferenceEngine::Blob::Ptr& copy);
+
+    /**
+     * @brief Sets back infer request own input blobs, so that blobs of previous nodes are not referenced after inference
+     */
+    void restoreOriginalInputBlobs();
+
+private:
+    Status setInputsForInference(InferenceEngine::InferRequest& inferRequest);
+    Status executeInference(NodeNotificationQueue& notifyEndQueue, InferenceEngine::InferRequest& inferRequest);
+};
+
+}  // namespace ovms
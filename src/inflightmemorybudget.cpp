@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "inflightmemorybudget.hpp"
+
+#include <utility>
+
+namespace ovms {
+
+InFlightMemoryBudget::Reservation::Reservation(Reservation&& rhs) noexcept :
+    budget(rhs.budget),
+    name(std::move(rhs.name)),
+    bytes(rhs.bytes) {
+    rhs.budget = nullptr;
+    rhs.bytes = 0;
+}
+
+InFlightMemoryBudget::Reservation& InFlightMemoryBudget::Reservation::operator=(Reservation&& rhs) noexcept {
+    if (this != &rhs) {
+        if (budget) {
+            budget->release(name, bytes);
+        }
+        budget = rhs.budget;
+        name = std::move(rhs.name);
+        bytes = rhs.bytes;
+        rhs.budget = nullptr;
+        rhs.bytes = 0;
+    }
+    return *this;
+}
+
+InFlightMemoryBudget::Reservation::~Reservation() {
+    if (budget) {
+        budget->release(name, bytes);
+    }
+}
+
+InFlightMemoryBudget& InFlightMemoryBudget::getInstance() {
+    static InFlightMemoryBudget instance;
+    return instance;
+}
+
+void InFlightMemoryBudget::configure(size_t budgetBytes) {
+    this->budgetBytes = budgetBytes;
+}
+
+std::optional<InFlightMemoryBudget::Reservation> InFlightMemoryBudget::tryReserve(const std::string& name, size_t bytes, size_t nameBudgetBytes) {
+    if (isUnlimited(nameBudgetBytes)) {
+        // nothing is limited, bytes are not counted either
+        return Reservation();
+    }
+    const size_t budgetBytes = this->budgetBytes.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mtx);
+    // compared without adding bytes, which may be saturated estimate of huge request
+    if (budgetBytes > 0 && (bytes > budgetBytes || reservedBytes > budgetBytes - bytes)) {
+        return std::nullopt;
+    }
+    auto& reservedByName = reservedBytesByName[name];
+    if (nameBudgetBytes > 0 && (bytes > nameBudgetBytes || reservedByName > nameBudgetBytes - bytes)) {
+        if (reservedByName == 0) {
+            reservedBytesByName.erase(name);
+        }
+        return std::nullopt;
+    }
+    reservedBytes += bytes;
+    reservedByName += bytes;
+    return Reservation(this, name, bytes);
+}
+
+void InFlightMemoryBudget::release(const std::string& name, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mtx);
+    reservedBytes -= bytes;
+    auto it = reservedBytesByName.find(name);
+    it->second -= bytes;
+    if (it->second == 0) {
+        reservedBytesByName.erase(it);
+    }
+}
+
+size_t InFlightMemoryBudget::getReservedBytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return reservedBytes;
+}
+
+size_t InFlightMemoryBudget::getReservedBytes(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = reservedBytesByName.find(name);
+    return it == reservedBytesByName.end() ? 0 : it->second;
+}
+
+}  // namespace ovms
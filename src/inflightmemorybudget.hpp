@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace ovms {
+
+/**
+ * @brief Bytes buffered by requests being processed, limited globally and per model, so that bursts of large
+ * requests are rejected instead of being buffered without bound.
+ *
+ * Requests reserve estimated size of their body, request and response protos when admitted, nodes of pipelines
+ * reserve size of output copies passed to next nodes. Reservations are released once memory is freed.
+ */
+class InFlightMemoryBudget {
+public:
+    /**
+     * @brief Bytes reserved in the budget, released once destroyed
+     */
+    class Reservation {
+        InFlightMemoryBudget* budget = nullptr;
+        std::string name;
+        size_t bytes = 0;
+
+        friend class InFlightMemoryBudget;
+        Reservation(InFlightMemoryBudget* budget, const std::string& name, size_t bytes) :
+            budget(budget),
+            name(name),
+            bytes(bytes) {}
+
+    public:
+        Reservation() = default;
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        Reservation(Reservation&& rhs) noexcept;
+        Reservation& operator=(Reservation&& rhs) noexcept;
+        ~Reservation();
+
+        size_t getBytes() const {
+            return bytes;
+        }
+    };
+
+    static InFlightMemoryBudget& getInstance();
+
+    InFlightMemoryBudget() = default;
+    InFlightMemoryBudget(const InFlightMemoryBudget&) = delete;
+    InFlightMemoryBudget& operator=(const InFlightMemoryBudget&) = delete;
+
+    /**
+     * @brief Sets budget shared by all models and pipelines, 0 if unlimited. Reservations already made are kept
+     */
+    void configure(size_t budgetBytes);
+
+    /**
+     * @brief Reserves bytes for model or pipeline unless global budget or budget of the name would be exceeded
+     *
+     * @param name name of model or pipeline the reservation is counted for
+     * @param nameBudgetBytes budget of the name, 0 if unlimited
+     *
+     * @return reservation or nullopt if budget would be exceeded
+     */
+    std::optional<Reservation> tryReserve(const std::string& name, size_t bytes, size_t nameBudgetBytes = 0);
+
+    /**
+     * @brief Tells whether reservations for name with given budget are not limited, so that estimating their size can be skipped
+     */
+    bool isUnlimited(size_t nameBudgetBytes = 0) const {
+        return nameBudgetBytes == 0 && budgetBytes.load(std::memory_order_relaxed) == 0;
+    }
+
+    size_t getReservedBytes() const;
+    size_t getReservedBytes(const std::string& name) const;
+
+private:
+    void release(const std::string& name, size_t bytes);
+
+    mutable std::mutex mtx;
+    std::atomic<size_t> budgetBytes{0};
+    size_t reservedBytes = 0;
+    std::unordered_map<std::string, size_t> reservedBytesByName;
+};
+
+}  // namespace ovms
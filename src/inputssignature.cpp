@@ -0,0 +1,76 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "inputssignature.hpp"
+
+namespace ovms {
+
+InputsSignature::InputsSignature(const tensor_map_t& inputsInfo, size_t batchSize, bool variableBatchSize) :
+    batchSize(static_cast<int64_t>(batchSize)),
+    variableBatchSize(variableBatchSize) {
+    inputs.reserve(inputsInfo.size());
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        Input input;
+        input.name = name;
+        input.dtype = tensorInfo->getPrecisionAsDataType();
+        input.elementSize = tensorInfo->getPrecision().size();
+        input.shape.assign(tensorInfo->getShape().begin(), tensorInfo->getShape().end());
+        inputs.push_back(std::move(input));
+    }
+}
+
+bool InputsSignature::matches(const tensorflow::serving::PredictRequest& request) const {
+    if (inputs.empty() || static_cast<size_t>(request.inputs_size()) != inputs.size()) {
+        return false;
+    }
+    for (const auto& input : inputs) {
+        auto it = request.inputs().find(input.name);
+        if (it == request.inputs().end()) {
+            return false;
+        }
+        const auto& proto = it->second;
+        if (proto.dtype() != input.dtype || input.shape.empty() ||
+            proto.tensor_shape().dim_size() != static_cast<int>(input.shape.size())) {
+            return false;
+        }
+        const int64_t requestBatchSize = proto.tensor_shape().dim(0).size();
+        if (variableBatchSize ? (requestBatchSize <= 0 || requestBatchSize > batchSize) : (requestBatchSize != batchSize || requestBatchSize != input.shape[0])) {
+            return false;
+        }
+        size_t valueCount = requestBatchSize;
+        for (size_t i = 1; i < input.shape.size(); i++) {
+            const int64_t dim = proto.tensor_shape().dim(i).size();
+            if (dim != input.shape[i]) {
+                return false;
+            }
+            valueCount *= dim;
+        }
+        // values of U16 and FP16 inputs are sent in value containers instead of tensor content
+        if (proto.dtype() == tensorflow::DataType::DT_UINT16) {
+            if (static_cast<size_t>(proto.int_val_size()) != valueCount) {
+                return false;
+            }
+        } else if (proto.dtype() == tensorflow::DataType::DT_HALF) {
+            if (static_cast<size_t>(proto.half_val_size()) != valueCount) {
+                return false;
+            }
+        } else if (proto.tensor_content().size() != valueCount * input.elementSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace ovms
@@ -0,0 +1,65 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Inputs expected by loaded network, precomputed so that valid requests are checked in a single pass
+ *
+ * Signature only recognizes requests which need neither reshape nor batch size change. Any mismatch
+ * is reported as no match, such requests go through detailed validation which reports the reason.
+ */
+class InputsSignature {
+    struct Input {
+        std::string name;
+        tensorflow::DataType dtype;
+        size_t elementSize;
+        std::vector<int64_t> shape;
+    };
+
+    std::vector<Input> inputs;
+    int64_t batchSize = 0;
+    bool variableBatchSize = false;
+
+public:
+    InputsSignature() = default;
+
+    /**
+     * @param inputsInfo inputs of loaded network
+     * @param batchSize batch size of loaded network
+     * @param variableBatchSize if set, requests with batch size from 1 up to batchSize match, as merged by batching scheduler
+     */
+    InputsSignature(const tensor_map_t& inputsInfo, size_t batchSize, bool variableBatchSize);
+
+    /**
+     * @brief Checks whether request has exactly the inputs of network with matching precision, shape and content size
+     */
+    bool matches(const tensorflow::serving::PredictRequest& request) const;
+};
+
+}  // namespace ovms
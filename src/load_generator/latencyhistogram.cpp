@@ -0,0 +1,102 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "latencyhistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace ovms {
+
+LatencyHistogram::LatencyHistogram() :
+    counts(getIndex(UINT64_MAX) + 1, 0) {}
+
+size_t LatencyHistogram::getIndex(uint64_t value) {
+    // values below SUB_BUCKET_COUNT are counted exactly, each next bucket doubles sub bucket width
+    const int bucketIndex = 63 - __builtin_clzll(value | SUB_BUCKET_MASK) - (SUB_BUCKET_BITS - 1);
+    const uint64_t subBucketIndex = value >> bucketIndex;
+    return bucketIndex * SUB_BUCKET_HALF_COUNT + subBucketIndex;
+}
+
+uint64_t LatencyHistogram::getHighestEquivalentValue(size_t index) {
+    int bucketIndex = 0;
+    uint64_t subBucketIndex = index;
+    if (index >= SUB_BUCKET_COUNT) {
+        bucketIndex = static_cast<int>((index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF_COUNT) + 1;
+        subBucketIndex = index - bucketIndex * SUB_BUCKET_HALF_COUNT;
+    }
+    const uint64_t lowest = subBucketIndex << bucketIndex;
+    return lowest + ((1ull << bucketIndex) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[getIndex(value)]++;
+    totalCount++;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    const double boundedPercentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t countAtPercentile = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(boundedPercentile / 100 * totalCount)));
+    uint64_t runningCount = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        runningCount += counts[i];
+        if (runningCount >= countAtPercentile) {
+            return std::min(getHighestEquivalentValue(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+void LatencyHistogram::printPercentileDistribution(std::ostream& out, double valueScale) const {
+    out << std::setw(12) << "Value" << std::setw(15) << "Percentile" << std::setw(11) << "TotalCount" << std::setw(17) << "1/(1-Percentile)"
+        << "\n\n";
+    out << std::fixed;
+    uint64_t runningCount = 0;
+    for (size_t i = 0; i < counts.size() && runningCount < totalCount; i++) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        runningCount += counts[i];
+        const double percentile = static_cast<double>(runningCount) / totalCount;
+        out << std::setw(12) << std::setprecision(3) << std::min(getHighestEquivalentValue(i), maxValue) / valueScale
+            << std::setw(15) << std::setprecision(12) << percentile
+            << std::setw(11) << runningCount;
+        if (runningCount < totalCount) {
+            out << std::setw(15) << std::setprecision(2) << 1 / (1 - percentile);
+        }
+        out << "\n";
+    }
+    out << "#[Mean    = " << std::setprecision(3) << getMean() / valueScale << ", Max     = " << getMax() / valueScale << "]\n";
+    out << "#[Total count    = " << totalCount << "]\n";
+}
+
+}  // namespace ovms
@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Histogram of latencies with bounded relative error, in the layout of HdrHistogram
+ *
+ * Values are counted in buckets covering powers of two split into linear sub buckets, so that each
+ * recorded value is represented with relative error below 1 / 2^(SUB_BUCKET_BITS - 1).
+ * Recording does not allocate and is not synchronized, each thread is expected to use its own histogram.
+ */
+class LatencyHistogram {
+    static const int SUB_BUCKET_BITS = 8;
+    static const uint64_t SUB_BUCKET_COUNT = 1ull << SUB_BUCKET_BITS;
+    static const uint64_t SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2;
+    static const uint64_t SUB_BUCKET_MASK = SUB_BUCKET_COUNT - 1;
+
+    std::vector<uint64_t> counts;
+    uint64_t totalCount = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+    double sum = 0;
+
+    static size_t getIndex(uint64_t value);
+    static uint64_t getHighestEquivalentValue(size_t index);
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t value);
+
+    void merge(const LatencyHistogram& other);
+
+    uint64_t getCount() const { return totalCount; }
+    uint64_t getMin() const { return totalCount ? minValue : 0; }
+    uint64_t getMax() const { return maxValue; }
+    double getMean() const { return totalCount ? sum / static_cast<double>(totalCount) : 0; }
+
+    /**
+     * @brief Gets value which given percent of recorded values are less or equal to
+     *
+     * @param percentile from 0 to 100
+     */
+    uint64_t getValueAtPercentile(double percentile) const;
+
+    /**
+     * @brief Writes percentile distribution in HdrHistogram text format, readable by its plotting tools
+     *
+     * @param valueScale recorded values are divided by it, e.g. 1000 to report microseconds in milliseconds
+     */
+    void printPercentileDistribution(std::ostream& out, double valueScale) const;
+};
+
+}  // namespace ovms
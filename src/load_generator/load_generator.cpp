@@ -0,0 +1,1102 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cxxopts.hpp>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "../npyfile.hpp"
+#include "../tensorinfo.hpp"
+#include "../trafficcapture.hpp"
+#include "latencyhistogram.hpp"
+#include "soakstats.hpp"
+
+using std::chrono::steady_clock;
+
+namespace ovms {
+namespace {
+
+using InputSet = std::vector<std::pair<std::string, NpyArray>>;
+
+struct LoadOptions {
+    std::string protocol;
+    std::string address;
+    uint64_t port;
+    std::string modelName;
+    int64_t modelVersion;
+    InputSet inputs;
+    // Requests with different inputs sent in turns, k-th of them uses k-th file passed for each input name
+    std::vector<InputSet> inputVariants;
+    bool restBinary;
+    uint64_t concurrency;
+    double rate;
+    double durationSeconds;
+    double warmupSeconds;
+    std::string histogramPath;
+    std::string replayPath;
+    double replaySpeed;
+    // Long running load, reporting each interval and changing served models meanwhile
+    double reportIntervalSeconds;
+    std::string reportPath;
+    pid_t serverPid;
+    uint64_t heapStatsPort;
+    std::string configPath;
+    std::vector<std::string> configVariants;
+    double reloadIntervalSeconds;
+    std::string modelBasePath;
+    double versionBumpIntervalSeconds;
+};
+
+/**
+ * @brief Client sending the same predict requests repeatedly over single connection
+ */
+class PredictClient {
+public:
+    virtual ~PredictClient() = default;
+    virtual bool predict() = 0;
+};
+
+void fillPredictRequest(const LoadOptions& options, const InputSet& inputs, tensorflow::serving::PredictRequest& request) {
+    request.mutable_model_spec()->set_name(options.modelName);
+    if (options.modelVersion > 0) {
+        request.mutable_model_spec()->mutable_version()->set_value(options.modelVersion);
+    }
+    for (const auto& [name, array] : inputs) {
+        auto& proto = (*request.mutable_inputs())[name];
+        proto.set_dtype(TensorInfo::getPrecisionAsDataType(array.precision));
+        for (auto dim : array.shape) {
+            proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+        }
+        if (array.precision == InferenceEngine::Precision::FP16 || array.precision == InferenceEngine::Precision::U16) {
+            // values of these precisions are sent in 32 bit containers
+            const uint16_t* values = reinterpret_cast<const uint16_t*>(array.data.data());
+            const size_t count = array.data.size() / sizeof(uint16_t);
+            for (size_t i = 0; i < count; i++) {
+                if (array.precision == InferenceEngine::Precision::FP16) {
+                    proto.add_half_val(values[i]);
+                } else {
+                    proto.add_int_val(values[i]);
+                }
+            }
+        } else {
+            proto.set_tensor_content(array.data.data(), array.data.size());
+        }
+    }
+}
+
+class GrpcPredictClient : public PredictClient {
+    std::unique_ptr<tensorflow::serving::PredictionService::Stub> stub;
+    std::vector<tensorflow::serving::PredictRequest> requests;
+    size_t nextRequest = 0;
+
+public:
+    GrpcPredictClient(const LoadOptions& options, int clientId) {
+        grpc::ChannelArguments arguments;
+        // distinct arguments prevent channels from sharing the same connection
+        arguments.SetInt("ovms.load_generator.client_id", clientId);
+        arguments.SetMaxReceiveMessageSize(-1);
+        auto channel = grpc::CreateCustomChannel(options.address + ":" + std::to_string(options.port), grpc::InsecureChannelCredentials(), arguments);
+        stub = tensorflow::serving::PredictionService::NewStub(channel);
+        requests.resize(options.inputVariants.size());
+        for (size_t i = 0; i < requests.size(); i++) {
+            fillPredictRequest(options, options.inputVariants[i], requests[i]);
+        }
+    }
+
+    bool predict() override {
+        if (requests.empty()) {
+            return false;
+        }
+        return send(requests[nextRequest++ % requests.size()]);
+    }
+
+    bool send(const tensorflow::serving::PredictRequest& predictRequest) {
+        grpc::ClientContext context;
+        tensorflow::serving::PredictResponse response;
+        auto status = stub->Predict(&context, predictRequest, &response);
+        if (!status.ok()) {
+            std::cerr << "Predict failed: " << status.error_message() << std::endl;
+        }
+        return status.ok();
+    }
+};
+
+template <typename T>
+void writeJsonValues(std::ostream& out, const T* values, const shape_t& shape, size_t dim, size_t& offset) {
+    out << "[";
+    for (size_t i = 0; i < shape[dim]; i++) {
+        if (i > 0) {
+            out << ",";
+        }
+        if (dim + 1 < shape.size()) {
+            writeJsonValues(out, values, shape, dim + 1, offset);
+        } else {
+            out << +values[offset++];
+        }
+    }
+    out << "]";
+}
+
+bool writeJsonInput(std::ostream& out, const NpyArray& array) {
+    size_t offset = 0;
+    if (array.shape.empty()) {
+        return false;
+    }
+    switch (array.precision) {
+    case InferenceEngine::Precision::FP32:
+        out << std::setprecision(9);
+        writeJsonValues(out, reinterpret_cast<const float*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    case InferenceEngine::Precision::I8:
+        writeJsonValues(out, reinterpret_cast<const int8_t*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    case InferenceEngine::Precision::U8:
+        writeJsonValues(out, reinterpret_cast<const uint8_t*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    case InferenceEngine::Precision::I16:
+        writeJsonValues(out, reinterpret_cast<const int16_t*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    case InferenceEngine::Precision::U16:
+        writeJsonValues(out, reinterpret_cast<const uint16_t*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    case InferenceEngine::Precision::I32:
+        writeJsonValues(out, reinterpret_cast<const int32_t*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    case InferenceEngine::Precision::I64:
+        writeJsonValues(out, reinterpret_cast<const int64_t*>(array.data.data()), array.shape, 0, offset);
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief HTTP/1.1 client keeping connection alive between requests
+ */
+class RestPredictClient : public PredictClient {
+    const LoadOptions& options;
+    std::vector<std::string> httpRequests;
+    size_t nextRequest = 0;
+    int socketFd = -1;
+    std::string buffer;
+
+    bool connectToServer() {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(options.address.c_str(), std::to_string(options.port).c_str(), &hints, &addresses) != 0) {
+            std::cerr << "Could not resolve address: " << options.address << std::endl;
+            return false;
+        }
+        for (addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+            socketFd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (socketFd < 0) {
+                continue;
+            }
+            if (connect(socketFd, address->ai_addr, address->ai_addrlen) == 0) {
+                break;
+            }
+            close(socketFd);
+            socketFd = -1;
+        }
+        freeaddrinfo(addresses);
+        if (socketFd < 0) {
+            std::cerr << "Could not connect to " << options.address << ":" << options.port << std::endl;
+            return false;
+        }
+        int noDelay = 1;
+        setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return true;
+    }
+
+    void disconnect() {
+        if (socketFd >= 0) {
+            close(socketFd);
+            socketFd = -1;
+        }
+        buffer.clear();
+    }
+
+    bool readMore() {
+        char chunk[64 * 1024];
+        ssize_t received = recv(socketFd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer.append(chunk, received);
+        return true;
+    }
+
+    bool readUntil(const char* delimiter, size_t from, size_t& position) {
+        while ((position = buffer.find(delimiter, from)) == std::string::npos) {
+            if (!readMore()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool readAtLeast(size_t size) {
+        while (buffer.size() < size) {
+            if (!readMore()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads response with Content-Length or chunked body, leaves data of next response in buffer
+     */
+    bool readResponse(int& statusCode, std::string* body) {
+        size_t headerEnd;
+        if (!readUntil("\r\n\r\n", 0, headerEnd)) {
+            return false;
+        }
+        std::string headers = buffer.substr(0, headerEnd);
+        size_t bodyStart = headerEnd + 4;
+        if (sscanf(headers.c_str(), "HTTP/1.%*d %d", &statusCode) != 1) {
+            return false;
+        }
+        std::transform(headers.begin(), headers.end(), headers.begin(), ::tolower);
+        auto contentLength = headers.find("\r\ncontent-length:");
+        if (contentLength != std::string::npos) {
+            size_t length = std::stoull(headers.substr(contentLength + strlen("\r\ncontent-length:")));
+            if (!readAtLeast(bodyStart + length)) {
+                return false;
+            }
+            if (body != nullptr) {
+                body->assign(buffer, bodyStart, length);
+            }
+            buffer.erase(0, bodyStart + length);
+            return true;
+        }
+        if (headers.find("\r\ntransfer-encoding: chunked") == std::string::npos) {
+            return false;
+        }
+        size_t position = bodyStart;
+        if (body != nullptr) {
+            body->clear();
+        }
+        while (true) {
+            size_t sizeEnd;
+            if (!readUntil("\r\n", position, sizeEnd)) {
+                return false;
+            }
+            const size_t chunkSize = std::stoull(buffer.substr(position, sizeEnd - position), nullptr, 16);
+            position = sizeEnd + 2 + chunkSize + 2;
+            if (!readAtLeast(position)) {
+                return false;
+            }
+            if (body != nullptr) {
+                body->append(buffer, sizeEnd + 2, chunkSize);
+            }
+            if (chunkSize == 0) {
+                buffer.erase(0, position);
+                return true;
+            }
+        }
+    }
+
+public:
+    RestPredictClient(const LoadOptions& options, const std::vector<std::string>& httpRequests) :
+        options(options),
+        httpRequests(httpRequests) {}
+
+    ~RestPredictClient() override {
+        disconnect();
+    }
+
+    bool predict() override {
+        if (httpRequests.empty()) {
+            return false;
+        }
+        return send(httpRequests[nextRequest++ % httpRequests.size()]);
+    }
+
+    /**
+     * @brief Sends request and reads its response, body of successful response is stored if requested
+     */
+    bool send(const std::string& request, std::string* body = nullptr) {
+        if (socketFd < 0 && !connectToServer()) {
+            return false;
+        }
+        size_t sent = 0;
+        while (sent < request.size()) {
+            ssize_t result = ::send(socketFd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (result <= 0) {
+                std::cerr << "Failed to send request" << std::endl;
+                disconnect();
+                return false;
+            }
+            sent += result;
+        }
+        int statusCode = 0;
+        if (!readResponse(statusCode, body)) {
+            std::cerr << "Failed to read response" << std::endl;
+            disconnect();
+            return false;
+        }
+        if (statusCode != 200) {
+            std::cerr << "Predict failed with HTTP status: " << statusCode << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+std::string buildHttpRequest(const LoadOptions& options, const std::string& path, const std::string& extraHeaders, const std::string& content) {
+    return "POST " + path + " HTTP/1.1\r\n" +
+           "Host: " + options.address + ":" + std::to_string(options.port) + "\r\n" +
+           "Content-Type: application/json\r\n" +
+           extraHeaders +
+           "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n" +
+           content;
+}
+
+std::string buildHttpGetRequest(const LoadOptions& options, const std::string& path) {
+    return "GET " + path + " HTTP/1.1\r\n" +
+           "Host: " + options.address + ":" + std::to_string(options.port) + "\r\n\r\n";
+}
+
+bool buildRestRequest(const LoadOptions& options, const InputSet& inputs, std::string& httpRequest) {
+    std::string path = "/v1/models/" + options.modelName;
+    if (options.modelVersion > 0) {
+        path += "/versions/" + std::to_string(options.modelVersion);
+    }
+    path += ":predict";
+    std::stringstream body;
+    std::string extraHeaders;
+    if (options.restBinary) {
+        body << "{\"inputs\":[";
+        for (size_t i = 0; i < inputs.size(); i++) {
+            const auto& [name, array] = inputs[i];
+            body << (i > 0 ? "," : "") << "{\"name\":\"" << name << "\",\"datatype\":\"" << TensorInfo::getPrecisionAsString(array.precision) << "\",\"shape\":[";
+            for (size_t d = 0; d < array.shape.size(); d++) {
+                body << (d > 0 ? "," : "") << array.shape[d];
+            }
+            body << "]}";
+        }
+        body << "]}";
+        extraHeaders = "Inference-Header-Content-Length: " + std::to_string(body.tellp()) + "\r\n";
+        for (const auto& [name, array] : inputs) {
+            body.write(array.data.data(), array.data.size());
+        }
+    } else {
+        body << "{\"inputs\":{";
+        for (size_t i = 0; i < inputs.size(); i++) {
+            const auto& [name, array] = inputs[i];
+            body << (i > 0 ? "," : "") << "\"" << name << "\":";
+            if (!writeJsonInput(body, array)) {
+                std::cerr << "Input " << name << " cannot be sent as JSON, use --rest_binary" << std::endl;
+                return false;
+            }
+        }
+        body << "}}";
+    }
+    httpRequest = buildHttpRequest(options, path, extraHeaders, body.str());
+    return true;
+}
+
+struct WorkerResult {
+    LatencyHistogram histogram;
+    uint64_t errors = 0;
+    // Results since last periodic report, taken by monitoring thread
+    bool reportIntervals = false;
+    std::mutex intervalMutex;
+    LatencyHistogram intervalHistogram;
+    uint64_t intervalErrors = 0;
+};
+
+/**
+ * @brief Sends requests until end of the run, either back to back or at fixed pace
+ *
+ * With fixed pace latency is measured from the time request was scheduled at, so that delays
+ * caused by previous slow responses are not hidden from results.
+ */
+void runWorker(PredictClient& client, double rate, steady_clock::time_point start, steady_clock::time_point measureFrom, steady_clock::time_point end, WorkerResult& result) {
+    const auto interval = rate > 0 ? std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(1.0 / rate)) : steady_clock::duration::zero();
+    auto scheduled = start;
+    while (true) {
+        auto now = steady_clock::now();
+        if (rate > 0) {
+            if (scheduled > now) {
+                std::this_thread::sleep_until(scheduled);
+            }
+        } else {
+            scheduled = now;
+        }
+        if (scheduled >= end) {
+            return;
+        }
+        const bool ok = client.predict();
+        const auto finished = steady_clock::now();
+        if (scheduled >= measureFrom) {
+            const uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(finished - scheduled).count();
+            if (ok) {
+                result.histogram.record(latency);
+            } else {
+                result.errors++;
+            }
+            if (result.reportIntervals) {
+                std::lock_guard<std::mutex> lock(result.intervalMutex);
+                if (ok) {
+                    result.intervalHistogram.record(latency);
+                } else {
+                    result.intervalErrors++;
+                }
+            }
+        }
+        scheduled += interval;
+    }
+}
+
+double toMegabytes(uint64_t bytes) {
+    return static_cast<double>(bytes) / (1024 * 1024);
+}
+
+/**
+ * @brief Reports results of each interval of long running load with resources of the server, changes served models meanwhile
+ *
+ * Configuration reload replaces config file with its next variant, or rewrites it with the same content if there are none,
+ * so that server reloads it. Version bump copies the latest version directory of a model as the next version and removes
+ * older ones, so that server loads the new version and unloads the previous one. Once load finishes, differences between
+ * the first and the last interval are reported, showing leaks and slow degradation.
+ */
+class SoakMonitor {
+    struct Sample {
+        double p99Milliseconds = 0;
+        std::optional<ProcessStats> process;
+        std::optional<HeapStats> heap;
+    };
+
+    const LoadOptions& options;
+    std::vector<WorkerResult>& results;
+    LoadOptions statsOptions;
+    std::unique_ptr<RestPredictClient> statsClient;
+    std::ofstream reportFile;
+    uint64_t reloads = 0;
+    int64_t version = 0;
+    size_t nextConfigVariant = 0;
+    std::optional<Sample> firstSample;
+    Sample lastSample;
+
+public:
+    SoakMonitor(const LoadOptions& options, std::vector<WorkerResult>& results) :
+        options(options),
+        results(results),
+        statsOptions(options) {
+        if (options.heapStatsPort > 0) {
+            statsOptions.port = options.heapStatsPort;
+            statsClient = std::make_unique<RestPredictClient>(statsOptions, std::vector<std::string>());
+        }
+        for (auto& result : results) {
+            result.reportIntervals = options.reportIntervalSeconds > 0;
+        }
+    }
+
+    static bool isEnabled(const LoadOptions& options) {
+        return options.reportIntervalSeconds > 0 || options.reloadIntervalSeconds > 0 || options.versionBumpIntervalSeconds > 0;
+    }
+
+    bool open() {
+        if (options.reportPath.empty()) {
+            return true;
+        }
+        reportFile.open(options.reportPath);
+        reportFile << "elapsed_s,requests,errors,throughput,p50_ms,p99_ms,max_ms,rss_mb,peak_rss_mb,threads,open_files,heap_allocated_mb,heap_mb,config_reloads,model_version" << std::endl;
+        if (!reportFile) {
+            std::cerr << "Could not write report to " << options.reportPath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void run(steady_clock::time_point measureFrom, steady_clock::time_point end) {
+        auto period = [](double seconds) {
+            return std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(seconds));
+        };
+        auto first = [measureFrom, &period](double seconds) {
+            return seconds > 0 ? measureFrom + period(seconds) : steady_clock::time_point::max();
+        };
+        auto nextReport = first(options.reportIntervalSeconds);
+        auto nextReload = first(options.reloadIntervalSeconds);
+        auto nextBump = first(options.versionBumpIntervalSeconds);
+        auto lastReport = measureFrom;
+        while (true) {
+            std::this_thread::sleep_until(std::min({end, nextReport, nextReload, nextBump}));
+            const auto now = steady_clock::now();
+            if (now >= nextReload && now < end) {
+                reloadConfig();
+                nextReload += period(options.reloadIntervalSeconds);
+            }
+            if (now >= nextBump && now < end) {
+                bumpVersion();
+                nextBump += period(options.versionBumpIntervalSeconds);
+            }
+            if (options.reportIntervalSeconds > 0 && (now >= nextReport || now >= end)) {
+                reportInterval(std::chrono::duration<double>(now - measureFrom).count(), std::chrono::duration<double>(now - lastReport).count());
+                lastReport = now;
+                nextReport += period(options.reportIntervalSeconds);
+            }
+            if (now >= end) {
+                break;
+            }
+        }
+        reportDrift();
+    }
+
+private:
+    void reportInterval(double elapsedSeconds, double intervalSeconds) {
+        LatencyHistogram histogram;
+        uint64_t errors = 0;
+        for (auto& result : results) {
+            std::lock_guard<std::mutex> lock(result.intervalMutex);
+            histogram.merge(result.intervalHistogram);
+            errors += result.intervalErrors;
+            result.intervalHistogram = LatencyHistogram();
+            result.intervalErrors = 0;
+        }
+        Sample sample;
+        sample.p99Milliseconds = static_cast<double>(histogram.getValueAtPercentile(99)) / 1000;
+        ProcessStats process;
+        if (options.serverPid > 0 && readProcessStats(options.serverPid, process)) {
+            sample.process = process;
+        }
+        std::string heapStatistics;
+        HeapStats heap;
+        // idle connection may have been closed by server since last interval, then it is sent again over new one
+        const std::string heapRequest = buildHttpGetRequest(statsOptions, "/debug/pprof/heap");
+        if (statsClient && (statsClient->send(heapRequest, &heapStatistics) || statsClient->send(heapRequest, &heapStatistics)) && parseHeapStatistics(heapStatistics, heap)) {
+            sample.heap = heap;
+        }
+        std::stringstream line;
+        line << std::fixed << std::setprecision(3)
+             << elapsedSeconds << "," << histogram.getCount() << "," << errors << ","
+             << (intervalSeconds > 0 ? static_cast<double>(histogram.getCount()) / intervalSeconds : 0) << ","
+             << static_cast<double>(histogram.getValueAtPercentile(50)) / 1000 << ","
+             << sample.p99Milliseconds << ","
+             << static_cast<double>(histogram.getMax()) / 1000 << ",";
+        if (sample.process) {
+            line << toMegabytes(sample.process->rssBytes) << "," << toMegabytes(sample.process->peakRssBytes) << ","
+                 << sample.process->threads << "," << sample.process->openFiles << ",";
+        } else {
+            line << ",,,,";
+        }
+        if (sample.heap) {
+            line << toMegabytes(sample.heap->allocatedBytes) << "," << toMegabytes(sample.heap->heapBytes) << ",";
+        } else {
+            line << ",,";
+        }
+        line << reloads << "," << version;
+        std::cout << "Interval: " << line.str() << std::endl;
+        if (reportFile.is_open()) {
+            reportFile << line.str() << std::endl;
+        }
+        if (!firstSample) {
+            firstSample = sample;
+        }
+        lastSample = sample;
+    }
+
+    void reloadConfig() {
+        std::string content;
+        const std::string& source = options.configVariants.empty() ? options.configPath : options.configVariants[nextConfigVariant++ % options.configVariants.size()];
+        std::ifstream sourceFile(source, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(sourceFile), std::istreambuf_iterator<char>());
+        if (!sourceFile) {
+            std::cerr << "Could not read config " << source << std::endl;
+            return;
+        }
+        // replaced at once, so that server never reads partially written file
+        const std::string temporaryPath = options.configPath + ".tmp";
+        std::ofstream(temporaryPath, std::ios::binary) << content;
+        if (std::rename(temporaryPath.c_str(), options.configPath.c_str()) != 0) {
+            std::cerr << "Could not replace config " << options.configPath << std::endl;
+            return;
+        }
+        reloads++;
+    }
+
+    void bumpVersion() {
+        namespace fs = std::filesystem;
+        std::error_code error;
+        std::vector<int64_t> versions;
+        for (const auto& entry : fs::directory_iterator(options.modelBasePath, error)) {
+            const auto name = entry.path().filename().string();
+            if (entry.is_directory() && !name.empty() && std::all_of(name.begin(), name.end(), ::isdigit)) {
+                versions.push_back(std::stoll(name));
+            }
+        }
+        if (error || versions.empty()) {
+            std::cerr << "No version directories found in " << options.modelBasePath << std::endl;
+            return;
+        }
+        std::sort(versions.begin(), versions.end());
+        const int64_t latest = versions.back();
+        const fs::path base(options.modelBasePath);
+        // copied under name which is not a version, so that server does not load it partially copied
+        const auto staging = base / ("." + std::to_string(latest + 1) + ".tmp");
+        fs::remove_all(staging, error);
+        fs::copy(base / std::to_string(latest), staging, fs::copy_options::recursive, error);
+        if (!error) {
+            fs::rename(staging, base / std::to_string(latest + 1), error);
+        }
+        if (error) {
+            std::cerr << "Could not copy version " << latest << " of " << options.modelBasePath << ": " << error.message() << std::endl;
+            return;
+        }
+        versions.pop_back();
+        for (auto old : versions) {
+            fs::remove_all(base / std::to_string(old), error);
+        }
+        version = latest + 1;
+    }
+
+    void reportDrift() {
+        if (!firstSample) {
+            return;
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << "Drift from first to last interval - p99 [ms]: " << firstSample->p99Milliseconds << " -> " << lastSample.p99Milliseconds;
+        if (firstSample->process && lastSample.process) {
+            std::cout << ", RSS [MB]: " << toMegabytes(firstSample->process->rssBytes) << " -> " << toMegabytes(lastSample.process->rssBytes)
+                      << ", threads: " << firstSample->process->threads << " -> " << lastSample.process->threads
+                      << ", open files: " << firstSample->process->openFiles << " -> " << lastSample.process->openFiles;
+        }
+        if (firstSample->heap && lastSample.heap) {
+            std::cout << ", heap allocated [MB]: " << toMegabytes(firstSample->heap->allocatedBytes) << " -> " << toMegabytes(lastSample.heap->allocatedBytes)
+                      << ", heap [MB]: " << toMegabytes(firstSample->heap->heapBytes) << " -> " << toMegabytes(lastSample.heap->heapBytes);
+        }
+        std::cout << std::endl;
+    }
+};
+
+int report(const LoadOptions& options, const std::vector<WorkerResult>& results, double elapsedSeconds) {
+    LatencyHistogram histogram;
+    uint64_t errors = 0;
+    for (const auto& result : results) {
+        histogram.merge(result.histogram);
+        errors += result.errors;
+    }
+    auto toMilliseconds = [](uint64_t microseconds) { return static_cast<double>(microseconds) / 1000; };
+    std::cout << std::fixed << std::setprecision(3)
+              << "Requests: " << histogram.getCount() << ", errors: " << errors << ", duration: " << elapsedSeconds << " s\n"
+              << "Throughput: " << static_cast<double>(histogram.getCount()) / elapsedSeconds << " requests/s\n"
+              << "Latency [ms] mean: " << histogram.getMean() / 1000
+              << ", p50: " << toMilliseconds(histogram.getValueAtPercentile(50))
+              << ", p90: " << toMilliseconds(histogram.getValueAtPercentile(90))
+              << ", p99: " << toMilliseconds(histogram.getValueAtPercentile(99))
+              << ", p999: " << toMilliseconds(histogram.getValueAtPercentile(99.9))
+              << ", max: " << toMilliseconds(histogram.getMax()) << std::endl;
+    if (!options.histogramPath.empty()) {
+        std::ofstream file(options.histogramPath);
+        histogram.printPercentileDistribution(file, 1000);
+        if (!file) {
+            std::cerr << "Could not write histogram to " << options.histogramPath << std::endl;
+            return 1;
+        }
+    }
+    return errors > 0 ? 2 : 0;
+}
+
+int run(const LoadOptions& options) {
+    std::vector<std::string> httpRequests;
+    if (options.protocol == "rest") {
+        for (const auto& inputs : options.inputVariants) {
+            httpRequests.emplace_back();
+            if (!buildRestRequest(options, inputs, httpRequests.back())) {
+                return 1;
+            }
+        }
+    }
+    std::vector<std::unique_ptr<PredictClient>> clients;
+    for (uint64_t i = 0; i < options.concurrency; i++) {
+        if (options.protocol == "grpc") {
+            clients.push_back(std::make_unique<GrpcPredictClient>(options, i));
+        } else {
+            clients.push_back(std::make_unique<RestPredictClient>(options, httpRequests));
+        }
+    }
+    std::vector<WorkerResult> results(options.concurrency);
+    std::optional<SoakMonitor> monitor;
+    if (SoakMonitor::isEnabled(options)) {
+        monitor.emplace(options, results);
+        if (!monitor->open()) {
+            return 1;
+        }
+    }
+    std::vector<std::thread> workers;
+    const auto start = steady_clock::now();
+    const auto measureFrom = start + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(options.warmupSeconds));
+    const auto end = measureFrom + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(options.durationSeconds));
+    const double workerRate = options.rate / static_cast<double>(options.concurrency);
+    for (uint64_t i = 0; i < options.concurrency; i++) {
+        // paced workers are spread evenly so that requests are not sent in bursts
+        auto workerStart = start;
+        if (workerRate > 0) {
+            workerStart += std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(static_cast<double>(i) / options.rate));
+        }
+        workers.emplace_back(runWorker, std::ref(*clients[i]), workerRate, workerStart, measureFrom, end, std::ref(results[i]));
+    }
+    if (monitor) {
+        monitor->run(measureFrom, end);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double elapsedSeconds = std::chrono::duration<double>(steady_clock::now() - measureFrom).count();
+    return report(options, results, elapsedSeconds);
+}
+
+/**
+ * @brief Captured request prepared for sending, decoded before replay starts
+ */
+struct ReplayRequest {
+    steady_clock::duration offset;
+    tensorflow::serving::PredictRequest grpcRequest;
+    std::string httpRequest;
+};
+
+bool loadReplayRequests(const LoadOptions& options, std::vector<ReplayRequest>& replayRequests) {
+    std::vector<CapturedRequest> captured;
+    auto status = readCaptureFile(options.replayPath, captured);
+    if (!status.ok()) {
+        std::cerr << "Could not read " << options.replayPath << ": " << status.string() << std::endl;
+        return false;
+    }
+    const auto protocol = options.protocol == "grpc" ? CapturedProtocol::GRPC : CapturedProtocol::REST;
+    size_t skipped = 0;
+    for (const auto& request : captured) {
+        // requests of the other API are received on different port, so they are not replayed
+        if (request.protocol != protocol) {
+            skipped++;
+            continue;
+        }
+        ReplayRequest replayRequest;
+        replayRequest.offset = std::chrono::duration_cast<steady_clock::duration>(
+            std::chrono::duration<double, std::micro>(static_cast<double>(request.offsetMicroseconds) / options.replaySpeed));
+        if (protocol == CapturedProtocol::GRPC) {
+            if (!replayRequest.grpcRequest.ParseFromString(request.body)) {
+                std::cerr << "Could not parse captured gRPC request" << std::endl;
+                return false;
+            }
+        } else {
+            const std::string extraHeaders = request.inferenceHeaderContentLength.empty() ? "" : "Inference-Header-Content-Length: " + request.inferenceHeaderContentLength + "\r\n";
+            replayRequest.httpRequest = buildHttpRequest(options, request.path, extraHeaders, request.body);
+        }
+        replayRequests.push_back(std::move(replayRequest));
+    }
+    if (skipped > 0) {
+        std::cout << "Skipped " << skipped << " captured requests not sent with " << options.protocol << " protocol" << std::endl;
+    }
+    if (replayRequests.empty()) {
+        std::cerr << "No " << options.protocol << " requests captured in " << options.replayPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sends captured requests taken in order at their recorded arrival times
+ *
+ * Latency is measured from recorded arrival time, so that requests delayed by busy workers are reported as slow.
+ */
+template <typename Client>
+void runReplayWorker(Client& client, const std::vector<ReplayRequest>& requests, std::atomic<size_t>& next, steady_clock::time_point start, steady_clock::duration warmup, WorkerResult& result) {
+    size_t index;
+    while ((index = next.fetch_add(1)) < requests.size()) {
+        const auto& request = requests[index];
+        const auto scheduled = start + request.offset;
+        std::this_thread::sleep_until(scheduled);
+        bool ok;
+        if constexpr (std::is_same_v<Client, GrpcPredictClient>) {
+            ok = client.send(request.grpcRequest);
+        } else {
+            ok = client.send(request.httpRequest);
+        }
+        const auto finished = steady_clock::now();
+        if (request.offset >= warmup) {
+            if (ok) {
+                result.histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(finished - scheduled).count());
+            } else {
+                result.errors++;
+            }
+        }
+    }
+}
+
+int replay(const LoadOptions& options) {
+    std::vector<ReplayRequest> requests;
+    if (!loadReplayRequests(options, requests)) {
+        return 1;
+    }
+    std::vector<std::unique_ptr<GrpcPredictClient>> grpcClients;
+    std::vector<std::unique_ptr<RestPredictClient>> restClients;
+    for (uint64_t i = 0; i < options.concurrency; i++) {
+        if (options.protocol == "grpc") {
+            grpcClients.push_back(std::make_unique<GrpcPredictClient>(options, i));
+        } else {
+            restClients.push_back(std::make_unique<RestPredictClient>(options, std::vector<std::string>()));
+        }
+    }
+    std::vector<WorkerResult> results(options.concurrency);
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next{0};
+    const auto start = steady_clock::now();
+    const auto warmup = std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(options.warmupSeconds));
+    for (uint64_t i = 0; i < options.concurrency; i++) {
+        if (options.protocol == "grpc") {
+            workers.emplace_back(runReplayWorker<GrpcPredictClient>, std::ref(*grpcClients[i]), std::cref(requests), std::ref(next), start, warmup, std::ref(results[i]));
+        } else {
+            workers.emplace_back(runReplayWorker<RestPredictClient>, std::ref(*restClients[i]), std::cref(requests), std::ref(next), start, warmup, std::ref(results[i]));
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double elapsedSeconds = std::max(0.0, std::chrono::duration<double>(steady_clock::now() - (start + warmup)).count());
+    return report(options, results, elapsedSeconds);
+}
+
+bool parseOptions(int argc, char** argv, LoadOptions& options) {
+    cxxopts::Options parser(argv[0], "Load generator for OpenVINO Model Server predict API");
+    // clang-format off
+    parser.add_options()
+        ("h, help",
+            "show this help message and exit")
+        ("protocol",
+            "grpc or rest",
+            cxxopts::value<std::string>()->default_value("grpc"), "PROTOCOL")
+        ("address",
+            "server address",
+            cxxopts::value<std::string>()->default_value("localhost"), "ADDRESS")
+        ("port",
+            "gRPC or REST port of the server",
+            cxxopts::value<uint64_t>()->default_value("9178"), "PORT")
+        ("model_name",
+            "name of model or pipeline",
+            cxxopts::value<std::string>(), "MODEL_NAME")
+        ("model_version",
+            "model version, 0 for default version",
+            cxxopts::value<int64_t>()->default_value("0"), "MODEL_VERSION")
+        ("input",
+            "input name and .npy file with its data, may be repeated",
+            cxxopts::value<std::vector<std::string>>(), "NAME=PATH")
+        ("rest_binary",
+            "send REST inputs as binary data after JSON header instead of JSON arrays")
+        ("concurrency",
+            "number of connections sending requests in parallel",
+            cxxopts::value<uint64_t>()->default_value("1"), "CONCURRENCY")
+        ("rate",
+            "total requests per second sent regardless of responses, 0 to send next request once response is received",
+            cxxopts::value<double>()->default_value("0"), "RATE")
+        ("duration",
+            "measurement time in seconds",
+            cxxopts::value<double>()->default_value("10"), "SECONDS")
+        ("warmup",
+            "time in seconds before measurement, requests sent then are not reported",
+            cxxopts::value<double>()->default_value("1"), "SECONDS")
+        ("histogram_path",
+            "optional path of file with latency percentile distribution in HdrHistogram format",
+            cxxopts::value<std::string>(), "HISTOGRAM_PATH")
+        ("replay",
+            "capture file recorded by server with capture_path, requests are sent at their recorded arrival times instead of model_name and input, duration and rate are ignored",
+            cxxopts::value<std::string>(), "REPLAY_PATH")
+        ("replay_speed",
+            "factor arrival times of replayed requests are sped up by, e.g. inverse of capture_sample_ratio to reproduce original traffic",
+            cxxopts::value<double>()->default_value("1"), "REPLAY_SPEED")
+        ("report_interval",
+            "time in seconds between reports of latency, throughput and server resources during measurement, 0 to report only at the end",
+            cxxopts::value<double>()->default_value("0"), "SECONDS")
+        ("report_path",
+            "optional path of CSV file with periodic reports",
+            cxxopts::value<std::string>(), "REPORT_PATH")
+        ("server_pid",
+            "process id of local server, its memory, threads and open files are reported",
+            cxxopts::value<int64_t>()->default_value("0"), "PID")
+        ("heap_stats_port",
+            "REST port of server started with profiling_endpoints, its heap statistics are reported",
+            cxxopts::value<uint64_t>()->default_value("0"), "PORT")
+        ("config_path",
+            "config file of the server, replaced every reload_interval",
+            cxxopts::value<std::string>(), "CONFIG_PATH")
+        ("config_variant",
+            "config file copied over config_path in turns, may be repeated, config_path is rewritten unchanged if none are passed",
+            cxxopts::value<std::vector<std::string>>(), "CONFIG_PATH")
+        ("reload_interval",
+            "time in seconds between config file replacements, 0 to not replace",
+            cxxopts::value<double>()->default_value("0"), "SECONDS")
+        ("model_base_path",
+            "local base path of served model, its latest version is copied as a new version every version_bump_interval and older versions are removed",
+            cxxopts::value<std::string>(), "MODEL_BASE_PATH")
+        ("version_bump_interval",
+            "time in seconds between new model versions, 0 to not add versions",
+            cxxopts::value<double>()->default_value("0"), "SECONDS");
+    // clang-format on
+    try {
+        auto result = parser.parse(argc, argv);
+        if (result.count("help")) {
+            std::cout << parser.help() << std::endl;
+            return false;
+        }
+        options.protocol = result["protocol"].as<std::string>();
+        options.address = result["address"].as<std::string>();
+        options.port = result["port"].as<uint64_t>();
+        options.modelVersion = result["model_version"].as<int64_t>();
+        options.restBinary = result.count("rest_binary") > 0;
+        options.concurrency = result["concurrency"].as<uint64_t>();
+        options.rate = result["rate"].as<double>();
+        options.durationSeconds = result["duration"].as<double>();
+        options.warmupSeconds = result["warmup"].as<double>();
+        if (result.count("histogram_path")) {
+            options.histogramPath = result["histogram_path"].as<std::string>();
+        }
+        options.replaySpeed = result["replay_speed"].as<double>();
+        if (result.count("replay")) {
+            options.replayPath = result["replay"].as<std::string>();
+        } else if (!result.count("model_name") || !result.count("input")) {
+            std::cerr << "model_name and at least one input are required" << std::endl;
+            return false;
+        }
+        if (result.count("model_name")) {
+            options.modelName = result["model_name"].as<std::string>();
+        }
+        for (const auto& input : result.count("input") ? result["input"].as<std::vector<std::string>>() : std::vector<std::string>()) {
+            auto separator = input.find('=');
+            if (separator == std::string::npos) {
+                std::cerr << "Input should be passed as NAME=PATH: " << input << std::endl;
+                return false;
+            }
+            NpyArray array;
+            auto status = readNpyFile(input.substr(separator + 1), array);
+            if (!status.ok()) {
+                std::cerr << "Could not read " << input.substr(separator + 1) << ": " << status.string() << std::endl;
+                return false;
+            }
+            options.inputs.emplace_back(input.substr(0, separator), std::move(array));
+        }
+        // k-th variant takes k-th file of each input, inputs with fewer files are repeated
+        size_t variants = 1;
+        std::vector<std::pair<std::string, std::vector<const NpyArray*>>> files;
+        for (const auto& [name, array] : options.inputs) {
+            auto it = std::find_if(files.begin(), files.end(), [&name = name](const auto& entry) { return entry.first == name; });
+            if (it == files.end()) {
+                files.emplace_back(name, std::vector<const NpyArray*>());
+                it = files.end() - 1;
+            }
+            it->second.push_back(&array);
+            variants = std::max(variants, it->second.size());
+        }
+        options.inputVariants.resize(variants);
+        for (size_t k = 0; k < variants; k++) {
+            for (const auto& [name, arrays] : files) {
+                options.inputVariants[k].emplace_back(name, *arrays[k % arrays.size()]);
+            }
+        }
+        options.reportIntervalSeconds = result["report_interval"].as<double>();
+        if (result.count("report_path")) {
+            options.reportPath = result["report_path"].as<std::string>();
+        }
+        options.serverPid = static_cast<pid_t>(result["server_pid"].as<int64_t>());
+        options.heapStatsPort = result["heap_stats_port"].as<uint64_t>();
+        if (result.count("config_path")) {
+            options.configPath = result["config_path"].as<std::string>();
+        }
+        if (result.count("config_variant")) {
+            options.configVariants = result["config_variant"].as<std::vector<std::string>>();
+        }
+        options.reloadIntervalSeconds = result["reload_interval"].as<double>();
+        if (result.count("model_base_path")) {
+            options.modelBasePath = result["model_base_path"].as<std::string>();
+        }
+        options.versionBumpIntervalSeconds = result["version_bump_interval"].as<double>();
+    } catch (const cxxopts::OptionException& e) {
+        std::cerr << "Error parsing options: " << e.what() << std::endl;
+        return false;
+    }
+    if (options.protocol != "grpc" && options.protocol != "rest") {
+        std::cerr << "Protocol should be grpc or rest" << std::endl;
+        return false;
+    }
+    if (options.concurrency == 0 || options.rate < 0 || options.durationSeconds <= 0 || options.warmupSeconds < 0) {
+        std::cerr << "Concurrency and duration should be positive, rate and warmup should not be negative" << std::endl;
+        return false;
+    }
+    if (options.replaySpeed <= 0) {
+        std::cerr << "Replay speed should be positive" << std::endl;
+        return false;
+    }
+    if (options.reportIntervalSeconds < 0 || options.reloadIntervalSeconds < 0 || options.versionBumpIntervalSeconds < 0 || options.serverPid < 0) {
+        std::cerr << "Report, reload and version bump intervals and server pid should not be negative" << std::endl;
+        return false;
+    }
+    if (options.reloadIntervalSeconds > 0 && options.configPath.empty()) {
+        std::cerr << "config_path is required with reload_interval" << std::endl;
+        return false;
+    }
+    if (options.versionBumpIntervalSeconds > 0 && options.modelBasePath.empty()) {
+        std::cerr << "model_base_path is required with version_bump_interval" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+}  // namespace ovms
+
+int main(int argc, char** argv) {
+    ovms::LoadOptions options;
+    if (!ovms::parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    if (!options.replayPath.empty()) {
+        return ovms::replay(options);
+    }
+    return ovms::run(options);
+}
@@ -0,0 +1,102 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "soakstats.hpp"
+
+#include <dirent.h>
+
+#include <fstream>
+#include <string>
+
+namespace ovms {
+
+namespace {
+bool readNumberAfter(const std::string& content, size_t from, const std::string& key, uint64_t& value, size_t* end = nullptr) {
+    auto position = content.find(key, from);
+    if (position == std::string::npos) {
+        return false;
+    }
+    position += key.size();
+    size_t parsed = 0;
+    try {
+        value = std::stoull(content.substr(position, 32), &parsed);
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (end != nullptr) {
+        *end = position + parsed;
+    }
+    return true;
+}
+}  // namespace
+
+bool readProcessStats(pid_t pid, ProcessStats& stats) {
+    const std::string directory = "/proc/" + std::to_string(pid);
+    std::ifstream statusFile(directory + "/status");
+    if (!statusFile) {
+        return false;
+    }
+    stats = ProcessStats();
+    std::string line;
+    while (std::getline(statusFile, line)) {
+        uint64_t value = 0;
+        if (line.rfind("VmRSS:", 0) == 0 && readNumberAfter(line, 0, "VmRSS:", value)) {
+            stats.rssBytes = value * 1024;
+        } else if (line.rfind("VmHWM:", 0) == 0 && readNumberAfter(line, 0, "VmHWM:", value)) {
+            stats.peakRssBytes = value * 1024;
+        } else if (line.rfind("Threads:", 0) == 0 && readNumberAfter(line, 0, "Threads:", value)) {
+            stats.threads = value;
+        }
+    }
+    DIR* fds = opendir((directory + "/fd").c_str());
+    if (fds == nullptr) {
+        return false;
+    }
+    while (dirent* entry = readdir(fds)) {
+        if (entry->d_name[0] != '.') {
+            stats.openFiles++;
+        }
+    }
+    closedir(fds);
+    return true;
+}
+
+bool parseHeapStatistics(const std::string& content, HeapStats& stats) {
+    // jemalloc summary precedes per arena statistics
+    auto summary = content.find("\"stats\":");
+    if (summary != std::string::npos) {
+        return readNumberAfter(content, summary, "\"allocated\":", stats.allocatedBytes) &&
+               readNumberAfter(content, summary, "\"resident\":", stats.heapBytes);
+    }
+    // malloc_info lists heaps of arenas first, totals of all of them follow the last one
+    auto totals = content.rfind("</heap>");
+    if (totals == std::string::npos) {
+        return false;
+    }
+    uint64_t fastBytes = 0;
+    uint64_t restBytes = 0;
+    size_t position = 0;
+    if (!readNumberAfter(content, totals, "<total type=\"fast\" count=\"", fastBytes, &position) ||
+        !readNumberAfter(content, position, "size=\"", fastBytes) ||
+        !readNumberAfter(content, totals, "<total type=\"rest\" count=\"", restBytes, &position) ||
+        !readNumberAfter(content, position, "size=\"", restBytes) ||
+        !readNumberAfter(content, totals, "<system type=\"current\" size=\"", stats.heapBytes)) {
+        return false;
+    }
+    stats.allocatedBytes = stats.heapBytes > fastBytes + restBytes ? stats.heapBytes - fastBytes - restBytes : 0;
+    return true;
+}
+
+}  // namespace ovms
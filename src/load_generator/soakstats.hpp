@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief Resources of a process sampled during long running load
+ */
+struct ProcessStats {
+    uint64_t rssBytes = 0;
+    uint64_t peakRssBytes = 0;
+    uint64_t threads = 0;
+    uint64_t openFiles = 0;
+};
+
+/**
+ * @brief Reads resources of local process from /proc
+ *
+ * @return false if process does not exist or its files cannot be read
+ */
+bool readProcessStats(pid_t pid, ProcessStats& stats);
+
+/**
+ * @brief Heap of server allocator, difference of both is memory kept by allocator but not used by the server
+ */
+struct HeapStats {
+    uint64_t allocatedBytes = 0;
+    uint64_t heapBytes = 0;
+};
+
+/**
+ * @brief Parses heap statistics returned by server profiling endpoint
+ *
+ * Accepts both jemalloc JSON statistics, taking allocated and resident bytes,
+ * and glibc malloc_info XML, taking system memory of all arenas and subtracting free chunks.
+ *
+ * @return false if content is in neither format
+ */
+bool parseHeapStatistics(const std::string& content, HeapStats& stats);
+
+}  // namespace ovms
@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "loadingprofile.hpp"
+
+#include <sstream>
+
+namespace ovms {
+
+const char* LoadingProfile::getPhaseName(LoadingPhase phase) {
+    switch (phase) {
+    case LoadingPhase::LIST_VERSIONS:
+        return "list_versions";
+    case LoadingPhase::DOWNLOAD:
+        return "download";
+    case LoadingPhase::READ_NETWORK:
+        return "read_network";
+    case LoadingPhase::RESHAPE:
+        return "reshape";
+    case LoadingPhase::LOAD_NETWORK:
+        return "load_network";
+    case LoadingPhase::CREATE_INFER_REQUESTS:
+        return "create_infer_requests";
+    case LoadingPhase::WARM_UP:
+        return "warm_up";
+    case LoadingPhase::VALIDATION:
+        return "validation";
+    default:
+        return "unknown";
+    }
+}
+
+std::string LoadingProfile::toString() const {
+    std::ostringstream out;
+    for (size_t i = 0; i < PHASES_COUNT; ++i) {
+        const auto phase = static_cast<LoadingPhase>(i);
+        if (!isRecorded(phase)) {
+            continue;
+        }
+        if (out.tellp() > 0) {
+            out << ", ";
+        }
+        out << getPhaseName(phase) << ": " << getMicroseconds(phase) / 1000 << " ms";
+    }
+    return out.str();
+}
+
+}  // namespace ovms
@@ -0,0 +1,109 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief Phase of model or pipeline loading measured for startup and reload profiling
+ */
+enum class LoadingPhase {
+    LIST_VERSIONS,
+    DOWNLOAD,
+    READ_NETWORK,
+    RESHAPE,
+    LOAD_NETWORK,
+    CREATE_INFER_REQUESTS,
+    WARM_UP,
+    VALIDATION,
+    PHASES_COUNT
+};
+
+/**
+ * @brief Durations of phases of the last load of model, model version or pipeline
+ *
+ * Phases are written by loading thread and read by metrics requests, so durations are relaxed atomics. Phases which
+ * did not run in the last load, e.g. reading network skipped on reload with new shapes, keep duration of previous one.
+ */
+class LoadingProfile {
+public:
+    static constexpr size_t PHASES_COUNT = static_cast<size_t>(LoadingPhase::PHASES_COUNT);
+
+    static const char* getPhaseName(LoadingPhase phase);
+
+    void record(LoadingPhase phase, uint64_t microseconds) {
+        durations[index(phase)].store(microseconds, std::memory_order_relaxed);
+        recorded[index(phase)].store(true, std::memory_order_relaxed);
+        reported.store(false, std::memory_order_release);
+    }
+
+    bool isRecorded(LoadingPhase phase) const {
+        return recorded[index(phase)].load(std::memory_order_relaxed);
+    }
+
+    uint64_t getMicroseconds(LoadingPhase phase) const {
+        return durations[index(phase)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Marks phases as reported, so that profile is logged once after each load
+     *
+     * @return true if any phase was recorded since previous call
+     */
+    bool markReported() {
+        return !reported.exchange(true, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Formats recorded phases in order of loading, e.g. "read_network: 120 ms, load_network: 2300 ms"
+     */
+    std::string toString() const;
+
+private:
+    static size_t index(LoadingPhase phase) {
+        return static_cast<size_t>(phase);
+    }
+
+    std::array<std::atomic<uint64_t>, PHASES_COUNT> durations{};
+    std::array<std::atomic<bool>, PHASES_COUNT> recorded{};
+    std::atomic<bool> reported{true};
+};
+
+/**
+ * @brief Records duration of loading phase from construction until scope is left, also by early return or exception
+ */
+class LoadingPhaseTimer {
+    LoadingProfile& profile;
+    const LoadingPhase phase;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    LoadingPhaseTimer(LoadingProfile& profile, LoadingPhase phase) :
+        profile(profile),
+        phase(phase) {}
+
+    ~LoadingPhaseTimer() {
+        profile.record(phase, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+}  // namespace ovms
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include <spdlog/spdlog.h>
+#include <sys/stat.h>
 
 #if defined(__APPLE__) || defined(__NetBSD__)
 #define st_mtim st_mtimespec
@@ -163,4 +164,21 @@ StatusCode LocalFileSystem::deleteFileFolder(const std::string& path) {
     return StatusCode::OK;
 }
 
+StatusCode LocalFileSystem::getDirectoryChangeToken(const std::string& path, std::string* token) {
+    if (isPathEscaped(path)) {
+        SPDLOG_ERROR("Path {} escape with .. is forbidden.", path);
+        return StatusCode::PATH_INVALID;
+    }
+    // single stat replaces listing, works on network mounts where inotify does not report remote changes
+    struct stat statTime;
+    if (stat(path.c_str(), &statTime) != 0) {
+        SPDLOG_DEBUG("Couldn't access path {}", path);
+        return StatusCode::PATH_INVALID;
+    }
+    *token = std::to_string(statTime.st_dev) + ":" + std::to_string(statTime.st_ino) + ":" +
+             std::to_string(statTime.st_mtim.tv_sec * NANOS_PER_SECOND + statTime.st_mtim.tv_nsec) + ":" +
+             std::to_string(statTime.st_ctim.tv_sec * NANOS_PER_SECOND + statTime.st_ctim.tv_nsec);
+    return StatusCode::OK;
+}
+
 }  // namespace ovms
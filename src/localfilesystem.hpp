@@ -111,6 +111,15 @@ public:
      * @return StatusCode 
      */
     StatusCode deleteFileFolder(const std::string& path) override;
+
+    /**
+     * @brief Get a token changing when entries of the directory are added, removed or renamed
+     * 
+     * @param path 
+     * @param token 
+     * @return StatusCode 
+     */
+    StatusCode getDirectoryChangeToken(const std::string& path, std::string* token) override;
 };
 
 }  // namespace ovms
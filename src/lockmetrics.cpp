@@ -0,0 +1,38 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "lockmetrics.hpp"
+
+namespace ovms {
+
+LockMetrics& LockMetricsRegistry::get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& lockMetrics = metrics[name];
+    if (!lockMetrics) {
+        lockMetrics = std::make_unique<LockMetrics>();
+    }
+    return *lockMetrics;
+}
+
+std::map<std::string, const LockMetrics*> LockMetricsRegistry::getAll() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::map<std::string, const LockMetrics*> result;
+    for (const auto& [name, lockMetrics] : metrics) {
+        result.emplace(name, lockMetrics.get());
+    }
+    return result;
+}
+
+}  // namespace ovms
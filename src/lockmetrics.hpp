@@ -0,0 +1,138 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "metrics.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Time spent waiting to acquire and holding exclusively mutexes with the same name
+ */
+struct LockMetrics {
+    LatencyHistogram wait;
+    LatencyHistogram hold;
+};
+
+/**
+ * @brief Lock metrics shared by all instrumented mutexes with the same name, e.g. of all served models
+ */
+class LockMetricsRegistry {
+    mutable std::mutex mtx;
+    std::map<std::string, std::unique_ptr<LockMetrics>> metrics;
+
+    LockMetricsRegistry() = default;
+
+public:
+    static LockMetricsRegistry& getInstance() {
+        static LockMetricsRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief Gets metrics of lock with given name, created on first use and kept for lifetime of the server
+     */
+    LockMetrics& get(const std::string& name);
+
+    std::map<std::string, const LockMetrics*> getAll() const;
+};
+
+#ifdef OVMS_LOCK_METRICS
+/**
+ * @brief Mutex recording acquisition wait and exclusive hold durations in lock metrics
+ *
+ * Shared owners only record wait, since they may hold the mutex concurrently. Recursive locking
+ * records hold from the outermost lock until the last unlock.
+ */
+template <typename Mutex>
+class InstrumentedMutex {
+    Mutex mtx;
+    LockMetrics& metrics;
+    std::chrono::steady_clock::time_point acquired;
+    size_t depth = 0;
+
+    static double elapsedMicroseconds(const std::chrono::steady_clock::time_point& since, const std::chrono::steady_clock::time_point& until) {
+        return std::chrono::duration<double, std::micro>(until - since).count();
+    }
+
+    void onAcquired(const std::chrono::steady_clock::time_point& now) {
+        if (depth++ == 0) {
+            acquired = now;
+        }
+    }
+
+public:
+    explicit InstrumentedMutex(const char* name) :
+        metrics(LockMetricsRegistry::getInstance().get(name)) {}
+
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock() {
+        const auto start = std::chrono::steady_clock::now();
+        mtx.lock();
+        const auto now = std::chrono::steady_clock::now();
+        metrics.wait.observe(elapsedMicroseconds(start, now));
+        onAcquired(now);
+    }
+
+    bool try_lock() {
+        if (!mtx.try_lock()) {
+            return false;
+        }
+        onAcquired(std::chrono::steady_clock::now());
+        return true;
+    }
+
+    void unlock() {
+        if (--depth == 0) {
+            metrics.hold.observe(elapsedMicroseconds(acquired, std::chrono::steady_clock::now()));
+        }
+        mtx.unlock();
+    }
+
+    void lock_shared() {
+        const auto start = std::chrono::steady_clock::now();
+        mtx.lock_shared();
+        metrics.wait.observe(elapsedMicroseconds(start, std::chrono::steady_clock::now()));
+    }
+
+    bool try_lock_shared() {
+        return mtx.try_lock_shared();
+    }
+
+    void unlock_shared() {
+        mtx.unlock_shared();
+    }
+};
+#else
+/**
+ * @brief Plain mutex when built without --define=lock_metrics=1, name is ignored
+ */
+template <typename Mutex>
+class InstrumentedMutex : public Mutex {
+public:
+    explicit InstrumentedMutex(const char*) {}
+};
+#endif
+
+}  // namespace ovms
@@ -17,6 +17,8 @@
 
 #include <vector>
 
+#include <spdlog/async.h>
+
 namespace ovms {
 
 std::shared_ptr<spdlog::logger> gcs_logger = std::make_shared<spdlog::logger>("gcs");
@@ -24,9 +26,13 @@ std::shared_ptr<spdlog::logger> azurestorage_logger = std::make_shared<spdlog::l
 std::shared_ptr<spdlog::logger> s3_logger = std::make_shared<spdlog::logger>("s3");
 std::shared_ptr<spdlog::logger> modelmanager_logger = std::make_shared<spdlog::logger>("modelmanager");
 std::shared_ptr<spdlog::logger> ensemble_logger = std::make_shared<spdlog::logger>("ensemble");
+std::shared_ptr<spdlog::logger> tracing_logger = std::make_shared<spdlog::logger>("tracing");
 
 const std::string default_pattern = "[%Y-%m-%d %T.%e][%n][%l][%s:%#] %v";
 
+// Messages of loggers used on request path are formatted and written by a background thread
+const size_t async_queue_size = 8192;
+
 void set_log_level(const std::string log_level, std::shared_ptr<spdlog::logger> logger) {
     logger->set_level(spdlog::level::info);
     if (!log_level.empty()) {
@@ -41,19 +47,26 @@ void set_log_level(const std::string log_level, std::shared_ptr<spdlog::logger>
 }
 
 void register_loggers(const std::string log_level, std::vector<spdlog::sink_ptr> sinks) {
-    auto serving_logger = std::make_shared<spdlog::logger>("serving", begin(sinks), end(sinks));
+    spdlog::init_thread_pool(async_queue_size, 1);
+    // Oldest messages are dropped when queue is full so that requests never wait for logging
+    auto serving_logger = std::make_shared<spdlog::async_logger>("serving", begin(sinks), end(sinks),
+        spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+    ensemble_logger = std::make_shared<spdlog::async_logger>("ensemble", begin(sinks), end(sinks),
+        spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+    tracing_logger = std::make_shared<spdlog::async_logger>("tracing", begin(sinks), end(sinks),
+        spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
     serving_logger->set_pattern(default_pattern);
     gcs_logger->set_pattern(default_pattern);
     azurestorage_logger->set_pattern(default_pattern);
     s3_logger->set_pattern(default_pattern);
     modelmanager_logger->set_pattern(default_pattern);
     ensemble_logger->set_pattern(default_pattern);
+    tracing_logger->set_pattern(default_pattern);
     for (auto sink : sinks) {
         gcs_logger->sinks().push_back(sink);
         azurestorage_logger->sinks().push_back(sink);
         s3_logger->sinks().push_back(sink);
         modelmanager_logger->sinks().push_back(sink);
-        ensemble_logger->sinks().push_back(sink);
     }
     set_log_level(log_level, serving_logger);
     set_log_level(log_level, gcs_logger);
@@ -61,12 +74,13 @@ void register_loggers(const std::string log_level, std::vector<spdlog::sink_ptr>
     set_log_level(log_level, s3_logger);
     set_log_level(log_level, modelmanager_logger);
     set_log_level(log_level, ensemble_logger);
+    set_log_level(log_level, tracing_logger);
     spdlog::set_default_logger(serving_logger);
 }
 
 void configure_logger(const std::string log_level, const std::string log_path) {
     std::vector<spdlog::sink_ptr> sinks;
-    sinks.push_back(std::make_shared<spdlog::sinks::stdout_sink_st>());
+    sinks.push_back(std::make_shared<spdlog::sinks::stdout_sink_mt>());
     if (!log_path.empty()) {
         sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_path));
     }
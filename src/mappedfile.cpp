@@ -0,0 +1,80 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "mappedfile.hpp"
+
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ovms {
+
+namespace {
+using file_identity_t = std::tuple<dev_t, ino_t, off_t, int64_t, int64_t>;
+
+std::mutex mappedFilesMtx;
+std::map<file_identity_t, std::weak_ptr<const MappedFile>> mappedFiles;
+}  // namespace
+
+MappedFile::~MappedFile() {
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SPDLOG_DEBUG("Failed to open file:{} for mapping", path);
+        return nullptr;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    file_identity_t identity{fileStat.st_dev, fileStat.st_ino, fileStat.st_size, fileStat.st_mtim.tv_sec, fileStat.st_mtim.tv_nsec};
+
+    std::lock_guard<std::mutex> lock(mappedFilesMtx);
+    auto it = mappedFiles.find(identity);
+    if (it != mappedFiles.end()) {
+        if (auto mappedFile = it->second.lock()) {
+            close(fd);
+            SPDLOG_DEBUG("Reusing mapping of file:{}", path);
+            return mappedFile;
+        }
+    }
+    // private writable mapping, so that pages modified in place are copied instead of failing
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        SPDLOG_DEBUG("Failed to map file:{}", path);
+        return nullptr;
+    }
+    std::shared_ptr<const MappedFile> mappedFile(new MappedFile(static_cast<const uint8_t*>(data), fileStat.st_size));
+    mappedFiles[identity] = mappedFile;
+    // drop entries of files no longer mapped
+    for (auto entry = mappedFiles.begin(); entry != mappedFiles.end();) {
+        entry = entry->second.expired() ? mappedFiles.erase(entry) : std::next(entry);
+    }
+    return mappedFile;
+}
+
+}  // namespace ovms
@@ -0,0 +1,64 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief Read only view of a file mapped into memory
+ *
+ * Mapping is private, pages are loaded from page cache on first access and shared with other
+ * processes mapping the same file. Instances of a file which did not change are shared
+ * within the process, so model versions and models pointing to the same weights file use one mapping.
+ */
+class MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    MappedFile(const uint8_t* data, size_t size) :
+        data(data),
+        size(size) {}
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+    ~MappedFile();
+
+    /**
+     * @brief Maps file or returns existing mapping of it if the file was not modified since
+     *
+     * @param path
+     *
+     * @return mapping or nullptr if file cannot be mapped
+     */
+    static std::shared_ptr<const MappedFile> open(const std::string& path);
+
+    const uint8_t* getData() const {
+        return data;
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+};
+
+}  // namespace ovms
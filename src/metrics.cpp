@@ -0,0 +1,270 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "metrics.hpp"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include "batchingscheduler.hpp"
+#include "loadingprofile.hpp"
+#include "lockmetrics.hpp"
+#include "modelinstance.hpp"
+#include "modelinstanceunloadguard.hpp"
+#include "modelmanager.hpp"
+#include "pipelinedefinition.hpp"
+
+namespace ovms {
+
+const std::array<uint64_t, LatencyHistogram::BUCKETS_COUNT> LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000};
+
+void LatencyHistogram::observe(double microseconds) {
+    const uint64_t value = microseconds > 0 ? static_cast<uint64_t>(microseconds) : 0;
+    size_t bucket = 0;
+    while (bucket < BUCKETS_COUNT && value > BUCKET_BOUNDS_MICROSECONDS[bucket]) {
+        ++bucket;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumMicroseconds.fetch_add(value, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+NodeMetrics& PipelineMetrics::getNode(const std::string& nodeName) {
+    std::lock_guard<std::mutex> lock(nodesMtx);
+    auto& metrics = nodes[nodeName];
+    if (!metrics) {
+        metrics = std::make_unique<NodeMetrics>();
+    }
+    return *metrics;
+}
+
+namespace {
+
+struct ServedModelVersion {
+    std::string name;
+    model_version_t version;
+    std::shared_ptr<ModelInstance> instance;
+    std::optional<size_t> nireq;
+    std::optional<size_t> idleStreams;
+    std::optional<size_t> waiters;
+    std::optional<size_t> batchTimeout;
+    std::optional<size_t> batchTargetSize;
+    std::optional<size_t> batchArrivalRate;
+};
+
+std::string labels(const ServedModelVersion& servedVersion) {
+    return "name=\"" + servedVersion.name + "\",version=\"" + std::to_string(servedVersion.version) + "\"";
+}
+
+void serializeHistogramSeries(std::ostringstream& out, const std::string& metric, const std::string& seriesLabels, const LatencyHistogram& histogram) {
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < LatencyHistogram::BUCKETS_COUNT; ++i) {
+        cumulative += histogram.getBucketCount(i);
+        out << metric << "_bucket{" << seriesLabels << ",le=\"" << LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[i] / 1e6 << "\"} " << cumulative << "\n";
+    }
+    cumulative += histogram.getBucketCount(LatencyHistogram::BUCKETS_COUNT);
+    out << metric << "_bucket{" << seriesLabels << ",le=\"+Inf\"} " << cumulative << "\n";
+    out << metric << "_sum{" << seriesLabels << "} " << histogram.getSumMicroseconds() / 1e6 << "\n";
+    out << metric << "_count{" << seriesLabels << "} " << cumulative << "\n";
+}
+
+void serializeHistogram(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::vector<ServedModelVersion>& servedVersions, const LatencyHistogram ModelMetrics::*histogramMember) {
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " histogram\n";
+    for (const auto& servedVersion : servedVersions) {
+        serializeHistogramSeries(out, metric, labels(servedVersion), servedVersion.instance->getMetrics().*histogramMember);
+    }
+}
+
+void serializeLockHistogram(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::map<std::string, const LockMetrics*>& locks, const LatencyHistogram LockMetrics::*histogramMember) {
+    if (locks.empty()) {
+        return;
+    }
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " histogram\n";
+    for (const auto& [name, lockMetrics] : locks) {
+        serializeHistogramSeries(out, metric, "lock=\"" + name + "\"", lockMetrics->*histogramMember);
+    }
+}
+
+void serializeCounter(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::vector<ServedModelVersion>& servedVersions, const std::atomic<uint64_t> ModelMetrics::*counterMember) {
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " counter\n";
+    for (const auto& servedVersion : servedVersions) {
+        const auto& counter = servedVersion.instance->getMetrics().*counterMember;
+        out << metric << "{" << labels(servedVersion) << "} " << counter.load(std::memory_order_relaxed) << "\n";
+    }
+}
+
+void serializeGauge(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::vector<ServedModelVersion>& servedVersions, std::optional<size_t> ServedModelVersion::*gaugeMember) {
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " gauge\n";
+    for (const auto& servedVersion : servedVersions) {
+        const auto& gauge = servedVersion.*gaugeMember;
+        if (gauge.has_value()) {
+            out << metric << "{" << labels(servedVersion) << "} " << gauge.value() << "\n";
+        }
+    }
+}
+
+void serializeLoadingPhases(std::ostringstream& out, const std::string& metric, const std::string& seriesLabels, const LoadingProfile& profile) {
+    for (size_t i = 0; i < LoadingProfile::PHASES_COUNT; ++i) {
+        const auto phase = static_cast<LoadingPhase>(i);
+        if (profile.isRecorded(phase)) {
+            out << metric << "{" << seriesLabels << ",phase=\"" << LoadingProfile::getPhaseName(phase) << "\"} " << profile.getMicroseconds(phase) / 1e6 << "\n";
+        }
+    }
+}
+
+void serializeLoadingProfiles(std::ostringstream& out, ModelManager& manager, const std::vector<ServedModelVersion>& servedVersions) {
+    out << "# HELP ovms_model_loading_phase_seconds Duration of versions listing and download in the last load of model versions.\n";
+    out << "# TYPE ovms_model_loading_phase_seconds gauge\n";
+    for (const auto& [name, model] : manager.getModels()) {
+        serializeLoadingPhases(out, "ovms_model_loading_phase_seconds", "name=\"" + name + "\"", model->getLoadingProfile());
+    }
+    out << "# HELP ovms_model_version_loading_phase_seconds Duration of phase in the last load or reload of model version.\n";
+    out << "# TYPE ovms_model_version_loading_phase_seconds gauge\n";
+    for (const auto& servedVersion : servedVersions) {
+        serializeLoadingPhases(out, "ovms_model_version_loading_phase_seconds", labels(servedVersion), servedVersion.instance->getLoadingProfile());
+    }
+}
+
+struct ServedPipeline {
+    std::string name;
+    std::shared_ptr<PipelineMetrics> metrics;
+};
+
+void serializePipelineCounter(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::vector<ServedPipeline>& pipelines, const std::atomic<uint64_t> PipelineMetrics::*counterMember) {
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " counter\n";
+    for (const auto& pipeline : pipelines) {
+        out << metric << "{pipeline=\"" << pipeline.name << "\"} " << ((*pipeline.metrics).*counterMember).load(std::memory_order_relaxed) << "\n";
+    }
+}
+
+void serializeNodeHistogram(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::vector<ServedPipeline>& pipelines, const LatencyHistogram NodeMetrics::*histogramMember) {
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " histogram\n";
+    for (const auto& pipeline : pipelines) {
+        pipeline.metrics->forEachNode([&](const std::string& node, const NodeMetrics& metrics) {
+            serializeHistogramSeries(out, metric, "pipeline=\"" + pipeline.name + "\",node=\"" + node + "\"", metrics.*histogramMember);
+        });
+    }
+}
+
+void serializeNodeCounter(std::ostringstream& out, const std::string& metric, const std::string& help,
+    const std::vector<ServedPipeline>& pipelines, const std::atomic<uint64_t> NodeMetrics::*counterMember) {
+    out << "# HELP " << metric << " " << help << "\n";
+    out << "# TYPE " << metric << " counter\n";
+    for (const auto& pipeline : pipelines) {
+        pipeline.metrics->forEachNode([&](const std::string& node, const NodeMetrics& metrics) {
+            out << metric << "{pipeline=\"" << pipeline.name << "\",node=\"" << node << "\"} " << (metrics.*counterMember).load(std::memory_order_relaxed) << "\n";
+        });
+    }
+}
+
+void serializePipelineMetrics(std::ostringstream& out, ModelManager& manager) {
+    std::vector<ServedPipeline> pipelines;
+    const auto definitions = manager.getPipelineFactory().getDefinitionsSnapshot();
+    for (const auto& [name, definition] : *definitions) {
+        pipelines.push_back({name, definition->getMetrics()});
+    }
+    if (pipelines.empty()) {
+        return;
+    }
+    out << "# HELP ovms_pipeline_loading_phase_seconds Duration of phase in the last load or reload of pipeline definition.\n";
+    out << "# TYPE ovms_pipeline_loading_phase_seconds gauge\n";
+    for (const auto& [name, definition] : *definitions) {
+        serializeLoadingPhases(out, "ovms_pipeline_loading_phase_seconds", "pipeline=\"" + name + "\"", definition->getLoadingProfile());
+    }
+    serializePipelineCounter(out, "ovms_pipeline_requests_success_total", "Number of successful pipeline executions.", pipelines, &PipelineMetrics::requestsSuccess);
+    serializePipelineCounter(out, "ovms_pipeline_requests_fail_total", "Number of failed pipeline executions.", pipelines, &PipelineMetrics::requestsFail);
+    out << "# HELP ovms_pipeline_execution_seconds Time of pipeline execution.\n";
+    out << "# TYPE ovms_pipeline_execution_seconds histogram\n";
+    for (const auto& pipeline : pipelines) {
+        serializeHistogramSeries(out, "ovms_pipeline_execution_seconds", "pipeline=\"" + pipeline.name + "\"", pipeline.metrics->total);
+    }
+    serializeNodeHistogram(out, "ovms_pipeline_node_execution_seconds", "Time from start of pipeline node until it finished.", pipelines, &NodeMetrics::execution);
+    serializeNodeHistogram(out, "ovms_pipeline_node_stream_wait_seconds", "Time pipeline node was deferred waiting for idle inference stream.", pipelines, &NodeMetrics::streamWait);
+    serializeNodeHistogram(out, "ovms_pipeline_node_ready_to_start_seconds", "Time from pipeline node inputs being ready until node start.", pipelines, &NodeMetrics::readyToStart);
+    serializeNodeCounter(out, "ovms_pipeline_node_copied_bytes_total", "Bytes of pipeline node outputs copied out of infer requests.", pipelines, &NodeMetrics::copiedBytes);
+    serializeNodeCounter(out, "ovms_pipeline_node_failures_total", "Number of failed pipeline node executions.", pipelines, &NodeMetrics::failures);
+    serializeNodeCounter(out, "ovms_pipeline_node_skipped_total", "Number of pipeline node executions skipped by closed gate.", pipelines, &NodeMetrics::skipped);
+}
+
+}  // namespace
+
+std::string serializeMetricsToPrometheusText(ModelManager& manager) {
+    std::vector<ServedModelVersion> servedVersions;
+    for (const auto& [name, model] : manager.getModels()) {
+        for (const auto& [version, instanceRef] : model->getModelVersionsMapCopy()) {
+            auto instance = manager.findModelInstance(name, version);
+            if (!instance) {
+                continue;
+            }
+            ServedModelVersion servedVersion{name, version, instance};
+            // Streams pool exists only while model version is loaded, guard holds off unloading while it is read
+            ModelInstanceUnloadGuard unloadGuard(*instance);
+            if (instance->getStatus().getState() == ModelVersionState::AVAILABLE) {
+                auto& inferRequestsQueue = instance->getInferRequestsQueue();
+                servedVersion.nireq = inferRequestsQueue.size();
+                servedVersion.idleStreams = inferRequestsQueue.getIdleStreamsCount();
+                servedVersion.waiters = inferRequestsQueue.getWaitersCount();
+                auto batchingScheduler = instance->getBatchingScheduler();
+                if (batchingScheduler && batchingScheduler->getTimeoutTuner()) {
+                    const auto* tuner = batchingScheduler->getTimeoutTuner();
+                    servedVersion.batchTimeout = tuner->getTimeoutMicroseconds();
+                    servedVersion.batchTargetSize = tuner->getTargetBatchSize();
+                    servedVersion.batchArrivalRate = static_cast<size_t>(tuner->getArrivalRate());
+                }
+            }
+            servedVersions.push_back(std::move(servedVersion));
+        }
+    }
+
+    std::ostringstream out;
+    serializeCounter(out, "ovms_requests_success_total", "Number of successful predict requests.", servedVersions, &ModelMetrics::requestsSuccess);
+    serializeCounter(out, "ovms_requests_fail_total", "Number of failed predict requests.", servedVersions, &ModelMetrics::requestsFail);
+    serializeHistogram(out, "ovms_request_stream_wait_seconds", "Time spent waiting for idle inference stream.", servedVersions, &ModelMetrics::streamWait);
+    serializeHistogram(out, "ovms_request_deserialization_seconds", "Time spent deserializing request into infer request inputs.", servedVersions, &ModelMetrics::deserialization);
+    serializeHistogram(out, "ovms_request_inference_seconds", "Time spent in inference.", servedVersions, &ModelMetrics::inference);
+    serializeHistogram(out, "ovms_request_serialization_seconds", "Time spent serializing inference outputs into response.", servedVersions, &ModelMetrics::serialization);
+    serializeHistogram(out, "ovms_request_total_seconds", "Total time of predict request processing in model version.", servedVersions, &ModelMetrics::total);
+    serializeGauge(out, "ovms_infer_requests_nireq", "Number of infer requests in model version streams pool.", servedVersions, &ServedModelVersion::nireq);
+    serializeGauge(out, "ovms_infer_requests_idle", "Number of idle infer requests in model version streams pool.", servedVersions, &ServedModelVersion::idleStreams);
+    serializeGauge(out, "ovms_infer_requests_waiting", "Number of requests waiting for idle infer request.", servedVersions, &ServedModelVersion::waiters);
+    serializeGauge(out, "ovms_dynamic_batch_timeout_microseconds", "Dynamic batching timeout tuned for latency SLO.", servedVersions, &ServedModelVersion::batchTimeout);
+    serializeGauge(out, "ovms_dynamic_batch_target_size", "Batch size dynamic batching timeout is tuned for.", servedVersions, &ServedModelVersion::batchTargetSize);
+    serializeGauge(out, "ovms_dynamic_batch_arrival_rate", "Estimated arrival rate of rows to dynamic batching, per second.", servedVersions, &ServedModelVersion::batchArrivalRate);
+    serializeLoadingProfiles(out, manager, servedVersions);
+    serializePipelineMetrics(out, manager);
+    // instrumented mutexes register their metrics only when built with lock metrics
+    const auto locks = LockMetricsRegistry::getInstance().getAll();
+    serializeLockHistogram(out, "ovms_lock_wait_seconds", "Time spent waiting to acquire lock.", locks, &LockMetrics::wait);
+    serializeLockHistogram(out, "ovms_lock_hold_seconds", "Time lock was held exclusively.", locks, &LockMetrics::hold);
+    return out.str();
+}
+
+}  // namespace ovms
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ovms {
+
+class ModelManager;
+
+/**
+ * @brief Lock-free latency histogram with fixed buckets
+ *
+ * Observations only increment relaxed atomic counters so recording does not introduce
+ * contention between requests served by different streams. Readers may see counters
+ * from slightly different moments, which is acceptable for monitoring.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKETS_COUNT = 16;
+
+    /**
+     * @brief Upper bounds of buckets in microseconds, last implicit bucket is +Inf
+     */
+    static const std::array<uint64_t, BUCKETS_COUNT> BUCKET_BOUNDS_MICROSECONDS;
+
+    void observe(double microseconds);
+
+    /**
+     * @brief Number of observations falling into bucket (non cumulative), BUCKETS_COUNT index is +Inf bucket
+     */
+    uint64_t getBucketCount(size_t bucket) const {
+        return buckets[bucket].load(std::memory_order_relaxed);
+    }
+
+    uint64_t getCount() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getSumMicroseconds() const {
+        return sumMicroseconds.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS_COUNT + 1> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sumMicroseconds{0};
+};
+
+/**
+ * @brief Per model version counters of predict requests processing phases
+ */
+struct ModelMetrics {
+    LatencyHistogram streamWait;
+    LatencyHistogram deserialization;
+    LatencyHistogram inference;
+    LatencyHistogram serialization;
+    LatencyHistogram total;
+    std::atomic<uint64_t> requestsSuccess{0};
+    std::atomic<uint64_t> requestsFail{0};
+    std::atomic<uint64_t> requestsInFlight{0};
+};
+
+/**
+ * @brief Per pipeline node counters, shared by all executions of the pipeline
+ */
+struct NodeMetrics {
+    /**
+     * @brief Time from start of node until notification about its finish
+     */
+    LatencyHistogram execution;
+
+    /**
+     * @brief Time node was deferred for idle stream of its model
+     */
+    LatencyHistogram streamWait;
+
+    /**
+     * @brief Time from notification about finish of dependency which made node ready until node start
+     */
+    LatencyHistogram readyToStart;
+    std::atomic<uint64_t> copiedBytes{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> skipped{0};
+};
+
+/**
+ * @brief Per pipeline counters and counters of its nodes, kept by node name across reloads of pipeline definition
+ */
+class PipelineMetrics {
+public:
+    LatencyHistogram total;
+    std::atomic<uint64_t> requestsSuccess{0};
+    std::atomic<uint64_t> requestsFail{0};
+
+    /**
+     * @brief Gets metrics of node, created on first use. Returned reference stays valid as long as pipeline metrics
+     */
+    NodeMetrics& getNode(const std::string& nodeName);
+
+    /**
+     * @brief Calls function with each node name and metrics, in order of names
+     */
+    template <typename F>
+    void forEachNode(F&& function) const {
+        std::lock_guard<std::mutex> lock(nodesMtx);
+        for (const auto& [name, metrics] : nodes) {
+            function(name, *metrics);
+        }
+    }
+
+private:
+    mutable std::mutex nodesMtx;
+    std::map<std::string, std::unique_ptr<NodeMetrics>> nodes;
+};
+
+/**
+ * @brief Serializes metrics of all served model versions and pipelines in Prometheus text exposition format
+ *
+ * @param manager
+ *
+ * @return metrics text
+ */
+std::string serializeMetricsToPrometheusText(ModelManager& manager);
+
+}  // namespace ovms
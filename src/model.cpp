@@ -15,12 +15,18 @@
 //*****************************************************************************
 #include "model.hpp"
 
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "customloaders.hpp"
+#include "modelreaper.hpp"
+#include "paralleltasks.hpp"
 
 namespace ovms {
 
@@ -46,11 +52,13 @@ const std::map<model_version_t, std::shared_ptr<ModelInstance>>& Model::getModel
 }
 
 void Model::updateDefaultVersion() {
+    // exclusive lock since versions may be updated concurrently while loading in parallel
+    std::unique_lock lock(modelVersionsMtx);
     model_version_t newDefaultVersion = 0;
-    SPDLOG_INFO("Updating default version for model:{}, from:{}", getName(), defaultVersion);
+    SPDLOG_INFO("Updating default version for model:{}, from:{}", getName(), defaultVersion.load());
     for (const auto& [version, versionInstance] : modelVersions) {
         if (version > newDefaultVersion &&
-            ModelVersionState::AVAILABLE == versionInstance->getStatus().getState()) {
+            (ModelVersionState::AVAILABLE == versionInstance->getStatus().getState() || versionInstance->isEvicted())) {
             newDefaultVersion = version;
         }
     }
@@ -63,17 +71,39 @@ void Model::updateDefaultVersion() {
 }
 
 const std::shared_ptr<ModelInstance> Model::getDefaultModelInstance() const {
-    std::shared_lock lock(modelVersionsMtx);
+    const auto snapshot = std::atomic_load(&modelVersionsSnapshot);
     auto defaultVersion = getDefaultVersion();
-    const auto modelInstanceIt = modelVersions.find(defaultVersion);
+    const auto modelInstanceIt = snapshot->find(defaultVersion);
 
-    if (modelVersions.end() == modelInstanceIt) {
+    if (snapshot->end() == modelInstanceIt) {
         SPDLOG_WARN("Default version:{} for model:{} not found", defaultVersion, getName());
         return nullptr;
     }
     return modelInstanceIt->second;
 }
 
+void Model::configureResultCache(const ModelConfig& config) {
+    const size_t maxSizeBytes = config.getResultCacheSizeMb() * 1024 * 1024;
+    const std::chrono::microseconds timeToLive = std::chrono::seconds(config.getResultCacheTtlSeconds());
+    auto current = getResultCache();
+    if (maxSizeBytes > 0 && config.isStateful()) {
+        // cache hit would skip advancing sequence state and return response of another sequence
+        SPDLOG_WARN("Result cache of model: {} is ignored, responses of stateful model depend on sequence state", getName());
+    }
+    if (maxSizeBytes == 0 || config.isStateful()) {
+        if (current) {
+            SPDLOG_INFO("Disabling result cache of model: {}", getName());
+            std::atomic_store(&resultCache, std::shared_ptr<ResultCache>());
+        }
+        return;
+    }
+    if (current && current->getMaxSizeBytes() == maxSizeBytes && current->getTimeToLive() == timeToLive) {
+        return;
+    }
+    SPDLOG_INFO("Enabling result cache of model: {}; size: {} MB; ttl: {} s", getName(), config.getResultCacheSizeMb(), config.getResultCacheTtlSeconds());
+    std::atomic_store(&resultCache, std::make_shared<ResultCache>(maxSizeBytes, timeToLive));
+}
+
 std::shared_ptr<ovms::ModelInstance> Model::modelInstanceFactory(const std::string& modelName, const model_version_t modelVersion) {
     SPDLOG_DEBUG("Producing new ModelInstance");
     return std::move(std::make_shared<ModelInstance>(modelName, modelVersion));
@@ -89,27 +119,72 @@ Status Model::addVersion(const ModelConfig& config) {
     }
     std::unique_lock lock(modelVersionsMtx);
     modelVersions[version] = std::move(modelInstance);
+    publishModelVersionsSnapshot();
     lock.unlock();
     updateDefaultVersion();
     subscriptionManager.notifySubscribers();
     return StatusCode::OK;
 }
 
-Status Model::addVersions(std::shared_ptr<model_versions_t> versionsToStart, ovms::ModelConfig& config) {
+void Model::retireInstance(const std::shared_ptr<ModelInstance>& instance) {
+    if (instance->canUnloadInstance()) {
+        instance->unloadModel();
+        return;
+    }
+    // waiting for inferences in progress would block processing of other versions and models
+    instance->beginRetirement();
+    ModelReaper::getInstance().retire(instance);
+}
+
+Status Model::replaceVersion(const std::shared_ptr<ModelInstance>& currentInstance, const ModelConfig& config) {
+    const auto& version = config.getVersion();
+    std::shared_ptr<ModelInstance> modelInstance = modelInstanceFactory(config.getName(), version);
+    // status snapshot keeps reporting the served instance until it is replaced
+    modelInstance->setStatusPublished(false);
+    auto status = modelInstance->loadModel(config);
+    if (!status.ok()) {
+        // current instance keeps serving with previous config, failed instance is discarded
+        SPDLOG_WARN("Reload of model: {}; version: {} failed, previous instance keeps serving", getName(), version);
+        return status;
+    }
+    modelInstance->takeSubscriptionsFrom(*currentInstance);
+    std::unique_lock lock(modelVersionsMtx);
+    modelVersions[version] = modelInstance;
+    publishModelVersionsSnapshot();
+    lock.unlock();
+    currentInstance->setStatusPublished(false);
+    modelInstance->setStatusPublished(true);
+    updateDefaultVersion();
+    // requests which already got previous instance finish on it
+    if (currentInstance->getStatus().getState() != ModelVersionState::END) {
+        retireInstance(currentInstance);
+    }
+    return StatusCode::OK;
+}
+
+Status Model::addVersions(std::shared_ptr<model_versions_t> versionsToStart, ovms::ModelConfig& config, size_t loadingThreads) {
+    configureResultCache(config);
     Status result = StatusCode::OK;
+    std::mutex resultMtx;
+    std::vector<std::function<void()>> tasks;
     for (const auto version : *versionsToStart) {
-        SPDLOG_INFO("Will add model: {}; version: {} ...", getName(), version);
-        config.setVersion(version);
-        config.parseModelMapping();
-        auto status = addVersion(config);
-        if (!status.ok()) {
-            SPDLOG_ERROR("Error occurred while loading model: {}; version: {}; error: {}",
-                getName(),
-                version,
-                status.string());
-            result = status;
-        }
+        tasks.emplace_back([this, version, &config, &result, &resultMtx]() {
+            SPDLOG_INFO("Will add model: {}; version: {} ...", getName(), version);
+            ModelConfig versionConfig = config;
+            versionConfig.setVersion(version);
+            versionConfig.parseModelMapping();
+            auto status = addVersion(versionConfig);
+            if (!status.ok()) {
+                SPDLOG_ERROR("Error occurred while loading model: {}; version: {}; error: {}",
+                    getName(),
+                    version,
+                    status.string());
+                std::lock_guard<std::mutex> lock(resultMtx);
+                result = status;
+            }
+        });
     }
+    executeInParallel(tasks, loadingThreads);
     return result;
 }
 
@@ -127,7 +202,11 @@ Status Model::retireVersions(std::shared_ptr<model_versions_t> versionsToRetire)
             result = status;
             continue;
         }
-        modelVersion->unloadModel();
+        retireInstance(modelVersion);
+        auto cache = getResultCache();
+        if (cache) {
+            cache->invalidate(version);
+        }
         updateDefaultVersion();
     }
     subscriptionManager.notifySubscribers();
@@ -143,42 +222,66 @@ void Model::retireAllVersions() {
 
     for (const auto versionModelInstancePair : modelVersions) {
         SPDLOG_INFO("Will unload model: {}; version: {} ...", getName(), versionModelInstancePair.first);
-        versionModelInstancePair.second->unloadModel();
+        retireInstance(versionModelInstancePair.second);
         updateDefaultVersion();
     }
+    auto cache = getResultCache();
+    if (cache) {
+        cache->clear();
+    }
     subscriptionManager.notifySubscribers();
 }
 
-Status Model::reloadVersions(std::shared_ptr<model_versions_t> versionsToReload, ovms::ModelConfig& config) {
+Status Model::reloadVersions(std::shared_ptr<model_versions_t> versionsToReload, ovms::ModelConfig& config, size_t loadingThreads) {
+    configureResultCache(config);
     Status result = StatusCode::OK;
+    std::mutex resultMtx;
+    std::vector<std::function<void()>> tasks;
     for (const auto version : *versionsToReload) {
-        SPDLOG_INFO("Will reload model: {}; version: {} ...", getName(), version);
-        config.setVersion(version);
-        auto status = config.parseModelMapping();
-        if ((!status.ok()) && (status != StatusCode::FILE_INVALID)) {
-            SPDLOG_ERROR("Error while parsing model mapping for model {}", status.string());
-        }
+        tasks.emplace_back([this, version, &config, &result, &resultMtx]() {
+            SPDLOG_INFO("Will reload model: {}; version: {} ...", getName(), version);
+            ModelConfig versionConfig = config;
+            versionConfig.setVersion(version);
+            auto status = versionConfig.parseModelMapping();
+            if ((!status.ok()) && (status != StatusCode::FILE_INVALID)) {
+                SPDLOG_ERROR("Error while parsing model mapping for model {}", status.string());
+            }
 
-        auto modelVersion = getModelInstanceByVersion(version);
-        if (!modelVersion) {
-            SPDLOG_ERROR("Error occurred while reloading model: {}; version: {}; error: {}",
-                getName(),
-                version,
-                status.string());
-            result = StatusCode::UNKNOWN_ERROR;
-            continue;
-        }
-        status = modelVersion->reloadModel(config);
-        if (!status.ok()) {
-            SPDLOG_ERROR("Error occurred while loading model: {}; version: {}; error: {}",
-                getName(),
-                version,
-                status.string());
-            result = status;
-            continue;
-        }
-        updateDefaultVersion();
+            auto modelVersion = getModelInstanceByVersion(version);
+            if (!modelVersion) {
+                SPDLOG_ERROR("Error occurred while reloading model: {}; version: {}; error: {}",
+                    getName(),
+                    version,
+                    status.string());
+                std::lock_guard<std::mutex> lock(resultMtx);
+                result = StatusCode::UNKNOWN_ERROR;
+                return;
+            }
+            // custom loaders track loaded versions themselves and would be notified about unload of the replaced instance
+            if (versionConfig.isCustomLoaderRequiredToLoadModel()) {
+                modelVersion->setStatusPublished(true);
+                status = modelVersion->reloadModel(versionConfig);
+            } else {
+                status = replaceVersion(modelVersion, versionConfig);
+            }
+            // responses of previously loaded model files are not valid anymore
+            auto cache = getResultCache();
+            if (cache) {
+                cache->invalidate(version);
+            }
+            if (!status.ok()) {
+                SPDLOG_ERROR("Error occurred while loading model: {}; version: {}; error: {}",
+                    getName(),
+                    version,
+                    status.string());
+                std::lock_guard<std::mutex> lock(resultMtx);
+                result = status;
+                return;
+            }
+            updateDefaultVersion();
+        });
     }
+    executeInParallel(tasks, loadingThreads);
     subscriptionManager.notifySubscribers();
     return result;
 }
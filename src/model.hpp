@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <shared_mutex>
@@ -22,8 +23,11 @@
 #include <utility>
 #include <vector>
 
+#include "loadingprofile.hpp"
+#include "lockmetrics.hpp"
 #include "modelchangesubscription.hpp"
 #include "modelinstance.hpp"
+#include "resultcache.hpp"
 
 namespace ovms {
 class PipelineDefinition;
@@ -34,13 +38,38 @@ private:
     /**
      * @brief Mutex for protecting concurrent modfying and accessing modelVersions
      */
-    mutable std::shared_mutex modelVersionsMtx;
+    mutable InstrumentedMutex<std::shared_mutex> modelVersionsMtx{"model_versions"};
 
     /**
          * @brief Update default version
          */
     void updateDefaultVersion();
 
+    /**
+         * @brief Cache of predict responses shared by model versions, nullptr if disabled
+         */
+    std::shared_ptr<ResultCache> resultCache;
+
+    /**
+         * @brief Durations of versions listing and download of the last load of model versions
+         */
+    LoadingProfile loadingProfile;
+
+    /**
+         * @brief Number of requests which looked up versions of the model since server start
+         */
+    std::atomic<uint64_t> requestsCount{0};
+
+    /**
+         * @brief Creates, recreates or drops result cache according to model config, stateful models are never cached
+         */
+    void configureResultCache(const ModelConfig& config);
+
+    /**
+         * @brief Unloads instance right away if it is idle, otherwise stops it accepting requests and leaves unloading to ModelReaper
+         */
+    void retireInstance(const std::shared_ptr<ModelInstance>& instance);
+
 protected:
     /**
          * @brief Model name
@@ -52,11 +81,24 @@ protected:
          */
     std::map<model_version_t, std::shared_ptr<ModelInstance>> modelVersions;
 
+    /**
+         * @brief Copy of modelVersions published after each change, read by requests without locking modelVersionsMtx
+         */
+    std::shared_ptr<const std::map<model_version_t, std::shared_ptr<ModelInstance>>> modelVersionsSnapshot =
+        std::make_shared<const std::map<model_version_t, std::shared_ptr<ModelInstance>>>();
+
+    /**
+         * @brief Publishes snapshot of modelVersions, has to be called with modelVersionsMtx locked exclusively
+         */
+    void publishModelVersionsSnapshot() {
+        std::atomic_store(&modelVersionsSnapshot, std::make_shared<const std::map<model_version_t, std::shared_ptr<ModelInstance>>>(modelVersions));
+    }
+
     /**
          * @brief Model default version
          *
          */
-    model_version_t defaultVersion = 0;
+    std::atomic<model_version_t> defaultVersion = 0;
 
     /**
          * @brief Get default version
@@ -64,7 +106,7 @@ protected:
          * @return default version
          */
     const model_version_t getDefaultVersion() const {
-        SPDLOG_DEBUG("Getting default version for model:{}, {}", getName(), defaultVersion);
+        SPDLOG_DEBUG("Getting default version for model:{}, {}", getName(), defaultVersion.load());
         return defaultVersion;
     }
 
@@ -77,6 +119,19 @@ protected:
          */
     virtual Status addVersion(const ModelConfig& config);
 
+    /**
+         * @brief Loads version with new config into a new ModelInstance and replaces the current one with it
+         *
+         * Current instance keeps serving requests while the new one is loaded and is unloaded after the swap.
+         * When the new instance fails to load, the current one keeps serving and is not replaced.
+         *
+         * @param currentInstance instance being replaced
+         * @param config model configuration
+         *
+         * @return status
+         */
+    Status replaceVersion(const std::shared_ptr<ModelInstance>& currentInstance, const ModelConfig& config);
+
     /**
          * @brief ModelInstances factory
          *
@@ -99,7 +154,7 @@ public:
     Model(const std::string& name) :
         name(name),
         defaultVersion(0),
-        subscriptionManager(std::string("model: ") + name) {}
+        subscriptionManager(std::string("model: ") + name, name) {}
 
     /**
          * @brief Destroy the Model object
@@ -145,19 +200,20 @@ public:
          * @return specific model version
          */
     const std::shared_ptr<ModelInstance> getModelInstanceByVersion(const model_version_t& version) const {
-        std::shared_lock lock(modelVersionsMtx);
-        auto it = modelVersions.find(version);
-        return it != modelVersions.end() ? it->second : nullptr;
+        const auto snapshot = std::atomic_load(&modelVersionsSnapshot);
+        auto it = snapshot->find(version);
+        return it != snapshot->end() ? it->second : nullptr;
     }
 
     /**
          * @brief Adds new versions of ModelInstance
          *
          * @param config model configuration
+         * @param loadingThreads maximum number of versions loaded concurrently
          *
          * @return status
          */
-    Status addVersions(std::shared_ptr<model_versions_t> versions, ovms::ModelConfig& config);
+    Status addVersions(std::shared_ptr<model_versions_t> versions, ovms::ModelConfig& config, size_t loadingThreads = 1);
 
     /**
          * @brief Retires versions of Model
@@ -177,10 +233,40 @@ public:
          * @brief Reloads versions of Model
          *
          * @param config model configuration
+         * @param loadingThreads maximum number of versions reloaded concurrently
          *
          * @return status
          */
-    Status reloadVersions(std::shared_ptr<model_versions_t> versions, ovms::ModelConfig& config);
+    Status reloadVersions(std::shared_ptr<model_versions_t> versions, ovms::ModelConfig& config, size_t loadingThreads = 1);
+
+    /**
+         * @brief Gets cache of predict responses
+         *
+         * @return result cache or nullptr if disabled
+         */
+    std::shared_ptr<ResultCache> getResultCache() const {
+        return std::atomic_load(&resultCache);
+    }
+
+    /**
+         * @brief Gets durations of versions listing and download
+         *
+         * @return loading profile
+         */
+    LoadingProfile& getLoadingProfile() {
+        return loadingProfile;
+    }
+
+    void countRequest() {
+        requestsCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+         * @brief Gets number of requests to the model since server start, used to order loading of models after restart
+         */
+    uint64_t getRequestsCount() const {
+        return requestsCount.load(std::memory_order_relaxed);
+    }
 
     void subscribe(PipelineDefinition& pd);
     void unsubscribe(PipelineDefinition& pd);
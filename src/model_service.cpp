@@ -29,6 +29,8 @@
 #include "tensorflow_serving/apis/model_service.pb.h"
 #pragma GCC diagnostic pop
 
+#include "metrics.hpp"
+#include "modelinstanceunloadguard.hpp"
 #include "modelmanager.hpp"
 #include "status.hpp"
 
@@ -44,7 +46,36 @@ void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response,
     status_to_fill->set_version(version);
     status_to_fill->clear_status();
     status_to_fill->mutable_status()->set_error_code(static_cast<tensorflow::error::Code>(static_cast<int>(model_version_status.getErrorCode())));
-    status_to_fill->mutable_status()->set_error_message(model_version_status.getErrorMsg());
+    if (model_version_status.getDetails().empty()) {
+        status_to_fill->mutable_status()->set_error_message(model_version_status.getErrorMsg());
+    } else {
+        status_to_fill->mutable_status()->set_error_message(model_version_status.getErrorMsg() + "; " + model_version_status.getDetails());
+    }
+}
+
+namespace {
+uint64_t averageMicroseconds(const LatencyHistogram& histogram) {
+    const auto count = histogram.getCount();
+    return count == 0 ? 0 : histogram.getSumMicroseconds() / count;
+}
+}  // namespace
+
+void addStatsToResponse(tensorflow::serving::ModelVersionStatus* status_to_fill, ModelInstance& instance) {
+    // Streams pool exists only while model version is loaded, guard holds off unloading while it is read
+    ModelInstanceUnloadGuard unloadGuard(instance);
+    if (instance.getStatus().getState() != ModelVersionState::AVAILABLE) {
+        return;
+    }
+    const auto& metrics = instance.getMetrics();
+    const auto errors = metrics.requestsFail.load(std::memory_order_relaxed);
+    auto stats = status_to_fill->mutable_stats();
+    stats->set_requests(metrics.requestsSuccess.load(std::memory_order_relaxed) + errors);
+    stats->set_errors(errors);
+    stats->set_in_flight(metrics.requestsInFlight.load(std::memory_order_relaxed));
+    stats->set_average_queue_wait_us(averageMicroseconds(metrics.streamWait));
+    stats->set_average_inference_us(averageMicroseconds(metrics.inference));
+    stats->set_idle_infer_requests(instance.getInferRequestsQueue().getIdleStreamsCount());
+    stats->set_hugepages_bytes(instance.getHugePagesIOBlobsBytes());
 }
 
 void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response, const model_version_t version, const PipelineDefinitionStatus& pipeline_status) {
@@ -118,6 +149,7 @@ Status GetModelStatusImpl::getModelStatus(
         const auto& status = model_instance->getStatus();
         SPDLOG_DEBUG("adding model {} - {} :: {} to response", requested_model_name, requested_version, status.getStateString());
         addStatusToResponse(response, requested_version, status);
+        addStatsToResponse(response->mutable_model_version_status(response->model_version_status_size() - 1), *model_instance);
     } else {
         // return status details of all versions of a requested model.
         auto modelVersionsInstances = model_ptr->getModelVersionsMapCopy();
@@ -125,6 +157,10 @@ Status GetModelStatusImpl::getModelStatus(
             const auto& status = modelInstance.getStatus();
             SPDLOG_DEBUG("adding model {} - {} :: {} to response", requested_model_name, modelVersion, status.getStateString());
             addStatusToResponse(response, modelVersion, status);
+            auto instance = model_ptr->getModelInstanceByVersion(modelVersion);
+            if (instance) {
+                addStatsToResponse(response->mutable_model_version_status(response->model_version_status_size() - 1), *instance);
+            }
         }
     }
     SPDLOG_DEBUG("model_service: response: {}", response->DebugString());
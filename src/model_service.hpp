@@ -35,6 +35,11 @@ namespace ovms {
 
 void addStatusToResponse(tensorflow::serving::GetModelStatusResponse* response, model_version_t version, const ModelVersionStatus& model_version_status);
 
+/**
+ * @brief Fills serving counters of model version into its status, left empty unless version is AVAILABLE
+ */
+void addStatsToResponse(tensorflow::serving::ModelVersionStatus* status_to_fill, ModelInstance& instance);
+
 class ModelServiceImpl final : public tensorflow::serving::ModelService::Service {
 public:
     ::grpc::Status GetModelStatus(::grpc::ServerContext* context,
@@ -16,6 +16,7 @@
 #include "modelchangesubscription.hpp"
 
 #include <exception>
+#include <mutex>
 #include <sstream>
 
 #include "pipelinedefinition.hpp"
@@ -49,9 +50,20 @@ void ModelChangeSubscription::notifySubscribers() {
     if (subscriptions.size() == 0) {
         return;
     }
+    // models are loaded concurrently and may notify the same pipeline definition
+    static std::mutex notificationMtx;
+    std::lock_guard<std::mutex> lock(notificationMtx);
     SPDLOG_INFO("Notified subscribers of:{}", ownerName);
     for (auto& [pipelineName, pipelineDefinition] : subscriptions) {
-        pipelineDefinition.notifyUsedModelChanged(ownerName);
+        pipelineDefinition.notifyUsedModelChanged(ownerName, modelName);
     }
 }
+
+void ModelChangeSubscription::transferTo(ModelChangeSubscription& other) {
+    for (auto& [pipelineName, pipelineDefinition] : subscriptions) {
+        SPDLOG_INFO("Subscription to {} from {} moved to new instance", ownerName, pipelineName);
+        other.subscriptions.insert({pipelineName, pipelineDefinition});
+    }
+    subscriptions.clear();
+}
 }  // namespace ovms
@@ -25,16 +25,23 @@ class PipelineDefinition;
 
 class ModelChangeSubscription {
     const std::string ownerName;
+    const std::string modelName;
     std::unordered_map<std::string, PipelineDefinition&> subscriptions;
 
 public:
-    ModelChangeSubscription(const std::string& ownerName) :
-        ownerName(ownerName) {}
+    ModelChangeSubscription(const std::string& ownerName, const std::string& modelName) :
+        ownerName(ownerName),
+        modelName(modelName) {}
 
     void subscribe(PipelineDefinition& pd);
 
     void unsubscribe(PipelineDefinition& pd);
 
     void notifySubscribers();
+
+    /**
+     * @brief Moves all subscriptions to other owner, used when model version instance is replaced
+     */
+    void transferTo(ModelChangeSubscription& other);
 };
 }  // namespace ovms
@@ -29,6 +29,19 @@
 
 namespace ovms {
 
+std::vector<std::string> ModelConfig::getBalancedTargetDevices() const {
+    static const std::string prefix = "BALANCE:";
+    if (this->targetDevice.compare(0, prefix.size(), prefix) != 0) {
+        return {};
+    }
+    auto devices = tokenize(this->targetDevice.substr(prefix.size()), ',');
+    for (auto& device : devices) {
+        trim(device);
+    }
+    devices.erase(std::remove(devices.begin(), devices.end(), ""), devices.end());
+    return devices;
+}
+
 bool ModelConfig::isReloadRequired(const ModelConfig& rhs) const {
     if (this->name != rhs.name) {
         SPDLOG_DEBUG("ModelConfig {} reload required due to name mismatch", this->name);
@@ -50,10 +63,126 @@ bool ModelConfig::isReloadRequired(const ModelConfig& rhs) const {
         SPDLOG_DEBUG("ModelConfig {} reload required due to batch size mismatch", this->name);
         return true;
     }
+    if (this->maxBatchSize != rhs.maxBatchSize) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to max batch size mismatch", this->name);
+        return true;
+    }
+    if (this->batchTimeoutMicroseconds != rhs.batchTimeoutMicroseconds) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to batch timeout mismatch", this->name);
+        return true;
+    }
+    if (this->batchLatencySloMicroseconds != rhs.batchLatencySloMicroseconds) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to batch latency SLO mismatch", this->name);
+        return true;
+    }
+    if (this->splitBatch != rhs.splitBatch) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to batch splitting mismatch", this->name);
+        return true;
+    }
+    if (this->numaNode != rhs.numaNode) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to NUMA node mismatch", this->name);
+        return true;
+    }
+    if (this->cpuSet != rhs.cpuSet) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to CPU set mismatch", this->name);
+        return true;
+    }
+    if (this->cpuSetExclusive != rhs.cpuSetExclusive) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to exclusive CPU set mismatch", this->name);
+        return true;
+    }
+    if (this->numaReplicas != rhs.numaReplicas) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to NUMA replicas mismatch", this->name);
+        return true;
+    }
+    if (this->maxQueueSize != rhs.maxQueueSize) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to max queue size mismatch", this->name);
+        return true;
+    }
+    if (this->queueTimeoutMicroseconds != rhs.queueTimeoutMicroseconds) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to queue timeout mismatch", this->name);
+        return true;
+    }
+    if (this->resultCacheSizeMb != rhs.resultCacheSizeMb) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to result cache size mismatch", this->name);
+        return true;
+    }
+    if (this->resultCacheTtlSeconds != rhs.resultCacheTtlSeconds) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to result cache TTL mismatch", this->name);
+        return true;
+    }
+    if (this->inFlightMemoryBudgetMb != rhs.inFlightMemoryBudgetMb) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to in flight memory budget mismatch", this->name);
+        return true;
+    }
+    if (this->deviceSchedulingWeight != rhs.deviceSchedulingWeight) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to device scheduling weight mismatch", this->name);
+        return true;
+    }
+    if (this->fp16Outputs != rhs.fp16Outputs) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to fp16 outputs mismatch", this->name);
+        return true;
+    }
+    if (this->inlineInference != rhs.inlineInference) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to inline inference mismatch", this->name);
+        return true;
+    }
+    if (this->completionSpinMicroseconds != rhs.completionSpinMicroseconds) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to completion spin time mismatch", this->name);
+        return true;
+    }
+    if (this->reuseInputBlobs != rhs.reuseInputBlobs) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to reuse input blobs mismatch", this->name);
+        return true;
+    }
+    if (this->hugePagesIOBlobs != rhs.hugePagesIOBlobs) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to hugepages io blobs mismatch", this->name);
+        return true;
+    }
+    if (this->remoteIOBlobs != rhs.remoteIOBlobs) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to remote io blobs mismatch", this->name);
+        return true;
+    }
+    if (this->leanMemory != rhs.leanMemory) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to lean memory mismatch", this->name);
+        return true;
+    }
+    if (this->stateful != rhs.stateful) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to stateful mismatch", this->name);
+        return true;
+    }
+    if (this->sequenceTimeoutSeconds != rhs.sequenceTimeoutSeconds) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to sequence timeout mismatch", this->name);
+        return true;
+    }
+    if (this->networkCacheSize != rhs.networkCacheSize) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to network cache size mismatch", this->name);
+        return true;
+    }
+    if (this->shapeBuckets != rhs.shapeBuckets) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to shape buckets mismatch", this->name);
+        return true;
+    }
     if (this->nireq != rhs.nireq) {
         SPDLOG_DEBUG("ModelConfig {} reload required due to nireq mismatch", this->name);
         return true;
     }
+    if (this->maxNireq != rhs.maxNireq) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to max nireq mismatch", this->name);
+        return true;
+    }
+    if (this->latencyNireq != rhs.latencyNireq) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to latency nireq mismatch", this->name);
+        return true;
+    }
+    if (this->autoTune != rhs.autoTune || this->autoTuneLatencyMs != rhs.autoTuneLatencyMs) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to auto tuning mismatch", this->name);
+        return true;
+    }
+    if (this->readinessMaxWaitingRequests != rhs.readinessMaxWaitingRequests || this->readinessMaxQueueWaitMs != rhs.readinessMaxQueueWaitMs) {
+        SPDLOG_DEBUG("ModelConfig {} reload required due to readiness thresholds mismatch", this->name);
+        return true;
+    }
     if (this->pluginConfig != rhs.pluginConfig) {
         SPDLOG_DEBUG("ModelConfig {} reload required due to plugin config mismatch", this->name);
         return true;
@@ -280,13 +409,25 @@ Status ModelConfig::parseModelMapping() {
     std::filesystem::path path = this->getPath();
     path.append(MAPPING_CONFIG_JSON);
 
-    std::ifstream ifs(path.c_str());
-    if (!ifs.good()) {
-        return StatusCode::FILE_INVALID;
+    // mapping of version read into memory is read with its model files
+    auto inMemoryFiles = getInMemoryModelFiles(getVersion());
+    std::ifstream ifs;
+    std::istringstream iss;
+    if (inMemoryFiles) {
+        if (inMemoryFiles->mapping.empty()) {
+            return StatusCode::FILE_INVALID;
+        }
+        iss.str(inMemoryFiles->mapping);
+    } else {
+        ifs.open(path.c_str());
+        if (!ifs.good()) {
+            return StatusCode::FILE_INVALID;
+        }
     }
+    std::istream& is = inMemoryFiles ? static_cast<std::istream&>(iss) : ifs;
 
     rapidjson::Document doc;
-    rapidjson::IStreamWrapper isw(ifs);
+    rapidjson::IStreamWrapper isw(is);
     if (doc.ParseStream(isw).HasParseError()) {
         SPDLOG_ERROR("Configuration file is not a valid JSON file.");
         return StatusCode::JSON_INVALID;
@@ -336,6 +477,79 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
     }
     if (v.HasMember("nireq"))
         this->setNireq(v["nireq"].GetUint64());
+    if (v.HasMember("max_nireq"))
+        this->setMaxNireq(v["max_nireq"].GetUint64());
+    if (v.HasMember("latency_nireq"))
+        this->setLatencyNireq(v["latency_nireq"].GetUint64());
+    if (v.HasMember("auto_tune"))
+        this->setAutoTune(v["auto_tune"].GetBool());
+    if (v.HasMember("auto_tune_latency_ms"))
+        this->setAutoTuneLatencyMs(v["auto_tune_latency_ms"].GetUint64());
+    if (v.HasMember("readiness_max_waiting_requests"))
+        this->setReadinessMaxWaitingRequests(v["readiness_max_waiting_requests"].GetUint64());
+    if (v.HasMember("readiness_max_queue_wait_ms"))
+        this->setReadinessMaxQueueWaitMs(v["readiness_max_queue_wait_ms"].GetUint64());
+    if (v.HasMember("max_batch_size"))
+        this->setMaxBatchSize(v["max_batch_size"].GetUint64());
+    if (v.HasMember("batch_timeout_microseconds"))
+        this->setBatchTimeoutMicroseconds(v["batch_timeout_microseconds"].GetUint64());
+    if (v.HasMember("batch_latency_slo_microseconds"))
+        this->setBatchLatencySloMicroseconds(v["batch_latency_slo_microseconds"].GetUint64());
+    if (v.HasMember("split_batch"))
+        this->setSplitBatch(v["split_batch"].GetBool());
+    if (v.HasMember("reuse_input_blobs"))
+        this->setReuseInputBlobs(v["reuse_input_blobs"].GetBool());
+    if (v.HasMember("hugepages_io_blobs"))
+        this->setHugePagesIOBlobs(v["hugepages_io_blobs"].GetBool());
+    if (v.HasMember("remote_io_blobs"))
+        this->setRemoteIOBlobs(v["remote_io_blobs"].GetBool());
+    if (v.HasMember("lean_memory"))
+        this->setLeanMemory(v["lean_memory"].GetBool());
+    if (v.HasMember("download_to_memory"))
+        this->setDownloadToMemory(v["download_to_memory"].GetBool());
+    if (v.HasMember("stateful"))
+        this->setStateful(v["stateful"].GetBool());
+    if (v.HasMember("sequence_timeout_seconds"))
+        this->setSequenceTimeoutSeconds(v["sequence_timeout_seconds"].GetUint());
+    if (v.HasMember("network_cache_size"))
+        this->setNetworkCacheSize(v["network_cache_size"].GetUint64());
+    if (v.HasMember("warmup_iterations"))
+        this->setWarmupIterations(v["warmup_iterations"].GetUint64());
+    if (v.HasMember("warmup_data")) {
+        std::map<std::string, std::string> warmupData;
+        for (auto& s : v["warmup_data"].GetObject()) {
+            warmupData[s.name.GetString()] = s.value.GetString();
+        }
+        this->setWarmupData(warmupData);
+    }
+    if (v.HasMember("numa_node"))
+        this->setNumaNode(v["numa_node"].GetInt());
+    if (v.HasMember("cpu_set"))
+        this->setCpuSet(v["cpu_set"].GetString());
+    if (v.HasMember("cpu_set_exclusive"))
+        this->setCpuSetExclusive(v["cpu_set_exclusive"].GetBool());
+    if (v.HasMember("numa_replicas"))
+        this->setNumaReplicas(v["numa_replicas"].GetBool());
+    if (v.HasMember("max_queue_size"))
+        this->setMaxQueueSize(v["max_queue_size"].GetUint64());
+    if (v.HasMember("queue_timeout_microseconds"))
+        this->setQueueTimeoutMicroseconds(v["queue_timeout_microseconds"].GetUint64());
+    if (v.HasMember("result_cache_size_mb"))
+        this->setResultCacheSizeMb(v["result_cache_size_mb"].GetUint64());
+    if (v.HasMember("result_cache_ttl_seconds"))
+        this->setResultCacheTtlSeconds(v["result_cache_ttl_seconds"].GetUint64());
+    if (v.HasMember("in_flight_memory_budget_mb"))
+        this->setInFlightMemoryBudgetMb(v["in_flight_memory_budget_mb"].GetUint64());
+    if (v.HasMember("lazy_load"))
+        this->setLazyLoad(v["lazy_load"].GetBool());
+    if (v.HasMember("fp16_outputs"))
+        this->setFp16Outputs(v["fp16_outputs"].GetBool());
+    if (v.HasMember("inline_inference"))
+        this->setInlineInference(v["inline_inference"].GetBool());
+    if (v.HasMember("completion_spin_microseconds"))
+        this->setCompletionSpinMicroseconds(v["completion_spin_microseconds"].GetUint());
+    if (v.HasMember("device_scheduling_weight"))
+        this->setDeviceSchedulingWeight(v["device_scheduling_weight"].GetUint());
 
     if (v.HasMember("shape")) {
         // Legacy format as string
@@ -377,6 +591,23 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
         }
     }
 
+    if (v.HasMember("shape_buckets")) {
+        for (auto& s : v["shape_buckets"].GetObject()) {
+            std::vector<shape_t> buckets;
+            for (auto& b : s.value.GetArray()) {
+                shape_t bucket;
+                for (auto& dim : b.GetArray()) {
+                    bucket.push_back(dim.GetUint64());
+                }
+                buckets.push_back(std::move(bucket));
+            }
+            if (!this->isShapeAuto(s.name.GetString())) {
+                SPDLOG_WARN("Shape buckets for input: {} are used only when its shape is set to auto", s.name.GetString());
+            }
+            this->addShapeBuckets(s.name.GetString(), std::move(buckets));
+        }
+    }
+
     if (v.HasMember("layout")) {
         if (v["layout"].IsString()) {
             this->setLayout(v["layout"].GetString());
@@ -416,6 +647,11 @@ Status ModelConfig::parseNode(const rapidjson::Value& v) {
         setBatchSize(0);
     }
 
+    if (isDynamicBatchingEnabled() && (getBatchingMode() == AUTO || anyShapeSetToAuto())) {
+        SPDLOG_WARN("Dynamic batching cannot be used together with automatic batch size or shape. Parameter max_batch_size will be ignored.");
+        setMaxBatchSize(0);
+    }
+
     // if the config has models which require custom loader to be used, then load the same here
     if (v.HasMember("custom_loader_options")) {
         if (!parseCustomLoaderOptionsConfig(v["custom_loader_options"]).ok()) {
@@ -15,12 +15,16 @@
 //*****************************************************************************
 #pragma once
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
@@ -48,6 +52,7 @@ struct ShapeInfo {
 };
 
 using shapes_map_t = std::unordered_map<std::string, ShapeInfo>;
+using shape_buckets_map_t = std::map<std::string, std::vector<shape_t>>;
 using layouts_map_t = std::unordered_map<std::string, std::string>;
 using mapping_config_t = std::unordered_map<std::string, std::string>;
 using plugin_config_t = std::map<std::string, std::string>;
@@ -56,6 +61,15 @@ using custom_loader_options_config_t = std::map<std::string, std::string>;
 const std::string ANONYMOUS_INPUT_NAME = "ANONYMOUS_INPUT_NAME";
 const std::string MAPPING_CONFIG_JSON = "mapping_config.json";
 
+/**
+     * @brief Model version files read from cloud storage into memory, weights are empty for ONNX models and mapping if not present
+     */
+struct InMemoryModelFiles {
+    std::string model;
+    std::string weights;
+    std::string mapping;
+};
+
 /**
      * @brief This class represents model configuration
      */
@@ -76,6 +90,16 @@ private:
          */
     std::string localPath;
 
+    /**
+         * @brief Directory with compiled networks exported for reuse between server restarts, empty if disabled
+         */
+    std::string compiledModelCacheDir;
+
+    /**
+         * @brief Share compiled network with other loaded model versions with identical model files, device, plugin config and inputs
+         */
+    bool shareCompiledNetworks = false;
+
     /**
          * @brief Target device
          */
@@ -91,6 +115,151 @@ private:
          */
     size_t batchSize;
 
+    /**
+         * @brief Maximum batch size assembled from concurrent requests by dynamic batching, 0 disables it
+         */
+    size_t maxBatchSize = 0;
+
+    /**
+         * @brief Maximum time the first request of a dynamic batch waits for subsequent ones
+         */
+    uint64_t batchTimeoutMicroseconds = 0;
+
+    /**
+         * @brief Latency target of dynamic batching, tuning timeout up to batchTimeoutMicroseconds when set, 0 for fixed timeout
+         */
+    uint64_t batchLatencySloMicroseconds = 0;
+
+    /**
+         * @brief Flag determining if requests with batch larger than network batch size are split into sub-batches
+         */
+    bool splitBatch = false;
+
+    /**
+         * @brief Flag determining if requests are deserialized into input blobs allocated by infer requests
+         */
+    bool reuseInputBlobs = false;
+
+    /**
+         * @brief Flag determining if input and output blobs of infer requests are allocated from hugepages
+         */
+    bool hugePagesIOBlobs = false;
+
+    /**
+         * @brief Flag determining if input and output blobs of infer requests are allocated in remote context of GPU device
+         */
+    bool remoteIOBlobs = false;
+
+    /**
+         * @brief Flag determining if host copy of network is released once it is compiled for device
+         */
+    bool leanMemory = false;
+
+    /**
+         * @brief Flag determining if model files from cloud storage are read into memory instead of downloaded to temporary directory
+         */
+    bool downloadToMemory = false;
+
+    /**
+         * @brief Model files read into memory by versions, released once versions are loaded
+         */
+    std::map<model_version_t, std::shared_ptr<const InMemoryModelFiles>> inMemoryModelFiles;
+
+    /**
+         * @brief Flag determining if model keeps state between requests of a sequence in memory states of infer request
+         */
+    bool stateful = false;
+
+    /**
+         * @brief Time after which sequence of stateful model which received no requests is removed, 0 if never
+         */
+    uint32_t sequenceTimeoutSeconds = 60;
+
+    /**
+         * @brief Number of networks compiled for previously requested shapes kept for auto batch size or shape, 0 disables it
+         */
+    size_t networkCacheSize = 0;
+
+    /**
+         * @brief Number of warm up inferences run with each infer request before model version is available
+         */
+    size_t warmupIterations = 0;
+
+    /**
+         * @brief Paths of .npy files with warm up samples, keyed by input name
+         */
+    std::map<std::string, std::string> warmupData;
+
+    /**
+         * @brief NUMA node which CPUs are used for loading and inference, -1 if not set
+         */
+    int numaNode = -1;
+
+    /**
+         * @brief List of CPUs used for loading and inference, takes precedence over NUMA node
+         */
+    std::string cpuSet;
+
+    /**
+         * @brief CPUs of the model are reserved exclusively, other models do not run on them
+         */
+    bool cpuSetExclusive = false;
+
+    /**
+         * @brief Network is compiled once for each NUMA node, requests use replica of node they are handled on
+         */
+    bool numaReplicas = false;
+
+    /**
+         * @brief Maximum number of requests waiting for infer request, 0 for no limit
+         */
+    size_t maxQueueSize = 0;
+
+    /**
+         * @brief Maximum time request waits for infer request, 0 for no limit
+         */
+    uint64_t queueTimeoutMicroseconds = 0;
+
+    /**
+         * @brief Memory limit of cached predict responses in megabytes, 0 disables result cache
+         */
+    size_t resultCacheSizeMb = 0;
+
+    /**
+         * @brief Time after which cached predict responses expire, 0 for no expiration
+         */
+    uint64_t resultCacheTtlSeconds = 0;
+
+    /**
+         * @brief Estimated memory of requests in progress above which new requests are rejected, 0 for no limit
+         */
+    size_t inFlightMemoryBudgetMb = 0;
+
+    /**
+         * @brief Flag determining if model versions are loaded by their first request instead of at startup
+         */
+    bool lazyLoad = false;
+
+    /**
+         * @brief Flag determining if FP32 outputs are sent as FP16
+         */
+    bool fp16Outputs = false;
+
+    /**
+         * @brief Flag determining if inference runs synchronously on request thread when no request waits for infer request
+         */
+    bool inlineInference = false;
+
+    /**
+         * @brief Time of polling infer request status before blocking wait for its completion, 0 for blocking wait only
+         */
+    uint32_t completionSpinMicroseconds = 0;
+
+    /**
+         * @brief Share of device concurrency limit given to the model when device is saturated, relative to other models on it
+         */
+    uint32_t deviceSchedulingWeight = 1;
+
     /**
          * @brief Model version policy
          */
@@ -101,6 +270,36 @@ private:
          */
     uint64_t nireq;
 
+    /**
+         * @brief Upper bound of infer requests pool growing at runtime, 0 for fixed nireq
+         */
+    uint64_t maxNireq = 0;
+
+    /**
+         * @brief Number of infer requests of additional network compiled for latency, 0 if it is not loaded
+         */
+    uint64_t latencyNireq = 0;
+
+    /**
+         * @brief Flag determining if CPU streams and nireq are selected by benchmarking the model while it is loading
+         */
+    bool autoTune = false;
+
+    /**
+         * @brief Maximum inference latency of configuration selected by auto tuning, 0 for no limit
+         */
+    uint64_t autoTuneLatencyMs = 0;
+
+    /**
+         * @brief Number of requests waiting for infer request above which server reports not ready, 0 for no limit
+         */
+    uint64_t readinessMaxWaitingRequests = 0;
+
+    /**
+         * @brief 99th percentile of wait for infer request above which server reports not ready, 0 for no limit
+         */
+    uint64_t readinessMaxQueueWaitMs = 0;
+
     /**
          * @brief Plugin config
          */
@@ -116,6 +315,11 @@ private:
          */
     shapes_map_t shapes;
 
+    /**
+         * @brief Shapes that requests to inputs with auto shape are padded up to, sorted by number of elements
+         */
+    shape_buckets_map_t shapeBuckets;
+
     /**
          * @brief Map of layouts
          */
@@ -275,6 +479,42 @@ public:
         this->localPath = localPath;
     }
 
+    /**
+         * @brief Get the compiled model cache directory
+         * 
+         * @return const std::string& 
+         */
+    const std::string& getCompiledModelCacheDir() const {
+        return this->compiledModelCacheDir;
+    }
+
+    /**
+         * @brief Set the compiled model cache directory
+         * 
+         * @param compiledModelCacheDir 
+         */
+    void setCompiledModelCacheDir(const std::string& compiledModelCacheDir) {
+        this->compiledModelCacheDir = compiledModelCacheDir;
+    }
+
+    /**
+         * @brief Checks if compiled network is shared with identical model versions
+         * 
+         * @return bool
+         */
+    bool isShareCompiledNetworks() const {
+        return this->shareCompiledNetworks;
+    }
+
+    /**
+         * @brief Set if compiled network is shared with identical model versions
+         * 
+         * @param shareCompiledNetworks
+         */
+    void setShareCompiledNetworks(bool shareCompiledNetworks) {
+        this->shareCompiledNetworks = shareCompiledNetworks;
+    }
+
     /**
          * @brief Get the target device
          * 
@@ -308,9 +548,20 @@ public:
          * @param bool
          */
     bool isDeviceUsed(const std::string& device) const {
-        return this->targetDevice == device || this->isHeteroTargetDevice(device);
+        if (this->targetDevice == device || this->isHeteroTargetDevice(device)) {
+            return true;
+        }
+        const auto balancedDevices = this->getBalancedTargetDevices();
+        return std::find(balancedDevices.begin(), balancedDevices.end(), device) != balancedDevices.end();
     }
 
+    /**
+         * @brief Gets devices requests are balanced between when target device is in format BALANCE:<DEVICE_1>,<DEVICE_2>
+         * 
+         * @return devices or empty vector if target device is not balanced
+         */
+    std::vector<std::string> getBalancedTargetDevices() const;
+
     /**
          * @brief Get the batching mode
          * 
@@ -403,165 +654,846 @@ public:
     Status parseModelVersionPolicy(std::string command);
 
     /**
-         * @brief Get the nireq
+         * @brief Get the dynamic batching max batch size
          * 
-         * @return uint64_t 
+         * @return size_t 
          */
-    uint64_t getNireq() const {
-        return this->nireq;
+    size_t getMaxBatchSize() const {
+        return this->maxBatchSize;
     }
 
     /**
-         * @brief Set the nireq
+         * @brief Set the dynamic batching max batch size
          * 
-         * @param nireq 
+         * @param maxBatchSize 
          */
-    void setNireq(const uint64_t nireq) {
-        this->nireq = nireq;
+    void setMaxBatchSize(const size_t maxBatchSize) {
+        this->maxBatchSize = maxBatchSize;
     }
 
     /**
-         * @brief Get the plugin config
+         * @brief Get the dynamic batching timeout
          * 
-         * @return const std::string&
+         * @return uint64_t 
          */
-    const plugin_config_t& getPluginConfig() const {
-        return this->pluginConfig;
+    uint64_t getBatchTimeoutMicroseconds() const {
+        return this->batchTimeoutMicroseconds;
     }
 
     /**
-         * @brief Set the plugin config
+         * @brief Set the dynamic batching timeout
          * 
-         * @param pluginConfig 
+         * @param batchTimeoutMicroseconds 
          */
-    void setPluginConfig(const plugin_config_t& pluginConfig) {
-        this->pluginConfig = pluginConfig;
+    void setBatchTimeoutMicroseconds(const uint64_t batchTimeoutMicroseconds) {
+        this->batchTimeoutMicroseconds = batchTimeoutMicroseconds;
     }
 
     /**
-         * @brief Parses json node for plugin config keys and values
+         * @brief Get the dynamic batching latency target
          * 
-         * @param json node representing plugin_config
-         * 
-         * @return status
+         * @return uint64_t 
          */
-    Status parsePluginConfig(const rapidjson::Value& node);
+    uint64_t getBatchLatencySloMicroseconds() const {
+        return this->batchLatencySloMicroseconds;
+    }
 
     /**
-         * @brief Parses string for plugin config keys and values
-         * 
-         * @param string representing plugin_config
+         * @brief Set the dynamic batching latency target
          * 
-         * @return status
+         * @param batchLatencySloMicroseconds 
          */
-    Status parsePluginConfig(std::string command) {
-        rapidjson::Document node;
-        if (command.empty()) {
-            return StatusCode::OK;
-        }
-        if (node.Parse(command.c_str()).HasParseError()) {
-            return StatusCode::PLUGIN_CONFIG_WRONG_FORMAT;
-        }
-
-        return parsePluginConfig(node);
+    void setBatchLatencySloMicroseconds(const uint64_t batchLatencySloMicroseconds) {
+        this->batchLatencySloMicroseconds = batchLatencySloMicroseconds;
     }
 
     /**
-         * @brief Parses value from json and extracts shapes info
+         * @brief Checks if requests with batch larger than network batch size are split into sub-batches
          * 
-         * @param rapidjson::Value& node
+         * @return bool
+         */
+    bool isSplitBatch() const {
+        return this->splitBatch;
+    }
+
+    /**
+         * @brief Set if requests with batch larger than network batch size are split into sub-batches
          * 
-         * @return status
+         * @param splitBatch 
          */
-    Status parseShapeParameter(const rapidjson::Value& node);
+    void setSplitBatch(const bool splitBatch) {
+        this->splitBatch = splitBatch;
+    }
 
     /**
-         * @brief Parses value from string and extracts shapes info
+         * @brief Get the number of warm up inferences of each infer request
          * 
-         * @param string
+         * @return size_t 
+         */
+    size_t getWarmupIterations() const {
+        return this->warmupIterations;
+    }
+
+    /**
+         * @brief Set the number of warm up inferences of each infer request
          * 
-         * @return status
+         * @param warmupIterations 
          */
-    Status parseShapeParameter(const std::string& command);
+    void setWarmupIterations(const size_t warmupIterations) {
+        this->warmupIterations = warmupIterations;
+    }
 
     /**
-         * @brief Returns true if any input shape specified in shapes map is in AUTO mode
+         * @brief Get the warm up samples files
          * 
-         * @return bool
+         * @return const std::map<std::string, std::string>& 
          */
-    bool anyShapeSetToAuto() const {
-        for (const auto& [name, shapeInfo] : getShapes()) {
-            if (shapeInfo.shapeMode == AUTO)
-                return true;
-        }
-        return false;
+    const std::map<std::string, std::string>& getWarmupData() const {
+        return this->warmupData;
     }
 
     /**
-         * @brief Get the shapes
+         * @brief Set the warm up samples files
          * 
-         * @return const shapes_map_t& 
+         * @param warmupData 
          */
-    const shapes_map_t& getShapes() const {
-        return this->shapes;
+    void setWarmupData(const std::map<std::string, std::string>& warmupData) {
+        this->warmupData = warmupData;
     }
 
     /**
-         * @brief Set the shapes
+         * @brief Get the NUMA node
          * 
-         * @param shapes 
+         * @return int 
          */
-    void setShapes(const shapes_map_t& shapes) {
-        this->shapes = shapes;
+    int getNumaNode() const {
+        return this->numaNode;
     }
 
     /**
-        * @brief Returns true if shape with certain name is in AUTO mode
+         * @brief Set the NUMA node
          * 
-         * @return bool
+         * @param numaNode 
          */
-    bool isShapeAuto(const std::string& name) const {
-        auto it = getShapes().find(name);
-        if (it == getShapes().end()) {
-            it = getShapes().find(ANONYMOUS_INPUT_NAME);
-        }
-        if (it == getShapes().end()) {
-            return false;
-        }
-        return it->second.shapeMode == Mode::AUTO;
+    void setNumaNode(const int numaNode) {
+        this->numaNode = numaNode;
     }
 
-    bool isShapeAnonymous() const {
-        return getShapes().size() == 1 && getShapes().begin()->first == ANONYMOUS_INPUT_NAME;
+    /**
+         * @brief Get the CPU set
+         * 
+         * @return const std::string& 
+         */
+    const std::string& getCpuSet() const {
+        return this->cpuSet;
     }
 
-    bool isShapeAnonymousFixed() const {
-        return isShapeAnonymous() && !isShapeAuto(ANONYMOUS_INPUT_NAME);
+    /**
+         * @brief Set the CPU set
+         * 
+         * @param cpuSet 
+         */
+    void setCpuSet(const std::string& cpuSet) {
+        this->cpuSet = cpuSet;
     }
 
     /**
-         * @brief Sets the shape from the string representation
-         *
-         * @param shape
-         * @param str
-         * @return Status
+         * @brief Checks whether CPUs of the model are reserved exclusively
+         * 
+         * @return bool
          */
-    static Status parseShape(ShapeInfo& shapeInfo, const std::string& str);
+    bool isCpuSetExclusive() const {
+        return this->cpuSetExclusive;
+    }
 
     /**
-         * @brief Add a single named shape
+         * @brief Set whether CPUs of the model are reserved exclusively
          * 
-         * @param name 
-         * @param shape 
+         * @param cpuSetExclusive 
          */
-    void addShape(const std::string& name, const ShapeInfo& shapeInfo) {
-        this->shapes[name] = shapeInfo;
+    void setCpuSetExclusive(const bool cpuSetExclusive) {
+        this->cpuSetExclusive = cpuSetExclusive;
+    }
+
+    /**
+         * @brief Checks whether network is compiled for each NUMA node
+         * 
+         * @return bool
+         */
+    bool isNumaReplicas() const {
+        return this->numaReplicas;
+    }
+
+    /**
+         * @brief Set whether network is compiled for each NUMA node
+         * 
+         * @param numaReplicas 
+         */
+    void setNumaReplicas(const bool numaReplicas) {
+        this->numaReplicas = numaReplicas;
+    }
+
+    /**
+         * @brief Get the maximum number of requests waiting for infer request
+         * 
+         * @return size_t 
+         */
+    size_t getMaxQueueSize() const {
+        return this->maxQueueSize;
+    }
+
+    /**
+         * @brief Set the maximum number of requests waiting for infer request
+         * 
+         * @param maxQueueSize 
+         */
+    void setMaxQueueSize(const size_t maxQueueSize) {
+        this->maxQueueSize = maxQueueSize;
+    }
+
+    /**
+         * @brief Get the maximum time request waits for infer request
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getQueueTimeoutMicroseconds() const {
+        return this->queueTimeoutMicroseconds;
+    }
+
+    /**
+         * @brief Set the maximum time request waits for infer request
+         * 
+         * @param queueTimeoutMicroseconds 
+         */
+    void setQueueTimeoutMicroseconds(const uint64_t queueTimeoutMicroseconds) {
+        this->queueTimeoutMicroseconds = queueTimeoutMicroseconds;
+    }
+
+    /**
+         * @brief Get the memory limit of result cache in megabytes
+         * 
+         * @return size_t 
+         */
+    size_t getResultCacheSizeMb() const {
+        return this->resultCacheSizeMb;
+    }
+
+    /**
+         * @brief Set the memory limit of result cache in megabytes
+         * 
+         * @param resultCacheSizeMb 
+         */
+    void setResultCacheSizeMb(const size_t resultCacheSizeMb) {
+        this->resultCacheSizeMb = resultCacheSizeMb;
+    }
+
+    /**
+         * @brief Get the time to live of cached results in seconds
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getResultCacheTtlSeconds() const {
+        return this->resultCacheTtlSeconds;
+    }
+
+    /**
+         * @brief Set the time to live of cached results in seconds
+         * 
+         * @param resultCacheTtlSeconds 
+         */
+    void setResultCacheTtlSeconds(const uint64_t resultCacheTtlSeconds) {
+        this->resultCacheTtlSeconds = resultCacheTtlSeconds;
+    }
+
+    /**
+         * @brief Get the memory budget of requests in progress in megabytes
+         * 
+         * @return size_t 
+         */
+    size_t getInFlightMemoryBudgetMb() const {
+        return this->inFlightMemoryBudgetMb;
+    }
+
+    /**
+         * @brief Set the memory budget of requests in progress in megabytes
+         * 
+         * @param inFlightMemoryBudgetMb 
+         */
+    void setInFlightMemoryBudgetMb(const size_t inFlightMemoryBudgetMb) {
+        this->inFlightMemoryBudgetMb = inFlightMemoryBudgetMb;
+    }
+
+    /**
+         * @brief Checks if model versions are loaded by their first request
+         * 
+         * @return bool
+         */
+    bool isLazyLoad() const {
+        return this->lazyLoad;
+    }
+
+    /**
+         * @brief Set if model versions are loaded by their first request
+         * 
+         * @param lazyLoad 
+         */
+    void setLazyLoad(const bool lazyLoad) {
+        this->lazyLoad = lazyLoad;
+    }
+
+    /**
+         * @brief Checks if FP32 outputs are sent as FP16
+         * 
+         * @return bool
+         */
+    bool isFp16Outputs() const {
+        return this->fp16Outputs;
+    }
+
+    /**
+         * @brief Set if FP32 outputs are sent as FP16
+         * 
+         * @param fp16Outputs 
+         */
+    void setFp16Outputs(const bool fp16Outputs) {
+        this->fp16Outputs = fp16Outputs;
+    }
+
+    /**
+         * @brief Checks if inference runs synchronously on request thread when no request waits for infer request
+         * 
+         * @return bool
+         */
+    bool isInlineInference() const {
+        return this->inlineInference;
+    }
+
+    /**
+         * @brief Set if inference runs synchronously on request thread when no request waits for infer request
+         * 
+         * @param inlineInference 
+         */
+    void setInlineInference(const bool inlineInference) {
+        this->inlineInference = inlineInference;
+    }
+
+    /**
+         * @brief Get the time of polling infer request status before blocking wait for its completion
+         * 
+         * @return uint32_t
+         */
+    uint32_t getCompletionSpinMicroseconds() const {
+        return this->completionSpinMicroseconds;
+    }
+
+    /**
+         * @brief Set the time of polling infer request status before blocking wait for its completion
+         * 
+         * @param completionSpinMicroseconds 
+         */
+    void setCompletionSpinMicroseconds(const uint32_t completionSpinMicroseconds) {
+        this->completionSpinMicroseconds = completionSpinMicroseconds;
+    }
+
+    /**
+         * @brief Get the share of device concurrency limit given to the model
+         * 
+         * @return uint32_t
+         */
+    uint32_t getDeviceSchedulingWeight() const {
+        return this->deviceSchedulingWeight;
+    }
+
+    /**
+         * @brief Set the share of device concurrency limit given to the model
+         * 
+         * @param deviceSchedulingWeight 
+         */
+    void setDeviceSchedulingWeight(const uint32_t deviceSchedulingWeight) {
+        this->deviceSchedulingWeight = deviceSchedulingWeight;
+    }
+
+    /**
+         * @brief Checks if requests are deserialized into input blobs preallocated by infer requests
+         * 
+         * @return bool
+         */
+    bool isReuseInputBlobs() const {
+        return this->reuseInputBlobs;
+    }
+
+    /**
+         * @brief Set if requests are deserialized into input blobs preallocated by infer requests
+         * 
+         * @param reuseInputBlobs 
+         */
+    void setReuseInputBlobs(const bool reuseInputBlobs) {
+        this->reuseInputBlobs = reuseInputBlobs;
+    }
+
+    /**
+         * @brief Checks if input and output blobs of infer requests are allocated from hugepages
+         * 
+         * @return bool
+         */
+    bool isHugePagesIOBlobs() const {
+        return this->hugePagesIOBlobs;
+    }
+
+    /**
+         * @brief Set if input and output blobs of infer requests are allocated from hugepages
+         * 
+         * @param hugePagesIOBlobs 
+         */
+    void setHugePagesIOBlobs(const bool hugePagesIOBlobs) {
+        this->hugePagesIOBlobs = hugePagesIOBlobs;
+    }
+
+    /**
+         * @brief Checks if input and output blobs of infer requests are allocated in remote context of GPU device
+         * 
+         * @return bool
+         */
+    bool isRemoteIOBlobs() const {
+        return this->remoteIOBlobs;
+    }
+
+    /**
+         * @brief Set if input and output blobs of infer requests are allocated in remote context of GPU device
+         * 
+         * @param remoteIOBlobs 
+         */
+    void setRemoteIOBlobs(const bool remoteIOBlobs) {
+        this->remoteIOBlobs = remoteIOBlobs;
+    }
+
+    /**
+         * @brief Checks if host copy of network is released once it is compiled for device
+         * 
+         * @return bool
+         */
+    bool isLeanMemory() const {
+        return this->leanMemory;
+    }
+
+    /**
+         * @brief Set if host copy of network is released once it is compiled for device
+         * 
+         * @param leanMemory 
+         */
+    void setLeanMemory(const bool leanMemory) {
+        this->leanMemory = leanMemory;
+    }
+
+    /**
+         * @brief Checks if model files from cloud storage are read into memory instead of downloaded to temporary directory
+         * 
+         * @return bool
+         */
+    bool isDownloadToMemory() const {
+        return this->downloadToMemory;
+    }
+
+    /**
+         * @brief Set if model files from cloud storage are read into memory instead of downloaded to temporary directory
+         * 
+         * @param downloadToMemory 
+         */
+    void setDownloadToMemory(const bool downloadToMemory) {
+        this->downloadToMemory = downloadToMemory;
+    }
+
+    /**
+         * @brief Get model files of given version read into memory
+         * 
+         * @param version 
+         * @return files or nullptr if version is loaded from disk
+         */
+    std::shared_ptr<const InMemoryModelFiles> getInMemoryModelFiles(model_version_t version) const {
+        auto it = this->inMemoryModelFiles.find(version);
+        return it == this->inMemoryModelFiles.end() ? nullptr : it->second;
+    }
+
+    /**
+         * @brief Set model files of given version read into memory
+         * 
+         * @param version 
+         * @param files 
+         */
+    void setInMemoryModelFiles(model_version_t version, std::shared_ptr<const InMemoryModelFiles> files) {
+        this->inMemoryModelFiles[version] = std::move(files);
+    }
+
+    /**
+         * @brief Release model files read into memory, versions which were loaded keep their own
+         */
+    void clearInMemoryModelFiles() {
+        this->inMemoryModelFiles.clear();
+    }
+
+    /**
+         * @brief Checks if model keeps state between requests of a sequence
+         * 
+         * @return bool
+         */
+    bool isStateful() const {
+        return this->stateful;
+    }
+
+    /**
+         * @brief Set if model keeps state between requests of a sequence
+         * 
+         * @param stateful 
+         */
+    void setStateful(const bool stateful) {
+        this->stateful = stateful;
+    }
+
+    /**
+         * @brief Get time after which idle sequence is removed, 0 if never
+         * 
+         * @return uint32_t
+         */
+    uint32_t getSequenceTimeoutSeconds() const {
+        return this->sequenceTimeoutSeconds;
+    }
+
+    /**
+         * @brief Set time after which idle sequence is removed, 0 if never
+         * 
+         * @param sequenceTimeoutSeconds 
+         */
+    void setSequenceTimeoutSeconds(const uint32_t sequenceTimeoutSeconds) {
+        this->sequenceTimeoutSeconds = sequenceTimeoutSeconds;
+    }
+
+    /**
+         * @brief Get number of networks compiled for previously requested shapes kept in cache
+         * 
+         * @return size_t
+         */
+    size_t getNetworkCacheSize() const {
+        return this->networkCacheSize;
+    }
+
+    /**
+         * @brief Set number of networks compiled for previously requested shapes kept in cache
+         * 
+         * @param networkCacheSize 
+         */
+    void setNetworkCacheSize(const size_t networkCacheSize) {
+        this->networkCacheSize = networkCacheSize;
+    }
+
+    /**
+         * @brief Checks if requests should be merged by dynamic batching scheduler
+         * 
+         * @return bool
+         */
+    bool isDynamicBatchingEnabled() const {
+        return this->maxBatchSize > 1;
+    }
+
+    /**
+         * @brief Get the nireq
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getNireq() const {
+        return this->nireq;
+    }
+
+    /**
+         * @brief Set the nireq
+         * 
+         * @param nireq 
+         */
+    void setNireq(const uint64_t nireq) {
+        this->nireq = nireq;
+    }
+
+    /**
+         * @brief Get the maximum nireq of adaptive infer requests pool
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getMaxNireq() const {
+        return this->maxNireq;
+    }
+
+    /**
+         * @brief Set the maximum nireq of adaptive infer requests pool
+         * 
+         * @param maxNireq 
+         */
+    void setMaxNireq(const uint64_t maxNireq) {
+        this->maxNireq = maxNireq;
+    }
+
+    /**
+         * @brief Get the number of infer requests of network compiled for latency
+         * 
+         * @return uint64_t
+         */
+    uint64_t getLatencyNireq() const {
+        return this->latencyNireq;
+    }
+
+    /**
+         * @brief Set the number of infer requests of network compiled for latency
+         * 
+         * @param latencyNireq 
+         */
+    void setLatencyNireq(const uint64_t latencyNireq) {
+        this->latencyNireq = latencyNireq;
+    }
+
+    /**
+         * @brief Checks if CPU streams and nireq are selected by benchmarking the model
+         * 
+         * @return bool
+         */
+    bool isAutoTune() const {
+        return this->autoTune;
+    }
+
+    /**
+         * @brief Set if CPU streams and nireq are selected by benchmarking the model
+         * 
+         * @param autoTune 
+         */
+    void setAutoTune(const bool autoTune) {
+        this->autoTune = autoTune;
+    }
+
+    /**
+         * @brief Get the latency limit of auto tuning in milliseconds
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getAutoTuneLatencyMs() const {
+        return this->autoTuneLatencyMs;
+    }
+
+    /**
+         * @brief Set the latency limit of auto tuning in milliseconds
+         * 
+         * @param autoTuneLatencyMs 
+         */
+    void setAutoTuneLatencyMs(const uint64_t autoTuneLatencyMs) {
+        this->autoTuneLatencyMs = autoTuneLatencyMs;
+    }
+
+    /**
+         * @brief Get the readiness limit of requests waiting for infer request
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getReadinessMaxWaitingRequests() const {
+        return this->readinessMaxWaitingRequests;
+    }
+
+    /**
+         * @brief Set the readiness limit of requests waiting for infer request
+         * 
+         * @param readinessMaxWaitingRequests 
+         */
+    void setReadinessMaxWaitingRequests(const uint64_t readinessMaxWaitingRequests) {
+        this->readinessMaxWaitingRequests = readinessMaxWaitingRequests;
+    }
+
+    /**
+         * @brief Get the readiness limit of 99th percentile of wait for infer request in milliseconds
+         * 
+         * @return uint64_t 
+         */
+    uint64_t getReadinessMaxQueueWaitMs() const {
+        return this->readinessMaxQueueWaitMs;
+    }
+
+    /**
+         * @brief Set the readiness limit of 99th percentile of wait for infer request in milliseconds
+         * 
+         * @param readinessMaxQueueWaitMs 
+         */
+    void setReadinessMaxQueueWaitMs(const uint64_t readinessMaxQueueWaitMs) {
+        this->readinessMaxQueueWaitMs = readinessMaxQueueWaitMs;
+    }
+
+    /**
+         * @brief Checks if infer requests queue pressure of model is considered in server readiness
+         * 
+         * @return bool
+         */
+    bool isReadinessCritical() const {
+        return this->readinessMaxWaitingRequests > 0 || this->readinessMaxQueueWaitMs > 0;
+    }
+
+    /**
+         * @brief Get the plugin config
+         * 
+         * @return const std::string&
+         */
+    const plugin_config_t& getPluginConfig() const {
+        return this->pluginConfig;
+    }
+
+    /**
+         * @brief Set the plugin config
+         * 
+         * @param pluginConfig 
+         */
+    void setPluginConfig(const plugin_config_t& pluginConfig) {
+        this->pluginConfig = pluginConfig;
+    }
+
+    /**
+         * @brief Parses json node for plugin config keys and values
+         * 
+         * @param json node representing plugin_config
+         * 
+         * @return status
+         */
+    Status parsePluginConfig(const rapidjson::Value& node);
+
+    /**
+         * @brief Parses string for plugin config keys and values
+         * 
+         * @param string representing plugin_config
+         * 
+         * @return status
+         */
+    Status parsePluginConfig(std::string command) {
+        rapidjson::Document node;
+        if (command.empty()) {
+            return StatusCode::OK;
+        }
+        if (node.Parse(command.c_str()).HasParseError()) {
+            return StatusCode::PLUGIN_CONFIG_WRONG_FORMAT;
+        }
+
+        return parsePluginConfig(node);
+    }
+
+    /**
+         * @brief Parses value from json and extracts shapes info
+         * 
+         * @param rapidjson::Value& node
+         * 
+         * @return status
+         */
+    Status parseShapeParameter(const rapidjson::Value& node);
+
+    /**
+         * @brief Parses value from string and extracts shapes info
+         * 
+         * @param string
+         * 
+         * @return status
+         */
+    Status parseShapeParameter(const std::string& command);
+
+    /**
+         * @brief Returns true if any input shape specified in shapes map is in AUTO mode
+         * 
+         * @return bool
+         */
+    bool anyShapeSetToAuto() const {
+        for (const auto& [name, shapeInfo] : getShapes()) {
+            if (shapeInfo.shapeMode == AUTO)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+         * @brief Get the shapes
+         * 
+         * @return const shapes_map_t& 
+         */
+    const shapes_map_t& getShapes() const {
+        return this->shapes;
+    }
+
+    /**
+         * @brief Set the shapes
+         * 
+         * @param shapes 
+         */
+    void setShapes(const shapes_map_t& shapes) {
+        this->shapes = shapes;
+    }
+
+    /**
+        * @brief Returns true if shape with certain name is in AUTO mode
+         * 
+         * @return bool
+         */
+    bool isShapeAuto(const std::string& name) const {
+        auto it = getShapes().find(name);
+        if (it == getShapes().end()) {
+            it = getShapes().find(ANONYMOUS_INPUT_NAME);
+        }
+        if (it == getShapes().end()) {
+            return false;
+        }
+        return it->second.shapeMode == Mode::AUTO;
+    }
+
+    bool isShapeAnonymous() const {
+        return getShapes().size() == 1 && getShapes().begin()->first == ANONYMOUS_INPUT_NAME;
+    }
+
+    bool isShapeAnonymousFixed() const {
+        return isShapeAnonymous() && !isShapeAuto(ANONYMOUS_INPUT_NAME);
+    }
+
+    /**
+         * @brief Sets the shape from the string representation
+         *
+         * @param shape
+         * @param str
+         * @return Status
+         */
+    static Status parseShape(ShapeInfo& shapeInfo, const std::string& str);
+
+    /**
+         * @brief Add a single named shape
+         * 
+         * @param name 
+         * @param shape 
+         */
+    void addShape(const std::string& name, const ShapeInfo& shapeInfo) {
+        this->shapes[name] = shapeInfo;
     }
 
     void removeShape(const std::string& name) {
         this->shapes.erase(name);
     }
 
+    /**
+         * @brief Get the shape buckets
+         * 
+         * @return const shape_buckets_map_t& 
+         */
+    const shape_buckets_map_t& getShapeBuckets() const {
+        return this->shapeBuckets;
+    }
+
+    /**
+         * @brief Add shape buckets of a single input, smaller buckets are tried first
+         * 
+         * @param name 
+         * @param buckets 
+         */
+    void addShapeBuckets(const std::string& name, std::vector<shape_t> buckets) {
+        std::stable_sort(buckets.begin(), buckets.end(), [](const shape_t& lhs, const shape_t& rhs) {
+            return std::accumulate(lhs.begin(), lhs.end(), size_t{1}, std::multiplies<size_t>()) <
+                   std::accumulate(rhs.begin(), rhs.end(), size_t{1}, std::multiplies<size_t>());
+        });
+        this->shapeBuckets[name] = std::move(buckets);
+    }
+
     /**
          * @brief Get the layouts
          * 
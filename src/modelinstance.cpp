@@ -16,21 +16,39 @@
 #include "modelinstance.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <dirent.h>
 #include <spdlog/spdlog.h>
 #include <sys/types.h>
 
+#include "compilednetworkregistry.hpp"
 #include "config.hpp"
+#include "cpuaffinity.hpp"
 #include "customloaders.hpp"
+#include "deviceconcurrencylimiter.hpp"
 #include "filesystem.hpp"
+#include "fnvhash.hpp"
+#include "modelmanager.hpp"
+#include "modelreaper.hpp"
+#include "ovengine.hpp"
+#include "sharedmemory.hpp"
 #include "stringutils.hpp"
+#include "tensorcache.hpp"
 
 using namespace InferenceEngine;
 
@@ -45,13 +63,31 @@ const int DEFAULT_OV_STREAMS = std::thread::hardware_concurrency() / 4;
 
 const uint UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS = 10;
 
+// each configuration is benchmarked by auto tuning for at least this time and rounds of inferences
+const auto TUNING_DURATION_PER_CONFIGURATION = std::chrono::milliseconds(500);
+const size_t TUNING_MIN_ROUNDS = 3;
+
+// last used time is not updated more often to avoid writes to shared cache line by every request
+const auto LAST_USED_TIME_RESOLUTION = std::chrono::seconds(1);
+
 void ModelInstance::subscribe(PipelineDefinition& pd) {
     subscriptionManager.subscribe(pd);
 }
 
+void ModelInstance::takeSubscriptionsFrom(ModelInstance& previousInstance) {
+    previousInstance.subscriptionManager.transferTo(subscriptionManager);
+    subscriptionManager.notifySubscribers();
+}
+
 void ModelInstance::unsubscribe(PipelineDefinition& pd) {
     subscriptionManager.unsubscribe(pd);
 }
+void ModelInstance::setAvailable() {
+    // inputs and outputs are changed only while requests are excluded, builders of metadata holding unload guard are finished by now
+    std::atomic_store(&metadataCache, std::shared_ptr<const ModelMetadataCacheEntry>());
+    this->status.setAvailable();
+}
+
 Status ModelInstance::loadInputTensors(const ModelConfig& config, const DynamicModelParameter& parameter) {
     if (config.isShapeAnonymousFixed() && network->getInputsInfo().size() > 1) {
         Status status = StatusCode::ANONYMOUS_FIXED_SHAPE_NOT_ALLOWED;
@@ -202,7 +238,7 @@ std::string ModelInstance::findModelFilePathWithExtension(const std::string& ext
     return findFilePathWithExtension(path, extension);
 }
 
-uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& modelConfig) {
+uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& modelConfig, InferenceEngine::ExecutableNetwork& executableNetwork) {
     uint numberOfParallelInferRequests = 0;
     if (modelConfig.getNireq() > 0) {
         return modelConfig.getNireq();
@@ -214,7 +250,7 @@ uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& mo
     }
     std::string key = METRIC_KEY(OPTIMAL_NUMBER_OF_INFER_REQUESTS);
     try {
-        numberOfParallelInferRequests = execNetwork->GetMetric(key).as<unsigned int>();
+        numberOfParallelInferRequests = executableNetwork.GetMetric(key).as<unsigned int>();
     } catch (const details::InferenceEngineException& ex) {
         SPDLOG_WARN("Failed to query OPTIMAL_NUMBER_OF_INFER_REQUESTS with error {}. Using 1 nireq.", ex.what());
         numberOfParallelInferRequests = 1u;
@@ -222,8 +258,8 @@ uint ModelInstance::getNumOfParallelInferRequestsUnbounded(const ModelConfig& mo
     return numberOfParallelInferRequests;
 }
 
-uint ModelInstance::getNumOfParallelInferRequests(const ModelConfig& modelConfig) {
-    uint nireq = getNumOfParallelInferRequestsUnbounded(modelConfig);
+uint ModelInstance::getNumOfParallelInferRequests(const ModelConfig& modelConfig, InferenceEngine::ExecutableNetwork& executableNetwork) {
+    uint nireq = getNumOfParallelInferRequestsUnbounded(modelConfig, executableNetwork);
     if (nireq > MAX_NIREQ_COUNT) {
         SPDLOG_WARN("Invalid nireq because its value was too high:{}. Maximum value:{}", nireq, MAX_NIREQ_COUNT);
         return 0;
@@ -235,14 +271,53 @@ uint ModelInstance::getNumOfParallelInferRequests(const ModelConfig& modelConfig
 }
 
 void ModelInstance::loadOVEngine() {
-    engine = std::make_unique<InferenceEngine::Core>();
+    engine = getSharedOVEngine();
 }
 
 std::unique_ptr<InferenceEngine::CNNNetwork> ModelInstance::loadOVCNNNetworkPtr(const std::string& modelFile) {
-    return std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(modelFile));
+    // weights of IR models are passed to Inference Engine as a blob over mapped .bin file instead of reading them to memory
+    if (modelFiles.size() != OV_MODEL_FILES_EXTENSIONS.size() || modelFiles[0] != modelFile) {
+        return std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(modelFile));
+    }
+    auto mappedWeights = MappedFile::open(modelFiles[1]);
+    if (!mappedWeights) {
+        SPDLOG_DEBUG("Weights file:{} cannot be mapped, reading it", modelFiles[1]);
+        return std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(modelFile));
+    }
+    std::ifstream xmlFile(modelFile);
+    if (!xmlFile.good()) {
+        throw std::runtime_error("Failed to read model file: " + modelFile);
+    }
+    std::stringstream xml;
+    xml << xmlFile.rdbuf();
+    auto weights = make_shared_blob<uint8_t>({Precision::U8, {mappedWeights->getSize()}, C},
+        const_cast<uint8_t*>(mappedWeights->getData()), mappedWeights->getSize());
+    auto cnnNetwork = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(xml.str(), weights));
+    weightsFile = std::move(mappedWeights);
+    return cnnNetwork;
+}
+
+Status ModelInstance::loadOVCNNNetworkFromMemory() {
+    SPDLOG_DEBUG("Try reading model:{} version:{} from memory", getName(), getVersion());
+    try {
+        InferenceEngine::Blob::CPtr weights;
+        if (!inMemoryModelFiles->weights.empty()) {
+            weights = make_shared_blob<uint8_t>({Precision::U8, {inMemoryModelFiles->weights.size()}, C},
+                reinterpret_cast<uint8_t*>(const_cast<char*>(inMemoryModelFiles->weights.data())), inMemoryModelFiles->weights.size());
+        }
+        network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(inMemoryModelFiles->model, weights));
+        customLoaderWeights = inMemoryModelFiles;
+    } catch (std::exception& e) {
+        SPDLOG_ERROR("Error:{}; occurred during loading CNNNetwork for model:{} version:{}", e.what(), getName(), getVersion());
+        return StatusCode::INTERNAL_ERROR;
+    }
+    return StatusCode::OK;
 }
 
 Status ModelInstance::loadOVCNNNetwork() {
+    if (inMemoryModelFiles) {
+        return loadOVCNNNetworkFromMemory();
+    }
     auto& modelFile = modelFiles[0];
     SPDLOG_DEBUG("Try reading model file:{}", modelFile);
     try {
@@ -254,12 +329,52 @@ Status ModelInstance::loadOVCNNNetwork() {
     return StatusCode::OK;
 }
 
+namespace {
+class CustomLoaderNetworkWriter : public CustomLoaderModelWriter {
+public:
+    std::string model;
+    Blob::Ptr weights;
+    std::shared_ptr<const void> weightsOwner;
+
+    void setModel(std::string&& model) override {
+        this->model = std::move(model);
+    }
+
+    uint8_t* allocateWeights(size_t size) override {
+        auto blob = make_shared_blob<uint8_t>({Precision::U8, {size}, C});
+        blob->allocate();
+        weights = blob;
+        weightsOwner = blob;
+        return blob->buffer().as<uint8_t*>();
+    }
+
+    void setWeights(std::vector<uint8_t>&& weights) override {
+        auto owned = std::make_shared<std::vector<uint8_t>>(std::move(weights));
+        this->weights = make_shared_blob<uint8_t>({Precision::U8, {owned->size()}, C}, owned->data(), owned->size());
+        weightsOwner = owned;
+    }
+
+    void setWeights(std::shared_ptr<const void> owner, const uint8_t* data, size_t size) override {
+        weights = make_shared_blob<uint8_t>({Precision::U8, {size}, C}, const_cast<uint8_t*>(data), size);
+        weightsOwner = std::move(owner);
+    }
+
+    bool setWeightsFile(const std::string& path) override {
+        auto mappedWeights = MappedFile::open(path);
+        if (!mappedWeights) {
+            SPDLOG_DEBUG("Weights file:{} passed by custom loader cannot be mapped", path);
+            return false;
+        }
+        // mapping outlives removal of the file
+        setWeights(mappedWeights, mappedWeights->getData(), mappedWeights->getSize());
+        return true;
+    }
+};
+}  // namespace
+
 Status ModelInstance::loadOVCNNNetworkUsingCustomLoader() {
     SPDLOG_DEBUG("Try reading model using a custom loader");
     try {
-        std::vector<uint8_t> model;
-        std::vector<uint8_t> weights;
-
         SPDLOG_INFO("loading CNNNetwork for model:{} basepath:{} <> {} version:{}", getName(), getPath(), this->config.getBasePath().c_str(), getVersion());
 
         custom_loader_options_config_t customLoaderOptionsConfig = this->config.getCustomLoaderOptionsConfigMap();
@@ -272,22 +387,26 @@ Status ModelInstance::loadOVCNNNetworkUsingCustomLoader() {
             throw std::invalid_argument("customloader not exisiting");
         }
 
-        CustomLoaderStatus res = customLoaderInterfacePtr->loadModel(this->config.getName(),
+        CustomLoaderNetworkWriter writer;
+        CustomLoaderStatus res = customLoaderInterfacePtr->loadModelStreamed(this->config.getName(),
             this->config.getBasePath(),
             getVersion(),
-            this->config.getCustomLoaderOptionsConfigStr(), model, weights);
+            this->config.getCustomLoaderOptionsConfigStr(), writer);
 
         if ((res == CustomLoaderStatus::MODEL_LOAD_ERROR) || (res == CustomLoaderStatus::INTERNAL_ERROR)) {
             return StatusCode::INTERNAL_ERROR;
         }
 
-        std::string strModel(model.begin(), model.end());
-
         if (res == CustomLoaderStatus::MODEL_TYPE_IR) {
-            network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(strModel,
-                make_shared_blob<uint8_t>({Precision::U8, {weights.size()}, C}, weights.data())));
+            if (!writer.weights) {
+                SPDLOG_ERROR("Custom loader: {} did not pass weights of model: {} version: {}", loaderName, getName(), getVersion());
+                return StatusCode::INTERNAL_ERROR;
+            }
+            network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(writer.model, writer.weights));
+            // network references weights memory instead of copying it
+            customLoaderWeights = std::move(writer.weightsOwner);
         } else if (res == CustomLoaderStatus::MODEL_TYPE_ONNX) {
-            network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(strModel, InferenceEngine::Blob::CPtr()));
+            network = std::make_unique<InferenceEngine::CNNNetwork>(engine->ReadNetwork(writer.model, InferenceEngine::Blob::CPtr()));
         } else if (res == CustomLoaderStatus::MODEL_TYPE_BLOB) {
             return StatusCode::INTERNAL_ERROR;
         }
@@ -302,6 +421,74 @@ void ModelInstance::loadExecutableNetworkPtr(const plugin_config_t& pluginConfig
     execNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, pluginConfig));
 }
 
+void ModelInstance::loadBalancedExecutableNetworks(const std::vector<std::string>& devices, const plugin_config_t& pluginConfig) {
+    for (const auto& device : devices) {
+        // plugin config combines keys of all devices, each plugin gets only keys it supports
+        const std::vector<std::string> supportedKeys = engine->GetMetric(device, METRIC_KEY(SUPPORTED_CONFIG_KEYS));
+        plugin_config_t devicePluginConfig;
+        for (const auto& [key, value] : pluginConfig) {
+            if (std::find(supportedKeys.begin(), supportedKeys.end(), key) != supportedKeys.end()) {
+                devicePluginConfig[key] = value;
+            } else {
+                SPDLOG_DEBUG("Plugin config key: {} is not supported by device: {}, skipped for model: {} version: {}", key, device, getName(), getVersion());
+            }
+        }
+        balancedExecNetworks.push_back(std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, device, devicePluginConfig)));
+        SPDLOG_INFO("Loaded model: {} version: {} on balanced device: {}", getName(), getVersion(), device);
+    }
+    // network of first device is used for metadata
+    execNetwork = balancedExecNetworks.front();
+}
+
+std::vector<std::vector<int>> ModelInstance::getNumaReplicasCpus(const ModelConfig& config) const {
+    std::vector<std::vector<int>> replicasCpus;
+    if (!config.isNumaReplicas()) {
+        return replicasCpus;
+    }
+    if (!config.getBalancedTargetDevices().empty() || targetDevice != "CPU") {
+        SPDLOG_WARN("Ignored NUMA replicas of model {}; version: {} since they are supported only on single CPU device", getName(), getVersion());
+        return replicasCpus;
+    }
+    // replicas are limited to CPUs requested for the model
+    if (!getNumaNodesCpus(cpuAffinity, replicasCpus).ok() || replicasCpus.size() < 2) {
+        SPDLOG_INFO("Model {}; version: {} is not replicated since its CPUs belong to single NUMA node", getName(), getVersion());
+        replicasCpus.clear();
+    }
+    return replicasCpus;
+}
+
+void ModelInstance::loadNumaReplicaExecutableNetworks(const std::vector<std::vector<int>>& replicasCpus, const plugin_config_t& pluginConfig) {
+    const bool threadsConfigured = prepareDefaultPluginConfig(config).count("CPU_THREADS_NUM") > 0;
+    for (const auto& cpus : replicasCpus) {
+        // plugin threads created during compilation inherit CPUs of the node, memory they touch first is allocated on it
+        CpuAffinityGuard cpuAffinityGuard(cpus);
+        plugin_config_t replicaPluginConfig = pluginConfig;
+        if (!threadsConfigured) {
+            replicaPluginConfig["CPU_THREADS_NUM"] = std::to_string(cpus.size());
+        }
+        balancedExecNetworks.push_back(std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, replicaPluginConfig)));
+        SPDLOG_INFO("Loaded model: {} version: {} replica: {} on NUMA node with {} CPUs starting from CPU: {}",
+            getName(), getVersion(), balancedExecNetworks.size() - 1, cpus.size(), cpus.front());
+    }
+    numaReplicasCpus = replicasCpus;
+    // network of first node is used for metadata
+    execNetwork = balancedExecNetworks.front();
+}
+
+void ModelInstance::loadLatencyExecutableNetwork(const ModelConfig& config, plugin_config_t pluginConfig) {
+    if (config.getLatencyNireq() == 0) {
+        return;
+    }
+    if (!balancedExecNetworks.empty() || (targetDevice != "CPU" && targetDevice != "GPU")) {
+        SPDLOG_WARN("Ignored latency nireq of model {}; version: {} since network compiled for latency is supported only on single CPU or GPU device", getName(), getVersion());
+        return;
+    }
+    // single stream gives the lowest latency of one request at the cost of throughput
+    pluginConfig[targetDevice + "_THROUGHPUT_STREAMS"] = "1";
+    latencyExecNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, pluginConfig));
+    SPDLOG_INFO("Loaded model: {} version: {} compiled for latency with {} infer requests", getName(), getVersion(), config.getLatencyNireq());
+}
+
 plugin_config_t ModelInstance::prepareDefaultPluginConfig(const ModelConfig& config) {
     plugin_config_t pluginConfig = config.getPluginConfig();
     // For CPU and GPU, if user did not specify, calculate CPU_THROUGHPUT_STREAMS automatically
@@ -318,10 +505,320 @@ plugin_config_t ModelInstance::prepareDefaultPluginConfig(const ModelConfig& con
     return pluginConfig;
 }
 
-Status ModelInstance::loadOVExecutableNetwork(const ModelConfig& config) {
-    plugin_config_t pluginConfig = prepareDefaultPluginConfig(config);
+bool ModelInstance::getCompiledNetworkHash(const plugin_config_t& pluginConfig, uint64_t& hash) const {
+    if (modelFiles.empty() && !inMemoryModelFiles) {
+        return false;
+    }
+    hash = FNV_OFFSET_BASIS;
+    hashString(hash, InferenceEngine::GetInferenceEngineVersion()->buildNumber);
+    if (inMemoryModelFiles) {
+        // same as hash of these files on disk
+        hashBytes(hash, inMemoryModelFiles->model.data(), inMemoryModelFiles->model.size());
+        hashBytes(hash, inMemoryModelFiles->weights.data(), inMemoryModelFiles->weights.size());
+    }
+    for (const auto& modelFile : modelFiles) {
+        if (!hashFile(hash, modelFile)) {
+            SPDLOG_WARN("Failed to read model file:{}; compiled network is not identified for model:{} version:{}", modelFile, getName(), getVersion());
+            return false;
+        }
+    }
+    hashString(hash, targetDevice);
+    for (const auto& [key, value] : pluginConfig) {
+        hashString(hash, key);
+        hashString(hash, value);
+    }
+    // network was already reshaped and had layouts set, these are part of compiled network
+    for (const auto& [name, input] : network->getInputsInfo()) {
+        hashString(hash, name);
+        hashString(hash, TensorInfo::shapeToString(input->getTensorDesc().getDims()));
+        hashString(hash, TensorInfo::getStringFromLayout(input->getLayout()));
+        hashString(hash, input->getPrecision().name());
+    }
+    return true;
+}
+
+std::string ModelInstance::getCompiledModelCacheFilePath(const ModelConfig& config, const plugin_config_t& pluginConfig) const {
+    uint64_t hash;
+    if (config.getCompiledModelCacheDir().empty() || !getCompiledNetworkHash(pluginConfig, hash)) {
+        return "";
+    }
+    std::stringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << hash << ".blob";
+    return (std::filesystem::path(config.getCompiledModelCacheDir()) / fileName.str()).string();
+}
+
+bool ModelInstance::importExecutableNetwork(const std::string& cacheFilePath, const plugin_config_t& pluginConfig) {
+    if (!std::filesystem::exists(cacheFilePath)) {
+        SPDLOG_DEBUG("Compiled model cache file:{} not found for model:{} version:{}", cacheFilePath, getName(), getVersion());
+        return false;
+    }
     try {
+        execNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->ImportNetwork(cacheFilePath, targetDevice, pluginConfig));
+    } catch (const std::exception& e) {
+        SPDLOG_WARN("Failed to import compiled model:{} version:{} from:{}; error: {}; compiling network instead",
+            getName(), getVersion(), cacheFilePath, e.what());
+        return false;
+    }
+    SPDLOG_INFO("Imported compiled model:{} version:{} from:{}", getName(), getVersion(), cacheFilePath);
+    return true;
+}
+
+void ModelInstance::loadOrImportExecutableNetwork(const std::string& cacheFilePath, const plugin_config_t& pluginConfig) {
+    if (cacheFilePath.empty() || !importExecutableNetwork(cacheFilePath, pluginConfig)) {
         loadExecutableNetworkPtr(pluginConfig);
+        if (!cacheFilePath.empty()) {
+            exportExecutableNetwork(cacheFilePath);
+        }
+    }
+}
+
+bool ModelInstance::getCompiledNetworkKey(const plugin_config_t& pluginConfig, CompiledNetworkKey& key) const {
+    if (!getCompiledNetworkHash(pluginConfig, key.hash)) {
+        return false;
+    }
+    std::stringstream description;
+    description << InferenceEngine::GetInferenceEngineVersion()->buildNumber << "\n"
+                << targetDevice << "\n";
+    for (const auto& [name, value] : pluginConfig) {
+        description << name << "=" << value << "\n";
+    }
+    for (const auto& [name, input] : network->getInputsInfo()) {
+        description << name << ":" << TensorInfo::shapeToString(input->getTensorDesc().getDims())
+                    << ":" << TensorInfo::getStringFromLayout(input->getLayout())
+                    << ":" << input->getPrecision().name() << "\n";
+    }
+    // plugin threads inherit CPUs of model loading the network, so only models with the same CPUs share it
+    for (auto cpu : cpuAffinity) {
+        hashString(key.hash, std::to_string(cpu));
+        description << cpu << ",";
+    }
+    key.description = description.str();
+    if (inMemoryModelFiles) {
+        key.inMemoryModelFiles.emplace_back(inMemoryModelFiles, &inMemoryModelFiles->model);
+        key.inMemoryModelFiles.emplace_back(inMemoryModelFiles, &inMemoryModelFiles->weights);
+    }
+    for (const auto& modelFile : modelFiles) {
+        if (!key.addModelFile(modelFile)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModelInstance::loadSharedExecutableNetwork(const std::string& cacheFilePath, const plugin_config_t& pluginConfig) {
+    CompiledNetworkKey key;
+    if (!getCompiledNetworkKey(pluginConfig, key)) {
+        return false;
+    }
+    bool shared = false;
+    execNetwork = CompiledNetworkRegistry::getInstance().getOrLoad(key, [this, &cacheFilePath, &pluginConfig]() {
+        loadOrImportExecutableNetwork(cacheFilePath, pluginConfig);
+        return execNetwork;
+    },
+        shared);
+    if (shared) {
+        SPDLOG_INFO("Model:{} version:{} shares network compiled for identical model files, device, plugin config and inputs", getName(), getVersion());
+    }
+    return true;
+}
+
+void ModelInstance::exportExecutableNetwork(const std::string& cacheFilePath) {
+    // exported to temporary file first so that servers sharing cache directory never import partially written network
+    std::stringstream temporaryFilePath;
+    temporaryFilePath << cacheFilePath << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+    try {
+        std::filesystem::create_directories(std::filesystem::path(cacheFilePath).parent_path());
+        execNetwork->Export(temporaryFilePath.str());
+        std::filesystem::rename(temporaryFilePath.str(), cacheFilePath);
+    } catch (const std::exception& e) {
+        SPDLOG_INFO("Compiled model:{} version:{} was not exported to cache; device:{} error: {}",
+            getName(), getVersion(), targetDevice, e.what());
+        std::error_code ec;
+        std::filesystem::remove(temporaryFilePath.str(), ec);
+        return;
+    }
+    SPDLOG_INFO("Exported compiled model:{} version:{} to:{}", getName(), getVersion(), cacheFilePath);
+}
+
+plugin_config_t ModelInstance::preparePluginConfig(const ModelConfig& config) const {
+    plugin_config_t pluginConfig = prepareDefaultPluginConfig(config);
+    // plugin threads are limited to requested CPUs, one thread per CPU unless user specified otherwise
+    if (!cpuAffinity.empty() && config.isDeviceUsed("CPU") && pluginConfig.count("CPU_THREADS_NUM") == 0) {
+        pluginConfig["CPU_THREADS_NUM"] = std::to_string(cpuAffinity.size());
+    }
+    // streams of model with exclusive CPUs are pinned to them, so that they do not migrate between its cores
+    if (config.isCpuSetExclusive() && config.isDeviceUsed("CPU") && pluginConfig.count("CPU_BIND_THREAD") == 0) {
+        pluginConfig["CPU_BIND_THREAD"] = "YES";
+    }
+    if (tuningChoice && tuningChoice->streams > 0) {
+        pluginConfig["CPU_THROUGHPUT_STREAMS"] = std::to_string(tuningChoice->streams);
+    }
+    return pluginConfig;
+}
+
+Status ModelInstance::tuneThroughputStreams(const ModelConfig& config) {
+    if (config.getTargetDevice() != "CPU") {
+        SPDLOG_WARN("Auto tuning is supported only on CPU target device, ignored for model {}; version: {}", getName(), getVersion());
+        return StatusCode::OK;
+    }
+    if (config.isNumaReplicas()) {
+        SPDLOG_WARN("Auto tuning ignored for model {}; version: {} since it is replicated for NUMA nodes", getName(), getVersion());
+        return StatusCode::OK;
+    }
+    const bool streamsConfigured = config.getPluginConfig().count("CPU_THROUGHPUT_STREAMS") > 0;
+    const bool nireqConfigured = config.getNireq() > 0 || ovms::Config::instance().nireq() > 0;
+    if (streamsConfigured && nireqConfigured) {
+        SPDLOG_WARN("Auto tuning ignored for model {}; version: {} since both CPU_THROUGHPUT_STREAMS and nireq are set", getName(), getVersion());
+        return StatusCode::OK;
+    }
+    std::map<std::string, NpyArray> samples;
+    size_t samplesCount = 0;
+    auto status = readWarmupSamples(config, samples, samplesCount);
+    if (!status.ok()) {
+        return status;
+    }
+    const auto tuningStart = std::chrono::steady_clock::now();
+    // streams configured by user are benchmarked as candidate 0
+    std::vector<uint32_t> streamsCandidates;
+    if (streamsConfigured) {
+        streamsCandidates.push_back(0);
+    } else {
+        const size_t cpusCount = cpuAffinity.empty() ? std::max(1u, std::thread::hardware_concurrency()) : cpuAffinity.size();
+        for (uint32_t streams = 1; streams <= cpusCount; streams *= 2) {
+            streamsCandidates.push_back(streams);
+        }
+    }
+    const double latencyLimitMs = config.getAutoTuneLatencyMs();
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> bestNetwork;
+    TuningChoice best;
+    double bestThroughput = 0;
+    double bestLatencyMs = 0;
+    bool bestWithinLimit = false;
+    for (const auto streams : streamsCandidates) {
+        plugin_config_t pluginConfig = preparePluginConfig(config);
+        if (streams > 0) {
+            pluginConfig["CPU_THROUGHPUT_STREAMS"] = std::to_string(streams);
+        }
+        std::shared_ptr<InferenceEngine::ExecutableNetwork> candidateNetwork;
+        try {
+            candidateNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>(engine->LoadNetwork(*network, targetDevice, pluginConfig));
+        } catch (const std::exception& e) {
+            SPDLOG_WARN("Auto tuning failed to load model {}; version: {} with CPU_THROUGHPUT_STREAMS: {}; error: {}",
+                getName(), getVersion(), pluginConfig["CPU_THROUGHPUT_STREAMS"], e.what());
+            continue;
+        }
+        const uint32_t baseNireq = (nireqConfigured || streams == 0) ? getNumOfParallelInferRequests(config, *candidateNetwork) : streams;
+        if (baseNireq == 0) {
+            return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
+        }
+        std::vector<uint32_t> nireqCandidates = {baseNireq};
+        if (!nireqConfigured && baseNireq * 2 <= MAX_NIREQ_COUNT) {
+            nireqCandidates.push_back(baseNireq * 2);
+        }
+        for (const auto nireq : nireqCandidates) {
+            double throughput = 0;
+            double latencyMs = 0;
+            status = benchmarkExecutableNetwork(*candidateNetwork, nireq, samples, samplesCount, throughput, latencyMs);
+            if (!status.ok()) {
+                return status;
+            }
+            SPDLOG_INFO("Auto tuning model {}; version: {}; CPU_THROUGHPUT_STREAMS: {}; nireq: {}; throughput: {:.1f} inferences/s; latency: {:.2f} ms",
+                getName(), getVersion(), pluginConfig["CPU_THROUGHPUT_STREAMS"], nireq, throughput, latencyMs);
+            // configurations within latency limit are compared by throughput, the others by latency only while none is within limit
+            const bool withinLimit = latencyLimitMs == 0 || latencyMs <= latencyLimitMs;
+            if (!bestNetwork ||
+                (withinLimit && (!bestWithinLimit || throughput > bestThroughput)) ||
+                (!withinLimit && !bestWithinLimit && latencyMs < bestLatencyMs)) {
+                bestNetwork = candidateNetwork;
+                best.streams = streams;
+                best.nireq = nireq;
+                best.description = "CPU_THROUGHPUT_STREAMS: " + pluginConfig["CPU_THROUGHPUT_STREAMS"];
+                bestThroughput = throughput;
+                bestLatencyMs = latencyMs;
+                bestWithinLimit = withinLimit;
+            }
+        }
+    }
+    if (!bestNetwork) {
+        return StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE;
+    }
+    if (!bestWithinLimit) {
+        SPDLOG_WARN("No configuration of model {}; version: {} meets latency limit of {} ms, selected the one with lowest latency", getName(), getVersion(), latencyLimitMs);
+    }
+    std::stringstream description;
+    description << "auto tuned " << best.description << ", nireq: " << best.nireq << std::fixed << std::setprecision(1)
+                << ", throughput: " << bestThroughput << " inferences/s, latency: " << std::setprecision(2) << bestLatencyMs << " ms";
+    best.description = description.str();
+    SPDLOG_INFO("Model {}; version: {}; {}; tuned in {} ms", getName(), getVersion(), best.description,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tuningStart).count());
+    tuningChoice = std::move(best);
+    execNetwork = std::move(bestNetwork);
+    return StatusCode::OK;
+}
+
+Status ModelInstance::benchmarkExecutableNetwork(InferenceEngine::ExecutableNetwork& executableNetwork, uint32_t nireq,
+    const std::map<std::string, NpyArray>& samples, size_t samplesCount, double& throughput, double& latencyMs) {
+    try {
+        std::vector<InferenceEngine::InferRequest> inferRequests;
+        for (uint32_t i = 0; i < nireq; i++) {
+            auto& inferRequest = inferRequests.emplace_back(executableNetwork.CreateInferRequest());
+            for (const auto& [name, tensorInfo] : getInputsInfo()) {
+                auto blob = inferRequest.GetBlob(tensorInfo->getName());
+                auto it = samples.find(name);
+                if (it == samples.end()) {
+                    std::memset(blob->buffer().as<char*>(), 0, blob->byteSize());
+                } else {
+                    std::memcpy(blob->buffer().as<char*>(), it->second.data.data() + (i % samplesCount) * blob->byteSize(), blob->byteSize());
+                }
+            }
+        }
+        // first round is not measured since plugins allocate memory on first inference
+        size_t rounds = 0;
+        std::chrono::steady_clock::duration measured{0};
+        while (rounds <= TUNING_MIN_ROUNDS || measured < TUNING_DURATION_PER_CONFIGURATION) {
+            const auto roundStart = std::chrono::steady_clock::now();
+            for (auto& inferRequest : inferRequests) {
+                inferRequest.StartAsync();
+            }
+            for (auto& inferRequest : inferRequests) {
+                auto sts = inferRequest.Wait(InferenceEngine::IInferRequest::RESULT_READY);
+                if (sts != InferenceEngine::StatusCode::OK) {
+                    SPDLOG_ERROR("Auto tuning inference failed for model {}; version: {}; status: {}", getName(), getVersion(), sts);
+                    return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+                }
+            }
+            if (rounds++ > 0) {
+                measured += std::chrono::steady_clock::now() - roundStart;
+            }
+        }
+        const double seconds = std::chrono::duration<double>(measured).count();
+        throughput = (rounds - 1) * nireq / seconds;
+        // all infer requests of a round run concurrently, so round time is the latency observed under this load
+        latencyMs = seconds * 1000 / (rounds - 1);
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        SPDLOG_ERROR("Auto tuning inference failed for model {}; version: {}; error: {}", getName(), getVersion(), e.what());
+        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+    }
+    return StatusCode::OK;
+}
+
+Status ModelInstance::loadOVExecutableNetwork(const ModelConfig& config) {
+    plugin_config_t pluginConfig = preparePluginConfig(config);
+    const auto balancedDevices = config.getBalancedTargetDevices();
+    const auto replicasCpus = getNumaReplicasCpus(config);
+    const auto cacheFilePath = balancedDevices.empty() && replicasCpus.empty() ? getCompiledModelCacheFilePath(config, pluginConfig) : "";
+    balancedExecNetworks.clear();
+    numaReplicasCpus.clear();
+    latencyExecNetwork.reset();
+    try {
+        if (!balancedDevices.empty()) {
+            loadBalancedExecutableNetworks(balancedDevices, pluginConfig);
+        } else if (!replicasCpus.empty()) {
+            loadNumaReplicaExecutableNetworks(replicasCpus, pluginConfig);
+        } else if (!config.isShareCompiledNetworks() || !loadSharedExecutableNetwork(cacheFilePath, pluginConfig)) {
+            loadOrImportExecutableNetwork(cacheFilePath, pluginConfig);
+        }
+        loadLatencyExecutableNetwork(config, pluginConfig);
     } catch (std::exception& e) {
         Status status = StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE;
         SPDLOG_ERROR("{}; error: {}; model:{}; version:{}; device:{}",
@@ -346,8 +843,14 @@ Status ModelInstance::fetchModelFilepaths() {
         // not required if the model is loaded using a custom loader and can be returned from here
         return StatusCode::OK;
     }
+    if (inMemoryModelFiles) {
+        // network is read from memory, there are no files on disk
+        modelFiles.clear();
+        return StatusCode::OK;
+    }
 
     SPDLOG_DEBUG("Getting model files from path:{}", path);
+    modelFiles.clear();
     if (!dirExists(path)) {
         SPDLOG_ERROR("Missing model directory {}", path);
         return StatusCode::PATH_INVALID;
@@ -383,22 +886,297 @@ Status ModelInstance::fetchModelFilepaths() {
 }
 
 Status ModelInstance::prepareInferenceRequestsQueue(const ModelConfig& config) {
-    uint numberOfParallelInferRequests = getNumOfParallelInferRequests(config);
+    if (!balancedExecNetworks.empty()) {
+        return prepareBalancedInferenceRequestsQueue(config);
+    }
+    uint numberOfParallelInferRequests = tuningChoice ? tuningChoice->nireq : getNumOfParallelInferRequests(config, *execNetwork);
     if (numberOfParallelInferRequests == 0) {
         return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
     }
-    inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*execNetwork, numberOfParallelInferRequests);
-    SPDLOG_INFO("Loaded model {}; version: {}; batch size: {}; No of InferRequests: {}",
+    uint64_t maxNumberOfParallelInferRequests = config.getMaxNireq();
+    if (maxNumberOfParallelInferRequests > MAX_NIREQ_COUNT) {
+        SPDLOG_WARN("Invalid max nireq because its value was too high:{}. Maximum value:{}", maxNumberOfParallelInferRequests, MAX_NIREQ_COUNT);
+        return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed max nireq value");
+    }
+    if (maxNumberOfParallelInferRequests > numberOfParallelInferRequests &&
+        (config.isDynamicBatchingEnabled() || config.isReuseInputBlobs())) {
+        // blobs of dynamic batching and reused input blobs are allocated once for each infer request
+        SPDLOG_WARN("Ignored max nireq of model {} since infer requests pool cannot grow with dynamic batching or reused input blobs", getName());
+        maxNumberOfParallelInferRequests = 0;
+    }
+    if (maxNumberOfParallelInferRequests > numberOfParallelInferRequests && latencyExecNetwork) {
+        SPDLOG_WARN("Ignored max nireq of model {} since infer requests pool with network compiled for latency cannot grow", getName());
+        maxNumberOfParallelInferRequests = 0;
+    }
+    if (latencyExecNetwork) {
+        const uint64_t latencyNireq = config.getLatencyNireq();
+        if (numberOfParallelInferRequests + latencyNireq > MAX_NIREQ_COUNT) {
+            SPDLOG_WARN("Invalid latency nireq because its value summed with nireq was too high:{}. Maximum value:{}", numberOfParallelInferRequests + latencyNireq, MAX_NIREQ_COUNT);
+            return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed latency nireq value");
+        }
+        // network compiled for latency is the second device of the pool, reserved for requests of high priority
+        inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(std::vector<std::pair<InferenceEngine::ExecutableNetwork*, int>>{
+            {execNetwork.get(), numberOfParallelInferRequests},
+            {latencyExecNetwork.get(), static_cast<int>(latencyNireq)}});
+        inferRequestsQueue->setLatencyDevice(1);
+    } else if (maxNumberOfParallelInferRequests > numberOfParallelInferRequests) {
+        inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*execNetwork, numberOfParallelInferRequests, maxNumberOfParallelInferRequests);
+    } else {
+        inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*execNetwork, numberOfParallelInferRequests);
+    }
+    auto deviceLimiter = DeviceConcurrencyLimiter::forDevice(targetDevice);
+    if (deviceLimiter) {
+        SPDLOG_DEBUG("Infer requests of model {} version {} share limit of {} executing on device {} with weight {}",
+            getName(), getVersion(), deviceLimiter->getMaxInFlight(), targetDevice, config.getDeviceSchedulingWeight());
+        inferRequestsQueue->setDeviceLimiter(std::move(deviceLimiter), config.getDeviceSchedulingWeight());
+    }
+    SPDLOG_INFO("Loaded model {}; version: {}; batch size: {}; No of InferRequests: {}; Max No of InferRequests: {}",
         getName(),
         getVersion(),
         getBatchSize(),
-        numberOfParallelInferRequests);
+        numberOfParallelInferRequests,
+        inferRequestsQueue->getMaxSize());
+    return StatusCode::OK;
+}
+
+Status ModelInstance::prepareBalancedInferenceRequestsQueue(const ModelConfig& config) {
+    // nireq applies to each device, devices without it set get their optimal number of infer requests
+    std::vector<std::pair<InferenceEngine::ExecutableNetwork*, int>> networks;
+    uint numberOfParallelInferRequests = 0;
+    if (config.getMaxNireq() > 0) {
+        SPDLOG_WARN("Ignored max nireq of model {} since infer requests pool of multiple devices cannot grow", getName());
+    }
+    for (auto& balancedExecNetwork : balancedExecNetworks) {
+        uint deviceInferRequests = getNumOfParallelInferRequests(config, *balancedExecNetwork);
+        if (deviceInferRequests == 0) {
+            return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
+        }
+        numberOfParallelInferRequests += deviceInferRequests;
+        networks.emplace_back(balancedExecNetwork.get(), deviceInferRequests);
+    }
+    if (numberOfParallelInferRequests > MAX_NIREQ_COUNT) {
+        SPDLOG_WARN("Invalid nireq because its value summed for all devices was too high:{}. Maximum value:{}", numberOfParallelInferRequests, MAX_NIREQ_COUNT);
+        return Status(StatusCode::INVALID_NIREQ, "Exceeded allowed nireq value");
+    }
+    // infer requests of NUMA replicas are created on and preferred by threads running on their node
+    inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(networks, numaReplicasCpus);
+    SPDLOG_INFO("Loaded model {}; version: {}; batch size: {}; No of InferRequests: {} on {} {}",
+        getName(),
+        getVersion(),
+        getBatchSize(),
+        numberOfParallelInferRequests,
+        networks.size(),
+        numaReplicasCpus.empty() ? "devices" : "NUMA nodes");
+    return StatusCode::OK;
+}
+
+void ModelInstance::prepareInputsSignature() {
+    inputsSignature = InputsSignature(getInputsInfo(), getBatchSize(), batchingScheduler != nullptr);
+}
+
+void ModelInstance::prepareBatchingScheduler(const ModelConfig& config) {
+    batchingScheduler.reset();
+    if (!config.isDynamicBatchingEnabled()) {
+        return;
+    }
+    if (config.isStateful()) {
+        SPDLOG_WARN("Dynamic batching disabled for model {}; version: {}. Requests of different sequences cannot share infer request of stateful model",
+            getName(), getVersion());
+        return;
+    }
+    for (const auto& [name, output] : getOutputsInfo()) {
+        if (output->getShape().size() == 0 || output->getShape()[0] != config.getMaxBatchSize()) {
+            SPDLOG_WARN("Dynamic batching disabled for model {}; version: {}. Output {} first dimension is not a batch dimension: {}",
+                getName(), getVersion(), name, TensorInfo::shapeToString(output->getShape()));
+            return;
+        }
+    }
+    batchingScheduler = std::make_unique<BatchingScheduler>(*this, config.getMaxBatchSize(), config.getBatchTimeoutMicroseconds(), config.getBatchLatencySloMicroseconds());
+    SPDLOG_INFO("Dynamic batching enabled for model {}; version: {}; max batch size: {}; batch timeout: {} us; latency SLO: {} us",
+        getName(), getVersion(), config.getMaxBatchSize(), config.getBatchTimeoutMicroseconds(), config.getBatchLatencySloMicroseconds());
+}
+
+void ModelInstance::prepareSequenceManager(const ModelConfig& config) {
+    sequenceManager.reset();
+    if (!config.isStateful()) {
+        return;
+    }
+    sequenceManager = std::make_unique<SequenceManager>(*inferRequestsQueue, std::chrono::seconds(config.getSequenceTimeoutSeconds()));
+    SPDLOG_INFO("Model {}; version: {} is stateful; max number of sequences: {}; sequence timeout: {} s",
+        getName(), getVersion(), inferRequestsQueue->getMaxSize(), config.getSequenceTimeoutSeconds());
+}
+
+void ModelInstance::preparePreallocatedInputBlobs(const ModelConfig& config) {
+    preallocatedInputBlobs.clear();
+    if (!config.isReuseInputBlobs() || batchingScheduler) {
+        return;
+    }
+    preallocatedInputBlobs.resize(inferRequestsQueue->size());
+    for (size_t streamId = 0; streamId < preallocatedInputBlobs.size(); streamId++) {
+        auto& inferRequest = inferRequestsQueue->getInferRequest(streamId);
+        for (const auto& [name, tensorInfo] : getInputsInfo()) {
+            preallocatedInputBlobs[streamId].emplace(name, inferRequest.GetBlob(tensorInfo->getName()));
+        }
+    }
+    SPDLOG_INFO("Reusing input blobs of infer requests for model {}; version: {}", getName(), getVersion());
+}
+
+void ModelInstance::prepareHugePagesIOBlobs(const ModelConfig& config) {
+    // blobs allocated in remote context replace these on GPU
+    if (!config.isHugePagesIOBlobs() || (config.isRemoteIOBlobs() && targetDevice == "GPU")) {
+        return;
+    }
+    if (!hugePagesIOBlobsPool) {
+        // buffers are not reused, blobs live as long as infer requests
+        hugePagesIOBlobsPool = std::make_shared<TensorBufferPool>();
+        hugePagesIOBlobsPool->configure(0, true);
+    }
+    std::vector<std::string> names;
+    for (const auto& [name, tensorInfo] : getInputsInfo()) {
+        names.push_back(tensorInfo->getName());
+    }
+    for (const auto& [name, tensorInfo] : getOutputsInfo()) {
+        names.push_back(tensorInfo->getName());
+    }
+    auto pool = hugePagesIOBlobsPool;
+    try {
+        inferRequestsQueue->setInferRequestInitializer([names, pool](InferenceEngine::InferRequest& inferRequest) {
+            for (const auto& name : names) {
+                const auto desc = inferRequest.GetBlob(name)->getTensorDesc();
+                inferRequest.SetBlob(name, createPooledBlob(desc, pool));
+            }
+        });
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        SPDLOG_WARN("Failed to set blobs allocated from hugepages for model {}; version: {}; blobs allocated by plugin are used; error: {}",
+            getName(), getVersion(), e.what());
+        return;
+    }
+    SPDLOG_INFO("Infer requests blobs of model {}; version: {} allocated from hugepages: {} MB",
+        getName(), getVersion(), hugePagesIOBlobsPool->getHugePagesBytes() / (1024 * 1024));
+}
+
+void ModelInstance::prepareRemoteIOBlobs(const ModelConfig& config) {
+    if (!config.isRemoteIOBlobs()) {
+        return;
+    }
+    if (targetDevice != "GPU") {
+        SPDLOG_WARN("Ignored remote io blobs of model {}; version: {} since they are supported only on GPU device", getName(), getVersion());
+        return;
+    }
+    std::vector<std::string> names;
+    for (const auto& [name, tensorInfo] : getInputsInfo()) {
+        names.push_back(tensorInfo->getName());
+    }
+    for (const auto& [name, tensorInfo] : getOutputsInfo()) {
+        names.push_back(tensorInfo->getName());
+    }
+    try {
+        // device memory is allocated by plugin and mapped into host memory when blob is accessed by the server
+        auto context = execNetwork->GetContext();
+        inferRequestsQueue->setInferRequestInitializer([names, context](InferenceEngine::InferRequest& inferRequest) {
+            for (const auto& name : names) {
+                const auto desc = inferRequest.GetBlob(name)->getTensorDesc();
+                auto blob = context->CreateBlob(desc);
+                blob->allocate();
+                inferRequest.SetBlob(name, blob);
+            }
+        });
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        SPDLOG_WARN("Failed to set blobs allocated in remote context for model {}; version: {}; blobs allocated by plugin are used; error: {}",
+            getName(), getVersion(), e.what());
+        return;
+    }
+    SPDLOG_INFO("Infer requests blobs of model {}; version: {} allocated in remote context of device {}", getName(), getVersion(), targetDevice);
+}
+
+Status ModelInstance::readWarmupSamples(const ModelConfig& config, std::map<std::string, NpyArray>& samples, size_t& samplesCount) {
+    for (const auto& [inputName, path] : config.getWarmupData()) {
+        auto it = getInputsInfo().find(inputName);
+        if (it == getInputsInfo().end()) {
+            SPDLOG_ERROR("Warm up data provided for input: {} which does not exist in model: {}; version: {}", inputName, getName(), getVersion());
+            return StatusCode::WARMUP_DATA_INVALID;
+        }
+        const auto& tensorInfo = it->second;
+        NpyArray& array = samples[inputName];
+        auto status = readNpyFile(path, array);
+        if (!status.ok()) {
+            return status;
+        }
+        // file holds samples stacked along batch dimension of the input
+        const auto& shape = tensorInfo->getShape();
+        const size_t sampleSize = std::accumulate(shape.begin(), shape.end(), tensorInfo->getPrecision().size(), std::multiplies<size_t>());
+        if (array.precision != tensorInfo->getPrecision() ||
+            array.shape.size() != shape.size() ||
+            !std::equal(shape.begin() + std::min<size_t>(1, shape.size()), shape.end(), array.shape.begin() + std::min<size_t>(1, array.shape.size())) ||
+            array.data.size() < sampleSize ||
+            array.data.size() % sampleSize != 0) {
+            SPDLOG_ERROR("Warm up data: {} with shape: {} does not match input: {} with shape: {} and precision: {} of model: {}; version: {}",
+                path, TensorInfo::shapeToString(array.shape), inputName, TensorInfo::shapeToString(shape), tensorInfo->getPrecisionAsString(), getName(), getVersion());
+            return StatusCode::WARMUP_DATA_INVALID;
+        }
+        const size_t count = array.data.size() / sampleSize;
+        samplesCount = samplesCount == 0 ? count : std::min(samplesCount, count);
+    }
+    return StatusCode::OK;
+}
+
+Status ModelInstance::warmUp(const ModelConfig& config) {
+    if (config.getWarmupIterations() == 0 && config.getWarmupData().empty()) {
+        return StatusCode::OK;
+    }
+    const auto warmUpStart = std::chrono::steady_clock::now();
+    std::map<std::string, NpyArray> samples;
+    size_t samplesCount = 0;
+    auto status = readWarmupSamples(config, samples, samplesCount);
+    if (!status.ok()) {
+        return status;
+    }
+    // by default every sample goes through every infer request once
+    const size_t iterations = config.getWarmupIterations() > 0 ? config.getWarmupIterations() : samplesCount;
+    try {
+        for (size_t streamId = 0; streamId < inferRequestsQueue->size(); streamId++) {
+            auto& inferRequest = inferRequestsQueue->getInferRequest(streamId);
+            for (const auto& [name, tensorInfo] : getInputsInfo()) {
+                if (samples.count(name) == 0) {
+                    auto blob = inferRequest.GetBlob(tensorInfo->getName());
+                    std::memset(blob->buffer().as<char*>(), 0, blob->byteSize());
+                }
+            }
+        }
+        for (size_t i = 0; i < iterations; i++) {
+            // all infer requests run concurrently, like under load, each on a different sample
+            for (size_t streamId = 0; streamId < inferRequestsQueue->size(); streamId++) {
+                auto& inferRequest = inferRequestsQueue->getInferRequest(streamId);
+                for (const auto& [name, array] : samples) {
+                    auto blob = inferRequest.GetBlob(getInputsInfo().at(name)->getName());
+                    const size_t sampleIndex = (i + streamId) % samplesCount;
+                    std::memcpy(blob->buffer().as<char*>(), array.data.data() + sampleIndex * blob->byteSize(), blob->byteSize());
+                }
+                inferRequest.StartAsync();
+            }
+            for (size_t streamId = 0; streamId < inferRequestsQueue->size(); streamId++) {
+                auto sts = inferRequestsQueue->getInferRequest(streamId).Wait(InferenceEngine::IInferRequest::RESULT_READY);
+                if (sts != InferenceEngine::StatusCode::OK) {
+                    SPDLOG_ERROR("Warm up inference failed for model {}; version: {}; status: {}", getName(), getVersion(), sts);
+                    return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+                }
+            }
+        }
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        SPDLOG_ERROR("Warm up inference failed for model {}; version: {}; error: {}", getName(), getVersion(), e.what());
+        return StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+    }
+    SPDLOG_INFO("Warmed up model {}; version: {}; with {} inferences on each of {} infer requests using {} samples in {} ms",
+        getName(), getVersion(), iterations, inferRequestsQueue->size(), samplesCount,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - warmUpStart).count());
     return StatusCode::OK;
 }
 
 void ModelInstance::configureBatchSize(const ModelConfig& config, const DynamicModelParameter& parameter) {
     if (parameter.isBatchSizeRequested()) {
         network->setBatchSize(parameter.getBatchSize());
+    } else if (config.isDynamicBatchingEnabled()) {
+        network->setBatchSize(config.getMaxBatchSize());
     } else if (config.getBatchSize() > 0) {
         network->setBatchSize(config.getBatchSize());
     }
@@ -406,19 +1184,47 @@ void ModelInstance::configureBatchSize(const ModelConfig& config, const DynamicM
 
 Status ModelInstance::loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter) {
     subscriptionManager.notifySubscribers();
+    takeInMemoryModelFiles(config);
     this->path = config.getPath();
     this->targetDevice = config.getTargetDevice();
     this->config = config;
+    this->config.clearInMemoryModelFiles();
+    // sequences hold infer requests of previous network, their state is not carried over
+    sequenceManager.reset();
+    networkCache.setCapacity(config.getNetworkCacheSize());
     auto status = fetchModelFilepaths();
     if (!status.ok()) {
         this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
         return status;
     }
+    std::vector<int> cpus;
+    status = getRequestedCpus(config.getNumaNode(), config.getCpuSet(), cpus);
+    if (status.ok() && config.isCpuSetExclusive()) {
+        if (cpus.empty()) {
+            SPDLOG_ERROR("Model:{} version:{} with exclusive CPU set requires cpu_set or numa_node", getName(), getVersion());
+            status = StatusCode::CPU_AFFINITY_INVALID;
+        } else {
+            status = CpuReservations::getInstance().reserve(getName(), cpus);
+        }
+    } else if (status.ok()) {
+        status = CpuReservations::getInstance().excludeReserved(getName(), cpus);
+    }
+    if (!status.ok()) {
+        this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+        return status;
+    }
+    // assigned only when changed since reloads triggered by requests run while other requests read it
+    if (cpus != cpuAffinity) {
+        cpuAffinity = std::move(cpus);
+    }
+    // plugin threads created and buffers first touched during loading and warm up stay on requested CPUs
+    CpuAffinityGuard cpuAffinityGuard(cpuAffinity);
     try {
         if (!this->engine)
             loadOVEngine();
         status = StatusCode::OK;
         if (!this->network) {
+            LoadingPhaseTimer readNetworkTimer(loadingProfile, LoadingPhase::READ_NETWORK);
             if (this->config.isCustomLoaderRequiredToLoadModel()) {
                 // loading the model using the custom loader
                 status = loadOVCNNNetworkUsingCustomLoader();
@@ -432,35 +1238,116 @@ Status ModelInstance::loadModelImpl(const ModelConfig& config, const DynamicMode
             return status;
         }
 
-        configureBatchSize(this->config, parameter);
-        status = loadInputTensors(this->config, parameter);
-        if (!status.ok()) {
-            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-            return status;
+        {
+            LoadingPhaseTimer reshapeTimer(loadingProfile, LoadingPhase::RESHAPE);
+            configureBatchSize(this->config, parameter);
+            status = loadInputTensors(this->config, parameter);
+            if (!status.ok()) {
+                this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+                return status;
+            }
+            loadOutputTensors(this->config);
         }
-        loadOutputTensors(this->config);
-        status = loadOVExecutableNetwork(this->config);
-        if (!status.ok()) {
-            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
-            return status;
+        {
+            // auto tuning compiles networks for benchmarked configurations, so it is part of this phase
+            LoadingPhaseTimer loadNetworkTimer(loadingProfile, LoadingPhase::LOAD_NETWORK);
+            // tuning is done once for configuration, network compiled with the selected one is kept
+            const bool tuning = parameter.isEmpty() && !tuningChoice && this->config.isAutoTune();
+            if (tuning) {
+                status = tuneThroughputStreams(this->config);
+                if (!status.ok()) {
+                    this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+                    return status;
+                }
+            }
+            if (!tuning || !tuningChoice) {
+                status = loadOVExecutableNetwork(this->config);
+            }
+            if (!status.ok()) {
+                this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+                return status;
+            }
+        }
+        {
+            LoadingPhaseTimer createInferRequestsTimer(loadingProfile, LoadingPhase::CREATE_INFER_REQUESTS);
+            status = prepareInferenceRequestsQueue(this->config);
         }
-        status = prepareInferenceRequestsQueue(this->config);
         if (!status.ok()) {
             this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
             return status;
         }
+        prepareBatchingScheduler(this->config);
+        prepareSequenceManager(this->config);
+        prepareInputsSignature();
+        prepareHugePagesIOBlobs(this->config);
+        prepareRemoteIOBlobs(this->config);
+        preparePreallocatedInputBlobs(this->config);
+        // reloads triggered by requests shapes are not delayed by warm up
+        if (parameter.isEmpty()) {
+            LoadingPhaseTimer warmUpTimer(loadingProfile, LoadingPhase::WARM_UP);
+            status = warmUp(this->config);
+            if (!status.ok()) {
+                this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+                return status;
+            }
+        }
     } catch (const InferenceEngine::details::InferenceEngineException& e) {
         SPDLOG_ERROR("exception occurred while loading network: {}", e.what());
         this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
         return StatusCode::NETWORK_NOT_LOADED;
     }
-    this->status.setAvailable();
+    batchSize = network->getBatchSize();
+    if (this->config.isLeanMemory()) {
+        // weights memory is kept since compiled network may refer to it, network is read again on reshape or reload
+        network.reset();
+        SPDLOG_DEBUG("Released host copy of network of model: {}, version: {}", getName(), getVersion());
+    }
+    memoryUsage = estimateMemoryUsage();
+    SPDLOG_DEBUG("Estimated memory usage of model: {}, version: {} is {} MB", getName(), getVersion(), memoryUsage / (1024 * 1024));
+    updateLastUsedTime();
+    if (tuningChoice) {
+        this->status.setDetails(tuningChoice->description);
+    }
+    setAvailable();
     modelLoadedNotify.notify_all();
     return status;
 }
 
+size_t ModelInstance::estimateMemoryUsage() const {
+    size_t usage = 0;
+    if (inMemoryModelFiles) {
+        usage += inMemoryModelFiles->model.size() + inMemoryModelFiles->weights.size();
+    }
+    for (const auto& file : modelFiles) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(file, ec);
+        if (!ec) {
+            usage += size;
+        }
+    }
+    size_t blobsSize = 0;
+    for (const auto* tensors : {&inputsInfo, &outputsInfo}) {
+        for (const auto& [name, tensorInfo] : *tensors) {
+            size_t size = tensorInfo->getPrecision().size();
+            for (auto dim : tensorInfo->getShape()) {
+                size *= dim;
+            }
+            blobsSize += size;
+        }
+    }
+    return usage + blobsSize * (inferRequestsQueue ? inferRequestsQueue->size() : 0);
+}
+
+void ModelInstance::updateLastUsedTime() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    const auto resolution = std::chrono::duration_cast<std::chrono::steady_clock::duration>(LAST_USED_TIME_RESOLUTION).count();
+    if (now - lastUsedTicks.load(std::memory_order_relaxed) >= resolution) {
+        lastUsedTicks.store(now, std::memory_order_relaxed);
+    }
+}
+
 Status ModelInstance::loadModel(const ModelConfig& config) {
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    std::lock_guard loadingLock(loadingMutex);
     SPDLOG_INFO("Loading model: {}, version: {}, from path: {}, with target device: {} ...",
         config.getName(), config.getVersion(), config.getPath(), config.getTargetDevice());
     if (config.getBatchingMode() == AUTO) {
@@ -468,13 +1355,54 @@ Status ModelInstance::loadModel(const ModelConfig& config) {
     } else if (config.anyShapeSetToAuto()) {
         SPDLOG_INFO("Some inputs shapes for model {} are set to auto", config.getName());
     }
-    this->status = ModelVersionStatus(config.getName(), config.getVersion());
+    this->status = ModelVersionStatus(config.getName(), config.getVersion(), ModelVersionState::START, &statusPublished);
+    networkCache.clear();
+    tuningChoice.reset();
+    if (isLoadingDeferred(config)) {
+        deferLoading(config);
+        return StatusCode::OK;
+    }
     this->status.setLoading();
+    evicted = false;
     return loadModelImpl(config);
 }
 
+bool ModelInstance::isLoadingDeferred(const ModelConfig& config) const {
+    if (!config.isLazyLoad()) {
+        return false;
+    }
+    if (config.isCustomLoaderRequiredToLoadModel()) {
+        SPDLOG_WARN("Lazy loading is not supported for model: {} loaded with custom loader, loading now", config.getName());
+        return false;
+    }
+    return true;
+}
+
+void ModelInstance::takeInMemoryModelFiles(const ModelConfig& config) {
+    // only files of this version are kept, configuration copy does not keep files of other versions alive
+    if (auto files = config.getInMemoryModelFiles(config.getVersion())) {
+        inMemoryModelFiles = std::move(files);
+    } else if (!config.isDownloadToMemory()) {
+        inMemoryModelFiles.reset();
+    }
+}
+
+void ModelInstance::deferLoading(const ModelConfig& config) {
+    SPDLOG_INFO("Loading of model: {}, version: {} is deferred until first request", config.getName(), config.getVersion());
+    subscriptionManager.notifySubscribers();
+    takeInMemoryModelFiles(config);
+    this->path = config.getPath();
+    this->targetDevice = config.getTargetDevice();
+    this->config = config;
+    this->config.clearInMemoryModelFiles();
+    releaseResources();
+    this->status = ModelVersionStatus(config.getName(), config.getVersion(), ModelVersionState::START, &statusPublished);
+    evicted = true;
+    modelLoadedNotify.notify_all();
+}
+
 Status ModelInstance::recoverFromReshapeError() {
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    std::lock_guard loadingLock(loadingMutex);
     this->status.setLoading();
     if (!canUnloadInstance()) {
         this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
@@ -487,19 +1415,32 @@ Status ModelInstance::recoverFromReshapeError() {
         return status;
     }
     this->loadOutputTensors(this->config);
-    this->status.setAvailable();
+    prepareInputsSignature();
+    setAvailable();
     this->modelLoadedNotify.notify_all();
     return StatusCode::OK;
 }
 
 Status ModelInstance::reloadModel(const ModelConfig& config, const DynamicModelParameter& parameter) {
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    std::lock_guard loadingLock(loadingMutex);
+    // versions serving requests are reloaded right away also with lazy loading
+    const bool deferred = parameter.isEmpty() && getStatus().getState() != ModelVersionState::AVAILABLE && isLoadingDeferred(config);
     this->status.setLoading();
     while (!canUnloadInstance()) {
         SPDLOG_INFO("Waiting to reload model: {} version: {}. Blocked by: {} inferences in progress.",
             getName(), getVersion(), predictRequestsHandlesCount);
         std::this_thread::sleep_for(std::chrono::milliseconds(UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS));
     }
+    // networks compiled with previous configuration are not valid anymore
+    networkCache.clear();
+    if (parameter.isEmpty()) {
+        tuningChoice.reset();
+    }
+    if (deferred) {
+        deferLoading(config);
+        return StatusCode::OK;
+    }
+    evicted = false;
     return loadModelImpl(config, parameter);
 }
 
@@ -524,10 +1465,10 @@ Status ModelInstance::recoverFromReloadingError(const Status& status) {
 Status ModelInstance::reloadModel(size_t batchSize, std::map<std::string, shape_t> requestShapes, std::unique_ptr<ModelInstanceUnloadGuard>& unloadGuard) {
     // temporarily release current predictRequest lock on model loading
     unloadGuard.reset();
+    const uint64_t reloadsCountBeforeWaiting = requestedReloadsCount;
     // block concurrent requests for reloading/unloading - assure that after reload predict request
     // will block further requests for reloading/unloading until inference is performed
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
-    SPDLOG_INFO("Will reload model:{} version:{}", getName(), getVersion());
+    std::lock_guard loadingLock(loadingMutex);
 
     DynamicModelParameter parameter;
     if (batchSize > 0) {
@@ -539,15 +1480,165 @@ Status ModelInstance::reloadModel(size_t batchSize, std::map<std::string, shape_
         return StatusCode::INTERNAL_ERROR;
     }
 
+    // requests which waited for reload to the same shapes reuse its result instead of reloading again
+    auto targetShapes = getTargetInputShapes(batchSize, requestShapes);
+    if (hasInputShapes(targetShapes)) {
+        SPDLOG_DEBUG("Model:{} version:{} was already reloaded to requested shapes", getName(), getVersion());
+        unloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
+        return StatusCode::OK;
+    }
+    if (requestedReloadsCount != reloadsCountBeforeWaiting && lastRequestedReloadShapes == targetShapes && !lastRequestedReloadStatus.ok()) {
+        SPDLOG_DEBUG("Model:{} version:{} reload to requested shapes failed meanwhile, not retried", getName(), getVersion());
+        return lastRequestedReloadStatus;
+    }
+    SPDLOG_INFO("Will reload model:{} version:{}", getName(), getVersion());
+    lastRequestedReloadShapes = targetShapes;
+    requestedReloadsCount++;
+
+    if (networkCache.getCapacity() > 0 && !batchingScheduler) {
+        auto status = reloadModelUsingNetworkCache(parameter, targetShapes);
+        lastRequestedReloadStatus = status;
+        if (status.ok()) {
+            unloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
+        }
+        return status;
+    }
+
     auto status = reloadModel(config, parameter);
     if (!status.ok()) {
-        return this->recoverFromReloadingError(status);
+        status = this->recoverFromReloadingError(status);
     } else {
         unloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
     }
+    lastRequestedReloadStatus = status;
+    return status;
+}
+
+bool ModelInstance::hasInputShapes(const std::map<std::string, shape_t>& shapes) const {
+    if (getStatus().getState() != ModelVersionState::AVAILABLE || shapes.size() != inputsInfo.size()) {
+        return false;
+    }
+    for (const auto& [name, shape] : shapes) {
+        auto it = inputsInfo.find(name);
+        if (it == inputsInfo.end() || it->second->getShape() != shape) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<CachedNetwork> ModelInstance::takeCurrentNetwork() {
+    sequenceManager.reset();
+    auto currentNetwork = std::make_shared<CachedNetwork>();
+    currentNetwork->execNetwork = std::move(execNetwork);
+    currentNetwork->balancedExecNetworks = std::move(balancedExecNetworks);
+    currentNetwork->latencyExecNetwork = std::move(latencyExecNetwork);
+    currentNetwork->inferRequestsQueue = std::move(inferRequestsQueue);
+    currentNetwork->inputsInfo = std::move(inputsInfo);
+    currentNetwork->outputsInfo = std::move(outputsInfo);
+    currentNetwork->preallocatedInputBlobs = std::move(preallocatedInputBlobs);
+    currentNetwork->batchSize = getBatchSize();
+    execNetwork.reset();
+    balancedExecNetworks.clear();
+    latencyExecNetwork.reset();
+    inferRequestsQueue.reset();
+    inputsInfo.clear();
+    outputsInfo.clear();
+    preallocatedInputBlobs.clear();
+    inputsSignature = InputsSignature();
+    return currentNetwork;
+}
+
+Status ModelInstance::restoreNetwork(CachedNetwork& cachedNetwork) {
+    // CNN network is kept in sync since batch size and subsequent reshapes are derived from it,
+    // released one is read again from model files when needed
+    if (network) {
+        InferenceEngine::ICNNNetwork::InputShapes networkShapes;
+        for (const auto& [name, tensorInfo] : cachedNetwork.inputsInfo) {
+            networkShapes[tensorInfo->getName()] = tensorInfo->getShape();
+        }
+        try {
+            network->reshape(networkShapes);
+        } catch (const InferenceEngine::details::InferenceEngineException& e) {
+            SPDLOG_WARN("Failed to reshape model: {} version: {} to shapes of cached network", getName(), getVersion());
+            SPDLOG_DEBUG("Description: {}", e.what());
+            return StatusCode::RESHAPE_ERROR;
+        }
+    }
+    batchSize = cachedNetwork.batchSize;
+    execNetwork = std::move(cachedNetwork.execNetwork);
+    balancedExecNetworks = std::move(cachedNetwork.balancedExecNetworks);
+    latencyExecNetwork = std::move(cachedNetwork.latencyExecNetwork);
+    inferRequestsQueue = std::move(cachedNetwork.inferRequestsQueue);
+    inputsInfo = std::move(cachedNetwork.inputsInfo);
+    outputsInfo = std::move(cachedNetwork.outputsInfo);
+    preallocatedInputBlobs = std::move(cachedNetwork.preallocatedInputBlobs);
+    prepareSequenceManager(config);
+    prepareInputsSignature();
+    return StatusCode::OK;
+}
+
+std::map<std::string, shape_t> ModelInstance::getTargetInputShapes(size_t batchSize, const std::map<std::string, shape_t>& requestShapes) const {
+    std::map<std::string, shape_t> targetShapes;
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        shape_t shape = tensorInfo->getShape();
+        if (batchSize > 0) {
+            if (shape.size() > 0) {
+                shape[0] = batchSize;
+            }
+        } else {
+            auto requestShapeItr = requestShapes.find(name);
+            if (requestShapeItr != requestShapes.end() && config.isShapeAuto(tensorInfo->getName())) {
+                shape = requestShapeItr->second;
+            }
+        }
+        targetShapes.emplace(name, std::move(shape));
+    }
+    return targetShapes;
+}
+
+Status ModelInstance::reloadModelUsingNetworkCache(const DynamicModelParameter& parameter, const std::map<std::string, shape_t>& targetShapes) {
+    std::lock_guard loadingLock(loadingMutex);
+    this->status.setLoading();
+    while (!canUnloadInstance()) {
+        SPDLOG_INFO("Waiting to reload model: {} version: {}. Blocked by: {} inferences in progress.",
+            getName(), getVersion(), predictRequestsHandlesCount);
+        std::this_thread::sleep_for(std::chrono::milliseconds(UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS));
+    }
+    auto cachedNetwork = networkCache.take(targetShapes);
+    auto currentNetwork = takeCurrentNetwork();
+    Status status = StatusCode::OK;
+    if (cachedNetwork) {
+        SPDLOG_INFO("Reusing cached network for model:{} version:{}", getName(), getVersion());
+        status = restoreNetwork(*cachedNetwork);
+    } else {
+        status = loadModelImpl(config, parameter);
+    }
+    if (!status.ok()) {
+        SPDLOG_WARN("Failed to reload model:{} version:{} with error:{}. Restoring previous network",
+            getName(), getVersion(), status.string());
+        auto recoveryStatus = restoreNetwork(*currentNetwork);
+        if (!recoveryStatus.ok()) {
+            this->status.setLoading(ModelVersionStatusErrorCode::UNKNOWN);
+            return status;
+        }
+    } else {
+        networkCache.insert(std::move(currentNetwork));
+    }
+    setAvailable();
+    modelLoadedNotify.notify_all();
     return status;
 }
 
+size_t ModelInstance::removeIdleSequences() {
+    // guard keeps sequence manager from being reset by concurrent reload or unload
+    ModelInstanceUnloadGuard unloadGuard(*this);
+    if (getStatus().getState() != ModelVersionState::AVAILABLE || !sequenceManager) {
+        return 0;
+    }
+    return sequenceManager->removeIdleSequences();
+}
+
 Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMilliseconds,
     std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuard) {
     // order is important here for performance reasons
@@ -555,10 +1646,24 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
     modelInstanceUnloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
     if (getStatus().getState() == ModelVersionState::AVAILABLE) {
         SPDLOG_DEBUG("Model:{}, version:{} already loaded", getName(), getVersion());
+        updateLastUsedTime();
         return StatusCode::OK;
     }
-    SPDLOG_INFO("Model:{} version:{} is still loading", getName(), getVersion());
     modelInstanceUnloadGuard.reset();
+    if (evicted) {
+        // loaded also for requests which do not wait, concurrent ones wait below until it is loaded
+        auto status = loadOnDemand();
+        if (!status.ok()) {
+            return status;
+        }
+        modelInstanceUnloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
+        if (getStatus().getState() == ModelVersionState::AVAILABLE) {
+            updateLastUsedTime();
+            return StatusCode::OK;
+        }
+        modelInstanceUnloadGuard.reset();
+    }
+    SPDLOG_INFO("Model:{} version:{} is still loading", getName(), getVersion());
 
     // wait several time since no guarantee that cv wakeup will be triggered before calling wait_for
     const uint waitLoadedTimestepMilliseconds = 100;
@@ -569,10 +1674,16 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
     std::mutex cv_mtx;
     std::unique_lock<std::mutex> cv_lock(cv_mtx);
     while (waitCheckpointsCounter-- > 0) {
+        if (evicted) {
+            auto status = loadOnDemand();
+            if (!status.ok()) {
+                return status;
+            }
+        }
         if (modelLoadedNotify.wait_for(cv_lock,
                 std::chrono::milliseconds(waitLoadedTimestepMilliseconds),
                 [this]() {
-                    return this->getStatus().getState() > ModelVersionState::LOADING;
+                    return this->getStatus().getState() > ModelVersionState::LOADING || evicted;
                 })) {
             SPDLOG_INFO("Waiting for model:{} version:{} loaded state for:{} time",
                 getName(), getVersion(), waitCheckpoints - waitCheckpointsCounter);
@@ -580,6 +1691,7 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
         modelInstanceUnloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*this);
         if (getStatus().getState() == ModelVersionState::AVAILABLE) {
             SPDLOG_INFO("Succesfully waited for model:{}, version:{}", getName(), getVersion());
+            updateLastUsedTime();
             return StatusCode::OK;
         }
         modelInstanceUnloadGuard.reset();
@@ -599,21 +1711,61 @@ Status ModelInstance::waitForLoaded(const uint waitForModelLoadedTimeoutMillisec
     }
 }
 
+namespace {
+// declared in reverse order of destruction, infer requests are destroyed before networks they were created from
+struct ReleasedNetworkResources {
+    std::shared_ptr<const InMemoryModelFiles> inMemoryModelFiles;
+    std::shared_ptr<const void> customLoaderWeights;
+    std::shared_ptr<const MappedFile> weightsFile;
+    std::unique_ptr<InferenceEngine::CNNNetwork> network;
+    std::vector<std::shared_ptr<InferenceEngine::ExecutableNetwork>> balancedExecNetworks;
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> latencyExecNetwork;
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
+    std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
+};
+}  // namespace
+
+void ModelInstance::beginRetirement() {
+    std::lock_guard loadingLock(loadingMutex);
+    // retired version is not loaded on demand anymore
+    evicted = false;
+    this->status.setUnloading();
+    modelLoadedNotify.notify_all();
+}
+
+void ModelInstance::finishRetirement() {
+    std::lock_guard loadingLock(loadingMutex);
+    if (getStatus().getState() != ModelVersionState::UNLOADING) {
+        SPDLOG_DEBUG("Model: {} version: {} was loaded again before its retirement finished", getName(), getVersion());
+        return;
+    }
+    unloadModel();
+}
+
 void ModelInstance::unloadModel() {
-    std::lock_guard<std::recursive_mutex> loadingLock(loadingMutex);
+    std::lock_guard loadingLock(loadingMutex);
     this->status.setUnloading();
     while (!canUnloadInstance()) {
         SPDLOG_DEBUG("Waiting to unload model:{} version:{}. Blocked by:{} inferences in progres.",
             getName(), getVersion(), predictRequestsHandlesCount);
         std::this_thread::sleep_for(std::chrono::milliseconds(UNLOAD_AVAILABILITY_CHECKING_INTERVAL_MILLISECONDS));
     }
-    inferRequestsQueue.reset();
-    execNetwork.reset();
-    network.reset();
-    engine.reset();
-    outputsInfo.clear();
-    inputsInfo.clear();
-    modelFiles.clear();
+    // destroying compiled networks may take seconds for big models, so it is done in background
+    batchingScheduler.reset();
+    sequenceManager.reset();
+    auto resources = std::make_shared<ReleasedNetworkResources>();
+    resources->inMemoryModelFiles = std::move(inMemoryModelFiles);
+    resources->customLoaderWeights = std::move(customLoaderWeights);
+    resources->weightsFile = std::move(weightsFile);
+    resources->network = std::move(network);
+    resources->balancedExecNetworks = std::move(balancedExecNetworks);
+    resources->latencyExecNetwork = std::move(latencyExecNetwork);
+    resources->execNetwork = std::move(execNetwork);
+    resources->inferRequestsQueue = std::move(inferRequestsQueue);
+    const size_t releasedMemoryUsage = memoryUsage;
+    releaseResources();
+    ModelReaper::getInstance().release(std::move(resources), releasedMemoryUsage);
+    evicted = false;
     status.setEnd();
 
     if (this->config.isCustomLoaderRequiredToLoadModel()) {
@@ -630,6 +1782,68 @@ void ModelInstance::unloadModel() {
     }
 }
 
+void ModelInstance::releaseResources() {
+    batchingScheduler.reset();
+    sequenceManager.reset();
+    inputsSignature = InputsSignature();
+    networkCache.clear();
+    preallocatedInputBlobs.clear();
+    inferRequestsQueue.reset();
+    execNetwork.reset();
+    balancedExecNetworks.clear();
+    latencyExecNetwork.reset();
+    network.reset();
+    weightsFile.reset();
+    customLoaderWeights.reset();
+    engine.reset();
+    outputsInfo.clear();
+    inputsInfo.clear();
+    modelFiles.clear();
+    memoryUsage = 0;
+}
+
+bool ModelInstance::evict() {
+    std::unique_lock loadingLock(loadingMutex, std::try_to_lock);
+    if (!loadingLock.owns_lock() || getStatus().getState() != ModelVersionState::AVAILABLE ||
+        config.isCustomLoaderRequiredToLoadModel() || !canUnloadInstance()) {
+        return false;
+    }
+    // requests coming from now on wait for version to be loaded again instead of using released network
+    this->status = ModelVersionStatus(getName(), getVersion(), ModelVersionState::START, &statusPublished);
+    if (!canUnloadInstance()) {
+        this->status.setAvailable();
+        return false;
+    }
+    SPDLOG_INFO("Evicting model: {}, version: {} using estimated {} MB", getName(), getVersion(), memoryUsage / (1024 * 1024));
+    releaseResources();
+    evicted = true;
+    modelLoadedNotify.notify_all();
+    return true;
+}
+
+Status ModelInstance::loadOnDemand() {
+    {
+        std::unique_lock loadingLock(loadingMutex, std::try_to_lock);
+        if (!loadingLock.owns_lock() || !evicted) {
+            // loaded by concurrent request or reload, waiting requests are notified once it is done
+            return StatusCode::OK;
+        }
+        SPDLOG_INFO("Loading model: {}, version: {} on demand", getName(), getVersion());
+        evicted = false;
+        this->status.setLoading();
+        auto status = loadModelImpl(config);
+        if (!status.ok()) {
+            // next request retries loading
+            SPDLOG_ERROR("Failed to load model: {}, version: {} on demand with error: {}", getName(), getVersion(), status.string());
+            evicted = true;
+            modelLoadedNotify.notify_all();
+            return status;
+        }
+    }
+    ModelManager::getInstance().enforceMemoryBudget(this);
+    return StatusCode::OK;
+}
+
 const Status ModelInstance::validatePrecision(const ovms::TensorInfo& networkInput,
     const tensorflow::TensorProto& requestInput) {
     // Network and request must have the same precision
@@ -662,6 +1876,11 @@ const Status ModelInstance::validateNumberOfShapeDimensions(const ovms::TensorIn
 
 const bool ModelInstance::checkBatchSizeMismatch(const ovms::TensorInfo& networkInput,
     const tensorflow::TensorProto& requestInput) {
+    if (batchingScheduler) {
+        // Requests smaller than network batch size are merged by batching scheduler
+        return requestInput.tensor_shape().dim(0).size() <= 0 ||
+               static_cast<size_t>(requestInput.tensor_shape().dim(0).size()) > getBatchSize();
+    }
     if (static_cast<size_t>(requestInput.tensor_shape().dim(0).size()) != getBatchSize())
         return true;
     return false;
@@ -672,7 +1891,7 @@ const bool ModelInstance::checkShapeMismatch(const ovms::TensorInfo& networkInpu
     const Mode& batchingMode) {
     // Network and request must have the same shape
     auto& shape = networkInput.getShape();
-    int i = (batchingMode == AUTO) ? 1 : 0;  // If batch size is automatic, omit first dimension
+    int i = (batchingMode == AUTO || batchingScheduler) ? 1 : 0;  // If batch size is automatic or dynamically batched, omit first dimension
     for (; i < requestInput.tensor_shape().dim_size(); i++) {
         if (requestInput.tensor_shape().dim(i).size() < 0 ||
             shape[i] != static_cast<size_t>(requestInput.tensor_shape().dim(i).size())) {
@@ -706,6 +1925,26 @@ const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& ne
         expectedValueCount *= requestInput.tensor_shape().dim(i).size();
     }
 
+    // Values of all precisions are kept in native width in shared memory region
+    if (isSharedMemoryTensor(requestInput)) {
+        std::shared_ptr<const SharedMemoryRegion> region;
+        const char* data = nullptr;
+        auto status = getSharedMemoryTensorData(requestInput, expectedValueCount * networkInput.getPrecision().size(), region, data);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("[Model:{} version:{}] Invalid shared memory tensor - {}", getName(), getVersion(), status.string());
+        }
+        return status;
+    }
+    if (isCachedTensorReference(requestInput)) {
+        std::shared_ptr<const CachedTensor> tensor;
+        const char* data = nullptr;
+        auto status = getCachedTensorData(requestInput, expectedValueCount * networkInput.getPrecision().size(), tensor, data);
+        if (!status.ok()) {
+            SPDLOG_DEBUG("[Model:{} version:{}] Invalid cached tensor reference - {}", getName(), getVersion(), status.string());
+        }
+        return status;
+    }
+
     // Network expects tensor content size or value count
     if (requestInput.dtype() == tensorflow::DataType::DT_UINT16) {
         if (requestInput.int_val_size() < 0 ||
@@ -738,13 +1977,42 @@ const Status ModelInstance::validateTensorContentSize(const ovms::TensorInfo& ne
     return StatusCode::OK;
 }
 
+const Status ModelInstance::validateEncodedImages(const ovms::TensorInfo& networkInput,
+    const tensorflow::TensorProto& requestInput) {
+    // Encoded images are decoded into 4 dimensional U8 or FP32 input, request shape holds number of images
+    if (networkInput.getShape().size() != 4 ||
+        (networkInput.getPrecision() != InferenceEngine::Precision::U8 && networkInput.getPrecision() != InferenceEngine::Precision::FP32)) {
+        std::stringstream ss;
+        ss << "Expected: " << networkInput.getPrecisionAsString() << "; Actual: " << TensorInfo::getDataTypeAsString(requestInput.dtype())
+           << ", encoded images are supported only for 4 dimensional U8 or FP32 inputs";
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model:{} version:{}] Invalid precision - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_PRECISION, details);
+    }
+    if (requestInput.tensor_shape().dim_size() != 1 ||
+        requestInput.tensor_shape().dim(0).size() != requestInput.string_val_size()) {
+        std::stringstream ss;
+        ss << "Expected: [" << requestInput.string_val_size() << "]; Actual: " << TensorInfo::tensorShapeToString(requestInput.tensor_shape());
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("[Model:{} version:{}] Invalid number of encoded images - {}", getName(), getVersion(), details);
+        return Status(StatusCode::INVALID_NO_OF_SHAPE_DIMENSIONS, details);
+    }
+    return StatusCode::OK;
+}
+
 const Status ModelInstance::validate(const tensorflow::serving::PredictRequest* request) {
+    // Most requests match loaded network exactly, detailed validation below is needed only to report what differs
+    if (inputsSignature.matches(*request)) {
+        return StatusCode::OK;
+    }
+
     Status finalStatus = StatusCode::OK;
 
-    // Network and request must have the same amount of inputs
-    if (request->inputs_size() < 0 || getInputsInfo().size() != static_cast<size_t>(request->inputs_size())) {
+    // Network and request must have the same amount of inputs, sequence inputs of stateful model are not passed to network
+    const size_t expectedInputsCount = getInputsInfo().size() + (sequenceManager ? getSequenceInputsCount(*request) : 0);
+    if (request->inputs_size() < 0 || expectedInputsCount != static_cast<size_t>(request->inputs_size())) {
         std::stringstream ss;
-        ss << "Expected: " << getInputsInfo().size() << "; Actual: " << request->inputs_size();
+        ss << "Expected: " << expectedInputsCount << "; Actual: " << request->inputs_size();
         const std::string details = ss.str();
         SPDLOG_DEBUG("[Model:{} version:{}] Invalid number of inputs - {}", getName(), getVersion(), details);
         return Status(StatusCode::INVALID_NO_OF_INPUTS, details);
@@ -768,6 +2036,25 @@ const Status ModelInstance::validate(const tensorflow::serving::PredictRequest*
         Mode batchingMode = getModelConfig().getBatchingMode();
         Mode shapeMode = getModelConfig().isShapeAuto(name) ? AUTO : FIXED;
 
+        if (requestInput.dtype() == tensorflow::DataType::DT_STRING) {
+            auto status = validateEncodedImages(*networkInput, requestInput);
+            if (!status.ok())
+                return status;
+            // Image size is validated when images are decoded
+            if (checkBatchSizeMismatch(*networkInput, requestInput)) {
+                if (batchingMode == AUTO) {
+                    finalStatus = StatusCode::BATCHSIZE_CHANGE_REQUIRED;
+                } else {
+                    std::stringstream ss;
+                    ss << "Expected: " << (batchingScheduler ? "up to " : "") << getBatchSize() << "; Actual: " << requestInput.string_val_size();
+                    const std::string details = ss.str();
+                    SPDLOG_DEBUG("[Model:{} version:{}] Invalid batch size - {}", getName(), getVersion(), details);
+                    return Status(StatusCode::INVALID_BATCH_SIZE, details);
+                }
+            }
+            continue;
+        }
+
         auto status = validatePrecision(*networkInput, requestInput);
         if (!status.ok())
             return status;
@@ -781,7 +2068,7 @@ const Status ModelInstance::validate(const tensorflow::serving::PredictRequest*
                 finalStatus = StatusCode::BATCHSIZE_CHANGE_REQUIRED;
             } else if (shapeMode != AUTO) {
                 std::stringstream ss;
-                ss << "Expected: " << getBatchSize() << "; Actual: " << requestInput.tensor_shape().dim(0).size();
+                ss << "Expected: " << (batchingScheduler ? "up to " : "") << getBatchSize() << "; Actual: " << requestInput.tensor_shape().dim(0).size();
                 const std::string details = ss.str();
                 SPDLOG_DEBUG("[Model:{} version:{}] Invalid batch size - {}", getName(), getVersion(), details);
                 return Status(StatusCode::INVALID_BATCH_SIZE, details);
@@ -15,12 +15,16 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <inference_engine.hpp>
@@ -31,18 +35,30 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "batchingscheduler.hpp"
 #include "customloaderconfig.hpp"
 #include "customloaderinterface.hpp"
+#include "inputssignature.hpp"
+#include "loadingprofile.hpp"
+#include "lockmetrics.hpp"
+#include "mappedfile.hpp"
 #include "modelchangesubscription.hpp"
+#include "metrics.hpp"
 #include "modelconfig.hpp"
 #include "modelinstanceunloadguard.hpp"
 #include "modelversionstatus.hpp"
+#include "networkcache.hpp"
+#include "npyfile.hpp"
 #include "ovinferrequestsqueue.hpp"
+#include "sequencemanager.hpp"
 #include "status.hpp"
+#include "tensorbufferpool.hpp"
 #include "tensorinfo.hpp"
 
 namespace ovms {
 
+struct CompiledNetworkKey;
+
 using tensor_map_t = std::map<std::string, std::shared_ptr<TensorInfo>>;
 
 class DynamicModelParameter {
@@ -59,6 +75,7 @@ public:
 
     bool isBatchSizeRequested() const { return batchSize > 0; }
     bool isShapeRequested(const std::string& name) const { return shapes.count(name) && shapes.at(name).size() > 0; }
+    bool isEmpty() const { return batchSize == 0 && shapes.empty(); }
 
     int getBatchSize() const { return batchSize; }
     const shape_t& getShape(const std::string& name) const { return shapes.at(name); }
@@ -69,6 +86,7 @@ private:
 };
 
 class PipelineDefinition;
+struct ModelMetadataCacheEntry;
 
 /**
      * @brief This class contains all the information about inference engine model
@@ -76,9 +94,24 @@ class PipelineDefinition;
 class ModelInstance {
 protected:
     /**
-         * @brief Inference Engine core object
+         * @brief Inference Engine core object, shared by all model instances and kept until process exit
+         */
+    std::shared_ptr<InferenceEngine::Core> engine;
+
+    /**
+         * @brief Mapped weights file referenced by CNNNetwork, has to outlive it
+         */
+    std::shared_ptr<const MappedFile> weightsFile;
+
+    /**
+         * @brief Weights memory handed over by custom loader or read from cloud storage referenced by CNNNetwork, has to outlive it
+         */
+    std::shared_ptr<const void> customLoaderWeights;
+
+    /**
+         * @brief Model files read from cloud storage into memory, kept to read network again on reshape or load on demand
          */
-    std::unique_ptr<InferenceEngine::Core> engine;
+    std::shared_ptr<const InMemoryModelFiles> inMemoryModelFiles;
 
     /**
          * @brief Inference Engine CNNNetwork object
@@ -90,6 +123,21 @@ protected:
          */
     std::shared_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
 
+    /**
+         * @brief Networks loaded on each of balanced devices or NUMA nodes, empty if target device is neither balanced nor replicated
+         */
+    std::vector<std::shared_ptr<InferenceEngine::ExecutableNetwork>> balancedExecNetworks;
+
+    /**
+         * @brief CPUs of NUMA node of each of balancedExecNetworks when network is replicated for NUMA nodes, empty otherwise
+         */
+    std::vector<std::vector<int>> numaReplicasCpus;
+
+    /**
+         * @brief Network compiled with single throughput stream for latency sensitive requests, nullptr if not enabled in config
+         */
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> latencyExecNetwork;
+
     /**
          * @brief Model name
          */
@@ -128,7 +176,9 @@ protected:
     virtual std::unique_ptr<InferenceEngine::CNNNetwork> loadOVCNNNetworkPtr(const std::string& modelFile);
 
     /**
-         * @brief Load OV Engine
+         * @brief Load OV Engine, the process wide core is created on first use
+         *
+         * Device plugins are initialized once and schedule streams of all models together.
          */
     void loadOVEngine();
 
@@ -139,11 +189,83 @@ protected:
          */
     Status loadOVCNNNetwork();
 
+    /**
+         * @brief Loads OV CNNNetwork from model files read into memory
+         *
+         * @return Status
+         */
+    Status loadOVCNNNetworkFromMemory();
+
     /**
          * @brief Sets OV ExecutableNetworkPtr
          */
     virtual void loadExecutableNetworkPtr(const plugin_config_t& pluginConfig);
 
+    /**
+         * @brief Loads network on each of balanced devices, with plugin config keys supported by the device
+         */
+    void loadBalancedExecutableNetworks(const std::vector<std::string>& devices, const plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Loads network on CPUs of each NUMA node, so that its plugin threads and memory stay on the node
+         */
+    void loadNumaReplicaExecutableNetworks(const std::vector<std::vector<int>>& replicasCpus, const plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Gets CPUs of NUMA nodes the network should be replicated for, empty if it is loaded once
+         */
+    std::vector<std::vector<int>> getNumaReplicasCpus(const ModelConfig& config) const;
+
+    /**
+         * @brief Loads additional network compiled with single throughput stream if latency nireq is set in config
+         */
+    void loadLatencyExecutableNetwork(const ModelConfig& config, plugin_config_t pluginConfig);
+
+    /**
+         * @brief Hashes model files, device, plugin config and inputs of network, which identify compiled network
+         *
+         * @return false if model files cannot be read
+         */
+    bool getCompiledNetworkHash(const plugin_config_t& pluginConfig, uint64_t& hash) const;
+
+    /**
+         * @brief Gets full identity of compiled network shared with other model versions, including CPUs of the model
+         *
+         * @return false if model files cannot be read
+         */
+    bool getCompiledNetworkKey(const plugin_config_t& pluginConfig, CompiledNetworkKey& key) const;
+
+    /**
+         * @brief Gets path of exported network in compiled model cache, identified by model files, device, plugin config and inputs
+         *
+         * @return path or empty string if cache is disabled
+         */
+    std::string getCompiledModelCacheFilePath(const ModelConfig& config, const plugin_config_t& pluginConfig) const;
+
+    /**
+         * @brief Sets OV ExecutableNetworkPtr compiled, or imported from compiled model cache, for single target device
+         */
+    void loadOrImportExecutableNetwork(const std::string& cacheFilePath, const plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Sets OV ExecutableNetworkPtr shared with other model versions with identical model files, device, plugin config, inputs and CPUs
+         *
+         * @return false if network cannot be identified and is not shared
+         */
+    bool loadSharedExecutableNetwork(const std::string& cacheFilePath, const plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Sets OV ExecutableNetworkPtr imported from compiled model cache
+         *
+         * @return true if network was imported
+         */
+    bool importExecutableNetwork(const std::string& cacheFilePath, const plugin_config_t& pluginConfig);
+
+    /**
+         * @brief Exports OV ExecutableNetwork to compiled model cache if target device supports it
+         */
+    void exportExecutableNetwork(const std::string& cacheFilePath);
+
     /**
          * @brief Loads OV ExecutableNetwork
          *
@@ -151,11 +273,76 @@ protected:
          */
     Status loadOVExecutableNetwork(const ModelConfig& config);
 
+    /**
+         * @brief Prepares plugin config with defaults, CPU threads of requested affinity and auto tuning choice
+         */
+    plugin_config_t preparePluginConfig(const ModelConfig& config) const;
+
+    /**
+         * @brief Selects CPU streams and nireq with the highest throughput within latency limit by benchmarking a grid of them
+         *
+         * Network with the selected configuration is kept as execNetwork.
+         */
+    Status tuneThroughputStreams(const ModelConfig& config);
+
+    /**
+         * @brief Measures throughput and average latency of all infer requests running concurrently on warm up samples or zeros
+         */
+    Status benchmarkExecutableNetwork(InferenceEngine::ExecutableNetwork& executableNetwork, uint32_t nireq,
+        const std::map<std::string, NpyArray>& samples, size_t samplesCount, double& throughput, double& latencyMs);
+
     /**
          * @brief Prepares inferenceRequestsQueue
          */
     Status prepareInferenceRequestsQueue(const ModelConfig& config);
 
+    /**
+         * @brief Prepares inferenceRequestsQueue spanning infer requests of all balanced devices or NUMA replicas
+         */
+    Status prepareBalancedInferenceRequestsQueue(const ModelConfig& config);
+
+    /**
+         * @brief Prepares dynamic batching scheduler if enabled in config
+         */
+    void prepareBatchingScheduler(const ModelConfig& config);
+
+    /**
+         * @brief Prepares sequence manager if model is stateful
+         */
+    void prepareSequenceManager(const ModelConfig& config);
+
+    /**
+         * @brief Precomputes inputs signature of currently loaded network for fast path of request validation
+         */
+    void prepareInputsSignature();
+
+    /**
+         * @brief Caches input blobs allocated by each infer request if reusing them is enabled in config
+         */
+    void preparePreallocatedInputBlobs(const ModelConfig& config);
+
+    /**
+         * @brief Replaces input and output blobs of infer requests with blobs allocated from hugepages if enabled in config
+         */
+    void prepareHugePagesIOBlobs(const ModelConfig& config);
+
+    /**
+         * @brief Replaces input and output blobs of infer requests with blobs allocated in remote context of GPU device if enabled in config
+         */
+    void prepareRemoteIOBlobs(const ModelConfig& config);
+
+    /**
+         * @brief Runs inferences with every infer request so that lazy allocations are done before model is available
+         *
+         * Inputs are filled with samples from warm up data files if provided, zeros otherwise.
+         */
+    Status warmUp(const ModelConfig& config);
+
+    /**
+         * @brief Reads and validates warm up data files against inputs, samplesCount is the number of samples in the smallest file
+         */
+    Status readWarmupSamples(const ModelConfig& config, std::map<std::string, NpyArray>& samples, size_t& samplesCount);
+
     /**
          * @brief Fetch model file paths
          *
@@ -219,6 +406,127 @@ private:
          */
     std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
 
+    /**
+         * @brief Merges concurrent requests into one inference when dynamic batching is enabled
+         */
+    std::unique_ptr<BatchingScheduler> batchingScheduler;
+
+    /**
+         * @brief Sequences of stateful model holding infer requests, nullptr if model is not stateful
+         */
+    std::unique_ptr<SequenceManager> sequenceManager;
+
+    /**
+         * @brief Inputs of currently loaded network matched by valid requests, empty when network is not loaded
+         */
+    InputsSignature inputsSignature;
+
+    /**
+         * @brief Input blobs allocated by infer requests, indexed by stream id
+         */
+    std::vector<std::unordered_map<std::string, InferenceEngine::Blob::Ptr>> preallocatedInputBlobs;
+
+    /**
+         * @brief Allocator of infer requests blobs mapped from hugepages, nullptr until hugepages io blobs are enabled
+         */
+    std::shared_ptr<TensorBufferPool> hugePagesIOBlobsPool;
+
+    /**
+         * @brief Metadata response built for currently loaded inputs and outputs, nullptr until first requested
+         */
+    std::shared_ptr<const ModelMetadataCacheEntry> metadataCache;
+
+    /**
+         * @brief Drops cached metadata and marks version as available, called once inputs and outputs are (re)loaded
+         */
+    void setAvailable();
+
+    /**
+         * @brief Networks compiled for other shapes requested before, reused on auto reshape
+         */
+    NetworkCache networkCache;
+
+    /**
+         * @brief CPUs which threads loading and serving the model are restricted to, empty if any CPU may be used
+         */
+    std::vector<int> cpuAffinity;
+
+    /**
+         * @brief Latency histograms and counters of predict requests, kept across model reloads
+         */
+    ModelMetrics metrics;
+
+    /**
+         * @brief Durations of loading phases of the last load or reload
+         */
+    LoadingProfile loadingProfile;
+
+    /**
+         * @brief CPU streams and nireq selected by auto tuning, 0 when not tuned
+         */
+    struct TuningChoice {
+        uint32_t streams = 0;
+        uint32_t nireq = 0;
+        std::string description;
+    };
+
+    /**
+         * @brief Result of auto tuning, kept for loads on demand and reshapes with the same configuration
+         */
+    std::optional<TuningChoice> tuningChoice;
+
+    /**
+         * @brief Set while network is not loaded until next request, after eviction by memory budget or with lazy loading
+         */
+    std::atomic<bool> evicted = false;
+
+    /**
+         * @brief Flag determining if status transitions are reported to status snapshot, cleared for instances not served
+         */
+    std::atomic<bool> statusPublished = true;
+
+    /**
+         * @brief Estimated memory usage of loaded version in bytes
+         */
+    std::atomic<size_t> memoryUsage = 0;
+
+    /**
+         * @brief Steady clock ticks of last request, used to select least recently used versions for eviction
+         */
+    std::atomic<int64_t> lastUsedTicks = 0;
+
+    /**
+         * @brief Releases network, infer requests and files of loaded version
+         */
+    void releaseResources();
+
+    /**
+         * @brief Estimates memory taken by loaded version from model files size and input and output blobs of all infer requests
+         */
+    size_t estimateMemoryUsage() const;
+
+    /**
+         * @brief Loads evicted or lazily loaded version with its current configuration, concurrent requests wait on modelLoadedNotify
+         */
+    Status loadOnDemand();
+
+    /**
+         * @brief Checks if loading with given configuration waits for the first request
+         */
+    bool isLoadingDeferred(const ModelConfig& config) const;
+
+    /**
+         * @brief Stores configuration and releases version so that it is loaded by the first request
+         */
+    void deferLoading(const ModelConfig& config);
+
+    /**
+         * @brief Keeps model files of this version read into memory by configuration, released when configuration reads them from disk
+         */
+    void takeInMemoryModelFiles(const ModelConfig& config);
+
+    void updateLastUsedTime();
+
     /**
          * @brief Holds current usage count in predict requests
          * 
@@ -229,7 +537,27 @@ private:
     /**
          * @brief Lock to disable concurrent modelinstance load/unload/reload
          */
-    std::recursive_mutex loadingMutex;
+    InstrumentedMutex<std::recursive_mutex> loadingMutex{"model_loading"};
+
+    /**
+         * @brief Count of reloads with batch size or shape requested, lets requests waiting for loadingMutex detect reload done meanwhile
+         */
+    std::atomic<uint64_t> requestedReloadsCount = 0;
+
+    /**
+         * @brief Input shapes targeted by last reload with batch size or shape requested
+         */
+    std::map<std::string, shape_t> lastRequestedReloadShapes;
+
+    /**
+         * @brief Result of last reload with batch size or shape requested
+         */
+    Status lastRequestedReloadStatus;
+
+    /**
+         * @brief Tells whether model is available with given input shapes
+         */
+    bool hasInputShapes(const std::map<std::string, shape_t>& shapes) const;
 
     /**
          * @brief Internal method for loading inputs
@@ -252,6 +580,30 @@ private:
          */
     Status loadModelImpl(const ModelConfig& config, const DynamicModelParameter& parameter = DynamicModelParameter());
 
+    /**
+         * @brief Moves currently served network out of model instance
+         */
+    std::shared_ptr<CachedNetwork> takeCurrentNetwork();
+
+    /**
+         * @brief Makes cached network the one served by model instance
+         *
+         * @return status
+         */
+    Status restoreNetwork(CachedNetwork& cachedNetwork);
+
+    /**
+         * @brief Calculates input shapes network would have after reloading with batch size or shapes requested
+         */
+    std::map<std::string, shape_t> getTargetInputShapes(size_t batchSize, const std::map<std::string, shape_t>& requestShapes) const;
+
+    /**
+         * @brief Reloads model with batch size or shape requested, reusing previously compiled network if cached
+         *
+         * @return status
+         */
+    Status reloadModelUsingNetworkCache(const DynamicModelParameter& parameter, const std::map<std::string, shape_t>& targetShapes);
+
     /**
          * @brief Configures batchsize
          */
@@ -273,8 +625,11 @@ private:
     const Status validateTensorContentSize(const ovms::TensorInfo& networkInput,
         const tensorflow::TensorProto& requestInput);
 
-    uint32_t getNumOfParallelInferRequests(const ModelConfig& config);
-    uint32_t getNumOfParallelInferRequestsUnbounded(const ModelConfig& config);
+    const Status validateEncodedImages(const ovms::TensorInfo& networkInput,
+        const tensorflow::TensorProto& requestInput);
+
+    uint32_t getNumOfParallelInferRequests(const ModelConfig& config, InferenceEngine::ExecutableNetwork& executableNetwork);
+    uint32_t getNumOfParallelInferRequestsUnbounded(const ModelConfig& config, InferenceEngine::ExecutableNetwork& executableNetwork);
 
     /**
          * @brief Reloads model input/output metadata from current state of CNNNetwork
@@ -301,7 +656,7 @@ public:
     ModelInstance(const std::string& name, model_version_t version) :
         name(name),
         version(version),
-        subscriptionManager(std::string("model: ") + name + std::string(" version: ") + std::to_string(version)) {}
+        subscriptionManager(std::string("model: ") + name + std::string(" version: ") + std::to_string(version), name) {}
 
     /**
          * @brief Destroy the Model Instance object
@@ -358,6 +713,19 @@ public:
         return status;
     }
 
+    /**
+         * @brief Enables or disables reporting status transitions to status snapshot, current state is reported once enabled
+         *
+         * Instance loaded aside of served version of the same number is not published until it replaces it,
+         * so that status snapshot reflects the version requests are served by.
+         */
+    void setStatusPublished(bool published) {
+        const bool wasPublished = statusPublished.exchange(published);
+        if (published && !wasPublished) {
+            status.publish();
+        }
+    }
+
     /**
          * @brief Gets executing target device name
          *
@@ -373,7 +741,7 @@ public:
          * @return batch size
          */
     virtual size_t getBatchSize() const {
-        return network->getBatchSize();
+        return network ? network->getBatchSize() : batchSize;
     }
 
     /**
@@ -403,6 +771,15 @@ public:
         return outputsInfo;
     }
 
+    /**
+         * @brief Get ngraph function of the network
+         *
+         * @return function or nullptr if network was released after it had been compiled
+         */
+    std::shared_ptr<const ngraph::Function> getNetworkFunction() const {
+        return network ? network->getFunction() : nullptr;
+    }
+
     /**
          * @brief Check if can unload infer requests
          *
@@ -421,6 +798,102 @@ public:
         return *inferRequestsQueue;
     }
 
+    /**
+         * @brief Get dynamic batching scheduler
+         * 
+         * @return BatchingScheduler or nullptr if dynamic batching is disabled
+         */
+    BatchingScheduler* getBatchingScheduler() {
+        return batchingScheduler.get();
+    }
+
+    /**
+         * @brief Get sequences of stateful model
+         * 
+         * @return SequenceManager or nullptr if model is not stateful
+         */
+    SequenceManager* getSequenceManager() {
+        return sequenceManager.get();
+    }
+
+    /**
+         * @brief Get predict requests metrics
+         * 
+         * @return ModelMetrics
+         */
+    ModelMetrics& getMetrics() {
+        return metrics;
+    }
+
+    const ModelMetrics& getMetrics() const {
+        return metrics;
+    }
+
+    /**
+         * @brief Get durations of loading phases of the last load or reload
+         * 
+         * @return LoadingProfile
+         */
+    LoadingProfile& getLoadingProfile() {
+        return loadingProfile;
+    }
+
+    /**
+         * @brief Get networks compiled for previously requested shapes
+         * 
+         * @return NetworkCache
+         */
+    const NetworkCache& getNetworkCache() const {
+        return networkCache;
+    }
+
+    /**
+         * @brief Get CPUs requested with NUMA node or CPU set
+         * 
+         * @return CPUs or empty vector if not requested
+         */
+    const std::vector<int>& getCpuAffinity() const {
+        return cpuAffinity;
+    }
+
+    /**
+         * @brief Get input blobs allocated by infer request
+         * 
+         * @param streamId
+         * @return input blobs or nullptr if reusing input blobs is disabled
+         */
+    /**
+         * @brief Get size of infer requests blobs mapped from hugepages
+         * 
+         * @return size in bytes
+         */
+    size_t getHugePagesIOBlobsBytes() const {
+        return hugePagesIOBlobsPool ? hugePagesIOBlobsPool->getHugePagesBytes() : 0;
+    }
+
+    /**
+         * @brief Get metadata response cached for currently loaded inputs and outputs
+         * 
+         * @return cached response or nullptr
+         */
+    std::shared_ptr<const ModelMetadataCacheEntry> getMetadataCache() const {
+        return std::atomic_load(&metadataCache);
+    }
+
+    /**
+         * @brief Caches metadata response, should be called with unload guard held so that it is not stored after reload
+         */
+    void setMetadataCache(std::shared_ptr<const ModelMetadataCacheEntry> entry) {
+        std::atomic_store(&metadataCache, std::move(entry));
+    }
+
+    const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>* getPreallocatedInputBlobs(int streamId) const {
+        if (preallocatedInputBlobs.empty()) {
+            return nullptr;
+        }
+        return &preallocatedInputBlobs[streamId];
+    }
+
     /**
          * @brief Combines plugin config from user with default config calculated at runtime
          *
@@ -463,6 +936,40 @@ public:
          */
     virtual void unloadModel();
 
+    /**
+         * @brief Stops accepting new requests, version is unloaded with finishRetirement once inferences in progress finish
+         */
+    void beginRetirement();
+
+    /**
+         * @brief Unloads version retired with beginRetirement, skipped if version was loaded again meanwhile
+         */
+    void finishRetirement();
+
+    /**
+         * @brief Releases network of idle version to free memory, it is loaded again on next request
+         *
+         * Does not wait, versions which are in use, loading or loaded with custom loader are not evicted.
+         *
+         * @return true if version was evicted
+         */
+    bool evict();
+
+    bool isEvicted() const {
+        return evicted;
+    }
+
+    /**
+         * @brief Gets estimated memory usage of loaded version in bytes, 0 if not loaded
+         */
+    size_t getMemoryUsage() const {
+        return memoryUsage;
+    }
+
+    std::chrono::steady_clock::time_point getLastUsedTime() const {
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(lastUsedTicks.load(std::memory_order_relaxed)));
+    }
+
     /**
          * @brief Wait for model to change to AVAILABLE state
          *
@@ -474,10 +981,24 @@ public:
     Status waitForLoaded(const uint waitForModelLoadedTimeoutMilliseconds,
         std::unique_ptr<ModelInstanceUnloadGuard>& modelInstanceUnloadGuard);
 
+    /**
+         * @brief Removes sequences of loaded stateful model which received no requests for sequence timeout
+         *
+         * @return number of removed sequences
+         */
+    size_t removeIdleSequences();
+
     void subscribe(PipelineDefinition& pd);
 
     void unsubscribe(PipelineDefinition& pd);
 
+    /**
+         * @brief Takes over pipelines subscribed to replaced instance of the same version and notifies them
+         *
+         * @param previousInstance
+         */
+    void takeSubscriptionsFrom(ModelInstance& previousInstance);
+
     const Status validate(const tensorflow::serving::PredictRequest* request);
 };
 }  // namespace ovms
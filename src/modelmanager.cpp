@@ -16,10 +16,16 @@
 #include "modelmanager.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <sstream>
 #include <unordered_map>
 #include <utility>
@@ -29,27 +35,105 @@
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <sys/stat.h>
 
 #include "azurefilesystem.hpp"
 #include "config.hpp"
+#include "cpuaffinity.hpp"
 #include "customloaders.hpp"
+#include "deviceconcurrencylimiter.hpp"
 #include "filesystem.hpp"
+#include "fnvhash.hpp"
 #include "gcsfilesystem.hpp"
+#include "inflightmemorybudget.hpp"
 #include "localfilesystem.hpp"
 #include "logging.hpp"
+#include "modelreaper.hpp"
+#include "ovengine.hpp"
+#include "paralleltasks.hpp"
 #include "pipeline.hpp"
 #include "pipeline_factory.hpp"
 #include "s3filesystem.hpp"
 #include "schema.hpp"
+#include "statussnapshot.hpp"
+#include "stringutils.hpp"
+#include "tensorbufferpool.hpp"
+#include "tensorcache.hpp"
+#include "workerprocesses.hpp"
 
 namespace ovms {
 
 static bool watcherStarted = false;
 
+static const std::chrono::seconds MODEL_USAGE_SAVE_INTERVAL{60};
+
 Status ModelManager::start() {
     auto& config = ovms::Config::instance();
     watcherIntervalSec = config.filesystemPollWaitSeconds();
+    modelLoadingThreads = config.modelLoadingThreads();
+    compiledModelCacheDir = config.compiledModelCacheDir();
+    shareCompiledNetworks = config.shareCompiledNetworks();
+    memoryBudgetBytes = static_cast<size_t>(config.modelMemoryBudgetMb()) * 1024 * 1024;
+    InFlightMemoryBudget::getInstance().configure(static_cast<size_t>(config.inFlightMemoryBudgetMb()) * 1024 * 1024);
+    TensorBufferPool::getInstance()->configure(static_cast<size_t>(config.tensorPoolSizeMb()) * 1024 * 1024, config.tensorPoolHugePages());
+    TensorCache::getInstance().configure(static_cast<size_t>(config.tensorCacheSizeMb()) * 1024 * 1024);
+    std::map<std::string, size_t> deviceConcurrencyLimits;
+    Status status = DeviceConcurrencyLimiter::parseLimits(config.deviceConcurrencyLimits(), deviceConcurrencyLimits);
+    if (!status.ok()) {
+        SPDLOG_ERROR("Couldn't parse device concurrency limits: {}", config.deviceConcurrencyLimits());
+        return status;
+    }
+    DeviceConcurrencyLimiter::configure(deviceConcurrencyLimits);
+    if (!config.cloudModelCacheDir().empty()) {
+        downloadCache = std::make_shared<DownloadCache>(config.cloudModelCacheDir());
+    }
+    modelUsage.setPath(config.modelUsageFile());
+    if (modelUsage.isEnabled()) {
+        modelUsage.load();
+    }
+    lastModelUsageSave = std::chrono::steady_clock::now();
+    if (config.serveWhileLoading()) {
+        // invalid configuration stops the server, only loading of models is deferred
+        status = validateStartupConfig();
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Couldn't start model manager");
+            return status;
+        }
+        // servers accept requests meanwhile, models become available one by one
+        criticalModelsLoaded = false;
+        initialLoad = std::async(std::launch::async, [this]() {
+            auto status = startModels();
+            if (!status.ok()) {
+                SPDLOG_LOGGER_ERROR(modelmanager_logger, "Loading models in background failed: {}, server is not going to be ready", status.string());
+                std::lock_guard<std::mutex> lock(startupStatusMtx);
+                startupStatus = status;
+            }
+            criticalModelsLoaded = true;
+        });
+        return StatusCode::OK;
+    }
+    return startModels();
+}
+
+Status ModelManager::validateStartupConfig() {
+    auto& config = ovms::Config::instance();
+    if (config.configPath() != "") {
+        rapidjson::Document configJson;
+        return parseConfig(config.configPath(), configJson);
+    }
+    ModelConfig modelConfig;
+    return createModelConfigFromParameters(modelConfig);
+}
+
+Status ModelManager::getStartupStatus() const {
+    std::lock_guard<std::mutex> lock(startupStatusMtx);
+    return startupStatus;
+}
+
+Status ModelManager::startModels() {
+    auto& config = ovms::Config::instance();
     Status status;
     if (config.configPath() != "") {
         status = startFromFile(config.configPath());
@@ -76,9 +160,20 @@ void ModelManager::startWatcher() {
 }
 
 Status ModelManager::startFromConfig() {
+    auto& modelConfig = servedModelConfigs.emplace_back();
+    auto status = createModelConfigFromParameters(modelConfig);
+    if (!status.ok()) {
+        return status;
+    }
+    status = reloadModelWithVersions(modelConfig, modelLoadingThreads);
+    logLoadingProfiles();
+    return status;
+}
+
+Status ModelManager::createModelConfigFromParameters(ModelConfig& modelConfig) {
     auto& config = ovms::Config::instance();
 
-    auto& modelConfig = servedModelConfigs.emplace_back(
+    modelConfig = ModelConfig(
         config.modelName(),
         config.modelPath(),
         config.targetDevice(),
@@ -112,12 +207,45 @@ Status ModelManager::startFromConfig() {
         modelConfig.setBatchingMode(FIXED);
         modelConfig.setBatchSize(0);
     }
+    return StatusCode::OK;
+}
 
-    return reloadModelWithVersions(modelConfig);
+/**
+ * @brief Reads device plugins used by models listed in config file, without validating it
+ */
+std::set<std::string> readConfigDevicePlugins(const std::string& jsonFilename) {
+    std::set<std::string> plugins;
+    std::ifstream ifs(jsonFilename.c_str());
+    rapidjson::Document configJson;
+    rapidjson::IStreamWrapper isw(ifs);
+    if (!ifs.good() || configJson.ParseStream(isw).HasParseError() || !configJson.IsObject()) {
+        return plugins;
+    }
+    const auto itr = configJson.FindMember("model_config_list");
+    if (itr == configJson.MemberEnd() || !itr->value.IsArray()) {
+        return plugins;
+    }
+    for (const auto& model : itr->value.GetArray()) {
+        if (!model.IsObject() || !model.HasMember("config") || !model["config"].IsObject()) {
+            continue;
+        }
+        const auto& config = model["config"];
+        const auto deviceItr = config.FindMember("target_device");
+        const std::string targetDevice = (deviceItr != config.MemberEnd() && deviceItr->value.IsString()) ? deviceItr->value.GetString() : "CPU";
+        plugins.merge(getTargetDevicePlugins(targetDevice));
+    }
+    return plugins;
 }
 
 Status ModelManager::startFromFile(const std::string& jsonFilename) {
+    // device plugins are initialized while config is parsed and models are downloaded and read, so that their compilation starts on warm Core
+    auto pluginsWarmUp = std::async(std::launch::async, [jsonFilename]() {
+        auto plugins = readConfigDevicePlugins(jsonFilename);
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Warming up {} device plugins used in config", plugins.size());
+        warmUpDevicePlugins(*getSharedOVEngine(), plugins);
+    });
     Status status = loadConfig(jsonFilename);
+    pluginsWarmUp.wait();
     if (!status.ok()) {
         return status;
     }
@@ -171,6 +299,13 @@ void processNodeOutputs(const rapidjson::Value::ConstMemberIterator& nodeOutputs
     }
 }
 
+void hashJsonValue(uint64_t& hash, const rapidjson::Value& value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    hashBytes(hash, buffer.GetString(), buffer.GetSize());
+}
+
 void processPipelineConfig(rapidjson::Document& configJson, const rapidjson::Value& pipelineConfig, std::set<std::string>& pipelinesInConfigFile, PipelineFactory& factory, ModelManager& manager) {
     const std::string pipelineName = pipelineConfig["name"].GetString();
     SPDLOG_LOGGER_INFO(modelmanager_logger, "Reading pipeline:{} configuration", pipelineName);
@@ -185,7 +320,9 @@ void processPipelineConfig(rapidjson::Document& configJson, const rapidjson::Val
         nodeName = nodeConfig["name"].GetString();
 
         std::string modelName;
-        modelName = nodeConfig["model_name"].GetString();
+        if (nodeConfig.HasMember("model_name")) {
+            modelName = nodeConfig["model_name"].GetString();
+        }
 
         const std::string nodeKindStr = nodeConfig["type"].GetString();
         auto nodeOutputsItr = nodeConfig.FindMember("outputs");
@@ -201,15 +338,100 @@ void processPipelineConfig(rapidjson::Document& configJson, const rapidjson::Val
         } else {
             modelVersion = std::nullopt;
         }
+        bool zeroCopyOutputs = false;
+        if (nodeConfig.HasMember("zero_copy_outputs")) {
+            zeroCopyOutputs = nodeConfig["zero_copy_outputs"].GetBool();
+        }
+        DemultiplexerParameters demultiplexerParameters;
+        if (nodeConfig.HasMember("crop_width")) {
+            demultiplexerParameters.cropWidth = nodeConfig["crop_width"].GetUint64();
+        }
+        if (nodeConfig.HasMember("crop_height")) {
+            demultiplexerParameters.cropHeight = nodeConfig["crop_height"].GetUint64();
+        }
+        if (nodeConfig.HasMember("max_crops")) {
+            demultiplexerParameters.maxCrops = nodeConfig["max_crops"].GetUint64();
+        }
+        if (nodeConfig.HasMember("confidence_threshold")) {
+            demultiplexerParameters.confidenceThreshold = nodeConfig["confidence_threshold"].GetFloat();
+        }
+        PreprocessingParameters preprocessingParameters;
+        if (nodeConfig.HasMember("resize_width")) {
+            preprocessingParameters.resizeWidth = nodeConfig["resize_width"].GetUint64();
+        }
+        if (nodeConfig.HasMember("resize_height")) {
+            preprocessingParameters.resizeHeight = nodeConfig["resize_height"].GetUint64();
+        }
+        if (nodeConfig.HasMember("mean")) {
+            for (const auto& value : nodeConfig["mean"].GetArray()) {
+                preprocessingParameters.mean.push_back(value.GetFloat());
+            }
+        }
+        if (nodeConfig.HasMember("scale")) {
+            for (const auto& value : nodeConfig["scale"].GetArray()) {
+                preprocessingParameters.scale.push_back(value.GetFloat());
+            }
+        }
+        if (nodeConfig.HasMember("input_layout")) {
+            preprocessingParameters.inputLayout = nodeConfig["input_layout"].GetString();
+        }
+        PostprocessingParameters postprocessingParameters;
+        if (nodeConfig.HasMember("operation")) {
+            postprocessingParameters.operation = nodeConfig["operation"].GetString();
+        }
+        if (nodeConfig.HasMember("top_k")) {
+            postprocessingParameters.topK = nodeConfig["top_k"].GetUint64();
+        }
+        if (nodeConfig.HasMember("score_threshold")) {
+            postprocessingParameters.scoreThreshold = nodeConfig["score_threshold"].GetFloat();
+        }
+        if (nodeConfig.HasMember("iou_threshold")) {
+            postprocessingParameters.iouThreshold = nodeConfig["iou_threshold"].GetFloat();
+        }
+        RemoteParameters remoteParameters;
+        if (nodeConfig.HasMember("address")) {
+            remoteParameters.address = nodeConfig["address"].GetString();
+        }
+        CustomNodeParameters customNodeParameters;
+        if (nodeConfig.HasMember("library_path")) {
+            customNodeParameters.libraryPath = nodeConfig["library_path"].GetString();
+        }
+        if (nodeConfig.HasMember("params")) {
+            for (const auto& param : nodeConfig["params"].GetObject()) {
+                customNodeParameters.params.emplace(param.name.GetString(), param.value.GetString());
+            }
+        }
+        GateParameters gateParameters;
+        if (nodeConfig.HasMember("comparison")) {
+            gateParameters.comparison = nodeConfig["comparison"].GetString();
+        }
+        if (nodeConfig.HasMember("threshold")) {
+            gateParameters.threshold = nodeConfig["threshold"].GetFloat();
+        }
         NodeKind nodeKind;
         auto status = toNodeKind(nodeKindStr, nodeKind);
         if (!status.ok()) {
             SPDLOG_LOGGER_WARN(modelmanager_logger, "Parsing node kind failed:{}", nodeKindStr);
             return;
         }
-        SPDLOG_DEBUG("Creating node:{} type:{} model_name:{} modelVersion:{}",
-            nodeName, nodeKindStr, modelName, modelVersion.value_or(0));
-        info.emplace_back(std::move(NodeInfo{nodeKind, nodeName, modelName, modelVersion, nodeOutputNameAlias}));
+        if ((nodeKind == NodeKind::DL || nodeKind == NodeKind::REMOTE) && modelName.empty()) {
+            SPDLOG_LOGGER_WARN(modelmanager_logger, "Pipeline:{} node:{} of type {} is missing model_name", pipelineName, nodeName, nodeKindStr);
+            return;
+        }
+        if (nodeKind == NodeKind::CUSTOM) {
+            // library stays loaded while any pipeline definition refers to it, pipeline fails validation if it cannot be loaded
+            if (customNodeParameters.libraryPath.empty()) {
+                SPDLOG_LOGGER_WARN(modelmanager_logger, "Pipeline:{} node:{} of type {} is missing library_path", pipelineName, nodeName, nodeKindStr);
+                return;
+            }
+            CustomNodeLibrary::load(customNodeParameters.libraryPath, customNodeParameters.library);
+        }
+        SPDLOG_DEBUG("Creating node:{} type:{} model_name:{} modelVersion:{} zeroCopyOutputs:{}",
+            nodeName, nodeKindStr, modelName, modelVersion.value_or(0), zeroCopyOutputs);
+        info.emplace_back(std::move(NodeInfo{nodeKind, nodeName, modelName, modelVersion, nodeOutputNameAlias, zeroCopyOutputs, demultiplexerParameters, preprocessingParameters, postprocessingParameters, remoteParameters, customNodeParameters, gateParameters}));
+        if (nodeConfig.HasMember("timeout_microseconds")) {
+            info.back().timeoutMicroseconds = nodeConfig["timeout_microseconds"].GetUint64();
+        }
         auto nodeInputItr = nodeConfig.FindMember("inputs");
         processNodeInputs(nodeName, nodeInputItr, connections);
     }
@@ -217,17 +439,43 @@ void processPipelineConfig(rapidjson::Document& configJson, const rapidjson::Val
     // pipeline outputs are node exit inputs
     processNodeInputs(EXIT_NODE_NAME, iteratorOutputs, connections);
     info.emplace_back(std::move(NodeInfo(NodeKind::EXIT, EXIT_NODE_NAME, "", std::nullopt, {})));
+    size_t maxBatchSize = 0;
+    if (pipelineConfig.HasMember("max_batch_size")) {
+        maxBatchSize = pipelineConfig["max_batch_size"].GetUint64();
+    }
+    uint64_t batchTimeoutMicroseconds = 0;
+    if (pipelineConfig.HasMember("batch_timeout_microseconds")) {
+        batchTimeoutMicroseconds = pipelineConfig["batch_timeout_microseconds"].GetUint64();
+    }
+    bool fp16Outputs = false;
+    if (pipelineConfig.HasMember("fp16_outputs")) {
+        fp16Outputs = pipelineConfig["fp16_outputs"].GetBool();
+    }
+    uint64_t timeoutMicroseconds = 0;
+    if (pipelineConfig.HasMember("timeout_microseconds")) {
+        timeoutMicroseconds = pipelineConfig["timeout_microseconds"].GetUint64();
+    }
+    bool fuseNetworks = false;
+    if (pipelineConfig.HasMember("fuse_networks")) {
+        fuseNetworks = pipelineConfig["fuse_networks"].GetBool();
+    }
     if (!factory.definitionExists(pipelineName)) {
         SPDLOG_DEBUG("Pipeline:{} was not loaded so far. Triggering load", pipelineName);
-        auto status = factory.createDefinition(pipelineName, info, connections, manager);
-        pipelinesInConfigFile.insert(pipelineName);
-        return;
+        auto status = factory.createDefinition(pipelineName, info, connections, manager, fuseNetworks);
+    } else {
+        SPDLOG_DEBUG("Pipeline:{} is already loaded. Triggering reload", pipelineName);
+        auto status = factory.reloadDefinition(pipelineName,
+            std::move(info),
+            std::move(connections),
+            manager,
+            fuseNetworks);
+    }
+    auto definition = factory.findDefinitionByName(pipelineName);
+    if (definition != nullptr) {
+        definition->setBatching(manager, maxBatchSize, batchTimeoutMicroseconds);
+        definition->setFp16Outputs(fp16Outputs);
+        definition->setTimeout(timeoutMicroseconds);
     }
-    SPDLOG_DEBUG("Pipeline:{} is already loaded. Triggering reload", pipelineName);
-    auto status = factory.reloadDefinition(pipelineName,
-        std::move(info),
-        std::move(connections),
-        manager);
     pipelinesInConfigFile.insert(pipelineName);
 }
 
@@ -235,13 +483,36 @@ Status ModelManager::loadPipelinesConfig(rapidjson::Document& configJson) {
     const auto itrp = configJson.FindMember("pipeline_config_list");
     if (itrp == configJson.MemberEnd() || !itrp->value.IsArray()) {
         SPDLOG_LOGGER_INFO(modelmanager_logger, "Configuration file doesn't have pipelines property.");
+        pipelineConfigHashes.clear();
         pipelineFactory.retireOtherThan({}, *this);
         return StatusCode::OK;
     }
     std::set<std::string> pipelinesInConfigFile;
+    std::map<std::string, uint64_t> newPipelineConfigHashes;
     for (const auto& pipelineConfig : itrp->value.GetArray()) {
+        const std::string pipelineName = pipelineConfig["name"].GetString();
+        uint64_t hash = FNV_OFFSET_BASIS;
+        hashJsonValue(hash, pipelineConfig);
+        newPipelineConfigHashes[pipelineName] = hash;
+        // definitions waiting for revalidation after used model change are reloaded even if their config is the same
+        auto it = pipelineConfigHashes.find(pipelineName);
+        auto definition = pipelineFactory.findDefinitionByName(pipelineName);
+        if (it != pipelineConfigHashes.end() && it->second == hash &&
+            definition != nullptr && definition->getStateCode() == PipelineDefinitionStateCode::AVAILABLE) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline:{} configuration did not change", pipelineName);
+            pipelinesInConfigFile.insert(pipelineName);
+            continue;
+        }
+        if (it != pipelineConfigHashes.end() && it->second == hash &&
+            definition != nullptr && definition->getStateCode() == PipelineDefinitionStateCode::AVAILABLE_REQUIRED_REVALIDATION) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Pipeline:{} configuration did not change, revalidating nodes using changed models", pipelineName);
+            definition->revalidate(*this);
+            pipelinesInConfigFile.insert(pipelineName);
+            continue;
+        }
         processPipelineConfig(configJson, pipelineConfig, pipelinesInConfigFile, pipelineFactory, *this);
     }
+    pipelineConfigHashes = std::move(newPipelineConfigHashes);
     pipelineFactory.retireOtherThan(std::move(pipelinesInConfigFile), *this);
     return ovms::StatusCode::OK;
 }
@@ -322,6 +593,7 @@ Status ModelManager::loadModelsConfig(rapidjson::Document& configJson) {
         return StatusCode::JSON_INVALID;
     }
     std::set<std::string> modelsInConfigFile;
+    std::map<std::string, uint64_t> newModelConfigHashes;
     servedModelConfigs.clear();
     for (const auto& configs : itr->value.GetArray()) {
         ModelConfig& modelConfig = servedModelConfigs.emplace_back();
@@ -332,21 +604,123 @@ Status ModelManager::loadModelsConfig(rapidjson::Document& configJson) {
             servedModelConfigs.pop_back();
             continue;
         }
-        reloadModelWithVersions(modelConfig);
         modelsInConfigFile.emplace(modelConfig.getName());
+        // the same model may be listed several times, its hash covers all of its entries
+        auto hashIt = newModelConfigHashes.try_emplace(modelConfig.getName(), FNV_OFFSET_BASIS).first;
+        hashJsonValue(hashIt->second, configs["config"]);
     }
+    // only models with changed configuration are reloaded, new versions of the others are picked up by the watcher
+    std::vector<ModelConfig*> configsToLoad;
+    std::unique_lock<std::mutex> tokensLock(modelDirectoryChangeTokensMtx);
+    for (auto& config : servedModelConfigs) {
+        auto it = modelConfigHashes.find(config.getName());
+        if (config.isCustomLoaderRequiredToLoadModel() || it == modelConfigHashes.end() ||
+            it->second != newModelConfigHashes.at(config.getName()) || findModelByName(config.getName()) == nullptr) {
+            configsToLoad.push_back(&config);
+            modelDirectoryChangeTokens.erase(config.getName());
+        } else {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Model:{} configuration did not change", config.getName());
+        }
+    }
+    for (auto it = modelDirectoryChangeTokens.begin(); it != modelDirectoryChangeTokens.end();) {
+        it = modelsInConfigFile.count(it->first) ? std::next(it) : modelDirectoryChangeTokens.erase(it);
+    }
+    tokensLock.unlock();
+    modelConfigHashes = std::move(newModelConfigHashes);
+    // reserved before any model is loaded, so that models loaded concurrently are kept off CPUs of exclusive ones
+    std::set<std::string> modelsFailedToReserveCpus;
+    for (const auto& config : servedModelConfigs) {
+        auto status = reserveExclusiveCpus(config);
+        if (!status.ok()) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Loading model:{} failed, reserving its exclusive CPUs failed: {}", config.getName(), status.string());
+            modelsFailedToReserveCpus.insert(config.getName());
+            // loaded again on next configuration reload
+            modelConfigHashes.erase(config.getName());
+        }
+    }
+    configsToLoad.erase(std::remove_if(configsToLoad.begin(), configsToLoad.end(),
+                            [&modelsFailedToReserveCpus](const ModelConfig* config) { return modelsFailedToReserveCpus.count(config->getName()) == 1; }),
+        configsToLoad.end());
+    loadModelsInParallel(configsToLoad);
     retireModelsRemovedFromConfigFile(modelsInConfigFile);
+    enforceMemoryBudget();
     return ovms::StatusCode::OK;
 }
 
-Status ModelManager::loadConfig(const std::string& jsonFilename) {
-    SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Loading configuration from {}", jsonFilename);
+namespace {
+bool supportsConcurrentLoading(const ModelConfig& config) {
+    custom_loader_options_config_t customLoaderOptionsConfig = config.getCustomLoaderOptionsConfigMap();
+    auto loader = CustomLoaders::instance().find(customLoaderOptionsConfig["loader_name"]);
+    return loader != nullptr && loader->supportsConcurrentLoading();
+}
+}  // namespace
+
+Status ModelManager::reserveExclusiveCpus(const ModelConfig& config) {
+    auto& reservations = CpuReservations::getInstance();
+    if (!config.isCpuSetExclusive()) {
+        reservations.release(config.getName());
+        return StatusCode::OK;
+    }
+    std::vector<int> cpus;
+    auto status = getRequestedCpus(config.getNumaNode(), config.getCpuSet(), cpus);
+    if (!status.ok()) {
+        return status;
+    }
+    if (cpus.empty()) {
+        SPDLOG_LOGGER_ERROR(modelmanager_logger, "Model:{} with exclusive CPU set requires cpu_set or numa_node", config.getName());
+        return StatusCode::CPU_AFFINITY_INVALID;
+    }
+    return reservations.reserve(config.getName(), cpus);
+}
+
+void ModelManager::loadModelsInParallel(const std::vector<ModelConfig*>& configs) {
+    // configs of the same model are applied in order by a single task, custom loaders are loaded concurrently only if they declare thread safety
+    std::map<std::string, std::vector<ModelConfig*>> configsByModel;
+    std::vector<ModelConfig*> customLoaderConfigs;
+    for (auto* config : configs) {
+        if (config->isCustomLoaderRequiredToLoadModel() && !supportsConcurrentLoading(*config)) {
+            customLoaderConfigs.push_back(config);
+        } else {
+            configsByModel[config->getName()].push_back(config);
+        }
+    }
+    const size_t modelsLoadedConcurrently = std::max<size_t>(1, std::min<size_t>(modelLoadingThreads, configsByModel.size()));
+    const size_t versionLoadingThreads = std::max<size_t>(1, modelLoadingThreads / modelsLoadedConcurrently);
+    SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Loading {} models with {} threads, up to {} versions of each concurrently",
+        configsByModel.size(), modelsLoadedConcurrently, versionLoadingThreads);
+    // models critical for readiness are loaded first, then the others in order of their usage, also before restart
+    std::vector<std::pair<uint64_t, std::vector<ModelConfig*>*>> criticalModels, otherModels;
+    for (auto& [name, modelConfigs] : configsByModel) {
+        auto model = findModelByName(name);
+        const uint64_t usage = modelUsage.getCount(name, model ? model->getRequestsCount() : 0);
+        const bool critical = std::any_of(modelConfigs.begin(), modelConfigs.end(), [](const ModelConfig* config) { return config->isReadinessCritical(); });
+        (critical ? criticalModels : otherModels).emplace_back(usage, &modelConfigs);
+    }
+    for (auto* group : {&criticalModels, &otherModels}) {
+        std::stable_sort(group->begin(), group->end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        std::vector<std::function<void()>> tasks;
+        for (const auto& [usage, modelConfigs] : *group) {
+            tasks.emplace_back([this, modelConfigs = modelConfigs, versionLoadingThreads]() {
+                for (auto* config : *modelConfigs) {
+                    reloadModelWithVersions(*config, versionLoadingThreads);
+                }
+            });
+        }
+        executeInParallel(tasks, modelsLoadedConcurrently);
+        // server loading models in background becomes ready once the first group is loaded
+        criticalModelsLoaded = true;
+    }
+    for (auto* config : customLoaderConfigs) {
+        reloadModelWithVersions(*config);
+    }
+}
+
+Status ModelManager::parseConfig(const std::string& jsonFilename, rapidjson::Document& configJson) {
     std::ifstream ifs(jsonFilename.c_str());
     if (!ifs.good()) {
         SPDLOG_LOGGER_ERROR(modelmanager_logger, "File is invalid {}", jsonFilename);
         return StatusCode::FILE_INVALID;
     }
-    rapidjson::Document configJson;
     rapidjson::IStreamWrapper isw(ifs);
     if (configJson.ParseStream(isw).HasParseError()) {
         SPDLOG_LOGGER_ERROR(modelmanager_logger, "Configuration file is not a valid JSON file.");
@@ -357,8 +731,17 @@ Status ModelManager::loadConfig(const std::string& jsonFilename) {
         SPDLOG_LOGGER_ERROR(modelmanager_logger, "Configuration file is not in valid configuration format");
         return StatusCode::JSON_INVALID;
     }
+    return StatusCode::OK;
+}
+
+Status ModelManager::loadConfig(const std::string& jsonFilename) {
+    SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Loading configuration from {}", jsonFilename);
+    rapidjson::Document configJson;
+    Status status = parseConfig(jsonFilename, configJson);
+    if (!status.ok()) {
+        return status;
+    }
     configFilename = jsonFilename;
-    Status status;
     // load the custom loader config, if available
     status = loadCustomLoadersConfig(configJson);
     if (status != StatusCode::OK) {
@@ -369,9 +752,29 @@ Status ModelManager::loadConfig(const std::string& jsonFilename) {
         return status;
     }
     status = loadPipelinesConfig(configJson);
+    logLoadingProfiles();
     return StatusCode::OK;
 }
 
+void ModelManager::logLoadingProfiles() {
+    for (const auto& [name, model] : *std::atomic_load(&modelsSnapshot)) {
+        if (model->getLoadingProfile().markReported()) {
+            SPDLOG_LOGGER_INFO(modelmanager_logger, "Loading profile of model: {} - {}", name, model->getLoadingProfile().toString());
+        }
+        for (const auto& [version, instanceRef] : model->getModelVersionsMapCopy()) {
+            auto instance = model->getModelInstanceByVersion(version);
+            if (instance && instance->getLoadingProfile().markReported()) {
+                SPDLOG_LOGGER_INFO(modelmanager_logger, "Loading profile of model: {} version: {} - {}", name, version, instance->getLoadingProfile().toString());
+            }
+        }
+    }
+    for (const auto& [name, definition] : *pipelineFactory.getDefinitionsSnapshot()) {
+        if (definition->getLoadingProfile().markReported()) {
+            SPDLOG_LOGGER_INFO(modelmanager_logger, "Loading profile of pipeline: {} - {}", name, definition->getLoadingProfile().toString());
+        }
+    }
+}
+
 void ModelManager::retireModelsRemovedFromConfigFile(const std::set<std::string>& modelsExistingInConfigFile) {
     std::set<std::string> modelsCurrentlyLoaded;
     for (auto& nameModelPair : getModels()) {
@@ -384,11 +787,18 @@ void ModelManager::retireModelsRemovedFromConfigFile(const std::set<std::string>
         modelsToUnloadAllVersions.begin());
     modelsToUnloadAllVersions.resize(it - modelsToUnloadAllVersions.begin());
     for (auto& modelName : modelsToUnloadAllVersions) {
+        CpuReservations::getInstance().release(modelName);
         try {
-            models.at(modelName)->retireAllVersions();
+            auto& model = models.at(modelName);
+            model->retireAllVersions();
+            // versions finishing retirement later are not reported anymore
+            for (const auto& [version, instance] : model->getModelVersions()) {
+                instance->setStatusPublished(false);
+            }
         } catch (const std::out_of_range& e) {
             SPDLOG_LOGGER_ERROR(modelmanager_logger, "Unknown error occured when tried to retire all versions of model:{}", modelName);
         }
+        StatusSnapshot::getInstance().removeModel(modelName);
     }
 }
 
@@ -403,16 +813,180 @@ void ModelManager::watcher(std::future<void> exit) {
         stat(configFilename.c_str(), &statTime);
         if (lastTime != statTime.st_ctime) {
             lastTime = statTime.st_ctime;
+            // config reload may change or retire models which are reloaded in background
+            waitForBackgroundReloads();
             loadConfig(configFilename);
         }
         for (auto& config : servedModelConfigs) {
-            reloadModelWithVersions(config);
+            reloadModelIfDirectoryChanged(config);
+        }
+        enforceMemoryBudget();
+        removeIdleSequences();
+        if (std::chrono::steady_clock::now() - lastModelUsageSave >= MODEL_USAGE_SAVE_INTERVAL) {
+            saveModelUsage();
         }
     }
+    waitForBackgroundReloads();
+    backgroundReloadsExecutor.reset();
+    serialBackgroundReloadsExecutor.reset();
     SPDLOG_LOGGER_ERROR(modelmanager_logger, "Exited config watcher thread");
 }
 
+void ModelManager::waitForBackgroundReloads() {
+    for (auto& [name, reload] : backgroundReloads) {
+        reload.wait();
+    }
+    backgroundReloads.clear();
+}
+
+BlockingTasksExecutor& ModelManager::getBackgroundReloadsExecutor(const ModelConfig& config) {
+    // custom loaders not declaring thread safety are reloaded one at a time, like in loadModelsInParallel
+    if (config.isCustomLoaderRequiredToLoadModel() && !supportsConcurrentLoading(config)) {
+        if (!serialBackgroundReloadsExecutor) {
+            serialBackgroundReloadsExecutor = std::make_unique<BlockingTasksExecutor>(1);
+        }
+        return *serialBackgroundReloadsExecutor;
+    }
+    if (!backgroundReloadsExecutor) {
+        backgroundReloadsExecutor = std::make_unique<BlockingTasksExecutor>(std::max<uint>(1, modelLoadingThreads));
+    }
+    return *backgroundReloadsExecutor;
+}
+
+void ModelManager::reloadModelIfDirectoryChanged(ModelConfig& config) {
+    auto running = backgroundReloads.find(config.getName());
+    if (running != backgroundReloads.end()) {
+        if (running->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Model: {} is still reloaded in background, skipping directory check", config.getName());
+            return;
+        }
+        backgroundReloads.erase(running);
+    }
+    std::string token;
+    // custom loaders may change their blacklist without touching model directory
+    if (!config.isCustomLoaderRequiredToLoadModel()) {
+        auto fs = filesystemFactory(config.getBasePath());
+        if (fs->getDirectoryChangeToken(config.getBasePath(), &token) != StatusCode::OK) {
+            token.clear();
+        }
+        std::lock_guard<std::mutex> lock(modelDirectoryChangeTokensMtx);
+        auto it = modelDirectoryChangeTokens.find(config.getName());
+        if (!token.empty() && it != modelDirectoryChangeTokens.end() &&
+            it->second.first == config.getBasePath() && it->second.second == token) {
+            return;
+        }
+    }
+    // download and load of new versions could take long, so it runs in background not to delay checks of other models,
+    // versions are published only once loaded while previous ones keep serving,
+    // number of concurrent reloads is bounded by model_loading_threads
+    auto finished = std::make_shared<std::promise<void>>();
+    backgroundReloads[config.getName()] = finished->get_future();
+    bool scheduled = getBackgroundReloadsExecutor(config).schedule([this, config, token, finished]() mutable {
+        reloadModelWithVersionsAndRecordToken(config, token);
+        // previous versions are retired only now, so budget is enforced once both networks are counted
+        enforceMemoryBudget();
+        finished->set_value();
+    });
+    if (!scheduled) {
+        finished->set_value();
+    }
+}
+
+void ModelManager::reloadModelWithVersionsAndRecordToken(ModelConfig& config, const std::string& token) {
+    if (config.isCustomLoaderRequiredToLoadModel()) {
+        reloadModelWithVersions(config);
+        logLoadingProfiles();
+        return;
+    }
+    auto status = reloadModelWithVersions(config);
+    logLoadingProfiles();
+    bool settled = status.ok() && !token.empty();
+    auto model = findModelByName(config.getName());
+    if (settled && model) {
+        for (const auto& [version, instance] : model->getModelVersionsMapCopy()) {
+            const auto& versionStatus = instance.getStatus();
+            if (versionStatus.getErrorCode() != ModelVersionStatusErrorCode::OK ||
+                (versionStatus.getState() != ModelVersionState::AVAILABLE && !instance.isEvicted() &&
+                    versionStatus.getState() != ModelVersionState::END)) {
+                settled = false;
+                break;
+            }
+        }
+    }
+    // failed or not yet settled versions are retried on every watcher tick as before
+    std::lock_guard<std::mutex> lock(modelDirectoryChangeTokensMtx);
+    if (settled) {
+        modelDirectoryChangeTokens[config.getName()] = {config.getBasePath(), token};
+    } else {
+        modelDirectoryChangeTokens.erase(config.getName());
+    }
+}
+
+void ModelManager::removeIdleSequences() {
+    const auto snapshot = std::atomic_load(&modelsSnapshot);
+    for (const auto& [name, model] : *snapshot) {
+        for (const auto& [version, instance] : model->getModelVersionsMapCopy()) {
+            if (!instance.getModelConfig().isStateful()) {
+                continue;
+            }
+            auto versionInstance = model->getModelInstanceByVersion(version);
+            if (!versionInstance) {
+                continue;
+            }
+            size_t removed = versionInstance->removeIdleSequences();
+            if (removed > 0) {
+                SPDLOG_LOGGER_INFO(modelmanager_logger, "Removed {} idle sequences of model: {} version: {}", removed, name, version);
+            }
+        }
+    }
+}
+
+void ModelManager::enforceMemoryBudget(const ModelInstance* excluded) {
+    if (memoryBudgetBytes == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(memoryBudgetMtx);
+    std::vector<std::shared_ptr<ModelInstance>> loadedInstances;
+    // networks of replaced and retired versions are counted until they are destroyed in background
+    size_t memoryUsage = ModelReaper::getInstance().getPendingMemoryUsage();
+    const auto snapshot = std::atomic_load(&modelsSnapshot);
+    for (const auto& [name, model] : *snapshot) {
+        for (const auto& [version, instance] : model->getModelVersionsMapCopy()) {
+            auto versionInstance = model->getModelInstanceByVersion(version);
+            if (!versionInstance || versionInstance->getStatus().getState() != ModelVersionState::AVAILABLE) {
+                continue;
+            }
+            memoryUsage += versionInstance->getMemoryUsage();
+            loadedInstances.push_back(std::move(versionInstance));
+        }
+    }
+    if (memoryUsage <= memoryBudgetBytes) {
+        return;
+    }
+    std::sort(loadedInstances.begin(), loadedInstances.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs->getLastUsedTime() < rhs->getLastUsedTime(); });
+    for (const auto& instance : loadedInstances) {
+        if (memoryUsage <= memoryBudgetBytes) {
+            break;
+        }
+        if (instance.get() == excluded) {
+            continue;
+        }
+        const size_t instanceMemoryUsage = instance->getMemoryUsage();
+        if (instance->evict()) {
+            memoryUsage -= instanceMemoryUsage;
+        }
+    }
+    if (memoryUsage > memoryBudgetBytes) {
+        SPDLOG_LOGGER_WARN(modelmanager_logger, "Estimated memory usage of loaded models: {} MB exceeds budget: {} MB, versions in use could not be evicted",
+            memoryUsage / (1024 * 1024), memoryBudgetBytes / (1024 * 1024));
+    }
+}
+
 void ModelManager::join() {
+    if (initialLoad.valid()) {
+        initialLoad.wait();
+    }
     if (watcherStarted) {
         exit.set_value();
         if (monitor.joinable()) {
@@ -420,6 +994,20 @@ void ModelManager::join() {
             watcherStarted = false;
         }
     }
+    saveModelUsage();
+}
+
+void ModelManager::saveModelUsage() {
+    // all worker processes read usage file on start, counts of the first one are representative
+    if (!modelUsage.isEnabled() || getWorkerProcessIndex() != 0) {
+        return;
+    }
+    std::map<std::string, uint64_t> counts;
+    for (const auto& [name, model] : *getModelsSnapshot()) {
+        counts.emplace(name, model->getRequestsCount());
+    }
+    modelUsage.save(counts);
+    lastModelUsageSave = std::chrono::steady_clock::now();
 }
 
 void ModelManager::getVersionsToChange(
@@ -490,14 +1078,17 @@ std::shared_ptr<ovms::Model> ModelManager::getModelIfExistCreateElse(const std::
     auto modelIt = models.find(modelName);
     if (models.end() == modelIt) {
         models.insert({modelName, modelFactory(modelName)});
+        std::atomic_store(&modelsSnapshot, std::make_shared<const std::map<std::string, std::shared_ptr<Model>>>(models));
     }
     return models[modelName];
 }
 
 std::shared_ptr<FileSystem> getFilesystem(const std::string& basePath) {
     if (basePath.rfind(S3FileSystem::S3_URL_PREFIX, 0) == 0) {
-        Aws::SDKOptions options;
-        Aws::InitAPI(options);
+        // SDK is initialized once, file systems share pooled clients which outlive them
+        static Aws::SDKOptions options;
+        static std::once_flag awsInitFlag;
+        std::call_once(awsInitFlag, []() { Aws::InitAPI(options); });
         return std::make_shared<S3FileSystem>(options, basePath);
     }
     if (basePath.rfind(GCSFileSystem::GCS_URL_PREFIX, 0) == 0) {
@@ -512,6 +1103,10 @@ std::shared_ptr<FileSystem> getFilesystem(const std::string& basePath) {
     return std::make_shared<LocalFileSystem>();
 }
 
+std::shared_ptr<FileSystem> ModelManager::filesystemFactory(const std::string& basePath) {
+    return getFilesystem(basePath);
+}
+
 Status ModelManager::readAvailableVersions(std::shared_ptr<FileSystem>& fs, const std::string& base, model_versions_t& versions) {
     files_list_t dirs;
 
@@ -561,10 +1156,80 @@ Status ModelManager::readAvailableVersions(std::shared_ptr<FileSystem>& fs, cons
     return StatusCode::OK;
 }
 
+namespace {
+StatusCode readModelVersionToMemory(std::shared_ptr<FileSystem>& fs, const std::string& versionPath, InMemoryModelFiles& files) {
+    files_list_t names;
+    auto sc = fs->getDirectoryFiles(versionPath, &names);
+    if (sc != StatusCode::OK) {
+        return sc;
+    }
+    std::string model, weights, mapping;
+    for (const auto& name : names) {
+        if (name == MAPPING_CONFIG_JSON) {
+            mapping = name;
+        } else if (model.empty() && endsWith(name, ".xml")) {
+            model = name;
+        } else if (weights.empty() && endsWith(name, ".bin")) {
+            weights = name;
+        }
+    }
+    if (model.empty() || weights.empty()) {
+        // same as for files on disk, ONNX model is used when IR is not complete
+        model.clear();
+        weights.clear();
+        for (const auto& name : names) {
+            if (endsWith(name, ".onnx")) {
+                model = name;
+                break;
+            }
+        }
+    }
+    if (model.empty()) {
+        SPDLOG_LOGGER_ERROR(modelmanager_logger, "Could not find model files in {}", versionPath);
+        return StatusCode::FILE_INVALID;
+    }
+    sc = fs->readTextFile(fs->joinPath({versionPath, model}), &files.model);
+    if (sc != StatusCode::OK) {
+        return sc;
+    }
+    if (!weights.empty()) {
+        sc = fs->readTextFile(fs->joinPath({versionPath, weights}), &files.weights);
+        if (sc != StatusCode::OK) {
+            return sc;
+        }
+    }
+    if (!mapping.empty()) {
+        sc = fs->readTextFile(fs->joinPath({versionPath, mapping}), &files.mapping);
+    }
+    return sc;
+}
+
+StatusCode downloadModelsToMemory(std::shared_ptr<FileSystem>& fs, ModelConfig& config, const model_versions_t& versions) {
+    SPDLOG_LOGGER_INFO(modelmanager_logger, "Reading model from {} into memory", config.getBasePath());
+    for (auto version : versions) {
+        auto files = std::make_shared<InMemoryModelFiles>();
+        auto sc = readModelVersionToMemory(fs, fs->joinPath({config.getBasePath(), std::to_string(version)}), *files);
+        if (sc != StatusCode::OK) {
+            SPDLOG_LOGGER_ERROR(modelmanager_logger, "Couldn't read model: {} version: {} from {} into memory", config.getName(), version, config.getBasePath());
+            return sc;
+        }
+        SPDLOG_LOGGER_DEBUG(modelmanager_logger, "Read model: {} version: {} into memory ({} bytes)", config.getName(), version, files->model.size() + files->weights.size());
+        config.setInMemoryModelFiles(version, std::move(files));
+    }
+    // nothing is written to disk, so there is no local copy to clean up
+    config.setLocalPath(config.getBasePath());
+    return StatusCode::OK;
+}
+}  // namespace
+
 StatusCode downloadModels(std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t> versions) {
     if (versions->size() == 0) {
         return StatusCode::OK;
     }
+    if (config.isDownloadToMemory() && !config.isCustomLoaderRequiredToLoadModel() &&
+        std::dynamic_pointer_cast<LocalFileSystem>(fs) == nullptr) {
+        return downloadModelsToMemory(fs, config, *versions);
+    }
     std::string localPath;
     SPDLOG_LOGGER_INFO(modelmanager_logger, "Getting model from {}", config.getBasePath());
     auto sc = fs->downloadModelVersions(config.getBasePath(), &localPath, *versions);
@@ -580,6 +1245,8 @@ StatusCode downloadModels(std::shared_ptr<FileSystem>& fs, ModelConfig& config,
 
 Status ModelManager::cleanupModelTmpFiles(ModelConfig& config) {
     auto lfstatus = StatusCode::OK;
+    // loaded versions keep their files, the rest is released
+    config.clearInMemoryModelFiles();
 
     if (config.getLocalPath().compare(config.getBasePath())) {
         LocalFileSystem lfs;
@@ -596,11 +1263,14 @@ Status ModelManager::cleanupModelTmpFiles(ModelConfig& config) {
     return lfstatus;
 }
 
-Status ModelManager::addModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToStart) {
+Status ModelManager::addModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToStart, size_t versionLoadingThreads) {
     Status status = StatusCode::OK;
     try {
-        downloadModels(fs, config, versionsToStart);
-        status = model->addVersions(versionsToStart, config);
+        {
+            LoadingPhaseTimer downloadTimer(model->getLoadingProfile(), LoadingPhase::DOWNLOAD);
+            downloadModels(fs, config, versionsToStart);
+        }
+        status = model->addVersions(versionsToStart, config, versionLoadingThreads);
         if (!status.ok()) {
             SPDLOG_LOGGER_ERROR(modelmanager_logger, "Error occurred while loading model: {} versions; error: {}",
                 config.getName(),
@@ -614,12 +1284,15 @@ Status ModelManager::addModelVersions(std::shared_ptr<ovms::Model>& model, std::
     return status;
 }
 
-Status ModelManager::reloadModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToReload) {
+Status ModelManager::reloadModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToReload, size_t versionLoadingThreads) {
     Status status = StatusCode::OK;
 
     try {
-        downloadModels(fs, config, versionsToReload);
-        auto status = model->reloadVersions(versionsToReload, config);
+        {
+            LoadingPhaseTimer downloadTimer(model->getLoadingProfile(), LoadingPhase::DOWNLOAD);
+            downloadModels(fs, config, versionsToReload);
+        }
+        auto status = model->reloadVersions(versionsToReload, config, versionLoadingThreads);
         if (!status.ok()) {
             SPDLOG_LOGGER_ERROR(modelmanager_logger, "Error occurred while reloading model: {}; versions; error: {}",
                 config.getName(),
@@ -633,13 +1306,18 @@ Status ModelManager::reloadModelVersions(std::shared_ptr<ovms::Model>& model, st
     return status;
 }
 
-Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
-    auto fs = getFilesystem(config.getBasePath());
+Status ModelManager::reloadModelWithVersions(ModelConfig& config, size_t versionLoadingThreads) {
+    config.setCompiledModelCacheDir(compiledModelCacheDir);
+    config.setShareCompiledNetworks(shareCompiledNetworks);
+    auto fs = filesystemFactory(config.getBasePath());
+    fs->setDownloadCache(downloadCache);
     std::vector<model_version_t> requestedVersions;
+    const auto listingStart = std::chrono::steady_clock::now();
     auto blocking_status = readAvailableVersions(fs, config.getBasePath(), requestedVersions);
     if (!blocking_status.ok()) {
         return blocking_status;
     }
+    const auto listingTime = std::chrono::steady_clock::now() - listingStart;
     requestedVersions = config.getModelVersionPolicy()->filter(requestedVersions);
 
     std::shared_ptr<model_versions_t> versionsToStart;
@@ -647,6 +1325,8 @@ Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
     std::shared_ptr<model_versions_t> versionsToRetire;
 
     auto model = getModelIfExistCreateElse(config.getName());
+    // model is created once its versions are listed
+    model->getLoadingProfile().record(LoadingPhase::LIST_VERSIONS, std::chrono::duration_cast<std::chrono::microseconds>(listingTime).count());
 
     // first reset custom loader name to empty string so that any changes to name can be captured
     model->resetCustomLoaderName();
@@ -679,14 +1359,14 @@ Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
     getVersionsToChange(config, model->getModelVersions(), requestedVersions, versionsToStart, versionsToReload, versionsToRetire);
 
     if (versionsToStart->size() > 0) {
-        auto blocking_status = addModelVersions(model, fs, config, versionsToStart);
+        auto blocking_status = addModelVersions(model, fs, config, versionsToStart, versionLoadingThreads);
         if (!blocking_status.ok()) {
             return blocking_status;
         }
     }
 
     if (versionsToReload->size() > 0) {
-        reloadModelVersions(model, fs, config, versionsToReload);
+        reloadModelVersions(model, fs, config, versionsToReload, versionLoadingThreads);
     }
     if (versionsToRetire->size()) {
         auto status = model->retireVersions(versionsToRetire);
@@ -701,9 +1381,9 @@ Status ModelManager::reloadModelWithVersions(ModelConfig& config) {
 }
 
 const std::shared_ptr<Model> ModelManager::findModelByName(const std::string& name) const {
-    std::shared_lock lock(modelsMtx);
-    auto it = models.find(name);
-    return it != models.end() ? it->second : nullptr;
+    const auto snapshot = std::atomic_load(&modelsSnapshot);
+    auto it = snapshot->find(name);
+    return it != snapshot->end() ? it->second : nullptr;
 }
 
 }  // namespace ovms
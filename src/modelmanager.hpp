@@ -15,23 +15,31 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
 #include <spdlog/spdlog.h>
 
+#include "blockingtasksexecutor.hpp"
 #include "customloaders.hpp"
 #include "filesystem.hpp"
+#include "lockmetrics.hpp"
 #include "model.hpp"
+#include "modelusage.hpp"
 #include "pipeline.hpp"
 #include "pipeline_factory.hpp"
+#include "readiness.hpp"
 
 namespace ovms {
 class IVersionReader;
@@ -53,6 +61,12 @@ protected:
      */
     std::map<std::string, std::shared_ptr<Model>> models;
 
+    /**
+     * @brief Copy of models published after each change, read by requests without locking modelsMtx
+     */
+    std::shared_ptr<const std::map<std::string, std::shared_ptr<Model>>> modelsSnapshot =
+        std::make_shared<const std::map<std::string, std::shared_ptr<Model>>>();
+
     PipelineFactory pipelineFactory;
 
 private:
@@ -68,10 +82,52 @@ private:
      * @return Status 
      */
     Status loadConfig(const std::string& jsonFilename);
+
+    /**
+     * @brief Reads configuration file and validates it against schema, without applying it
+     *
+     * @param jsonFilename configuration file
+     * @param configJson parsed configuration
+     * @return Status
+     */
+    Status parseConfig(const std::string& jsonFilename, rapidjson::Document& configJson);
+
+    /**
+     * @brief Validates config file or command line arguments of models loaded in background, before servers are started
+     */
+    Status validateStartupConfig();
+
+    /**
+     * @brief Creates configuration of model served from command line arguments
+     */
+    Status createModelConfigFromParameters(ModelConfig& modelConfig);
+
+    /**
+     * @brief Loads models from config file or command line arguments and starts watcher
+     */
+    Status startModels();
     Status cleanupModelTmpFiles(ModelConfig& config);
-    Status reloadModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToReload);
-    Status addModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToStart);
+    Status reloadModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToReload, size_t versionLoadingThreads);
+    Status addModelVersions(std::shared_ptr<ovms::Model>& model, std::shared_ptr<FileSystem>& fs, ModelConfig& config, std::shared_ptr<model_versions_t>& versionsToStart, size_t versionLoadingThreads);
     Status loadModelsConfig(rapidjson::Document& configJson);
+
+    /**
+     * @brief Loads and reloads models from config file concurrently, returns once all of them are processed
+     *
+     * Threads are split between models and their versions, so that no more than modelLoadingThreads are used.
+     *
+     * @param configs
+     */
+    void loadModelsInParallel(const std::vector<ModelConfig*>& configs);
+
+    /**
+     * @brief Reserves CPUs of model with exclusive CPU set or releases reservation of the other model
+     *
+     * @param config
+     *
+     * @return CPU_SET_RESERVED if CPUs are reserved by other model, CPU_AFFINITY_INVALID if CPUs are not requested
+     */
+    Status reserveExclusiveCpus(const ModelConfig& config);
     Status loadPipelinesConfig(rapidjson::Document& configJson);
     Status loadCustomLoadersConfig(rapidjson::Document& configJson);
 
@@ -84,6 +140,31 @@ private:
      */
     void watcher(std::future<void> exit);
 
+    /**
+     * @brief Reloads model versions in watcher, skipped when model directory did not change since last successful reload
+     *
+     * @param config
+     */
+    void reloadModelIfDirectoryChanged(ModelConfig& config);
+
+    /**
+     * @brief Reloads model versions and records directory change token once all of them are settled
+     *
+     * @param config
+     * @param token directory change token read before reload, empty if not available
+     */
+    void reloadModelWithVersionsAndRecordToken(ModelConfig& config, const std::string& token);
+
+    /**
+     * @brief Waits until all model reloads started by watcher finish
+     */
+    void waitForBackgroundReloads();
+
+    /**
+     * @brief Gets executor of watcher reloads for model, custom loaders not supporting concurrent loading get single worker one
+     */
+    BlockingTasksExecutor& getBackgroundReloadsExecutor(const ModelConfig& config);
+
     /**
      * @brief A JSON configuration filename
      */
@@ -105,6 +186,41 @@ private:
      */
     std::vector<ModelConfig> servedModelConfigs;
 
+    /**
+     * @brief Hashes of model config entries applied from config file, keyed by model name
+     */
+    std::map<std::string, uint64_t> modelConfigHashes;
+
+    /**
+     * @brief Hashes of pipeline config entries applied from config file, keyed by pipeline name
+     */
+    std::map<std::string, uint64_t> pipelineConfigHashes;
+
+    /**
+     * @brief Directory change tokens of models successfully reloaded by watcher, keyed by model name
+     */
+    std::map<std::string, std::pair<std::string, std::string>> modelDirectoryChangeTokens;
+
+    /**
+     * @brief Mutex for blocking concurrent access to directory change tokens by background reloads
+     */
+    std::mutex modelDirectoryChangeTokensMtx;
+
+    /**
+     * @brief Model reloads started by watcher and running in background, keyed by model name, used by watcher thread only
+     */
+    std::map<std::string, std::future<void>> backgroundReloads;
+
+    /**
+     * @brief Workers running model reloads started by watcher, as many as model loading threads, used by watcher thread only
+     */
+    std::unique_ptr<BlockingTasksExecutor> backgroundReloadsExecutor;
+
+    /**
+     * @brief Single worker running reloads of custom loader models not supporting concurrent loading, used by watcher thread only
+     */
+    std::unique_ptr<BlockingTasksExecutor> serialBackgroundReloadsExecutor;
+
     /**
      * @brief Retires models non existing in config file
      *
@@ -115,13 +231,83 @@ private:
     /**
      * @brief Mutex for blocking concurrent add & find of model
      */
-    mutable std::shared_mutex modelsMtx;
+    mutable InstrumentedMutex<std::shared_mutex> modelsMtx{"models"};
 
     /**
      * Time interval between each config file check
      */
     uint watcherIntervalSec = 1;
 
+    /**
+     * Maximum number of models and versions loaded concurrently
+     */
+    uint modelLoadingThreads = 1;
+
+    /**
+     * Directory of exported compiled networks shared by all models, empty if disabled
+     */
+    std::string compiledModelCacheDir;
+
+    /**
+     * Share compiled networks between model versions with identical model files, device, plugin config and inputs
+     */
+    bool shareCompiledNetworks = false;
+
+    /**
+     * Cache of model files downloaded from cloud storage, nullptr if disabled
+     */
+    std::shared_ptr<DownloadCache> downloadCache;
+
+    /**
+     * Estimated memory of loaded model versions above which least recently used are evicted, 0 if unlimited
+     */
+    size_t memoryBudgetBytes = 0;
+
+    /**
+     * @brief Mutex for blocking concurrent memory budget enforcement
+     */
+    std::mutex memoryBudgetMtx;
+
+    /**
+     * @brief Readiness of server based on infer requests queue pressure of critical models
+     */
+    ReadinessProbe readinessProbe;
+
+    /**
+     * @brief Request counts of models persisted between restarts, ordering loading of models
+     */
+    ModelUsage modelUsage;
+
+    /**
+     * @brief Time of the last save of model usage by watcher
+     */
+    std::chrono::steady_clock::time_point lastModelUsageSave;
+
+    /**
+     * @brief Loading of models at startup running in background while servers accept requests, invalid if not used
+     */
+    std::future<void> initialLoad;
+
+    /**
+     * @brief Cleared while models critical for readiness are loaded at startup in background
+     */
+    std::atomic<bool> criticalModelsLoaded{true};
+
+    /**
+     * @brief Status of models loading at startup in background, OK until it fails
+     */
+    Status startupStatus;
+
+    /**
+     * @brief Mutex for blocking concurrent access to startup status by readiness checks
+     */
+    mutable std::mutex startupStatusMtx;
+
+    /**
+     * @brief Saves request counts of served models, if enabled
+     */
+    void saveModelUsage();
+
 public:
     /**
      * @brief Gets the instance of ModelManager
@@ -166,6 +352,29 @@ public:
         return pipelineFactory;
     }
 
+    ReadinessProbe& getReadinessProbe() {
+        return readinessProbe;
+    }
+
+    /**
+     * @brief Gets copy of models collection, safe to iterate while models are being added
+     */
+    std::shared_ptr<const std::map<std::string, std::shared_ptr<Model>>> getModelsSnapshot() const {
+        return std::atomic_load(&modelsSnapshot);
+    }
+
+    /**
+     * @brief Tells whether models critical for readiness are loaded, false only while they are loaded at startup in background
+     */
+    bool areCriticalModelsLoaded() const {
+        return criticalModelsLoaded.load();
+    }
+
+    /**
+     * @brief Gets status of models loading at startup in background, OK while it is running or if it succeeded
+     */
+    Status getStartupStatus() const;
+
     /**
      * @brief Finds model with specific name
      *
@@ -233,10 +442,11 @@ public:
      * @brief Reload model versions located in base path
      * 
      * @param ModelConfig config
+     * @param versionLoadingThreads maximum number of versions loaded concurrently
      * 
      * @return status
      */
-    Status reloadModelWithVersions(ModelConfig& config);
+    Status reloadModelWithVersions(ModelConfig& config, size_t versionLoadingThreads = 1);
 
     /**
      * @brief Starts model manager using ovms::Config
@@ -251,6 +461,23 @@ public:
      */
     void startWatcher();
 
+    /**
+     * @brief Evicts least recently used idle model versions until their estimated memory fits in budget
+     *
+     * @param excluded version which is not evicted, e.g. just loaded
+     */
+    void enforceMemoryBudget(const ModelInstance* excluded = nullptr);
+
+    /**
+     * @brief Removes sequences of stateful models which received no requests for their sequence timeout
+     */
+    void removeIdleSequences();
+
+    /**
+     * @brief Logs durations of loading phases of models, model versions and pipelines loaded since previous call
+     */
+    void logLoadingProfiles();
+
     /**
      * @brief Gracefully finish the thread
      */
@@ -265,6 +492,14 @@ public:
         return std::make_shared<Model>(name);
     }
 
+    /**
+     * @brief Factory for creating a filesystem of model base path
+     *
+     * @param basePath
+     * @return std::shared_ptr<FileSystem>
+     */
+    virtual std::shared_ptr<FileSystem> filesystemFactory(const std::string& basePath);
+
     /**
      * @brief Reads available versions from given filesystem
      * 
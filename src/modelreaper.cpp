@@ -0,0 +1,113 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "modelreaper.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "modelinstance.hpp"
+
+namespace ovms {
+
+namespace {
+const std::chrono::milliseconds RETIRING_INSTANCES_CHECKING_INTERVAL(10);
+}  // namespace
+
+ModelReaper::ModelReaper() :
+    thread(&ModelReaper::run, this) {}
+
+ModelReaper::~ModelReaper() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    wakeUp.notify_all();
+    thread.join();
+}
+
+void ModelReaper::retire(std::shared_ptr<ModelInstance> instance) {
+    SPDLOG_DEBUG("Model: {} version: {} will be unloaded in background once its inferences finish", instance->getName(), instance->getVersion());
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        retiringInstances.push_back(std::move(instance));
+    }
+    wakeUp.notify_all();
+}
+
+void ModelReaper::release(std::shared_ptr<void> resources, size_t memoryUsage) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        releasedResources.push_back(std::move(resources));
+        releasedMemoryUsage += memoryUsage;
+    }
+    wakeUp.notify_all();
+}
+
+size_t ModelReaper::getPendingMemoryUsage() {
+    std::lock_guard<std::mutex> lock(mtx);
+    size_t memoryUsage = releasedMemoryUsage + destroyedMemoryUsage;
+    for (const auto& instance : retiringInstances) {
+        memoryUsage += instance->getMemoryUsage();
+    }
+    return memoryUsage;
+}
+
+void ModelReaper::waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(mtx);
+    idle.wait(lock, [this]() { return !busy && retiringInstances.empty() && releasedResources.empty(); });
+}
+
+void ModelReaper::run() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopped) {
+        auto resources = std::move(releasedResources);
+        releasedResources.clear();
+        destroyedMemoryUsage = releasedMemoryUsage;
+        releasedMemoryUsage = 0;
+        std::vector<std::shared_ptr<ModelInstance>> unloadable;
+        for (auto it = retiringInstances.begin(); it != retiringInstances.end();) {
+            if ((*it)->canUnloadInstance()) {
+                unloadable.push_back(std::move(*it));
+                it = retiringInstances.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        busy = !resources.empty() || !unloadable.empty();
+        lock.unlock();
+        resources.clear();
+        for (auto& instance : unloadable) {
+            instance->finishRetirement();
+        }
+        unloadable.clear();
+        lock.lock();
+        destroyedMemoryUsage = 0;
+        busy = false;
+        if (!releasedResources.empty()) {
+            continue;
+        }
+        if (retiringInstances.empty()) {
+            idle.notify_all();
+            wakeUp.wait(lock, [this]() { return stopped || !retiringInstances.empty() || !releasedResources.empty(); });
+        } else {
+            wakeUp.wait_for(lock, RETIRING_INSTANCES_CHECKING_INTERVAL, [this]() { return stopped || !releasedResources.empty(); });
+        }
+    }
+}
+
+}  // namespace ovms
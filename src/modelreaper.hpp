@@ -0,0 +1,84 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ovms {
+
+class ModelInstance;
+
+/**
+ * @brief Background thread finishing retirement of model versions, so that config processing is not blocked
+ * by inferences in progress or by destruction of networks, which may take seconds for big models
+ */
+class ModelReaper {
+    std::mutex mtx;
+    std::condition_variable wakeUp;
+    std::vector<std::shared_ptr<ModelInstance>> retiringInstances;
+    std::vector<std::shared_ptr<void>> releasedResources;
+    // estimated memory of released resources not destroyed yet, including those being destroyed
+    size_t releasedMemoryUsage = 0;
+    size_t destroyedMemoryUsage = 0;
+    bool busy = false;
+    bool stopped = false;
+    std::condition_variable idle;
+    std::thread thread;
+
+    ModelReaper();
+    void run();
+
+public:
+    static ModelReaper& getInstance() {
+        static ModelReaper instance;
+        return instance;
+    }
+
+    ~ModelReaper();
+
+    /**
+     * @brief Unloads version in UNLOADING state once it has no inferences in progress, skipped if it was loaded again meanwhile
+     *
+     * @param instance
+     */
+    void retire(std::shared_ptr<ModelInstance> instance);
+
+    /**
+     * @brief Destroys resources of unloaded version
+     *
+     * @param resources
+     * @param memoryUsage estimated memory of resources, counted as used until they are destroyed
+     */
+    void release(std::shared_ptr<void> resources, size_t memoryUsage = 0);
+
+    /**
+     * @brief Gets estimated memory still held by retiring versions and by resources waiting for destruction
+     *
+     * Previous network coexists with the new one until it is destroyed, so that memory is counted in model memory budget.
+     */
+    size_t getPendingMemoryUsage();
+
+    /**
+     * @brief Waits until all scheduled versions are unloaded and resources destroyed
+     */
+    void waitUntilIdle();
+};
+
+}  // namespace ovms
@@ -0,0 +1,89 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "modelusage.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+namespace ovms {
+
+Status ModelUsage::load() {
+    std::lock_guard<std::mutex> lock(mtx);
+    previousCounts.clear();
+    std::ifstream ifs(path);
+    if (!ifs.good()) {
+        SPDLOG_DEBUG("Model usage file {} does not exist, models are loaded in configuration order", path);
+        return StatusCode::OK;
+    }
+    rapidjson::Document json;
+    rapidjson::IStreamWrapper isw(ifs);
+    if (json.ParseStream(isw).HasParseError() || !json.IsObject()) {
+        SPDLOG_WARN("Model usage file {} is not a valid JSON object, models are loaded in configuration order", path);
+        return StatusCode::JSON_INVALID;
+    }
+    for (const auto& member : json.GetObject()) {
+        if (member.value.IsUint64()) {
+            previousCounts[member.name.GetString()] = member.value.GetUint64() / 2;
+        }
+    }
+    SPDLOG_INFO("Read usage of {} models from {}", previousCounts.size(), path);
+    return StatusCode::OK;
+}
+
+Status ModelUsage::save(const std::map<std::string, uint64_t>& currentCounts) const {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    for (const auto& [name, count] : currentCounts) {
+        writer.Key(name.c_str());
+        writer.Uint64(getCount(name, count));
+    }
+    writer.EndObject();
+
+    const auto tmpPath = path + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream ofs(tmpPath, std::ios::trunc);
+        ofs.write(buffer.GetString(), buffer.GetSize());
+        if (!ofs.good()) {
+            SPDLOG_WARN("Failed to write model usage file {}", tmpPath);
+            return StatusCode::FILE_INVALID;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        SPDLOG_WARN("Failed to save model usage file {}; error: {}", path, ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return StatusCode::FILE_INVALID;
+    }
+    return StatusCode::OK;
+}
+
+uint64_t ModelUsage::getCount(const std::string& name, uint64_t currentCount) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = previousCounts.find(name);
+    return currentCount + (it != previousCounts.end() ? it->second : 0);
+}
+
+}  // namespace ovms
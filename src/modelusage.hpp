@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Request counts of models persisted between server restarts, so that the busiest models are loaded first on startup
+ *
+ * Counts of previous runs are halved when they are read, so that the order follows recent traffic. Saved counts are the
+ * halved previous ones plus requests received since startup, models missing in saved counts are dropped.
+ */
+class ModelUsage {
+    std::string path;
+    std::map<std::string, uint64_t> previousCounts;
+    mutable std::mutex mtx;
+
+public:
+    /**
+     * @brief Sets path of file with saved counts, empty if disabled, has to be called before counts are used
+     */
+    void setPath(const std::string& path) {
+        this->path = path;
+    }
+
+    bool isEnabled() const {
+        return !path.empty();
+    }
+
+    /**
+     * @brief Reads counts saved by previous run, missing file is not an error
+     */
+    Status load();
+
+    /**
+     * @brief Writes counts, published with rename so that crash while saving keeps the previous file
+     *
+     * @param currentCounts requests received by models since startup
+     */
+    Status save(const std::map<std::string, uint64_t>& currentCounts) const;
+
+    /**
+     * @brief Gets usage of model used to order loading
+     */
+    uint64_t getCount(const std::string& name, uint64_t currentCount = 0) const;
+};
+
+}  // namespace ovms
@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -22,6 +23,7 @@
 #include <spdlog/spdlog.h>
 
 #include "modelconfig.hpp"
+#include "statussnapshot.hpp"
 
 // note: think about using https://github.com/Neargye/magic_enum when compatible compiler is supported.
 
@@ -81,15 +83,19 @@ class ModelVersionStatus {
     model_version_t version;
     ModelVersionState state;
     ModelVersionStatusErrorCode errorCode;
+    std::string details;
+    // transitions are reported to status snapshot only while set, nullptr if always reported
+    const std::atomic<bool>* published = nullptr;
 
 public:
     ModelVersionStatus() = default;
 
-    ModelVersionStatus(const std::string& model_name, model_version_t version, ModelVersionState state = ModelVersionState::START) :
+    ModelVersionStatus(const std::string& model_name, model_version_t version, ModelVersionState state = ModelVersionState::START, const std::atomic<bool>* published = nullptr) :
         modelName(model_name),
         version(version),
         state(state),
-        errorCode(ModelVersionStatusErrorCode::OK) {
+        errorCode(ModelVersionStatusErrorCode::OK),
+        published(published) {
         logStatus();
     }
 
@@ -109,6 +115,17 @@ public:
         return ModelVersionStatusErrorCodeToString(this->errorCode);
     }
 
+    /**
+     * @brief Gets additional information about loaded version reported with its status, empty if there is none
+     */
+    const std::string& getDetails() const {
+        return this->details;
+    }
+
+    void setDetails(const std::string& details) {
+        this->details = details;
+    }
+
     /**
      * @brief Check if current state is state that is either transforming to END or already in that state.
      *
@@ -146,6 +163,13 @@ public:
         logStatus();
     }
 
+    /**
+     * @brief Reports current state to status snapshot, used once version starts being served
+     */
+    void publish() const {
+        StatusSnapshot::getInstance().updateModelVersion(this->modelName, this->version, ModelVersionStateToString(state), ModelVersionStatusErrorCodeToString(errorCode));
+    }
+
 private:
     void logStatus() {
         SPDLOG_INFO("STATUS CHANGE: Version {} of model {} status change. New status: ( \"state\": \"{}\", \"error_code\": \"{}\" )",
@@ -153,6 +177,9 @@ private:
             this->modelName,
             ModelVersionStateToString(state),
             ModelVersionStatusErrorCodeToString(errorCode));
+        if (this->published == nullptr || this->published->load()) {
+            publish();
+        }
     }
 };
 
@@ -0,0 +1,133 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "multipredict.hpp"
+
+#include <map>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "modelconfig.hpp"
+#include "modelinstance.hpp"
+#include "modelinstanceunloadguard.hpp"
+#include "prediction_service_utils.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Gets index of the last request each shared input is passed to, which takes it over without copy
+ */
+std::map<std::string, int> getLastRequestsUsingInputs(const MultiPredictRequest& request, const std::vector<const tensor_map_t*>& modelsInputs) {
+    std::map<std::string, int> lastRequestUsingInput;
+    for (int i = 0; i < request.requests_size(); i++) {
+        const auto& modelRequest = request.requests(i);
+        for (const auto& [name, input] : request.shared_inputs().inputs()) {
+            if (modelsInputs[i]->count(name) > 0 && modelRequest.inputs().count(name) == 0) {
+                lastRequestUsingInput[name] = i;
+            }
+        }
+    }
+    return lastRequestUsingInput;
+}
+
+bool isSharedInputPassed(const MultiPredictRequest& request, const std::vector<const tensor_map_t*>& modelsInputs, int index, const std::string& name, int last) {
+    return index <= last && request.requests(index).inputs().count(name) == 0 && modelsInputs[index]->count(name) > 0;
+}
+}  // namespace
+
+Status prepareMultiPredict(ModelManager& manager, MultiPredictRequest& request, std::vector<MultiPredictModel>& models) {
+    if (request.requests_size() == 0) {
+        return StatusCode::MULTI_PREDICT_NO_REQUESTS;
+    }
+    if (request.requests_size() > MAX_MULTI_PREDICT_REQUESTS) {
+        SPDLOG_DEBUG("Multi predict request lists {} models, up to {} are allowed", request.requests_size(), MAX_MULTI_PREDICT_REQUESTS);
+        return StatusCode::MULTI_PREDICT_TOO_MANY_REQUESTS;
+    }
+    std::vector<const tensor_map_t*> modelsInputs;
+    for (const auto& modelRequest : request.requests()) {
+        auto& model = models.emplace_back();
+        auto status = getModelInstance(manager, modelRequest.model_spec().name(), modelRequest.model_spec().version().value(),
+            model.modelInstance, model.modelInstanceUnloadGuard);
+        if (!status.ok()) {
+            SPDLOG_INFO("Getting modelInstance for multi predict request failed. {}", status.string());
+            return status;
+        }
+        modelsInputs.push_back(&model.modelInstance->getInputsInfo());
+    }
+    auto& budget = InFlightMemoryBudget::getInstance();
+    const auto copiedBytes = getMultiPredictCopiedBytes(request, modelsInputs);
+    for (size_t i = 0; i < models.size(); i++) {
+        const auto& modelInstance = *models[i].modelInstance;
+        const size_t modelBudgetBytes = modelInstance.getModelConfig().getInFlightMemoryBudgetMb() * 1024 * 1024;
+        if (copiedBytes[i] == 0 || budget.isUnlimited(modelBudgetBytes)) {
+            continue;
+        }
+        auto reserved = budget.tryReserve(modelInstance.getName(), copiedBytes[i], modelBudgetBytes);
+        if (!reserved) {
+            SPDLOG_DEBUG("Multi predict request rejected due to in flight memory budget of model {}", modelInstance.getName());
+            return StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED;
+        }
+        models[i].sharedInputsReservation = std::move(reserved.value());
+    }
+    shareMultiPredictInputs(request, modelsInputs);
+    return StatusCode::OK;
+}
+
+std::vector<size_t> getMultiPredictCopiedBytes(const MultiPredictRequest& request, const std::vector<const tensor_map_t*>& modelsInputs) {
+    std::vector<size_t> copiedBytes(request.requests_size(), 0);
+    for (const auto& [name, last] : getLastRequestsUsingInputs(request, modelsInputs)) {
+        const size_t inputBytes = request.shared_inputs().inputs().at(name).ByteSizeLong();
+        for (int i = 0; i < last; i++) {
+            if (isSharedInputPassed(request, modelsInputs, i, name, last)) {
+                copiedBytes[i] += inputBytes;
+            }
+        }
+    }
+    return copiedBytes;
+}
+
+void shareMultiPredictInputs(MultiPredictRequest& request, const std::vector<const tensor_map_t*>& modelsInputs) {
+    const auto lastRequestUsingInput = getLastRequestsUsingInputs(request, modelsInputs);
+    auto& sharedInputs = *request.mutable_shared_inputs()->mutable_inputs();
+    for (int i = 0; i < request.requests_size(); i++) {
+        for (const auto& [name, last] : lastRequestUsingInput) {
+            if (!isSharedInputPassed(request, modelsInputs, i, name, last)) {
+                continue;
+            }
+            auto& inputs = *request.mutable_requests(i)->mutable_inputs();
+            if (i < last) {
+                inputs[name] = sharedInputs[name];
+            } else {
+                inputs[name].Swap(&sharedInputs[name]);
+            }
+        }
+    }
+}
+
+bool MultiPredictCompletion::complete(const Status& requestStatus, Status& callStatus) {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (!requestStatus.ok() && status.ok()) {
+        status = requestStatus;
+    }
+    if (--inProgress > 0) {
+        return false;
+    }
+    callStatus = status;
+    return true;
+}
+
+}  // namespace ovms
@@ -0,0 +1,102 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "src/prediction_stream_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "inflightmemorybudget.hpp"
+#include "status.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+class ModelInstance;
+class ModelInstanceUnloadGuard;
+class ModelManager;
+
+/**
+ * @brief Maximum number of requests in one MultiPredict call, each of them may get a copy of shared inputs
+ */
+constexpr int MAX_MULTI_PREDICT_REQUESTS = 64;
+
+/**
+ * @brief Model version of single request of MultiPredict call, kept loaded until its inference is started
+ */
+struct MultiPredictModel {
+    std::shared_ptr<ModelInstance> modelInstance;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+    // copies of shared inputs passed to request of the model, released with the call
+    InFlightMemoryBudget::Reservation sharedInputsReservation;
+};
+
+/**
+ * @brief Resolves model versions of all requests and passes shared inputs to requests of models having them
+ *
+ * Copies of shared inputs are reserved in in flight memory budget of their models before they are made.
+ *
+ * @param models model version of each request, in order of requests
+ *
+ * @return MULTI_PREDICT_NO_REQUESTS if no model is listed, MULTI_PREDICT_TOO_MANY_REQUESTS if more than
+ * MAX_MULTI_PREDICT_REQUESTS are listed, IN_FLIGHT_MEMORY_EXHAUSTED if copies of shared inputs do not fit the budget,
+ * status of the first model which could not be found otherwise
+ */
+Status prepareMultiPredict(ModelManager& manager, MultiPredictRequest& request, std::vector<MultiPredictModel>& models);
+
+/**
+ * @brief Passes each shared input to requests of models having input of that name and not setting it themselves.
+ * The input is copied into all but the last of those requests, which takes it over without copy.
+ *
+ * @param modelsInputs inputs info of model of each request, in order of requests
+ */
+void shareMultiPredictInputs(MultiPredictRequest& request, const std::vector<const tensor_map_t*>& modelsInputs);
+
+/**
+ * @brief Gets bytes of shared inputs copies shareMultiPredictInputs makes into each request
+ *
+ * @return bytes in order of requests
+ */
+std::vector<size_t> getMultiPredictCopiedBytes(const MultiPredictRequest& request, const std::vector<const tensor_map_t*>& modelsInputs);
+
+/**
+ * @brief Counts down requests of MultiPredict call completed by inference threads, call fails if any of them fails
+ */
+class MultiPredictCompletion {
+    std::mutex mtx;
+    size_t inProgress;
+    Status status = StatusCode::OK;
+
+public:
+    explicit MultiPredictCompletion(size_t count) :
+        inProgress(count) {}
+
+    /**
+     * @brief Records status of completed request
+     *
+     * @param callStatus set to status of the first failed request or OK once the last request is completed
+     *
+     * @return true for the last request
+     */
+    bool complete(const Status& requestStatus, Status& callStatus);
+};
+
+}  // namespace ovms
@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "networkcache.hpp"
+
+#include <utility>
+
+namespace ovms {
+
+std::map<std::string, shape_t> CachedNetwork::getInputShapes() const {
+    std::map<std::string, shape_t> shapes;
+    for (const auto& [name, tensorInfo] : inputsInfo) {
+        shapes.emplace(name, tensorInfo->getShape());
+    }
+    return shapes;
+}
+
+void NetworkCache::setCapacity(size_t capacity) {
+    std::unique_lock<std::mutex> lock(mtx);
+    this->capacity = capacity;
+    while (entries.size() > capacity) {
+        entries.pop_back();
+    }
+}
+
+size_t NetworkCache::size() const {
+    std::unique_lock<std::mutex> lock(mtx);
+    return entries.size();
+}
+
+std::shared_ptr<CachedNetwork> NetworkCache::take(const std::map<std::string, shape_t>& shapes) {
+    std::unique_lock<std::mutex> lock(mtx);
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->first == shapes) {
+            auto network = std::move(it->second);
+            entries.erase(it);
+            return network;
+        }
+    }
+    return nullptr;
+}
+
+void NetworkCache::insert(std::shared_ptr<CachedNetwork> network) {
+    if (!network->execNetwork) {
+        return;
+    }
+    auto shapes = network->getInputShapes();
+    std::unique_lock<std::mutex> lock(mtx);
+    if (capacity == 0) {
+        return;
+    }
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->first == shapes) {
+            entries.erase(it);
+            break;
+        }
+    }
+    entries.emplace_front(std::move(shapes), std::move(network));
+    while (entries.size() > capacity) {
+        entries.pop_back();
+    }
+}
+
+void NetworkCache::clear() {
+    std::unique_lock<std::mutex> lock(mtx);
+    entries.clear();
+}
+
+}  // namespace ovms
@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#include "modelconfig.hpp"
+#include "ovinferrequestsqueue.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Network compiled for specific input shapes together with its infer requests
+ */
+struct CachedNetwork {
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
+    std::vector<std::shared_ptr<InferenceEngine::ExecutableNetwork>> balancedExecNetworks;
+    std::shared_ptr<InferenceEngine::ExecutableNetwork> latencyExecNetwork;
+    std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
+    tensor_map_t inputsInfo;
+    tensor_map_t outputsInfo;
+    std::vector<std::unordered_map<std::string, InferenceEngine::Blob::Ptr>> preallocatedInputBlobs;
+    size_t batchSize = 0;
+
+    /**
+     * @brief Shapes of network inputs by their mapped names
+     */
+    std::map<std::string, shape_t> getInputShapes() const;
+};
+
+/**
+ * @brief LRU cache of networks compiled for previously requested shapes of model version
+ *
+ * Network currently served by model version is not kept in the cache. It is put back there
+ * when model version switches to other shapes, so that switching back does not require recompilation.
+ */
+class NetworkCache {
+    size_t capacity = 0;
+    mutable std::mutex mtx;
+
+    /**
+     * @brief Cached networks, most recently used first
+     */
+    std::list<std::pair<std::map<std::string, shape_t>, std::shared_ptr<CachedNetwork>>> entries;
+
+public:
+    /**
+     * @brief Sets maximum number of cached networks, evicts least recently used ones above it
+     */
+    void setCapacity(size_t capacity);
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    size_t size() const;
+
+    /**
+     * @brief Removes network compiled for exactly these input shapes from the cache
+     *
+     * @return network or nullptr if not cached
+     */
+    std::shared_ptr<CachedNetwork> take(const std::map<std::string, shape_t>& shapes);
+
+    /**
+     * @brief Adds network keyed by its input shapes as most recently used, evicts least recently used one above capacity
+     */
+    void insert(std::shared_ptr<CachedNetwork> network);
+
+    void clear();
+};
+
+}  // namespace ovms
@@ -41,6 +41,9 @@ Status Node::setInputs(const Node& dependency, BlobMap& inputs) {
     for (const auto& pair : mapping_for_dependency) {
         const auto& dependency_output_name = pair.first;
         const auto& current_node_input_name = pair.second;
+        if (!isInputRequired(current_node_input_name)) {
+            continue;
+        }
 
         // possibly incorrectly constructed pipeline - required input missing from previous node
         auto it = inputs.find(dependency_output_name);
@@ -63,4 +66,12 @@ Status Node::setInputs(const Node& dependency, BlobMap& inputs) {
     return StatusCode::OK;
 }
 
+void Node::skipDependency(const Node& dependency) {
+    for (const auto& pair : this->getMappingByDependency(dependency)) {
+        this->skippedInputs.insert(pair.second);
+    }
+    this->dependencySkipped = true;
+    finishedDependenciesCount++;
+}
+
 }  // namespace ovms
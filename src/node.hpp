@@ -15,6 +15,8 @@
 //*****************************************************************************
 #pragma once
 
+#include <chrono>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -22,8 +24,8 @@
 
 #include <inference_engine.hpp>
 
+#include "metrics.hpp"
 #include "status.hpp"
-#include "threadsafequeue.hpp"
 
 namespace ovms {
 
@@ -31,6 +33,20 @@ using BlobMap = std::unordered_map<std::string, InferenceEngine::Blob::Ptr>;
 using BlobNames = std::vector<std::string>;
 using InputPairs = std::vector<std::pair<std::string, std::string>>;
 
+class Node;
+
+/**
+ * @brief Receives nodes which finished execution or got stream id they were deferred for
+ *
+ * Nodes are pushed from infer request completion callbacks and from threads returning streams
+ * with infer requests queue lock held, so push should only record the node and return.
+ */
+class NodeNotificationQueue {
+public:
+    virtual ~NodeNotificationQueue() = default;
+    virtual void push(Node& node) = 0;
+};
+
 class Node {
 protected:
     std::string nodeName;
@@ -40,6 +56,19 @@ protected:
 
     size_t finishedDependenciesCount = 0;
 
+    // Inputs which skipped dependencies would provide, node is skipped as well unless it is exit node
+    std::set<std::string> skippedInputs;
+    bool dependencySkipped = false;
+
+    // Time after which pipeline fails if node did not finish since it was started, 0 if not limited
+    std::chrono::microseconds timeout{0};
+
+    // Counters shared by this node in all pipelines of the definition, nullptr if not collected
+    NodeMetrics* metrics = nullptr;
+
+    // Time of the last notification, written by notifying thread before node is queued
+    std::chrono::steady_clock::time_point notificationTime;
+
     // Blobs ready and waiting for execution
     BlobMap inputBlobs;
 
@@ -55,11 +84,37 @@ public:
 
     const std::string& getName() const { return this->nodeName; }
 
-    virtual Status execute(ThreadSafeQueue<std::reference_wrapper<Node>>& notifyEndQueue) = 0;
+    const std::chrono::microseconds& getTimeout() const { return this->timeout; }
+    void setTimeout(const std::chrono::microseconds& timeout) { this->timeout = timeout; }
+
+    NodeMetrics* getMetrics() const { return this->metrics; }
+    void setMetrics(NodeMetrics* metrics) { this->metrics = metrics; }
+
+    const std::chrono::steady_clock::time_point& getNotificationTime() const { return this->notificationTime; }
+    void setNotificationTime(const std::chrono::steady_clock::time_point& time) { this->notificationTime = time; }
+
+    virtual Status execute(NodeNotificationQueue& notifyEndQueue) = 0;
     virtual Status fetchResults(BlobMap& outputs) = 0;
 
     Status setInputs(const Node& dependency, BlobMap& inputs);
 
+    /**
+     * @brief Counts dependency as finished without providing its outputs, because it was skipped or closed the gate
+     */
+    void skipDependency(const Node& dependency);
+
+    bool hasSkippedDependency() const { return this->dependencySkipped; }
+
+    /**
+     * @brief Drops inputs of node skipped in current execution, blobs can be owned by inference requests of previous nodes
+     */
+    void releaseInputs() { this->inputBlobs.clear(); }
+
+    /**
+     * @brief Tells whether dependants of node are skipped in current execution instead of receiving its outputs
+     */
+    virtual bool skipsDependants() const { return false; }
+
     virtual void addDependency(Node& node, const InputPairs& blobNamesMapping) {
         this->previous.emplace_back(node);
         this->blobNamesMapping[node.getName()] = blobNamesMapping;
@@ -70,6 +125,11 @@ public:
     const InputPairs& getMappingByDependency(const Node& dependency) {
         return blobNamesMapping.at(dependency.getName());
     }
+
+    /**
+     * @brief Tells whether input is used in current execution, dependencies skip fetching outputs mapped to inputs which are not
+     */
+    virtual bool isInputRequired(const std::string& inputName) const { return true; }
     bool isReady() const {
         return finishedDependenciesCount == previous.size();
     }
@@ -77,6 +137,16 @@ public:
         return next;
     }
     virtual void release() {}
+
+    /**
+     * @brief Clears state of previous execution so that node can be reused in next pipeline
+     */
+    virtual void reset() {
+        this->inputBlobs.clear();
+        this->finishedDependenciesCount = 0;
+        this->skippedInputs.clear();
+        this->dependencySkipped = false;
+    }
     virtual bool tryDisarmStreamIdGuard(const uint microseconds = 1) { return true; }
 
     static void printNodeConnections(const std::string& nodeName, const std::string& sourceNode, const InputPairs& pairs);
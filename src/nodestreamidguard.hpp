@@ -15,8 +15,11 @@
 //*****************************************************************************
 #pragma once
 
-#include <future>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <optional>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
@@ -24,15 +27,32 @@
 
 namespace ovms {
 struct NodeStreamIdGuard {
-    NodeStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue) :
+    /**
+     * @param inferRequestsQueue
+     * @param onStreamAssigned called from thread returning the stream once it is assigned, if notifyWhenAssigned() armed it
+     */
+    NodeStreamIdGuard(ovms::OVInferRequestsQueue& inferRequestsQueue, std::function<void()> onStreamAssigned = {}) :
         inferRequestsQueue_(inferRequestsQueue),
-        futureStreamId(inferRequestsQueue_.getIdleStream()) {}
+        onStreamAssigned_(std::move(onStreamAssigned)),
+        waiter([this]() {
+            if (notificationArmed.exchange(false) && onStreamAssigned_) {
+                onStreamAssigned_();
+            }
+        }) {
+        streamId = inferRequestsQueue_.tryGetIdleStream();
+        if (!streamId) {
+            inferRequestsQueue_.waitForIdleStream(waiter);
+        }
+    }
 
     ~NodeStreamIdGuard() {
         if (!disarmed) {
             if (!streamId) {
                 SPDLOG_DEBUG("Trying to disarm stream Id that is not needed anymore...");
-                streamId = futureStreamId.get();
+                if (inferRequestsQueue_.cancelWaiting(waiter)) {
+                    return;
+                }
+                streamId = waiter.wait();
             }
             SPDLOG_DEBUG("Returning streamId:{}", streamId.value());
             inferRequestsQueue_.returnStream(streamId.value());
@@ -41,17 +61,34 @@ struct NodeStreamIdGuard {
 
     std::optional<int> tryGetId(const uint microseconds = 1) {
         if (!streamId) {
-            if (std::future_status::ready == futureStreamId.wait_for(std::chrono::microseconds(microseconds))) {
-                streamId = futureStreamId.get();
-            }
+            streamId = waiter.waitFor(std::chrono::microseconds(microseconds));
         }
         return streamId;
     }
 
+    /**
+     * @brief Arms one-shot notification about stream assignment
+     *
+     * @return false if stream is already assigned and no notification will follow, true otherwise
+     */
+    bool notifyWhenAssigned() {
+        notificationArmed.store(true);
+        if (tryGetId(0) && notificationArmed.exchange(false)) {
+            return false;
+        }
+        return true;
+    }
+
     bool tryDisarm(const uint microseconds = 1) {
-        if (std::future_status::ready == futureStreamId.wait_for(std::chrono::microseconds(microseconds))) {
-            streamId = futureStreamId.get();
-            SPDLOG_DEBUG("Returning streamId:", streamId.value());
+        if (disarmed) {
+            return true;
+        }
+        if (!streamId && inferRequestsQueue_.cancelWaiting(waiter)) {
+            disarmed = true;
+            return disarmed;
+        }
+        if (tryGetId(microseconds)) {
+            SPDLOG_DEBUG("Returning streamId:{}", streamId.value());
             inferRequestsQueue_.returnStream(streamId.value());
             disarmed = true;
         }
@@ -60,7 +97,9 @@ struct NodeStreamIdGuard {
 
 private:
     ovms::OVInferRequestsQueue& inferRequestsQueue_;
-    std::future<int> futureStreamId;
+    const std::function<void()> onStreamAssigned_;
+    std::atomic<bool> notificationArmed{false};
+    BlockingIdleStreamWaiter waiter;
     std::optional<int> streamId = std::nullopt;
     bool disarmed = false;
 };
@@ -0,0 +1,192 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "npyfile.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+namespace {
+const char NPY_MAGIC[] = "\x93NUMPY";
+const size_t NPY_MAGIC_SIZE = 6;
+
+const std::map<std::string, std::pair<InferenceEngine::Precision, size_t>> NPY_DESCR_TO_PRECISION = {
+    {"<f4", {InferenceEngine::Precision::FP32, 4}},
+    {"<f2", {InferenceEngine::Precision::FP16, 2}},
+    {"<i4", {InferenceEngine::Precision::I32, 4}},
+    {"<i8", {InferenceEngine::Precision::I64, 8}},
+    {"<i2", {InferenceEngine::Precision::I16, 2}},
+    {"<u2", {InferenceEngine::Precision::U16, 2}},
+    {"|i1", {InferenceEngine::Precision::I8, 1}},
+    {"|u1", {InferenceEngine::Precision::U8, 1}},
+};
+
+// header is a python dict literal, e.g. {'descr': '<f4', 'fortran_order': False, 'shape': (100, 10), }
+bool findHeaderValue(const std::string& header, const std::string& key, std::string& value) {
+    auto position = header.find("'" + key + "'");
+    if (position == std::string::npos) {
+        return false;
+    }
+    position = header.find(':', position);
+    if (position == std::string::npos) {
+        return false;
+    }
+    position = header.find_first_not_of(' ', position + 1);
+    if (position == std::string::npos) {
+        return false;
+    }
+    size_t end;
+    if (header[position] == '\'') {
+        end = header.find('\'', ++position);
+    } else if (header[position] == '(') {
+        end = header.find(')', ++position);
+    } else {
+        end = header.find_first_of(",}", position);
+    }
+    if (end == std::string::npos) {
+        return false;
+    }
+    value = header.substr(position, end - position);
+    return true;
+}
+
+bool parseShape(const std::string& value, shape_t& shape) {
+    shape.clear();
+    std::stringstream ss(value);
+    std::string dimension;
+    while (std::getline(ss, dimension, ',')) {
+        auto begin = dimension.find_first_not_of(' ');
+        if (begin == std::string::npos) {
+            continue;
+        }
+        try {
+            shape.push_back(std::stoul(dimension.substr(begin)));
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+Status writeNpyFile(const std::string& path, const NpyArray& array) {
+    auto it = NPY_DESCR_TO_PRECISION.begin();
+    while (it != NPY_DESCR_TO_PRECISION.end() && it->second.first != array.precision) {
+        ++it;
+    }
+    if (it == NPY_DESCR_TO_PRECISION.end()) {
+        SPDLOG_ERROR("Array of unsupported precision cannot be written to file: {}", path);
+        return StatusCode::INVALID_PRECISION;
+    }
+    std::stringstream shape;
+    for (size_t i = 0; i < array.shape.size(); i++) {
+        shape << array.shape[i] << (i + 1 < array.shape.size() ? ", " : "");
+    }
+    if (array.shape.size() == 1) {
+        shape << ",";
+    }
+    std::string header = "{'descr': '" + it->first + "', 'fortran_order': False, 'shape': (" + shape.str() + "), }";
+    // data starts at offset aligned to 64 bytes, header is padded with spaces and terminated with new line
+    const size_t unpaddedSize = NPY_MAGIC_SIZE + 4 + header.size() + 1;
+    header.append((64 - unpaddedSize % 64) % 64, ' ');
+    header.push_back('\n');
+    std::ofstream file(path, std::ios::binary);
+    if (!file.good()) {
+        SPDLOG_ERROR("Cannot open file for writing: {}", path);
+        return StatusCode::FILE_INVALID;
+    }
+    const char version[2] = {1, 0};
+    const char headerSize[2] = {static_cast<char>(header.size() & 0xFF), static_cast<char>(header.size() >> 8)};
+    file.write(NPY_MAGIC, NPY_MAGIC_SIZE);
+    file.write(version, sizeof(version));
+    file.write(headerSize, sizeof(headerSize));
+    file.write(header.data(), header.size());
+    file.write(array.data.data(), array.data.size());
+    if (!file.good()) {
+        SPDLOG_ERROR("Cannot write file: {}", path);
+        return StatusCode::FILE_INVALID;
+    }
+    return StatusCode::OK;
+}
+
+Status readNpyFile(const std::string& path, NpyArray& array) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.good()) {
+        SPDLOG_ERROR("Cannot open file: {}", path);
+        return StatusCode::FILE_INVALID;
+    }
+    char preamble[NPY_MAGIC_SIZE + 2];
+    if (!file.read(preamble, sizeof(preamble)) || std::memcmp(preamble, NPY_MAGIC, NPY_MAGIC_SIZE) != 0) {
+        SPDLOG_ERROR("File: {} is not in npy format", path);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+    const uint8_t majorVersion = static_cast<uint8_t>(preamble[NPY_MAGIC_SIZE]);
+    uint32_t headerSize = 0;
+    if (majorVersion == 1) {
+        uint8_t size[2];
+        file.read(reinterpret_cast<char*>(size), sizeof(size));
+        headerSize = size[0] | (size[1] << 8);
+    } else if (majorVersion == 2 || majorVersion == 3) {
+        uint8_t size[4];
+        file.read(reinterpret_cast<char*>(size), sizeof(size));
+        headerSize = size[0] | (size[1] << 8) | (size[2] << 16) | (static_cast<uint32_t>(size[3]) << 24);
+    } else {
+        SPDLOG_ERROR("File: {} has unsupported npy format version: {}", path, majorVersion);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+    std::string header(headerSize, '\0');
+    if (!file || !file.read(header.data(), headerSize)) {
+        SPDLOG_ERROR("File: {} has truncated npy header", path);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+
+    std::string descr, fortranOrder, shape;
+    if (!findHeaderValue(header, "descr", descr) ||
+        !findHeaderValue(header, "fortran_order", fortranOrder) ||
+        !findHeaderValue(header, "shape", shape) ||
+        !parseShape(shape, array.shape)) {
+        SPDLOG_ERROR("File: {} has invalid npy header: {}", path, header);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+    if (fortranOrder != "False") {
+        SPDLOG_ERROR("File: {} contains array in fortran order, only C order is supported", path);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+    auto it = NPY_DESCR_TO_PRECISION.find(descr);
+    if (it == NPY_DESCR_TO_PRECISION.end()) {
+        SPDLOG_ERROR("File: {} contains array of unsupported type: {}", path, descr);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+    array.precision = it->second.first;
+    size_t dataSize = it->second.second;
+    for (const auto dimension : array.shape) {
+        dataSize *= dimension;
+    }
+    array.data.resize(dataSize);
+    if (!file.read(array.data.data(), dataSize)) {
+        SPDLOG_ERROR("File: {} contains less data than declared by shape: {}", path, shape);
+        return StatusCode::WARMUP_DATA_INVALID;
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,57 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#include "modelconfig.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Array read from file in numpy .npy format
+ */
+struct NpyArray {
+    InferenceEngine::Precision precision;
+    shape_t shape;
+    std::vector<char> data;
+};
+
+/**
+ * @brief Reads .npy file with C ordered little endian array of numeric type
+ *
+ * @param path
+ * @param array
+ *
+ * @return status
+ */
+Status readNpyFile(const std::string& path, NpyArray& array);
+
+/**
+ * @brief Writes array to .npy file in format version 1.0, C ordered and little endian
+ *
+ * @param path
+ * @param array
+ *
+ * @return status
+ */
+Status writeNpyFile(const std::string& path, const NpyArray& array);
+
+}  // namespace ovms
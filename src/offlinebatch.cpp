@@ -0,0 +1,288 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "offlinebatch.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "modelinstance.hpp"
+#include "modelinstanceunloadguard.hpp"
+#include "pipeline.hpp"
+#include "prediction_service_utils.hpp"
+#include "tensorinfo.hpp"
+#include "workstealingexecutor.hpp"
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace ovms {
+
+namespace {
+const std::vector<InferenceEngine::Precision> NPY_PRECISIONS = {
+    InferenceEngine::Precision::FP32,
+    InferenceEngine::Precision::FP16,
+    InferenceEngine::Precision::I32,
+    InferenceEngine::Precision::I64,
+    InferenceEngine::Precision::I16,
+    InferenceEngine::Precision::U16,
+    InferenceEngine::Precision::I8,
+    InferenceEngine::Precision::U8,
+};
+
+template <typename T, typename Values>
+void copyValues(const Values& values, std::vector<char>& data) {
+    data.resize(values.size() * sizeof(T));
+    T* destination = reinterpret_cast<T*>(data.data());
+    for (int i = 0; i < values.size(); i++) {
+        destination[i] = static_cast<T>(values.Get(i));
+    }
+}
+
+struct Sample {
+    std::string name;
+    PredictRequest request;
+    PredictResponse response;
+    std::unique_ptr<Pipeline> pipeline;
+};
+
+Status readSample(const std::filesystem::path& directory, const std::string& name, PredictRequest& request) {
+    request.mutable_model_spec()->set_name(name);
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".npy") {
+            continue;
+        }
+        NpyArray array;
+        auto status = readNpyFile(entry.path().string(), array);
+        if (!status.ok()) {
+            return status;
+        }
+        npyArrayToTensorProto(array, (*request.mutable_inputs())[entry.path().stem().string()]);
+    }
+    if (ec) {
+        SPDLOG_ERROR("Cannot list sample directory: {}; error: {}", directory.string(), ec.message());
+        return StatusCode::PATH_INVALID;
+    }
+    return StatusCode::OK;
+}
+
+Status writeSampleOutputs(const std::filesystem::path& directory, const PredictResponse& response) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        SPDLOG_ERROR("Cannot create output directory: {}; error: {}", directory.string(), ec.message());
+        return StatusCode::PATH_INVALID;
+    }
+    for (const auto& [name, output] : response.outputs()) {
+        NpyArray array;
+        auto status = tensorProtoToNpyArray(output, array);
+        if (!status.ok()) {
+            SPDLOG_ERROR("Output: {} cannot be written in npy format", name);
+            return status;
+        }
+        status = writeNpyFile((directory / (name + ".npy")).string(), array);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return StatusCode::OK;
+}
+
+/**
+ * @brief Keeps up to concurrency samples in progress and records the first failure
+ */
+class OfflineBatchProgress {
+    std::mutex mtx;
+    std::condition_variable cv;
+    const size_t concurrency;
+    size_t inProgress = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    Status firstFailure = StatusCode::OK;
+
+public:
+    explicit OfflineBatchProgress(size_t concurrency) :
+        concurrency(concurrency) {}
+
+    void waitForSlot() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return inProgress < concurrency; });
+        ++inProgress;
+    }
+
+    void finished(const std::string& sampleName, const Status& status) {
+        if (!status.ok()) {
+            SPDLOG_ERROR("Sample: {} failed: {}", sampleName, status.string());
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        --inProgress;
+        if (status.ok()) {
+            ++succeeded;
+        } else if (failed++ == 0) {
+            firstFailure = status;
+        }
+        cv.notify_all();
+    }
+
+    Status waitForAll() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return inProgress == 0; });
+        SPDLOG_INFO("Offline batch inference finished, samples succeeded: {}; failed: {}", succeeded, failed);
+        return firstFailure;
+    }
+};
+}  // namespace
+
+void npyArrayToTensorProto(const NpyArray& array, tensorflow::TensorProto& proto) {
+    proto.set_dtype(TensorInfo::getPrecisionAsDataType(array.precision));
+    proto.mutable_tensor_shape()->clear_dim();
+    for (auto dim : array.shape) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    if (array.precision == InferenceEngine::Precision::FP16 || array.precision == InferenceEngine::Precision::U16) {
+        const uint16_t* values = reinterpret_cast<const uint16_t*>(array.data.data());
+        const size_t count = array.data.size() / sizeof(uint16_t);
+        for (size_t i = 0; i < count; i++) {
+            if (array.precision == InferenceEngine::Precision::FP16) {
+                proto.add_half_val(values[i]);
+            } else {
+                proto.add_int_val(values[i]);
+            }
+        }
+    } else {
+        proto.set_tensor_content(array.data.data(), array.data.size());
+    }
+}
+
+Status tensorProtoToNpyArray(const tensorflow::TensorProto& proto, NpyArray& array) {
+    auto precision = std::find_if(NPY_PRECISIONS.begin(), NPY_PRECISIONS.end(),
+        [&proto](InferenceEngine::Precision precision) { return TensorInfo::getPrecisionAsDataType(precision) == proto.dtype(); });
+    if (precision == NPY_PRECISIONS.end()) {
+        return StatusCode::INVALID_PRECISION;
+    }
+    array.precision = *precision;
+    array.shape.clear();
+    for (const auto& dim : proto.tensor_shape().dim()) {
+        array.shape.push_back(dim.size());
+    }
+    if (!proto.tensor_content().empty()) {
+        array.data.assign(proto.tensor_content().begin(), proto.tensor_content().end());
+        return StatusCode::OK;
+    }
+    switch (array.precision) {
+    case InferenceEngine::Precision::FP32:
+        copyValues<float>(proto.float_val(), array.data);
+        break;
+    case InferenceEngine::Precision::FP16:
+        copyValues<uint16_t>(proto.half_val(), array.data);
+        break;
+    case InferenceEngine::Precision::I64:
+        copyValues<int64_t>(proto.int64_val(), array.data);
+        break;
+    case InferenceEngine::Precision::I32:
+        copyValues<int32_t>(proto.int_val(), array.data);
+        break;
+    case InferenceEngine::Precision::I16:
+        copyValues<int16_t>(proto.int_val(), array.data);
+        break;
+    case InferenceEngine::Precision::U16:
+        copyValues<uint16_t>(proto.int_val(), array.data);
+        break;
+    case InferenceEngine::Precision::I8:
+        copyValues<int8_t>(proto.int_val(), array.data);
+        break;
+    default:
+        copyValues<uint8_t>(proto.int_val(), array.data);
+        break;
+    }
+    return StatusCode::OK;
+}
+
+Status runOfflineBatchInference(ModelManager& manager, const OfflineBatchOptions& options) {
+    std::error_code ec;
+    std::vector<std::string> sampleNames;
+    for (const auto& entry : std::filesystem::directory_iterator(options.inputDir, ec)) {
+        if (entry.is_directory()) {
+            sampleNames.push_back(entry.path().filename().string());
+        }
+    }
+    if (ec) {
+        SPDLOG_ERROR("Cannot list batch input directory: {}; error: {}", options.inputDir, ec.message());
+        return StatusCode::PATH_INVALID;
+    }
+    std::sort(sampleNames.begin(), sampleNames.end());
+
+    size_t concurrency = options.concurrency;
+    if (concurrency == 0) {
+        auto modelInstance = manager.findModelInstance(options.name);
+        concurrency = modelInstance ? modelInstance->getInferRequestsQueue().size() : std::thread::hardware_concurrency();
+    }
+    concurrency = std::max<size_t>(1, concurrency);
+    SPDLOG_INFO("Offline batch inference of {} samples with: {}; samples in progress: {}", sampleNames.size(), options.name, concurrency);
+
+    OfflineBatchProgress progress(concurrency);
+    const std::filesystem::path outputDir(options.outputDir);
+    for (const auto& sampleName : sampleNames) {
+        // next sample is read while previous ones are inferred
+        auto sample = std::make_shared<Sample>();
+        sample->name = sampleName;
+        auto status = readSample(std::filesystem::path(options.inputDir) / sampleName, options.name, sample->request);
+        progress.waitForSlot();
+        if (!status.ok()) {
+            progress.finished(sampleName, status);
+            continue;
+        }
+        auto onComplete = [sample, &progress, &outputDir](const Status& status) {
+            // outputs are written by executor worker instead of thread completing inference
+            WorkStealingExecutor::getInstance().schedule([sample, &progress, &outputDir, status]() {
+                sample->pipeline.reset();
+                auto result = status.ok() ? writeSampleOutputs(outputDir / sample->name, sample->response) : status;
+                progress.finished(sample->name, result);
+            });
+        };
+        std::shared_ptr<ModelInstance> modelInstance;
+        std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+        status = getModelInstance(manager, options.name, 0, modelInstance, modelInstanceUnloadGuard);
+        if (status == StatusCode::MODEL_NAME_MISSING) {
+            status = getPipeline(manager, sample->pipeline, &sample->request, &sample->response);
+            if (status.ok()) {
+                sample->pipeline->executeAsync(std::move(onComplete));
+                continue;
+            }
+        }
+        if (!status.ok()) {
+            progress.finished(sampleName, status);
+            continue;
+        }
+        const PredictRequest* request = &sample->request;
+        PredictResponse* response = &sample->response;
+        inferenceAsync(std::move(modelInstance), request, response, std::move(modelInstanceUnloadGuard),
+            [](std::function<void()> continuation) { WorkStealingExecutor::getInstance().schedule(std::move(continuation)); },
+            std::move(onComplete));
+    }
+    return progress.waitForAll();
+}
+
+}  // namespace ovms
@@ -0,0 +1,75 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "modelmanager.hpp"
+#include "npyfile.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+struct OfflineBatchOptions {
+    /**
+     * @brief Directory with one subdirectory per sample, holding <input name>.npy file for each input
+     */
+    std::string inputDir;
+
+    /**
+     * @brief Directory where <sample>/<output name>.npy files are written
+     */
+    std::string outputDir;
+
+    /**
+     * @brief Name of model or pipeline, default version of model is used
+     */
+    std::string name;
+
+    /**
+     * @brief Maximum number of samples in progress, 0 for nireq of the model or number of hardware threads for pipelines
+     */
+    size_t concurrency = 0;
+};
+
+/**
+ * @brief Converts array to request input, values of FP16 and U16 precisions are held in 32 bit containers
+ */
+void npyArrayToTensorProto(const NpyArray& array, tensorflow::TensorProto& proto);
+
+/**
+ * @brief Converts response output to array
+ *
+ * @return INVALID_PRECISION for types without npy counterpart
+ */
+Status tensorProtoToNpyArray(const tensorflow::TensorProto& proto, NpyArray& array);
+
+/**
+ * @brief Runs all samples of input directory through model or pipeline served by manager and writes their outputs, without RPC
+ *
+ * Samples are read ahead while up to concurrency of them are inferred, outputs are written by shared executor workers,
+ * so that infer requests are kept busy. Failed samples are logged and skipped.
+ *
+ * @return status of the first failed sample, OK if all succeeded
+ */
+Status runOfflineBatchInference(ModelManager& manager, const OfflineBatchOptions& options);
+
+}  // namespace ovms
@@ -15,13 +15,34 @@
 //*****************************************************************************
 #include "ov_utils.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <utility>
+
+#include "tensorbufferpool.hpp"
 
 namespace ovms {
 
+namespace {
+template <typename T>
+class ExternalMemoryBlob : public InferenceEngine::TBlob<T> {
+    std::shared_ptr<const void> owner;
+
+public:
+    ExternalMemoryBlob(const InferenceEngine::TensorDesc& desc, std::shared_ptr<const void> owner, const char* data) :
+        InferenceEngine::TBlob<T>(desc, const_cast<T*>(reinterpret_cast<const T*>(data))),
+        owner(std::move(owner)) {}
+};
+
+template <typename T>
+InferenceEngine::Blob::Ptr makeExternalMemoryBlob(const InferenceEngine::TensorDesc& desc, std::shared_ptr<const void> owner, const char* data) {
+    return std::make_shared<ExternalMemoryBlob<T>>(desc, std::move(owner), data);
+}
+}  // namespace
+
 InferenceEngine::Blob::Ptr blobClone(const InferenceEngine::Blob::Ptr sourceBlob) {
-    auto copyBlob = InferenceEngine::Blob::CreateFromData(std::make_shared<InferenceEngine::Data>("", sourceBlob->getTensorDesc()));
-    copyBlob->allocate();
+    auto copyBlob = createPooledBlob(sourceBlob->getTensorDesc());
     if (copyBlob->byteSize() != sourceBlob->byteSize()) {
         return nullptr;
     }
@@ -29,4 +50,47 @@ InferenceEngine::Blob::Ptr blobClone(const InferenceEngine::Blob::Ptr sourceBlob
     return copyBlob;
 }
 
+InferenceEngine::Blob::Ptr createZeroBlob(const InferenceEngine::TensorDesc& desc) {
+    auto blob = createPooledBlob(desc);
+    if (blob->byteSize() > 0) {
+        std::memset((void*)blob->buffer(), 0, blob->byteSize());
+    }
+    return blob;
+}
+
+InferenceEngine::Blob::Ptr createExternalMemoryBlob(const InferenceEngine::TensorDesc& desc, std::shared_ptr<const void> owner, const char* data) {
+    switch (desc.getPrecision()) {
+    case InferenceEngine::Precision::FP32:
+        return makeExternalMemoryBlob<float>(desc, std::move(owner), data);
+    case InferenceEngine::Precision::FP16:
+    case InferenceEngine::Precision::U16:
+        return makeExternalMemoryBlob<uint16_t>(desc, std::move(owner), data);
+    case InferenceEngine::Precision::I16:
+        return makeExternalMemoryBlob<int16_t>(desc, std::move(owner), data);
+    case InferenceEngine::Precision::U8:
+        return makeExternalMemoryBlob<uint8_t>(desc, std::move(owner), data);
+    case InferenceEngine::Precision::I8:
+        return makeExternalMemoryBlob<int8_t>(desc, std::move(owner), data);
+    case InferenceEngine::Precision::I32:
+        return makeExternalMemoryBlob<int32_t>(desc, std::move(owner), data);
+    case InferenceEngine::Precision::I64:
+        return makeExternalMemoryBlob<int64_t>(desc, std::move(owner), data);
+    default:
+        return nullptr;
+    }
+}
+
+InferenceEngine::StatusCode waitForInferRequest(InferenceEngine::InferRequest& inferRequest, std::chrono::microseconds spinTime) {
+    if (spinTime.count() > 0) {
+        const auto spinEnd = std::chrono::steady_clock::now() + spinTime;
+        do {
+            auto sts = inferRequest.Wait(InferenceEngine::IInferRequest::STATUS_ONLY);
+            if (sts != InferenceEngine::StatusCode::RESULT_NOT_READY) {
+                return sts;
+            }
+        } while (std::chrono::steady_clock::now() < spinEnd);
+    }
+    return inferRequest.Wait(InferenceEngine::IInferRequest::RESULT_READY);
+}
+
 }  // namespace ovms
@@ -15,10 +15,35 @@
 //*****************************************************************************
 #pragma once
 
+#include <chrono>
+#include <memory>
+
 #include <inference_engine.hpp>
 
 namespace ovms {
 
 InferenceEngine::Blob::Ptr blobClone(const InferenceEngine::Blob::Ptr sourceBlob);
 
+/**
+ * @brief Creates blob with allocated, zero filled memory
+ */
+InferenceEngine::Blob::Ptr createZeroBlob(const InferenceEngine::TensorDesc& desc);
+
+/**
+ * @brief Creates blob pointing to memory it does not own, e.g. mapped shared memory or cached tensor.
+ * Owner of the memory is kept alive as long as infer request or pipeline node holds the blob.
+ *
+ * Values are expected in native width of precision, FP16 as 16 bit words, so no conversion is needed.
+ *
+ * @return nullptr if precision is not supported
+ */
+InferenceEngine::Blob::Ptr createExternalMemoryBlob(const InferenceEngine::TensorDesc& desc, std::shared_ptr<const void> owner, const char* data);
+
+/**
+ * @brief Waits for result of started infer request, polling its status for up to spinTime before blocking
+ *
+ * Spinning keeps calling thread awake, so that completion is observed without wake up latency at the cost of CPU time.
+ */
+InferenceEngine::StatusCode waitForInferRequest(InferenceEngine::InferRequest& inferRequest, std::chrono::microseconds spinTime);
+
 }  // namespace ovms
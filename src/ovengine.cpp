@@ -0,0 +1,67 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "ovengine.hpp"
+
+#include <chrono>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+#include "timer.hpp"
+
+namespace ovms {
+
+std::shared_ptr<InferenceEngine::Core> getSharedOVEngine() {
+    static std::shared_ptr<InferenceEngine::Core> sharedEngine = std::make_shared<InferenceEngine::Core>();
+    return sharedEngine;
+}
+
+std::set<std::string> getTargetDevicePlugins(const std::string& targetDevice) {
+    std::set<std::string> plugins;
+    std::string devices = targetDevice;
+    auto separator = targetDevice.find(':');
+    if (separator != std::string::npos) {
+        plugins.insert(targetDevice.substr(0, separator));
+        devices = targetDevice.substr(separator + 1);
+    }
+    std::stringstream ss(devices);
+    std::string device;
+    while (std::getline(ss, device, ',')) {
+        // device id and number of requests of MULTI device, e.g. GPU.1(4)
+        device = device.substr(0, device.find_first_of(".("));
+        if (!device.empty()) {
+            plugins.insert(device);
+        }
+    }
+    return plugins;
+}
+
+void warmUpDevicePlugins(InferenceEngine::Core& engine, const std::set<std::string>& plugins) {
+    for (const auto& plugin : plugins) {
+        Timer timer;
+        timer.start("warm up");
+        try {
+            engine.GetVersions(plugin);
+        } catch (const std::exception& e) {
+            SPDLOG_DEBUG("Device plugin {} warm up failed: {}", plugin, e.what());
+            continue;
+        }
+        timer.stop("warm up");
+        SPDLOG_DEBUG("Device plugin {} initialized in {:.3f} ms", plugin, timer.elapsed<std::chrono::microseconds>("warm up") / 1000);
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,45 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Gets Inference Engine Core shared by all model instances
+ *
+ * Core is created on first call and kept until process exit, also when no model is loaded, so that device plugins
+ * are initialized once. Instances hold a reference, so that Core outlives their networks destroyed during exit.
+ */
+std::shared_ptr<InferenceEngine::Core> getSharedOVEngine();
+
+/**
+ * @brief Gets names of device plugins used by target device, e.g. MULTI, CPU and GPU for MULTI:CPU,GPU.1
+ */
+std::set<std::string> getTargetDevicePlugins(const std::string& targetDevice);
+
+/**
+ * @brief Loads and initializes device plugins in Core, so that first network loaded to them does not pay for plugin discovery.
+ * Plugins which fail to initialize are skipped, their error is reported once network is loaded.
+ */
+void warmUpDevicePlugins(InferenceEngine::Core& engine, const std::set<std::string>& plugins);
+
+}  // namespace ovms
@@ -13,46 +13,541 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
-
 #include "ovinferrequestsqueue.hpp"
 
+#include <algorithm>
+#include <thread>
 #include <utility>
 
+#include <sched.h>
+
+#include "cpuaffinity.hpp"
+
 namespace ovms {
+namespace {
+/**
+* @brief Waiter fulfilling promise, used for getIdleStream compatibility. Frees itself once notified
+*/
+class PromiseIdleStreamWaiter : public IdleStreamWaiter {
+public:
+    std::promise<int> promise;
+
+protected:
+    void notifyIdleStream(int streamId) override {
+        promise.set_value(streamId);
+        delete this;
+    }
+
+    void notifyDeadlineExceeded() override {
+        // never called since waiter is registered without deadline
+        promise.set_value(-1);
+        delete this;
+    }
+
+    void notifyCancelled() override {
+        // never called since waiter is registered without cancellation flag
+        promise.set_value(-1);
+        delete this;
+    }
+};
+
+// adaptive pool grows when requests waited for idle stream this long on average
+const uint64_t POOL_GROW_WAIT_TIME_MICROSECONDS = 1000;
+const auto POOL_GROW_INTERVAL = std::chrono::milliseconds(100);
+// and shrinks when no request had to wait for idle stream for this long
+const auto POOL_SHRINK_IDLE_TIME = std::chrono::seconds(10);
+const auto POOL_SHRINK_INTERVAL = std::chrono::seconds(1);
+
+int64_t ticks(const std::chrono::steady_clock::time_point& time) {
+    return time.time_since_epoch().count();
+}
+
+size_t ringSizeFor(int streamsLength) {
+    size_t size = 1;
+    while (size < static_cast<size_t>(streamsLength)) {
+        size <<= 1;
+    }
+    return size;
+}
+}  // namespace
+
+OVInferRequestsQueue::IdleStreamsRing::IdleStreamsRing(int streamsLength) :
+    cells(new Cell[ringSizeFor(streamsLength)]),
+    cellsMask(ringSizeFor(streamsLength) - 1) {
+    for (size_t i = 0; i <= cellsMask; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+OVInferRequestsQueue::OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength) :
+    OVInferRequestsQueue({{&network, streamsLength}}) {}
+
+OVInferRequestsQueue::OVInferRequestsQueue(const std::vector<std::pair<InferenceEngine::ExecutableNetwork*, int>>& networks,
+    const std::vector<std::vector<int>>& devicesCpus) :
+    deviceLatencyEstimates(new std::atomic<uint64_t>[networks.size()]) {
+    for (size_t device = 0; device < devicesCpus.size() && networks.size() > 1; ++device) {
+        for (auto cpu : devicesCpus[device]) {
+            if (cpu >= static_cast<int>(cpuDevices.size())) {
+                cpuDevices.resize(cpu + 1, -1);
+            }
+            cpuDevices[cpu] = static_cast<int>(device);
+        }
+    }
+    for (size_t device = 0; device < networks.size(); ++device) {
+        const auto& [network, streamsLength] = networks[device];
+        rings.push_back(std::make_unique<IdleStreamsRing>(streamsLength));
+        deviceLatencyEstimates[device].store(0, std::memory_order_relaxed);
+        CpuAffinityGuard cpuAffinityGuard(device < devicesCpus.size() ? devicesCpus[device] : std::vector<int>{});
+        for (int i = 0; i < streamsLength; ++i) {
+            const int streamId = static_cast<int>(inferRequests.size());
+            streamDevices.push_back(device);
+            inferRequests.push_back(network->CreateInferRequest());
+            rings.back()->push(streamId);
+        }
+    }
+    streamTakenTimes.resize(inferRequests.size());
+    activeStreamsCount.store(inferRequests.size(), std::memory_order_relaxed);
+}
+
+OVInferRequestsQueue::OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength, int maxStreamsLength) :
+    deviceLatencyEstimates(new std::atomic<uint64_t>[1]) {
+    // all slots are allocated upfront so that InferRequests are never moved while used by other threads
+    const int slotsCount = std::max(streamsLength, maxStreamsLength);
+    rings.push_back(std::make_unique<IdleStreamsRing>(slotsCount));
+    deviceLatencyEstimates[0].store(0, std::memory_order_relaxed);
+    streamDevices.resize(slotsCount, 0);
+    streamTakenTimes.resize(slotsCount);
+    inferRequests.resize(slotsCount);
+    releasedStreams.resize(slotsCount, true);
+    for (int streamId = 0; streamId < streamsLength; ++streamId) {
+        inferRequests[streamId] = network.CreateInferRequest();
+        releasedStreams[streamId] = false;
+        rings.back()->push(streamId);
+    }
+    // parked streams are taken from the back, lowest ids first
+    for (int streamId = slotsCount - 1; streamId >= streamsLength; --streamId) {
+        parkedStreams.push_back(streamId);
+    }
+    activeStreamsCount.store(streamsLength, std::memory_order_relaxed);
+    if (slotsCount > streamsLength) {
+        adaptiveNetwork = &network;
+        minStreams = streamsLength;
+        const auto now = std::chrono::steady_clock::now();
+        lastAdjustmentTicks.store(ticks(now), std::memory_order_relaxed);
+        lastWaitTicks.store(ticks(now), std::memory_order_relaxed);
+    }
+}
+
+OVInferRequestsQueue::~OVInferRequestsQueue() {
+    if (deviceLimiter) {
+        deviceLimiter->unregisterClient(deviceLimiterClientId);
+    }
+}
+
+void OVInferRequestsQueue::setDeviceLimiter(std::shared_ptr<DeviceConcurrencyLimiter> limiter, uint32_t weight) {
+    if (rings.size() != 1 && !latencyDevice) {
+        SPDLOG_WARN("Device concurrency limit is not applied to infer requests pool of multiple devices");
+        return;
+    }
+    deviceLimiterClientId = limiter->registerClient(weight, [this]() { dispatchToWaiters(); });
+    deviceLimiter = std::move(limiter);
+}
+
+void OVInferRequestsQueue::setLatencyDevice(size_t device) {
+    if (device < rings.size() && rings.size() > 1) {
+        latencyDevice = device;
+    }
+}
+
+void OVInferRequestsQueue::setInferRequestInitializer(std::function<void(InferenceEngine::InferRequest&)> initializer) {
+    for (size_t streamId = 0; streamId < inferRequests.size(); ++streamId) {
+        if (releasedStreams.empty() || !releasedStreams[streamId]) {
+            initializer(inferRequests[streamId]);
+        }
+    }
+    inferRequestInitializer = std::move(initializer);
+}
+
+void OVInferRequestsQueue::IdleStreamsRing::push(int streamId) {
+    Cell* cell;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells[pos & cellsMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Ring is never full since it is larger than number of streams. Cell is still
+            // being read by consumer which was lapped by other threads, wait for it to finish
+            std::this_thread::yield();
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->streamId = streamId;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+}
+
+std::optional<int> OVInferRequestsQueue::IdleStreamsRing::pop() {
+    Cell* cell;
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells[pos & cellsMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return std::nullopt;  // empty
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    int streamId = cell->streamId;
+    cell->sequence.store(pos + cellsMask + 1, std::memory_order_release);
+    return streamId;
+}
+
+void OVInferRequestsQueue::push(int streamId) {
+    if (rings.size() == 1) {
+        rings.front()->push(streamId);
+        return;
+    }
+    const size_t device = streamDevices[streamId];
+    const auto heldTime = std::chrono::steady_clock::now() - streamTakenTimes[streamId];
+    const uint64_t latency = std::max<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(heldTime).count(), 1);
+    // estimate is updated without synchronization, losing concurrent samples is acceptable
+    auto& estimate = deviceLatencyEstimates[device];
+    const uint64_t previous = estimate.load(std::memory_order_relaxed);
+    estimate.store(previous == 0 ? latency : (previous * 7 + latency) / 8, std::memory_order_relaxed);
+    rings[device]->push(streamId);
+}
+
+std::optional<int> OVInferRequestsQueue::pop(RequestPriority priority) {
+    std::optional<int> streamId;
+    if (rings.size() == 1) {
+        streamId = rings.front()->pop();
+    } else {
+        if (latencyDevice) {
+            streamId = popForPriority(priority);
+        } else if (!cpuDevices.empty()) {
+            streamId = popFromLocalDevice();
+        } else {
+            streamId = popFromFastestDevice();
+        }
+    }
+    if (streamId && deviceLimiter && !deviceLimiter->tryAcquire(deviceLimiterClientId)) {
+        // device is saturated by pools of other models, limiter dispatches to waiters once slot is free
+        rings[streamDevices[streamId.value()]]->push(streamId.value());
+        return std::nullopt;
+    }
+    if (streamId && rings.size() > 1) {
+        streamTakenTimes[streamId.value()] = std::chrono::steady_clock::now();
+    }
+    return streamId;
+}
+
+std::optional<int> OVInferRequestsQueue::popFromFastestDevice() {
+    for (;;) {
+        IdleStreamsRing* fastestRing = nullptr;
+        uint64_t fastestLatency = 0;
+        for (size_t device = 0; device < rings.size(); ++device) {
+            if (rings[device]->size() == 0) {
+                continue;
+            }
+            // devices not measured yet have estimate 0 and are tried first
+            const uint64_t latency = deviceLatencyEstimates[device].load(std::memory_order_relaxed);
+            if (fastestRing == nullptr || latency < fastestLatency) {
+                fastestRing = rings[device].get();
+                fastestLatency = latency;
+            }
+        }
+        if (fastestRing == nullptr) {
+            return std::nullopt;
+        }
+        auto streamId = fastestRing->pop();
+        if (streamId) {
+            return streamId;
+        }
+        // stream was taken by other thread in the meantime, pick again
+    }
+}
+
+std::optional<int> OVInferRequestsQueue::popFromLocalDevice() {
+    const int cpu = sched_getcpu();
+    if (cpu >= 0 && cpu < static_cast<int>(cpuDevices.size()) && cpuDevices[cpu] >= 0) {
+        auto streamId = rings[cpuDevices[cpu]]->pop();
+        if (streamId) {
+            return streamId;
+        }
+    }
+    // streams of remote devices are taken only once local ones are busy
+    return popFromFastestDevice();
+}
+
+std::optional<int> OVInferRequestsQueue::popForPriority(RequestPriority priority) {
+    auto& latencyRing = *rings[latencyDevice.value()];
+    if (priority == RequestPriority::HIGH) {
+        auto streamId = latencyRing.pop();
+        if (streamId) {
+            return streamId;
+        }
+    }
+    for (size_t device = 0; device < rings.size(); ++device) {
+        if (device == latencyDevice.value()) {
+            continue;
+        }
+        auto streamId = rings[device]->pop();
+        if (streamId) {
+            return streamId;
+        }
+    }
+    // requests of normal priority overflow to network reserved for latency once others are busy
+    if (priority == RequestPriority::NORMAL) {
+        return latencyRing.pop();
+    }
+    return std::nullopt;
+}
+
+std::optional<int> OVInferRequestsQueue::tryGetIdleStream(RequestPriority priority) {
+    // do not overtake already waiting callers
+    if (waitersCount.load(std::memory_order_acquire) > 0) {
+        return std::nullopt;
+    }
+    return pop(priority);
+}
+
+bool OVInferRequestsQueue::waitForIdleStream(IdleStreamWaiter& waiter) {
+    {
+        std::unique_lock lock(waitersMtx);
+        const size_t priority = static_cast<size_t>(waiter.options.priority);
+        if (waiter.options.maxQueueSize > 0) {
+            // only waiters which would be served before this one count
+            size_t waitersAhead = 0;
+            for (size_t i = 0; i <= priority; ++i) {
+                waitersAhead += priorityWaitersCounts[i];
+            }
+            if (waitersAhead >= waiter.options.maxQueueSize) {
+                return false;
+            }
+        }
+        waiter.waiting = true;
+        if (adaptiveNetwork) {
+            waiter.registeredTime = std::chrono::steady_clock::now();
+            lastWaitTicks.store(ticks(waiter.registeredTime), std::memory_order_relaxed);
+        }
+        waiter.next = nullptr;
+        waiter.prev = waitersTails[priority];
+        if (waitersTails[priority]) {
+            waitersTails[priority]->next = &waiter;
+        } else {
+            waitersHeads[priority] = &waiter;
+        }
+        waitersTails[priority] = &waiter;
+        priorityWaitersCounts[priority]++;
+        waitersCount.fetch_add(1, std::memory_order_seq_cst);
+    }
+    // stream could be returned before waiter was visible to returning thread
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    dispatchToWaiters();
+    if (adaptiveNetwork) {
+        growIfWaitingTooLong();
+    }
+    return true;
+}
+
+int OVInferRequestsQueue::waitForIdleStream() {
+    auto streamId = tryGetIdleStream();
+    if (streamId) {
+        return streamId.value();
+    }
+    BlockingIdleStreamWaiter waiter;
+    waitForIdleStream(waiter);
+    return waiter.wait();
+}
+
 std::future<int> OVInferRequestsQueue::getIdleStream() {
-    int value;
-    std::promise<int> idleStreamPromise;
-    std::future<int> idleStreamFuture = idleStreamPromise.get_future();
-    std::unique_lock<std::mutex> lk(front_mut);
-    if (streams[front_idx] < 0) {  // we need to wait for any idle stream to be returned
-        std::unique_lock<std::mutex> queueLock(queue_mutex);
-        promises.push(std::move(idleStreamPromise));
-    } else {  // we can give idle stream right away
-        value = streams[front_idx];
-        streams[front_idx] = -1;  // negative value indicate consumed vector index
-        front_idx = (front_idx + 1) % streams.size();
-        lk.unlock();
-        idleStreamPromise.set_value(value);
-    }
-    return std::move(idleStreamFuture);
+    auto streamId = tryGetIdleStream();
+    if (streamId) {
+        std::promise<int> idleStreamPromise;
+        idleStreamPromise.set_value(streamId.value());
+        return idleStreamPromise.get_future();
+    }
+    auto waiter = new PromiseIdleStreamWaiter();
+    auto idleStreamFuture = waiter->promise.get_future();
+    waitForIdleStream(*waiter);
+    return idleStreamFuture;
 }
 
-void OVInferRequestsQueue::returnStream(int streamID) {
-    std::unique_lock<std::mutex> lk(queue_mutex);
-    if (promises.size()) {
-        std::promise<int> promise = std::move(promises.front());
-        promises.pop();
-        lk.unlock();
-        promise.set_value(streamID);
+void OVInferRequestsQueue::unlinkWaiter(IdleStreamWaiter& waiter) {
+    const size_t priority = static_cast<size_t>(waiter.options.priority);
+    if (waiter.prev) {
+        waiter.prev->next = waiter.next;
+    } else {
+        waitersHeads[priority] = waiter.next;
+    }
+    if (waiter.next) {
+        waiter.next->prev = waiter.prev;
+    } else {
+        waitersTails[priority] = waiter.prev;
+    }
+    waiter.prev = waiter.next = nullptr;
+    waiter.waiting = false;
+    priorityWaitersCounts[priority]--;
+    waitersCount.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+bool OVInferRequestsQueue::cancelWaiting(IdleStreamWaiter& waiter) {
+    std::unique_lock lock(waitersMtx);
+    if (!waiter.waiting) {
+        return false;
+    }
+    unlinkWaiter(waiter);
+    return true;
+}
+
+void OVInferRequestsQueue::dispatchToWaiters() {
+    std::unique_lock lock(waitersMtx);
+    // waiters of the same priority usually share timeout, so expired ones are at the front of the list
+    const auto now = std::chrono::steady_clock::now();
+    auto dropHeads = [this, &now](IdleStreamWaiter*& head) {
+        while (head) {
+            IdleStreamWaiter* waiter = head;
+            if (waiter->options.isCancelled()) {
+                unlinkWaiter(*waiter);
+                waiter->notifyCancelled();
+            } else if (waiter->options.isExpired(now)) {
+                unlinkWaiter(*waiter);
+                waiter->notifyDeadlineExceeded();
+            } else {
+                return;
+            }
+        }
+    };
+    for (auto& head : waitersHeads) {
+        dropHeads(head);
+    }
+    for (;;) {
+        IdleStreamWaiter* waiter = nullptr;
+        for (auto& head : waitersHeads) {
+            // client may have cancelled waiter which became head after previous assignment
+            dropHeads(head);
+            if (head) {
+                waiter = head;
+                break;
+            }
+        }
+        if (!waiter) {
+            return;
+        }
+        auto streamId = pop(waiter->options.priority);
+        if (!streamId) {
+            return;
+        }
+        unlinkWaiter(*waiter);
+        if (adaptiveNetwork) {
+            // estimate is updated without synchronization, losing concurrent samples is acceptable
+            const uint64_t waitTime = std::chrono::duration_cast<std::chrono::microseconds>(now - waiter->registeredTime).count();
+            const uint64_t previous = waitTimeEstimate.load(std::memory_order_relaxed);
+            waitTimeEstimate.store((previous * 7 + waitTime) / 8, std::memory_order_relaxed);
+        }
+        waiter->notifyIdleStream(streamId.value());
+    }
+}
+
+bool OVInferRequestsQueue::tryStartAdjustment(const std::chrono::steady_clock::time_point& now, std::chrono::steady_clock::duration interval) {
+    int64_t lastAdjustment = lastAdjustmentTicks.load(std::memory_order_relaxed);
+    return ticks(now) - lastAdjustment >= interval.count() &&
+           lastAdjustmentTicks.compare_exchange_strong(lastAdjustment, ticks(now), std::memory_order_relaxed);
+}
+
+void OVInferRequestsQueue::growIfWaitingTooLong() {
+    const uint64_t waitTime = waitTimeEstimate.load(std::memory_order_relaxed);
+    if (waitTime < POOL_GROW_WAIT_TIME_MICROSECONDS || waitersCount.load(std::memory_order_relaxed) == 0 ||
+        !tryStartAdjustment(std::chrono::steady_clock::now(), POOL_GROW_INTERVAL)) {
         return;
     }
-    std::uint32_t old_back = back_idx.load();
-    while (!back_idx.compare_exchange_weak(
-        old_back,
-        (old_back + 1) % streams.size(),
-        std::memory_order_relaxed)) {
+    int streamId;
+    bool released;
+    {
+        std::unique_lock<std::mutex> lock(parkedStreamsMtx);
+        if (parkedStreams.empty()) {
+            return;
+        }
+        streamId = parkedStreams.back();
+        parkedStreams.pop_back();
+        released = releasedStreams[streamId];
+    }
+    if (released) {
+        try {
+            inferRequests[streamId] = adaptiveNetwork->CreateInferRequest();
+            if (inferRequestInitializer) {
+                inferRequestInitializer(inferRequests[streamId]);
+            }
+        } catch (const InferenceEngine::details::InferenceEngineException& e) {
+            SPDLOG_WARN("Failed to add infer request to pool: {}", e.what());
+            std::unique_lock<std::mutex> lock(parkedStreamsMtx);
+            parkedStreams.push_back(streamId);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(parkedStreamsMtx);
+        releasedStreams[streamId] = false;
+    }
+    activeStreamsCount.fetch_add(1, std::memory_order_relaxed);
+    SPDLOG_DEBUG("Added infer request to pool since requests waited {} us on average, infer requests: {}", waitTime, size());
+    pushIdleStream(streamId);
+}
+
+bool OVInferRequestsQueue::shrinkIfIdle(int streamId) {
+    if (activeStreamsCount.load(std::memory_order_relaxed) <= minStreams || waitersCount.load(std::memory_order_relaxed) > 0) {
+        return false;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (ticks(now) - lastWaitTicks.load(std::memory_order_relaxed) < std::chrono::duration_cast<std::chrono::steady_clock::duration>(POOL_SHRINK_IDLE_TIME).count() ||
+        !tryStartAdjustment(now, POOL_SHRINK_INTERVAL)) {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(parkedStreamsMtx);
+        // stream may be returned from its own completion callback, so its InferRequest is released on next adjustment
+        for (int parkedStreamId : parkedStreams) {
+            if (!releasedStreams[parkedStreamId]) {
+                inferRequests[parkedStreamId] = InferenceEngine::InferRequest();
+                releasedStreams[parkedStreamId] = true;
+            }
+        }
+        parkedStreams.push_back(streamId);
+    }
+    waitTimeEstimate.store(0, std::memory_order_relaxed);
+    activeStreamsCount.fetch_sub(1, std::memory_order_relaxed);
+    SPDLOG_DEBUG("Removed idle infer request from pool, infer requests: {}", size());
+    return true;
+}
+
+void OVInferRequestsQueue::pushIdleStream(int streamID) {
+    if (adaptiveNetwork && shrinkIfIdle(streamID)) {
+        return;
+    }
+    push(streamID);
+    // pairs with fence in waitForIdleStream so that either waiter sees returned stream or we see the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waitersCount.load(std::memory_order_relaxed) > 0) {
+        dispatchToWaiters();
+    }
+}
+
+void OVInferRequestsQueue::returnStream(int streamID) {
+    pushIdleStream(streamID);
+    // slot is returned after stream, so that own waiters denied above compete for it with waiters of other pools
+    if (deviceLimiter) {
+        deviceLimiter->release();
     }
-    streams[old_back] = streamID;
 }
 
 }  // namespace ovms
@@ -16,27 +16,242 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
 
+#include "deviceconcurrencylimiter.hpp"
+#include "lockmetrics.hpp"
+
 namespace ovms {
+class OVInferRequestsQueue;
+class RequestTrace;
+
+/**
+* @brief Priority class of request waiting for idle stream, waiters of higher class are always served first
+*/
+enum class RequestPriority {
+    HIGH,
+    NORMAL,
+    LOW
+};
+
+const size_t REQUEST_PRIORITIES_COUNT = 3;
+
 /**
-* @brief Class representing circular buffer for managing IE streams
+* @brief Admission policy of request waiting for idle stream
+*/
+struct StreamWaitingOptions {
+    RequestPriority priority = RequestPriority::NORMAL;
+
+    /**
+    * @brief Time after which request is dropped from waiters list instead of being assigned a stream
+    */
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+    /**
+    * @brief Request is rejected when this many requests of the same or higher priority are already waiting, 0 for no limit
+    */
+    size_t maxQueueSize = 0;
+
+    /**
+    * @brief Flag set by the caller once client gave up on request, waiter is then dropped instead of being assigned a stream
+    */
+    const std::atomic<bool>* cancelled = nullptr;
+
+    /**
+    * @brief Trace which waiting and inference steps of the request are recorded in, nullptr if request is not traced
+    */
+    RequestTrace* trace = nullptr;
+
+    /**
+    * @brief Size of request body buffered by the caller until request completes, counted in in flight memory budget
+    */
+    size_t bufferedRequestBytes = 0;
+
+    bool isCancelled() const {
+        return cancelled && cancelled->load(std::memory_order_relaxed);
+    }
+
+    bool isExpired(const std::chrono::steady_clock::time_point& now = std::chrono::steady_clock::now()) const {
+        return deadline <= now;
+    }
+};
+
+/**
+* @brief Entry of waiters list used when there is no idle stream available.
+*
+* Waiter is owned by the caller (usually placed on stack or in stream id guard) so that
+* registering it does not allocate. Queue calls notifyIdleStream exactly once with assigned stream id,
+* notifyDeadlineExceeded once the deadline passed or notifyCancelled once cancelled flag of options was set,
+* unless waiting is cancelled with cancelWaiting before.
+*/
+class IdleStreamWaiter {
+    friend class OVInferRequestsQueue;
+
+    IdleStreamWaiter* prev = nullptr;
+    IdleStreamWaiter* next = nullptr;
+    bool waiting = false;
+    std::chrono::steady_clock::time_point registeredTime;
+
+protected:
+    StreamWaitingOptions options;
+
+    /**
+    * @brief Called by the queue with stream assigned to this waiter. Called with queue waiters list lock held
+    */
+    virtual void notifyIdleStream(int streamId) = 0;
+
+    /**
+    * @brief Called by the queue when deadline of waiter passed before stream was assigned. Called with queue waiters list lock held
+    */
+    virtual void notifyDeadlineExceeded() = 0;
+
+    /**
+    * @brief Called by the queue when request was cancelled by the client before stream was assigned. Called with queue waiters list lock held
+    */
+    virtual void notifyCancelled() = 0;
+
+public:
+    virtual ~IdleStreamWaiter() = default;
+
+    /**
+    * @brief Sets priority and deadline, must be called before waiter is registered
+    */
+    void setOptions(const StreamWaitingOptions& options) {
+        this->options = options;
+    }
+};
+
+/**
+* @brief Waiter allowing calling thread to block until stream is assigned.
+* Optional callback is invoked from thread returning the stream, right after assignment.
+*/
+class BlockingIdleStreamWaiter : public IdleStreamWaiter {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::optional<int> streamId = std::nullopt;
+    bool deadlineExceeded = false;
+    const std::function<void()> onStreamAssigned;
+
+protected:
+    void notifyIdleStream(int streamId) override {
+        // notify under lock since waiting thread may destroy waiter right after wake up
+        std::unique_lock<std::mutex> lock(mtx);
+        this->streamId = streamId;
+        if (onStreamAssigned) {
+            onStreamAssigned();
+        }
+        cv.notify_one();
+    }
+
+    void notifyDeadlineExceeded() override {
+        std::unique_lock<std::mutex> lock(mtx);
+        deadlineExceeded = true;
+        cv.notify_one();
+    }
+
+    void notifyCancelled() override {
+        notifyDeadlineExceeded();
+    }
+
+public:
+    BlockingIdleStreamWaiter(std::function<void()> onStreamAssigned = {}) :
+        onStreamAssigned(std::move(onStreamAssigned)) {}
+
+    /**
+    * @brief Waits up to specified time for stream assignment
+    */
+    std::optional<int> waitFor(const std::chrono::microseconds& timeout) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait_for(lock, timeout, [this]() { return streamId.has_value(); });
+        return streamId;
+    }
+
+    /**
+    * @brief Waits until stream is assigned, given time passes or queue reports deadline exceeded or cancellation
+    *
+    * @return stream id or nullopt if it was not assigned
+    */
+    std::optional<int> waitUntil(const std::chrono::steady_clock::time_point& time) {
+        std::unique_lock<std::mutex> lock(mtx);
+        const auto resolved = [this]() { return streamId.has_value() || deadlineExceeded; };
+        if (time == std::chrono::steady_clock::time_point::max()) {
+            cv.wait(lock, resolved);
+        } else {
+            cv.wait_until(lock, time, resolved);
+        }
+        return streamId;
+    }
+
+    /**
+    * @brief Waits until stream is assigned
+    */
+    int wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return streamId.has_value(); });
+        return streamId.value();
+    }
+};
+
+/**
+* @brief Class representing lock-free pool of idle IE streams
+*
+* Idle stream ids are kept in bounded MPMC ring where each cell holds sequence number telling whether
+* it is ready to be written or read in the current lap. Acquiring and returning stream while there are
+* idle ones does not take locks nor allocate. Only when pool is empty caller is linked to waiters list
+* guarded by mutex.
+*
+* Pool may span infer requests of networks loaded on several devices, each with its own ring. Stream is then
+* taken from the idle device with the lowest moving average of time its streams were held by callers, or from
+* the device local to CPU of the calling thread when CPUs of devices are given.
 */
 class OVInferRequestsQueue {
 public:
     /**
     * @brief Allocating idle stream for execution
+    *
+    * Kept for callers which need future semantics. Allocates promise shared state on every call,
+    * prefer tryGetIdleStream/waitForIdleStream on hot paths.
     */
     std::future<int> getIdleStream();
 
+    /**
+    * @brief Takes idle stream if there is any available without blocking
+    *
+    * @param priority selects network of stream when pool has network reserved for latency sensitive requests
+    */
+    std::optional<int> tryGetIdleStream(RequestPriority priority = RequestPriority::NORMAL);
+
+    /**
+    * @brief Blocks until idle stream is available
+    */
+    int waitForIdleStream();
+
+    /**
+    * @brief Registers waiter which will be notified with stream id once it is available.
+    * If there is idle stream it is assigned right away from calling thread.
+    *
+    * @return false if waiter was rejected since max queue size of its options was reached
+    */
+    bool waitForIdleStream(IdleStreamWaiter& waiter);
+
+    /**
+    * @brief Removes waiter from waiters list
+    *
+    * @return true if waiter was removed before stream was assigned to it
+    */
+    bool cancelWaiting(IdleStreamWaiter& waiter);
+
     /**
     * @brief Release stream after execution
     */
@@ -45,15 +260,48 @@ public:
     /**
     * @brief Constructor with initialization
     */
-    OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength) :
-        streams(streamsLength),
-        front_idx{0},
-        back_idx{0} {
-        for (int i = 0; i < streamsLength; ++i) {
-            streams[i] = i;
-            inferRequests.push_back(network.CreateInferRequest());
-        }
-    }
+    OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength);
+
+    /**
+    * @brief Constructor of adaptive pool, which starts with streamsLength InferRequests and grows up to maxStreamsLength
+    * when requests keep waiting for idle stream, streams above initial count are released once they are not needed
+    */
+    OVInferRequestsQueue(InferenceEngine::ExecutableNetwork& network, int streamsLength, int maxStreamsLength);
+
+    /**
+    * @brief Constructor with initialization of streams for each of networks loaded on different devices
+    *
+    * @param devicesCpus optional CPUs of each network, e.g. of its NUMA node. Infer requests of network are created
+    * on its CPUs, so that their memory is local to them. Callers get streams of network owning CPU they run on first,
+    * streams of remaining networks only once local ones are busy
+    */
+    OVInferRequestsQueue(const std::vector<std::pair<InferenceEngine::ExecutableNetwork*, int>>& networks,
+        const std::vector<std::vector<int>>& devicesCpus = {});
+
+    ~OVInferRequestsQueue();
+
+    /**
+     * @brief Makes streams of the pool compete with pools of other models for slots of device limiter, stream is taken from
+     * the pool only together with slot which is returned with the stream. Must be called before pool is used and after
+     * setLatencyDevice, pool of networks loaded on multiple devices cannot be limited.
+     *
+     * @param limiter
+     * @param weight share of device slots given to the pool when device is saturated
+     */
+    void setDeviceLimiter(std::shared_ptr<DeviceConcurrencyLimiter> limiter, uint32_t weight);
+
+    /**
+     * @brief Reserves streams of network at given index, in order of networks passed to constructor, for latency sensitive requests.
+     * Requests of high priority take its streams first, requests of normal priority only when streams of remaining networks are busy
+     * and requests of low priority never. Must be called before pool is used
+     */
+    void setLatencyDevice(size_t device);
+
+    /**
+     * @brief Sets function applied to each InferRequest of the pool, e.g. to replace its blobs, before it is used for the first time.
+     * Applied to created InferRequests right away and to those created later in adaptive pool. Must be called before pool is used.
+     */
+    void setInferRequestInitializer(std::function<void(InferenceEngine::InferRequest&)> initializer);
 
     /**
      * @brief Give InferRequest
@@ -62,31 +310,198 @@ public:
         return inferRequests[streamID];
     }
 
+    /**
+     * @brief Number of InferRequests in the pool, changes over time in adaptive pool
+     */
+    size_t size() const {
+        return activeStreamsCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Maximum number of InferRequests in the pool
+     */
+    size_t getMaxSize() const {
+        return inferRequests.size();
+    }
+
+    /**
+     * @brief Number of devices which networks streams belong to
+     */
+    size_t getDevicesCount() const {
+        return rings.size();
+    }
+
+    /**
+     * @brief Index of device which network stream belongs to, in order of networks passed to constructor
+     */
+    size_t getStreamDevice(int streamID) const {
+        return streamDevices[streamID];
+    }
+
+    /**
+     * @brief Approximate number of idle streams, intended for monitoring only
+     */
+    size_t getIdleStreamsCount() const {
+        size_t count = 0;
+        for (const auto& ring : rings) {
+            count += ring->size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Moving average of time in microseconds streams of device were held, 0 if not measured yet
+     */
+    uint64_t getDeviceLatencyEstimate(size_t device) const {
+        return deviceLatencyEstimates[device].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of callers waiting for idle stream, intended for monitoring only
+     */
+    size_t getWaitersCount() const {
+        return waitersCount.load(std::memory_order_relaxed);
+    }
+
 protected:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        int streamId;
+    };
+
+    /**
+    * @brief Bounded MPMC ring of idle stream ids of single device, its size is power of 2 not lower than number of streams
+    */
+    struct IdleStreamsRing {
+        std::unique_ptr<Cell[]> cells;
+        size_t cellsMask;
+
+        alignas(64) std::atomic<size_t> enqueuePos{0};
+        alignas(64) std::atomic<size_t> dequeuePos{0};
+
+        explicit IdleStreamsRing(int streamsLength);
+
+        void push(int streamId);
+        std::optional<int> pop();
+
+        size_t size() const {
+            const size_t dequeued = dequeuePos.load();
+            const size_t enqueued = enqueuePos.load();
+            return enqueued > dequeued ? enqueued - dequeued : 0;
+        }
+    };
+
+    void push(int streamId);
+    std::optional<int> pop(RequestPriority priority = RequestPriority::NORMAL);
+
     /**
-    * @brief Vector representing circular buffer for infer queue
+    * @brief Makes stream idle again without returning device limiter slot, used also for streams added to adaptive pool
     */
-    std::vector<int> streams;
+    void pushIdleStream(int streamId);
 
     /**
-    * @brief Index of the front of the idle streams list
+    * @brief Picks idle stream of device expected to complete inference first
     */
-    std::uint32_t front_idx;
+    std::optional<int> popFromFastestDevice();
 
     /**
-    * @brief Index of the back of the idle streams list
+    * @brief Picks idle stream of device owning CPU of calling thread, of the fastest remaining device if it has none
     */
-    std::atomic<std::uint32_t> back_idx;
+    std::optional<int> popFromLocalDevice();
 
     /**
-    * @brief Vector representing OV streams and used for notification about completed inference operations
+    * @brief Picks idle stream of network reserved for latency or of remaining networks, depending on priority
     */
-    std::mutex front_mut;
-    std::mutex queue_mutex;
+    std::optional<int> popForPriority(RequestPriority priority);
+
     /**
-     * 
-     */
+    * @brief Assigns idle streams to waiters by priority and in order of registration, drops cancelled waiters and those past their deadline
+    */
+    void dispatchToWaiters();
+
+    /**
+    * @brief Removes waiter from waiters list of its priority, called with waiters list lock held
+    */
+    void unlinkWaiter(IdleStreamWaiter& waiter);
+
+    /**
+    * @brief Claims the right to change size of adaptive pool, so that it changes at most once per interval
+    */
+    bool tryStartAdjustment(const std::chrono::steady_clock::time_point& now, std::chrono::steady_clock::duration interval);
+
+    /**
+    * @brief Adds stream to adaptive pool when requests waited for idle stream too long on average
+    */
+    void growIfWaitingTooLong();
+
+    /**
+    * @brief Takes returned stream out of adaptive pool when no request waited for idle stream for a while
+    *
+    * @return true if stream was parked instead of being returned to idle streams
+    */
+    bool shrinkIfIdle(int streamId);
+
+    /**
+    * @brief Rings of idle stream ids, one for each device
+    */
+    std::vector<std::unique_ptr<IdleStreamsRing>> rings;
+    std::vector<size_t> streamDevices;
+
+    /**
+    * @brief Device of network reserved for latency sensitive requests, nullopt if streams are picked from the fastest device
+    */
+    std::optional<size_t> latencyDevice;
+
+    /**
+    * @brief Device owning each CPU, -1 for CPUs of no device, empty if streams are not picked by CPU of calling thread
+    */
+    std::vector<int> cpuDevices;
+
+    /**
+    * @brief Latency estimates of devices and times streams were taken at, used only with multiple devices
+    */
+    std::unique_ptr<std::atomic<uint64_t>[]> deviceLatencyEstimates;
+    std::vector<std::chrono::steady_clock::time_point> streamTakenTimes;
+
+    /**
+    * @brief Intrusive FIFO lists of waiters for idle stream, one for each priority
+    */
+    InstrumentedMutex<std::mutex> waitersMtx{"infer_requests_waiters"};
+    IdleStreamWaiter* waitersHeads[REQUEST_PRIORITIES_COUNT] = {};
+    IdleStreamWaiter* waitersTails[REQUEST_PRIORITIES_COUNT] = {};
+    size_t priorityWaitersCounts[REQUEST_PRIORITIES_COUNT] = {};
+    alignas(64) std::atomic<size_t> waitersCount{0};
+
     std::vector<InferenceEngine::InferRequest> inferRequests;
-    std::queue<std::promise<int>> promises;
+    alignas(64) std::atomic<size_t> activeStreamsCount{0};
+
+    /**
+    * @brief Network used to create streams of adaptive pool, nullptr if pool has fixed size
+    */
+    InferenceEngine::ExecutableNetwork* adaptiveNetwork = nullptr;
+    size_t minStreams = 0;
+
+    std::function<void(InferenceEngine::InferRequest&)> inferRequestInitializer;
+
+    /**
+    * @brief Limiter of device shared with pools of other models, nullptr if device is not limited
+    */
+    std::shared_ptr<DeviceConcurrencyLimiter> deviceLimiter;
+    DeviceConcurrencyLimiter::client_id_t deviceLimiterClientId = 0;
+
+    /**
+    * @brief Stream ids out of adaptive pool, InferRequests of streams parked in previous adjustments are released
+    */
+    std::mutex parkedStreamsMtx;
+    std::vector<int> parkedStreams;
+    std::vector<bool> releasedStreams;
+
+    std::atomic<int64_t> lastAdjustmentTicks{0};
+    std::atomic<int64_t> lastWaitTicks{0};
+
+    /**
+    * @brief Moving average of time in microseconds requests waited for idle stream in adaptive pool
+    */
+    std::atomic<uint64_t> waitTimeEstimate{0};
 };
 }  // namespace ovms
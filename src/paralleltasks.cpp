@@ -0,0 +1,42 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "paralleltasks.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace ovms {
+
+void executeInParallel(const std::vector<std::function<void()>>& tasks, size_t maxThreads) {
+    std::atomic<size_t> nextTask = 0;
+    auto worker = [&tasks, &nextTask]() {
+        for (size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+            tasks[i]();
+        }
+    };
+    const size_t threadsCount = std::max<size_t>(1, std::min(maxThreads, tasks.size()));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadsCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace ovms
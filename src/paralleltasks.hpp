@@ -0,0 +1,33 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Executes tasks on up to maxThreads threads, including the calling one, and waits until all of them finish
+ *
+ * Tasks are taken in order. With maxThreads equal to 1 they are executed sequentially on the calling thread.
+ *
+ * @param tasks
+ * @param maxThreads
+ */
+void executeInParallel(const std::vector<std::function<void()>>& tasks, size_t maxThreads);
+
+}  // namespace ovms
@@ -0,0 +1,51 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "phasemarkers.hpp"
+
+namespace ovms {
+
+#ifdef OVMS_ITT
+const __itt_domain* PhaseMarker::getDomain() {
+    static const __itt_domain* domain = __itt_domain_create("ovms");
+    return domain;
+}
+
+__itt_string_handle* PhaseMarker::getDetailKey() {
+    static __itt_string_handle* key = __itt_string_handle_create("detail");
+    return key;
+}
+#endif
+
+PhaseMarker::PhaseMarker(const char* name)
+#ifdef OVMS_PHASE_MARKERS
+    :
+    name(name)
+#endif
+#ifdef OVMS_ITT
+    ,
+    handle(__itt_string_handle_create(name))
+#endif
+{
+}
+
+const PhaseMarker STREAM_WAIT_PHASE("stream wait");
+const PhaseMarker DESERIALIZE_PHASE("deserialize");
+const PhaseMarker INFERENCE_PHASE("inference");
+const PhaseMarker SERIALIZE_PHASE("serialize");
+const PhaseMarker NODE_EXECUTE_PHASE("node execute");
+const PhaseMarker NODE_FETCH_RESULTS_PHASE("node fetch results");
+
+}  // namespace ovms
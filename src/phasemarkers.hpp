@@ -0,0 +1,131 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#ifdef OVMS_ITT
+#include <ittnotify.h>
+#endif
+#ifdef OVMS_USDT
+#include <sys/sdt.h>
+#endif
+
+#if defined(OVMS_ITT) || defined(OVMS_USDT)
+#define OVMS_PHASE_MARKERS
+#endif
+
+namespace ovms {
+
+/**
+ * @brief Phase of request processing annotated for external profilers
+ *
+ * Phases are reported as ITT overlapped tasks for VTune when built with --define=itt=1 and as USDT probes
+ * ovms:phase_begin and ovms:phase_end for perf and bpftrace when built with --define=usdt=1. Otherwise markers
+ * compile to nothing. Phase may begin and end on different threads, its instance is identified by owner
+ * (e.g. request context or pipeline node), detail names it further (e.g. node name).
+ */
+class PhaseMarker {
+#ifdef OVMS_PHASE_MARKERS
+    const char* const name;
+#endif
+#ifdef OVMS_ITT
+    __itt_string_handle* const handle;
+
+    static const __itt_domain* getDomain();
+    static __itt_string_handle* getDetailKey();
+
+    __itt_id getTaskId(const void* owner) const {
+        return __itt_id_make(const_cast<void*>(owner), reinterpret_cast<unsigned long long>(handle));
+    }
+#endif
+
+public:
+    explicit PhaseMarker(const char* name);
+
+    void begin(const void* owner, const char* detail = "") const {
+#ifdef OVMS_ITT
+        const __itt_domain* domain = getDomain();
+        if (domain->flags) {
+            __itt_task_begin_overlapped(domain, getTaskId(owner), __itt_null, handle);
+            if (*detail) {
+                __itt_metadata_str_add(domain, getTaskId(owner), getDetailKey(), detail, 0);
+            }
+        }
+#endif
+#ifdef OVMS_USDT
+        DTRACE_PROBE3(ovms, phase_begin, name, owner, detail);
+#endif
+    }
+
+    void end(const void* owner, const char* detail = "") const {
+#ifdef OVMS_ITT
+        const __itt_domain* domain = getDomain();
+        if (domain->flags) {
+            __itt_task_end_overlapped(domain, getTaskId(owner));
+        }
+#endif
+#ifdef OVMS_USDT
+        DTRACE_PROBE3(ovms, phase_end, name, owner, detail);
+#endif
+    }
+};
+
+/**
+ * @brief Marks phase from construction until end is called or scope is left, also by early return
+ */
+class PhaseScope {
+#ifdef OVMS_PHASE_MARKERS
+    const PhaseMarker& marker;
+    const void* const owner;
+    const char* const detail;
+    bool ended = false;
+#endif
+
+public:
+    PhaseScope(const PhaseMarker& marker, const void* owner, const char* detail = "")
+#ifdef OVMS_PHASE_MARKERS
+        :
+        marker(marker),
+        owner(owner),
+        detail(detail) {
+        marker.begin(owner, detail);
+    }
+#else
+    {
+    }
+#endif
+
+    ~PhaseScope() {
+        end();
+    }
+
+    void end() {
+#ifdef OVMS_PHASE_MARKERS
+        if (!ended) {
+            ended = true;
+            marker.end(owner, detail);
+        }
+#endif
+    }
+};
+
+extern const PhaseMarker STREAM_WAIT_PHASE;
+extern const PhaseMarker DESERIALIZE_PHASE;
+extern const PhaseMarker INFERENCE_PHASE;
+extern const PhaseMarker SERIALIZE_PHASE;
+extern const PhaseMarker NODE_EXECUTE_PHASE;
+extern const PhaseMarker NODE_FETCH_RESULTS_PHASE;
+
+}  // namespace ovms
@@ -16,12 +16,18 @@
 #include "pipeline.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <map>
+#include <set>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "logging.hpp"
-#include "threadsafequeue.hpp"
+#include "phasemarkers.hpp"
+#include "workstealingexecutor.hpp"
 
 namespace ovms {
 
@@ -51,62 +57,428 @@ void setFailIfNotFailEarlier(ovms::Status& earlierStatusCode, ovms::Status& newF
     }
 }
 
-#define IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE \
-    if (!firstErrorStatus.ok()) {                                                       \
-        if (finishedExecute == startedExecute) {                                        \
-            break;                                                                      \
-        } else {                                                                        \
-            continue;                                                                   \
-        }                                                                               \
-    }
-
 #define CHECK_AND_LOG_ERROR(NODE)                                                           \
     if (!status.ok()) {                                                                     \
         setFailIfNotFailEarlier(firstErrorStatus, status);                                  \
         SPDLOG_LOGGER_WARN(ensemble_logger, "Executing pipeline:{} node:{} failed with:{}", \
             getName(), NODE.getName(), status.string());                                    \
+        if (NODE.getMetrics()) {                                                            \
+            NODE.getMetrics()->failures.fetch_add(1, std::memory_order_relaxed);            \
+        }                                                                                   \
     }
 
+namespace {
+double elapsedMicroseconds(const std::chrono::steady_clock::time_point& from, const std::chrono::steady_clock::time_point& to) {
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+}  // namespace
+
+Pipeline::~Pipeline() {
+    if (pool) {
+        pool->release(PipelineGraph{std::move(nodes), &entry, &exit, poolGeneration});
+    }
+}
+
 Status Pipeline::execute() {
+    std::promise<Status> finished;
+    auto result = finished.get_future();
+    executeAsync([&finished](const Status& status) { finished.set_value(status); });
+    return result.get();
+}
+
+Status Pipeline::executeAndRelease(std::unique_ptr<Pipeline> pipeline, std::shared_ptr<void> keepAlive) {
+    auto reported = std::make_shared<std::promise<Status>>();
+    auto result = reported->get_future();
+    // pipeline is owned by its own finish callback, same as in asynchronous execution
+    std::shared_ptr<Pipeline> executed = std::move(pipeline);
+    executed->executeAsync([reported](const Status& status) { reported->set_value(status); },
+        [executed, keepAlive]() mutable {
+            executed.reset();
+            keepAlive.reset();
+        });
+    return result.get();
+}
+
+void Pipeline::executeAsync(PipelineCompletionCallback onResult, std::function<void()> onFinished) {
+    this->onResult = std::move(onResult);
+    start([onFinished = std::move(onFinished)](const Status&) { onFinished(); });
+}
+
+void Pipeline::executeAsync(PipelineCompletionCallback onComplete) {
+    this->onResult = nullptr;
+    start(std::move(onComplete));
+}
+
+void Pipeline::start(PipelineCompletionCallback onComplete) {
     SPDLOG_LOGGER_DEBUG(ensemble_logger, "Started execution of pipeline: {}", getName());
-    ThreadSafeQueue<std::reference_wrapper<Node>> finishedNodeQueue;
-    ovms::Status firstErrorStatus{ovms::StatusCode::OK};
-    auto startedExecute{prepareStatusMap()};
-    auto finishedExecute{prepareStatusMap()};
+    this->onComplete = std::move(onComplete);
+    notifications = std::make_unique<BoundedMpscQueue<Node*>>(nodes.size() + 1);
+    pendingNotifications = 0;
+    firstErrorStatus = StatusCode::OK;
+    startedExecute = prepareStatusMap();
+    finishedExecute = prepareStatusMap();
+    nodesWaitingForIdleInferenceStreamId.clear();
+    memoizedExecutions.clear();
+    memoizationLeaders.clear();
+    nodeStartTimes.clear();
+    nodeDeferTimes.clear();
+    deadlineTimers.clear();
+    deadlineExceeded = false;
+    timedOutNode = nullptr;
+    findMemoizableNodes();
+    findPrunedNodes();
+    if (timeout.count() > 0) {
+        armDeadlineTimer(nullptr, timeout);
+    }
     startedExecute.at(entry.getName()) = true;
-    ovms::Status status = entry.execute(finishedNodeQueue);  // first node will triger first message
+    if (trace || metrics) {
+        startTime = std::chrono::steady_clock::now();
+        nodeStartTimes[&entry] = startTime;
+    }
+    NODE_EXECUTE_PHASE.begin(&entry, entry.getName().c_str());
+    // first node will trigger first notification, pipeline may be already finished and destroyed when execute returns
+    ovms::Status status = entry.execute(*this);
     if (!status.ok()) {
         SPDLOG_LOGGER_WARN(ensemble_logger, "Executing pipeline:{} node:{} failed with:{}",
             getName(), entry.getName(), status.string());
-        return status;
-    }
-    std::vector<std::reference_wrapper<Node>> nodesWaitingForIdleInferenceStreamId;  // consider replacing with std::vector
-    // even though we can remove with random sequence it is probable that we will remove those in sequence
-    const uint WAIT_FOR_FINISHED_NODE_TIMEOUT_MICROSECONDS = 500;
-    const uint WAIT_FOR_DEFERRED_NODE_DISARM_TIMEOUT_MICROSECONDS = 500;
-    // process finished nodes and if no one is finished check if any node with deffered execution
-    // has necessary resources already
+    }
+}
+
+void Pipeline::push(Node& node) {
+    if (node.getMetrics()) {
+        node.setNotificationTime(std::chrono::steady_clock::now());
+    }
+    enqueue(&node);
+}
+
+void Pipeline::enqueue(Node* node) {
+    notifications->push(node);
+    if (pendingNotifications.fetch_add(1) > 0) {
+        return;
+    }
+    WorkStealingExecutor::getInstance().schedule([this]() { processNotifications(); });
+}
+
+void Pipeline::processNotifications() {
+    size_t pending = pendingNotifications.load();
+    size_t processed = 0;
     while (true) {
-        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} waiting for message that node finished.", getName());
-        auto optionallyFinishedNode = finishedNodeQueue.tryPull(WAIT_FOR_FINISHED_NODE_TIMEOUT_MICROSECONDS);
-        if (optionallyFinishedNode) {
-            Node& finishedNode = optionallyFinishedNode.value().get();
-            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} got message that node:{} finished.", getName(), finishedNode.getName());
-            finishedExecute.at(finishedNode.getName()) = true;
-            if (!firstErrorStatus.ok()) {
-                finishedNode.release();
+        if (processed == pending) {
+            pending = pendingNotifications.fetch_sub(processed) - processed;
+            processed = 0;
+            if (pending == 0) {
+                return;
             }
-            IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE
-            BlobMap finishedNodeOutputBlobMap;
-            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Fetching results of pipeline:{} node:{}", getName(), finishedNode.getName());
-            status = finishedNode.fetchResults(finishedNodeOutputBlobMap);
-            CHECK_AND_LOG_ERROR(finishedNode)
-            IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE
-            if (std::all_of(finishedExecute.begin(), finishedExecute.end(), [](auto pair) { return pair.second; })) {
+        }
+        auto node = notifications->tryPull();
+        if (!node) {
+            // counted notification is being written by other producer
+            std::this_thread::yield();
+            continue;
+        }
+        processed++;
+        const bool finished = node.value() == nullptr ? handleDeadlineExceeded() : handleNotification(*node.value());
+        if (finished) {
+            // memoized outputs may keep infer requests of zero copy nodes reserved
+            memoizedExecutions.clear();
+            // timer tasks reference pipeline, none may be running once it is destroyed
+            cancelDeadlineTimers();
+            auto status = firstErrorStatus;
+            if (metrics) {
+                metrics->total.observe(elapsedMicroseconds(startTime, std::chrono::steady_clock::now()));
+                (status.ok() ? metrics->requestsSuccess : metrics->requestsFail).fetch_add(1, std::memory_order_relaxed);
+            }
+            reportResult(status);
+            auto callback = std::move(onComplete);
+            // pipeline may be destroyed by the callback
+            callback(status);
+            return;
+        }
+    }
+}
+
+void Pipeline::armDeadlineTimer(const Node* node, const std::chrono::microseconds& timeout) {
+    deadlineTimers[node] = DeadlineTimer::getInstance().schedule(std::chrono::steady_clock::now() + timeout, [this, node]() {
+        if (deadlineExceeded.exchange(true)) {
+            return;
+        }
+        timedOutNode = node;
+        enqueue(nullptr);
+    });
+}
+
+void Pipeline::cancelDeadlineTimer(const Node* node) {
+    auto it = deadlineTimers.find(node);
+    if (it == deadlineTimers.end()) {
+        return;
+    }
+    DeadlineTimer::getInstance().cancel(it->second);
+    deadlineTimers.erase(it);
+}
+
+void Pipeline::cancelDeadlineTimers() {
+    for (const auto& [node, id] : deadlineTimers) {
+        DeadlineTimer::getInstance().cancel(id);
+    }
+    deadlineTimers.clear();
+}
+
+void Pipeline::reportResult(const Status& status) {
+    if (!onResult) {
+        return;
+    }
+    auto callback = std::move(onResult);
+    onResult = nullptr;
+    callback(status);
+}
+
+bool Pipeline::handleDeadlineExceeded() {
+    if (firstErrorStatus.ok()) {
+        Status status = timedOutNode == nullptr ? Status(StatusCode::PIPELINE_TIMEOUT) : Status(StatusCode::PIPELINE_NODE_TIMEOUT, "node: " + timedOutNode->getName());
+        setFailIfNotFailEarlier(firstErrorStatus, status);
+        SPDLOG_LOGGER_WARN(ensemble_logger, "Executing pipeline:{} failed with:{}", getName(), status.string());
+        // response is sent right away, while running nodes finish in background and do not start next nodes
+        trace = nullptr;
+        reportResult(status);
+    }
+    return releaseDeferredNodes();
+}
+
+void Pipeline::findMemoizableNodes() {
+    if (memoizableNodesFound) {
+        return;
+    }
+    memoizableNodesFound = true;
+    std::map<std::string, std::vector<Node*>> nodesByGroup;
+    for (const auto& node : nodes) {
+        auto dlNode = dynamic_cast<DLNode*>(node.get());
+        if (dlNode != nullptr) {
+            nodesByGroup[dlNode->getMemoizationGroup()].push_back(dlNode);
+        }
+    }
+    for (const auto& [group, groupNodes] : nodesByGroup) {
+        if (groupNodes.size() > 1) {
+            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} memoizes outputs of {} nodes using model:{}", getName(), groupNodes.size(), group);
+            memoizableNodes.insert(groupNodes.begin(), groupNodes.end());
+        }
+    }
+}
+
+void Pipeline::findPrunedNodes() {
+    prunedNodes.clear();
+    if (!exit.hasOutputFilter()) {
+        return;
+    }
+    std::map<Node*, bool> required;
+    const std::function<bool(Node&)> isRequired = [this, &required, &isRequired](Node& node) {
+        if (&node == &exit) {
+            return true;
+        }
+        auto it = required.find(&node);
+        if (it != required.end()) {
+            return it->second;
+        }
+        bool result = false;
+        for (auto& nextNode : node.getNextNodes()) {
+            if (&nextNode.get() != &exit) {
+                result = isRequired(nextNode.get());
+            } else {
+                const auto& mapping = exit.getMappingByDependency(node);
+                result = std::any_of(mapping.begin(), mapping.end(), [this](const auto& pair) { return exit.isInputRequired(pair.second); });
+            }
+            if (result) {
                 break;
             }
+        }
+        required.emplace(&node, result);
+        return result;
+    };
+    for (const auto& node : nodes) {
+        if (node.get() != &entry && !isRequired(*node)) {
+            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} node:{} is not needed for requested outputs", getName(), node->getName());
+            prunedNodes.insert(node.get());
+        }
+    }
+}
+
+bool Pipeline::tryMemoizeNode(Node& node) {
+    if (memoizableNodes.count(&node) == 0) {
+        return false;
+    }
+    auto& dlNode = static_cast<DLNode&>(node);
+    const uint64_t key = dlNode.computeMemoizationKey();
+    auto it = memoizedExecutions.find(key);
+    if (it == memoizedExecutions.end()) {
+        memoizedExecutions.emplace(key, MemoizedExecution{&dlNode});
+        memoizationLeaders.emplace(&node, key);
+        dlNode.exportOutputs({});
+        return false;
+    }
+    auto& execution = it->second;
+    if (!execution.finished) {
+        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} node:{} waits for outputs of node:{}", getName(), node.getName(), execution.leader->getName());
+        execution.leader->exportOutputs(dlNode.getRequiredModelOutputs());
+        execution.followers.push_back(&dlNode);
+        return true;
+    }
+    if (!dlNode.setMemoizedOutputs(execution.outputs)) {
+        return false;
+    }
+    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} node:{} reuses outputs of node:{}", getName(), node.getName(), execution.leader->getName());
+    push(node);
+    return true;
+}
+
+void Pipeline::finishMemoizedFollowers(const Node& leader, BlobMap outputs) {
+    auto leaderItr = memoizationLeaders.find(&leader);
+    if (leaderItr == memoizationLeaders.end()) {
+        return;
+    }
+    const uint64_t key = leaderItr->second;
+    memoizationLeaders.erase(leaderItr);
+    auto& execution = memoizedExecutions.at(key);
+    execution.finished = true;
+    execution.outputs = std::move(outputs);
+    for (auto* follower : execution.followers) {
+        if (!firstErrorStatus.ok()) {
+            // follower did not reserve any resources
+            finishedExecute.at(follower->getName()) = true;
+            NODE_EXECUTE_PHASE.end(follower, follower->getName().c_str());
+            continue;
+        }
+        if (follower->setMemoizedOutputs(execution.outputs)) {
+            push(*follower);
+            continue;
+        }
+        Status status = StatusCode::INTERNAL_ERROR;
+        SPDLOG_LOGGER_WARN(ensemble_logger, "Pipeline:{} node:{} is missing memoized outputs of node:{}", getName(), follower->getName(), leader.getName());
+        setFailIfNotFailEarlier(firstErrorStatus, status);
+        finishedExecute.at(follower->getName()) = true;
+        NODE_EXECUTE_PHASE.end(follower, follower->getName().c_str());
+    }
+    execution.followers.clear();
+    if (execution.leader->hasZeroCopyOutputs()) {
+        // zero copy outputs keep infer request of leader reserved, they are not kept for nodes started later
+        execution.outputs.clear();
+        memoizedExecutions.erase(key);
+    }
+}
+
+void Pipeline::startNode(Node& node, std::optional<std::chrono::steady_clock::time_point> readyTime) {
+    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Started execution of pipeline:{} node:{}", getName(), node.getName());
+    startedExecute.at(node.getName()) = true;
+    if (trace || metrics) {
+        const auto now = std::chrono::steady_clock::now();
+        nodeStartTimes[&node] = now;
+        if (node.getMetrics() && readyTime) {
+            node.getMetrics()->readyToStart.observe(elapsedMicroseconds(readyTime.value(), now));
+        }
+    }
+    if (node.getTimeout().count() > 0) {
+        armDeadlineTimer(&node, node.getTimeout());
+    }
+    NODE_EXECUTE_PHASE.begin(&node, node.getName().c_str());
+    if (tryMemoizeNode(node)) {
+        return;
+    }
+    auto status = node.execute(*this);
+    if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
+        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Node:{} not ready for execution yet", node.getName());
+        nodesWaitingForIdleInferenceStreamId.insert(&node);
+        if (node.getMetrics()) {
+            nodeDeferTimes[&node] = std::chrono::steady_clock::now();
+        }
+        status = StatusCode::OK;
+    }
+    CHECK_AND_LOG_ERROR(node)
+}
+
+void Pipeline::startOrSkipNode(Node& node, std::chrono::steady_clock::time_point readyTime) {
+    const bool pruned = prunedNodes.count(&node) == 1;
+    if ((!node.hasSkippedDependency() && !pruned) || &node == &exit) {
+        startNode(node, readyTime);
+        return;
+    }
+    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Skipped execution of pipeline:{} node:{}{}", getName(), node.getName(), pruned ? " not needed for requested outputs" : "");
+    startedExecute.at(node.getName()) = true;
+    finishedExecute.at(node.getName()) = true;
+    node.releaseInputs();
+    if (node.getMetrics() && !pruned) {
+        node.getMetrics()->skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (auto& nextNode : node.getNextNodes()) {
+        nextNode.get().skipDependency(node);
+    }
+    for (auto& nextNode : node.getNextNodes()) {
+        if (nextNode.get().isReady()) {
+            startOrSkipNode(nextNode.get(), readyTime);
+        }
+    }
+}
+
+bool Pipeline::handleNotification(Node& node) {
+    ovms::Status status;
+    if (nodesWaitingForIdleInferenceStreamId.erase(&node) > 0) {
+        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Trying to trigger node:{} execution", node.getName());
+        status = node.execute(*this);
+        if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
+            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Node:{} not ready for execution yet", node.getName());
+            nodesWaitingForIdleInferenceStreamId.insert(&node);
+            status = StatusCode::OK;
+        } else if (node.getMetrics()) {
+            auto deferItr = nodeDeferTimes.find(&node);
+            if (deferItr != nodeDeferTimes.end()) {
+                node.getMetrics()->streamWait.observe(elapsedMicroseconds(deferItr->second, std::chrono::steady_clock::now()));
+                nodeDeferTimes.erase(deferItr);
+            }
+        }
+        CHECK_AND_LOG_ERROR(node)
+    } else {
+        Node& finishedNode = node;
+        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Pipeline:{} got message that node:{} finished.", getName(), finishedNode.getName());
+        finishedExecute.at(finishedNode.getName()) = true;
+        NODE_EXECUTE_PHASE.end(&finishedNode, finishedNode.getName().c_str());
+        cancelDeadlineTimer(&finishedNode);
+        if (!firstErrorStatus.ok()) {
+            finishedNode.release();
+            finishMemoizedFollowers(finishedNode, {});
+            // error occurred earlier, finish once all started nodes are finished
+            return finishedExecute == startedExecute;
+        }
+        BlobMap finishedNodeOutputBlobMap;
+        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Fetching results of pipeline:{} node:{}", getName(), finishedNode.getName());
+        const auto fetchStart = std::chrono::steady_clock::now();
+        if (finishedNode.getMetrics()) {
+            auto startItr = nodeStartTimes.find(&finishedNode);
+            if (startItr != nodeStartTimes.end()) {
+                finishedNode.getMetrics()->execution.observe(elapsedMicroseconds(startItr->second, finishedNode.getNotificationTime()));
+            }
+        }
+        NODE_FETCH_RESULTS_PHASE.begin(&finishedNode, finishedNode.getName().c_str());
+        status = finishedNode.fetchResults(finishedNodeOutputBlobMap);
+        NODE_FETCH_RESULTS_PHASE.end(&finishedNode, finishedNode.getName().c_str());
+        if (trace) {
+            auto startItr = nodeStartTimes.find(&finishedNode);
+            if (startItr != nodeStartTimes.end()) {
+                trace->addSpan("node " + finishedNode.getName() + " execute", startItr->second, fetchStart);
+            }
+            trace->addSpan("node " + finishedNode.getName() + " fetch results", fetchStart, std::chrono::steady_clock::now());
+        }
+        CHECK_AND_LOG_ERROR(finishedNode)
+        if (memoizationLeaders.count(&finishedNode) == 1) {
+            finishMemoizedFollowers(finishedNode, static_cast<DLNode&>(finishedNode).takeExportedOutputs());
+        }
+        if (firstErrorStatus.ok()) {
+            if (std::all_of(finishedExecute.begin(), finishedExecute.end(), [](auto pair) { return pair.second; })) {
+                return true;
+            }
             auto& nextNodesFromFinished = finishedNode.getNextNodes();
+            const bool skipsDependants = finishedNode.skipsDependants();
             for (auto& nextNode : nextNodesFromFinished) {
+                if (skipsDependants) {
+                    nextNode.get().skipDependency(finishedNode);
+                    continue;
+                }
                 SPDLOG_LOGGER_DEBUG(ensemble_logger, "setting pipeline:{} node:{} outputs as inputs for node:{}",
                     getName(), finishedNode.getName(), nextNode.get().getName());
                 status = nextNode.get().setInputs(finishedNode, finishedNodeOutputBlobMap);
@@ -117,71 +489,39 @@ Status Pipeline::execute() {
             }
             finishedNodeOutputBlobMap.clear();
             for (auto& nextNode : nextNodesFromFinished) {
-                if (nextNode.get().isReady()) {
-                    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Started execution of pipeline:{} node:{}", getName(), nextNode.get().getName());
-                    startedExecute.at(nextNode.get().getName()) = true;
-                    status = nextNode.get().execute(finishedNodeQueue);
-                    if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
-                        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Node:{} not ready for execution yet", nextNode.get().getName());
-                        nodesWaitingForIdleInferenceStreamId.push_back(nextNode.get());
-                        status = StatusCode::OK;
-                    }
-                    CHECK_AND_LOG_ERROR(nextNode.get())
-                    if (!firstErrorStatus.ok()) {
-                        break;
-                    }
-                }
-            }
-        } else {
-            // If error occurred earlier, disarm stream id guards of all deferred nodes and exit
-            if (!firstErrorStatus.ok()) {
-                SPDLOG_LOGGER_DEBUG(ensemble_logger, "Will try to disarm all stream id guards of all {} deferred nodes due to previous error in pipeline", nodesWaitingForIdleInferenceStreamId.size());
-                // Check if there are deferred nodes in queue to free
-                if (nodesWaitingForIdleInferenceStreamId.size() > 0) {
-                    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Trying to disarm {} remaining deferred nodes...", nodesWaitingForIdleInferenceStreamId.size());
-                    for (auto it = nodesWaitingForIdleInferenceStreamId.begin(); it != nodesWaitingForIdleInferenceStreamId.end();) {
-                        auto& node = (*it).get();
-                        if (node.tryDisarmStreamIdGuard(WAIT_FOR_DEFERRED_NODE_DISARM_TIMEOUT_MICROSECONDS)) {
-                            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Stream id guard disarm of node {} has succeeded", node.getName());
-                            finishedExecute.at(node.getName()) = true;
-                            it = nodesWaitingForIdleInferenceStreamId.erase(it);
-                        } else {
-                            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Cannot disarm stream id guard of node {} yet, will try again later", node.getName());
-                            it++;
-                        }
-                    }
-                    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Disarming iteration completed, remaining deferred nodes count: {}", nodesWaitingForIdleInferenceStreamId.size());
+                if (!firstErrorStatus.ok()) {
+                    break;
                 }
-                // Check for deferred node queue size again to indicate if all nodes got freed
-                if (nodesWaitingForIdleInferenceStreamId.size() > 0) {
-                    continue;
-                } else {
-                    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Disarming all stream id guards of deferred nodes completed, pipeline will shut down");
-                    IF_ERROR_OCCURRED_EARLIER_THEN_BREAK_IF_ALL_STARTED_FINISHED_CONTINUE_OTHERWISE
+                if (nextNode.get().isReady()) {
+                    startOrSkipNode(nextNode.get(), finishedNode.getNotificationTime());
                 }
             }
+        }
+    }
+    if (!firstErrorStatus.ok()) {
+        return releaseDeferredNodes();
+    }
+    return false;
+}
 
-            // else scope could be executed always however it seems most reasonable at the time to
-            // free blocked inferRequests from exeuction first rather than free models for reloading
-            for (auto it = nodesWaitingForIdleInferenceStreamId.begin(); it != nodesWaitingForIdleInferenceStreamId.end();) {
-                auto& node = (*it).get();
-                SPDLOG_LOGGER_DEBUG(ensemble_logger, "Trying to trigger node:{} execution", node.getName());
-                status = node.execute(finishedNodeQueue);
-                if (status.ok()) {
-                    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Node:{} ready yet:", node.getName());
-                    it = nodesWaitingForIdleInferenceStreamId.erase(it);
-                    continue;
-                }
-                it++;
-                if (status == StatusCode::PIPELINE_STREAM_ID_NOT_READY_YET) {
-                    SPDLOG_LOGGER_DEBUG(ensemble_logger, "Node:{} not ready for execution yet", node.getName());
-                    status = StatusCode::OK;
-                } else {
-                    CHECK_AND_LOG_ERROR(node)
-                }
-            }
+bool Pipeline::releaseDeferredNodes() {
+    // Deferred nodes will never be executed, free their requests for stream id so that other inferences are not blocked
+    if (nodesWaitingForIdleInferenceStreamId.size() > 0) {
+        SPDLOG_LOGGER_DEBUG(ensemble_logger, "Disarming stream id guards of {} deferred nodes due to previous error in pipeline", nodesWaitingForIdleInferenceStreamId.size());
+    }
+    for (auto it = nodesWaitingForIdleInferenceStreamId.begin(); it != nodesWaitingForIdleInferenceStreamId.end();) {
+        auto& deferredNode = **it;
+        if (deferredNode.tryDisarmStreamIdGuard(0)) {
+            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Stream id guard disarm of node {} has succeeded", deferredNode.getName());
+            finishedExecute.at(deferredNode.getName()) = true;
+            NODE_EXECUTE_PHASE.end(&deferredNode, deferredNode.getName().c_str());
+            finishMemoizedFollowers(deferredNode, {});
+            it = nodesWaitingForIdleInferenceStreamId.erase(it);
+        } else {
+            SPDLOG_LOGGER_DEBUG(ensemble_logger, "Cannot disarm stream id guard of node {} yet, will try again on its notification", deferredNode.getName());
+            it++;
         }
     }
-    return firstErrorStatus;
+    return finishedExecute == startedExecute;
 }
 }  // namespace ovms
@@ -15,33 +15,122 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "deadlinetimer.hpp"
 #include "dl_node.hpp"
 #include "entry_node.hpp"
 #include "exit_node.hpp"
+#include "pipelinepool.hpp"
+#include "requesttrace.hpp"
 #include "status.hpp"
+#include "threadsafequeue.hpp"
 
 namespace ovms {
 
 void printNodeConnections(const std::string& nodeName, const std::string& sourceNode, const InputPairs& pairs);
 
-class Pipeline {
+using PipelineCompletionCallback = std::function<void(const Status&)>;
+
+/**
+ * @brief Graph of nodes executed for single request
+ *
+ * Execution is driven by node notifications: finished nodes pass their outputs to following nodes and
+ * start those which became ready, nodes deferred due to no idle stream are started once stream is assigned.
+ * Notifications are processed on WorkStealingExecutor workers, one at a time for a given pipeline.
+ * Expired pipeline or node timeout is delivered as notification as well, pipeline then fails and does not start more nodes.
+ * Dependants of node which skips them, e.g. closed gate, are never started and pipeline finishes once remaining nodes are finished.
+ */
+class Pipeline : public NodeNotificationQueue {
     std::vector<std::unique_ptr<Node>> nodes;
     const std::string name;
     EntryNode& entry;
     ExitNode& exit;
 
+    // Pool which nodes are given back to after pipeline is destroyed
+    std::shared_ptr<PipelinePool> pool;
+    uint64_t poolGeneration = 0;
+
+    // Execution state, modified only by the worker currently processing notifications
+    Status firstErrorStatus;
+    std::map<const std::string, bool> startedExecute;
+    std::map<const std::string, bool> finishedExecute;
+    // Deferred nodes are pushed again by the thread returning stream id to the infer requests queue,
+    // finished nodes are pushed by infer request completion callbacks. Both are distinguished by presence in this set.
+    std::set<Node*> nodesWaitingForIdleInferenceStreamId;
+    PipelineCompletionCallback onComplete;
+    // Called with result as soon as it is known, before onComplete, empty if result is passed to onComplete
+    PipelineCompletionCallback onResult;
+
+    // Time after which pipeline fails if it did not finish since it was started, 0 if not limited
+    std::chrono::microseconds timeout{0};
+    // Timers of pipeline timeout, keyed by nullptr, and of started nodes with timeout, cancelled once not needed
+    std::map<const Node*, DeadlineTimer::TaskId> deadlineTimers;
+    // Set by timer thread with first expired timeout, which is pushed as nullptr notification
+    std::atomic<bool> deadlineExceeded{false};
+    const Node* timedOutNode = nullptr;
+
+    // Each node has at most one notification pending and there is at most one timeout notification,
+    // so queue sized to nodes count plus one never blocks producers.
+    // Notifications are processed by single worker scheduled by whoever raises pending count from zero.
+    std::unique_ptr<BoundedMpscQueue<Node*>> notifications;
+    std::atomic<size_t> pendingNotifications{0};
+
+    /**
+     * @brief Execution of DL node shared by nodes with the same model and inputs
+     */
+    struct MemoizedExecution {
+        DLNode* leader;
+        std::vector<DLNode*> followers;
+        bool finished = false;
+        // leader outputs keyed by model output names
+        BlobMap outputs;
+    };
+
+    // DL nodes of models used by more than one node, only their outputs are memoized
+    std::set<Node*> memoizableNodes;
+    bool memoizableNodesFound = false;
+    std::unordered_map<uint64_t, MemoizedExecution> memoizedExecutions;
+    std::map<const Node*, uint64_t> memoizationLeaders;
+
+    // Nodes feeding only pipeline outputs left out by output filter of current request, they are skipped
+    std::set<const Node*> prunedNodes;
+
+    // Trace which node executions are recorded in, nullptr if request is not traced
+    RequestTrace* trace = nullptr;
+    std::map<const Node*, std::chrono::steady_clock::time_point> nodeStartTimes;
+
+    // Counters of the pipeline definition, nullptr if not collected
+    std::shared_ptr<PipelineMetrics> metrics;
+    std::chrono::steady_clock::time_point startTime;
+    std::map<const Node*, std::chrono::steady_clock::time_point> nodeDeferTimes;
+
 public:
     Pipeline(EntryNode& entry, ExitNode& exit, const std::string& name = "default_name") :
         name(name),
         entry(entry),
         exit(exit) {}
 
+    Pipeline(PipelineGraph&& graph, std::shared_ptr<PipelinePool> pool, const std::string& name) :
+        nodes(std::move(graph.nodes)),
+        name(name),
+        entry(*graph.entry),
+        exit(*graph.exit),
+        pool(std::move(pool)),
+        poolGeneration(graph.generation) {}
+
+    ~Pipeline() override;
+
     void push(std::unique_ptr<Node> node) {
         nodes.emplace_back(std::move(node));
     }
@@ -56,13 +145,144 @@ public:
         to.addDependency(from, blobNamesMapping);
     }
 
+    /**
+     * @brief Executes pipeline and blocks until all nodes are finished, also when execution exceeds timeout
+     */
     Status execute();
+
+    /**
+     * @brief Executes pipeline and blocks until its result is known, so that timeout bounds the latency
+     *
+     * After timeout deferred nodes are released and running nodes do not start next nodes, but they still finish
+     * in background. Pipeline and keepAlive, which must keep request and response referenced by the nodes, are
+     * destroyed once all started nodes are finished.
+     */
+    static Status executeAndRelease(std::unique_ptr<Pipeline> pipeline, std::shared_ptr<void> keepAlive);
+
+    /**
+     * @brief Starts pipeline execution without blocking calling thread
+     *
+     * onComplete is called exactly once from WorkStealingExecutor worker once all started nodes are finished.
+     * Pipeline is not accessed after onComplete is called, so it may be destroyed from the callback.
+     */
+    void executeAsync(PipelineCompletionCallback onComplete);
+
+    /**
+     * @brief Starts pipeline execution without blocking calling thread, result may be reported before all nodes are finished
+     *
+     * onResult is called exactly once from WorkStealingExecutor worker, as soon as pipeline or its node exceeds timeout or
+     * once all started nodes are finished otherwise. Nodes still running after timeout keep referencing request and response,
+     * so those must stay valid until onFinished is called. onFinished is called exactly once after onResult, once all started
+     * nodes are finished, and pipeline may be destroyed from it.
+     */
+    void executeAsync(PipelineCompletionCallback onResult, std::function<void()> onFinished);
+
     const std::string& getName() const {
         return name;
     }
 
+    /**
+     * @brief Records execution of each node, from its start until its results are fetched, in trace which must outlive execution
+     */
+    void setTrace(RequestTrace* trace) {
+        this->trace = trace;
+    }
+
+    /**
+     * @brief Records execution of pipeline and its nodes in counters shared by pipelines of the definition
+     */
+    void setMetrics(std::shared_ptr<PipelineMetrics> metrics) {
+        this->metrics = std::move(metrics);
+    }
+
+    /**
+     * @brief Sets time after which execution fails if it did not finish, 0 if not limited
+     */
+    void setTimeout(const std::chrono::microseconds& timeout) {
+        this->timeout = timeout;
+    }
+
 private:
     std::map<const std::string, bool> prepareStatusMap() const;
+
+    void start(PipelineCompletionCallback onComplete);
+
+    /**
+     * @brief Records node notification, may be called from any thread
+     */
+    void push(Node& node) override;
+
+    /**
+     * @brief Records notification of node or of expired timeout as nullptr, may be called from any thread
+     */
+    void enqueue(Node* node);
+
+    void processNotifications();
+
+    /**
+     * @brief Arms timer notifying about expired timeout of the pipeline, when node is nullptr, or of the node
+     */
+    void armDeadlineTimer(const Node* node, const std::chrono::microseconds& timeout);
+    void cancelDeadlineTimer(const Node* node);
+    void cancelDeadlineTimers();
+
+    /**
+     * @brief Fails pipeline once its timeout or timeout of one of its nodes expired and reports result right away
+     *
+     * @return true if pipeline execution is finished
+     */
+    bool handleDeadlineExceeded();
+
+    /**
+     * @brief Passes result to onResult if it was not reported yet
+     */
+    void reportResult(const Status& status);
+
+    /**
+     * @brief Frees requests for stream id of deferred nodes, which will never be executed after an error
+     *
+     * @return true if pipeline execution is finished
+     */
+    bool releaseDeferredNodes();
+
+    /**
+     * @brief Handles notification of single node
+     *
+     * @return true if pipeline execution is finished
+     */
+    bool handleNotification(Node& node);
+
+    /**
+     * @brief Starts node, readyTime is notification time of dependency which made it ready, if there was any
+     */
+    void startNode(Node& node, std::optional<std::chrono::steady_clock::time_point> readyTime = std::nullopt);
+
+    /**
+     * @brief Starts ready node, or finishes it right away together with its dependants if any of its dependencies was skipped
+     *
+     * Exit node is always started, so that response contains outputs of nodes which were not skipped.
+     * Nodes pruned by output filter are finished the same way.
+     */
+    void startOrSkipNode(Node& node, std::chrono::steady_clock::time_point readyTime);
+
+    /**
+     * @brief Runs node unless other node with the same model already ran or runs with the same inputs
+     *
+     * @return true if node execution was memoized
+     */
+    bool tryMemoizeNode(Node& node);
+
+    /**
+     * @brief Passes outputs of finished leader node to nodes waiting for them, followers are finished without outputs after error
+     */
+    void finishMemoizedFollowers(const Node& leader, BlobMap outputs);
+
+    void findMemoizableNodes();
+
+    /**
+     * @brief Finds nodes which outputs are not needed for outputs selected by request, so that they are not executed
+     */
+    void findPrunedNodes();
 };
 
 }  // namespace ovms
@@ -22,12 +22,13 @@ namespace ovms {
 Status PipelineFactory::createDefinition(const std::string& pipelineName,
     const std::vector<NodeInfo>& nodeInfos,
     const pipeline_connections_t& connections,
-    ModelManager& manager) {
+    ModelManager& manager,
+    bool networkFusion) {
     if (definitionExists(pipelineName)) {
         SPDLOG_WARN("Two pipelines with the same name:{} defined in config file. Ignoring the second definition", pipelineName);
         return StatusCode::PIPELINE_DEFINITION_ALREADY_EXIST;
     }
-    std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>(pipelineName, nodeInfos, connections);
+    std::unique_ptr<PipelineDefinition> pipelineDefinition = std::make_unique<PipelineDefinition>(pipelineName, nodeInfos, connections, networkFusion);
 
     pipelineDefinition->makeSubscriptions(manager);
     Status validationResult = pipelineDefinition->validate(manager);
@@ -38,6 +39,11 @@ Status PipelineFactory::createDefinition(const std::string& pipelineName,
 
     std::unique_lock lock(definitionsMtx);
     definitions[pipelineName] = std::move(pipelineDefinition);
+    auto snapshot = std::make_shared<std::map<std::string, PipelineDefinition*>>();
+    for (const auto& [name, definition] : definitions) {
+        snapshot->emplace(name, definition.get());
+    }
+    std::atomic_store(&definitionsSnapshot, std::shared_ptr<const std::map<std::string, PipelineDefinition*>>(std::move(snapshot)));
 
     SPDLOG_INFO("Loading pipeline definition:{} succeeded", pipelineName);
     return StatusCode::OK;
@@ -48,13 +54,11 @@ Status PipelineFactory::create(std::unique_ptr<Pipeline>& pipeline,
     const tensorflow::serving::PredictRequest* request,
     tensorflow::serving::PredictResponse* response,
     ModelManager& manager) const {
-    if (!definitionExists(name)) {
+    auto definition = findDefinitionByName(name);
+    if (definition == nullptr) {
         SPDLOG_INFO("Pipeline with requested name:{} does not exist", name);
         return StatusCode::PIPELINE_DEFINITION_NAME_MISSING;
     }
-    std::shared_lock lock(definitionsMtx);
-    auto& definition = *definitions.at(name);
-    lock.unlock();
-    return definition.create(pipeline, request, response, manager);
+    return definition->create(pipeline, request, response, manager);
 }
 }  // namespace ovms
@@ -29,6 +29,7 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "lockmetrics.hpp"
 #include "pipeline.hpp"
 #include "pipelinedefinition.hpp"
 #include "status.hpp"
@@ -39,17 +40,23 @@ class ModelManager;
 
 class PipelineFactory {
     std::map<std::string, std::unique_ptr<PipelineDefinition>> definitions;
-    mutable std::shared_mutex definitionsMtx;
+    mutable InstrumentedMutex<std::shared_mutex> definitionsMtx{"pipeline_definitions"};
+
+    /**
+     * @brief Definitions published after each change, read by requests without locking definitionsMtx
+     */
+    std::shared_ptr<const std::map<std::string, PipelineDefinition*>> definitionsSnapshot =
+        std::make_shared<const std::map<std::string, PipelineDefinition*>>();
 
 public:
     Status createDefinition(const std::string& pipelineName,
         const std::vector<NodeInfo>& nodeInfos,
         const pipeline_connections_t& connections,
-        ModelManager& manager);
+        ModelManager& manager,
+        bool networkFusion = false);
 
     bool definitionExists(const std::string& name) const {
-        std::shared_lock lock(definitionsMtx);
-        return definitions.count(name) == 1;
+        return std::atomic_load(&definitionsSnapshot)->count(name) == 1;
     }
 
     Status create(std::unique_ptr<Pipeline>& pipeline,
@@ -58,25 +65,33 @@ public:
         tensorflow::serving::PredictResponse* response,
         ModelManager& manager) const;
 
+    /**
+     * @brief Gets definitions published by last change
+     */
+    std::shared_ptr<const std::map<std::string, PipelineDefinition*>> getDefinitionsSnapshot() const {
+        return std::atomic_load(&definitionsSnapshot);
+    }
+
     PipelineDefinition* findDefinitionByName(const std::string& name) const {
-        std::shared_lock lock(definitionsMtx);
-        auto it = definitions.find(name);
-        if (it == std::end(definitions)) {
+        const auto snapshot = std::atomic_load(&definitionsSnapshot);
+        auto it = snapshot->find(name);
+        if (it == std::end(*snapshot)) {
             return nullptr;
         } else {
-            return it->second.get();
+            return it->second;
         }
     }
     Status reloadDefinition(const std::string& pipelineName,
         const std::vector<NodeInfo>&& nodeInfos,
         const pipeline_connections_t&& connections,
-        ModelManager& manager) {
+        ModelManager& manager,
+        bool networkFusion = false) {
         auto pd = findDefinitionByName(pipelineName);
         if (pd == nullptr) {
             SPDLOG_ERROR("Requested to reload pipeline definition but it does not exist:{}", pipelineName);
             return StatusCode::UNKNOWN_ERROR;
         }
-        return pd->reload(manager, std::move(nodeInfos), std::move(connections));
+        return pd->reload(manager, std::move(nodeInfos), std::move(connections), networkFusion);
     }
     void retireOtherThan(std::set<std::string>&& pipelinesInConfigFile, ModelManager& manager) {
         std::for_each(definitions.begin(),
@@ -0,0 +1,152 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "pipelinebatcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "batchsplitting.hpp"
+#include "pipeline.hpp"
+#include "pipelinedefinition.hpp"
+
+namespace ovms {
+
+namespace {
+struct MergedExecution {
+    tensorflow::serving::PredictRequest request;
+    tensorflow::serving::PredictResponse response;
+};
+
+// merged request is executed with output filter of the first request
+bool haveSameOutputFilter(const tensorflow::serving::PredictRequest& first, const tensorflow::serving::PredictRequest& second) {
+    return std::equal(first.output_filter().begin(), first.output_filter().end(), second.output_filter().begin(), second.output_filter().end());
+}
+}  // namespace
+
+PipelineBatcher::PipelineBatcher(PipelineDefinition& definition, ModelManager& manager, size_t maxBatchSize, uint64_t batchTimeoutMicroseconds) :
+    definition(definition),
+    manager(manager),
+    maxBatchSize(maxBatchSize),
+    batchTimeoutMicroseconds(batchTimeoutMicroseconds) {}
+
+void PipelineBatcher::closeBatch(const std::shared_ptr<Batch>& batch) {
+    batch->closed = true;
+    if (formingBatch == batch) {
+        formingBatch.reset();
+    }
+    batch->closedNotify.notify_one();
+}
+
+Status PipelineBatcher::executeSingle(const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response,
+    std::shared_ptr<void> keepAlive) {
+    std::unique_ptr<Pipeline> pipeline;
+    auto status = definition.create(pipeline, request, response, manager);
+    if (!status.ok()) {
+        return status;
+    }
+    return Pipeline::executeAndRelease(std::move(pipeline), std::move(keepAlive));
+}
+
+Status PipelineBatcher::execute(const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response,
+    std::shared_ptr<void> keepAlive) {
+    BatchedRequest batchedRequest{request, response, getMergeableBatchSize(*request)};
+    if (batchedRequest.batchSize == 0 || batchedRequest.batchSize >= maxBatchSize) {
+        return executeSingle(request, response, keepAlive);
+    }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    if (formingBatch && (formingBatch->batchSize + batchedRequest.batchSize > maxBatchSize ||
+                            !haveSameSampleShapes(*formingBatch->requests.front()->request, *request) ||
+                            !haveSameOutputFilter(*formingBatch->requests.front()->request, *request))) {
+        // Request does not fit, dispatch forming batch right away and start a new one
+        closeBatch(formingBatch);
+    }
+    bool isLeader = false;
+    if (!formingBatch) {
+        formingBatch = std::make_shared<Batch>();
+        isLeader = true;
+    }
+    auto batch = formingBatch;
+    batch->requests.push_back(&batchedRequest);
+    batch->batchSize += batchedRequest.batchSize;
+    if (batch->batchSize == maxBatchSize) {
+        closeBatch(batch);
+    }
+
+    if (!isLeader) {
+        batch->finishedNotify.wait(lock, [&batch]() { return batch->finished; });
+        if (!batch->executeSeparately) {
+            return batch->status;
+        }
+        lock.unlock();
+        return executeSingle(request, response, keepAlive);
+    }
+
+    batch->closedNotify.wait_for(lock, std::chrono::microseconds(batchTimeoutMicroseconds), [&batch]() { return batch->closed; });
+    if (!batch->closed) {
+        closeBatch(batch);
+    }
+    lock.unlock();
+
+    // Closed batch is not modified by other threads anymore
+    Status status;
+    if (batch->requests.size() == 1) {
+        status = executeSingle(request, response, keepAlive);
+    } else {
+        status = executeBatch(*batch);
+    }
+
+    lock.lock();
+    if (!status.ok() && batch->requests.size() > 1) {
+        SPDLOG_DEBUG("Executing {} merged requests of pipeline:{} failed: {}. Executing them separately",
+            batch->requests.size(), definition.getName(), status.string());
+        batch->executeSeparately = true;
+    }
+    batch->status = status;
+    batch->finished = true;
+    lock.unlock();
+    batch->finishedNotify.notify_all();
+    if (batch->executeSeparately) {
+        return executeSingle(request, response, keepAlive);
+    }
+    return status;
+}
+
+Status PipelineBatcher::executeBatch(const Batch& batch) {
+    std::vector<const tensorflow::serving::PredictRequest*> requests;
+    std::vector<tensorflow::serving::PredictResponse*> responses;
+    std::vector<size_t> batchSizes;
+    for (const auto* batchedRequest : batch.requests) {
+        requests.push_back(batchedRequest->request);
+        responses.push_back(batchedRequest->response);
+        batchSizes.push_back(batchedRequest->batchSize);
+    }
+    // merged request and response are kept by nodes still running after pipeline timeout
+    auto merged = std::make_shared<MergedExecution>();
+    mergeRequestBatches(requests, merged->request);
+    SPDLOG_DEBUG("Executing pipeline:{} for {} merged requests with batch size:{}", definition.getName(), requests.size(), batch.batchSize);
+    auto status = executeSingle(&merged->request, &merged->response, merged);
+    if (!status.ok()) {
+        return status;
+    }
+    return splitResponseBatches(merged->response, batchSizes, responses);
+}
+
+}  // namespace ovms
@@ -0,0 +1,99 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+class ModelManager;
+class PipelineDefinition;
+
+/**
+ * @brief Merges concurrent predict requests of a single pipeline into one pipeline execution.
+ *
+ * First request of a batch becomes its leader: it waits up to batch_timeout_microseconds for other requests
+ * with the same inputs sample shapes to join, concatenates their inputs along first dimension and executes
+ * the pipeline once on behalf of all of them. Exit node outputs are split back to requests responses along
+ * first dimension. Batch is dispatched earlier when it gets full or when request with different sample shapes comes.
+ * When merged execution fails or its outputs are not batched, requests of the batch are executed separately.
+ */
+class PipelineBatcher {
+    struct BatchedRequest {
+        const tensorflow::serving::PredictRequest* request;
+        tensorflow::serving::PredictResponse* response;
+        size_t batchSize;
+    };
+
+    struct Batch {
+        std::vector<BatchedRequest*> requests;
+        size_t batchSize = 0;
+        bool closed = false;
+        bool finished = false;
+        bool executeSeparately = false;
+        Status status = StatusCode::OK;
+        std::condition_variable closedNotify;
+        std::condition_variable finishedNotify;
+    };
+
+    PipelineDefinition& definition;
+    ModelManager& manager;
+    const size_t maxBatchSize;
+    const uint64_t batchTimeoutMicroseconds;
+
+    std::mutex mtx;
+    std::shared_ptr<Batch> formingBatch;
+
+    void closeBatch(const std::shared_ptr<Batch>& batch);
+
+    Status executeSingle(const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response,
+        std::shared_ptr<void> keepAlive);
+
+    /**
+     * @brief Executes merged requests of closed batch, fills responses of all batch requests on success
+     */
+    Status executeBatch(const Batch& batch);
+
+public:
+    PipelineBatcher(PipelineDefinition& definition, ModelManager& manager, size_t maxBatchSize, uint64_t batchTimeoutMicroseconds);
+
+    size_t getMaxBatchSize() const { return maxBatchSize; }
+    uint64_t getBatchTimeoutMicroseconds() const { return batchTimeoutMicroseconds; }
+
+    /**
+     * @brief Executes pipeline for request merged with concurrent ones and blocks until its response is ready
+     *
+     * @param request
+     * @param response
+     * @param keepAlive keeps request and response until nodes still running after pipeline timeout are finished
+     *
+     * @return Status
+     */
+    Status execute(const tensorflow::serving::PredictRequest* request, tensorflow::serving::PredictResponse* response,
+        std::shared_ptr<void> keepAlive);
+};
+
+}  // namespace ovms
@@ -15,10 +15,17 @@
 //*****************************************************************************
 #include "pipelinedefinition.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <map>
 #include <set>
 #include <thread>
+#include <unordered_set>
 
+#include "fused_dl_node.hpp"
+#include "fusednetwork.hpp"
+#include "gather_node.hpp"
+#include "get_model_metadata_impl.hpp"
 #include "pipelinedefinitionunloadguard.hpp"
 #include "prediction_service_utils.hpp"
 
@@ -29,36 +36,82 @@ Status toNodeKind(const std::string& str, NodeKind& nodeKind) {
         nodeKind = NodeKind::DL;
         return StatusCode::OK;
     }
+    if (str == DEMULTIPLEXER_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::DEMULTIPLEXER;
+        return StatusCode::OK;
+    }
+    if (str == GATHER_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::GATHER;
+        return StatusCode::OK;
+    }
+    if (str == PREPROCESSING_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::PREPROCESSING;
+        return StatusCode::OK;
+    }
+    if (str == POSTPROCESSING_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::POSTPROCESSING;
+        return StatusCode::OK;
+    }
+    if (str == REMOTE_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::REMOTE;
+        return StatusCode::OK;
+    }
+    if (str == CUSTOM_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::CUSTOM;
+        return StatusCode::OK;
+    }
+    if (str == GATE_NODE_CONFIG_TYPE) {
+        nodeKind = NodeKind::GATE;
+        return StatusCode::OK;
+    }
     SPDLOG_ERROR("Unsupported node type:{}", str);
     return StatusCode::PIPELINE_NODE_WRONG_KIND_CONFIGURATION;
 }
 
 Status PipelineDefinition::validate(ModelManager& manager) {
-    ValidationResultNotifier notifier(status, loadedNotify);
-    Status validationResult = validateNodes(manager);
-    if (!validationResult.ok()) {
-        return validationResult;
-    }
-
-    validationResult = validateForCycles();
-    if (!validationResult.ok()) {
-        return validationResult;
+    Status validationResult;
+    {
+        ValidationResultNotifier notifier(status, loadedNotify);
+        LoadingPhaseTimer validationTimer(loadingProfile, LoadingPhase::VALIDATION);
+        validationResult = validateNodes(manager);
+        if (validationResult.ok()) {
+            validationResult = validateForCycles();
+        }
+        notifier.passed = validationResult.ok();
     }
-    notifier.passed = true;
+    // fusion requires definition to be available, so it is done once validation result is published
+    fuseNetworks(manager);
     return validationResult;
 }
 
-Status PipelineDefinition::reload(ModelManager& manager, const std::vector<NodeInfo>&& nodeInfos, const pipeline_connections_t&& connections) {
-    resetSubscriptions(manager);
-    while (requestsHandlesCounter > 0) {
-        std::this_thread::sleep_for(std::chrono::microseconds(1));
+Status PipelineDefinition::reload(ModelManager& manager, const std::vector<NodeInfo>&& nodeInfos, const pipeline_connections_t&& connections, bool networkFusion) {
+    // new structure is validated aside while requests keep using the current one, then both are swapped at once
+    PipelineDefinition candidate(pipelineName, nodeInfos, connections);
+    Status validationResult;
+    {
+        LoadingPhaseTimer validationTimer(loadingProfile, LoadingPhase::VALIDATION);
+        validationResult = candidate.validateNodes(manager);
+        if (validationResult.ok()) {
+            validationResult = candidate.validateForCycles();
+        }
     }
 
-    this->nodeInfos = std::move(nodeInfos);
-    this->connections = std::move(connections);
+    resetSubscriptions(manager);
+    {
+        std::unique_lock lock(loadMtx);
+        std::swap(this->nodeInfos, candidate.nodeInfos);
+        std::swap(this->connections, candidate.connections);
+        this->pipelinePool->invalidate();
+    }
     makeSubscriptions(manager);
 
-    return validate(manager);
+    {
+        ValidationResultNotifier notifier(status, loadedNotify);
+        notifier.passed = validationResult.ok();
+    }
+    this->networkFusion = networkFusion;
+    fuseNetworks(manager);
+    return validationResult;
 }
 
 void PipelineDefinition::retire(ModelManager& manager) {
@@ -69,6 +122,8 @@ void PipelineDefinition::retire(ModelManager& manager) {
     }
     this->nodeInfos.clear();
     this->connections.clear();
+    std::atomic_store(&this->fusedChains, std::shared_ptr<const std::vector<FusedChain>>());
+    this->pipelinePool->invalidate();
 }
 
 Status PipelineDefinition::waitForLoaded(std::unique_ptr<PipelineDefinitionUnloadGuard>& unloadGuard, const uint waitForLoadedTimeoutMicroseconds) {
@@ -110,6 +165,147 @@ Status PipelineDefinition::waitForLoaded(std::unique_ptr<PipelineDefinitionUnloa
     return StatusCode::OK;
 }
 
+void PipelineDefinition::setBatching(ModelManager& manager, size_t maxBatchSize, uint64_t batchTimeoutMicroseconds) {
+    auto current = getBatcher();
+    if (maxBatchSize == 0) {
+        std::atomic_store(&batcher, std::shared_ptr<PipelineBatcher>());
+        return;
+    }
+    if (current && current->getMaxBatchSize() == maxBatchSize && current->getBatchTimeoutMicroseconds() == batchTimeoutMicroseconds) {
+        return;
+    }
+    SPDLOG_INFO("Pipeline:{} merges concurrent requests up to batch size:{} with timeout:{} microseconds", getName(), maxBatchSize, batchTimeoutMicroseconds);
+    // requests already waiting in previous batcher finish with it, shared pointer keeps it alive
+    std::atomic_store(&batcher, std::make_shared<PipelineBatcher>(*this, manager, maxBatchSize, batchTimeoutMicroseconds));
+}
+
+void PipelineDefinition::setNetworkFusion(ModelManager& manager, bool networkFusion) {
+    this->networkFusion = networkFusion;
+    fuseNetworks(manager);
+}
+
+std::vector<std::vector<const NodeInfo*>> PipelineDefinition::findFusibleChains(ModelManager& manager) const {
+    std::unordered_map<std::string, std::vector<std::string>> dependants;
+    for (const auto& [dependantName, dependencies] : connections) {
+        for (const auto& dependency : dependencies) {
+            dependants[dependency.first].push_back(dependantName);
+        }
+    }
+    const auto isFusibleModel = [&manager](const NodeInfo& info) {
+        if (info.kind != NodeKind::DL) {
+            return false;
+        }
+        auto instance = manager.findModelInstance(info.modelName, info.modelVersion.value_or(0));
+        if (instance == nullptr || instance->getBatchingScheduler() != nullptr || instance->getNetworkFunction() == nullptr) {
+            return false;
+        }
+        const auto& config = instance->getModelConfig();
+        return config.getBatchingMode() != Mode::AUTO && !config.anyShapeSetToAuto();
+    };
+    const auto findInfo = [this](const std::string& nodeName) -> const NodeInfo* {
+        auto it = std::find_if(nodeInfos.begin(), nodeInfos.end(), [&nodeName](const NodeInfo& info) { return info.nodeName == nodeName; });
+        return it == nodeInfos.end() ? nullptr : &(*it);
+    };
+    // node following given node in fusible chain or nullptr
+    const auto findNextInChain = [&](const NodeInfo& info) -> const NodeInfo* {
+        auto it = dependants.find(info.nodeName);
+        if (it == dependants.end() || it->second.size() != 1) {
+            return nullptr;
+        }
+        const auto* next = findInfo(it->second.front());
+        if (next == nullptr || connections.at(next->nodeName).size() != 1 || !isFusibleModel(*next)) {
+            return nullptr;
+        }
+        if (manager.findModelInstance(info.modelName, info.modelVersion.value_or(0))->getTargetDevice() !=
+            manager.findModelInstance(next->modelName, next->modelVersion.value_or(0))->getTargetDevice()) {
+            return nullptr;
+        }
+        return next;
+    };
+    std::unordered_set<std::string> chained;
+    std::vector<std::vector<const NodeInfo*>> chains;
+    // chains are started from nodes which do not follow other fusible node
+    for (const auto& info : nodeInfos) {
+        if (!isFusibleModel(info)) {
+            continue;
+        }
+        auto it = connections.find(info.nodeName);
+        if (it != connections.end() && it->second.size() == 1) {
+            const auto* previous = findInfo(it->second.begin()->first);
+            if (previous != nullptr && isFusibleModel(*previous) && findNextInChain(*previous) == &info) {
+                continue;
+            }
+        }
+        std::vector<const NodeInfo*> chain{&info};
+        while (const auto* next = findNextInChain(*chain.back())) {
+            if (!chained.insert(next->nodeName).second) {
+                break;
+            }
+            chain.push_back(next);
+        }
+        if (chain.size() > 1) {
+            chains.push_back(std::move(chain));
+        }
+    }
+    return chains;
+}
+
+void PipelineDefinition::fuseNetworks(ModelManager& manager) {
+    std::shared_ptr<std::vector<FusedChain>> chains;
+    if (this->networkFusion && this->status.isAvailable()) {
+        chains = std::make_shared<std::vector<FusedChain>>();
+        std::shared_lock lock(loadMtx);
+        for (const auto& nodes : findFusibleChains(manager)) {
+            FusedChain chain;
+            std::vector<FusedNetworkStage> stages;
+            bool timeoutLimited = true;
+            for (const auto* info : nodes) {
+                FusedNetworkStage stage;
+                stage.nodeName = info->nodeName;
+                stage.model = manager.findModelInstance(info->modelName, info->modelVersion.value_or(0));
+                stage.outputNameAliases = info->outputNameAliases;
+                if (!stages.empty()) {
+                    stage.inputs = connections.at(info->nodeName).at(stages.back().nodeName);
+                }
+                stages.push_back(std::move(stage));
+                chain.nodeNames.push_back(info->nodeName);
+                chain.timeoutMicroseconds += info->timeoutMicroseconds;
+                timeoutLimited = timeoutLimited && info->timeoutMicroseconds > 0;
+            }
+            if (!timeoutLimited) {
+                chain.timeoutMicroseconds = 0;
+            }
+            auto fusionStatus = FusedNetwork::create(getName() + "/" + chain.nodeNames.back(), stages, chain.network);
+            if (!fusionStatus.ok()) {
+                SPDLOG_INFO("Pipeline:{} nodes from:{} to:{} run separately since they cannot be fused: {}",
+                    getName(), chain.nodeNames.front(), chain.nodeNames.back(), fusionStatus.string());
+                continue;
+            }
+            SPDLOG_INFO("Pipeline:{} runs {} nodes from:{} to:{} as single fused network",
+                getName(), chain.nodeNames.size(), chain.nodeNames.front(), chain.nodeNames.back());
+            chains->push_back(std::move(chain));
+        }
+        if (chains->empty()) {
+            chains.reset();
+        }
+    }
+    std::atomic_store(&this->fusedChains, std::shared_ptr<const std::vector<FusedChain>>(std::move(chains)));
+    this->pipelinePool->invalidate();
+}
+
+std::shared_ptr<const ModelMetadataCacheEntry> PipelineDefinition::getMetadataCache() const {
+    auto entry = std::atomic_load(&metadataCache);
+    if (entry && entry->generation != pipelinePool->getGeneration()) {
+        return nullptr;
+    }
+    return entry;
+}
+
+void PipelineDefinition::setMetadataCache(std::shared_ptr<ModelMetadataCacheEntry> entry, uint64_t generation) {
+    entry->generation = generation;
+    std::atomic_store(&metadataCache, std::shared_ptr<const ModelMetadataCacheEntry>(std::move(entry)));
+}
+
 Status PipelineDefinition::create(std::unique_ptr<Pipeline>& pipeline,
     const tensorflow::serving::PredictRequest* request,
     tensorflow::serving::PredictResponse* response,
@@ -120,10 +316,53 @@ Status PipelineDefinition::create(std::unique_ptr<Pipeline>& pipeline,
         return status;
     }
 
+    auto pooledGraph = pipelinePool->tryAcquire();
+    if (pooledGraph) {
+        SPDLOG_DEBUG("Reusing pooled pipeline:{}", getName());
+        pooledGraph->entry->setRequest(request);
+        pooledGraph->exit->setResponse(response);
+        pooledGraph->exit->setRequest(request);
+        pooledGraph->exit->setFp16Outputs(fp16Outputs);
+        pipeline = std::make_unique<Pipeline>(std::move(pooledGraph.value()), pipelinePool, pipelineName);
+        pipeline->setTimeout(std::chrono::microseconds(timeoutMicroseconds));
+        pipeline->setMetrics(metrics);
+        return status;
+    }
+
+    std::shared_lock lock(loadMtx);
+    PipelineGraph graph;
+    graph.generation = pipelinePool->getGeneration();
     std::unordered_map<std::string, std::unique_ptr<Node>> nodes;
     EntryNode* entry = nullptr;
     ExitNode* exit = nullptr;
+    // nodes of fused chain are replaced with single node named like the last node of the chain
+    auto fused = getFusedChains();
+    std::unordered_map<std::string, const FusedChain*> fusedNodes;
+    if (fused) {
+        for (const auto& chain : *fused) {
+            for (const auto& nodeName : chain.nodeNames) {
+                fusedNodes.emplace(nodeName, &chain);
+            }
+        }
+    }
     for (const auto& info : nodeInfos) {
+        auto fusedIt = fusedNodes.find(info.nodeName);
+        if (fusedIt != fusedNodes.end()) {
+            const auto& chain = *fusedIt->second;
+            if (chain.nodeNames.back() != info.nodeName) {
+                continue;
+            }
+            SPDLOG_DEBUG("Creating pipeline:{}. Adding nodeName:{} running fused network:{}",
+                getName(), info.nodeName, chain.network->getName());
+            auto node = std::make_unique<FusedDLNode>(info.nodeName,
+                chain.network,
+                info.outputNameAliases,
+                info.zeroCopyOutputs || isPassingOutputsToExitOnly(info));
+            node->setTimeout(std::chrono::microseconds(chain.timeoutMicroseconds));
+            node->setMetrics(&metrics->getNode(info.nodeName));
+            nodes.insert(std::make_pair(info.nodeName, std::move(node)));
+            continue;
+        }
         SPDLOG_DEBUG("Creating pipeline:{}. Adding nodeName:{}, modelName:{}",
             getName(), info.nodeName, info.modelName);
         switch (info.kind) {
@@ -138,10 +377,49 @@ Status PipelineDefinition::create(std::unique_ptr<Pipeline>& pipeline,
                                                            info.modelName,
                                                            info.modelVersion,
                                                            manager,
-                                                           info.outputNameAliases))));
+                                                           info.outputNameAliases,
+                                                           info.zeroCopyOutputs || isPassingOutputsToExitOnly(info)))));
+            break;
+        case NodeKind::DEMULTIPLEXER:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<DemultiplexerNode>(info.nodeName,
+                                                           info.demultiplexerParameters,
+                                                           info.outputNameAliases)));
+            break;
+        case NodeKind::GATHER:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<GatherNode>(info.nodeName,
+                                                           info.outputNameAliases)));
+            break;
+        case NodeKind::PREPROCESSING:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<PreprocessingNode>(info.nodeName,
+                                                           info.preprocessingParameters,
+                                                           info.outputNameAliases)));
+            break;
+        case NodeKind::POSTPROCESSING:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<PostprocessingNode>(info.nodeName,
+                                                           info.postprocessingParameters,
+                                                           info.outputNameAliases)));
+            break;
+        case NodeKind::REMOTE:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<RemoteNode>(info.nodeName,
+                                                           info.modelName,
+                                                           info.modelVersion,
+                                                           info.remoteParameters,
+                                                           info.outputNameAliases)));
+            break;
+        case NodeKind::CUSTOM:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<CustomNode>(info.nodeName,
+                                                           info.customNodeParameters,
+                                                           info.outputNameAliases)));
+            break;
+        case NodeKind::GATE:
+            nodes.insert(std::make_pair(info.nodeName, std::make_unique<GateNode>(info.nodeName,
+                                                           info.gateParameters,
+                                                           info.outputNameAliases)));
             break;
         case NodeKind::EXIT: {
             auto node = std::make_unique<ExitNode>(response);
+            node->setRequest(request);
+            node->setFp16Outputs(fp16Outputs);
             exit = node.get();
             nodes.insert(std::make_pair(info.nodeName, std::move(node)));
             break;
@@ -149,22 +427,57 @@ Status PipelineDefinition::create(std::unique_ptr<Pipeline>& pipeline,
         default:
             throw std::invalid_argument("unknown node kind");
         }
+        nodes.at(info.nodeName)->setTimeout(std::chrono::microseconds(info.timeoutMicroseconds));
+        nodes.at(info.nodeName)->setMetrics(&metrics->getNode(info.nodeName));
     }
     for (const auto& kv : connections) {
-        const auto& dependantNode = nodes.at(kv.first);
+        auto dependantName = kv.first;
+        auto fusedIt = fusedNodes.find(kv.first);
+        if (fusedIt != fusedNodes.end()) {
+            // connections inside fused chain are dropped, inputs of the first node are inputs of the fused node
+            if (fusedIt->second->nodeNames.front() != kv.first) {
+                continue;
+            }
+            dependantName = fusedIt->second->nodeNames.back();
+        }
+        const auto& dependantNode = nodes.at(dependantName);
         for (const auto& pair : kv.second) {
             const auto& dependencyNode = nodes.at(pair.first);
             SPDLOG_DEBUG("Connecting pipeline:{}, from:{}, to:{}", getName(), dependencyNode->getName(), dependantNode->getName());
             Pipeline::connect(*dependencyNode, *dependantNode, pair.second);
         }
     }
-    pipeline = std::make_unique<Pipeline>(*entry, *exit, pipelineName);
+    graph.entry = entry;
+    graph.exit = exit;
     for (auto& kv : nodes) {
-        pipeline->push(std::move(kv.second));
+        graph.nodes.emplace_back(std::move(kv.second));
     }
+    pipeline = std::make_unique<Pipeline>(std::move(graph), pipelinePool, pipelineName);
+    pipeline->setTimeout(std::chrono::microseconds(timeoutMicroseconds));
     return status;
 }
 
+bool PipelineDefinition::isPassingOutputsToExitOnly(const NodeInfo& node) const {
+    bool hasDependants = false;
+    for (const auto& [dependantName, dependencies] : connections) {
+        if (dependencies.count(node.nodeName) == 0) {
+            continue;
+        }
+        auto dependantInfo = std::find_if(nodeInfos.begin(), nodeInfos.end(),
+            [&dependantName](const NodeInfo& info) { return info.nodeName == dependantName; });
+        if (dependantInfo == nodeInfos.end() || dependantInfo->kind != NodeKind::EXIT) {
+            return false;
+        }
+        hasDependants = true;
+    }
+    if (!hasDependants) {
+        return false;
+    }
+    return std::none_of(nodeInfos.begin(), nodeInfos.end(), [&node](const NodeInfo& info) {
+        return info.kind == NodeKind::DL && info.nodeName != node.nodeName && info.modelName == node.modelName;
+    });
+}
+
 void PipelineDefinition::resetSubscriptions(ModelManager& manager) {
     for (auto& [modelName, modelVersion] : subscriptions) {
         if (modelVersion) {
@@ -216,29 +529,65 @@ void PipelineDefinition::makeSubscriptions(ModelManager& manager) {
     }
 }
 
+/**
+ * @brief State shared by validators of all nodes in single validation pass
+ */
+struct NodeValidationContext {
+    NodeValidationContext(ModelManager& manager, const std::vector<NodeInfo>& nodeInfos) :
+        manager(manager) {
+        for (const auto& info : nodeInfos) {
+            nodeInfosByName.emplace(info.nodeName, &info);
+        }
+    }
+
+    /**
+     * @brief Gets model instance, fetched once per validation pass and kept loaded until it ends
+     */
+    Status getModelInstance(const std::string& modelName, model_version_t modelVersion, std::shared_ptr<ModelInstance>& modelInstance) {
+        const auto key = std::make_pair(modelName, modelVersion);
+        auto it = modelInstances.find(key);
+        if (it != modelInstances.end()) {
+            modelInstance = it->second;
+            return StatusCode::OK;
+        }
+        std::unique_ptr<ModelInstanceUnloadGuard> unloadGuard;
+        auto status = ovms::getModelInstance(manager, modelName, modelVersion, modelInstance, unloadGuard);
+        if (!status.ok()) {
+            return status;
+        }
+        modelInstances.emplace(key, modelInstance);
+        unloadGuards.emplace_back(std::move(unloadGuard));
+        return status;
+    }
+
+    ModelManager& manager;
+    std::unordered_map<std::string, const NodeInfo*> nodeInfosByName;
+
+private:
+    std::map<std::pair<std::string, model_version_t>, std::shared_ptr<ModelInstance>> modelInstances;
+    std::vector<std::unique_ptr<ModelInstanceUnloadGuard>> unloadGuards;
+};
+
 class NodeValidator {
     const std::string& pipelineName;
-    ModelManager& manager;
+    NodeValidationContext& context;
     const NodeInfo& dependantNodeInfo;
     const pipeline_connections_t& connections;
-    const std::vector<NodeInfo>& nodeInfos;
 
-    std::unique_ptr<ModelInstanceUnloadGuard> dependantModelUnloadGuard;
     std::shared_ptr<ModelInstance> dependantModelInstance;
     std::set<std::string> remainingUnconnectedDependantModelInputs;
+    std::set<std::string> builtInNodeInputs;
 
 public:
     NodeValidator(
         const std::string& pipelineName,
-        ModelManager& manager,
+        NodeValidationContext& context,
         const NodeInfo& dependantNodeInfo,
-        const pipeline_connections_t& connections,
-        const std::vector<NodeInfo>& nodeInfos) :
+        const pipeline_connections_t& connections) :
         pipelineName(pipelineName),
-        manager(manager),
+        context(context),
         dependantNodeInfo(dependantNodeInfo),
-        connections(connections),
-        nodeInfos(nodeInfos) {
+        connections(connections) {
         SPDLOG_DEBUG("Validation of pipeline: {}; node name: {}; node kind: {}",
             pipelineName,
             dependantNodeInfo.nodeName,
@@ -246,13 +595,7 @@ public:
     }
 
     Status fetchUnderlyingModelInstance() {
-        if (!getModelInstance(
-                manager,
-                dependantNodeInfo.modelName,
-                dependantNodeInfo.modelVersion.value_or(0),
-                dependantModelInstance,
-                dependantModelUnloadGuard)
-                 .ok()) {
+        if (!context.getModelInstance(dependantNodeInfo.modelName, dependantNodeInfo.modelVersion.value_or(0), dependantModelInstance).ok()) {
             SPDLOG_ERROR("Validation of pipeline({}) definition failed. Missing model: {}; version: {}",
                 pipelineName,
                 dependantNodeInfo.modelName,
@@ -262,19 +605,17 @@ public:
         return StatusCode::OK;
     }
 
-    Status getDependencyNodeInfo(const std::string& dependencyNodeName, std::vector<NodeInfo>::const_iterator& dependencyNodeInfo) {
+    Status getDependencyNodeInfo(const std::string& dependencyNodeName, const NodeInfo*& dependencyNodeInfo) {
         // Find dependency node info object.
-        dependencyNodeInfo = std::find_if(
-            std::begin(this->nodeInfos),
-            std::end(this->nodeInfos),
-            [dependencyNodeName](const NodeInfo& nodeInfo) { return nodeInfo.nodeName == dependencyNodeName; });
-        if (dependencyNodeInfo == std::end(this->nodeInfos)) {
+        auto it = context.nodeInfosByName.find(dependencyNodeName);
+        if (it == context.nodeInfosByName.end()) {
             SPDLOG_ERROR("Validation of pipeline({}) definition failed. Node (name:{}) is connected to missing dependency node (name:{})",
                 pipelineName,
                 dependantNodeInfo.nodeName,
                 dependencyNodeName);
             return StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_NODE;
         }
+        dependencyNodeInfo = it->second;
 
         if (dependencyNodeInfo->kind == NodeKind::EXIT) {
             SPDLOG_ERROR("Validation of pipeline({}) definition failed. Exit node used as dependency node",
@@ -297,6 +638,17 @@ public:
         return StatusCode::OK;
     }
 
+    Status checkForForbiddenStatefulModel() {
+        if (dependantModelInstance->getModelConfig().isStateful()) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Node name {} used stateful model name {} which is forbidden.",
+                pipelineName,
+                dependantNodeInfo.nodeName,
+                dependantNodeInfo.modelName);
+            return StatusCode::FORBIDDEN_MODEL_STATEFUL;
+        }
+        return StatusCode::OK;
+    }
+
     Status checkConnectionMappedToExistingDataSource(const NodeInfo& dependencyNodeInfo, std::shared_ptr<ModelInstance>& dependencyModelInstance, const std::string& dataSource) {
         // Check whether dependency node is configured to have required output.
         if (dependencyNodeInfo.outputNameAliases.count(dataSource) == 0) {
@@ -394,6 +746,174 @@ public:
         return StatusCode::OK;
     }
 
+    Status markNodeInputAsConnected(const std::string& name) {
+        // Built in nodes have fixed set of required inputs, gather and gate nodes accept any other input to be passed.
+        // Inputs of remote model and custom node library are known only to the server serving it or the library, each can be connected once.
+        if ((dependantNodeInfo.kind == NodeKind::REMOTE || dependantNodeInfo.kind == NodeKind::CUSTOM) && builtInNodeInputs.insert(name).second) {
+            remainingUnconnectedDependantModelInputs.insert(name);
+        }
+        if (builtInNodeInputs.count(name) == 0) {
+            if (dependantNodeInfo.kind == NodeKind::GATHER || dependantNodeInfo.kind == NodeKind::GATE) {
+                return StatusCode::OK;
+            }
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Node:{} has no input with name:{}",
+                pipelineName,
+                dependantNodeInfo.nodeName,
+                name);
+            return StatusCode::PIPELINE_CONNECTION_TO_MISSING_MODEL_INPUT;
+        }
+        if (remainingUnconnectedDependantModelInputs.erase(name) == 0) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Node:{} input name:{} is connected to more than one data source",
+                pipelineName,
+                dependantNodeInfo.nodeName,
+                name);
+            return StatusCode::PIPELINE_MODEL_INPUT_CONNECTED_TO_MULTIPLE_DATA_SOURCES;
+        }
+        return StatusCode::OK;
+    }
+
+    Status validateDemultiplexerParameters() {
+        const auto& parameters = dependantNodeInfo.demultiplexerParameters;
+        if (parameters.cropWidth == 0 || parameters.cropHeight == 0 || parameters.maxCrops == 0 ||
+            parameters.confidenceThreshold < 0 || parameters.confidenceThreshold > 1) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Demultiplexer node:{} requires positive crop_width, crop_height, max_crops and confidence_threshold in range [0, 1]",
+                pipelineName,
+                dependantNodeInfo.nodeName);
+            return StatusCode::PIPELINE_NODE_INVALID_PARAMETERS;
+        }
+        for (const auto& [alias, dataItem] : dependantNodeInfo.outputNameAliases) {
+            if (dataItem != DEMULTIPLEXER_CROPS_OUTPUT_NAME &&
+                dataItem != DEMULTIPLEXER_CROPS_COUNT_OUTPUT_NAME &&
+                dataItem != DEMULTIPLEXER_COORDINATES_OUTPUT_NAME) {
+                SPDLOG_ERROR("Validation of pipeline({}) definition failed. Demultiplexer node:{} has no output data item:{}",
+                    pipelineName,
+                    dependantNodeInfo.nodeName,
+                    dataItem);
+                return StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_DATA_SOURCE;
+            }
+        }
+        return StatusCode::OK;
+    }
+
+    Status validatePreprocessingParameters() {
+        const auto& parameters = dependantNodeInfo.preprocessingParameters;
+        if ((parameters.resizeWidth == 0) != (parameters.resizeHeight == 0) ||
+            (parameters.inputLayout != "NCHW" && parameters.inputLayout != "NHWC") ||
+            std::any_of(parameters.scale.begin(), parameters.scale.end(), [](float scale) { return scale == 0; })) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Preprocessing node:{} requires both or none of resize_width and resize_height, input_layout NCHW or NHWC and non zero scale values",
+                pipelineName,
+                dependantNodeInfo.nodeName);
+            return StatusCode::PIPELINE_NODE_INVALID_PARAMETERS;
+        }
+        for (const auto& [alias, dataItem] : dependantNodeInfo.outputNameAliases) {
+            if (dataItem != PREPROCESSING_IMAGE_OUTPUT_NAME) {
+                SPDLOG_ERROR("Validation of pipeline({}) definition failed. Preprocessing node:{} has no output data item:{}",
+                    pipelineName,
+                    dependantNodeInfo.nodeName,
+                    dataItem);
+                return StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_DATA_SOURCE;
+            }
+        }
+        return StatusCode::OK;
+    }
+
+    Status validatePostprocessingParameters() {
+        const auto& parameters = dependantNodeInfo.postprocessingParameters;
+        const auto outputNames = PostprocessingNode::getOutputNames(parameters.operation);
+        if (outputNames.empty() || parameters.topK == 0 ||
+            parameters.iouThreshold < 0 || parameters.iouThreshold > 1) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Postprocessing node:{} requires operation softmax, argmax, top_k or nms, non zero top_k and iou_threshold in range [0, 1]",
+                pipelineName,
+                dependantNodeInfo.nodeName);
+            return StatusCode::PIPELINE_NODE_INVALID_PARAMETERS;
+        }
+        for (const auto& [alias, dataItem] : dependantNodeInfo.outputNameAliases) {
+            if (outputNames.count(dataItem) == 0) {
+                SPDLOG_ERROR("Validation of pipeline({}) definition failed. Postprocessing node:{} with operation {} has no output data item:{}",
+                    pipelineName,
+                    dependantNodeInfo.nodeName,
+                    parameters.operation,
+                    dataItem);
+                return StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_DATA_SOURCE;
+            }
+        }
+        return StatusCode::OK;
+    }
+
+    Status validateRemoteParameters() {
+        const auto& address = dependantNodeInfo.remoteParameters.address;
+        const auto separator = address.rfind(':');
+        if (dependantNodeInfo.modelName.empty() || separator == std::string::npos || separator == 0 || separator + 1 == address.size()) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Remote node:{} requires model_name and address in host:port format",
+                pipelineName,
+                dependantNodeInfo.nodeName);
+            return StatusCode::PIPELINE_NODE_INVALID_PARAMETERS;
+        }
+        return StatusCode::OK;
+    }
+
+    Status validateCustomNodeParameters() {
+        if (!dependantNodeInfo.customNodeParameters.library) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Custom node:{} library:{} is not loaded",
+                pipelineName,
+                dependantNodeInfo.nodeName,
+                dependantNodeInfo.customNodeParameters.libraryPath);
+            return StatusCode::PIPELINE_NODE_INVALID_PARAMETERS;
+        }
+        return StatusCode::OK;
+    }
+
+    Status validateGatherOutputs() {
+        // Gather node outputs are its inputs trimmed to count rows
+        std::set<std::string> inputNames;
+        if (connections.count(dependantNodeInfo.nodeName) > 0) {
+            for (const auto& [dependencyNodeName, mapping] : connections.at(dependantNodeInfo.nodeName)) {
+                for (const auto& [alias, realName] : mapping) {
+                    inputNames.insert(realName);
+                }
+            }
+        }
+        for (const auto& [alias, dataItem] : dependantNodeInfo.outputNameAliases) {
+            if (dataItem == GATHER_COUNT_INPUT_NAME || inputNames.count(dataItem) == 0) {
+                SPDLOG_ERROR("Validation of pipeline({}) definition failed. Gather node:{} has no output data item:{}",
+                    pipelineName,
+                    dependantNodeInfo.nodeName,
+                    dataItem);
+                return StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_DATA_SOURCE;
+            }
+        }
+        return StatusCode::OK;
+    }
+
+    Status validateGateParameters() {
+        const auto& parameters = dependantNodeInfo.gateParameters;
+        if (parameters.comparison != GATE_GREATER && parameters.comparison != GATE_LESS) {
+            SPDLOG_ERROR("Validation of pipeline({}) definition failed. Gate node:{} requires comparison greater or less",
+                pipelineName,
+                dependantNodeInfo.nodeName);
+            return StatusCode::PIPELINE_NODE_INVALID_PARAMETERS;
+        }
+        // Gate node outputs are its inputs, including condition
+        std::set<std::string> inputNames;
+        if (connections.count(dependantNodeInfo.nodeName) > 0) {
+            for (const auto& [dependencyNodeName, mapping] : connections.at(dependantNodeInfo.nodeName)) {
+                for (const auto& [alias, realName] : mapping) {
+                    inputNames.insert(realName);
+                }
+            }
+        }
+        for (const auto& [alias, dataItem] : dependantNodeInfo.outputNameAliases) {
+            if (inputNames.count(dataItem) == 0) {
+                SPDLOG_ERROR("Validation of pipeline({}) definition failed. Gate node:{} has no output data item:{}",
+                    pipelineName,
+                    dependantNodeInfo.nodeName,
+                    dataItem);
+                return StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_DATA_SOURCE;
+            }
+        }
+        return StatusCode::OK;
+    }
+
     Status markModelInputAsConnected(const std::string& name) {
         // If currently validated node is of type DL model, mark its input as connected
         // by erasing from previously gathered input set.
@@ -421,18 +941,11 @@ public:
     }
 
     Status validateConnection(const NodeInfo& dependencyNodeInfo, const InputPairs& mapping) {
-        // At this point dependency node can only be either DL model node or entry node.
+        // At this point dependency node can be DL model node, built in node or entry node.
         // Take care when adding new node types.
-        std::unique_ptr<ModelInstanceUnloadGuard> dependencyModelUnloadGuard;
         std::shared_ptr<ModelInstance> dependencyModelInstance;
         if (dependencyNodeInfo.kind == NodeKind::DL) {
-            if (!getModelInstance(
-                    manager,
-                    dependencyNodeInfo.modelName,
-                    dependencyNodeInfo.modelVersion.value_or(0),
-                    dependencyModelInstance,
-                    dependencyModelUnloadGuard)
-                     .ok()) {
+            if (!context.getModelInstance(dependencyNodeInfo.modelName, dependencyNodeInfo.modelVersion.value_or(0), dependencyModelInstance).ok()) {
                 SPDLOG_ERROR("Validation of pipeline({}) definition failed. Dependency DL model node refers to unavailable model - name:{}; version:{}",
                     pipelineName,
                     dependencyNodeInfo.modelName,
@@ -447,6 +960,11 @@ public:
                 if (!result.ok()) {
                     return result;
                 }
+            } else if (dependantNodeInfo.kind != NodeKind::EXIT) {
+                auto result = markNodeInputAsConnected(realName);
+                if (!result.ok()) {
+                    return result;
+                }
             }
 
             auto result = checkConnectionMappedToExistingDataSource(dependencyNodeInfo, dependencyModelInstance, alias);
@@ -477,8 +995,54 @@ public:
                 return result;
             }
 
+            result = checkForForbiddenStatefulModel();
+            if (!result.ok()) {
+                return result;
+            }
+
             prepareRemainingUnconnectedDependantModelInputsSet();
+        } else if (dependantNodeInfo.kind == NodeKind::DEMULTIPLEXER) {
+            auto result = validateDemultiplexerParameters();
+            if (!result.ok()) {
+                return result;
+            }
+            builtInNodeInputs = {DEMULTIPLEXER_IMAGE_INPUT_NAME, DEMULTIPLEXER_DETECTION_INPUT_NAME};
+        } else if (dependantNodeInfo.kind == NodeKind::GATHER) {
+            auto result = validateGatherOutputs();
+            if (!result.ok()) {
+                return result;
+            }
+            builtInNodeInputs = {GATHER_COUNT_INPUT_NAME};
+        } else if (dependantNodeInfo.kind == NodeKind::PREPROCESSING) {
+            auto result = validatePreprocessingParameters();
+            if (!result.ok()) {
+                return result;
+            }
+            builtInNodeInputs = {PREPROCESSING_IMAGE_INPUT_NAME};
+        } else if (dependantNodeInfo.kind == NodeKind::POSTPROCESSING) {
+            auto result = validatePostprocessingParameters();
+            if (!result.ok()) {
+                return result;
+            }
+            builtInNodeInputs = PostprocessingNode::getInputNames(dependantNodeInfo.postprocessingParameters.operation);
+        } else if (dependantNodeInfo.kind == NodeKind::REMOTE) {
+            auto result = validateRemoteParameters();
+            if (!result.ok()) {
+                return result;
+            }
+        } else if (dependantNodeInfo.kind == NodeKind::CUSTOM) {
+            auto result = validateCustomNodeParameters();
+            if (!result.ok()) {
+                return result;
+            }
+        } else if (dependantNodeInfo.kind == NodeKind::GATE) {
+            auto result = validateGateParameters();
+            if (!result.ok()) {
+                return result;
+            }
+            builtInNodeInputs = {GATE_CONDITION_INPUT_NAME};
         }
+        remainingUnconnectedDependantModelInputs.insert(builtInNodeInputs.begin(), builtInNodeInputs.end());
 
         if (connections.count(dependantNodeInfo.nodeName) > 0) {
             for (const auto& [dependencyNodeName, mapping] : connections.at(dependantNodeInfo.nodeName)) {
@@ -486,7 +1050,7 @@ public:
                     return StatusCode::UNKNOWN_ERROR;
                 }
 
-                std::vector<NodeInfo>::const_iterator dependencyNodeInfo;
+                const NodeInfo* dependencyNodeInfo = nullptr;
                 auto result = getDependencyNodeInfo(dependencyNodeName, dependencyNodeInfo);
                 if (!result.ok()) {
                     return result;
@@ -503,16 +1067,17 @@ public:
     }
 };
 
-Status PipelineDefinition::validateNode(ModelManager& manager, const NodeInfo& dependantNodeInfo) {
-    NodeValidator validator(this->pipelineName, manager, dependantNodeInfo, connections, nodeInfos);
+Status PipelineDefinition::validateNode(const NodeInfo& dependantNodeInfo, NodeValidationContext& context) {
+    NodeValidator validator(this->pipelineName, context, dependantNodeInfo, connections);
     return validator.validate();
 }
 
 // Because of the way how pipeline_connections is implemented, this function is using
 // transpose of PipelineDefinition graph.(Transpose contains same cycles as original graph)
 Status PipelineDefinition::validateForCycles() {
-    std::vector<std::string> visited;
+    std::unordered_set<std::string> visited;
     std::vector<std::string> parentNodes;
+    std::unordered_set<std::string> parentNodesSet;
     visited.reserve(nodeInfos.size());
     parentNodes.reserve(nodeInfos.size());
 
@@ -526,7 +1091,7 @@ Status PipelineDefinition::validateForCycles() {
         return StatusCode::PIPELINE_MISSING_ENTRY_OR_EXIT;
     }
     std::string nodeName = itr->nodeName;
-    visited.push_back(nodeName);
+    visited.insert(nodeName);
 
     bool anyUnvisitedLeft = true;
     while (anyUnvisitedLeft) {
@@ -538,14 +1103,15 @@ Status PipelineDefinition::validateForCycles() {
                 return StatusCode::PIPELINE_CYCLE_FOUND;
             }
 
-            if (std::find(visited.begin(), visited.end(), node.first) == visited.end()) {
+            if (visited.count(node.first) == 0) {
                 parentNodes.push_back(nodeName);
-                visited.push_back(node.first);
+                parentNodesSet.insert(nodeName);
+                visited.insert(node.first);
                 nodeName = node.first;
                 unvisistedFound = true;
                 break;
             } else {
-                if (std::find(parentNodes.begin(), parentNodes.end(), node.first) != parentNodes.end()) {
+                if (parentNodesSet.count(node.first) > 0) {
                     std::string cycleNodes;
                     for (auto& cycleNode : parentNodes) {
                         cycleNodes += cycleNode;
@@ -569,6 +1135,7 @@ Status PipelineDefinition::validateForCycles() {
             } else {
                 nodeName = parentNodes.back();
                 parentNodes.pop_back();
+                parentNodesSet.erase(nodeName);
             }
         }
     }
@@ -608,26 +1175,76 @@ Status PipelineDefinition::validateNodes(ModelManager& manager) {
         return StatusCode::PIPELINE_MULTIPLE_EXIT_NODES;
     }
 
+    std::unordered_set<std::string> nodeNames;
+    std::vector<const NodeInfo*> nodes;
     for (const auto& node : nodeInfos) {
-        auto findByName = [node](const NodeInfo& nodeInfo) {
-            return nodeInfo.nodeName == node.nodeName;
-        };
-
-        if (std::count_if(nodeInfos.begin(), nodeInfos.end(), findByName) > 1) {
+        if (!nodeNames.insert(node.nodeName).second) {
             SPDLOG_ERROR("PipelineDefinition: {} has multiple nodes with name {}", pipelineName, node.nodeName);
             return StatusCode::PIPELINE_NODE_NAME_DUPLICATE;
         }
+        nodes.push_back(&node);
+    }
+
+    return validateNodes(manager, nodes);
+}
 
-        auto result = validateNode(manager, node);
+Status PipelineDefinition::validateNodes(ModelManager& manager, const std::vector<const NodeInfo*>& nodes) {
+    NodeValidationContext context(manager, nodeInfos);
+    for (const auto* node : nodes) {
+        auto result = validateNode(*node, context);
         if (!result.ok()) {
             return result;
         }
     }
-
     return StatusCode::OK;
 }
 
+Status PipelineDefinition::revalidate(ModelManager& manager) {
+    auto result = revalidateNodes(manager);
+    if (result.ok()) {
+        fuseNetworks(manager);
+    }
+    return result;
+}
+
+Status PipelineDefinition::revalidateNodes(ModelManager& manager) {
+    std::set<std::string> models;
+    {
+        std::lock_guard<std::mutex> lock(changedModelsMtx);
+        models.swap(changedModels);
+    }
+    if (getStateCode() != PipelineDefinitionStateCode::AVAILABLE_REQUIRED_REVALIDATION) {
+        return validate(manager);
+    }
+    // Nodes using changed models are validated with connections to their dependencies,
+    // nodes connected to their outputs are validated for changed outputs metadata.
+    std::unordered_set<std::string> changedNodes;
+    for (const auto& info : nodeInfos) {
+        if (info.kind == NodeKind::DL && models.count(info.modelName) > 0) {
+            changedNodes.insert(info.nodeName);
+        }
+    }
+    std::vector<const NodeInfo*> nodes;
+    for (const auto& info : nodeInfos) {
+        bool affected = changedNodes.count(info.nodeName) > 0;
+        auto it = connections.find(info.nodeName);
+        if (!affected && it != connections.end()) {
+            affected = std::any_of(it->second.begin(), it->second.end(),
+                [&changedNodes](const auto& dependency) { return changedNodes.count(dependency.first) > 0; });
+        }
+        if (affected) {
+            nodes.push_back(&info);
+        }
+    }
+    SPDLOG_DEBUG("Revalidating {} of {} nodes of pipeline definition:{} after used models changed", nodes.size(), nodeInfos.size(), getName());
+    ValidationResultNotifier notifier(status, loadedNotify);
+    auto result = validateNodes(manager, nodes);
+    notifier.passed = result.ok();
+    return result;
+}
+
 Status PipelineDefinition::getInputsInfo(tensor_map_t& inputsInfo, const ModelManager& manager) const {
+    std::shared_lock lock(loadMtx);
     // Assumptions: this can only be called on available pipeline definition.
     // Add check if available when pipeline status will be implemented.
 
@@ -646,7 +1263,14 @@ Status PipelineDefinition::getInputsInfo(tensor_map_t& inputsInfo, const ModelMa
             }
 
             switch (dependantNodeInfo->kind) {
-            case NodeKind::EXIT: {
+            case NodeKind::EXIT:
+            case NodeKind::DEMULTIPLEXER:
+            case NodeKind::GATHER:
+            case NodeKind::PREPROCESSING:
+            case NodeKind::POSTPROCESSING:
+            case NodeKind::REMOTE:
+            case NodeKind::CUSTOM:
+            case NodeKind::GATE: {
                 for (const auto& [alias, realName] : specificDependencyMapping) {
                     inputsInfo.insert({alias, TensorInfo::getUnspecifiedTensorInfo()});
                 }
@@ -685,6 +1309,7 @@ Status PipelineDefinition::getInputsInfo(tensor_map_t& inputsInfo, const ModelMa
 }
 
 Status PipelineDefinition::getOutputsInfo(tensor_map_t& outputsInfo, const ModelManager& manager) const {
+    std::shared_lock lock(loadMtx);
     // Assumptions: this can only be called on available pipeline definition.
     // Add check if available when pipeline status will be implemented.
 
@@ -704,7 +1329,14 @@ Status PipelineDefinition::getOutputsInfo(tensor_map_t& outputsInfo, const Model
             const auto& dependencyNodeInfo = std::find_if(std::begin(nodeInfos), std::end(nodeInfos), byName(dependencyNodeName));
 
             switch (dependencyNodeInfo->kind) {
-            case NodeKind::ENTRY: {
+            case NodeKind::ENTRY:
+            case NodeKind::DEMULTIPLEXER:
+            case NodeKind::GATHER:
+            case NodeKind::PREPROCESSING:
+            case NodeKind::POSTPROCESSING:
+            case NodeKind::REMOTE:
+            case NodeKind::CUSTOM:
+            case NodeKind::GATE: {
                 for (const auto& [alias, realName] : specificDependencyMapping) {
                     outputsInfo.insert({realName, TensorInfo::getUnspecifiedTensorInfo()});
                 }
@@ -18,6 +18,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <string>
@@ -30,26 +31,51 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "custom_node.hpp"
+#include "demultiplexer_node.hpp"
+#include "gate_node.hpp"
+#include "loadingprofile.hpp"
 #include "model_version_policy.hpp"
 #include "node.hpp"
 #include "pipeline.hpp"
+#include "pipelinebatcher.hpp"
 #include "pipelinedefinitionstatus.hpp"
 #include "pipelinedefinitionunloadguard.hpp"
+#include "postprocessing_node.hpp"
+#include "preprocessing_node.hpp"
+#include "remote_node.hpp"
 #include "status.hpp"
 
 namespace ovms {
 
+class FusedNetwork;
 class ModelManager;
+struct ModelMetadataCacheEntry;
+struct NodeValidationContext;
 
 using pipeline_connections_t = std::unordered_map<std::string, std::unordered_map<std::string, InputPairs>>;
 
 enum class NodeKind {
     ENTRY,
     DL,
+    DEMULTIPLEXER,
+    GATHER,
+    PREPROCESSING,
+    POSTPROCESSING,
+    REMOTE,
+    CUSTOM,
+    GATE,
     EXIT
 };
 
 const std::string DL_NODE_CONFIG_TYPE = "DL model";
+const std::string DEMULTIPLEXER_NODE_CONFIG_TYPE = "Demultiplexer";
+const std::string GATHER_NODE_CONFIG_TYPE = "Gather";
+const std::string PREPROCESSING_NODE_CONFIG_TYPE = "Preprocessing";
+const std::string POSTPROCESSING_NODE_CONFIG_TYPE = "Postprocessing";
+const std::string REMOTE_NODE_CONFIG_TYPE = "Remote model";
+const std::string CUSTOM_NODE_CONFIG_TYPE = "Custom";
+const std::string GATE_NODE_CONFIG_TYPE = "Gate";
 
 Status toNodeKind(const std::string& str, NodeKind& nodeKind);
 
@@ -59,17 +85,51 @@ struct NodeInfo {
     std::string modelName;
     std::optional<model_version_t> modelVersion;
     std::unordered_map<std::string, std::string> outputNameAliases;
+    bool zeroCopyOutputs;
+    DemultiplexerParameters demultiplexerParameters;
+    PreprocessingParameters preprocessingParameters;
+    PostprocessingParameters postprocessingParameters;
+    RemoteParameters remoteParameters;
+    CustomNodeParameters customNodeParameters;
+    GateParameters gateParameters;
+    // Time after which pipeline fails if node did not finish since it was started, 0 if not limited
+    uint64_t timeoutMicroseconds = 0;
 
     NodeInfo(NodeKind kind,
         const std::string& nodeName,
         const std::string& modelName = "",
         std::optional<model_version_t> modelVersion = std::nullopt,
-        std::unordered_map<std::string, std::string> outputNameAliases = {}) :
+        std::unordered_map<std::string, std::string> outputNameAliases = {},
+        bool zeroCopyOutputs = false,
+        const DemultiplexerParameters& demultiplexerParameters = {},
+        const PreprocessingParameters& preprocessingParameters = {},
+        const PostprocessingParameters& postprocessingParameters = {},
+        const RemoteParameters& remoteParameters = {},
+        const CustomNodeParameters& customNodeParameters = {},
+        const GateParameters& gateParameters = {}) :
         kind(kind),
         nodeName(nodeName),
         modelName(modelName),
         modelVersion(modelVersion),
-        outputNameAliases(outputNameAliases) {}
+        outputNameAliases(outputNameAliases),
+        zeroCopyOutputs(zeroCopyOutputs),
+        demultiplexerParameters(demultiplexerParameters),
+        preprocessingParameters(preprocessingParameters),
+        postprocessingParameters(postprocessingParameters),
+        remoteParameters(remoteParameters),
+        customNodeParameters(customNodeParameters),
+        gateParameters(gateParameters) {}
+};
+
+/**
+ * @brief Linear chain of DL nodes executed as single inference of fused network
+ */
+struct FusedChain {
+    // Names of nodes in execution order
+    std::vector<std::string> nodeNames;
+    std::shared_ptr<FusedNetwork> network;
+    // Sum of node timeouts, 0 if any of nodes is not limited
+    uint64_t timeoutMicroseconds = 0;
 };
 
 class PipelineDefinition {
@@ -97,36 +157,117 @@ class PipelineDefinition {
     pipeline_connections_t connections;
 
     std::atomic<uint64_t> requestsHandlesCounter = 0;
-    std::shared_mutex loadMtx;
+    /**
+     * @brief Guards swapping nodes and connections on reload, held shared while pipelines are created from them
+     */
+    mutable std::shared_mutex loadMtx;
 
     std::condition_variable loadedNotify;
 
+    std::shared_ptr<PipelinePool> pipelinePool = std::make_shared<PipelinePool>();
+
+    /**
+     * @brief Counters of pipelines created from the definition and of their nodes
+     */
+    std::shared_ptr<PipelineMetrics> metrics = std::make_shared<PipelineMetrics>();
+
+    /**
+     * @brief Duration of the last validation of the definition
+     */
+    LoadingProfile loadingProfile;
+
+    /**
+     * @brief Merges concurrent requests into single pipeline execution, nullptr if pipeline batching is disabled
+     */
+    std::shared_ptr<PipelineBatcher> batcher;
+
+    /**
+     * @brief Flag determining if FP32 pipeline outputs are sent as FP16
+     */
+    std::atomic<bool> fp16Outputs = false;
+
+    /**
+     * @brief Time after which pipeline execution fails if it did not finish, 0 if not limited
+     */
+    std::atomic<uint64_t> timeoutMicroseconds = 0;
+
+    /**
+     * @brief Flag determining if linear chains of DL nodes are compiled into fused networks
+     */
+    std::atomic<bool> networkFusion = false;
+
+    /**
+     * @brief Chains of nodes compiled into fused networks for current nodes and used models, nullptr if none
+     */
+    std::shared_ptr<const std::vector<FusedChain>> fusedChains;
+
+    /**
+     * @brief Metadata response built for current nodes and used models, valid while pipeline pool generation is the same
+     */
+    std::shared_ptr<const ModelMetadataCacheEntry> metadataCache;
+
     // Pipelines are not versioned and any available definition has constant version equal 1.
     static constexpr model_version_t VERSION = 1;
 
 protected:
     PipelineDefinitionStatus status;
 
+    /**
+     * @brief Checks if outputs of DL node can be serialized by exit node straight from the node's infer request.
+     * Holds for nodes connected only to exit node, whose model is not used by other nodes which could wait for the held stream.
+     */
+    bool isPassingOutputsToExitOnly(const NodeInfo& node) const;
+
 private:
     std::set<std::pair<const std::string, model_version_t>> subscriptions;
 
-    Status validateNode(ModelManager& manager, const NodeInfo& node);
+    /**
+     * @brief Names of used models which changed since last validation
+     */
+    std::set<std::string> changedModels;
+    std::mutex changedModelsMtx;
+
+    Status validateNode(const NodeInfo& node, NodeValidationContext& context);
+
+    /**
+     * @brief Validates only given nodes, with model instances fetched once for all of them
+     */
+    Status validateNodes(ModelManager& manager, const std::vector<const NodeInfo*>& nodes);
+
+    Status revalidateNodes(ModelManager& manager);
+
+    /**
+     * @brief Finds linear chains of DL nodes, in which each node is the only dependency of the next one and outputs of each node
+     * except the last one go only to the next node. Models of chain run on the same device, have static shapes and no dynamic batching.
+     */
+    std::vector<std::vector<const NodeInfo*>> findFusibleChains(ModelManager& manager) const;
+
+    /**
+     * @brief Compiles fused networks of fusible chains if network fusion is enabled and definition is available,
+     * chains which cannot be fused keep running node by node
+     */
+    void fuseNetworks(ModelManager& manager);
 
 public:
     static constexpr uint64_t WAIT_FOR_LOADED_DEFAULT_TIMEOUT_MICROSECONDS = 1000;
     PipelineDefinition(const std::string& pipelineName,
         const std::vector<NodeInfo>& nodeInfos,
-        const pipeline_connections_t& connections) :
+        const pipeline_connections_t& connections,
+        bool networkFusion = false) :
         pipelineName(pipelineName),
         nodeInfos(nodeInfos),
         connections(connections),
+        networkFusion(networkFusion),
         status(this->pipelineName) {}
 
     Status create(std::unique_ptr<Pipeline>& pipeline,
         const tensorflow::serving::PredictRequest* request,
         tensorflow::serving::PredictResponse* response,
         ModelManager& manager);
-    Status reload(ModelManager& manager, const std::vector<NodeInfo>&& nodeInfos, const pipeline_connections_t&& connections);
+    /**
+     * @brief Validates new structure and swaps it with the current one, fused networks are compiled once validation passes
+     */
+    Status reload(ModelManager& manager, const std::vector<NodeInfo>&& nodeInfos, const pipeline_connections_t&& connections, bool networkFusion = false);
     void retire(ModelManager& manager);
     Status validate(ModelManager& manager);
     Status validateNodes(ModelManager& manager);
@@ -135,10 +276,93 @@ public:
     const PipelineDefinitionStateCode getStateCode() const { return status.getStateCode(); }
     const model_version_t getVersion() const { return VERSION; }
 
-    void notifyUsedModelChanged(const std::string& ownerDetails) {
+    void notifyUsedModelChanged(const std::string& ownerDetails, const std::string& modelName) {
+        // fused networks are compiled again from changed models once definition is revalidated
+        std::atomic_store(&this->fusedChains, std::shared_ptr<const std::vector<FusedChain>>());
+        this->pipelinePool->invalidate();
+        {
+            std::lock_guard<std::mutex> lock(changedModelsMtx);
+            changedModels.insert(modelName);
+        }
         this->status.handle(UsedModelChangedEvent(ownerDetails));
     }
 
+    /**
+     * @brief Revalidates definition after used models changed. When it was available before the change, only nodes
+     * using changed models and nodes connected to their outputs are validated again, since structure did not change.
+     * Whole definition is validated otherwise.
+     *
+     * @param manager
+     *
+     * @return Status
+     */
+    Status revalidate(ModelManager& manager);
+
+    /**
+     * @brief Enables merging of concurrent requests into single pipeline execution, disables it when maxBatchSize is 0
+     *
+     * @param manager
+     * @param maxBatchSize
+     * @param batchTimeoutMicroseconds
+     */
+    void setBatching(ModelManager& manager, size_t maxBatchSize, uint64_t batchTimeoutMicroseconds);
+
+    std::shared_ptr<PipelineBatcher> getBatcher() const {
+        return std::atomic_load(&batcher);
+    }
+
+    /**
+     * @brief Sets if FP32 pipeline outputs are sent as FP16 by pipelines created from now on
+     */
+    void setFp16Outputs(bool fp16Outputs) {
+        this->fp16Outputs = fp16Outputs;
+    }
+
+    /**
+     * @brief Sets timeout of pipelines created from now on, 0 if not limited
+     */
+    void setTimeout(uint64_t timeoutMicroseconds) {
+        this->timeoutMicroseconds = timeoutMicroseconds;
+    }
+
+    /**
+     * @brief Enables or disables compiling linear chains of DL nodes into fused networks, used by pipelines created from now on
+     */
+    void setNetworkFusion(ModelManager& manager, bool networkFusion);
+
+    /**
+     * @brief Gets chains of nodes compiled into fused networks
+     *
+     * @return chains or nullptr if none
+     */
+    std::shared_ptr<const std::vector<FusedChain>> getFusedChains() const {
+        return std::atomic_load(&fusedChains);
+    }
+
+    /**
+     * @brief Gets metadata response cached for current nodes and used models
+     *
+     * @return cached response or nullptr if it was not built since last reload or used model change
+     */
+    std::shared_ptr<const ModelMetadataCacheEntry> getMetadataCache() const;
+
+    /**
+     * @brief Caches metadata response, built when pipeline pool had given generation
+     */
+    void setMetadataCache(std::shared_ptr<ModelMetadataCacheEntry> entry, uint64_t generation);
+
+    std::shared_ptr<PipelineMetrics> getMetrics() const {
+        return this->metrics;
+    }
+
+    LoadingProfile& getLoadingProfile() {
+        return this->loadingProfile;
+    }
+
+    PipelinePool& getPipelinePool() {
+        return *this->pipelinePool;
+    }
+
     const PipelineDefinitionStatus& getStatus() const {
         return this->status;
     }
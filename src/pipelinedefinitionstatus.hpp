@@ -31,6 +31,7 @@
 
 #include "modelversionstatus.hpp"
 #include "status.hpp"
+#include "statussnapshot.hpp"
 
 namespace ovms {
 
@@ -71,6 +72,7 @@ public:
         }
         SPDLOG_INFO("Pipeline:{} state changed to:{} after handling:{}:{}",
             name, pipelineDefinitionStateCodeToString(getStateCode()), event.name, event.getDetails());
+        StatusSnapshot::getInstance().updatePipeline(name, pipelineDefinitionStateCodeToString(getStateCode()));
     }
 
     template <typename State>
@@ -0,0 +1,65 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "pipelinepool.hpp"
+
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+std::optional<PipelineGraph> PipelinePool::tryAcquire() {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (graphs.empty()) {
+        return std::nullopt;
+    }
+    PipelineGraph graph = std::move(graphs.back());
+    graphs.pop_back();
+    return std::optional<PipelineGraph>{std::move(graph)};
+}
+
+uint64_t PipelinePool::getGeneration() {
+    std::unique_lock<std::mutex> lock(mtx);
+    return generation;
+}
+
+void PipelinePool::release(PipelineGraph&& graph) {
+    for (auto& node : graph.nodes) {
+        node->reset();
+    }
+    std::unique_lock<std::mutex> lock(mtx);
+    if (graph.generation != generation || graphs.size() >= capacity) {
+        return;
+    }
+    graphs.emplace_back(std::move(graph));
+}
+
+void PipelinePool::invalidate() {
+    std::vector<PipelineGraph> outdatedGraphs;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        generation++;
+        outdatedGraphs.swap(graphs);
+    }
+    SPDLOG_DEBUG("Dropping {} pooled pipelines", outdatedGraphs.size());
+}
+
+size_t PipelinePool::size() {
+    std::unique_lock<std::mutex> lock(mtx);
+    return graphs.size();
+}
+
+}  // namespace ovms
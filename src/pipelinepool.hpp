@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "entry_node.hpp"
+#include "exit_node.hpp"
+#include "node.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Already connected pipeline nodes, ready to be reused by next pipeline execution
+ */
+struct PipelineGraph {
+    std::vector<std::unique_ptr<Node>> nodes;
+    EntryNode* entry = nullptr;
+    ExitNode* exit = nullptr;
+    uint64_t generation = 0;
+};
+
+/**
+ * @brief Keeps node graphs of finished pipelines so that new pipelines of the same definition
+ * do not have to create and connect nodes again. Graphs created before invalidate() was called are dropped.
+ */
+class PipelinePool {
+    std::mutex mtx;
+    std::vector<PipelineGraph> graphs;
+    uint64_t generation = 0;
+    const size_t capacity;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16;
+
+    PipelinePool(size_t capacity = DEFAULT_CAPACITY) :
+        capacity(capacity) {}
+
+    /**
+     * @brief Takes graph from the pool if there is any
+     */
+    std::optional<PipelineGraph> tryAcquire();
+
+    /**
+     * @brief Current generation, graphs created by the caller should be marked with it
+     */
+    uint64_t getGeneration();
+
+    /**
+     * @brief Resets nodes state and stores graph for reuse unless it is outdated or pool is full
+     */
+    void release(PipelineGraph&& graph);
+
+    /**
+     * @brief Drops pooled graphs and those currently in use once they are released
+     */
+    void invalidate();
+
+    size_t size();
+};
+
+}  // namespace ovms
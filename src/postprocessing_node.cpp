@@ -0,0 +1,267 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "postprocessing_node.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "ov_utils.hpp"
+
+namespace ovms {
+
+namespace {
+// Kernels are written as plain loops over contiguous memory, so that compiler can vectorize them.
+
+void softmax(const float* __restrict logits, float* __restrict probabilities, size_t classes) {
+    float max = logits[0];
+    for (size_t c = 1; c < classes; c++) {
+        max = std::max(max, logits[c]);
+    }
+    float sum = 0;
+    for (size_t c = 0; c < classes; c++) {
+        probabilities[c] = std::exp(logits[c] - max);
+        sum += probabilities[c];
+    }
+    const float invSum = 1.0f / sum;
+    for (size_t c = 0; c < classes; c++) {
+        probabilities[c] *= invSum;
+    }
+}
+
+// Partial sort of indices keeps cost at O(classes * log(k)) instead of sorting all classes
+void topK(const float* scores, size_t classes, size_t k, std::vector<int32_t>& indices, int32_t* topClasses, float* topScores) {
+    std::iota(indices.begin(), indices.end(), 0);
+    std::partial_sort(indices.begin(), indices.begin() + k, indices.end(), [scores](int32_t a, int32_t b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    });
+    for (size_t i = 0; i < k; i++) {
+        topClasses[i] = indices[i];
+        topScores[i] = scores[indices[i]];
+    }
+}
+
+struct Candidate {
+    float score;
+    int32_t box;
+    int32_t label;
+};
+
+// Boxes kept so far are stored as separate coordinate arrays, so that overlap with all of them is computed
+// in one branch free loop
+class KeptBoxes {
+    std::vector<float> xMin, yMin, xMax, yMax, area;
+    std::vector<int32_t> labels;
+    std::vector<float> overlap;
+
+public:
+    explicit KeptBoxes(size_t capacity) {
+        for (auto* v : {&xMin, &yMin, &xMax, &yMax, &area, &overlap}) {
+            v->reserve(capacity);
+        }
+        labels.reserve(capacity);
+    }
+
+    size_t size() const { return labels.size(); }
+
+    bool isSuppressed(const float* box, int32_t label, float iouThreshold) {
+        const size_t count = size();
+        overlap.resize(count);
+        const float boxArea = std::max(0.0f, box[2] - box[0]) * std::max(0.0f, box[3] - box[1]);
+        for (size_t i = 0; i < count; i++) {
+            const float width = std::max(0.0f, std::min(xMax[i], box[2]) - std::max(xMin[i], box[0]));
+            const float height = std::max(0.0f, std::min(yMax[i], box[3]) - std::max(yMin[i], box[1]));
+            const float intersection = width * height;
+            const float iou = intersection / std::max(area[i] + boxArea - intersection, 1e-9f);
+            overlap[i] = (labels[i] == label && iou > iouThreshold) ? 1.0f : 0.0f;
+        }
+        float suppressed = 0;
+        for (size_t i = 0; i < count; i++) {
+            suppressed += overlap[i];
+        }
+        return suppressed > 0;
+    }
+
+    void add(const float* box, int32_t label) {
+        xMin.push_back(box[0]);
+        yMin.push_back(box[1]);
+        xMax.push_back(box[2]);
+        yMax.push_back(box[3]);
+        area.push_back(std::max(0.0f, box[2] - box[0]) * std::max(0.0f, box[3] - box[1]));
+        labels.push_back(label);
+    }
+};
+
+size_t elementsAfterBatch(const InferenceEngine::SizeVector& dims) {
+    return std::accumulate(dims.begin() + 1, dims.end(), size_t(1), std::multiplies<size_t>());
+}
+}  // namespace
+
+std::set<std::string> PostprocessingNode::getInputNames(const std::string& operation) {
+    if (operation == POSTPROCESSING_SOFTMAX || operation == POSTPROCESSING_ARGMAX || operation == POSTPROCESSING_TOP_K) {
+        return {POSTPROCESSING_LOGITS_INPUT_NAME};
+    }
+    if (operation == POSTPROCESSING_NMS) {
+        return {POSTPROCESSING_BOXES_INPUT_NAME, POSTPROCESSING_SCORES_INPUT_NAME};
+    }
+    return {};
+}
+
+std::set<std::string> PostprocessingNode::getOutputNames(const std::string& operation) {
+    if (operation == POSTPROCESSING_SOFTMAX) {
+        return {POSTPROCESSING_PROBABILITIES_OUTPUT_NAME};
+    }
+    if (operation == POSTPROCESSING_ARGMAX || operation == POSTPROCESSING_TOP_K) {
+        return {POSTPROCESSING_CLASSES_OUTPUT_NAME, POSTPROCESSING_SCORES_OUTPUT_NAME};
+    }
+    if (operation == POSTPROCESSING_NMS) {
+        return {POSTPROCESSING_BOXES_OUTPUT_NAME, POSTPROCESSING_SCORES_OUTPUT_NAME, POSTPROCESSING_CLASSES_OUTPUT_NAME, POSTPROCESSING_COUNT_OUTPUT_NAME};
+    }
+    return {};
+}
+
+Status PostprocessingNode::process() {
+    std::vector<InferenceEngine::Blob::Ptr> inputs;
+    for (const auto& name : getInputNames(parameters.operation)) {
+        auto it = this->inputBlobs.find(name);
+        if (it == this->inputBlobs.end()) {
+            SPDLOG_DEBUG("[Node: {}] Missing {} input", getName(), name);
+            return StatusCode::INVALID_MISSING_INPUT;
+        }
+        if (it->second->getTensorDesc().getPrecision() != InferenceEngine::Precision::FP32) {
+            SPDLOG_DEBUG("[Node: {}] Only FP32 {} input is supported", getName(), name);
+            return StatusCode::INVALID_PRECISION;
+        }
+    }
+    if (parameters.operation == POSTPROCESSING_NMS) {
+        return processDetections(this->inputBlobs.at(POSTPROCESSING_BOXES_INPUT_NAME), this->inputBlobs.at(POSTPROCESSING_SCORES_INPUT_NAME));
+    }
+    return processLogits(this->inputBlobs.at(POSTPROCESSING_LOGITS_INPUT_NAME));
+}
+
+Status PostprocessingNode::processLogits(const InferenceEngine::Blob::Ptr& logits) {
+    const auto& dims = logits->getTensorDesc().getDims();
+    if (dims.size() < 2 || elementsAfterBatch(dims) == 0) {
+        SPDLOG_DEBUG("[Node: {}] Expected logits with batch and classes dimensions", getName());
+        return StatusCode::INVALID_SHAPE;
+    }
+    const size_t batch = dims[0];
+    const size_t classes = elementsAfterBatch(dims);
+    const float* data = logits->cbuffer().as<const float*>();
+    if (parameters.operation == POSTPROCESSING_SOFTMAX) {
+        auto output = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32,
+            dims, InferenceEngine::TensorDesc::getLayoutByDims(dims)));
+        float* probabilities = output->buffer().as<float*>();
+        for (size_t n = 0; n < batch; n++) {
+            softmax(data + n * classes, probabilities + n * classes, classes);
+        }
+        this->outputBlobs.emplace(POSTPROCESSING_PROBABILITIES_OUTPUT_NAME, std::move(output));
+        return StatusCode::OK;
+    }
+    const bool argmax = parameters.operation == POSTPROCESSING_ARGMAX;
+    const size_t k = argmax ? 1 : parameters.topK;
+    if (k > classes) {
+        const std::string details = "top_k: " + std::to_string(k) + " is greater than classes count: " + std::to_string(classes);
+        SPDLOG_DEBUG("[Node: {}] {}", getName(), details);
+        return Status(StatusCode::INVALID_SHAPE, details);
+    }
+    const InferenceEngine::SizeVector outputDims = argmax ? InferenceEngine::SizeVector{batch} : InferenceEngine::SizeVector{batch, k};
+    const auto layout = argmax ? InferenceEngine::Layout::C : InferenceEngine::Layout::NC;
+    auto classesOutput = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::I32, outputDims, layout));
+    auto scoresOutput = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, outputDims, layout));
+    int32_t* topClasses = classesOutput->buffer().as<int32_t*>();
+    float* topScores = scoresOutput->buffer().as<float*>();
+    std::vector<int32_t> indices(classes);
+    for (size_t n = 0; n < batch; n++) {
+        const float* scores = data + n * classes;
+        if (argmax) {
+            topClasses[n] = static_cast<int32_t>(std::max_element(scores, scores + classes) - scores);
+            topScores[n] = scores[topClasses[n]];
+        } else {
+            topK(scores, classes, k, indices, topClasses + n * k, topScores + n * k);
+        }
+    }
+    this->outputBlobs.emplace(POSTPROCESSING_CLASSES_OUTPUT_NAME, std::move(classesOutput));
+    this->outputBlobs.emplace(POSTPROCESSING_SCORES_OUTPUT_NAME, std::move(scoresOutput));
+    return StatusCode::OK;
+}
+
+Status PostprocessingNode::processDetections(const InferenceEngine::Blob::Ptr& boxes, const InferenceEngine::Blob::Ptr& scores) {
+    const auto& boxesDims = boxes->getTensorDesc().getDims();
+    const auto& scoresDims = scores->getTensorDesc().getDims();
+    if (boxesDims.size() != 3 || boxesDims[2] != 4 ||
+        (scoresDims.size() != 2 && scoresDims.size() != 3) ||
+        scoresDims[0] != boxesDims[0] || scoresDims[1] != boxesDims[1]) {
+        SPDLOG_DEBUG("[Node: {}] Expected boxes with shape [N, B, 4] and scores with shape [N, B] or [N, B, C]", getName());
+        return StatusCode::INVALID_SHAPE;
+    }
+    const size_t batch = boxesDims[0];
+    const size_t boxesCount = boxesDims[1];
+    const size_t classes = scoresDims.size() == 3 ? scoresDims[2] : 1;
+    const size_t k = parameters.topK;
+    auto boxesOutput = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {batch, k, 4}, InferenceEngine::Layout::CHW));
+    auto scoresOutput = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {batch, k}, InferenceEngine::Layout::NC));
+    auto classesOutput = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::I32, {batch, k}, InferenceEngine::Layout::NC));
+    auto countOutput = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::I32, {batch}, InferenceEngine::Layout::C));
+    const float* boxesData = boxes->cbuffer().as<const float*>();
+    const float* scoresData = scores->cbuffer().as<const float*>();
+    float* keptBoxes = boxesOutput->buffer().as<float*>();
+    float* keptScores = scoresOutput->buffer().as<float*>();
+    int32_t* keptClasses = classesOutput->buffer().as<int32_t*>();
+    int32_t* keptCount = countOutput->buffer().as<int32_t*>();
+    std::vector<Candidate> candidates;
+    candidates.reserve(boxesCount * classes);
+    for (size_t n = 0; n < batch; n++) {
+        const float* batchBoxes = boxesData + n * boxesCount * 4;
+        const float* batchScores = scoresData + n * boxesCount * classes;
+        candidates.clear();
+        for (size_t i = 0; i < boxesCount * classes; i++) {
+            if (batchScores[i] > parameters.scoreThreshold) {
+                candidates.push_back({batchScores[i], static_cast<int32_t>(i / classes), static_cast<int32_t>(i % classes)});
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+        KeptBoxes kept(k);
+        for (const auto& candidate : candidates) {
+            if (kept.size() == k) {
+                break;
+            }
+            const float* box = batchBoxes + candidate.box * 4;
+            if (kept.isSuppressed(box, candidate.label, parameters.iouThreshold)) {
+                continue;
+            }
+            const size_t slot = n * k + kept.size();
+            std::copy(box, box + 4, keptBoxes + slot * 4);
+            keptScores[slot] = candidate.score;
+            keptClasses[slot] = candidate.label;
+            kept.add(box, candidate.label);
+        }
+        keptCount[n] = static_cast<int32_t>(kept.size());
+        SPDLOG_DEBUG("[Node: {}] Kept {} of {} detection candidates in batch {}", getName(), kept.size(), candidates.size(), n);
+    }
+    this->outputBlobs.emplace(POSTPROCESSING_BOXES_OUTPUT_NAME, std::move(boxesOutput));
+    this->outputBlobs.emplace(POSTPROCESSING_SCORES_OUTPUT_NAME, std::move(scoresOutput));
+    this->outputBlobs.emplace(POSTPROCESSING_CLASSES_OUTPUT_NAME, std::move(classesOutput));
+    this->outputBlobs.emplace(POSTPROCESSING_COUNT_OUTPUT_NAME, std::move(countOutput));
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,88 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "built_in_node.hpp"
+
+namespace ovms {
+
+const std::string POSTPROCESSING_LOGITS_INPUT_NAME = "logits";
+const std::string POSTPROCESSING_BOXES_INPUT_NAME = "boxes";
+const std::string POSTPROCESSING_SCORES_INPUT_NAME = "scores";
+const std::string POSTPROCESSING_PROBABILITIES_OUTPUT_NAME = "probabilities";
+const std::string POSTPROCESSING_CLASSES_OUTPUT_NAME = "classes";
+const std::string POSTPROCESSING_SCORES_OUTPUT_NAME = "scores";
+const std::string POSTPROCESSING_BOXES_OUTPUT_NAME = "boxes";
+const std::string POSTPROCESSING_COUNT_OUTPUT_NAME = "count";
+
+const std::string POSTPROCESSING_SOFTMAX = "softmax";
+const std::string POSTPROCESSING_ARGMAX = "argmax";
+const std::string POSTPROCESSING_TOP_K = "top_k";
+const std::string POSTPROCESSING_NMS = "nms";
+
+struct PostprocessingParameters {
+    // One of softmax, argmax, top_k and nms
+    std::string operation = POSTPROCESSING_ARGMAX;
+    // Number of classes returned by top_k, maximum number of detections kept by nms
+    size_t topK = 1;
+    // Detections with lower score are dropped by nms
+    float scoreThreshold = 0;
+    // Detections overlapping already kept detection of the same class more than this are suppressed by nms
+    float iouThreshold = 0.5;
+};
+
+/**
+ * @brief Reduces model outputs inside the server, so that clients receive results instead of raw tensors
+ *
+ * Operations on FP32 logits with shape [N, ...], where all dimensions but first are classes:
+ * softmax produces probabilities of the same shape, argmax produces I32 classes and FP32 scores with shape [N],
+ * top_k produces classes and scores with shape [N, K] sorted by descending score.
+ * Operation nms takes FP32 boxes [N, B, 4] as (x_min, y_min, x_max, y_max) and scores [N, B] or [N, B, C],
+ * suppresses overlapping boxes of the same class and produces boxes [N, K, 4], scores and classes [N, K]
+ * sorted by descending score with unused rows zero filled, and I32 count of detections kept per batch with shape [N].
+ */
+class PostprocessingNode : public BuiltInNode {
+    const PostprocessingParameters parameters;
+
+public:
+    PostprocessingNode(const std::string& nodeName, const PostprocessingParameters& parameters,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        BuiltInNode(nodeName, nodeOutputNameAlias),
+        parameters(parameters) {}
+
+    /**
+     * @brief Names of inputs required by operation, empty for unknown operation
+     */
+    static std::set<std::string> getInputNames(const std::string& operation);
+
+    /**
+     * @brief Names of outputs produced by operation, empty for unknown operation
+     */
+    static std::set<std::string> getOutputNames(const std::string& operation);
+
+protected:
+    Status process() override;
+
+private:
+    Status processLogits(const InferenceEngine::Blob::Ptr& logits);
+    Status processDetections(const InferenceEngine::Blob::Ptr& boxes, const InferenceEngine::Blob::Ptr& scores);
+};
+
+}  // namespace ovms
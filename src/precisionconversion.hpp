@@ -0,0 +1,172 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#pragma GCC diagnostic pop
+
+namespace ovms {
+
+/**
+ * @brief Field of tensor proto holding request values of given precision
+ */
+enum class TensorProtoField {
+    NONE,
+    TENSOR_CONTENT,
+    HALF_VAL,
+    INT_VAL
+};
+
+/**
+ * @brief Conversion between OpenVINO precision and tensor proto, resolved once per tensor and cached in TensorInfo
+ */
+struct PrecisionConversion {
+    InferenceEngine::Precision::ePrecision precision;
+
+    /**
+     * @brief Matching tensor proto dtype, DT_INVALID if there is none
+     */
+    tensorflow::DataType dtype;
+
+    /**
+     * @brief Values are held in tensor_content in their native width, so that outputs can be serialized and shared memory tensors read without conversion
+     */
+    bool nativeContent;
+
+    /**
+     * @brief Field request values are deserialized from, NONE if precision cannot be deserialized
+     */
+    TensorProtoField requestField;
+
+    /**
+     * @brief Creates blob pointing to tensor_content of request, set for TENSOR_CONTENT request field
+     */
+    InferenceEngine::Blob::Ptr (*wrapContent)(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc);
+
+    /**
+     * @brief Counts values of zero padded request field, set for HALF_VAL and INT_VAL request fields
+     */
+    size_t (*countValues)(const tensorflow::TensorProto& proto);
+
+    /**
+     * @brief Narrows values of zero padded request field into destination memory, set for HALF_VAL and INT_VAL request fields
+     */
+    void (*copyValues)(const tensorflow::TensorProto& proto, void* destination);
+
+    bool isDeserializable() const {
+        return requestField != TensorProtoField::NONE;
+    }
+};
+
+namespace precision_conversion {
+template <typename T>
+InferenceEngine::Blob::Ptr wrapContent(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc) {
+    return InferenceEngine::make_shared_blob<T>(desc, const_cast<T*>(reinterpret_cast<const T*>(proto.tensor_content().data())));
+}
+
+template <TensorProtoField Field>
+const auto& getValues(const tensorflow::TensorProto& proto) {
+    static_assert(Field == TensorProtoField::HALF_VAL || Field == TensorProtoField::INT_VAL, "Only zero padded fields hold values");
+    if constexpr (Field == TensorProtoField::HALF_VAL) {
+        return proto.half_val();
+    } else {
+        return proto.int_val();
+    }
+}
+
+template <TensorProtoField Field>
+size_t countValues(const tensorflow::TensorProto& proto) {
+    return static_cast<size_t>(getValues<Field>(proto).size());
+}
+
+// Narrowing copy of contiguous repeated field is vectorized by compiler
+template <typename T, TensorProtoField Field>
+void copyValues(const tensorflow::TensorProto& proto, void* destination) {
+    const auto& values = getValues<Field>(proto);
+    std::copy(values.begin(), values.end(), static_cast<T*>(destination));
+}
+
+template <typename T>
+constexpr PrecisionConversion fromContent(InferenceEngine::Precision::ePrecision precision) {
+    return {precision, tensorflow::DataTypeToEnum<T>::value, true, TensorProtoField::TENSOR_CONTENT, &wrapContent<T>, nullptr, nullptr};
+}
+
+template <typename T, TensorProtoField Field>
+constexpr PrecisionConversion fromPaddedField(InferenceEngine::Precision::ePrecision precision, tensorflow::DataType dtype) {
+    return {precision, dtype, true, Field, nullptr, &countValues<Field>, &copyValues<T, Field>};
+}
+
+constexpr PrecisionConversion serializedOnly(InferenceEngine::Precision::ePrecision precision, tensorflow::DataType dtype) {
+    return {precision, dtype, true, TensorProtoField::NONE, nullptr, nullptr, nullptr};
+}
+
+constexpr PrecisionConversion typeOnly(InferenceEngine::Precision::ePrecision precision, tensorflow::DataType dtype) {
+    return {precision, dtype, false, TensorProtoField::NONE, nullptr, nullptr, nullptr};
+}
+}  // namespace precision_conversion
+
+// FP16 and U16 values are zero padded in request fields:
+// https://github.com/tensorflow/tensorflow/blob/v2.2.0/tensorflow/core/framework/tensor.proto#L45
+constexpr std::array<PrecisionConversion, 10> PRECISION_CONVERSIONS{{
+    precision_conversion::fromContent<float>(InferenceEngine::Precision::FP32),
+    precision_conversion::fromPaddedField<uint16_t, TensorProtoField::HALF_VAL>(InferenceEngine::Precision::FP16, tensorflow::DataType::DT_HALF),
+    precision_conversion::fromContent<uint8_t>(InferenceEngine::Precision::U8),
+    precision_conversion::fromContent<int8_t>(InferenceEngine::Precision::I8),
+    precision_conversion::fromPaddedField<uint16_t, TensorProtoField::INT_VAL>(InferenceEngine::Precision::U16, tensorflow::DataType::DT_UINT16),
+    precision_conversion::fromContent<int16_t>(InferenceEngine::Precision::I16),
+    precision_conversion::fromContent<int32_t>(InferenceEngine::Precision::I32),
+    precision_conversion::serializedOnly(InferenceEngine::Precision::I64, tensorflow::DataType::DT_INT64),
+    precision_conversion::typeOnly(InferenceEngine::Precision::U64, tensorflow::DataType::DT_UINT64),
+    precision_conversion::typeOnly(InferenceEngine::Precision::BOOL, tensorflow::DataType::DT_BOOL),
+}};
+
+constexpr PrecisionConversion UNSUPPORTED_PRECISION_CONVERSION =
+    precision_conversion::typeOnly(InferenceEngine::Precision::UNSPECIFIED, tensorflow::DataType::DT_INVALID);
+
+/**
+ * @brief Gets conversion of precision, hot paths use the one cached in TensorInfo instead
+ */
+inline const PrecisionConversion& getPrecisionConversion(InferenceEngine::Precision precision) {
+    for (const auto& conversion : PRECISION_CONVERSIONS) {
+        if (conversion.precision == precision) {
+            return conversion;
+        }
+    }
+    return UNSUPPORTED_PRECISION_CONVERSION;
+}
+
+/**
+ * @brief Gets conversion of tensor proto dtype
+ */
+inline const PrecisionConversion& getDataTypeConversion(tensorflow::DataType dtype) {
+    for (const auto& conversion : PRECISION_CONVERSIONS) {
+        if (conversion.dtype == dtype) {
+            return conversion;
+        }
+    }
+    return UNSUPPORTED_PRECISION_CONVERSION;
+}
+
+}  // namespace ovms
@@ -15,11 +15,21 @@
 //*****************************************************************************
 #include "prediction_service.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <google/protobuf/arena.h>
+#include <grpcpp/alarm.h>
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
 
@@ -28,15 +38,25 @@
 #include "tensorflow/core/framework/tensor.h"
 #pragma GCC diagnostic pop
 
+#include "blockingtasksexecutor.hpp"
+#include "chunkedinputs.hpp"
+#include "cpuaffinity.hpp"
 #include "get_model_metadata_impl.hpp"
+#include "inflightmemorybudget.hpp"
 #include "modelinstanceunloadguard.hpp"
 #include "modelmanager.hpp"
+#include "multipredict.hpp"
 #include "ovinferrequestsqueue.hpp"
+#include "pipelinebatcher.hpp"
 #include "prediction_service_utils.hpp"
+#include "requesttrace.hpp"
+#include "resultcache.hpp"
 #include "status.hpp"
+#include "statussnapshot.hpp"
 
 #define DEBUG
 #include "timer.hpp"
+#include "trafficcapture.hpp"
 
 using grpc::ServerContext;
 
@@ -64,45 +84,1162 @@ Status getPipeline(const PredictRequest* request,
     return getPipeline(manager, pipelinePtr, request, response);
 }
 
-grpc::Status ovms::PredictionServiceImpl::Predict(
-    ServerContext* context,
-    const PredictRequest* request,
-    PredictResponse* response) {
+std::shared_ptr<ResultCache> getResultCache(const PredictRequest* request) {
+    auto model = ModelManager::getInstance().findModelByName(request->model_spec().name());
+    return model ? model->getResultCache() : nullptr;
+}
+
+/**
+ * @brief Gets priority from call metadata, normal if not set
+ */
+RequestPriority getRequestPriority(const grpc::ServerContext& context) {
+    const auto& metadata = context.client_metadata();
+    auto priorityItr = metadata.find(REQUEST_PRIORITY_HEADER);
+    if (priorityItr == metadata.end()) {
+        return RequestPriority::NORMAL;
+    }
+    const std::string value(priorityItr->second.data(), priorityItr->second.size());
+    auto priority = parseRequestPriority(value);
+    if (!priority) {
+        SPDLOG_DEBUG("Ignored unknown {} value: {}", REQUEST_PRIORITY_HEADER, value);
+        return RequestPriority::NORMAL;
+    }
+    return priority.value();
+}
+
+/**
+ * @brief Object passed as tag to completion queue, notified by handling thread once operation is completed
+ */
+class CompletionQueueTag {
+public:
+    virtual ~CompletionQueueTag() = default;
+    virtual void proceed(bool ok) = 0;
+};
+
+/**
+ * @brief State of single asynchronous Predict call, frees itself once response is sent, call is done and pipeline is finished
+ *
+ * Call done notification tells whether client cancelled the call, which is then passed to inference
+ * so that it is not started for requests nobody waits for anymore. Pipeline which timed out is responded
+ * before its running nodes finish, those keep request and response referenced until then.
+ */
+class PredictCallData : public CompletionQueueTag {
+    class CallDoneTag : public CompletionQueueTag {
+        PredictCallData& callData;
+
+    public:
+        CallDoneTag(PredictCallData& callData) :
+            callData(callData) {}
+
+        void proceed(bool ok) override {
+            callData.callDone();
+        }
+    };
+
+    enum class State {
+        AWAITING_CALL,
+        RESUMING,
+        FINISHING
+    };
+
+    PredictionServiceImpl& service;
+    grpc::ServerCompletionQueue& completionQueue;
+    grpc::ServerContext context;
+    // request and response trees are allocated on arena and released at once with call data
+    google::protobuf::Arena arena;
+    PredictRequest& request;
+    PredictResponse& response;
+    grpc::ServerAsyncResponseWriter<PredictResponse> responder;
+    grpc::Alarm alarm;
+    std::unique_ptr<ovms::Pipeline> pipeline;
+    std::function<void()> continuation;
+    State state = State::AWAITING_CALL;
     Timer timer;
-    timer.start("total");
-    using std::chrono::microseconds;
-    SPDLOG_DEBUG("Processing gRPC request for model: {}; version: {}",
-        request->model_spec().name(),
-        request->model_spec().version().value());
+    std::unique_ptr<RequestTrace> trace;
+    CallDoneTag callDoneTag;
+    std::atomic<bool> cancelled{false};
+    // held by response being sent, call done notification and pipeline being executed
+    std::atomic<int> references{2};
+    InFlightMemoryBudget::Reservation inFlightMemory;
+
+public:
+    PredictCallData(PredictionServiceImpl& service, grpc::ServerCompletionQueue& completionQueue) :
+        service(service),
+        completionQueue(completionQueue),
+        request(*google::protobuf::Arena::CreateMessage<PredictRequest>(&arena)),
+        response(*google::protobuf::Arena::CreateMessage<PredictResponse>(&arena)),
+        responder(&context),
+        callDoneTag(*this) {
+        context.AsyncNotifyWhenDone(static_cast<CompletionQueueTag*>(&callDoneTag));
+        service.RequestPredict(&context, &request, &responder, &completionQueue, &completionQueue, static_cast<CompletionQueueTag*>(this));
+    }
+
+    void proceed(bool ok) override {
+        switch (state) {
+        case State::AWAITING_CALL:
+            if (!ok) {
+                // server is shutting down, call done is not notified for calls never started
+                delete this;
+                return;
+            }
+            new PredictCallData(service, completionQueue);
+            process();
+            return;
+        case State::RESUMING: {
+            auto resumed = std::move(continuation);
+            resumed();
+            return;
+        }
+        case State::FINISHING:
+            unref();
+            return;
+        }
+    }
+
+private:
+    void unref() {
+        if (references.fetch_sub(1) == 1) {
+            delete this;
+        }
+    }
+
+    void callDone() {
+        // flag is read by inference threads, call data outlives inference which holds reference or is sent after it completes
+        cancelled.store(context.IsCancelled(), std::memory_order_relaxed);
+        unref();
+    }
+
+    void process() {
+        timer.start("total");
+        SPDLOG_DEBUG("Processing gRPC request for model: {}; version: {}",
+            request.model_spec().name(),
+            request.model_spec().version().value());
+        service.callStarted();
+        TrafficCapture::getInstance().captureGrpc(request);
+        trace = createTrace();
+
+        std::shared_ptr<ovms::ModelInstance> modelInstance;
+        std::unique_ptr<ovms::Pipeline> pipelinePtr;
+
+        std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+        auto status = getModelInstance(&request, modelInstance, modelInstanceUnloadGuard);
+
+        if (status == StatusCode::MODEL_NAME_MISSING) {
+            SPDLOG_INFO("Requested model: {} does not exist. Searching for pipeline with that name...", request.model_spec().name());
+            status = reservePipelineInFlightMemory(request.model_spec().name(), request, 0, inFlightMemory);
+            if (!status.ok()) {
+                finish(status);
+                return;
+            }
+            auto batcher = getPipelineBatcher(ModelManager::getInstance(), request.model_spec().name());
+            if (batcher) {
+                // batch leader blocks until merged requests are executed, requests are executed by pool separate from
+                // synchronous inferences, since pipelines of the batch wait on those
+                references.fetch_add(1);
+                // request and response are kept until nodes running after pipeline timeout are finished
+                std::shared_ptr<void> keepAlive(nullptr, [this](void*) { unref(); });
+                bool scheduled = BlockingTasksExecutor::getPipelineBatchesInstance().schedule([this, batcher, keepAlive]() {
+                    finish(batcher->execute(&request, &response, keepAlive));
+                });
+                if (!scheduled) {
+                    finish(StatusCode::SERVER_SHUTTING_DOWN);
+                }
+                return;
+            }
+            status = getPipeline(&request, &response, pipelinePtr);
+        }
+        if (!status.ok()) {
+            SPDLOG_INFO("Getting modelInstance or pipeline failed. {}", status.string());
+            finish(status);
+            return;
+        }
+
+        if (pipelinePtr) {
+            // pipeline nodes are processed by shared pipeline executor workers, completion queue thread is released right away
+            pipeline = std::move(pipelinePtr);
+            pipeline->setTrace(trace.get());
+            references.fetch_add(1);
+            pipeline->executeAsync([this](const Status& status) { finish(status); },
+                [this]() {
+                    pipeline.reset();
+                    unref();
+                });
+            return;
+        }
+
+        // repeated requests are answered from cache before waiting for infer request
+        auto resultCache = getResultCache(&request);
+        uint64_t resultCacheKey = 0;
+        const auto version = modelInstance->getVersion();
+        if (resultCache && ResultCache::computeKey(version, request, resultCacheKey)) {
+            if (resultCache->lookup(version, resultCacheKey, request, response)) {
+                SPDLOG_DEBUG("Result cache hit for model: {}; version: {}", request.model_spec().name(), version);
+                modelInstanceUnloadGuard.reset();
+                finish(StatusCode::OK);
+                return;
+            }
+        } else {
+            resultCache.reset();
+        }
+
+        inferenceAsync(std::move(modelInstance), &request, &response, std::move(modelInstanceUnloadGuard),
+            [this](std::function<void()> continuation) { resume(std::move(continuation)); },
+            [this, resultCache = std::move(resultCache), resultCacheKey, version](const Status& status) {
+                if (resultCache && status.ok()) {
+                    resultCache->insert(version, resultCacheKey, request, response);
+                }
+                finish(status);
+            },
+            getStreamWaitingOptions());
+    }
+
+    /**
+     * @brief Gets priority from call metadata, requests waiting for infer request are dropped once call deadline passes or call is cancelled
+     */
+    StreamWaitingOptions getStreamWaitingOptions() const {
+        StreamWaitingOptions options;
+        options.cancelled = &cancelled;
+        options.trace = trace.get();
+        options.priority = getRequestPriority(context);
+        const auto deadline = context.deadline();
+        if (deadline != std::chrono::system_clock::time_point::max()) {
+            options.deadline = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - std::chrono::system_clock::now());
+        }
+        return options;
+    }
+
+    /**
+     * @brief Starts trace of requests which came with sampled trace context or server timing request in metadata
+     */
+    std::unique_ptr<RequestTrace> createTrace() const {
+        const auto& metadata = context.client_metadata();
+        std::string_view traceparent;
+        auto traceparentItr = metadata.find(TRACEPARENT_HEADER);
+        if (traceparentItr != metadata.end()) {
+            traceparent = std::string_view(traceparentItr->second.data(), traceparentItr->second.size());
+        }
+        return RequestTrace::create(traceparent, metadata.find(SERVER_TIMING_REQUEST_HEADER) != metadata.end());
+    }
+
+    void resume(std::function<void()> continuation) {
+        this->continuation = std::move(continuation);
+        state = State::RESUMING;
+        alarm.Set(&completionQueue, gpr_now(GPR_CLOCK_MONOTONIC), static_cast<CompletionQueueTag*>(this));
+    }
+
+    void finish(const Status& status) {
+        using std::chrono::microseconds;
+        auto& service = this->service;
+        auto trace = std::move(this->trace);
+        state = State::FINISHING;
+        if (trace && trace->isServerTimingRequested()) {
+            context.AddTrailingMetadata(SERVER_TIMING_HEADER, trace->serializeServerTiming());
+        }
+        if (status.ok()) {
+            timer.stop("total");
+            SPDLOG_DEBUG("Total gRPC request processing time: {} ms", timer.elapsed<microseconds>("total") / 1000);
+            if (service.responseCompressionMinBytes > 0 && response.ByteSizeLong() >= service.responseCompressionMinBytes) {
+                // gRPC picks algorithm for the level among encodings accepted by client
+                context.set_compression_level(GRPC_COMPRESS_LEVEL_LOW);
+            }
+            responder.Finish(response, grpc::Status::OK, static_cast<CompletionQueueTag*>(this));
+        } else {
+            responder.FinishWithError(status.grpc(), static_cast<CompletionQueueTag*>(this));
+        }
+        // call data may be already freed by completion queue thread
+        if (trace && trace->isSampled()) {
+            trace->exportSpans();
+        }
+        service.callFinished();
+    }
+};
+
+/**
+ * @brief State of single PredictStream call, frees itself once call is finished and done
+ *
+ * Model version is resolved from the first request. Each request guards it against unloading only while it is
+ * inferred, so that idle stream does not block unloading, request read after version is unloaded fails the stream.
+ * Up to nireq requests of the stream are inferred at once, next request is read from the stream as soon as
+ * there is room for it. Responses are written in order of requests, one at a time. Requests are read and
+ * started by completion queue thread, responses are written by thread completing inference, so that state
+ * shared between them is guarded by mutex.
+ */
+class PredictStreamCallData {
+    /**
+     * @brief Completion queue tag notifying one of call data methods
+     */
+    class Tag : public CompletionQueueTag {
+        PredictStreamCallData& callData;
+        void (PredictStreamCallData::*method)(bool ok);
+
+    public:
+        Tag(PredictStreamCallData& callData, void (PredictStreamCallData::*method)(bool ok)) :
+            callData(callData),
+            method(method) {}
+
+        void proceed(bool ok) override {
+            (callData.*method)(ok);
+        }
+    };
+
+    /**
+     * @brief Request of the stream with its response, kept until response is written
+     */
+    struct Frame : public CompletionQueueTag {
+        google::protobuf::Arena arena;
+        PredictRequest& request;
+        PredictResponse& response;
+        grpc::Alarm alarm;
+        std::function<void()> continuation;
+        Status status = StatusCode::OK;
+        bool completed = false;
+
+        Frame() :
+            request(*google::protobuf::Arena::CreateMessage<PredictRequest>(&arena)),
+            response(*google::protobuf::Arena::CreateMessage<PredictResponse>(&arena)) {}
+
+        void proceed(bool ok) override {
+            auto resumed = std::move(continuation);
+            resumed();
+        }
+    };
+
+    PredictionServiceImpl& service;
+    grpc::ServerCompletionQueue& completionQueue;
+    grpc::ServerContext context;
+    grpc::ServerAsyncReaderWriter<PredictResponse, PredictRequest> stream;
+    Tag acceptedTag;
+    Tag readTag;
+    Tag writeTag;
+    Tag finishedTag;
+    Tag callDoneTag;
+    std::atomic<bool> cancelled{false};
+
+    std::shared_ptr<ModelInstance> modelInstance;
+    size_t maxFramesInProgress = 1;
+    StreamWaitingOptions waitingOptions;
+
+    std::mutex mtx;
+    std::unique_ptr<Frame> readFrame;
+    // frames in order of requests, front one is written next
+    std::deque<std::unique_ptr<Frame>> frames;
+    size_t framesInProgress = 0;
+    Status streamStatus = StatusCode::OK;
+    bool reading = false;
+    bool readsDone = false;
+    bool writing = false;
+    bool writeFailed = false;
+    bool finishing = false;
+    bool finished = false;
+    bool callDoneNotified = false;
+
+public:
+    PredictStreamCallData(PredictionServiceImpl& service, grpc::ServerCompletionQueue& completionQueue) :
+        service(service),
+        completionQueue(completionQueue),
+        stream(&context),
+        acceptedTag(*this, &PredictStreamCallData::accepted),
+        readTag(*this, &PredictStreamCallData::read),
+        writeTag(*this, &PredictStreamCallData::written),
+        finishedTag(*this, &PredictStreamCallData::finishedCall),
+        callDoneTag(*this, &PredictStreamCallData::callDone) {
+        context.AsyncNotifyWhenDone(static_cast<CompletionQueueTag*>(&callDoneTag));
+        service.streamService.RequestPredictStream(&context, &stream, &completionQueue, &completionQueue, static_cast<CompletionQueueTag*>(&acceptedTag));
+    }
+
+private:
+    void accepted(bool ok) {
+        if (!ok) {
+            // server is shutting down, call done is not notified for calls never started
+            delete this;
+            return;
+        }
+        new PredictStreamCallData(service, completionQueue);
+        SPDLOG_DEBUG("Processing gRPC stream");
+        service.callStarted();
+        waitingOptions.priority = getRequestPriority(context);
+        waitingOptions.cancelled = &cancelled;
+        std::unique_lock<std::mutex> lock(mtx);
+        startReading();
+    }
+
+    void startReading() {
+        readFrame = std::make_unique<Frame>();
+        reading = true;
+        stream.Read(&readFrame->request, static_cast<CompletionQueueTag*>(&readTag));
+    }
+
+    void read(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        reading = false;
+        if (!ok || !streamStatus.ok()) {
+            // client is done writing or stream already failed, remaining responses are written before finishing
+            readsDone = true;
+            readFrame.reset();
+            proceed(lock);
+            deleteIfDone(lock);
+            return;
+        }
+        std::unique_ptr<ModelInstanceUnloadGuard> frameUnloadGuard;
+        auto frameStatus = prepare(readFrame->request, frameUnloadGuard);
+        if (!frameStatus.ok()) {
+            streamStatus = frameStatus;
+            readFrame.reset();
+            proceed(lock);
+            return;
+        }
+        Frame& frame = *readFrame;
+        frames.push_back(std::move(readFrame));
+        ++framesInProgress;
+        lock.unlock();
+        // completion may be notified from this thread before inferenceAsync returns
+        inferenceAsync(modelInstance, &frame.request, &frame.response, std::move(frameUnloadGuard),
+            [this, &frame](std::function<void()> continuation) {
+                frame.continuation = std::move(continuation);
+                frame.alarm.Set(&completionQueue, gpr_now(GPR_CLOCK_MONOTONIC), static_cast<CompletionQueueTag*>(&frame));
+            },
+            [this, &frame](const Status& frameStatus) { frameCompleted(frame, frameStatus); },
+            waitingOptions);
+        lock.lock();
+        if (!reading && !readsDone && streamStatus.ok() && framesInProgress < maxFramesInProgress) {
+            startReading();
+        }
+    }
+
+    /**
+     * @brief Resolves model version on the first request and checks that the following ones can use it
+     *
+     * @param frameUnloadGuard guard of model version held while request is inferred
+     */
+    Status prepare(const PredictRequest& request, std::unique_ptr<ModelInstanceUnloadGuard>& frameUnloadGuard) {
+        if (modelInstance == nullptr) {
+            auto status = getModelInstance(&request, modelInstance, frameUnloadGuard);
+            if (!status.ok()) {
+                SPDLOG_INFO("Getting modelInstance for stream failed. {}", status.string());
+                return status;
+            }
+            maxFramesInProgress = std::max<size_t>(1, modelInstance->getInferRequestsQueue().size());
+            SPDLOG_DEBUG("Stream of model: {}; version: {} started with up to {} requests in progress",
+                modelInstance->getName(), modelInstance->getVersion(), maxFramesInProgress);
+        } else if (request.model_spec().name() != modelInstance->getName() ||
+                   (request.model_spec().version().value() != 0 && request.model_spec().version().value() != modelInstance->getVersion())) {
+            return StatusCode::STREAM_MODEL_SPEC_MISMATCH;
+        } else {
+            frameUnloadGuard = std::make_unique<ModelInstanceUnloadGuard>(*modelInstance);
+        }
+        if (modelInstance->getStatus().getState() != ModelVersionState::AVAILABLE) {
+            // version was unloaded or evicted meanwhile stream was open, client can start a new one
+            return StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE;
+        }
+        const auto& config = modelInstance->getModelConfig();
+        if (config.getBatchingMode() == AUTO || config.anyShapeSetToAuto()) {
+            // reloading waits for all unload guards to be released, including the one held by this request
+            auto validationStatus = modelInstance->validate(&request);
+            if (validationStatus.batchSizeChangeRequired()) {
+                return Status(StatusCode::INVALID_BATCH_SIZE, "Model can't be reloaded with new batch size while stream is open");
+            }
+            if (validationStatus.reshapeRequired()) {
+                return Status(StatusCode::INVALID_SHAPE, "Model can't be reloaded with new shape while stream is open");
+            }
+        }
+        return StatusCode::OK;
+    }
+
+    void frameCompleted(Frame& frame, const Status& frameStatus) {
+        std::unique_lock<std::mutex> lock(mtx);
+        frame.completed = true;
+        frame.status = frameStatus;
+        --framesInProgress;
+        if (!frameStatus.ok() && streamStatus.ok()) {
+            streamStatus = frameStatus;
+        }
+        if (!reading && !readsDone && !finishing && streamStatus.ok() && framesInProgress < maxFramesInProgress) {
+            startReading();
+        }
+        proceed(lock);
+    }
+
+    void written(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        writing = false;
+        frames.pop_front();
+        if (!ok) {
+            // client is gone, responses of requests still in progress are dropped
+            writeFailed = true;
+            if (streamStatus.ok()) {
+                streamStatus = StatusCode::REQUEST_CANCELLED;
+            }
+        }
+        proceed(lock);
+    }
+
+    /**
+     * @brief Writes next completed response in order or finishes the call once nothing more can be written
+     */
+    void proceed(std::unique_lock<std::mutex>& lock) {
+        if (writing || finishing) {
+            return;
+        }
+        if (!writeFailed && !frames.empty() && frames.front()->completed && frames.front()->status.ok()) {
+            writing = true;
+            stream.Write(frames.front()->response, static_cast<CompletionQueueTag*>(&writeTag));
+            return;
+        }
+        // failed request is not followed by responses of requests sent after it
+        const bool nothingToWrite = writeFailed || frames.empty() || (frames.front()->completed && !frames.front()->status.ok());
+        if (framesInProgress > 0 || !nothingToWrite || (streamStatus.ok() && !readsDone)) {
+            return;
+        }
+        finishing = true;
+        frames.clear();
+        if (streamStatus.ok()) {
+            SPDLOG_DEBUG("gRPC stream finished");
+            stream.Finish(grpc::Status::OK, static_cast<CompletionQueueTag*>(&finishedTag));
+        } else {
+            SPDLOG_DEBUG("gRPC stream failed: {}", streamStatus.string());
+            stream.Finish(streamStatus.grpc(), static_cast<CompletionQueueTag*>(&finishedTag));
+        }
+        service.callFinished();
+    }
+
+    void finishedCall(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        finished = true;
+        deleteIfDone(lock);
+    }
+
+    void callDone(bool ok) {
+        // flag is read by inference threads of requests in progress
+        cancelled.store(context.IsCancelled(), std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mtx);
+        callDoneNotified = true;
+        deleteIfDone(lock);
+    }
+
+    void deleteIfDone(std::unique_lock<std::mutex>& lock) {
+        // pending read is completed once call is finished
+        if (finished && callDoneNotified && !reading) {
+            lock.unlock();
+            delete this;
+        }
+    }
+};
+
+/**
+ * @brief State of single PredictChunked call, frees itself once response is sent and call is done
+ *
+ * Model version is resolved from the header chunk, in-flight memory is reserved before its input blobs are allocated.
+ * Content of following chunks is written into input blobs as chunks are read, inference is started once client is done
+ * writing. Version is guarded against unloading only while header is prepared and from the start of inference, so that
+ * slow upload does not block unloading, inputs are validated again against version found loaded at the start. Chunks are read one at a time, so that only response sending races with call done notification.
+ */
+class PredictChunkedCallData {
+    class Tag : public CompletionQueueTag {
+        PredictChunkedCallData& callData;
+        void (PredictChunkedCallData::*method)(bool ok);
+
+    public:
+        Tag(PredictChunkedCallData& callData, void (PredictChunkedCallData::*method)(bool ok)) :
+            callData(callData),
+            method(method) {}
+
+        void proceed(bool ok) override {
+            (callData.*method)(ok);
+        }
+    };
+
+    PredictionServiceImpl& service;
+    grpc::ServerCompletionQueue& completionQueue;
+    grpc::ServerContext context;
+    grpc::ServerAsyncReader<PredictResponse, PredictChunk> reader;
+    Tag acceptedTag;
+    Tag readTag;
+    Tag resumedTag;
+    Tag finishedTag;
+    Tag callDoneTag;
+    std::atomic<bool> cancelled{false};
+
+    PredictChunk chunk;
+    PredictRequest header;
+    PredictResponse response;
+    bool headerReceived = false;
+    ChunkedInputs inputs;
+    std::shared_ptr<ModelInstance> modelInstance;
+    InFlightMemoryBudget::Reservation inFlightMemory;
+    StreamWaitingOptions waitingOptions;
+    grpc::Alarm alarm;
+    std::function<void()> continuation;
+
+    std::mutex mtx;
+    bool finished = false;
+    bool callDoneNotified = false;
+
+public:
+    PredictChunkedCallData(PredictionServiceImpl& service, grpc::ServerCompletionQueue& completionQueue) :
+        service(service),
+        completionQueue(completionQueue),
+        reader(&context),
+        acceptedTag(*this, &PredictChunkedCallData::accepted),
+        readTag(*this, &PredictChunkedCallData::read),
+        resumedTag(*this, &PredictChunkedCallData::resumed),
+        finishedTag(*this, &PredictChunkedCallData::finishedCall),
+        callDoneTag(*this, &PredictChunkedCallData::callDone) {
+        context.AsyncNotifyWhenDone(static_cast<CompletionQueueTag*>(&callDoneTag));
+        service.streamService.RequestPredictChunked(&context, &reader, &completionQueue, &completionQueue, static_cast<CompletionQueueTag*>(&acceptedTag));
+    }
+
+private:
+    void accepted(bool ok) {
+        if (!ok) {
+            // server is shutting down, call done is not notified for calls never started
+            delete this;
+            return;
+        }
+        new PredictChunkedCallData(service, completionQueue);
+        SPDLOG_DEBUG("Processing gRPC chunked request");
+        service.callStarted();
+        waitingOptions.priority = getRequestPriority(context);
+        waitingOptions.cancelled = &cancelled;
+        reader.Read(&chunk, static_cast<CompletionQueueTag*>(&readTag));
+    }
+
+    void read(bool ok) {
+        if (!ok) {
+            // client is done writing or call is cancelled
+            startInference();
+            return;
+        }
+        auto status = headerReceived ? writeChunk() : prepare();
+        if (!status.ok()) {
+            finish(status);
+            return;
+        }
+        chunk.Clear();
+        reader.Read(&chunk, static_cast<CompletionQueueTag*>(&readTag));
+    }
+
+    /**
+     * @brief Resolves model version from header chunk, reserves in-flight memory and allocates its inputs
+     */
+    Status prepare() {
+        if (!chunk.has_header()) {
+            return Status(StatusCode::INVALID_MISSING_INPUT, "First chunk has to carry request header");
+        }
+        header.Swap(chunk.mutable_header());
+        headerReceived = true;
+        std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+        auto status = getModelInstance(&header, modelInstance, modelInstanceUnloadGuard);
+        if (!status.ok()) {
+            SPDLOG_INFO("Getting modelInstance for chunked request failed. {}", status.string());
+            return status;
+        }
+        SPDLOG_DEBUG("Chunked request for model: {}; version: {}", modelInstance->getName(), modelInstance->getVersion());
+        if (modelInstance->getBatchingScheduler() != nullptr) {
+            return Status(StatusCode::NOT_IMPLEMENTED, "Chunked inputs are not supported for models with dynamic batching");
+        }
+        status = inputs.validate(modelInstance->getInputsInfo(), header);
+        if (!status.ok()) {
+            return status;
+        }
+        status = reserveModelInFlightMemory(*modelInstance, header, inputs.getBytes(), inFlightMemory);
+        if (!status.ok()) {
+            return status;
+        }
+        status = inputs.allocate(modelInstance->getInputsInfo(), header);
+        if (!status.ok()) {
+            return status;
+        }
+        // content of header is already copied into input blobs
+        for (auto& [name, input] : *header.mutable_inputs()) {
+            input.clear_tensor_content();
+        }
+        return writeChunk();
+    }
+
+    Status writeChunk() {
+        if (chunk.input_name().empty() && chunk.content().empty()) {
+            return StatusCode::OK;
+        }
+        return inputs.write(chunk.input_name(), chunk.offset(), chunk.content());
+    }
 
-    std::shared_ptr<ovms::ModelInstance> modelInstance;
-    std::unique_ptr<ovms::Pipeline> pipelinePtr;
+    void startInference() {
+        auto status = headerReceived ? inputs.checkComplete() : Status(StatusCode::INVALID_MISSING_INPUT, "Missing request header");
+        if (!status.ok()) {
+            finish(status);
+            return;
+        }
+        // version may be unloaded or reloaded with other inputs while content was uploaded
+        std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
+        status = modelInstance->waitForLoaded(WAIT_FOR_MODEL_LOADED_TIMEOUT_MS, modelInstanceUnloadGuard);
+        if (status.ok()) {
+            status = ChunkedInputs().validate(modelInstance->getInputsInfo(), header);
+        }
+        if (!status.ok()) {
+            finish(status);
+            return;
+        }
+        // completion may be notified from this thread before inferenceWithInputBlobsAsync returns
+        inferenceWithInputBlobsAsync(modelInstance, &header, inputs.getBlobs(), &response, std::move(modelInstanceUnloadGuard),
+            [this](std::function<void()> continuation) {
+                this->continuation = std::move(continuation);
+                alarm.Set(&completionQueue, gpr_now(GPR_CLOCK_MONOTONIC), static_cast<CompletionQueueTag*>(&resumedTag));
+            },
+            [this](const Status& status) { finish(status); },
+            waitingOptions);
+    }
+
+    void resumed(bool ok) {
+        auto resumed = std::move(continuation);
+        resumed();
+    }
+
+    void finish(const Status& status) {
+        auto& service = this->service;
+        if (status.ok()) {
+            SPDLOG_DEBUG("gRPC chunked request finished");
+            if (service.responseCompressionMinBytes > 0 && response.ByteSizeLong() >= service.responseCompressionMinBytes) {
+                context.set_compression_level(GRPC_COMPRESS_LEVEL_LOW);
+            }
+            reader.Finish(response, grpc::Status::OK, static_cast<CompletionQueueTag*>(&finishedTag));
+        } else {
+            SPDLOG_DEBUG("gRPC chunked request failed: {}", status.string());
+            reader.FinishWithError(status.grpc(), static_cast<CompletionQueueTag*>(&finishedTag));
+        }
+        // call data may be already freed by completion queue thread
+        service.callFinished();
+    }
 
-    std::unique_ptr<ModelInstanceUnloadGuard> modelInstanceUnloadGuard;
-    auto status = getModelInstance(request, modelInstance, modelInstanceUnloadGuard);
+    void finishedCall(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        finished = true;
+        deleteIfDone(lock);
+    }
 
-    if (status == StatusCode::MODEL_NAME_MISSING) {
-        SPDLOG_INFO("Requested model: {} does not exist. Searching for pipeline with that name...", request->model_spec().name());
-        status = getPipeline(request, response, pipelinePtr);
+    void callDone(bool ok) {
+        // flag is read by inference thread
+        cancelled.store(context.IsCancelled(), std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mtx);
+        callDoneNotified = true;
+        deleteIfDone(lock);
     }
-    if (!status.ok()) {
-        SPDLOG_INFO("Getting modelInstance or pipeline failed. {}", status.string());
-        return status.grpc();
+
+    void deleteIfDone(std::unique_lock<std::mutex>& lock) {
+        if (finished && callDoneNotified) {
+            lock.unlock();
+            delete this;
+        }
     }
+};
+
+/**
+ * @brief State of single MultiPredict call, frees itself once response is sent and call is done
+ *
+ * Request message is parsed once. Each shared input is copied only into requests of models having it, the last of them
+ * takes it over without copy. Inference of all models is started by completion queue thread right away, so that models run
+ * concurrently on their infer requests, response is sent by the thread completing the last of them.
+ */
+class MultiPredictCallData {
+    class Tag : public CompletionQueueTag {
+        MultiPredictCallData& callData;
+        void (MultiPredictCallData::*method)(bool ok);
+
+    public:
+        Tag(MultiPredictCallData& callData, void (MultiPredictCallData::*method)(bool ok)) :
+            callData(callData),
+            method(method) {}
+
+        void proceed(bool ok) override {
+            (callData.*method)(ok);
+        }
+    };
 
-    if (pipelinePtr) {
-        status = pipelinePtr->execute();
-    } else {
-        status = inference(*modelInstance, request, response, modelInstanceUnloadGuard);
+    /**
+     * @brief Inference of single model, resumed on completion queue when waiting for infer request
+     */
+    struct Task : public CompletionQueueTag {
+        grpc::Alarm alarm;
+        std::function<void()> continuation;
+
+        void proceed(bool ok) override {
+            auto resumed = std::move(continuation);
+            resumed();
+        }
+    };
+
+    PredictionServiceImpl& service;
+    grpc::ServerCompletionQueue& completionQueue;
+    grpc::ServerContext context;
+    // requests of models are on the same arena as shared inputs, so that inputs are swapped into them without copy
+    google::protobuf::Arena arena;
+    MultiPredictRequest& request;
+    MultiPredictResponse& response;
+    grpc::ServerAsyncResponseWriter<MultiPredictResponse> responder;
+    Tag acceptedTag;
+    Tag finishedTag;
+    Tag callDoneTag;
+    std::atomic<bool> cancelled{false};
+    StreamWaitingOptions waitingOptions;
+    std::vector<MultiPredictModel> models;
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::unique_ptr<MultiPredictCompletion> completion;
+
+    std::mutex mtx;
+    bool finished = false;
+    bool callDoneNotified = false;
+
+public:
+    MultiPredictCallData(PredictionServiceImpl& service, grpc::ServerCompletionQueue& completionQueue) :
+        service(service),
+        completionQueue(completionQueue),
+        request(*google::protobuf::Arena::CreateMessage<MultiPredictRequest>(&arena)),
+        response(*google::protobuf::Arena::CreateMessage<MultiPredictResponse>(&arena)),
+        responder(&context),
+        acceptedTag(*this, &MultiPredictCallData::accepted),
+        finishedTag(*this, &MultiPredictCallData::finishedCall),
+        callDoneTag(*this, &MultiPredictCallData::callDone) {
+        context.AsyncNotifyWhenDone(static_cast<CompletionQueueTag*>(&callDoneTag));
+        service.streamService.RequestMultiPredict(&context, &request, &responder, &completionQueue, &completionQueue, static_cast<CompletionQueueTag*>(&acceptedTag));
     }
 
-    if (!status.ok()) {
-        return status.grpc();
+private:
+    void accepted(bool ok) {
+        if (!ok) {
+            // server is shutting down, call done is not notified for calls never started
+            delete this;
+            return;
+        }
+        new MultiPredictCallData(service, completionQueue);
+        SPDLOG_DEBUG("Processing gRPC multi predict request for {} models", request.requests_size());
+        service.callStarted();
+        waitingOptions.priority = getRequestPriority(context);
+        waitingOptions.cancelled = &cancelled;
+        auto status = prepareMultiPredict(ModelManager::getInstance(), request, models);
+        if (!status.ok()) {
+            finish(status);
+            return;
+        }
+        startInference();
+    }
+
+    void startInference() {
+        const int count = request.requests_size();
+        for (int i = 0; i < count; i++) {
+            response.add_responses();
+        }
+        completion = std::make_unique<MultiPredictCompletion>(count);
+        for (int i = 0; i < count; i++) {
+            tasks.emplace_back(std::make_unique<Task>());
+        }
+        for (int i = 0; i < count; i++) {
+            auto& task = *tasks[i];
+            auto& model = models[i];
+            // completion of the last model may be notified from this thread and free call data before inferenceAsync returns
+            inferenceAsync(std::move(model.modelInstance), &request.requests(i), response.mutable_responses(i), std::move(model.modelInstanceUnloadGuard),
+                [this, &task](std::function<void()> continuation) {
+                    task.continuation = std::move(continuation);
+                    task.alarm.Set(&completionQueue, gpr_now(GPR_CLOCK_MONOTONIC), static_cast<CompletionQueueTag*>(&task));
+                },
+                [this](const Status& status) { taskCompleted(status); },
+                waitingOptions);
+        }
+    }
+
+    void taskCompleted(const Status& status) {
+        Status callStatus;
+        if (completion->complete(status, callStatus)) {
+            finish(callStatus);
+        }
+    }
+
+    void finish(const Status& status) {
+        auto& service = this->service;
+        for (auto& model : models) {
+            model.modelInstanceUnloadGuard.reset();
+        }
+        if (status.ok()) {
+            SPDLOG_DEBUG("gRPC multi predict request finished");
+            if (service.responseCompressionMinBytes > 0 && response.ByteSizeLong() >= service.responseCompressionMinBytes) {
+                context.set_compression_level(GRPC_COMPRESS_LEVEL_LOW);
+            }
+            responder.Finish(response, grpc::Status::OK, static_cast<CompletionQueueTag*>(&finishedTag));
+        } else {
+            SPDLOG_DEBUG("gRPC multi predict request failed: {}", status.string());
+            responder.FinishWithError(status.grpc(), static_cast<CompletionQueueTag*>(&finishedTag));
+        }
+        // call data may be already freed by completion queue thread
+        service.callFinished();
+    }
+
+    void finishedCall(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        finished = true;
+        deleteIfDone(lock);
+    }
+
+    void callDone(bool ok) {
+        // flag is read by inference threads
+        cancelled.store(context.IsCancelled(), std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mtx);
+        callDoneNotified = true;
+        deleteIfDone(lock);
+    }
+
+    void deleteIfDone(std::unique_lock<std::mutex>& lock) {
+        if (finished && callDoneNotified) {
+            lock.unlock();
+            delete this;
+        }
+    }
+};
+
+/**
+ * @brief State of single WatchStatus call, frees itself once call is finished and done
+ *
+ * Call does not occupy a thread while waiting for transitions. StatusSnapshot listener cancels alarm the call waits on,
+ * completion queue thread then reads new transitions and writes them one at a time. Listener is called with snapshot
+ * lock held, so that call data never calls snapshot while holding its own lock.
+ */
+class WatchStatusCallData {
+    class Tag : public CompletionQueueTag {
+        WatchStatusCallData& callData;
+        void (WatchStatusCallData::*method)(bool ok);
+
+    public:
+        Tag(WatchStatusCallData& callData, void (WatchStatusCallData::*method)(bool ok)) :
+            callData(callData),
+            method(method) {}
+
+        void proceed(bool ok) override {
+            (callData.*method)(ok);
+        }
+    };
+
+    PredictionServiceImpl& service;
+    grpc::ServerCompletionQueue& completionQueue;
+    grpc::ServerContext context;
+    WatchStatusRequest request;
+    grpc::ServerAsyncWriter<StatusChange> writer;
+    Tag acceptedTag;
+    Tag writeTag;
+    Tag wokenTag;
+    Tag finishedTag;
+    Tag callDoneTag;
+    grpc::Alarm alarm;
+
+    std::set<std::string> names;
+    uint64_t sequence = 0;
+    size_t listenerId = 0;
+    std::deque<StatusChange> messages;
+
+    std::mutex mtx;
+    bool waiting = false;
+    bool changed = false;
+    bool finished = false;
+    bool callDoneNotified = false;
+
+public:
+    WatchStatusCallData(PredictionServiceImpl& service, grpc::ServerCompletionQueue& completionQueue) :
+        service(service),
+        completionQueue(completionQueue),
+        writer(&context),
+        acceptedTag(*this, &WatchStatusCallData::accepted),
+        writeTag(*this, &WatchStatusCallData::written),
+        wokenTag(*this, &WatchStatusCallData::woken),
+        finishedTag(*this, &WatchStatusCallData::finishedCall),
+        callDoneTag(*this, &WatchStatusCallData::callDone) {
+        context.AsyncNotifyWhenDone(static_cast<CompletionQueueTag*>(&callDoneTag));
+        service.statusWatchService.RequestWatchStatus(&context, &request, &writer, &completionQueue, &completionQueue, static_cast<CompletionQueueTag*>(&acceptedTag));
     }
 
-    timer.stop("total");
-    SPDLOG_DEBUG("Total gRPC request processing time: {} ms", timer.elapsed<microseconds>("total") / 1000);
-    return grpc::Status::OK;
+private:
+    void accepted(bool ok) {
+        if (!ok) {
+            // server is shutting down, call done is not notified for calls never started
+            delete this;
+            return;
+        }
+        new WatchStatusCallData(service, completionQueue);
+        service.callStarted();
+        names = std::set<std::string>(request.names().begin(), request.names().end());
+        SPDLOG_DEBUG("Started watching status of {} models and pipelines", names.empty() ? std::string("all") : std::to_string(names.size()));
+        auto& snapshot = StatusSnapshot::getInstance();
+        // registered before current states are read, so that no transition after them is missed
+        listenerId = snapshot.addListener([this]() { wake(); });
+        std::vector<StatusTransition> states;
+        sequence = snapshot.getStates(states);
+        addMessages(states);
+        proceed();
+    }
+
+    void addMessages(const std::vector<StatusTransition>& changes) {
+        for (const auto& change : changes) {
+            if (!names.empty() && names.count(change.name) == 0) {
+                continue;
+            }
+            auto& message = messages.emplace_back();
+            message.set_sequence(change.sequence);
+            message.set_name(change.name);
+            message.set_pipeline(change.pipeline);
+            message.set_version(change.version);
+            message.set_state(change.state);
+            message.set_error_code(change.errorCode);
+        }
+    }
+
+    /**
+     * @brief Writes next message, reads new transitions once all are written or waits for them
+     */
+    void proceed() {
+        while (messages.empty()) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                if (callDoneNotified) {
+                    lock.unlock();
+                    finish();
+                    return;
+                }
+                changed = false;
+            }
+            std::vector<StatusTransition> changes;
+            if (!StatusSnapshot::getInstance().waitForChanges(sequence, changes, std::chrono::milliseconds(0))) {
+                // watching is stopped on server shutdown
+                finish();
+                return;
+            }
+            addMessages(changes);
+            if (!messages.empty()) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            if (!changed && !callDoneNotified) {
+                // alarm never expires, it is cancelled by transition or call done
+                waiting = true;
+                alarm.Set(&completionQueue, gpr_inf_future(GPR_CLOCK_MONOTONIC), static_cast<CompletionQueueTag*>(&wokenTag));
+                return;
+            }
+        }
+        writer.Write(messages.front(), static_cast<CompletionQueueTag*>(&writeTag));
+    }
+
+    void wake() {
+        std::unique_lock<std::mutex> lock(mtx);
+        changed = true;
+        if (waiting) {
+            waiting = false;
+            alarm.Cancel();
+        }
+    }
+
+    void woken(bool ok) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            waiting = false;
+        }
+        proceed();
+    }
+
+    void written(bool ok) {
+        if (!ok) {
+            // client is gone
+            finish();
+            return;
+        }
+        messages.pop_front();
+        proceed();
+    }
+
+    void finish() {
+        auto& service = this->service;
+        StatusSnapshot::getInstance().removeListener(listenerId);
+        SPDLOG_DEBUG("Finished watching status");
+        writer.Finish(grpc::Status::OK, static_cast<CompletionQueueTag*>(&finishedTag));
+        // call data may be already freed by completion queue thread
+        service.callFinished();
+    }
+
+    void finishedCall(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        finished = true;
+        deleteIfDone(lock);
+    }
+
+    void callDone(bool ok) {
+        std::unique_lock<std::mutex> lock(mtx);
+        callDoneNotified = true;
+        if (waiting) {
+            waiting = false;
+            alarm.Cancel();
+        }
+        deleteIfDone(lock);
+    }
+
+    void deleteIfDone(std::unique_lock<std::mutex>& lock) {
+        if (finished && callDoneNotified) {
+            lock.unlock();
+            delete this;
+        }
+    }
+};
+
+PredictionServiceImpl::~PredictionServiceImpl() {
+    stopHandlingPredictCalls();
+}
+
+void PredictionServiceImpl::addCompletionQueue(grpc::ServerBuilder& builder) {
+    completionQueues.push_back(builder.AddCompletionQueue());
+}
+
+void PredictionServiceImpl::startHandlingPredictCalls(const std::vector<int>& cpus) {
+    for (size_t i = 0; i < completionQueues.size(); i++) {
+        std::vector<int> threadCpus;
+        if (!cpus.empty()) {
+            threadCpus.push_back(cpus[i % cpus.size()]);
+        }
+        handlingThreads.emplace_back(&PredictionServiceImpl::handlePredictCalls, this, std::ref(*completionQueues[i]), std::move(threadCpus));
+    }
+}
+
+void PredictionServiceImpl::stopHandlingPredictCalls() {
+    {
+        std::unique_lock<std::mutex> lock(callsInProgressMtx);
+        callsInProgressCv.wait(lock, [this]() { return callsInProgress == 0; });
+    }
+    for (auto& completionQueue : completionQueues) {
+        completionQueue->Shutdown();
+    }
+    for (auto& thread : handlingThreads) {
+        thread.join();
+    }
+    handlingThreads.clear();
+    completionQueues.clear();
+}
+
+void PredictionServiceImpl::handlePredictCalls(grpc::ServerCompletionQueue& completionQueue, std::vector<int> cpus) {
+    CpuAffinityGuard cpuAffinityGuard(cpus);
+    new PredictCallData(*this, completionQueue);
+    new PredictStreamCallData(*this, completionQueue);
+    new PredictChunkedCallData(*this, completionQueue);
+    new MultiPredictCallData(*this, completionQueue);
+    new WatchStatusCallData(*this, completionQueue);
+    void* tag;
+    bool ok;
+    while (completionQueue.Next(&tag, &ok)) {
+        static_cast<CompletionQueueTag*>(tag)->proceed(ok);
+    }
+}
+
+void PredictionServiceImpl::callStarted() {
+    std::unique_lock<std::mutex> lock(callsInProgressMtx);
+    ++callsInProgress;
+}
+
+void PredictionServiceImpl::callFinished() {
+    std::unique_lock<std::mutex> lock(callsInProgressMtx);
+    if (--callsInProgress == 0) {
+        callsInProgressCv.notify_all();
+    }
 }
 
 grpc::Status PredictionServiceImpl::GetModelMetadata(
@@ -15,25 +15,111 @@
 //*****************************************************************************
 #pragma once
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/server_builder.h>
 #include <grpcpp/server_context.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
+#include "src/prediction_stream_service.grpc.pb.h"
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
 namespace ovms {
 
-class PredictionServiceImpl final : public tensorflow::serving::PredictionService::Service {
-    grpc::Status Predict(
-        grpc::ServerContext* context,
-        const tensorflow::serving::PredictRequest* request,
-        tensorflow::serving::PredictResponse* response) override;
+class PredictCallData;
+class PredictStreamCallData;
+class PredictChunkedCallData;
+class MultiPredictCallData;
+class WatchStatusCallData;
+
+/**
+ * @brief Prediction service with Predict handled asynchronously through completion queue
+ *
+ * Predict call does not occupy a thread while inference is running. Completion queue thread validates and starts
+ * inference, response is sent from OpenVINO completion callback. Concurrency is therefore bounded by number of
+ * infer requests of served models instead of number of threads. GetModelMetadata stays synchronous.
+ * PredictStream, PredictChunked and MultiPredict calls of stream service and WatchStatus calls of status watch service
+ * are handled by the same completion queues.
+ * Service instance can be registered in one server only.
+ */
+class PredictionServiceImpl final : public tensorflow::serving::PredictionService::WithAsyncMethod_Predict<tensorflow::serving::PredictionService::Service> {
+    friend class PredictCallData;
+    friend class PredictStreamCallData;
+    friend class PredictChunkedCallData;
+    friend class MultiPredictCallData;
+    friend class WatchStatusCallData;
+
+public:
+    ~PredictionServiceImpl();
+
+    /**
+     * @brief Gets service with PredictStream, PredictChunked and MultiPredict methods, to be registered in the same server
+     */
+    grpc::Service& getStreamService() {
+        return streamService;
+    }
+
+    /**
+     * @brief Gets service with WatchStatus method, to be registered in the same server
+     */
+    grpc::Service& getStatusWatchService() {
+        return statusWatchService;
+    }
+
+    /**
+     * @brief Adds completion queue used for Predict calls, to be called before server is built
+     *
+     * Each completion queue is polled by its own thread, so that calls are not serialized on single queue.
+     */
+    void addCompletionQueue(grpc::ServerBuilder& builder);
+
+    /**
+     * @brief Sets minimum size of Predict response compressed with algorithm accepted by client, 0 disables compression
+     */
+    void setResponseCompressionMinBytes(size_t minBytes) {
+        responseCompressionMinBytes = minBytes;
+    }
+
+    /**
+     * @brief Starts handling Predict calls with one thread per completion queue, to be called after server is started
+     *
+     * @param cpus CPU each handling thread is pinned to in round robin order, threads are not pinned if empty
+     */
+    void startHandlingPredictCalls(const std::vector<int>& cpus = {});
+
+    /**
+     * @brief Waits for calls in progress and stops handling threads, to be called after server shutdown
+     */
+    void stopHandlingPredictCalls();
 
     grpc::Status GetModelMetadata(
         grpc::ServerContext* context,
         const tensorflow::serving::GetModelMetadataRequest* request,
         tensorflow::serving::GetModelMetadataResponse* response) override;
+
+private:
+    void handlePredictCalls(grpc::ServerCompletionQueue& completionQueue, std::vector<int> cpus);
+
+    void callStarted();
+    void callFinished();
+
+    PredictionStreamService::AsyncService streamService;
+    ModelStatusWatchService::AsyncService statusWatchService;
+
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> completionQueues;
+    std::vector<std::thread> handlingThreads;
+
+    std::mutex callsInProgressMtx;
+    std::condition_variable callsInProgressCv;
+    size_t callsInProgress = 0;
+
+    size_t responseCompressionMinBytes = 0;
 };
 
 }  // namespace ovms
@@ -15,17 +15,39 @@
 //*****************************************************************************
 #include "prediction_service_utils.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "batchsplitting.hpp"
+#include "blockingtasksexecutor.hpp"
+#include "cpuaffinity.hpp"
 #include "deserialization.hpp"
 #include "executinstreamidguard.hpp"
+#include "inflightmemorybudget.hpp"
 #include "modelinstance.hpp"
 #include "modelinstanceunloadguard.hpp"
 #include "modelmanager.hpp"
+#include "ov_utils.hpp"
+#include "phasemarkers.hpp"
+#include "requesttrace.hpp"
+#include "sequencemanager.hpp"
 #include "serialization.hpp"
+#include "shapebuckets.hpp"
 
 #define DEBUG
 #include "timer.hpp"
+#include "workstealingexecutor.hpp"
 
 using tensorflow::serving::PredictRequest;
 using tensorflow::serving::PredictResponse;
@@ -34,6 +56,407 @@ namespace ovms {
 
 const int DEFAULT_MODEL_GET_RETRIES = 5;
 
+namespace {
+/**
+ * @brief Completes admission policy passed with request with queue limits configured for model
+ */
+StreamWaitingOptions applyModelQueueLimits(const ModelConfig& config, StreamWaitingOptions options) {
+    options.maxQueueSize = config.getMaxQueueSize();
+    if (config.getQueueTimeoutMicroseconds() > 0) {
+        options.deadline = std::min(options.deadline,
+            std::chrono::steady_clock::now() + std::chrono::microseconds(config.getQueueTimeoutMicroseconds()));
+    }
+    return options;
+}
+
+/**
+ * @brief Estimates memory buffered while request is processed: request body kept by the caller, request proto and response proto
+ *
+ * Estimate saturates at maximum size instead of wrapping, so that outputs of huge shapes do not pass the budget.
+ */
+size_t estimateInFlightBytes(const ModelInstance& modelVersion, const PredictRequest& requestProto, size_t bufferedRequestBytes) {
+    constexpr size_t maxBytes = std::numeric_limits<size_t>::max();
+    size_t bytes = bufferedRequestBytes;
+    if (__builtin_add_overflow(bytes, requestProto.ByteSizeLong(), &bytes)) {
+        return maxBytes;
+    }
+    for (const auto& [name, output] : modelVersion.getOutputsInfo()) {
+        size_t size = output->getPrecision().size();
+        for (auto dim : output->getShape()) {
+            if (__builtin_mul_overflow(size, dim, &size)) {
+                return maxBytes;
+            }
+        }
+        if (__builtin_add_overflow(bytes, size, &bytes)) {
+            return maxBytes;
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief Checks whether client still waits for request, so that abandoned requests do not occupy infer requests
+ */
+Status checkRequestAbandoned(const StreamWaitingOptions& options) {
+    if (options.isCancelled()) {
+        return StatusCode::REQUEST_CANCELLED;
+    }
+    if (options.isExpired()) {
+        return StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT;
+    }
+    return StatusCode::OK;
+}
+
+/**
+ * @brief Sets input blobs filled by the caller on infer request
+ */
+Status setInputBlobs(InferenceEngine::InferRequest& inferRequest, const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& inputBlobs) {
+    try {
+        for (const auto& [name, blob] : inputBlobs) {
+            inferRequest.SetBlob(name, blob);
+        }
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    } catch (std::logic_error& e) {
+        Status status = StatusCode::OV_INTERNAL_DESERIALIZATION_ERROR;
+        SPDLOG_DEBUG("{}: {}", status.string(), e.what());
+        return status;
+    }
+    return StatusCode::OK;
+}
+
+/**
+ * @brief Records total processing time, outcome and in flight presence of predict request in model version metrics
+ */
+class RequestMetricsReporter {
+    ModelMetrics& metrics;
+    const Status& status;
+    const std::chrono::high_resolution_clock::time_point start;
+
+public:
+    RequestMetricsReporter(ModelMetrics& metrics, const Status& status) :
+        metrics(metrics),
+        status(status),
+        start(std::chrono::high_resolution_clock::now()) {
+        metrics.requestsInFlight.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~RequestMetricsReporter() {
+        metrics.requestsInFlight.fetch_sub(1, std::memory_order_relaxed);
+        if (!status.ok()) {
+            metrics.requestsFail.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        metrics.total.observe(std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count());
+        metrics.requestsSuccess.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief State of single inference started with inferenceAsync, frees itself once completion is reported
+ */
+class AsyncInferenceContext : public IdleStreamWaiter {
+    std::shared_ptr<ModelInstance> modelVersion;
+    std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuardPtr;
+    const PredictRequest* requestProto;
+    PredictResponse* responseProto;
+    const InferenceContinuationScheduler scheduleContinuation;
+    InferenceCompletionCallback onComplete;
+    const StreamWaitingOptions waitingOptions;
+    const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>* inputBlobs;
+
+    PredictRequest paddedRequest;
+    ShapeBucketPadding padding;
+
+    Status status;
+    RequestMetricsReporter metricsReporter;
+    Timer timer;
+    std::chrono::steady_clock::time_point spanStart;
+    const PhaseMarker* activePhase = nullptr;
+    int executingInferId = -1;
+    ResponseBackedOutputBlobs responseBackedOutputs;
+    tensor_map_t filteredOutputs;
+    const tensor_map_t* requestedOutputs = nullptr;
+
+public:
+    AsyncInferenceContext(
+        std::shared_ptr<ModelInstance> modelVersion,
+        std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuardPtr,
+        const PredictRequest* requestProto,
+        PredictResponse* responseProto,
+        InferenceContinuationScheduler scheduleContinuation,
+        InferenceCompletionCallback onComplete,
+        const StreamWaitingOptions& waitingOptions,
+        const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>* inputBlobs = nullptr) :
+        modelVersion(std::move(modelVersion)),
+        modelUnloadGuardPtr(std::move(modelUnloadGuardPtr)),
+        requestProto(requestProto),
+        responseProto(responseProto),
+        scheduleContinuation(std::move(scheduleContinuation)),
+        onComplete(std::move(onComplete)),
+        waitingOptions(waitingOptions),
+        inputBlobs(inputBlobs),
+        metricsReporter(this->modelVersion->getMetrics(), status) {}
+
+    void start();
+
+protected:
+    void notifyIdleStream(int streamId) override {
+        executingInferId = streamId;
+        scheduleContinuation([this]() { startInference(); });
+    }
+
+    void notifyDeadlineExceeded() override {
+        scheduleContinuation([this]() { complete(StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT); });
+    }
+
+    void notifyCancelled() override {
+        scheduleContinuation([this]() { complete(StatusCode::REQUEST_CANCELLED); });
+    }
+
+private:
+    void startInference();
+    void onInferenceCompleted(InferenceEngine::StatusCode sts);
+
+    void startSpan(const PhaseMarker& phase) {
+        activePhase = &phase;
+        phase.begin(this);
+        if (waitingOptions.trace) {
+            spanStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    void endPhase() {
+        if (activePhase) {
+            activePhase->end(this);
+            activePhase = nullptr;
+        }
+    }
+
+    void endSpan(const char* name) {
+        endPhase();
+        if (waitingOptions.trace) {
+            waitingOptions.trace->addSpan(name, spanStart, std::chrono::steady_clock::now());
+        }
+    }
+
+    void complete(Status result) {
+        status = result;
+        endPhase();
+        auto callback = std::move(onComplete);
+        // release model version and record metrics before caller is notified
+        delete this;
+        callback(result);
+    }
+};
+
+void AsyncInferenceContext::start() {
+    // inputs filled by the caller are already validated against model inputs
+    if (inputBlobs == nullptr && padRequestToShapeBuckets(modelVersion->getModelConfig(), *requestProto, paddedRequest, padding)) {
+        requestProto = &paddedRequest;
+    }
+    status = checkRequestAbandoned(waitingOptions);
+    if (status.ok() && inputBlobs == nullptr) {
+        status = modelVersion->validate(requestProto);
+        status = reloadModelIfRequired(status, *modelVersion, requestProto, modelUnloadGuardPtr);
+    }
+    if (status.ok()) {
+        status = getRequestedOutputs(modelVersion->getOutputsInfo(), *requestProto, filteredOutputs, requestedOutputs);
+    }
+    if (!status.ok()) {
+        complete(status);
+        return;
+    }
+
+    timer.start("get infer request");
+    startSpan(STREAM_WAIT_PHASE);
+    auto& inferRequestsQueue = modelVersion->getInferRequestsQueue();
+    auto streamId = inferRequestsQueue.tryGetIdleStream(waitingOptions.priority);
+    if (!streamId) {
+        setOptions(applyModelQueueLimits(modelVersion->getModelConfig(), waitingOptions));
+        // context may be resumed and completed on other thread before waitForIdleStream returns
+        if (!inferRequestsQueue.waitForIdleStream(*this)) {
+            complete(StatusCode::INFER_REQUESTS_QUEUE_FULL);
+        }
+        return;
+    }
+    executingInferId = streamId.value();
+    startInference();
+}
+
+void AsyncInferenceContext::startInference() {
+    using std::chrono::microseconds;
+    // restores affinity of continuation thread after context is completed and deleted
+    CpuAffinityGuard cpuAffinityGuard(modelVersion->getCpuAffinity());
+    auto& metrics = modelVersion->getMetrics();
+    timer.stop("get infer request");
+    endSpan("stream wait");
+    metrics.streamWait.observe(timer.elapsed<microseconds>("get infer request"));
+    SPDLOG_DEBUG("Getting infer req duration in model {}, version {}, nireq {}: {:.3f} ms",
+        requestProto->model_spec().name(), modelVersion->getVersion(), executingInferId, timer.elapsed<microseconds>("get infer request") / 1000);
+
+    auto& inferRequestsQueue = modelVersion->getInferRequestsQueue();
+    // client may have given up while request was waiting for infer request
+    status = checkRequestAbandoned(waitingOptions);
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Request for model {}, version {} abandoned before inference: {}", requestProto->model_spec().name(), modelVersion->getVersion(), status.string());
+        inferRequestsQueue.returnStream(executingInferId);
+        complete(status);
+        return;
+    }
+    InferenceEngine::InferRequest& inferRequest = inferRequestsQueue.getInferRequest(executingInferId);
+    timer.start("deserialize");
+    startSpan(DESERIALIZE_PHASE);
+    auto preallocatedInputBlobs = modelVersion->getPreallocatedInputBlobs(executingInferId);
+    if (inputBlobs != nullptr) {
+        status = setInputBlobs(inferRequest, *inputBlobs);
+    } else if (preallocatedInputBlobs != nullptr) {
+        status = deserializePredictRequestToPreallocatedBlobs<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion->getInputsInfo(), inferRequest, *preallocatedInputBlobs);
+    } else {
+        status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion->getInputsInfo(), inferRequest);
+    }
+    timer.stop("deserialize");
+    endSpan("deserialize");
+    metrics.deserialization.observe(timer.elapsed<microseconds>("deserialize"));
+    if (!status.ok()) {
+        inferRequestsQueue.returnStream(executingInferId);
+        complete(status);
+        return;
+    }
+    SPDLOG_DEBUG("Deserialization duration in model {}, version {}, nireq {}: {:.3f} ms",
+        requestProto->model_spec().name(), modelVersion->getVersion(), executingInferId, timer.elapsed<microseconds>("deserialize") / 1000);
+
+    // converted outputs are serialized from output blobs, inference does not write them into response
+    if (!modelVersion->getModelConfig().isFp16Outputs()) {
+        responseBackedOutputs.bind(inferRequest, *requestedOutputs, responseProto);
+    }
+    timer.start("prediction");
+    startSpan(INFERENCE_PHASE);
+    try {
+        inferRequest.SetCompletionCallback<std::function<void(InferenceEngine::InferRequest, InferenceEngine::StatusCode)>>(
+            [this](InferenceEngine::InferRequest, InferenceEngine::StatusCode sts) {
+                onInferenceCompleted(sts);
+            });
+        inferRequest.StartAsync();
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_ERROR("Async caught an exception {}: {}", status.string(), e.what());
+        inferRequest.SetCompletionCallback([]() {});  // reset callback on infer request
+        responseBackedOutputs.restore();
+        inferRequestsQueue.returnStream(executingInferId);
+        complete(status);
+    }
+}
+
+void AsyncInferenceContext::onInferenceCompleted(InferenceEngine::StatusCode sts) {
+    using std::chrono::microseconds;
+    auto& metrics = modelVersion->getMetrics();
+    auto& inferRequestsQueue = modelVersion->getInferRequestsQueue();
+    InferenceEngine::InferRequest& inferRequest = inferRequestsQueue.getInferRequest(executingInferId);
+    inferRequest.SetCompletionCallback([]() {});  // reset callback on infer request
+    timer.stop("prediction");
+    endSpan("inference");
+    metrics.inference.observe(timer.elapsed<microseconds>("prediction"));
+
+    if (sts != InferenceEngine::StatusCode::OK) {
+        status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
+        SPDLOG_ERROR("Async infer failed {}: {}", status.string(), sts);
+    } else {
+        SPDLOG_DEBUG("Prediction duration in model {}, version {}, nireq {}: {:.3f} ms",
+            requestProto->model_spec().name(), modelVersion->getVersion(), executingInferId, timer.elapsed<microseconds>("prediction") / 1000);
+        timer.start("serialize");
+        startSpan(SERIALIZE_PHASE);
+        status = serializePredictResponse(inferRequest, *requestedOutputs, responseProto, modelVersion->getModelConfig().isFp16Outputs());
+        if (status.ok() && padding.isApplied()) {
+            sliceResponseToRequestShapes(padding, *responseProto);
+        }
+        timer.stop("serialize");
+        endSpan("serialize");
+        metrics.serialization.observe(timer.elapsed<microseconds>("serialize"));
+        SPDLOG_DEBUG("Serialization duration in model {}, version {}, nireq {}: {:.3f} ms",
+            requestProto->model_spec().name(), modelVersion->getVersion(), executingInferId, timer.elapsed<microseconds>("serialize") / 1000);
+    }
+    responseBackedOutputs.restore();
+    inferRequestsQueue.returnStream(executingInferId);
+    complete(status);
+}
+
+/**
+ * @brief Runs sub-batches of request split to network batch size concurrently and merges their outputs
+ *
+ * Sub-batches are inferred asynchronously with continuations on shared executor, only calling thread waits for them.
+ *
+ * @return std::nullopt if request is not split and has to be processed as a whole
+ */
+std::optional<Status> inferenceSplitBatch(
+    ModelInstance& modelVersion,
+    const PredictRequest& requestProto,
+    PredictResponse* responseProto,
+    const StreamWaitingOptions& waitingOptions) {
+    const size_t batchSize = modelVersion.getBatchSize();
+    const size_t subBatchesCount = getSubBatchesCount(requestProto, batchSize);
+    if (subBatchesCount == 0) {
+        return std::nullopt;
+    }
+    // sub-batches must not reload model which is held loaded by the others, such requests are processed as a whole
+    PredictRequest firstSubRequest;
+    prepareSubBatchRequest(requestProto, batchSize, 0, firstSubRequest);
+    auto status = modelVersion.validate(&firstSubRequest);
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Sub-batch of request for model {}, version {} is not valid, request is not split: {}",
+            requestProto.model_spec().name(), modelVersion.getVersion(), status.string());
+        return std::nullopt;
+    }
+    SPDLOG_DEBUG("Request with batch size: {} split into {} sub-batches of batch size: {}",
+        getRequestBatchSize(&requestProto), subBatchesCount, batchSize);
+    // caller holds model version loaded until all sub-batches are completed
+    const std::shared_ptr<ModelInstance> unownedModelVersion(std::shared_ptr<ModelInstance>(), &modelVersion);
+    const InferenceContinuationScheduler scheduleContinuation = [](std::function<void()> continuation) {
+        WorkStealingExecutor::getInstance().schedule(std::move(continuation));
+    };
+    // sub-requests are prepared in windows of one for each infer request, instead of copying whole request up front
+    const size_t windowSize = std::max<size_t>(1, modelVersion.getInferRequestsQueue().size());
+    std::vector<PredictResponse> subResponses(subBatchesCount);
+    std::vector<PredictRequest> subRequests(std::min(windowSize, subBatchesCount));
+    subRequests[0] = std::move(firstSubRequest);
+    for (size_t windowStart = 0; windowStart < subBatchesCount; windowStart += windowSize) {
+        const size_t windowCount = std::min(windowSize, subBatchesCount - windowStart);
+        std::vector<Status> statuses(windowCount, StatusCode::OK);
+        std::mutex mtx;
+        std::condition_variable completed;
+        size_t pending = windowCount;
+        for (size_t i = 0; i < windowCount; i++) {
+            if (windowStart + i > 0) {
+                subRequests[i].Clear();
+                prepareSubBatchRequest(requestProto, batchSize, windowStart + i, subRequests[i]);
+            }
+            auto context = new AsyncInferenceContext(unownedModelVersion, std::make_unique<ModelInstanceUnloadGuard>(modelVersion),
+                &subRequests[i], &subResponses[windowStart + i], scheduleContinuation,
+                [&statuses, &mtx, &completed, &pending, i](const Status& subStatus) {
+                    // notified under lock since waiting thread frees state right after wake up
+                    std::lock_guard<std::mutex> lock(mtx);
+                    statuses[i] = subStatus;
+                    if (--pending == 0) {
+                        completed.notify_one();
+                    }
+                },
+                waitingOptions);
+            context->start();
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        completed.wait(lock, [&pending]() { return pending == 0; });
+        for (const auto& subStatus : statuses) {
+            if (!subStatus.ok()) {
+                return subStatus;
+            }
+        }
+    }
+    return mergeSubBatchResponses(subResponses, batchSize, getRequestBatchSize(&requestProto), *responseProto);
+}
+}  // namespace
+
 size_t getRequestBatchSize(const tensorflow::serving::PredictRequest* request) {
     auto requestInputItr = request->inputs().begin();
     if (requestInputItr == request->inputs().end()) {
@@ -69,17 +492,26 @@ Status getModelInstance(ovms::ModelManager& manager,
     if (model == nullptr) {
         return StatusCode::MODEL_NAME_MISSING;
     }
+    model->countRequest();
+    Status status = StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE;
+    auto retries = DEFAULT_MODEL_GET_RETRIES;
     if (modelVersionId != 0) {
-        modelInstance = model->getModelInstanceByVersion(modelVersionId);
-        if (modelInstance == nullptr) {
-            return StatusCode::MODEL_VERSION_MISSING;
+        // instance may be replaced by reload in the meantime, new one is taken from the model then
+        std::shared_ptr<ovms::ModelInstance> previousInstance;
+        while (status == StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE && retries--) {
+            modelInstance = model->getModelInstanceByVersion(modelVersionId);
+            if (modelInstance == nullptr) {
+                return StatusCode::MODEL_VERSION_MISSING;
+            }
+            if (modelInstance == previousInstance) {
+                break;
+            }
+            status = modelInstance->waitForLoaded(WAIT_FOR_MODEL_LOADED_TIMEOUT_MS, modelInstanceUnloadGuardPtr);
+            previousInstance = modelInstance;
         }
-
-        return modelInstance->waitForLoaded(WAIT_FOR_MODEL_LOADED_TIMEOUT_MS, modelInstanceUnloadGuardPtr);
+        return status;
     }
 
-    Status status = StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE;
-    auto retries = DEFAULT_MODEL_GET_RETRIES;
     while (status == StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE && retries--) {
         modelInstance = model->getDefaultModelInstance();
         if (modelInstance == nullptr) {
@@ -104,10 +536,55 @@ Status getPipeline(ovms::ModelManager& manager,
     return status;
 }
 
-Status performInference(ovms::OVInferRequestsQueue& inferRequestsQueue, const int executingInferId, InferenceEngine::InferRequest& inferRequest) {
+std::shared_ptr<PipelineBatcher> getPipelineBatcher(ovms::ModelManager& manager, const std::string& pipelineName) {
+    auto definition = manager.getPipelineFactory().findDefinitionByName(pipelineName);
+    return definition ? definition->getBatcher() : nullptr;
+}
+
+Status reserveModelInFlightMemory(const ModelInstance& modelVersion,
+    const PredictRequest& request,
+    size_t bufferedRequestBytes,
+    InFlightMemoryBudget::Reservation& reservation) {
+    auto& budget = InFlightMemoryBudget::getInstance();
+    const size_t modelBudgetBytes = modelVersion.getModelConfig().getInFlightMemoryBudgetMb() * 1024 * 1024;
+    if (budget.isUnlimited(modelBudgetBytes)) {
+        return StatusCode::OK;
+    }
+    auto reserved = budget.tryReserve(modelVersion.getName(), estimateInFlightBytes(modelVersion, request, bufferedRequestBytes), modelBudgetBytes);
+    if (!reserved) {
+        SPDLOG_DEBUG("Request for model {}, version {} rejected due to in flight memory budget", modelVersion.getName(), modelVersion.getVersion());
+        return StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED;
+    }
+    reservation = std::move(reserved.value());
+    return StatusCode::OK;
+}
+
+Status reservePipelineInFlightMemory(const std::string& pipelineName,
+    const PredictRequest& request,
+    size_t bufferedRequestBytes,
+    InFlightMemoryBudget::Reservation& reservation) {
+    auto& budget = InFlightMemoryBudget::getInstance();
+    if (budget.isUnlimited()) {
+        return StatusCode::OK;
+    }
+    auto reserved = budget.tryReserve(pipelineName, bufferedRequestBytes + request.ByteSizeLong());
+    if (!reserved) {
+        SPDLOG_DEBUG("Request for pipeline {} rejected due to in flight memory budget", pipelineName);
+        return StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED;
+    }
+    reservation = std::move(reserved.value());
+    return StatusCode::OK;
+}
+
+Status performInference(ovms::OVInferRequestsQueue& inferRequestsQueue, const int executingInferId, InferenceEngine::InferRequest& inferRequest, bool inlineExecution,
+    std::chrono::microseconds completionSpinTime) {
     try {
+        if (inlineExecution) {
+            inferRequest.Infer();
+            return StatusCode::OK;
+        }
         inferRequest.StartAsync();
-        InferenceEngine::StatusCode sts = inferRequest.Wait(InferenceEngine::IInferRequest::RESULT_READY);
+        InferenceEngine::StatusCode sts = waitForInferRequest(inferRequest, completionSpinTime);
         if (sts != InferenceEngine::StatusCode::OK) {
             Status status = StatusCode::OV_INTERNAL_INFERENCE_ERROR;
             SPDLOG_ERROR("Async infer failed {}: {}", status.string(), sts);
@@ -121,46 +598,216 @@ Status performInference(ovms::OVInferRequestsQueue& inferRequestsQueue, const in
     return StatusCode::OK;
 }
 
+namespace {
+/**
+ * @brief Runs request of stateful model on infer request held by its sequence, so that network state is kept between requests
+ */
+Status inferenceStateful(
+    ModelInstance& modelVersion,
+    SequenceManager& sequenceManager,
+    const PredictRequest* requestProto,
+    PredictResponse* responseProto,
+    const StreamWaitingOptions& waitingOptions) {
+    Timer timer;
+    using std::chrono::microseconds;
+    auto& metrics = modelVersion.getMetrics();
+
+    Status status;
+    RequestMetricsReporter metricsReporter(metrics, status);
+    SequenceRequest sequenceRequest;
+    status = parseSequenceRequest(*requestProto, sequenceRequest);
+    if (!status.ok())
+        return status;
+    status = modelVersion.validate(requestProto);
+    if (status.batchSizeChangeRequired() || status.reshapeRequired()) {
+        // reloading network would drop state of all sequences
+        SPDLOG_DEBUG("Stateful model {}, version {} cannot be reshaped to request shapes", modelVersion.getName(), modelVersion.getVersion());
+        status = Status(StatusCode::INVALID_SHAPE, "Stateful model cannot be reshaped");
+    }
+    if (!status.ok())
+        return status;
+    tensor_map_t filteredOutputs;
+    const tensor_map_t* requestedOutputs = nullptr;
+    status = getRequestedOutputs(modelVersion.getOutputsInfo(), *requestProto, filteredOutputs, requestedOutputs);
+    if (!status.ok())
+        return status;
+
+    CpuAffinityGuard cpuAffinityGuard(modelVersion.getCpuAffinity());
+    timer.start("get infer request");
+    uint64_t sequenceId = sequenceRequest.id;
+    std::shared_ptr<Sequence> sequence;
+    if (sequenceRequest.control == SequenceControl::START) {
+        status = sequenceManager.startSequence(sequenceId, applyModelQueueLimits(modelVersion.getModelConfig(), waitingOptions), sequence);
+    } else {
+        status = sequenceManager.findSequence(sequenceId, sequence);
+    }
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Request for model {}, version {}, sequence {} rejected: {}", requestProto->model_spec().name(), modelVersion.getVersion(), sequenceId, status.string());
+        return status;
+    }
+    std::lock_guard<std::mutex> sequenceLock(sequence->mtx);
+    int executingInferId = sequence->getStreamId();
+    InferenceEngine::InferRequest& inferRequest = sequence->getInferRequest();
+    timer.stop("get infer request");
+    metrics.streamWait.observe(timer.elapsed<microseconds>("get infer request"));
+
+    timer.start("deserialize");
+    auto preallocatedInputBlobs = modelVersion.getPreallocatedInputBlobs(executingInferId);
+    if (preallocatedInputBlobs != nullptr) {
+        status = deserializePredictRequestToPreallocatedBlobs<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion.getInputsInfo(), inferRequest, *preallocatedInputBlobs);
+    } else {
+        status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion.getInputsInfo(), inferRequest);
+    }
+    timer.stop("deserialize");
+    metrics.deserialization.observe(timer.elapsed<microseconds>("deserialize"));
+    if (status.ok()) {
+        timer.start("prediction");
+        status = performInference(modelVersion.getInferRequestsQueue(), executingInferId, inferRequest, false,
+            std::chrono::microseconds(modelVersion.getModelConfig().getCompletionSpinMicroseconds()));
+        timer.stop("prediction");
+        metrics.inference.observe(timer.elapsed<microseconds>("prediction"));
+    }
+    if (status.ok()) {
+        timer.start("serialize");
+        status = serializePredictResponse(inferRequest, *requestedOutputs, responseProto, modelVersion.getModelConfig().isFp16Outputs());
+        timer.stop("serialize");
+        metrics.serialization.observe(timer.elapsed<microseconds>("serialize"));
+    }
+    sequence->touch();
+    if (!status.ok()) {
+        if (sequenceRequest.control == SequenceControl::START) {
+            sequenceManager.endSequence(sequenceId);
+        }
+        return status;
+    }
+    SPDLOG_DEBUG("Stateful inference duration in model {}, version {}, sequence {}, nireq {}: {:.3f} ms",
+        requestProto->model_spec().name(), modelVersion.getVersion(), sequenceId, executingInferId, timer.elapsed<microseconds>("prediction") / 1000);
+    auto& sequenceIdOutput = (*responseProto->mutable_outputs())[SEQUENCE_ID_INPUT];
+    sequenceIdOutput.set_dtype(tensorflow::DataType::DT_UINT64);
+    sequenceIdOutput.mutable_tensor_shape()->add_dim()->set_size(1);
+    sequenceIdOutput.add_uint64_val(sequenceId);
+    if (sequenceRequest.control == SequenceControl::END) {
+        sequenceManager.endSequence(sequenceId);
+    }
+    return StatusCode::OK;
+}
+}  // namespace
+
 Status inference(
     ModelInstance& modelVersion,
     const PredictRequest* requestProto,
     PredictResponse* responseProto,
-    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr) {
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    const StreamWaitingOptions& waitingOptions) {
+    auto sequenceManager = modelVersion.getSequenceManager();
+    if (sequenceManager != nullptr) {
+        return inferenceStateful(modelVersion, *sequenceManager, requestProto, responseProto, waitingOptions);
+    }
+    if (isBatchSplitRequired(modelVersion, *requestProto)) {
+        auto splitStatus = inferenceSplitBatch(modelVersion, *requestProto, responseProto, waitingOptions);
+        if (splitStatus.has_value()) {
+            return splitStatus.value();
+        }
+    }
     Timer timer;
     using std::chrono::microseconds;
+    auto& metrics = modelVersion.getMetrics();
 
-    auto status = modelVersion.validate(requestProto);
+    Status status;
+    RequestMetricsReporter metricsReporter(metrics, status);
+    PredictRequest paddedRequest;
+    ShapeBucketPadding padding;
+    if (padRequestToShapeBuckets(modelVersion.getModelConfig(), *requestProto, paddedRequest, padding)) {
+        requestProto = &paddedRequest;
+    }
+    status = modelVersion.validate(requestProto);
     status = reloadModelIfRequired(status, modelVersion, requestProto, modelUnloadGuardPtr);
     if (!status.ok())
         return status;
+    tensor_map_t filteredOutputs;
+    const tensor_map_t* requestedOutputs = nullptr;
+    status = getRequestedOutputs(modelVersion.getOutputsInfo(), *requestProto, filteredOutputs, requestedOutputs);
+    if (!status.ok())
+        return status;
+
+    // request data is copied into blobs on the NUMA node the model was loaded on
+    CpuAffinityGuard cpuAffinityGuard(modelVersion.getCpuAffinity());
+    auto batchingScheduler = modelVersion.getBatchingScheduler();
+    if (batchingScheduler != nullptr) {
+        timer.start("batched inference");
+        status = batchingScheduler->execute(requestProto, responseProto);
+        timer.stop("batched inference");
+        SPDLOG_DEBUG("Batched inference duration in model {}, version {}: {:.3f} ms",
+            requestProto->model_spec().name(), modelVersion.getVersion(), timer.elapsed<microseconds>("batched inference") / 1000);
+        return status;
+    }
 
     timer.start("get infer request");
+    PhaseScope streamWaitPhase(STREAM_WAIT_PHASE, requestProto);
     ovms::OVInferRequestsQueue& inferRequestsQueue = modelVersion.getInferRequestsQueue();
-    ExecutingStreamIdGuard executingStreamIdGuard(inferRequestsQueue);
+    ExecutingStreamIdGuard executingStreamIdGuard(inferRequestsQueue, applyModelQueueLimits(modelVersion.getModelConfig(), waitingOptions));
+    if (!executingStreamIdGuard.getStatus().ok()) {
+        status = executingStreamIdGuard.getStatus();
+        SPDLOG_DEBUG("Request for model {}, version {} rejected: {}", requestProto->model_spec().name(), modelVersion.getVersion(), status.string());
+        return status;
+    }
     int executingInferId = executingStreamIdGuard.getId();
+    status = checkRequestAbandoned(waitingOptions);
+    if (!status.ok()) {
+        SPDLOG_DEBUG("Request for model {}, version {} abandoned before inference: {}", requestProto->model_spec().name(), modelVersion.getVersion(), status.string());
+        return status;
+    }
     InferenceEngine::InferRequest& inferRequest = inferRequestsQueue.getInferRequest(executingInferId);
     timer.stop("get infer request");
+    streamWaitPhase.end();
+    metrics.streamWait.observe(timer.elapsed<microseconds>("get infer request"));
     SPDLOG_DEBUG("Getting infer req duration in model {}, version {}, nireq {}: {:.3f} ms",
         requestProto->model_spec().name(), modelVersion.getVersion(), executingInferId, timer.elapsed<microseconds>("get infer request") / 1000);
 
     timer.start("deserialize");
-    status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion.getInputsInfo(), inferRequest);
+    PhaseScope deserializePhase(DESERIALIZE_PHASE, requestProto);
+    auto preallocatedInputBlobs = modelVersion.getPreallocatedInputBlobs(executingInferId);
+    if (preallocatedInputBlobs != nullptr) {
+        status = deserializePredictRequestToPreallocatedBlobs<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion.getInputsInfo(), inferRequest, *preallocatedInputBlobs);
+    } else {
+        status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(*requestProto, modelVersion.getInputsInfo(), inferRequest);
+    }
     timer.stop("deserialize");
+    deserializePhase.end();
+    metrics.deserialization.observe(timer.elapsed<microseconds>("deserialize"));
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Deserialization duration in model {}, version {}, nireq {}: {:.3f} ms",
         requestProto->model_spec().name(), modelVersion.getVersion(), executingInferId, timer.elapsed<microseconds>("deserialize") / 1000);
+    // restored before infer request is returned by executing stream guard
+    ResponseBackedOutputBlobs responseBackedOutputs;
+    const bool fp16Outputs = modelVersion.getModelConfig().isFp16Outputs();
+    if (!fp16Outputs) {
+        responseBackedOutputs.bind(inferRequest, *requestedOutputs, responseProto);
+    }
     timer.start("prediction");
-    status = performInference(inferRequestsQueue, executingInferId, inferRequest);
+    PhaseScope inferencePhase(INFERENCE_PHASE, requestProto);
+    // synchronous call saves handoff to stream thread, only worth it while no other request waits for its infer request
+    const bool inlineExecution = modelVersion.getModelConfig().isInlineInference() && inferRequestsQueue.getWaitersCount() == 0;
+    status = performInference(inferRequestsQueue, executingInferId, inferRequest, inlineExecution,
+        std::chrono::microseconds(modelVersion.getModelConfig().getCompletionSpinMicroseconds()));
     timer.stop("prediction");
+    inferencePhase.end();
+    metrics.inference.observe(timer.elapsed<microseconds>("prediction"));
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Prediction duration in model {}, version {}, nireq {}: {:.3f} ms",
         requestProto->model_spec().name(), modelVersion.getVersion(), executingInferId, timer.elapsed<microseconds>("prediction") / 1000);
 
     timer.start("serialize");
-    status = serializePredictResponse(inferRequest, modelVersion.getOutputsInfo(), responseProto);
+    PhaseScope serializePhase(SERIALIZE_PHASE, requestProto);
+    status = serializePredictResponse(inferRequest, *requestedOutputs, responseProto, fp16Outputs);
+    if (status.ok() && padding.isApplied()) {
+        sliceResponseToRequestShapes(padding, *responseProto);
+    }
     timer.stop("serialize");
+    serializePhase.end();
+    metrics.serialization.observe(timer.elapsed<microseconds>("serialize"));
     if (!status.ok())
         return status;
     SPDLOG_DEBUG("Serialization duration in model {}, version {}, nireq {}: {:.3f} ms",
@@ -169,6 +816,90 @@ Status inference(
     return StatusCode::OK;
 }
 
+void inferenceAsync(
+    std::shared_ptr<ModelInstance> modelVersion,
+    const PredictRequest* requestProto,
+    PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuardPtr,
+    InferenceContinuationScheduler scheduleContinuation,
+    InferenceCompletionCallback onComplete,
+    const StreamWaitingOptions& waitingOptions) {
+    InFlightMemoryBudget::Reservation reservation;
+    auto status = reserveModelInFlightMemory(*modelVersion, *requestProto, waitingOptions.bufferedRequestBytes, reservation);
+    if (!status.ok()) {
+        modelUnloadGuardPtr.reset();
+        onComplete(status);
+        return;
+    }
+    if (reservation.getBytes() > 0) {
+        // bytes are released once completion callback is destroyed, after response was handed over
+        onComplete = [onComplete = std::move(onComplete),
+                         reservation = std::make_shared<InFlightMemoryBudget::Reservation>(std::move(reservation))](const Status& status) {
+            onComplete(status);
+        };
+    }
+    // dynamically batched, split and stateful requests are executed synchronously, by one of bounded pool of threads waiting for inference
+    if (modelVersion->getBatchingScheduler() != nullptr ||
+        modelVersion->getSequenceManager() != nullptr ||
+        isBatchSplitRequired(*modelVersion, *requestProto)) {
+        // executor takes copyable tasks, unload guard is shared by copies of the task and released once it is finished
+        auto unloadGuard = std::make_shared<std::unique_ptr<ModelInstanceUnloadGuard>>(std::move(modelUnloadGuardPtr));
+        bool scheduled = BlockingTasksExecutor::getInferencesInstance().schedule(
+            [modelVersion, requestProto, responseProto, unloadGuard, onComplete, waitingOptions]() {
+                auto status = inference(*modelVersion, requestProto, responseProto, *unloadGuard, waitingOptions);
+                unloadGuard->reset();
+                onComplete(status);
+            });
+        if (!scheduled) {
+            unloadGuard->reset();
+            onComplete(StatusCode::SERVER_SHUTTING_DOWN);
+        }
+        return;
+    }
+    auto context = new AsyncInferenceContext(std::move(modelVersion), std::move(modelUnloadGuardPtr),
+        requestProto, responseProto, std::move(scheduleContinuation), std::move(onComplete), waitingOptions);
+    context->start();
+}
+
+void inferenceWithInputBlobsAsync(
+    std::shared_ptr<ModelInstance> modelVersion,
+    const PredictRequest* requestProto,
+    const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& inputBlobs,
+    PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuardPtr,
+    InferenceContinuationScheduler scheduleContinuation,
+    InferenceCompletionCallback onComplete,
+    const StreamWaitingOptions& waitingOptions) {
+    if (modelVersion->getBatchingScheduler() != nullptr) {
+        SPDLOG_DEBUG("Model {}, version {} with dynamic batching does not accept input blobs", modelVersion->getName(), modelVersion->getVersion());
+        modelUnloadGuardPtr.reset();
+        onComplete(Status(StatusCode::NOT_IMPLEMENTED, "Input blobs are not supported for models with dynamic batching"));
+        return;
+    }
+    if (modelVersion->getSequenceManager() != nullptr) {
+        SPDLOG_DEBUG("Stateful model {}, version {} does not accept input blobs", modelVersion->getName(), modelVersion->getVersion());
+        modelUnloadGuardPtr.reset();
+        onComplete(Status(StatusCode::NOT_IMPLEMENTED, "Input blobs are not supported for stateful models"));
+        return;
+    }
+    auto context = new AsyncInferenceContext(std::move(modelVersion), std::move(modelUnloadGuardPtr),
+        requestProto, responseProto, std::move(scheduleContinuation), std::move(onComplete), waitingOptions, &inputBlobs);
+    context->start();
+}
+
+std::optional<RequestPriority> parseRequestPriority(const std::string& priority) {
+    std::string lowercase = priority;
+    std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), ::tolower);
+    if (lowercase == "high") {
+        return RequestPriority::HIGH;
+    } else if (lowercase == "normal") {
+        return RequestPriority::NORMAL;
+    } else if (lowercase == "low") {
+        return RequestPriority::LOW;
+    }
+    return std::nullopt;
+}
+
 Status reloadModelIfRequired(
     Status validationStatus,
     ModelInstance& modelInstance,
@@ -14,9 +14,13 @@
 // limitations under the License.
 //*****************************************************************************
 #pragma once
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #pragma GCC diagnostic push
@@ -24,6 +28,7 @@
 #include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
 #pragma GCC diagnostic pop
 
+#include "inflightmemorybudget.hpp"
 #include "modelinstance.hpp"
 #include "modelmanager.hpp"
 
@@ -45,13 +50,103 @@ Status getPipeline(ModelManager& manager,
     const tensorflow::serving::PredictRequest* request,
     tensorflow::serving::PredictResponse* response);
 
-Status performInference(ovms::OVInferRequestsQueue& inferRequestsQueue, const int executingInferId, InferenceEngine::InferRequest& inferRequest);
+/**
+ * @brief Gets batcher merging concurrent requests of pipeline
+ *
+ * @return batcher or nullptr if pipeline does not exist or its batching is disabled
+ */
+std::shared_ptr<PipelineBatcher> getPipelineBatcher(ModelManager& manager, const std::string& pipelineName);
+
+/**
+ * @brief Reserves estimated memory of model request in in flight memory budget: buffered body, request and response protos
+ *
+ * @param bufferedRequestBytes size of request body or inputs buffered by the caller until inference finishes
+ *
+ * @return IN_FLIGHT_MEMORY_EXHAUSTED if budget would be exceeded
+ */
+Status reserveModelInFlightMemory(const ModelInstance& modelVersion,
+    const tensorflow::serving::PredictRequest& request,
+    size_t bufferedRequestBytes,
+    InFlightMemoryBudget::Reservation& reservation);
+
+/**
+ * @brief Reserves estimated memory of pipeline request in in flight memory budget, node outputs are reserved by nodes copying them
+ *
+ * @param bufferedRequestBytes size of request body buffered by the caller until pipeline finishes
+ *
+ * @return IN_FLIGHT_MEMORY_EXHAUSTED if budget would be exceeded
+ */
+Status reservePipelineInFlightMemory(const std::string& pipelineName,
+    const tensorflow::serving::PredictRequest& request,
+    size_t bufferedRequestBytes,
+    InFlightMemoryBudget::Reservation& reservation);
+
+Status performInference(ovms::OVInferRequestsQueue& inferRequestsQueue, const int executingInferId, InferenceEngine::InferRequest& inferRequest, bool inlineExecution = false,
+    std::chrono::microseconds completionSpinTime = std::chrono::microseconds(0));
 
 Status inference(
     ModelInstance& modelVersion,
     const tensorflow::serving::PredictRequest* requestProto,
     tensorflow::serving::PredictResponse* responseProto,
-    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr);
+    std::unique_ptr<ModelInstanceUnloadGuard>& modelUnloadGuardPtr,
+    const StreamWaitingOptions& waitingOptions = {});
+
+/**
+ * @brief Hands over continuation of asynchronous inference to thread owned by the caller
+ */
+using InferenceContinuationScheduler = std::function<void(std::function<void()>)>;
+using InferenceCompletionCallback = std::function<void(const Status&)>;
+
+/**
+ * @brief Runs inference without blocking calling thread until infer request is finished
+ *
+ * Request is validated and deserialized in calling thread when there is idle infer request. Otherwise it waits
+ * in infer requests queue and is resumed through scheduleContinuation, which is invoked with queue lock held and
+ * should only pass continuation to other thread. Response is serialized in OpenVINO completion callback.
+ * onComplete is called exactly once; request and response must stay valid until then.
+ * Models with batching scheduler are executed synchronously on separate thread since batch leader blocks.
+ * Priority and deadline of waitingOptions are combined with max_queue_size and queue_timeout_microseconds of the model,
+ * rejected requests complete with INFER_REQUESTS_QUEUE_FULL or INFER_REQUESTS_QUEUE_TIMEOUT.
+ * Request cancelled by the client or past its deadline is not started once it gets infer request, it completes with
+ * REQUEST_CANCELLED or INFER_REQUESTS_QUEUE_TIMEOUT instead.
+ */
+void inferenceAsync(
+    std::shared_ptr<ModelInstance> modelVersion,
+    const tensorflow::serving::PredictRequest* requestProto,
+    tensorflow::serving::PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuardPtr,
+    InferenceContinuationScheduler scheduleContinuation,
+    InferenceCompletionCallback onComplete,
+    const StreamWaitingOptions& waitingOptions = {});
+
+/**
+ * @brief Runs inference like inferenceAsync on input blobs filled by the caller instead of deserializing request inputs
+ *
+ * Request holds only model spec and output filter. Blobs are keyed by network input name, have to match model inputs
+ * and stay valid until onComplete is called. Input memory is not reserved in in flight memory budget, it is up to the caller.
+ * Models with dynamic batching are not supported.
+ */
+void inferenceWithInputBlobsAsync(
+    std::shared_ptr<ModelInstance> modelVersion,
+    const tensorflow::serving::PredictRequest* requestProto,
+    const std::unordered_map<std::string, InferenceEngine::Blob::Ptr>& inputBlobs,
+    tensorflow::serving::PredictResponse* responseProto,
+    std::unique_ptr<ModelInstanceUnloadGuard> modelUnloadGuardPtr,
+    InferenceContinuationScheduler scheduleContinuation,
+    InferenceCompletionCallback onComplete,
+    const StreamWaitingOptions& waitingOptions = {});
+
+/**
+ * @brief Name of gRPC metadata entry and HTTP header with request priority: high, normal or low
+ */
+const std::string REQUEST_PRIORITY_HEADER = "inference-priority";
+
+/**
+ * @brief Parses request priority, case insensitive
+ *
+ * @return priority or nullopt if value is not recognized
+ */
+std::optional<RequestPriority> parseRequestPriority(const std::string& priority);
 
 Status reloadModelIfRequired(
     Status validationStatus,
@@ -0,0 +1,190 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "preprocessing_node.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "ov_utils.hpp"
+
+namespace ovms {
+
+namespace {
+// Kernels are written as plain loops over contiguous memory with precomputed coefficients,
+// so that compiler can vectorize them for the target instruction set.
+
+template <typename T>
+void normalizePlanar(const T* __restrict src, float* __restrict dst, size_t channels, size_t pixels,
+    const float* mean, const float* invScale) {
+    for (size_t c = 0; c < channels; c++) {
+        const T* srcPlane = src + c * pixels;
+        float* dstPlane = dst + c * pixels;
+        const float m = mean[c];
+        const float s = invScale[c];
+        for (size_t p = 0; p < pixels; p++) {
+            dstPlane[p] = (static_cast<float>(srcPlane[p]) - m) * s;
+        }
+    }
+}
+
+template <typename T>
+void normalizeInterleaved(const T* __restrict src, float* __restrict dst, size_t channels, size_t pixels,
+    const float* mean, const float* invScale) {
+    for (size_t c = 0; c < channels; c++) {
+        float* dstPlane = dst + c * pixels;
+        const float m = mean[c];
+        const float s = invScale[c];
+        for (size_t p = 0; p < pixels; p++) {
+            dstPlane[p] = (static_cast<float>(src[p * channels + c]) - m) * s;
+        }
+    }
+}
+
+template <typename T>
+void normalize(const T* src, float* dst, bool interleaved, size_t channels, size_t pixels,
+    const std::vector<float>& mean, const std::vector<float>& invScale) {
+    if (interleaved) {
+        normalizeInterleaved(src, dst, channels, pixels, mean.data(), invScale.data());
+    } else {
+        normalizePlanar(src, dst, channels, pixels, mean.data(), invScale.data());
+    }
+}
+
+struct ResizeCoefficients {
+    std::vector<size_t> first;
+    std::vector<size_t> second;
+    std::vector<float> weight;
+
+    ResizeCoefficients(size_t inputSize, size_t outputSize) :
+        first(outputSize),
+        second(outputSize),
+        weight(outputSize) {
+        const float scale = static_cast<float>(inputSize) / outputSize;
+        for (size_t o = 0; o < outputSize; o++) {
+            float position = std::min(std::max((o + 0.5f) * scale - 0.5f, 0.0f), static_cast<float>(inputSize - 1));
+            first[o] = static_cast<size_t>(position);
+            second[o] = std::min(first[o] + 1, inputSize - 1);
+            weight[o] = position - first[o];
+        }
+    }
+};
+
+void resizePlane(const float* __restrict src, size_t width, float* __restrict dst, size_t outputWidth,
+    const ResizeCoefficients& columns, const ResizeCoefficients& rows, float* __restrict rowBuffer) {
+    for (size_t oy = 0; oy < rows.first.size(); oy++) {
+        const float* top = src + rows.first[oy] * width;
+        const float* bottom = src + rows.second[oy] * width;
+        const float wy = rows.weight[oy];
+        // vertical pass is contiguous, horizontal pass reads through precomputed indices
+        for (size_t x = 0; x < width; x++) {
+            rowBuffer[x] = top[x] + (bottom[x] - top[x]) * wy;
+        }
+        float* out = dst + oy * outputWidth;
+        for (size_t ox = 0; ox < outputWidth; ox++) {
+            const float left = rowBuffer[columns.first[ox]];
+            const float right = rowBuffer[columns.second[ox]];
+            out[ox] = left + (right - left) * columns.weight[ox];
+        }
+    }
+}
+
+std::vector<float> perChannel(const std::vector<float>& values, size_t channels, float defaultValue) {
+    if (values.empty()) {
+        return std::vector<float>(channels, defaultValue);
+    }
+    if (values.size() == 1) {
+        return std::vector<float>(channels, values[0]);
+    }
+    return values;
+}
+}  // namespace
+
+Status PreprocessingNode::process() {
+    auto imageItr = this->inputBlobs.find(PREPROCESSING_IMAGE_INPUT_NAME);
+    if (imageItr == this->inputBlobs.end()) {
+        SPDLOG_DEBUG("[Node: {}] Missing {} input", getName(), PREPROCESSING_IMAGE_INPUT_NAME);
+        return StatusCode::INVALID_MISSING_INPUT;
+    }
+    const auto& image = imageItr->second;
+    const auto precision = image->getTensorDesc().getPrecision();
+    if (precision != InferenceEngine::Precision::U8 && precision != InferenceEngine::Precision::FP32) {
+        SPDLOG_DEBUG("[Node: {}] Only U8 and FP32 images are supported", getName());
+        return StatusCode::INVALID_PRECISION;
+    }
+    const auto& dims = image->getTensorDesc().getDims();
+    if (dims.size() != 4) {
+        SPDLOG_DEBUG("[Node: {}] Expected image with 4 dimensions in {} layout", getName(), parameters.inputLayout);
+        return StatusCode::INVALID_SHAPE;
+    }
+    const bool interleaved = parameters.inputLayout == "NHWC";
+    const size_t batch = dims[0];
+    const size_t channels = interleaved ? dims[3] : dims[1];
+    const size_t height = interleaved ? dims[1] : dims[2];
+    const size_t width = interleaved ? dims[2] : dims[3];
+    if (height == 0 || width == 0) {
+        return StatusCode::INVALID_SHAPE;
+    }
+    const auto mean = perChannel(parameters.mean, channels, 0.0f);
+    auto invScale = perChannel(parameters.scale, channels, 1.0f);
+    if (mean.size() != channels || invScale.size() != channels) {
+        const std::string details = "Mean and scale values count does not match image channels: " + std::to_string(channels);
+        SPDLOG_DEBUG("[Node: {}] {}", getName(), details);
+        return Status(StatusCode::INVALID_SHAPE, details);
+    }
+    std::transform(invScale.begin(), invScale.end(), invScale.begin(), [](float scale) { return 1.0f / scale; });
+
+    const size_t outputHeight = parameters.resizeHeight > 0 ? parameters.resizeHeight : height;
+    const size_t outputWidth = parameters.resizeWidth > 0 ? parameters.resizeWidth : width;
+    const bool resize = outputHeight != height || outputWidth != width;
+    auto output = createZeroBlob(InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32,
+        {batch, channels, outputHeight, outputWidth}, InferenceEngine::Layout::NCHW));
+
+    const size_t pixels = height * width;
+    const size_t outputPixels = outputHeight * outputWidth;
+    float* outputData = output->buffer().as<float*>();
+    // normalization is linear, so it is applied before resize, when image is converted to planar layout
+    std::vector<float> planar(resize ? channels * pixels : 0);
+    std::vector<float> rowBuffer(resize ? width : 0);
+    std::unique_ptr<ResizeCoefficients> columns, rows;
+    if (resize) {
+        columns = std::make_unique<ResizeCoefficients>(width, outputWidth);
+        rows = std::make_unique<ResizeCoefficients>(height, outputHeight);
+    }
+    for (size_t n = 0; n < batch; n++) {
+        float* normalized = resize ? planar.data() : outputData + n * channels * outputPixels;
+        if (precision == InferenceEngine::Precision::U8) {
+            normalize(image->cbuffer().as<const uint8_t*>() + n * channels * pixels, normalized, interleaved, channels, pixels, mean, invScale);
+        } else {
+            normalize(image->cbuffer().as<const float*>() + n * channels * pixels, normalized, interleaved, channels, pixels, mean, invScale);
+        }
+        if (!resize) {
+            continue;
+        }
+        for (size_t c = 0; c < channels; c++) {
+            resizePlane(planar.data() + c * pixels, width, outputData + (n * channels + c) * outputPixels, outputWidth, *columns, *rows, rowBuffer.data());
+        }
+    }
+    SPDLOG_DEBUG("[Node: {}] Preprocessed batch of {} images {}x{} into {}x{}", getName(), batch, width, height, outputWidth, outputHeight);
+    this->outputBlobs.emplace(PREPROCESSING_IMAGE_OUTPUT_NAME, std::move(output));
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
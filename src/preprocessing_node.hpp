@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "built_in_node.hpp"
+
+namespace ovms {
+
+const std::string PREPROCESSING_IMAGE_INPUT_NAME = "image";
+const std::string PREPROCESSING_IMAGE_OUTPUT_NAME = "image";
+
+struct PreprocessingParameters {
+    // 0 keeps original size
+    size_t resizeWidth = 0;
+    size_t resizeHeight = 0;
+    // Empty, single value for all channels or value for each channel
+    std::vector<float> mean;
+    std::vector<float> scale;
+    // Layout of input image, either NCHW or NHWC
+    std::string inputLayout = "NCHW";
+};
+
+/**
+ * @brief Prepares raw images sent by clients for the model inference
+ *
+ * Takes U8 or FP32 image batch in NHWC or NCHW layout and produces FP32 NCHW batch with values
+ * normalized as (value - mean) / scale, resized with bilinear interpolation when size is configured.
+ */
+class PreprocessingNode : public BuiltInNode {
+    const PreprocessingParameters parameters;
+
+public:
+    PreprocessingNode(const std::string& nodeName, const PreprocessingParameters& parameters,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        BuiltInNode(nodeName, nodeOutputNameAlias),
+        parameters(parameters) {}
+
+protected:
+    Status process() override;
+};
+
+}  // namespace ovms
@@ -0,0 +1,226 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <execinfo.h>
+#ifdef OVMS_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+#include <malloc.h>
+#include <signal.h>
+#include <spdlog/spdlog.h>
+#include <sys/time.h>
+
+#ifdef OVMS_JEMALLOC
+// arena per CPU avoids contention and fragmentation of threads allocating large tensors, freed pages are purged by
+// background threads instead of request threads, overridden by MALLOC_CONF environment variable
+const char* malloc_conf = "percpu_arena:percpu,background_thread:true";
+#endif
+
+namespace ovms {
+
+namespace {
+const size_t MAX_SAMPLES = 1 << 16;
+const size_t MAX_STACK_DEPTH = 64;
+// signal handler and signal trampoline
+const size_t SKIPPED_FRAMES = 2;
+
+std::atomic<bool> enabled{false};
+std::atomic<bool> running{false};
+std::atomic<void**> samples{nullptr};
+std::atomic<size_t> samplesCount{0};
+std::atomic<int> handlersInProgress{0};
+
+static_assert(std::atomic<void**>::is_always_lock_free && std::atomic<size_t>::is_always_lock_free && std::atomic<int>::is_always_lock_free,
+    "signal handler can use only lock free atomics");
+
+void onProfilingSignal(int) {
+    const int savedErrno = errno;
+    handlersInProgress.fetch_add(1);
+    void** buffer = samples.load();
+    if (buffer != nullptr) {
+        const size_t index = samplesCount.fetch_add(1);
+        if (index < MAX_SAMPLES) {
+            void** sample = buffer + index * (MAX_STACK_DEPTH + 1);
+            const int depth = backtrace(sample + 1, MAX_STACK_DEPTH);
+            sample[0] = reinterpret_cast<void*>(static_cast<uintptr_t>(depth));
+        }
+    }
+    handlersInProgress.fetch_sub(1);
+    errno = savedErrno;
+}
+
+void setProfilingTimer(uint64_t periodMicroseconds) {
+    itimerval timer{};
+    timer.it_interval.tv_sec = periodMicroseconds / 1000000;
+    timer.it_interval.tv_usec = periodMicroseconds % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void appendWord(std::string& profile, uintptr_t word) {
+    profile.append(reinterpret_cast<const char*>(&word), sizeof(word));
+}
+
+std::string serializeProfile(void** buffer, size_t count, uint64_t periodMicroseconds) {
+    std::map<std::vector<uintptr_t>, uintptr_t> stacks;
+    for (size_t i = 0; i < count; i++) {
+        void** sample = buffer + i * (MAX_STACK_DEPTH + 1);
+        const size_t depth = reinterpret_cast<uintptr_t>(sample[0]);
+        if (depth <= SKIPPED_FRAMES) {
+            continue;
+        }
+        std::vector<uintptr_t> stack;
+        std::transform(sample + 1 + SKIPPED_FRAMES, sample + 1 + depth, std::back_inserter(stack),
+            [](void* pc) { return reinterpret_cast<uintptr_t>(pc); });
+        stacks[std::move(stack)]++;
+    }
+    std::string profile;
+    // header: header words count, version, sampling period, padding
+    for (uintptr_t word : {uintptr_t(0), uintptr_t(3), uintptr_t(0), uintptr_t(periodMicroseconds), uintptr_t(0)}) {
+        appendWord(profile, word);
+    }
+    for (const auto& [stack, samplesOfStack] : stacks) {
+        appendWord(profile, samplesOfStack);
+        appendWord(profile, stack.size());
+        for (uintptr_t pc : stack) {
+            appendWord(profile, pc);
+        }
+    }
+    // trailer
+    for (uintptr_t word : {uintptr_t(0), uintptr_t(1), uintptr_t(0)}) {
+        appendWord(profile, word);
+    }
+    std::ifstream maps("/proc/self/maps");
+    std::stringstream mapsContent;
+    mapsContent << maps.rdbuf();
+    profile += mapsContent.str();
+    return profile;
+}
+}  // namespace
+
+void CpuProfiler::setEnabled(bool isEnabled) {
+    enabled = isEnabled;
+}
+
+bool CpuProfiler::isEnabled() {
+    return enabled;
+}
+
+Status CpuProfiler::profile(std::chrono::milliseconds duration, std::string& profile, uint32_t frequency) {
+    bool expected = false;
+    if (!running.compare_exchange_strong(expected, true)) {
+        return StatusCode::PROFILER_BUSY;
+    }
+    // first call of backtrace loads unwinder, which is not allowed in signal handler
+    void* warmUpStack[1];
+    backtrace(warmUpStack, 1);
+    std::unique_ptr<void*[]> buffer(new void*[MAX_SAMPLES * (MAX_STACK_DEPTH + 1)]);
+    samplesCount = 0;
+    samples = buffer.get();
+
+    struct sigaction action {};
+    action.sa_handler = onProfilingSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        samples = nullptr;
+        running = false;
+        SPDLOG_ERROR("Cannot install SIGPROF handler for profiling");
+        return StatusCode::PROFILER_FAILED;
+    }
+    const uint64_t periodMicroseconds = 1000000 / std::max<uint32_t>(1, frequency);
+    SPDLOG_INFO("Started CPU profiling for {} ms", duration.count());
+    setProfilingTimer(periodMicroseconds);
+    std::this_thread::sleep_for(duration);
+    setProfilingTimer(0);
+    samples = nullptr;
+    // signal pending after timer is stopped is ignored instead of terminating the process
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPROF, &action, nullptr);
+    while (handlersInProgress.load() > 0) {
+        std::this_thread::yield();
+    }
+    const size_t count = std::min(samplesCount.load(), MAX_SAMPLES);
+    SPDLOG_INFO("Finished CPU profiling with {} samples", count);
+    profile = serializeProfile(buffer.get(), count, periodMicroseconds);
+    running = false;
+    return StatusCode::OK;
+}
+
+Status CpuProfiler::parseDuration(std::string_view seconds, std::chrono::milliseconds maxDuration, std::chrono::milliseconds& duration) {
+    const uint32_t maxSeconds = std::chrono::duration_cast<std::chrono::seconds>(maxDuration).count();
+    if (seconds.empty()) {
+        duration = maxDuration;
+        return StatusCode::OK;
+    }
+    uint32_t requested = 0;
+    auto [end, error] = std::from_chars(seconds.data(), seconds.data() + seconds.size(), requested);
+    if (error != std::errc() || end != seconds.data() + seconds.size() || requested == 0 || requested > maxSeconds) {
+        return Status(StatusCode::REST_INVALID_URL, "seconds should be from 1 to " + std::to_string(maxSeconds));
+    }
+    duration = std::chrono::seconds(requested);
+    return StatusCode::OK;
+}
+
+#ifdef OVMS_JEMALLOC
+const char* getHeapStatisticsContentType() {
+    return "application/json";
+}
+
+Status getHeapStatistics(std::string& statistics) {
+    statistics.clear();
+    malloc_stats_print([](void* output, const char* part) { static_cast<std::string*>(output)->append(part); }, &statistics, "J");
+    return statistics.empty() ? StatusCode::PROFILER_FAILED : StatusCode::OK;
+}
+#else
+const char* getHeapStatisticsContentType() {
+    return "text/xml";
+}
+
+Status getHeapStatistics(std::string& statistics) {
+    char* content = nullptr;
+    size_t size = 0;
+    FILE* stream = open_memstream(&content, &size);
+    if (stream == nullptr) {
+        return StatusCode::PROFILER_FAILED;
+    }
+    const int result = malloc_info(0, stream);
+    fclose(stream);
+    if (result != 0) {
+        free(content);
+        return StatusCode::PROFILER_FAILED;
+    }
+    statistics.assign(content, size);
+    free(content);
+    return StatusCode::OK;
+}
+#endif
+
+}  // namespace ovms
@@ -0,0 +1,71 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Samples call stacks of threads consuming CPU with SIGPROF timer, one profile at a time
+ *
+ * Profile is written in legacy CPU profile format of gperftools followed by memory mappings of the process,
+ * so that it can be read by pprof together with the server binary.
+ */
+class CpuProfiler {
+public:
+    /**
+     * @brief Enables profiling endpoints of REST API, disabled by default
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * @brief Samples call stacks for given duration of wall time, blocks calling thread meanwhile
+     *
+     * @param duration
+     * @param profile
+     * @param frequency samples per second of CPU time consumed by the process
+     *
+     * @return status, PROFILER_BUSY when other profile is being collected
+     */
+    static Status profile(std::chrono::milliseconds duration, std::string& profile, uint32_t frequency = 100);
+
+    /**
+     * @brief Parses duration of profile requested in whole seconds, so that it fits below request timeout
+     *
+     * @param seconds requested duration, maxDuration if empty
+     * @param maxDuration
+     * @param duration
+     *
+     * @return status, REST_INVALID_URL when seconds are not a number or exceed maxDuration
+     */
+    static Status parseDuration(std::string_view seconds, std::chrono::milliseconds maxDuration, std::chrono::milliseconds& duration);
+};
+
+/**
+ * @brief Gets statistics of heap allocator arenas in XML format of malloc_info, or in JSON format of malloc_stats_print when built with jemalloc
+ */
+Status getHeapStatistics(std::string& statistics);
+
+const char* getHeapStatisticsContentType();
+
+}  // namespace ovms
@@ -0,0 +1,147 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "readiness.hpp"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "modelinstance.hpp"
+#include "modelinstanceunloadguard.hpp"
+#include "modelmanager.hpp"
+
+namespace ovms {
+
+namespace {
+ReadinessProbe::buckets_t getBucketsCounts(const LatencyHistogram& histogram) {
+    ReadinessProbe::buckets_t buckets;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        buckets[i] = histogram.getBucketCount(i);
+    }
+    return buckets;
+}
+
+ReadinessProbe::buckets_t getBucketsSince(const ReadinessProbe::buckets_t& current, const ReadinessProbe::buckets_t* previous) {
+    if (!previous) {
+        return current;
+    }
+    ReadinessProbe::buckets_t since;
+    for (size_t i = 0; i < current.size(); ++i) {
+        // version loaded again since previous check starts with fresh counters
+        if (current[i] < (*previous)[i]) {
+            return current;
+        }
+        since[i] = current[i] - (*previous)[i];
+    }
+    return since;
+}
+}  // namespace
+
+uint64_t ReadinessProbe::estimatePercentile99(const buckets_t& buckets) {
+    uint64_t total = 0;
+    for (const auto count : buckets) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const uint64_t rank = total - total / 100;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < LatencyHistogram::BUCKETS_COUNT; ++i) {
+        cumulative += buckets[i];
+        if (cumulative >= rank) {
+            return LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[i];
+        }
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
+
+Status ReadinessProbe::check(ModelManager& manager) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::map<std::pair<std::string, model_version_t>, buckets_t> currentStreamWaitBuckets;
+    std::string reasons;
+    auto addReason = [&reasons](const std::string& reason) {
+        reasons += reasons.empty() ? reason : "; " + reason;
+    };
+    if (!manager.areCriticalModelsLoaded()) {
+        addReason("models critical for readiness are being loaded");
+    }
+    const auto startupStatus = manager.getStartupStatus();
+    if (!startupStatus.ok()) {
+        addReason("loading models at startup failed: " + startupStatus.string());
+    }
+    for (const auto& [name, model] : *manager.getModelsSnapshot()) {
+        bool critical = false;
+        bool available = false;
+        for (const auto& [version, instanceRef] : model->getModelVersionsMapCopy()) {
+            auto instance = manager.findModelInstance(name, version);
+            if (!instance) {
+                continue;
+            }
+            // Streams pool exists only while model version is loaded, guard holds off unloading while it is read
+            ModelInstanceUnloadGuard unloadGuard(*instance);
+            const auto& config = instance->getModelConfig();
+            if (!config.isReadinessCritical()) {
+                continue;
+            }
+            critical = true;
+            // lazily loaded or evicted version is loaded by the first request, which would never come while not ready
+            if (instance->isEvicted()) {
+                available = true;
+                continue;
+            }
+            if (instance->getStatus().getState() != ModelVersionState::AVAILABLE) {
+                continue;
+            }
+            available = true;
+            const std::string versionName = "model " + name + " version " + std::to_string(version);
+            const auto waiting = instance->getInferRequestsQueue().getWaitersCount();
+            if (config.getReadinessMaxWaitingRequests() > 0 && waiting > config.getReadinessMaxWaitingRequests()) {
+                addReason(versionName + " has " + std::to_string(waiting) + " requests waiting for infer request");
+            }
+            const auto key = std::make_pair(name, version);
+            const auto current = getBucketsCounts(instance->getMetrics().streamWait);
+            auto previous = previousStreamWaitBuckets.find(key);
+            const auto percentile = estimatePercentile99(getBucketsSince(current,
+                previous != previousStreamWaitBuckets.end() ? &previous->second : nullptr));
+            currentStreamWaitBuckets.emplace(key, current);
+            if (config.getReadinessMaxQueueWaitMs() > 0 && percentile > config.getReadinessMaxQueueWaitMs() * 1000) {
+                addReason(versionName + " 99th percentile of wait for infer request exceeds " + std::to_string(config.getReadinessMaxQueueWaitMs()) + " ms");
+            }
+        }
+        if (critical && !available) {
+            addReason("model " + name + " has no available version");
+        }
+    }
+    previousStreamWaitBuckets = std::move(currentStreamWaitBuckets);
+
+    const bool wasReady = ready;
+    ready = reasons.empty();
+    if (!ready) {
+        if (wasReady) {
+            SPDLOG_WARN("Server is not ready to receive requests: {}", reasons);
+        }
+        return Status(StatusCode::SERVER_NOT_READY, reasons);
+    }
+    if (!wasReady) {
+        SPDLOG_INFO("Server is ready to receive requests again");
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
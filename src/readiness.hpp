@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "metrics.hpp"
+#include "model_version_policy.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+class ModelManager;
+
+/**
+ * @brief Decides whether server should receive traffic, based on infer requests queue pressure of critical models
+ *
+ * Model is critical when readiness thresholds are set in its configuration. Server is not ready when any AVAILABLE version
+ * of critical model has more requests waiting for infer request than allowed, when 99th percentile of wait for infer request
+ * exceeds the limit, when critical model has no AVAILABLE version while critical models are loaded at startup or once their loading at startup failed. Percentile is estimated with upper bounds of stream wait
+ * histogram buckets from observations made since previous check, so that it reflects current load and not whole lifetime
+ * of model version.
+ */
+class ReadinessProbe {
+public:
+    using buckets_t = std::array<uint64_t, LatencyHistogram::BUCKETS_COUNT + 1>;
+
+    /**
+     * @brief Checks readiness of served models
+     *
+     * @param manager
+     *
+     * @return OK if ready, SERVER_NOT_READY with reasons otherwise
+     */
+    Status check(ModelManager& manager);
+
+    /**
+     * @brief Estimates 99th percentile in microseconds from histogram buckets counts
+     *
+     * @return upper bound of bucket containing percentile, 0 without observations, UINT64_MAX if it is in +Inf bucket
+     */
+    static uint64_t estimatePercentile99(const buckets_t& buckets);
+
+private:
+    std::mutex mtx;
+
+    /**
+     * @brief Stream wait histogram buckets counts of model versions at previous check
+     */
+    std::map<std::pair<std::string, model_version_t>, buckets_t> previousStreamWaitBuckets;
+
+    bool ready = true;
+};
+
+}  // namespace ovms
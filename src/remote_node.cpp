@@ -0,0 +1,203 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "remote_node.hpp"
+
+#include <cstring>
+#include <set>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "precisionconversion.hpp"
+#include "remoteinferenceclient.hpp"
+#include "tensorbufferpool.hpp"
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+namespace {
+/**
+ * @brief Output blob pointing into response memory, keeps the response until the blob is released
+ */
+struct ResponseBackedBlob {
+    std::shared_ptr<const tensorflow::serving::PredictResponse> response;
+    InferenceEngine::Blob::Ptr blob;
+};
+
+Status serializeInput(const InferenceEngine::Blob::Ptr& blob, tensorflow::TensorProto& proto) {
+    const auto& desc = blob->getTensorDesc();
+    const auto& conversion = getPrecisionConversion(desc.getPrecision());
+    for (size_t dim : desc.getDims()) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    proto.set_dtype(conversion.dtype);
+    // Values are written to the field remote server deserializes them from
+    switch (conversion.requestField) {
+    case TensorProtoField::TENSOR_CONTENT:
+        proto.mutable_tensor_content()->assign(blob->cbuffer().as<const char*>(), blob->byteSize());
+        return StatusCode::OK;
+    case TensorProtoField::HALF_VAL: {
+        const auto* values = blob->cbuffer().as<const uint16_t*>();
+        proto.mutable_half_val()->Reserve(blob->size());
+        for (size_t i = 0; i < blob->size(); i++) {
+            proto.add_half_val(values[i]);
+        }
+        return StatusCode::OK;
+    }
+    case TensorProtoField::INT_VAL: {
+        const auto* values = blob->cbuffer().as<const uint16_t*>();
+        proto.mutable_int_val()->Reserve(blob->size());
+        for (size_t i = 0; i < blob->size(); i++) {
+            proto.add_int_val(values[i]);
+        }
+        return StatusCode::OK;
+    }
+    case TensorProtoField::NONE:
+    default:
+        break;
+    }
+    const std::string details = "Actual: " + TensorInfo::getPrecisionAsString(desc.getPrecision());
+    SPDLOG_DEBUG("Unsupported remote node input precision - {}", details);
+    return Status(StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION, details);
+}
+}  // namespace
+
+Status RemoteNode::prepareRequest(tensorflow::serving::PredictRequest& request) const {
+    request.mutable_model_spec()->set_name(this->modelName);
+    if (this->modelVersion) {
+        request.mutable_model_spec()->mutable_version()->set_value(this->modelVersion.value());
+    }
+    for (const auto& [name, blob] : this->inputBlobs) {
+        auto status = serializeInput(blob, (*request.mutable_inputs())[name]);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    // Remote server sends only outputs used by following nodes
+    std::set<std::string> outputs;
+    for (const auto& node : this->next) {
+        for (const auto& [alias, inputName] : node.get().getMappingByDependency(*this)) {
+            if (node.get().isInputRequired(inputName)) {
+                outputs.insert(this->nodeOutputNameAlias.count(alias) == 1 ? this->nodeOutputNameAlias.at(alias) : alias);
+            }
+        }
+    }
+    for (const auto& output : outputs) {
+        request.add_output_filter(output);
+    }
+    return StatusCode::OK;
+}
+
+Status RemoteNode::execute(NodeNotificationQueue& notifyEndQueue) {
+    this->request.Clear();
+    this->inferenceStatus = prepareRequest(this->request);
+    // Blobs can be owned by inference requests of previous nodes, release them once copied into request
+    this->inputBlobs.clear();
+    if (!this->inferenceStatus.ok()) {
+        notifyEndQueue.push(*this);
+        return this->inferenceStatus;
+    }
+    SPDLOG_DEBUG("[Node: {}] Sending inference request of model: {} to remote server: {}", getName(), this->modelName, this->parameters.address);
+    this->response = std::make_shared<tensorflow::serving::PredictResponse>();
+    RemoteInferenceClient::getInstance().predict(this->parameters.address, this->request, *this->response, getTimeout(),
+        [this, &notifyEndQueue](const grpc::Status& status) {
+            if (!status.ok()) {
+                this->inferenceStatus = Status(StatusCode::REMOTE_INFERENCE_FAILED, this->parameters.address + ": " + status.error_message());
+            }
+            // node may be released by pipeline right after notification
+            notifyEndQueue.push(*this);
+        });
+    return StatusCode::OK;
+}
+
+Status RemoteNode::fetchResults(BlobMap& outputs) {
+    if (!this->inferenceStatus.ok()) {
+        SPDLOG_DEBUG("[Node: {}] Remote inference failed: {}", getName(), this->inferenceStatus.string());
+        this->release();
+        return this->inferenceStatus;
+    }
+    std::shared_ptr<const tensorflow::serving::PredictResponse> response = std::move(this->response);
+    for (const auto& node : this->next) {
+        for (const auto& pair : node.get().getMappingByDependency(*this)) {
+            const auto& outputName = pair.first;
+            if (outputs.count(outputName) == 1) {
+                continue;
+            }
+            if (!node.get().isInputRequired(pair.second)) {
+                continue;
+            }
+            const auto& modelOutputName = this->nodeOutputNameAlias.count(outputName) == 1 ? this->nodeOutputNameAlias.at(outputName) : outputName;
+            auto protoItr = response->outputs().find(modelOutputName);
+            if (protoItr == response->outputs().end()) {
+                SPDLOG_WARN("[Node: {}] Remote server did not send model output for alias {}", getName(), outputName);
+                this->release();
+                return StatusCode::INVALID_MISSING_OUTPUT;
+            }
+            InferenceEngine::Blob::Ptr blob;
+            auto status = deserializeOutput(response, protoItr->second, blob);
+            if (!status.ok()) {
+                SPDLOG_DEBUG("[Node: {}] Deserialization of remote model output {} failed: {}", getName(), modelOutputName, status.string());
+                this->release();
+                return status;
+            }
+            outputs.emplace(outputName, std::move(blob));
+        }
+    }
+    this->release();
+    return StatusCode::OK;
+}
+
+Status RemoteNode::deserializeOutput(const std::shared_ptr<const tensorflow::serving::PredictResponse>& response,
+    const tensorflow::TensorProto& proto, InferenceEngine::Blob::Ptr& blob) {
+    const auto& conversion = getDataTypeConversion(proto.dtype());
+    if (conversion.precision == InferenceEngine::Precision::UNSPECIFIED) {
+        return StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+    }
+    InferenceEngine::SizeVector dims;
+    size_t count = 1;
+    for (const auto& dim : proto.tensor_shape().dim()) {
+        if (dim.size() < 0) {
+            return StatusCode::INVALID_SHAPE;
+        }
+        dims.push_back(dim.size());
+        count *= dim.size();
+    }
+    const InferenceEngine::TensorDesc desc(conversion.precision, dims, InferenceEngine::TensorDesc::getLayoutByDims(dims));
+    const size_t byteSize = count * InferenceEngine::Precision(conversion.precision).size();
+    if (conversion.requestField == TensorProtoField::TENSOR_CONTENT) {
+        if (proto.tensor_content().size() != byteSize) {
+            return StatusCode::INVALID_CONTENT_SIZE;
+        }
+        // aliasing pointer - blob memory stays valid as long as response is kept
+        auto owner = std::make_shared<ResponseBackedBlob>(ResponseBackedBlob{response, conversion.wrapContent(proto, desc)});
+        blob = InferenceEngine::Blob::Ptr(owner, owner->blob.get());
+        return StatusCode::OK;
+    }
+    // Outputs of precisions without request field in tensor_content, or values sent zero padded
+    blob = createPooledBlob(desc);
+    if (proto.tensor_content().size() == byteSize) {
+        std::memcpy(blob->buffer().as<char*>(), proto.tensor_content().data(), byteSize);
+        return StatusCode::OK;
+    }
+    if (conversion.countValues != nullptr && conversion.countValues(proto) == count) {
+        conversion.copyValues(proto, blob->buffer().as<void*>());
+        return StatusCode::OK;
+    }
+    blob.reset();
+    return StatusCode::INVALID_CONTENT_SIZE;
+}
+
+}  // namespace ovms
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "model_version_policy.hpp"  // for model_version_t typename
+#include "node.hpp"
+
+namespace ovms {
+
+struct RemoteParameters {
+    // Address of server serving the model, host:port
+    std::string address;
+};
+
+/**
+ * @brief Runs inference of model served by other server instance, so that pipeline stages can be spread across hosts
+ *
+ * Inputs are sent in tensor_content of predict request and outputs are passed to following nodes as blobs
+ * pointing into tensor_content of the response, which is kept until the last of them is released.
+ */
+class RemoteNode : public Node {
+    const std::string modelName;
+    const std::optional<model_version_t> modelVersion;
+    const RemoteParameters parameters;
+    const std::unordered_map<std::string, std::string> nodeOutputNameAlias;
+
+    tensorflow::serving::PredictRequest request;
+    std::shared_ptr<tensorflow::serving::PredictResponse> response;
+    Status inferenceStatus;
+
+public:
+    RemoteNode(const std::string& nodeName, const std::string& modelName, std::optional<model_version_t> modelVersion,
+        const RemoteParameters& parameters,
+        std::unordered_map<std::string, std::string> nodeOutputNameAlias = {}) :
+        Node(nodeName),
+        modelName(modelName),
+        modelVersion(modelVersion),
+        parameters(parameters),
+        nodeOutputNameAlias(nodeOutputNameAlias) {}
+
+    Status execute(NodeNotificationQueue& notifyEndQueue) override;
+
+    Status fetchResults(BlobMap& outputs) override;
+
+    void release() override {
+        this->request.Clear();
+        this->response.reset();
+    }
+
+    void reset() override {
+        release();
+        Node::reset();
+    }
+
+    /**
+     * @brief Fills predict request with input blobs of the node
+     */
+    Status prepareRequest(tensorflow::serving::PredictRequest& request) const;
+
+    /**
+     * @brief Creates blob pointing into tensor_content of response output, or copy of values sent in other fields
+     */
+    static Status deserializeOutput(const std::shared_ptr<const tensorflow::serving::PredictResponse>& response,
+        const tensorflow::TensorProto& proto, InferenceEngine::Blob::Ptr& blob);
+};
+
+}  // namespace ovms
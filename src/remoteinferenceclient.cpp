@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "remoteinferenceclient.hpp"
+
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+RemoteInferenceClient::RemoteInferenceClient() :
+    thread([this]() { run(); }) {}
+
+RemoteInferenceClient::~RemoteInferenceClient() {
+    completionQueue.Shutdown();
+    thread.join();
+}
+
+RemoteInferenceClient& RemoteInferenceClient::getInstance() {
+    static RemoteInferenceClient instance;
+    return instance;
+}
+
+tensorflow::serving::PredictionService::Stub& RemoteInferenceClient::getStub(const std::string& address) {
+    std::unique_lock lock(mtx);
+    auto& pool = connections[address];
+    if (!pool) {
+        SPDLOG_INFO("Opening {} connections to remote server: {}", CONNECTIONS_PER_ADDRESS, address);
+        pool = std::make_unique<Connections>();
+        for (size_t i = 0; i < CONNECTIONS_PER_ADDRESS; i++) {
+            grpc::ChannelArguments arguments;
+            arguments.SetMaxReceiveMessageSize(-1);
+            arguments.SetMaxSendMessageSize(-1);
+            // channels with global subchannel pool would share a single connection
+            arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+            auto channel = grpc::CreateCustomChannel(address, grpc::InsecureChannelCredentials(), arguments);
+            pool->stubs.emplace_back(tensorflow::serving::PredictionService::NewStub(channel));
+        }
+    }
+    lock.unlock();
+    return *pool->stubs[pool->next.fetch_add(1, std::memory_order_relaxed) % pool->stubs.size()];
+}
+
+void RemoteInferenceClient::predict(const std::string& address,
+    const tensorflow::serving::PredictRequest& request,
+    tensorflow::serving::PredictResponse& response,
+    std::chrono::microseconds timeout,
+    Callback callback) {
+    auto call = new Call;
+    call->callback = std::move(callback);
+    if (timeout.count() > 0) {
+        call->context.set_deadline(std::chrono::system_clock::now() + timeout);
+    }
+    call->reader = getStub(address).PrepareAsyncPredict(&call->context, request, &completionQueue);
+    call->reader->StartCall();
+    call->reader->Finish(&response, &call->status, call);
+}
+
+void RemoteInferenceClient::run() {
+    void* tag = nullptr;
+    bool ok = false;
+    while (completionQueue.Next(&tag, &ok)) {
+        std::unique_ptr<Call> call(static_cast<Call*>(tag));
+        call->callback(call->status);
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,94 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+namespace ovms {
+
+/**
+ * @brief Sends predict requests of remote pipeline nodes to other servers
+ *
+ * Each server address gets a fixed pool of channels, each with its own connection, requests are spread over them round robin.
+ * Calls are asynchronous, so that any number of requests is in flight on a connection at once without blocking pipeline threads.
+ * Completions are delivered on a single thread, so callbacks should only record the result and hand over the work.
+ */
+class RemoteInferenceClient {
+public:
+    static constexpr size_t CONNECTIONS_PER_ADDRESS = 4;
+
+    using Callback = std::function<void(const grpc::Status&)>;
+
+private:
+    struct Connections {
+        std::vector<std::unique_ptr<tensorflow::serving::PredictionService::Stub>> stubs;
+        std::atomic<size_t> next{0};
+    };
+
+    struct Call {
+        grpc::ClientContext context;
+        grpc::Status status;
+        std::unique_ptr<grpc::ClientAsyncResponseReader<tensorflow::serving::PredictResponse>> reader;
+        Callback callback;
+    };
+
+    std::mutex mtx;
+    std::unordered_map<std::string, std::unique_ptr<Connections>> connections;
+    grpc::CompletionQueue completionQueue;
+    std::thread thread;
+
+    tensorflow::serving::PredictionService::Stub& getStub(const std::string& address);
+    void run();
+
+public:
+    RemoteInferenceClient();
+    ~RemoteInferenceClient();
+
+    RemoteInferenceClient(const RemoteInferenceClient&) = delete;
+    RemoteInferenceClient& operator=(const RemoteInferenceClient&) = delete;
+
+    static RemoteInferenceClient& getInstance();
+
+    /**
+     * @brief Starts predict call, request and response have to stay valid until callback is called
+     *
+     * @param address host:port of the server
+     * @param timeout deadline of the call, 0 if not limited
+     * @param callback called on completion thread once response is received or call failed
+     */
+    void predict(const std::string& address,
+        const tensorflow::serving::PredictRequest& request,
+        tensorflow::serving::PredictResponse& response,
+        std::chrono::microseconds timeout,
+        Callback callback);
+};
+
+}  // namespace ovms
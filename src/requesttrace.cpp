@@ -0,0 +1,140 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "requesttrace.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#include "logging.hpp"
+
+namespace ovms {
+
+namespace {
+bool isLowercaseHex(std::string_view value) {
+    return std::all_of(value.begin(), value.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+bool isAllZeros(std::string_view value) {
+    return std::all_of(value.begin(), value.end(), [](char c) { return c == '0'; });
+}
+
+bool isTokenCharacter(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || std::string_view("!#$%&'*+-.^_`|~").find(c) != std::string_view::npos;
+}
+
+// metric name has to be a token, span name with spaces is kept in quoted description
+void serializeServerTimingMetric(std::ostream& out, const std::string& name, std::chrono::steady_clock::duration duration) {
+    for (char c : name) {
+        out << (isTokenCharacter(c) ? c : '_');
+    }
+    out << ";desc=\"";
+    for (char c : name) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        // metadata values have to be printable ASCII
+        if (c >= 0x20 && c < 0x7f) {
+            out << c;
+        }
+    }
+    out << "\";dur=" << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(duration).count();
+}
+}  // namespace
+
+std::unique_ptr<RequestTrace> RequestTrace::fromTraceparent(std::string_view traceparent) {
+    // version-traceid-parentid-flags, later versions may append fields after flags
+    const size_t versionSize = 2, traceIdSize = 32, parentIdSize = 16, flagsSize = 2;
+    const size_t size = versionSize + traceIdSize + parentIdSize + flagsSize + 3;
+    if (traceparent.size() < size || (traceparent.size() > size && traceparent[size] != '-')) {
+        return nullptr;
+    }
+    const auto version = traceparent.substr(0, versionSize);
+    const auto traceId = traceparent.substr(versionSize + 1, traceIdSize);
+    const auto parentId = traceparent.substr(versionSize + traceIdSize + 2, parentIdSize);
+    const auto flags = traceparent.substr(versionSize + traceIdSize + parentIdSize + 3, flagsSize);
+    if (traceparent[versionSize] != '-' || traceparent[versionSize + traceIdSize + 1] != '-' ||
+        traceparent[versionSize + traceIdSize + parentIdSize + 2] != '-') {
+        return nullptr;
+    }
+    if (!isLowercaseHex(version) || version == "ff" || (version == "00" && traceparent.size() != size) ||
+        !isLowercaseHex(traceId) || isAllZeros(traceId) ||
+        !isLowercaseHex(parentId) || isAllZeros(parentId) ||
+        !isLowercaseHex(flags)) {
+        return nullptr;
+    }
+    const bool sampled = std::stoi(std::string(flags), nullptr, 16) & 0x01;
+    if (!sampled) {
+        return nullptr;
+    }
+    return std::make_unique<RequestTrace>(std::string(traceId), std::string(parentId));
+}
+
+std::unique_ptr<RequestTrace> RequestTrace::create(std::string_view traceparent, bool serverTimingRequested) {
+    std::unique_ptr<RequestTrace> trace;
+    if (!traceparent.empty()) {
+        trace = fromTraceparent(traceparent);
+        if (!trace) {
+            SPDLOG_DEBUG("Ignored invalid or not sampled {} value: {}", TRACEPARENT_HEADER, traceparent);
+        }
+    }
+    if (serverTimingRequested) {
+        if (!trace) {
+            trace = std::make_unique<RequestTrace>("", "");
+        }
+        trace->serverTimingRequested = true;
+    }
+    return trace;
+}
+
+void RequestTrace::addSpan(std::string name, std::chrono::steady_clock::time_point spanStart, std::chrono::steady_clock::time_point spanEnd) {
+    std::lock_guard<std::mutex> lock(mtx);
+    spans.push_back({std::move(name), spanStart, spanEnd});
+}
+
+std::vector<TraceSpan> RequestTrace::getSpans() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return spans;
+}
+
+void RequestTrace::exportSpans() const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    std::stringstream ss;
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& span : spans) {
+        ss << " [" << span.name
+           << " start_us:" << duration_cast<microseconds>(span.start - start).count()
+           << " duration_us:" << duration_cast<microseconds>(span.end - span.start).count() << "]";
+    }
+    const auto duration = duration_cast<microseconds>(std::chrono::steady_clock::now() - start).count();
+    SPDLOG_LOGGER_INFO(tracing_logger, "trace_id:{} parent_id:{} duration_us:{} spans:{}", traceId, parentId, duration, ss.str());
+}
+
+std::string RequestTrace::serializeServerTiming() const {
+    std::stringstream ss;
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& span : spans) {
+        serializeServerTimingMetric(ss, span.name, span.end - span.start);
+        ss << ", ";
+    }
+    serializeServerTimingMetric(ss, "total", std::chrono::steady_clock::now() - start);
+    return ss.str();
+}
+
+}  // namespace ovms
@@ -0,0 +1,110 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief Name of gRPC metadata entry and HTTP header with W3C trace context of the request
+ */
+const std::string TRACEPARENT_HEADER = "traceparent";
+
+/**
+ * @brief Name of gRPC metadata entry and HTTP header requesting timing of the request processing phases in response
+ */
+const std::string SERVER_TIMING_REQUEST_HEADER = "ovms-server-timing";
+
+/**
+ * @brief Name of gRPC trailing metadata entry and HTTP response header with timing of the request in W3C Server-Timing format
+ */
+const std::string SERVER_TIMING_HEADER = "server-timing";
+
+struct TraceSpan {
+    std::string name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+};
+
+/**
+ * @brief Spans recorded while processing single request which came with sampled W3C trace context or requested server timing
+ *
+ * Spans may be added from any thread processing the request. Spans of sampled requests are exported together once
+ * the request is finished, as single message of tracing logger which is written by logging thread. Spans of requests
+ * which requested server timing are returned to the client with the response.
+ */
+class RequestTrace {
+    const std::string traceId;
+    const std::string parentId;
+    const std::chrono::steady_clock::time_point start;
+    bool serverTimingRequested = false;
+
+    mutable std::mutex mtx;
+    std::vector<TraceSpan> spans;
+
+public:
+    RequestTrace(const std::string& traceId, const std::string& parentId) :
+        traceId(traceId),
+        parentId(parentId),
+        start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Creates trace of the request from value of traceparent header
+     *
+     * @return trace or nullptr if header is malformed or caller did not sample the request
+     */
+    static std::unique_ptr<RequestTrace> fromTraceparent(std::string_view traceparent);
+
+    /**
+     * @brief Creates trace of the request from values of traceparent and server timing request headers
+     *
+     * @param traceparent value of traceparent header, empty if missing
+     * @param serverTimingRequested whether server timing request header is present
+     * @return trace or nullptr if request is neither sampled nor requested server timing
+     */
+    static std::unique_ptr<RequestTrace> create(std::string_view traceparent, bool serverTimingRequested);
+
+    const std::string& getTraceId() const { return traceId; }
+    const std::string& getParentId() const { return parentId; }
+
+    /**
+     * @brief Checks whether request came with sampled trace context and spans have to be exported
+     */
+    bool isSampled() const { return !traceId.empty(); }
+    bool isServerTimingRequested() const { return serverTimingRequested; }
+
+    void addSpan(std::string name, std::chrono::steady_clock::time_point spanStart, std::chrono::steady_clock::time_point spanEnd);
+
+    std::vector<TraceSpan> getSpans() const;
+
+    /**
+     * @brief Exports time since trace was created and spans with their start offset relative to it
+     */
+    void exportSpans() const;
+
+    /**
+     * @brief Serializes spans and time since trace was created as value of Server-Timing header, durations are in milliseconds
+     */
+    std::string serializeServerTiming() const;
+};
+
+}  // namespace ovms
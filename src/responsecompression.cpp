@@ -0,0 +1,93 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "responsecompression.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+#include "stringutils.hpp"
+
+namespace ovms {
+
+namespace {
+// Window bits above 15 make zlib write gzip header and trailer instead of zlib ones
+const int GZIP_WINDOW_BITS = 15 + 16;
+const int GZIP_MEMORY_LEVEL = 8;
+
+// Speed matters more than ratio since compression is done on request latency path
+const int GZIP_COMPRESSION_LEVEL = 1;
+
+double getQuality(const std::string& parameters) {
+    for (auto parameter : tokenize(parameters, ';')) {
+        erase_spaces(parameter);
+        if (parameter.rfind("q=", 0) == 0) {
+            try {
+                return std::stod(parameter.substr(2));
+            } catch (const std::exception&) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+}  // namespace
+
+bool acceptsGzipEncoding(const std::string& acceptEncoding) {
+    bool wildcardAccepted = false;
+    for (auto coding : tokenize(acceptEncoding, ',')) {
+        const auto parametersBegin = coding.find(';');
+        const std::string parameters = parametersBegin == std::string::npos ? "" : coding.substr(parametersBegin + 1);
+        std::string name = coding.substr(0, parametersBegin);
+        erase_spaces(name);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (name == "gzip" || name == "x-gzip") {
+            return getQuality(parameters) > 0;
+        }
+        if (name == "*") {
+            wildcardAccepted = getQuality(parameters) > 0;
+        }
+    }
+    return wildcardAccepted;
+}
+
+bool compressGzip(const std::string& input, std::string& output) {
+    z_stream stream{};
+    if (deflateInit2(&stream, GZIP_COMPRESSION_LEVEL, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        SPDLOG_DEBUG("Failed to initialize gzip compression");
+        return false;
+    }
+    output.resize(deflateBound(&stream, input.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = output.size();
+    const int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        SPDLOG_DEBUG("Failed to compress {} bytes with gzip, error: {}", input.size(), result);
+        output.clear();
+        return false;
+    }
+    output.resize(stream.total_out);
+    return true;
+}
+
+}  // namespace ovms
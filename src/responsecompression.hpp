@@ -0,0 +1,37 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief Checks whether Accept-Encoding header value allows gzip content coding, either by name or by wildcard with non zero quality
+ */
+bool acceptsGzipEncoding(const std::string& acceptEncoding);
+
+/**
+ * @brief Compresses data to gzip format
+ *
+ * @param input data to compress
+ * @param output destination for compressed data
+ *
+ * @return false if compression failed, output is then cleared
+ */
+bool compressGzip(const std::string& input, std::string& output);
+
+}  // namespace ovms
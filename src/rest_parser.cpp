@@ -15,17 +15,33 @@
 //*****************************************************************************
 #include "rest_parser.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <functional>
+#include <map>
+#include <set>
 #include <string>
+#include <vector>
+
+#include "workstealingexecutor.hpp"
 
 namespace ovms {
 
+RestParser::RestParser(const RestParser& other) :
+    order(other.order),
+    format(other.format),
+    tensorPrecisionMap(other.tensorPrecisionMap),
+    documentLength(other.documentLength) {
+    requestProto->CopyFrom(*other.requestProto);
+}
+
 RestParser::RestParser(const tensor_map_t& tensors) {
     for (const auto& kv : tensors) {
         const auto& name = kv.first;
         const auto& tensor = kv.second;
         tensorPrecisionMap[name] = tensor->getPrecision();
-        auto& input = (*requestProto.mutable_inputs())[name];
+        auto& input = (*requestProto->mutable_inputs())[name];
         input.set_dtype(tensor->getPrecisionAsDataType());
         input.mutable_tensor_content()->reserve(std::accumulate(
                                                     tensor->getShape().begin(),
@@ -37,7 +53,7 @@ RestParser::RestParser(const tensor_map_t& tensors) {
 }
 
 void RestParser::removeUnusedInputs() {
-    auto& inputs = (*requestProto.mutable_inputs());
+    auto& inputs = (*requestProto->mutable_inputs());
     auto it = inputs.begin();
     while (it != inputs.end()) {
         if (!it->second.tensor_shape().dim_size()) {
@@ -69,12 +85,7 @@ bool RestParser::parseArray(rapidjson::Value& doc, int dim, tensorflow::TensorPr
     } else {
         if (!setPrecisionIfNotSet(doc.GetArray()[0], proto, tensorName))
             return false;
-        for (auto& value : doc.GetArray()) {
-            if (!addValue(proto, value)) {
-                return false;
-            }
-        }
-        return true;
+        return addValues(proto, static_cast<const rapidjson::Value&>(doc).GetArray());
     }
     return false;
 }
@@ -85,7 +96,7 @@ bool RestParser::parseInstance(rapidjson::Value& doc) {
     }
     for (auto& itr : doc.GetObject()) {
         std::string tensorName = itr.name.GetString();
-        auto& proto = (*requestProto.mutable_inputs())[tensorName];
+        auto& proto = (*requestProto->mutable_inputs())[tensorName];
         increaseBatchSize(proto);
         if (!parseArray(itr.value, 1, proto, tensorName)) {
             return false;
@@ -96,7 +107,7 @@ bool RestParser::parseInstance(rapidjson::Value& doc) {
 
 bool RestParser::isBatchSizeEqualForAllInputs() const {
     int64_t size = 0;
-    for (const auto& kv : requestProto.inputs()) {
+    for (const auto& kv : requestProto->inputs()) {
         if (size == 0) {
             size = kv.second.tensor_shape().dim(0).size();
         } else if (kv.second.tensor_shape().dim(0).size() != size) {
@@ -116,21 +127,25 @@ Status RestParser::parseRowFormat(rapidjson::Value& node) {
     }
     if (node.GetArray()[0].IsObject()) {
         // named format
-        for (auto& instance : node.GetArray()) {
-            if (!instance.IsObject()) {
+        auto instances = node.GetArray();
+        for (size_t i = 0; i < instances.Size(); i++) {
+            if (!instances[i].IsObject()) {
                 return StatusCode::REST_NAMED_INSTANCE_NOT_AN_OBJECT;
             }
-            if (!this->parseInstance(instance)) {
+            if (!this->parseInstance(instances[i])) {
                 return StatusCode::REST_COULD_NOT_PARSE_INSTANCE;
             }
+            if (i == 0 && parseRemainingInstancesInParallel(node)) {
+                break;
+            }
         }
     } else if (node.GetArray()[0].IsArray() || node.GetArray()[0].IsNumber()) {
         // no named format
-        if (requestProto.inputs_size() != 1) {
+        if (requestProto->inputs_size() != 1) {
             return StatusCode::REST_INPUT_NOT_PREALLOCATED;
         }
-        auto inputsIterator = requestProto.mutable_inputs()->begin();
-        if (inputsIterator == requestProto.mutable_inputs()->end()) {
+        auto inputsIterator = requestProto->mutable_inputs()->begin();
+        if (inputsIterator == requestProto->mutable_inputs()->end()) {
             const std::string details = "Failed to parse row formatted request.";
             SPDLOG_ERROR("Internal error occured: {}", details);
             return Status(StatusCode::INTERNAL_ERROR, details);
@@ -156,11 +171,11 @@ Status RestParser::parseColumnFormat(rapidjson::Value& node) {
     order = Order::COLUMN;
     // no named format
     if (node.IsArray()) {
-        if (requestProto.inputs_size() != 1) {
+        if (requestProto->inputs_size() != 1) {
             return StatusCode::REST_INPUT_NOT_PREALLOCATED;
         }
-        auto inputsIterator = requestProto.mutable_inputs()->begin();
-        if (inputsIterator == requestProto.mutable_inputs()->end()) {
+        auto inputsIterator = requestProto->mutable_inputs()->begin();
+        if (inputsIterator == requestProto->mutable_inputs()->end()) {
             const std::string details = "Failed to parse column formatted request.";
             SPDLOG_ERROR("Internal error occured: {}", details);
             return Status(StatusCode::INTERNAL_ERROR, details);
@@ -180,7 +195,7 @@ Status RestParser::parseColumnFormat(rapidjson::Value& node) {
     }
     for (auto& kv : node.GetObject()) {
         std::string tensorName = kv.name.GetString();
-        auto& proto = (*requestProto.mutable_inputs())[tensorName];
+        auto& proto = (*requestProto->mutable_inputs())[tensorName];
         if (!parseArray(kv.value, 0, proto, tensorName)) {
             return StatusCode::REST_COULD_NOT_PARSE_INPUT;
         }
@@ -190,11 +205,69 @@ Status RestParser::parseColumnFormat(rapidjson::Value& node) {
     return StatusCode::OK;
 }
 
+namespace {
+const size_t INITIAL_DOCUMENT_BUFFER_SIZE = 64 * 1024;
+const size_t MAX_DOCUMENT_BUFFER_SIZE = 16 * 1024 * 1024;
+
+/**
+ * @brief Allocates DOM nodes of request document from per thread buffer reused between requests
+ *
+ * Buffer grows to capacity required by the largest document seen so far, up to the limit,
+ * so that documents of similar size do not allocate memory pool chunks one by one.
+ */
+class ReusedDocumentAllocator {
+    struct Buffer {
+        std::vector<char> data;
+        size_t requiredSize = INITIAL_DOCUMENT_BUFFER_SIZE;
+    };
+
+    static Buffer& getBuffer() {
+        thread_local Buffer buffer;
+        if (buffer.data.size() < buffer.requiredSize) {
+            buffer.data.resize(buffer.requiredSize);
+        }
+        return buffer;
+    }
+
+    Buffer& buffer;
+    rapidjson::MemoryPoolAllocator<> allocator;
+
+public:
+    ReusedDocumentAllocator() :
+        buffer(getBuffer()),
+        allocator(buffer.data.data(), buffer.data.size()) {}
+
+    ~ReusedDocumentAllocator() {
+        buffer.requiredSize = std::max(buffer.requiredSize, std::min(allocator.Capacity(), MAX_DOCUMENT_BUFFER_SIZE));
+    }
+
+    rapidjson::MemoryPoolAllocator<>* get() {
+        return &allocator;
+    }
+};
+}  // namespace
+
 Status RestParser::parse(const char* json) {
-    rapidjson::Document doc;
+    ReusedDocumentAllocator allocator;
+    rapidjson::Document doc(allocator.get());
+    documentLength = std::strlen(json);
     if (doc.Parse(json).HasParseError()) {
         return StatusCode::JSON_INVALID;
     }
+    return parseDocument(doc);
+}
+
+Status RestParser::parseInsitu(char* json) {
+    ReusedDocumentAllocator allocator;
+    rapidjson::Document doc(allocator.get());
+    documentLength = std::strlen(json);
+    if (doc.ParseInsitu(json).HasParseError()) {
+        return StatusCode::JSON_INVALID;
+    }
+    return parseDocument(doc);
+}
+
+Status RestParser::parseDocument(rapidjson::Document& doc) {
     if (!doc.IsObject()) {
         return StatusCode::REST_BODY_IS_NOT_AN_OBJECT;
     }
@@ -212,6 +285,110 @@ Status RestParser::parse(const char* json) {
     return StatusCode::REST_PREDICT_UNKNOWN_ORDER;
 }
 
+namespace {
+bool getBinaryDataType(const std::string& datatype, tensorflow::DataType& dtype) {
+    static const std::map<std::string, tensorflow::DataType> dataTypes = {
+        {"FP32", tensorflow::DataType::DT_FLOAT},
+        {"FP16", tensorflow::DataType::DT_HALF},
+        {"I8", tensorflow::DataType::DT_INT8},
+        {"U8", tensorflow::DataType::DT_UINT8},
+        {"I16", tensorflow::DataType::DT_INT16},
+        {"U16", tensorflow::DataType::DT_UINT16},
+        {"I32", tensorflow::DataType::DT_INT32},
+        {"I64", tensorflow::DataType::DT_INT64},
+    };
+    auto it = dataTypes.find(datatype);
+    if (it == dataTypes.end()) {
+        return false;
+    }
+    dtype = it->second;
+    return true;
+}
+}  // namespace
+
+Status RestParser::parseBinary(const char* body, size_t size, size_t headerSize) {
+    order = Order::COLUMN;
+    if (headerSize > size) {
+        return StatusCode::REST_BINARY_HEADER_INVALID;
+    }
+    rapidjson::Document doc;
+    if (doc.Parse(body, headerSize).HasParseError()) {
+        return StatusCode::JSON_INVALID;
+    }
+    if (!doc.IsObject()) {
+        return StatusCode::REST_BODY_IS_NOT_AN_OBJECT;
+    }
+    auto inputsItr = doc.FindMember("inputs");
+    if (inputsItr == doc.MemberEnd() || !inputsItr->value.IsArray() || inputsItr->value.GetArray().Size() == 0) {
+        return StatusCode::REST_BINARY_HEADER_INVALID;
+    }
+
+    size_t offset = headerSize;
+    std::set<std::string> inputNames;
+    for (auto& input : inputsItr->value.GetArray()) {
+        if (!input.IsObject()) {
+            return StatusCode::REST_BINARY_HEADER_INVALID;
+        }
+        auto nameItr = input.FindMember("name");
+        auto datatypeItr = input.FindMember("datatype");
+        auto shapeItr = input.FindMember("shape");
+        if (nameItr == input.MemberEnd() || !nameItr->value.IsString() ||
+            datatypeItr == input.MemberEnd() || !datatypeItr->value.IsString() ||
+            shapeItr == input.MemberEnd() || !shapeItr->value.IsArray()) {
+            return StatusCode::REST_BINARY_HEADER_INVALID;
+        }
+        tensorflow::DataType dtype;
+        if (!getBinaryDataType(datatypeItr->value.GetString(), dtype)) {
+            return StatusCode::REST_UNSUPPORTED_PRECISION;
+        }
+
+        const std::string name = nameItr->value.GetString();
+        if (!inputNames.insert(name).second) {
+            SPDLOG_DEBUG("Binary tensors request header declares input: {} more than once", name);
+            return Status(StatusCode::REST_BINARY_HEADER_INVALID, "Duplicate input: " + name);
+        }
+        auto& proto = (*requestProto->mutable_inputs())[name];
+        proto.set_dtype(dtype);
+        proto.mutable_tensor_shape()->clear_dim();
+        size_t elements = 1;
+        for (auto& dim : shapeItr->value.GetArray()) {
+            if (!dim.IsInt64() || dim.GetInt64() < 0 || __builtin_mul_overflow(elements, static_cast<size_t>(dim.GetInt64()), &elements)) {
+                return StatusCode::REST_BINARY_HEADER_INVALID;
+            }
+            proto.mutable_tensor_shape()->add_dim()->set_size(dim.GetInt64());
+        }
+        size_t byteSize = 0;
+        if (__builtin_mul_overflow(elements, static_cast<size_t>(DataTypeSize(dtype)), &byteSize) || byteSize > size - offset) {
+            return StatusCode::REST_BINARY_DATA_SIZE_MISMATCH;
+        }
+
+        const char* data = body + offset;
+        switch (dtype) {
+        case tensorflow::DataType::DT_HALF:
+        case tensorflow::DataType::DT_UINT16: {
+            // Deserialization expects these precisions in 32 bit containers
+            auto* values = dtype == tensorflow::DataType::DT_HALF ? proto.mutable_half_val() : proto.mutable_int_val();
+            values->Resize(elements, 0);
+            for (size_t i = 0; i < elements; i++) {
+                uint16_t value;
+                std::memcpy(&value, data + i * sizeof(uint16_t), sizeof(uint16_t));
+                values->Set(i, value);
+            }
+            break;
+        }
+        default:
+            proto.mutable_tensor_content()->assign(data, byteSize);
+        }
+        offset += byteSize;
+    }
+    if (offset != size) {
+        return StatusCode::REST_BINARY_DATA_SIZE_MISMATCH;
+    }
+    removeUnusedInputs();
+    format = Format::NAMED;
+    return StatusCode::OK;
+}
+
 void RestParser::increaseBatchSize(tensorflow::TensorProto& proto) {
     if (proto.tensor_shape().dim_size() < 1) {
         proto.mutable_tensor_shape()->add_dim()->set_size(0);
@@ -231,115 +408,294 @@ bool RestParser::setDimOrValidate(tensorflow::TensorProto& proto, int dim, int s
     }
 }
 
+namespace {
 template <typename T>
-bool addToTensorContent(tensorflow::TensorProto& proto, T value) {
-    if (sizeof(T) != DataTypeSize(proto.dtype())) {
+bool getNumber(const rapidjson::Value& value, T& result) {
+    if (value.IsDouble()) {
+        result = static_cast<T>(value.GetDouble());
+    } else if (value.IsInt64()) {
+        result = static_cast<T>(value.GetInt64());
+    } else if (value.IsUint64()) {
+        result = static_cast<T>(value.GetUint64());
+    } else {
         return false;
     }
-    proto.mutable_tensor_content()->append(reinterpret_cast<const char*>(&value), sizeof(T));
     return true;
 }
 
 template <typename T>
-bool addToTensorContent(tensorflow::TensorProto& proto, const rapidjson::Value& value) {
-    if (value.IsDouble()) {
-        return addToTensorContent<T>(proto, static_cast<T>(value.GetDouble()));
-    }
-    if (value.IsInt64()) {
-        return addToTensorContent<T>(proto, static_cast<T>(value.GetInt64()));
-    }
-    if (value.IsUint64()) {
-        return addToTensorContent<T>(proto, static_cast<T>(value.GetUint64()));
-    }
-    if (value.IsInt()) {
-        return addToTensorContent<T>(proto, static_cast<T>(value.GetInt()));
-    }
-    if (value.IsUint()) {
-        return addToTensorContent<T>(proto, static_cast<T>(value.GetUint()));
+bool writeValues(const rapidjson::Value::ConstArray& values, char* destination) {
+    for (const auto& value : values) {
+        T number;
+        if (!getNumber(value, number)) {
+            return false;
+        }
+        std::memcpy(destination, &number, sizeof(T));
+        destination += sizeof(T);
     }
-    return false;
+    return true;
 }
 
-bool addToHalfVal(tensorflow::TensorProto& proto, const rapidjson::Value& value) {
-    if (value.IsDouble()) {
-        proto.add_half_val(value.GetDouble());
-        return true;
-    }
-    if (value.IsInt64()) {
-        proto.add_half_val(value.GetInt64());
-        return true;
-    }
-    if (value.IsUint64()) {
-        proto.add_half_val(value.GetUint64());
-        return true;
-    }
-    if (value.IsInt()) {
-        proto.add_half_val(value.GetInt());
-        return true;
+// Content is resized once for the whole array and values are converted straight into it,
+// space for all values of input is usually reserved up front from its shape
+template <typename T>
+bool addToTensorContent(tensorflow::TensorProto& proto, const rapidjson::Value::ConstArray& values) {
+    if (sizeof(T) != DataTypeSize(proto.dtype())) {
+        return false;
     }
-    if (value.IsUint()) {
-        proto.add_half_val(value.GetUint());
-        return true;
+    auto* content = proto.mutable_tensor_content();
+    const size_t offset = content->size();
+    content->resize(offset + values.Size() * sizeof(T));
+    if (!writeValues<T>(values, &(*content)[offset])) {
+        content->resize(offset);
+        return false;
     }
-    return false;
+    return true;
 }
 
-bool addToIntVal(tensorflow::TensorProto& proto, const rapidjson::Value& value) {
-    if (value.IsDouble()) {
-        proto.add_int_val(value.GetDouble());
-        return true;
-    }
-    if (value.IsInt64()) {
-        proto.add_int_val(value.GetInt64());
-        return true;
-    }
-    if (value.IsUint64()) {
-        proto.add_int_val(value.GetUint64());
-        return true;
-    }
-    if (value.IsInt()) {
-        proto.add_int_val(value.GetInt());
-        return true;
-    }
-    if (value.IsUint()) {
-        proto.add_int_val(value.GetUint());
-        return true;
+// Deserialization expects these precisions in 32 bit containers
+template <typename T>
+bool addToRepeatedField(google::protobuf::RepeatedField<int>& field, const rapidjson::Value::ConstArray& values) {
+    field.Reserve(field.size() + values.Size());
+    for (const auto& value : values) {
+        T number;
+        if (!getNumber(value, number)) {
+            return false;
+        }
+        field.AddAlreadyReserved(number);
     }
-    return false;
+    return true;
 }
+}  // namespace
 
-bool RestParser::addValue(tensorflow::TensorProto& proto, const rapidjson::Value& value) {
-    if (!value.IsNumber())
-        return false;
-
+bool RestParser::addValues(tensorflow::TensorProto& proto, const rapidjson::Value::ConstArray& values) {
     switch (proto.dtype()) {
     case tensorflow::DataType::DT_FLOAT:
-        return addToTensorContent<float>(proto, value);
+        return addToTensorContent<float>(proto, values);
     case tensorflow::DataType::DT_HALF:
-        return addToHalfVal(proto, value);
+        return addToRepeatedField<float>(*proto.mutable_half_val(), values);
     case tensorflow::DataType::DT_DOUBLE:
-        return addToTensorContent<double>(proto, value);
+        return addToTensorContent<double>(proto, values);
     case tensorflow::DataType::DT_INT32:
-        return addToTensorContent<int32_t>(proto, value);
+        return addToTensorContent<int32_t>(proto, values);
     case tensorflow::DataType::DT_INT16:
-        return addToTensorContent<int16_t>(proto, value);
+        return addToTensorContent<int16_t>(proto, values);
     case tensorflow::DataType::DT_UINT16:
-        return addToIntVal(proto, value);
+        return addToRepeatedField<int64_t>(*proto.mutable_int_val(), values);
     case tensorflow::DataType::DT_INT8:
-        return addToTensorContent<int8_t>(proto, value);
+        return addToTensorContent<int8_t>(proto, values);
     case tensorflow::DataType::DT_UINT8:
-        return addToTensorContent<uint8_t>(proto, value);
+        return addToTensorContent<uint8_t>(proto, values);
     case tensorflow::DataType::DT_INT64:
-        return addToTensorContent<int64_t>(proto, value);
+        return addToTensorContent<int64_t>(proto, values);
     case tensorflow::DataType::DT_UINT32:
-        return addToTensorContent<uint32_t>(proto, value);
+        return addToTensorContent<uint32_t>(proto, values);
     case tensorflow::DataType::DT_UINT64:
-        return addToTensorContent<uint64_t>(proto, value);
+        return addToTensorContent<uint64_t>(proto, values);
     default:
         return false;
     }
 }
 
+namespace {
+const size_t PARALLEL_ROW_PARSING_MIN_INSTANCES_PER_WORKER = 64;
+
+/**
+ * @brief Input of row format request parsed in parallel, each instance is written to its own slice of tensor content
+ */
+struct RowInputSlice {
+    tensorflow::TensorProto* proto;
+    char* data;
+    size_t instanceByteSize;
+};
+
+bool writeTensorContent(tensorflow::DataType dtype, const rapidjson::Value::ConstArray& values, char* destination) {
+    switch (dtype) {
+    case tensorflow::DataType::DT_FLOAT:
+        return writeValues<float>(values, destination);
+    case tensorflow::DataType::DT_DOUBLE:
+        return writeValues<double>(values, destination);
+    case tensorflow::DataType::DT_INT32:
+        return writeValues<int32_t>(values, destination);
+    case tensorflow::DataType::DT_INT16:
+        return writeValues<int16_t>(values, destination);
+    case tensorflow::DataType::DT_INT8:
+        return writeValues<int8_t>(values, destination);
+    case tensorflow::DataType::DT_UINT8:
+        return writeValues<uint8_t>(values, destination);
+    case tensorflow::DataType::DT_INT64:
+        return writeValues<int64_t>(values, destination);
+    case tensorflow::DataType::DT_UINT32:
+        return writeValues<uint32_t>(values, destination);
+    case tensorflow::DataType::DT_UINT64:
+        return writeValues<uint64_t>(values, destination);
+    default:
+        return false;
+    }
+}
+
+// Shape is not modified, array has to match dimensions already set by first instance
+bool writeRowArray(const rapidjson::Value& node, int dim, const tensorflow::TensorProto& proto, char*& destination) {
+    if (!node.IsArray() || dim >= proto.tensor_shape().dim_size() || static_cast<int64_t>(node.GetArray().Size()) != proto.tensor_shape().dim(dim).size()) {
+        return false;
+    }
+    const auto array = node.GetArray();
+    if (array[0].IsArray()) {
+        for (const auto& item : array) {
+            if (!writeRowArray(item, dim + 1, proto, destination)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (dim != proto.tensor_shape().dim_size() - 1 || !writeTensorContent(proto.dtype(), array, destination)) {
+        return false;
+    }
+    destination += array.Size() * DataTypeSize(proto.dtype());
+    return true;
+}
+
+// Checks array dimensions without reading values, so that content is allocated only for instances matching the first one
+bool hasRowShape(const rapidjson::Value& node, int dim, const tensorflow::TensorProto& proto) {
+    if (!node.IsArray() || dim >= proto.tensor_shape().dim_size() || static_cast<int64_t>(node.GetArray().Size()) != proto.tensor_shape().dim(dim).size()) {
+        return false;
+    }
+    const auto array = node.GetArray();
+    if (dim == proto.tensor_shape().dim_size() - 1) {
+        return array.Size() == 0 || !array[0].IsArray();
+    }
+    for (const auto& item : array) {
+        if (!hasRowShape(item, dim + 1, proto)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasRowInstanceShape(const rapidjson::Value& instance, const std::map<std::string, size_t>& slicesIndexes, const std::vector<RowInputSlice>& slices) {
+    if (!instance.IsObject() || instance.MemberCount() != slices.size()) {
+        return false;
+    }
+    std::vector<bool> checked(slices.size(), false);
+    for (const auto& member : instance.GetObject()) {
+        auto it = slicesIndexes.find(member.name.GetString());
+        if (it == slicesIndexes.end() || checked[it->second] || !hasRowShape(member.value, 1, *slices[it->second].proto)) {
+            return false;
+        }
+        checked[it->second] = true;
+    }
+    return true;
+}
+
+bool writeRowInstance(const rapidjson::Value& instance, size_t index, const std::map<std::string, size_t>& slicesIndexes, const std::vector<RowInputSlice>& slices) {
+    if (!instance.IsObject() || instance.MemberCount() != slices.size()) {
+        return false;
+    }
+    std::vector<bool> written(slices.size(), false);
+    for (const auto& member : instance.GetObject()) {
+        auto it = slicesIndexes.find(member.name.GetString());
+        if (it == slicesIndexes.end() || written[it->second]) {
+            return false;
+        }
+        const auto& slice = slices[it->second];
+        char* destination = slice.data + index * slice.instanceByteSize;
+        if (!writeRowArray(member.value, 1, *slice.proto, destination) ||
+            destination != slice.data + (index + 1) * slice.instanceByteSize) {
+            return false;
+        }
+        written[it->second] = true;
+    }
+    return true;
+}
+}  // namespace
+
+bool RestParser::parseRemainingInstancesInParallel(rapidjson::Value& instances) {
+    const auto array = instances.GetArray();
+    auto& executor = WorkStealingExecutor::getInstance();
+    const size_t workers = std::min<size_t>(executor.getWorkersCount() + 1, array.Size() / PARALLEL_ROW_PARSING_MIN_INSTANCES_PER_WORKER);
+    if (workers < 2) {
+        return false;
+    }
+
+    std::map<std::string, size_t> slicesIndexes;
+    std::vector<RowInputSlice> slices;
+    size_t instanceValues = 0;
+    for (const auto& member : array[0].GetObject()) {
+        const std::string tensorName = member.name.GetString();
+        auto& proto = (*requestProto->mutable_inputs())[tensorName];
+        // precision has to be known up front, FP16 and U16 are not stored in tensor content
+        if (tensorPrecisionMap.count(tensorName) == 0 ||
+            proto.dtype() == tensorflow::DataType::DT_HALF ||
+            proto.dtype() == tensorflow::DataType::DT_UINT16 ||
+            slicesIndexes.count(tensorName) > 0) {
+            return false;
+        }
+        size_t instanceByteSize = DataTypeSize(proto.dtype());
+        for (int i = 1; i < proto.tensor_shape().dim_size(); i++) {
+            if (__builtin_mul_overflow(instanceByteSize, static_cast<size_t>(proto.tensor_shape().dim(i).size()), &instanceByteSize)) {
+                return false;
+            }
+        }
+        if (instanceByteSize == 0 || proto.tensor_content().size() != instanceByteSize) {
+            return false;
+        }
+        instanceValues += instanceByteSize / DataTypeSize(proto.dtype());
+        slicesIndexes[tensorName] = slices.size();
+        slices.push_back({&proto, nullptr, instanceByteSize});
+    }
+    // each value takes at least one character of the document
+    size_t requestValues = 0;
+    if (__builtin_mul_overflow(instanceValues, static_cast<size_t>(array.Size()), &requestValues) || requestValues > documentLength) {
+        return false;
+    }
+
+    const size_t instancesPerWorker = (array.Size() - 1 + workers - 1) / workers;
+    const size_t tasksCount = (array.Size() - 1 + instancesPerWorker - 1) / instancesPerWorker;
+    std::atomic<bool> matching{true};
+    executor.parallelFor(tasksCount, tasksCount - 1, [&array, &slicesIndexes, &slices, &matching, instancesPerWorker](size_t task) {
+        const size_t begin = 1 + task * instancesPerWorker;
+        const size_t end = std::min<size_t>(begin + instancesPerWorker, array.Size());
+        for (size_t i = begin; i < end && matching.load(std::memory_order_relaxed); i++) {
+            if (!hasRowInstanceShape(array[i], slicesIndexes, slices)) {
+                matching = false;
+            }
+        }
+    });
+    if (!matching) {
+        SPDLOG_DEBUG("Instances of row format request differ in shapes, parsing sequentially");
+        return false;
+    }
+
+    for (auto& slice : slices) {
+        auto* content = slice.proto->mutable_tensor_content();
+        content->resize(array.Size() * slice.instanceByteSize);
+        slice.data = &(*content)[0];
+    }
+    std::atomic<bool> written{true};
+    executor.parallelFor(tasksCount, tasksCount - 1, [&array, &slicesIndexes, &slices, &written, instancesPerWorker](size_t task) {
+        const size_t begin = 1 + task * instancesPerWorker;
+        const size_t end = std::min<size_t>(begin + instancesPerWorker, array.Size());
+        for (size_t i = begin; i < end && written.load(std::memory_order_relaxed); i++) {
+            if (!writeRowInstance(array[i], i, slicesIndexes, slices)) {
+                written = false;
+            }
+        }
+    });
+
+    for (auto& slice : slices) {
+        if (written) {
+            slice.proto->mutable_tensor_shape()->mutable_dim(0)->set_size(array.Size());
+        } else {
+            // restore state after first instance so that sequential parsing reports the same error
+            slice.proto->mutable_tensor_content()->resize(slice.instanceByteSize);
+        }
+    }
+    if (!written) {
+        SPDLOG_DEBUG("Parallel parsing of row format request failed, parsing sequentially");
+    }
+    return written;
+}
+
 bool RestParser::setPrecisionIfNotSet(const rapidjson::Value& value, tensorflow::TensorProto& proto, const std::string& tensorName) {
     if (tensorPrecisionMap.count(tensorName))
         return true;
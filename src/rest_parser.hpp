@@ -16,8 +16,11 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 
+#include <google/protobuf/arena.h>
+
 #include <rapidjson/document.h>
 #include <spdlog/spdlog.h>
 
@@ -63,16 +66,26 @@ class RestParser {
      */
     Format format = Format::UNKNOWN;
 
+    /**
+     * @brief Owns request proto and all its tensors, released at once together with parser
+     */
+    std::unique_ptr<google::protobuf::Arena> arena = std::make_unique<google::protobuf::Arena>();
+
     /**
      * @brief Request proto
      */
-    tensorflow::serving::PredictRequest requestProto;
+    tensorflow::serving::PredictRequest* requestProto = google::protobuf::Arena::CreateMessage<tensorflow::serving::PredictRequest>(arena.get());
 
     /**
      * @brief Request content precision
      */
     std::map<std::string, InferenceEngine::Precision> tensorPrecisionMap;
 
+    /**
+     * @brief Length of JSON document being parsed, bounds number of values it can contain
+     */
+    size_t documentLength = 0;
+
     void removeUnusedInputs();
 
     /**
@@ -88,9 +101,9 @@ class RestParser {
     static bool setDimOrValidate(tensorflow::TensorProto& proto, int dim, int size);
 
     /**
-     * Parses and adds rapidjson value to tensor proto depending on underlying tensor data type
+     * Parses and adds array of rapidjson numeric values to tensor proto depending on underlying tensor data type
      */
-    static bool addValue(tensorflow::TensorProto& proto, const rapidjson::Value& value);
+    static bool addValues(tensorflow::TensorProto& proto, const rapidjson::Value::ConstArray& values);
 
     /**
      * @brief Parses rapidjson Node for arrays or numeric values on certain level of nesting.
@@ -126,6 +139,19 @@ class RestParser {
      */
     bool parseInstance(rapidjson::Value& doc);
 
+    /**
+     * @brief Parses named row format instances following the first one on multiple threads
+     *
+     * Each instance is written straight to its own slice of tensor content, so it has to contain the same inputs
+     * with the same shapes as the first one. Shapes of all instances are checked before tensor content is allocated.
+     * Used for preallocated inputs and large batches only, runs on shared executor.
+     *
+     * @param instances rapidjson Node with array of instances, first one already parsed
+     *
+     * @return true if all instances were parsed, false if parsing should continue sequentially from the second instance
+     */
+    bool parseRemainingInstancesInParallel(rapidjson::Value& instances);
+
     /**
      * @brief Checks whether all inputs have equal batch size, 0th-dimension
      * 
@@ -165,8 +191,19 @@ class RestParser {
 
     bool setPrecisionIfNotSet(const rapidjson::Value& value, tensorflow::TensorProto& proto, const std::string& tensorName);
 
+    /**
+     * @brief Parses already loaded JSON document of request body
+     */
+    Status parseDocument(rapidjson::Document& doc);
+
 public:
     RestParser() = default;
+
+    RestParser(const RestParser& other);
+    RestParser(RestParser&&) = default;
+    RestParser& operator=(const RestParser&) = delete;
+    RestParser& operator=(RestParser&&) = default;
+
     /**
      * @brief Constructor for preallocating memory for inputs beforehand. Size is calculated from tensor shape required by backend.
      * 
@@ -179,7 +216,7 @@ public:
      * 
      * @return proto
      */
-    tensorflow::serving::PredictRequest& getProto() { return requestProto; }
+    tensorflow::serving::PredictRequest& getProto() { return *requestProto; }
 
     /**
      * @brief Gets request order
@@ -211,6 +248,34 @@ public:
      * }
      */
     Status parse(const char* json);
+
+    /**
+     * @brief Parses http request body in place, without copying strings to JSON document
+     *
+     * @param json null terminated request string, modified during parsing and not usable afterwards
+     *
+     * @return Status indicating error code or success
+     */
+    Status parseInsitu(char* json);
+
+    /**
+     * @brief Parses binary tensors request body: JSON header describing inputs followed by their raw data
+     *
+     * @param body request body
+     * @param size request body size
+     * @param headerSize size of JSON header at the beginning of body
+     *
+     * @return Status indicating error code or success
+     *
+     * JSON header expected to be passed in following structure, data of inputs follows it in the same order:
+     * {
+     *     "inputs": [
+     *         {"name": "input1", "datatype": "FP32", "shape": [1, 3, 224, 224]},
+     *         ...
+     *     ]
+     * }
+     */
+    Status parseBinary(const char* body, size_t size, size_t headerSize);
 };
 
 }  // namespace ovms
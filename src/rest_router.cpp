@@ -0,0 +1,226 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "rest_router.hpp"
+
+namespace ovms {
+
+namespace {
+const std::string_view MODELS_PREFIX = "/v1/models";
+const std::string_view SHARED_MEMORY_PREFIX = "/v1/shared_memory";
+const std::string_view PROFILING_PREFIX = "/debug/pprof/";
+
+bool isAnyCharacter(char c) {
+    return c != '\n' && c != '\r';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isWordCharacter(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isNameCharacter(char c) {
+    return c != '/' && c != ':';
+}
+
+bool consume(std::string_view& path, std::string_view token) {
+    if (path.substr(0, token.size()) != token) {
+        return false;
+    }
+    path.remove_prefix(token.size());
+    return true;
+}
+
+template <typename Predicate>
+std::string_view consumeWhile(std::string_view& path, Predicate predicate) {
+    size_t length = 0;
+    while (length < path.size() && predicate(path[length])) {
+        length++;
+    }
+    auto consumed = path.substr(0, length);
+    path.remove_prefix(length);
+    return consumed;
+}
+
+/**
+ * @brief Matches path against pattern with optional leading character, as (.?) group of REST API paths
+ */
+template <typename Matcher>
+bool matchWithOptionalPrefix(std::string_view path, Matcher matcher) {
+    if (matcher(path)) {
+        return true;
+    }
+    return !path.empty() && isAnyCharacter(path[0]) && matcher(path.substr(1));
+}
+
+/**
+ * @brief Consumes [/versions/{version}|/labels/{label}]
+ */
+void consumeVersionOrLabel(std::string_view& path, RestPathComponents& components) {
+    components.modelVersion = {};
+    components.modelVersionLabel = {};
+    auto rest = path;
+    if (consume(rest, "/versions/")) {
+        components.modelVersion = consumeWhile(rest, isDigit);
+        if (!components.modelVersion.empty()) {
+            path = rest;
+        }
+        return;
+    }
+    rest = path;
+    if (consume(rest, "/labels/")) {
+        components.modelVersionLabel = consumeWhile(rest, isWordCharacter);
+        if (!components.modelVersionLabel.empty()) {
+            path = rest;
+        }
+    }
+}
+
+bool matchModelStatusSuffix(std::string_view path, RestPathComponents& components) {
+    consumeVersionOrLabel(path, components);
+    components.method = {};
+    if (path.empty()) {
+        return true;
+    }
+    if (path == "/metadata") {
+        components.method = path.substr(1);
+        return true;
+    }
+    return false;
+}
+}  // namespace
+
+bool matchModelsPath(std::string_view path) {
+    return matchWithOptionalPrefix(path, [](std::string_view path) {
+        if (!consume(path, MODELS_PREFIX) || !consume(path, "/")) {
+            return false;
+        }
+        for (char c : path) {
+            if (!isAnyCharacter(c)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+bool matchPredictionPath(std::string_view path, RestPathComponents& components) {
+    return matchWithOptionalPrefix(path, [&components](std::string_view path) {
+        if (!consume(path, MODELS_PREFIX) || !consume(path, "/")) {
+            return false;
+        }
+        components.modelName = consumeWhile(path, isNameCharacter);
+        if (components.modelName.empty()) {
+            return false;
+        }
+        consumeVersionOrLabel(path, components);
+        if (!consume(path, ":")) {
+            return false;
+        }
+        if (path == "classify" || path == "regress" || path == "predict") {
+            components.method = path;
+            return true;
+        }
+        return false;
+    });
+}
+
+bool matchModelStatusPath(std::string_view path, RestPathComponents& components) {
+    return matchWithOptionalPrefix(path, [&components](std::string_view path) {
+        if (!consume(path, MODELS_PREFIX)) {
+            return false;
+        }
+        // model name is optional, path segment is matched as name first, as version or label of all models otherwise
+        auto rest = path;
+        if (consume(rest, "/")) {
+            components.modelName = consumeWhile(rest, isNameCharacter);
+            if (!components.modelName.empty() && matchModelStatusSuffix(rest, components)) {
+                return true;
+            }
+        }
+        components.modelName = {};
+        return matchModelStatusSuffix(path, components);
+    });
+}
+
+bool matchMetricsPath(std::string_view path) {
+    return matchWithOptionalPrefix(path, [](std::string_view path) {
+        return path == "/metrics";
+    });
+}
+
+bool matchReadinessPath(std::string_view path) {
+    return matchWithOptionalPrefix(path, [](std::string_view path) {
+        return path == "/v1/ready";
+    });
+}
+
+bool matchStatusSnapshotPath(std::string_view path) {
+    return matchWithOptionalPrefix(path, [](std::string_view path) {
+        return path == "/v1/status";
+    });
+}
+
+bool matchProfilingPath(std::string_view path, std::string_view& profile, std::string_view& seconds) {
+    return matchWithOptionalPrefix(path, [&profile, &seconds](std::string_view path) {
+        profile = {};
+        seconds = {};
+        if (!consume(path, PROFILING_PREFIX)) {
+            return false;
+        }
+        profile = consumeWhile(path, isWordCharacter);
+        if (profile != "profile" && profile != "heap") {
+            return false;
+        }
+        if (path.empty()) {
+            return true;
+        }
+        if (!consume(path, "?seconds=")) {
+            return false;
+        }
+        seconds = consumeWhile(path, isDigit);
+        return !seconds.empty() && path.empty();
+    });
+}
+
+bool matchSharedMemoryPath(std::string_view path, std::string_view& regionName, std::string_view& method) {
+    return matchWithOptionalPrefix(path, [&regionName, &method](std::string_view path) {
+        regionName = {};
+        method = {};
+        if (!consume(path, SHARED_MEMORY_PREFIX)) {
+            return false;
+        }
+        if (path.empty()) {
+            return true;
+        }
+        if (!consume(path, "/")) {
+            return false;
+        }
+        regionName = consumeWhile(path, isNameCharacter);
+        if (regionName.empty() || !consume(path, ":")) {
+            return false;
+        }
+        if (path == "register" || path == "unregister") {
+            method = path;
+            return true;
+        }
+        return false;
+    });
+}
+
+}  // namespace ovms
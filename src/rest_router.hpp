@@ -0,0 +1,94 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <string_view>
+
+namespace ovms {
+
+/**
+ * @brief Components of REST API path, they are views into matched path
+ */
+struct RestPathComponents {
+    std::string_view modelName;
+    std::string_view modelVersion;
+    std::string_view modelVersionLabel;
+    std::string_view method;
+};
+
+/**
+ * @brief Matches paths served by models API: (.?)/v1/models/.*
+ */
+bool matchModelsPath(std::string_view path);
+
+/**
+ * @brief Matches prediction path: (.?)/v1/models/{name}[/versions/{version}|/labels/{label}]:(classify|regress|predict)
+ *
+ * @param path
+ * @param components filled with model name, version, label and processing method on match
+ *
+ * @return true if whole path matches
+ */
+bool matchPredictionPath(std::string_view path, RestPathComponents& components);
+
+/**
+ * @brief Matches model status path: (.?)/v1/models[/{name}][/versions/{version}|/labels/{label}][/metadata]
+ *
+ * @param path
+ * @param components filled with model name, version, label and metadata subresource on match
+ *
+ * @return true if whole path matches
+ */
+bool matchModelStatusPath(std::string_view path, RestPathComponents& components);
+
+/**
+ * @brief Matches metrics path: (.?)/metrics
+ */
+bool matchMetricsPath(std::string_view path);
+
+/**
+ * @brief Matches readiness path: (.?)/v1/ready
+ */
+bool matchReadinessPath(std::string_view path);
+
+/**
+ * @brief Matches status of all models and pipelines path: (.?)/v1/status
+ */
+bool matchStatusSnapshotPath(std::string_view path);
+
+/**
+ * @brief Matches profiling path: (.?)/debug/pprof/(profile|heap)[?seconds={seconds}]
+ *
+ * @param path
+ * @param profile filled with profile or heap on match
+ * @param seconds filled with value of seconds query parameter on match, empty if not set
+ *
+ * @return true if whole path matches
+ */
+bool matchProfilingPath(std::string_view path, std::string_view& profile, std::string_view& seconds);
+
+/**
+ * @brief Matches shared memory regions path: (.?)/v1/shared_memory[/{name}:(register|unregister)]
+ *
+ * @param path
+ * @param regionName filled with region name on match, empty if path refers to all regions
+ * @param method filled with register or unregister on match, empty if path refers to all regions
+ *
+ * @return true if whole path matches
+ */
+bool matchSharedMemoryPath(std::string_view path, std::string_view& regionName, std::string_view& method);
+
+}  // namespace ovms
@@ -15,11 +15,23 @@
 //*****************************************************************************
 #include "rest_utils.hpp"
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+#include <rapidjson/internal/dtoa.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
 #include <spdlog/spdlog.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
-#include "tensorflow_serving/util/json_tensor.h"
+#include "tensorflow/core/framework/tensor.h"
 #pragma GCC diagnostic pop
 
 #define DEBUG
@@ -27,26 +39,341 @@
 
 using tensorflow::DataType;
 using tensorflow::DataTypeSize;
-using tensorflow::serving::JsonPredictRequestFormat;
-using tensorflow::serving::MakeJsonFromTensors;
 using tensorflow::serving::PredictResponse;
 
 namespace ovms {
-Status makeJsonFromPredictResponse(
-    PredictResponse& response_proto,
-    std::string* response_json,
-    Order order) {
-    if (order == Order::UNKNOWN) {
-        return StatusCode::REST_PREDICT_UNKNOWN_ORDER;
+
+namespace {
+
+const size_t RESPONSE_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * @brief rapidjson output stream passing serialized response to writer in chunks of fixed size
+ */
+class ResponseChunkStream {
+public:
+    typedef char Ch;
+
+    ResponseChunkStream(const ResponseChunkWriter& writeChunk) :
+        writeChunk(writeChunk),
+        buffer(RESPONSE_CHUNK_SIZE) {}
+
+    void Put(Ch c) {
+        buffer[size++] = c;
+        if (size == RESPONSE_CHUNK_SIZE) {
+            Flush();
+        }
     }
 
-    Timer timer;
-    using std::chrono::microseconds;
+    void Flush() {
+        if (size > 0) {
+            writeChunk(buffer.data(), size);
+            size = 0;
+        }
+    }
+
+private:
+    const ResponseChunkWriter& writeChunk;
+    std::vector<char> buffer;
+    size_t size = 0;
+};
+
+/**
+ * @brief Writes shortest decimal representation which parses back to the same float
+ *
+ * Runs rapidjson Grisu2 digit generation with rounding boundaries of float precision instead of
+ * double so that 0.1f is written as 0.1 and not as 0.10000000149011612. Value has to be finite.
+ *
+ * @return end of written characters
+ */
+char* floatToDecimal(float value, char* buffer) {
+    using rapidjson::internal::DiyFp;
+
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (bits >> 31) {
+        *buffer++ = '-';
+    }
+    const uint32_t biasedExponent = (bits >> 23) & 0xFF;
+    const uint64_t significand = bits & 0x7FFFFF;
+    if (biasedExponent == 0 && significand == 0) {
+        std::memcpy(buffer, "0.0", 3);
+        return buffer + 3;
+    }
+
+    const uint64_t hiddenBit = 0x800000;
+    const uint64_t f = biasedExponent != 0 ? (significand | hiddenBit) : significand;
+    const int e = biasedExponent != 0 ? static_cast<int>(biasedExponent) - 150 : -149;
 
-    timer.start("convert");
+    // Lower boundary is closer when value is power of 2, since spacing of floats halves below it
+    const DiyFp v = DiyFp(f, e).Normalize();
+    const DiyFp plus = DiyFp((f << 1) + 1, e - 1).Normalize();
+    DiyFp minus = (f == hiddenBit && biasedExponent > 1) ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
 
-    for (auto& kv : *response_proto.mutable_outputs()) {
-        auto& tensor = kv.second;
+    int K;
+    const DiyFp cachedPower = rapidjson::internal::GetCachedPower(plus.e, &K);
+    const DiyFp W = v * cachedPower;
+    DiyFp Wp = plus * cachedPower;
+    DiyFp Wm = minus * cachedPower;
+    Wm.f++;
+    Wp.f--;
+    int length;
+    rapidjson::internal::DigitGen(W, Wp, Wp.f - Wm.f, buffer, &length, &K);
+    return rapidjson::internal::Prettify(buffer, length, K, 324);
+}
+
+template <typename JsonWriter, typename T>
+bool writeNonFinite(JsonWriter& writer, T value) {
+    if (std::isnan(value)) {
+        return writer.RawValue("NaN", 3, rapidjson::kNumberType);
+    }
+    return value < 0 ? writer.RawValue("-Infinity", 9, rapidjson::kNumberType) : writer.RawValue("Infinity", 8, rapidjson::kNumberType);
+}
+
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, float value) {
+    if (!std::isfinite(value)) {
+        return writeNonFinite(writer, value);
+    }
+    char buffer[32];
+    const char* end = floatToDecimal(value, buffer);
+    return writer.RawValue(buffer, end - buffer, rapidjson::kNumberType);
+}
+
+/**
+ * @brief Raw IEEE 754 half precision value of tensor_content
+ */
+struct Half {
+    uint16_t bits;
+};
+
+float halfToFloat(uint16_t half) {
+#ifdef __F16C__
+    return _cvtsh_ss(half);
+#else
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // subnormal half is normalized in single precision
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+#endif
+}
+
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, Half value) {
+    return writeNumber(writer, halfToFloat(value.bits));
+}
+
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, double value) {
+    if (!std::isfinite(value)) {
+        return writeNonFinite(writer, value);
+    }
+    return writer.Double(value);
+}
+
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, int8_t value) { return writer.Int(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, uint8_t value) { return writer.Uint(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, int16_t value) { return writer.Int(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, uint16_t value) { return writer.Uint(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, int32_t value) { return writer.Int(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, uint32_t value) { return writer.Uint(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, int64_t value) { return writer.Int64(value); }
+template <typename JsonWriter>
+bool writeNumber(JsonWriter& writer, uint64_t value) { return writer.Uint64(value); }
+
+/**
+ * @brief Writes values of tensor_content as nested arrays, starting with given dimension
+ *
+ * @param data first element of written subtensor
+ * @param strides number of elements between consecutive indices of each dimension
+ */
+template <typename T, typename JsonWriter>
+void writeSubtensor(JsonWriter& writer, const tensorflow::TensorProto& tensor, const char* data, const std::vector<size_t>& strides, int dimension) {
+    if (dimension == tensor.tensor_shape().dim_size()) {
+        // tensor_content is not guaranteed to be aligned to T
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        writeNumber(writer, value);
+        return;
+    }
+    writer.StartArray();
+    const char* end = data + tensor.tensor_shape().dim(dimension).size() * strides[dimension] * sizeof(T);
+    if (dimension + 1 == tensor.tensor_shape().dim_size()) {
+        for (const char* it = data; it != end; it += sizeof(T)) {
+            T value;
+            std::memcpy(&value, it, sizeof(T));
+            writeNumber(writer, value);
+        }
+    } else {
+        for (const char* it = data; it != end; it += strides[dimension] * sizeof(T)) {
+            writeSubtensor<T>(writer, tensor, it, strides, dimension + 1);
+        }
+    }
+    writer.EndArray();
+}
+
+template <typename T, typename JsonWriter>
+void writeTensor(JsonWriter& writer, const tensorflow::TensorProto& tensor, int64_t batchIndex) {
+    const int dimCount = tensor.tensor_shape().dim_size();
+    std::vector<size_t> strides(dimCount, 1);
+    for (int i = dimCount - 2; i >= 0; i--) {
+        strides[i] = strides[i + 1] * tensor.tensor_shape().dim(i + 1).size();
+    }
+    const char* data = tensor.tensor_content().data();
+    if (batchIndex < 0) {
+        writeSubtensor<T>(writer, tensor, data, strides, 0);
+    } else {
+        writeSubtensor<T>(writer, tensor, data + batchIndex * strides[0] * sizeof(T), strides, 1);
+    }
+}
+
+/**
+ * @brief Writes whole tensor, or its single batch slice when batchIndex is not negative
+ */
+template <typename JsonWriter>
+void writeTensorValues(JsonWriter& writer, const tensorflow::TensorProto& tensor, int64_t batchIndex) {
+    switch (tensor.dtype()) {
+    case DataType::DT_FLOAT:
+        return writeTensor<float>(writer, tensor, batchIndex);
+    case DataType::DT_HALF:
+        return writeTensor<Half>(writer, tensor, batchIndex);
+    case DataType::DT_DOUBLE:
+        return writeTensor<double>(writer, tensor, batchIndex);
+    case DataType::DT_INT32:
+        return writeTensor<int32_t>(writer, tensor, batchIndex);
+    case DataType::DT_INT16:
+        return writeTensor<int16_t>(writer, tensor, batchIndex);
+    case DataType::DT_UINT16:
+        return writeTensor<uint16_t>(writer, tensor, batchIndex);
+    case DataType::DT_INT8:
+        return writeTensor<int8_t>(writer, tensor, batchIndex);
+    case DataType::DT_UINT8:
+        return writeTensor<uint8_t>(writer, tensor, batchIndex);
+    case DataType::DT_INT64:
+        return writeTensor<int64_t>(writer, tensor, batchIndex);
+    case DataType::DT_UINT32:
+        return writeTensor<uint32_t>(writer, tensor, batchIndex);
+    case DataType::DT_UINT64:
+        return writeTensor<uint64_t>(writer, tensor, batchIndex);
+    default:
+        return;
+    }
+}
+
+bool isSupportedPrecision(DataType dtype) {
+    switch (dtype) {
+    case DataType::DT_FLOAT:
+    case DataType::DT_HALF:
+    case DataType::DT_DOUBLE:
+    case DataType::DT_INT32:
+    case DataType::DT_INT16:
+    case DataType::DT_UINT16:
+    case DataType::DT_INT8:
+    case DataType::DT_UINT8:
+    case DataType::DT_INT64:
+    case DataType::DT_UINT32:
+    case DataType::DT_UINT64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Status validateOutputsForRowOrder(const PredictResponse& response_proto, int64_t& batchSize) {
+    batchSize = -1;
+    for (const auto& kv : response_proto.outputs()) {
+        const auto& tensor = kv.second;
+        if (tensor.tensor_shape().dim_size() == 0) {
+            SPDLOG_ERROR("Creating json from tensors failed: output {} is a scalar, cannot be serialized in row format", kv.first);
+            return StatusCode::REST_PROTO_TO_STRING_ERROR;
+        }
+        if (batchSize >= 0 && tensor.tensor_shape().dim(0).size() != batchSize) {
+            SPDLOG_ERROR("Creating json from tensors failed: outputs have different batch sizes, cannot be serialized in row format");
+            return StatusCode::REST_PROTO_TO_STRING_ERROR;
+        }
+        batchSize = tensor.tensor_shape().dim(0).size();
+    }
+    return StatusCode::OK;
+}
+
+// Layout and format options follow tensorflow serving MakeJsonFromTensors, values of row format
+// instances are written in single line
+template <typename JsonWriter>
+void writeRowOrder(JsonWriter& writer, const PredictResponse& response_proto, int64_t batchSize) {
+    const bool named = response_proto.outputs().size() > 1;
+    writer.Key("predictions");
+    writer.StartArray();
+    for (int64_t i = 0; i < batchSize; i++) {
+        if (named) {
+            writer.StartObject();
+        }
+        for (const auto& kv : response_proto.outputs()) {
+            if (named) {
+                writer.Key(kv.first.c_str(), kv.first.size());
+            }
+            writer.SetFormatOptions(rapidjson::kFormatSingleLineArray);
+            writeTensorValues(writer, kv.second, i);
+            writer.SetFormatOptions(rapidjson::kFormatDefault);
+        }
+        if (named) {
+            writer.EndObject();
+        }
+    }
+    writer.EndArray();
+}
+
+template <typename JsonWriter>
+void writeColumnOrder(JsonWriter& writer, const PredictResponse& response_proto) {
+    const bool named = response_proto.outputs().size() > 1;
+    writer.Key("outputs");
+    if (named) {
+        writer.StartObject();
+    }
+    for (const auto& kv : response_proto.outputs()) {
+        if (named) {
+            writer.Key(kv.first.c_str(), kv.first.size());
+        }
+        writeTensorValues(writer, kv.second, -1);
+    }
+    if (named) {
+        writer.EndObject();
+    }
+}
+
+Status validateOutputs(const PredictResponse& response_proto, Order order, int64_t& batchSize) {
+    if (order == Order::UNKNOWN) {
+        return StatusCode::REST_PREDICT_UNKNOWN_ORDER;
+    }
+
+    for (const auto& kv : response_proto.outputs()) {
+        const auto& tensor = kv.second;
 
         size_t expected_content_size = DataTypeSize(tensor.dtype());
         for (int i = 0; i < tensor.tensor_shape().dim_size(); i++) {
@@ -57,74 +384,81 @@ Status makeJsonFromPredictResponse(
             return StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE;
         }
 
-        switch (tensor.dtype()) {
-        case DataType::DT_FLOAT:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(float)) {
-                tensor.add_float_val(*reinterpret_cast<float*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_DOUBLE:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(double)) {
-                tensor.add_double_val(*reinterpret_cast<double*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT32:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int32_t)) {
-                tensor.add_int_val(*reinterpret_cast<int32_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT16:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int16_t)) {
-                tensor.add_int_val(*reinterpret_cast<int16_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT8:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int8_t)) {
-                tensor.add_int_val(*reinterpret_cast<int8_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_UINT8:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(uint8_t)) {
-                tensor.add_int_val(*reinterpret_cast<uint8_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_INT64:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(int64_t)) {
-                tensor.add_int64_val(*reinterpret_cast<int64_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_UINT32:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(uint32_t)) {
-                tensor.add_uint32_val(*reinterpret_cast<uint32_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        case DataType::DT_UINT64:
-            for (size_t i = 0; i < tensor.tensor_content().size(); i += sizeof(uint64_t)) {
-                tensor.add_uint64_val(*reinterpret_cast<uint64_t*>(tensor.mutable_tensor_content()->data() + i));
-            }
-            break;
-        default:
+        if (!isSupportedPrecision(tensor.dtype())) {
             return StatusCode::REST_UNSUPPORTED_PRECISION;
         }
     }
 
-    timer.stop("convert");
-    timer.start("MakeJsonFromTensors");
+    if (response_proto.outputs().empty()) {
+        SPDLOG_ERROR("Creating json from tensors failed: no outputs in response");
+        return StatusCode::REST_PROTO_TO_STRING_ERROR;
+    }
 
-    const auto& tf_status = MakeJsonFromTensors(
-        response_proto.outputs(),
-        order == Order::ROW ? JsonPredictRequestFormat::kRow : JsonPredictRequestFormat::kColumnar,
-        response_json);
+    batchSize = 0;
+    if (order == Order::ROW) {
+        return validateOutputsForRowOrder(response_proto, batchSize);
+    }
+    return StatusCode::OK;
+}
 
-    timer.stop("MakeJsonFromTensors");
-    SPDLOG_DEBUG("tensor_content to *_val container conversion: {:.3f} ms", timer.elapsed<microseconds>("convert") / 1000);
-    SPDLOG_DEBUG("MakeJsonFromTensors call: {:.3f} ms", timer.elapsed<microseconds>("MakeJsonFromTensors") / 1000);
+// Values are formatted straight from tensor_content, without filling *_val containers first
+template <typename OutputStream>
+void writeJson(OutputStream& stream, const PredictResponse& response_proto, Order order, int64_t batchSize) {
+    rapidjson::PrettyWriter<OutputStream> writer(stream);
+    writer.StartObject();
+    if (order == Order::ROW) {
+        writeRowOrder(writer, response_proto, batchSize);
+    } else {
+        writeColumnOrder(writer, response_proto);
+    }
+    writer.EndObject();
+}
 
-    if (!tf_status.ok()) {
-        SPDLOG_ERROR("Creating json from tensors failed: {}", tf_status.error_message());
-        return StatusCode::REST_PROTO_TO_STRING_ERROR;
+}  // namespace
+
+Status makeJsonFromPredictResponse(
+    const PredictResponse& response_proto,
+    std::string* response_json,
+    Order order) {
+    int64_t batchSize;
+    auto status = validateOutputs(response_proto, order, batchSize);
+    if (!status.ok()) {
+        return status;
     }
 
+    Timer timer;
+    using std::chrono::microseconds;
+
+    timer.start("MakeJson");
+    rapidjson::StringBuffer buffer;
+    writeJson(buffer, response_proto, order, batchSize);
+    response_json->assign(buffer.GetString(), buffer.GetSize());
+    timer.stop("MakeJson");
+    SPDLOG_DEBUG("Creating json from tensor_content: {:.3f} ms", timer.elapsed<microseconds>("MakeJson") / 1000);
+
+    return StatusCode::OK;
+}
+
+Status makeJsonFromPredictResponse(
+    const PredictResponse& response_proto,
+    const ResponseChunkWriter& writeChunk,
+    Order order) {
+    int64_t batchSize;
+    auto status = validateOutputs(response_proto, order, batchSize);
+    if (!status.ok()) {
+        return status;
+    }
+
+    Timer timer;
+    using std::chrono::microseconds;
+
+    timer.start("MakeJson");
+    ResponseChunkStream stream(writeChunk);
+    writeJson(stream, response_proto, order, batchSize);
+    stream.Flush();
+    timer.stop("MakeJson");
+    SPDLOG_DEBUG("Writing json from tensor_content in chunks: {:.3f} ms", timer.elapsed<microseconds>("MakeJson") / 1000);
+
     return StatusCode::OK;
 }
 }  // namespace ovms
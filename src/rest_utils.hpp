@@ -15,6 +15,7 @@
 //*****************************************************************************
 #pragma once
 
+#include <functional>
 #include <string>
 
 #pragma GCC diagnostic push
@@ -26,8 +27,22 @@
 #include "status.hpp"
 
 namespace ovms {
+/**
+ * @brief Receives consecutive parts of serialized response
+ */
+using ResponseChunkWriter = std::function<void(const char* data, size_t size)>;
+
 Status makeJsonFromPredictResponse(
-    tensorflow::serving::PredictResponse& response_proto,
+    const tensorflow::serving::PredictResponse& response_proto,
     std::string* response_json,
     Order order);
+
+/**
+ * @brief Serializes response in chunks passed to writer as soon as they are filled,
+ * so that whole JSON is never buffered in memory. Nothing is written when status is not OK.
+ */
+Status makeJsonFromPredictResponse(
+    const tensorflow::serving::PredictResponse& response_proto,
+    const ResponseChunkWriter& writeChunk,
+    Order order);
 }  // namespace ovms
@@ -0,0 +1,199 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "resultcache.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "xxhash.hpp"
+
+namespace ovms {
+
+namespace {
+bool isSameTensor(const tensorflow::TensorProto& lhs, const tensorflow::TensorProto& rhs) {
+    if (lhs.dtype() != rhs.dtype() || lhs.tensor_shape().dim_size() != rhs.tensor_shape().dim_size()) {
+        return false;
+    }
+    for (int i = 0; i < lhs.tensor_shape().dim_size(); i++) {
+        if (lhs.tensor_shape().dim(i).size() != rhs.tensor_shape().dim(i).size()) {
+            return false;
+        }
+    }
+    return lhs.tensor_content() == rhs.tensor_content();
+}
+
+bool isSameInputs(const google::protobuf::Map<std::string, tensorflow::TensorProto>& cached,
+    const google::protobuf::Map<std::string, tensorflow::TensorProto>& requested) {
+    if (cached.size() != requested.size()) {
+        return false;
+    }
+    for (const auto& [name, tensor] : requested) {
+        auto it = cached.find(name);
+        if (it == cached.end() || !isSameTensor(it->second, tensor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// filter limits outputs of response, order and repetitions of names do not change it
+std::vector<std::string> getSortedOutputFilter(const tensorflow::serving::PredictRequest& request) {
+    std::vector<std::string> outputFilter(request.output_filter().begin(), request.output_filter().end());
+    std::sort(outputFilter.begin(), outputFilter.end());
+    outputFilter.erase(std::unique(outputFilter.begin(), outputFilter.end()), outputFilter.end());
+    return outputFilter;
+}
+}  // namespace
+
+ResultCache::ResultCache(size_t maxSizeBytes, std::chrono::microseconds timeToLive) :
+    maxSizeBytes(maxSizeBytes),
+    timeToLive(timeToLive) {}
+
+size_t ResultCache::getSizeBytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return sizeBytes;
+}
+
+size_t ResultCache::getEntriesCount() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries.size();
+}
+
+bool ResultCache::computeKey(model_version_t version, const tensorflow::serving::PredictRequest& request, uint64_t& key) {
+    if (request.inputs().empty()) {
+        return false;
+    }
+    // protobuf map iteration order is not defined
+    std::vector<const std::string*> names;
+    names.reserve(request.inputs().size());
+    for (const auto& [name, tensor] : request.inputs()) {
+        if (tensor.tensor_content().empty()) {
+            return false;
+        }
+        names.push_back(&name);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+
+    XXHash64 hash;
+    hash.update(&version, sizeof(version));
+    for (const auto* name : names) {
+        const auto& tensor = request.inputs().at(*name);
+        hash.updateString(*name);
+        const int32_t dtype = tensor.dtype();
+        hash.update(&dtype, sizeof(dtype));
+        const int32_t dimsCount = tensor.tensor_shape().dim_size();
+        hash.update(&dimsCount, sizeof(dimsCount));
+        for (const auto& dim : tensor.tensor_shape().dim()) {
+            const int64_t size = dim.size();
+            hash.update(&size, sizeof(size));
+        }
+        hash.updateString(tensor.tensor_content());
+    }
+    const auto outputFilter = getSortedOutputFilter(request);
+    const uint64_t outputFilterSize = outputFilter.size();
+    hash.update(&outputFilterSize, sizeof(outputFilterSize));
+    for (const auto& name : outputFilter) {
+        hash.updateString(name);
+    }
+    key = hash.digest();
+    return true;
+}
+
+void ResultCache::erase(std::list<Entry>::iterator entry) {
+    sizeBytes -= entry->sizeBytes;
+    index.erase(entry->key);
+    entries.erase(entry);
+}
+
+bool ResultCache::lookup(model_version_t version, uint64_t key, const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse& response) {
+    std::shared_ptr<const inputs_map_t> inputs;
+    std::shared_ptr<const tensorflow::serving::PredictResponse> cachedResponse;
+    const auto outputFilter = getSortedOutputFilter(request);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return false;
+        }
+        auto entry = it->second;
+        if (timeToLive.count() > 0 && entry->expiration <= std::chrono::steady_clock::now()) {
+            erase(entry);
+            return false;
+        }
+        if (entry->version != version || entry->outputFilter != outputFilter) {
+            return false;
+        }
+        entries.splice(entries.begin(), entries, entry);
+        inputs = entry->inputs;
+        cachedResponse = entry->response;
+    }
+    // comparing and copying large tensors does not block other requests
+    if (!isSameInputs(*inputs, request.inputs())) {
+        SPDLOG_DEBUG("Result cache key collision for model: {}; version: {}", request.model_spec().name(), version);
+        return false;
+    }
+    response = *cachedResponse;
+    return true;
+}
+
+void ResultCache::insert(model_version_t version, uint64_t key, const tensorflow::serving::PredictRequest& request, const tensorflow::serving::PredictResponse& response) {
+    const size_t entrySizeBytes = request.ByteSizeLong() + response.ByteSizeLong();
+    if (entrySizeBytes > maxSizeBytes) {
+        SPDLOG_DEBUG("Response of model: {}; version: {} of size: {} exceeds result cache size", request.model_spec().name(), version, entrySizeBytes);
+        return;
+    }
+    // copies are made before taking the lock
+    auto inputs = std::make_shared<const inputs_map_t>(request.inputs());
+    auto cachedResponse = std::make_shared<const tensorflow::serving::PredictResponse>(response);
+    auto outputFilter = getSortedOutputFilter(request);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        erase(it->second);
+    }
+    while (!entries.empty() && sizeBytes + entrySizeBytes > maxSizeBytes) {
+        erase(std::prev(entries.end()));
+    }
+    entries.push_front(Entry{key, version, std::move(inputs), std::move(outputFilter), std::move(cachedResponse),
+        std::chrono::steady_clock::now() + timeToLive, entrySizeBytes});
+    index[key] = entries.begin();
+    sizeBytes += entrySizeBytes;
+}
+
+void ResultCache::invalidate(model_version_t version) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto next = std::next(it);
+        if (it->version == version) {
+            erase(it);
+        }
+        it = next;
+    }
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    entries.clear();
+    index.clear();
+    sizeBytes = 0;
+}
+
+}  // namespace ovms
@@ -0,0 +1,112 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "model_version_policy.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Cache of predict responses of a model, so that repeated identical requests are answered without inference
+ *
+ * Entries are keyed by xxHash of model version, request inputs and output filter. Requests are cached only when all inputs are
+ * sent in tensor_content. Inputs and output filter of the cached request are kept with the entry and compared on lookup, so hash
+ * collisions never return response of another request. Least recently used entries are dropped when total size of
+ * requests and responses exceeds the limit, entries older than time to live are not returned.
+ */
+class ResultCache {
+    using inputs_map_t = google::protobuf::Map<std::string, tensorflow::TensorProto>;
+
+    struct Entry {
+        uint64_t key;
+        model_version_t version;
+        std::shared_ptr<const inputs_map_t> inputs;
+        std::vector<std::string> outputFilter;
+        std::shared_ptr<const tensorflow::serving::PredictResponse> response;
+        std::chrono::steady_clock::time_point expiration;
+        size_t sizeBytes;
+    };
+
+    const size_t maxSizeBytes;
+    const std::chrono::microseconds timeToLive;
+
+    mutable std::mutex mtx;
+    // most recently used entries first
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    size_t sizeBytes = 0;
+
+    void erase(std::list<Entry>::iterator entry);
+
+public:
+    /**
+     * @param maxSizeBytes
+     * @param timeToLive 0 for entries which do not expire
+     */
+    ResultCache(size_t maxSizeBytes, std::chrono::microseconds timeToLive);
+
+    size_t getMaxSizeBytes() const { return maxSizeBytes; }
+    std::chrono::microseconds getTimeToLive() const { return timeToLive; }
+
+    size_t getSizeBytes() const;
+    size_t getEntriesCount() const;
+
+    /**
+     * @brief Computes key of request, inputs are hashed in order of their names, followed by sorted output filter
+     *
+     * @param version
+     * @param request
+     * @param key
+     *
+     * @return false if request cannot be cached
+     */
+    static bool computeKey(model_version_t version, const tensorflow::serving::PredictRequest& request, uint64_t& key);
+
+    /**
+     * @brief Fills response with cached one
+     *
+     * @return true on cache hit
+     */
+    bool lookup(model_version_t version, uint64_t key, const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse& response);
+
+    /**
+     * @brief Stores response of request, replaces existing entry with the same key
+     */
+    void insert(model_version_t version, uint64_t key, const tensorflow::serving::PredictRequest& request, const tensorflow::serving::PredictResponse& response);
+
+    /**
+     * @brief Drops entries of model version
+     */
+    void invalidate(model_version_t version);
+
+    void clear();
+};
+
+}  // namespace ovms
@@ -25,10 +25,17 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "s3filesystem.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <aws/core/Aws.h>
@@ -40,6 +47,7 @@
 #include <aws/s3/model/ListObjectsRequest.h>
 
 #include "logging.hpp"
+#include "paralleltasks.hpp"
 #include "stringutils.hpp"
 
 namespace ovms {
@@ -49,6 +57,28 @@ namespace fs = std::filesystem;
 
 const std::string S3FileSystem::S3_URL_PREFIX = "s3://";
 
+namespace {
+const char* S3_ALLOCATION_TAG = "ovms_s3";
+
+const uint32_t DEFAULT_S3_DOWNLOAD_THREADS = 8;
+const uint32_t DEFAULT_S3_DOWNLOAD_PART_SIZE_MB = 64;
+
+// Clients keep connections alive, so sharing them between file systems created for every model
+// on every watcher tick avoids TLS handshake with each storage request
+std::shared_ptr<s3::S3Client> getPooledClient(const std::string& key, const std::function<std::shared_ptr<s3::S3Client>()>& create) {
+    static std::mutex clientsMtx;
+    // never destroyed, SDK is not shut down before process exit
+    static auto* clients = new std::map<std::string, std::shared_ptr<s3::S3Client>>();
+    std::lock_guard<std::mutex> lock(clientsMtx);
+    auto& client = (*clients)[key];
+    if (!client) {
+        SPDLOG_LOGGER_DEBUG(s3_logger, "Creating S3 client for endpoint: {}", key.substr(0, key.find('|')));
+        client = create();
+    }
+    return client;
+}
+}  // namespace
+
 StatusCode S3FileSystem::parsePath(const std::string& path, std::string* bucket, std::string* object) {
     std::smatch sm;
 
@@ -86,7 +116,9 @@ S3FileSystem::S3FileSystem(const Aws::SDKOptions& options, const std::string& s3
     options_(options),
     s3_regex_(S3_URL_PREFIX + "([0-9a-zA-Z-.]+):([0-9]+)/([0-9a-z.-]+)(((/"
                               "[0-9a-zA-Z.-_]+)*)?)"),
-    proxy_regex_("^(https?)://(([^:]{1,128}):([^@]{1,256})@)?([^:/]{1,255})(:([0-9]{1,5}))?/?") {
+    proxy_regex_("^(https?)://(([^:]{1,128}):([^@]{1,256})@)?([^:/]{1,255})(:([0-9]{1,5}))?/?"),
+    download_threads_(getPositiveEnvValue("S3_DOWNLOAD_THREADS", DEFAULT_S3_DOWNLOAD_THREADS)),
+    download_part_size_(uint64_t(getPositiveEnvValue("S3_DOWNLOAD_PART_SIZE_MB", DEFAULT_S3_DOWNLOAD_PART_SIZE_MB)) * 1024 * 1024) {
     Aws::Client::ClientConfiguration config;
     Aws::Auth::AWSCredentials credentials;
 
@@ -94,6 +126,7 @@ S3FileSystem::S3FileSystem(const Aws::SDKOptions& options, const std::string& s3
     const char* key_id = std::getenv("AWS_ACCESS_KEY_ID");
     const char* region = std::getenv("AWS_REGION");
     const char* s3_endpoint = std::getenv("S3_ENDPOINT");
+    const char* profile = std::getenv("AWS_PROFILE");
     const char* http_proxy = std::getenv("http_proxy") != nullptr ? std::getenv("http_proxy") : std::getenv("HTTP_PROXY");
     const char* https_proxy = std::getenv("https_proxy") != nullptr ? std::getenv("https_proxy") : std::getenv("HTTPS_PROXY");
     const std::string default_proxy = https_proxy != nullptr ? std::string(https_proxy) : http_proxy != nullptr ? std::string(http_proxy) : "";
@@ -105,8 +138,8 @@ S3FileSystem::S3FileSystem(const Aws::SDKOptions& options, const std::string& s3
         if (region != NULL) {
             config.region = region;
         }
-    } else if (const char* profile_name = std::getenv("AWS_PROFILE")) {
-        config = Aws::Client::ClientConfiguration(profile_name);
+    } else if (profile != nullptr) {
+        config = Aws::Client::ClientConfiguration(profile);
     } else {
         config = Aws::Client::ClientConfiguration("default");
     }
@@ -147,23 +180,27 @@ S3FileSystem::S3FileSystem(const Aws::SDKOptions& options, const std::string& s3
         }
     }
 
-    if ((secret_key != NULL) && (key_id != NULL)) {
-        client_ = s3::S3Client(
-            credentials,
-            config,
-            Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
-            false);
-    } else {
-        client_ = s3::S3Client(
+    const bool useCredentials = (secret_key != NULL) && (key_id != NULL);
+    const std::string clientKey = std::string(config.endpointOverride.c_str()) + "|" +
+                                  (config.scheme == Aws::Http::Scheme::HTTP ? "http" : "https") + "|" +
+                                  config.region.c_str() + "|" + (profile != nullptr ? profile : "") + "|" + default_proxy + "|" +
+                                  (useCredentials ? std::string(key_id) + "|" + secret_key : std::string());
+    client_ = getPooledClient(clientKey, [&]() {
+        if (useCredentials) {
+            return std::make_shared<s3::S3Client>(
+                credentials,
+                config,
+                Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
+                false);
+        }
+        return std::make_shared<s3::S3Client>(
             config,
             Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
             false);
-    }
+    });
 }
 
-S3FileSystem::~S3FileSystem() {
-    Aws::ShutdownAPI(options_);
-}
+S3FileSystem::~S3FileSystem() {}
 
 StatusCode S3FileSystem::fileExists(const std::string& path, bool* exists) {
     *exists = false;
@@ -178,7 +215,7 @@ StatusCode S3FileSystem::fileExists(const std::string& path, bool* exists) {
     head_request.SetBucket(bucket.c_str());
     head_request.SetKey(object.c_str());
 
-    auto head_object_outcome = client_.HeadObject(head_request);
+    auto head_object_outcome = client_->HeadObject(head_request);
     if (head_object_outcome.IsSuccess()) {
         *exists = true;
         return StatusCode::OK;
@@ -206,7 +243,7 @@ StatusCode S3FileSystem::isDirectory(const std::string& path, bool* is_dir) {
     s3::Model::HeadBucketRequest head_request;
     head_request.WithBucket(bucket.c_str());
 
-    auto head_bucket_outcome = client_.HeadBucket(head_request);
+    auto head_bucket_outcome = client_->HeadBucket(head_request);
     if (!head_bucket_outcome.IsSuccess()) {
         SPDLOG_LOGGER_ERROR(s3_logger, "Couldn't get MetaData for bucket with name {}", bucket);
         SPDLOG_LOGGER_ERROR(s3_logger, "{}", head_bucket_outcome.GetError().GetMessage());
@@ -223,7 +260,7 @@ StatusCode S3FileSystem::isDirectory(const std::string& path, bool* is_dir) {
     s3::Model::ListObjectsRequest list_objects_request;
     list_objects_request.SetBucket(bucket.c_str());
     list_objects_request.SetPrefix(appendSlash(object_path).c_str());
-    auto list_objects_outcome = client_.ListObjects(list_objects_request);
+    auto list_objects_outcome = client_->ListObjects(list_objects_request);
 
     if (list_objects_outcome.IsSuccess()) {
         *is_dir = !list_objects_outcome.GetResult().GetContents().empty();
@@ -251,7 +288,7 @@ StatusCode S3FileSystem::getDirectoryContents(const std::string& path, std::set<
     s3::Model::ListObjectsRequest objects_request;
     objects_request.SetBucket(bucket.c_str());
     objects_request.SetPrefix(full_dir.c_str());
-    auto list_objects_outcome = client_.ListObjects(objects_request);
+    auto list_objects_outcome = client_->ListObjects(objects_request);
 
     if (list_objects_outcome.IsSuccess()) {
         Aws::Vector<Aws::S3::Model::Object> object_list = list_objects_outcome.GetResult().GetContents();
@@ -278,6 +315,40 @@ StatusCode S3FileSystem::getDirectoryContents(const std::string& path, std::set<
     return StatusCode::OK;
 }
 
+StatusCode S3FileSystem::getDirectoryChangeToken(const std::string& path, std::string* token) {
+    std::string bucket, dir_path;
+    auto status = parsePath(path, &bucket, &dir_path);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    std::string full_dir = appendSlash(dir_path);
+
+    // S3 has no directory modification time, single flat listing covers all versions and their files
+    uint64_t hash = FNV_OFFSET_BASIS;
+    s3::Model::ListObjectsRequest objects_request;
+    objects_request.SetBucket(bucket.c_str());
+    objects_request.SetPrefix(full_dir.c_str());
+    while (true) {
+        auto list_objects_outcome = client_->ListObjects(objects_request);
+        if (!list_objects_outcome.IsSuccess()) {
+            SPDLOG_LOGGER_ERROR(s3_logger, "Could not list contents of directory {}", path);
+            return StatusCode::S3_INVALID_ACCESS;
+        }
+        const auto& result = list_objects_outcome.GetResult();
+        for (auto const& s3_object : result.GetContents()) {
+            hashString(hash, s3_object.GetKey().c_str());
+            hashString(hash, s3_object.GetETag().c_str());
+            hashString(hash, std::to_string(s3_object.GetSize()));
+        }
+        if (!result.GetIsTruncated() || result.GetContents().empty()) {
+            break;
+        }
+        objects_request.SetMarker(result.GetContents().back().GetKey());
+    }
+    *token = std::to_string(hash);
+    return StatusCode::OK;
+}
+
 StatusCode S3FileSystem::getDirectorySubdirs(const std::string& path, std::set<std::string>* subdirs) {
     // Parse bucket and dir_path
     std::string bucket, dir_path;
@@ -362,17 +433,13 @@ StatusCode S3FileSystem::readTextFile(const std::string& path, std::string* cont
     object_request.SetBucket(bucket.c_str());
     object_request.SetKey(object.c_str());
 
-    auto get_object_outcome = client_.GetObject(object_request);
+    auto get_object_outcome = client_->GetObject(object_request);
     if (get_object_outcome.IsSuccess()) {
         auto& object_result = get_object_outcome.GetResultWithOwnership().GetBody();
 
-        std::string data = "";
-        char c = 0;
-        while (object_result.get(c)) {
-            data += c;
-        }
-
-        *contents = data;
+        // read in bulk through stream buffer, model weights read into memory take hundreds of megabytes
+        std::string data((std::istreambuf_iterator<char>(object_result)), std::istreambuf_iterator<char>());
+        *contents = std::move(data);
     } else {
         SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}", path);
         return StatusCode::S3_FILE_INVALID;
@@ -381,7 +448,7 @@ StatusCode S3FileSystem::readTextFile(const std::string& path, std::string* cont
     return StatusCode::OK;
 }
 
-StatusCode S3FileSystem::downloadFileFolder(const std::string& path, const std::string& local_path) {
+StatusCode S3FileSystem::collectFilesToDownload(const std::string& path, const std::string& local_path, files_to_download_t* files_to_download) {
     bool exists;
     auto status = fileExists(path, &exists);
     if (status != StatusCode::OK) {
@@ -411,99 +478,169 @@ StatusCode S3FileSystem::downloadFileFolder(const std::string& path, const std::
     if (status != StatusCode::OK) {
         return status;
     }
-    if (is_dir) {
-        status = getDirectoryContents(effective_path, &contents);
+    if (!is_dir) {
+        files_to_download->emplace_back(effective_path, local_path);
+        return StatusCode::OK;
+    }
+
+    status = getDirectoryContents(effective_path, &contents);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+
+    for (auto iter = contents.begin(); iter != contents.end(); ++iter) {
+        bool is_subdir;
+        std::string s3_fpath = joinPath({effective_path, *iter});
+        std::string local_fpath = joinPath({local_path, *iter});
+        status = isDirectory(s3_fpath, &is_subdir);
         if (status != StatusCode::OK) {
             return status;
         }
+        if (is_subdir) {
+            // Create local mirror of sub-directories
+            int status = mkdir(const_cast<char*>(local_fpath.c_str()), S_IRUSR | S_IWUSR | S_IXUSR);
+            if (status == -1) {
+                SPDLOG_LOGGER_ERROR(s3_logger, "Failed to create local folder: {} {} ", local_fpath, strerror(errno));
+                return StatusCode::PATH_INVALID;
+            }
 
-        for (auto iter = contents.begin(); iter != contents.end(); ++iter) {
-            bool is_subdir;
-            std::string s3_fpath = joinPath({effective_path, *iter});
-            std::string local_fpath = joinPath({local_path, *iter});
-            status = isDirectory(s3_fpath, &is_subdir);
-            if (status != StatusCode::OK) {
-                return status;
+            // Add with s3 path
+            std::set<std::string> subdir_files;
+            auto s = getDirectoryFiles(s3_fpath, &subdir_files);
+            if (s != StatusCode::OK) {
+                return s;
             }
-            if (is_subdir) {
-                // Create local mirror of sub-directories
-                int status = mkdir(const_cast<char*>(local_fpath.c_str()), S_IRUSR | S_IWUSR | S_IXUSR);
-                if (status == -1) {
-                    SPDLOG_LOGGER_ERROR(s3_logger, "Failed to create local folder: {} {} ", local_fpath, strerror(errno));
-                    return StatusCode::PATH_INVALID;
-                }
-
-                // Add with s3 path
-                std::set<std::string> subdir_files;
-                auto s = getDirectoryFiles(s3_fpath, &subdir_files);
-                if (s != StatusCode::OK) {
-                    return s;
-                }
-                for (auto itr = subdir_files.begin(); itr != subdir_files.end(); ++itr) {
-                    files.insert(joinPath({s3_fpath, *itr}));
-                }
-            } else {
-                files.insert(s3_fpath);
+            for (auto itr = subdir_files.begin(); itr != subdir_files.end(); ++itr) {
+                files.insert(joinPath({s3_fpath, *itr}));
             }
+        } else {
+            files.insert(s3_fpath);
         }
+    }
 
-        for (auto iter = files.begin(); iter != files.end(); ++iter) {
-            if (std::any_of(acceptedFiles.begin(), acceptedFiles.end(), [&iter](const std::string& x) {
-                    return iter->size() > 0 && endsWith(*iter, x);
-                })) {
-                std::string bucket, object;
-                status = parsePath(*iter, &bucket, &object);
-                if (status != StatusCode::OK) {
-                    return status;
-                }
-
-                // Send a request for the objects metadata
-                s3::Model::GetObjectRequest object_request;
-                object_request.SetBucket(bucket.c_str());
-                object_request.SetKey(object.c_str());
-
-                auto get_object_outcome = client_.GetObject(object_request);
-                if (get_object_outcome.IsSuccess()) {
-                    auto& retrieved_file =
-                        get_object_outcome.GetResultWithOwnership().GetBody();
-                    std::string s3_removed_path = (*iter).substr(effective_path.size());
-                    std::string local_file_path = joinPath({local_path, s3_removed_path});
-                    std::ofstream output_file(local_file_path.c_str(), std::ios::binary);
-                    output_file << retrieved_file.rdbuf();
-                    output_file.close();
-                } else {
-                    SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}", *iter);
-                    return StatusCode::S3_FAILED_GET_OBJECT;
-                }
-            }
+    for (auto iter = files.begin(); iter != files.end(); ++iter) {
+        if (std::any_of(acceptedFiles.begin(), acceptedFiles.end(), [&iter](const std::string& x) {
+                return iter->size() > 0 && endsWith(*iter, x);
+            })) {
+            std::string s3_removed_path = (*iter).substr(effective_path.size());
+            files_to_download->emplace_back(*iter, joinPath({local_path, s3_removed_path}));
         }
-    } else {
+    }
+
+    return StatusCode::OK;
+}
+
+StatusCode S3FileSystem::downloadFiles(const files_to_download_t& files_to_download) {
+    struct ObjectPart {
+        std::string bucket;
+        std::string object;
+        std::string local_file_path;
+        uint64_t offset;
+        uint64_t size;
+        bool ranged;
+    };
+    std::vector<ObjectPart> parts;
+    std::vector<std::pair<std::string, std::string>> files_to_cache;
+    DownloadDeduplicator deduplicator;
+
+    for (const auto& [s3_file_path, local_file_path] : files_to_download) {
         std::string bucket, object;
-        auto s = parsePath(effective_path, &bucket, &object);
-        if (s != StatusCode::OK) {
-            return s;
+        auto status = parsePath(s3_file_path, &bucket, &object);
+        if (status != StatusCode::OK) {
+            return status;
         }
 
-        // Send a request for the objects metadata
-        s3::Model::GetObjectRequest object_request;
-        object_request.SetBucket(bucket.c_str());
-        object_request.SetKey(object.c_str());
-
-        auto get_object_outcome = client_.GetObject(object_request);
-        if (get_object_outcome.IsSuccess()) {
-            auto& retrieved_file = get_object_outcome.GetResultWithOwnership().GetBody();
-            std::ofstream output_file(local_path.c_str(), std::ios::binary);
-            output_file << retrieved_file.rdbuf();
-            output_file.close();
-        } else {
-            SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}", effective_path);
+        s3::Model::HeadObjectRequest head_request;
+        head_request.SetBucket(bucket.c_str());
+        head_request.SetKey(object.c_str());
+        auto head_object_outcome = client_->HeadObject(head_request);
+        if (!head_object_outcome.IsSuccess()) {
+            SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object metadata at {}", s3_file_path);
             return StatusCode::S3_FAILED_GET_OBJECT;
         }
+        const uint64_t object_size = head_object_outcome.GetResult().GetContentLength();
+
+        // ETag is derived from object content
+        auto key = DownloadCache::createKey({"s3", head_object_outcome.GetResult().GetETag().c_str(), std::to_string(object_size)});
+        if (downloadCache && downloadCache->restore(key, local_file_path)) {
+            continue;
+        }
+        if (deduplicator.isDuplicate(key, local_file_path)) {
+            continue;
+        }
+        if (downloadCache) {
+            files_to_cache.emplace_back(key, local_file_path);
+        }
+
+        status = createLocalFile(local_file_path, object_size);
+        if (status != StatusCode::OK) {
+            return status;
+        }
+
+        const bool ranged = object_size > download_part_size_;
+        for (uint64_t offset = 0; offset < object_size; offset += download_part_size_) {
+            parts.push_back({bucket, object, local_file_path, offset, std::min(download_part_size_, object_size - offset), ranged});
+        }
     }
 
+    SPDLOG_LOGGER_DEBUG(s3_logger, "Downloading {} files in {} parts using up to {} threads", files_to_download.size(), parts.size(), download_threads_);
+    std::vector<StatusCode> statuses(parts.size(), StatusCode::OK);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < parts.size(); i++) {
+        tasks.emplace_back([this, &part = parts[i], &status = statuses[i]]() {
+            s3::Model::GetObjectRequest object_request;
+            object_request.SetBucket(part.bucket.c_str());
+            object_request.SetKey(part.object.c_str());
+            if (part.ranged) {
+                object_request.SetRange(("bytes=" + std::to_string(part.offset) + "-" + std::to_string(part.offset + part.size - 1)).c_str());
+            }
+            // Response body is streamed straight to its place in the target file
+            object_request.SetResponseStreamFactory([&part]() {
+                auto* stream = Aws::New<Aws::FStream>(S3_ALLOCATION_TAG, part.local_file_path.c_str(), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+                stream->seekp(part.offset);
+                return stream;
+            });
+
+            auto get_object_outcome = client_->GetObject(object_request);
+            if (!get_object_outcome.IsSuccess() ||
+                static_cast<uint64_t>(get_object_outcome.GetResult().GetContentLength()) != part.size) {
+                SPDLOG_LOGGER_ERROR(s3_logger, "Failed to get object at {}/{} bytes {}-{}", part.bucket, part.object, part.offset, part.offset + part.size);
+                status = StatusCode::S3_FAILED_GET_OBJECT;
+                return;
+            }
+            auto& body = get_object_outcome.GetResult().GetBody();
+            body.flush();
+            if (!body) {
+                SPDLOG_LOGGER_ERROR(s3_logger, "Failed to write local file: {}", part.local_file_path);
+                status = StatusCode::S3_FAILED_GET_OBJECT;
+            }
+        });
+    }
+    executeInParallel(tasks, download_threads_);
+
+    for (const auto& status : statuses) {
+        if (status != StatusCode::OK) {
+            return status;
+        }
+    }
+    if (!deduplicator.linkDuplicates()) {
+        return StatusCode::FILESYSTEM_ERROR;
+    }
+    for (const auto& [key, local_file_path] : files_to_cache) {
+        downloadCache->store(key, local_file_path);
+    }
     return StatusCode::OK;
 }
 
+StatusCode S3FileSystem::downloadFileFolder(const std::string& path, const std::string& local_path) {
+    files_to_download_t files_to_download;
+    auto status = collectFilesToDownload(path, local_path, &files_to_download);
+    if (status != StatusCode::OK) {
+        return status;
+    }
+    return downloadFiles(files_to_download);
+}
+
 StatusCode S3FileSystem::downloadModelVersions(const std::string& path,
     std::string* local_path,
     const std::vector<model_version_t>& versions) {
@@ -513,7 +650,9 @@ StatusCode S3FileSystem::downloadModelVersions(const std::string& path,
         return sc;
     }
 
+    // Files of all versions are downloaded together so that parallelism is not limited to a single version
     StatusCode result = StatusCode::OK;
+    files_to_download_t files_to_download;
     for (auto& ver : versions) {
         std::string versionpath = path;
         if (!endsWith(versionpath, "/")) {
@@ -526,13 +665,19 @@ StatusCode S3FileSystem::downloadModelVersions(const std::string& path,
         }
         lpath.append(std::to_string(ver));
         fs::create_directory(lpath);
-        auto status = downloadFileFolder(versionpath, lpath);
+        auto status = collectFilesToDownload(versionpath, lpath, &files_to_download);
         if (status != StatusCode::OK) {
             result = status;
             SPDLOG_LOGGER_ERROR(s3_logger, "Failed to download model version {}", versionpath);
         }
     }
 
+    auto status = downloadFiles(files_to_download);
+    if (status != StatusCode::OK) {
+        result = status;
+        SPDLOG_LOGGER_ERROR(s3_logger, "Failed to download model versions from {}", path);
+    }
+
     return result;
 }
 
@@ -15,8 +15,10 @@
 //*****************************************************************************
 #pragma once
 
+#include <memory>
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <aws/core/Aws.h>
@@ -70,6 +72,15 @@ public:
      */
     StatusCode getDirectoryContents(const std::string& path, files_list_t* contents) override;
 
+    /**
+     * @brief Get a token changing whenever any object under given directory changes
+     * 
+     * @param path 
+     * @param token 
+     * @return StatusCode 
+     */
+    StatusCode getDirectoryChangeToken(const std::string& path, std::string* token) override;
+
     /**
      * @brief Get only directories in given directory
      * 
@@ -138,18 +149,50 @@ private:
     StatusCode parsePath(const std::string& path, std::string* bucket, std::string* object);
 
     /**
-     * @brief 
+     * @brief Pairs of remote file path and local file path
+     */
+    using files_to_download_t = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * @brief Lists accepted files of remote file or directory and creates local mirror of its sub-directories
      * 
+     * @param path 
+     * @param local_path 
+     * @param files_to_download 
+     * @return StatusCode 
      */
-    Aws::SDKOptions options_;
+    StatusCode collectFilesToDownload(const std::string& path, const std::string& local_path, files_to_download_t* files_to_download);
+
+    /**
+     * @brief Downloads files concurrently, objects larger than download part size are fetched with ranged requests in parallel
+     * 
+     * @param files_to_download 
+     * @return StatusCode 
+     */
+    StatusCode downloadFiles(const files_to_download_t& files_to_download);
 
     /**
      * @brief 
      * 
      */
-    Aws::S3::S3Client client_;
+    Aws::SDKOptions options_;
+
+    /**
+     * @brief Client shared by file systems with the same endpoint and credentials
+     */
+    std::shared_ptr<Aws::S3::S3Client> client_;
     std::regex s3_regex_;
     std::regex proxy_regex_;
+
+    /**
+     * @brief Maximum number of concurrent GET requests, set with S3_DOWNLOAD_THREADS
+     */
+    size_t download_threads_;
+
+    /**
+     * @brief Size in bytes of object ranges downloaded in parallel, set with S3_DOWNLOAD_PART_SIZE_MB
+     */
+    uint64_t download_part_size_;
 };
 
 }  // namespace ovms
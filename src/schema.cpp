@@ -73,9 +73,148 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 						"shape": {
 							"type": ["object", "string"]
 						},
+						"shape_buckets": {
+							"type": "object",
+							"additionalProperties": {
+								"type": "array",
+								"items": {
+									"type": "array",
+									"items": {
+										"type": "integer",
+										"minimum": 1
+									},
+									"minItems": 1
+								},
+								"minItems": 1
+							}
+						},
 						"nireq": {
 							"type": "integer"
 						},
+						"max_nireq": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"latency_nireq": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"auto_tune": {
+							"type": "boolean"
+						},
+						"auto_tune_latency_ms": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"readiness_max_waiting_requests": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"readiness_max_queue_wait_ms": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"max_batch_size": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"batch_timeout_microseconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"batch_latency_slo_microseconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"split_batch": {
+							"type": "boolean"
+						},
+						"reuse_input_blobs": {
+							"type": "boolean"
+						},
+						"hugepages_io_blobs": {
+							"type": "boolean"
+						},
+						"remote_io_blobs": {
+							"type": "boolean"
+						},
+						"lean_memory": {
+							"type": "boolean"
+						},
+						"download_to_memory": {
+							"type": "boolean"
+						},
+						"stateful": {
+							"type": "boolean"
+						},
+						"sequence_timeout_seconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"network_cache_size": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"warmup_iterations": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"warmup_data": {
+							"type": "object",
+							"additionalProperties": {
+								"type": "string"
+							}
+						},
+						"numa_node": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"cpu_set": {
+							"type": "string"
+						},
+						"cpu_set_exclusive": {
+							"type": "boolean"
+						},
+						"numa_replicas": {
+							"type": "boolean"
+						},
+						"max_queue_size": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"queue_timeout_microseconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"result_cache_size_mb": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"result_cache_ttl_seconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"in_flight_memory_budget_mb": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"lazy_load": {
+							"type": "boolean"
+						},
+						"fp16_outputs": {
+							"type": "boolean"
+						},
+						"inline_inference": {
+							"type": "boolean"
+						},
+						"completion_spin_microseconds": {
+							"type": "integer",
+							"minimum": 0
+						},
+						"device_scheduling_weight": {
+							"type": "integer",
+							"minimum": 1
+						},
 						"target_device": {
 							"type": "string"
 						},
@@ -134,7 +273,7 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 		},
 		"node_config": {
 			"type": "object",
-			"required": ["name", "model_name", "inputs", "outputs"],
+			"required": ["name", "inputs", "outputs"],
 			"properties": {
 				"name": {
 					"type": "string"
@@ -144,7 +283,7 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 				},
 				"type": {
 					"type": "string",
-					"enum": ["DL model", "Demultiplexer", "Batch dispatcher"]
+					"enum": ["DL model", "Demultiplexer", "Gather", "Preprocessing", "Postprocessing", "Remote model", "Custom", "Gate", "Batch dispatcher"]
 				},
 				"version": {
 					"type": "integer",
@@ -161,6 +300,89 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 					"items": {
 						"$ref": "#/definitions/output_alias"
 					}
+				},
+				"zero_copy_outputs": {
+					"type": "boolean"
+				},
+				"timeout_microseconds": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"crop_width": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"crop_height": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"max_crops": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"confidence_threshold": {
+					"type": "number",
+					"minimum": 0,
+					"maximum": 1
+				},
+				"resize_width": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"resize_height": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"mean": {
+					"type": "array",
+					"items": {
+						"type": "number"
+					}
+				},
+				"scale": {
+					"type": "array",
+					"items": {
+						"type": "number"
+					}
+				},
+				"input_layout": {
+					"type": "string",
+					"enum": ["NCHW", "NHWC"]
+				},
+				"operation": {
+					"type": "string",
+					"enum": ["softmax", "argmax", "top_k", "nms"]
+				},
+				"top_k": {
+					"type": "integer",
+					"minimum": 1
+				},
+				"score_threshold": {
+					"type": "number"
+				},
+				"iou_threshold": {
+					"type": "number",
+					"minimum": 0,
+					"maximum": 1
+				},
+				"comparison": {
+					"type": "string",
+					"enum": ["greater", "less"]
+				},
+				"threshold": {
+					"type": "number"
+				},
+				"address": {
+					"type": "string"
+				},
+				"library_path": {
+					"type": "string"
+				},
+				"params": {
+					"type": "object",
+					"additionalProperties": {
+						"type": "string"
+					}
 				}
 			},
 			"additionalProperties": false
@@ -189,6 +411,24 @@ const char* MODELS_CONFIG_SCHEMA = R"({
 					"items": {
 						"$ref": "#/definitions/source_node"
 					}
+				},
+				"max_batch_size": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"batch_timeout_microseconds": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"fp16_outputs": {
+					"type": "boolean"
+				},
+				"timeout_microseconds": {
+					"type": "integer",
+					"minimum": 0
+				},
+				"fuse_networks": {
+					"type": "boolean"
 				}
 			},
 			"additionalProperties": false
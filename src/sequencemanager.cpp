@@ -0,0 +1,191 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "sequencemanager.hpp"
+
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+namespace {
+bool readSingleValue(const tensorflow::TensorProto& proto, tensorflow::DataType dtype, uint64_t& value) {
+    if (proto.dtype() != dtype) {
+        return false;
+    }
+    if (dtype == tensorflow::DataType::DT_UINT64) {
+        if (proto.uint64_val_size() == 1) {
+            value = proto.uint64_val(0);
+            return true;
+        }
+        if (proto.tensor_content().size() == sizeof(uint64_t)) {
+            value = *reinterpret_cast<const uint64_t*>(proto.tensor_content().data());
+            return true;
+        }
+        return false;
+    }
+    if (proto.uint32_val_size() == 1) {
+        value = proto.uint32_val(0);
+        return true;
+    }
+    if (proto.tensor_content().size() == sizeof(uint32_t)) {
+        value = *reinterpret_cast<const uint32_t*>(proto.tensor_content().data());
+        return true;
+    }
+    return false;
+}
+}  // namespace
+
+Status parseSequenceRequest(const tensorflow::serving::PredictRequest& request, SequenceRequest& result) {
+    auto it = request.inputs().find(SEQUENCE_ID_INPUT);
+    if (it == request.inputs().end() || !readSingleValue(it->second, tensorflow::DataType::DT_UINT64, result.id)) {
+        SPDLOG_DEBUG("Request to stateful model requires {} input with single DT_UINT64 value", SEQUENCE_ID_INPUT);
+        return StatusCode::INVALID_SEQUENCE_ID;
+    }
+    result.control = SequenceControl::NONE;
+    it = request.inputs().find(SEQUENCE_CONTROL_INPUT);
+    if (it == request.inputs().end()) {
+        return StatusCode::OK;
+    }
+    uint64_t control = 0;
+    if (!readSingleValue(it->second, tensorflow::DataType::DT_UINT32, control) || control > static_cast<uint64_t>(SequenceControl::END)) {
+        SPDLOG_DEBUG("Invalid {} input, expected single DT_UINT32 value 0, 1 or 2", SEQUENCE_CONTROL_INPUT);
+        return StatusCode::INVALID_SEQUENCE_CONTROL_INPUT;
+    }
+    result.control = static_cast<SequenceControl>(control);
+    if (result.id == 0 && result.control != SequenceControl::START) {
+        SPDLOG_DEBUG("Sequence id 0 is allowed only in sequence start request");
+        return StatusCode::INVALID_SEQUENCE_ID;
+    }
+    return StatusCode::OK;
+}
+
+size_t getSequenceInputsCount(const tensorflow::serving::PredictRequest& request) {
+    return request.inputs().count(SEQUENCE_ID_INPUT) + request.inputs().count(SEQUENCE_CONTROL_INPUT);
+}
+
+Sequence::Sequence(OVInferRequestsQueue& inferRequestsQueue, std::unique_ptr<ExecutingStreamIdGuard> streamIdGuard) :
+    inferRequestsQueue(inferRequestsQueue),
+    streamIdGuard(std::move(streamIdGuard)) {
+    touch();
+}
+
+Sequence::~Sequence() {
+    // infer request is returned to the pool by stream guard right after, other requests must not see sequence state
+    resetState();
+}
+
+void Sequence::resetState() {
+    try {
+        for (auto& state : getInferRequest().QueryState()) {
+            state.Reset();
+        }
+    } catch (const InferenceEngine::details::InferenceEngineException& e) {
+        SPDLOG_ERROR("Resetting memory states of infer request: {} failed: {}", getStreamId(), e.what());
+    }
+}
+
+Status SequenceManager::startSequence(uint64_t& id, const StreamWaitingOptions& options, std::shared_ptr<Sequence>& sequence) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (id != 0 && sequences.count(id) > 0) {
+            SPDLOG_DEBUG("Sequence: {} is already started", id);
+            return StatusCode::SEQUENCE_ALREADY_EXISTS;
+        }
+        if (sequences.size() >= inferRequestsQueue.getMaxSize()) {
+            SPDLOG_DEBUG("Cannot start sequence, all {} infer requests are held by started sequences", sequences.size());
+            return StatusCode::MAX_SEQUENCE_NUMBER_REACHED;
+        }
+    }
+    // infer request may still be used by sequence which was ended and has request in progress
+    auto streamIdGuard = std::make_unique<ExecutingStreamIdGuard>(inferRequestsQueue, options);
+    if (!streamIdGuard->getStatus().ok()) {
+        return streamIdGuard->getStatus();
+    }
+    auto started = std::make_shared<Sequence>(inferRequestsQueue, std::move(streamIdGuard));
+    // infer request could be used by stateless warm up or previous owner could fail resetting it
+    started->resetState();
+    std::lock_guard<std::mutex> lock(mtx);
+    if (id == 0) {
+        do {
+            id = ++lastGeneratedId;
+        } while (id == 0 || sequences.count(id) > 0);
+    } else if (sequences.count(id) > 0) {
+        SPDLOG_DEBUG("Sequence: {} is already started", id);
+        return StatusCode::SEQUENCE_ALREADY_EXISTS;
+    }
+    sequences.emplace(id, started);
+    sequence = std::move(started);
+    SPDLOG_DEBUG("Started sequence: {} using infer request: {}", id, sequence->getStreamId());
+    return StatusCode::OK;
+}
+
+Status SequenceManager::findSequence(uint64_t id, std::shared_ptr<Sequence>& sequence) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = sequences.find(id);
+    if (it == sequences.end()) {
+        SPDLOG_DEBUG("Sequence: {} does not exist", id);
+        return StatusCode::SEQUENCE_MISSING;
+    }
+    sequence = it->second;
+    return StatusCode::OK;
+}
+
+void SequenceManager::endSequence(uint64_t id) {
+    std::shared_ptr<Sequence> ended;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = sequences.find(id);
+        if (it == sequences.end()) {
+            return;
+        }
+        ended = std::move(it->second);
+        sequences.erase(it);
+    }
+    SPDLOG_DEBUG("Ended sequence: {}", id);
+}
+
+size_t SequenceManager::removeIdleSequences() {
+    if (sequenceTimeout.count() == 0) {
+        return 0;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Sequence>> removed;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto it = sequences.begin(); it != sequences.end();) {
+            std::unique_lock<std::mutex> sequenceLock(it->second->mtx, std::try_to_lock);
+            if (sequenceLock.owns_lock() && now - it->second->getLastUsed() > sequenceTimeout) {
+                SPDLOG_DEBUG("Removing sequence: {} which received no requests for {} seconds", it->first, sequenceTimeout.count());
+                sequenceLock.unlock();
+                removed.push_back(std::move(it->second));
+                it = sequences.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // infer requests are reset and returned outside of the lock
+    return removed.size();
+}
+
+size_t SequenceManager::getSequencesCount() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return sequences.size();
+}
+
+}  // namespace ovms
@@ -0,0 +1,147 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "executinstreamidguard.hpp"
+#include "ovinferrequestsqueue.hpp"
+#include "status.hpp"
+
+namespace ovms {
+
+// Special inputs of requests to stateful models, they are not passed to the network
+const std::string SEQUENCE_ID_INPUT = "sequence_id";
+const std::string SEQUENCE_CONTROL_INPUT = "sequence_control_input";
+
+enum class SequenceControl : uint32_t {
+    NONE = 0,
+    START = 1,
+    END = 2
+};
+
+struct SequenceRequest {
+    // 0 in sequence start request makes server generate unique id
+    uint64_t id = 0;
+    SequenceControl control = SequenceControl::NONE;
+};
+
+/**
+ * @brief Reads sequence id and sequence control inputs of request
+ */
+Status parseSequenceRequest(const tensorflow::serving::PredictRequest& request, SequenceRequest& result);
+
+/**
+ * @brief Number of sequence id and sequence control inputs present in request
+ */
+size_t getSequenceInputsCount(const tensorflow::serving::PredictRequest& request);
+
+/**
+ * @brief Sequence of requests to stateful model. Sequence holds infer request of the model from start to end,
+ * so that state tensors of the network stay in memory states of the infer request and are not sent by clients.
+ * State is reset before infer request is returned to the pool.
+ */
+class Sequence {
+    OVInferRequestsQueue& inferRequestsQueue;
+    std::unique_ptr<ExecutingStreamIdGuard> streamIdGuard;
+    std::atomic<std::chrono::steady_clock::rep> lastUsed;
+
+public:
+    Sequence(OVInferRequestsQueue& inferRequestsQueue, std::unique_ptr<ExecutingStreamIdGuard> streamIdGuard);
+    ~Sequence();
+
+    /**
+     * @brief Serializes requests of the sequence, held from deserialization until outputs are serialized
+     */
+    std::mutex mtx;
+
+    int getStreamId() { return streamIdGuard->getId(); }
+    InferenceEngine::InferRequest& getInferRequest() { return inferRequestsQueue.getInferRequest(getStreamId()); }
+
+    /**
+     * @brief Resets memory states of infer request to initial values of the network
+     */
+    void resetState();
+
+    /**
+     * @brief Records time of the last request
+     */
+    void touch() { lastUsed.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed); }
+    std::chrono::steady_clock::time_point getLastUsed() const {
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(lastUsed.load(std::memory_order_relaxed)));
+    }
+};
+
+/**
+ * @brief Started sequences of stateful model version, each holding one infer request of the model
+ */
+class SequenceManager {
+    OVInferRequestsQueue& inferRequestsQueue;
+    const std::chrono::seconds sequenceTimeout;
+
+    mutable std::mutex mtx;
+    std::unordered_map<uint64_t, std::shared_ptr<Sequence>> sequences;
+    uint64_t lastGeneratedId = 0;
+
+public:
+    /**
+     * @param inferRequestsQueue pool of model infer requests, has to outlive sequence manager
+     * @param sequenceTimeout time after which idle sequence is removed, 0 if never
+     */
+    SequenceManager(OVInferRequestsQueue& inferRequestsQueue, std::chrono::seconds sequenceTimeout) :
+        inferRequestsQueue(inferRequestsQueue),
+        sequenceTimeout(sequenceTimeout) {}
+
+    /**
+     * @brief Starts sequence, taking idle infer request of the model with its state reset
+     *
+     * @param id of new sequence, 0 to generate unique one which is then set
+     * @param options of waiting for idle infer request
+     * @param sequence
+     *
+     * @return SEQUENCE_ALREADY_EXISTS or MAX_SEQUENCE_NUMBER_REACHED if all infer requests are held by other sequences
+     */
+    Status startSequence(uint64_t& id, const StreamWaitingOptions& options, std::shared_ptr<Sequence>& sequence);
+
+    Status findSequence(uint64_t id, std::shared_ptr<Sequence>& sequence) const;
+
+    /**
+     * @brief Removes sequence, its infer request is returned once requests using it finish
+     */
+    void endSequence(uint64_t id);
+
+    /**
+     * @brief Removes sequences which received no requests for sequence timeout, sequences with request in progress are kept
+     *
+     * @return number of removed sequences
+     */
+    size_t removeIdleSequences();
+
+    size_t getSequencesCount() const;
+};
+
+}  // namespace ovms
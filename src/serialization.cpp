@@ -15,68 +15,278 @@
 //*****************************************************************************
 #include "serialization.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+#include "workstealingexecutor.hpp"
+
 namespace ovms {
 
+namespace {
+#ifndef __F16C__
+// Rounds to nearest even, values above half precision range become infinity
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (bits >> 16) & 0x8000;
+    const uint32_t absBits = bits & 0x7FFFFFFF;
+    if (absBits >= 0x7F800000) {
+        return sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0);
+    }
+    if (absBits >= 0x477FF000) {
+        return sign | 0x7C00;
+    }
+    if (absBits < 0x38800000) {
+        // subnormal half, values up to half of the smallest one round to zero
+        if (absBits <= 0x33000000) {
+            return sign;
+        }
+        const uint32_t shift = 126 - (absBits >> 23);
+        const uint32_t mantissa = (absBits & 0x7FFFFF) | 0x800000;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t midpoint = 1u << (shift - 1);
+        if (remainder > midpoint || (remainder == midpoint && (half & 1))) {
+            half++;
+        }
+        return sign | half;
+    }
+    uint32_t half = (absBits >> 13) - ((127 - 15) << 10);
+    const uint32_t remainder = absBits & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return sign | half;
+}
+#endif
+
+// FP32 outputs are down converted when requested, content of other precisions is copied
+void setTensorContent(tensorflow::TensorProto& proto, const char* data, size_t byteSize, const InferenceEngine::Precision precision, bool fp16Outputs) {
+    if (!fp16Outputs || precision != InferenceEngine::Precision::FP32) {
+        proto.mutable_tensor_content()->assign(data, byteSize);
+        return;
+    }
+    const size_t count = byteSize / sizeof(float);
+    std::string content(count * sizeof(uint16_t), '\0');
+    convertFloatToHalf(reinterpret_cast<const float*>(data), count, reinterpret_cast<uint16_t*>(&content[0]));
+    proto.set_dtype(tensorflow::DataType::DT_HALF);
+    proto.mutable_tensor_content()->swap(content);
+}
+}  // namespace
+
+void convertFloatToHalf(const float* source, size_t count, uint16_t* destination) {
+    size_t i = 0;
+#ifdef __F16C__
+    for (; i + 8 <= count; i += 8) {
+        const __m256 values = _mm256_loadu_ps(source + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (; i < count; i++) {
+        destination[i] = _cvtss_sh(source[i], _MM_FROUND_TO_NEAREST_INT);
+    }
+#else
+    for (; i < count; i++) {
+        destination[i] = floatToHalf(source[i]);
+    }
+#endif
+}
+
+// dtype and dims are copied from response template of output, dims of cleared or reused response are not reallocated
+static Status setTensorProtoHeader(
+    tensorflow::TensorProto& responseOutput,
+    const TensorInfo& networkOutput) {
+    // tensor_content holds values in their native width, no padding or conversion is needed
+    if (!networkOutput.getPrecisionConversion().nativeContent) {
+        Status status = StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION;
+        SPDLOG_ERROR(status.string());
+        return status;
+    }
+    const auto& responseTemplate = networkOutput.getResponseTemplate();
+    responseOutput.set_dtype(responseTemplate.dtype());
+    responseOutput.mutable_tensor_shape()->CopyFrom(responseTemplate.tensor_shape());
+    return StatusCode::OK;
+}
+
 Status serializeBlobToTensorProto(
     tensorflow::TensorProto& responseOutput,
     const std::shared_ptr<TensorInfo>& networkOutput,
-    InferenceEngine::Blob::Ptr blob) {
+    InferenceEngine::Blob::Ptr blob,
+    bool fp16Outputs) {
+    if (fp16Outputs && networkOutput->getPrecision() == InferenceEngine::Precision::FP32) {
+        // content of outputs written by inference directly into response is replaced
+        // with converted one, it is temporarily moved out so that it is not cleared
+        std::string content;
+        const char* data = blob->buffer().as<const char*>();
+        if (responseOutput.tensor_content().data() == data) {
+            content.swap(*responseOutput.mutable_tensor_content());
+        }
+        responseOutput.Clear();
+        auto status = setTensorProtoHeader(responseOutput, *networkOutput);
+        if (!status.ok()) {
+            return status;
+        }
+        setTensorContent(responseOutput, content.empty() ? data : content.data(), blob->byteSize(), networkOutput->getPrecision(), fp16Outputs);
+        return StatusCode::OK;
+    }
+    // outputs written by inference directly into response content are not copied
+    const bool writtenInPlace = responseOutput.tensor_content().data() == blob->buffer().as<const char*>() &&
+                                responseOutput.tensor_content().size() == blob->byteSize();
+    if (!writtenInPlace) {
+        responseOutput.Clear();
+    }
+    auto status = setTensorProtoHeader(responseOutput, *networkOutput);
+    if (!status.ok()) {
+        return status;
+    }
+    if (!writtenInPlace) {
+        responseOutput.mutable_tensor_content()->assign((char*)blob->buffer(), blob->byteSize());
+    }
+    return StatusCode::OK;
+}
+
+Status serializeBlobBatchSliceToTensorProto(
+    tensorflow::TensorProto& responseOutput,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob,
+    size_t batchOffset,
+    size_t batchCount,
+    bool fp16Outputs) {
+    const auto& shape = networkOutput->getShape();
+    if (shape.size() == 0 || shape[0] == 0 || batchOffset + batchCount > shape[0]) {
+        Status status = StatusCode::INTERNAL_ERROR;
+        SPDLOG_ERROR("{}: cannot serialize batch slice [{}, {}) of output with shape {}",
+            status.string(), batchOffset, batchOffset + batchCount, TensorInfo::shapeToString(shape));
+        return status;
+    }
     responseOutput.Clear();
-    switch (networkOutput->getPrecision()) {
+    auto status = setTensorProtoHeader(responseOutput, *networkOutput);
+    if (!status.ok()) {
+        return status;
+    }
+    responseOutput.mutable_tensor_shape()->mutable_dim(0)->set_size(batchCount);
+    const size_t rowByteSize = blob->byteSize() / shape[0];
+    setTensorContent(responseOutput, (char*)blob->buffer() + batchOffset * rowByteSize, batchCount * rowByteSize, networkOutput->getPrecision(), fp16Outputs);
+    return StatusCode::OK;
+}
+
+template <typename T>
+static InferenceEngine::Blob::Ptr makeBlobOnContent(const InferenceEngine::TensorDesc& desc, std::string& content) {
+    return InferenceEngine::make_shared_blob<T>(desc, reinterpret_cast<T*>(&content[0]), content.size() / sizeof(T));
+}
+
+static InferenceEngine::Blob::Ptr makeBlobOnContent(const InferenceEngine::TensorDesc& desc, std::string& content) {
+    switch (desc.getPrecision()) {
     case InferenceEngine::Precision::FP32:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<float>::value);
-        break;
+        return makeBlobOnContent<float>(desc, content);
+    case InferenceEngine::Precision::FP16:
+        return makeBlobOnContent<InferenceEngine::ie_fp16>(desc, content);
     case InferenceEngine::Precision::I32:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<int>::value);
-        break;
+        return makeBlobOnContent<int32_t>(desc, content);
     case InferenceEngine::Precision::I16:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<int16_t>::value);
-        break;
+        return makeBlobOnContent<int16_t>(desc, content);
+    case InferenceEngine::Precision::U16:
+        return makeBlobOnContent<uint16_t>(desc, content);
     case InferenceEngine::Precision::U8:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<uint8_t>::value);
-        break;
+        return makeBlobOnContent<uint8_t>(desc, content);
     case InferenceEngine::Precision::I8:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<int8_t>::value);
-        break;
+        return makeBlobOnContent<int8_t>(desc, content);
+    case InferenceEngine::Precision::I64:
+        return makeBlobOnContent<int64_t>(desc, content);
+    default:
+        return nullptr;
+    }
+}
 
-    // 2 byte padding [v1, v0, 0, 0, u1, u0, 0, 0, ...]
-    case InferenceEngine::Precision::U16:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<uint32_t>::value);
-        break;
-    case InferenceEngine::Precision::FP16:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<float>::value);
-        break;
+void ResponseBackedOutputBlobs::bind(
+    InferenceEngine::InferRequest& inferRequest,
+    const tensor_map_t& outputMap,
+    tensorflow::serving::PredictResponse* response) {
+    restore();
+    this->inferRequest = &inferRequest;
+    for (const auto& [name, networkOutput] : outputMap) {
+        try {
+            auto original = inferRequest.GetBlob(networkOutput->getName());
+            auto& tensorProto = (*response->mutable_outputs())[networkOutput->getMappedName()];
+            tensorProto.Clear();
+            auto* content = tensorProto.mutable_tensor_content();
+            content->resize(original->byteSize());
+            auto blob = makeBlobOnContent(original->getTensorDesc(), *content);
+            if (blob == nullptr) {
+                continue;
+            }
+            inferRequest.SetBlob(networkOutput->getName(), blob);
+            originalBlobs.emplace(networkOutput->getName(), std::move(original));
+        } catch (const InferenceEngine::details::InferenceEngineException& e) {
+            SPDLOG_DEBUG("Output {} is serialized by copy, cannot set blob backed by response: {}", networkOutput->getName(), e.what());
+        }
+    }
+}
 
-    case InferenceEngine::Precision::I64:
-        responseOutput.set_dtype(tensorflow::DataTypeToEnum<int32_t>::value);
-        break;
-
-    case InferenceEngine::Precision::Q78:
-    case InferenceEngine::Precision::BIN:
-    case InferenceEngine::Precision::BOOL:
-    case InferenceEngine::Precision::MIXED:
-    case InferenceEngine::Precision::CUSTOM:
-    default: {
-        Status status = StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION;
-        SPDLOG_ERROR(status.string());
-        return status;
+void ResponseBackedOutputBlobs::restore() {
+    if (inferRequest == nullptr) {
+        return;
+    }
+    for (const auto& [name, blob] : originalBlobs) {
+        try {
+            inferRequest->SetBlob(name, blob);
+        } catch (const InferenceEngine::details::InferenceEngineException& e) {
+            SPDLOG_ERROR("Failed to restore output blob {} of infer request: {}", name, e.what());
+        }
+    }
+    originalBlobs.clear();
+    inferRequest = nullptr;
+}
+
+Status serializeOutputsInParallel(const std::vector<size_t>& byteSizes, const std::function<Status(size_t)>& serialize) {
+    std::vector<size_t> large;
+    for (size_t i = 0; i < byteSizes.size(); ++i) {
+        if (byteSizes[i] >= PARALLEL_SERIALIZATION_MIN_BYTES) {
+            large.push_back(i);
+        }
+    }
+    if (large.size() < 2) {
+        large.clear();
     }
+    std::vector<Status> statuses(byteSizes.size());
+    auto largeIt = large.begin();
+    for (size_t i = 0; i < byteSizes.size(); ++i) {
+        if (largeIt != large.end() && *largeIt == i) {
+            ++largeIt;
+            continue;
+        }
+        statuses[i] = serialize(i);
+    }
+    if (!large.empty()) {
+        auto& executor = WorkStealingExecutor::getInstance();
+        executor.parallelFor(large.size(), std::min(large.size() - 1, executor.getWorkersCount()),
+            [&large, &statuses, &serialize](size_t index) { statuses[large[index]] = serialize(large[index]); });
     }
-    responseOutput.mutable_tensor_shape()->Clear();
-    for (auto dim : networkOutput->getShape()) {
-        responseOutput.mutable_tensor_shape()->add_dim()->set_size(dim);
+    for (auto& status : statuses) {
+        if (!status.ok()) {
+            return status;
+        }
     }
-    responseOutput.mutable_tensor_content()->assign((char*)blob->buffer(), blob->byteSize());
     return StatusCode::OK;
 }
 
 Status serializePredictResponse(
     InferenceEngine::InferRequest& inferRequest,
     const tensor_map_t& outputMap,
-    tensorflow::serving::PredictResponse* response) {
-
+    tensorflow::serving::PredictResponse* response,
+    bool fp16Outputs) {
+    std::vector<std::pair<const std::shared_ptr<TensorInfo>*, InferenceEngine::Blob::Ptr>> blobs;
+    std::vector<tensorflow::TensorProto*> protos;
+    std::vector<size_t> byteSizes;
+    blobs.reserve(outputMap.size());
+    protos.reserve(outputMap.size());
+    byteSizes.reserve(outputMap.size());
     for (const auto& pair : outputMap) {
-        auto networkOutput = pair.second;
+        const auto& networkOutput = pair.second;
         InferenceEngine::Blob::Ptr blob;
         try {
             blob = inferRequest.GetBlob(networkOutput->getName());
@@ -86,12 +296,45 @@ Status serializePredictResponse(
             return status;
         }
         auto& tensorProto = (*response->mutable_outputs())[networkOutput->getMappedName()];
-        auto status = serializeBlobToTensorProto(tensorProto, networkOutput, blob);
-        if (!status.ok()) {
-            return status;
-        }
+        // outputs written by inference directly into response are not copied, unless they are converted
+        const bool writtenInPlace = tensorProto.tensor_content().data() == blob->buffer().as<const char*>() &&
+                                    !(fp16Outputs && networkOutput->getPrecision() == InferenceEngine::Precision::FP32);
+        byteSizes.push_back(writtenInPlace ? 0 : blob->byteSize());
+        protos.push_back(&tensorProto);
+        blobs.emplace_back(&networkOutput, std::move(blob));
+    }
+    return serializeOutputsInParallel(byteSizes, [&blobs, &protos, fp16Outputs](size_t index) {
+        return serializeBlobToTensorProto(*protos[index], *blobs[index].first, blobs[index].second, fp16Outputs);
+    });
+}
+
+bool isOutputRequested(const tensorflow::serving::PredictRequest& request, const std::string& outputName) {
+    if (request.output_filter_size() == 0) {
+        return true;
     }
+    return std::find(request.output_filter().begin(), request.output_filter().end(), outputName) != request.output_filter().end();
+}
 
+Status getRequestedOutputs(
+    const tensor_map_t& outputMap,
+    const tensorflow::serving::PredictRequest& request,
+    tensor_map_t& filteredOutputs,
+    const tensor_map_t*& requestedOutputs) {
+    requestedOutputs = &outputMap;
+    if (request.output_filter_size() == 0) {
+        return StatusCode::OK;
+    }
+    filteredOutputs.clear();
+    for (const auto& name : request.output_filter()) {
+        auto it = outputMap.find(name);
+        if (it == outputMap.end()) {
+            const std::string details = "Requested output: " + name;
+            SPDLOG_DEBUG("Output filter refers to missing output - {}", details);
+            return Status(StatusCode::INVALID_MISSING_OUTPUT, details);
+        }
+        filteredOutputs.emplace(name, it->second);
+    }
+    requestedOutputs = &filteredOutputs;
     return StatusCode::OK;
 }
 
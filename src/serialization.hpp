@@ -15,8 +15,10 @@
 //*****************************************************************************
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <spdlog/spdlog.h>
@@ -32,14 +34,100 @@
 
 namespace ovms {
 
+/**
+ * @brief Converts single precision values to raw IEEE 754 half precision ones, rounding to nearest even
+ */
+void convertFloatToHalf(const float* source, size_t count, uint16_t* destination);
+
+/**
+ * @brief Serializes output blob, FP32 output is sent as DT_HALF when fp16Outputs is set
+ */
 Status serializeBlobToTensorProto(
     tensorflow::TensorProto& responseOutput,
     const std::shared_ptr<TensorInfo>& networkOutput,
-    InferenceEngine::Blob::Ptr blob);
+    InferenceEngine::Blob::Ptr blob,
+    bool fp16Outputs = false);
+
+/**
+ * @brief Serializes rows [batchOffset, batchOffset + batchCount) of output blob, used to split batched inference results
+ */
+Status serializeBlobBatchSliceToTensorProto(
+    tensorflow::TensorProto& responseOutput,
+    const std::shared_ptr<TensorInfo>& networkOutput,
+    InferenceEngine::Blob::Ptr blob,
+    size_t batchOffset,
+    size_t batchCount,
+    bool fp16Outputs = false);
+
+/**
+ * @brief Makes inference write outputs directly into tensor_content of response, so that serialization does not copy them
+ *
+ * Output blobs of infer request are replaced with blobs backed by response memory for a single inference
+ * and original blobs are restored on destruction, before infer request is returned to the queue.
+ */
+class ResponseBackedOutputBlobs {
+    InferenceEngine::InferRequest* inferRequest = nullptr;
+    InferenceEngine::BlobMap originalBlobs;
+
+public:
+    ResponseBackedOutputBlobs() = default;
+    ResponseBackedOutputBlobs(const ResponseBackedOutputBlobs&) = delete;
+    ResponseBackedOutputBlobs& operator=(const ResponseBackedOutputBlobs&) = delete;
+    ~ResponseBackedOutputBlobs() {
+        restore();
+    }
+
+    /**
+     * @brief Sets output blobs of infer request, outputs which cannot be bound are serialized by copy
+     */
+    void bind(
+        InferenceEngine::InferRequest& inferRequest,
+        const tensor_map_t& outputMap,
+        tensorflow::serving::PredictResponse* response);
+
+    void restore();
+};
+
+const size_t PARALLEL_SERIALIZATION_MIN_BYTES = 512 * 1024;
+
+/**
+ * @brief Serializes outputs, those of at least PARALLEL_SERIALIZATION_MIN_BYTES concurrently on calling thread and shared executor workers
+ *
+ * Response latency then follows the largest output instead of the sum of them. Response map entries have to be
+ * inserted beforehand, as map is not safe to modify concurrently.
+ *
+ * @param byteSizes bytes copied by serialization of each output
+ * @param serialize serializes output of given index
+ *
+ * @return the first failure in order of outputs
+ */
+Status serializeOutputsInParallel(const std::vector<size_t>& byteSizes, const std::function<Status(size_t)>& serialize);
 
 Status serializePredictResponse(
     InferenceEngine::InferRequest& inferRequest,
     const tensor_map_t& outputMap,
-    tensorflow::serving::PredictResponse* response);
+    tensorflow::serving::PredictResponse* response,
+    bool fp16Outputs = false);
+
+/**
+ * @brief Tells whether output is listed in output_filter of request, all outputs are requested when filter is empty
+ */
+bool isOutputRequested(const tensorflow::serving::PredictRequest& request, const std::string& outputName);
+
+/**
+ * @brief Selects outputs listed in output_filter of request, so that other outputs are neither fetched nor serialized
+ *
+ * @param outputMap all outputs of model
+ * @param request
+ * @param filteredOutputs storage of selected outputs, filled only when request filters outputs
+ * @param requestedOutputs set to outputMap or filteredOutputs
+ *
+ * @return INVALID_MISSING_OUTPUT if filter refers to output model does not have
+ */
+Status getRequestedOutputs(
+    const tensor_map_t& outputMap,
+    const tensorflow::serving::PredictRequest& request,
+    tensor_map_t& filteredOutputs,
+    const tensor_map_t*& requestedOutputs);
 
 }  // namespace ovms
@@ -13,8 +13,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -29,13 +31,22 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "blockingtasksexecutor.hpp"
 #include "config.hpp"
+#include "cpuaffinity.hpp"
 #include "http_server.hpp"
 #include "logging.hpp"
 #include "model_service.hpp"
 #include "modelmanager.hpp"
+#include "offlinebatch.hpp"
 #include "prediction_service.hpp"
+#include "profiler.hpp"
+#include "statussnapshot.hpp"
 #include "stringutils.hpp"
+#include "tensorcache_service.hpp"
+#include "trafficcapture.hpp"
+#include "workerprocesses.hpp"
+#include "workstealingexecutor.hpp"
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -54,10 +65,47 @@ uint getGRPCServersCount() {
             return result.value();
         }
     }
+    if (ovms::Config::instance().serverShards() > 0) {
+        return ovms::Config::instance().serverShards();
+    }
 
     return std::max<uint>(1, ovms::Config::instance().grpcWorkers());
 }
 
+/**
+ * @brief Gets CPUs which threads of each gRPC and REST server shard are pinned to, empty if sharding is disabled
+ */
+std::vector<std::vector<int>> getServerShardsCpus() {
+    auto& config = ovms::Config::instance();
+    std::vector<std::vector<int>> shardsCpus;
+    if (config.serverShards() == 0) {
+        return shardsCpus;
+    }
+    auto status = splitCpus(config.serverShardsCpuSet(), config.serverShards(), shardsCpus);
+    if (!status.ok()) {
+        SPDLOG_ERROR("Cannot split CPUs: {} between server shards", config.serverShardsCpuSet());
+        exit(1);
+    }
+    return shardsCpus;
+}
+
+/**
+ * @brief Gets CPU of each completion queue thread of gRPC server, empty if threads are not pinned
+ *
+ * Threads of all servers are spread over grpc_cpu_set, otherwise each server spreads its threads over CPUs of its shard.
+ */
+std::vector<int> getCompletionQueueThreadsCpus(const std::vector<int>& grpcCpus, const std::vector<std::vector<int>>& shardsCpus, uint server, uint completionQueuesCount) {
+    std::vector<int> cpus;
+    for (uint q = 0; q < completionQueuesCount; ++q) {
+        if (!grpcCpus.empty()) {
+            cpus.push_back(grpcCpus[(server * completionQueuesCount + q) % grpcCpus.size()]);
+        } else if (server < shardsCpus.size() && !shardsCpus[server].empty()) {
+            cpus.push_back(shardsCpus[server][q % shardsCpus[server].size()]);
+        }
+    }
+    return cpus;
+}
+
 bool isPortAvailable(uint64_t port) {
     struct sockaddr_in addr;
     int s = socket(AF_INET, SOCK_STREAM, 0);
@@ -116,9 +164,31 @@ void logConfig(Config& config) {
     }
     SPDLOG_DEBUG("gRPC port: {}", config.port());
     SPDLOG_DEBUG("REST port: {}", config.restPort());
+    SPDLOG_DEBUG("gRPC unix socket path: {}", config.grpcUnixSocketPath());
+    SPDLOG_DEBUG("REST unix socket path: {}", config.restUnixSocketPath());
     SPDLOG_DEBUG("REST workers: {}", config.restWorkers());
+    SPDLOG_DEBUG("REST connection timeout: {}", config.restConnectionTimeout());
+    SPDLOG_DEBUG("REST socket buffer size: {}", config.restSocketBufferSize());
     SPDLOG_DEBUG("gRPC workers: {}", config.grpcWorkers());
+    SPDLOG_DEBUG("gRPC completion queues: {}", config.grpcCompletionQueues());
+    SPDLOG_DEBUG("gRPC CPU set: {}", config.grpcCpuSet());
     SPDLOG_DEBUG("gRPC channel arguments: {}", config.grpcChannelArguments());
+    SPDLOG_DEBUG("server shards: {}", config.serverShards());
+    SPDLOG_DEBUG("server shards CPU set: {}", config.serverShardsCpuSet());
+    SPDLOG_DEBUG("worker processes: {}, worker index: {}", config.workerProcesses(), getWorkerProcessIndex());
+    SPDLOG_DEBUG("executor workers: {}", config.executorWorkers());
+    SPDLOG_DEBUG("executor CPU set: {}", config.executorCpuSet());
+    SPDLOG_DEBUG("profiling endpoints: {}", config.profilingEndpoints());
+    SPDLOG_DEBUG("share compiled networks: {}", config.shareCompiledNetworks());
+    SPDLOG_DEBUG("capture path: {}", config.capturePath());
+    SPDLOG_DEBUG("capture sample ratio: {}", config.captureSampleRatio());
+    SPDLOG_DEBUG("response compression min bytes: {}", config.responseCompressionMinBytes());
+    SPDLOG_DEBUG("in flight memory budget: {} MB", config.inFlightMemoryBudgetMb());
+    SPDLOG_DEBUG("tensor cache size: {} MB", config.tensorCacheSizeMb());
+    SPDLOG_DEBUG("batch input dir: {}", config.batchInputDir());
+    SPDLOG_DEBUG("batch output dir: {}", config.batchOutputDir());
+    SPDLOG_DEBUG("batch model name: {}", config.batchModelName());
+    SPDLOG_DEBUG("batch concurrency: {}", config.batchConcurrency());
     SPDLOG_DEBUG("log level: {}", config.logLevel());
     SPDLOG_DEBUG("log path: {}", config.logPath());
 }
@@ -156,8 +226,9 @@ void installSignalHandlers() {
 }
 
 std::vector<std::unique_ptr<Server>> startGRPCServer(
-    PredictionServiceImpl& predict_service,
-    ModelServiceImpl& model_service) {
+    std::vector<std::unique_ptr<PredictionServiceImpl>>& predict_services,
+    ModelServiceImpl& model_service,
+    TensorCacheServiceImpl& tensor_cache_service) {
     const int GIGABYTE = 1024 * 1024 * 1024;
 
     std::vector<GrpcChannelArgument> channel_arguments;
@@ -176,82 +247,166 @@ std::vector<std::unique_ptr<Server>> startGRPCServer(
         exit(1);
     }
 
-    ServerBuilder builder;
-    builder.SetMaxReceiveMessageSize(GIGABYTE);
-    builder.SetMaxSendMessageSize(GIGABYTE);
-    builder.AddListeningPort(config.grpcBindAddress() + ":" + std::to_string(config.port()), grpc::InsecureServerCredentials());
-    builder.RegisterService(&predict_service);
-    builder.RegisterService(&model_service);
-    for (const GrpcChannelArgument& channel_argument : channel_arguments) {
-        // gRPC accept arguments of two types, int and string. We will attempt to
-        // parse each arg as int and pass it on as such if successful. Otherwise we
-        // will pass it as a string. gRPC will log arguments that were not accepted.
-        SPDLOG_DEBUG("setting grpc channel argument {}: {}", channel_argument.key, channel_argument.value);
-        try {
-            int i = std::stoi(channel_argument.value);
-            builder.AddChannelArgument(channel_argument.key, i);
-        } catch (std::invalid_argument const& e) {
-            builder.AddChannelArgument(channel_argument.key, channel_argument.value);
-        } catch (std::out_of_range const& e) {
-            SPDLOG_WARN("Out of range parameter {} : {}", channel_argument.key, channel_argument.value);
-        }
-    }
-
     std::vector<std::unique_ptr<Server>> servers;
     uint grpcServersCount = getGRPCServersCount();
     servers.reserve(grpcServersCount);
+    predict_services.reserve(grpcServersCount);
     SPDLOG_DEBUG("Starting grpc servers: {}", grpcServersCount);
 
-    if (!isPortAvailable(config.port())) {
+    // port is shared with other worker processes
+    if (config.workerProcesses() == 0 && !isPortAvailable(config.port())) {
         throw std::runtime_error("Failed to start GRPC server at " + config.grpcBindAddress() + ":" + std::to_string(config.port()));
     }
+    const std::string grpcUnixSocketPath = getWorkerProcessIndex() == 0 ? config.grpcUnixSocketPath() : "";
+    if (!grpcUnixSocketPath.empty()) {
+        removeStaleUnixSocket(grpcUnixSocketPath);
+    }
+    const auto shardsCpus = getServerShardsCpus();
+    const uint completionQueuesCount = config.grpcCompletionQueues();
+    std::vector<int> grpcCpus;
+    if (!config.grpcCpuSet().empty() && !getRequestedCpus(-1, config.grpcCpuSet(), grpcCpus).ok()) {
+        throw std::runtime_error("Cannot pin gRPC threads to CPUs: " + config.grpcCpuSet());
+    }
     for (uint i = 0; i < grpcServersCount; ++i) {
+        // completion queue and handling threads created while starting the server inherit CPUs of the shard
+        CpuAffinityGuard cpuAffinityGuard(i < shardsCpus.size() ? shardsCpus[i] : std::vector<int>{});
+        // service with asynchronous method can be registered in single server only
+        predict_services.push_back(std::make_unique<PredictionServiceImpl>());
+        auto& predict_service = *predict_services.back();
+        predict_service.setResponseCompressionMinBytes(config.responseCompressionMinBytes());
+
+        ServerBuilder builder;
+        builder.SetMaxReceiveMessageSize(GIGABYTE);
+        builder.SetMaxSendMessageSize(GIGABYTE);
+        builder.AddListeningPort(config.grpcBindAddress() + ":" + std::to_string(config.port()), grpc::InsecureServerCredentials());
+        if (i == 0 && !grpcUnixSocketPath.empty()) {
+            // unix domain socket can't be shared between servers with SO_REUSEPORT like the tcp port
+            builder.AddListeningPort("unix:" + grpcUnixSocketPath, grpc::InsecureServerCredentials());
+        }
+        builder.RegisterService(&predict_service);
+        builder.RegisterService(&predict_service.getStreamService());
+        builder.RegisterService(&model_service);
+        builder.RegisterService(&predict_service.getStatusWatchService());
+        builder.RegisterService(&tensor_cache_service);
+        for (uint q = 0; q < completionQueuesCount; ++q) {
+            predict_service.addCompletionQueue(builder);
+        }
+        for (const GrpcChannelArgument& channel_argument : channel_arguments) {
+            // gRPC accept arguments of two types, int and string. We will attempt to
+            // parse each arg as int and pass it on as such if successful. Otherwise we
+            // will pass it as a string. gRPC will log arguments that were not accepted.
+            SPDLOG_DEBUG("setting grpc channel argument {}: {}", channel_argument.key, channel_argument.value);
+            try {
+                int i = std::stoi(channel_argument.value);
+                builder.AddChannelArgument(channel_argument.key, i);
+            } catch (std::invalid_argument const& e) {
+                builder.AddChannelArgument(channel_argument.key, channel_argument.value);
+            } catch (std::out_of_range const& e) {
+                SPDLOG_WARN("Out of range parameter {} : {}", channel_argument.key, channel_argument.value);
+            }
+        }
+
         std::unique_ptr<Server> server = builder.BuildAndStart();
         if (server == nullptr) {
             throw std::runtime_error("Failed to start GRPC server at " + std::to_string(config.port()));
         }
+        predict_service.startHandlingPredictCalls(getCompletionQueueThreadsCpus(grpcCpus, shardsCpus, i, completionQueuesCount));
         servers.push_back(std::move(server));
     }
     SPDLOG_INFO("Server started on port {}", config.port());
+    if (!grpcUnixSocketPath.empty()) {
+        SPDLOG_INFO("Server started on unix domain socket {}", grpcUnixSocketPath);
+    }
 
     return servers;
 }
 
-std::unique_ptr<ovms::http_server> startRESTServer() {
+std::vector<std::unique_ptr<ovms::http_server>> startRESTServer() {
     const int REST_TIMEOUT = 5000;
 
     auto& config = ovms::Config::instance();
+    std::vector<std::unique_ptr<ovms::http_server>> restServers;
     if (config.restPort() != 0) {
         // if (config.restAddress() !=  TODO FIXME
 
         const std::string server_address = config.restBindAddress() + ":" + std::to_string(config.restPort());
 
         int workers = config.restWorkers() ? config.restWorkers() : 10;
-        SPDLOG_INFO("Will start {} REST workers", workers);
-
-        std::unique_ptr<ovms::http_server> restServer = ovms::createAndStartHttpServer(config.restBindAddress(), config.restPort(), workers, REST_TIMEOUT);
-        if (restServer != nullptr) {
-            SPDLOG_INFO("Started REST server at {}", server_address);
-        } else {
-            throw std::runtime_error("Failed to start REST server at " + server_address);
+        const auto shardsCpus = getServerShardsCpus();
+        const size_t serversCount = std::max<size_t>(1, shardsCpus.size());
+        if (serversCount > 1) {
+            // each shard runs its own event loop
+            workers = std::max<int>(2, workers / serversCount);
+        }
+        SPDLOG_INFO("Will start {} REST servers with {} workers", serversCount, workers);
+
+        for (size_t i = 0; i < serversCount; ++i) {
+            // executor threads running event loop and requests are created with CPUs of the shard
+            CpuAffinityGuard cpuAffinityGuard(i < shardsCpus.size() ? shardsCpus[i] : std::vector<int>{});
+            std::unique_ptr<ovms::http_server> restServer = ovms::createAndStartHttpServer(config.restBindAddress(), config.restPort(), workers, REST_TIMEOUT,
+                i == 0 && getWorkerProcessIndex() == 0 ? config.restUnixSocketPath() : "", config.responseCompressionMinBytes(),
+                !shardsCpus.empty() || config.workerProcesses() > 0,
+                config.restConnectionTimeout(), config.restSocketBufferSize());
+            if (restServer != nullptr) {
+                SPDLOG_INFO("Started REST server at {}", server_address);
+            } else {
+                throw std::runtime_error("Failed to start REST server at " + server_address);
+            }
+            restServers.push_back(std::move(restServer));
         }
-
-        return restServer;
     }
 
-    return nullptr;
+    return restServers;
+}
+
+int runOfflineBatch() {
+    auto& config = ovms::Config::instance();
+    logConfig(config);
+    auto& manager = ModelManager::getInstance();
+    auto status = manager.start();
+    if (!status.ok()) {
+        SPDLOG_ERROR("ovms::ModelManager::Start() Error: {}", status.string());
+        return EXIT_FAILURE;
+    }
+    OfflineBatchOptions options;
+    options.inputDir = config.batchInputDir();
+    options.outputDir = config.batchOutputDir();
+    options.name = config.batchModelName();
+    options.concurrency = config.batchConcurrency();
+    status = runOfflineBatchInference(manager, options);
+    manager.join();
+    return status.ok() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 int server_main(int argc, char** argv) {
     installSignalHandlers();
     try {
         auto& config = ovms::Config::instance().parse(argc, argv);
+        if (config.workerProcesses() > 0 && config.batchInputDir().empty()) {
+            // returns only in forked workers, before logger and executor threads are started
+            startWorkerProcesses(config.workerProcesses(), shutdown_request);
+        }
         configure_logger(config.logLevel(), config.logPath());
 
-        PredictionServiceImpl predict_service;
+        std::vector<std::unique_ptr<PredictionServiceImpl>> predict_services;
         ModelServiceImpl model_service;
+        TensorCacheServiceImpl tensor_cache_service;
 
-        auto grpc = startGRPCServer(predict_service, model_service);
+        CpuProfiler::setEnabled(config.profilingEndpoints());
+        auto status = WorkStealingExecutor::configure(config.executorWorkers(), config.executorCpuSet());
+        if (!status.ok()) {
+            throw std::runtime_error("Cannot configure executor workers on CPUs: " + config.executorCpuSet());
+        }
+        if (!config.batchInputDir().empty()) {
+            return runOfflineBatch();
+        }
+        if (!config.capturePath().empty() && getWorkerProcessIndex() == 0) {
+            status = TrafficCapture::getInstance().start(config.capturePath(), config.captureSampleRatio());
+            if (!status.ok()) {
+                throw std::runtime_error("Cannot start traffic capture to: " + config.capturePath());
+            }
+        }
+        auto grpc = startGRPCServer(predict_services, model_service, tensor_cache_service);
         auto rest = startRESTServer();
 
         while (!shutdown_request) {
@@ -261,13 +416,22 @@ int server_main(int argc, char** argv) {
             SPDLOG_ERROR("Illegal operation. OVMS started on unsupported device");
         }
         SPDLOG_INFO("Shutting down");
+        // status watches last until cancelled, they would hold off server shutdown
+        StatusSnapshot::getInstance().stopWatching();
         for (const auto& g : grpc) {
             g->Shutdown();
         }
+        for (const auto& predict_service : predict_services) {
+            predict_service->stopHandlingPredictCalls();
+        }
 
-        if (rest != nullptr) {
-            rest->Terminate();
+        for (const auto& r : rest) {
+            r->Terminate();
         }
+        TrafficCapture::getInstance().stop();
+        // requests still waiting for synchronous inference hold unload guards of models, batched pipelines wait on those
+        BlockingTasksExecutor::getPipelineBatchesInstance().shutdown();
+        BlockingTasksExecutor::getInferencesInstance().shutdown();
 
         ModelManager::getInstance().join();
     } catch (std::exception& e) {
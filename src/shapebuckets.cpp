@@ -0,0 +1,207 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "shapebuckets.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/types.h"
+#pragma GCC diagnostic pop
+
+#include "tensorinfo.hpp"
+
+namespace ovms {
+
+namespace {
+size_t getNumberOfElements(const shape_t& shape) {
+    return std::accumulate(shape.begin(), shape.end(), size_t{1}, std::multiplies<size_t>());
+}
+
+shape_t getTensorShape(const tensorflow::TensorProto& tensor) {
+    shape_t shape;
+    for (const auto& dim : tensor.tensor_shape().dim()) {
+        shape.push_back(dim.size());
+    }
+    return shape;
+}
+
+void setTensorShape(tensorflow::TensorProto& tensor, const shape_t& shape) {
+    tensor.mutable_tensor_shape()->clear_dim();
+    for (auto dim : shape) {
+        tensor.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+}
+
+/**
+ * @brief Copies leading region of row major tensor into another tensor, both having region rank
+ */
+void copyTensorRegion(const char* source, const std::vector<size_t>& sourceStrides,
+    char* destination, const std::vector<size_t>& destinationStrides,
+    const shape_t& region, size_t dim) {
+    if (dim + 1 == region.size()) {
+        std::memcpy(destination, source, region[dim] * sourceStrides[dim]);
+        return;
+    }
+    for (size_t i = 0; i < region[dim]; i++) {
+        copyTensorRegion(source + i * sourceStrides[dim], sourceStrides,
+            destination + i * destinationStrides[dim], destinationStrides,
+            region, dim + 1);
+    }
+}
+
+/**
+ * @brief Calculates byte strides of row major tensor, last one being element size
+ */
+std::vector<size_t> getStrides(const shape_t& shape, size_t elementSize) {
+    std::vector<size_t> strides(shape.size());
+    size_t stride = elementSize;
+    for (size_t i = shape.size(); i > 0; i--) {
+        strides[i - 1] = stride;
+        stride *= shape[i - 1];
+    }
+    return strides;
+}
+
+std::string resizeTensorContent(const std::string& content, const shape_t& shape, const shape_t& newShape, size_t elementSize) {
+    // sliced dimensions are copied partially, padded ones are left zero filled
+    shape_t region(shape.size());
+    for (size_t i = 0; i < shape.size(); i++) {
+        region[i] = std::min(shape[i], newShape[i]);
+    }
+    std::string resized(getNumberOfElements(newShape) * elementSize, '\0');
+    if (getNumberOfElements(region) > 0) {
+        copyTensorRegion(content.data(), getStrides(shape, elementSize),
+            resized.data(), getStrides(newShape, elementSize), region, 0);
+    }
+    return resized;
+}
+}  // namespace
+
+const shape_t* findShapeBucket(const std::vector<shape_t>& buckets, const shape_t& shape) {
+    for (const auto& bucket : buckets) {
+        if (bucket.size() != shape.size()) {
+            continue;
+        }
+        bool fits = true;
+        for (size_t i = 0; i < shape.size(); i++) {
+            if (bucket[i] < shape[i]) {
+                fits = false;
+                break;
+            }
+        }
+        if (fits) {
+            return &bucket;
+        }
+    }
+    return nullptr;
+}
+
+bool padRequestToShapeBuckets(const ModelConfig& config,
+    const tensorflow::serving::PredictRequest& request,
+    tensorflow::serving::PredictRequest& paddedRequest,
+    ShapeBucketPadding& padding) {
+    std::map<std::string, const shape_t*> inputsBuckets;
+    for (const auto& [name, buckets] : config.getShapeBuckets()) {
+        if (!config.isShapeAuto(name)) {
+            continue;
+        }
+        auto mappedName = config.getMappingInputByKey(name);
+        auto requestInputItr = request.inputs().find(mappedName.empty() ? name : mappedName);
+        if (requestInputItr == request.inputs().end()) {
+            continue;
+        }
+        const auto& requestInput = requestInputItr->second;
+        const size_t elementSize = tensorflow::DataTypeSize(requestInput.dtype());
+        auto shape = getTensorShape(requestInput);
+        if (elementSize == 0 || shape.empty() || requestInput.tensor_content().size() != getNumberOfElements(shape) * elementSize) {
+            // left for validation or deserialization of original request
+            continue;
+        }
+        auto bucket = findShapeBucket(buckets, shape);
+        if (bucket == nullptr) {
+            SPDLOG_DEBUG("Request input: {} shape: {} does not fit any shape bucket, reshape is used instead",
+                requestInputItr->first, TensorInfo::shapeToString(shape));
+            continue;
+        }
+        if (*bucket != shape) {
+            inputsBuckets.emplace(requestInputItr->first, bucket);
+            padding.requestShapes.emplace(requestInputItr->first, std::move(shape));
+            padding.bucketShapes.emplace(requestInputItr->first, *bucket);
+        }
+    }
+    if (!padding.isApplied()) {
+        return false;
+    }
+
+    *paddedRequest.mutable_model_spec() = request.model_spec();
+    *paddedRequest.mutable_output_filter() = request.output_filter();
+    for (const auto& [name, requestInput] : request.inputs()) {
+        auto& paddedInput = (*paddedRequest.mutable_inputs())[name];
+        auto bucketItr = inputsBuckets.find(name);
+        if (bucketItr == inputsBuckets.end()) {
+            paddedInput = requestInput;
+            continue;
+        }
+        paddedInput.set_dtype(requestInput.dtype());
+        setTensorShape(paddedInput, *bucketItr->second);
+        *paddedInput.mutable_tensor_content() = resizeTensorContent(requestInput.tensor_content(),
+            padding.requestShapes.at(name), *bucketItr->second, tensorflow::DataTypeSize(requestInput.dtype()));
+        SPDLOG_DEBUG("Request input: {} padded from shape: {} to shape bucket: {}",
+            name, TensorInfo::shapeToString(padding.requestShapes.at(name)), TensorInfo::shapeToString(*bucketItr->second));
+    }
+    return true;
+}
+
+void sliceResponseToRequestShapes(const ShapeBucketPadding& padding, tensorflow::serving::PredictResponse& response) {
+    // padded dimension index -> bucket size, request size; first padded input defines it
+    std::map<size_t, std::pair<size_t, size_t>> paddedDims;
+    for (const auto& [name, bucketShape] : padding.bucketShapes) {
+        const auto& requestShape = padding.requestShapes.at(name);
+        for (size_t i = 0; i < bucketShape.size(); i++) {
+            if (bucketShape[i] != requestShape[i]) {
+                paddedDims.emplace(i, std::make_pair(bucketShape[i], requestShape[i]));
+            }
+        }
+    }
+    for (auto& [name, output] : *response.mutable_outputs()) {
+        auto shape = getTensorShape(output);
+        auto slicedShape = shape;
+        for (const auto& [dim, sizes] : paddedDims) {
+            if (dim < slicedShape.size() && slicedShape[dim] == sizes.first) {
+                slicedShape[dim] = sizes.second;
+            }
+        }
+        const size_t numberOfElements = getNumberOfElements(shape);
+        if (slicedShape == shape || numberOfElements == 0 || output.tensor_content().size() % numberOfElements != 0) {
+            continue;
+        }
+        const size_t elementSize = output.tensor_content().size() / numberOfElements;
+        *output.mutable_tensor_content() = resizeTensorContent(output.tensor_content(), shape, slicedShape, elementSize);
+        setTensorShape(output, slicedShape);
+        SPDLOG_DEBUG("Response output: {} sliced from shape: {} to shape: {}",
+            name, TensorInfo::shapeToString(shape), TensorInfo::shapeToString(slicedShape));
+    }
+}
+
+}  // namespace ovms
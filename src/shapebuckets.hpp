@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <map>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "modelconfig.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Shapes of request inputs before and after padding to shape buckets
+ */
+struct ShapeBucketPadding {
+    std::map<std::string, shape_t> requestShapes;
+    std::map<std::string, shape_t> bucketShapes;
+
+    bool isApplied() const {
+        return !bucketShapes.empty();
+    }
+};
+
+/**
+ * @brief Finds smallest bucket not smaller than shape in any dimension
+ *
+ * @return bucket or nullptr if shape does not fit any bucket
+ */
+const shape_t* findShapeBucket(const std::vector<shape_t>& buckets, const shape_t& shape);
+
+/**
+ * @brief Pads request inputs with auto shape up to shape buckets configured for them
+ *
+ * Padded inputs are filled with zeros after request data in each dimension. Inputs not requiring
+ * padding are copied as they are. Only inputs with data in tensor_content are padded.
+ *
+ * @param config model configuration
+ * @param request
+ * @param paddedRequest request with padded inputs, filled only when padding was applied
+ * @param padding shapes used later to slice response outputs
+ *
+ * @return true if any input was padded
+ */
+bool padRequestToShapeBuckets(const ModelConfig& config,
+    const tensorflow::serving::PredictRequest& request,
+    tensorflow::serving::PredictRequest& paddedRequest,
+    ShapeBucketPadding& padding);
+
+/**
+ * @brief Slices response outputs back to request shapes
+ *
+ * Output dimension is sliced when the same dimension of a padded input was padded and output
+ * has the size of bucket in it, which holds for outputs following padded dimension of an input.
+ *
+ * @param padding
+ * @param response
+ */
+void sliceResponseToRequestShapes(const ShapeBucketPadding& padding, tensorflow::serving::PredictResponse& response);
+
+}  // namespace ovms
@@ -0,0 +1,153 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "sharedmemory.hpp"
+
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ov_utils.hpp"
+
+namespace ovms {
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    munmap(mapping, mappingSize);
+}
+
+Status SharedMemoryRegion::open(const std::string& name, const std::string& key, size_t offset, size_t byteSize, std::shared_ptr<const SharedMemoryRegion>& region) {
+    if (byteSize == 0) {
+        SPDLOG_DEBUG("Shared memory region:{} cannot be empty", name);
+        return Status(StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED, "Region byte size can't be 0");
+    }
+    int fd = shm_open(key.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        SPDLOG_DEBUG("Failed to open shared memory segment:{} of region:{}", key, name);
+        return Status(StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED, "Segment: " + key);
+    }
+    struct stat segmentStat;
+    // offset + byteSize could wrap, bounds are checked with subtraction
+    if (fstat(fd, &segmentStat) != 0 || byteSize > static_cast<size_t>(segmentStat.st_size) ||
+        offset > static_cast<size_t>(segmentStat.st_size) - byteSize) {
+        close(fd);
+        SPDLOG_DEBUG("Shared memory region:{} exceeds segment:{}", name, key);
+        return Status(StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS, "Segment: " + key + " is smaller than offset and byte size of region");
+    }
+    // mapping has to start at page boundary
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    const size_t mappingOffset = offset - offset % pageSize;
+    const size_t mappingSize = offset + byteSize - mappingOffset;
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, mappingOffset);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        SPDLOG_DEBUG("Failed to map shared memory segment:{} of region:{}", key, name);
+        return Status(StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED, "Segment: " + key);
+    }
+    region.reset(new SharedMemoryRegion(name, key, offset, byteSize, mapping, mappingSize, static_cast<const char*>(mapping) + (offset - mappingOffset)));
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegistry::registerRegion(const std::string& name, const std::string& key, size_t offset, size_t byteSize) {
+    std::unique_lock lock(mtx);
+    if (regions.count(name) > 0) {
+        SPDLOG_DEBUG("Shared memory region:{} is already registered", name);
+        return StatusCode::SHARED_MEMORY_REGION_ALREADY_EXISTS;
+    }
+    std::shared_ptr<const SharedMemoryRegion> region;
+    auto status = SharedMemoryRegion::open(name, key, offset, byteSize, region);
+    if (!status.ok()) {
+        return status;
+    }
+    regions.emplace(name, std::move(region));
+    SPDLOG_INFO("Registered shared memory region:{} segment:{} offset:{} byte size:{}", name, key, offset, byteSize);
+    return StatusCode::OK;
+}
+
+Status SharedMemoryRegistry::unregisterRegion(const std::string& name) {
+    std::unique_lock lock(mtx);
+    if (regions.erase(name) == 0) {
+        SPDLOG_DEBUG("Shared memory region:{} is not registered", name);
+        return StatusCode::SHARED_MEMORY_REGION_NOT_FOUND;
+    }
+    SPDLOG_INFO("Unregistered shared memory region:{}", name);
+    return StatusCode::OK;
+}
+
+std::shared_ptr<const SharedMemoryRegion> SharedMemoryRegistry::findRegion(const std::string& name) const {
+    std::shared_lock lock(mtx);
+    auto it = regions.find(name);
+    return it == regions.end() ? nullptr : it->second;
+}
+
+std::vector<std::shared_ptr<const SharedMemoryRegion>> SharedMemoryRegistry::getRegions() const {
+    std::shared_lock lock(mtx);
+    std::vector<std::shared_ptr<const SharedMemoryRegion>> result;
+    for (const auto& [name, region] : regions) {
+        result.push_back(region);
+    }
+    return result;
+}
+
+bool isSharedMemoryTensor(const tensorflow::TensorProto& proto) {
+    return proto.resource_handle_val_size() == 1 && proto.resource_handle_val(0).container() == SHARED_MEMORY_CONTAINER;
+}
+
+Status getSharedMemoryTensorData(const tensorflow::TensorProto& proto, size_t byteSize, std::shared_ptr<const SharedMemoryRegion>& region, const char*& data) {
+    const auto& handle = proto.resource_handle_val(0);
+    region = SharedMemoryRegistry::getInstance().findRegion(handle.name());
+    if (region == nullptr) {
+        SPDLOG_DEBUG("Tensor refers to not registered shared memory region:{}", handle.name());
+        return Status(StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, "Region: " + handle.name());
+    }
+    const uint64_t offset = handle.hash_code();
+    if (offset > region->getByteSize() || byteSize > region->getByteSize() - offset) {
+        std::stringstream ss;
+        ss << "Region: " << handle.name() << " byte size: " << region->getByteSize() << "; Tensor offset: " << offset << " byte size: " << byteSize;
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Tensor exceeds shared memory region - {}", details);
+        return Status(StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS, details);
+    }
+    data = region->getData() + offset;
+    return StatusCode::OK;
+}
+
+Status createSharedMemoryBlob(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc, InferenceEngine::Blob::Ptr& blob) {
+    size_t byteSize = desc.getPrecision().size();
+    for (size_t dim : desc.getDims()) {
+        if (__builtin_mul_overflow(byteSize, dim, &byteSize)) {
+            SPDLOG_DEBUG("Shared memory tensor dimensions are too big");
+            return StatusCode::INVALID_SHAPE;
+        }
+    }
+    std::shared_ptr<const SharedMemoryRegion> region;
+    const char* data = nullptr;
+    auto status = getSharedMemoryTensorData(proto, byteSize, region, data);
+    if (!status.ok()) {
+        return status;
+    }
+    blob = createExternalMemoryBlob(desc, std::move(region), data);
+    if (!blob) {
+        return StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
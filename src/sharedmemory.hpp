@@ -0,0 +1,128 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Container of resource handle referring to tensor data in shared memory region
+ *
+ * Tensor proto of such input has dtype and tensor_shape set as usual, empty content and single resource_handle_val
+ * with this container, region name as name and byte offset of data within region as hash_code.
+ */
+const std::string SHARED_MEMORY_CONTAINER = "ovms_shared_memory";
+
+/**
+ * @brief Part of POSIX shared memory segment registered by co-located client, mapped read only
+ */
+class SharedMemoryRegion {
+    std::string name;
+    std::string key;
+    size_t offset;
+    size_t byteSize;
+    void* mapping;
+    size_t mappingSize;
+    const char* data;
+
+    SharedMemoryRegion(const std::string& name, const std::string& key, size_t offset, size_t byteSize, void* mapping, size_t mappingSize, const char* data) :
+        name(name),
+        key(key),
+        offset(offset),
+        byteSize(byteSize),
+        mapping(mapping),
+        mappingSize(mappingSize),
+        data(data) {}
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+public:
+    ~SharedMemoryRegion();
+
+    /**
+     * @brief Maps byteSize bytes of shared memory segment starting at offset
+     *
+     * @param name under which region is referred to in requests
+     * @param key name of segment passed to shm_open
+     */
+    static Status open(const std::string& name, const std::string& key, size_t offset, size_t byteSize, std::shared_ptr<const SharedMemoryRegion>& region);
+
+    const std::string& getName() const { return name; }
+    const std::string& getKey() const { return key; }
+    size_t getOffset() const { return offset; }
+    size_t getByteSize() const { return byteSize; }
+    const char* getData() const { return data; }
+};
+
+/**
+ * @brief Shared memory regions registered by clients, keyed by name
+ *
+ * Unregistered region stays mapped until blobs of requests referring to it are released.
+ */
+class SharedMemoryRegistry {
+    std::map<std::string, std::shared_ptr<const SharedMemoryRegion>> regions;
+    mutable std::shared_mutex mtx;
+
+public:
+    static SharedMemoryRegistry& getInstance() {
+        static SharedMemoryRegistry instance;
+        return instance;
+    }
+
+    Status registerRegion(const std::string& name, const std::string& key, size_t offset, size_t byteSize);
+    Status unregisterRegion(const std::string& name);
+
+    /**
+     * @return region or nullptr if there is no region with such name
+     */
+    std::shared_ptr<const SharedMemoryRegion> findRegion(const std::string& name) const;
+
+    std::vector<std::shared_ptr<const SharedMemoryRegion>> getRegions() const;
+};
+
+/**
+ * @brief Checks whether tensor data is referred in shared memory region instead of being sent in tensor proto
+ */
+bool isSharedMemoryTensor(const tensorflow::TensorProto& proto);
+
+/**
+ * @brief Finds byteSize bytes of tensor data in shared memory region it refers to
+ *
+ * @param region holds mapping as long as data is used
+ */
+Status getSharedMemoryTensorData(const tensorflow::TensorProto& proto, size_t byteSize, std::shared_ptr<const SharedMemoryRegion>& region, const char*& data);
+
+/**
+ * @brief Wraps tensor data in shared memory region as blob without copying, blob keeps region mapped
+ */
+Status createSharedMemoryBlob(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc, InferenceEngine::Blob::Ptr& blob);
+
+}  // namespace ovms
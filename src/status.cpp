@@ -31,9 +31,14 @@ const std::map<const StatusCode, const std::string> Status::statusMessageMap = {
     {StatusCode::PLUGIN_CONFIG_WRONG_FORMAT, "Plugin config is in wrong format"},
     {StatusCode::MODEL_VERSION_POLICY_WRONG_FORMAT, "Model version policy is in wrong format"},
     {StatusCode::MODEL_VERSION_POLICY_UNSUPPORTED_KEY, "Model version policy contains unsupported key"},
+    {StatusCode::DEVICE_CONCURRENCY_LIMITS_WRONG_FORMAT, "Device concurrency limits are in wrong format"},
     {StatusCode::RESHAPE_ERROR, "Model could not be reshaped with requested shape"},
+    {StatusCode::FORBIDDEN_MODEL_STATEFUL, "Stateful models are supported only in direct inference requests"},
     {StatusCode::ANONYMOUS_FIXED_SHAPE_NOT_ALLOWED, "Anonymous fixed shape is invalid for models with multiple inputs"},
     {StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE, "Cannot load network into target device"},
+    {StatusCode::WARMUP_DATA_INVALID, "Warm up data file is invalid or does not match model inputs"},
+    {StatusCode::CPU_AFFINITY_INVALID, "Requested NUMA node or CPU set is invalid or not available"},
+    {StatusCode::CPU_SET_RESERVED, "Requested CPUs are reserved exclusively by other model"},
     {StatusCode::MODEL_MISSING, "Model with requested name and/or version is not found"},
     {StatusCode::MODEL_NAME_MISSING, "Model with requested name is not found"},
     {StatusCode::PIPELINE_DEFINITION_NAME_MISSING, "Model with requested name is not found"},
@@ -43,6 +48,10 @@ const std::map<const StatusCode, const std::string> Status::statusMessageMap = {
     {StatusCode::PIPELINE_DEFINITION_NOT_LOADED_ANYMORE, "Pipeline is retired"},
     {StatusCode::PIPELINE_DEFINITION_NOT_LOADED_YET, "Pipeline is not loaded yet"},
     {StatusCode::MODEL_SPEC_MISSING, "model_spec missing in request"},
+    {StatusCode::STREAM_MODEL_SPEC_MISMATCH, "Requests of stream have to target the same model version"},
+    {StatusCode::CHUNKED_INPUT_OUT_OF_ORDER, "Chunks of input have to be sent in order"},
+    {StatusCode::MULTI_PREDICT_NO_REQUESTS, "Multi predict request has to list at least one model"},
+    {StatusCode::MULTI_PREDICT_TOO_MANY_REQUESTS, "Multi predict request lists more models than allowed"},
     {StatusCode::INVALID_SIGNATURE_DEF, "Invalid signature name"},
     {StatusCode::CONFIG_SHAPE_IS_NOT_IN_NETWORK, "Shape from config not found in network"},
     {StatusCode::INVALID_NIREQ, "Nireq parameter too high"},
@@ -56,6 +65,14 @@ const std::map<const StatusCode, const std::string> Status::statusMessageMap = {
     {StatusCode::INVALID_PRECISION, "Invalid input precision"},
     {StatusCode::INVALID_VALUE_COUNT, "Invalid number of values in tensor proto container"},
     {StatusCode::INVALID_CONTENT_SIZE, "Invalid content size of tensor proto"},
+    {StatusCode::IMAGE_PARSING_FAILED, "Image parsing failed"},
+
+    // Sequences of stateful models
+    {StatusCode::INVALID_SEQUENCE_ID, "Sequence id input is missing or is not a single uint64 value"},
+    {StatusCode::INVALID_SEQUENCE_CONTROL_INPUT, "Sequence control input is not a single uint32 value equal 0, 1 or 2"},
+    {StatusCode::SEQUENCE_MISSING, "Sequence with requested id does not exist"},
+    {StatusCode::SEQUENCE_ALREADY_EXISTS, "Sequence with requested id already exists"},
+    {StatusCode::MAX_SEQUENCE_NUMBER_REACHED, "Max number of started sequences of the model is reached"},
 
     // Deserialization
     {StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION, "Unsupported deserialization precision"},
@@ -63,6 +80,16 @@ const std::map<const StatusCode, const std::string> Status::statusMessageMap = {
 
     // Inference
     {StatusCode::OV_INTERNAL_INFERENCE_ERROR, "Internal inference error"},
+    {StatusCode::INFER_REQUESTS_QUEUE_FULL, "Too many requests are waiting for inference"},
+    {StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT, "Request was not scheduled for inference before its deadline"},
+    {StatusCode::REQUEST_CANCELLED, "Request was cancelled by the client"},
+    {StatusCode::PIPELINE_TIMEOUT, "Pipeline execution did not finish before its timeout"},
+    {StatusCode::PIPELINE_NODE_TIMEOUT, "Pipeline node execution did not finish before its timeout"},
+    {StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED, "Memory of requests in progress exceeds in flight memory budget"},
+    {StatusCode::REMOTE_INFERENCE_FAILED, "Inference on remote server failed"},
+    {StatusCode::PIPELINE_NODES_NOT_FUSED, "Pipeline nodes cannot be fused into single network"},
+    {StatusCode::CUSTOM_NODE_EXECUTION_FAILED, "Custom node library execution failed"},
+    {StatusCode::CUSTOM_NODE_INVALID_OUTPUT, "Custom node library returned invalid output"},
 
     // Serialization
     {StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION, "Unsupported serialization precision"},
@@ -91,6 +118,8 @@ const std::map<const StatusCode, const std::string> Status::statusMessageMap = {
     {StatusCode::REST_PROTO_TO_STRING_ERROR, "Response parsing to JSON error"},
     {StatusCode::REST_UNSUPPORTED_PRECISION, "Could not parse input content. Unsupported data precision detected"},
     {StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE, "Tensor serialization error"},
+    {StatusCode::REST_BINARY_HEADER_INVALID, "Invalid binary tensors request header"},
+    {StatusCode::REST_BINARY_DATA_SIZE_MISMATCH, "Binary tensors data size does not match inputs declared in header"},
 
     // Storage errors
     // S3
@@ -134,6 +163,30 @@ const std::map<const StatusCode, const std::string> Status::statusMessageMap = {
     {StatusCode::CUSTOM_LOADER_NOT_PRESENT, "The custom loader is not present in loaders list"},
     {StatusCode::CUSTOM_LOADER_INIT_FAILED, "Custom Loader LoadInit failed"},
     {StatusCode::CUSTOM_LOADER_ERROR, "Custom Loader Generic / Unknown Error"},
+
+    // Custom node library
+    {StatusCode::CUSTOM_NODE_LIBRARY_INVALID, "Custom node library not found or cannot open"},
+    {StatusCode::CUSTOM_NODE_LIBRARY_MISSING_FUNCTIONS, "Custom node library does not export execute and release functions"},
+
+    // Shared memory
+    {StatusCode::SHARED_MEMORY_REGION_ALREADY_EXISTS, "Shared memory region is already registered"},
+    {StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, "Shared memory region is not registered"},
+    {StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED, "Could not open shared memory segment"},
+    {StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS, "Tensor data exceeds shared memory region"},
+
+    // Tensor cache
+    {StatusCode::TENSOR_CACHE_DISABLED, "Tensor cache is disabled"},
+    {StatusCode::TENSOR_CACHE_TENSOR_TOO_LARGE, "Tensor exceeds tensor cache size"},
+    {StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND, "Tensor is not cached"},
+    {StatusCode::TENSOR_CACHE_TENSOR_MISMATCH, "Tensor reference does not match cached tensor"},
+
+    // Readiness
+    {StatusCode::SERVER_NOT_READY, "Server is not ready to receive requests"},
+    {StatusCode::SERVER_SHUTTING_DOWN, "Server is shutting down"},
+
+    // Profiling
+    {StatusCode::PROFILER_BUSY, "Other profile is being collected"},
+    {StatusCode::PROFILER_FAILED, "Could not start profiler"},
 };
 
 const std::map<const StatusCode, grpc::StatusCode> Status::grpcStatusMap = {
@@ -159,6 +212,10 @@ const std::map<const StatusCode, grpc::StatusCode> Status::grpcStatusMap = {
     {StatusCode::PIPELINE_DEFINITION_NOT_LOADED_ANYMORE, grpc::StatusCode::NOT_FOUND},
     {StatusCode::PIPELINE_DEFINITION_NOT_LOADED_YET, grpc::StatusCode::NOT_FOUND},
     {StatusCode::MODEL_SPEC_MISSING, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::STREAM_MODEL_SPEC_MISMATCH, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::CHUNKED_INPUT_OUT_OF_ORDER, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::MULTI_PREDICT_NO_REQUESTS, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::MULTI_PREDICT_TOO_MANY_REQUESTS, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_SIGNATURE_DEF, grpc::StatusCode::INVALID_ARGUMENT},
 
     // Predict request validation
@@ -170,6 +227,12 @@ const std::map<const StatusCode, grpc::StatusCode> Status::grpcStatusMap = {
     {StatusCode::INVALID_PRECISION, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_VALUE_COUNT, grpc::StatusCode::INVALID_ARGUMENT},
     {StatusCode::INVALID_CONTENT_SIZE, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::IMAGE_PARSING_FAILED, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::INVALID_SEQUENCE_ID, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::INVALID_SEQUENCE_CONTROL_INPUT, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::SEQUENCE_MISSING, grpc::StatusCode::NOT_FOUND},
+    {StatusCode::SEQUENCE_ALREADY_EXISTS, grpc::StatusCode::ALREADY_EXISTS},
+    {StatusCode::MAX_SEQUENCE_NUMBER_REACHED, grpc::StatusCode::UNAVAILABLE},
 
     // Deserialization
 
@@ -179,6 +242,16 @@ const std::map<const StatusCode, grpc::StatusCode> Status::grpcStatusMap = {
 
     // Inference
     {StatusCode::OV_INTERNAL_INFERENCE_ERROR, grpc::StatusCode::INTERNAL},
+    {StatusCode::INFER_REQUESTS_QUEUE_FULL, grpc::StatusCode::RESOURCE_EXHAUSTED},
+    {StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT, grpc::StatusCode::RESOURCE_EXHAUSTED},
+    {StatusCode::REQUEST_CANCELLED, grpc::StatusCode::CANCELLED},
+    {StatusCode::PIPELINE_TIMEOUT, grpc::StatusCode::DEADLINE_EXCEEDED},
+    {StatusCode::PIPELINE_NODE_TIMEOUT, grpc::StatusCode::DEADLINE_EXCEEDED},
+    {StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED, grpc::StatusCode::RESOURCE_EXHAUSTED},
+    {StatusCode::REMOTE_INFERENCE_FAILED, grpc::StatusCode::UNAVAILABLE},
+    {StatusCode::PIPELINE_NODES_NOT_FUSED, grpc::StatusCode::INTERNAL},
+    {StatusCode::CUSTOM_NODE_EXECUTION_FAILED, grpc::StatusCode::INTERNAL},
+    {StatusCode::CUSTOM_NODE_INVALID_OUTPUT, grpc::StatusCode::INTERNAL},
 
     // Serialization
 
@@ -188,6 +261,20 @@ const std::map<const StatusCode, grpc::StatusCode> Status::grpcStatusMap = {
 
     // GetModelStatus
     {StatusCode::INTERNAL_ERROR, grpc::StatusCode::INTERNAL},
+
+    // Shared memory
+    {StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, grpc::StatusCode::INVALID_ARGUMENT},
+    {StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS, grpc::StatusCode::INVALID_ARGUMENT},
+
+    // Tensor cache
+    {StatusCode::TENSOR_CACHE_DISABLED, grpc::StatusCode::FAILED_PRECONDITION},
+    {StatusCode::TENSOR_CACHE_TENSOR_TOO_LARGE, grpc::StatusCode::RESOURCE_EXHAUSTED},
+    {StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND, grpc::StatusCode::NOT_FOUND},
+    {StatusCode::TENSOR_CACHE_TENSOR_MISMATCH, grpc::StatusCode::INVALID_ARGUMENT},
+
+    // Readiness
+    {StatusCode::SERVER_NOT_READY, grpc::StatusCode::UNAVAILABLE},
+    {StatusCode::SERVER_SHUTTING_DOWN, grpc::StatusCode::UNAVAILABLE},
 };
 
 const std::map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap = {
@@ -213,6 +300,8 @@ const std::map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap
     {StatusCode::REST_PROTO_TO_STRING_ERROR, net_http::HTTPStatusCode::ERROR},
     {StatusCode::REST_UNSUPPORTED_PRECISION, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE, net_http::HTTPStatusCode::ERROR},
+    {StatusCode::REST_BINARY_HEADER_INVALID, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::REST_BINARY_DATA_SIZE_MISMATCH, net_http::HTTPStatusCode::BAD_REQUEST},
 
     {StatusCode::PATH_INVALID, net_http::HTTPStatusCode::ERROR},
     {StatusCode::FILE_INVALID, net_http::HTTPStatusCode::ERROR},
@@ -234,6 +323,10 @@ const std::map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap
     {StatusCode::PIPELINE_DEFINITION_NOT_LOADED_YET, net_http::HTTPStatusCode::NOT_FOUND},
     {StatusCode::PIPELINE_DEFINITION_NOT_LOADED_ANYMORE, net_http::HTTPStatusCode::NOT_FOUND},
     {StatusCode::MODEL_SPEC_MISSING, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::STREAM_MODEL_SPEC_MISMATCH, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::CHUNKED_INPUT_OUT_OF_ORDER, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::MULTI_PREDICT_NO_REQUESTS, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::MULTI_PREDICT_TOO_MANY_REQUESTS, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_SIGNATURE_DEF, net_http::HTTPStatusCode::BAD_REQUEST},
 
     // Predict request validation
@@ -245,6 +338,12 @@ const std::map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap
     {StatusCode::INVALID_PRECISION, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_VALUE_COUNT, net_http::HTTPStatusCode::BAD_REQUEST},
     {StatusCode::INVALID_CONTENT_SIZE, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::IMAGE_PARSING_FAILED, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::INVALID_SEQUENCE_ID, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::INVALID_SEQUENCE_CONTROL_INPUT, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SEQUENCE_MISSING, net_http::HTTPStatusCode::NOT_FOUND},
+    {StatusCode::SEQUENCE_ALREADY_EXISTS, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::MAX_SEQUENCE_NUMBER_REACHED, net_http::HTTPStatusCode::SERVICE_UNAV},
 
     // Deserialization
 
@@ -254,6 +353,16 @@ const std::map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap
 
     // Inference
     {StatusCode::OV_INTERNAL_INFERENCE_ERROR, net_http::HTTPStatusCode::ERROR},
+    {StatusCode::INFER_REQUESTS_QUEUE_FULL, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::REQUEST_CANCELLED, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::PIPELINE_TIMEOUT, net_http::HTTPStatusCode::GATEWAY_TO},
+    {StatusCode::PIPELINE_NODE_TIMEOUT, net_http::HTTPStatusCode::GATEWAY_TO},
+    {StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::REMOTE_INFERENCE_FAILED, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::PIPELINE_NODES_NOT_FUSED, net_http::HTTPStatusCode::ERROR},
+    {StatusCode::CUSTOM_NODE_EXECUTION_FAILED, net_http::HTTPStatusCode::ERROR},
+    {StatusCode::CUSTOM_NODE_INVALID_OUTPUT, net_http::HTTPStatusCode::ERROR},
 
     // Serialization
 
@@ -263,6 +372,34 @@ const std::map<const StatusCode, net_http::HTTPStatusCode> Status::httpStatusMap
 
     // GetModelStatus
     {StatusCode::INTERNAL_ERROR, net_http::HTTPStatusCode::ERROR},
+
+    // Shared memory
+    {StatusCode::SHARED_MEMORY_REGION_ALREADY_EXISTS, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SHARED_MEMORY_REGION_NOT_FOUND, net_http::HTTPStatusCode::NOT_FOUND},
+    {StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS, net_http::HTTPStatusCode::BAD_REQUEST},
+
+    // Tensor cache
+    {StatusCode::TENSOR_CACHE_DISABLED, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::TENSOR_CACHE_TENSOR_TOO_LARGE, net_http::HTTPStatusCode::BAD_REQUEST},
+    {StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND, net_http::HTTPStatusCode::NOT_FOUND},
+    {StatusCode::TENSOR_CACHE_TENSOR_MISMATCH, net_http::HTTPStatusCode::BAD_REQUEST},
+
+    // Readiness
+    {StatusCode::SERVER_NOT_READY, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::SERVER_SHUTTING_DOWN, net_http::HTTPStatusCode::SERVICE_UNAV},
+
+    // Profiling
+    {StatusCode::PROFILER_BUSY, net_http::HTTPStatusCode::SERVICE_UNAV},
+    {StatusCode::PROFILER_FAILED, net_http::HTTPStatusCode::ERROR},
 };
 
+const std::string& Status::getMessage(StatusCode code) {
+    static const std::string unknownErrorMessage = "Unknown error";
+    auto it = statusMessageMap.find(code);
+    if (it != statusMessageMap.end())
+        return it->second;
+    return unknownErrorMessage;
+}
+
 }  // namespace ovms
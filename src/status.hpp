@@ -16,6 +16,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -45,14 +46,19 @@ enum class StatusCode {
     MODEL_VERSION_POLICY_WRONG_FORMAT,    /*!< Model version policy is in wrong format */
     MODEL_VERSION_POLICY_UNSUPPORTED_KEY, /*!< Model version policy contains invalid key */
     GRPC_CHANNEL_ARG_WRONG_FORMAT,
+    DEVICE_CONCURRENCY_LIMITS_WRONG_FORMAT, /*!< Device concurrency limits are in wrong format */
     NO_MODEL_VERSION_AVAILABLE,             /*!< No model version found in path */
     RESHAPE_ERROR,                          /*!< Impossible to perform reshape */
     RESHAPE_REQUIRED,                       /*!< Model instance needs to be reloaded with new shape */
     BATCHSIZE_CHANGE_REQUIRED,              /*!< Model instance needs to be reloaded with new batch size */
     FORBIDDEN_MODEL_DYNAMIC_PARAMETER,      /*!< Value of the provided param is forbidden */
+    FORBIDDEN_MODEL_STATEFUL,               /*!< Stateful model is used where only stateless models are supported */
     ANONYMOUS_FIXED_SHAPE_NOT_ALLOWED,      /*!< Anonymous fixed shape is invalid for models with multiple inputs */
     CONFIG_SHAPE_IS_NOT_IN_NETWORK,         /*!< Invalid shape dimension number or dimension value */
     CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE, /*!< Cannot load network into target device */
+    WARMUP_DATA_INVALID,                    /*!< Warm up data file is invalid or does not match model inputs */
+    CPU_AFFINITY_INVALID,                   /*!< Requested NUMA node or CPU set is invalid or not available */
+    CPU_SET_RESERVED,                       /*!< Requested CPUs are reserved exclusively by other model */
 
     // Model management
     MODEL_MISSING,                    /*!< Model with such name and/or version does not exist */
@@ -72,13 +78,31 @@ enum class StatusCode {
     INVALID_PRECISION,              /*!< Invalid precision */
     INVALID_VALUE_COUNT,            /*!< Invalid value count error status for uint16 and half float data types */
     INVALID_CONTENT_SIZE,           /*!< Invalid content size error status for types using tensor_content() */
+    IMAGE_PARSING_FAILED,           /*!< Encoded image in string_val could not be decoded */
+
+    // Sequences of stateful models
+    INVALID_SEQUENCE_ID,            /*!< Sequence id input is missing or is not a single uint64 value */
+    INVALID_SEQUENCE_CONTROL_INPUT, /*!< Sequence control input is not a single known uint32 value */
+    SEQUENCE_MISSING,               /*!< Sequence with requested id does not exist or was removed as idle */
+    SEQUENCE_ALREADY_EXISTS,        /*!< Sequence with requested id is already started */
+    MAX_SEQUENCE_NUMBER_REACHED,    /*!< Infer requests of model are all held by started sequences */
 
     // Deserialization
     OV_UNSUPPORTED_DESERIALIZATION_PRECISION, /*!< Unsupported deserialization precision, theoretically should never be returned since ModelInstance::validation checks against network precision */
     OV_INTERNAL_DESERIALIZATION_ERROR,        /*!< Error occured during deserialization */
 
     // Inference
-    OV_INTERNAL_INFERENCE_ERROR, /*!< Error occured during inference */
+    OV_INTERNAL_INFERENCE_ERROR,  /*!< Error occured during inference */
+    INFER_REQUESTS_QUEUE_FULL,    /*!< Too many requests are waiting for infer request */
+    INFER_REQUESTS_QUEUE_TIMEOUT, /*!< Infer request was not available before request deadline */
+    REQUEST_CANCELLED,            /*!< Client cancelled request before inference was started */
+    PIPELINE_TIMEOUT,             /*!< Pipeline execution did not finish before pipeline timeout */
+    PIPELINE_NODE_TIMEOUT,        /*!< Pipeline node execution did not finish before node timeout */
+    IN_FLIGHT_MEMORY_EXHAUSTED,   /*!< Memory buffered by requests in progress would exceed budget */
+    REMOTE_INFERENCE_FAILED,      /*!< Remote server did not return results of pipeline node inference */
+    PIPELINE_NODES_NOT_FUSED,     /*!< Chain of pipeline nodes cannot be compiled into single network */
+    CUSTOM_NODE_EXECUTION_FAILED, /*!< Custom node library returned error */
+    CUSTOM_NODE_INVALID_OUTPUT,   /*!< Custom node library returned output of unsupported precision or inconsistent size */
 
     // Serialization
     OV_UNSUPPORTED_SERIALIZATION_PRECISION, /*!< Unsupported serializaton precision */
@@ -88,7 +112,11 @@ enum class StatusCode {
     INVALID_SIGNATURE_DEF, /*!< Requested signature is not supported */
 
     // Common request validation errors
-    MODEL_SPEC_MISSING, /*!< Request lacks model_spec */
+    MODEL_SPEC_MISSING,              /*!< Request lacks model_spec */
+    STREAM_MODEL_SPEC_MISMATCH,      /*!< Request of stream targets other model version than previous ones */
+    CHUNKED_INPUT_OUT_OF_ORDER,      /*!< Chunk of input does not continue content already received */
+    MULTI_PREDICT_NO_REQUESTS,       /*!< Multi predict request does not list any model */
+    MULTI_PREDICT_TOO_MANY_REQUESTS, /*!< Multi predict request lists more models than allowed */
 
     INTERNAL_ERROR,
 
@@ -153,6 +181,8 @@ enum class StatusCode {
     REST_PROTO_TO_STRING_ERROR,          /*!< Error while parsing ResponseProto to JSON string */
     REST_UNSUPPORTED_PRECISION,          /*!< Unsupported conversion from tensor_content to _val container */
     REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE,
+    REST_BINARY_HEADER_INVALID,          /*!< Invalid JSON header of binary tensors request */
+    REST_BINARY_DATA_SIZE_MISMATCH,      /*!< Binary tensors data size does not match shapes declared in header */
 
     PIPELINE_DEFINITION_ALREADY_EXIST,
     PIPELINE_NODE_WRONG_KIND_CONFIGURATION,
@@ -174,6 +204,7 @@ enum class StatusCode {
     PIPELINE_NOT_ALL_INPUTS_CONNECTED,
     PIPELINE_MODEL_INPUT_CONNECTED_TO_MULTIPLE_DATA_SOURCES,
     PIPELINE_EXIT_USED_AS_NODE_DEPENDENCY,
+    PIPELINE_NODE_INVALID_PARAMETERS,
 
     // Custom Loader
     CUSTOM_LOADER_LIBRARY_INVALID,
@@ -182,34 +213,53 @@ enum class StatusCode {
     CUSTOM_LOADER_NOT_PRESENT,
     CUSTOM_LOADER_INIT_FAILED,
     CUSTOM_LOADER_ERROR,
+
+    // Custom node library
+    CUSTOM_NODE_LIBRARY_INVALID,
+    CUSTOM_NODE_LIBRARY_MISSING_FUNCTIONS,
+
+    // Shared memory
+    SHARED_MEMORY_REGION_ALREADY_EXISTS, /*!< Shared memory region with such name is already registered */
+    SHARED_MEMORY_REGION_NOT_FOUND,      /*!< Shared memory region with such name is not registered */
+    SHARED_MEMORY_REGION_OPEN_FAILED,    /*!< Shared memory segment could not be opened or mapped */
+    SHARED_MEMORY_REGION_OUT_OF_BOUNDS,  /*!< Tensor data exceeds shared memory region */
+
+    // Tensor cache
+    TENSOR_CACHE_DISABLED,         /*!< Tensor cache size is not configured */
+    TENSOR_CACHE_TENSOR_TOO_LARGE, /*!< Uploaded tensor exceeds tensor cache size */
+    TENSOR_CACHE_TENSOR_NOT_FOUND, /*!< Tensor with such handle is not cached, it was released or evicted */
+    TENSOR_CACHE_TENSOR_MISMATCH,  /*!< Reference dtype or shape does not match cached tensor */
+
+    // Readiness
+    SERVER_NOT_READY,     /*!< Infer requests queue pressure of critical model exceeds readiness thresholds */
+    SERVER_SHUTTING_DOWN, /*!< Request could not be scheduled since server is shutting down */
+
+    // Profiling
+    PROFILER_BUSY,   /*!< Other profile is being collected */
+    PROFILER_FAILED, /*!< Profiler could not be started */
 };
 
 class Status {
     StatusCode code;
-    std::string message;
+
+    /**
+     * @brief Message with details, allocated only for statuses created with details and shared by copies
+     */
+    std::shared_ptr<const std::string> detailedMessage;
 
     static const std::map<const StatusCode, const std::string> statusMessageMap;
     static const std::map<const StatusCode, grpc::StatusCode> grpcStatusMap;
     static const std::map<const StatusCode, net_http::HTTPStatusCode> httpStatusMap;
 
-    void appendDetails(const std::string& details) {
-        this->message += " - " + details;
-    }
+    static const std::string& getMessage(StatusCode code);
 
 public:
     Status(StatusCode code = StatusCode::OK) :
-        code(code) {
-        auto it = statusMessageMap.find(code);
-        if (it != statusMessageMap.end())
-            this->message = it->second;
-        else
-            this->message = "Unknown error";
-    }
+        code(code) {}
 
     Status(StatusCode code, const std::string& details) :
-        Status(code) {
-        appendDetails(details);
-    }
+        code(code),
+        detailedMessage(std::make_shared<const std::string>(getMessage(code) + " - " + details)) {}
 
     bool ok() const {
         return code == StatusCode::OK;
@@ -238,7 +288,7 @@ public:
     const grpc::Status grpc() const {
         auto it = grpcStatusMap.find(code);
         if (it != grpcStatusMap.end()) {
-            return grpc::Status(it->second, this->message);
+            return grpc::Status(it->second, string());
         } else {
             return grpc::Status(grpc::StatusCode::UNKNOWN, "Unknown error");
         }
@@ -249,7 +299,7 @@ public:
     }
 
     const std::string& string() const {
-        return this->message;
+        return detailedMessage ? *detailedMessage : getMessage(code);
     }
 
     operator const std::string&() const {
@@ -0,0 +1,174 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "statussnapshot.hpp"
+
+#include <utility>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace ovms {
+
+void StatusSnapshot::updateModelVersion(const std::string& modelName, int64_t version, const std::string& state, const std::string& errorCode) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& entry = modelVersions[modelName][version];
+    if (entry.state == state && entry.errorCode == errorCode) {
+        return;
+    }
+    entry.state = state;
+    entry.errorCode = errorCode;
+    serialized.reset();
+    recordChange(modelName, false, version, state, errorCode);
+}
+
+void StatusSnapshot::removeModel(const std::string& modelName) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (modelVersions.erase(modelName) == 0) {
+        return;
+    }
+    serialized.reset();
+}
+
+void StatusSnapshot::updatePipeline(const std::string& pipelineName, const std::string& state) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& entry = pipelines[pipelineName];
+    if (entry == state) {
+        return;
+    }
+    entry = state;
+    serialized.reset();
+    recordChange(pipelineName, true, 0, state, "");
+}
+
+void StatusSnapshot::recordChange(const std::string& name, bool pipeline, int64_t version, const std::string& state, const std::string& errorCode) {
+    changes.push_back({++sequence, name, pipeline, version, state, errorCode});
+    if (changes.size() > MAX_RETAINED_CHANGES) {
+        changes.pop_front();
+    }
+    notifyLocked();
+}
+
+void StatusSnapshot::notifyLocked() {
+    changed.notify_all();
+    for (const auto& [id, listener] : listeners) {
+        listener();
+    }
+}
+
+void StatusSnapshot::getStatesLocked(std::vector<StatusTransition>& states) const {
+    for (const auto& [modelName, versions] : modelVersions) {
+        for (const auto& [version, entry] : versions) {
+            states.push_back({sequence, modelName, false, version, entry.state, entry.errorCode});
+        }
+    }
+    for (const auto& [pipelineName, state] : pipelines) {
+        states.push_back({sequence, pipelineName, true, 0, state, ""});
+    }
+}
+
+uint64_t StatusSnapshot::getStates(std::vector<StatusTransition>& states) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    getStatesLocked(states);
+    return sequence;
+}
+
+bool StatusSnapshot::waitForChanges(uint64_t& lastSequence, std::vector<StatusTransition>& newChanges, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mtx);
+    changed.wait_for(lock, timeout, [this, lastSequence]() { return watchingStopped || sequence > lastSequence; });
+    if (watchingStopped) {
+        return false;
+    }
+    if (sequence == lastSequence) {
+        return true;
+    }
+    if (changes.front().sequence > lastSequence + 1) {
+        getStatesLocked(newChanges);
+    } else {
+        for (auto it = changes.begin() + (lastSequence + 1 - changes.front().sequence); it != changes.end(); ++it) {
+            newChanges.push_back(*it);
+        }
+    }
+    lastSequence = sequence;
+    return true;
+}
+
+size_t StatusSnapshot::addListener(std::function<void()> listener) {
+    std::lock_guard<std::mutex> lock(mtx);
+    listeners.emplace(nextListenerId, std::move(listener));
+    return nextListenerId++;
+}
+
+void StatusSnapshot::removeListener(size_t id) {
+    std::lock_guard<std::mutex> lock(mtx);
+    listeners.erase(id);
+}
+
+void StatusSnapshot::stopWatching() {
+    std::lock_guard<std::mutex> lock(mtx);
+    watchingStopped = true;
+    notifyLocked();
+}
+
+std::shared_ptr<const std::string> StatusSnapshot::getJson() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!serialized) {
+        serialized = serialize();
+    }
+    return serialized;
+}
+
+std::shared_ptr<const std::string> StatusSnapshot::serialize() const {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("models");
+    writer.StartArray();
+    for (const auto& [modelName, versions] : modelVersions) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(modelName.c_str());
+        writer.Key("versions");
+        writer.StartArray();
+        for (const auto& [version, entry] : versions) {
+            writer.StartObject();
+            writer.Key("version");
+            writer.Int64(version);
+            writer.Key("state");
+            writer.String(entry.state.c_str());
+            writer.Key("error_code");
+            writer.String(entry.errorCode.c_str());
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("pipelines");
+    writer.StartArray();
+    for (const auto& [pipelineName, state] : pipelines) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(pipelineName.c_str());
+        writer.Key("state");
+        writer.String(state.c_str());
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return std::make_shared<const std::string>(buffer.GetString(), buffer.GetSize());
+}
+
+}  // namespace ovms
@@ -0,0 +1,134 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ovms {
+
+/**
+ * @brief State of model version or pipeline after its transition
+ */
+struct StatusTransition {
+    uint64_t sequence;
+    std::string name;
+    bool pipeline;
+    // 0 for pipelines
+    int64_t version;
+    std::string state;
+    std::string errorCode;
+};
+
+/**
+ * @brief States of all model versions and pipelines, updated on their state transitions
+ *
+ * Serves monitoring of whole server with single request instead of querying each model status, JSON response is
+ * serialized once after a transition and shared by requests until the next one. Recent transitions are retained
+ * for watchers streaming them.
+ */
+class StatusSnapshot {
+    struct ModelVersionEntry {
+        std::string state;
+        std::string errorCode;
+    };
+
+    std::map<std::string, std::map<int64_t, ModelVersionEntry>> modelVersions;
+    std::map<std::string, std::string> pipelines;
+    std::shared_ptr<const std::string> serialized;
+    std::deque<StatusTransition> changes;
+    uint64_t sequence = 0;
+    bool watchingStopped = false;
+    std::map<size_t, std::function<void()>> listeners;
+    size_t nextListenerId = 0;
+    mutable std::mutex mtx;
+    std::condition_variable changed;
+
+    void notifyLocked();
+
+    std::shared_ptr<const std::string> serialize() const;
+    void recordChange(const std::string& name, bool pipeline, int64_t version, const std::string& state, const std::string& errorCode);
+    void getStatesLocked(std::vector<StatusTransition>& states) const;
+
+public:
+    static constexpr size_t MAX_RETAINED_CHANGES = 1024;
+
+    static StatusSnapshot& getInstance() {
+        static StatusSnapshot instance;
+        return instance;
+    }
+
+    void updateModelVersion(const std::string& modelName, int64_t version, const std::string& state, const std::string& errorCode);
+    void updatePipeline(const std::string& pipelineName, const std::string& state);
+
+    /**
+     * @brief Removes all versions of model deleted from configuration, watchers already received their last transitions
+     */
+    void removeModel(const std::string& modelName);
+
+    /**
+     * @brief Gets states in JSON format:
+     * {"models": [{"name": ..., "versions": [{"version": ..., "state": ..., "error_code": ...}]}], "pipelines": [{"name": ..., "state": ...}]}
+     */
+    std::shared_ptr<const std::string> getJson();
+
+    /**
+     * @brief Gets current states of all model versions and pipelines
+     *
+     * @return sequence number of the last transition reflected in states
+     */
+    uint64_t getStates(std::vector<StatusTransition>& states) const;
+
+    /**
+     * @brief Waits until states change after given sequence number or timeout expires
+     *
+     * Fills transitions newer than lastSequence in their order and advances lastSequence to the last of them. When some of
+     * them are no longer retained, current states of all model versions and pipelines are filled instead, so that
+     * watcher falling behind misses intermediate states only.
+     *
+     * @return false once watching is stopped
+     */
+    bool waitForChanges(uint64_t& lastSequence, std::vector<StatusTransition>& newChanges, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Adds callback notified after each transition and once watching is stopped, for watchers not waiting on a thread
+     *
+     * Listener is called with snapshot lock held, so it must not call snapshot, it should only wake up its watcher.
+     *
+     * @return id of listener to remove it with
+     */
+    size_t addListener(std::function<void()> listener);
+
+    /**
+     * @brief Removes listener, it is not called anymore once this returns
+     */
+    void removeListener(size_t id);
+
+    /**
+     * @brief Wakes up and stops all watchers, called on server shutdown
+     */
+    void stopWatching();
+};
+
+}  // namespace ovms
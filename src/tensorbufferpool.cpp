@@ -0,0 +1,211 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "tensorbufferpool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+namespace ovms {
+
+std::shared_ptr<TensorBufferPool> TensorBufferPool::getInstance() {
+    static std::shared_ptr<TensorBufferPool> instance = std::make_shared<TensorBufferPool>();
+    return instance;
+}
+
+TensorBufferPool::~TensorBufferPool() {
+    for (auto& [sizeClass, buffers] : freeBuffers) {
+        for (auto* buffer : buffers) {
+            releaseBuffer(buffer);
+        }
+    }
+}
+
+void TensorBufferPool::configure(size_t maxCachedBytes, bool useHugePages) {
+    std::vector<Buffer*> released;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        this->maxCachedBytes = maxCachedBytes;
+        this->useHugePages = useHugePages;
+        for (auto& [sizeClass, buffers] : freeBuffers) {
+            released.insert(released.end(), buffers.begin(), buffers.end());
+        }
+        freeBuffers.clear();
+        cachedBytes = 0;
+    }
+    for (auto* buffer : released) {
+        releaseBuffer(buffer);
+    }
+}
+
+size_t TensorBufferPool::getSizeClass(size_t size) {
+    if (size <= ALIGNMENT) {
+        return ALIGNMENT;
+    }
+    size_t power = ALIGNMENT;
+    while (power * 2 < size) {
+        power *= 2;
+    }
+    const size_t step = std::max(power / 4, ALIGNMENT);
+    return (size + step - 1) / step * step;
+}
+
+void* TensorBufferPool::lock(void* handle, InferenceEngine::LockOp) noexcept {
+    return static_cast<Buffer*>(handle)->data;
+}
+
+void TensorBufferPool::unlock(void*) noexcept {}
+
+void* TensorBufferPool::alloc(size_t size) noexcept {
+    const size_t sizeClass = getSizeClass(size);
+    bool hugePages;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = freeBuffers.find(sizeClass);
+        if (it != freeBuffers.end() && !it->second.empty()) {
+            Buffer* buffer = it->second.back();
+            it->second.pop_back();
+            cachedBytes -= sizeClass;
+            return buffer;
+        }
+        hugePages = useHugePages && sizeClass >= HUGE_PAGE_SIZE;
+    }
+    return allocateBuffer(sizeClass, hugePages);
+}
+
+bool TensorBufferPool::free(void* handle) noexcept {
+    Buffer* buffer = static_cast<Buffer*>(handle);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (cachedBytes + buffer->size <= maxCachedBytes) {
+            try {
+                freeBuffers[buffer->size].push_back(buffer);
+                cachedBytes += buffer->size;
+                return true;
+            } catch (std::bad_alloc&) {
+            }
+        }
+    }
+    releaseBuffer(buffer);
+    return true;
+}
+
+size_t TensorBufferPool::getCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return cachedBytes;
+}
+
+size_t TensorBufferPool::getHugePagesBytes() const {
+    return hugePagesBytes;
+}
+
+TensorBufferPool::Buffer* TensorBufferPool::allocateBuffer(size_t size, bool hugePages) {
+    void* data = nullptr;
+    size_t mappedSize = size;
+    if (hugePages) {
+        // mapping from hugepages must be a multiple of page size
+        mappedSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        data = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (data == MAP_FAILED) {
+            SPDLOG_DEBUG("Failed to map {} bytes from hugepages, using regular pages", mappedSize);
+            data = nullptr;
+            mappedSize = size;
+            hugePages = false;
+        }
+    }
+    if (data == nullptr) {
+        data = std::aligned_alloc(ALIGNMENT, size);
+        if (data == nullptr) {
+            return nullptr;
+        }
+    }
+    auto* buffer = new (std::nothrow) Buffer{data, size, mappedSize, hugePages};
+    if (buffer == nullptr) {
+        releaseMemory(data, mappedSize, hugePages);
+        return nullptr;
+    }
+    if (hugePages) {
+        hugePagesBytes += mappedSize;
+    }
+    return buffer;
+}
+
+void TensorBufferPool::releaseBuffer(Buffer* buffer) {
+    releaseMemory(buffer->data, buffer->mappedSize, buffer->hugePages);
+    if (buffer->hugePages) {
+        hugePagesBytes -= buffer->mappedSize;
+    }
+    delete buffer;
+}
+
+void TensorBufferPool::releaseMemory(void* data, size_t size, bool hugePages) {
+    if (hugePages) {
+        munmap(data, size);
+    } else {
+        std::free(data);
+    }
+}
+
+namespace {
+template <typename T>
+InferenceEngine::Blob::Ptr makePooledBlob(const InferenceEngine::TensorDesc& desc, const std::shared_ptr<TensorBufferPool>& pool) {
+    auto blob = InferenceEngine::make_shared_blob<T>(desc, std::static_pointer_cast<InferenceEngine::IAllocator>(pool));
+    blob->allocate();
+    return blob;
+}
+}  // namespace
+
+InferenceEngine::Blob::Ptr createPooledBlob(const InferenceEngine::TensorDesc& desc) {
+    return createPooledBlob(desc, TensorBufferPool::getInstance());
+}
+
+InferenceEngine::Blob::Ptr createPooledBlob(const InferenceEngine::TensorDesc& desc, const std::shared_ptr<TensorBufferPool>& pool) {
+    switch (desc.getPrecision()) {
+    case InferenceEngine::Precision::FP32:
+        return makePooledBlob<float>(desc, pool);
+    case InferenceEngine::Precision::FP16:
+    case InferenceEngine::Precision::U16:
+        return makePooledBlob<uint16_t>(desc, pool);
+    case InferenceEngine::Precision::I16:
+        return makePooledBlob<int16_t>(desc, pool);
+    case InferenceEngine::Precision::U8:
+    case InferenceEngine::Precision::BOOL:
+        return makePooledBlob<uint8_t>(desc, pool);
+    case InferenceEngine::Precision::I8:
+        return makePooledBlob<int8_t>(desc, pool);
+    case InferenceEngine::Precision::I32:
+        return makePooledBlob<int32_t>(desc, pool);
+    case InferenceEngine::Precision::I64:
+        return makePooledBlob<int64_t>(desc, pool);
+    default: {
+        auto blob = InferenceEngine::Blob::CreateFromData(std::make_shared<InferenceEngine::Data>("", desc));
+        blob->allocate();
+        return blob;
+    }
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,104 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+namespace ovms {
+
+/**
+ * @brief Pool of 64 bytes aligned buffers used as memory of blobs allocated by server, e.g. node outputs and converted inputs.
+ * Buffers are grouped in size classes and kept for reuse when blob using them is released, up to configured size of the pool.
+ */
+class TensorBufferPool : public InferenceEngine::IAllocator {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /**
+     * @brief Gets the pool shared by all blobs created with createPooledBlob
+     */
+    static std::shared_ptr<TensorBufferPool> getInstance();
+
+    TensorBufferPool() = default;
+    ~TensorBufferPool();
+
+    /**
+     * @brief Sets configuration of the pool, applied to buffers allocated afterwards
+     *
+     * @param maxCachedBytes maximum size of released buffers kept for reuse, 0 disables reuse
+     * @param useHugePages whether buffers of at least HUGE_PAGE_SIZE are mapped from 2MB hugepages
+     */
+    void configure(size_t maxCachedBytes, bool useHugePages);
+
+    void* lock(void* handle, InferenceEngine::LockOp op = InferenceEngine::LOCK_FOR_WRITE) noexcept override;
+    void unlock(void* handle) noexcept override;
+    void* alloc(size_t size) noexcept override;
+    bool free(void* handle) noexcept override;
+    void Release() noexcept override {}
+
+    /**
+     * @brief Gets size of buffers released and kept for reuse
+     */
+    size_t getCachedBytes() const;
+
+    /**
+     * @brief Gets size of buffers currently mapped from hugepages
+     */
+    size_t getHugePagesBytes() const;
+
+    /**
+     * @brief Gets size of the buffer allocated for requested size, 25% above it at most for sizes above 256 bytes
+     */
+    static size_t getSizeClass(size_t size);
+
+private:
+    struct Buffer {
+        void* data;
+        size_t size;
+        size_t mappedSize;
+        bool hugePages;
+    };
+
+    Buffer* allocateBuffer(size_t size, bool hugePages);
+    void releaseBuffer(Buffer* buffer);
+    static void releaseMemory(void* data, size_t size, bool hugePages);
+
+    mutable std::mutex mtx;
+    std::unordered_map<size_t, std::vector<Buffer*>> freeBuffers;
+    size_t cachedBytes = 0;
+    std::atomic<size_t> hugePagesBytes{0};
+    size_t maxCachedBytes = 0;
+    bool useHugePages = false;
+};
+
+/**
+ * @brief Creates blob with allocated memory taken from TensorBufferPool
+ */
+InferenceEngine::Blob::Ptr createPooledBlob(const InferenceEngine::TensorDesc& desc);
+
+/**
+ * @brief Creates blob with allocated memory taken from given pool
+ */
+InferenceEngine::Blob::Ptr createPooledBlob(const InferenceEngine::TensorDesc& desc, const std::shared_ptr<TensorBufferPool>& pool);
+
+}  // namespace ovms
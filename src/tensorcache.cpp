@@ -0,0 +1,204 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "tensorcache.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "ov_utils.hpp"
+#include "precisionconversion.hpp"
+
+namespace ovms {
+
+Status CachedTensor::create(const std::string& handle, const tensorflow::TensorProto& proto, std::shared_ptr<const CachedTensor>& tensor) {
+    const auto& conversion = getDataTypeConversion(proto.dtype());
+    if (!conversion.nativeContent) {
+        SPDLOG_DEBUG("Unsupported precision of cached tensor:{}", handle);
+        return StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+    }
+    InferenceEngine::SizeVector shape;
+    size_t valueCount = 1;
+    for (int i = 0; i < proto.tensor_shape().dim_size(); i++) {
+        const auto dim = proto.tensor_shape().dim(i).size();
+        if (dim < 0 || __builtin_mul_overflow(valueCount, static_cast<size_t>(dim), &valueCount)) {
+            SPDLOG_DEBUG("Invalid shape of cached tensor:{}", handle);
+            return StatusCode::INVALID_SHAPE;
+        }
+        shape.emplace_back(dim);
+    }
+    size_t byteSize = 0;
+    if (__builtin_mul_overflow(valueCount, InferenceEngine::Precision(conversion.precision).size(), &byteSize) || byteSize == 0) {
+        SPDLOG_DEBUG("Invalid shape of cached tensor:{}", handle);
+        return StatusCode::INVALID_SHAPE;
+    }
+    std::string data;
+    if (proto.tensor_content().empty() && (conversion.requestField == TensorProtoField::HALF_VAL || conversion.requestField == TensorProtoField::INT_VAL)) {
+        // Values are narrowed from zero padded half_val or int_val container
+        if (conversion.countValues(proto) != valueCount) {
+            std::stringstream ss;
+            ss << "Expected: " << valueCount << "; Actual: " << conversion.countValues(proto);
+            return Status(StatusCode::INVALID_VALUE_COUNT, ss.str());
+        }
+        data.resize(byteSize);
+        conversion.copyValues(proto, data.data());
+    } else {
+        if (proto.tensor_content().size() != byteSize) {
+            std::stringstream ss;
+            ss << "Expected: " << byteSize << " bytes; Actual: " << proto.tensor_content().size() << " bytes";
+            return Status(StatusCode::INVALID_CONTENT_SIZE, ss.str());
+        }
+        data = proto.tensor_content();
+    }
+    tensor = std::make_shared<const CachedTensor>(handle, proto.dtype(), std::move(shape), std::move(data));
+    return StatusCode::OK;
+}
+
+void TensorCache::evict(size_t requiredBytes) {
+    while (!lru.empty() && byteSize + requiredBytes > capacity) {
+        const auto& tensor = lru.back();
+        SPDLOG_DEBUG("Evicting cached tensor:{} byte size:{}", tensor->getHandle(), tensor->getByteSize());
+        byteSize -= tensor->getByteSize();
+        tensors.erase(tensor->getHandle());
+        lru.pop_back();
+    }
+}
+
+void TensorCache::configure(size_t capacity) {
+    std::unique_lock lock(mtx);
+    this->capacity = capacity;
+    evict(0);
+}
+
+Status TensorCache::upload(const tensorflow::TensorProto& proto, std::string& handle) {
+    {
+        std::unique_lock lock(mtx);
+        if (capacity == 0) {
+            SPDLOG_DEBUG("Tensor cannot be uploaded, tensor cache is disabled");
+            return StatusCode::TENSOR_CACHE_DISABLED;
+        }
+        do {
+            char buffer[17];
+            std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(handleGenerator()));
+            handle = buffer;
+        } while (tensors.count(handle) > 0);
+    }
+    // Conversion of large tensor does not block lookups of other requests
+    std::shared_ptr<const CachedTensor> tensor;
+    auto status = CachedTensor::create(handle, proto, tensor);
+    if (!status.ok()) {
+        return status;
+    }
+    std::unique_lock lock(mtx);
+    if (tensor->getByteSize() > capacity) {
+        std::stringstream ss;
+        ss << "Tensor byte size: " << tensor->getByteSize() << "; Tensor cache byte size: " << capacity;
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Tensor cannot be uploaded - {}", details);
+        return Status(StatusCode::TENSOR_CACHE_TENSOR_TOO_LARGE, details);
+    }
+    evict(tensor->getByteSize());
+    byteSize += tensor->getByteSize();
+    lru.push_front(std::move(tensor));
+    tensors.emplace(handle, lru.begin());
+    SPDLOG_DEBUG("Uploaded cached tensor:{} byte size:{}", handle, lru.front()->getByteSize());
+    return StatusCode::OK;
+}
+
+Status TensorCache::release(const std::string& handle) {
+    std::unique_lock lock(mtx);
+    auto it = tensors.find(handle);
+    if (it == tensors.end()) {
+        SPDLOG_DEBUG("Cached tensor:{} is not found", handle);
+        return StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND;
+    }
+    byteSize -= (*it->second)->getByteSize();
+    lru.erase(it->second);
+    tensors.erase(it);
+    SPDLOG_DEBUG("Released cached tensor:{}", handle);
+    return StatusCode::OK;
+}
+
+std::shared_ptr<const CachedTensor> TensorCache::find(const std::string& handle) {
+    std::unique_lock lock(mtx);
+    auto it = tensors.find(handle);
+    if (it == tensors.end()) {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    return *it->second;
+}
+
+size_t TensorCache::getByteSize() const {
+    std::unique_lock lock(mtx);
+    return byteSize;
+}
+
+size_t TensorCache::getTensorsCount() const {
+    std::unique_lock lock(mtx);
+    return tensors.size();
+}
+
+bool isCachedTensorReference(const tensorflow::TensorProto& proto) {
+    return proto.resource_handle_val_size() == 1 && proto.resource_handle_val(0).container() == TENSOR_CACHE_CONTAINER;
+}
+
+Status getCachedTensorData(const tensorflow::TensorProto& proto, size_t byteSize, std::shared_ptr<const CachedTensor>& tensor, const char*& data) {
+    const auto& handle = proto.resource_handle_val(0).name();
+    tensor = TensorCache::getInstance().find(handle);
+    if (tensor == nullptr) {
+        SPDLOG_DEBUG("Tensor refers to not cached tensor:{}", handle);
+        return Status(StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND, "Handle: " + handle);
+    }
+    bool shapeMatches = static_cast<size_t>(proto.tensor_shape().dim_size()) == tensor->getShape().size();
+    for (int i = 0; shapeMatches && i < proto.tensor_shape().dim_size(); i++) {
+        shapeMatches = proto.tensor_shape().dim(i).size() >= 0 && static_cast<size_t>(proto.tensor_shape().dim(i).size()) == tensor->getShape()[i];
+    }
+    if (proto.dtype() != tensor->getDataType() || !shapeMatches || byteSize != tensor->getByteSize()) {
+        std::stringstream ss;
+        ss << "Handle: " << handle << " byte size: " << tensor->getByteSize() << "; Tensor byte size: " << byteSize;
+        const std::string details = ss.str();
+        SPDLOG_DEBUG("Tensor does not match cached tensor - {}", details);
+        return Status(StatusCode::TENSOR_CACHE_TENSOR_MISMATCH, details);
+    }
+    data = tensor->getData();
+    return StatusCode::OK;
+}
+
+Status createCachedTensorBlob(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc, InferenceEngine::Blob::Ptr& blob) {
+    size_t byteSize = desc.getPrecision().size();
+    for (size_t dim : desc.getDims()) {
+        if (__builtin_mul_overflow(byteSize, dim, &byteSize)) {
+            SPDLOG_DEBUG("Cached tensor dimensions are too big");
+            return StatusCode::INVALID_SHAPE;
+        }
+    }
+    std::shared_ptr<const CachedTensor> tensor;
+    const char* data = nullptr;
+    auto status = getCachedTensorData(proto, byteSize, tensor, data);
+    if (!status.ok()) {
+        return status;
+    }
+    blob = createExternalMemoryBlob(desc, std::move(tensor), data);
+    if (!blob) {
+        return StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION;
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
@@ -0,0 +1,138 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <inference_engine.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Container of resource handle referring to tensor uploaded to tensor cache
+ *
+ * Tensor proto of such input has dtype and tensor_shape of the uploaded tensor set as usual, empty content and single
+ * resource_handle_val with this container and handle returned by upload as name.
+ */
+const std::string TENSOR_CACHE_CONTAINER = "ovms_tensor_cache";
+
+/**
+ * @brief Tensor uploaded by client, values are kept in native width so that blobs of any model input of matching precision point to them
+ */
+class CachedTensor {
+    std::string handle;
+    tensorflow::DataType dtype;
+    InferenceEngine::SizeVector shape;
+    std::string data;
+
+public:
+    CachedTensor(const std::string& handle, tensorflow::DataType dtype, InferenceEngine::SizeVector shape, std::string data) :
+        handle(handle),
+        dtype(dtype),
+        shape(std::move(shape)),
+        data(std::move(data)) {}
+
+    CachedTensor(const CachedTensor&) = delete;
+    CachedTensor& operator=(const CachedTensor&) = delete;
+
+    /**
+     * @brief Converts tensor proto to native width values, only precisions with native tensor content are supported
+     */
+    static Status create(const std::string& handle, const tensorflow::TensorProto& proto, std::shared_ptr<const CachedTensor>& tensor);
+
+    const std::string& getHandle() const { return handle; }
+    tensorflow::DataType getDataType() const { return dtype; }
+    const InferenceEngine::SizeVector& getShape() const { return shape; }
+    size_t getByteSize() const { return data.size(); }
+    const char* getData() const { return data.data(); }
+};
+
+/**
+ * @brief Tensors uploaded by clients, keyed by handle. Least recently used tensors are evicted once their size exceeds capacity.
+ *
+ * Evicted or released tensor stays in memory until blobs of requests referring to it are released.
+ */
+class TensorCache {
+    using LruList = std::list<std::shared_ptr<const CachedTensor>>;
+
+    LruList lru;
+    std::unordered_map<std::string, LruList::iterator> tensors;
+    size_t capacity = 0;
+    size_t byteSize = 0;
+    std::mt19937_64 handleGenerator{std::random_device{}()};
+    mutable std::mutex mtx;
+
+    void evict(size_t requiredBytes);
+
+public:
+    static TensorCache& getInstance() {
+        static TensorCache instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets maximum size of cached tensors, 0 disables uploads. Tensors above new capacity are evicted.
+     */
+    void configure(size_t capacity);
+
+    /**
+     * @param handle filled with unique handle requests refer to the tensor with
+     */
+    Status upload(const tensorflow::TensorProto& proto, std::string& handle);
+    Status release(const std::string& handle);
+
+    /**
+     * @brief Finds tensor and marks it as most recently used
+     *
+     * @return tensor or nullptr if there is no tensor with such handle
+     */
+    std::shared_ptr<const CachedTensor> find(const std::string& handle);
+
+    size_t getByteSize() const;
+    size_t getTensorsCount() const;
+};
+
+/**
+ * @brief Checks whether tensor data is referred in tensor cache instead of being sent in tensor proto
+ */
+bool isCachedTensorReference(const tensorflow::TensorProto& proto);
+
+/**
+ * @brief Finds byteSize bytes of tensor data in tensor cache, dtype of reference has to match the uploaded tensor
+ *
+ * @param tensor holds data as long as it is used
+ */
+Status getCachedTensorData(const tensorflow::TensorProto& proto, size_t byteSize, std::shared_ptr<const CachedTensor>& tensor, const char*& data);
+
+/**
+ * @brief Wraps tensor data of tensor cache as blob without copying, blob keeps the tensor in memory
+ */
+Status createCachedTensorBlob(const tensorflow::TensorProto& proto, const InferenceEngine::TensorDesc& desc, InferenceEngine::Blob::Ptr& blob);
+
+}  // namespace ovms
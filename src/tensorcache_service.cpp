@@ -0,0 +1,43 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "tensorcache_service.hpp"
+
+#include <string>
+
+#include "status.hpp"
+#include "tensorcache.hpp"
+
+namespace ovms {
+
+::grpc::Status TensorCacheServiceImpl::UploadTensor(::grpc::ServerContext* context,
+    const UploadTensorRequest* request,
+    UploadTensorResponse* response) {
+    std::string handle;
+    auto status = TensorCache::getInstance().upload(request->tensor(), handle);
+    if (!status.ok()) {
+        return status.grpc();
+    }
+    response->set_handle(handle);
+    return grpc::Status::OK;
+}
+
+::grpc::Status TensorCacheServiceImpl::ReleaseTensor(::grpc::ServerContext* context,
+    const ReleaseTensorRequest* request,
+    ReleaseTensorResponse* response) {
+    return TensorCache::getInstance().release(request->handle()).grpc();
+}
+
+}  // namespace ovms
@@ -27,6 +27,7 @@
 #pragma GCC diagnostic pop
 
 #include "modelconfig.hpp"
+#include "precisionconversion.hpp"
 
 namespace ovms {
 
@@ -50,6 +51,11 @@ protected:
          */
     InferenceEngine::Precision precision;
 
+    /**
+         * @brief Conversion of precision to and from tensor proto
+         */
+    const PrecisionConversion* precisionConversion = &UNSUPPORTED_PRECISION_CONVERSION;
+
     /**
          * @brief Model input
          */
@@ -65,6 +71,19 @@ protected:
          */
     InferenceEngine::TensorDesc tensorDesc;
 
+    /**
+         * @brief Response tensor with dtype and shape of the tensor and without content, built once instead of on each response
+         */
+    tensorflow::TensorProto responseTemplate;
+
+    void updateResponseTemplate() {
+        responseTemplate.Clear();
+        responseTemplate.set_dtype(precisionConversion->dtype);
+        for (auto dim : shape) {
+            responseTemplate.mutable_tensor_shape()->add_dim()->set_size(dim);
+        }
+    }
+
 public:
     /**
          * @brief Construct a new Tensor Info object
@@ -85,7 +104,10 @@ public:
         name(name),
         mapping(""),
         precision(precision),
-        shape(shape) {}
+        precisionConversion(&ovms::getPrecisionConversion(precision)),
+        shape(shape) {
+        updateResponseTemplate();
+    }
 
     /**
          * @brief Construct a new Tensor Info object
@@ -103,8 +125,11 @@ public:
         name(name),
         mapping(""),
         precision(precision),
+        precisionConversion(&ovms::getPrecisionConversion(precision)),
         shape(shape),
-        layout(layout) {}
+        layout(layout) {
+        updateResponseTemplate();
+    }
 
     /**
          * @brief Construct a new Tensor Info object
@@ -122,8 +147,11 @@ public:
         name(name),
         mapping(mapping),
         precision(precision),
+        precisionConversion(&ovms::getPrecisionConversion(precision)),
         shape(shape),
-        layout(layout) {}
+        layout(layout) {
+        updateResponseTemplate();
+    }
 
     /**
          * @brief Get the Name object
@@ -159,6 +187,26 @@ public:
          */
     void setPrecision(const InferenceEngine::Precision& requestedPrecision) {
         precision = requestedPrecision;
+        precisionConversion = &ovms::getPrecisionConversion(requestedPrecision);
+        updateResponseTemplate();
+    }
+
+    /**
+         * @brief Get the response tensor with dtype and shape of the tensor, to be copied into responses before their content is set
+         * 
+         * @return const tensorflow::TensorProto&
+         */
+    const tensorflow::TensorProto& getResponseTemplate() const {
+        return responseTemplate;
+    }
+
+    /**
+         * @brief Get the conversion of precision to and from tensor proto
+         * 
+         * @return const PrecisionConversion&
+         */
+    const PrecisionConversion& getPrecisionConversion() const {
+        return *precisionConversion;
     }
 
     /**
@@ -167,36 +215,11 @@ public:
          * @return const tensorflow::DataType
          */
     const tensorflow::DataType getPrecisionAsDataType() const {
-        return getPrecisionAsDataType(precision);
+        return precisionConversion->dtype;
     }
 
     static const tensorflow::DataType getPrecisionAsDataType(InferenceEngine::Precision precision) {
-        switch (precision) {
-        case InferenceEngine::Precision::FP32:
-            return tensorflow::DataType::DT_FLOAT;
-        case InferenceEngine::Precision::FP16:
-            return tensorflow::DataType::DT_HALF;
-        // case InferenceEngine::Precision::Q78:   return tensorflow::DataType::
-        case InferenceEngine::Precision::I16:
-            return tensorflow::DataType::DT_INT16;
-        case InferenceEngine::Precision::U8:
-            return tensorflow::DataType::DT_UINT8;
-        case InferenceEngine::Precision::I8:
-            return tensorflow::DataType::DT_INT8;
-        case InferenceEngine::Precision::U16:
-            return tensorflow::DataType::DT_UINT16;
-        case InferenceEngine::Precision::I32:
-            return tensorflow::DataType::DT_INT32;
-        case InferenceEngine::Precision::U64:
-            return tensorflow::DataType::DT_UINT64;
-        case InferenceEngine::Precision::I64:
-            return tensorflow::DataType::DT_INT64;
-        // case InferenceEngine::Precision::BIN:   return tensorflow::DataType::
-        case InferenceEngine::Precision::BOOL:
-            return tensorflow::DataType::DT_BOOL;
-        default:
-            return tensorflow::DataType::DT_INVALID;
-        }
+        return ovms::getPrecisionConversion(precision).dtype;
     }
 
     /**
@@ -0,0 +1,156 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../batchingscheduler.hpp"
+#include "../modelinstance.hpp"
+#include "../prediction_service_utils.hpp"
+#include "test_utils.hpp"
+
+using testing::Each;
+using testing::Eq;
+
+class BatchingSchedulerTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        config = DUMMY_MODEL_CONFIG;
+        config.setBatchSize(0);
+        config.setNireq(1);
+        config.setMaxBatchSize(MAX_BATCH_SIZE);
+        config.setBatchTimeoutMicroseconds(BATCH_TIMEOUT_MICROSECONDS);
+        ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+    }
+
+    static tensorflow::serving::PredictRequest prepareRequest(size_t batchSize, float value) {
+        tensorflow::serving::PredictRequest request;
+        auto& input = (*request.mutable_inputs())[DUMMY_MODEL_INPUT_NAME];
+        input.set_dtype(tensorflow::DataType::DT_FLOAT);
+        input.mutable_tensor_shape()->add_dim()->set_size(batchSize);
+        input.mutable_tensor_shape()->add_dim()->set_size(DUMMY_MODEL_INPUT_SIZE);
+        std::vector<float> data(batchSize * DUMMY_MODEL_INPUT_SIZE, value);
+        input.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+        return request;
+    }
+
+    ovms::Status performInference(const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse& response) {
+        std::shared_ptr<ovms::ModelInstance> modelInstance;
+        std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+        auto status = ovms::getModelInstance(manager, config.getName(), 0, modelInstance, unloadGuard);
+        if (!status.ok()) {
+            return status;
+        }
+        return ovms::inference(*modelInstance, &request, &response, unloadGuard);
+    }
+
+    static void checkResponse(const tensorflow::serving::PredictResponse& response, size_t batchSize, float expectedValue) {
+        ASSERT_EQ(response.outputs().count(DUMMY_MODEL_OUTPUT_NAME), 1);
+        const auto& output = response.outputs().at(DUMMY_MODEL_OUTPUT_NAME);
+        ASSERT_EQ(output.tensor_shape().dim_size(), 2);
+        EXPECT_EQ(output.tensor_shape().dim(0).size(), batchSize);
+        EXPECT_EQ(output.tensor_shape().dim(1).size(), DUMMY_MODEL_OUTPUT_SIZE);
+        auto values = asVector<float>(output.tensor_content());
+        ASSERT_EQ(values.size(), batchSize * DUMMY_MODEL_OUTPUT_SIZE);
+        EXPECT_THAT(values, Each(Eq(expectedValue)));
+    }
+
+    static constexpr size_t MAX_BATCH_SIZE = 4;
+    static constexpr uint64_t BATCH_TIMEOUT_MICROSECONDS = 200000;
+
+    ConstructorEnabledModelManager manager;
+    ovms::ModelConfig config;
+};
+
+TEST_F(BatchingSchedulerTest, SchedulerCreatedForModelWithMaxBatchSize) {
+    auto modelInstance = manager.findModelInstance(config.getName());
+    ASSERT_NE(modelInstance, nullptr);
+    ASSERT_NE(modelInstance->getBatchingScheduler(), nullptr);
+    EXPECT_EQ(modelInstance->getBatchingScheduler()->getMaxBatchSize(), MAX_BATCH_SIZE);
+    EXPECT_EQ(modelInstance->getBatchSize(), MAX_BATCH_SIZE);
+}
+
+TEST_F(BatchingSchedulerTest, SingleRequestDispatchedAfterTimeout) {
+    auto request = prepareRequest(2, 3.0);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInference(request, response), ovms::StatusCode::OK);
+    checkResponse(response, 2, 4.0);
+}
+
+TEST_F(BatchingSchedulerTest, ConcurrentRequestsAreSplitBackToCallers) {
+    const size_t numberOfRequests = 2 * MAX_BATCH_SIZE + 1;
+    std::vector<tensorflow::serving::PredictResponse> responses(numberOfRequests);
+    std::vector<ovms::Status> statuses(numberOfRequests);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numberOfRequests; i++) {
+        threads.emplace_back([this, i, &responses, &statuses]() {
+            auto request = prepareRequest(1, static_cast<float>(i));
+            statuses[i] = performInference(request, responses[i]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < numberOfRequests; i++) {
+        ASSERT_EQ(statuses[i], ovms::StatusCode::OK) << "request: " << i;
+        checkResponse(responses[i], 1, static_cast<float>(i) + 1);
+    }
+}
+
+TEST_F(BatchingSchedulerTest, RequestExceedingMaxBatchSizeRejected) {
+    auto request = prepareRequest(MAX_BATCH_SIZE + 1, 1.0);
+    tensorflow::serving::PredictResponse response;
+    EXPECT_EQ(performInference(request, response), ovms::StatusCode::INVALID_BATCH_SIZE);
+}
+
+TEST_F(BatchingSchedulerTest, RequestWithWrongShapeRejected) {
+    tensorflow::serving::PredictRequest request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE + 1}, tensorflow::DataType::DT_FLOAT}}});
+    tensorflow::serving::PredictResponse response;
+    EXPECT_EQ(performInference(request, response), ovms::StatusCode::INVALID_SHAPE);
+}
+
+TEST_F(BatchingSchedulerTest, RequestWithInputsOfDifferentBatchSizeRejected) {
+    config = SUM_MODEL_CONFIG;
+    config.setBatchSize(0);
+    config.setNireq(1);
+    config.setMaxBatchSize(MAX_BATCH_SIZE);
+    config.setBatchTimeoutMicroseconds(BATCH_TIMEOUT_MICROSECONDS);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+    auto modelInstance = manager.findModelInstance(config.getName());
+    ASSERT_NE(modelInstance, nullptr);
+    ASSERT_NE(modelInstance->getBatchingScheduler(), nullptr);
+
+    // first input in request map would otherwise decide how many rows of the other one are copied
+    tensorflow::serving::PredictRequest request = preparePredictRequest(
+        {{SUM_MODEL_INPUT_NAME_1,
+             std::tuple<ovms::shape_t, tensorflow::DataType>{{1, SUM_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}},
+            {SUM_MODEL_INPUT_NAME_2,
+                std::tuple<ovms::shape_t, tensorflow::DataType>{{MAX_BATCH_SIZE, SUM_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}});
+    tensorflow::serving::PredictResponse response;
+    EXPECT_EQ(modelInstance->getBatchingScheduler()->execute(&request, &response), ovms::StatusCode::INVALID_BATCH_SIZE);
+    EXPECT_EQ(performInference(request, response), ovms::StatusCode::INVALID_BATCH_SIZE);
+
+    request = preparePredictRequest(
+        {{SUM_MODEL_INPUT_NAME_1,
+             std::tuple<ovms::shape_t, tensorflow::DataType>{{2, SUM_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}},
+            {SUM_MODEL_INPUT_NAME_2,
+                std::tuple<ovms::shape_t, tensorflow::DataType>{{2, SUM_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}});
+    EXPECT_EQ(performInference(request, response), ovms::StatusCode::OK);
+}
@@ -0,0 +1,209 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../batchsplitting.hpp"
+#include "../modelinstance.hpp"
+#include "../prediction_service_utils.hpp"
+#include "test_utils.hpp"
+
+using testing::ElementsAre;
+
+namespace {
+tensorflow::TensorProto prepareTensor(const ovms::shape_t& shape, const std::vector<float>& data) {
+    tensorflow::TensorProto tensor;
+    tensor.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : shape) {
+        tensor.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    tensor.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    return tensor;
+}
+}  // namespace
+
+TEST(BatchSplitting, SplitsWithZeroFilledLastSubBatch) {
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())["in"] = prepareTensor({3, 2}, {1, 2, 3, 4, 5, 6});
+    ASSERT_EQ(ovms::getSubBatchesCount(request, 2), 2);
+    std::vector<tensorflow::serving::PredictRequest> subRequests(2);
+    ovms::prepareSubBatchRequest(request, 2, 0, subRequests[0]);
+    ovms::prepareSubBatchRequest(request, 2, 1, subRequests[1]);
+    const auto& first = subRequests[0].inputs().at("in");
+    EXPECT_EQ(first.tensor_shape().dim(0).size(), 2);
+    EXPECT_EQ(first.tensor_shape().dim(1).size(), 2);
+    EXPECT_THAT(asVector<float>(first.tensor_content()), ElementsAre(1, 2, 3, 4));
+    const auto& last = subRequests[1].inputs().at("in");
+    EXPECT_EQ(last.tensor_shape().dim(0).size(), 2);
+    EXPECT_THAT(asVector<float>(last.tensor_content()), ElementsAre(5, 6, 0, 0));
+}
+
+TEST(BatchSplitting, NotSplitWhenBatchFits) {
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())["in"] = prepareTensor({2, 2}, {1, 2, 3, 4});
+    EXPECT_EQ(ovms::getSubBatchesCount(request, 2), 0);
+}
+
+TEST(BatchSplitting, NotSplitWhenInputsDataIsNotInTensorContent) {
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())["in"] = prepareTensor({3, 2}, {1, 2, 3, 4, 5, 6});
+    auto& other = (*request.mutable_inputs())["other"];
+    other.set_dtype(tensorflow::DataType::DT_FLOAT);
+    other.mutable_tensor_shape()->add_dim()->set_size(3);
+    other.add_float_val(1);
+    other.add_float_val(2);
+    other.add_float_val(3);
+    EXPECT_EQ(ovms::getSubBatchesCount(request, 2), 0);
+}
+
+TEST(BatchSplitting, NotSplitWhenShapeDoesNotMatchData) {
+    tensorflow::serving::PredictRequest request;
+    auto& input = (*request.mutable_inputs())["in"];
+    input = prepareTensor({3, 2}, {1, 2, 3, 4, 5, 6});
+    // batch larger than request data
+    input.mutable_tensor_shape()->mutable_dim(0)->set_size(1000000000);
+    EXPECT_EQ(ovms::getSubBatchesCount(request, 2), 0);
+    input.mutable_tensor_shape()->mutable_dim(0)->set_size(-3);
+    EXPECT_EQ(ovms::getSubBatchesCount(request, 2), 0);
+    // 4 * 2^62 * 3 wraps around to 24 bytes of data
+    input.mutable_tensor_shape()->mutable_dim(0)->set_size(3);
+    input.mutable_tensor_shape()->mutable_dim(1)->set_size(int64_t(1) << 62);
+    EXPECT_EQ(ovms::getSubBatchesCount(request, 2), 0);
+    input.mutable_tensor_shape()->mutable_dim(1)->set_size(-2);
+    input.mutable_tensor_shape()->mutable_dim(0)->set_size(-3);
+    EXPECT_EQ(ovms::getSubBatchesCount(request, 2), 0);
+}
+
+TEST(BatchSplitting, MergeDropsZeroFilledRows) {
+    std::vector<tensorflow::serving::PredictResponse> subResponses(2);
+    (*subResponses[0].mutable_outputs())["out"] = prepareTensor({2, 1}, {1, 2});
+    (*subResponses[1].mutable_outputs())["out"] = prepareTensor({2, 1}, {3, 0});
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(ovms::mergeSubBatchResponses(subResponses, 2, 3, response), ovms::StatusCode::OK);
+    const auto& output = response.outputs().at("out");
+    EXPECT_EQ(output.tensor_shape().dim(0).size(), 3);
+    EXPECT_EQ(output.tensor_shape().dim(1).size(), 1);
+    EXPECT_THAT(asVector<float>(output.tensor_content()), ElementsAre(1, 2, 3));
+}
+
+TEST(BatchSplitting, MergeFailsForOutputWithoutBatch) {
+    std::vector<tensorflow::serving::PredictResponse> subResponses(2);
+    (*subResponses[0].mutable_outputs())["out"] = prepareTensor({1, 2}, {1, 2});
+    (*subResponses[1].mutable_outputs())["out"] = prepareTensor({1, 2}, {3, 4});
+    tensorflow::serving::PredictResponse response;
+    EXPECT_EQ(ovms::mergeSubBatchResponses(subResponses, 2, 3, response), ovms::StatusCode::OV_INTERNAL_SERIALIZATION_ERROR);
+}
+
+class BatchSplittingInferenceTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        config = DUMMY_MODEL_CONFIG;
+        config.setNireq(2);
+        config.setSplitBatch(true);
+        ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+    }
+
+    ovms::Status performInference(const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse& response) {
+        std::shared_ptr<ovms::ModelInstance> modelInstance;
+        std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+        auto status = ovms::getModelInstance(manager, config.getName(), 0, modelInstance, unloadGuard);
+        if (!status.ok()) {
+            return status;
+        }
+        return ovms::inference(*modelInstance, &request, &response, unloadGuard);
+    }
+
+    ConstructorEnabledModelManager manager;
+    ovms::ModelConfig config;
+};
+
+TEST_F(BatchSplittingInferenceTest, OversizedBatchIsSplitWithoutReload) {
+    const size_t batchSize = 5;
+    std::vector<float> data;
+    for (size_t i = 0; i < batchSize; i++) {
+        data.insert(data.end(), DUMMY_MODEL_INPUT_SIZE, static_cast<float>(i));
+    }
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())[DUMMY_MODEL_INPUT_NAME] = prepareTensor({batchSize, DUMMY_MODEL_INPUT_SIZE}, data);
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInference(request, response), ovms::StatusCode::OK);
+
+    const auto& output = response.outputs().at(DUMMY_MODEL_OUTPUT_NAME);
+    ASSERT_EQ(output.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(output.tensor_shape().dim(0).size(), batchSize);
+    auto values = asVector<float>(output.tensor_content());
+    ASSERT_EQ(values.size(), batchSize * DUMMY_MODEL_OUTPUT_SIZE);
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(values[i], static_cast<float>(i / DUMMY_MODEL_OUTPUT_SIZE) + 1) << "element: " << i;
+    }
+    auto modelInstance = manager.findModelInstance(config.getName());
+    ASSERT_NE(modelInstance, nullptr);
+    EXPECT_EQ(modelInstance->getBatchSize(), 1);
+    EXPECT_EQ(modelInstance->getMetrics().inference.getCount(), batchSize);
+}
+
+TEST(BatchSplitting, MergesRequestsWithSameSampleShapes) {
+    tensorflow::serving::PredictRequest first, second;
+    first.mutable_model_spec()->set_name("pipeline");
+    (*first.mutable_inputs())["in"] = prepareTensor({1, 2}, {1, 2});
+    (*second.mutable_inputs())["in"] = prepareTensor({2, 2}, {3, 4, 5, 6});
+    EXPECT_EQ(ovms::getMergeableBatchSize(first), 1);
+    EXPECT_EQ(ovms::getMergeableBatchSize(second), 2);
+    ASSERT_TRUE(ovms::haveSameSampleShapes(first, second));
+    tensorflow::serving::PredictRequest merged;
+    ovms::mergeRequestBatches({&first, &second}, merged);
+    EXPECT_EQ(merged.model_spec().name(), "pipeline");
+    const auto& input = merged.inputs().at("in");
+    EXPECT_EQ(input.tensor_shape().dim(0).size(), 3);
+    EXPECT_EQ(input.tensor_shape().dim(1).size(), 2);
+    EXPECT_THAT(asVector<float>(input.tensor_content()), ElementsAre(1, 2, 3, 4, 5, 6));
+}
+
+TEST(BatchSplitting, NotMergeableWhenSampleShapesDiffer) {
+    tensorflow::serving::PredictRequest first, second;
+    (*first.mutable_inputs())["in"] = prepareTensor({1, 2}, {1, 2});
+    (*second.mutable_inputs())["in"] = prepareTensor({1, 3}, {3, 4, 5});
+    EXPECT_FALSE(ovms::haveSameSampleShapes(first, second));
+    (*second.mutable_inputs())["in"] = prepareTensor({1, 2}, {3, 4});
+    (*second.mutable_inputs())["other"] = prepareTensor({1, 2}, {3, 4});
+    EXPECT_FALSE(ovms::haveSameSampleShapes(first, second));
+}
+
+TEST(BatchSplitting, SplitsMergedResponse) {
+    tensorflow::serving::PredictResponse merged;
+    (*merged.mutable_outputs())["out"] = prepareTensor({3, 1}, {1, 2, 3});
+    std::vector<tensorflow::serving::PredictResponse> responses(2);
+    auto status = ovms::splitResponseBatches(merged, {1, 2}, {&responses[0], &responses[1]});
+    ASSERT_EQ(status, ovms::StatusCode::OK);
+    const auto& first = responses[0].outputs().at("out");
+    EXPECT_EQ(first.tensor_shape().dim(0).size(), 1);
+    EXPECT_THAT(asVector<float>(first.tensor_content()), ElementsAre(1));
+    const auto& second = responses[1].outputs().at("out");
+    EXPECT_EQ(second.tensor_shape().dim(0).size(), 2);
+    EXPECT_THAT(asVector<float>(second.tensor_content()), ElementsAre(2, 3));
+}
+
+TEST(BatchSplitting, SplitMergedResponseFailsWhenOutputIsNotBatched) {
+    tensorflow::serving::PredictResponse merged;
+    (*merged.mutable_outputs())["out"] = prepareTensor({1, 3}, {1, 2, 3});
+    std::vector<tensorflow::serving::PredictResponse> responses(2);
+    auto status = ovms::splitResponseBatches(merged, {1, 2}, {&responses[0], &responses[1]});
+    EXPECT_EQ(status, ovms::StatusCode::OV_INTERNAL_SERIALIZATION_ERROR);
+    EXPECT_TRUE(responses[0].outputs().empty());
+}
@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../batchtimeouttuner.hpp"
+
+using ovms::BatchTimeoutTuner;
+
+namespace {
+void recordArrivals(BatchTimeoutTuner& tuner, std::chrono::microseconds interval, size_t count) {
+    auto time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        tuner.recordArrival(time, 1);
+        time += interval;
+    }
+}
+}  // namespace
+
+TEST(BatchTimeoutTuner, MaxTimeoutUsedUntilObserved) {
+    BatchTimeoutTuner tuner(8, 5000, 20000);
+    tuner.update();
+    EXPECT_EQ(tuner.getTimeoutMicroseconds(), 5000);
+    EXPECT_EQ(tuner.getArrivalRate(), 0);
+}
+
+TEST(BatchTimeoutTuner, NoWaitingAtLowTraffic) {
+    BatchTimeoutTuner tuner(8, 5000, 20000);
+    recordArrivals(tuner, std::chrono::microseconds(100000), 10);
+    tuner.recordInference(1, 1000);
+    tuner.update();
+    EXPECT_EQ(tuner.getTimeoutMicroseconds(), 0);
+    EXPECT_EQ(tuner.getTargetBatchSize(), 1);
+    EXPECT_NEAR(tuner.getArrivalRate(), 10, 0.01);
+}
+
+TEST(BatchTimeoutTuner, WaitsForFullBatchAtHighTraffic) {
+    BatchTimeoutTuner tuner(8, 5000, 20000);
+    recordArrivals(tuner, std::chrono::microseconds(100), BatchTimeoutTuner::ARRIVALS_WINDOW * 2);
+    tuner.recordInference(8, 1000);
+    tuner.update();
+    EXPECT_EQ(tuner.getTargetBatchSize(), 8);
+    EXPECT_EQ(tuner.getTimeoutMicroseconds(), 700);
+}
+
+TEST(BatchTimeoutTuner, WaitingLimitedByLatencySlo) {
+    BatchTimeoutTuner tuner(8, 5000, 1500);
+    recordArrivals(tuner, std::chrono::microseconds(200), 20);
+    tuner.recordInference(8, 1000);
+    tuner.update();
+    // 2 further rows arrive within 400 us, waiting for 3 would exceed 1500 us together with inference
+    EXPECT_EQ(tuner.getTargetBatchSize(), 3);
+    EXPECT_EQ(tuner.getTimeoutMicroseconds(), 400);
+}
+
+TEST(BatchTimeoutTuner, TailInferenceTimeCountedInSlo) {
+    BatchTimeoutTuner tuner(8, 5000, 1500);
+    recordArrivals(tuner, std::chrono::microseconds(200), 20);
+    for (int i = 0; i < 50; ++i) {
+        tuner.recordInference(8, i % 2 ? 800 : 1200);
+    }
+    tuner.update();
+    EXPECT_LT(tuner.getTimeoutMicroseconds(), 400);
+}
@@ -0,0 +1,88 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../blockingtasksexecutor.hpp"
+
+using ovms::BlockingTasksExecutor;
+
+TEST(BlockingTasksExecutor, ExecutesAllScheduledTasks) {
+    std::atomic<size_t> executed{0};
+    {
+        BlockingTasksExecutor executor(4);
+        EXPECT_EQ(executor.getWorkersCount(), 4);
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_TRUE(executor.schedule([&executed]() { executed++; }));
+        }
+    }
+    // queued tasks are executed before workers are stopped
+    EXPECT_EQ(executed.load(), 1000);
+}
+
+TEST(BlockingTasksExecutor, RunsNoMoreTasksAtOnceThanWorkers) {
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> maxRunning{0};
+    std::set<std::thread::id> threads;
+    std::mutex mtx;
+    BlockingTasksExecutor executor(3);
+    for (int i = 0; i < 30; i++) {
+        executor.schedule([&]() {
+            auto current = ++running;
+            auto previous = maxRunning.load();
+            while (previous < current && !maxRunning.compare_exchange_weak(previous, current)) {
+            }
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                threads.insert(std::this_thread::get_id());
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            running--;
+        });
+    }
+    executor.shutdown();
+    EXPECT_LE(maxRunning.load(), 3);
+    EXPECT_LE(threads.size(), 3);
+}
+
+TEST(BlockingTasksExecutor, ShutdownWaitsForRunningTasksAndRejectsNewOnes) {
+    BlockingTasksExecutor executor(1);
+    std::promise<void> started;
+    std::atomic<bool> finished{false};
+    executor.schedule([&]() {
+        started.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+    started.get_future().wait();
+    executor.shutdown();
+    EXPECT_TRUE(finished.load());
+    EXPECT_FALSE(executor.schedule([]() {}));
+    // second shutdown, e.g. from destructor, returns at once
+    executor.shutdown();
+}
+
+TEST(BlockingTasksExecutor, InferencesAndPipelineBatchesInstancesAreSeparate) {
+    EXPECT_GE(BlockingTasksExecutor::getInferencesInstance().getWorkersCount(), 64);
+    EXPECT_GE(BlockingTasksExecutor::getPipelineBatchesInstance().getWorkersCount(), 64);
+    EXPECT_NE(&BlockingTasksExecutor::getInferencesInstance(), &BlockingTasksExecutor::getPipelineBatchesInstance());
+}
@@ -0,0 +1,92 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../chunkedinputs.hpp"
+
+using ovms::ChunkedInputs;
+using ovms::StatusCode;
+using ovms::TensorInfo;
+
+using tensorflow::serving::PredictRequest;
+
+class ChunkedInputsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        inputsInfo["input"] = std::make_shared<TensorInfo>("input", InferenceEngine::Precision::FP32, ovms::shape_t{1, 4}, InferenceEngine::Layout::NC);
+        auto& input = (*header.mutable_inputs())["input"];
+        input.set_dtype(tensorflow::DataType::DT_FLOAT);
+        input.mutable_tensor_shape()->add_dim()->set_size(1);
+        input.mutable_tensor_shape()->add_dim()->set_size(4);
+    }
+
+    static std::string bytesOf(const std::vector<float>& values) {
+        return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    }
+
+    ovms::tensor_map_t inputsInfo;
+    PredictRequest header;
+    ChunkedInputs inputs;
+};
+
+TEST_F(ChunkedInputsTest, ChunksAreWrittenIntoInputBlob) {
+    (*header.mutable_inputs())["input"].set_tensor_content(bytesOf({1.0}));
+    ASSERT_EQ(inputs.prepare(inputsInfo, header), StatusCode::OK);
+    EXPECT_EQ(inputs.getBytes(), 4 * sizeof(float));
+    EXPECT_EQ(inputs.checkComplete(), StatusCode::INVALID_CONTENT_SIZE);
+    ASSERT_EQ(inputs.write("input", sizeof(float), bytesOf({2.0, 3.0})), StatusCode::OK);
+    ASSERT_EQ(inputs.write("input", 3 * sizeof(float), bytesOf({4.0})), StatusCode::OK);
+    EXPECT_EQ(inputs.checkComplete(), StatusCode::OK);
+    const auto& blob = inputs.getBlobs().at("input");
+    const float* data = blob->cbuffer().as<const float*>();
+    EXPECT_EQ(std::vector<float>(data, data + 4), (std::vector<float>{1.0, 2.0, 3.0, 4.0}));
+}
+
+TEST_F(ChunkedInputsTest, RejectsChunksOutOfOrderOrAboveInputSize) {
+    ASSERT_EQ(inputs.prepare(inputsInfo, header), StatusCode::OK);
+    EXPECT_EQ(inputs.write("input", sizeof(float), bytesOf({2.0})), StatusCode::CHUNKED_INPUT_OUT_OF_ORDER);
+    EXPECT_EQ(inputs.write("input", 0, bytesOf({1.0, 2.0, 3.0, 4.0, 5.0})), StatusCode::INVALID_CONTENT_SIZE);
+    EXPECT_EQ(inputs.write("other", 0, bytesOf({1.0})), StatusCode::INVALID_MISSING_INPUT);
+}
+
+TEST_F(ChunkedInputsTest, RejectsHeaderNotMatchingModelInputs) {
+    auto& input = (*header.mutable_inputs())["input"];
+    input.mutable_tensor_shape()->mutable_dim(1)->set_size(5);
+    EXPECT_EQ(inputs.prepare(inputsInfo, header), StatusCode::INVALID_SHAPE);
+
+    ChunkedInputs wrongPrecision;
+    input.mutable_tensor_shape()->mutable_dim(1)->set_size(4);
+    input.set_dtype(tensorflow::DataType::DT_INT32);
+    EXPECT_EQ(wrongPrecision.prepare(inputsInfo, header), StatusCode::INVALID_PRECISION);
+
+    ChunkedInputs missingInput;
+    header.mutable_inputs()->clear();
+    (*header.mutable_inputs())["other"] = input;
+    EXPECT_EQ(missingInput.prepare(inputsInfo, header), StatusCode::INVALID_MISSING_INPUT);
+}
+
+TEST_F(ChunkedInputsTest, ValidationComputesSizeWithoutAllocatingBlobs) {
+    ASSERT_EQ(inputs.validate(inputsInfo, header), StatusCode::OK);
+    EXPECT_EQ(inputs.getBytes(), 4 * sizeof(float));
+    EXPECT_TRUE(inputs.getBlobs().empty());
+    ASSERT_EQ(inputs.allocate(inputsInfo, header), StatusCode::OK);
+    EXPECT_EQ(inputs.getBlobs().size(), 1);
+    EXPECT_EQ(inputs.getBlobs().at("input")->byteSize(), inputs.getBytes());
+}
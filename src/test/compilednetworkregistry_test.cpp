@@ -0,0 +1,148 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../compilednetworkregistry.hpp"
+
+using InferenceEngine::ExecutableNetwork;
+using ovms::CompiledNetworkKey;
+using ovms::CompiledNetworkRegistry;
+
+namespace {
+CompiledNetworkKey makeKey(uint64_t hash, const std::string& description = "CPU", const std::string& model = "model") {
+    CompiledNetworkKey key;
+    key.hash = hash;
+    key.description = description;
+    key.inMemoryModelFiles.push_back(std::make_shared<const std::string>(model));
+    return key;
+}
+}  // namespace
+
+TEST(CompiledNetworkRegistry, NetworkSharedWhileHeld) {
+    CompiledNetworkRegistry registry;
+    size_t loads = 0;
+    auto load = [&loads]() {
+        loads++;
+        return std::make_shared<ExecutableNetwork>();
+    };
+    bool shared = true;
+    auto first = registry.getOrLoad(makeKey(1), load, shared);
+    EXPECT_FALSE(shared);
+    auto second = registry.getOrLoad(makeKey(1), load, shared);
+    EXPECT_TRUE(shared);
+    EXPECT_EQ(first, second);
+    auto other = registry.getOrLoad(makeKey(2), load, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(loads, 2);
+    EXPECT_EQ(registry.size(), 2);
+
+    first.reset();
+    second.reset();
+    EXPECT_EQ(registry.size(), 1);
+    registry.getOrLoad(makeKey(1), load, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_EQ(loads, 3);
+}
+
+TEST(CompiledNetworkRegistry, ConcurrentLoadsCompileOnce) {
+    CompiledNetworkRegistry registry;
+    std::atomic<size_t> loads{0};
+    auto load = [&loads]() {
+        loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return std::make_shared<ExecutableNetwork>();
+    };
+    std::vector<std::shared_ptr<ExecutableNetwork>> networks(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < networks.size(); i++) {
+        threads.emplace_back([&, i]() {
+            bool shared;
+            networks[i] = registry.getOrLoad(makeKey(7), load, shared);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(loads, 1);
+    for (const auto& network : networks) {
+        EXPECT_EQ(network, networks[0]);
+    }
+}
+
+TEST(CompiledNetworkRegistry, FailedLoadIsNotShared) {
+    CompiledNetworkRegistry registry;
+    bool shared;
+    EXPECT_THROW(registry.getOrLoad(makeKey(3), []() -> std::shared_ptr<ExecutableNetwork> { throw std::runtime_error("compilation failed"); }, shared), std::runtime_error);
+    auto network = registry.getOrLoad(makeKey(3), []() { return std::make_shared<ExecutableNetwork>(); }, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_NE(network, nullptr);
+}
+
+TEST(CompiledNetworkRegistry, CollidingHashesDoNotShareNetwork) {
+    CompiledNetworkRegistry registry;
+    auto load = []() { return std::make_shared<ExecutableNetwork>(); };
+    bool shared = true;
+    auto network = registry.getOrLoad(makeKey(5), load, shared);
+    EXPECT_FALSE(shared);
+    auto otherDevice = registry.getOrLoad(makeKey(5, "GPU"), load, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_NE(network, otherDevice);
+    auto otherModel = registry.getOrLoad(makeKey(5, "CPU", "other model"), load, shared);
+    EXPECT_FALSE(shared);
+    EXPECT_NE(network, otherModel);
+    EXPECT_EQ(registry.size(), 3);
+
+    auto sameModel = registry.getOrLoad(makeKey(5), load, shared);
+    EXPECT_TRUE(shared);
+    EXPECT_EQ(network, sameModel);
+}
+
+TEST(CompiledNetworkRegistry, ModelFilesAreComparedByContent) {
+    const auto directory = std::filesystem::temp_directory_path() / "compiled_network_registry_test";
+    std::filesystem::create_directories(directory);
+    const auto writeFile = [&directory](const std::string& name, const std::string& content) {
+        const auto path = (directory / name).string();
+        std::ofstream(path, std::ios::binary) << content;
+        return path;
+    };
+    const auto makeFileKey = [](const std::string& path) {
+        CompiledNetworkKey key;
+        key.hash = 9;
+        key.description = "CPU";
+        EXPECT_TRUE(key.addModelFile(path));
+        return key;
+    };
+    const auto model = writeFile("model.xml", "identical model");
+    const auto copy = writeFile("copy.xml", "identical model");
+    const auto other = writeFile("other.xml", "different model");
+
+    EXPECT_TRUE(makeFileKey(model).matches(makeFileKey(model)));
+    EXPECT_TRUE(makeFileKey(model).matches(makeFileKey(copy)));
+    EXPECT_FALSE(makeFileKey(model).matches(makeFileKey(other)));
+    CompiledNetworkKey missing;
+    EXPECT_FALSE(missing.addModelFile((directory / "missing.xml").string()));
+    std::filesystem::remove_all(directory);
+}
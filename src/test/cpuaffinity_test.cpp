@@ -0,0 +1,136 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <pthread.h>
+
+#include "../cpuaffinity.hpp"
+
+using testing::ElementsAre;
+
+TEST(CpuAffinity, ParseCpuList) {
+    std::vector<int> cpus;
+    ASSERT_EQ(ovms::parseCpuList("0-3,8, 10-11", cpus), ovms::StatusCode::OK);
+    EXPECT_THAT(cpus, ElementsAre(0, 1, 2, 3, 8, 10, 11));
+    ASSERT_EQ(ovms::parseCpuList("5,2,2-3", cpus), ovms::StatusCode::OK);
+    EXPECT_THAT(cpus, ElementsAre(2, 3, 5));
+    EXPECT_EQ(ovms::parseCpuList("3-1", cpus), ovms::StatusCode::CPU_AFFINITY_INVALID);
+    EXPECT_EQ(ovms::parseCpuList("1-", cpus), ovms::StatusCode::CPU_AFFINITY_INVALID);
+    EXPECT_EQ(ovms::parseCpuList("1a", cpus), ovms::StatusCode::CPU_AFFINITY_INVALID);
+    EXPECT_EQ(ovms::parseCpuList("-1", cpus), ovms::StatusCode::CPU_AFFINITY_INVALID);
+}
+
+TEST(CpuAffinity, GetRequestedCpus) {
+    std::vector<int> cpus;
+    ASSERT_EQ(ovms::getRequestedCpus(-1, "", cpus), ovms::StatusCode::OK);
+    EXPECT_TRUE(cpus.empty());
+    EXPECT_EQ(ovms::getRequestedCpus(-1, "1000-1001", cpus), ovms::StatusCode::CPU_AFFINITY_INVALID);
+    EXPECT_EQ(ovms::getRequestedCpus(1000, "", cpus), ovms::StatusCode::CPU_AFFINITY_INVALID);
+}
+
+TEST(CpuAffinity, SplitCpusIntoConsecutiveSets) {
+    std::vector<std::vector<int>> cpuSets;
+    ASSERT_EQ(ovms::splitCpus("", 1, cpuSets), ovms::StatusCode::OK);
+    ASSERT_EQ(cpuSets.size(), 1);
+    const auto allowedCpus = cpuSets[0];
+    ASSERT_FALSE(allowedCpus.empty());
+
+    ASSERT_EQ(ovms::splitCpus("", 2, cpuSets), ovms::StatusCode::OK);
+    ASSERT_EQ(cpuSets.size(), 2);
+    if (allowedCpus.size() >= 2) {
+        std::vector<int> joined = cpuSets[0];
+        joined.insert(joined.end(), cpuSets[1].begin(), cpuSets[1].end());
+        EXPECT_EQ(joined, allowedCpus);
+        EXPECT_LE(cpuSets[1].size() - cpuSets[0].size(), 1);
+    }
+
+    const std::string firstCpu = std::to_string(allowedCpus[0]);
+    ASSERT_EQ(ovms::splitCpus(firstCpu, 3, cpuSets), ovms::StatusCode::OK);
+    EXPECT_THAT(cpuSets, ElementsAre(ElementsAre(allowedCpus[0]), ElementsAre(allowedCpus[0]), ElementsAre(allowedCpus[0])));
+    EXPECT_EQ(ovms::splitCpus("1000-1001", 2, cpuSets), ovms::StatusCode::CPU_AFFINITY_INVALID);
+}
+
+TEST(CpuAffinity, NumaNodesCpusCoverAllowedCpus) {
+    std::vector<std::vector<int>> cpuSets;
+    ASSERT_EQ(ovms::splitCpus("", 1, cpuSets), ovms::StatusCode::OK);
+    const auto allowedCpus = cpuSets[0];
+    std::vector<std::vector<int>> nodesCpus;
+    ASSERT_EQ(ovms::getNumaNodesCpus({}, nodesCpus), ovms::StatusCode::OK);
+    ASSERT_FALSE(nodesCpus.empty());
+    std::vector<int> joined;
+    for (const auto& nodeCpus : nodesCpus) {
+        EXPECT_FALSE(nodeCpus.empty());
+        joined.insert(joined.end(), nodeCpus.begin(), nodeCpus.end());
+    }
+    std::sort(joined.begin(), joined.end());
+    EXPECT_EQ(joined, allowedCpus);
+
+    // nodes are limited to requested CPUs
+    ASSERT_EQ(ovms::getNumaNodesCpus({allowedCpus[0]}, nodesCpus), ovms::StatusCode::OK);
+    EXPECT_THAT(nodesCpus, ElementsAre(ElementsAre(allowedCpus[0])));
+}
+
+TEST(CpuAffinity, GuardRestoresThreadAffinity) {
+    cpu_set_t initialCpus;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(initialCpus), &initialCpus), 0);
+    int firstCpu = 0;
+    while (!CPU_ISSET(firstCpu, &initialCpus)) {
+        firstCpu++;
+    }
+    {
+        ovms::CpuAffinityGuard guard({firstCpu});
+        cpu_set_t cpus;
+        ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus), 0);
+        EXPECT_EQ(CPU_COUNT(&cpus), 1);
+        EXPECT_TRUE(CPU_ISSET(firstCpu, &cpus));
+    }
+    cpu_set_t restoredCpus;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(restoredCpus), &restoredCpus), 0);
+    EXPECT_TRUE(CPU_EQUAL(&initialCpus, &restoredCpus));
+}
+
+TEST(CpuAffinity, ReservedCpusAreExcludedForOtherModels) {
+    ovms::CpuReservations reservations;
+    std::vector<int> cpus;
+    ASSERT_EQ(reservations.excludeReserved("other", cpus), ovms::StatusCode::OK);
+    EXPECT_TRUE(cpus.empty());
+
+    ASSERT_EQ(reservations.reserve("exclusive", {2, 3}), ovms::StatusCode::OK);
+    EXPECT_EQ(reservations.reserve("second", {3, 4}), ovms::StatusCode::CPU_SET_RESERVED);
+    EXPECT_EQ(reservations.reserve("exclusive", {3, 4}), ovms::StatusCode::OK);
+
+    cpus = {1, 3, 4};
+    ASSERT_EQ(reservations.excludeReserved("other", cpus), ovms::StatusCode::OK);
+    EXPECT_THAT(cpus, ElementsAre(1));
+    cpus = {3, 4};
+    EXPECT_EQ(reservations.excludeReserved("other", cpus), ovms::StatusCode::CPU_SET_RESERVED);
+    ASSERT_EQ(reservations.excludeReserved("exclusive", cpus), ovms::StatusCode::OK);
+    EXPECT_THAT(cpus, ElementsAre(3, 4));
+
+    cpus.clear();
+    ASSERT_EQ(reservations.excludeReserved("other", cpus), ovms::StatusCode::OK);
+    EXPECT_THAT(cpus, testing::Not(testing::Contains(3)));
+    EXPECT_THAT(cpus, testing::Not(testing::Contains(4)));
+
+    reservations.release("exclusive");
+    cpus.clear();
+    ASSERT_EQ(reservations.excludeReserved("other", cpus), ovms::StatusCode::OK);
+    EXPECT_TRUE(cpus.empty());
+}
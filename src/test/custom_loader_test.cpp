@@ -25,6 +25,7 @@
 #include <inference_engine.hpp>
 #include <stdlib.h>
 
+#include "../customloaderinterface.hpp"
 #include "../executinstreamidguard.hpp"
 #include "../get_model_metadata_impl.hpp"
 #include "../localfilesystem.hpp"
@@ -1010,4 +1011,86 @@ TEST_F(TestCustomLoader, CustomLoaderMultipleLoaderWithSameLoaderName) {
     performPredict("dummy", 1, request);
 }
 
+namespace {
+class VectorCustomLoader : public ovms::CustomLoaderInterface {
+public:
+    CustomLoaderStatus result = CustomLoaderStatus::MODEL_TYPE_IR;
+    std::vector<uint8_t> model{'x', 'm', 'l'};
+    std::vector<uint8_t> weights{1, 2, 3, 4};
+
+    CustomLoaderStatus loaderInit(const std::string& loaderConfigFile) override {
+        return CustomLoaderStatus::OK;
+    }
+    CustomLoaderStatus loadModel(const std::string& modelName, const std::string& basePath, const int version,
+        const std::string& loaderOptions, std::vector<uint8_t>& modelBuffer, std::vector<uint8_t>& weightsBuffer) override {
+        modelBuffer = model;
+        weightsBuffer = std::move(weights);
+        return result;
+    }
+    CustomLoaderStatus unloadModel(const std::string& modelName, const int version) override {
+        return CustomLoaderStatus::OK;
+    }
+    CustomLoaderStatus retireModel(const std::string& modelName) override {
+        return CustomLoaderStatus::OK;
+    }
+    CustomLoaderStatus loaderDeInit() override {
+        return CustomLoaderStatus::OK;
+    }
+};
+
+class RecordingModelWriter : public ovms::CustomLoaderModelWriter {
+public:
+    std::string model;
+    std::vector<uint8_t> weights;
+    size_t setModelCalls = 0;
+    size_t setWeightsCalls = 0;
+
+    void setModel(std::string&& model) override {
+        this->model = std::move(model);
+        setModelCalls++;
+    }
+    uint8_t* allocateWeights(size_t size) override {
+        weights.resize(size);
+        return weights.data();
+    }
+    void setWeights(std::vector<uint8_t>&& weights) override {
+        this->weights = std::move(weights);
+        setWeightsCalls++;
+    }
+    void setWeights(std::shared_ptr<const void> owner, const uint8_t* data, size_t size) override {
+        weights.assign(data, data + size);
+        setWeightsCalls++;
+    }
+    bool setWeightsFile(const std::string& path) override {
+        return false;
+    }
+};
+}  // namespace
+
+TEST(CustomLoaderInterface, DefaultStreamedLoadHandsOverVectorsWithoutCopyingWeights) {
+    VectorCustomLoader loader;
+    const uint8_t* weightsData = loader.weights.data();
+    RecordingModelWriter writer;
+    EXPECT_EQ(loader.loadModelStreamed("dummy", "/tmp", 1, "", writer), CustomLoaderStatus::MODEL_TYPE_IR);
+    EXPECT_EQ(writer.setModelCalls, 1);
+    EXPECT_EQ(writer.setWeightsCalls, 1);
+    EXPECT_EQ(writer.model, "xml");
+    EXPECT_THAT(writer.weights, ContainerEq(std::vector<uint8_t>{1, 2, 3, 4}));
+    EXPECT_EQ(writer.weights.data(), weightsData);
+}
+
+TEST(CustomLoaderInterface, DefaultStreamedLoadDoesNotWriteModelOnError) {
+    VectorCustomLoader loader;
+    loader.result = CustomLoaderStatus::MODEL_LOAD_ERROR;
+    RecordingModelWriter writer;
+    EXPECT_EQ(loader.loadModelStreamed("dummy", "/tmp", 1, "", writer), CustomLoaderStatus::MODEL_LOAD_ERROR);
+    EXPECT_EQ(writer.setModelCalls, 0);
+    EXPECT_EQ(writer.setWeightsCalls, 0);
+}
+
+TEST(CustomLoaderInterface, LoaderIsNotLoadedConcurrentlyByDefault) {
+    VectorCustomLoader loader;
+    EXPECT_FALSE(loader.supportsConcurrentLoading());
+}
+
 #pragma GCC diagnostic pop
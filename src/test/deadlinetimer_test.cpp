@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../deadlinetimer.hpp"
+
+using ovms::DeadlineTimer;
+
+TEST(DeadlineTimer, RunsTasksInOrderOfTheirTime) {
+    DeadlineTimer timer;
+    const auto now = std::chrono::steady_clock::now();
+    std::mutex mtx;
+    std::vector<int> order;
+    std::promise<void> finished;
+    timer.schedule(now + std::chrono::milliseconds(30), [&]() {
+        std::lock_guard lock(mtx);
+        order.push_back(3);
+        finished.set_value();
+    });
+    timer.schedule(now + std::chrono::milliseconds(10), [&]() {
+        std::lock_guard lock(mtx);
+        order.push_back(1);
+    });
+    timer.schedule(now + std::chrono::milliseconds(20), [&]() {
+        std::lock_guard lock(mtx);
+        order.push_back(2);
+    });
+    ASSERT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    std::lock_guard lock(mtx);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_GE(std::chrono::steady_clock::now() - now, std::chrono::milliseconds(30));
+}
+
+TEST(DeadlineTimer, CancelledTaskDoesNotRun) {
+    DeadlineTimer timer;
+    std::atomic<bool> ran{false};
+    auto id = timer.schedule(std::chrono::steady_clock::now() + std::chrono::milliseconds(20), [&ran]() { ran = true; });
+    EXPECT_TRUE(timer.cancel(id));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(ran.load());
+    EXPECT_FALSE(timer.cancel(id));
+}
+
+TEST(DeadlineTimer, CancelWaitsForRunningTask) {
+    DeadlineTimer timer;
+    std::promise<void> started;
+    std::atomic<bool> finished{false};
+    auto id = timer.schedule(std::chrono::steady_clock::now(), [&]() {
+        started.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+    started.get_future().wait();
+    EXPECT_FALSE(timer.cancel(id));
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(DeadlineTimer, TaskScheduledEarlierThanPendingOnesWakesTimer) {
+    DeadlineTimer timer;
+    const auto now = std::chrono::steady_clock::now();
+    timer.schedule(now + std::chrono::hours(1), []() {});
+    std::promise<void> finished;
+    timer.schedule(now + std::chrono::milliseconds(10), [&finished]() { finished.set_value(); });
+    EXPECT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
@@ -14,6 +14,8 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <cstring>
+#include <map>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -225,6 +227,60 @@ TEST_P(DeserializeTFTensorProto, ShouldReturnValidBlob) {
                                 << " should return valid blob ptr";
 }
 
+TEST_F(TensorflowGRPCPredict, ShouldDeserializeIntoPreallocatedBlob) {
+    tensorMap[tensorName]->setPrecision(Precision::U8);
+    SetUpTensorProto(fromInferenceEnginePrecision(Precision::U8));
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<uint8_t>(tensorMap[tensorName]->getTensorDesc());
+    blob->allocate();
+    ASSERT_TRUE(ConcreteTensorProtoDeserializator::deserializeTensorProtoToBlob(tensorProto, tensorMap[tensorName], blob));
+    EXPECT_EQ(0, std::memcmp(blob->buffer().as<char*>(), tensorProto.tensor_content().data(), tensorProto.tensor_content().size()));
+}
+
+TEST_F(TensorflowGRPCPredict, ShouldNotDeserializeIntoPreallocatedBlobOfDifferentSize) {
+    // Content of 3 bytes does not fill FP32 blob of 3 elements
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<float>(tensorMap[tensorName]->getTensorDesc());
+    blob->allocate();
+    EXPECT_FALSE(ConcreteTensorProtoDeserializator::deserializeTensorProtoToBlob(tensorProto, tensorMap[tensorName], blob));
+}
+
+TEST_F(TensorflowGRPCPredict, ShouldDeserializeManyLargeInputsConcurrently) {
+    // Each input exceeds threshold so that conversions run in parallel
+    const size_t elementsCount = PARALLEL_DESERIALIZATION_MIN_BYTES / sizeof(uint16_t);
+    const size_t inputsCount = 4;
+    ovms::tensor_map_t inputs;
+    PredictRequest request;
+    for (size_t i = 0; i < inputsCount; i++) {
+        const std::string name = "input" + std::to_string(i);
+        inputs[name] = std::make_shared<ovms::TensorInfo>(name, Precision::FP16, InferenceEngine::SizeVector{1, elementsCount}, InferenceEngine::Layout::NC);
+        auto& proto = (*request.mutable_inputs())[name];
+        proto.set_dtype(tensorflow::DataType::DT_HALF);
+        proto.mutable_tensor_shape()->add_dim()->set_size(1);
+        proto.mutable_tensor_shape()->add_dim()->set_size(elementsCount);
+        for (size_t j = 0; j < elementsCount; j++) {
+            proto.add_half_val(i + j % 7);
+        }
+    }
+    std::shared_ptr<MockIInferRequest> mInferRequestPtr = std::make_shared<MockIInferRequest>();
+    InferenceEngine::InferRequest inferRequest(mInferRequestPtr);
+    std::map<std::string, InferenceEngine::Blob::Ptr> blobs;
+    EXPECT_CALL(*mInferRequestPtr, SetBlob(_, _, _))
+        .Times(inputsCount)
+        .WillRepeatedly([&blobs](const char* name, const InferenceEngine::Blob::Ptr& blob, InferenceEngine::ResponseDesc*) {
+            blobs[name] = blob;
+            return InferenceEngine::StatusCode::OK;
+        });
+    auto status = deserializePredictRequest<ConcreteTensorProtoDeserializator>(request, inputs, inferRequest);
+    ASSERT_TRUE(status.ok()) << status.string();
+    ASSERT_EQ(blobs.size(), inputsCount);
+    for (size_t i = 0; i < inputsCount; i++) {
+        const auto& proto = request.inputs().at("input" + std::to_string(i));
+        const uint16_t* data = blobs["input" + std::to_string(i)]->cbuffer().as<const uint16_t*>();
+        for (size_t j = 0; j < elementsCount; j++) {
+            ASSERT_EQ(data[j], proto.half_val(j)) << "input" << i << " element " << j;
+        }
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     TestDeserialize,
     GRPCPredictRequestNegative,
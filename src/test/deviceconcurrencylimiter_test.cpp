@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../deviceconcurrencylimiter.hpp"
+
+using ovms::DeviceConcurrencyLimiter;
+
+TEST(DeviceConcurrencyLimiter, ParseLimits) {
+    std::map<std::string, size_t> limits;
+    ASSERT_TRUE(DeviceConcurrencyLimiter::parseLimits("GPU=4, MYRIAD = 8", limits).ok());
+    EXPECT_EQ(limits, (std::map<std::string, size_t>{{"GPU", 4}, {"MYRIAD", 8}}));
+    limits.clear();
+    ASSERT_TRUE(DeviceConcurrencyLimiter::parseLimits("", limits).ok());
+    EXPECT_TRUE(limits.empty());
+    for (const std::string invalid : {"GPU", "GPU=", "=4", "GPU=0", "GPU=-1", "GPU=four", "GPU=4=5"}) {
+        EXPECT_EQ(DeviceConcurrencyLimiter::parseLimits(invalid, limits), ovms::StatusCode::DEVICE_CONCURRENCY_LIMITS_WRONG_FORMAT) << invalid;
+    }
+}
+
+TEST(DeviceConcurrencyLimiter, LimiterSharedOnlyByConfiguredDevice) {
+    DeviceConcurrencyLimiter::configure({{"GPU", 2}});
+    auto limiter = DeviceConcurrencyLimiter::forDevice("GPU");
+    ASSERT_NE(limiter, nullptr);
+    EXPECT_EQ(limiter->getMaxInFlight(), 2);
+    EXPECT_EQ(DeviceConcurrencyLimiter::forDevice("GPU"), limiter);
+    EXPECT_EQ(DeviceConcurrencyLimiter::forDevice("CPU"), nullptr);
+    DeviceConcurrencyLimiter::configure({});
+    EXPECT_EQ(DeviceConcurrencyLimiter::forDevice("GPU"), nullptr);
+}
+
+TEST(DeviceConcurrencyLimiter, SlotsAreCappedAndWaitingClientIsNotified) {
+    DeviceConcurrencyLimiter limiter("GPU", 2);
+    size_t notifications = 0;
+    auto first = limiter.registerClient(1, []() {});
+    auto second = limiter.registerClient(1, [&notifications]() { notifications++; });
+    EXPECT_TRUE(limiter.tryAcquire(first));
+    EXPECT_TRUE(limiter.tryAcquire(first));
+    EXPECT_FALSE(limiter.tryAcquire(second));
+    EXPECT_EQ(limiter.getInFlight(), 2);
+    limiter.release();
+    EXPECT_EQ(notifications, 1);
+    // notified client did not take the slot, so it stays free
+    EXPECT_EQ(limiter.getInFlight(), 1);
+    EXPECT_TRUE(limiter.tryAcquire(second));
+    limiter.release();
+    EXPECT_EQ(notifications, 1);
+    limiter.unregisterClient(first);
+    limiter.unregisterClient(second);
+}
+
+TEST(DeviceConcurrencyLimiter, SaturatedDeviceSlotsAreSharedByWeights) {
+    DeviceConcurrencyLimiter limiter("GPU", 1);
+    std::vector<DeviceConcurrencyLimiter::client_id_t> ids;
+    std::map<size_t, size_t> granted;
+    // each client takes notified slot right away and keeps waiting for next one
+    auto onSlotAvailable = [&limiter, &ids, &granted](size_t client) {
+        if (limiter.tryAcquire(ids[client])) {
+            granted[client]++;
+        }
+    };
+    ids.push_back(limiter.registerClient(1, [&onSlotAvailable]() { onSlotAvailable(0); }));
+    ids.push_back(limiter.registerClient(3, [&onSlotAvailable]() { onSlotAvailable(1); }));
+    ASSERT_TRUE(limiter.tryAcquire(ids[0]));
+    for (auto id : ids) {
+        EXPECT_FALSE(limiter.tryAcquire(id));
+    }
+    for (int i = 0; i < 400; i++) {
+        limiter.release();
+        for (auto id : ids) {
+            limiter.tryAcquire(id);
+        }
+    }
+    EXPECT_EQ(granted[0] + granted[1], 400);
+    EXPECT_NEAR(granted[1], granted[0] * 3, 4);
+    limiter.release();
+    for (auto id : ids) {
+        limiter.unregisterClient(id);
+    }
+}
+
+TEST(DeviceConcurrencyLimiter, IdleClientDoesNotGetBurstOfSlots) {
+    DeviceConcurrencyLimiter limiter("GPU", 1);
+    auto busy = limiter.registerClient(1, []() {});
+    auto idle = limiter.registerClient(1, []() {});
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(limiter.tryAcquire(busy));
+        limiter.release();
+    }
+    ASSERT_TRUE(limiter.tryAcquire(busy));
+    EXPECT_FALSE(limiter.tryAcquire(idle));
+    EXPECT_FALSE(limiter.tryAcquire(busy));
+    limiter.release();
+    // clients are served alternately instead of idle one taking ten slots in a row
+    EXPECT_TRUE(limiter.tryAcquire(idle));
+    limiter.release();
+    EXPECT_TRUE(limiter.tryAcquire(busy));
+    limiter.release();
+    limiter.unregisterClient(busy);
+    limiter.unregisterClient(idle);
+}
@@ -0,0 +1,114 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../downloadcache.hpp"
+
+class DownloadCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove_all(cacheDir);
+        std::filesystem::remove_all(modelDir);
+        std::filesystem::create_directories(modelDir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(cacheDir);
+        std::filesystem::remove_all(modelDir);
+    }
+
+    static void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    const std::string cacheDir = "/tmp/ovms_download_cache_test";
+    const std::string modelDir = "/tmp/ovms_download_cache_test_model";
+};
+
+TEST_F(DownloadCacheTest, KeyDependsOnAllFields) {
+    EXPECT_EQ(ovms::DownloadCache::createKey({"s3", "etag", "10"}), ovms::DownloadCache::createKey({"s3", "etag", "10"}));
+    EXPECT_NE(ovms::DownloadCache::createKey({"s3", "etag", "10"}), ovms::DownloadCache::createKey({"s3", "etag", "11"}));
+    EXPECT_NE(ovms::DownloadCache::createKey({"s3", "etag1", "0"}), ovms::DownloadCache::createKey({"s3", "etag", "10"}));
+}
+
+TEST_F(DownloadCacheTest, StoredFileRestoredAfterLocalCopyRemoved) {
+    ovms::DownloadCache cache(cacheDir);
+    const auto key = ovms::DownloadCache::createKey({"s3", "etag", "7"});
+    const std::string downloadedPath = modelDir + "/model.bin";
+    writeFile(downloadedPath, "weights");
+    cache.store(key, downloadedPath);
+    std::filesystem::remove_all(modelDir);
+    std::filesystem::create_directories(modelDir);
+
+    const std::string restoredPath = modelDir + "/other_version_model.bin";
+    ASSERT_TRUE(cache.restore(key, restoredPath));
+    EXPECT_EQ(readFile(restoredPath), "weights");
+}
+
+TEST_F(DownloadCacheTest, MissingFileNotRestored) {
+    ovms::DownloadCache cache(cacheDir);
+    const std::string localPath = modelDir + "/model.bin";
+    EXPECT_FALSE(cache.restore(ovms::DownloadCache::createKey({"s3", "etag", "7"}), localPath));
+    EXPECT_FALSE(std::filesystem::exists(localPath));
+}
+
+TEST_F(DownloadCacheTest, StoreReplacesEntryWithoutModifyingRestoredFiles) {
+    ovms::DownloadCache cache(cacheDir);
+    const auto key = ovms::DownloadCache::createKey({"gcs", "bucket", "object", "1", "3"});
+    const std::string firstPath = modelDir + "/first.bin";
+    const std::string secondPath = modelDir + "/second.bin";
+    const std::string restoredPath = modelDir + "/restored.bin";
+    writeFile(firstPath, "old");
+    cache.store(key, firstPath);
+    ASSERT_TRUE(cache.restore(key, restoredPath));
+
+    writeFile(secondPath, "new");
+    cache.store(key, secondPath);
+    EXPECT_EQ(readFile(restoredPath), "old");
+    const std::string newRestoredPath = modelDir + "/new_restored.bin";
+    ASSERT_TRUE(cache.restore(key, newRestoredPath));
+    EXPECT_EQ(readFile(newRestoredPath), "new");
+}
+
+TEST_F(DownloadCacheTest, DuplicatesLinkedToFirstDownloadedFile) {
+    ovms::DownloadDeduplicator deduplicator;
+    const auto weightsKey = ovms::DownloadCache::createKey({"s3", "etag", "7"});
+    const std::string firstVersionPath = modelDir + "/1_model.bin";
+    const std::string secondVersionPath = modelDir + "/2_model.bin";
+    const std::string topologyPath = modelDir + "/2_model.xml";
+    EXPECT_FALSE(deduplicator.isDuplicate(weightsKey, firstVersionPath));
+    EXPECT_TRUE(deduplicator.isDuplicate(weightsKey, secondVersionPath));
+    EXPECT_FALSE(deduplicator.isDuplicate(ovms::DownloadCache::createKey({"s3", "other_etag", "9"}), topologyPath));
+
+    writeFile(firstVersionPath, "weights");
+    writeFile(secondVersionPath, "");
+    ASSERT_TRUE(deduplicator.linkDuplicates());
+    EXPECT_EQ(readFile(secondVersionPath), "weights");
+    EXPECT_FALSE(std::filesystem::exists(topologyPath));
+}
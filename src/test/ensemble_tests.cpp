@@ -13,11 +13,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <atomic>
+#include <future>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
+#include <grpcpp/grpcpp.h>
 #include <gtest/gtest.h>
 
+#include "../gate_node.hpp"
+#include "../gather_node.hpp"
 #include "../modelconfig.hpp"
 #include "../pipeline.hpp"
 #include "../pipeline_factory.hpp"
@@ -142,6 +150,204 @@ TEST_F(EnsembleFlowTest, DummyModel) {
     checkResponse(dummySeriallyConnectedCount);
 }
 
+TEST_F(EnsembleFlowTest, DummyModelExecutedAsynchronously) {
+    // Pipeline is destroyed from completion callback, as done by gRPC Predict
+    // input   dummy    output
+    //  O------->O------->O
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    auto input_node = std::make_unique<EntryNode>(&request);
+    auto model_node = std::make_unique<DLNode>("dummy_node", dummyModelName, requestedModelVersion, managerWithDummyModel);
+    auto output_node = std::make_unique<ExitNode>(&response);
+
+    auto pipeline = std::make_unique<Pipeline>(*input_node, *output_node);
+    pipeline->connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline->connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+    pipeline->push(std::move(input_node));
+    pipeline->push(std::move(model_node));
+    pipeline->push(std::move(output_node));
+
+    std::promise<Status> finished;
+    auto result = finished.get_future();
+    auto* executedPipeline = pipeline.get();
+    executedPipeline->executeAsync([&pipeline, &finished](const Status& status) {
+        pipeline.reset();
+        finished.set_value(status);
+    });
+    ASSERT_EQ(result.get(), StatusCode::OK);
+    EXPECT_EQ(pipeline, nullptr);
+    checkResponse(1);
+}
+
+class DelayedDLNode : public DLNode {
+    std::thread delayed;
+
+public:
+    DelayedDLNode(const std::string& nodeName, const std::string& modelName, std::optional<model_version_t> modelVersion, ModelManager& modelManager) :
+        DLNode(nodeName, modelName, modelVersion, modelManager, {}) {}
+    ~DelayedDLNode() {
+        if (delayed.joinable()) {
+            delayed.join();
+        }
+    }
+    ovms::Status execute(NodeNotificationQueue& notifyEndQueue) override {
+        delayed = std::thread([this, &notifyEndQueue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            DLNode::execute(notifyEndQueue);
+        });
+        return StatusCode::OK;
+    }
+};
+
+TEST_F(EnsembleFlowTest, NodeTimeoutReportedBeforeNodeFinishes) {
+    // Result is reported once node timeout expires, pipeline is finished once the node finishes
+    // input   dummy(delayed)    output
+    //  O------->O------->O
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    auto input_node = std::make_unique<EntryNode>(&request);
+    auto model_node = std::make_unique<DelayedDLNode>("dummy_node", dummyModelName, requestedModelVersion, managerWithDummyModel);
+    model_node->setTimeout(std::chrono::milliseconds(50));
+    auto output_node = std::make_unique<ExitNode>(&response);
+
+    auto pipeline = std::make_unique<Pipeline>(*input_node, *output_node);
+    pipeline->connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline->connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+    pipeline->push(std::move(input_node));
+    pipeline->push(std::move(model_node));
+    pipeline->push(std::move(output_node));
+
+    std::promise<Status> reported;
+    auto result = reported.get_future();
+    std::promise<void> finished;
+    auto pipelineFinished = finished.get_future();
+    const auto start = std::chrono::steady_clock::now();
+    auto* executedPipeline = pipeline.get();
+    executedPipeline->executeAsync([&reported](const Status& status) { reported.set_value(status); },
+        [&pipeline, &finished]() {
+            pipeline.reset();
+            finished.set_value();
+        });
+    ASSERT_EQ(result.get(), StatusCode::PIPELINE_NODE_TIMEOUT);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+    pipelineFinished.get();
+    EXPECT_EQ(pipeline, nullptr);
+}
+
+TEST_F(EnsembleFlowTest, SynchronousExecutionReturnsOnTimeoutBeforeNodeFinishes) {
+    // Caller is unblocked once node timeout expires, pipeline and kept objects are released once the node finishes
+    // input   dummy(delayed)    output
+    //  O------->O------->O
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    auto input_node = std::make_unique<EntryNode>(&request);
+    auto model_node = std::make_unique<DelayedDLNode>("dummy_node", dummyModelName, requestedModelVersion, managerWithDummyModel);
+    model_node->setTimeout(std::chrono::milliseconds(50));
+    auto output_node = std::make_unique<ExitNode>(&response);
+
+    auto pipeline = std::make_unique<Pipeline>(*input_node, *output_node);
+    pipeline->connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline->connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+    pipeline->push(std::move(input_node));
+    pipeline->push(std::move(model_node));
+    pipeline->push(std::move(output_node));
+
+    std::promise<void> released;
+    auto keptReleased = released.get_future();
+    std::shared_ptr<void> keepAlive(nullptr, [&released](void*) { released.set_value(); });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(Pipeline::executeAndRelease(std::move(pipeline), std::move(keepAlive)), StatusCode::PIPELINE_NODE_TIMEOUT);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+    keptReleased.get();
+    EXPECT_EQ(response.outputs().size(), 0);
+}
+
+TEST_F(EnsembleFlowTest, ConcurrentPipelinesBatchedInDynamicallyBatchedModel) {
+    // Nodes of concurrent pipelines are merged into one inference by batching scheduler of dummy model
+    // input   dummy    output
+    //  O------->O------->O
+    const size_t maxBatchSize = 4;
+    config.setBatchSize(0);
+    config.setNireq(1);
+    config.setMaxBatchSize(maxBatchSize);
+    config.setBatchTimeoutMicroseconds(200000);
+    ConstructorEnabledModelManager managerWithDummyModel;
+    ASSERT_EQ(managerWithDummyModel.reloadModelWithVersions(config), StatusCode::OK);
+
+    std::vector<PredictRequest> requests(maxBatchSize, request);
+    std::vector<PredictResponse> responses(maxBatchSize);
+    std::vector<Status> statuses(maxBatchSize);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < maxBatchSize; i++) {
+        threads.emplace_back([this, i, &requests, &responses, &statuses, &managerWithDummyModel]() {
+            auto input_node = std::make_unique<EntryNode>(&requests[i]);
+            auto model_node = std::make_unique<DLNode>("dummy_node", dummyModelName, requestedModelVersion, managerWithDummyModel);
+            auto output_node = std::make_unique<ExitNode>(&responses[i]);
+
+            Pipeline pipeline(*input_node, *output_node);
+            pipeline.connect(*input_node, *model_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+            pipeline.connect(*model_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+            pipeline.push(std::move(input_node));
+            pipeline.push(std::move(model_node));
+            pipeline.push(std::move(output_node));
+            statuses[i] = pipeline.execute();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < maxBatchSize; i++) {
+        ASSERT_EQ(statuses[i], StatusCode::OK) << "pipeline: " << i;
+        response = responses[i];
+        checkResponse(1);
+    }
+    auto modelInstance = managerWithDummyModel.findModelInstance(dummyModelName);
+    ASSERT_NE(modelInstance, nullptr);
+    EXPECT_EQ(modelInstance->getInferRequestsQueue().getIdleStreamsCount(), 1);
+}
+
+TEST_F(EnsembleFlowTest, DummyModelsChainWithZeroCopyOutputs) {
+    // Outputs of both nodes are passed further without copy, first node keeps its stream until second finishes
+    // input   dummy   dummy    output
+    //  O------->O------->O------->O
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    auto input_node = std::make_unique<EntryNode>(&request);
+    auto first_node = std::make_unique<DLNode>("dummy_node_1", dummyModelName, requestedModelVersion, managerWithDummyModel,
+        std::unordered_map<std::string, std::string>{}, true);
+    auto second_node = std::make_unique<DLNode>("dummy_node_2", dummyModelName, requestedModelVersion, managerWithDummyModel,
+        std::unordered_map<std::string, std::string>{}, true);
+    auto output_node = std::make_unique<ExitNode>(&response);
+
+    Pipeline pipeline(*input_node, *output_node);
+    pipeline.connect(*input_node, *first_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*first_node, *second_node, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*second_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+
+    pipeline.push(std::move(input_node));
+    pipeline.push(std::move(first_node));
+    pipeline.push(std::move(second_node));
+    pipeline.push(std::move(output_node));
+
+    ASSERT_EQ(pipeline.execute(), StatusCode::OK);
+    checkResponse(2);
+
+    // All streams need to be returned after pipeline execution
+    auto modelInstance = managerWithDummyModel.findModelInstance(dummyModelName);
+    ASSERT_NE(modelInstance, nullptr);
+    for (uint i = 0; i < NIREQ; i++) {
+        EXPECT_TRUE(modelInstance->getInferRequestsQueue().tryGetIdleStream().has_value());
+    }
+}
+
 TEST_F(EnsembleFlowTest, DummyModelDirectAndPipelineInference) {
     ConstructorEnabledModelManager managerWithDummyModel;
     config.setNireq(1);
@@ -547,6 +753,101 @@ TEST_F(EnsembleFlowTest, ParallelDummyModels) {
     }
 }
 
+class ExecutionRecordingDLNode : public DLNode {
+    std::set<std::string>& executedNodes;
+
+public:
+    ExecutionRecordingDLNode(const std::string& nodeName, const std::string& modelName, std::optional<model_version_t> modelVersion,
+        ModelManager& modelManager, std::set<std::string>& executedNodes) :
+        DLNode(nodeName, modelName, modelVersion, modelManager),
+        executedNodes(executedNodes) {}
+
+    Status execute(NodeNotificationQueue& notifyEndQueue) override {
+        executedNodes.insert(getName());
+        return DLNode::execute(notifyEndQueue);
+    }
+};
+
+TEST_F(EnsembleFlowTest, DuplicateDummyNodesWithTheSameInputsAreMemoized) {
+    /* input      dummy x 3      output
+        O---------->O------------->O
+        |---------->O------------->|
+        L---------->O------------->|  (different input)
+    */
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+    auto input_node = std::make_unique<EntryNode>(&request);
+    auto output_node = std::make_unique<ExitNode>(&response);
+    Pipeline pipeline(*input_node, *output_node);
+    std::set<std::string> executedNodes;
+    const std::string otherInputName = customPipelineInputName + "_other";
+    const std::vector<std::string> nodeInputs{customPipelineInputName, customPipelineInputName, otherInputName};
+    for (size_t i = 0; i < nodeInputs.size(); i++) {
+        auto node = std::make_unique<ExecutionRecordingDLNode>("dummy_node_" + std::to_string(i), dummyModelName, requestedModelVersion, managerWithDummyModel, executedNodes);
+        pipeline.connect(*input_node, *node, {{nodeInputs[i], DUMMY_MODEL_INPUT_NAME}});
+        pipeline.connect(*node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName + std::to_string(i)}});
+        pipeline.push(std::move(node));
+    }
+    pipeline.push(std::move(input_node));
+    pipeline.push(std::move(output_node));
+
+    std::vector<float> otherRequestData(DUMMY_MODEL_INPUT_SIZE, 7.0);
+    tensorflow::TensorProto& proto = (*request.mutable_inputs())[otherInputName];
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_content()->assign((char*)otherRequestData.data(), otherRequestData.size() * sizeof(float));
+    proto.mutable_tensor_shape()->add_dim()->set_size(1);
+    proto.mutable_tensor_shape()->add_dim()->set_size(DUMMY_MODEL_INPUT_SIZE);
+
+    ASSERT_EQ(pipeline.execute(), ovms::StatusCode::OK);
+    EXPECT_EQ(executedNodes.size(), 2);
+    EXPECT_EQ(executedNodes.count("dummy_node_2"), 1);
+
+    std::vector<std::vector<float>> expectedOutputs{requestData, requestData, otherRequestData};
+    for (size_t i = 0; i < expectedOutputs.size(); i++) {
+        const auto outputName = customPipelineOutputName + std::to_string(i);
+        ASSERT_EQ(response.outputs().count(outputName), 1);
+        const auto& output = response.outputs().at(outputName);
+        ASSERT_EQ(output.tensor_content().size(), DUMMY_MODEL_OUTPUT_SIZE * sizeof(float));
+        auto& expected = expectedOutputs[i];
+        std::for_each(expected.begin(), expected.end(), [](float& v) { v += 1.0; });
+        EXPECT_EQ(0, std::memcmp(output.tensor_content().data(), expected.data(), output.tensor_content().size()))
+            << readableError(expected.data(), (const float*)output.tensor_content().data(), DUMMY_MODEL_OUTPUT_SIZE);
+    }
+}
+
+TEST_F(EnsembleFlowTest, NodesFeedingOnlyFilteredOutOutputsAreNotExecuted) {
+    /* input      dummy      output
+        O---------->O--------->O
+        L---------->O--->O---->|  (filtered out)
+    */
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+    auto input_node = std::make_unique<EntryNode>(&request);
+    auto output_node = std::make_unique<ExitNode>(&response);
+    output_node->setRequest(&request);
+    Pipeline pipeline(*input_node, *output_node);
+    std::set<std::string> executedNodes;
+    auto requested_node = std::make_unique<ExecutionRecordingDLNode>("requested_node", dummyModelName, requestedModelVersion, managerWithDummyModel, executedNodes);
+    auto first_filtered_node = std::make_unique<ExecutionRecordingDLNode>("first_filtered_node", dummyModelName, requestedModelVersion, managerWithDummyModel, executedNodes);
+    auto second_filtered_node = std::make_unique<ExecutionRecordingDLNode>("second_filtered_node", dummyModelName, requestedModelVersion, managerWithDummyModel, executedNodes);
+    pipeline.connect(*input_node, *requested_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*requested_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}});
+    pipeline.connect(*input_node, *first_filtered_node, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*first_filtered_node, *second_filtered_node, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}});
+    pipeline.connect(*second_filtered_node, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, "filtered_output"}});
+    pipeline.push(std::move(input_node));
+    pipeline.push(std::move(requested_node));
+    pipeline.push(std::move(first_filtered_node));
+    pipeline.push(std::move(second_filtered_node));
+    pipeline.push(std::move(output_node));
+
+    request.add_output_filter(customPipelineOutputName);
+    ASSERT_EQ(pipeline.execute(), ovms::StatusCode::OK);
+    EXPECT_EQ(executedNodes, std::set<std::string>{"requested_node"});
+    EXPECT_EQ(response.outputs().size(), 1);
+    checkResponse(1);
+}
+
 TEST_F(EnsembleFlowTest, FailInDLNodeSetInputsMissingInput) {
     // Most basic configuration, just process single dummy model request
 
@@ -1147,82 +1448,678 @@ TEST_F(EnsembleFlowTest, PipelineDefinitionContainingNodeConnectedToItselfValida
         {ENTRY_NODE_NAME, {{"output", "input"}}},
         {"dummy_node", {{"output", "input"}}}};
 
-    // dummy node 1 O--------->O response
+    // dummy node 1 O--------->O response
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{"output", "input"}}}};
+
+    // Create pipeline definition
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateForCycles(), StatusCode::PIPELINE_CYCLE_FOUND);
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionContainingTwoCyclesValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    // Simulate reading from pipeline_config.json
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME},
+        {NodeKind::DL, "dummy_node", "output"},
+        {NodeKind::DL, "dummy_node1", "output"},
+        {NodeKind::DL, "dummy_node2", "output"},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+
+    // request O--------->O dummy node
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{"output", "input"}}}};
+
+    // dummy node O--------->O dummy node
+    connections["dummy_node"] = {
+        {EXIT_NODE_NAME, {{"output", "input"}}}};
+
+    // dummy node 1 O--------->O response
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node1", {{"output", "input"}}}};
+
+    // dummy node   O---------------\/
+    // dummy node 2 O--------->dummy node 1
+    connections["dummy_node1"] = {
+        {"dummy_node", {{"output", "input"}}},
+        {"dummy_node2", {{"output", "input"}}}};
+
+    // dummy node 1 O--------->O dummy node 2
+    connections["dummy_node2"] = {
+        {"dummy_node1", {{"output", "input"}}}};
+
+    // Create pipeline definition
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateForCycles(), StatusCode::PIPELINE_CYCLE_FOUND);
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionContainingUnconnectedNodeValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    // Simulate reading from pipeline_config.json
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME},
+        {NodeKind::DL, "dummy_node", "output"},
+        {NodeKind::DL, "dummy_node1", "output"},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+
+    // request O--------->O dummy node
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{"output", "input"}}}};
+
+    // dummy node O--------->O response
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{"output", "input"}}}};
+
+    // Create pipeline definition
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateForCycles(), StatusCode::PIPELINE_CONTAINS_UNCONNECTED_NODES);
+}
+
+TEST_F(EnsembleFlowTest, DemultiplexerCropsAreGatheredByCount) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    // Nodes
+    // request   demultiplexer   gather   response
+    //  O------------>O---------->O------->O
+    // 2x2 image with three detections, one of them below confidence threshold
+    PredictRequest demultiplexerRequest;
+    std::vector<float> image{1.0, 2.0, 3.0, 4.0};
+    auto& imageProto = (*demultiplexerRequest.mutable_inputs())["image"];
+    imageProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : {1, 1, 2, 2}) {
+        imageProto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    imageProto.mutable_tensor_content()->assign((char*)image.data(), image.size() * sizeof(float));
+    std::vector<float> detections{
+        0, 1, 0.9, 0.0, 0.0, 1.0, 1.0,
+        0, 1, 0.1, 0.0, 0.0, 0.5, 0.5,
+        0, 1, 0.8, 0.5, 0.0, 1.0, 1.0,
+        -1, 0, 0, 0, 0, 0, 0};
+    auto& detectionProto = (*demultiplexerRequest.mutable_inputs())["detection"];
+    detectionProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : {1, 1, 4, 7}) {
+        detectionProto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    detectionProto.mutable_tensor_content()->assign((char*)detections.data(), detections.size() * sizeof(float));
+
+    DemultiplexerParameters parameters;
+    parameters.cropWidth = 2;
+    parameters.cropHeight = 2;
+    parameters.maxCrops = 4;
+    parameters.confidenceThreshold = 0.5;
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"image", "image"}, {"detection", "detection"}}},
+        {NodeKind::DEMULTIPLEXER, "demultiplexer_node", "", std::nullopt,
+            {{"crops", DEMULTIPLEXER_CROPS_OUTPUT_NAME}, {"count", DEMULTIPLEXER_CROPS_COUNT_OUTPUT_NAME}, {"coordinates", DEMULTIPLEXER_COORDINATES_OUTPUT_NAME}},
+            false, parameters},
+        {NodeKind::GATHER, "gather_node", "", std::nullopt, {{"crops", "crops"}, {"coordinates", "coordinates"}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["demultiplexer_node"] = {
+        {ENTRY_NODE_NAME, {{"image", DEMULTIPLEXER_IMAGE_INPUT_NAME}, {"detection", DEMULTIPLEXER_DETECTION_INPUT_NAME}}}};
+    connections["gather_node"] = {
+        {"demultiplexer_node", {{"crops", "crops"}, {"coordinates", "coordinates"}, {"count", GATHER_COUNT_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"gather_node", {{"crops", "crops"}, {"coordinates", "coordinates"}}}};
+
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("demultiplexer_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "demultiplexer_pipeline", &demultiplexerRequest, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+
+    ASSERT_EQ(response.outputs().count("crops"), 1);
+    const auto& crops = response.outputs().at("crops");
+    EXPECT_THAT(asVector(crops.tensor_shape()), ::testing::ElementsAre(2, 1, 2, 2));
+    auto cropsData = asVector<float>(crops.tensor_content());
+    ASSERT_EQ(cropsData.size(), 8);
+    // Box covering whole image is resized without change
+    EXPECT_THAT(std::vector<float>(cropsData.begin(), cropsData.begin() + 4), ::testing::ElementsAre(1.0, 2.0, 3.0, 4.0));
+    // Right half of image stretched to crop width, first column interpolated with left neighbour
+    EXPECT_THAT(std::vector<float>(cropsData.begin() + 4, cropsData.end()), ::testing::ElementsAre(1.75, 2.0, 3.75, 4.0));
+
+    ASSERT_EQ(response.outputs().count("coordinates"), 1);
+    const auto& coordinates = response.outputs().at("coordinates");
+    EXPECT_THAT(asVector(coordinates.tensor_shape()), ::testing::ElementsAre(2, 4));
+    EXPECT_THAT(asVector<float>(coordinates.tensor_content()), ::testing::ElementsAre(0.0, 0.0, 1.0, 1.0, 0.5, 0.0, 1.0, 1.0));
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionDemultiplexerWithInvalidParametersValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    DemultiplexerParameters parameters;
+    parameters.cropWidth = 2;
+    parameters.cropHeight = 2;
+    parameters.maxCrops = 0;
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"image", "image"}, {"detection", "detection"}}},
+        {NodeKind::DEMULTIPLEXER, "demultiplexer_node", "", std::nullopt, {{"crops", DEMULTIPLEXER_CROPS_OUTPUT_NAME}}, false, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["demultiplexer_node"] = {
+        {ENTRY_NODE_NAME, {{"image", DEMULTIPLEXER_IMAGE_INPUT_NAME}, {"detection", DEMULTIPLEXER_DETECTION_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"demultiplexer_node", {{"crops", "crops"}}}};
+
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NODE_INVALID_PARAMETERS);
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionDemultiplexerWithMissingInputValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    DemultiplexerParameters parameters;
+    parameters.cropWidth = 2;
+    parameters.cropHeight = 2;
+    parameters.maxCrops = 4;
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"image", "image"}}},
+        {NodeKind::DEMULTIPLEXER, "demultiplexer_node", "", std::nullopt, {{"crops", DEMULTIPLEXER_CROPS_OUTPUT_NAME}}, false, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["demultiplexer_node"] = {
+        {ENTRY_NODE_NAME, {{"image", DEMULTIPLEXER_IMAGE_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"demultiplexer_node", {{"crops", "crops"}}}};
+
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NOT_ALL_INPUTS_CONNECTED);
+}
+
+TEST_F(EnsembleFlowTest, PreprocessingNodeConvertsNormalizesAndResizes) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    // U8 image in NHWC layout with height 1, width 2 and 2 channels
+    PredictRequest preprocessingRequest;
+    std::vector<uint8_t> image{10, 20, 30, 40};
+    auto& imageProto = (*preprocessingRequest.mutable_inputs())["image"];
+    imageProto.set_dtype(tensorflow::DataType::DT_UINT8);
+    for (auto dim : {1, 1, 2, 2}) {
+        imageProto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    imageProto.mutable_tensor_content()->assign((char*)image.data(), image.size());
+
+    PreprocessingParameters parameters;
+    parameters.resizeWidth = 4;
+    parameters.resizeHeight = 1;
+    parameters.mean = {10, 20};
+    parameters.scale = {2, 4};
+    parameters.inputLayout = "NHWC";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"image", "image"}}},
+        {NodeKind::PREPROCESSING, "preprocessing_node", "", std::nullopt, {{"preprocessed", PREPROCESSING_IMAGE_OUTPUT_NAME}}, false, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["preprocessing_node"] = {
+        {ENTRY_NODE_NAME, {{"image", PREPROCESSING_IMAGE_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"preprocessing_node", {{"preprocessed", "preprocessed"}}}};
+
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("preprocessing_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "preprocessing_pipeline", &preprocessingRequest, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+
+    ASSERT_EQ(response.outputs().count("preprocessed"), 1);
+    const auto& output = response.outputs().at("preprocessed");
+    EXPECT_EQ(output.dtype(), tensorflow::DataType::DT_FLOAT);
+    EXPECT_THAT(asVector(output.tensor_shape()), ::testing::ElementsAre(1, 2, 1, 4));
+    EXPECT_THAT(asVector<float>(output.tensor_content()), ::testing::ElementsAre(0.0, 2.5, 7.5, 10.0, 0.0, 1.25, 3.75, 5.0));
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionPreprocessingWithInvalidParametersValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    PreprocessingParameters parameters;
+    parameters.resizeWidth = 4;
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"image", "image"}}},
+        {NodeKind::PREPROCESSING, "preprocessing_node", "", std::nullopt, {{"preprocessed", PREPROCESSING_IMAGE_OUTPUT_NAME}}, false, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["preprocessing_node"] = {
+        {ENTRY_NODE_NAME, {{"image", PREPROCESSING_IMAGE_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"preprocessing_node", {{"preprocessed", "preprocessed"}}}};
+
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NODE_INVALID_PARAMETERS);
+}
+
+TEST_F(EnsembleFlowTest, PostprocessingNodeReturnsTopKClasses) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    PredictRequest postprocessingRequest;
+    std::vector<float> logits{1, 4, 3, 2, 8, 5, 6, 7};
+    auto& logitsProto = (*postprocessingRequest.mutable_inputs())["logits"];
+    logitsProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : {2, 4}) {
+        logitsProto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    logitsProto.mutable_tensor_content()->assign((char*)logits.data(), logits.size() * sizeof(float));
+
+    PostprocessingParameters parameters;
+    parameters.operation = POSTPROCESSING_TOP_K;
+    parameters.topK = 2;
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"logits", "logits"}}},
+        {NodeKind::POSTPROCESSING, "postprocessing_node", "", std::nullopt,
+            {{"classes", POSTPROCESSING_CLASSES_OUTPUT_NAME}, {"scores", POSTPROCESSING_SCORES_OUTPUT_NAME}}, false, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["postprocessing_node"] = {
+        {ENTRY_NODE_NAME, {{"logits", POSTPROCESSING_LOGITS_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"postprocessing_node", {{"classes", "classes"}, {"scores", "scores"}}}};
+
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("postprocessing_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "postprocessing_pipeline", &postprocessingRequest, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+
+    ASSERT_EQ(response.outputs().count("classes"), 1);
+    ASSERT_EQ(response.outputs().count("scores"), 1);
+    const auto& classes = response.outputs().at("classes");
+    EXPECT_EQ(classes.dtype(), tensorflow::DataType::DT_INT32);
+    EXPECT_THAT(asVector(classes.tensor_shape()), ::testing::ElementsAre(2, 2));
+    EXPECT_THAT(asVector<int32_t>(classes.tensor_content()), ::testing::ElementsAre(1, 2, 0, 3));
+    EXPECT_THAT(asVector<float>(response.outputs().at("scores").tensor_content()), ::testing::ElementsAre(4, 3, 8, 7));
+}
+
+TEST_F(EnsembleFlowTest, PostprocessingNodeSuppressesOverlappingDetections) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    PredictRequest postprocessingRequest;
+    // second box overlaps first one with IoU 0.81, third one is separate
+    std::vector<float> boxes{0, 0, 10, 10, 1, 1, 10, 10, 20, 20, 30, 30};
+    std::vector<float> scores{0.9, 0.8, 0.7};
+    auto& boxesProto = (*postprocessingRequest.mutable_inputs())["boxes"];
+    boxesProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : {1, 3, 4}) {
+        boxesProto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    boxesProto.mutable_tensor_content()->assign((char*)boxes.data(), boxes.size() * sizeof(float));
+    auto& scoresProto = (*postprocessingRequest.mutable_inputs())["scores"];
+    scoresProto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : {1, 3}) {
+        scoresProto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    scoresProto.mutable_tensor_content()->assign((char*)scores.data(), scores.size() * sizeof(float));
+
+    PostprocessingParameters parameters;
+    parameters.operation = POSTPROCESSING_NMS;
+    parameters.topK = 3;
+    parameters.iouThreshold = 0.5;
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"boxes", "boxes"}, {"scores", "scores"}}},
+        {NodeKind::POSTPROCESSING, "postprocessing_node", "", std::nullopt,
+            {{"boxes", POSTPROCESSING_BOXES_OUTPUT_NAME}, {"scores", POSTPROCESSING_SCORES_OUTPUT_NAME}, {"count", POSTPROCESSING_COUNT_OUTPUT_NAME}}, false, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["postprocessing_node"] = {
+        {ENTRY_NODE_NAME, {{"boxes", POSTPROCESSING_BOXES_INPUT_NAME}, {"scores", POSTPROCESSING_SCORES_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"postprocessing_node", {{"boxes", "boxes"}, {"scores", "scores"}, {"count", "count"}}}};
+
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("postprocessing_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "postprocessing_pipeline", &postprocessingRequest, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+
+    ASSERT_EQ(response.outputs().count("count"), 1);
+    EXPECT_THAT(asVector<int32_t>(response.outputs().at("count").tensor_content()), ::testing::ElementsAre(2));
+    const auto& keptBoxes = response.outputs().at("boxes");
+    EXPECT_THAT(asVector(keptBoxes.tensor_shape()), ::testing::ElementsAre(1, 3, 4));
+    EXPECT_THAT(asVector<float>(keptBoxes.tensor_content()), ::testing::ElementsAre(0, 0, 10, 10, 20, 20, 30, 30, 0, 0, 0, 0));
+    EXPECT_THAT(asVector<float>(response.outputs().at("scores").tensor_content()), ::testing::ElementsAre(0.9f, 0.7f, 0.0f));
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionPostprocessingWithInvalidParametersValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    PostprocessingParameters parameters;
+    parameters.operation = "sigmoid";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"logits", "logits"}}},
+        {NodeKind::POSTPROCESSING, "postprocessing_node", "", std::nullopt, {{"classes", POSTPROCESSING_CLASSES_OUTPUT_NAME}}, false, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["postprocessing_node"] = {
+        {ENTRY_NODE_NAME, {{"logits", POSTPROCESSING_LOGITS_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"postprocessing_node", {{"classes", "classes"}}}};
+
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NODE_INVALID_PARAMETERS);
+}
+
+class EnsembleGateTest : public EnsembleFlowTest {
+protected:
+    void createCascadeDefinition(PipelineFactory& factory, ModelManager& manager, const GateParameters& parameters) {
+        // request   dummy_node_1   gate   dummy_node_2   response
+        //                 \___________________________/ intermediate
+        std::vector<NodeInfo> info{
+            {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+            {NodeKind::DL, "dummy_node_1", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+            {NodeKind::GATE, "gate_node", "", std::nullopt, {{GATE_CONDITION_INPUT_NAME, GATE_CONDITION_INPUT_NAME}, {"passed", "passed"}}, false, {}, {}, {}, {}, {}, parameters},
+            {NodeKind::DL, "dummy_node_2", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+            {NodeKind::EXIT, EXIT_NODE_NAME},
+        };
+        pipeline_connections_t connections;
+        connections["dummy_node_1"] = {
+            {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+        connections["gate_node"] = {
+            {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, GATE_CONDITION_INPUT_NAME}}},
+            {ENTRY_NODE_NAME, {{customPipelineInputName, "passed"}}}};
+        connections["dummy_node_2"] = {
+            {"gate_node", {{"passed", DUMMY_MODEL_INPUT_NAME}}}};
+        connections[EXIT_NODE_NAME] = {
+            {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, "intermediate"}}},
+            {"dummy_node_2", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+        ASSERT_EQ(factory.createDefinition("cascade_pipeline", info, connections, manager), StatusCode::OK);
+    }
+};
+
+TEST_F(EnsembleGateTest, OpenGateExecutesFollowingNodes) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    GateParameters parameters;
+    parameters.comparison = GATE_GREATER;
+    // dummy_node_1 outputs values up to 103
+    parameters.threshold = 100;
+    PipelineFactory factory;
+    createCascadeDefinition(factory, managerWithDummyModel, parameters);
+
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "cascade_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    checkResponse(1);
+    EXPECT_EQ(response.outputs().count("intermediate"), 1);
+}
+
+TEST_F(EnsembleGateTest, ClosedGateSkipsFollowingNodes) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    GateParameters parameters;
+    parameters.comparison = GATE_LESS;
+    // dummy_node_1 outputs values not lower than -99
+    parameters.threshold = -100;
+    PipelineFactory factory;
+    createCascadeDefinition(factory, managerWithDummyModel, parameters);
+    auto metrics = factory.findDefinitionByName("cascade_pipeline")->getMetrics();
+
+    // second pipeline is taken from pool and has to be skipped again
+    for (int i = 0; i < 2; i++) {
+        std::unique_ptr<Pipeline> pipeline;
+        response.Clear();
+        ASSERT_EQ(factory.create(pipeline, "cascade_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+        ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+        EXPECT_EQ(response.outputs().count("intermediate"), 1);
+        EXPECT_EQ(response.outputs().count(customPipelineOutputName), 0);
+    }
+
+    EXPECT_EQ(metrics->requestsSuccess, 2);
+    EXPECT_EQ(metrics->getNode("dummy_node_1").execution.getCount(), 2);
+    EXPECT_EQ(metrics->getNode("dummy_node_2").execution.getCount(), 0);
+    EXPECT_EQ(metrics->getNode("dummy_node_2").skipped, 2);
+}
+
+TEST_F(EnsembleGateTest, OutputFilterOfSkippedOutputIsAccepted) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    GateParameters parameters;
+    parameters.threshold = 1000;
+    PipelineFactory factory;
+    createCascadeDefinition(factory, managerWithDummyModel, parameters);
+
+    request.add_output_filter(customPipelineOutputName);
+    request.add_output_filter("intermediate");
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "cascade_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    EXPECT_EQ(response.outputs().count("intermediate"), 1);
+    EXPECT_EQ(response.outputs().count(customPipelineOutputName), 0);
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionGateWithInvalidParametersValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    GateParameters parameters;
+    parameters.comparison = "equal";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"scores", "scores"}}},
+        {NodeKind::GATE, "gate_node", "", std::nullopt, {{"scores", GATE_CONDITION_INPUT_NAME}}, false, {}, {}, {}, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["gate_node"] = {
+        {ENTRY_NODE_NAME, {{"scores", GATE_CONDITION_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"gate_node", {{"scores", "scores"}}}};
+
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NODE_INVALID_PARAMETERS);
+}
+
+TEST_F(EnsembleFlowTest, CustomNodeLibraryProcessesInputs) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    CustomNodeParameters parameters;
+    parameters.libraryPath = "/ovms/bazel-bin/src/libsamplecustomnode.so";
+    // adds 1 to inputs like dummy model
+    parameters.params = {{"add_value", "1"}};
+    ASSERT_EQ(CustomNodeLibrary::load(parameters.libraryPath, parameters.library), StatusCode::OK);
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::CUSTOM, "custom_node", "", std::nullopt, {{"sum", "values"}}, false, {}, {}, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["custom_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, "values"}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"custom_node", {{"sum", customPipelineOutputName}}}};
+
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("custom_node_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "custom_node_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+
+    checkResponse(1);
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionCustomNodeWithMissingLibraryValidation) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    CustomNodeParameters parameters;
+    parameters.libraryPath = "/nonexisting/libcustomnode.so";
+    EXPECT_EQ(CustomNodeLibrary::load(parameters.libraryPath, parameters.library), StatusCode::CUSTOM_NODE_LIBRARY_INVALID);
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::CUSTOM, "custom_node", "", std::nullopt, {{"sum", "values"}}, false, {}, {}, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["custom_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, "values"}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"custom_node", {{"sum", customPipelineOutputName}}}};
+
+    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NODE_INVALID_PARAMETERS);
+}
+
+namespace {
+// Serves dummy model on other server, adds 1 to inputs like the real one
+class RemoteDummyService final : public PredictionService::Service {
+public:
+    std::atomic<int> calls{0};
+    std::vector<std::string> lastOutputFilter;
+
+    grpc::Status Predict(grpc::ServerContext* context, const PredictRequest* request, PredictResponse* response) override {
+        calls++;
+        lastOutputFilter.assign(request->output_filter().begin(), request->output_filter().end());
+        if (request->model_spec().name() != "dummy" || request->inputs().count(DUMMY_MODEL_INPUT_NAME) == 0) {
+            return grpc::Status(grpc::StatusCode::NOT_FOUND, "model or input not found");
+        }
+        const auto& input = request->inputs().at(DUMMY_MODEL_INPUT_NAME);
+        auto& output = (*response->mutable_outputs())[DUMMY_MODEL_OUTPUT_NAME];
+        output = input;
+        auto* values = reinterpret_cast<float*>(&(*output.mutable_tensor_content())[0]);
+        for (size_t i = 0; i < output.tensor_content().size() / sizeof(float); i++) {
+            values[i] += 1;
+        }
+        return grpc::Status::OK;
+    }
+};
+}  // namespace
+
+TEST_F(EnsembleFlowTest, RemoteNodeRunsInferenceOnOtherServer) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+
+    RemoteDummyService service;
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+    ASSERT_NE(port, 0);
+
+    RemoteParameters parameters;
+    parameters.address = "localhost:" + std::to_string(port);
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::REMOTE, "remote_node", "dummy", std::nullopt, {{"remote_output", DUMMY_MODEL_OUTPUT_NAME}}, false, {}, {}, {}, parameters},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+
+    pipeline_connections_t connections;
+    connections["remote_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
     connections[EXIT_NODE_NAME] = {
-        {"dummy_node", {{"output", "input"}}}};
+        {"remote_node", {{"remote_output", customPipelineOutputName}}}};
 
-    // Create pipeline definition
-    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
-    ASSERT_EQ(pipelineDefinition.validateForCycles(), StatusCode::PIPELINE_CYCLE_FOUND);
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("remote_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    for (int i = 0; i < 2; i++) {
+        response.Clear();
+        std::unique_ptr<Pipeline> pipeline;
+        ASSERT_EQ(factory.create(pipeline, "remote_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+        ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+        checkResponse(1);
+    }
+    EXPECT_EQ(service.calls, 2);
+    EXPECT_THAT(service.lastOutputFilter, ::testing::ElementsAre(DUMMY_MODEL_OUTPUT_NAME));
+    server->Shutdown();
 }
 
-TEST_F(EnsembleFlowTest, PipelineDefinitionContainingTwoCyclesValidation) {
+TEST_F(EnsembleFlowTest, RemoteNodeFailsPipelineWhenRemoteServerIsUnavailable) {
     ConstructorEnabledModelManager managerWithDummyModel;
-    managerWithDummyModel.reloadModelWithVersions(config);
 
-    // Simulate reading from pipeline_config.json
+    RemoteParameters parameters;
+    parameters.address = "localhost:1";
     std::vector<NodeInfo> info{
-        {NodeKind::ENTRY, ENTRY_NODE_NAME},
-        {NodeKind::DL, "dummy_node", "output"},
-        {NodeKind::DL, "dummy_node1", "output"},
-        {NodeKind::DL, "dummy_node2", "output"},
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::REMOTE, "remote_node", "dummy", std::nullopt, {{"remote_output", DUMMY_MODEL_OUTPUT_NAME}}, false, {}, {}, {}, parameters},
         {NodeKind::EXIT, EXIT_NODE_NAME},
     };
 
     pipeline_connections_t connections;
-
-    // request O--------->O dummy node
-    connections["dummy_node"] = {
-        {ENTRY_NODE_NAME, {{"output", "input"}}}};
-
-    // dummy node O--------->O dummy node
-    connections["dummy_node"] = {
-        {EXIT_NODE_NAME, {{"output", "input"}}}};
-
-    // dummy node 1 O--------->O response
+    connections["remote_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
     connections[EXIT_NODE_NAME] = {
-        {"dummy_node1", {{"output", "input"}}}};
-
-    // dummy node   O---------------\/
-    // dummy node 2 O--------->dummy node 1
-    connections["dummy_node1"] = {
-        {"dummy_node", {{"output", "input"}}},
-        {"dummy_node2", {{"output", "input"}}}};
-
-    // dummy node 1 O--------->O dummy node 2
-    connections["dummy_node2"] = {
-        {"dummy_node1", {{"output", "input"}}}};
+        {"remote_node", {{"remote_output", customPipelineOutputName}}}};
 
-    // Create pipeline definition
-    PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
-    ASSERT_EQ(pipelineDefinition.validateForCycles(), StatusCode::PIPELINE_CYCLE_FOUND);
+    PipelineFactory factory;
+    ASSERT_EQ(factory.createDefinition("remote_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "remote_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    EXPECT_EQ(pipeline->execute(), StatusCode::REMOTE_INFERENCE_FAILED);
 }
 
-TEST_F(EnsembleFlowTest, PipelineDefinitionContainingUnconnectedNodeValidation) {
+TEST_F(EnsembleFlowTest, PipelineDefinitionRemoteNodeWithInvalidAddressValidation) {
     ConstructorEnabledModelManager managerWithDummyModel;
-    managerWithDummyModel.reloadModelWithVersions(config);
 
-    // Simulate reading from pipeline_config.json
+    RemoteParameters parameters;
+    parameters.address = "localhost";
     std::vector<NodeInfo> info{
-        {NodeKind::ENTRY, ENTRY_NODE_NAME},
-        {NodeKind::DL, "dummy_node", "output"},
-        {NodeKind::DL, "dummy_node1", "output"},
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::REMOTE, "remote_node", "dummy", std::nullopt, {{"remote_output", DUMMY_MODEL_OUTPUT_NAME}}, false, {}, {}, {}, parameters},
         {NodeKind::EXIT, EXIT_NODE_NAME},
     };
 
     pipeline_connections_t connections;
-
-    // request O--------->O dummy node
-    connections["dummy_node"] = {
-        {ENTRY_NODE_NAME, {{"output", "input"}}}};
-
-    // dummy node O--------->O response
+    connections["remote_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
     connections[EXIT_NODE_NAME] = {
-        {"dummy_node", {{"output", "input"}}}};
+        {"remote_node", {{"remote_output", customPipelineOutputName}}}};
 
-    // Create pipeline definition
     PipelineDefinition pipelineDefinition("my_new_pipeline", info, connections);
-    ASSERT_EQ(pipelineDefinition.validateForCycles(), StatusCode::PIPELINE_CONTAINS_UNCONNECTED_NODES);
+    ASSERT_EQ(pipelineDefinition.validateNodes(managerWithDummyModel), StatusCode::PIPELINE_NODE_INVALID_PARAMETERS);
+}
+
+TEST(RemoteNode, OutputPointsIntoResponseContent) {
+    auto response = std::make_shared<PredictResponse>();
+    auto& proto = (*response->mutable_outputs())["output"];
+    std::vector<float> values{1, 2, 3, 4, 5, 6};
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_shape()->add_dim()->set_size(2);
+    proto.mutable_tensor_shape()->add_dim()->set_size(3);
+    proto.mutable_tensor_content()->assign((char*)values.data(), values.size() * sizeof(float));
+
+    InferenceEngine::Blob::Ptr blob;
+    ASSERT_EQ(RemoteNode::deserializeOutput(response, proto, blob), StatusCode::OK);
+    EXPECT_EQ(blob->getTensorDesc().getPrecision(), InferenceEngine::Precision::FP32);
+    EXPECT_THAT(blob->getTensorDesc().getDims(), ::testing::ElementsAre(2, 3));
+    EXPECT_EQ(blob->buffer().as<const char*>(), proto.tensor_content().data());
+
+    tensorflow::TensorProto truncated = proto;
+    truncated.mutable_tensor_content()->resize(5);
+    InferenceEngine::Blob::Ptr invalid;
+    EXPECT_EQ(RemoteNode::deserializeOutput(response, truncated, invalid), StatusCode::INVALID_CONTENT_SIZE);
+
+    std::weak_ptr<PredictResponse> weakResponse = response;
+    response.reset();
+    EXPECT_FALSE(weakResponse.expired());
+    blob.reset();
+    EXPECT_TRUE(weakResponse.expired());
 }
 
 TEST_F(EnsembleFlowTest, SimplePipelineFactoryCreation) {
@@ -1269,6 +2166,171 @@ TEST_F(EnsembleFlowTest, SimplePipelineFactoryCreation) {
     checkResponse(dummySeriallyConnectedCount);
 }
 
+TEST_F(EnsembleFlowTest, PipelineFactoryReusesPooledPipelines) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineFactory factory;
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+    ASSERT_EQ(factory.createDefinition("my_new_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    auto& pool = factory.findDefinitionByName("my_new_pipeline")->getPipelinePool();
+
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "my_new_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    checkResponse(1);
+    const Node* entry = &pipeline->getEntry();
+    pipeline.reset();
+    EXPECT_EQ(pool.size(), 1);
+
+    // Second pipeline reuses nodes of the first one and writes to new response
+    response.Clear();
+    ASSERT_EQ(factory.create(pipeline, "my_new_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    EXPECT_EQ(&pipeline->getEntry(), entry);
+    EXPECT_EQ(pool.size(), 0);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    checkResponse(1);
+
+    // Pipeline created before invalidation is not given back to pool
+    pool.invalidate();
+    pipeline.reset();
+    EXPECT_EQ(pool.size(), 0);
+}
+
+TEST_F(EnsembleFlowTest, PipelineFactoryRunsChainOfDummyModelsAsFusedNetwork) {
+    // input   dummy   dummy   dummy    output
+    //  O------->O------->O------->O------->O
+    //          [      fused network     ]
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineFactory factory;
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node_1", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "dummy_node_2", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "dummy_node_3", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node_1"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections["dummy_node_2"] = {
+        {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}}}};
+    connections["dummy_node_3"] = {
+        {"dummy_node_2", {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node_3", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+    ASSERT_EQ(factory.createDefinition("my_new_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    auto definition = factory.findDefinitionByName("my_new_pipeline");
+    ASSERT_NE(definition, nullptr);
+    definition->setNetworkFusion(managerWithDummyModel, true);
+
+    auto chains = definition->getFusedChains();
+    ASSERT_NE(chains, nullptr);
+    ASSERT_EQ(chains->size(), 1);
+    EXPECT_EQ(chains->front().nodeNames, (std::vector<std::string>{"dummy_node_1", "dummy_node_2", "dummy_node_3"}));
+
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "my_new_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    checkResponse(3);
+    pipeline.reset();
+
+    // Pipelines run node by node once fusion is disabled
+    definition->setNetworkFusion(managerWithDummyModel, false);
+    EXPECT_EQ(definition->getFusedChains(), nullptr);
+    response.Clear();
+    ASSERT_EQ(factory.create(pipeline, "my_new_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    checkResponse(3);
+}
+
+TEST_F(EnsembleFlowTest, PipelineDefinitionDoesNotFuseNodeWithOutputsUsedByOtherNodes) {
+    // input   dummy   dummy    output
+    //  O------->O------->O------->O
+    //           |________________/
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineFactory factory;
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node_1", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "dummy_node_2", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node_1"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections["dummy_node_2"] = {
+        {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, "intermediate"}}},
+        {"dummy_node_2", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+    ASSERT_EQ(factory.createDefinition("my_new_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    auto definition = factory.findDefinitionByName("my_new_pipeline");
+    ASSERT_NE(definition, nullptr);
+    definition->setNetworkFusion(managerWithDummyModel, true);
+    EXPECT_EQ(definition->getFusedChains(), nullptr);
+
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(factory.create(pipeline, "my_new_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    checkResponse(2);
+    EXPECT_EQ(response.outputs().count("intermediate"), 1);
+}
+
+TEST_F(EnsembleFlowTest, PipelineMetricsCollectedForPooledPipelines) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    PipelineFactory factory;
+
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+    ASSERT_EQ(factory.createDefinition("my_new_pipeline", info, connections, managerWithDummyModel), StatusCode::OK);
+    auto metrics = factory.findDefinitionByName("my_new_pipeline")->getMetrics();
+
+    // second pipeline is taken from pool and records into the same counters
+    for (int i = 0; i < 2; i++) {
+        std::unique_ptr<Pipeline> pipeline;
+        response.Clear();
+        ASSERT_EQ(factory.create(pipeline, "my_new_pipeline", &request, &response, managerWithDummyModel), StatusCode::OK);
+        ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+        checkResponse(1);
+    }
+
+    EXPECT_EQ(metrics->requestsSuccess, 2);
+    EXPECT_EQ(metrics->requestsFail, 0);
+    EXPECT_EQ(metrics->total.getCount(), 2);
+    auto& nodeMetrics = metrics->getNode("dummy_node");
+    EXPECT_EQ(nodeMetrics.execution.getCount(), 2);
+    EXPECT_EQ(nodeMetrics.readyToStart.getCount(), 2);
+    EXPECT_EQ(nodeMetrics.failures, 0);
+    EXPECT_EQ(metrics->getNode(EXIT_NODE_NAME).readyToStart.getCount(), 2);
+}
+
 TEST_F(EnsembleFlowTest, ParallelPipelineFactoryUsage) {
     // Prepare manager
     ConstructorEnabledModelManager managerWithDummyModel;
@@ -1940,7 +3002,7 @@ TEST_F(EnsembleFlowTest, ErrorHandlingSkipsDeferredNodesExecutionIfExecutionFail
 
     Pipeline pipeline(*input_node, *output_node);
     pipeline.connect(*input_node, *dummy_node_1, {{"proto_input_1x10", DUMMY_MODEL_INPUT_NAME}});  // this node will start execution, reserve stream id
-    pipeline.connect(*input_node, *dummy_node_2, {{"proto_input_1x10", DUMMY_MODEL_INPUT_NAME}});  // this node will start execution, get future object for stream id, defer to queue
+    pipeline.connect(*input_node, *dummy_node_2, {{"proto_input_1x10_B", DUMMY_MODEL_INPUT_NAME}});  // this node will start execution, get future object for stream id, defer to queue
     pipeline.connect(*input_node, *dummy_node_3, {{"proto_input_1x5", DUMMY_MODEL_INPUT_NAME}});   // this node will fail at validation time
     pipeline.connect(*dummy_node_1, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, "proto_output_1x10_A"}});
     pipeline.connect(*dummy_node_2, *output_node, {{DUMMY_MODEL_OUTPUT_NAME, "proto_output_1x10_B"}});
@@ -1956,6 +3018,7 @@ TEST_F(EnsembleFlowTest, ErrorHandlingSkipsDeferredNodesExecutionIfExecutionFail
 
     auto& proto_input_1x5 = (*request.mutable_inputs())["proto_input_1x5"];
     auto& proto_input_1x10 = (*request.mutable_inputs())["proto_input_1x10"];
+    auto& proto_input_1x10_B = (*request.mutable_inputs())["proto_input_1x10_B"];
 
     proto_input_1x5.set_dtype(tensorflow::DataType::DT_FLOAT);
     proto_input_1x10.set_dtype(tensorflow::DataType::DT_FLOAT);
@@ -1973,6 +3036,11 @@ TEST_F(EnsembleFlowTest, ErrorHandlingSkipsDeferredNodesExecutionIfExecutionFail
     proto_input_1x10.mutable_tensor_shape()->add_dim()->set_size(1);
     proto_input_1x10.mutable_tensor_shape()->add_dim()->set_size(data_1x10.size());
 
+    // different data than of first node, so that second node is not memoized and waits for stream id
+    proto_input_1x10_B = proto_input_1x10;
+    std::iota(data_1x10.begin(), data_1x10.end(), 15);
+    proto_input_1x10_B.mutable_tensor_content()->assign((char*)data_1x10.data(), data_1x10.size() * sizeof(float));
+
     EXPECT_EQ(pipeline.execute(), StatusCode::INVALID_SHAPE);
 }
 
@@ -2007,6 +3075,83 @@ TEST_F(EnsembleFlowTest, ReloadPipelineDefinitionWithNewModelNameShouldPass) {
     EXPECT_TRUE(status.ok()) << status.string();
 }
 
+TEST_F(EnsembleFlowTest, PipelineCreatedBeforeReloadShouldExecuteWithPreviousNodes) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    const std::string pipelineName = "originalName";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+    PipelineDefinition pd(pipelineName, info, connections);
+    auto status = pd.validate(managerWithDummyModel);
+    ASSERT_TRUE(status.ok());
+    std::unique_ptr<Pipeline> pipelineBeforeReload;
+    status = pd.create(pipelineBeforeReload, &request, &response, managerWithDummyModel);
+    ASSERT_TRUE(status.ok());
+
+    std::vector<NodeInfo> infoNew{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "missingDummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connectionsNew = connections;
+    status = pd.reload(managerWithDummyModel, std::move(infoNew), std::move(connectionsNew));
+    EXPECT_EQ(status, ovms::StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_MODEL) << status.string();
+    EXPECT_EQ(pd.getStateCode(), PipelineDefinitionStateCode::LOADING_PRECONDITION_FAILED);
+
+    ASSERT_EQ(pipelineBeforeReload->execute(), StatusCode::OK);
+    uint dummySeriallyConnectedCount = 1;
+    checkResponse(dummySeriallyConnectedCount);
+
+    status = pd.reload(managerWithDummyModel, std::move(info), std::move(connections));
+    ASSERT_TRUE(status.ok()) << status.string();
+    EXPECT_EQ(pd.getStateCode(), PipelineDefinitionStateCode::AVAILABLE);
+}
+
+TEST_F(EnsembleFlowTest, OutputFilterShouldLimitPipelineOutputs) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    const std::string secondOutputName = "second_output";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "second_dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections["second_dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}},
+        {"second_dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, secondOutputName}}}};
+    PipelineDefinition pd("filteredPipeline", info, connections);
+    ASSERT_EQ(pd.validate(managerWithDummyModel), StatusCode::OK);
+
+    request.add_output_filter(customPipelineOutputName);
+    std::unique_ptr<Pipeline> pipeline;
+    ASSERT_EQ(pd.create(pipeline, &request, &response, managerWithDummyModel), StatusCode::OK);
+    ASSERT_EQ(pipeline->execute(), StatusCode::OK);
+    EXPECT_EQ(response.outputs().size(), 1);
+    EXPECT_EQ(response.outputs().count(secondOutputName), 0);
+    checkResponse(1);
+
+    response.Clear();
+    request.add_output_filter("missing_output");
+    ASSERT_EQ(pd.create(pipeline, &request, &response, managerWithDummyModel), StatusCode::OK);
+    EXPECT_EQ(pipeline->execute(), StatusCode::INVALID_MISSING_OUTPUT);
+}
+
 TEST_F(EnsembleFlowTest, ReloadPipelineDefinitionWithNewNonExistingModelNameShouldFail) {
     ConstructorEnabledModelManager managerWithDummyModel;
     managerWithDummyModel.reloadModelWithVersions(config);
@@ -2089,6 +3234,46 @@ TEST_F(EnsembleFlowTest, RevalidatePipelineDefinitionWhen1ModelVersionBecomesAva
     EXPECT_TRUE(status.ok()) << status.string();
 }
 
+TEST_F(EnsembleFlowTest, RevalidatePipelineDefinitionShouldCheckOnlyNodesUsingChangedModels) {
+    ConstructorEnabledModelManager managerWithDummyModel;
+    managerWithDummyModel.reloadModelWithVersions(config);
+
+    const std::string pipelineName = "originalName";
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{customPipelineInputName, customPipelineInputName}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {
+        {ENTRY_NODE_NAME, {{customPipelineInputName, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, customPipelineOutputName}}}};
+    PipelineDefinition pd(pipelineName, info, connections);
+    auto status = pd.validate(managerWithDummyModel);
+    ASSERT_TRUE(status.ok()) << status.string();
+    managerWithDummyModel.findModelByName("dummy")->retireAllVersions();
+
+    // change of model not used by any node does not trigger validation of dummy node
+    pd.notifyUsedModelChanged("model: other", "other");
+    ASSERT_EQ(pd.getStateCode(), PipelineDefinitionStateCode::AVAILABLE_REQUIRED_REVALIDATION);
+    status = pd.revalidate(managerWithDummyModel);
+    EXPECT_TRUE(status.ok()) << status.string();
+    EXPECT_EQ(pd.getStateCode(), PipelineDefinitionStateCode::AVAILABLE);
+
+    pd.notifyUsedModelChanged("model: dummy", "dummy");
+    status = pd.revalidate(managerWithDummyModel);
+    EXPECT_EQ(status, ovms::StatusCode::PIPELINE_NODE_REFERING_TO_MISSING_MODEL) << status.string();
+    EXPECT_EQ(pd.getStateCode(), PipelineDefinitionStateCode::LOADING_PRECONDITION_FAILED);
+
+    // definition not available before is validated whole
+    status = managerWithDummyModel.reloadModelWithVersions(config);
+    ASSERT_TRUE(status.ok()) << status.string();
+    status = pd.revalidate(managerWithDummyModel);
+    EXPECT_TRUE(status.ok()) << status.string();
+    EXPECT_EQ(pd.getStateCode(), PipelineDefinitionStateCode::AVAILABLE);
+}
+
 TEST_F(EnsembleFlowTest, DISABLED_RetirePipelineDefinitionExecuteShouldFail) {
     ConstructorEnabledModelManager managerWithDummyModel;
     managerWithDummyModel.reloadModelWithVersions(config);
@@ -2515,3 +3700,53 @@ TEST_F(EnsembleFlowTest, RetireReloadAddPipelineAtTheSameTime) {
     ASSERT_TRUE(status.ok()) << status.string();
     EXPECT_EQ(inputsInfoAfter.count(NEW_INPUT_NAME), 1);
 }
+
+class PipelineDefinitionWithOutputsAliasing : public PipelineDefinition {
+public:
+    PipelineDefinitionWithOutputsAliasing(const std::vector<NodeInfo>& nodeInfos, const pipeline_connections_t& connections) :
+        PipelineDefinition("pipeline", nodeInfos, connections) {}
+    using PipelineDefinition::isPassingOutputsToExitOnly;
+};
+
+TEST(EnsembleOutputsAliasing, NodeConnectedOnlyToExitPassesOutputsWithoutCopy) {
+    // input   dummy    output
+    //  O------->O------->O
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"input", "input"}}},
+        {NodeKind::DL, "dummy_node", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node"] = {{ENTRY_NODE_NAME, {{"input", DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {{"dummy_node", {{DUMMY_MODEL_OUTPUT_NAME, "output"}}}};
+    PipelineDefinitionWithOutputsAliasing definition(info, connections);
+    EXPECT_TRUE(definition.isPassingOutputsToExitOnly(info[1]));
+}
+
+TEST(EnsembleOutputsAliasing, NodesSharingModelCopyOutputs) {
+    // Last node keeps copying, holding its stream could block the other node of the same model
+    // input   dummy   dummy    output
+    //  O------->O------->O------->O
+    //           |----------------^
+    std::vector<NodeInfo> info{
+        {NodeKind::ENTRY, ENTRY_NODE_NAME, "", std::nullopt, {{"input", "input"}}},
+        {NodeKind::DL, "dummy_node_1", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::DL, "dummy_node_2", "dummy", std::nullopt, {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_OUTPUT_NAME}}},
+        {NodeKind::EXIT, EXIT_NODE_NAME},
+    };
+    pipeline_connections_t connections;
+    connections["dummy_node_1"] = {{ENTRY_NODE_NAME, {{"input", DUMMY_MODEL_INPUT_NAME}}}};
+    connections["dummy_node_2"] = {{"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, DUMMY_MODEL_INPUT_NAME}}}};
+    connections[EXIT_NODE_NAME] = {
+        {"dummy_node_1", {{DUMMY_MODEL_OUTPUT_NAME, "output_1"}}},
+        {"dummy_node_2", {{DUMMY_MODEL_OUTPUT_NAME, "output_2"}}}};
+    PipelineDefinitionWithOutputsAliasing definition(info, connections);
+    EXPECT_FALSE(definition.isPassingOutputsToExitOnly(info[1]));
+    EXPECT_FALSE(definition.isPassingOutputsToExitOnly(info[2]));
+
+    // with different models only the last node passes outputs without copy
+    info[2].modelName = "other";
+    PipelineDefinitionWithOutputsAliasing definitionWithOtherModel(info, connections);
+    EXPECT_FALSE(definitionWithOtherModel.isPassingOutputsToExitOnly(info[1]));
+    EXPECT_TRUE(definitionWithOtherModel.isPassingOutputsToExitOnly(info[2]));
+}
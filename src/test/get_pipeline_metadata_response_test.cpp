@@ -276,3 +276,14 @@ TEST_F(GetPipelineMetadataResponseBuild, serialize2Json) {
     EXPECT_TRUE(received_doc.HasMember("modelSpec"));
     EXPECT_TRUE(received_doc.HasMember("metadata"));
 }
+
+TEST_F(GetPipelineMetadataResponse, MetadataCacheIsDroppedWhenUsedModelChanged) {
+    EXPECT_EQ(pipelineDefinition.getMetadataCache(), nullptr);
+    auto entry = std::make_shared<ovms::ModelMetadataCacheEntry>();
+    ASSERT_EQ(ovms::GetModelMetadataImpl::buildResponse(pipelineDefinition, &entry->response, manager), ovms::StatusCode::OK);
+    pipelineDefinition.setMetadataCache(entry, pipelineDefinition.getPipelinePool().getGeneration());
+    EXPECT_EQ(pipelineDefinition.getMetadataCache(), entry);
+
+    pipelineDefinition.notifyUsedModelChanged("model: dummy", "dummy");
+    EXPECT_EQ(pipelineDefinition.getMetadataCache(), nullptr);
+}
@@ -0,0 +1,136 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <png.h>
+#include <zlib.h>
+
+#include "../imagedecoder.hpp"
+
+namespace {
+constexpr size_t IMAGE_HEIGHT = 2;
+constexpr size_t IMAGE_WIDTH = 3;
+
+// 2x3 RGB image with pixel value encoding its position
+std::vector<uint8_t> preparePixels(uint8_t seed) {
+    std::vector<uint8_t> pixels(IMAGE_HEIGHT * IMAGE_WIDTH * 3);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = seed + i;
+    }
+    return pixels;
+}
+
+std::string encodePng(const std::vector<uint8_t>& pixels) {
+    png_image image;
+    std::memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    image.width = IMAGE_WIDTH;
+    image.height = IMAGE_HEIGHT;
+    image.format = PNG_FORMAT_RGB;
+    png_alloc_size_t size = 0;
+    EXPECT_TRUE(png_image_write_to_memory(&image, nullptr, &size, 0, pixels.data(), 0, nullptr));
+    std::string encoded(size, '\0');
+    EXPECT_TRUE(png_image_write_to_memory(&image, &encoded[0], &size, 0, pixels.data(), 0, nullptr));
+    encoded.resize(size);
+    return encoded;
+}
+
+// Writes size to IHDR chunk of PNG image, which follows 8 bytes of signature, without encoding its pixels
+std::string setPngHeaderSize(std::string encoded, uint32_t width, uint32_t height) {
+    auto writeBigEndian = [&encoded](size_t offset, uint32_t value) {
+        for (size_t i = 0; i < 4; i++) {
+            encoded[offset + i] = static_cast<char>(value >> (24 - 8 * i));
+        }
+    };
+    writeBigEndian(16, width);
+    writeBigEndian(20, height);
+    // checksum covers chunk type and 13 bytes of header data
+    writeBigEndian(29, crc32(0, reinterpret_cast<const Bytef*>(encoded.data() + 12), 17));
+    return encoded;
+}
+}  // namespace
+
+TEST(ImageDecoder, DecodePng) {
+    auto pixels = preparePixels(10);
+    ovms::DecodedImage image;
+    ASSERT_EQ(ovms::decodeImage(encodePng(pixels), 3, image), ovms::StatusCode::OK);
+    EXPECT_EQ(image.height, IMAGE_HEIGHT);
+    EXPECT_EQ(image.width, IMAGE_WIDTH);
+    EXPECT_EQ(image.channels, 3);
+    EXPECT_EQ(image.pixels, pixels);
+}
+
+TEST(ImageDecoder, InvalidImageRejected) {
+    ovms::DecodedImage image;
+    EXPECT_EQ(ovms::decodeImage("not an image", 0, image), ovms::StatusCode::IMAGE_PARSING_FAILED);
+    auto truncated = encodePng(preparePixels(0)).substr(0, 40);
+    EXPECT_EQ(ovms::decodeImage(truncated, 0, image), ovms::StatusCode::IMAGE_PARSING_FAILED);
+}
+
+TEST(ImageDecoder, HugeImageRejectedFromHeader) {
+    ovms::DecodedImage image;
+    auto huge = setPngHeaderSize(encodePng(preparePixels(0)), 100000, 100000);
+    EXPECT_EQ(ovms::decodeImage(huge, 3, image), ovms::StatusCode::INVALID_SHAPE);
+    EXPECT_TRUE(image.pixels.empty());
+}
+
+TEST(ImageDecoder, ImageOfUnexpectedSizeRejectedFromHeader) {
+    ovms::DecodedImage image;
+    auto encoded = setPngHeaderSize(encodePng(preparePixels(0)), 300, 200);
+    EXPECT_EQ(ovms::decodeImage(encoded, 3, image, IMAGE_HEIGHT, IMAGE_WIDTH), ovms::StatusCode::INVALID_SHAPE);
+    EXPECT_TRUE(image.pixels.empty());
+    EXPECT_EQ(ovms::decodeImage(encodePng(preparePixels(0)), 3, image, IMAGE_HEIGHT, IMAGE_WIDTH), ovms::StatusCode::OK);
+}
+
+TEST(ImageDecoder, DecodeBatchToNCHWFloat) {
+    tensorflow::TensorProto proto;
+    auto first = preparePixels(0);
+    auto second = preparePixels(100);
+    proto.add_string_val(encodePng(first));
+    proto.add_string_val(encodePng(second));
+    InferenceEngine::TensorDesc desc(InferenceEngine::Precision::FP32, {2, 3, IMAGE_HEIGHT, IMAGE_WIDTH}, InferenceEngine::Layout::NCHW);
+    std::vector<float> output(2 * 3 * IMAGE_HEIGHT * IMAGE_WIDTH);
+    ASSERT_EQ(ovms::decodeImages(proto, desc, output.data()), ovms::StatusCode::OK);
+    const size_t planeSize = IMAGE_HEIGHT * IMAGE_WIDTH;
+    for (size_t c = 0; c < 3; c++) {
+        for (size_t i = 0; i < planeSize; i++) {
+            EXPECT_EQ(output[c * planeSize + i], first[i * 3 + c]);
+            EXPECT_EQ(output[(3 + c) * planeSize + i], second[i * 3 + c]);
+        }
+    }
+}
+
+TEST(ImageDecoder, DecodeBatchWrongImageSize) {
+    tensorflow::TensorProto proto;
+    proto.add_string_val(encodePng(preparePixels(0)));
+    InferenceEngine::TensorDesc desc(InferenceEngine::Precision::U8, {1, IMAGE_HEIGHT, IMAGE_WIDTH + 1, 3}, InferenceEngine::Layout::NHWC);
+    std::vector<uint8_t> output(IMAGE_HEIGHT * (IMAGE_WIDTH + 1) * 3);
+    EXPECT_EQ(ovms::decodeImages(proto, desc, output.data()), ovms::StatusCode::INVALID_SHAPE);
+}
+
+TEST(ImageDecoder, DecodeBatchToNativeSizeBlob) {
+    tensorflow::TensorProto proto;
+    auto pixels = preparePixels(5);
+    proto.add_string_val(encodePng(pixels));
+    InferenceEngine::Blob::Ptr blob;
+    ASSERT_EQ(ovms::decodeImages(proto, blob), ovms::StatusCode::OK);
+    ASSERT_NE(blob, nullptr);
+    EXPECT_EQ(blob->getTensorDesc().getDims(), (InferenceEngine::SizeVector{1, IMAGE_HEIGHT, IMAGE_WIDTH, 3}));
+    EXPECT_EQ(std::memcmp(blob->cbuffer().as<const uint8_t*>(), pixels.data(), pixels.size()), 0);
+}
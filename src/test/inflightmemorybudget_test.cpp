@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "../inflightmemorybudget.hpp"
+
+using ovms::InFlightMemoryBudget;
+
+TEST(InFlightMemoryBudget, ReservationsAreNotCountedWhenUnlimited) {
+    InFlightMemoryBudget budget;
+    auto reservation = budget.tryReserve("model", 1000);
+    ASSERT_TRUE(reservation.has_value());
+    EXPECT_EQ(budget.getReservedBytes(), 0);
+}
+
+TEST(InFlightMemoryBudget, RejectsReservationAboveGlobalBudget) {
+    InFlightMemoryBudget budget;
+    budget.configure(100);
+    auto first = budget.tryReserve("model_a", 60);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(budget.tryReserve("model_b", 50).has_value());
+    auto second = budget.tryReserve("model_b", 40);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(budget.getReservedBytes(), 100);
+    EXPECT_EQ(budget.getReservedBytes("model_a"), 60);
+    EXPECT_EQ(budget.getReservedBytes("model_b"), 40);
+}
+
+TEST(InFlightMemoryBudget, RejectsReservationAboveBudgetOfName) {
+    InFlightMemoryBudget budget;
+    auto first = budget.tryReserve("model_a", 60, 100);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(budget.tryReserve("model_a", 50, 100).has_value());
+    EXPECT_TRUE(budget.tryReserve("model_b", 50, 100).has_value());
+    EXPECT_EQ(budget.getReservedBytes("model_a"), 60);
+}
+
+TEST(InFlightMemoryBudget, ReleasesBytesOnceReservationIsDestroyed) {
+    InFlightMemoryBudget budget;
+    budget.configure(100);
+    {
+        auto reservation = budget.tryReserve("model", 100);
+        ASSERT_TRUE(reservation.has_value());
+        auto moved = std::move(reservation.value());
+        reservation.reset();
+        EXPECT_EQ(budget.getReservedBytes(), 100);
+        EXPECT_EQ(moved.getBytes(), 100);
+    }
+    EXPECT_EQ(budget.getReservedBytes(), 0);
+    EXPECT_EQ(budget.getReservedBytes("model"), 0);
+    EXPECT_TRUE(budget.tryReserve("model", 100).has_value());
+}
+
+TEST(InFlightMemoryBudget, RejectsSaturatedEstimateWithoutWrapping) {
+    InFlightMemoryBudget budget;
+    budget.configure(100);
+    auto first = budget.tryReserve("model", 10, 100);
+    ASSERT_TRUE(first.has_value());
+    // estimate of request with huge output shapes saturates at maximum size, adding it to reserved bytes would wrap
+    EXPECT_FALSE(budget.tryReserve("model", std::numeric_limits<size_t>::max(), 100).has_value());
+    EXPECT_FALSE(budget.tryReserve("other", std::numeric_limits<size_t>::max() - 5).has_value());
+    EXPECT_EQ(budget.getReservedBytes(), 10);
+    EXPECT_EQ(budget.getReservedBytes("model"), 10);
+}
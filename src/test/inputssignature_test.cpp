@@ -0,0 +1,122 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../inputssignature.hpp"
+
+using tensorflow::serving::PredictRequest;
+
+namespace {
+ovms::tensor_map_t inputsWithBatch(size_t batchSize, InferenceEngine::Precision precision = InferenceEngine::Precision::FP32) {
+    ovms::tensor_map_t inputs;
+    inputs["a"] = std::make_shared<ovms::TensorInfo>("a", precision, ovms::shape_t{batchSize, 10});
+    inputs["b"] = std::make_shared<ovms::TensorInfo>("b", precision, ovms::shape_t{batchSize, 2, 3});
+    return inputs;
+}
+
+void addInput(PredictRequest& request, const std::string& name, tensorflow::DataType dtype, const std::vector<int64_t>& shape, size_t contentSize) {
+    auto& proto = (*request.mutable_inputs())[name];
+    proto.set_dtype(dtype);
+    for (auto dim : shape) {
+        proto.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    proto.mutable_tensor_content()->resize(contentSize);
+}
+
+PredictRequest requestWithBatch(int64_t batchSize) {
+    PredictRequest request;
+    addInput(request, "a", tensorflow::DataType::DT_FLOAT, {batchSize, 10}, batchSize * 10 * sizeof(float));
+    addInput(request, "b", tensorflow::DataType::DT_FLOAT, {batchSize, 2, 3}, batchSize * 6 * sizeof(float));
+    return request;
+}
+}  // namespace
+
+TEST(InputsSignature, MatchesRequestWithExpectedInputs) {
+    ovms::InputsSignature signature(inputsWithBatch(2), 2, false);
+    EXPECT_TRUE(signature.matches(requestWithBatch(2)));
+}
+
+TEST(InputsSignature, EmptySignatureDoesNotMatch) {
+    ovms::InputsSignature signature;
+    EXPECT_FALSE(signature.matches(requestWithBatch(2)));
+}
+
+TEST(InputsSignature, DoesNotMatchDifferentInputs) {
+    ovms::InputsSignature signature(inputsWithBatch(2), 2, false);
+    auto request = requestWithBatch(2);
+    request.mutable_inputs()->erase("b");
+    EXPECT_FALSE(signature.matches(request));
+    addInput(request, "c", tensorflow::DataType::DT_FLOAT, {2, 2, 3}, 2 * 6 * sizeof(float));
+    EXPECT_FALSE(signature.matches(request));
+}
+
+TEST(InputsSignature, DoesNotMatchDifferentPrecision) {
+    ovms::InputsSignature signature(inputsWithBatch(2), 2, false);
+    auto request = requestWithBatch(2);
+    (*request.mutable_inputs())["a"].set_dtype(tensorflow::DataType::DT_INT32);
+    EXPECT_FALSE(signature.matches(request));
+}
+
+TEST(InputsSignature, DoesNotMatchDifferentShape) {
+    ovms::InputsSignature signature(inputsWithBatch(2), 2, false);
+    auto request = requestWithBatch(2);
+    (*request.mutable_inputs())["b"].mutable_tensor_shape()->mutable_dim(2)->set_size(2);
+    EXPECT_FALSE(signature.matches(request));
+    (*request.mutable_inputs())["b"].mutable_tensor_shape()->add_dim()->set_size(3);
+    EXPECT_FALSE(signature.matches(request));
+}
+
+TEST(InputsSignature, DoesNotMatchDifferentContentSize) {
+    ovms::InputsSignature signature(inputsWithBatch(2), 2, false);
+    auto request = requestWithBatch(2);
+    (*request.mutable_inputs())["a"].mutable_tensor_content()->resize(2 * 10 * sizeof(float) - 1);
+    EXPECT_FALSE(signature.matches(request));
+}
+
+TEST(InputsSignature, MatchesOnlyNetworkBatchSize) {
+    ovms::InputsSignature signature(inputsWithBatch(4), 4, false);
+    EXPECT_FALSE(signature.matches(requestWithBatch(2)));
+    EXPECT_TRUE(signature.matches(requestWithBatch(4)));
+    EXPECT_FALSE(signature.matches(requestWithBatch(5)));
+}
+
+TEST(InputsSignature, MatchesBatchSizesUpToMaxWithVariableBatchSize) {
+    ovms::InputsSignature signature(inputsWithBatch(4), 4, true);
+    EXPECT_FALSE(signature.matches(requestWithBatch(0)));
+    EXPECT_TRUE(signature.matches(requestWithBatch(1)));
+    EXPECT_TRUE(signature.matches(requestWithBatch(4)));
+    EXPECT_FALSE(signature.matches(requestWithBatch(5)));
+}
+
+TEST(InputsSignature, MatchesValueCountOfHalfInputs) {
+    ovms::InputsSignature signature(inputsWithBatch(1, InferenceEngine::Precision::FP16), 1, false);
+    PredictRequest request;
+    addInput(request, "a", tensorflow::DataType::DT_HALF, {1, 10}, 0);
+    addInput(request, "b", tensorflow::DataType::DT_HALF, {1, 2, 3}, 0);
+    for (int i = 0; i < 10; i++) {
+        (*request.mutable_inputs())["a"].add_half_val(0);
+    }
+    for (int i = 0; i < 5; i++) {
+        (*request.mutable_inputs())["b"].add_half_val(0);
+    }
+    EXPECT_FALSE(signature.matches(request));
+    (*request.mutable_inputs())["b"].add_half_val(0);
+    EXPECT_TRUE(signature.matches(request));
+}
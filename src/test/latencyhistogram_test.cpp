@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../load_generator/latencyhistogram.hpp"
+
+using ovms::LatencyHistogram;
+
+TEST(LatencyHistogram, EmptyHistogramReportsZeros) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.getCount(), 0);
+    EXPECT_EQ(histogram.getMin(), 0);
+    EXPECT_EQ(histogram.getMax(), 0);
+    EXPECT_EQ(histogram.getMean(), 0);
+    EXPECT_EQ(histogram.getValueAtPercentile(99), 0);
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100; value++) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.getCount(), 100);
+    EXPECT_EQ(histogram.getMin(), 1);
+    EXPECT_EQ(histogram.getMax(), 100);
+    EXPECT_DOUBLE_EQ(histogram.getMean(), 50.5);
+    EXPECT_EQ(histogram.getValueAtPercentile(50), 50);
+    EXPECT_EQ(histogram.getValueAtPercentile(99), 99);
+    EXPECT_EQ(histogram.getValueAtPercentile(100), 100);
+}
+
+TEST(LatencyHistogram, LargeValuesHaveBoundedRelativeError) {
+    for (uint64_t value : {1000ull, 123456ull, 98765432ull, 1ull << 40}) {
+        LatencyHistogram single;
+        single.record(value);
+        const double reported = single.getValueAtPercentile(50);
+        EXPECT_NEAR(reported, value, value / 128.0) << value;
+    }
+}
+
+TEST(LatencyHistogram, PercentilesOfSkewedDistribution) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 990; i++) {
+        histogram.record(1000);
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.record(100000);
+    }
+    EXPECT_NEAR(histogram.getValueAtPercentile(50), 1000, 1000 / 128.0);
+    EXPECT_NEAR(histogram.getValueAtPercentile(99), 1000, 1000 / 128.0);
+    EXPECT_NEAR(histogram.getValueAtPercentile(99.9), 100000, 100000 / 128.0);
+    EXPECT_EQ(histogram.getMax(), 100000);
+}
+
+TEST(LatencyHistogram, MergeAddsCountsOfBothHistograms) {
+    LatencyHistogram first, second;
+    first.record(10);
+    first.record(20);
+    second.record(5);
+    second.record(500);
+    first.merge(second);
+    EXPECT_EQ(first.getCount(), 4);
+    EXPECT_EQ(first.getMin(), 5);
+    EXPECT_EQ(first.getMax(), 500);
+    EXPECT_DOUBLE_EQ(first.getMean(), 133.75);
+    EXPECT_EQ(first.getValueAtPercentile(50), 10);
+}
+
+TEST(LatencyHistogram, PrintsPercentileDistribution) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1000; value <= 2000; value++) {
+        histogram.record(value);
+    }
+    std::stringstream out;
+    histogram.printPercentileDistribution(out, 1000);
+    const std::string text = out.str();
+    EXPECT_EQ(text.find("       Value     Percentile TotalCount 1/(1-Percentile)"), 0) << text;
+    EXPECT_NE(text.find("#[Mean    = 1.500, Max     = 2.000]"), std::string::npos) << text;
+    EXPECT_NE(text.find("#[Total count    = 1001]"), std::string::npos) << text;
+}
@@ -0,0 +1,64 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <gtest/gtest.h>
+
+#include "../loadingprofile.hpp"
+#include "../modelinstance.hpp"
+#include "test_utils.hpp"
+
+using ovms::LoadingPhase;
+using ovms::LoadingPhaseTimer;
+using ovms::LoadingProfile;
+
+TEST(LoadingProfile, FormatsRecordedPhasesInLoadingOrder) {
+    LoadingProfile profile;
+    EXPECT_EQ(profile.toString(), "");
+    profile.record(LoadingPhase::LOAD_NETWORK, 2300000);
+    profile.record(LoadingPhase::READ_NETWORK, 120500);
+    EXPECT_TRUE(profile.isRecorded(LoadingPhase::READ_NETWORK));
+    EXPECT_FALSE(profile.isRecorded(LoadingPhase::RESHAPE));
+    EXPECT_EQ(profile.getMicroseconds(LoadingPhase::READ_NETWORK), 120500u);
+    EXPECT_EQ(profile.toString(), "read_network: 120 ms, load_network: 2300 ms");
+}
+
+TEST(LoadingProfile, ReportedOnceAfterEachRecord) {
+    LoadingProfile profile;
+    EXPECT_FALSE(profile.markReported());
+    profile.record(LoadingPhase::VALIDATION, 10);
+    EXPECT_TRUE(profile.markReported());
+    EXPECT_FALSE(profile.markReported());
+    profile.record(LoadingPhase::VALIDATION, 20);
+    EXPECT_TRUE(profile.markReported());
+}
+
+TEST(LoadingProfile, TimerRecordsOnScopeExit) {
+    LoadingProfile profile;
+    {
+        LoadingPhaseTimer timer(profile, LoadingPhase::DOWNLOAD);
+        EXPECT_FALSE(profile.isRecorded(LoadingPhase::DOWNLOAD));
+    }
+    EXPECT_TRUE(profile.isRecorded(LoadingPhase::DOWNLOAD));
+}
+
+TEST(LoadingProfile, ModelVersionLoadRecordsPhases) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    auto& profile = modelInstance.getLoadingProfile();
+    for (auto phase : {LoadingPhase::READ_NETWORK, LoadingPhase::RESHAPE, LoadingPhase::LOAD_NETWORK, LoadingPhase::CREATE_INFER_REQUESTS, LoadingPhase::WARM_UP}) {
+        EXPECT_TRUE(profile.isRecorded(phase)) << LoadingProfile::getPhaseName(phase);
+    }
+    EXPECT_FALSE(profile.isRecorded(LoadingPhase::VALIDATION));
+}
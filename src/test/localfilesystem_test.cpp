@@ -144,6 +144,27 @@ TEST(LocalFileSystem, DestroyFileFolder) {
     EXPECT_EQ(status, ovms::StatusCode::PATH_INVALID);
 }
 
+TEST(LocalFileSystem, GetDirectoryChangeToken) {
+    ovms::LocalFileSystem lfs;
+    createTmpFiles();
+    std::string token, sameToken, changedToken;
+    auto status = lfs.getDirectoryChangeToken(TMP_PATH, &token);
+    EXPECT_EQ(status, ovms::StatusCode::OK);
+    EXPECT_FALSE(token.empty());
+    status = lfs.getDirectoryChangeToken(TMP_PATH, &sameToken);
+    EXPECT_EQ(status, ovms::StatusCode::OK);
+    EXPECT_EQ(token, sameToken);
+
+    std::filesystem::create_directories(TMP_PATH + "dir3");
+    status = lfs.getDirectoryChangeToken(TMP_PATH, &changedToken);
+    EXPECT_EQ(status, ovms::StatusCode::OK);
+    EXPECT_NE(token, changedToken);
+    std::filesystem::remove_all(TMP_PATH + "dir3");
+
+    status = lfs.getDirectoryChangeToken("/tmp/structure/not_existing", &token);
+    EXPECT_EQ(status, ovms::StatusCode::PATH_INVALID);
+}
+
 TEST(FileSystem, CreateTempFolder) {
     std::string local_path;
     namespace fs = std::filesystem;
@@ -0,0 +1,77 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../lockmetrics.hpp"
+
+using ovms::InstrumentedMutex;
+using ovms::LockMetricsRegistry;
+
+TEST(LockMetricsRegistry, LocksWithSameNameShareMetrics) {
+    auto& first = LockMetricsRegistry::getInstance().get("registry_test_shared");
+    auto& second = LockMetricsRegistry::getInstance().get("registry_test_shared");
+    auto& other = LockMetricsRegistry::getInstance().get("registry_test_other");
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+    auto all = LockMetricsRegistry::getInstance().getAll();
+    ASSERT_EQ(all.count("registry_test_shared"), 1);
+    EXPECT_EQ(all.at("registry_test_shared"), &first);
+}
+
+TEST(InstrumentedMutex, LocksLikeUnderlyingMutex) {
+    InstrumentedMutex<std::shared_mutex> mtx("instrumented_test_plain");
+    {
+        std::unique_lock lock(mtx);
+        std::thread([&mtx]() { EXPECT_FALSE(mtx.try_lock_shared()); }).join();
+    }
+    {
+        std::shared_lock lock(mtx);
+        std::thread([&mtx]() { EXPECT_FALSE(mtx.try_lock()); }).join();
+    }
+    EXPECT_TRUE(mtx.try_lock());
+    mtx.unlock();
+}
+
+#ifdef OVMS_LOCK_METRICS
+TEST(InstrumentedMutex, RecordsWaitAndHold) {
+    InstrumentedMutex<std::shared_mutex> mtx("instrumented_test_records");
+    const auto& metrics = LockMetricsRegistry::getInstance().get("instrumented_test_records");
+    {
+        std::unique_lock lock(mtx);
+    }
+    {
+        std::shared_lock lock(mtx);
+    }
+    EXPECT_EQ(metrics.wait.getCount(), 2);
+    EXPECT_EQ(metrics.hold.getCount(), 1);
+}
+
+TEST(InstrumentedMutex, RecursiveLockRecordsOuterHold) {
+    InstrumentedMutex<std::recursive_mutex> mtx("instrumented_test_recursive");
+    const auto& metrics = LockMetricsRegistry::getInstance().get("instrumented_test_recursive");
+    {
+        std::lock_guard outer(mtx);
+        std::lock_guard inner(mtx);
+        EXPECT_EQ(metrics.hold.getCount(), 0);
+    }
+    EXPECT_EQ(metrics.wait.getCount(), 2);
+    EXPECT_EQ(metrics.hold.getCount(), 1);
+}
+#endif
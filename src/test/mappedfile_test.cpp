@@ -0,0 +1,57 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../mappedfile.hpp"
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::ofstream file(filePath, std::ios::binary);
+        file << content;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(filePath);
+    }
+
+    const std::string filePath = "/tmp/ovms_mapped_file_test.bin";
+    const std::string content = "weights content";
+};
+
+TEST_F(MappedFileTest, ContentMatchesFile) {
+    auto mappedFile = ovms::MappedFile::open(filePath);
+    ASSERT_NE(mappedFile, nullptr);
+    ASSERT_EQ(mappedFile->getSize(), content.size());
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(mappedFile->getData()), mappedFile->getSize()), content);
+}
+
+TEST_F(MappedFileTest, MappingSharedWhileInUse) {
+    auto first = ovms::MappedFile::open(filePath);
+    auto second = ovms::MappedFile::open(filePath);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(MappedFileTest, NonExistingOrEmptyFileNotMapped) {
+    EXPECT_EQ(ovms::MappedFile::open("/tmp/ovms_mapped_file_test_missing.bin"), nullptr);
+    std::ofstream(filePath, std::ios::binary | std::ios::trunc).close();
+    EXPECT_EQ(ovms::MappedFile::open(filePath), nullptr);
+}
@@ -0,0 +1,178 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../http_rest_api_handler.hpp"
+#include "../lockmetrics.hpp"
+#include "../metrics.hpp"
+#include "../model_service.hpp"
+#include "../modelinstance.hpp"
+#include "../prediction_service_utils.hpp"
+#include "test_utils.hpp"
+
+using testing::HasSubstr;
+using testing::Not;
+
+TEST(LatencyHistogram, ObservationsFallIntoBuckets) {
+    ovms::LatencyHistogram histogram;
+    histogram.observe(10);
+    histogram.observe(ovms::LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[0]);
+    histogram.observe(ovms::LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[0] + 1);
+    histogram.observe(ovms::LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS.back() * 10);
+
+    EXPECT_EQ(histogram.getBucketCount(0), 2);
+    EXPECT_EQ(histogram.getBucketCount(1), 1);
+    EXPECT_EQ(histogram.getBucketCount(ovms::LatencyHistogram::BUCKETS_COUNT), 1);
+    EXPECT_EQ(histogram.getCount(), 4);
+    EXPECT_EQ(histogram.getSumMicroseconds(),
+        10 + 2 * ovms::LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[0] + 1 + ovms::LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS.back() * 10);
+}
+
+class MetricsTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        config = DUMMY_MODEL_CONFIG;
+        ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+    }
+
+    ovms::Status performInference(const tensorflow::serving::PredictRequest& request) {
+        std::shared_ptr<ovms::ModelInstance> modelInstance;
+        std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+        auto status = ovms::getModelInstance(manager, config.getName(), 0, modelInstance, unloadGuard);
+        if (!status.ok()) {
+            return status;
+        }
+        tensorflow::serving::PredictResponse response;
+        return ovms::inference(*modelInstance, &request, &response, unloadGuard);
+    }
+
+    ConstructorEnabledModelManager manager;
+    ovms::ModelConfig config;
+};
+
+TEST_F(MetricsTest, PredictRequestsAreCounted) {
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}});
+    ASSERT_EQ(performInference(request), ovms::StatusCode::OK);
+    ASSERT_EQ(performInference(request), ovms::StatusCode::OK);
+    auto wrongRequest = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE + 1}, tensorflow::DataType::DT_FLOAT}}});
+    ASSERT_EQ(performInference(wrongRequest), ovms::StatusCode::INVALID_SHAPE);
+
+    auto modelInstance = manager.findModelInstance(config.getName());
+    ASSERT_NE(modelInstance, nullptr);
+    const auto& metrics = modelInstance->getMetrics();
+    EXPECT_EQ(metrics.requestsSuccess.load(), 2);
+    EXPECT_EQ(metrics.requestsFail.load(), 1);
+    EXPECT_EQ(metrics.streamWait.getCount(), 2);
+    EXPECT_EQ(metrics.deserialization.getCount(), 2);
+    EXPECT_EQ(metrics.inference.getCount(), 2);
+    EXPECT_EQ(metrics.serialization.getCount(), 2);
+    EXPECT_EQ(metrics.total.getCount(), 2);
+}
+
+TEST_F(MetricsTest, SerializesPrometheusText) {
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}});
+    ASSERT_EQ(performInference(request), ovms::StatusCode::OK);
+
+    auto text = ovms::serializeMetricsToPrometheusText(manager);
+    EXPECT_THAT(text, HasSubstr("# TYPE ovms_request_inference_seconds histogram\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_requests_success_total{name=\"dummy\",version=\"1\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_requests_fail_total{name=\"dummy\",version=\"1\"} 0\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_request_total_seconds_bucket{name=\"dummy\",version=\"1\",le=\"+Inf\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_request_total_seconds_count{name=\"dummy\",version=\"1\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_infer_requests_nireq{name=\"dummy\",version=\"1\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_infer_requests_idle{name=\"dummy\",version=\"1\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_infer_requests_waiting{name=\"dummy\",version=\"1\"} 0\n"));
+}
+
+TEST_F(MetricsTest, SerializesLockMetrics) {
+    ovms::LockMetricsRegistry::getInstance().get("metrics_test_lock").wait.observe(10);
+
+    auto text = ovms::serializeMetricsToPrometheusText(manager);
+    EXPECT_THAT(text, HasSubstr("# TYPE ovms_lock_wait_seconds histogram\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_lock_wait_seconds_count{lock=\"metrics_test_lock\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("ovms_lock_hold_seconds_count{lock=\"metrics_test_lock\"} 0\n"));
+}
+
+TEST_F(MetricsTest, QueueGaugesSkippedForNotLoadedVersion) {
+    auto modelInstance = manager.findModelInstance(config.getName());
+    ASSERT_NE(modelInstance, nullptr);
+    modelInstance->unloadModel();
+
+    auto text = ovms::serializeMetricsToPrometheusText(manager);
+    EXPECT_THAT(text, HasSubstr("ovms_requests_success_total{name=\"dummy\",version=\"1\"} 0\n"));
+    EXPECT_THAT(text, Not(HasSubstr("ovms_infer_requests_nireq{name=\"dummy\"")));
+}
+
+TEST_F(MetricsTest, ModelStatusContainsStats) {
+    auto request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}});
+    ASSERT_EQ(performInference(request), ovms::StatusCode::OK);
+    auto wrongRequest = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE + 1}, tensorflow::DataType::DT_FLOAT}}});
+    ASSERT_EQ(performInference(wrongRequest), ovms::StatusCode::INVALID_SHAPE);
+
+    tensorflow::serving::GetModelStatusRequest statusRequest;
+    tensorflow::serving::GetModelStatusResponse statusResponse;
+    statusRequest.mutable_model_spec()->set_name(config.getName());
+    ASSERT_EQ(ovms::GetModelStatusImpl::getModelStatus(&statusRequest, &statusResponse, manager), ovms::StatusCode::OK);
+    ASSERT_EQ(statusResponse.model_version_status_size(), 1);
+    ASSERT_TRUE(statusResponse.model_version_status(0).has_stats());
+    const auto& stats = statusResponse.model_version_status(0).stats();
+    EXPECT_EQ(stats.requests(), 2);
+    EXPECT_EQ(stats.errors(), 1);
+    EXPECT_EQ(stats.in_flight(), 0);
+    EXPECT_EQ(stats.idle_infer_requests(), 1);
+    EXPECT_EQ(stats.hugepages_bytes(), 0);
+
+    std::string json;
+    ASSERT_EQ(ovms::GetModelStatusImpl::serializeResponse2Json(&statusResponse, &json), ovms::StatusCode::OK);
+    EXPECT_THAT(json, HasSubstr("\"average_inference_us\""));
+}
+
+TEST_F(MetricsTest, ModelStatusStatsSkippedForNotLoadedVersion) {
+    auto modelInstance = manager.findModelInstance(config.getName());
+    ASSERT_NE(modelInstance, nullptr);
+    modelInstance->unloadModel();
+
+    tensorflow::serving::GetModelStatusRequest statusRequest;
+    tensorflow::serving::GetModelStatusResponse statusResponse;
+    statusRequest.mutable_model_spec()->set_name(config.getName());
+    ASSERT_EQ(ovms::GetModelStatusImpl::getModelStatus(&statusRequest, &statusResponse, manager), ovms::StatusCode::OK);
+    ASSERT_EQ(statusResponse.model_version_status_size(), 1);
+    EXPECT_FALSE(statusResponse.model_version_status(0).has_stats());
+}
+
+TEST(HttpRestApiHandlerMetrics, PostMethodNotAllowed) {
+    ovms::HttpRestApiHandler handler(5000);
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    std::string response;
+    EXPECT_EQ(handler.processRequest("POST", "/metrics", body, &headers, &response), ovms::StatusCode::REST_UNSUPPORTED_METHOD);
+}
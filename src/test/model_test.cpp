@@ -14,11 +14,14 @@
 // limitations under the License.
 //*****************************************************************************
 #include <deque>
+#include <future>
+#include <memory>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "../model.hpp"
+#include "../modelreaper.hpp"
 #include "mockmodelinstancechangingstates.hpp"
 #include "test_utils.hpp"
 
@@ -74,6 +77,22 @@ TEST_F(ModelDefaultVersions, DefaultVersionShouldReturnHighest) {
     EXPECT_EQ(2, defaultInstance->getVersion());
 }
 
+TEST_F(ModelDefaultVersions, DefaultVersionShouldReturnHighestWhenAddedConcurrently) {
+    MockModelWithInstancesJustChangingStates mockModel;
+    std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
+    for (ovms::model_version_t version = 1; version <= 5; version++) {
+        versionsToChange->push_back(version);
+    }
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(mockModel.addVersions(versionsToChange, config, 3), ovms::StatusCode::OK);
+
+    EXPECT_EQ(mockModel.getModelVersions().size(), 5);
+    std::shared_ptr<ovms::ModelInstance> defaultInstance;
+    defaultInstance = mockModel.getDefaultModelInstance();
+    EXPECT_TRUE(nullptr != defaultInstance);
+    EXPECT_EQ(5, defaultInstance->getVersion());
+}
+
 TEST_F(ModelDefaultVersions, DefaultVersionShouldReturnHighestNonRetired) {
     MockModelWithInstancesJustChangingStates mockModel;
     std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
@@ -124,3 +143,125 @@ TEST_F(ModelDefaultVersions, DefaultVersionShouldReturnHighestWhenVersionReloade
     EXPECT_TRUE(nullptr != defaultInstance);
     EXPECT_EQ(2, defaultInstance->getVersion());
 }
+
+TEST_F(ModelDefaultVersions, ReloadedVersionIsReplacedWithNewInstance) {
+    MockModelWithInstancesJustChangingStates mockModel;
+    std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
+    versionsToChange->push_back(1);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(mockModel.addVersions(versionsToChange, config), ovms::StatusCode::OK);
+    auto previousInstance = mockModel.getModelInstanceByVersion(1);
+    ASSERT_NE(nullptr, previousInstance);
+
+    config.setNireq(2);
+    ASSERT_EQ(mockModel.reloadVersions(versionsToChange, config), ovms::StatusCode::OK);
+
+    auto currentInstance = mockModel.getModelInstanceByVersion(1);
+    ASSERT_NE(nullptr, currentInstance);
+    EXPECT_NE(previousInstance, currentInstance);
+    EXPECT_EQ(ovms::ModelVersionState::END, previousInstance->getStatus().getState());
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, currentInstance->getStatus().getState());
+    EXPECT_EQ(currentInstance, mockModel.getDefaultModelInstance());
+}
+
+TEST_F(ModelDefaultVersions, RetiringVersionInUseDoesNotWaitForInferences) {
+    MockModelWithInstancesJustChangingStates mockModel;
+    std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
+    versionsToChange->push_back(1);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(mockModel.addVersions(versionsToChange, config), ovms::StatusCode::OK);
+    auto instance = mockModel.getDefaultModelInstance();
+    ASSERT_NE(nullptr, instance);
+    instance->increasePredictRequestsHandlesCount();
+
+    mockModel.retireVersions(versionsToChange);
+    EXPECT_EQ(ovms::ModelVersionState::UNLOADING, instance->getStatus().getState());
+    EXPECT_EQ(nullptr, mockModel.getDefaultModelInstance());
+
+    instance->decreasePredictRequestsHandlesCount();
+    ovms::ModelReaper::getInstance().waitUntilIdle();
+    EXPECT_EQ(ovms::ModelVersionState::END, instance->getStatus().getState());
+}
+
+TEST_F(ModelDefaultVersions, ReleasedNetworkMemoryIsCountedUntilDestroyed) {
+    auto& reaper = ovms::ModelReaper::getInstance();
+    reaper.waitUntilIdle();
+    const size_t pendingBefore = reaper.getPendingMemoryUsage();
+    std::promise<void> destructionAllowed;
+    std::shared_future<void> allowed = destructionAllowed.get_future().share();
+    reaper.release(std::shared_ptr<void>(new int(0), [allowed](void* resource) {
+        allowed.wait();
+        delete static_cast<int*>(resource);
+    }),
+        1024);
+    EXPECT_EQ(reaper.getPendingMemoryUsage(), pendingBefore + 1024);
+
+    destructionAllowed.set_value();
+    reaper.waitUntilIdle();
+    EXPECT_EQ(reaper.getPendingMemoryUsage(), pendingBefore);
+}
+
+TEST_F(ModelDefaultVersions, ResultCacheIsNotEnabledForStatefulModel) {
+    MockModelWithInstancesJustChangingStates mockModel;
+    std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
+    versionsToChange->push_back(1);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setResultCacheSizeMb(1);
+    config.setStateful(true);
+    ASSERT_EQ(mockModel.addVersions(versionsToChange, config), ovms::StatusCode::OK);
+    EXPECT_EQ(mockModel.getResultCache(), nullptr);
+
+    config.setStateful(false);
+    ASSERT_EQ(mockModel.reloadVersions(versionsToChange, config), ovms::StatusCode::OK);
+    EXPECT_NE(mockModel.getResultCache(), nullptr);
+
+    // model becoming stateful drops its cached responses
+    config.setStateful(true);
+    ASSERT_EQ(mockModel.reloadVersions(versionsToChange, config), ovms::StatusCode::OK);
+    EXPECT_EQ(mockModel.getResultCache(), nullptr);
+}
+
+namespace {
+constexpr uint32_t FAILING_NIREQ = 3;
+
+class MockModelInstanceFailingWithNireq : public MockModelInstanceChangingStates {
+public:
+    using MockModelInstanceChangingStates::MockModelInstanceChangingStates;
+    ovms::Status loadModel(const ovms::ModelConfig& config) override {
+        if (config.getNireq() == FAILING_NIREQ) {
+            this->status = ovms::ModelVersionStatus(config.getName(), config.getVersion());
+            this->status.setLoading(ovms::ModelVersionStatusErrorCode::UNKNOWN);
+            return ovms::StatusCode::INVALID_NIREQ;
+        }
+        return MockModelInstanceChangingStates::loadModel(config);
+    }
+};
+
+class MockModelWithInstancesFailingWithNireq : public ovms::Model {
+public:
+    MockModelWithInstancesFailingWithNireq() :
+        Model("UNUSED_NAME") {}
+
+protected:
+    std::shared_ptr<ovms::ModelInstance> modelInstanceFactory(const std::string& modelName, const ovms::model_version_t version) override {
+        return std::make_shared<MockModelInstanceFailingWithNireq>(modelName, version);
+    }
+};
+}  // namespace
+
+TEST_F(ModelDefaultVersions, FailedReloadKeepsCurrentInstanceServing) {
+    MockModelWithInstancesFailingWithNireq mockModel;
+    std::shared_ptr<ovms::model_versions_t> versionsToChange = std::make_shared<ovms::model_versions_t>();
+    versionsToChange->push_back(1);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    ASSERT_EQ(mockModel.addVersions(versionsToChange, config), ovms::StatusCode::OK);
+    auto previousInstance = mockModel.getModelInstanceByVersion(1);
+    ASSERT_NE(nullptr, previousInstance);
+
+    config.setNireq(FAILING_NIREQ);
+    EXPECT_EQ(mockModel.reloadVersions(versionsToChange, config), ovms::StatusCode::INVALID_NIREQ);
+
+    EXPECT_EQ(previousInstance, mockModel.getModelInstanceByVersion(1));
+    EXPECT_EQ(previousInstance, mockModel.getDefaultModelInstance());
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, previousInstance->getStatus().getState());
+}
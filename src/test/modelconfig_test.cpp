@@ -265,6 +265,19 @@ TEST(ModelConfig, isDeviceUsed) {
     EXPECT_TRUE(config.isDeviceUsed("CPU"));
     config.setTargetDevice("HETERO:MYRIAD,GPU");
     EXPECT_FALSE(config.isDeviceUsed("CPU"));
+    config.setTargetDevice("BALANCE:GPU.0,CPU");
+    EXPECT_TRUE(config.isDeviceUsed("CPU"));
+    EXPECT_FALSE(config.isDeviceUsed("GPU"));
+}
+
+TEST(ModelConfig, getBalancedTargetDevices) {
+    ovms::ModelConfig config;
+    config.setTargetDevice("CPU");
+    EXPECT_TRUE(config.getBalancedTargetDevices().empty());
+    config.setTargetDevice("MULTI:GPU,CPU");
+    EXPECT_TRUE(config.getBalancedTargetDevices().empty());
+    config.setTargetDevice("BALANCE:GPU.0, GPU.1,CPU");
+    EXPECT_THAT(config.getBalancedTargetDevices(), ElementsAre("GPU.0", "GPU.1", "CPU"));
 }
 
 TEST(ModelConfig, shapeConfigurationEqual_SingleInput) {
@@ -471,3 +484,71 @@ TEST(ModelConfig, ConfigParseNodeWithForbiddenShapeName) {
     ASSERT_EQ(status, ovms::StatusCode::OK);
     EXPECT_EQ(modelConfig.getShapes().size(), 0);
 }
+
+TEST(ModelConfig, ConfigParseNodeWithDynamicBatching) {
+    std::string config = R"#(
+        {
+        "model_config_list": [
+            {
+                "config": {
+                    "name": "alpha",
+                    "base_path": "/tmp/models/dummy1",
+                    "max_batch_size": 8,
+                    "batch_timeout_microseconds": 500
+                }
+            }
+        ]
+    }
+    )#";
+
+    rapidjson::Document configJson;
+    rapidjson::ParseResult parsingSucceeded = configJson.Parse(config.c_str());
+    ASSERT_EQ(parsingSucceeded, true);
+
+    const auto modelConfigList = configJson.FindMember("model_config_list");
+    ASSERT_NE(modelConfigList, configJson.MemberEnd());
+    const auto& configs = modelConfigList->value.GetArray();
+    ASSERT_EQ(configs.Size(), 1);
+    ovms::ModelConfig modelConfig;
+    auto status = modelConfig.parseNode(configs[0]["config"]);
+
+    ASSERT_EQ(status, ovms::StatusCode::OK);
+    EXPECT_TRUE(modelConfig.isDynamicBatchingEnabled());
+    EXPECT_EQ(modelConfig.getMaxBatchSize(), 8);
+    EXPECT_EQ(modelConfig.getBatchTimeoutMicroseconds(), 500);
+
+    ovms::ModelConfig otherConfig = modelConfig;
+    EXPECT_FALSE(modelConfig.isReloadRequired(otherConfig));
+    otherConfig.setBatchTimeoutMicroseconds(1000);
+    EXPECT_TRUE(modelConfig.isReloadRequired(otherConfig));
+}
+
+TEST(ModelConfig, ConfigParseNodeDynamicBatchingIgnoredWithAutoBatchSize) {
+    std::string config = R"#(
+        {
+        "model_config_list": [
+            {
+                "config": {
+                    "name": "alpha",
+                    "base_path": "/tmp/models/dummy1",
+                    "batch_size": "auto",
+                    "max_batch_size": 8
+                }
+            }
+        ]
+    }
+    )#";
+
+    rapidjson::Document configJson;
+    rapidjson::ParseResult parsingSucceeded = configJson.Parse(config.c_str());
+    ASSERT_EQ(parsingSucceeded, true);
+
+    const auto& configs = configJson.FindMember("model_config_list")->value.GetArray();
+    ASSERT_EQ(configs.Size(), 1);
+    ovms::ModelConfig modelConfig;
+    auto status = modelConfig.parseNode(configs[0]["config"]);
+
+    ASSERT_EQ(status, ovms::StatusCode::OK);
+    EXPECT_FALSE(modelConfig.isDynamicBatchingEnabled());
+    EXPECT_EQ(modelConfig.getMaxBatchSize(), 0);
+}
@@ -16,15 +16,19 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <stdlib.h>
 
 #include "../get_model_metadata_impl.hpp"
+#include "../localfilesystem.hpp"
 #include "../modelinstance.hpp"
 #include "test_utils.hpp"
 
+using testing::HasSubstr;
 using testing::Return;
 
 const std::vector<ovms::ModelVersionState> INFER_QUEUE_SUCCESS_FOR_STATES{
@@ -193,6 +197,60 @@ TEST_F(TestLoadModel, CheckIfOVNonExistingBinFileErrorIsCatched) {
     EXPECT_EQ(status, ovms::StatusCode::CANNOT_LOAD_NETWORK_INTO_TARGET_DEVICE) << status.string();
 }
 
+class MockModelInstanceCountingCompilations : public ovms::ModelInstance {
+public:
+    MockModelInstanceCountingCompilations() :
+        ModelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION) {}
+
+    size_t compilations = 0;
+
+protected:
+    void loadExecutableNetworkPtr(const ovms::plugin_config_t& pluginConfig) override {
+        compilations++;
+        ModelInstance::loadExecutableNetworkPtr(pluginConfig);
+    }
+};
+
+TEST_F(TestLoadModel, CompiledModelCacheSkipsCompilationWhenNetworkWasExported) {
+    const std::string cacheDir = "/tmp/test_compiled_model_cache";
+    std::filesystem::remove_all(cacheDir);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setCompiledModelCacheDir(cacheDir);
+
+    MockModelInstanceCountingCompilations firstInstance;
+    ASSERT_EQ(firstInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(firstInstance.compilations, 1);
+    // export depends on target device plugin support, without it every load compiles the network
+    const bool exported = std::filesystem::exists(cacheDir) && !std::filesystem::is_empty(cacheDir);
+
+    MockModelInstanceCountingCompilations secondInstance;
+    ASSERT_EQ(secondInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(secondInstance.compilations, exported ? 0 : 1);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, secondInstance.getStatus().getState());
+    std::filesystem::remove_all(cacheDir);
+}
+
+TEST_F(TestLoadModel, SharedCompiledNetworkIsCompiledOnceForIdenticalModels) {
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setShareCompiledNetworks(true);
+
+    MockModelInstanceCountingCompilations firstInstance;
+    ASSERT_EQ(firstInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(firstInstance.compilations, 1);
+
+    config.setName("alias");
+    MockModelInstanceCountingCompilations secondInstance;
+    ASSERT_EQ(secondInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(secondInstance.compilations, 0);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, secondInstance.getStatus().getState());
+
+    // versions with different inputs compile their own network
+    config.setBatchSize(2);
+    MockModelInstanceCountingCompilations reshapedInstance;
+    ASSERT_EQ(reshapedInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(reshapedInstance.compilations, 1);
+}
+
 TEST_F(TestLoadModel, CheckIfNonExistingXmlFileReturnsFileInvalid) {
     ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
 
@@ -263,6 +321,71 @@ TEST_F(TestLoadModel, SuccessfulLoad) {
     EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
 }
 
+TEST_F(TestLoadModel, SuccessfulLoadFromMemory) {
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    auto files = std::make_shared<ovms::InMemoryModelFiles>();
+    ovms::LocalFileSystem lfs;
+    ASSERT_EQ(lfs.readTextFile(dummy_model_location + "/1/dummy.xml", &files->model), ovms::StatusCode::OK);
+    ASSERT_EQ(lfs.readTextFile(dummy_model_location + "/1/dummy.bin", &files->weights), ovms::StatusCode::OK);
+    config.setDownloadToMemory(true);
+    config.setLeanMemory(true);
+    config.setInMemoryModelFiles(config.getVersion(), files);
+    // files are not read from disk
+    config.setLocalPath("/nonexisting_path");
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    EXPECT_EQ(modelInstance.getModelConfig().getInMemoryModelFiles(config.getVersion()), nullptr);
+    // released network is read again from files kept in memory
+    EXPECT_EQ(modelInstance.reloadModel(modelInstance.getModelConfig()), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+}
+
+TEST_F(TestLoadModel, MetadataCacheIsDroppedOnReload) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    EXPECT_EQ(modelInstance.getMetadataCache(), nullptr);
+    auto entry = std::make_shared<ovms::ModelMetadataCacheEntry>();
+    entry->response.mutable_model_spec()->set_name("UNUSED_NAME");
+    modelInstance.setMetadataCache(entry);
+    EXPECT_EQ(modelInstance.getMetadataCache(), entry);
+
+    ASSERT_EQ(modelInstance.reloadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    EXPECT_EQ(modelInstance.getMetadataCache(), nullptr);
+}
+
+TEST_F(TestLoadModel, SuccessfulLoadWithWarmup) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setNireq(2);
+    config.setWarmupIterations(3);
+    EXPECT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+}
+
+TEST_F(TestLoadModel, SuccessfulLoadWithWarmupData) {
+    std::vector<float> samples(3 * DUMMY_MODEL_INPUT_SIZE, 1.0);
+    auto path = createNpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (3, 10), }",
+        std::string(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(float)), "/tmp/ovms_warmup_dummy.npy");
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setNireq(2);
+    config.setWarmupData({{DUMMY_MODEL_INPUT_NAME, path}});
+    EXPECT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+}
+
+TEST_F(TestLoadModel, UnSuccessfulLoadWithWarmupDataOfWrongShape) {
+    std::vector<float> samples(3 * (DUMMY_MODEL_INPUT_SIZE + 1), 1.0);
+    auto path = createNpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (3, 11), }",
+        std::string(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(float)), "/tmp/ovms_warmup_dummy_wrong.npy");
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setWarmupData({{DUMMY_MODEL_INPUT_NAME, path}});
+    EXPECT_EQ(modelInstance.loadModel(config), ovms::StatusCode::WARMUP_DATA_INVALID);
+    EXPECT_EQ(ovms::ModelVersionState::LOADING, modelInstance.getStatus().getState());
+}
+
 TEST_F(TestLoadModel, UnSuccessfulLoadWhenNireqTooHigh) {
     std::filesystem::path dir = std::filesystem::current_path();
     std::string dummy_model = dir.u8string() + "/src/test/dummy";
@@ -305,6 +428,20 @@ TEST_F(TestReloadModel, SuccessfulReloadFromAlreadyLoadedWithNewBatchSize) {
     EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
 }
 
+TEST_F(TestReloadModel, SuccessfulReloadWithNewBatchSizeAfterNetworkReleasedInLeanMemoryMode) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setBatchSize(1);
+    config.setLeanMemory(true);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    ASSERT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    EXPECT_EQ(modelInstance.getBatchSize(), 1);
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    EXPECT_EQ(modelInstance.reloadModel(2, {}, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    EXPECT_EQ(modelInstance.getBatchSize(), 2);
+}
+
 TEST_F(TestReloadModel, SuccessfulReloadFromAlreadyLoadedWithNewShape) {
     ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
     ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
@@ -345,6 +482,114 @@ TEST_F(TestReloadModel, SuccessfulReloadFromAlreadyUnloadedWithNewShape) {
     EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
 }
 
+TEST_F(TestReloadModel, ReloadToAlreadyReachedBatchSizeIsNotRepeated) {
+    MockModelInstanceCountingCompilations modelInstance;
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setBatchSize(1);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    // request waiting for reload done by another request with the same batch size reuses its result
+    ASSERT_EQ(modelInstance.reloadModel(2, {}, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(modelInstance.compilations, 2);
+    ASSERT_NE(unloadGuard, nullptr);
+    EXPECT_EQ(modelInstance.reloadModel(2, {}, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_EQ(modelInstance.compilations, 2);
+    EXPECT_NE(unloadGuard, nullptr);
+    EXPECT_EQ(modelInstance.getBatchSize(), 2);
+}
+
+class TestEvictModel : public ::testing::Test {};
+
+TEST_F(TestEvictModel, EvictedModelIsLoadedOnNextRequest) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    EXPECT_GT(modelInstance.getMemoryUsage(), 0);
+    ASSERT_TRUE(modelInstance.evict());
+    EXPECT_TRUE(modelInstance.isEvicted());
+    EXPECT_EQ(modelInstance.getMemoryUsage(), 0);
+    EXPECT_EQ(ovms::ModelVersionState::START, modelInstance.getStatus().getState());
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(modelInstance.waitForLoaded(1000, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_FALSE(modelInstance.isEvicted());
+    EXPECT_GT(modelInstance.getMemoryUsage(), 0);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+}
+
+TEST_F(TestEvictModel, ModelInUseIsNotEvicted) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(modelInstance.waitForLoaded(0, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_FALSE(modelInstance.evict());
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    unloadGuard.reset();
+    EXPECT_TRUE(modelInstance.evict());
+}
+
+TEST_F(TestEvictModel, UnloadedModelIsNotEvicted) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ASSERT_EQ(modelInstance.loadModel(DUMMY_MODEL_CONFIG), ovms::StatusCode::OK);
+    modelInstance.unloadModel();
+    EXPECT_FALSE(modelInstance.evict());
+    EXPECT_EQ(ovms::ModelVersionState::END, modelInstance.getStatus().getState());
+}
+
+TEST_F(TestEvictModel, LazyLoadedModelIsLoadedOnFirstRequest) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setLazyLoad(true);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_TRUE(modelInstance.isEvicted());
+    EXPECT_EQ(ovms::ModelVersionState::START, modelInstance.getStatus().getState());
+    EXPECT_EQ(modelInstance.getInputsInfo().size(), 0);
+    std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+    ASSERT_EQ(modelInstance.waitForLoaded(0, unloadGuard), ovms::StatusCode::OK);
+    EXPECT_FALSE(modelInstance.isEvicted());
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    EXPECT_EQ(modelInstance.getInputsInfo().size(), 1);
+}
+
+TEST_F(TestEvictModel, ConcurrentFirstRequestsOfLazyLoadedModelSucceed) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setLazyLoad(true);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    std::vector<std::thread> threads;
+    std::vector<ovms::Status> statuses(4, ovms::StatusCode::UNKNOWN_ERROR);
+    for (size_t i = 0; i < statuses.size(); i++) {
+        threads.emplace_back([&modelInstance, &statuses, i]() {
+            std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+            statuses[i] = modelInstance.waitForLoaded(10000, unloadGuard);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& status : statuses) {
+        EXPECT_EQ(status, ovms::StatusCode::OK) << status.string();
+    }
+}
+
+TEST_F(TestLoadModel, SuccessfulLoadWithAutoTuning) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setAutoTune(true);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_EQ(ovms::ModelVersionState::AVAILABLE, modelInstance.getStatus().getState());
+    EXPECT_THAT(modelInstance.getStatus().getDetails(), HasSubstr("auto tuned CPU_THROUGHPUT_STREAMS"));
+    EXPECT_GT(modelInstance.getInferRequestsQueue().size(), 0);
+}
+
+TEST_F(TestLoadModel, AutoTuningKeepsConfiguredNireq) {
+    ovms::ModelInstance modelInstance("UNUSED_NAME", UNUSED_MODEL_VERSION);
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setAutoTune(true);
+    config.setNireq(3);
+    ASSERT_EQ(modelInstance.loadModel(config), ovms::StatusCode::OK);
+    EXPECT_THAT(modelInstance.getStatus().getDetails(), HasSubstr("nireq: 3"));
+    EXPECT_EQ(modelInstance.getInferRequestsQueue().size(), 3);
+}
+
 TEST(CpuThroughputStreamsNotSpecified, DefaultIsSetForCPU) {
     ovms::ModelConfig config;
     config.setTargetDevice("CPU");
@@ -407,6 +407,61 @@ TEST(ModelManager, ConfigReloadingShouldRetireModelInstancesOfModelRemovedFromJs
     manager.join();
 }
 
+class MockModelManagerCountingVersionReads : public MockModelManagerWithModelInstancesJustChangingStates {
+public:
+    ovms::Status readAvailableVersions(
+        std::shared_ptr<ovms::FileSystem>& fs,
+        const std::string& base,
+        ovms::model_versions_t& versions) override {
+        versionReads[base]++;
+        return MockModelManagerWithModelInstancesJustChangingStates::readAvailableVersions(fs, base, versions);
+    };
+    std::map<std::string, size_t> versionReads;
+};
+
+TEST(ModelManager, ConfigReloadingShouldReloadOnlyModelsWithChangedConfig) {
+    const char* config_2_models_changed_second = R"({
+   "model_config_list": [
+    {
+      "config": {
+        "name": "resnet",
+        "base_path": "/tmp/models/dummy1",
+        "target_device": "CPU",
+        "model_version_policy": {"all": {}}
+      }
+    },
+    {
+      "config": {
+        "name": "alpha",
+        "base_path": "/tmp/models/dummy2",
+        "target_device": "CPU",
+        "nireq": 2,
+        "model_version_policy": {"all": {}}
+      }
+    }]
+})";
+    std::string fileToReload = "/tmp/ovms_config_file_diff.json";
+    createConfigFileWithContent(config_2_models, fileToReload);
+    MockModelManagerCountingVersionReads manager;
+    manager.registerVersionToLoad(1);
+    ASSERT_EQ(manager.startFromFile(fileToReload), ovms::StatusCode::OK);
+    EXPECT_EQ(manager.versionReads["/tmp/models/dummy1"], 1);
+    EXPECT_EQ(manager.versionReads["/tmp/models/dummy2"], 1);
+
+    createConfigFileWithContent(config_2_models_changed_second, fileToReload);
+    ASSERT_EQ(manager.startFromFile(fileToReload), ovms::StatusCode::OK);
+    EXPECT_EQ(manager.versionReads["/tmp/models/dummy1"], 1);
+    EXPECT_EQ(manager.versionReads["/tmp/models/dummy2"], 2);
+
+    // removed and added back model is loaded again
+    createConfigFileWithContent(config_1_model, fileToReload);
+    ASSERT_EQ(manager.startFromFile(fileToReload), ovms::StatusCode::OK);
+    createConfigFileWithContent(config_2_models_changed_second, fileToReload);
+    ASSERT_EQ(manager.startFromFile(fileToReload), ovms::StatusCode::OK);
+    EXPECT_EQ(manager.versionReads["/tmp/models/dummy1"], 1);
+    EXPECT_EQ(manager.versionReads["/tmp/models/dummy2"], 3);
+}
+
 class MockModelInstanceInStateWithConfig : public ovms::ModelInstance {
     static const ovms::model_version_t UNUSED_VERSION = 987789;
 
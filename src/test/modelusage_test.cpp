@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../modelusage.hpp"
+#include "test_utils.hpp"
+
+using ovms::ModelUsage;
+
+class ModelUsageTest : public TestWithTempDir {};
+
+TEST_F(ModelUsageTest, CountsOfPreviousRunAreHalvedAndAddedToCurrentOnes) {
+    const std::string path = directoryPath + "/usage.json";
+    ModelUsage previousRun;
+    previousRun.setPath(path);
+    ASSERT_EQ(previousRun.load(), ovms::StatusCode::OK);
+    ASSERT_EQ(previousRun.save({{"busy", 1000}, {"rare", 10}}), ovms::StatusCode::OK);
+
+    ModelUsage usage;
+    usage.setPath(path);
+    ASSERT_EQ(usage.load(), ovms::StatusCode::OK);
+    EXPECT_EQ(usage.getCount("busy"), 500);
+    EXPECT_EQ(usage.getCount("rare", 7), 12);
+    EXPECT_EQ(usage.getCount("new", 3), 3);
+
+    // models missing in current counts are dropped
+    ASSERT_EQ(usage.save({{"rare", 7}}), ovms::StatusCode::OK);
+    ASSERT_EQ(usage.load(), ovms::StatusCode::OK);
+    EXPECT_EQ(usage.getCount("busy"), 0);
+    EXPECT_EQ(usage.getCount("rare"), 6);
+}
+
+TEST_F(ModelUsageTest, MissingOrInvalidFileGivesNoUsage) {
+    ModelUsage usage;
+    usage.setPath(directoryPath + "/missing.json");
+    EXPECT_EQ(usage.load(), ovms::StatusCode::OK);
+    EXPECT_EQ(usage.getCount("model"), 0);
+
+    const std::string path = directoryPath + "/invalid.json";
+    std::ofstream(path) << "[1, 2";
+    usage.setPath(path);
+    EXPECT_EQ(usage.load(), ovms::StatusCode::JSON_INVALID);
+    EXPECT_EQ(usage.getCount("model"), 0);
+}
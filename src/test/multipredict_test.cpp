@@ -0,0 +1,207 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../modelinstance.hpp"
+#include "../modelinstanceunloadguard.hpp"
+#include "../multipredict.hpp"
+#include "test_utils.hpp"
+
+using ovms::MultiPredictCompletion;
+using ovms::MultiPredictModel;
+using ovms::MultiPredictRequest;
+using ovms::StatusCode;
+using ovms::TensorInfo;
+
+namespace {
+void setInput(tensorflow::serving::PredictRequest& request, const std::string& name, const std::string& content) {
+    auto& input = (*request.mutable_inputs())[name];
+    input.set_dtype(tensorflow::DataType::DT_FLOAT);
+    input.mutable_tensor_shape()->add_dim()->set_size(1);
+    input.set_tensor_content(content);
+}
+
+ovms::tensor_map_t prepareInputsInfo(const std::vector<std::string>& names) {
+    ovms::tensor_map_t inputsInfo;
+    for (const auto& name : names) {
+        inputsInfo[name] = std::make_shared<TensorInfo>(name, InferenceEngine::Precision::FP32, ovms::shape_t{1}, InferenceEngine::Layout::C);
+    }
+    return inputsInfo;
+}
+}  // namespace
+
+TEST(MultiPredict, SharedInputsArePassedOnlyToModelsHavingThem) {
+    MultiPredictRequest request;
+    setInput(*request.mutable_shared_inputs(), "image", "aaaa");
+    setInput(*request.mutable_shared_inputs(), "mask", "bbbb");
+    request.add_requests();
+    request.add_requests();
+    request.add_requests();
+    const auto imageAndMask = prepareInputsInfo({"image", "mask"});
+    const auto image = prepareInputsInfo({"image"});
+    const auto other = prepareInputsInfo({"other"});
+    ovms::shareMultiPredictInputs(request, {&imageAndMask, &image, &other});
+
+    ASSERT_EQ(request.requests(0).inputs().size(), 2);
+    EXPECT_EQ(request.requests(0).inputs().at("image").tensor_content(), "aaaa");
+    EXPECT_EQ(request.requests(0).inputs().at("mask").tensor_content(), "bbbb");
+    ASSERT_EQ(request.requests(1).inputs().size(), 1);
+    EXPECT_EQ(request.requests(1).inputs().at("image").tensor_content(), "aaaa");
+    EXPECT_EQ(request.requests(2).inputs().size(), 0);
+    // last request using the input takes it over without copy
+    EXPECT_TRUE(request.shared_inputs().inputs().at("image").tensor_content().empty());
+    EXPECT_TRUE(request.shared_inputs().inputs().at("mask").tensor_content().empty());
+}
+
+TEST(MultiPredict, InputsOfModelRequestTakePrecedenceOverSharedInputs) {
+    MultiPredictRequest request;
+    setInput(*request.mutable_shared_inputs(), "image", "shared");
+    setInput(*request.add_requests(), "image", "own");
+    request.add_requests();
+    setInput(*request.add_requests(), "image", "own");
+    const auto image = prepareInputsInfo({"image"});
+    ovms::shareMultiPredictInputs(request, {&image, &image, &image});
+
+    EXPECT_EQ(request.requests(0).inputs().at("image").tensor_content(), "own");
+    EXPECT_EQ(request.requests(1).inputs().at("image").tensor_content(), "shared");
+    EXPECT_EQ(request.requests(2).inputs().at("image").tensor_content(), "own");
+}
+
+TEST(MultiPredict, CopiedBytesAreCountedForAllButLastRequestOfInput) {
+    MultiPredictRequest request;
+    setInput(*request.mutable_shared_inputs(), "image", "aaaa");
+    request.add_requests();
+    request.add_requests();
+    request.add_requests();
+    setInput(*request.add_requests(), "image", "cccc");
+    const auto image = prepareInputsInfo({"image"});
+    const auto other = prepareInputsInfo({"other"});
+    const size_t inputBytes = request.shared_inputs().inputs().at("image").ByteSizeLong();
+    const auto copiedBytes = ovms::getMultiPredictCopiedBytes(request, {&image, &other, &image, &image});
+    EXPECT_EQ(copiedBytes, (std::vector<size_t>{inputBytes, 0, 0, 0}));
+}
+
+TEST(MultiPredict, CallStatusIsReportedOnceLastRequestIsCompleted) {
+    MultiPredictCompletion completion(3);
+    ovms::Status callStatus = StatusCode::INTERNAL_ERROR;
+    EXPECT_FALSE(completion.complete(StatusCode::OK, callStatus));
+    EXPECT_FALSE(completion.complete(StatusCode::OK, callStatus));
+    EXPECT_EQ(callStatus, StatusCode::INTERNAL_ERROR);
+    EXPECT_TRUE(completion.complete(StatusCode::OK, callStatus));
+    EXPECT_EQ(callStatus, StatusCode::OK);
+}
+
+TEST(MultiPredict, FailureOfAnyRequestFailsCallWithFirstError) {
+    MultiPredictCompletion completion(3);
+    ovms::Status callStatus;
+    EXPECT_FALSE(completion.complete(StatusCode::OK, callStatus));
+    EXPECT_FALSE(completion.complete(StatusCode::INVALID_SHAPE, callStatus));
+    EXPECT_TRUE(completion.complete(StatusCode::INVALID_PRECISION, callStatus));
+    EXPECT_EQ(callStatus, StatusCode::INVALID_SHAPE);
+}
+
+TEST(MultiPredict, OnlyLastOfConcurrentlyCompletedRequestsFinishesCall) {
+    const size_t count = 64;
+    MultiPredictCompletion completion(count);
+    std::atomic<size_t> finished{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; i++) {
+        threads.emplace_back([&completion, &finished, i]() {
+            ovms::Status callStatus;
+            if (completion.complete(i == 7 ? StatusCode::OV_INTERNAL_INFERENCE_ERROR : StatusCode::OK, callStatus)) {
+                EXPECT_EQ(callStatus, StatusCode::OV_INTERNAL_INFERENCE_ERROR);
+                finished++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(finished.load(), 1);
+}
+
+class MultiPredictPrepare : public ::testing::Test {
+public:
+    void SetUp() override {
+        ASSERT_EQ(manager.reloadModelWithVersions(config), StatusCode::OK);
+    }
+
+    ConstructorEnabledModelManager manager;
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+};
+
+TEST_F(MultiPredictPrepare, CallWithoutRequestsIsRejected) {
+    MultiPredictRequest request;
+    std::vector<MultiPredictModel> models;
+    EXPECT_EQ(ovms::prepareMultiPredict(manager, request, models), StatusCode::MULTI_PREDICT_NO_REQUESTS);
+}
+
+TEST_F(MultiPredictPrepare, CallWithTooManyRequestsIsRejected) {
+    MultiPredictRequest request;
+    for (int i = 0; i <= ovms::MAX_MULTI_PREDICT_REQUESTS; i++) {
+        request.add_requests()->mutable_model_spec()->set_name("dummy");
+    }
+    std::vector<MultiPredictModel> models;
+    EXPECT_EQ(ovms::prepareMultiPredict(manager, request, models), StatusCode::MULTI_PREDICT_TOO_MANY_REQUESTS);
+    EXPECT_TRUE(models.empty());
+}
+
+TEST_F(MultiPredictPrepare, SharedInputCopiesExceedingBudgetAreRejected) {
+    MultiPredictRequest request;
+    setInput(*request.mutable_shared_inputs(), DUMMY_MODEL_INPUT_NAME, std::string(1024, 'a'));
+    request.add_requests()->mutable_model_spec()->set_name("dummy");
+    request.add_requests()->mutable_model_spec()->set_name("dummy");
+    request.add_requests()->mutable_model_spec()->set_name("dummy");
+    auto& budget = ovms::InFlightMemoryBudget::getInstance();
+    budget.configure(1500);
+    std::vector<MultiPredictModel> models;
+    EXPECT_EQ(ovms::prepareMultiPredict(manager, request, models), StatusCode::IN_FLIGHT_MEMORY_EXHAUSTED);
+    // input is not copied before copies of all requests are reserved, reservations are released with the call
+    EXPECT_EQ(request.requests(0).inputs().count(DUMMY_MODEL_INPUT_NAME), 0);
+    models.clear();
+    EXPECT_EQ(budget.getReservedBytes(), 0);
+    budget.configure(0);
+}
+
+TEST_F(MultiPredictPrepare, MissingModelFailsWholeCall) {
+    MultiPredictRequest request;
+    request.add_requests()->mutable_model_spec()->set_name("dummy");
+    request.add_requests()->mutable_model_spec()->set_name("missing");
+    std::vector<MultiPredictModel> models;
+    EXPECT_EQ(ovms::prepareMultiPredict(manager, request, models), StatusCode::MODEL_NAME_MISSING);
+}
+
+TEST_F(MultiPredictPrepare, SharedInputIsPassedToEachRequestOfModel) {
+    MultiPredictRequest request;
+    setInput(*request.mutable_shared_inputs(), DUMMY_MODEL_INPUT_NAME, "content");
+    request.add_requests()->mutable_model_spec()->set_name("dummy");
+    request.add_requests()->mutable_model_spec()->set_name("dummy");
+    std::vector<MultiPredictModel> models;
+    ASSERT_EQ(ovms::prepareMultiPredict(manager, request, models), StatusCode::OK);
+    ASSERT_EQ(models.size(), 2);
+    for (const auto& model : models) {
+        ASSERT_NE(model.modelInstance, nullptr);
+        EXPECT_NE(model.modelInstanceUnloadGuard, nullptr);
+    }
+    EXPECT_EQ(request.requests(0).inputs().at(DUMMY_MODEL_INPUT_NAME).tensor_content(), "content");
+    EXPECT_EQ(request.requests(1).inputs().at(DUMMY_MODEL_INPUT_NAME).tensor_content(), "content");
+}
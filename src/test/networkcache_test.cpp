@@ -0,0 +1,107 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../modelinstance.hpp"
+#include "../networkcache.hpp"
+#include "../prediction_service_utils.hpp"
+#include "test_utils.hpp"
+
+namespace {
+std::shared_ptr<ovms::CachedNetwork> createCachedNetwork(size_t batchSize) {
+    auto network = std::make_shared<ovms::CachedNetwork>();
+    network->execNetwork = std::make_shared<InferenceEngine::ExecutableNetwork>();
+    network->inputsInfo[DUMMY_MODEL_INPUT_NAME] = std::make_shared<ovms::TensorInfo>(
+        DUMMY_MODEL_INPUT_NAME, InferenceEngine::Precision::FP32, ovms::shape_t{batchSize, DUMMY_MODEL_INPUT_SIZE});
+    return network;
+}
+
+std::map<std::string, ovms::shape_t> shapesWithBatch(size_t batchSize) {
+    return {{DUMMY_MODEL_INPUT_NAME, ovms::shape_t{batchSize, DUMMY_MODEL_INPUT_SIZE}}};
+}
+}  // namespace
+
+TEST(NetworkCache, TakeReturnsNetworkWithMatchingShapes) {
+    ovms::NetworkCache cache;
+    cache.setCapacity(2);
+    auto network = createCachedNetwork(1);
+    cache.insert(network);
+    cache.insert(createCachedNetwork(2));
+    EXPECT_EQ(cache.take(shapesWithBatch(3)), nullptr);
+    EXPECT_EQ(cache.take(shapesWithBatch(1)), network);
+    EXPECT_EQ(cache.take(shapesWithBatch(1)), nullptr);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(NetworkCache, LeastRecentlyUsedNetworkEvicted) {
+    ovms::NetworkCache cache;
+    cache.setCapacity(2);
+    cache.insert(createCachedNetwork(1));
+    cache.insert(createCachedNetwork(2));
+    cache.insert(cache.take(shapesWithBatch(1)));
+    cache.insert(createCachedNetwork(3));
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.take(shapesWithBatch(2)), nullptr);
+    EXPECT_NE(cache.take(shapesWithBatch(1)), nullptr);
+    EXPECT_NE(cache.take(shapesWithBatch(3)), nullptr);
+}
+
+TEST(NetworkCache, NetworkWithSameShapesReplaced) {
+    ovms::NetworkCache cache;
+    cache.setCapacity(2);
+    cache.insert(createCachedNetwork(1));
+    auto network = createCachedNetwork(1);
+    cache.insert(network);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.take(shapesWithBatch(1)), network);
+}
+
+TEST(NetworkCache, ZeroCapacityKeepsNothing) {
+    ovms::NetworkCache cache;
+    cache.insert(createCachedNetwork(1));
+    EXPECT_EQ(cache.size(), 0);
+    cache.setCapacity(2);
+    cache.insert(createCachedNetwork(1));
+    cache.insert(createCachedNetwork(2));
+    cache.setCapacity(1);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(NetworkCache, ModelWithAutoBatchSizeSwitchesBackToCachedNetwork) {
+    ConstructorEnabledModelManager manager;
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setBatchingParams("auto");
+    config.setNetworkCacheSize(1);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+
+    for (size_t batchSize : std::vector<size_t>{2, 1, 2}) {
+        std::shared_ptr<ovms::ModelInstance> modelInstance;
+        std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+        ASSERT_EQ(ovms::getModelInstance(manager, config.getName(), 0, modelInstance, unloadGuard), ovms::StatusCode::OK);
+        tensorflow::serving::PredictRequest request = preparePredictRequest(
+            {{DUMMY_MODEL_INPUT_NAME,
+                std::tuple<ovms::shape_t, tensorflow::DataType>{{batchSize, DUMMY_MODEL_INPUT_SIZE}, tensorflow::DataType::DT_FLOAT}}});
+        tensorflow::serving::PredictResponse response;
+        ASSERT_EQ(ovms::inference(*modelInstance, &request, &response, unloadGuard), ovms::StatusCode::OK);
+        EXPECT_EQ(modelInstance->getBatchSize(), batchSize);
+        EXPECT_EQ(modelInstance->getNetworkCache().size(), 1);
+        ASSERT_EQ(response.outputs().count(DUMMY_MODEL_OUTPUT_NAME), 1);
+        EXPECT_EQ(response.outputs().at(DUMMY_MODEL_OUTPUT_NAME).tensor_shape().dim(0).size(), batchSize);
+    }
+}
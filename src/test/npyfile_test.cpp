@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../npyfile.hpp"
+#include "test_utils.hpp"
+
+namespace {
+std::string floatsAsString(const std::vector<float>& values) {
+    return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+}
+}  // namespace
+
+TEST(NpyFile, ReadsArrayWithShapeAndData) {
+    std::vector<float> values{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    auto path = createNpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (3, 2), }", floatsAsString(values), "/tmp/ovms_npy_valid.npy");
+    ovms::NpyArray array;
+    ASSERT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::OK);
+    EXPECT_EQ(array.precision, InferenceEngine::Precision::FP32);
+    EXPECT_EQ(array.shape, (ovms::shape_t{3, 2}));
+    EXPECT_EQ(std::string(array.data.begin(), array.data.end()), floatsAsString(values));
+}
+
+TEST(NpyFile, ReadsOneDimensionalArray) {
+    auto path = createNpyFile("{'descr': '|u1', 'fortran_order': False, 'shape': (4,), }", "abcd", "/tmp/ovms_npy_1d.npy");
+    ovms::NpyArray array;
+    ASSERT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::OK);
+    EXPECT_EQ(array.precision, InferenceEngine::Precision::U8);
+    EXPECT_EQ(array.shape, (ovms::shape_t{4}));
+}
+
+TEST(NpyFile, RejectsInvalidFiles) {
+    ovms::NpyArray array;
+    EXPECT_EQ(ovms::readNpyFile("/tmp/ovms_npy_not_existing.npy", array), ovms::StatusCode::FILE_INVALID);
+
+    auto path = createConfigFileWithContent("not a numpy file", "/tmp/ovms_npy_invalid_magic.npy");
+    EXPECT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::WARMUP_DATA_INVALID);
+
+    path = createNpyFile("{'descr': '<f4', 'fortran_order': True, 'shape': (1, 2), }", floatsAsString({1.0, 2.0}), "/tmp/ovms_npy_fortran.npy");
+    EXPECT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::WARMUP_DATA_INVALID);
+
+    path = createNpyFile("{'descr': '<c8', 'fortran_order': False, 'shape': (1,), }", floatsAsString({1.0, 2.0}), "/tmp/ovms_npy_complex.npy");
+    EXPECT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::WARMUP_DATA_INVALID);
+
+    path = createNpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (2, 2), }", floatsAsString({1.0, 2.0}), "/tmp/ovms_npy_truncated.npy");
+    EXPECT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::WARMUP_DATA_INVALID);
+}
+
+TEST(NpyFile, WrittenArrayIsReadBack) {
+    ovms::NpyArray written;
+    written.precision = InferenceEngine::Precision::FP32;
+    written.shape = {3, 2};
+    auto data = floatsAsString({1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+    written.data.assign(data.begin(), data.end());
+    const std::string path = "/tmp/ovms_npy_written.npy";
+    ASSERT_EQ(ovms::writeNpyFile(path, written), ovms::StatusCode::OK);
+    ovms::NpyArray array;
+    ASSERT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::OK);
+    EXPECT_EQ(array.precision, written.precision);
+    EXPECT_EQ(array.shape, written.shape);
+    EXPECT_EQ(array.data, written.data);
+
+    written.precision = InferenceEngine::Precision::U8;
+    written.shape = {4};
+    written.data.assign({'a', 'b', 'c', 'd'});
+    ASSERT_EQ(ovms::writeNpyFile(path, written), ovms::StatusCode::OK);
+    ASSERT_EQ(ovms::readNpyFile(path, array), ovms::StatusCode::OK);
+    EXPECT_EQ(array.shape, (ovms::shape_t{4}));
+    EXPECT_EQ(array.data, written.data);
+}
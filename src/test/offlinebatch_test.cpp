@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../offlinebatch.hpp"
+
+using ovms::NpyArray;
+using ovms::StatusCode;
+
+TEST(OfflineBatch, NpyArrayConvertedToTensorContent) {
+    NpyArray array;
+    array.precision = InferenceEngine::Precision::FP32;
+    array.shape = {1, 2};
+    std::vector<float> values{1.0, 2.0};
+    array.data.assign(reinterpret_cast<const char*>(values.data()), reinterpret_cast<const char*>(values.data()) + sizeof(float) * values.size());
+    tensorflow::TensorProto proto;
+    ovms::npyArrayToTensorProto(array, proto);
+    EXPECT_EQ(proto.dtype(), tensorflow::DataType::DT_FLOAT);
+    ASSERT_EQ(proto.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(proto.tensor_shape().dim(1).size(), 2);
+    EXPECT_EQ(proto.tensor_content(), std::string(array.data.begin(), array.data.end()));
+
+    NpyArray converted;
+    ASSERT_EQ(ovms::tensorProtoToNpyArray(proto, converted), StatusCode::OK);
+    EXPECT_EQ(converted.precision, InferenceEngine::Precision::FP32);
+    EXPECT_EQ(converted.shape, array.shape);
+    EXPECT_EQ(converted.data, array.data);
+}
+
+TEST(OfflineBatch, HalfValuesConvertedToNativeWidth) {
+    NpyArray array;
+    array.precision = InferenceEngine::Precision::FP16;
+    array.shape = {3};
+    std::vector<uint16_t> values{1, 2, 3};
+    array.data.assign(reinterpret_cast<const char*>(values.data()), reinterpret_cast<const char*>(values.data()) + sizeof(uint16_t) * values.size());
+    tensorflow::TensorProto proto;
+    ovms::npyArrayToTensorProto(array, proto);
+    EXPECT_EQ(proto.half_val_size(), 3);
+    EXPECT_TRUE(proto.tensor_content().empty());
+
+    NpyArray converted;
+    ASSERT_EQ(ovms::tensorProtoToNpyArray(proto, converted), StatusCode::OK);
+    EXPECT_EQ(converted.precision, InferenceEngine::Precision::FP16);
+    EXPECT_EQ(converted.data, array.data);
+}
+
+TEST(OfflineBatch, RejectsOutputWithoutNpyType) {
+    tensorflow::TensorProto proto;
+    proto.set_dtype(tensorflow::DataType::DT_STRING);
+    NpyArray converted;
+    EXPECT_EQ(ovms::tensorProtoToNpyArray(proto, converted), StatusCode::INVALID_PRECISION);
+}
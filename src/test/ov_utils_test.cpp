@@ -14,6 +14,10 @@
 // limitations under the License.
 //*****************************************************************************
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -62,3 +66,45 @@ TEST(OVUtils, CopyBlob) {
     // Expect memory addresses to differ since cloning should allocate new memory space for the cloned blob
     EXPECT_NE((float*)copyBlob->buffer(), (float*)originalBlob->buffer());
 }
+
+TEST(OVUtils, WaitForInferRequestWithSpin) {
+    InferenceEngine::Core engine;
+    InferenceEngine::ExecutableNetwork network = engine.LoadNetwork(
+        engine.ReadNetwork(std::filesystem::current_path().u8string() + "/src/test/dummy/1/dummy.xml"), "CPU");
+    InferenceEngine::InferRequest inferRequest = network.CreateInferRequest();
+    for (auto spinTime : {std::chrono::microseconds(0), std::chrono::microseconds(1), std::chrono::microseconds(1000000)}) {
+        inferRequest.StartAsync();
+        EXPECT_EQ(ovms::waitForInferRequest(inferRequest, spinTime), InferenceEngine::StatusCode::OK);
+    }
+}
+
+TEST(OVUtils, ExternalMemoryBlobKeepsOwnerAlive) {
+    auto owner = std::make_shared<std::vector<int32_t>>(std::vector<int32_t>{1, 2, 3, 4});
+    std::weak_ptr<std::vector<int32_t>> released = owner;
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::I32, {2, 2}, InferenceEngine::Layout::NC};
+    auto blob = ovms::createExternalMemoryBlob(desc, owner, reinterpret_cast<const char*>(owner->data()));
+    ASSERT_NE(blob, nullptr);
+    const int32_t* data = owner->data();
+    owner.reset();
+    EXPECT_FALSE(released.expired());
+    // blob points at memory of the owner without copy
+    EXPECT_EQ(blob->cbuffer().as<const int32_t*>(), data);
+    EXPECT_THAT(std::vector<int32_t>(data, data + 4), ElementsAre(1, 2, 3, 4));
+    blob.reset();
+    EXPECT_TRUE(released.expired());
+}
+
+TEST(OVUtils, ExternalMemoryBlobUsesNativeWidthOfHalfPrecision) {
+    auto owner = std::make_shared<std::vector<uint16_t>>(std::vector<uint16_t>{0x3c00, 0x4000});
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP16, {2}, InferenceEngine::Layout::C};
+    auto blob = ovms::createExternalMemoryBlob(desc, owner, reinterpret_cast<const char*>(owner->data()));
+    ASSERT_NE(blob, nullptr);
+    EXPECT_EQ(blob->byteSize(), 2 * sizeof(uint16_t));
+    EXPECT_EQ(blob->cbuffer().as<const uint16_t*>(), owner->data());
+}
+
+TEST(OVUtils, ExternalMemoryBlobOfUnsupportedPrecisionIsNotCreated) {
+    auto owner = std::make_shared<std::vector<char>>(8);
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::BOOL, {8}, InferenceEngine::Layout::C};
+    EXPECT_EQ(ovms::createExternalMemoryBlob(desc, owner, owner->data()), nullptr);
+}
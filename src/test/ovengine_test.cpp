@@ -0,0 +1,34 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../ovengine.hpp"
+
+using ovms::getTargetDevicePlugins;
+
+TEST(OVEngine, TargetDevicePluginsOfSingleDevice) {
+    EXPECT_EQ(getTargetDevicePlugins("CPU"), (std::set<std::string>{"CPU"}));
+    EXPECT_EQ(getTargetDevicePlugins("GPU.1"), (std::set<std::string>{"GPU"}));
+}
+
+TEST(OVEngine, TargetDevicePluginsOfMultiAndHeteroDevices) {
+    EXPECT_EQ(getTargetDevicePlugins("MULTI:GPU.0(4),GPU.1(4),CPU"), (std::set<std::string>{"MULTI", "GPU", "CPU"}));
+    EXPECT_EQ(getTargetDevicePlugins("HETERO:MYRIAD,CPU"), (std::set<std::string>{"HETERO", "MYRIAD", "CPU"}));
+    EXPECT_EQ(getTargetDevicePlugins("MULTI"), (std::set<std::string>{"MULTI"}));
+}
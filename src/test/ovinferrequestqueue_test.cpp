@@ -14,6 +14,7 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
 #include <chrono>
 #include <filesystem>
 #include <random>
@@ -22,7 +23,11 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <sched.h>
 
+#include "../cpuaffinity.hpp"
+#include "../executinstreamidguard.hpp"
+#include "../nodestreamidguard.hpp"
 #include "../ovinferrequestsqueue.hpp"
 #define DEBUG
 #include "../timer.hpp"
@@ -127,3 +132,411 @@ TEST(OVInferRequestQueue, AsyncGetInferRequest) {
     const int secondStreamId = secondStreamRequest.get();
     EXPECT_EQ(firstStreamId, secondStreamId);
 }
+
+TEST(OVInferRequestQueue, TryGetIdleStreamDoesNotBlockWhenEmpty) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 2);
+
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::optional<int>(0));
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::optional<int>(1));
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::nullopt);
+    inferRequestsQueue.returnStream(1);
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::optional<int>(1));
+}
+
+TEST(OVInferRequestQueue, WaitersAreServedInOrderAndCanBeCancelled) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+
+    ovms::BlockingIdleStreamWaiter firstWaiter, cancelledWaiter, secondWaiter;
+    inferRequestsQueue.waitForIdleStream(firstWaiter);
+    inferRequestsQueue.waitForIdleStream(cancelledWaiter);
+    inferRequestsQueue.waitForIdleStream(secondWaiter);
+    EXPECT_EQ(firstWaiter.waitFor(std::chrono::microseconds(1)), std::nullopt);
+    EXPECT_TRUE(inferRequestsQueue.cancelWaiting(cancelledWaiter));
+
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(firstWaiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(streamId));
+    EXPECT_FALSE(inferRequestsQueue.cancelWaiting(firstWaiter));
+    EXPECT_EQ(secondWaiter.waitFor(std::chrono::microseconds(1)), std::nullopt);
+
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(secondWaiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(streamId));
+    EXPECT_EQ(cancelledWaiter.waitFor(std::chrono::microseconds(1)), std::nullopt);
+}
+
+TEST(OVInferRequestQueue, NodeStreamIdGuardDisarmedBeforeStreamAssigned) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+    {
+        ovms::NodeStreamIdGuard guard(inferRequestsQueue);
+        EXPECT_EQ(guard.tryGetId(), std::nullopt);
+        EXPECT_TRUE(guard.tryDisarm());
+    }
+    inferRequestsQueue.returnStream(streamId);
+    // stream must not be consumed by disarmed guard
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::optional<int>(streamId));
+}
+
+TEST(OVInferRequestQueue, NodeStreamIdGuardNotifiesWhenStreamReturned) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+    int notificationsCount = 0;
+    {
+        ovms::NodeStreamIdGuard guard(inferRequestsQueue, [&notificationsCount]() { notificationsCount++; });
+        EXPECT_EQ(guard.tryGetId(0), std::nullopt);
+        inferRequestsQueue.returnStream(streamId);
+        // stream assigned before notification was armed
+        EXPECT_EQ(notificationsCount, 0);
+        EXPECT_FALSE(guard.notifyWhenAssigned());
+        EXPECT_EQ(guard.tryGetId(0), std::optional<int>(streamId));
+    }
+    EXPECT_EQ(inferRequestsQueue.waitForIdleStream(), streamId);
+    {
+        ovms::NodeStreamIdGuard guard(inferRequestsQueue, [&notificationsCount]() { notificationsCount++; });
+        EXPECT_TRUE(guard.notifyWhenAssigned());
+        inferRequestsQueue.returnStream(streamId);
+        EXPECT_EQ(notificationsCount, 1);
+        EXPECT_EQ(guard.tryGetId(0), std::optional<int>(streamId));
+    }
+}
+
+TEST(OVInferRequestQueue, MultiThreadWaitForIdleStream) {
+    const int nireq = 4;
+    const int numberOfClients = 32;
+    const int iterations = 1000;
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, nireq);
+
+    std::vector<std::atomic<int>> usage(nireq);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < numberOfClients; ++i) {
+        clients.emplace_back([&inferRequestsQueue, &usage]() {
+            for (int j = 0; j < iterations; ++j) {
+                int streamId = inferRequestsQueue.waitForIdleStream();
+                EXPECT_EQ(usage[streamId].fetch_add(1), 0);
+                usage[streamId].fetch_sub(1);
+                inferRequestsQueue.returnStream(streamId);
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    for (int i = 0; i < nireq; ++i) {
+        EXPECT_TRUE(inferRequestsQueue.tryGetIdleStream().has_value());
+    }
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::nullopt);
+}
+
+TEST(OVInferRequestQueue, StreamsOfFasterDeviceArePreferred) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork firstNetwork = engine.LoadNetwork(network, "CPU");
+    InferenceEngine::ExecutableNetwork secondNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue({{&firstNetwork, 2}, {&secondNetwork, 2}});
+    ASSERT_EQ(inferRequestsQueue.size(), 4);
+    ASSERT_EQ(inferRequestsQueue.getDevicesCount(), 2);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(1), 0);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(2), 1);
+
+    // first device holds its stream longer
+    int slowStream = inferRequestsQueue.waitForIdleStream();
+    ASSERT_EQ(inferRequestsQueue.getStreamDevice(slowStream), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    inferRequestsQueue.returnStream(slowStream);
+    int fastStream = inferRequestsQueue.waitForIdleStream();
+    ASSERT_EQ(inferRequestsQueue.getStreamDevice(fastStream), 1);
+    inferRequestsQueue.returnStream(fastStream);
+    EXPECT_GT(inferRequestsQueue.getDeviceLatencyEstimate(0), inferRequestsQueue.getDeviceLatencyEstimate(1));
+
+    // faster device is used while it has idle streams, slower one only when it has not
+    std::vector<int> streams;
+    for (int i = 0; i < 4; i++) {
+        streams.push_back(inferRequestsQueue.waitForIdleStream());
+    }
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[0]), 1);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[1]), 1);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[2]), 0);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[3]), 0);
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream().has_value());
+}
+
+TEST(OVInferRequestQueue, StreamsOfDeviceLocalToCallingThreadArePreferred) {
+    cpu_set_t allowedCpus;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus), 0);
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE && cpus.size() < 2; cpu++) {
+        if (CPU_ISSET(cpu, &allowedCpus)) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.size() < 2) {
+        GTEST_SKIP() << "Requires at least 2 CPUs";
+    }
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork firstNetwork = engine.LoadNetwork(network, "CPU");
+    InferenceEngine::ExecutableNetwork secondNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue({{&firstNetwork, 2}, {&secondNetwork, 2}}, {{cpus[0]}, {cpus[1]}});
+
+    ovms::CpuAffinityGuard guard({cpus[1]});
+    std::vector<int> streams;
+    for (int i = 0; i < 4; i++) {
+        auto stream = inferRequestsQueue.tryGetIdleStream();
+        ASSERT_TRUE(stream.has_value());
+        streams.push_back(stream.value());
+    }
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[0]), 1);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[1]), 1);
+    // streams of the other device are taken once local ones are busy
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[2]), 0);
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(streams[3]), 0);
+    for (auto stream : streams) {
+        inferRequestsQueue.returnStream(stream);
+    }
+    ovms::CpuAffinityGuard otherGuard({cpus[0]});
+    auto stream = inferRequestsQueue.tryGetIdleStream();
+    ASSERT_TRUE(stream.has_value());
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(stream.value()), 0);
+}
+
+TEST(OVInferRequestQueue, WaitersOfHigherPriorityAreServedFirst) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+
+    ovms::BlockingIdleStreamWaiter lowWaiter, normalWaiter, highWaiter;
+    lowWaiter.setOptions({ovms::RequestPriority::LOW});
+    highWaiter.setOptions({ovms::RequestPriority::HIGH});
+    ASSERT_TRUE(inferRequestsQueue.waitForIdleStream(lowWaiter));
+    ASSERT_TRUE(inferRequestsQueue.waitForIdleStream(normalWaiter));
+    ASSERT_TRUE(inferRequestsQueue.waitForIdleStream(highWaiter));
+
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(highWaiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(streamId));
+    EXPECT_EQ(normalWaiter.waitFor(std::chrono::microseconds(1)), std::nullopt);
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(normalWaiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(streamId));
+    EXPECT_EQ(lowWaiter.waitFor(std::chrono::microseconds(1)), std::nullopt);
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(lowWaiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(streamId));
+}
+
+TEST(OVInferRequestQueue, WaitersAboveMaxQueueSizeAreRejected) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+
+    const auto noDeadline = std::chrono::steady_clock::time_point::max();
+    ovms::BlockingIdleStreamWaiter firstWaiter, rejectedWaiter, highWaiter;
+    firstWaiter.setOptions({ovms::RequestPriority::NORMAL, noDeadline, 1});
+    rejectedWaiter.setOptions({ovms::RequestPriority::NORMAL, noDeadline, 1});
+    highWaiter.setOptions({ovms::RequestPriority::HIGH, noDeadline, 1});
+    EXPECT_TRUE(inferRequestsQueue.waitForIdleStream(firstWaiter));
+    EXPECT_FALSE(inferRequestsQueue.waitForIdleStream(rejectedWaiter));
+    // waiters of lower priority are not counted since they are served later
+    EXPECT_TRUE(inferRequestsQueue.waitForIdleStream(highWaiter));
+    EXPECT_EQ(inferRequestsQueue.getWaitersCount(), 2);
+    EXPECT_FALSE(inferRequestsQueue.cancelWaiting(rejectedWaiter));
+    EXPECT_TRUE(inferRequestsQueue.cancelWaiting(firstWaiter));
+    EXPECT_TRUE(inferRequestsQueue.cancelWaiting(highWaiter));
+    inferRequestsQueue.returnStream(streamId);
+}
+
+TEST(OVInferRequestQueue, WaitersPastDeadlineAreDropped) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+
+    ovms::BlockingIdleStreamWaiter expiredWaiter, waiter;
+    expiredWaiter.setOptions({ovms::RequestPriority::NORMAL, std::chrono::steady_clock::now() + std::chrono::milliseconds(10)});
+    ASSERT_TRUE(inferRequestsQueue.waitForIdleStream(expiredWaiter));
+    ASSERT_TRUE(inferRequestsQueue.waitForIdleStream(waiter));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(expiredWaiter.waitUntil(std::chrono::steady_clock::time_point::max()), std::nullopt);
+    EXPECT_EQ(waiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(streamId));
+}
+
+TEST(OVInferRequestQueue, CancelledWaitersAreDropped) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+
+    std::atomic<bool> cancelled{false};
+    ovms::StreamWaitingOptions options;
+    options.cancelled = &cancelled;
+    ovms::Status status;
+    std::thread guardThread([&inferRequestsQueue, &options, &status]() {
+        ovms::ExecutingStreamIdGuard guard(inferRequestsQueue, options);
+        status = guard.getStatus();
+    });
+    while (inferRequestsQueue.getWaitersCount() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    cancelled = true;
+    inferRequestsQueue.returnStream(streamId);
+    guardThread.join();
+    EXPECT_EQ(status, ovms::StatusCode::REQUEST_CANCELLED);
+    EXPECT_EQ(inferRequestsQueue.getWaitersCount(), 0);
+    EXPECT_EQ(inferRequestsQueue.tryGetIdleStream(), std::optional<int>(streamId));
+}
+
+TEST(OVInferRequestQueue, ExecutingStreamIdGuardRejectsRequestAfterQueueTimeout) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1);
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+
+    ovms::StreamWaitingOptions options;
+    options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    {
+        ovms::ExecutingStreamIdGuard guard(inferRequestsQueue, options);
+        EXPECT_EQ(guard.getStatus(), ovms::StatusCode::INFER_REQUESTS_QUEUE_TIMEOUT);
+    }
+    EXPECT_EQ(inferRequestsQueue.getWaitersCount(), 0);
+    inferRequestsQueue.returnStream(streamId);
+    {
+        ovms::ExecutingStreamIdGuard guard(inferRequestsQueue, options);
+        EXPECT_EQ(guard.getStatus(), ovms::StatusCode::OK);
+        EXPECT_EQ(guard.getId(), streamId);
+    }
+}
+
+TEST(OVInferRequestQueue, AdaptivePoolGrowsWhenRequestsWait) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1, 2);
+    EXPECT_EQ(inferRequestsQueue.size(), 1);
+    EXPECT_EQ(inferRequestsQueue.getMaxSize(), 2);
+    // pool is not adjusted right after creation
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+    std::thread returningThread([&inferRequestsQueue, streamId]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        inferRequestsQueue.returnStream(streamId);
+    });
+    EXPECT_EQ(inferRequestsQueue.waitForIdleStream(), streamId);
+    returningThread.join();
+    EXPECT_EQ(inferRequestsQueue.size(), 1);
+
+    // request waited longer than threshold, so next waiting one gets new infer request
+    EXPECT_EQ(inferRequestsQueue.waitForIdleStream(), 1);
+    EXPECT_EQ(inferRequestsQueue.size(), 2);
+    inferRequestsQueue.returnStream(1);
+    inferRequestsQueue.returnStream(streamId);
+    EXPECT_EQ(inferRequestsQueue.getIdleStreamsCount(), 2);
+}
+
+TEST(OVInferRequestQueue, InitializerAppliedToCreatedAndAddedInferRequests) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue(execNetwork, 1, 2);
+    std::atomic<int> initializedCount{0};
+    inferRequestsQueue.setInferRequestInitializer([&initializedCount](InferenceEngine::InferRequest&) { initializedCount++; });
+    EXPECT_EQ(initializedCount, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    const int streamId = inferRequestsQueue.waitForIdleStream();
+    std::thread returningThread([&inferRequestsQueue, streamId]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        inferRequestsQueue.returnStream(streamId);
+    });
+    EXPECT_EQ(inferRequestsQueue.waitForIdleStream(), streamId);
+    returningThread.join();
+    EXPECT_EQ(inferRequestsQueue.waitForIdleStream(), 1);
+    EXPECT_EQ(initializedCount, 2);
+    inferRequestsQueue.returnStream(1);
+    inferRequestsQueue.returnStream(streamId);
+}
+
+TEST(OVInferRequestQueue, DeviceLimiterCapsStreamsOfPoolsSharingDevice) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork execNetwork = engine.LoadNetwork(network, "CPU");
+    auto limiter = std::make_shared<ovms::DeviceConcurrencyLimiter>("CPU", 2);
+    ovms::OVInferRequestsQueue firstQueue(execNetwork, 2);
+    ovms::OVInferRequestsQueue secondQueue(execNetwork, 2);
+    firstQueue.setDeviceLimiter(limiter, 1);
+    secondQueue.setDeviceLimiter(limiter, 1);
+
+    const int firstStreamId = firstQueue.waitForIdleStream();
+    const int secondStreamId = firstQueue.waitForIdleStream();
+    EXPECT_EQ(limiter->getInFlight(), 2);
+    // second pool has idle streams but device is saturated
+    EXPECT_EQ(secondQueue.tryGetIdleStream(), std::nullopt);
+    ovms::BlockingIdleStreamWaiter waiter;
+    secondQueue.waitForIdleStream(waiter);
+    EXPECT_EQ(waiter.waitFor(std::chrono::microseconds(1)), std::nullopt);
+
+    firstQueue.returnStream(firstStreamId);
+    EXPECT_EQ(waiter.waitFor(std::chrono::microseconds(1)), std::optional<int>(0));
+    EXPECT_EQ(limiter->getInFlight(), 2);
+    EXPECT_EQ(firstQueue.tryGetIdleStream(), std::nullopt);
+
+    secondQueue.returnStream(0);
+    firstQueue.returnStream(secondStreamId);
+    EXPECT_EQ(limiter->getInFlight(), 0);
+    EXPECT_EQ(firstQueue.getIdleStreamsCount(), 2);
+    EXPECT_EQ(secondQueue.getIdleStreamsCount(), 2);
+}
+
+TEST(OVInferRequestQueue, LatencyNetworkStreamsAreSelectedByPriority) {
+    InferenceEngine::Core engine;
+    InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+    InferenceEngine::ExecutableNetwork throughputNetwork = engine.LoadNetwork(network, "CPU");
+    InferenceEngine::ExecutableNetwork latencyNetwork = engine.LoadNetwork(network, "CPU");
+    ovms::OVInferRequestsQueue inferRequestsQueue({{&throughputNetwork, 2}, {&latencyNetwork, 1}});
+    inferRequestsQueue.setLatencyDevice(1);
+
+    auto highStream = inferRequestsQueue.tryGetIdleStream(ovms::RequestPriority::HIGH);
+    ASSERT_TRUE(highStream.has_value());
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(highStream.value()), 1);
+    // high priority falls back to throughput streams when latency ones are busy
+    auto highFallbackStream = inferRequestsQueue.tryGetIdleStream(ovms::RequestPriority::HIGH);
+    ASSERT_TRUE(highFallbackStream.has_value());
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(highFallbackStream.value()), 0);
+    inferRequestsQueue.returnStream(highStream.value());
+    inferRequestsQueue.returnStream(highFallbackStream.value());
+
+    std::vector<int> lowStreams;
+    for (int i = 0; i < 2; i++) {
+        auto stream = inferRequestsQueue.tryGetIdleStream(ovms::RequestPriority::LOW);
+        ASSERT_TRUE(stream.has_value());
+        EXPECT_EQ(inferRequestsQueue.getStreamDevice(stream.value()), 0);
+        lowStreams.push_back(stream.value());
+    }
+    // low priority never takes latency streams
+    EXPECT_FALSE(inferRequestsQueue.tryGetIdleStream(ovms::RequestPriority::LOW).has_value());
+    // normal priority overflows to them once throughput streams are busy
+    auto normalStream = inferRequestsQueue.tryGetIdleStream(ovms::RequestPriority::NORMAL);
+    ASSERT_TRUE(normalStream.has_value());
+    EXPECT_EQ(inferRequestsQueue.getStreamDevice(normalStream.value()), 1);
+}
@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../paralleltasks.hpp"
+
+TEST(ParallelTasks, AllTasksExecutedOnce) {
+    const size_t numberOfTasks = 20;
+    std::vector<std::atomic<int>> executions(numberOfTasks);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < numberOfTasks; i++) {
+        tasks.emplace_back([&executions, i]() { executions[i]++; });
+    }
+    ovms::executeInParallel(tasks, 4);
+    for (size_t i = 0; i < numberOfTasks; i++) {
+        EXPECT_EQ(executions[i], 1) << "task: " << i;
+    }
+}
+
+TEST(ParallelTasks, ConcurrencyBounded) {
+    const size_t maxThreads = 3;
+    std::atomic<size_t> running = 0;
+    std::atomic<size_t> maxRunning = 0;
+    std::vector<std::function<void()>> tasks(10, [&running, &maxRunning]() {
+        size_t current = ++running;
+        size_t previousMax = maxRunning;
+        while (current > previousMax && !maxRunning.compare_exchange_weak(previousMax, current)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        running--;
+    });
+    ovms::executeInParallel(tasks, maxThreads);
+    EXPECT_LE(maxRunning, maxThreads);
+    EXPECT_GT(maxRunning, 1);
+}
+
+TEST(ParallelTasks, SingleThreadExecutesInOrderOnCallingThread) {
+    std::vector<size_t> order;
+    std::vector<std::function<void()>> tasks;
+    const auto callingThread = std::this_thread::get_id();
+    for (size_t i = 0; i < 5; i++) {
+        tasks.emplace_back([&order, i, callingThread]() {
+            EXPECT_EQ(std::this_thread::get_id(), callingThread);
+            order.push_back(i);
+        });
+    }
+    ovms::executeInParallel(tasks, 1);
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
@@ -0,0 +1,95 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow/core/framework/tensor.h"
+#pragma GCC diagnostic pop
+
+#include "../precisionconversion.hpp"
+#include "../tensorinfo.hpp"
+
+using namespace ovms;
+using InferenceEngine::Precision;
+
+TEST(PrecisionConversion, ResolvesDataTypeOfEachPrecision) {
+    EXPECT_EQ(getPrecisionConversion(Precision::FP32).dtype, tensorflow::DataType::DT_FLOAT);
+    EXPECT_EQ(getPrecisionConversion(Precision::FP16).dtype, tensorflow::DataType::DT_HALF);
+    EXPECT_EQ(getPrecisionConversion(Precision::U8).dtype, tensorflow::DataType::DT_UINT8);
+    EXPECT_EQ(getPrecisionConversion(Precision::I8).dtype, tensorflow::DataType::DT_INT8);
+    EXPECT_EQ(getPrecisionConversion(Precision::U16).dtype, tensorflow::DataType::DT_UINT16);
+    EXPECT_EQ(getPrecisionConversion(Precision::I16).dtype, tensorflow::DataType::DT_INT16);
+    EXPECT_EQ(getPrecisionConversion(Precision::I32).dtype, tensorflow::DataType::DT_INT32);
+    EXPECT_EQ(getPrecisionConversion(Precision::I64).dtype, tensorflow::DataType::DT_INT64);
+    EXPECT_EQ(getPrecisionConversion(Precision::U64).dtype, tensorflow::DataType::DT_UINT64);
+    EXPECT_EQ(getPrecisionConversion(Precision::BOOL).dtype, tensorflow::DataType::DT_BOOL);
+    EXPECT_EQ(getPrecisionConversion(Precision::Q78).dtype, tensorflow::DataType::DT_INVALID);
+    EXPECT_EQ(getPrecisionConversion(Precision::UNSPECIFIED).dtype, tensorflow::DataType::DT_INVALID);
+}
+
+TEST(PrecisionConversion, ResolvesPrecisionOfEachDataType) {
+    for (const auto& conversion : PRECISION_CONVERSIONS) {
+        EXPECT_EQ(&getDataTypeConversion(conversion.dtype), &conversion);
+        EXPECT_EQ(&getPrecisionConversion(conversion.precision), &conversion);
+    }
+    EXPECT_EQ(&getDataTypeConversion(tensorflow::DataType::DT_STRING), &UNSUPPORTED_PRECISION_CONVERSION);
+}
+
+TEST(PrecisionConversion, DeserializesFromFieldOfRequest) {
+    EXPECT_EQ(getPrecisionConversion(Precision::FP32).requestField, TensorProtoField::TENSOR_CONTENT);
+    EXPECT_EQ(getPrecisionConversion(Precision::FP16).requestField, TensorProtoField::HALF_VAL);
+    EXPECT_EQ(getPrecisionConversion(Precision::U16).requestField, TensorProtoField::INT_VAL);
+    EXPECT_EQ(getPrecisionConversion(Precision::I32).requestField, TensorProtoField::TENSOR_CONTENT);
+    EXPECT_FALSE(getPrecisionConversion(Precision::I64).isDeserializable());
+    EXPECT_TRUE(getPrecisionConversion(Precision::I64).nativeContent);
+    EXPECT_FALSE(getPrecisionConversion(Precision::BOOL).isDeserializable());
+    EXPECT_FALSE(getPrecisionConversion(Precision::BOOL).nativeContent);
+}
+
+TEST(PrecisionConversion, NarrowsZeroPaddedValues) {
+    tensorflow::TensorProto proto;
+    proto.add_half_val(0x3C00);
+    proto.add_half_val(0xC000);
+    const auto& fp16 = getPrecisionConversion(Precision::FP16);
+    ASSERT_EQ(fp16.countValues(proto), 2);
+    std::vector<uint16_t> halfs(2);
+    fp16.copyValues(proto, halfs.data());
+    EXPECT_EQ(halfs, (std::vector<uint16_t>{0x3C00, 0xC000}));
+
+    proto.add_int_val(65535);
+    proto.add_int_val(1);
+    proto.add_int_val(7);
+    const auto& u16 = getPrecisionConversion(Precision::U16);
+    ASSERT_EQ(u16.countValues(proto), 3);
+    std::vector<uint16_t> values(3);
+    u16.copyValues(proto, values.data());
+    EXPECT_EQ(values, (std::vector<uint16_t>{65535, 1, 7}));
+}
+
+TEST(PrecisionConversion, IsCachedInTensorInfo) {
+    TensorInfo info("input", Precision::FP16, shape_t{1, 10});
+    EXPECT_EQ(&info.getPrecisionConversion(), &getPrecisionConversion(Precision::FP16));
+    EXPECT_EQ(info.getPrecisionAsDataType(), tensorflow::DataType::DT_HALF);
+    info.setPrecision(Precision::I32);
+    EXPECT_EQ(&info.getPrecisionConversion(), &getPrecisionConversion(Precision::I32));
+    EXPECT_EQ(info.getPrecisionAsDataType(), tensorflow::DataType::DT_INT32);
+    EXPECT_EQ(TensorInfo().getPrecisionAsDataType(), tensorflow::DataType::DT_INVALID);
+}
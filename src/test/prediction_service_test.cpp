@@ -247,6 +247,18 @@ TEST_F(TestPredict, SuccesfullOnDummyModel) {
     performPredict(config.getName(), config.getVersion(), request);
 }
 
+TEST_F(TestPredict, SuccesfullInlineInferenceOnDummyModel) {
+    ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+    config.setInlineInference(true);
+    ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+
+    tensorflow::serving::PredictResponse response;
+    ASSERT_EQ(performInferenceWithShape(response), ovms::StatusCode::OK);
+    checkOutputShape(response, {1, 10});
+    const auto& output = response.outputs().at("a");
+    EXPECT_EQ(output.tensor_content().size(), DUMMY_MODEL_OUTPUT_SIZE * sizeof(float));
+}
+
 TEST_F(TestPredict, SuccesfullReloadFromAlreadyLoadedWithNewBatchSize) {
     tensorflow::serving::PredictRequest request = preparePredictRequest(
         {{DUMMY_MODEL_INPUT_NAME,
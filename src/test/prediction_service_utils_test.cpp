@@ -14,8 +14,12 @@
 // limitations under the License.
 //*****************************************************************************
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <thread>
+#include <tuple>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -220,3 +224,69 @@ TEST_F(ModelInstanceModelLoadedNotify, WhenChangedStateFromLoadingToAvailableInR
     spdlog::error("State:{}", (int)modelInstance->getStatus().getState());
     EXPECT_EQ(status, ovms::StatusCode::MODEL_VERSION_NOT_LOADED_YET);
 }
+
+class InferenceAsyncTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        config = DUMMY_MODEL_CONFIG;
+        ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+    }
+
+    static tensorflow::serving::PredictRequest prepareRequest(float value) {
+        tensorflow::serving::PredictRequest request;
+        auto& input = (*request.mutable_inputs())[DUMMY_MODEL_INPUT_NAME];
+        input.set_dtype(tensorflow::DataType::DT_FLOAT);
+        input.mutable_tensor_shape()->add_dim()->set_size(1);
+        input.mutable_tensor_shape()->add_dim()->set_size(DUMMY_MODEL_INPUT_SIZE);
+        std::vector<float> data(DUMMY_MODEL_INPUT_SIZE, value);
+        input.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+        return request;
+    }
+
+    std::future<ovms::Status> startInference(const tensorflow::serving::PredictRequest& request, tensorflow::serving::PredictResponse& response) {
+        auto promise = std::make_shared<std::promise<ovms::Status>>();
+        auto future = promise->get_future();
+        std::shared_ptr<ovms::ModelInstance> modelInstance;
+        std::unique_ptr<ovms::ModelInstanceUnloadGuard> unloadGuard;
+        auto status = ovms::getModelInstance(manager, config.getName(), 0, modelInstance, unloadGuard);
+        if (!status.ok()) {
+            promise->set_value(status);
+            return future;
+        }
+        ovms::inferenceAsync(std::move(modelInstance), &request, &response, std::move(unloadGuard),
+            [](std::function<void()> continuation) { std::thread(std::move(continuation)).detach(); },
+            [promise](const ovms::Status& status) { promise->set_value(status); });
+        return future;
+    }
+
+    ConstructorEnabledModelManager manager;
+    ovms::ModelConfig config;
+};
+
+TEST_F(InferenceAsyncTest, ConcurrentRequestsExceedingNireqComplete) {
+    const size_t numberOfRequests = 4 * config.getNireq() + 1;
+    std::vector<tensorflow::serving::PredictRequest> requests;
+    std::vector<tensorflow::serving::PredictResponse> responses(numberOfRequests);
+    std::vector<std::future<ovms::Status>> futures;
+    for (size_t i = 0; i < numberOfRequests; i++) {
+        requests.push_back(prepareRequest(static_cast<float>(i)));
+    }
+    for (size_t i = 0; i < numberOfRequests; i++) {
+        futures.push_back(startInference(requests[i], responses[i]));
+    }
+    for (size_t i = 0; i < numberOfRequests; i++) {
+        ASSERT_EQ(futures[i].get(), ovms::StatusCode::OK) << "request: " << i;
+        ASSERT_EQ(responses[i].outputs().count(DUMMY_MODEL_OUTPUT_NAME), 1);
+        auto values = asVector<float>(responses[i].outputs().at(DUMMY_MODEL_OUTPUT_NAME).tensor_content());
+        EXPECT_THAT(values, ::testing::Each(::testing::Eq(static_cast<float>(i) + 1))) << "request: " << i;
+    }
+}
+
+TEST_F(InferenceAsyncTest, ValidationErrorReportedInCompletion) {
+    tensorflow::serving::PredictRequest request = preparePredictRequest(
+        {{DUMMY_MODEL_INPUT_NAME,
+            std::tuple<ovms::shape_t, tensorflow::DataType>{{1, DUMMY_MODEL_INPUT_SIZE + 1}, tensorflow::DataType::DT_FLOAT}}});
+    tensorflow::serving::PredictResponse response;
+    EXPECT_EQ(startInference(request, response).get(), ovms::StatusCode::INVALID_SHAPE);
+    EXPECT_EQ(response.outputs_size(), 0);
+}
@@ -0,0 +1,209 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+
+#include "../modelconfig.hpp"
+#include "../modelmanager.hpp"
+#include "../modelversionstatus.hpp"
+#include "../prediction_service.hpp"
+#include "../status.hpp"
+#include "test_utils.hpp"
+
+using ovms::ModelStatusWatchService;
+using ovms::PredictionStreamService;
+using ovms::StatusCode;
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace {
+const char* STREAM_MODEL_NAME = "stream_dummy";
+
+class PredictStreamTest : public ::testing::Test {
+protected:
+    ovms::PredictionServiceImpl service;
+    std::unique_ptr<grpc::Server> server;
+    std::unique_ptr<PredictionStreamService::Stub> stub;
+    std::shared_ptr<grpc::Channel> channel;
+
+    void SetUp() override {
+        ovms::ModelConfig config = DUMMY_MODEL_CONFIG;
+        config.setName(STREAM_MODEL_NAME);
+        // several requests of the stream are inferred at once, responses still have to be written in order
+        config.setNireq(4);
+        ASSERT_EQ(ovms::ModelManager::getInstance().reloadModelWithVersions(config), StatusCode::OK);
+
+        int port = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&service);
+        builder.RegisterService(&service.getStreamService());
+        builder.RegisterService(&service.getStatusWatchService());
+        service.addCompletionQueue(builder);
+        server = builder.BuildAndStart();
+        ASSERT_NE(port, 0);
+        service.startHandlingPredictCalls();
+        channel = grpc::CreateChannel("localhost:" + std::to_string(port), grpc::InsecureChannelCredentials());
+        stub = PredictionStreamService::NewStub(channel);
+    }
+
+    void TearDown() override {
+        server->Shutdown();
+        // returns once all calls are finished, so that a stream left unfinished hangs the test
+        service.stopHandlingPredictCalls();
+    }
+
+    static PredictRequest prepareRequest(float value, const std::string& modelName = STREAM_MODEL_NAME) {
+        PredictRequest request;
+        request.mutable_model_spec()->set_name(modelName);
+        auto& input = (*request.mutable_inputs())[DUMMY_MODEL_INPUT_NAME];
+        input.set_dtype(tensorflow::DataType::DT_FLOAT);
+        input.mutable_tensor_shape()->add_dim()->set_size(1);
+        input.mutable_tensor_shape()->add_dim()->set_size(DUMMY_MODEL_INPUT_SIZE);
+        std::vector<float> data(DUMMY_MODEL_INPUT_SIZE, value);
+        input.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+        return request;
+    }
+
+    static float getOutputValue(const PredictResponse& response) {
+        const auto& output = response.outputs().at(DUMMY_MODEL_OUTPUT_NAME);
+        EXPECT_EQ(output.tensor_content().size(), DUMMY_MODEL_OUTPUT_SIZE * sizeof(float));
+        return reinterpret_cast<const float*>(output.tensor_content().data())[0];
+    }
+};
+}  // namespace
+
+TEST_F(PredictStreamTest, ResponsesAreWrittenInOrderOfRequests) {
+    grpc::ClientContext context;
+    auto stream = stub->PredictStream(&context);
+    const int count = 32;
+    for (int i = 0; i < count; i++) {
+        ASSERT_TRUE(stream->Write(prepareRequest(static_cast<float>(i))));
+    }
+    ASSERT_TRUE(stream->WritesDone());
+    PredictResponse response;
+    for (int i = 0; i < count; i++) {
+        ASSERT_TRUE(stream->Read(&response)) << "response: " << i;
+        // dummy model adds 1 to inputs
+        EXPECT_EQ(getOutputValue(response), i + 1);
+    }
+    EXPECT_FALSE(stream->Read(&response));
+    EXPECT_TRUE(stream->Finish().ok());
+}
+
+TEST_F(PredictStreamTest, FailedRequestFinishesStreamAfterResponsesOfEarlierRequests) {
+    grpc::ClientContext context;
+    auto stream = stub->PredictStream(&context);
+    ASSERT_TRUE(stream->Write(prepareRequest(1)));
+    ASSERT_TRUE(stream->Write(prepareRequest(2)));
+    ASSERT_TRUE(stream->Write(prepareRequest(3, "other_model")));
+    // stream may be already failed by the server, requests written after the failed one are not answered
+    stream->Write(prepareRequest(4));
+    stream->WritesDone();
+    PredictResponse response;
+    ASSERT_TRUE(stream->Read(&response));
+    EXPECT_EQ(getOutputValue(response), 2);
+    ASSERT_TRUE(stream->Read(&response));
+    EXPECT_EQ(getOutputValue(response), 3);
+    EXPECT_FALSE(stream->Read(&response));
+    auto status = stream->Finish();
+    EXPECT_EQ(status.error_code(), ovms::Status(StatusCode::STREAM_MODEL_SPEC_MISMATCH).grpc().error_code());
+}
+
+TEST_F(PredictStreamTest, FailedFirstRequestFinishesStreamWithoutResponses) {
+    grpc::ClientContext context;
+    auto stream = stub->PredictStream(&context);
+    ASSERT_TRUE(stream->Write(prepareRequest(1, "not_existing_model")));
+    stream->WritesDone();
+    PredictResponse response;
+    EXPECT_FALSE(stream->Read(&response));
+    auto status = stream->Finish();
+    EXPECT_EQ(status.error_code(), ovms::Status(StatusCode::MODEL_NAME_MISSING).grpc().error_code());
+}
+
+TEST_F(PredictStreamTest, CancelledStreamIsFinishedByServer) {
+    {
+        grpc::ClientContext context;
+        auto stream = stub->PredictStream(&context);
+        for (int i = 0; i < 8; i++) {
+            ASSERT_TRUE(stream->Write(prepareRequest(static_cast<float>(i))));
+        }
+        PredictResponse response;
+        ASSERT_TRUE(stream->Read(&response));
+        EXPECT_EQ(getOutputValue(response), 1);
+        // responses of requests in progress are dropped, client does not wait for them
+        context.TryCancel();
+        EXPECT_EQ(stream->Finish().error_code(), grpc::StatusCode::CANCELLED);
+    }
+    // cancelled stream released model version and infer requests, next stream is served
+    grpc::ClientContext context;
+    auto stream = stub->PredictStream(&context);
+    ASSERT_TRUE(stream->Write(prepareRequest(5)));
+    ASSERT_TRUE(stream->WritesDone());
+    PredictResponse response;
+    ASSERT_TRUE(stream->Read(&response));
+    EXPECT_EQ(getOutputValue(response), 6);
+    EXPECT_FALSE(stream->Read(&response));
+    EXPECT_TRUE(stream->Finish().ok());
+}
+
+TEST_F(PredictStreamTest, IdleStreamDoesNotBlockUnloadingOfModelVersion) {
+    grpc::ClientContext context;
+    auto stream = stub->PredictStream(&context);
+    ASSERT_TRUE(stream->Write(prepareRequest(1)));
+    PredictResponse response;
+    ASSERT_TRUE(stream->Read(&response));
+    EXPECT_EQ(getOutputValue(response), 2);
+    // returns once unload guards are released, so that hangs if the stream holds one
+    ovms::ModelManager::getInstance().findModelByName(STREAM_MODEL_NAME)->retireAllVersions();
+    stream->Write(prepareRequest(2));
+    stream->WritesDone();
+    EXPECT_FALSE(stream->Read(&response));
+    auto status = stream->Finish();
+    EXPECT_EQ(status.error_code(), ovms::Status(StatusCode::MODEL_VERSION_NOT_LOADED_ANYMORE).grpc().error_code());
+}
+
+TEST_F(PredictStreamTest, WatchStatusStreamsTransitionsOfWatchedModels) {
+    auto watchStub = ModelStatusWatchService::NewStub(channel);
+    grpc::ClientContext context;
+    ovms::WatchStatusRequest request;
+    request.add_names("watch_status_model");
+    auto watch = watchStub->WatchStatus(&context, request);
+    ovms::StatusChange change;
+    // stream may be still starting on server, transitions after current states are read are sent in order
+    ovms::ModelVersionStatus status("watch_status_model", 1);
+    status.setLoading();
+    status.setAvailable();
+    // earlier states are sent only if stream started before they were left
+    do {
+        ASSERT_TRUE(watch->Read(&change));
+    } while (change.state() == "START" || change.state() == "LOADING");
+    EXPECT_EQ(change.name(), "watch_status_model");
+    EXPECT_EQ(change.version(), 1);
+    EXPECT_EQ(change.state(), "AVAILABLE");
+    status.setUnloading();
+    ASSERT_TRUE(watch->Read(&change));
+    EXPECT_EQ(change.state(), "UNLOADING");
+    // waiting stream is finished by server once cancelled
+    context.TryCancel();
+    EXPECT_FALSE(watch->Read(&change));
+    EXPECT_EQ(watch->Finish().error_code(), grpc::StatusCode::CANCELLED);
+}
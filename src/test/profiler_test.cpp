@@ -0,0 +1,97 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../profiler.hpp"
+
+using ovms::CpuProfiler;
+using ovms::StatusCode;
+
+namespace {
+uintptr_t readWord(const std::string& profile, size_t index) {
+    uintptr_t word;
+    std::memcpy(&word, profile.data() + index * sizeof(word), sizeof(word));
+    return word;
+}
+}  // namespace
+
+TEST(CpuProfiler, ProfileOfBusyThreadIsInLegacyPprofFormat) {
+    std::atomic<bool> stop{false};
+    std::thread busyThread([&stop]() {
+        volatile uint64_t counter = 0;
+        while (!stop) {
+            counter = counter + 1;
+        }
+    });
+    std::string profile;
+    ASSERT_EQ(CpuProfiler::profile(std::chrono::milliseconds(300), profile, 1000), StatusCode::OK);
+    stop = true;
+    busyThread.join();
+
+    ASSERT_GT(profile.size(), 8 * sizeof(uintptr_t));
+    EXPECT_EQ(readWord(profile, 0), 0);
+    EXPECT_EQ(readWord(profile, 1), 3);
+    EXPECT_EQ(readWord(profile, 2), 0);
+    EXPECT_EQ(readWord(profile, 3), 1000);
+    EXPECT_EQ(readWord(profile, 4), 0);
+    // records of sampled stacks are followed by trailer and memory mappings
+    size_t index = 5;
+    uintptr_t samples = 0;
+    while (readWord(profile, index) != 0) {
+        samples += readWord(profile, index);
+        index += 2 + readWord(profile, index + 1);
+        ASSERT_LT((index + 3) * sizeof(uintptr_t), profile.size());
+    }
+    EXPECT_GT(samples, 0);
+    EXPECT_EQ(readWord(profile, index + 1), 1);
+    EXPECT_EQ(readWord(profile, index + 2), 0);
+    EXPECT_NE(profile.find("r-xp", (index + 3) * sizeof(uintptr_t)), std::string::npos);
+}
+
+TEST(CpuProfiler, ConcurrentProfileIsRejected) {
+    std::string firstProfile;
+    std::thread profilingThread([&firstProfile]() {
+        EXPECT_EQ(CpuProfiler::profile(std::chrono::milliseconds(500), firstProfile), StatusCode::OK);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::string secondProfile;
+    EXPECT_EQ(CpuProfiler::profile(std::chrono::milliseconds(10), secondProfile), StatusCode::PROFILER_BUSY);
+    profilingThread.join();
+}
+
+TEST(HeapStatistics, MallocInfoIsReturned) {
+    std::string statistics;
+    ASSERT_EQ(ovms::getHeapStatistics(statistics), StatusCode::OK);
+    EXPECT_NE(statistics.find("<malloc"), std::string::npos);
+}
+
+TEST(CpuProfiler, DurationIsLimitedBelowRequestTimeout) {
+    std::chrono::milliseconds duration;
+    ASSERT_EQ(CpuProfiler::parseDuration("", std::chrono::milliseconds(2500), duration), StatusCode::OK);
+    EXPECT_EQ(duration, std::chrono::milliseconds(2500));
+    ASSERT_EQ(CpuProfiler::parseDuration("2", std::chrono::milliseconds(2500), duration), StatusCode::OK);
+    EXPECT_EQ(duration, std::chrono::seconds(2));
+    for (const auto& seconds : {"3", "600", "0", "-1", "1s", "99999999999"}) {
+        EXPECT_EQ(CpuProfiler::parseDuration(seconds, std::chrono::milliseconds(2500), duration), StatusCode::REST_INVALID_URL) << seconds;
+    }
+}
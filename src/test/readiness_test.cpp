@@ -0,0 +1,131 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+#include "../metrics.hpp"
+#include "../modelinstance.hpp"
+#include "../readiness.hpp"
+#include "test_utils.hpp"
+
+using ovms::LatencyHistogram;
+using ovms::ReadinessProbe;
+
+TEST(ReadinessProbe, Percentile99FromBuckets) {
+    ReadinessProbe::buckets_t buckets{};
+    EXPECT_EQ(ReadinessProbe::estimatePercentile99(buckets), 0);
+    buckets[0] = 99;
+    buckets[5] = 1;
+    EXPECT_EQ(ReadinessProbe::estimatePercentile99(buckets), LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[0]);
+    buckets[5] = 2;
+    EXPECT_EQ(ReadinessProbe::estimatePercentile99(buckets), LatencyHistogram::BUCKET_BOUNDS_MICROSECONDS[5]);
+    buckets[LatencyHistogram::BUCKETS_COUNT] = 10;
+    EXPECT_EQ(ReadinessProbe::estimatePercentile99(buckets), std::numeric_limits<uint64_t>::max());
+}
+
+class ReadinessProbeTest : public ::testing::Test {
+public:
+    void load(ovms::ModelConfig config) {
+        ASSERT_EQ(manager.reloadModelWithVersions(config), ovms::StatusCode::OK);
+        instance = manager.findModelInstance(config.getName());
+        ASSERT_NE(instance, nullptr);
+    }
+
+    ConstructorEnabledModelManager manager;
+    ReadinessProbe probe;
+    std::shared_ptr<ovms::ModelInstance> instance;
+};
+
+TEST_F(ReadinessProbeTest, ReadyWithoutCriticalModels) {
+    load(DUMMY_MODEL_CONFIG);
+    for (int i = 0; i < 10; i++) {
+        instance->getMetrics().streamWait.observe(10'000'000);
+    }
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+}
+
+TEST_F(ReadinessProbeTest, NotReadyWhenTooManyRequestsWait) {
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setNireq(1);
+    config.setReadinessMaxWaitingRequests(1);
+    load(config);
+    auto& queue = instance->getInferRequestsQueue();
+    int streamId = queue.getIdleStream().get();
+    auto first = queue.getIdleStream();
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+    auto second = queue.getIdleStream();
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::SERVER_NOT_READY);
+
+    queue.returnStream(streamId);
+    queue.returnStream(first.get());
+    queue.returnStream(second.get());
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+}
+
+TEST_F(ReadinessProbeTest, QueueWaitPercentileCoversObservationsSincePreviousCheck) {
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setReadinessMaxQueueWaitMs(10);
+    load(config);
+    auto& streamWait = instance->getMetrics().streamWait;
+    for (int i = 0; i < 100; i++) {
+        streamWait.observe(100);
+    }
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+    for (int i = 0; i < 10; i++) {
+        streamWait.observe(50'000);
+    }
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::SERVER_NOT_READY);
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+}
+
+TEST_F(ReadinessProbeTest, NotReadyWhenCriticalModelIsNotAvailable) {
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setReadinessMaxWaitingRequests(10);
+    load(config);
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+    instance->unloadModel();
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::SERVER_NOT_READY);
+}
+
+TEST_F(ReadinessProbeTest, ReadyWhenCriticalModelIsLoadedLazily) {
+    auto config = DUMMY_MODEL_CONFIG;
+    config.setReadinessMaxWaitingRequests(10);
+    config.setLazyLoad(true);
+    load(config);
+    // version is loaded by the first request, which has to be let in
+    ASSERT_TRUE(instance->isEvicted());
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+}
+
+class StartupFailingModelManager : public ConstructorEnabledModelManager {
+public:
+    void failStartup(const ovms::Status& status) {
+        std::lock_guard<std::mutex> lock(startupStatusMtx);
+        startupStatus = status;
+    }
+};
+
+TEST(ReadinessProbe, NotReadyWhenLoadingModelsAtStartupFailed) {
+    StartupFailingModelManager manager;
+    ReadinessProbe probe;
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::OK);
+    manager.failStartup(ovms::StatusCode::PATH_INVALID);
+    EXPECT_EQ(probe.check(manager), ovms::StatusCode::SERVER_NOT_READY);
+}
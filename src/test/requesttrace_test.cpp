@@ -0,0 +1,116 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../requesttrace.hpp"
+
+using ovms::RequestTrace;
+using testing::HasSubstr;
+using testing::MatchesRegex;
+
+TEST(RequestTrace, CreatedFromSampledTraceparent) {
+    auto trace = RequestTrace::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01");
+    ASSERT_NE(trace, nullptr);
+    EXPECT_EQ(trace->getTraceId(), "4bf92f3577b34da6a3ce929d0e0e4736");
+    EXPECT_EQ(trace->getParentId(), "00f067aa0ba902b7");
+}
+
+TEST(RequestTrace, NotCreatedFromNotSampledTraceparent) {
+    EXPECT_EQ(RequestTrace::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00"), nullptr);
+    EXPECT_EQ(RequestTrace::fromTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-02"), nullptr);
+}
+
+TEST(RequestTrace, NotCreatedFromMalformedTraceparent) {
+    const std::vector<std::string> values = {
+        "",
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7",
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-1",
+        "00_4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01",
+        "00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01",
+        "00-4bf92f3577b34da6a3ce929d0e0e473-600f067aa0ba902b7-01",
+        "00-00000000000000000000000000000000-00f067aa0ba902b7-01",
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01",
+        "ff-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01",
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-future",
+        "01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01future",
+    };
+    for (const auto& value : values) {
+        EXPECT_EQ(RequestTrace::fromTraceparent(value), nullptr) << value;
+    }
+}
+
+TEST(RequestTrace, FutureVersionMayHaveMoreFields) {
+    EXPECT_NE(RequestTrace::fromTraceparent("01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-future"), nullptr);
+}
+
+TEST(RequestTrace, SpansAddedFromManyThreads) {
+    RequestTrace trace("4bf92f3577b34da6a3ce929d0e0e4736", "00f067aa0ba902b7");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&trace]() {
+            for (int j = 0; j < 100; j++) {
+                auto now = std::chrono::steady_clock::now();
+                trace.addSpan("span", now, now);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(trace.getSpans().size(), 400);
+    trace.exportSpans();
+}
+
+TEST(RequestTrace, CreatedForSampledOrServerTimingRequests) {
+    const std::string sampled = "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+    const std::string notSampled = "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00";
+    EXPECT_EQ(RequestTrace::create("", false), nullptr);
+    EXPECT_EQ(RequestTrace::create(notSampled, false), nullptr);
+
+    auto trace = RequestTrace::create(sampled, false);
+    ASSERT_NE(trace, nullptr);
+    EXPECT_TRUE(trace->isSampled());
+    EXPECT_FALSE(trace->isServerTimingRequested());
+
+    trace = RequestTrace::create(notSampled, true);
+    ASSERT_NE(trace, nullptr);
+    EXPECT_FALSE(trace->isSampled());
+    EXPECT_TRUE(trace->isServerTimingRequested());
+
+    trace = RequestTrace::create(sampled, true);
+    ASSERT_NE(trace, nullptr);
+    EXPECT_TRUE(trace->isSampled());
+    EXPECT_TRUE(trace->isServerTimingRequested());
+    EXPECT_EQ(trace->getTraceId(), "4bf92f3577b34da6a3ce929d0e0e4736");
+}
+
+TEST(RequestTrace, SerializesServerTiming) {
+    auto trace = RequestTrace::create("", true);
+    ASSERT_NE(trace, nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    trace->addSpan("stream wait", start, start + std::chrono::microseconds(1500));
+    trace->addSpan("node \"a\" execute", start, start + std::chrono::milliseconds(2));
+    const auto timing = trace->serializeServerTiming();
+    EXPECT_THAT(timing, HasSubstr("stream_wait;desc=\"stream wait\";dur=1.500, "));
+    EXPECT_THAT(timing, HasSubstr("node__a__execute;desc=\"node \\\"a\\\" execute\";dur=2.000, "));
+    EXPECT_THAT(timing, MatchesRegex(".*, total;desc=\"total\";dur=[0-9]+\\.[0-9]{3}"));
+}
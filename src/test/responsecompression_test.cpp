@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "../responsecompression.hpp"
+
+using namespace ovms;
+
+TEST(ResponseCompression, AcceptsGzipEncoding) {
+    EXPECT_TRUE(acceptsGzipEncoding("gzip"));
+    EXPECT_TRUE(acceptsGzipEncoding("deflate, gzip;q=1.0, *;q=0.5"));
+    EXPECT_TRUE(acceptsGzipEncoding("br, X-GZIP"));
+    EXPECT_TRUE(acceptsGzipEncoding("*"));
+    EXPECT_FALSE(acceptsGzipEncoding(""));
+    EXPECT_FALSE(acceptsGzipEncoding("identity"));
+    EXPECT_FALSE(acceptsGzipEncoding("gzip;q=0"));
+    EXPECT_FALSE(acceptsGzipEncoding("gzip; q=0, *"));
+    EXPECT_FALSE(acceptsGzipEncoding("*;q=0"));
+}
+
+TEST(ResponseCompression, CompressedDataDecompressesToInput) {
+    std::string input;
+    for (int i = 0; i < 10000; i++) {
+        input += "{\"outputs\": [" + std::to_string(i % 7) + "]}";
+    }
+    std::string compressed;
+    ASSERT_TRUE(compressGzip(input, compressed));
+    EXPECT_LT(compressed.size(), input.size());
+    ASSERT_GT(compressed.size(), 2u);
+    EXPECT_EQ(static_cast<unsigned char>(compressed[0]), 0x1f);
+    EXPECT_EQ(static_cast<unsigned char>(compressed[1]), 0x8b);
+
+    z_stream stream{};
+    ASSERT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+    std::string decompressed(input.size(), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(&compressed[0]);
+    stream.avail_in = compressed.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&decompressed[0]);
+    stream.avail_out = decompressed.size();
+    EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+    inflateEnd(&stream);
+    EXPECT_EQ(stream.total_out, input.size());
+    EXPECT_EQ(decompressed, input);
+}
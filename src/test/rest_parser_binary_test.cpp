@@ -0,0 +1,144 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../rest_parser.hpp"
+#include "test_utils.hpp"
+
+using namespace ovms;
+
+using namespace testing;
+using ::testing::ElementsAre;
+
+using tensorflow::DataType;
+
+namespace {
+template <typename T>
+void appendBinary(std::string& body, const std::vector<T>& values) {
+    body.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+}  // namespace
+
+TEST(RestParserBinary, ParseFp32AndI32Inputs) {
+    std::string header = R"({"inputs":[{"name":"a","datatype":"FP32","shape":[1,3]},{"name":"b","datatype":"I32","shape":[2]}]})";
+    std::string body = header;
+    appendBinary<float>(body, {1.5, 2.5, 3.5});
+    appendBinary<int32_t>(body, {-4, 5});
+
+    RestParser parser;
+    ASSERT_EQ(parser.parseBinary(body.data(), body.size(), header.size()), StatusCode::OK);
+    EXPECT_EQ(parser.getOrder(), Order::COLUMN);
+    EXPECT_EQ(parser.getFormat(), Format::NAMED);
+    ASSERT_EQ(parser.getProto().inputs_size(), 2);
+
+    const auto& a = parser.getProto().inputs().at("a");
+    EXPECT_EQ(a.dtype(), DataType::DT_FLOAT);
+    EXPECT_THAT(asVector(a.tensor_shape()), ElementsAre(1, 3));
+    EXPECT_THAT(asVector<float>(a.tensor_content()), ElementsAre(1.5, 2.5, 3.5));
+
+    const auto& b = parser.getProto().inputs().at("b");
+    EXPECT_EQ(b.dtype(), DataType::DT_INT32);
+    EXPECT_THAT(asVector(b.tensor_shape()), ElementsAre(2));
+    EXPECT_THAT(asVector<int32_t>(b.tensor_content()), ElementsAre(-4, 5));
+}
+
+TEST(RestParserBinary, ParseFp16IntoHalfVal) {
+    std::string header = R"({"inputs":[{"name":"a","datatype":"FP16","shape":[2]}]})";
+    std::string body = header;
+    appendBinary<uint16_t>(body, {0x3C00, 0xC000});
+
+    RestParser parser;
+    ASSERT_EQ(parser.parseBinary(body.data(), body.size(), header.size()), StatusCode::OK);
+    const auto& a = parser.getProto().inputs().at("a");
+    EXPECT_EQ(a.dtype(), DataType::DT_HALF);
+    EXPECT_EQ(a.tensor_content().size(), 0);
+    EXPECT_THAT(a.half_val(), ElementsAre(0x3C00, 0xC000));
+}
+
+TEST(RestParserBinary, DataSizeMismatch) {
+    std::string header = R"({"inputs":[{"name":"a","datatype":"FP32","shape":[1,3]}]})";
+    std::string tooShort = header;
+    appendBinary<float>(tooShort, {1.0, 2.0});
+    std::string tooLong = header;
+    appendBinary<float>(tooLong, {1.0, 2.0, 3.0, 4.0});
+
+    RestParser parser;
+    EXPECT_EQ(parser.parseBinary(tooShort.data(), tooShort.size(), header.size()), StatusCode::REST_BINARY_DATA_SIZE_MISMATCH);
+    EXPECT_EQ(parser.parseBinary(tooLong.data(), tooLong.size(), header.size()), StatusCode::REST_BINARY_DATA_SIZE_MISMATCH);
+}
+
+TEST(RestParserBinary, InvalidHeader) {
+    std::vector<std::string> headers{
+        R"({"inputs":[]})",
+        R"({"instances":[{"name":"a","datatype":"FP32","shape":[1]}]})",
+        R"({"inputs":[{"datatype":"FP32","shape":[1]}]})",
+        R"({"inputs":[{"name":"a","datatype":"FP32","shape":[-1]}]})",
+        R"({"inputs":[{"name":"a","datatype":"FP32","shape":"1"}]})"};
+    for (const auto& header : headers) {
+        std::string body = header;
+        appendBinary<float>(body, {1.0});
+        RestParser parser;
+        EXPECT_EQ(parser.parseBinary(body.data(), body.size(), header.size()), StatusCode::REST_BINARY_HEADER_INVALID) << header;
+    }
+}
+
+TEST(RestParserBinary, HeaderSizeExceedsBody) {
+    std::string body = R"({"inputs":[{"name":"a","datatype":"FP32","shape":[1]}]})";
+    RestParser parser;
+    EXPECT_EQ(parser.parseBinary(body.data(), body.size(), body.size() + 1), StatusCode::REST_BINARY_HEADER_INVALID);
+}
+
+TEST(RestParserBinary, HeaderNotJson) {
+    std::string body = R"({"inputs":[{"name":"a","datatype":"FP32","shape":[1]})";
+    RestParser parser;
+    EXPECT_EQ(parser.parseBinary(body.data(), body.size(), body.size()), StatusCode::JSON_INVALID);
+}
+
+TEST(RestParserBinary, UnsupportedDatatype) {
+    std::string header = R"({"inputs":[{"name":"a","datatype":"BYTES","shape":[1]}]})";
+    std::string body = header + "x";
+    RestParser parser;
+    EXPECT_EQ(parser.parseBinary(body.data(), body.size(), header.size()), StatusCode::REST_UNSUPPORTED_PRECISION);
+}
+
+TEST(RestParserBinary, DuplicateInputNamesRejected) {
+    std::string header = R"({"inputs":[{"name":"a","datatype":"FP32","shape":[1]},{"name":"a","datatype":"FP32","shape":[1]}]})";
+    std::string body = header;
+    appendBinary<float>(body, {1.0, 2.0});
+    RestParser parser;
+    EXPECT_EQ(parser.parseBinary(body.data(), body.size(), header.size()), StatusCode::REST_BINARY_HEADER_INVALID);
+}
+
+TEST(RestParserBinary, ShapeOverflowRejected) {
+    // product of dimensions wraps to 0
+    std::string header = R"({"inputs":[{"name":"a","datatype":"U8","shape":[4294967296,4294967296]}]})";
+    RestParser elementsParser;
+    EXPECT_EQ(elementsParser.parseBinary(header.data(), header.size(), header.size()), StatusCode::REST_BINARY_HEADER_INVALID);
+
+    // dimension does not fit in tensor shape
+    header = R"({"inputs":[{"name":"a","datatype":"U8","shape":[0,18446744073709551615]}]})";
+    RestParser dimParser;
+    EXPECT_EQ(dimParser.parseBinary(header.data(), header.size(), header.size()), StatusCode::REST_BINARY_HEADER_INVALID);
+
+    // elements fit, size in bytes wraps to 0
+    header = R"({"inputs":[{"name":"a","datatype":"FP32","shape":[4611686018427387904]}]})";
+    RestParser byteSizeParser;
+    EXPECT_EQ(byteSizeParser.parseBinary(header.data(), header.size(), header.size()), StatusCode::REST_BINARY_DATA_SIZE_MISMATCH);
+}
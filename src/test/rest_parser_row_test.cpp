@@ -13,6 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <sstream>
+#include <string>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -106,6 +109,29 @@ TEST(RestParserRow, ParseValid2Inputs) {
     }
 }
 
+TEST(RestParserRow, ParseInsituSameAsParse) {
+    std::string body(predictRequestRowNamedJson);
+    RestParser parser(prepareTensors({{"inputA", {2, 2, 3, 2}}, {"inputB", {2, 2, 3}}}));
+    RestParser insituParser(prepareTensors({{"inputA", {2, 2, 3, 2}}, {"inputB", {2, 2, 3}}}));
+    ASSERT_EQ(parser.parse(predictRequestRowNamedJson), StatusCode::OK);
+    ASSERT_EQ(insituParser.parseInsitu(body.data()), StatusCode::OK);
+    EXPECT_EQ(insituParser.getOrder(), Order::ROW);
+    EXPECT_EQ(insituParser.getFormat(), Format::NAMED);
+    ASSERT_EQ(insituParser.getProto().inputs_size(), 2);
+    for (const auto& name : {"inputA", "inputB"}) {
+        const auto& expected = parser.getProto().inputs().at(name);
+        const auto& input = insituParser.getProto().inputs().at(name);
+        EXPECT_EQ(asVector(input.tensor_shape()), asVector(expected.tensor_shape()));
+        EXPECT_EQ(input.tensor_content(), expected.tensor_content());
+    }
+}
+
+TEST(RestParserRow, ParseInsituInvalidJson) {
+    std::string body = R"({"instances": [[1.0, 2.0]})";
+    RestParser parser(prepareTensors({{"i", {1, 2}}}));
+    EXPECT_EQ(parser.parseInsitu(body.data()), StatusCode::JSON_INVALID);
+}
+
 TEST(RestParserRow, ValidShape_1x1) {
     std::vector<RestParser> parsers{RestParser(), RestParser(prepareTensors({{"i", {1, 1}}}))};
     for (RestParser& parser : parsers) {
@@ -358,6 +384,81 @@ TEST(RestParserRow, ParseHalf) {
     ASSERT_EQ(parser.parse(R"({"signature_name":"","instances":[{"i":[[-5.1222, 0.434422, -4.52122, 155234.22122]]}]})"), StatusCode::OK);
 }
 
+TEST(RestParserRow, ParseMixedIntegerAndFloatingPointValuesToPreallocatedContent) {
+    RestParser parser(prepareTensors({{"i", {2, 1, 3}}}, InferenceEngine::Precision::FP32));
+    ASSERT_EQ(parser.parse(R"({"signature_name":"","instances":[{"i":[[1, 2.5, -3]]},{"i":[[4.25, 5, 6]]}]})"), StatusCode::OK);
+    EXPECT_THAT(asVector<float>(parser.getProto().inputs().at("i").tensor_content()), ElementsAre(1, 2.5, -3, 4.25, 5, 6));
+    parser = RestParser(prepareTensors({{"i", {2, 1, 3}}}, InferenceEngine::Precision::I32));
+    ASSERT_EQ(parser.parse(R"({"signature_name":"","instances":[{"i":[[1, 2.0, -3]]},{"i":[[4, 5, 6.0]]}]})"), StatusCode::OK);
+    EXPECT_THAT(asVector<int32_t>(parser.getProto().inputs().at("i").tensor_content()), ElementsAre(1, 2, -3, 4, 5, 6));
+}
+
+std::string createLargeNamedRowRequest(size_t instances, const std::string& lastInstance = "") {
+    std::stringstream json;
+    json << R"({"signature_name":"","instances":[)";
+    for (size_t i = 0; i < instances; i++) {
+        json << (i > 0 ? "," : "");
+        if (i == instances - 1 && !lastInstance.empty()) {
+            json << lastInstance;
+        } else {
+            json << R"({"a":[[)" << i << "," << i + 0.5 << R"(]],"b":[)" << i << "]}";
+        }
+    }
+    json << "]}";
+    return json.str();
+}
+
+TEST(RestParserRow, ParseLargeBatch) {
+    const int batchSize = 1024;
+    RestParser parser(prepareTensors({{"a", {batchSize, 1, 2}}, {"b", {batchSize, 1}}}, InferenceEngine::Precision::FP32));
+    ASSERT_EQ(parser.parse(createLargeNamedRowRequest(batchSize).c_str()), StatusCode::OK);
+    const auto& a = parser.getProto().inputs().at("a");
+    const auto& b = parser.getProto().inputs().at("b");
+    EXPECT_THAT(asVector(a.tensor_shape()), ElementsAre(batchSize, 1, 2));
+    EXPECT_THAT(asVector(b.tensor_shape()), ElementsAre(batchSize, 1));
+    const auto aValues = asVector<float>(a.tensor_content());
+    const auto bValues = asVector<float>(b.tensor_content());
+    ASSERT_EQ(aValues.size(), static_cast<size_t>(batchSize * 2));
+    ASSERT_EQ(bValues.size(), static_cast<size_t>(batchSize));
+    for (int i = 0; i < batchSize; i++) {
+        EXPECT_EQ(aValues[i * 2], i);
+        EXPECT_EQ(aValues[i * 2 + 1], i + 0.5);
+        EXPECT_EQ(bValues[i], i);
+    }
+}
+
+TEST(RestParserRow, ParseLargeBatchWithInvalidInstance) {
+    const int batchSize = 1024;
+    auto parseLargeRequest = [batchSize](const std::string& lastInstance) {
+        RestParser parser(prepareTensors({{"a", {batchSize, 1, 2}}, {"b", {batchSize, 1}}}, InferenceEngine::Precision::FP32));
+        return parser.parse(createLargeNamedRowRequest(batchSize, lastInstance).c_str());
+    };
+    EXPECT_EQ(parseLargeRequest(R"({"a":[[1,2,3]],"b":[1]})"), StatusCode::REST_COULD_NOT_PARSE_INSTANCE);
+    EXPECT_EQ(parseLargeRequest(R"({"a":[[1,"str"]],"b":[1]})"), StatusCode::REST_COULD_NOT_PARSE_INSTANCE);
+    EXPECT_EQ(parseLargeRequest(R"({"a":[[1,2]]})"), StatusCode::REST_INSTANCES_BATCH_SIZE_DIFFER);
+    EXPECT_EQ(parseLargeRequest(R"({"a":[[1,2]],"b":[1],"c":[1]})"), StatusCode::REST_INSTANCES_BATCH_SIZE_DIFFER);
+    EXPECT_EQ(parseLargeRequest("[1]"), StatusCode::REST_NAMED_INSTANCE_NOT_AN_OBJECT);
+}
+
+TEST(RestParserRow, ParseLargeFirstInstanceFollowedByEmptyInstances) {
+    const int batchSize = 4096;
+    const int values = 1024;
+    std::stringstream json;
+    json << R"({"signature_name":"","instances":[{"a":[[)";
+    for (int i = 0; i < values; i++) {
+        json << (i > 0 ? "," : "") << i;
+    }
+    json << "]]}";
+    for (int i = 1; i < batchSize; i++) {
+        json << ",{}";
+    }
+    json << "]}";
+    // content for whole batch is not allocated for instances which do not contain its values
+    RestParser parser(prepareTensors({{"a", {batchSize, 1, values}}}, InferenceEngine::Precision::FP32));
+    EXPECT_EQ(parser.parse(json.str().c_str()), StatusCode::REST_COULD_NOT_PARSE_INSTANCE);
+    EXPECT_EQ(parser.getProto().inputs().at("a").tensor_content().size(), values * sizeof(float));
+}
+
 TEST(RestParserRow, InvalidJson) {
     std::vector<RestParser> parsers{RestParser(), RestParser(prepareTensors({{"i", {1, 3, 2}}}))};
     for (RestParser& parser : parsers) {
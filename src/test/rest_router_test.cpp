@@ -0,0 +1,183 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../rest_router.hpp"
+
+using ovms::RestPathComponents;
+
+namespace {
+// Expressions previously used for routing, router is expected to give the same results
+const std::regex modelsRegex(R"((.?)\/v1\/models\/.*)");
+const std::regex predictionRegex(R"((.?)\/v1\/models\/([^\/:]+)(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?:(classify|regress|predict))");
+const std::regex modelStatusRegex(R"((.?)\/v1\/models(?:\/([^\/:]+))?(?:(?:\/versions\/(\d+))|(?:\/labels\/(\w+)))?(?:\/(metadata))?)");
+const std::regex metricsRegex(R"((.?)\/metrics)");
+
+const std::vector<std::string> paths{
+    "",
+    "/",
+    "/metrics",
+    "x/metrics",
+    "//metrics",
+    "/metrics/",
+    "ab/metrics",
+    "/v1/models",
+    "/v1/models/",
+    "x/v1/models/",
+    "/v1/models/dummy",
+    "/v1/models/dummy/",
+    "/v1/models/dummy/metadata",
+    "/v1/models/dummy/versions/1",
+    "/v1/models/dummy/versions/12/metadata",
+    "/v1/models/dummy/versions/",
+    "/v1/models/dummy/versions/a",
+    "/v1/models/dummy/versions/1a",
+    "/v1/models/dummy/labels/stable",
+    "/v1/models/dummy/labels/stable_2/metadata",
+    "/v1/models/dummy/labels/sta-ble",
+    "/v1/models/dummy/labels/",
+    "/v1/models/versions/1",
+    "/v1/models/labels/latest",
+    "/v1/models/metadata",
+    "/v1/models/metadata/metadata",
+    "/v1/models/dummy:predict",
+    "/v1/models/dummy:classify",
+    "/v1/models/dummy:regress",
+    "/v1/models/dummy:predictx",
+    "/v1/models/dummy:",
+    "/v1/models/:predict",
+    "/v1/models/dummy/versions/3:predict",
+    "/v1/models/dummy/versions/:predict",
+    "/v1/models/dummy/labels/l1:predict",
+    "/v1/models/dummy/labels/l1/metadata:predict",
+    "/v1/models/dummy/metadata:predict",
+    "/v1/models/dum my:predict",
+    "x/v1/models/dummy:predict",
+    "xy/v1/models/dummy:predict",
+    "//v1/models/dummy/versions/1",
+    "/v2/models/dummy:predict",
+    "/v1/models/dummy\n:predict",
+    "\n/v1/models/dummy",
+    "/v1/models/dummy/versions/99999999999999999999",
+};
+
+std::string toString(std::string_view view) {
+    return std::string(view);
+}
+}  // namespace
+
+TEST(RestRouter, ModelsPathMatchesRegex) {
+    for (const auto& path : paths) {
+        EXPECT_EQ(ovms::matchModelsPath(path), std::regex_match(path, modelsRegex)) << path;
+    }
+}
+
+TEST(RestRouter, MetricsPathMatchesRegex) {
+    for (const auto& path : paths) {
+        EXPECT_EQ(ovms::matchMetricsPath(path), std::regex_match(path, metricsRegex)) << path;
+    }
+}
+
+TEST(RestRouter, PredictionPathMatchesRegex) {
+    for (const auto& path : paths) {
+        std::smatch sm;
+        RestPathComponents components;
+        const bool expected = std::regex_match(path, sm, predictionRegex);
+        ASSERT_EQ(ovms::matchPredictionPath(path, components), expected) << path;
+        if (!expected) {
+            continue;
+        }
+        EXPECT_EQ(toString(components.modelName), sm[2]) << path;
+        EXPECT_EQ(toString(components.modelVersion), sm[3]) << path;
+        EXPECT_EQ(toString(components.modelVersionLabel), sm[4]) << path;
+        EXPECT_EQ(toString(components.method), sm[5]) << path;
+    }
+}
+
+TEST(RestRouter, ModelStatusPathMatchesRegex) {
+    for (const auto& path : paths) {
+        std::smatch sm;
+        RestPathComponents components;
+        const bool expected = std::regex_match(path, sm, modelStatusRegex);
+        ASSERT_EQ(ovms::matchModelStatusPath(path, components), expected) << path;
+        if (!expected) {
+            continue;
+        }
+        EXPECT_EQ(toString(components.modelName), sm[2]) << path;
+        EXPECT_EQ(toString(components.modelVersion), sm[3]) << path;
+        EXPECT_EQ(toString(components.modelVersionLabel), sm[4]) << path;
+        EXPECT_EQ(toString(components.method), sm[5]) << path;
+    }
+}
+
+TEST(RestRouter, PredictionPathComponents) {
+    RestPathComponents components;
+    ASSERT_TRUE(ovms::matchPredictionPath("/v1/models/resnet/versions/2:predict", components));
+    EXPECT_EQ(components.modelName, "resnet");
+    EXPECT_EQ(components.modelVersion, "2");
+    EXPECT_TRUE(components.modelVersionLabel.empty());
+    EXPECT_EQ(components.method, "predict");
+}
+
+TEST(RestRouter, ReadinessPath) {
+    EXPECT_TRUE(ovms::matchReadinessPath("/v1/ready"));
+    EXPECT_TRUE(ovms::matchReadinessPath("x/v1/ready"));
+    for (const auto& path : {"/v1/ready/", "/v1/readyz", "/ready", "ab/v1/ready", "/v1/models/ready"}) {
+        EXPECT_FALSE(ovms::matchReadinessPath(path)) << path;
+    }
+}
+
+TEST(RestRouter, StatusSnapshotPath) {
+    EXPECT_TRUE(ovms::matchStatusSnapshotPath("/v1/status"));
+    EXPECT_TRUE(ovms::matchStatusSnapshotPath("x/v1/status"));
+    for (const auto& path : {"/v1/status/", "/v1/statuses", "/status", "/v1/models/status"}) {
+        EXPECT_FALSE(ovms::matchStatusSnapshotPath(path)) << path;
+    }
+}
+
+TEST(RestRouter, ProfilingPathComponents) {
+    std::string_view profile, seconds;
+    ASSERT_TRUE(ovms::matchProfilingPath("/debug/pprof/profile?seconds=5", profile, seconds));
+    EXPECT_EQ(profile, "profile");
+    EXPECT_EQ(seconds, "5");
+    ASSERT_TRUE(ovms::matchProfilingPath("/debug/pprof/heap", profile, seconds));
+    EXPECT_EQ(profile, "heap");
+    EXPECT_TRUE(seconds.empty());
+    for (const auto& path : {"/debug/pprof/", "/debug/pprof/goroutine", "/debug/pprof/profile?seconds=", "/debug/pprof/profile?debug=1", "/debug/pprof/heap/"}) {
+        EXPECT_FALSE(ovms::matchProfilingPath(path, profile, seconds)) << path;
+    }
+}
+
+
+    std::string_view regionName, method;
+    ASSERT_TRUE(ovms::matchSharedMemoryPath("/v1/shared_memory/frames:register", regionName, method));
+    EXPECT_EQ(regionName, "frames");
+    EXPECT_EQ(method, "register");
+    ASSERT_TRUE(ovms::matchSharedMemoryPath("x/v1/shared_memory/frames:unregister", regionName, method));
+    EXPECT_EQ(regionName, "frames");
+    EXPECT_EQ(method, "unregister");
+    ASSERT_TRUE(ovms::matchSharedMemoryPath("/v1/shared_memory", regionName, method));
+    EXPECT_TRUE(regionName.empty());
+    EXPECT_TRUE(method.empty());
+    for (const auto& path : {"/v1/shared_memory/", "/v1/shared_memory/frames", "/v1/shared_memory/:register",
+             "/v1/shared_memory/frames:predict", "/v1/shared_memory/a/b:register", "/v1/models/frames:register"}) {
+        EXPECT_FALSE(ovms::matchSharedMemoryPath(path, regionName, method)) << path;
+    }
+}
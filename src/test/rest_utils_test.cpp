@@ -13,6 +13,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //*****************************************************************************
+#include <limits>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -406,3 +410,103 @@ TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_Uint64) {
     ]
 })");
 }
+
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_Half) {
+    uint16_t data[4] = {0x3C00, 0xC000, 0x3800, 0x7BFF};  // 1, -2, 0.5, 65504
+    output->set_dtype(tensorflow::DataType::DT_HALF);
+    output->mutable_tensor_shape()->mutable_dim(1)->set_size(4);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(data), sizeof(data));
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::OK);
+    EXPECT_EQ(json, R"({
+    "predictions": [[1.0, -2.0, 0.5, 65504.0]
+    ]
+})");
+}
+
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_Uint16) {
+    uint16_t data = 65000;
+    output->set_dtype(tensorflow::DataType::DT_UINT16);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(&data), sizeof(uint16_t));
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::OK);
+    EXPECT_EQ(json, R"({
+    "predictions": [[65000]
+    ]
+})");
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::COLUMN), StatusCode::OK);
+    EXPECT_EQ(json, R"({
+    "outputs": [
+        [
+            65000
+        ]
+    ]
+})");
+}
+
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_FloatShortestRepresentation) {
+    float data[4] = {0.1f, -1.0f / 3, 16777216.0f, 1e-7f};
+    output->set_dtype(tensorflow::DataType::DT_FLOAT);
+    output->mutable_tensor_shape()->mutable_dim(1)->set_size(4);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(data), sizeof(data));
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::OK);
+    EXPECT_EQ(json, R"({
+    "predictions": [[0.1, -0.33333334, 16777216.0, 1e-7]
+    ]
+})");
+}
+
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_FloatNonFinite) {
+    float data[3] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+    output->set_dtype(tensorflow::DataType::DT_FLOAT);
+    output->mutable_tensor_shape()->mutable_dim(1)->set_size(3);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(data), sizeof(data));
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::OK);
+    EXPECT_EQ(json, R"({
+    "predictions": [[NaN, Infinity, -Infinity]
+    ]
+})");
+}
+
+TEST_F(RestUtilsTest, MakeJsonFromPredictResponse_RowOrderBatchSizeMismatchError) {
+    output2->mutable_tensor_shape()->mutable_dim(0)->set_size(1);
+    output2->mutable_tensor_shape()->mutable_dim(1)->set_size(10);
+    EXPECT_EQ(makeJsonFromPredictResponse(proto, &json, Order::ROW), StatusCode::REST_PROTO_TO_STRING_ERROR);
+    EXPECT_EQ(makeJsonFromPredictResponse(proto, &json, Order::COLUMN), StatusCode::OK);
+}
+
+TEST_F(RestUtilsTest, MakeJsonFromPredictResponse_ChunksMatchWholeResponse) {
+    for (auto order : {Order::ROW, Order::COLUMN}) {
+        ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, order), StatusCode::OK);
+        std::string chunked;
+        size_t chunks = 0;
+        ASSERT_EQ(makeJsonFromPredictResponse(
+                      proto, [&chunked, &chunks](const char* data, size_t size) { chunked.append(data, size); chunks++; }, order),
+            StatusCode::OK);
+        EXPECT_EQ(chunked, json);
+        EXPECT_EQ(chunks, 1);
+    }
+}
+
+TEST_F(RestUtilsTest, MakeJsonFromPredictResponse_NothingWrittenInChunksOnError) {
+    output1->mutable_tensor_content()->clear();
+    size_t chunks = 0;
+    EXPECT_EQ(makeJsonFromPredictResponse(
+                  proto, [&chunks](const char* data, size_t size) { chunks++; }, Order::ROW),
+        StatusCode::REST_SERIALIZE_TENSOR_CONTENT_INVALID_SIZE);
+    EXPECT_EQ(chunks, 0);
+}
+
+TEST_F(RestUtilsPrecisionTest, MakeJsonFromPredictResponse_LargeResponseSplitIntoChunks) {
+    const int64_t elements = 100000;
+    std::vector<int32_t> data(elements, 7);
+    output->set_dtype(tensorflow::DataType::DT_INT32);
+    output->mutable_tensor_shape()->mutable_dim(1)->set_size(elements);
+    output->mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), elements * sizeof(int32_t));
+    ASSERT_EQ(makeJsonFromPredictResponse(proto, &json, Order::COLUMN), StatusCode::OK);
+    std::string chunked;
+    size_t chunks = 0;
+    ASSERT_EQ(makeJsonFromPredictResponse(
+                  proto, [&chunked, &chunks](const char* data, size_t size) { chunked.append(data, size); chunks++; }, Order::COLUMN),
+        StatusCode::OK);
+    EXPECT_EQ(chunked, json);
+    EXPECT_GT(chunks, 1);
+}
@@ -0,0 +1,193 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../resultcache.hpp"
+#include "../xxhash.hpp"
+
+using tensorflow::serving::PredictRequest;
+using tensorflow::serving::PredictResponse;
+
+namespace {
+PredictRequest prepareRequest(const std::string& content) {
+    PredictRequest request;
+    request.mutable_model_spec()->set_name("dummy");
+    auto& input = (*request.mutable_inputs())["input"];
+    input.set_dtype(tensorflow::DataType::DT_FLOAT);
+    input.mutable_tensor_shape()->add_dim()->set_size(1);
+    input.mutable_tensor_shape()->add_dim()->set_size(content.size() / sizeof(float));
+    *input.mutable_tensor_content() = content;
+    return request;
+}
+
+PredictResponse prepareResponse(const std::string& content) {
+    PredictResponse response;
+    auto& output = (*response.mutable_outputs())["output"];
+    output.set_dtype(tensorflow::DataType::DT_FLOAT);
+    *output.mutable_tensor_content() = content;
+    return response;
+}
+
+uint64_t computeKey(ovms::model_version_t version, const PredictRequest& request) {
+    uint64_t key = 0;
+    EXPECT_TRUE(ovms::ResultCache::computeKey(version, request, key));
+    return key;
+}
+}  // namespace
+
+TEST(XXHash64, ReferenceValues) {
+    const std::string abc = "abc";
+    ovms::XXHash64 empty;
+    EXPECT_EQ(empty.digest(), 0xEF46DB3751D8E999ULL);
+    ovms::XXHash64 hash;
+    hash.update(abc.data(), abc.size());
+    EXPECT_EQ(hash.digest(), 0x44BC2CF5AD770999ULL);
+}
+
+TEST(XXHash64, StreamingMatchesSingleUpdate) {
+    std::string data(1000, '\0');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i * 7);
+    }
+    ovms::XXHash64 whole;
+    whole.update(data.data(), data.size());
+    ovms::XXHash64 chunked;
+    for (size_t offset = 0; offset < data.size(); offset += 13) {
+        chunked.update(data.data() + offset, std::min<size_t>(13, data.size() - offset));
+    }
+    EXPECT_EQ(whole.digest(), chunked.digest());
+}
+
+TEST(ResultCache, KeyDependsOnVersionAndContent) {
+    auto request = prepareRequest(std::string(16, 'a'));
+    EXPECT_EQ(computeKey(1, request), computeKey(1, prepareRequest(std::string(16, 'a'))));
+    EXPECT_NE(computeKey(1, request), computeKey(2, request));
+    EXPECT_NE(computeKey(1, request), computeKey(1, prepareRequest(std::string(16, 'b'))));
+}
+
+TEST(ResultCache, RequestWithoutTensorContentNotCached) {
+    auto request = prepareRequest("");
+    uint64_t key;
+    EXPECT_FALSE(ovms::ResultCache::computeKey(1, request, key));
+}
+
+TEST(ResultCache, HitReturnsCachedResponse) {
+    ovms::ResultCache cache(1024 * 1024, std::chrono::microseconds(0));
+    auto request = prepareRequest(std::string(16, 'a'));
+    const auto key = computeKey(1, request);
+    PredictResponse response;
+    EXPECT_FALSE(cache.lookup(1, key, request, response));
+    cache.insert(1, key, request, prepareResponse("result"));
+    ASSERT_TRUE(cache.lookup(1, key, request, response));
+    EXPECT_EQ(response.outputs().at("output").tensor_content(), "result");
+}
+
+TEST(ResultCache, CollidingKeyWithDifferentInputsMisses) {
+    ovms::ResultCache cache(1024 * 1024, std::chrono::microseconds(0));
+    auto request = prepareRequest(std::string(16, 'a'));
+    const auto key = computeKey(1, request);
+    cache.insert(1, key, request, prepareResponse("result"));
+    PredictResponse response;
+    EXPECT_FALSE(cache.lookup(1, key, prepareRequest(std::string(16, 'b')), response));
+}
+
+TEST(ResultCache, KeyDependsOnOutputFilter) {
+    auto request = prepareRequest(std::string(16, 'a'));
+    auto filtered = request;
+    filtered.add_output_filter("first");
+    filtered.add_output_filter("second");
+    auto reordered = request;
+    reordered.add_output_filter("second");
+    reordered.add_output_filter("first");
+    EXPECT_NE(computeKey(1, request), computeKey(1, filtered));
+    EXPECT_EQ(computeKey(1, filtered), computeKey(1, reordered));
+}
+
+TEST(ResultCache, RequestsWithDifferentOutputFiltersDoNotShareEntries) {
+    ovms::ResultCache cache(1024 * 1024, std::chrono::microseconds(0));
+    auto unfiltered = prepareRequest(std::string(16, 'a'));
+    auto filtered = unfiltered;
+    filtered.add_output_filter("output");
+    auto otherFiltered = unfiltered;
+    otherFiltered.add_output_filter("other");
+    cache.insert(1, computeKey(1, unfiltered), unfiltered, prepareResponse("unfiltered"));
+    PredictResponse response;
+    EXPECT_FALSE(cache.lookup(1, computeKey(1, filtered), filtered, response));
+    // colliding key does not return response of request with another filter either
+    EXPECT_FALSE(cache.lookup(1, computeKey(1, unfiltered), filtered, response));
+    cache.insert(1, computeKey(1, filtered), filtered, prepareResponse("filtered"));
+    EXPECT_FALSE(cache.lookup(1, computeKey(1, otherFiltered), otherFiltered, response));
+    EXPECT_FALSE(cache.lookup(1, computeKey(1, filtered), otherFiltered, response));
+    ASSERT_TRUE(cache.lookup(1, computeKey(1, filtered), filtered, response));
+    EXPECT_EQ(response.outputs().at("output").tensor_content(), "filtered");
+    ASSERT_TRUE(cache.lookup(1, computeKey(1, unfiltered), unfiltered, response));
+    EXPECT_EQ(response.outputs().at("output").tensor_content(), "unfiltered");
+}
+
+TEST(ResultCache, LeastRecentlyUsedEvictedOverSizeLimit) {
+    auto first = prepareRequest(std::string(100, 'a'));
+    auto second = prepareRequest(std::string(100, 'b'));
+    auto third = prepareRequest(std::string(100, 'c'));
+    auto result = prepareResponse(std::string(100, 'r'));
+    const size_t entrySize = first.ByteSizeLong() + result.ByteSizeLong();
+    ovms::ResultCache cache(2 * entrySize, std::chrono::microseconds(0));
+    cache.insert(1, computeKey(1, first), first, result);
+    cache.insert(1, computeKey(1, second), second, result);
+    PredictResponse response;
+    ASSERT_TRUE(cache.lookup(1, computeKey(1, first), first, response));
+    cache.insert(1, computeKey(1, third), third, result);
+    EXPECT_EQ(cache.getEntriesCount(), 2);
+    EXPECT_LE(cache.getSizeBytes(), 2 * entrySize);
+    EXPECT_TRUE(cache.lookup(1, computeKey(1, first), first, response));
+    EXPECT_FALSE(cache.lookup(1, computeKey(1, second), second, response));
+    EXPECT_TRUE(cache.lookup(1, computeKey(1, third), third, response));
+}
+
+TEST(ResultCache, EntryLargerThanCacheNotStored) {
+    auto request = prepareRequest(std::string(100, 'a'));
+    ovms::ResultCache cache(10, std::chrono::microseconds(0));
+    cache.insert(1, computeKey(1, request), request, prepareResponse("result"));
+    EXPECT_EQ(cache.getEntriesCount(), 0);
+    EXPECT_EQ(cache.getSizeBytes(), 0);
+}
+
+TEST(ResultCache, ExpiredEntryNotReturned) {
+    ovms::ResultCache cache(1024 * 1024, std::chrono::milliseconds(10));
+    auto request = prepareRequest(std::string(16, 'a'));
+    const auto key = computeKey(1, request);
+    cache.insert(1, key, request, prepareResponse("result"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    PredictResponse response;
+    EXPECT_FALSE(cache.lookup(1, key, request, response));
+    EXPECT_EQ(cache.getEntriesCount(), 0);
+}
+
+TEST(ResultCache, InvalidateDropsOnlyEntriesOfVersion) {
+    ovms::ResultCache cache(1024 * 1024, std::chrono::microseconds(0));
+    auto request = prepareRequest(std::string(16, 'a'));
+    cache.insert(1, computeKey(1, request), request, prepareResponse("first"));
+    cache.insert(2, computeKey(2, request), request, prepareResponse("second"));
+    cache.invalidate(1);
+    PredictResponse response;
+    EXPECT_FALSE(cache.lookup(1, computeKey(1, request), request, response));
+    ASSERT_TRUE(cache.lookup(2, computeKey(2, request), request, response));
+    EXPECT_EQ(response.outputs().at("output").tensor_content(), "second");
+}
@@ -0,0 +1,151 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../sequencemanager.hpp"
+
+using namespace ovms;
+
+namespace {
+const std::string DUMMY_MODEL_PATH = std::filesystem::current_path().u8string() + "/src/test/dummy/1/dummy.xml";
+
+tensorflow::serving::PredictRequest prepareSequenceRequest(uint64_t id, std::optional<uint32_t> control) {
+    tensorflow::serving::PredictRequest request;
+    auto& idProto = (*request.mutable_inputs())[SEQUENCE_ID_INPUT];
+    idProto.set_dtype(tensorflow::DataType::DT_UINT64);
+    idProto.mutable_tensor_shape()->add_dim()->set_size(1);
+    idProto.add_uint64_val(id);
+    if (control.has_value()) {
+        auto& controlProto = (*request.mutable_inputs())[SEQUENCE_CONTROL_INPUT];
+        controlProto.set_dtype(tensorflow::DataType::DT_UINT32);
+        controlProto.mutable_tensor_shape()->add_dim()->set_size(1);
+        controlProto.add_uint32_val(control.value());
+    }
+    return request;
+}
+
+class SequenceManagerTest : public ::testing::Test {
+protected:
+    InferenceEngine::Core engine;
+    std::unique_ptr<InferenceEngine::ExecutableNetwork> execNetwork;
+    std::unique_ptr<OVInferRequestsQueue> inferRequestsQueue;
+
+    void SetUp() override {
+        InferenceEngine::CNNNetwork network = engine.ReadNetwork(DUMMY_MODEL_PATH);
+        execNetwork = std::make_unique<InferenceEngine::ExecutableNetwork>(engine.LoadNetwork(network, "CPU"));
+        inferRequestsQueue = std::make_unique<OVInferRequestsQueue>(*execNetwork, 2);
+    }
+};
+}  // namespace
+
+TEST(SequenceRequest, ParsesIdAndControl) {
+    SequenceRequest result;
+    ASSERT_EQ(parseSequenceRequest(prepareSequenceRequest(42, 1), result), StatusCode::OK);
+    EXPECT_EQ(result.id, 42);
+    EXPECT_EQ(result.control, SequenceControl::START);
+    ASSERT_EQ(parseSequenceRequest(prepareSequenceRequest(42, std::nullopt), result), StatusCode::OK);
+    EXPECT_EQ(result.control, SequenceControl::NONE);
+    ASSERT_EQ(parseSequenceRequest(prepareSequenceRequest(0, 1), result), StatusCode::OK);
+    EXPECT_EQ(result.id, 0);
+}
+
+TEST(SequenceRequest, ParsesIdFromTensorContent) {
+    auto request = prepareSequenceRequest(0, 2);
+    uint64_t id = 7;
+    auto& idProto = (*request.mutable_inputs())[SEQUENCE_ID_INPUT];
+    idProto.clear_uint64_val();
+    idProto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(&id), sizeof(id));
+    SequenceRequest result;
+    ASSERT_EQ(parseSequenceRequest(request, result), StatusCode::OK);
+    EXPECT_EQ(result.id, 7);
+    EXPECT_EQ(result.control, SequenceControl::END);
+}
+
+TEST(SequenceRequest, RejectsInvalidInputs) {
+    SequenceRequest result;
+    tensorflow::serving::PredictRequest request;
+    EXPECT_EQ(parseSequenceRequest(request, result), StatusCode::INVALID_SEQUENCE_ID);
+    EXPECT_EQ(parseSequenceRequest(prepareSequenceRequest(0, std::nullopt), result), StatusCode::INVALID_SEQUENCE_ID);
+    EXPECT_EQ(parseSequenceRequest(prepareSequenceRequest(0, 2), result), StatusCode::INVALID_SEQUENCE_ID);
+    EXPECT_EQ(parseSequenceRequest(prepareSequenceRequest(1, 3), result), StatusCode::INVALID_SEQUENCE_CONTROL_INPUT);
+    request = prepareSequenceRequest(1, std::nullopt);
+    (*request.mutable_inputs())[SEQUENCE_ID_INPUT].set_dtype(tensorflow::DataType::DT_INT64);
+    EXPECT_EQ(parseSequenceRequest(request, result), StatusCode::INVALID_SEQUENCE_ID);
+}
+
+TEST(SequenceRequest, CountsSequenceInputs) {
+    EXPECT_EQ(getSequenceInputsCount(prepareSequenceRequest(1, 1)), 2);
+    EXPECT_EQ(getSequenceInputsCount(prepareSequenceRequest(1, std::nullopt)), 1);
+    EXPECT_EQ(getSequenceInputsCount(tensorflow::serving::PredictRequest()), 0);
+}
+
+TEST_F(SequenceManagerTest, SequenceHoldsInferRequestUntilEnded) {
+    SequenceManager manager(*inferRequestsQueue, std::chrono::seconds(60));
+    uint64_t id = 5;
+    std::shared_ptr<Sequence> sequence;
+    ASSERT_EQ(manager.startSequence(id, StreamWaitingOptions(), sequence), StatusCode::OK);
+    EXPECT_EQ(id, 5);
+    EXPECT_EQ(inferRequestsQueue->getIdleStreamsCount(), 1);
+    std::shared_ptr<Sequence> found;
+    ASSERT_EQ(manager.findSequence(5, found), StatusCode::OK);
+    EXPECT_EQ(found->getStreamId(), sequence->getStreamId());
+    EXPECT_EQ(manager.startSequence(id, StreamWaitingOptions(), found), StatusCode::SEQUENCE_ALREADY_EXISTS);
+    found.reset();
+    manager.endSequence(5);
+    EXPECT_EQ(manager.findSequence(5, found), StatusCode::SEQUENCE_MISSING);
+    // infer request is returned once the last request using sequence releases it
+    EXPECT_EQ(inferRequestsQueue->getIdleStreamsCount(), 1);
+    sequence.reset();
+    EXPECT_EQ(inferRequestsQueue->getIdleStreamsCount(), 2);
+}
+
+TEST_F(SequenceManagerTest, GeneratesUniqueIdsAndLimitsNumberOfSequences) {
+    SequenceManager manager(*inferRequestsQueue, std::chrono::seconds(60));
+    uint64_t first = 0, second = 0, third = 0;
+    std::shared_ptr<Sequence> sequence;
+    ASSERT_EQ(manager.startSequence(first, StreamWaitingOptions(), sequence), StatusCode::OK);
+    ASSERT_EQ(manager.startSequence(second, StreamWaitingOptions(), sequence), StatusCode::OK);
+    EXPECT_NE(first, 0);
+    EXPECT_NE(second, 0);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(manager.startSequence(third, StreamWaitingOptions(), sequence), StatusCode::MAX_SEQUENCE_NUMBER_REACHED);
+    EXPECT_EQ(manager.getSequencesCount(), 2);
+}
+
+TEST_F(SequenceManagerTest, RemovesIdleSequences) {
+    SequenceManager manager(*inferRequestsQueue, std::chrono::seconds(1));
+    uint64_t idle = 1, used = 2;
+    std::shared_ptr<Sequence> sequence;
+    ASSERT_EQ(manager.startSequence(idle, StreamWaitingOptions(), sequence), StatusCode::OK);
+    ASSERT_EQ(manager.startSequence(used, StreamWaitingOptions(), sequence), StatusCode::OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    {
+        // sequence with request in progress is kept
+        std::lock_guard<std::mutex> lock(sequence->mtx);
+        EXPECT_EQ(manager.removeIdleSequences(), 1);
+    }
+    std::shared_ptr<Sequence> found;
+    EXPECT_EQ(manager.findSequence(idle, found), StatusCode::SEQUENCE_MISSING);
+    EXPECT_EQ(manager.findSequence(used, found), StatusCode::OK);
+}
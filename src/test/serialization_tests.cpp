@@ -14,9 +14,11 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -163,6 +165,117 @@ TEST_P(SerializeTFTensorProto, SerializeTensorProtoShouldSucceedForPrecision) {
         << "should succeed";
 }
 
+TEST(SerializeTFTensorProtoInPlace, BlobBackedByTensorContentIsNotCopied) {
+    auto networkOutput = std::make_shared<ovms::TensorInfo>(
+        std::string("2_values_C_layout"),
+        Precision::FP32,
+        shape_t{2},
+        InferenceEngine::Layout::C);
+    TensorProto responseOutput;
+    auto* content = responseOutput.mutable_tensor_content();
+    content->resize(2 * sizeof(float));
+    auto blob = InferenceEngine::make_shared_blob<float>(networkOutput->getTensorDesc(), reinterpret_cast<float*>(&(*content)[0]), 2);
+    blob->buffer().as<float*>()[0] = 1.5;
+    blob->buffer().as<float*>()[1] = 2.5;
+    const char* data = responseOutput.tensor_content().data();
+
+    auto status = serializeBlobToTensorProto(responseOutput, networkOutput, blob);
+    ASSERT_TRUE(status.ok());
+    EXPECT_EQ(responseOutput.tensor_content().data(), data);
+    EXPECT_EQ(responseOutput.dtype(), tensorflow::DataType::DT_FLOAT);
+    ASSERT_EQ(responseOutput.tensor_shape().dim_size(), 1);
+    EXPECT_EQ(responseOutput.tensor_shape().dim(0).size(), 2);
+    const float* values = reinterpret_cast<const float*>(responseOutput.tensor_content().data());
+    EXPECT_EQ(values[0], 1.5);
+    EXPECT_EQ(values[1], 2.5);
+}
+
+TEST(SerializeTFTensorProtoTemplate, ShapeOfReusedProtoIsReplacedWithTemplate) {
+    auto networkOutput = std::make_shared<ovms::TensorInfo>(
+        std::string("3x2_values"),
+        Precision::FP32,
+        shape_t{3, 2},
+        InferenceEngine::Layout::NC);
+    const auto& responseTemplate = networkOutput->getResponseTemplate();
+    EXPECT_EQ(responseTemplate.dtype(), tensorflow::DataType::DT_FLOAT);
+    ASSERT_EQ(responseTemplate.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(responseTemplate.tensor_shape().dim(0).size(), 3);
+    EXPECT_EQ(responseTemplate.tensor_shape().dim(1).size(), 2);
+    EXPECT_TRUE(responseTemplate.tensor_content().empty());
+
+    std::vector<float> data{1, 2, 3, 4, 5, 6};
+    auto blob = InferenceEngine::make_shared_blob<float>(networkOutput->getTensorDesc(), data.data(), data.size());
+    TensorProto responseOutput;
+    for (auto dim : {7, 8, 9}) {
+        responseOutput.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    ASSERT_TRUE(serializeBlobToTensorProto(responseOutput, networkOutput, blob).ok());
+    ASSERT_EQ(responseOutput.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(responseOutput.tensor_shape().dim(0).size(), 3);
+    EXPECT_EQ(responseOutput.tensor_shape().dim(1).size(), 2);
+    EXPECT_EQ(responseOutput.tensor_content().size(), data.size() * sizeof(float));
+
+    ASSERT_TRUE(serializeBlobBatchSliceToTensorProto(responseOutput, networkOutput, blob, 1, 2).ok());
+    ASSERT_EQ(responseOutput.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(responseOutput.tensor_shape().dim(0).size(), 2);
+    EXPECT_EQ(responseOutput.tensor_shape().dim(1).size(), 2);
+    ASSERT_EQ(responseOutput.tensor_content().size(), 4 * sizeof(float));
+    EXPECT_EQ(reinterpret_cast<const float*>(responseOutput.tensor_content().data())[0], 3);
+    EXPECT_EQ(responseTemplate.tensor_shape().dim(0).size(), 3);
+}
+
+TEST(SerializeTFTensorProtoDtype, LowPrecisionOutputsKeepNativeType) {
+    const std::vector<std::pair<Precision, tensorflow::DataType>> expectedTypes{
+        {Precision::FP16, tensorflow::DataType::DT_HALF},
+        {Precision::U16, tensorflow::DataType::DT_UINT16},
+        {Precision::I64, tensorflow::DataType::DT_INT64}};
+    for (const auto& [precision, dtype] : expectedTypes) {
+        auto networkOutput = std::make_shared<ovms::TensorInfo>(
+            std::string("2_values_C_layout"),
+            precision,
+            shape_t{2},
+            InferenceEngine::Layout::C);
+        InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<uint8_t>(
+            InferenceEngine::TensorDesc(Precision::U8, {2 * precision.size()}, InferenceEngine::Layout::C));
+        blob->allocate();
+        TensorProto responseOutput;
+        auto status = serializeBlobToTensorProto(responseOutput, networkOutput, blob);
+        ASSERT_TRUE(status.ok());
+        EXPECT_EQ(responseOutput.dtype(), dtype) << precision;
+        EXPECT_EQ(responseOutput.tensor_content().size(), 2 * precision.size()) << precision;
+    }
+}
+
+TEST(SerializeTFTensorProtoDtype, Fp32OutputsConvertedToHalfWhenEnabled) {
+    auto networkOutput = std::make_shared<ovms::TensorInfo>(
+        std::string("4_values_C_layout"),
+        Precision::FP32,
+        shape_t{4},
+        InferenceEngine::Layout::C);
+    std::vector<float> data{1.5, 2.5, -0.0, 70000.0};
+    auto blob = InferenceEngine::make_shared_blob<float>(networkOutput->getTensorDesc(), data.data(), data.size());
+    TensorProto responseOutput;
+    auto status = serializeBlobToTensorProto(responseOutput, networkOutput, blob, true);
+    ASSERT_TRUE(status.ok());
+    EXPECT_EQ(responseOutput.dtype(), tensorflow::DataType::DT_HALF);
+    ASSERT_EQ(responseOutput.tensor_shape().dim_size(), 1);
+    EXPECT_EQ(responseOutput.tensor_shape().dim(0).size(), 4);
+    ASSERT_EQ(responseOutput.tensor_content().size(), 4 * sizeof(uint16_t));
+    const uint16_t* values = reinterpret_cast<const uint16_t*>(responseOutput.tensor_content().data());
+    EXPECT_EQ(values[0], 0x3E00);
+    EXPECT_EQ(values[1], 0x4100);
+    EXPECT_EQ(values[2], 0x8000);
+    EXPECT_EQ(values[3], 0x7C00);
+}
+
+TEST(SerializeTFTensorProtoDtype, ConvertFloatToHalfRoundsToNearestEven) {
+    // lengths above vector width check both vectorized and remaining elements
+    std::vector<float> source{1.0, 0.5, 65504.0, 1.0f + 1.0f / 2048, 1.0f + 3.0f / 2048, 6.0e-8f, 2.0e-8f, -2.0, 3.0};
+    std::vector<uint16_t> destination(source.size());
+    convertFloatToHalf(source.data(), source.size(), destination.data());
+    EXPECT_THAT(destination, ::testing::ElementsAre(0x3C00, 0x3800, 0x7BFF, 0x3C00, 0x3C02, 0x0001, 0x0000, 0xC000, 0x4200));
+}
+
 class SerializeTFTensorProtoNegative : public SerializeTFTensorProto {};
 
 TEST_P(SerializeTFTensorProtoNegative, SerializeTensorProtoShouldSucceedForPrecision) {
@@ -236,6 +349,53 @@ TEST_F(SerializeTFGRPCPredictResponseNegative, OutputNameNotCreatedInInferenceSh
     EXPECT_EQ(status, ovms::StatusCode::OV_INTERNAL_SERIALIZATION_ERROR);
 }
 
+TEST(SerializeOutputFilter, OnlyFilteredOutputsAreRequested) {
+    tensor_map_t outputs;
+    outputs["a"] = std::make_shared<ovms::TensorInfo>("a", Precision::FP32, InferenceEngine::SizeVector{1, 10}, InferenceEngine::Layout::NC);
+    outputs["b"] = std::make_shared<ovms::TensorInfo>("b", Precision::FP32, InferenceEngine::SizeVector{1, 10}, InferenceEngine::Layout::NC);
+    PredictRequest request;
+    tensor_map_t filteredOutputs;
+    const tensor_map_t* requestedOutputs = nullptr;
+    ASSERT_EQ(getRequestedOutputs(outputs, request, filteredOutputs, requestedOutputs), ovms::StatusCode::OK);
+    EXPECT_EQ(requestedOutputs, &outputs);
+    EXPECT_TRUE(isOutputRequested(request, "b"));
+
+    request.add_output_filter("b");
+    ASSERT_EQ(getRequestedOutputs(outputs, request, filteredOutputs, requestedOutputs), ovms::StatusCode::OK);
+    ASSERT_EQ(requestedOutputs, &filteredOutputs);
+    EXPECT_EQ(filteredOutputs.size(), 1);
+    EXPECT_EQ(filteredOutputs.count("b"), 1);
+    EXPECT_TRUE(isOutputRequested(request, "b"));
+    EXPECT_FALSE(isOutputRequested(request, "a"));
+
+    request.add_output_filter("c");
+    EXPECT_EQ(getRequestedOutputs(outputs, request, filteredOutputs, requestedOutputs), ovms::StatusCode::INVALID_MISSING_OUTPUT);
+}
+
+TEST(SerializeOutputsInParallel, SerializesEachOutputOnceAndReturnsFirstFailure) {
+    const std::vector<size_t> byteSizes{PARALLEL_SERIALIZATION_MIN_BYTES, 16, PARALLEL_SERIALIZATION_MIN_BYTES * 4, 0, PARALLEL_SERIALIZATION_MIN_BYTES};
+    std::vector<std::atomic<int>> calls(byteSizes.size());
+    EXPECT_EQ(serializeOutputsInParallel(byteSizes, [&calls](size_t index) {
+        calls[index]++;
+        return Status(StatusCode::OK);
+    }),
+        StatusCode::OK);
+    for (const auto& count : calls) {
+        EXPECT_EQ(count.load(), 1);
+    }
+
+    auto status = serializeOutputsInParallel(byteSizes, [](size_t index) {
+        if (index == 2) {
+            return Status(StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION);
+        }
+        if (index == 3) {
+            return Status(StatusCode::OV_INTERNAL_SERIALIZATION_ERROR);
+        }
+        return Status(StatusCode::OK);
+    });
+    EXPECT_EQ(status, StatusCode::OV_UNSUPPORTED_SERIALIZATION_PRECISION);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Test,
     SerializeTFTensorProto,
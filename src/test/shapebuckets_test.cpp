@@ -0,0 +1,114 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../shapebuckets.hpp"
+#include "test_utils.hpp"
+
+using testing::ElementsAre;
+
+namespace {
+tensorflow::TensorProto prepareTensor(const ovms::shape_t& shape, const std::vector<float>& data) {
+    tensorflow::TensorProto tensor;
+    tensor.set_dtype(tensorflow::DataType::DT_FLOAT);
+    for (auto dim : shape) {
+        tensor.mutable_tensor_shape()->add_dim()->set_size(dim);
+    }
+    tensor.mutable_tensor_content()->assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    return tensor;
+}
+
+ovms::ModelConfig prepareConfig() {
+    ovms::ModelConfig config;
+    ovms::ShapeInfo shapeInfo;
+    shapeInfo.shapeMode = ovms::AUTO;
+    config.addShape("input", shapeInfo);
+    config.addShapeBuckets("input", {{1, 8}, {1, 4}});
+    return config;
+}
+}  // namespace
+
+TEST(ShapeBuckets, BucketsSortedBySize) {
+    auto config = prepareConfig();
+    EXPECT_THAT(config.getShapeBuckets().at("input"), ElementsAre(ovms::shape_t{1, 4}, ovms::shape_t{1, 8}));
+}
+
+TEST(ShapeBuckets, FindsSmallestFittingBucket) {
+    std::vector<ovms::shape_t> buckets{{1, 4}, {1, 8}, {2, 8}};
+    EXPECT_EQ(*ovms::findShapeBucket(buckets, {1, 3}), (ovms::shape_t{1, 4}));
+    EXPECT_EQ(*ovms::findShapeBucket(buckets, {1, 5}), (ovms::shape_t{1, 8}));
+    EXPECT_EQ(*ovms::findShapeBucket(buckets, {2, 1}), (ovms::shape_t{2, 8}));
+    EXPECT_EQ(ovms::findShapeBucket(buckets, {1, 9}), nullptr);
+    EXPECT_EQ(ovms::findShapeBucket(buckets, {1, 2, 3}), nullptr);
+}
+
+TEST(ShapeBuckets, RequestPaddedAndResponseSliced) {
+    auto config = prepareConfig();
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name("model");
+    (*request.mutable_inputs())["input"] = prepareTensor({1, 3}, {1, 2, 3});
+
+    tensorflow::serving::PredictRequest paddedRequest;
+    ovms::ShapeBucketPadding padding;
+    ASSERT_TRUE(ovms::padRequestToShapeBuckets(config, request, paddedRequest, padding));
+    EXPECT_EQ(paddedRequest.model_spec().name(), "model");
+    const auto& paddedInput = paddedRequest.inputs().at("input");
+    ASSERT_EQ(paddedInput.tensor_shape().dim_size(), 2);
+    EXPECT_EQ(paddedInput.tensor_shape().dim(1).size(), 4);
+    EXPECT_THAT(asVector<float>(paddedInput.tensor_content()), ElementsAre(1, 2, 3, 0));
+
+    tensorflow::serving::PredictResponse response;
+    (*response.mutable_outputs())["output"] = prepareTensor({1, 4}, {2, 3, 4, 1});
+    (*response.mutable_outputs())["scores"] = prepareTensor({1, 2}, {5, 6});
+    ovms::sliceResponseToRequestShapes(padding, response);
+    const auto& output = response.outputs().at("output");
+    EXPECT_EQ(output.tensor_shape().dim(1).size(), 3);
+    EXPECT_THAT(asVector<float>(output.tensor_content()), ElementsAre(2, 3, 4));
+    EXPECT_THAT(asVector<float>(response.outputs().at("scores").tensor_content()), ElementsAre(5, 6));
+}
+
+TEST(ShapeBuckets, InnerDimensionsPaddedPerRow) {
+    ovms::ModelConfig config;
+    ovms::ShapeInfo shapeInfo;
+    shapeInfo.shapeMode = ovms::AUTO;
+    config.addShape("input", shapeInfo);
+    config.addShapeBuckets("input", {{2, 3}});
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())["input"] = prepareTensor({2, 2}, {1, 2, 3, 4});
+
+    tensorflow::serving::PredictRequest paddedRequest;
+    ovms::ShapeBucketPadding padding;
+    ASSERT_TRUE(ovms::padRequestToShapeBuckets(config, request, paddedRequest, padding));
+    EXPECT_THAT(asVector<float>(paddedRequest.inputs().at("input").tensor_content()), ElementsAre(1, 2, 0, 3, 4, 0));
+}
+
+TEST(ShapeBuckets, NotAppliedWhenShapeMatchesBucketOrIsNotAuto) {
+    auto config = prepareConfig();
+    tensorflow::serving::PredictRequest request;
+    (*request.mutable_inputs())["input"] = prepareTensor({1, 4}, {1, 2, 3, 4});
+    tensorflow::serving::PredictRequest paddedRequest;
+    ovms::ShapeBucketPadding padding;
+    EXPECT_FALSE(ovms::padRequestToShapeBuckets(config, request, paddedRequest, padding));
+
+    ovms::ModelConfig fixedShapeConfig;
+    fixedShapeConfig.addShapeBuckets("input", {{1, 8}});
+    (*request.mutable_inputs())["input"] = prepareTensor({1, 3}, {1, 2, 3});
+    EXPECT_FALSE(ovms::padRequestToShapeBuckets(fixedShapeConfig, request, paddedRequest, padding));
+    EXPECT_FALSE(padding.isApplied());
+}
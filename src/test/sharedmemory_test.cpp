@@ -0,0 +1,132 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../sharedmemory.hpp"
+
+using ovms::SharedMemoryRegistry;
+using ovms::StatusCode;
+
+namespace {
+const std::string SEGMENT_KEY = "/ovms_shared_memory_test";
+
+class SharedMemoryTest : public ::testing::Test {
+protected:
+    std::vector<float> values{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+
+    void SetUp() override {
+        int fd = shm_open(SEGMENT_KEY.c_str(), O_CREAT | O_RDWR, 0600);
+        ASSERT_GE(fd, 0);
+        const size_t byteSize = values.size() * sizeof(float);
+        ASSERT_EQ(ftruncate(fd, byteSize), 0);
+        ASSERT_EQ(write(fd, values.data(), byteSize), static_cast<ssize_t>(byteSize));
+        close(fd);
+    }
+
+    void TearDown() override {
+        for (const auto& region : SharedMemoryRegistry::getInstance().getRegions()) {
+            SharedMemoryRegistry::getInstance().unregisterRegion(region->getName());
+        }
+        shm_unlink(SEGMENT_KEY.c_str());
+    }
+
+    tensorflow::TensorProto prepareTensor(const std::string& regionName, uint64_t offset) {
+        tensorflow::TensorProto proto;
+        proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+        auto handle = proto.add_resource_handle_val();
+        handle->set_container(ovms::SHARED_MEMORY_CONTAINER);
+        handle->set_name(regionName);
+        handle->set_hash_code(offset);
+        return proto;
+    }
+};
+}  // namespace
+
+TEST_F(SharedMemoryTest, RegisterFindAndUnregister) {
+    auto& registry = SharedMemoryRegistry::getInstance();
+    ASSERT_EQ(registry.registerRegion("region", SEGMENT_KEY, 4 * sizeof(float), 4 * sizeof(float)), StatusCode::OK);
+    auto region = registry.findRegion("region");
+    ASSERT_NE(region, nullptr);
+    EXPECT_EQ(region->getKey(), SEGMENT_KEY);
+    EXPECT_EQ(region->getOffset(), 4 * sizeof(float));
+    EXPECT_EQ(region->getByteSize(), 4 * sizeof(float));
+    EXPECT_EQ(reinterpret_cast<const float*>(region->getData())[0], 5.0);
+    EXPECT_EQ(registry.getRegions().size(), 1);
+    EXPECT_EQ(registry.unregisterRegion("region"), StatusCode::OK);
+    EXPECT_EQ(registry.findRegion("region"), nullptr);
+    // data remains mapped while referenced
+    EXPECT_EQ(reinterpret_cast<const float*>(region->getData())[3], 8.0);
+    EXPECT_EQ(registry.unregisterRegion("region"), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+}
+
+TEST_F(SharedMemoryTest, RegisterDuplicateName) {
+    auto& registry = SharedMemoryRegistry::getInstance();
+    ASSERT_EQ(registry.registerRegion("region", SEGMENT_KEY, 0, sizeof(float)), StatusCode::OK);
+    EXPECT_EQ(registry.registerRegion("region", SEGMENT_KEY, 0, sizeof(float)), StatusCode::SHARED_MEMORY_REGION_ALREADY_EXISTS);
+}
+
+TEST_F(SharedMemoryTest, RegisterMissingSegment) {
+    EXPECT_EQ(SharedMemoryRegistry::getInstance().registerRegion("region", "/ovms_not_existing_segment", 0, sizeof(float)), StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED);
+}
+
+TEST_F(SharedMemoryTest, RegisterEmptyRegion) {
+    EXPECT_EQ(SharedMemoryRegistry::getInstance().registerRegion("region", SEGMENT_KEY, 0, 0), StatusCode::SHARED_MEMORY_REGION_OPEN_FAILED);
+}
+
+TEST_F(SharedMemoryTest, RegisterRegionExceedingSegment) {
+    EXPECT_EQ(SharedMemoryRegistry::getInstance().registerRegion("region", SEGMENT_KEY, sizeof(float), values.size() * sizeof(float)), StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS);
+}
+
+TEST_F(SharedMemoryTest, RegisterRegionWithWrappingOffset) {
+    // offset + byte size wraps around to 4, within the segment
+    const size_t offset = std::numeric_limits<size_t>::max() - 3;
+    EXPECT_EQ(SharedMemoryRegistry::getInstance().registerRegion("region", SEGMENT_KEY, offset, 2 * sizeof(float)), StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS);
+}
+
+TEST_F(SharedMemoryTest, TensorDataAtOffset) {
+    ASSERT_EQ(SharedMemoryRegistry::getInstance().registerRegion("region", SEGMENT_KEY, sizeof(float), 6 * sizeof(float)), StatusCode::OK);
+    auto proto = prepareTensor("region", 2 * sizeof(float));
+    EXPECT_TRUE(ovms::isSharedMemoryTensor(proto));
+    std::shared_ptr<const ovms::SharedMemoryRegion> region;
+    const char* data = nullptr;
+    ASSERT_EQ(ovms::getSharedMemoryTensorData(proto, 4 * sizeof(float), region, data), StatusCode::OK);
+    EXPECT_EQ(reinterpret_cast<const float*>(data)[0], 4.0);
+    EXPECT_EQ(reinterpret_cast<const float*>(data)[3], 7.0);
+    EXPECT_EQ(ovms::getSharedMemoryTensorData(proto, 5 * sizeof(float), region, data), StatusCode::SHARED_MEMORY_REGION_OUT_OF_BOUNDS);
+}
+
+TEST_F(SharedMemoryTest, TensorDataOfNotRegisteredRegion) {
+    auto proto = prepareTensor("region", 0);
+    std::shared_ptr<const ovms::SharedMemoryRegion> region;
+    const char* data = nullptr;
+    EXPECT_EQ(ovms::getSharedMemoryTensorData(proto, sizeof(float), region, data), StatusCode::SHARED_MEMORY_REGION_NOT_FOUND);
+}
+
+TEST_F(SharedMemoryTest, TensorWithContentIsNotSharedMemoryTensor) {
+    tensorflow::TensorProto proto;
+    proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+    proto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    EXPECT_FALSE(ovms::isSharedMemoryTensor(proto));
+    proto.add_resource_handle_val()->set_container("other");
+    EXPECT_FALSE(ovms::isSharedMemoryTensor(proto));
+}
@@ -0,0 +1,76 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <unistd.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../load_generator/soakstats.hpp"
+
+using ovms::HeapStats;
+using ovms::ProcessStats;
+
+TEST(SoakStats, ReadsStatsOfCurrentProcess) {
+    ProcessStats stats;
+    ASSERT_TRUE(ovms::readProcessStats(getpid(), stats));
+    EXPECT_GT(stats.rssBytes, 0);
+    EXPECT_GE(stats.peakRssBytes, stats.rssBytes);
+    EXPECT_GT(stats.threads, 0);
+    // at least standard streams are open
+    EXPECT_GE(stats.openFiles, 3);
+}
+
+TEST(SoakStats, MissingProcessIsReported) {
+    ProcessStats stats;
+    EXPECT_FALSE(ovms::readProcessStats(-1, stats));
+}
+
+TEST(SoakStats, ParsesJemallocStatistics) {
+    const std::string content = R"({"jemalloc": {"version": "5.2.1", "arenas": {"narenas": 4}, "stats": {"allocated": 1000, "active": 1200, "metadata": 100, "resident": 1500, "mapped": 2000}, "stats.arenas": {"0": {"resident": 10}}}})";
+    HeapStats stats;
+    ASSERT_TRUE(ovms::parseHeapStatistics(content, stats));
+    EXPECT_EQ(stats.allocatedBytes, 1000);
+    EXPECT_EQ(stats.heapBytes, 1500);
+}
+
+TEST(SoakStats, ParsesMallocInfoTotals) {
+    const std::string content = R"(<malloc version="1">
+<heap nr="0">
+<sizes>
+</sizes>
+<total type="fast" count="1" size="32"/>
+<total type="rest" count="2" size="100"/>
+<system type="current" size="500"/>
+</heap>
+<total type="fast" count="3" size="64"/>
+<total type="rest" count="4" size="436"/>
+<total type="mmap" count="1" size="4096"/>
+<system type="current" size="2000"/>
+<system type="max" size="3000"/>
+<aspace type="total" size="2000"/>
+</malloc>
+)";
+    HeapStats stats;
+    ASSERT_TRUE(ovms::parseHeapStatistics(content, stats));
+    EXPECT_EQ(stats.heapBytes, 2000);
+    EXPECT_EQ(stats.allocatedBytes, 1500);
+}
+
+TEST(SoakStats, UnknownFormatIsRejected) {
+    HeapStats stats;
+    EXPECT_FALSE(ovms::parseHeapStatistics("not statistics", stats));
+}
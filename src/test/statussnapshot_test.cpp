@@ -0,0 +1,216 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include "../modelversionstatus.hpp"
+#include "../statussnapshot.hpp"
+
+using ovms::ModelVersionStatus;
+using ovms::StatusSnapshot;
+using ovms::StatusTransition;
+
+namespace {
+const rapidjson::Value* findEntry(const rapidjson::Document& doc, const char* collection, const std::string& name) {
+    for (const auto& entry : doc[collection].GetArray()) {
+        if (name == entry["name"].GetString()) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const StatusTransition* findTransition(const std::vector<StatusTransition>& transitions, const std::string& name) {
+    const StatusTransition* found = nullptr;
+    for (const auto& transition : transitions) {
+        if (transition.name == name) {
+            found = &transition;
+        }
+    }
+    return found;
+}
+}  // namespace
+
+TEST(StatusSnapshot, ModelVersionTransitionsAreReflected) {
+    ModelVersionStatus status("status_snapshot_model", 3);
+    status.setLoading();
+    status.setAvailable();
+
+    rapidjson::Document doc;
+    doc.Parse(StatusSnapshot::getInstance().getJson()->c_str());
+    ASSERT_FALSE(doc.HasParseError());
+    auto model = findEntry(doc, "models", "status_snapshot_model");
+    ASSERT_NE(model, nullptr);
+    ASSERT_EQ((*model)["versions"].Size(), 1u);
+    const auto& version = (*model)["versions"][0];
+    EXPECT_EQ(version["version"].GetInt64(), 3);
+    EXPECT_STREQ(version["state"].GetString(), "AVAILABLE");
+    EXPECT_STREQ(version["error_code"].GetString(), "OK");
+
+    status.setEnd(ovms::ModelVersionStatusErrorCode::UNKNOWN);
+    doc.Parse(StatusSnapshot::getInstance().getJson()->c_str());
+    model = findEntry(doc, "models", "status_snapshot_model");
+    ASSERT_NE(model, nullptr);
+    EXPECT_STREQ((*model)["versions"][0]["state"].GetString(), "END");
+    EXPECT_STREQ((*model)["versions"][0]["error_code"].GetString(), "UNKNOWN");
+}
+
+TEST(StatusSnapshot, UnpublishedTransitionsDoNotOverwriteServedInstanceState) {
+    std::atomic<bool> servedPublished = true;
+    ModelVersionStatus served("status_snapshot_replaced_model", 1, ovms::ModelVersionState::START, &servedPublished);
+    served.setLoading();
+    served.setAvailable();
+
+    std::atomic<bool> replacementPublished = false;
+    ModelVersionStatus replacement("status_snapshot_replaced_model", 1, ovms::ModelVersionState::START, &replacementPublished);
+    replacement.setLoading();
+
+    rapidjson::Document doc;
+    doc.Parse(StatusSnapshot::getInstance().getJson()->c_str());
+    auto model = findEntry(doc, "models", "status_snapshot_replaced_model");
+    ASSERT_NE(model, nullptr);
+    EXPECT_STREQ((*model)["versions"][0]["state"].GetString(), "AVAILABLE");
+    EXPECT_STREQ((*model)["versions"][0]["error_code"].GetString(), "OK");
+
+    // replacement takes over serving, retirement of previous instance is not reported
+    replacement.setAvailable(ovms::ModelVersionStatusErrorCode::UNKNOWN);
+    servedPublished = false;
+    replacementPublished = true;
+    replacement.publish();
+    served.setEnd();
+    doc.Parse(StatusSnapshot::getInstance().getJson()->c_str());
+    model = findEntry(doc, "models", "status_snapshot_replaced_model");
+    ASSERT_NE(model, nullptr);
+    EXPECT_STREQ((*model)["versions"][0]["state"].GetString(), "AVAILABLE");
+    EXPECT_STREQ((*model)["versions"][0]["error_code"].GetString(), "UNKNOWN");
+}
+
+TEST(StatusSnapshot, RemovedModelIsNotReported) {
+    auto& snapshot = StatusSnapshot::getInstance();
+    ModelVersionStatus status("status_snapshot_removed_model", 1);
+    status.setEnd();
+    snapshot.removeModel("status_snapshot_removed_model");
+
+    rapidjson::Document doc;
+    doc.Parse(snapshot.getJson()->c_str());
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_EQ(findEntry(doc, "models", "status_snapshot_removed_model"), nullptr);
+    std::vector<StatusTransition> states;
+    snapshot.getStates(states);
+    EXPECT_EQ(findTransition(states, "status_snapshot_removed_model"), nullptr);
+}
+
+TEST(StatusSnapshot, JsonIsSerializedOnlyAfterTransition) {
+    auto& snapshot = StatusSnapshot::getInstance();
+    snapshot.updatePipeline("status_snapshot_pipeline", "BEGIN");
+    auto first = snapshot.getJson();
+    EXPECT_EQ(snapshot.getJson(), first);
+
+    snapshot.updatePipeline("status_snapshot_pipeline", "AVAILABLE");
+    auto second = snapshot.getJson();
+    EXPECT_NE(second, first);
+    rapidjson::Document doc;
+    doc.Parse(second->c_str());
+    ASSERT_FALSE(doc.HasParseError());
+    auto pipeline = findEntry(doc, "pipelines", "status_snapshot_pipeline");
+    ASSERT_NE(pipeline, nullptr);
+    EXPECT_STREQ((*pipeline)["state"].GetString(), "AVAILABLE");
+}
+
+TEST(StatusSnapshot, WatcherReceivesTransitionsInOrder) {
+    auto& snapshot = StatusSnapshot::getInstance();
+    std::vector<StatusTransition> transitions;
+    uint64_t sequence = snapshot.getStates(transitions);
+
+    ModelVersionStatus status("status_snapshot_watched_model", 1);
+    status.setLoading();
+    status.setAvailable();
+    transitions.clear();
+    ASSERT_TRUE(snapshot.waitForChanges(sequence, transitions, std::chrono::milliseconds(0)));
+    ASSERT_EQ(transitions.size(), 2u);
+    EXPECT_EQ(transitions[0].name, "status_snapshot_watched_model");
+    EXPECT_FALSE(transitions[0].pipeline);
+    EXPECT_EQ(transitions[0].version, 1);
+    EXPECT_EQ(transitions[0].state, "LOADING");
+    EXPECT_EQ(transitions[1].state, "AVAILABLE");
+    EXPECT_EQ(transitions[1].errorCode, "OK");
+    EXPECT_EQ(transitions[1].sequence, sequence);
+
+    snapshot.updatePipeline("status_snapshot_watched_pipeline", "BEGIN");
+    snapshot.updatePipeline("status_snapshot_watched_pipeline", "BEGIN");
+    transitions.clear();
+    ASSERT_TRUE(snapshot.waitForChanges(sequence, transitions, std::chrono::milliseconds(0)));
+    ASSERT_EQ(transitions.size(), 1u);
+    EXPECT_TRUE(transitions[0].pipeline);
+    EXPECT_EQ(transitions[0].state, "BEGIN");
+
+    transitions.clear();
+    ASSERT_TRUE(snapshot.waitForChanges(sequence, transitions, std::chrono::milliseconds(0)));
+    EXPECT_TRUE(transitions.empty());
+}
+
+TEST(StatusSnapshot, WaitingWatcherIsWokenUpByTransition) {
+    auto& snapshot = StatusSnapshot::getInstance();
+    std::vector<StatusTransition> transitions;
+    uint64_t sequence = snapshot.getStates(transitions);
+    transitions.clear();
+    auto watch = std::async(std::launch::async, [&snapshot, &sequence, &transitions]() {
+        return snapshot.waitForChanges(sequence, transitions, std::chrono::seconds(10));
+    });
+    snapshot.updatePipeline("status_snapshot_woken_pipeline", "AVAILABLE");
+    ASSERT_EQ(watch.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_TRUE(watch.get());
+    auto transition = findTransition(transitions, "status_snapshot_woken_pipeline");
+    ASSERT_NE(transition, nullptr);
+    EXPECT_EQ(transition->state, "AVAILABLE");
+}
+
+TEST(StatusSnapshot, WatcherFallingBehindReceivesCurrentStates) {
+    auto& snapshot = StatusSnapshot::getInstance();
+    std::vector<StatusTransition> transitions;
+    uint64_t sequence = snapshot.getStates(transitions);
+    for (size_t i = 0; i <= StatusSnapshot::MAX_RETAINED_CHANGES; ++i) {
+        snapshot.updatePipeline("status_snapshot_flapping_pipeline", i % 2 ? "AVAILABLE" : "RELOADING");
+    }
+    snapshot.updatePipeline("status_snapshot_flapping_pipeline", "RETIRED");
+    transitions.clear();
+    ASSERT_TRUE(snapshot.waitForChanges(sequence, transitions, std::chrono::milliseconds(0)));
+    auto transition = findTransition(transitions, "status_snapshot_flapping_pipeline");
+    ASSERT_NE(transition, nullptr);
+    EXPECT_EQ(transition->state, "RETIRED");
+    EXPECT_LT(transitions.size(), StatusSnapshot::MAX_RETAINED_CHANGES);
+}
+
+TEST(StatusSnapshot, ListenerIsNotifiedOfTransitionsUntilRemoved) {
+    auto& snapshot = StatusSnapshot::getInstance();
+    int notifications = 0;
+    auto id = snapshot.addListener([&notifications]() { ++notifications; });
+    snapshot.updatePipeline("status_snapshot_listened_pipeline", "BEGIN");
+    snapshot.updatePipeline("status_snapshot_listened_pipeline", "BEGIN");
+    EXPECT_EQ(notifications, 1);
+    snapshot.updatePipeline("status_snapshot_listened_pipeline", "AVAILABLE");
+    EXPECT_EQ(notifications, 2);
+    snapshot.removeListener(id);
+    snapshot.updatePipeline("status_snapshot_listened_pipeline", "RETIRED");
+    EXPECT_EQ(notifications, 2);
+}
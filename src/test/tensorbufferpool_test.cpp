@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../ov_utils.hpp"
+#include "../tensorbufferpool.hpp"
+
+using ovms::TensorBufferPool;
+
+TEST(TensorBufferPool, SizeClass) {
+    EXPECT_EQ(TensorBufferPool::getSizeClass(0), 64);
+    EXPECT_EQ(TensorBufferPool::getSizeClass(1), 64);
+    EXPECT_EQ(TensorBufferPool::getSizeClass(64), 64);
+    EXPECT_EQ(TensorBufferPool::getSizeClass(65), 128);
+    EXPECT_EQ(TensorBufferPool::getSizeClass(1000), 1024);
+    EXPECT_EQ(TensorBufferPool::getSizeClass(1025), 1280);
+    EXPECT_EQ(TensorBufferPool::getSizeClass(3 * 224 * 224 * 4), 655360);
+    for (size_t size : {100, 5000, 123456, 10000000}) {
+        const size_t sizeClass = TensorBufferPool::getSizeClass(size);
+        EXPECT_GE(sizeClass, size);
+        EXPECT_LE(sizeClass, size + size / 4 + TensorBufferPool::ALIGNMENT);
+        EXPECT_EQ(sizeClass % TensorBufferPool::ALIGNMENT, 0);
+    }
+}
+
+TEST(TensorBufferPool, ReusesReleasedBuffer) {
+    TensorBufferPool pool;
+    pool.configure(1024 * 1024, false);
+    void* handle = pool.alloc(1000);
+    ASSERT_NE(handle, nullptr);
+    void* data = pool.lock(handle);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % TensorBufferPool::ALIGNMENT, 0);
+    std::memset(data, 1, 1000);
+    EXPECT_TRUE(pool.free(handle));
+    EXPECT_EQ(pool.getCachedBytes(), 1024);
+
+    void* reusedHandle = pool.alloc(1020);
+    EXPECT_EQ(pool.lock(reusedHandle), data);
+    EXPECT_EQ(pool.getCachedBytes(), 0);
+    pool.free(reusedHandle);
+}
+
+TEST(TensorBufferPool, DoesNotReuseBufferOfDifferentSizeClass) {
+    TensorBufferPool pool;
+    pool.configure(1024 * 1024, false);
+    void* handle = pool.alloc(1000);
+    pool.free(handle);
+    void* otherHandle = pool.alloc(5000);
+    EXPECT_NE(otherHandle, handle);
+    EXPECT_EQ(pool.getCachedBytes(), 1024);
+    pool.free(otherHandle);
+}
+
+TEST(TensorBufferPool, ReleasesBuffersAboveLimit) {
+    TensorBufferPool pool;
+    pool.configure(2048, false);
+    void* first = pool.alloc(1024);
+    void* second = pool.alloc(1024);
+    void* third = pool.alloc(1024);
+    pool.free(first);
+    pool.free(second);
+    pool.free(third);
+    EXPECT_EQ(pool.getCachedBytes(), 2048);
+
+    pool.configure(0, false);
+    EXPECT_EQ(pool.getCachedBytes(), 0);
+    void* handle = pool.alloc(1024);
+    pool.free(handle);
+    EXPECT_EQ(pool.getCachedBytes(), 0);
+}
+
+TEST(TensorBufferPool, HugePagesFallbackToRegularPages) {
+    // Hugepages are usually not reserved in test environment, allocation must succeed either way
+    TensorBufferPool pool;
+    pool.configure(0, true);
+    const size_t size = 3 * TensorBufferPool::HUGE_PAGE_SIZE;
+    void* handle = pool.alloc(size);
+    ASSERT_NE(handle, nullptr);
+    void* data = pool.lock(handle);
+    std::memset(data, 1, size);
+    EXPECT_EQ(pool.getHugePagesBytes() % TensorBufferPool::HUGE_PAGE_SIZE, 0);
+    pool.free(handle);
+    EXPECT_EQ(pool.getHugePagesBytes(), 0);
+}
+
+TEST(TensorBufferPool, CloneBlobIntoPooledMemory) {
+    const InferenceEngine::TensorDesc desc{InferenceEngine::Precision::FP16, {1, 3, 10, 10}, InferenceEngine::Layout::NCHW};
+    std::vector<uint16_t> data(300);
+    std::iota(data.begin(), data.end(), 0);
+    InferenceEngine::Blob::Ptr blob = InferenceEngine::make_shared_blob<uint16_t>(desc, data.data());
+    auto copy = ovms::blobClone(blob);
+    ASSERT_NE(copy, nullptr);
+    EXPECT_EQ(copy->getTensorDesc(), desc);
+    const uint16_t* copyData = copy->cbuffer().as<const uint16_t*>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(copyData) % TensorBufferPool::ALIGNMENT, 0);
+    EXPECT_EQ(std::memcmp(copyData, data.data(), data.size() * sizeof(uint16_t)), 0);
+}
@@ -0,0 +1,186 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../tensorcache.hpp"
+
+using ovms::StatusCode;
+using ovms::TensorCache;
+
+namespace {
+class TensorCacheTest : public ::testing::Test {
+protected:
+    std::vector<float> values{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+
+    void SetUp() override {
+        TensorCache::getInstance().configure(4 * values.size() * sizeof(float));
+    }
+
+    void TearDown() override {
+        TensorCache::getInstance().configure(0);
+    }
+
+    tensorflow::TensorProto prepareTensor() {
+        tensorflow::TensorProto proto;
+        proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+        proto.mutable_tensor_shape()->add_dim()->set_size(2);
+        proto.mutable_tensor_shape()->add_dim()->set_size(values.size() / 2);
+        proto.mutable_tensor_content()->assign(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+        return proto;
+    }
+
+    tensorflow::TensorProto prepareReference(const std::string& handle) {
+        tensorflow::TensorProto proto;
+        proto.set_dtype(tensorflow::DataType::DT_FLOAT);
+        proto.mutable_tensor_shape()->add_dim()->set_size(2);
+        proto.mutable_tensor_shape()->add_dim()->set_size(values.size() / 2);
+        auto resourceHandle = proto.add_resource_handle_val();
+        resourceHandle->set_container(ovms::TENSOR_CACHE_CONTAINER);
+        resourceHandle->set_name(handle);
+        return proto;
+    }
+};
+}  // namespace
+
+TEST_F(TensorCacheTest, UploadFindAndRelease) {
+    auto& cache = TensorCache::getInstance();
+    std::string handle;
+    ASSERT_EQ(cache.upload(prepareTensor(), handle), StatusCode::OK);
+    EXPECT_FALSE(handle.empty());
+    auto tensor = cache.find(handle);
+    ASSERT_NE(tensor, nullptr);
+    EXPECT_EQ(tensor->getDataType(), tensorflow::DataType::DT_FLOAT);
+    EXPECT_EQ(tensor->getShape(), InferenceEngine::SizeVector({2, 4}));
+    EXPECT_EQ(tensor->getByteSize(), values.size() * sizeof(float));
+    EXPECT_EQ(reinterpret_cast<const float*>(tensor->getData())[7], 8.0);
+    EXPECT_EQ(cache.getByteSize(), values.size() * sizeof(float));
+    EXPECT_EQ(cache.release(handle), StatusCode::OK);
+    EXPECT_EQ(cache.find(handle), nullptr);
+    EXPECT_EQ(cache.getByteSize(), 0);
+    // data remains in memory while referenced
+    EXPECT_EQ(reinterpret_cast<const float*>(tensor->getData())[0], 1.0);
+    EXPECT_EQ(cache.release(handle), StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND);
+}
+
+TEST_F(TensorCacheTest, HandlesAreUnique) {
+    std::string first, second;
+    ASSERT_EQ(TensorCache::getInstance().upload(prepareTensor(), first), StatusCode::OK);
+    ASSERT_EQ(TensorCache::getInstance().upload(prepareTensor(), second), StatusCode::OK);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(TensorCache::getInstance().getTensorsCount(), 2);
+}
+
+TEST_F(TensorCacheTest, LeastRecentlyUsedTensorIsEvicted) {
+    auto& cache = TensorCache::getInstance();
+    std::vector<std::string> handles(4);
+    for (auto& handle : handles) {
+        ASSERT_EQ(cache.upload(prepareTensor(), handle), StatusCode::OK);
+    }
+    ASSERT_NE(cache.find(handles[0]), nullptr);
+    std::string handle;
+    ASSERT_EQ(cache.upload(prepareTensor(), handle), StatusCode::OK);
+    EXPECT_EQ(cache.getTensorsCount(), 4);
+    EXPECT_NE(cache.find(handles[0]), nullptr);
+    EXPECT_EQ(cache.find(handles[1]), nullptr);
+    EXPECT_NE(cache.find(handles[2]), nullptr);
+    EXPECT_NE(cache.find(handle), nullptr);
+    cache.configure(values.size() * sizeof(float));
+    EXPECT_EQ(cache.getTensorsCount(), 1);
+    EXPECT_NE(cache.find(handle), nullptr);
+}
+
+TEST_F(TensorCacheTest, UploadTooLargeTensor) {
+    TensorCache::getInstance().configure(values.size() * sizeof(float) - 1);
+    std::string handle;
+    EXPECT_EQ(TensorCache::getInstance().upload(prepareTensor(), handle), StatusCode::TENSOR_CACHE_TENSOR_TOO_LARGE);
+}
+
+TEST_F(TensorCacheTest, UploadWhenDisabled) {
+    TensorCache::getInstance().configure(0);
+    std::string handle;
+    EXPECT_EQ(TensorCache::getInstance().upload(prepareTensor(), handle), StatusCode::TENSOR_CACHE_DISABLED);
+}
+
+TEST_F(TensorCacheTest, UploadInvalidTensor) {
+    std::string handle;
+    auto proto = prepareTensor();
+    proto.mutable_tensor_content()->pop_back();
+    EXPECT_EQ(TensorCache::getInstance().upload(proto, handle), StatusCode::INVALID_CONTENT_SIZE);
+    proto = prepareTensor();
+    proto.mutable_tensor_shape()->mutable_dim(0)->set_size(-2);
+    EXPECT_EQ(TensorCache::getInstance().upload(proto, handle), StatusCode::INVALID_SHAPE);
+    proto = prepareTensor();
+    proto.set_dtype(tensorflow::DataType::DT_STRING);
+    EXPECT_EQ(TensorCache::getInstance().upload(proto, handle), StatusCode::OV_UNSUPPORTED_DESERIALIZATION_PRECISION);
+    EXPECT_EQ(TensorCache::getInstance().getTensorsCount(), 0);
+}
+
+TEST_F(TensorCacheTest, HalfValuesAreKeptInNativeWidth) {
+    tensorflow::TensorProto proto;
+    proto.set_dtype(tensorflow::DataType::DT_HALF);
+    proto.mutable_tensor_shape()->add_dim()->set_size(3);
+    proto.add_half_val(1);
+    proto.add_half_val(2);
+    proto.add_half_val(65535);
+    std::string handle;
+    ASSERT_EQ(TensorCache::getInstance().upload(proto, handle), StatusCode::OK);
+    auto tensor = TensorCache::getInstance().find(handle);
+    ASSERT_NE(tensor, nullptr);
+    ASSERT_EQ(tensor->getByteSize(), 3 * sizeof(uint16_t));
+    EXPECT_EQ(reinterpret_cast<const uint16_t*>(tensor->getData())[2], 65535);
+    proto.add_half_val(3);
+    EXPECT_EQ(TensorCache::getInstance().upload(proto, handle), StatusCode::INVALID_VALUE_COUNT);
+}
+
+TEST_F(TensorCacheTest, ReferenceBlobPointsToCachedData) {
+    std::string handle;
+    ASSERT_EQ(TensorCache::getInstance().upload(prepareTensor(), handle), StatusCode::OK);
+    auto reference = prepareReference(handle);
+    EXPECT_TRUE(ovms::isCachedTensorReference(reference));
+    InferenceEngine::Blob::Ptr blob;
+    ASSERT_EQ(ovms::createCachedTensorBlob(reference, InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {2, 4}, InferenceEngine::Layout::NC), blob), StatusCode::OK);
+    ASSERT_EQ(TensorCache::getInstance().release(handle), StatusCode::OK);
+    // blob keeps released tensor in memory
+    EXPECT_EQ(blob->cbuffer().as<const float*>()[5], 6.0);
+    EXPECT_EQ(ovms::createCachedTensorBlob(reference, InferenceEngine::TensorDesc(InferenceEngine::Precision::FP32, {2, 4}, InferenceEngine::Layout::NC), blob), StatusCode::TENSOR_CACHE_TENSOR_NOT_FOUND);
+}
+
+TEST_F(TensorCacheTest, ReferenceHasToMatchCachedTensor) {
+    std::string handle;
+    ASSERT_EQ(TensorCache::getInstance().upload(prepareTensor(), handle), StatusCode::OK);
+    std::shared_ptr<const ovms::CachedTensor> tensor;
+    const char* data = nullptr;
+    auto reference = prepareReference(handle);
+    EXPECT_EQ(ovms::getCachedTensorData(reference, values.size() * sizeof(float), tensor, data), StatusCode::OK);
+    EXPECT_EQ(ovms::getCachedTensorData(reference, 4 * sizeof(float), tensor, data), StatusCode::TENSOR_CACHE_TENSOR_MISMATCH);
+    reference.mutable_tensor_shape()->mutable_dim(0)->set_size(4);
+    reference.mutable_tensor_shape()->mutable_dim(1)->set_size(2);
+    EXPECT_EQ(ovms::getCachedTensorData(reference, values.size() * sizeof(float), tensor, data), StatusCode::TENSOR_CACHE_TENSOR_MISMATCH);
+    reference = prepareReference(handle);
+    reference.set_dtype(tensorflow::DataType::DT_INT32);
+    EXPECT_EQ(ovms::getCachedTensorData(reference, values.size() * sizeof(float), tensor, data), StatusCode::TENSOR_CACHE_TENSOR_MISMATCH);
+}
+
+TEST_F(TensorCacheTest, SharedMemoryTensorIsNotCachedTensorReference) {
+    auto proto = prepareTensor();
+    EXPECT_FALSE(ovms::isCachedTensorReference(proto));
+    proto.add_resource_handle_val()->set_container("ovms_shared_memory");
+    EXPECT_FALSE(ovms::isCachedTensorReference(proto));
+}
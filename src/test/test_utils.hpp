@@ -135,6 +135,21 @@ static std::string createConfigFileWithContent(const std::string& content, std::
     }
     return filename;
 }
+
+// writes .npy version 1.0 file with given header dict and raw data, returns path to a file.
+static std::string createNpyFile(const std::string& header, const std::string& data, const std::string& filename) {
+    std::string paddedHeader = header;
+    while ((10 + paddedHeader.size() + 1) % 64 != 0) {
+        paddedHeader += ' ';
+    }
+    paddedHeader += '\n';
+    std::ofstream file{filename, std::ios::binary};
+    file.write("\x93NUMPY\x01\x00", 8);
+    file.put(static_cast<char>(paddedHeader.size() & 0xff));
+    file.put(static_cast<char>(paddedHeader.size() >> 8));
+    file << paddedHeader << data;
+    return filename;
+}
 #pragma GCC diagnostic pop
 
 template <typename T>
@@ -71,6 +71,16 @@ TEST(TestThreadSafeQueue, NoElementsPushed) {
     EXPECT_EQ(std::nullopt, queue.tryPull(WAIT_FOR_ELEMENT_TIMEOUT_MICROSECONDS));
 }
 
+TEST(TestThreadSafeQueue, PullBlocksUntilElementPushed) {
+    ThreadSafeQueue<int> queue;
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        queue.push(7);
+    });
+    EXPECT_EQ(7, queue.pull());
+    producer.join();
+}
+
 const uint ELEMENTS_TO_INSERT = 500;
 
 void producer(ThreadSafeQueue<int>& queue, std::future<void> startSignal) {
@@ -125,3 +135,72 @@ TEST(TestThreadSafeQueue, SeveralThreadsAllElementsPresent) {
         EXPECT_EQ(NUMBER_OF_PRODUCERS, counter);
     }
 }
+
+using ovms::BoundedMpscQueue;
+
+TEST(TestBoundedMpscQueue, SeveralElementsInFIFOOrder) {
+    const std::vector<int> elements = {1, 2, 3, 4, 5, 6};
+    BoundedMpscQueue<int> queue(elements.size());
+    for (auto& e : elements) {
+        EXPECT_TRUE(queue.tryPush(e));
+    }
+    for (auto& e : elements) {
+        EXPECT_EQ(e, queue.tryPull());
+    }
+    EXPECT_EQ(std::nullopt, queue.tryPull());
+}
+
+TEST(TestBoundedMpscQueue, PushFailsWhenFull) {
+    BoundedMpscQueue<int> queue(4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(0, queue.tryPull());
+    EXPECT_TRUE(queue.tryPush(4));
+    EXPECT_EQ(4u, queue.size());
+}
+
+TEST(TestBoundedMpscQueue, NoElementsPushed) {
+    BoundedMpscQueue<int> queue(4);
+    EXPECT_EQ(std::nullopt, queue.tryPull(1'000));
+}
+
+TEST(TestBoundedMpscQueue, PullBlocksUntilElementPushed) {
+    BoundedMpscQueue<int> queue(4);
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        queue.push(7);
+    });
+    EXPECT_EQ(7, queue.pull());
+    producer.join();
+}
+
+TEST(TestBoundedMpscQueue, SeveralThreadsAllElementsPresent) {
+    const uint NUMBER_OF_PRODUCERS = 80;
+    BoundedMpscQueue<int> queue(64);
+    std::promise<void> startSignal;
+    std::shared_future<void> started = startSignal.get_future().share();
+    std::vector<std::thread> producers;
+    for (auto i = 0u; i < NUMBER_OF_PRODUCERS; ++i) {
+        producers.emplace_back([&queue, started]() {
+            started.wait();
+            for (uint counter = 0; counter < ELEMENTS_TO_INSERT; ++counter) {
+                queue.push(counter);
+            }
+        });
+    }
+    startSignal.set_value();
+    std::map<int, uint> counts;
+    for (auto i = 0u; i < NUMBER_OF_PRODUCERS * ELEMENTS_TO_INSERT; ++i) {
+        counts[queue.tryPull(WAIT_FOR_ELEMENT_TIMEOUT_MICROSECONDS).value()]++;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_EQ(std::nullopt, queue.tryPull());
+    ASSERT_EQ(counts.size(), ELEMENTS_TO_INSERT);
+    for (auto [key, counter] : counts) {
+        EXPECT_EQ(NUMBER_OF_PRODUCERS, counter);
+    }
+}
@@ -0,0 +1,106 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#include "tensorflow_serving/apis/prediction_service.grpc.pb.h"
+#pragma GCC diagnostic pop
+
+#include "../trafficcapture.hpp"
+
+using ovms::CapturedProtocol;
+using ovms::CapturedRequest;
+using ovms::StatusCode;
+using ovms::TrafficCapture;
+
+TEST(TrafficCapture, RecordedRequestsReadBackInOrder) {
+    const std::string path = "/tmp/ovms_traffic_capture.bin";
+    TrafficCapture capture;
+    ASSERT_EQ(capture.start(path, 1.0), StatusCode::OK);
+    tensorflow::serving::PredictRequest request;
+    request.mutable_model_spec()->set_name("dummy");
+    (*request.mutable_inputs())["b"].set_tensor_content(std::string(40, '\1'));
+    capture.captureGrpc(request);
+    capture.captureRest("/v1/models/dummy:predict", "", "{\"instances\":[1]}");
+    capture.captureRest("/v1/models/dummy:predict", "16", std::string(32, '\0'));
+    capture.stop();
+    EXPECT_EQ(capture.getCapturedCount(), 3);
+    EXPECT_EQ(capture.getDroppedCount(), 0);
+
+    std::vector<CapturedRequest> requests;
+    ASSERT_EQ(ovms::readCaptureFile(path, requests), StatusCode::OK);
+    ASSERT_EQ(requests.size(), 3);
+    EXPECT_EQ(requests[0].protocol, CapturedProtocol::GRPC);
+    tensorflow::serving::PredictRequest parsed;
+    ASSERT_TRUE(parsed.ParseFromString(requests[0].body));
+    EXPECT_EQ(parsed.model_spec().name(), "dummy");
+    EXPECT_EQ(parsed.inputs().at("b").tensor_content(), std::string(40, '\1'));
+    EXPECT_EQ(requests[1].protocol, CapturedProtocol::REST);
+    EXPECT_EQ(requests[1].path, "/v1/models/dummy:predict");
+    EXPECT_EQ(requests[1].body, "{\"instances\":[1]}");
+    EXPECT_EQ(requests[2].inferenceHeaderContentLength, "16");
+    EXPECT_EQ(requests[2].body, std::string(32, '\0'));
+    EXPECT_LE(requests[0].offsetMicroseconds, requests[1].offsetMicroseconds);
+    EXPECT_LE(requests[1].offsetMicroseconds, requests[2].offsetMicroseconds);
+    std::remove(path.c_str());
+}
+
+TEST(TrafficCapture, RequestsAreSampled) {
+    const std::string path = "/tmp/ovms_traffic_capture_sampled.bin";
+    TrafficCapture capture;
+    ASSERT_EQ(capture.start(path, 0.1), StatusCode::OK);
+    for (int i = 0; i < 10000; i++) {
+        capture.captureRest("/v1/models/dummy:predict", "", "{}");
+    }
+    capture.stop();
+    EXPECT_GT(capture.getCapturedCount(), 500);
+    EXPECT_LT(capture.getCapturedCount(), 1500);
+    std::remove(path.c_str());
+}
+
+TEST(TrafficCapture, DisabledCaptureRecordsNothing) {
+    TrafficCapture capture;
+    EXPECT_FALSE(capture.isEnabled());
+    capture.captureRest("/v1/models/dummy:predict", "", "{}");
+    EXPECT_EQ(capture.getCapturedCount(), 0);
+    EXPECT_EQ(capture.start("/tmp/ovms_traffic_capture_invalid.bin", 0), StatusCode::UNKNOWN_ERROR);
+    EXPECT_FALSE(capture.isEnabled());
+}
+
+TEST(TrafficCapture, InvalidFilesAreRejected) {
+    std::vector<CapturedRequest> requests;
+    EXPECT_EQ(ovms::readCaptureFile("/tmp/ovms_traffic_capture_not_existing.bin", requests), StatusCode::FILE_INVALID);
+    const std::string path = "/tmp/ovms_traffic_capture_truncated.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(TrafficCapture::FILE_MAGIC, TrafficCapture::FILE_MAGIC_SIZE);
+        file.put(1);
+        file.write("\0\0\0", 3);
+    }
+    EXPECT_EQ(ovms::readCaptureFile(path, requests), StatusCode::FILE_INVALID);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a capture file";
+    }
+    EXPECT_EQ(ovms::readCaptureFile(path, requests), StatusCode::FILE_INVALID);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,79 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <signal.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../workerprocesses.hpp"
+
+namespace {
+volatile sig_atomic_t shutdownRequest = 0;
+
+void requestShutdown(int) {
+    shutdownRequest = 1;
+}
+
+const std::string WORKERS_LOG = "/tmp/ovms_worker_processes_test.log";
+const std::string WORKER_EXITED_MARKER = "/tmp/ovms_worker_processes_test.exited";
+
+// Runs in process which becomes the master, workers log their index and wait for termination by master
+void superviseWorkers(uint32_t count) {
+    signal(SIGALRM, requestShutdown);
+    alarm(3);
+    const uint32_t index = ovms::startWorkerProcesses(count, shutdownRequest);
+    {
+        std::ofstream log(WORKERS_LOG, std::ios::app);
+        log << index << " " << ovms::getWorkerProcessIndex() << std::endl;
+    }
+    if (index == 0 && std::ifstream(WORKER_EXITED_MARKER).fail()) {
+        // first worker exits once, so that master forks it again
+        std::ofstream marker(WORKER_EXITED_MARKER);
+        _exit(1);
+    }
+    while (true) {
+        pause();
+    }
+}
+}  // namespace
+
+TEST(WorkerProcesses, WorkersAreForkedRestartedAndTerminatedOnShutdown) {
+    std::remove(WORKERS_LOG.c_str());
+    std::remove(WORKER_EXITED_MARKER.c_str());
+    EXPECT_EXIT(superviseWorkers(2), ::testing::ExitedWithCode(EXIT_SUCCESS), "Shutting down workers");
+
+    std::map<uint32_t, size_t> startsCount;
+    std::ifstream log(WORKERS_LOG);
+    uint32_t index, reportedIndex;
+    while (log >> index >> reportedIndex) {
+        EXPECT_EQ(index, reportedIndex);
+        startsCount[index]++;
+    }
+    EXPECT_EQ(startsCount.size(), 2);
+    EXPECT_EQ(startsCount[0], 2);
+    EXPECT_EQ(startsCount[1], 1);
+    std::remove(WORKERS_LOG.c_str());
+    std::remove(WORKER_EXITED_MARKER.c_str());
+}
+
+TEST(WorkerProcesses, SingleProcessIndexIsZero) {
+    EXPECT_EQ(ovms::getWorkerProcessIndex(), 0);
+}
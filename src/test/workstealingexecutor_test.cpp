@@ -0,0 +1,120 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sched.h>
+
+#include "../workstealingexecutor.hpp"
+
+using ovms::WorkStealingExecutor;
+
+TEST(WorkStealingExecutor, ExecutesAllScheduledTasks) {
+    std::atomic<size_t> executed{0};
+    {
+        WorkStealingExecutor executor(4);
+        EXPECT_EQ(executor.getWorkersCount(), 4);
+        for (int i = 0; i < 1000; i++) {
+            executor.schedule([&executed]() { executed++; });
+        }
+    }
+    // pending tasks are executed before workers are stopped
+    EXPECT_EQ(executed.load(), 1000);
+}
+
+TEST(WorkStealingExecutor, TasksScheduledByWorkerAreExecuted) {
+    WorkStealingExecutor executor(2);
+    std::promise<void> finished;
+    std::atomic<int> remaining{100};
+    std::function<void()> task = [&]() {
+        if (--remaining > 0) {
+            executor.schedule(task);
+        } else {
+            finished.set_value();
+        }
+    };
+    executor.schedule(task);
+    EXPECT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
+
+TEST(WorkStealingExecutor, IdleWorkerStealsTasksOfBusyOne) {
+    WorkStealingExecutor executor(2);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> stolen;
+    // blocked task schedules next one to its own queue, other worker has to steal it
+    executor.schedule([&executor, released, &stolen]() {
+        executor.schedule([&stolen]() { stolen.set_value(); });
+        released.wait();
+    });
+    EXPECT_EQ(stolen.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    release.set_value();
+}
+
+TEST(WorkStealingExecutor, WorkersArePinnedToCpus) {
+    cpu_set_t allowedCpus;
+    CPU_ZERO(&allowedCpus);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowedCpus)) {
+        cpu++;
+    }
+    WorkStealingExecutor executor(2, {cpu});
+    std::mutex mtx;
+    std::set<int> cpus;
+    std::vector<std::promise<void>> finished(10);
+    for (auto& promise : finished) {
+        executor.schedule([&mtx, &cpus, &promise]() {
+            cpu_set_t workerCpus;
+            CPU_ZERO(&workerCpus);
+            sched_getaffinity(0, sizeof(workerCpus), &workerCpus);
+            std::lock_guard<std::mutex> lock(mtx);
+            cpus.insert(CPU_COUNT(&workerCpus) == 1 ? sched_getcpu() : -1);
+            promise.set_value();
+        });
+    }
+    for (auto& promise : finished) {
+        promise.get_future().wait();
+    }
+    EXPECT_EQ(cpus, std::set<int>({cpu}));
+}
+
+TEST(WorkStealingExecutor, ParallelForRunsEachIndexOnce) {
+    WorkStealingExecutor executor(4);
+    std::vector<std::atomic<int>> runs(100);
+    executor.parallelFor(runs.size(), 3, [&runs](size_t index) { runs[index]++; });
+    for (const auto& count : runs) {
+        EXPECT_EQ(count.load(), 1);
+    }
+    executor.parallelFor(0, 3, [](size_t) { FAIL(); });
+}
+
+TEST(WorkStealingExecutor, ParallelForCalledByAllWorkersFinishes) {
+    WorkStealingExecutor executor(2);
+    std::atomic<size_t> executed{0};
+    std::promise<void> first, second;
+    // helpers of both calls are queued behind workers blocked in parallelFor, callers run indexes themselves
+    executor.schedule([&]() { executor.parallelFor(10, 2, [&executed](size_t) { executed++; }); first.set_value(); });
+    executor.schedule([&]() { executor.parallelFor(10, 2, [&executed](size_t) { executed++; }); second.set_value(); });
+    EXPECT_EQ(first.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(second.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(executed.load(), 20);
+}
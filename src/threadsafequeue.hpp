@@ -15,12 +15,22 @@
 //*****************************************************************************
 #pragma once
 
+#include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <thread>
 #include <utility>
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
 namespace ovms {
 
 template <typename T>
@@ -53,7 +63,16 @@ public:
         }
     }
 
+    T pull() {
+        std::unique_lock<std::mutex> lock(mtx);
+        signal.wait(lock, [this]() { return queue.size() > 0; });
+        T element = std::move(queue.front());
+        queue.pop();
+        return element;
+    }
+
     size_t size() {
+        std::unique_lock<std::mutex> lock(mtx);
         return queue.size();
     }
 
@@ -62,4 +81,140 @@ private:
     std::queue<T> queue;
     std::condition_variable signal;
 };
+
+/**
+ * @brief Bounded lock-free queue with many producers and single consumer
+ *
+ * Elements are kept in ring of cells preallocated up front, each with sequence number telling whether
+ * it is ready to be written or read in the current lap, so that push and pull do not allocate.
+ * Consumer waiting for element blocks on futex, producers wake it only when it is waiting.
+ * Push waits for free cell when queue is full, capacity should be set to the maximum number of elements
+ * which may be queued at once.
+ */
+template <typename T>
+class BoundedMpscQueue {
+public:
+    explicit BoundedMpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells = std::make_unique<Cell[]>(size);
+        cellsMask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    bool tryPush(T element) {
+        size_t position = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & cellsMask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.element = std::move(element);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        pushes.fetch_add(1);
+        if (consumerWaiting.load()) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&pushes), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+        return true;
+    }
+
+    void push(T element) {
+        while (!tryPush(element)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Takes element if there is one already pushed, called by consumer only
+     */
+    std::optional<T> tryPull() {
+        const size_t position = dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = cells[position & cellsMask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return std::nullopt;
+        }
+        std::optional<T> element{std::move(cell.element)};
+        cell.sequence.store(position + cellsMask + 1, std::memory_order_release);
+        dequeuePos.store(position + 1, std::memory_order_relaxed);
+        return element;
+    }
+
+    std::optional<T> tryPull(const uint waitDurationMicroseconds) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(waitDurationMicroseconds);
+        while (true) {
+            const uint32_t observedPushes = pushes.load();
+            auto element = tryPull();
+            if (element) {
+                return element;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return std::nullopt;
+            }
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+            timespec timeout{static_cast<time_t>(remaining / 1'000'000'000), static_cast<long>(remaining % 1'000'000'000)};
+            wait(observedPushes, &timeout);
+        }
+    }
+
+    T pull() {
+        while (true) {
+            const uint32_t observedPushes = pushes.load();
+            auto element = tryPull();
+            if (element) {
+                return std::move(element.value());
+            }
+            wait(observedPushes, nullptr);
+        }
+    }
+
+    /**
+     * @brief Approximate number of queued elements, intended for monitoring only
+     */
+    size_t size() const {
+        const size_t enqueued = enqueuePos.load();
+        const size_t dequeued = dequeuePos.load();
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T element;
+    };
+
+    // Returns once element is pushed after observedPushes was read, on timeout or spuriously
+    void wait(uint32_t observedPushes, const timespec* timeout) {
+        consumerWaiting.store(true);
+        if (pushes.load() == observedPushes) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&pushes), FUTEX_WAIT_PRIVATE, observedPushes, timeout, nullptr, 0);
+        }
+        consumerWaiting.store(false);
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    size_t cellsMask;
+
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+    alignas(64) std::atomic<uint32_t> pushes{0};
+    std::atomic<bool> consumerWaiting{false};
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex requires plain 32 bit word");
+};
 }  // namespace ovms
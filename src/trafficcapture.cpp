@@ -0,0 +1,205 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "trafficcapture.hpp"
+
+#include <random>
+#include <utility>
+
+#include <google/protobuf/message.h>
+#include <spdlog/spdlog.h>
+
+namespace ovms {
+
+const char TrafficCapture::FILE_MAGIC[] = "OVMSCAP1";
+const size_t TrafficCapture::FILE_MAGIC_SIZE = 8;
+const size_t TrafficCapture::MAX_QUEUED_BYTES = 256 * 1024 * 1024;
+
+namespace {
+// fields are written in host byte order, captures are replayed on the same architecture
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+void writeString(std::ostream& out, const std::string& value) {
+    writeValue<uint64_t>(out, value.size());
+    out.write(value.data(), value.size());
+}
+
+bool readString(std::istream& in, std::string& value, uint64_t maxSize) {
+    uint64_t size;
+    if (!readValue(in, size) || size > maxSize) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(in.read(value.data(), size));
+}
+}  // namespace
+
+Status TrafficCapture::start(const std::string& path, double sampleRatio) {
+    if (sampleRatio <= 0 || sampleRatio > 1) {
+        SPDLOG_ERROR("Traffic capture sample ratio should be greater than 0 and not greater than 1: {}", sampleRatio);
+        return StatusCode::UNKNOWN_ERROR;
+    }
+    stop();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        SPDLOG_ERROR("Could not create traffic capture file: {}", path);
+        return StatusCode::FILE_INVALID;
+    }
+    file.write(FILE_MAGIC, FILE_MAGIC_SIZE);
+    this->sampleRatio = sampleRatio;
+    captured = 0;
+    dropped = 0;
+    stopping = false;
+    startTime = std::chrono::steady_clock::now();
+    writer = std::thread(&TrafficCapture::writeRecords, this);
+    enabled = true;
+    SPDLOG_INFO("Capturing {} of predict requests to: {}", sampleRatio, path);
+    return StatusCode::OK;
+}
+
+void TrafficCapture::stop() {
+    if (!writer.joinable()) {
+        return;
+    }
+    enabled = false;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    signal.notify_one();
+    writer.join();
+    file.close();
+    SPDLOG_INFO("Traffic capture stopped, captured requests: {}; dropped: {}", captured.load(), dropped.load());
+}
+
+bool TrafficCapture::isSampled() {
+    if (!isEnabled()) {
+        return false;
+    }
+    if (sampleRatio >= 1) {
+        return true;
+    }
+    // random sampling keeps arrival process of sampled requests similar to the original one
+    thread_local std::minstd_rand generator(std::random_device{}());
+    thread_local std::uniform_real_distribution<double> distribution(0, 1);
+    return distribution(generator) < sampleRatio;
+}
+
+void TrafficCapture::captureGrpc(const google::protobuf::Message& request) {
+    if (!isSampled()) {
+        return;
+    }
+    CapturedRequest record;
+    record.protocol = CapturedProtocol::GRPC;
+    request.SerializeToString(&record.body);
+    enqueue(std::move(record));
+}
+
+void TrafficCapture::captureRest(const std::string& path, const std::string& inferenceHeaderContentLength, const std::string& body) {
+    if (!isSampled()) {
+        return;
+    }
+    CapturedRequest record;
+    record.protocol = CapturedProtocol::REST;
+    record.path = path;
+    record.inferenceHeaderContentLength = inferenceHeaderContentLength;
+    record.body = body;
+    enqueue(std::move(record));
+}
+
+void TrafficCapture::enqueue(CapturedRequest&& request) {
+    const size_t size = request.path.size() + request.inferenceHeaderContentLength.size() + request.body.size();
+    std::unique_lock<std::mutex> lock(mtx);
+    if (stopping || queuedBytes + size > MAX_QUEUED_BYTES) {
+        dropped++;
+        return;
+    }
+    // arrival time is taken under lock so that records are written in order of their offsets
+    request.offsetMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    queuedBytes += size;
+    queue.push_back(std::move(request));
+    lock.unlock();
+    signal.notify_one();
+}
+
+void TrafficCapture::writeRecords() {
+    std::deque<CapturedRequest> records;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            signal.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            records.swap(queue);
+            queuedBytes = 0;
+        }
+        for (const auto& record : records) {
+            writeValue(file, static_cast<uint8_t>(record.protocol));
+            writeValue(file, record.offsetMicroseconds);
+            writeString(file, record.path);
+            writeString(file, record.inferenceHeaderContentLength);
+            writeString(file, record.body);
+        }
+        captured += records.size();
+        records.clear();
+        if (!file) {
+            SPDLOG_ERROR("Failed to write traffic capture file, capture stopped");
+            enabled = false;
+            return;
+        }
+    }
+    file.flush();
+}
+
+Status readCaptureFile(const std::string& path, std::vector<CapturedRequest>& requests) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        SPDLOG_ERROR("Could not open traffic capture file: {}", path);
+        return StatusCode::FILE_INVALID;
+    }
+    // corrupted field sizes are not allocated beyond file size
+    const uint64_t fileSize = file.tellg();
+    file.seekg(0);
+    std::string magic(TrafficCapture::FILE_MAGIC_SIZE, '\0');
+    if (!file.read(magic.data(), magic.size()) || magic != TrafficCapture::FILE_MAGIC) {
+        return Status(StatusCode::FILE_INVALID, "Not a traffic capture file: " + path);
+    }
+    requests.clear();
+    uint8_t protocol;
+    while (readValue(file, protocol)) {
+        CapturedRequest request;
+        if (protocol > static_cast<uint8_t>(CapturedProtocol::REST) ||
+            !readValue(file, request.offsetMicroseconds) ||
+            !readString(file, request.path, fileSize) ||
+            !readString(file, request.inferenceHeaderContentLength, fileSize) ||
+            !readString(file, request.body, fileSize)) {
+            return Status(StatusCode::FILE_INVALID, "Traffic capture file is truncated or corrupted after " + std::to_string(requests.size()) + " requests");
+        }
+        request.protocol = static_cast<CapturedProtocol>(protocol);
+        requests.push_back(std::move(request));
+    }
+    return StatusCode::OK;
+}
+
+}  // namespace ovms
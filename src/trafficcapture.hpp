@@ -0,0 +1,149 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "status.hpp"
+
+namespace google {
+namespace protobuf {
+class Message;
+}  // namespace protobuf
+}  // namespace google
+
+namespace ovms {
+
+enum class CapturedProtocol : uint8_t {
+    GRPC = 0,
+    REST = 1
+};
+
+/**
+ * @brief Predict request recorded by traffic capture
+ */
+struct CapturedRequest {
+    CapturedProtocol protocol = CapturedProtocol::GRPC;
+    /**
+     * @brief Arrival time of the request since capture start
+     */
+    uint64_t offsetMicroseconds = 0;
+    /**
+     * @brief REST request path, empty for gRPC
+     */
+    std::string path;
+    /**
+     * @brief Value of Inference-Header-Content-Length header of REST request, empty if not sent
+     */
+    std::string inferenceHeaderContentLength;
+    /**
+     * @brief Serialized PredictRequest for gRPC, request body for REST
+     */
+    std::string body;
+};
+
+/**
+ * @brief Records sampled predict requests with their arrival times to binary file for replay by load generator
+ *
+ * Request threads only decide if request is sampled and copy it, file is written by background thread.
+ * Requests are dropped instead of blocking request threads when writer does not keep up.
+ */
+class TrafficCapture {
+    std::atomic<bool> enabled{false};
+    double sampleRatio = 1.0;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::ofstream file;
+    std::thread writer;
+    std::mutex mtx;
+    std::condition_variable signal;
+    std::deque<CapturedRequest> queue;
+    size_t queuedBytes = 0;
+    bool stopping = false;
+
+    std::atomic<uint64_t> captured{0};
+    std::atomic<uint64_t> dropped{0};
+
+    bool isSampled();
+    void enqueue(CapturedRequest&& request);
+    void writeRecords();
+
+public:
+    static const char FILE_MAGIC[];
+    static const size_t FILE_MAGIC_SIZE;
+    /**
+     * @brief Size of requests waiting for writer above which new requests are dropped
+     */
+    static const size_t MAX_QUEUED_BYTES;
+
+    static TrafficCapture& getInstance() {
+        static TrafficCapture instance;
+        return instance;
+    }
+
+    ~TrafficCapture() {
+        stop();
+    }
+
+    /**
+     * @brief Creates capture file and starts recording requests
+     *
+     * @param path of capture file, overwritten if exists
+     * @param sampleRatio fraction of requests recorded, between 0 and 1
+     * @return Status
+     */
+    Status start(const std::string& path, double sampleRatio);
+
+    /**
+     * @brief Stops recording, returns once requests waiting for writer are written
+     */
+    void stop();
+
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void captureGrpc(const google::protobuf::Message& request);
+    void captureRest(const std::string& path, const std::string& inferenceHeaderContentLength, const std::string& body);
+
+    uint64_t getCapturedCount() const {
+        return captured.load();
+    }
+
+    uint64_t getDroppedCount() const {
+        return dropped.load();
+    }
+};
+
+/**
+ * @brief Reads all requests recorded in capture file
+ *
+ * @param path of capture file
+ * @param requests recorded requests in order of arrival
+ * @return Status
+ */
+Status readCaptureFile(const std::string& path, std::vector<CapturedRequest>& requests);
+
+}  // namespace ovms
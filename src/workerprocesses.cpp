@@ -0,0 +1,159 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "workerprocesses.hpp"
+
+#include <sys/prctl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ovms {
+
+namespace {
+uint32_t workerProcessIndex = 0;
+
+// worker exiting sooner after its start is considered failing at startup
+constexpr std::chrono::seconds STARTUP_FAILURE_PERIOD{30};
+constexpr uint32_t MAX_STARTUP_FAILURES = 5;
+
+struct Worker {
+    pid_t pid = 0;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point restartTime;
+    uint32_t startupFailures = 0;
+};
+
+// Master does not start logger, its thread would not be present in workers forked later
+void logMaster(const std::string& message) {
+    std::cerr << "[master " << getpid() << "] " << message << std::endl;
+}
+
+pid_t forkWorker(uint32_t index) {
+    // master may run as pid 1 in a container, so worker compares its parent with master pid instead of init
+    const pid_t masterPid = getpid();
+    pid_t pid = fork();
+    if (pid == 0) {
+        workerProcessIndex = index;
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (getppid() != masterPid) {
+            // master died before death signal was set
+            std::exit(EXIT_FAILURE);
+        }
+    } else if (pid < 0) {
+        logMaster("Cannot fork worker " + std::to_string(index) + ": " + std::strerror(errno));
+    } else {
+        logMaster("Started worker " + std::to_string(index) + " pid " + std::to_string(pid));
+    }
+    return pid;
+}
+
+/**
+ * @brief Schedules restart of worker which exited or could not be forked
+ *
+ * @return false if worker failed at startup too many times in a row
+ */
+bool scheduleRestart(Worker& worker, uint32_t index, const std::chrono::steady_clock::time_point& now) {
+    worker.pid = 0;
+    if (now - worker.startTime >= STARTUP_FAILURE_PERIOD) {
+        worker.startupFailures = 0;
+        worker.restartTime = now;
+        return true;
+    }
+    if (++worker.startupFailures >= MAX_STARTUP_FAILURES) {
+        logMaster("Worker " + std::to_string(index) + " failed at startup " + std::to_string(worker.startupFailures) + " times in a row");
+        return false;
+    }
+    // backoff doubles with each failure, starting at 1 second
+    const std::chrono::seconds backoff(1LL << (worker.startupFailures - 1));
+    worker.restartTime = now + backoff;
+    logMaster("Restarting worker " + std::to_string(index) + " in " + std::to_string(backoff.count()) + " seconds");
+    return true;
+}
+}  // namespace
+
+uint32_t startWorkerProcesses(uint32_t count, volatile sig_atomic_t& shutdownRequest) {
+    std::vector<Worker> workers(count);
+    bool failed = false;
+    for (uint32_t i = 0; i < count && !failed; ++i) {
+        workers[i].startTime = std::chrono::steady_clock::now();
+        workers[i].pid = forkWorker(i);
+        if (workers[i].pid == 0) {
+            return i;
+        }
+        if (workers[i].pid < 0) {
+            failed = !scheduleRestart(workers[i], i, workers[i].startTime);
+        }
+    }
+    while (!shutdownRequest && !failed) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const auto now = std::chrono::steady_clock::now();
+        int status = 0;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            for (uint32_t i = 0; i < count; ++i) {
+                if (workers[i].pid != pid) {
+                    continue;
+                }
+                logMaster("Worker " + std::to_string(i) + " pid " + std::to_string(pid) + " exited with status " +
+                          std::to_string(WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status)));
+                failed = !scheduleRestart(workers[i], i, now) || failed;
+            }
+        }
+        if (shutdownRequest || failed) {
+            break;
+        }
+        // workers which could not be forked or exited are restarted once their backoff expires, at most once a second
+        for (uint32_t i = 0; i < count && !failed; ++i) {
+            if (workers[i].pid > 0 || now < workers[i].restartTime) {
+                continue;
+            }
+            workers[i].startTime = now;
+            workers[i].pid = forkWorker(i);
+            if (workers[i].pid == 0) {
+                return i;
+            }
+            if (workers[i].pid < 0) {
+                failed = !scheduleRestart(workers[i], i, now);
+            }
+        }
+    }
+    logMaster(failed ? "Shutting down workers due to repeated worker startup failures" : "Shutting down workers");
+    for (const auto& worker : workers) {
+        if (worker.pid > 0) {
+            kill(worker.pid, SIGTERM);
+        }
+    }
+    for (const auto& worker : workers) {
+        if (worker.pid > 0) {
+            waitpid(worker.pid, nullptr, 0);
+        }
+    }
+    std::exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+uint32_t getWorkerProcessIndex() {
+    return workerProcessIndex;
+}
+
+}  // namespace ovms
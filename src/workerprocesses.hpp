@@ -0,0 +1,41 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <signal.h>
+
+#include <cstdint>
+
+namespace ovms {
+
+/**
+ * @brief Forks worker processes serving the same ports and supervises them until shutdown is requested
+ *
+ * Has to be called before any thread is started, since forked process contains only the calling thread.
+ * Returns index of worker in each worker process, which continues server startup. Master process never returns:
+ * it forks again workers which exited while server was running, forwards SIGTERM once shutdownRequest is set
+ * by signal handler and exits once all workers exited. Workers are terminated as well when master dies.
+ * Workers failing right after start are restarted with exponential backoff, master stops all workers and exits
+ * with failure once a worker fails at startup several times in a row, e.g. due to invalid configuration.
+ */
+uint32_t startWorkerProcesses(uint32_t count, volatile sig_atomic_t& shutdownRequest);
+
+/**
+ * @brief Index of current worker process, 0 also when server runs in single process
+ */
+uint32_t getWorkerProcessIndex();
+
+}  // namespace ovms
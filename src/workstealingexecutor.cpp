@@ -0,0 +1,181 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "workstealingexecutor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "cpuaffinity.hpp"
+
+namespace ovms {
+
+namespace {
+struct ExecutorSettings {
+    size_t workersCount = 0;
+    std::vector<int> cpus;
+};
+
+ExecutorSettings& getSettings() {
+    static ExecutorSettings settings;
+    return settings;
+}
+
+// set for worker threads, so that tasks they schedule go to their own queue
+thread_local const WorkStealingExecutor* currentExecutor = nullptr;
+thread_local size_t currentQueue = 0;
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(size_t workersCount, const std::vector<int>& cpus) {
+    for (size_t i = 0; i < workersCount; ++i) {
+        queues.emplace_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t i = 0; i < workersCount; ++i) {
+        std::vector<int> workerCpus;
+        if (!cpus.empty()) {
+            workerCpus.push_back(cpus[i % cpus.size()]);
+        }
+        workers.emplace_back(&WorkStealingExecutor::work, this, i, std::move(workerCpus));
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    {
+        std::unique_lock<std::mutex> lock(idleMtx);
+        stopped = true;
+    }
+    idle.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+Status WorkStealingExecutor::configure(size_t workersCount, const std::string& cpuSet) {
+    auto& settings = getSettings();
+    settings.cpus.clear();
+    if (!cpuSet.empty()) {
+        auto status = getRequestedCpus(-1, cpuSet, settings.cpus);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    settings.workersCount = workersCount > 0 ? workersCount : settings.cpus.size();
+    return StatusCode::OK;
+}
+
+WorkStealingExecutor& WorkStealingExecutor::getInstance() {
+    static WorkStealingExecutor instance(
+        getSettings().workersCount > 0 ? getSettings().workersCount : std::max(1u, std::thread::hardware_concurrency()),
+        getSettings().cpus);
+    return instance;
+}
+
+void WorkStealingExecutor::schedule(std::function<void()> task) {
+    const size_t index = currentExecutor == this ? currentQueue : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::unique_lock<std::mutex> lock(queues[index]->mtx);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    pendingTasks.fetch_add(1, std::memory_order_seq_cst);
+    // idle worker either sees pending task before it waits or is counted as idle here
+    if (idleWorkers.load(std::memory_order_seq_cst) > 0) {
+        { std::unique_lock<std::mutex> lock(idleMtx); }
+        idle.notify_one();
+    }
+}
+
+namespace {
+struct ParallelForState {
+    ParallelForState(size_t count, std::function<void(size_t)> task) :
+        count(count),
+        task(std::move(task)) {}
+
+    const size_t count;
+    const std::function<void(size_t)> task;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    std::mutex mtx;
+    std::condition_variable done;
+
+    void run() {
+        for (size_t index = next.fetch_add(1); index < count; index = next.fetch_add(1)) {
+            task(index);
+            if (finished.fetch_add(1) + 1 == count) {
+                std::unique_lock<std::mutex> lock(mtx);
+                done.notify_all();
+            }
+        }
+    }
+};
+}  // namespace
+
+void WorkStealingExecutor::parallelFor(size_t count, size_t helpers, std::function<void(size_t)> task) {
+    // helpers scheduled after all indexes are taken return right away, state outlives the call for them
+    auto state = std::make_shared<ParallelForState>(count, std::move(task));
+    for (size_t i = 0; i < std::min(helpers, count > 0 ? count - 1 : 0); ++i) {
+        schedule([state]() { state->run(); });
+    }
+    state->run();
+    std::unique_lock<std::mutex> lock(state->mtx);
+    state->done.wait(lock, [&state]() { return state->finished.load() == state->count; });
+}
+
+bool WorkStealingExecutor::popLocal(size_t index, std::function<void()>& task) {
+    auto& queue = *queues[index];
+    std::unique_lock<std::mutex> lock(queue.mtx);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingExecutor::steal(size_t index, std::function<void()>& task) {
+    for (size_t i = 1; i < queues.size(); ++i) {
+        auto& queue = *queues[(index + i) % queues.size()];
+        std::unique_lock<std::mutex> lock(queue.mtx, std::try_to_lock);
+        if (!lock.owns_lock() || queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingExecutor::work(size_t index, std::vector<int> cpus) {
+    CpuAffinityGuard cpuAffinityGuard(cpus);
+    currentExecutor = this;
+    currentQueue = index;
+    while (true) {
+        std::function<void()> task;
+        if (popLocal(index, task) || steal(index, task)) {
+            pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idleMtx);
+        idleWorkers.fetch_add(1, std::memory_order_seq_cst);
+        idle.wait(lock, [this]() { return stopped || pendingTasks.load(std::memory_order_seq_cst) > 0; });
+        idleWorkers.fetch_sub(1, std::memory_order_relaxed);
+        if (stopped && pendingTasks.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+    }
+}
+
+}  // namespace ovms
@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "status.hpp"
+
+namespace ovms {
+
+/**
+ * @brief Worker threads shared by pipelines and REST requests, each with its own queue of tasks
+ *
+ * Task scheduled by a worker is pushed to its own queue and taken from there last in first out, so that
+ * continuation of a request runs on the core which has its data in cache. Tasks scheduled by other threads
+ * are spread between queues in round robin order. Idle worker steals oldest tasks from queues of others.
+ * Workers may be pinned each to one CPU of given set, e.g. CPUs not used by inference streams.
+ * Tasks should not block, inferences are started asynchronously.
+ */
+class WorkStealingExecutor {
+    struct TaskQueue {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    alignas(64) std::atomic<size_t> pendingTasks{0};
+    alignas(64) std::atomic<size_t> nextQueue{0};
+
+    std::mutex idleMtx;
+    std::condition_variable idle;
+    std::atomic<size_t> idleWorkers{0};
+    bool stopped = false;
+
+    void work(size_t index, std::vector<int> cpus);
+    bool popLocal(size_t index, std::function<void()>& task);
+    bool steal(size_t index, std::function<void()>& task);
+
+public:
+    /**
+     * @param workersCount number of workers
+     * @param cpus CPUs worker threads are pinned to in round robin order, not pinned if empty
+     */
+    WorkStealingExecutor(size_t workersCount, const std::vector<int>& cpus = {});
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    /**
+     * @brief Sets size and CPUs of shared executor, has to be called before it is used for the first time
+     *
+     * @param workersCount number of workers, 0 for one worker on each CPU of the set
+     * @param cpuSet CPU list workers are pinned to, workers are not pinned if empty
+     *
+     * @return status
+     */
+    static Status configure(size_t workersCount, const std::string& cpuSet);
+
+    /**
+     * @brief Gets executor shared by pipelines and REST requests, by default with one worker for each hardware thread
+     */
+    static WorkStealingExecutor& getInstance();
+
+    void schedule(std::function<void()> task);
+
+    /**
+     * @brief Runs task for each index from 0 to count on calling thread and up to helpers workers, returns once all are finished
+     *
+     * Calling thread runs indexes not yet taken by workers itself instead of waiting for helper tasks queued behind
+     * others, so that it can be called from a worker as well.
+     */
+    void parallelFor(size_t count, size_t helpers, std::function<void(size_t)> task);
+
+    size_t getWorkersCount() const {
+        return workers.size();
+    }
+};
+
+}  // namespace ovms
@@ -0,0 +1,143 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "xxhash.hpp"
+
+#include <cstring>
+
+namespace ovms {
+
+namespace {
+const uint64_t PRIME1 = 11400714785074694791ULL;
+const uint64_t PRIME2 = 14029467366897019727ULL;
+const uint64_t PRIME3 = 1609587929392839161ULL;
+const uint64_t PRIME4 = 9650029242287828579ULL;
+const uint64_t PRIME5 = 2870177450012600261ULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const unsigned char* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const unsigned char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * PRIME1;
+}
+
+inline uint64_t mergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= round(0, accumulator);
+    return hash * PRIME1 + PRIME4;
+}
+}  // namespace
+
+XXHash64::XXHash64(uint64_t seed) :
+    seed(seed) {
+    accumulators[0] = seed + PRIME1 + PRIME2;
+    accumulators[1] = seed + PRIME2;
+    accumulators[2] = seed;
+    accumulators[3] = seed - PRIME1;
+}
+
+void XXHash64::update(const void* data, size_t size) {
+    auto input = static_cast<const unsigned char*>(data);
+    totalSize += size;
+    if (bufferedSize + size < sizeof(buffer)) {
+        std::memcpy(buffer + bufferedSize, input, size);
+        bufferedSize += size;
+        return;
+    }
+    if (bufferedSize > 0) {
+        const size_t missing = sizeof(buffer) - bufferedSize;
+        std::memcpy(buffer + bufferedSize, input, missing);
+        for (size_t i = 0; i < 4; i++) {
+            accumulators[i] = round(accumulators[i], read64(buffer + i * 8));
+        }
+        input += missing;
+        size -= missing;
+        bufferedSize = 0;
+    }
+    // independent lanes let the CPU overlap multiplications of consecutive stripes
+    uint64_t v1 = accumulators[0], v2 = accumulators[1], v3 = accumulators[2], v4 = accumulators[3];
+    const unsigned char* const end = input + size;
+    for (; input + sizeof(buffer) <= end; input += sizeof(buffer)) {
+        v1 = round(v1, read64(input));
+        v2 = round(v2, read64(input + 8));
+        v3 = round(v3, read64(input + 16));
+        v4 = round(v4, read64(input + 24));
+    }
+    accumulators[0] = v1;
+    accumulators[1] = v2;
+    accumulators[2] = v3;
+    accumulators[3] = v4;
+    bufferedSize = end - input;
+    std::memcpy(buffer, input, bufferedSize);
+}
+
+void XXHash64::updateString(const std::string& str) {
+    const uint64_t size = str.size();
+    update(&size, sizeof(size));
+    update(str.data(), str.size());
+}
+
+uint64_t XXHash64::digest() const {
+    uint64_t hash;
+    if (totalSize >= sizeof(buffer)) {
+        hash = rotateLeft(accumulators[0], 1) + rotateLeft(accumulators[1], 7) +
+               rotateLeft(accumulators[2], 12) + rotateLeft(accumulators[3], 18);
+        for (size_t i = 0; i < 4; i++) {
+            hash = mergeRound(hash, accumulators[i]);
+        }
+    } else {
+        hash = seed + PRIME5;
+    }
+    hash += totalSize;
+
+    const unsigned char* input = buffer;
+    const unsigned char* const end = buffer + bufferedSize;
+    for (; input + 8 <= end; input += 8) {
+        hash ^= round(0, read64(input));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (input + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(input)) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        input += 4;
+    }
+    for (; input < end; input++) {
+        hash ^= (*input) * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+}  // namespace ovms
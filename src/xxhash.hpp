@@ -0,0 +1,47 @@
+//*****************************************************************************
+// Copyright 2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ovms {
+
+/**
+ * @brief Streaming 64-bit xxHash (XXH64), processes input 32 bytes at a time so large tensors are hashed at memory speed
+ */
+class XXHash64 {
+    uint64_t accumulators[4];
+    uint64_t seed;
+    uint64_t totalSize = 0;
+    unsigned char buffer[32];
+    size_t bufferedSize = 0;
+
+public:
+    XXHash64(uint64_t seed = 0);
+
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Hashes string including its size, so that consecutive fields stay separated
+     */
+    void updateString(const std::string& str);
+
+    uint64_t digest() const;
+};
+
+}  // namespace ovms